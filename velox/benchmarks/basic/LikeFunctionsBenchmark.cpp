@@ -228,6 +228,14 @@ BENCHMARK_MULTI(tpchQuery20) {
   return benchmark->run(TpchBenchmarkCase::TpchQuery20, "forest%");
 }
 
+BENCHMARK_DRAW_LINE();
+
+// A generic pattern with a literal that no row contains. All rows are
+// rejected without running the regex.
+BENCHMARK_MULTI(rareLiteral) {
+  return benchmark->run(TpchBenchmarkCase::TpchQuery13, "%xylophone_%");
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
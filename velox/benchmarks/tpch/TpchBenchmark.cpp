@@ -15,11 +15,15 @@
  */
 
 #include <folly/Benchmark.h>
+#include <folly/String.h>
 #include <folly/init/Init.h>
+#include <folly/json.h>
 #include <gflags/gflags.h>
+#include <fstream>
 
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
@@ -27,6 +31,7 @@
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/Split.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/exec/tests/utils/TpchQueryBuilder.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
 #include "velox/parse/TypeResolver.h"
@@ -89,6 +94,35 @@ DEFINE_bool(use_native_parquet_reader, true, "Use Native Parquet Reader");
 DEFINE_int32(num_drivers, 4, "Number of drivers");
 DEFINE_string(data_format, "parquet", "Data format");
 DEFINE_int32(num_splits_per_file, 10, "Number of splits per file");
+DEFINE_int32(
+    spill_pct,
+    0,
+    "Percentage of the input of spillable operators to spill "
+    "(testing.spill-pct). Non-zero enables spilling.");
+DEFINE_int64(
+    max_query_memory_mb,
+    0,
+    "Memory cap of a query. Non-zero enables spilling so that a query over "
+    "the cap spills instead of failing. 0 means no cap.");
+DEFINE_string(
+    spill_path,
+    "",
+    "Directory for spill files. A temporary directory if empty.");
+DEFINE_string(
+    stats_json,
+    "",
+    "If set, runs each of --queries once with each of --num_drivers_list "
+    "drivers and writes the stats of each run to this file as one JSON "
+    "object per line.");
+DEFINE_string(
+    queries,
+    "",
+    "Comma-separated TPC-H query numbers for --stats_json. All supported "
+    "queries if empty.");
+DEFINE_string(
+    num_drivers_list,
+    "",
+    "Comma-separated driver counts for --stats_json. --num_drivers if empty.");
 
 DEFINE_validator(data_path, &notEmpty);
 DEFINE_validator(data_format, &validateDataFormat);
@@ -113,10 +147,12 @@ class TpchBenchmark {
   }
 
   std::pair<std::unique_ptr<TaskCursor>, std::vector<RowVectorPtr>> run(
-      const TpchPlan& tpchPlan) {
+      const TpchPlan& tpchPlan,
+      int32_t numDrivers = FLAGS_num_drivers) {
     CursorParameters params;
-    params.maxDrivers = FLAGS_num_drivers;
+    params.maxDrivers = numDrivers;
     params.planNode = tpchPlan.plan;
+    params.queryCtx = makeQueryCtx();
     const int numSplitsPerFile = FLAGS_num_splits_per_file;
 
     bool noMoreSplits = false;
@@ -137,6 +173,40 @@ class TpchBenchmark {
     };
     return readCursor(params, addSplits);
   }
+
+ private:
+  // Returns a QueryCtx with the spilling and memory cap given by the flags.
+  std::shared_ptr<core::QueryCtx> makeQueryCtx() {
+    auto queryCtx = core::QueryCtx::createForTest();
+    const int64_t maxBytes = FLAGS_max_query_memory_mb > 0
+        ? FLAGS_max_query_memory_mb << 20
+        : memory::kMaxMemory;
+    // The tracker also measures the peak memory of the query.
+    queryCtx->pool()->setMemoryUsageTracker(
+        memory::MemoryUsageTracker::create(maxBytes, maxBytes, maxBytes));
+    if (FLAGS_spill_pct == 0 && FLAGS_max_query_memory_mb == 0) {
+      return queryCtx;
+    }
+    std::string spillPath = FLAGS_spill_path;
+    if (spillPath.empty()) {
+      if (!spillDirectory_) {
+        spillDirectory_ = TempDirectoryPath::create();
+      }
+      spillPath = spillDirectory_->path;
+    }
+    queryCtx->setConfigOverridesUnsafe({
+        {core::QueryConfig::kSpillEnabled, "true"},
+        {core::QueryConfig::kAggregationSpillEnabled, "true"},
+        {core::QueryConfig::kJoinSpillEnabled, "true"},
+        {core::QueryConfig::kOrderBySpillEnabled, "true"},
+        {core::QueryConfig::kTestingSpillPct,
+         std::to_string(FLAGS_spill_pct)},
+        {core::QueryConfig::kSpillPath, spillPath},
+    });
+    return queryCtx;
+  }
+
+  std::shared_ptr<TempDirectoryPath> spillDirectory_;
 };
 
 TpchBenchmark benchmark;
@@ -147,11 +217,21 @@ BENCHMARK(q1) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q2) {
+  const auto planContext = queryBuilder->getQueryPlan(2);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q3) {
   const auto planContext = queryBuilder->getQueryPlan(3);
   benchmark.run(planContext);
 }
 
+BENCHMARK(q4) {
+  const auto planContext = queryBuilder->getQueryPlan(4);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q5) {
   const auto planContext = queryBuilder->getQueryPlan(5);
   benchmark.run(planContext);
@@ -182,6 +262,11 @@ BENCHMARK(q10) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q11) {
+  const auto planContext = queryBuilder->getQueryPlan(11);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q12) {
   const auto planContext = queryBuilder->getQueryPlan(12);
   benchmark.run(planContext);
@@ -207,6 +292,11 @@ BENCHMARK(q16) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q17) {
+  const auto planContext = queryBuilder->getQueryPlan(17);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q18) {
   const auto planContext = queryBuilder->getQueryPlan(18);
   benchmark.run(planContext);
@@ -217,18 +307,113 @@ BENCHMARK(q19) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q20) {
+  const auto planContext = queryBuilder->getQueryPlan(20);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q21) {
+  const auto planContext = queryBuilder->getQueryPlan(21);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q22) {
   const auto planContext = queryBuilder->getQueryPlan(22);
   benchmark.run(planContext);
 }
 
+namespace {
+// The queries that TpchQueryBuilder supports.
+const std::vector<int32_t> kQueries = {
+    1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20,
+    21, 22};
+
+std::vector<int32_t> parseIntList(
+    const std::string& list,
+    const std::vector<int32_t>& defaultValues) {
+  if (list.empty()) {
+    return defaultValues;
+  }
+  std::vector<folly::StringPiece> parts;
+  folly::split(',', list, parts, true);
+  std::vector<int32_t> values;
+  values.reserve(parts.size());
+  for (const auto& part : parts) {
+    values.push_back(folly::to<int32_t>(folly::trimWhitespace(part)));
+  }
+  return values;
+}
+
+// Returns the stats of a run of 'query' with 'numDrivers' as a JSON object.
+// Records the error if the query fails, e.g. by running out of memory.
+folly::dynamic runForStats(int32_t query, int32_t numDrivers) {
+  folly::dynamic stats = folly::dynamic::object("query", query)(
+      "num_drivers", numDrivers)("spill_pct", FLAGS_spill_pct)(
+      "max_query_memory_mb", FLAGS_max_query_memory_mb)(
+      "data_format", FLAGS_data_format);
+  const auto queryPlan = queryBuilder->getQueryPlan(query);
+  const auto startMs = getCurrentTimeMs();
+  std::shared_ptr<Task> task;
+  try {
+    auto [cursor, results] = benchmark.run(queryPlan, numDrivers);
+    task = cursor->task();
+    ensureTaskCompletion(task.get());
+    int64_t numOutputRows = 0;
+    for (const auto& vector : results) {
+      numOutputRows += vector->size();
+    }
+    stats["output_rows"] = numOutputRows;
+  } catch (const std::exception& e) {
+    stats["error"] = e.what();
+    stats["wall_ms"] = static_cast<int64_t>(getCurrentTimeMs() - startMs);
+    return stats;
+  }
+  const auto taskStats = task->taskStats();
+  stats["wall_ms"] = static_cast<int64_t>(
+      taskStats.executionEndTimeMs - taskStats.executionStartTimeMs);
+  uint64_t cpuNanos = 0;
+  uint64_t spilledBytes = 0;
+  uint64_t spilledRows = 0;
+  for (const auto& pipelineStats : taskStats.pipelineStats) {
+    for (const auto& operatorStats : pipelineStats.operatorStats) {
+      cpuNanos += operatorStats.addInputTiming.cpuNanos +
+          operatorStats.getOutputTiming.cpuNanos +
+          operatorStats.finishTiming.cpuNanos;
+      spilledBytes += operatorStats.spilledBytes;
+      spilledRows += operatorStats.spilledRows;
+    }
+  }
+  stats["cpu_ms"] = static_cast<int64_t>(cpuNanos / 1'000'000);
+  stats["peak_memory_bytes"] =
+      task->queryCtx()->pool()->getMemoryUsageTracker()->getPeakTotalBytes();
+  stats["spilled_bytes"] = static_cast<int64_t>(spilledBytes);
+  stats["spilled_rows"] = static_cast<int64_t>(spilledRows);
+  return stats;
+}
+
+void writeStatsJson() {
+  std::ofstream out(FLAGS_stats_json);
+  VELOX_CHECK(out.good(), "Cannot open {}", FLAGS_stats_json);
+  const auto queries = parseIntList(FLAGS_queries, kQueries);
+  const auto numDriversList =
+      parseIntList(FLAGS_num_drivers_list, {FLAGS_num_drivers});
+  for (auto query : queries) {
+    for (auto numDrivers : numDriversList) {
+      out << folly::toJson(runForStats(query, numDrivers)) << std::endl;
+    }
+  }
+}
+} // namespace
+
 int main(int argc, char** argv) {
   folly::init(&argc, &argv, false);
   benchmark.initialize();
   queryBuilder =
       std::make_shared<TpchQueryBuilder>(toFileFormat(FLAGS_data_format));
   queryBuilder->initialize(FLAGS_data_path);
-  if (FLAGS_run_query_verbose == -1) {
+  if (!FLAGS_stats_json.empty()) {
+    writeStatsJson();
+  } else if (FLAGS_run_query_verbose == -1) {
     folly::runBenchmarks();
   } else {
     const auto queryPlan = queryBuilder->getQueryPlan(FLAGS_run_query_verbose);
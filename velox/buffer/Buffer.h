@@ -141,6 +141,15 @@ class Buffer {
     return false;
   }
 
+  // True if at least AlignedBuffer::kPadding bytes past size() are
+  // readable, so that SIMD kernels can load whole batches over the tail of
+  // the data without masking. The padding bytes have unspecified values.
+  // True for the buffers allocated from a pool, false for views over
+  // external memory.
+  bool isPadded() const {
+    return !isView();
+  }
+
   virtual void setIsMutable(bool isMutable) {
     VELOX_CHECK(
         !isMutable || referenceCount_ == 1,
@@ -289,7 +298,11 @@ class AlignedBuffer : public Buffer {
   // Declare size here and static_assert in
   // constructor. sizeof(AlignedBuffer) is not defined here.
   static constexpr int32_t kSizeofAlignedBuffer = 64;
-  static constexpr int32_t kPaddedSize = kSizeofAlignedBuffer + simd::kPadding;
+  // Bytes past capacity() that are allocated with the buffer. At least 64
+  // so that a whole cache line or AVX-512 batch can be loaded at any offset
+  // below size() regardless of the SIMD width of the build.
+  static constexpr int32_t kPadding = std::max<int32_t>(64, simd::kPadding);
+  static constexpr int32_t kPaddedSize = kSizeofAlignedBuffer + kPadding;
 
   ~AlignedBuffer() {
     // This may throw, which is expected to signal an error to the
@@ -311,8 +324,10 @@ class AlignedBuffer : public Buffer {
   /**
    * Allocates enough memory to store numElements of type T.  May
    * allocate more memory than strictly necessary. Guarantees that
-   * simd::kPadding bytes past capacity() are addressable and asserts that
-   * these do not get overrun.
+   * kPadding bytes past capacity() are addressable and asserts that
+   * these do not get overrun. The padding is kept by reallocate(), so the
+   * values and nulls of flat vectors can always be read kPadding bytes
+   * past their size, see Buffer::isPadded().
    */
   template <typename T>
   static BufferPtr allocate(
@@ -23,14 +23,24 @@ namespace facebook::velox {
 StringView StringViewBufferHolder::getOwnedStringView(
     const char* data,
     int32_t size) {
-  if (stringBuffers_.empty() ||
-      stringBuffers_.back()->size() + size >
-          stringBuffers_.back()->capacity()) {
-    stringBuffers_.push_back(AlignedBuffer::allocate<char>(
-        std::max(size, kInitialStringReservation), pool_));
-    stringBuffers_.back()->setSize(0);
+  Buffer* stringBuffer;
+  if (size > kInitialStringReservation && !stringBuffers_.empty()) {
+    // A string larger than a chunk gets a buffer of its own before the last
+    // chunk, which keeps receiving the following strings.
+    auto buffer = AlignedBuffer::allocate<char>(size, pool_);
+    buffer->setSize(0);
+    stringBuffer = buffer.get();
+    stringBuffers_.insert(stringBuffers_.end() - 1, std::move(buffer));
+  } else {
+    if (stringBuffers_.empty() ||
+        stringBuffers_.back()->size() + size >
+            stringBuffers_.back()->capacity()) {
+      stringBuffers_.push_back(AlignedBuffer::allocate<char>(
+          std::max(size, kInitialStringReservation), pool_));
+      stringBuffers_.back()->setSize(0);
+    }
+    stringBuffer = stringBuffers_.back().get();
   }
-  auto stringBuffer = stringBuffers_.back().get();
   char* newPtr = stringBuffer->asMutable<char>() + stringBuffer->size();
   memcpy(newPtr, data, size);
   stringBuffer->setSize(stringBuffer->size() + size);
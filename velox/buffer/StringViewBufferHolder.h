@@ -76,6 +76,8 @@ class StringViewBufferHolder {
   StringView getOwnedStringView(StringView stringView);
   StringView getOwnedStringView(const char* data, int32_t size);
 
+  // Size of the chunks the strings are copied into. Longer strings get a
+  // buffer of their own.
   static constexpr int32_t kInitialStringReservation{1024 * 8};
 
   std::vector<BufferPtr> stringBuffers_;
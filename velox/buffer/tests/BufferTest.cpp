@@ -198,6 +198,21 @@ struct MockCachePin {
   int32_t pinCount = 0;
 };
 
+TEST_F(BufferTest, padding) {
+  static_assert(AlignedBuffer::kPadding >= 64);
+  for (auto size : {0, 1, 63, 64, 1000}) {
+    auto buffer = AlignedBuffer::allocate<char>(size, pool_.get());
+    EXPECT_TRUE(buffer->isPadded());
+    // The bytes past size() are readable, which ASAN would flag otherwise.
+    char tail[64];
+    memcpy(tail, buffer->as<char>() + size, sizeof(tail));
+
+    AlignedBuffer::reallocate<char>(&buffer, size * 3);
+    EXPECT_TRUE(buffer->isPadded());
+    memcpy(tail, buffer->as<char>() + buffer->size(), sizeof(tail));
+  }
+}
+
 TEST_F(BufferTest, testBufferView) {
   MockCachePin pin;
   const char* data = "12345678\0";
@@ -205,6 +220,7 @@ TEST_F(BufferTest, testBufferView) {
       reinterpret_cast<const uint8_t*>(data), sizeof(data), pin);
   EXPECT_EQ(buffer->size(), sizeof(data));
   EXPECT_EQ(buffer->capacity(), sizeof(data));
+  EXPECT_FALSE(buffer->isPadded());
   EXPECT_EQ(pin.pinCount, 1);
   EXPECT_FALSE(buffer->isMutable());
   EXPECT_THROW(buffer->setIsMutable(true), VeloxException);
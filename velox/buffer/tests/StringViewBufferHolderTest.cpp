@@ -120,6 +120,28 @@ TEST(StringViewBufferHolderTest, moreBuffersAreUsedWhenCurrentBufferFills) {
   }
 }
 
+TEST(StringViewBufferHolderTest, longStringDoesNotEndCurrentBuffer) {
+  auto holder = makeHolder();
+  std::string first = nonInlinedString();
+  std::string longString(20'000, 'b');
+  std::string last = nonInlinedString() + "c";
+
+  auto firstView = holder.getOwnedValue(StringView(first));
+  auto longView = holder.getOwnedValue(StringView(longString));
+  auto lastView = holder.getOwnedValue(StringView(last));
+  ASSERT_EQ(longString, longView.str());
+
+  // The long string has a buffer of its own. The string after it goes into
+  // the free space of the first buffer.
+  auto buffers = holder.moveBuffers();
+  ASSERT_EQ(2, buffers.size());
+  ASSERT_EQ(longView.data(), buffers[0]->as<char>());
+  ASSERT_EQ(firstView.data(), buffers[1]->as<char>());
+  ASSERT_EQ(firstView.data() + first.size(), lastView.data());
+  ASSERT_EQ(first, firstView.str());
+  ASSERT_EQ(last, lastView.str());
+}
+
 TEST(StringViewBufferHolderTest, stateIsClearedAfterStringsAreMoved) {
   auto holder = makeHolder();
   std::string value = nonInlinedString();
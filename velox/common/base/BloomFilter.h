@@ -22,6 +22,7 @@
 #include <folly/Hash.h>
 
 #include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
 
 namespace facebook::velox {
 
@@ -56,6 +57,19 @@ class BloomFilter {
         hashInput ? folly::hasher<uint64_t>()(value) : value);
   }
 
+  // Returns the bits of 'this' for sending to another process.
+  const std::vector<uint64_t>& bits() const {
+    return bits_;
+  }
+
+  // Replaces the content of 'this' with 'words' from bits() of another
+  // filter.
+  void setBits(std::vector<uint64_t> words) {
+    VELOX_CHECK(!words.empty());
+    VELOX_CHECK_EQ(words.size(), bits::nextPowerOfTwo(words.size()));
+    bits_ = std::move(words);
+  }
+
  private:
   // We use 4 independent hash functions by taking 24 bits of
   // the hash code and breaking these up into 4 groups of 6 bits. Each group
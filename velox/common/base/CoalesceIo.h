@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <vector>
 namespace facebook::velox {
 // Utility for combining IOs to nearby location into fewer coalesced
@@ -36,6 +38,51 @@ struct CoalesceIoStats {
 
 static constexpr int32_t kNoCoalesce = -1;
 
+// Latency and throughput of a storage device. Zero if not known.
+struct IoProfile {
+  // Time from issuing a request to receiving its first byte.
+  double latencyUs{0};
+  // Transfer rate after the first byte.
+  double bytesPerUs{0};
+
+  bool empty() const {
+    return latencyUs <= 0 || bytesPerUs <= 0;
+  }
+};
+
+// Limits for coalesceIo().
+struct CoalescePolicy {
+  // Gaps of at least this many bytes start a new IO.
+  int32_t maxGap;
+  // An IO is not extended past this many bytes.
+  int64_t maxIoBytes;
+};
+
+// Returns the coalescing limits that minimize the expected time of reading
+// from a device with 'profile'. Reading through a gap costs less than a
+// separate request if the gap transfers in less than the latency, so the
+// max gap is the bytes transferred in one latency. An IO of a few times
+// that saves little more latency but delays the IOs that could run in
+// parallel, so IOs are capped to kIoBytesPerGap gaps. If 'profile' is
+// empty, returns 'defaultGap' and no cap.
+inline CoalescePolicy makeCoalescePolicy(
+    const IoProfile& profile,
+    int32_t defaultGap) {
+  constexpr int64_t kMinGap = 4 << 10;
+  constexpr int64_t kMaxGap = 16 << 20;
+  constexpr int64_t kIoBytesPerGap = 8;
+  constexpr int64_t kMinIoBytes = 1 << 20;
+  if (profile.empty()) {
+    return {defaultGap, std::numeric_limits<int64_t>::max()};
+  }
+  const auto gap = std::clamp<int64_t>(
+      static_cast<int64_t>(profile.latencyUs * profile.bytesPerUs),
+      kMinGap,
+      kMaxGap);
+  return {
+      static_cast<int32_t>(gap), std::max(kMinIoBytes, gap * kIoBytesPerGap)};
+}
+
 // Generic template for grouping IOs into batches of <
 // rangesPerIo ranges separated by gaps of size >= maxGap. Element
 // represents the object of the IO, Range is the type representing the
@@ -46,7 +93,8 @@ static constexpr int32_t kNoCoalesce = -1;
 // that correspond to an Element, skipRange adds a gap between
 // neighboring items, ioFunc takes the items, the first item to
 // process, the first item not to process, the offset of the first
-// item and a vector of Ranges.
+// item and a vector of Ranges. An IO is not extended to cover more than
+// maxIoBytes bytes from its start.
 template <
     typename Item,
     typename Range,
@@ -65,7 +113,8 @@ CoalesceIoStats coalesceIo(
     ItemNumRanges numRanges,
     AddRanges addRanges,
     SkipRange skipRange,
-    IoFunc ioFunc) {
+    IoFunc ioFunc,
+    int64_t maxIoBytes = std::numeric_limits<int64_t>::max()) {
   std::vector<Range> buffers;
   auto start = offsetFunc(0);
   auto lastOffset = start;
@@ -79,7 +128,9 @@ CoalesceIoStats coalesceIo(
     result.payloadBytes += size;
     int32_t rangesForItem = numRanges(i);
     bool enoughRanges = (rangesForItem == kNoCoalesce ||
-                         ranges.size() + rangesForItem >= rangesPerIo) &&
+                         ranges.size() + rangesForItem >= rangesPerIo ||
+                         static_cast<int64_t>(startOffset + size - start) >
+                             maxIoBytes) &&
         !ranges.empty();
     if (lastOffset != startOffset || enoughRanges) {
       int64_t gap = startOffset - lastOffset;
@@ -1053,6 +1053,106 @@ xsimd::batch<T, A> iota(const A&) {
 
 namespace detail {
 
+// Adds 'y' to 'x' with wrap around. Sets 'overflow' if the signed sum
+// overflows.
+template <typename T>
+inline T addWithOverflow(T x, T y, bool& overflow) {
+  if constexpr (std::is_integral_v<T>) {
+    T result;
+    overflow |= __builtin_add_overflow(x, y, &result);
+    return result;
+  } else {
+    return x + y;
+  }
+}
+
+} // namespace detail
+
+template <typename TSum, typename T, typename A>
+TSum reduceSum(const T* values, int32_t size, bool* overflow, const A&) {
+  using Batch = xsimd::batch<TSum, A>;
+  constexpr int32_t kStep = Batch::size;
+  auto sums = xsimd::broadcast<TSum, A>(0);
+  // The sign bit of a lane is set if an addition to it overflowed.
+  auto overflows = xsimd::broadcast<TSum, A>(0);
+  int32_t row = 0;
+  for (; row + kStep <= size; row += kStep) {
+    auto batch = Batch::load_unaligned(values + row);
+    if constexpr (std::is_integral_v<TSum>) {
+      auto newSums = sums + batch;
+      overflows = overflows | ((sums ^ newSums) & (batch ^ newSums));
+      sums = newSums;
+    } else {
+      sums = sums + batch;
+    }
+  }
+  TSum lanes[kStep];
+  sums.store_unaligned(lanes);
+  bool anyOverflow = false;
+  if constexpr (std::is_integral_v<TSum>) {
+    TSum laneOverflows[kStep];
+    overflows.store_unaligned(laneOverflows);
+    for (auto i = 0; i < kStep; ++i) {
+      anyOverflow |= laneOverflows[i] < 0;
+    }
+  }
+  TSum result = 0;
+  for (auto i = 0; i < kStep; ++i) {
+    result = detail::addWithOverflow(result, lanes[i], anyOverflow);
+  }
+  for (; row < size; ++row) {
+    result = detail::addWithOverflow(result, TSum(values[row]), anyOverflow);
+  }
+  if (overflow) {
+    *overflow = anyOverflow;
+  }
+  return result;
+}
+
+template <typename T, typename A>
+T reduceMin(const T* values, int32_t size, T initial, const A&) {
+  using Batch = xsimd::batch<T, A>;
+  constexpr int32_t kStep = Batch::size;
+  auto mins = xsimd::broadcast<T, A>(initial);
+  int32_t row = 0;
+  for (; row + kStep <= size; row += kStep) {
+    mins = xsimd::min(mins, Batch::load_unaligned(values + row));
+  }
+  T lanes[kStep];
+  mins.store_unaligned(lanes);
+  T result = initial;
+  for (auto i = 0; i < kStep; ++i) {
+    result = std::min(result, lanes[i]);
+  }
+  for (; row < size; ++row) {
+    result = std::min(result, values[row]);
+  }
+  return result;
+}
+
+template <typename T, typename A>
+T reduceMax(const T* values, int32_t size, T initial, const A&) {
+  using Batch = xsimd::batch<T, A>;
+  constexpr int32_t kStep = Batch::size;
+  auto maxs = xsimd::broadcast<T, A>(initial);
+  int32_t row = 0;
+  for (; row + kStep <= size; row += kStep) {
+    maxs = xsimd::max(maxs, Batch::load_unaligned(values + row));
+  }
+  T lanes[kStep];
+  maxs.store_unaligned(lanes);
+  T result = initial;
+  for (auto i = 0; i < kStep; ++i) {
+    result = std::max(result, lanes[i]);
+  }
+  for (; row < size; ++row) {
+    result = std::max(result, values[row]);
+  }
+  return result;
+}
+
+namespace detail {
+
 template <typename T, typename A>
 struct HalfBatchImpl<T, A, std::enable_if_t<std::is_base_of_v<xsimd::avx, A>>> {
   using Type = xsimd::batch<T, xsimd::sse2>;
@@ -26,6 +26,31 @@ alignas(kPadding) int32_t permute4x64Indices[16][8];
 
 } // namespace detail
 
+void gatherBits(
+    const uint64_t* bits,
+    const int32_t* indices,
+    int32_t numIndices,
+    uint64_t* result,
+    int32_t resultOffset) {
+  int32_t i = 0;
+  // Bits up to the first byte boundary of 'result'.
+  for (; i < numIndices && (resultOffset + i) % 8 != 0; ++i) {
+    bits::setBit(result, resultOffset + i, bits::isBitSet(bits, indices[i]));
+  }
+  // gather8Bits() loads a full batch of indices and returns at most as many
+  // bits as the batch has lanes.
+  constexpr int32_t kBatchSize = xsimd::batch<int32_t>::size;
+  if constexpr (kBatchSize >= 8) {
+    auto* resultBytes = reinterpret_cast<uint8_t*>(result);
+    for (; i + kBatchSize <= numIndices; i += 8) {
+      resultBytes[(resultOffset + i) / 8] = gather8Bits(bits, indices + i, 8);
+    }
+  }
+  for (; i < numIndices; ++i) {
+    bits::setBit(result, resultOffset + i, bits::isBitSet(bits, indices[i]));
+  }
+}
+
 namespace {
 
 void initByteSetBits() {
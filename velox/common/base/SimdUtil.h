@@ -267,6 +267,17 @@ uint8_t gather8Bits(
       bits, loadGatherIndices<int32_t>(indices, arch), numIndices, arch);
 }
 
+// Sets the bits of 'result' at offsets [resultOffset, resultOffset +
+// numIndices) to the bits of 'bits' at the offsets in 'indices'. The other
+// bits of 'result' are not changed. Whole bytes of 'result' are gathered 8
+// bits at a time with gather8Bits().
+void gatherBits(
+    const uint64_t* bits,
+    const int32_t* indices,
+    int32_t numIndices,
+    uint64_t* result,
+    int32_t resultOffset = 0);
+
 namespace detail {
 template <typename T, typename A, size_t kSizeT = sizeof(T)>
 struct BitMask;
@@ -405,6 +416,26 @@ inline bool isDense(const T* values, int32_t size) {
   return (values[size - 1] - values[0] == size - 1);
 }
 
+// Returns the sum of 'values[0]' to 'values[size - 1]' as TSum, which may be
+// wider than T. The values are added in several lanes, so a floating point
+// sum may differ from a serial loop in the last bits. Integer lanes wrap
+// around on overflow. If 'overflow' is not null, it is set to true if the sum
+// of any lane or the final sum of the lanes overflowed.
+template <typename TSum, typename T, typename A = xsimd::default_arch>
+TSum reduceSum(
+    const T* values,
+    int32_t size,
+    bool* overflow = nullptr,
+    const A& = {});
+
+// Returns the smallest of 'initial' and 'values[0]' to 'values[size - 1]'.
+template <typename T, typename A = xsimd::default_arch>
+T reduceMin(const T* values, int32_t size, T initial, const A& = {});
+
+// Returns the largest of 'initial' and 'values[0]' to 'values[size - 1]'.
+template <typename T, typename A = xsimd::default_arch>
+T reduceMax(const T* values, int32_t size, T initial, const A& = {});
+
 } // namespace facebook::velox::simd
 
 #include "velox/common/base/SimdUtil-inl.h"
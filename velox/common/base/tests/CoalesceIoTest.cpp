@@ -113,3 +113,57 @@ TEST(CoalesceIoTest, basic) {
   EXPECT_EQ(1, ioGroups[2].size());
   EXPECT_EQ(1, ioGroups[3].size());
 }
+
+TEST(CoalesceIoTest, maxIoBytes) {
+  // Adjacent 100K units, which coalesce unless capped.
+  std::vector<IoUnit> data;
+  for (auto i = 0; i < 10; ++i) {
+    data.emplace_back(i * 100000, 100000, 1);
+  }
+  std::vector<int64_t> offsets;
+  auto stats = coalesceIo<IoUnit, Range>(
+      data,
+      20000,
+      1000,
+      [&](int32_t index) { return data[index].offset; },
+      [&](int32_t index) { return data[index].size; },
+      [&](int32_t index) { return data[index].numBuffers; },
+      [&](const IoUnit& item, std::vector<Range>& ranges) {
+        ranges.emplace_back(item.size, item.numBuffers);
+      },
+      [&](int32_t skip, std::vector<Range>& ranges) {
+        ranges.emplace_back(skip, 0);
+      },
+      [&](const std::vector<IoUnit>& /*items*/,
+          int32_t /*begin*/,
+          int32_t /*end*/,
+          uint64_t offset,
+          const std::vector<Range>& /*ranges*/) { offsets.push_back(offset); },
+      350000);
+  // Each IO covers 3 units since 4 would be 400000 bytes.
+  EXPECT_EQ(4, stats.numIos);
+  std::vector<int64_t> expectedOffsets{0, 300000, 600000, 900000};
+  EXPECT_EQ(expectedOffsets, offsets);
+}
+
+TEST(CoalesceIoTest, policy) {
+  // Without a profile the default gap applies and IOs are not capped.
+  auto policy = makeCoalescePolicy(IoProfile(), 512 << 10);
+  EXPECT_EQ(512 << 10, policy.maxGap);
+  EXPECT_EQ(std::numeric_limits<int64_t>::max(), policy.maxIoBytes);
+
+  // 100us at 2GB/s: reading 200KB takes as long as a new request.
+  policy = makeCoalescePolicy(IoProfile{100, 2000}, 512 << 10);
+  EXPECT_EQ(200000, policy.maxGap);
+  EXPECT_EQ(1600000, policy.maxIoBytes);
+
+  // 30ms at 100MB/s coalesces over gaps of 3MB.
+  policy = makeCoalescePolicy(IoProfile{30000, 100}, 512 << 10);
+  EXPECT_EQ(3000000, policy.maxGap);
+  EXPECT_EQ(24000000, policy.maxIoBytes);
+
+  // The gap is bounded and IOs are at least 1MB.
+  policy = makeCoalescePolicy(IoProfile{1, 10}, 512 << 10);
+  EXPECT_EQ(4 << 10, policy.maxGap);
+  EXPECT_EQ(1 << 20, policy.maxIoBytes);
+}
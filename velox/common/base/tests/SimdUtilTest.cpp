@@ -192,6 +192,33 @@ TEST_F(SimdUtilTest, gatherBits) {
   EXPECT_FALSE(bits::isBitSet(&bits, N - 1));
 }
 
+TEST_F(SimdUtilTest, gatherBitsToOffset) {
+  std::vector<uint64_t> data(8);
+  folly::Random::DefaultGenerator rng(1);
+  for (auto& word : data) {
+    word = folly::Random::rand64(rng);
+  }
+  std::vector<int32_t> indices(100);
+  for (auto& index : indices) {
+    index = folly::Random::rand32(data.size() * 64, rng);
+  }
+  for (auto offset : {0, 3, 8, 61}) {
+    for (auto numIndices : {0, 5, 8, 17, 100}) {
+      std::vector<uint64_t> result(4, ~0ULL);
+      simd::gatherBits(
+          data.data(), indices.data(), numIndices, result.data(), offset);
+      for (auto i = 0; i < result.size() * 64; ++i) {
+        const bool expected = i >= offset && i < offset + numIndices
+            ? bits::isBitSet(data.data(), indices[i - offset])
+            : true;
+        ASSERT_EQ(bits::isBitSet(result.data(), i), expected)
+            << "offset " << offset << ", numIndices " << numIndices
+            << ", bit " << i;
+      }
+    }
+  }
+}
+
 namespace {
 
 // Find elements that satisfy a condition and pack them to the left.
@@ -289,6 +316,40 @@ TEST_F(SimdUtilTest, misc) {
   EXPECT_FALSE(simd::isDense(&ints[0], 4));
 }
 
+TEST_F(SimdUtilTest, reduce) {
+  for (auto size = 0; size < 50; ++size) {
+    std::vector<int32_t> ints(size);
+    int64_t expectedSum = 0;
+    int32_t expectedMin = 7;
+    int32_t expectedMax = 7;
+    for (auto i = 0; i < size; ++i) {
+      ints[i] = (i * 1'234'567) ^ 0x5555;
+      expectedSum += ints[i];
+      expectedMin = std::min(expectedMin, ints[i]);
+      expectedMax = std::max(expectedMax, ints[i]);
+    }
+    bool overflow = true;
+    EXPECT_EQ(
+        expectedSum, simd::reduceSum<int64_t>(ints.data(), size, &overflow));
+    EXPECT_FALSE(overflow);
+    EXPECT_EQ(expectedMin, simd::reduceMin(ints.data(), size, 7));
+    EXPECT_EQ(expectedMax, simd::reduceMax(ints.data(), size, 7));
+  }
+
+  std::vector<int64_t> longs(20, std::numeric_limits<int64_t>::max() / 3);
+  bool overflow = false;
+  simd::reduceSum<int64_t>(longs.data(), longs.size(), &overflow);
+  EXPECT_TRUE(overflow);
+  overflow = false;
+  EXPECT_EQ(
+      2 * (std::numeric_limits<int64_t>::max() / 3),
+      simd::reduceSum<int64_t>(longs.data(), 2, &overflow));
+  EXPECT_FALSE(overflow);
+
+  std::vector<double> doubles = {1.5, 2.5, -1, 4, 8, 0.25, 3};
+  EXPECT_EQ(18.25, simd::reduceSum<double>(doubles.data(), doubles.size()));
+}
+
 TEST_F(SimdUtilTest, memory) {
   for (auto size = 0; size < 150; ++size) {
     testMemsetAndMemcpy(size);
@@ -19,7 +19,11 @@
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/caching/SsdCache.h"
 
+#include <algorithm>
+
+#include <folly/compression/Compression.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
+#include <folly/io/IOBuf.h>
 #include "velox/common/caching/FileIds.h"
 
 namespace facebook::velox::cache {
@@ -27,14 +31,64 @@ namespace facebook::velox::cache {
 using memory::MachinePageCount;
 using memory::MappedMemory;
 
+namespace {
+// Returns an IOBuf chain over the first 'size' bytes of 'data'.
+std::unique_ptr<folly::IOBuf> wrapAllocation(
+    const MappedMemory::Allocation& data,
+    uint64_t size) {
+  std::unique_ptr<folly::IOBuf> result;
+  uint64_t offset = 0;
+  for (auto i = 0; i < data.numRuns() && offset < size; ++i) {
+    auto run = data.runAt(i);
+    const auto bytes = std::min<uint64_t>(run.numBytes(), size - offset);
+    auto buffer = folly::IOBuf::wrapBuffer(run.data<char>(), bytes);
+    if (result) {
+      result->prependChain(std::move(buffer));
+    } else {
+      result = std::move(buffer);
+    }
+    offset += bytes;
+  }
+  VELOX_CHECK_EQ(offset, size);
+  return result;
+}
+
+// Copies the bytes of 'from' to the start of 'to'.
+void copyToAllocation(const folly::IOBuf& from, MappedMemory::Allocation& to) {
+  int32_t runIndex = 0;
+  uint64_t offsetInRun = 0;
+  for (const auto& range : from) {
+    uint64_t copied = 0;
+    while (copied < range.size()) {
+      VELOX_CHECK_LT(runIndex, to.numRuns());
+      auto run = to.runAt(runIndex);
+      const auto bytes =
+          std::min(run.numBytes() - offsetInRun, range.size() - copied);
+      memcpy(run.data<char>() + offsetInRun, range.data() + copied, bytes);
+      copied += bytes;
+      offsetInRun += bytes;
+      if (offsetInRun == run.numBytes()) {
+        ++runIndex;
+        offsetInRun = 0;
+      }
+    }
+  }
+}
+
+MachinePageCount bytesToPages(uint64_t bytes) {
+  return bits::roundUp(bytes, MappedMemory::kPageSize) /
+      MappedMemory::kPageSize;
+}
+} // namespace
+
 AsyncDataCacheEntry::AsyncDataCacheEntry(CacheShard* shard)
     : shard_(shard), data_(shard->cache()) {
   accessStats_.reset();
 }
 
-void AsyncDataCacheEntry::setExclusiveToShared() {
+void AsyncDataCacheEntry::setExclusiveTo(int32_t numPins) {
   VELOX_CHECK(isExclusive());
-  numPins_ = 1;
+  numPins_ = numPins;
   std::unique_ptr<folly::SharedPromise<bool>> promise;
   {
     std::lock_guard<std::mutex> l(shard_->mutex());
@@ -45,6 +99,10 @@ void AsyncDataCacheEntry::setExclusiveToShared() {
   if (promise) {
     promise->setValue(true);
   }
+}
+
+void AsyncDataCacheEntry::setExclusiveToShared() {
+  setExclusiveTo(1);
 
   // The entry may now have other readers, It is safe to do read-only
   // ops like integrity and notifying SSD cache of another candidate.
@@ -95,9 +153,110 @@ memory::MachinePageCount AsyncDataCacheEntry::setPrefetch(bool flag) {
   return shard_->cache()->incrementPrefetchPages(flag ? numPages : -numPages);
 }
 
+bool AsyncDataCacheEntry::compress() {
+  VELOX_CHECK(isExclusive());
+  VELOX_CHECK_EQ(0, compressedSize_);
+  auto codec = folly::io::getCodec(folly::io::CodecType::LZ4);
+  auto compressed = codec->compress(wrapAllocation(data_, size_).get());
+  const auto compressedSize = compressed->computeChainDataLength();
+  // The savings are in whole pages.
+  const auto numPages = bytesToPages(compressedSize);
+  if (numPages * 100 > data_.numPages() * (100 - kMinCompressionSavingsPct)) {
+    compressible_ = false;
+    return false;
+  }
+  auto cache = shard_->cache();
+  MappedMemory::Allocation newData(cache);
+  {
+    ClockTimer t(shard_->allocClocks());
+    if (!cache->allocateWithoutEviction(
+            numPages, CacheShard::kCacheOwner, newData)) {
+      return false;
+    }
+  }
+  copyToAllocation(*compressed, newData);
+  const int64_t pagesDelta =
+      static_cast<int64_t>(newData.numPages()) - data_.numPages();
+  std::swap(data_, newData);
+  {
+    ClockTimer t(shard_->allocClocks());
+    cache->free(newData);
+  }
+  cache->incrementCachedPages(pagesDelta);
+  compressedSize_ = compressedSize;
+  return true;
+}
+
+void AsyncDataCacheEntry::decompress() {
+  VELOX_CHECK(isExclusive());
+  VELOX_CHECK_GT(compressedSize_, 0);
+  auto codec = folly::io::getCodec(folly::io::CodecType::LZ4);
+  auto decompressed =
+      codec->uncompress(wrapAllocation(data_, compressedSize_).get(), size_);
+  auto cache = shard_->cache();
+  MappedMemory::Allocation newData(cache);
+  {
+    ClockTimer t(shard_->allocClocks());
+    if (!cache->allocate(
+            bytesToPages(size_), CacheShard::kCacheOwner, newData)) {
+      _VELOX_THROW(
+          VeloxRuntimeError,
+          error_source::kErrorSourceRuntime.c_str(),
+          error_code::kNoCacheSpace.c_str(),
+          /* isRetriable */ true,
+          "Failed to allocate {} bytes for decompressing cache entry",
+          size_);
+    }
+  }
+  copyToAllocation(*decompressed, newData);
+  const int64_t pagesDelta =
+      static_cast<int64_t>(newData.numPages()) - data_.numPages();
+  std::swap(data_, newData);
+  {
+    ClockTimer t(shard_->allocClocks());
+    cache->free(newData);
+  }
+  cache->incrementCachedPages(pagesDelta);
+  compressedSize_ = 0;
+}
+
+void AsyncDataCacheEntry::setTenant(int32_t tenant) {
+  VELOX_CHECK_GE(tenant, 0);
+  VELOX_CHECK_LT(tenant, AsyncDataCache::kMaxTenants);
+  if (tenant == tenant_) {
+    return;
+  }
+  auto cache = shard_->cache();
+  if (tenantPinned_) {
+    cache->tryIncrementTenantPinnedBytes(tenant_, -size_);
+    tenantPinned_ = false;
+  }
+  if (tenant_) {
+    cache->incrementTenantBytes(tenant_, -size_);
+  }
+  if (tenant) {
+    cache->incrementTenantBytes(tenant, size_);
+  }
+  tenant_ = tenant;
+}
+
+bool AsyncDataCacheEntry::pinForTenant() {
+  if (tenantPinned_) {
+    return true;
+  }
+  if (!tenant_ ||
+      !shard_->cache()->tryIncrementTenantPinnedBytes(tenant_, size_)) {
+    return false;
+  }
+  tenantPinned_ = true;
+  return true;
+}
+
 void AsyncDataCacheEntry::initialize(FileCacheKey key) {
   VELOX_CHECK(isExclusive());
   setSsdFile(nullptr, 0);
+  compressible_ = false;
+  compressedSize_ = 0;
   key_ = std::move(key);
   auto cache = shard_->cache();
   ClockTimer t(shard_->allocClocks());
@@ -125,10 +284,11 @@ void AsyncDataCacheEntry::initialize(FileCacheKey key) {
 
 std::string AsyncDataCacheEntry::toString() const {
   return fmt::format(
-      "<entry key:{}:{} size {} pins {}>",
+      "<entry key:{}:{} size {} compressed {} pins {}>",
       key_.fileNum.id(),
       key_.offset,
       size_,
+      compressedSize_,
       numPins_);
 }
 
@@ -147,11 +307,16 @@ std::unique_ptr<AsyncDataCacheEntry> CacheShard::getFreeEntryWithSize(
 CachePin CacheShard::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
-    folly::SemiFuture<bool>* wait) {
+    folly::SemiFuture<bool>* wait,
+    int32_t tenant) {
+  VELOX_CHECK_GE(tenant, 0);
+  VELOX_CHECK_LT(tenant, kMaxCacheTenants);
   AsyncDataCacheEntry* entryToInit = nullptr;
+  AsyncDataCacheEntry* entryToDecompress = nullptr;
   {
     std::lock_guard<std::mutex> l(mutex_);
     ++eventCounter_;
+    const auto hash = std::hash<RawFileCacheKey>()(key);
     auto it = entryMap_.find(key);
     if (it != entryMap_.end()) {
       auto found = it->second;
@@ -171,39 +336,66 @@ CachePin CacheShard::findOrCreate(
           found->setPrefetch(false);
         } else {
           ++numHit_;
+          ++tenantHits_[tenant];
+          frequency_.increment(hash);
+          found->admitted_ = true;
         }
-        ++found->numPins_;
-        CachePin pin;
-        pin.setEntry(found);
-        return pin;
+        if (!found->isCompressed()) {
+          ++found->numPins_;
+          CachePin pin;
+          pin.setEntry(found);
+          return pin;
+        }
+        // Other threads wait for the decompression like for a load.
+        found->numPins_ = AsyncDataCacheEntry::kExclusive;
+        entryToDecompress = found;
+      } else {
+        // This can happen if different load quanta apply to access via
+        // different connectors. This is not an error but still worth
+        // logging.
+        LOG_EVERY_N(INFO, 100) << "Requested larger entry. Found size "
+                               << found->size() << " requested size " << size;
+        // The old entry is superseded. Possible readers of the old
+        // entry still retain a valid read pin.
+        found->key_.fileNum.clear();
       }
-      // This can happen if different load quanta apply to access via
-      // different connectors. This is not an error but still worth
-      // logging.
-      LOG_EVERY_N(INFO, 100) << "Requested larger entry. Found size "
-                             << found->size() << " requested size " << size;
-      // The old entry is superseded. Possible readers of the old
-      // entry still retain a valid read pin.
-      found->key_.fileNum.clear();
-    }
-    auto newEntry = getFreeEntryWithSize(size);
-    // Initialize the members that must be set inside 'mutex_'.
-    newEntry->numPins_ = AsyncDataCacheEntry::kExclusive;
-    newEntry->promise_ = nullptr;
-    entryToInit = newEntry.get();
-    entryMap_[key] = newEntry.get();
-    if (emptySlots_.empty()) {
-      entries_.push_back(std::move(newEntry));
-    } else {
-      auto index = emptySlots_.back();
-      emptySlots_.pop_back();
-      entries_[index] = std::move(newEntry);
     }
-    ++numNew_;
-    // Inside the shard mutex.
-    VELOX_CHECK_EQ(0, entryToInit->size_);
-    entryToInit->size_ = size;
-    entryToInit->isFirstUse_ = true;
+    if (!entryToDecompress) {
+      auto newEntry = getFreeEntryWithSize(size);
+      // Initialize the members that must be set inside 'mutex_'.
+      newEntry->numPins_ = AsyncDataCacheEntry::kExclusive;
+      newEntry->promise_ = nullptr;
+      entryToInit = newEntry.get();
+      if (it == entryMap_.end()) {
+        ++fileEntryCounts_[key.fileNum];
+      }
+      entryMap_[key] = newEntry.get();
+      if (emptySlots_.empty()) {
+        entries_.push_back(std::move(newEntry));
+      } else {
+        auto index = emptySlots_.back();
+        emptySlots_.pop_back();
+        entries_[index] = std::move(newEntry);
+      }
+      ++numNew_;
+      ++tenantNew_[tenant];
+      frequency_.increment(hash);
+      entryToInit->admitted_ = !cache_->filterAdmission() ||
+          frequency_.estimate(hash) >= kMinAdmitFrequency;
+      if (entryToInit->admitted_) {
+        ++numAdmit_;
+      } else {
+        ++numReject_;
+      }
+      // Inside the shard mutex.
+      VELOX_CHECK_EQ(0, entryToInit->size_);
+      entryToInit->size_ = size;
+      entryToInit->isFirstUse_ = true;
+      entryToInit->setTenant(tenant);
+    }
+  }
+  if (entryToDecompress) {
+    return decompressEntry(entryToDecompress);
   }
   return initEntry(key, entryToInit);
 }
@@ -218,6 +410,18 @@ bool CacheShard::exists(RawFileCacheKey key) const {
   return false;
 }
 
+bool CacheShard::isFileCached(uint64_t fileNum) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return fileEntryCounts_.count(fileNum) != 0;
+}
+
+void CacheShard::appendFileNums(std::vector<uint64_t>& fileNums) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (const auto& [fileNum, count] : fileEntryCounts_) {
+    fileNums.push_back(fileNum);
+  }
+}
+
 CachePin CacheShard::initEntry(
     RawFileCacheKey key,
     AsyncDataCacheEntry* entry) {
@@ -235,6 +439,42 @@ CachePin CacheShard::initEntry(
   return pin;
 }
 
+CachePin CacheShard::decompressEntry(AsyncDataCacheEntry* entry) {
+  // If decompress() throws, 'pin' removes the exclusive 'entry'.
+  CachePin pin;
+  pin.setEntry(entry);
+  entry->decompress();
+  ++numDecompress_;
+  entry->setExclusiveTo(1);
+  return pin;
+}
+
+bool CacheShard::shouldCompressLocked(
+    const AsyncDataCacheEntry& entry,
+    bool evictAllUnpinned) const {
+  // Prefetched entries are about to be read and SSD saveable ones are about
+  // to be written in their decompressed form.
+  return entry.compressible_ && !entry.isCompressed() && !evictAllUnpinned &&
+      entry.key_.fileNum.hasValue() && entry.admitted_ &&
+      !entry.isPrefetch_ && !entry.ssdSaveable_ && entry.data_.numPages() > 0;
+}
+
+void CacheShard::compressEntries(
+    const std::vector<AsyncDataCacheEntry*>& entries) {
+  for (auto* entry : entries) {
+    try {
+      if (entry->compress()) {
+        ++numCompress_;
+      }
+    } catch (const std::exception& e) {
+      // The entry stays valid in its decompressed form.
+      LOG(WARNING) << "Failed to compress cache entry: " << e.what();
+      entry->compressible_ = false;
+    }
+    entry->setExclusiveTo(0);
+  }
+}
+
 CoalescedLoad::~CoalescedLoad() {
   // Continue possibly waiting threads.
   setEndState(LoadState::kCancelled);
@@ -295,11 +535,18 @@ void CacheShard::removeEntry(AsyncDataCacheEntry* entry) {
 }
 
 void CacheShard::removeEntryLocked(AsyncDataCacheEntry* entry) {
+  // A superseded entry has no key but is still accounted to its tenant.
+  entry->setTenant(0);
   if (entry->key_.fileNum.hasValue()) {
     auto removeIter = entryMap_.find(
         RawFileCacheKey{entry->key_.fileNum.id(), entry->key_.offset});
     VELOX_CHECK(removeIter != entryMap_.end());
     entryMap_.erase(removeIter);
+    auto countIter = fileEntryCounts_.find(entry->key_.fileNum.id());
+    VELOX_CHECK(countIter != fileEntryCounts_.end());
+    if (--countIter->second == 0) {
+      fileEntryCounts_.erase(countIter);
+    }
     entry->key_.fileNum.clear();
     entry->setSsdFile(nullptr, 0);
     if (entry->isPrefetch()) {
@@ -325,17 +572,34 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
   bool skipSsdSaveable = ssdCache && ssdCache->writeInProgress();
   auto now = accessTime();
   std::vector<MappedMemory::Allocation> toFree;
+  std::vector<AsyncDataCacheEntry*> toCompress;
   {
     std::lock_guard<std::mutex> l(mutex_);
     int size = entries_.size();
     if (!size) {
       return;
     }
+    if (!evictAllUnpinned && cache_->anyTenantOverQuota()) {
+      // The entries of a tenant over quota go regardless of their score.
+      // Soft pins do not protect these either.
+      for (auto i = 0; i < size && largeFreed + tinyFreed <= bytesToFree;
+           ++i) {
+        auto candidate = entries_[i].get();
+        if (!candidate || candidate->numPins_ != 0 ||
+            !candidate->key_.fileNum.hasValue() ||
+            !cache_->isTenantOverQuota(candidate->tenant_)) {
+          continue;
+        }
+        ++numEvictChecks_;
+        ++numQuotaEvict_;
+        evictEntryLocked(i, 0, toFree, tinyFreed, largeFreed);
+      }
+    }
     int32_t counter = 0;
     int32_t numChecked = 0;
     auto entryIndex = (clockHand_ % size);
     auto iter = entries_.begin() + entryIndex;
-    while (++counter <= size) {
+    while (largeFreed + tinyFreed <= bytesToFree && ++counter <= size) {
       if (++iter == entries_.end()) {
         iter = entries_.begin();
         entryIndex = 0;
@@ -360,33 +624,34 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
       int32_t score = 0;
       if (candidate->numPins_ == 0 &&
           (!candidate->key_.fileNum.hasValue() || evictAllUnpinned ||
+           !candidate->admitted_ ||
            (score = candidate->score(now)) >= evictionThreshold_)) {
         if (skipSsdSaveable && candidate->ssdSaveable_ && !evictAllUnpinned) {
           ++evictSaveableSkipped;
           continue;
         }
-        largeFreed += candidate->data_.byteSize();
-        toFree.push_back(std::move(candidate->data()));
-        removeEntryLocked(candidate);
-        freeEntries_.push_back(std::move(*iter));
-        emptySlots_.push_back(entryIndex);
-        tinyFreed += candidate->tinyData_.size();
-        candidate->tinyData_.clear();
-        candidate->size_ = 0;
-        ++numEvict_;
-        if (score) {
-          sumEvictScore_ += score;
+        if (!evictAllUnpinned && candidate->key_.fileNum.hasValue() &&
+            candidate->tenantPinned_ &&
+            cache_->isTenantPinned(candidate->tenant_)) {
+          continue;
         }
-        if (largeFreed + tinyFreed > bytesToFree) {
-          break;
+        if (shouldCompressLocked(*candidate, evictAllUnpinned)) {
+          // Made unpinned again by compressEntries().
+          candidate->numPins_ = AsyncDataCacheEntry::kExclusive;
+          toCompress.push_back(candidate);
+          continue;
         }
+        evictEntryLocked(entryIndex, score, toFree, tinyFreed, largeFreed);
       }
     }
   }
-  ClockTimer t(allocClocks_);
-  toFree.clear();
+  {
+    ClockTimer t(allocClocks_);
+    toFree.clear();
+  }
   cache_->incrementCachedPages(
       -largeFreed / static_cast<int32_t>(MappedMemory::kPageSize));
+  compressEntries(toCompress);
   if (evictSaveableSkipped && ssdCache && ssdCache->startWrite()) {
     // Rare. May occur if SSD is unusually slow. Useful for  diagnostics.
     LOG(INFO) << "SSDCA: Start save for old saveable, skipped "
@@ -398,6 +663,27 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
   }
 }
 
+void CacheShard::evictEntryLocked(
+    int32_t index,
+    int32_t score,
+    std::vector<MappedMemory::Allocation>& toFree,
+    int64_t& tinyFreed,
+    int64_t& largeFreed) {
+  auto candidate = entries_[index].get();
+  largeFreed += candidate->data_.byteSize();
+  toFree.push_back(std::move(candidate->data()));
+  removeEntryLocked(candidate);
+  freeEntries_.push_back(std::move(entries_[index]));
+  emptySlots_.push_back(index);
+  tinyFreed += candidate->tinyData_.size();
+  candidate->tinyData_.clear();
+  candidate->size_ = 0;
+  ++numEvict_;
+  if (score) {
+    sumEvictScore_ += score;
+  }
+}
+
 void CacheShard::calibrateThreshold() {
   auto numSamples = std::min<int32_t>(10, entries_.size());
   auto now = accessTime();
@@ -437,10 +723,23 @@ void CacheShard::updateStats(CacheStats& stats) {
       stats.prefetchBytes += entry->size();
     }
     ++stats.numEntries;
+    if (entry->tenantPinned_) {
+      stats.tenantPinnedBytes += entry->size_;
+    }
     stats.tinySize += entry->tinyData_.size();
     stats.tinyPadding += entry->tinyData_.capacity() - entry->tinyData_.size();
-    stats.largeSize += entry->size_;
-    stats.largePadding += entry->data_.byteSize() - entry->size_;
+    if (entry->isCompressed()) {
+      ++stats.numCompressed;
+      stats.compressionSavings +=
+          bytesToPages(entry->size_) * MappedMemory::kPageSize -
+          entry->data_.byteSize();
+      stats.largeSize += entry->compressedSize_;
+      stats.largePadding +=
+          entry->data_.byteSize() - entry->compressedSize_;
+    } else {
+      stats.largeSize += entry->size_;
+      stats.largePadding += entry->data_.byteSize() - entry->size_;
+    }
   }
   stats.numHit += numHit_;
   stats.numNew += numNew_;
@@ -448,6 +747,15 @@ void CacheShard::updateStats(CacheStats& stats) {
   stats.numEvictChecks += numEvictChecks_;
   stats.numWaitExclusive += numWaitExclusive_;
   stats.sumEvictScore += sumEvictScore_;
+  stats.numAdmit += numAdmit_;
+  stats.numReject += numReject_;
+  stats.numCompress += numCompress_;
+  stats.numDecompress += numDecompress_;
+  stats.numQuotaEvict += numQuotaEvict_;
+  for (auto i = 0; i < kMaxCacheTenants; ++i) {
+    stats.tenants[i].numHit += tenantHits_[i];
+    stats.tenants[i].numNew += tenantNew_[i];
+  }
   stats.allocClocks += allocClocks_;
 }
 
@@ -460,7 +768,7 @@ void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
   VELOX_CHECK(cache_->ssdCache()->writeInProgress());
   for (auto& entry : entries_) {
     if (entry && !entry->ssdFile_ && !entry->isExclusive() &&
-        entry->ssdSaveable_) {
+        entry->ssdSaveable_ && !entry->isCompressed()) {
       CachePin pin;
       ++entry->numPins_;
       pin.setEntry(entry.get());
@@ -487,12 +795,53 @@ AsyncDataCache::AsyncDataCache(
   }
 }
 
+void AsyncDataCache::setTenantBudget(int32_t tenant, int64_t bytes) {
+  VELOX_CHECK_GT(tenant, 0);
+  VELOX_CHECK_LT(tenant, kMaxTenants);
+  VELOX_CHECK_GE(bytes, 0);
+  tenantBudget_[tenant] = bytes;
+}
+
+void AsyncDataCache::setTenantQuota(int32_t tenant, int64_t bytes) {
+  VELOX_CHECK_GT(tenant, 0);
+  VELOX_CHECK_LT(tenant, kMaxTenants);
+  VELOX_CHECK_GE(bytes, 0);
+  tenantQuota_[tenant] = bytes;
+}
+
+bool AsyncDataCache::anyTenantOverQuota() const {
+  for (auto tenant = 1; tenant < kMaxTenants; ++tenant) {
+    if (isTenantOverQuota(tenant)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AsyncDataCache::tryIncrementTenantPinnedBytes(
+    int32_t tenant,
+    int64_t bytes) {
+  auto& pinned = tenantPinnedBytes_[tenant];
+  if (bytes < 0) {
+    pinned += bytes;
+    return true;
+  }
+  auto current = pinned.load();
+  do {
+    if (current + bytes > tenantBudget_[tenant]) {
+      return false;
+    }
+  } while (!pinned.compare_exchange_weak(current, current + bytes));
+  return true;
+}
+
 CachePin AsyncDataCache::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
-    folly::SemiFuture<bool>* wait) {
+    folly::SemiFuture<bool>* wait,
+    int32_t tenant) {
   int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
-  return shards_[shard]->findOrCreate(key, size, wait);
+  return shards_[shard]->findOrCreate(key, size, wait, tenant);
 }
 
 bool AsyncDataCache::exists(RawFileCacheKey key) const {
@@ -500,6 +849,38 @@ bool AsyncDataCache::exists(RawFileCacheKey key) const {
   return shards_[shard]->exists(key);
 }
 
+bool AsyncDataCache::isFileCached(uint64_t fileNum) const {
+  // The entries of a file are spread over all shards.
+  for (auto& shard : shards_) {
+    if (shard->isFileCached(fileNum)) {
+      return true;
+    }
+  }
+  return ssdCache_ && ssdCache_->isFileCached(fileNum);
+}
+
+BloomFilter<> AsyncDataCache::cachedFilesFilter() const {
+  std::vector<uint64_t> fileNums;
+  for (auto& shard : shards_) {
+    shard->appendFileNums(fileNums);
+  }
+  if (ssdCache_) {
+    ssdCache_->appendFileNums(fileNums);
+  }
+  std::sort(fileNums.begin(), fileNums.end());
+  fileNums.erase(
+      std::unique(fileNums.begin(), fileNums.end()), fileNums.end());
+  BloomFilter<> filter;
+  filter.reset(fileNums.size());
+  for (auto fileNum : fileNums) {
+    const auto path = fileIds().string(fileNum);
+    if (!path.empty()) {
+      filter.insert(filePathHash(path));
+    }
+  }
+  return filter;
+}
+
 bool AsyncDataCache::makeSpace(
     MachinePageCount numPages,
     std::function<bool()> allocate) {
@@ -612,6 +993,15 @@ bool AsyncDataCache::allocateContiguous(
   });
 }
 
+bool AsyncDataCache::growContiguous(
+    MachinePageCount increment,
+    ContiguousAllocation& allocation,
+    std::function<void(int64_t, bool)> beforeAllocCB) {
+  return makeSpace(increment, [&]() {
+    return mappedMemory_->growContiguous(increment, allocation, beforeAllocCB);
+  });
+}
+
 void* FOLLY_NULLABLE
 AsyncDataCache::allocateBytes(uint64_t bytes, uint64_t maxMallocSize) {
   void* result = nullptr;
@@ -667,6 +1057,9 @@ CacheStats AsyncDataCache::refreshStats() const {
   for (auto& shard : shards_) {
     shard->updateStats(stats);
   }
+  for (auto i = 0; i < kMaxTenants; ++i) {
+    stats.tenants[i].bytes = tenantBytes_[i];
+  }
   return stats;
 }
 
@@ -684,7 +1077,10 @@ std::string AsyncDataCache::toString() const {
           stats.largePadding
       << " / " << maxBytes_ << " bytes\n"
       << "Miss: " << stats.numNew << " Hit " << stats.numHit << " evict "
-      << stats.numEvict << "\n"
+      << stats.numEvict << " quota evict " << stats.numQuotaEvict
+      << " admit " << stats.numAdmit << " reject "
+      << stats.numReject << " compressed " << stats.numCompressed
+      << " saving " << stats.compressionSavings << " bytes\n"
       << " read pins " << stats.numShared << " write pins "
       << stats.numExclusive << " unused prefetch " << stats.numPrefetch
       << " Alloc Megaclocks " << (stats.allocClocks >> 20)
@@ -707,7 +1103,8 @@ CoalesceIoStats readPins(
         int32_t begin,
         int32_t end,
         uint64_t offset,
-        const std::vector<folly::Range<char*>>& buffers)> readFunc) {
+        const std::vector<folly::Range<char*>>& buffers)> readFunc,
+    int64_t maxIoBytes) {
   return coalesceIo<CachePin, folly::Range<char*>>(
       pins,
       maxGap,
@@ -743,7 +1140,8 @@ CoalesceIoStats readPins(
         // without actually allocating a buffer for it.
         ranges.push_back(folly::Range<char*>(nullptr, (char*)(uint64_t)size));
       },
-      readFunc);
+      readFunc,
+      maxIoBytes);
 }
 
 } // namespace facebook::velox::cache
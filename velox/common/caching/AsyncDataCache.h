@@ -16,15 +16,18 @@
 
 #pragma once
 
+#include <array>
 #include <deque>
 
 #include <fmt/format.h>
 #include <folly/chrono/Hardware.h>
 #include <folly/futures/SharedPromise.h>
 #include "velox/common/base/BitUtil.h"
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/base/CoalesceIo.h"
 #include "velox/common/base/SelectivityInfo.h"
 #include "velox/common/caching/FileGroupStats.h"
+#include "velox/common/caching/FrequencySketch.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/caching/StringIdMap.h"
 #include "velox/common/file/File.h"
@@ -37,6 +40,10 @@ class CacheShard;
 class SsdCache;
 class SsdFile;
 
+// Number of cache tenant ids, including the 0 of no tenant. See
+// AsyncDataCache::setTenantQuota().
+constexpr int32_t kMaxCacheTenants = 16;
+
 // Type for tracking last access. This is based on CPU clock and
 // scaled to be around 1ms resolution. This can wrap around and is
 // only comparable to other values of the same type. This is a
@@ -134,6 +141,9 @@ class AsyncDataCacheEntry {
  public:
   static constexpr int32_t kExclusive = -10000;
   static constexpr int32_t kTinyDataSize = 2048;
+  // Minimum percentage of memory that compressing a cold entry must save
+  // for the entry to be kept compressed.
+  static constexpr int32_t kMinCompressionSavingsPct = 30;
 
   explicit AsyncDataCacheEntry(CacheShard* FOLLY_NONNULL shard);
 
@@ -231,12 +241,55 @@ class AsyncDataCacheEntry {
     groupId_ = groupId;
   }
 
+  // Allows keeping 'this' LZ4 compressed while unpinned. Set by the reader
+  // for streams that are seldom read after being referenced.
+  void setCompressible(bool flag) {
+    compressible_ = flag;
+  }
+
+  // Accounts 'this' to the bytes of 'tenant'. See
+  // AsyncDataCache::setTenantQuota(). 0 clears the tenant and its soft pin.
+  // Must be exclusive or called inside the mutex of 'shard_'.
+  void setTenant(int32_t tenant);
+
+  int32_t tenant() const {
+    return tenant_;
+  }
+
+  // Soft-pins 'this' for its tenant if this fits in the tenant's budget. See
+  // AsyncDataCache::setTenantBudget(). Returns true if 'this' is now held for
+  // the tenant.
+  bool pinForTenant();
+
+  bool isTenantPinned() const {
+    return tenantPinned_;
+  }
+
+  // True if 'data_' holds the LZ4 compression of the 'size_' bytes of
+  // 'this'. A compressed entry is decompressed before being pinned.
+  bool isCompressed() const {
+    return compressedSize_ > 0;
+  }
+
   std::string toString() const;
 
  private:
   void release();
   void addReference();
 
+  // Sets the pin count of an exclusive 'this' to 'numPins' and realizes the
+  // promise of threads waiting for 'this'.
+  void setExclusiveTo(int32_t numPins);
+
+  // Replaces 'data_' with its LZ4 compression if this saves at least
+  // kMinCompressionSavingsPct of the memory. Returns true if compressed.
+  // Clears 'compressible_' if the data does not compress. Must be exclusive.
+  bool compress();
+
+  // Replaces the compressed 'data_' with the decompressed data. Must be
+  // exclusive. Throws if out of memory.
+  void decompress();
+
   // Returns a future that will be realized when a caller can retry
   // getting 'this'. Must be called inside the mutex of 'shard_'.
   folly::SemiFuture<bool> getFuture() {
@@ -295,6 +348,23 @@ class AsyncDataCacheEntry {
   // True if this should be saved to SSD.
   bool ssdSaveable_{false};
 
+  // False if the key of 'this' was too infrequently accessed to pass the
+  // admission filter of 'shard_' when 'this' was created. Such an entry is
+  // evicted at first sight when not pinned. Set to true on the first hit.
+  bool admitted_{true};
+
+  // See setCompressible().
+  bool compressible_{false};
+
+  // Size of the compressed data in 'data_', 0 if not compressed.
+  int32_t compressedSize_{0};
+
+  // Tenant whose query created 'this', 0 if none.
+  int32_t tenant_{0};
+
+  // True if 'this' counts against the soft pinning budget of 'tenant_'.
+  bool tenantPinned_{false};
+
   friend class CacheShard;
   friend class CachePin;
 };
@@ -479,6 +549,34 @@ struct CacheStats {
   // Sum of scores of evicted entries. This serves to infer an average
   // lifetime for entries in cache.
   int64_t sumEvictScore{};
+  // Number of new entries that passed the admission filter.
+  int64_t numAdmit{};
+  // Number of new entries that did not pass the admission filter and are
+  // evicted first.
+  int64_t numReject{};
+  // Number of entries held compressed.
+  int32_t numCompressed{};
+  // Memory saved by holding entries compressed.
+  int64_t compressionSavings{};
+  // Number of times a cold entry was compressed instead of evicted.
+  int64_t numCompress{};
+  // Number of times a compressed entry was decompressed on hit.
+  int64_t numDecompress{};
+  // Total size of entries soft-pinned for a tenant.
+  int64_t tenantPinnedBytes{};
+  // Number of entries evicted because their tenant was over its quota.
+  int64_t numQuotaEvict{};
+
+  struct TenantStats {
+    // Hits and new entries for the queries of the tenant.
+    int64_t numHit{};
+    int64_t numNew{};
+    // Size of the entries accounted to the tenant.
+    int64_t bytes{};
+  };
+
+  // Indexed by tenant. Index 0 covers the queries that have no tenant.
+  std::array<TenantStats, kMaxCacheTenants> tenants{};
 };
 // Collection of cache entries whose key hashes to the same shard of
 // the hash number space.  The cache population is divided into shards
@@ -488,17 +586,33 @@ class CacheShard {
  public:
   static constexpr int32_t kCacheOwner = -4;
 
-  explicit CacheShard(AsyncDataCache* FOLLY_NONNULL cache) : cache_(cache) {}
+  // Number of counters per row in the frequency sketch of the admission
+  // filter.
+  static constexpr int32_t kFrequencySketchWidth = 8192;
+
+  // Minimum estimated number of recent accesses for a new entry to be
+  // admitted when the cache is filtering admission.
+  static constexpr int32_t kMinAdmitFrequency = 2;
+
+  explicit CacheShard(AsyncDataCache* FOLLY_NONNULL cache)
+      : cache_(cache), frequency_(kFrequencySketchWidth) {}
 
   // See AsyncDataCache::findOrCreate.
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
-      folly::SemiFuture<bool>* FOLLY_NULLABLE readyFuture);
+      folly::SemiFuture<bool>* FOLLY_NULLABLE readyFuture,
+      int32_t tenant);
 
   // Returns true if there is an entry for 'key'. Updates access time.
   bool exists(RawFileCacheKey key) const;
 
+  // Returns true if 'this' has an entry for 'fileNum'.
+  bool isFileCached(uint64_t fileNum) const;
+
+  // Appends the file numbers that have entries in 'this' to 'fileNums'.
+  void appendFileNums(std::vector<uint64_t>& fileNums) const;
+
   AsyncDataCache* FOLLY_NONNULL cache() {
     return cache_;
   }
@@ -507,10 +621,10 @@ class CacheShard {
   }
 
   // removes 'bytesToFree' worth of entries or as many entries as are
-  // not pinned. This favors first removing older and less frequently
-  // used entries. If 'evictAllUnpinned' is true, anything that is
-  // not pinned is evicted at first sight. This is for out of memory
-  // emergencies.
+  // not pinned. The entries of tenants over their quota go first. This
+  // then favors removing older and less frequently used entries. If
+  // 'evictAllUnpinned' is true, anything that is not pinned is evicted at
+  // first sight. This is for out of memory emergencies.
   void evict(uint64_t bytesToFree, bool evictAllUnpinned);
 
   // Removes 'entry' from 'this'.
@@ -526,6 +640,10 @@ class CacheShard {
   // calling this a second time.
   void appendSsdSaveable(std::vector<CachePin>& pins);
 
+  // Compresses the entries that evict() set aside, after which they are
+  // again unpinned. Called without 'mutex_'.
+  void compressEntries(const std::vector<AsyncDataCacheEntry*>& entries);
+
   auto& allocClocks() {
     return allocClocks_;
   }
@@ -535,6 +653,15 @@ class CacheShard {
 
   void calibrateThreshold();
 
+  // Removes the unpinned entry at 'index' in 'entries_' and moves its data
+  // to 'toFree'. Adds the freed bytes to 'tinyFreed' and 'largeFreed'.
+  void evictEntryLocked(
+      int32_t index,
+      int32_t score,
+      std::vector<memory::MappedMemory::Allocation>& toFree,
+      int64_t& tinyFreed,
+      int64_t& largeFreed);
+
   void removeEntryLocked(AsyncDataCacheEntry* FOLLY_NONNULL entry);
 
   // Returns an unused entry if found. 'size' is a hint for selecting an entry
@@ -545,9 +672,21 @@ class CacheShard {
       RawFileCacheKey key,
       AsyncDataCacheEntry* FOLLY_NONNULL entry);
 
+  // Decompresses an entry found compressed by findOrCreate() and returns it
+  // pinned for shared access.
+  CachePin decompressEntry(AsyncDataCacheEntry* FOLLY_NONNULL entry);
+
+  // True if evict() should compress 'entry' instead of evicting it. An
+  // entry that stays cold while compressed is evicted on the next round.
+  bool shouldCompressLocked(
+      const AsyncDataCacheEntry& entry,
+      bool evictAllUnpinned) const;
+
   mutable std::mutex mutex_;
   folly::F14FastMap<RawFileCacheKey, AsyncDataCacheEntry * FOLLY_NONNULL>
       entryMap_;
+  // Number of keys in 'entryMap_' per file number.
+  folly::F14FastMap<uint64_t, int32_t> fileEntryCounts_;
   // Entries associated to a key.
   std::deque<std::unique_ptr<AsyncDataCacheEntry>> entries_;
   // Unused indices in 'entries_'.
@@ -556,6 +695,11 @@ class CacheShard {
   // few around to avoid allocating one inside 'mutex_'.
   std::vector<std::unique_ptr<AsyncDataCacheEntry>> freeEntries_;
   AsyncDataCache* const FOLLY_NONNULL cache_;
+  // Recent accesses to the keys of the shard, including keys that are no
+  // longer cached. A new entry whose key was not accessed before is not
+  // admitted if the cache is filtering admission, so that a scan that does
+  // not come back to its data does not displace the entries that are hit.
+  FrequencySketch frequency_;
   // Index in 'entries_' for the next eviction candidate.
   uint32_t clockHand_{};
   // Number of gets  since last stats sampling.
@@ -576,6 +720,19 @@ class CacheShard {
   // Sum of evict scores. This divided by 'numEvict_' correlates to
   // time data stays in cache.
   uint64_t sumEvictScore_{};
+  // Count of new entries that passed the admission filter.
+  uint64_t numAdmit_{};
+  // Count of new entries that did not pass the admission filter.
+  uint64_t numReject_{};
+  // Count of entries evicted because their tenant was over quota.
+  uint64_t numQuotaEvict_{};
+  // Counts of hits and new entries per tenant of the caller.
+  std::array<uint64_t, kMaxCacheTenants> tenantHits_{};
+  std::array<uint64_t, kMaxCacheTenants> tenantNew_{};
+  // Counts of compressions and decompressions of entries. Updated outside
+  // of 'mutex_'.
+  std::atomic<uint64_t> numCompress_{0};
+  std::atomic<uint64_t> numDecompress_{0};
   // Tracker of time spent in allocating/freeing MappedMemory space
   // for backing cached data.
   std::atomic<uint64_t> allocClocks_;
@@ -583,6 +740,9 @@ class CacheShard {
 
 class AsyncDataCache : public memory::MappedMemory {
  public:
+  // Number of tenant ids, including the 0 of no tenant.
+  static constexpr int32_t kMaxTenants = kMaxCacheTenants;
+
   AsyncDataCache(
       const std::shared_ptr<memory::MappedMemory>& mappedMemory,
       uint64_t maxBytes,
@@ -598,15 +758,27 @@ class AsyncDataCache : public memory::MappedMemory {
   // future that is realized when the pin is no longer exclusive. When
   // the future is realized, the caller may retry findOrCreate().
   // runtime error with code kNoCacheSpace if there is no space to create the
-  // new entry after evicting any unpinned content.
+  // new entry after evicting any unpinned content. 'tenant' identifies the
+  // query class of the caller. A new entry is accounted to 'tenant' and the
+  // hit or miss is counted for 'tenant'.
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
-      folly::SemiFuture<bool>* FOLLY_NULLABLE waitFuture = nullptr);
+      folly::SemiFuture<bool>* FOLLY_NULLABLE waitFuture = nullptr,
+      int32_t tenant = 0);
 
   // Returns true if there is an entry for 'key'. Updates access time.
   bool exists(RawFileCacheKey key) const;
 
+  // Returns true if there is an entry for any part of 'fileNum' in memory
+  // or on SSD.
+  bool isFileCached(uint64_t fileNum) const;
+
+  // Returns a Bloom filter over the filePathHash() of the files that have
+  // entries in memory or on SSD. This summarizes the contents of 'this' for
+  // a scheduler that places splits on the workers that cache their files.
+  BloomFilter<> cachedFilesFilter() const;
+
   bool allocate(
       memory::MachinePageCount numPages,
       int32_t owner,
@@ -628,6 +800,11 @@ class AsyncDataCache : public memory::MappedMemory {
     mappedMemory_->freeContiguous(allocation);
   }
 
+  bool growContiguous(
+      memory::MachinePageCount increment,
+      ContiguousAllocation& allocation,
+      std::function<void(int64_t, bool)> beforeAllocCB = nullptr) override;
+
   void* FOLLY_NULLABLE allocateBytes(
       uint64_t bytes,
       uint64_t maxMallocSize = kMaxMallocBytes) override;
@@ -673,6 +850,71 @@ class AsyncDataCache : public memory::MappedMemory {
     return maxBytes_;
   }
 
+  // Returns true if new entries must pass the admission filter of their
+  // shard. New entries are admitted unconditionally until the cached data
+  // reaches kFilterAdmissionPct of 'maxBytes_'.
+  bool filterAdmission() const {
+    return cachedPages_ * memory::MappedMemory::kPageSize >=
+        maxBytes_ / 100 * kFilterAdmissionPct;
+  }
+
+  // Soft-pins up to 'bytes' of entries of 'tenant', a number in
+  // [1, kMaxTenants). Eviction skips these unless the cache runs out of
+  // unpinned memory. An entry is pinned by pinForTenant() only if it fits in
+  // the remaining budget. A budget of 0 makes the pinned entries evictable
+  // again.
+  void setTenantBudget(int32_t tenant, int64_t bytes);
+
+  // Sets a quota of 'bytes' for the entries of 'tenant'. While 'tenant' is
+  // over its quota, its unpinned entries are evicted before any other
+  // entries, regardless of their score or soft pins, so that the queries of
+  // one tenant cannot displace the entries of the others. A tenant may go
+  // over its quota while the cache has free space. 0 means no quota.
+  void setTenantQuota(int32_t tenant, int64_t bytes);
+
+  // Returns the total size of the entries accounted to 'tenant'.
+  int64_t tenantBytes(int32_t tenant) const {
+    return tenantBytes_.at(tenant);
+  }
+
+  // Returns the total size of the entries soft-pinned for 'tenant'.
+  int64_t tenantPinnedBytes(int32_t tenant) const {
+    return tenantPinnedBytes_.at(tenant);
+  }
+
+  // True if the pinned entries of 'tenant' are within its budget and thus
+  // not evicted by regular eviction.
+  bool isTenantPinned(int32_t tenant) const {
+    return tenant != 0 &&
+        tenantPinnedBytes_[tenant] <= tenantBudget_[tenant];
+  }
+
+  // True if the entries of 'tenant' exceed its quota.
+  bool isTenantOverQuota(int32_t tenant) const {
+    const auto quota = tenantQuota_[tenant].load();
+    return tenant != 0 && quota > 0 && tenantBytes_[tenant] > quota;
+  }
+
+  // True if any tenant is over its quota.
+  bool anyTenantOverQuota() const;
+
+  void incrementTenantBytes(int32_t tenant, int64_t bytes) {
+    tenantBytes_[tenant] += bytes;
+  }
+
+  // Adds 'bytes' to the soft-pinned bytes of 'tenant' if this stays within
+  // its budget. Returns true if added. A negative 'bytes' always succeeds.
+  bool tryIncrementTenantPinnedBytes(int32_t tenant, int64_t bytes);
+
+  // Allocates 'numPages' from the backing MappedMemory without making
+  // space. Used inside eviction, where making space would recurse.
+  bool allocateWithoutEviction(
+      memory::MachinePageCount numPages,
+      int32_t owner,
+      Allocation& out) {
+    return mappedMemory_->allocate(numPages, owner, out);
+  }
+
   SsdCache* FOLLY_NULLABLE ssdCache() const {
     return ssdCache_.get();
   }
@@ -702,14 +944,15 @@ class AsyncDataCache : public memory::MappedMemory {
   // loaded pins. Calls processPin for each exclusive
   // pin. processPin must move its argument if it wants to use it
   // afterwards. sizeFunc(i) returns the size of the ith item in
-  // 'keys'.
+  // 'keys'. 'tenant' is as in findOrCreate().
   template <typename SizeFunc, typename ProcessPin>
   void makePins(
       const std::vector<RawFileCacheKey>& keys,
       SizeFunc sizeFunc,
-      ProcessPin processPin) {
+      ProcessPin processPin,
+      int32_t tenant = 0) {
     for (auto i = 0; i < keys.size(); ++i) {
-      auto pin = findOrCreate(keys[i], sizeFunc(i), nullptr);
+      auto pin = findOrCreate(keys[i], sizeFunc(i), nullptr, tenant);
       if (pin.empty() || pin.checkedEntry()->isShared()) {
         continue;
       }
@@ -733,6 +976,7 @@ class AsyncDataCache : public memory::MappedMemory {
 
  private:
   static constexpr int32_t kNumShards = 4; // Must be power of 2.
+  static constexpr int32_t kFilterAdmissionPct = 50;
   static constexpr int32_t kShardMask = kNumShards - 1;
 
   // Waits a pseudorandom delay times 'counter'.
@@ -754,6 +998,12 @@ class AsyncDataCache : public memory::MappedMemory {
   std::vector<std::unique_ptr<CacheShard>> shards_;
   int32_t shardCounter_{};
   std::atomic<memory::MachinePageCount> cachedPages_{0};
+  // Soft pinning budget and pinned bytes per tenant. See setTenantBudget().
+  std::array<std::atomic<int64_t>, kMaxTenants> tenantBudget_{};
+  std::array<std::atomic<int64_t>, kMaxTenants> tenantPinnedBytes_{};
+  // Quota and accounted bytes per tenant. See setTenantQuota().
+  std::array<std::atomic<int64_t>, kMaxTenants> tenantQuota_{};
+  std::array<std::atomic<int64_t>, kMaxTenants> tenantBytes_{};
   // Number of pages that are allocated and not yet loaded or loaded
   // but not yet hit for the first time.
   std::atomic<memory::MachinePageCount> prefetchPages_{0};
@@ -814,7 +1064,7 @@ T percentile(Next next, int32_t numSamples, int percent) {
 // vector of memory ranges to fill by ReadFile::preadv or a similar
 // function.
 // The caller is responsible for calling setValid on the pins after a successful
-// read.
+// read. A read is not extended past 'maxIoBytes' from its start.
 //
 // Returns the number of distinct IOs, the number of bytes loaded into pins and
 // the number of extr bytes read.
@@ -828,7 +1078,8 @@ CoalesceIoStats readPins(
         int32_t begin,
         int32_t end,
         uint64_t offset,
-        const std::vector<folly::Range<char*>>& buffers)> readFunc);
+        const std::vector<folly::Range<char*>>& buffers)> readFunc,
+    int64_t maxIoBytes = std::numeric_limits<int64_t>::max());
 
 } // namespace facebook::velox::cache
 
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/caching/CacheWarmup.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "velox/common/caching/FileIds.h"
+
+namespace facebook::velox::cache {
+
+namespace {
+// Maximum gap between ranges read in one IO.
+constexpr int32_t kMaxCoalesceDistance = 512 << 10;
+
+// Puts the calling thread in the idle IO priority class for the lifetime of
+// 'this'. No-op where this is not supported.
+class IdleIoPriority {
+ public:
+  IdleIoPriority() {
+#ifdef __linux__
+    oldPriority_ = syscall(SYS_ioprio_get, kIoprioWhoProcess, 0);
+    if (oldPriority_ >= 0) {
+      syscall(
+          SYS_ioprio_set,
+          kIoprioWhoProcess,
+          0,
+          kIoprioClassIdle << kIoprioClassShift);
+    }
+#endif
+  }
+
+  ~IdleIoPriority() {
+#ifdef __linux__
+    if (oldPriority_ >= 0) {
+      syscall(SYS_ioprio_set, kIoprioWhoProcess, 0, oldPriority_);
+    }
+#endif
+  }
+
+ private:
+  // From linux/ioprio.h. A 'who' of 0 with kIoprioWhoProcess is the
+  // calling thread.
+  static constexpr int kIoprioWhoProcess = 1;
+  static constexpr int kIoprioClassIdle = 3;
+  static constexpr int kIoprioClassShift = 13;
+
+  long oldPriority_{-1};
+};
+} // namespace
+
+class CacheWarmup::Load : public CoalescedLoad {
+ public:
+  Load(
+      AsyncDataCache& cache,
+      std::shared_ptr<ReadFile> file,
+      uint64_t fileNum,
+      std::vector<RawFileCacheKey> keys,
+      std::vector<int32_t> sizes,
+      int32_t tenant)
+      : CoalescedLoad(std::move(keys), std::move(sizes)),
+        cache_(cache),
+        file_(std::move(file)),
+        fileNum_(fileIds(), fileNum),
+        tenant_(tenant) {}
+
+  std::string toString() const override {
+    return fmt::format("<CacheWarmup::Load: {} entries>", keys_.size());
+  }
+
+  int64_t numEntries() const {
+    return numEntries_;
+  }
+
+  int64_t bytes() const {
+    return bytes_;
+  }
+
+  int64_t numPinned() const {
+    return numPinned_;
+  }
+
+ protected:
+  std::vector<CachePin> loadData(bool /*isPrefetch*/) override {
+    std::vector<CachePin> pins;
+    cache_.makePins(
+        keys_,
+        [&](int32_t index) { return sizes_[index]; },
+        [&](int32_t /*index*/, CachePin pin) {
+          pins.push_back(std::move(pin));
+        },
+        tenant_);
+    if (pins.empty()) {
+      return pins;
+    }
+    readPins(
+        pins,
+        kMaxCoalesceDistance,
+        1000,
+        [&](int32_t i) { return pins[i].entry()->offset(); },
+        [&](const std::vector<CachePin>& /*pins*/,
+            int32_t /*begin*/,
+            int32_t /*end*/,
+            uint64_t offset,
+            const std::vector<folly::Range<char*>>& buffers) {
+          file_->preadv(offset, buffers);
+        });
+    for (auto& pin : pins) {
+      auto entry = pin.checkedEntry();
+      // The first hit by a query does not count as a cache hit.
+      entry->setPrefetch();
+      if (tenant_ && entry->pinForTenant()) {
+        ++numPinned_;
+      }
+      ++numEntries_;
+      bytes_ += entry->size();
+    }
+    return pins;
+  }
+
+ private:
+  AsyncDataCache& cache_;
+  const std::shared_ptr<ReadFile> file_;
+  // Keeps the id in the keys valid.
+  const StringIdLease fileNum_;
+  const int32_t tenant_;
+  int64_t numEntries_{0};
+  int64_t bytes_{0};
+  int64_t numPinned_{0};
+};
+
+CacheWarmup::CacheWarmup(
+    AsyncDataCache* cache,
+    folly::Executor* executor,
+    int32_t loadQuantum)
+    : cache_(cache), executor_(executor), loadQuantum_(loadQuantum) {
+  VELOX_CHECK_GT(loadQuantum_, 0);
+}
+
+CacheWarmup::~CacheWarmup() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    pending_.clear();
+  }
+  wait();
+}
+
+void CacheWarmup::add(
+    std::shared_ptr<ReadFile> file,
+    uint64_t fileNum,
+    std::vector<Region> regions,
+    int32_t tenant) {
+  VELOX_CHECK_GE(tenant, 0);
+  VELOX_CHECK_LT(tenant, AsyncDataCache::kMaxTenants);
+  std::sort(regions.begin(), regions.end(), [](auto& left, auto& right) {
+    return left.offset < right.offset;
+  });
+  std::vector<RawFileCacheKey> keys;
+  std::vector<int32_t> sizes;
+  for (const auto& region : regions) {
+    for (uint64_t offset = 0; offset < region.length; offset += loadQuantum_) {
+      keys.push_back(RawFileCacheKey{fileNum, region.offset + offset});
+      sizes.push_back(
+          std::min<uint64_t>(loadQuantum_, region.length - offset));
+    }
+  }
+  if (keys.empty()) {
+    return;
+  }
+  auto load = std::make_shared<Load>(
+      *cache_,
+      std::move(file),
+      fileNum,
+      std::move(keys),
+      std::move(sizes),
+      tenant);
+  std::lock_guard<std::mutex> l(mutex_);
+  pending_.push_back(std::move(load));
+  if (!running_) {
+    running_ = true;
+    executor_->add([this]() { runLoads(); });
+  }
+}
+
+void CacheWarmup::runLoads() {
+  IdleIoPriority ioPriority;
+  for (;;) {
+    std::shared_ptr<Load> load;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (pending_.empty()) {
+        running_ = false;
+        idle_.notify_all();
+        return;
+      }
+      load = std::move(pending_.front());
+      pending_.pop_front();
+    }
+    bool error = false;
+    try {
+      load->loadOrFuture(nullptr);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Cache warmup load failed: " << e.what();
+      error = true;
+    }
+    std::lock_guard<std::mutex> l(mutex_);
+    stats_.numEntries += load->numEntries();
+    stats_.bytes += load->bytes();
+    stats_.numPinned += load->numPinned();
+    stats_.numErrors += error;
+  }
+}
+
+void CacheWarmup::wait() {
+  std::unique_lock<std::mutex> l(mutex_);
+  idle_.wait(l, [&]() { return !running_; });
+}
+
+CacheWarmup::Stats CacheWarmup::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return stats_;
+}
+
+} // namespace facebook::velox::cache
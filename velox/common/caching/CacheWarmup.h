@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <folly/Executor.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/file/File.h"
+
+namespace facebook::velox::cache {
+
+/// Loads ranges of files known to be hot into an AsyncDataCache in the
+/// background, e.g. after a restart or ahead of a scheduled dashboard. The
+/// loads run one at a time on the executor. On Linux the loading thread
+/// uses the idle IO priority class while loading, so that the warmup does
+/// not compete with queries for the disk. The ranges must be those that the
+/// readers request, e.g. the streams of the hot columns from the stripe
+/// footers, since the cache is keyed on the offset of the range.
+class CacheWarmup {
+ public:
+  struct Region {
+    uint64_t offset;
+    uint64_t length;
+  };
+
+  struct Stats {
+    // Number of entries loaded.
+    int64_t numEntries{0};
+    // Bytes loaded.
+    int64_t bytes{0};
+    // Number of entries soft-pinned for the tenant of their load.
+    int64_t numPinned{0};
+    // Number of loads that failed.
+    int64_t numErrors{0};
+  };
+
+  /// 'loadQuantum' is the maximum size of an entry. Regions larger than
+  /// this are split like CachedBufferedInput splits them.
+  CacheWarmup(
+      AsyncDataCache* FOLLY_NONNULL cache,
+      folly::Executor* FOLLY_NONNULL executor,
+      int32_t loadQuantum = 8 << 20);
+
+  ~CacheWarmup();
+
+  /// Schedules loading 'regions' of 'file', which is identified in the cache
+  /// by 'fileNum', an id from fileIds(). The loaded entries are accounted to
+  /// 'tenant' and soft-pinned for it within its budget if 'tenant' is not 0.
+  /// See AsyncDataCache::setTenantBudget().
+  void add(
+      std::shared_ptr<ReadFile> file,
+      uint64_t fileNum,
+      std::vector<Region> regions,
+      int32_t tenant = 0);
+
+  /// Waits until all scheduled loads are done.
+  void wait();
+
+  Stats stats() const;
+
+ private:
+  class Load;
+
+  // Runs the pending loads on a thread of 'executor_' until none is left.
+  void runLoads();
+
+  AsyncDataCache* const FOLLY_NONNULL cache_;
+  folly::Executor* const FOLLY_NONNULL executor_;
+  const int32_t loadQuantum_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable idle_;
+  std::deque<std::shared_ptr<Load>> pending_;
+  // True while a task of 'executor_' is running loads.
+  bool running_{false};
+  Stats stats_;
+};
+
+} // namespace facebook::velox::cache
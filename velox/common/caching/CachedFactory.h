@@ -25,13 +25,14 @@
 
 #pragma once
 
-#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <utility>
 
-#include "folly/container/F14Set.h"
+#include "folly/container/F14Map.h"
+#include "folly/futures/Future.h"
+#include "folly/futures/SharedPromise.h"
 #include "glog/logging.h"
 
 #include "velox/common/caching/SimpleLRUCache.h"
@@ -157,6 +158,18 @@ class CachedFactory {
   // will probably mess with your memory model, so really try to avoid it.
   CachedPtr<Key, Value, Comparator, Hash> generate(const Key& key);
 
+  // Same as generate() but runs the Generator on 'executor' instead of the
+  // calling thread. A request for a key that is being generated waits for
+  // the same generation without taking a thread.
+  folly::SemiFuture<CachedPtr<Key, Value, Comparator, Hash>> generateAsync(
+      const Key& key,
+      folly::Executor* executor);
+
+  // Removes the value of 'key' from the cache. Returns false if the value is
+  // in use, in which case it stays in the cache. Returns true if the key is
+  // not in the cache.
+  bool evict(const Key& key);
+
   // Advanced function taking in a group of keys. Separates those keys into
   // one's present in the cache (returning CachedPtrs for them) and those not
   // in the cache. Does NOT call the Generator for any key.
@@ -183,13 +196,28 @@ class CachedFactory {
   CachedFactory& operator=(const CachedFactory&) = delete;
 
  private:
+  using Ptr = CachedPtr<Key, Value, Comparator, Hash>;
+
+  // Returns the cached value of 'key' or a null CachedPtr.
+  Ptr lookup(const Key& key, bool wasCached);
+
+  // Runs the Generator for 'key', which the caller has added to 'pending_',
+  // and completes the waiters.
+  Ptr generateMissing(const Key& key);
+
   std::unique_ptr<SimpleLRUCache<Key, Value, Comparator, Hash>> cache_;
   std::unique_ptr<Generator> generator_;
-  folly::F14FastSet<Key, Hash, Comparator> pending_;
+  // The keys being generated. The promise is fulfilled when the value is in
+  // the cache or the generation failed.
+  folly::F14FastMap<
+      Key,
+      std::unique_ptr<folly::SharedPromise<folly::Unit>>,
+      Hash,
+      Comparator>
+      pending_;
 
   std::mutex cacheMu_;
   std::mutex pendingMu_;
-  std::condition_variable pendingCv_;
 };
 
 //
@@ -281,6 +309,26 @@ void CachedPtr<Key, Value, Comparator, Hash>::clear() {
   }
 }
 
+template <
+    typename Key,
+    typename Value,
+    typename Generator,
+    typename Sizer,
+    typename Comparator,
+    typename Hash>
+CachedPtr<Key, Value, Comparator, Hash>
+CachedFactory<Key, Value, Generator, Sizer, Comparator, Hash>::lookup(
+    const Key& key,
+    bool wasCached) {
+  std::lock_guard<std::mutex> cache_lock(cacheMu_);
+  Value* value = cache_->get(key);
+  if (!value) {
+    return Ptr();
+  }
+  return Ptr(
+      wasCached, value, cache_.get(), std::make_unique<Key>(key), &cacheMu_);
+}
+
 template <
     typename Key,
     typename Value,
@@ -292,76 +340,123 @@ CachedPtr<Key, Value, Comparator, Hash>
 CachedFactory<Key, Value, Generator, Sizer, Comparator, Hash>::generate(
     const Key& key) {
   std::unique_lock<std::mutex> pending_lock(pendingMu_);
-  {
-    std::lock_guard<std::mutex> cache_lock(cacheMu_);
-    Value* value = cache_->get(key);
-    if (value) {
-      return CachedPtr<Key, Value, Comparator, Hash>(
-          /*wasCached=*/true,
-          value,
-          cache_.get(),
-          std::make_unique<Key>(key),
-          &cacheMu_);
-    }
+  auto cached = lookup(key, /*wasCached=*/true);
+  if (cached.get()) {
+    return cached;
   }
-  if (pending_.contains(key)) {
-    pendingCv_.wait(pending_lock, [&]() { return !pending_.contains(key); });
+  auto it = pending_.find(key);
+  if (it != pending_.end()) {
+    auto future = it->second->getSemiFuture();
+    pending_lock.unlock();
+    std::move(future).wait();
     // Will normally hit the cache now.
-    {
-      std::lock_guard<std::mutex> cache_lock(cacheMu_);
-      Value* value = cache_->get(key);
-      if (value) {
-        return CachedPtr<Key, Value, Comparator, Hash>(
-            /*wasCached=*/false,
-            value,
-            cache_.get(),
-            std::make_unique<Key>(key),
-            &cacheMu_);
-      }
+    auto generated = lookup(key, /*wasCached=*/false);
+    if (generated.get()) {
+      return generated;
     }
-    pending_lock.unlock();
     return generate(key); // Regenerate in the edge case.
-  } else {
-    pending_.insert(key);
-    pending_lock.unlock();
-    std::unique_ptr<Value> generatedValue;
-    // TODO: consider using folly/ScopeGuard here.
-    try {
-      generatedValue = (*generator_)(key);
-    } catch (const std::exception& e) {
-      {
-        std::lock_guard<std::mutex> pending_lock(pendingMu_);
-        pending_.erase(key);
-      }
-      pendingCv_.notify_all();
-      throw;
-    }
-    const uint64_t sizeOccupied = Sizer()(*generatedValue);
-    Value* rawValue = generatedValue.release();
-    cacheMu_.lock();
-    const bool inserted = cache_->addPinned(key, rawValue, sizeOccupied);
-    cacheMu_.unlock();
-    CachedPtr<Key, Value, Comparator, Hash> result;
-    if (inserted) {
-      result = CachedPtr<Key, Value, Comparator, Hash>(
-          /*wasCached=*/false,
-          rawValue,
-          cache_.get(),
-          std::make_unique<Key>(key),
-          &cacheMu_);
-    } else {
-      // We want a LOG_EVERY_N_SEC warning here, but it doesn't seem to
-      // be available in glog?
-      // LOG_EVERY_N_SEC(WARNING, 60) << "Unable to insert into cache!";
-      result = CachedPtr<Key, Value, Comparator, Hash>(rawValue);
-    }
+  }
+  pending_.emplace(key, std::make_unique<folly::SharedPromise<folly::Unit>>());
+  pending_lock.unlock();
+  return generateMissing(key);
+}
+
+template <
+    typename Key,
+    typename Value,
+    typename Generator,
+    typename Sizer,
+    typename Comparator,
+    typename Hash>
+folly::SemiFuture<CachedPtr<Key, Value, Comparator, Hash>>
+CachedFactory<Key, Value, Generator, Sizer, Comparator, Hash>::generateAsync(
+    const Key& key,
+    folly::Executor* executor) {
+  std::unique_lock<std::mutex> pending_lock(pendingMu_);
+  auto cached = lookup(key, /*wasCached=*/true);
+  if (cached.get()) {
+    return folly::makeSemiFuture(std::move(cached));
+  }
+  auto it = pending_.find(key);
+  if (it != pending_.end()) {
+    return it->second->getSemiFuture().deferValue(
+        [this, key](folly::Unit /*unused*/) {
+          auto generated = lookup(key, /*wasCached=*/false);
+          if (generated.get()) {
+            return generated;
+          }
+          return generate(key);
+        });
+  }
+  pending_.emplace(key, std::make_unique<folly::SharedPromise<folly::Unit>>());
+  pending_lock.unlock();
+  return folly::via(executor, [this, key]() { return generateMissing(key); })
+      .semi();
+}
+
+template <
+    typename Key,
+    typename Value,
+    typename Generator,
+    typename Sizer,
+    typename Comparator,
+    typename Hash>
+CachedPtr<Key, Value, Comparator, Hash>
+CachedFactory<Key, Value, Generator, Sizer, Comparator, Hash>::generateMissing(
+    const Key& key) {
+  auto finishPending = [&]() {
+    std::unique_ptr<folly::SharedPromise<folly::Unit>> promise;
     {
       std::lock_guard<std::mutex> pending_lock(pendingMu_);
-      pending_.erase(key);
+      auto it = pending_.find(key);
+      promise = std::move(it->second);
+      pending_.erase(it);
     }
-    pendingCv_.notify_all();
-    return result;
+    // The waiters look up the cache and generate again if the value is not
+    // there, so they are woken up the same way on error.
+    promise->setValue();
+  };
+  std::unique_ptr<Value> generatedValue;
+  try {
+    generatedValue = (*generator_)(key);
+  } catch (const std::exception& e) {
+    finishPending();
+    throw;
+  }
+  const uint64_t sizeOccupied = Sizer()(*generatedValue);
+  Value* rawValue = generatedValue.release();
+  cacheMu_.lock();
+  const bool inserted = cache_->addPinned(key, rawValue, sizeOccupied);
+  cacheMu_.unlock();
+  Ptr result;
+  if (inserted) {
+    result = Ptr(
+        /*wasCached=*/false,
+        rawValue,
+        cache_.get(),
+        std::make_unique<Key>(key),
+        &cacheMu_);
+  } else {
+    // We want a LOG_EVERY_N_SEC warning here, but it doesn't seem to
+    // be available in glog?
+    // LOG_EVERY_N_SEC(WARNING, 60) << "Unable to insert into cache!";
+    result = Ptr(rawValue);
   }
+  finishPending();
+  return result;
+}
+
+template <
+    typename Key,
+    typename Value,
+    typename Generator,
+    typename Sizer,
+    typename Comparator,
+    typename Hash>
+bool CachedFactory<Key, Value, Generator, Sizer, Comparator, Hash>::evict(
+    const Key& key) {
+  std::lock_guard<std::mutex> cache_lock(cacheMu_);
+  return cache_->erase(key);
 }
 
 template <
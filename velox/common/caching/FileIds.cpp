@@ -18,9 +18,15 @@
 
 #include <gflags/gflags.h>
 
+#include "velox/common/base/BitUtil.h"
+
 namespace facebook::velox {
 StringIdMap& fileIds() {
   static StringIdMap* ids = new StringIdMap();
   return *ids;
 }
+
+uint64_t filePathHash(std::string_view path) {
+  return bits::hashBytes(1, path.data(), path.size());
+}
 } // namespace facebook::velox
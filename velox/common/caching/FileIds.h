@@ -21,4 +21,8 @@ namespace facebook::velox {
 // Returns a process-wide map of file path to id and id to file path.
 StringIdMap& fileIds();
 
+// Returns a hash of 'path' that is the same in all processes. Unlike the ids
+// of fileIds(), this can be compared between workers and a scheduler.
+uint64_t filePathHash(std::string_view path);
+
 } // namespace facebook::velox
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace facebook::velox::cache {
+
+// Approximate count of recent accesses to keys given by their hash. This is a
+// count-min sketch of 4 rows of saturating counters, as in the TinyLFU cache
+// admission policy. The counters are halved after every 10 x 'width'
+// increments so that the counts reflect recent history. An estimate is never
+// below the true count since the last halving but may be above it if other
+// keys collide in all rows.
+class FrequencySketch {
+ public:
+  static constexpr int32_t kMaxCount = 15;
+
+  // 'width' is the number of counters per row, rounded up to a power of 2.
+  // This should be around the number of distinct keys to track.
+  explicit FrequencySketch(int32_t width);
+
+  // Records an access to the key with 'hash'.
+  void increment(uint64_t hash);
+
+  // Returns the estimated number of recent accesses to the key with 'hash',
+  // at most kMaxCount.
+  int32_t estimate(uint64_t hash) const;
+
+ private:
+  static constexpr int32_t kDepth = 4;
+
+  // Returns the index of the counter for 'hash' in row 'row'.
+  uint64_t index(uint64_t hash, int32_t row) const;
+
+  // Halves all counters.
+  void age();
+
+  const uint64_t mask_;
+  // 'kDepth' rows of 'mask_' + 1 counters.
+  std::vector<uint8_t> counters_;
+  // Number of increments after which the counters are halved.
+  const uint64_t sampleSize_;
+  uint64_t numIncrements_{0};
+};
+
+} // namespace facebook::velox::cache
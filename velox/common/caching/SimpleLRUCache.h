@@ -90,6 +90,10 @@ class SimpleLRUCache {
   // happen (namely, memory leaks).
   void release(const Key& key);
 
+  // Removes and frees the value of 'key' if it is not pinned. Returns false
+  // if the key is pinned, true otherwise.
+  bool erase(const Key& key);
+
   // Total size of elements in the cache (NOT the maximum size/limit).
   int64_t currentSize() const {
     return curSize_;
@@ -212,6 +216,25 @@ inline void SimpleLRUCache<Key, Value, Comparator, Hash>::release(
   }
 }
 
+template <typename Key, typename Value, typename Comparator, typename Hash>
+inline bool SimpleLRUCache<Key, Value, Comparator, Hash>::erase(
+    const Key& key) {
+  auto it = keys_.find(key);
+  if (it == keys_.end()) {
+    return true;
+  }
+  Element* e = it->second;
+  if (e->pinCount > 0) {
+    return false;
+  }
+  curSize_ -= e->size;
+  keys_.erase(it);
+  elements_.remove(e);
+  delete e->value;
+  delete e;
+  return true;
+}
+
 template <typename Key, typename Value, typename Comparator, typename Hash>
 inline int64_t SimpleLRUCache<Key, Value, Comparator, Hash>::free(
     int64_t size) {
@@ -112,6 +112,12 @@ void SsdCache::write(std::vector<CachePin> pins) {
   writesInProgress_.fetch_sub(numNoStore);
 }
 
+void SsdCache::appendFileNums(std::vector<uint64_t>& fileNums) const {
+  for (auto& file : files_) {
+    file->appendFileNums(fileNums);
+  }
+}
+
 SsdCacheStats SsdCache::stats() const {
   SsdCacheStats stats;
   for (auto& file : files_) {
@@ -134,6 +140,10 @@ std::string SsdCache::toString() const {
       << (data.bytesRead >> 20) << "MB Size " << (capacity >> 30)
       << "GB Occupied " << (data.bytesCached >> 30) << "GB";
   out << (data.entriesCached >> 10) << "K entries.";
+  if (data.entriesRecovered || data.entriesDropped) {
+    out << " Recovered " << data.entriesRecovered << " entries, dropped "
+        << data.entriesDropped << ".";
+  }
   out << "\nGroupStats: " << groupStats_->toString(capacity);
   return out.str();
 }
@@ -67,6 +67,14 @@ class SsdCache {
   // Returns  stats aggregated from all shards.
   SsdCacheStats stats() const;
 
+  // Returns true if there is an entry for 'fileNum'.
+  bool isFileCached(uint64_t fileNum) const {
+    return files_[fileNum % numShards_]->isFileCached(fileNum);
+  }
+
+  // Appends the file numbers that have entries in 'this' to 'fileNums'.
+  void appendFileNums(std::vector<uint64_t>& fileNums) const;
+
   FileGroupStats& groupStats() const {
     return *groupStats_;
   }
@@ -19,6 +19,7 @@
 #include <folly/portability/SysUio.h>
 #include "velox/common/base/AsyncSource.h"
 #include "velox/common/caching/FileIds.h"
+#include "velox/common/file/IoUring.h"
 
 #include <fcntl.h>
 #include <sys/stat.h>
@@ -170,10 +171,39 @@ bool SsdFile::erase(RawFileCacheKey key) {
   if (it == entries_.end()) {
     return false;
   }
+  decrementFileEntryCountLocked(key.fileNum);
   entries_.erase(it);
   return true;
 }
 
+bool SsdFile::isFileCached(uint64_t fileNum) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return fileEntryCounts_.count(fileNum) != 0;
+}
+
+void SsdFile::appendFileNums(std::vector<uint64_t>& fileNums) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (const auto& [fileNum, count] : fileEntryCounts_) {
+    fileNums.push_back(fileNum);
+  }
+}
+
+void SsdFile::setEntryLocked(FileCacheKey key, SsdRun run) {
+  const auto fileNum = key.fileNum.id();
+  auto [it, inserted] = entries_.insert_or_assign(std::move(key), run);
+  if (inserted) {
+    ++fileEntryCounts_[fileNum];
+  }
+}
+
+void SsdFile::decrementFileEntryCountLocked(uint64_t fileNum) {
+  auto it = fileEntryCounts_.find(fileNum);
+  VELOX_CHECK(it != fileEntryCounts_.end());
+  if (--it->second == 0) {
+    fileEntryCounts_.erase(it);
+  }
+}
+
 CoalesceIoStats SsdFile::load(
     const std::vector<SsdPin>& ssdPins,
     const std::vector<CachePin>& pins) {
@@ -200,7 +230,10 @@ CoalesceIoStats SsdFile::load(
   }
   // Do coalesced IO for the pins. For short payloads, the break-even
   // between discrete pread calls and a single preadv that discards
-  // gaps is ~25K per gap. For longer payloads this is ~50-100K.
+  // gaps is ~25K per gap. For longer payloads this is ~50-100K. With
+  // io_uring, the reads are all submitted before waiting for any.
+  const bool async = readFile_->hasPreadvAsync();
+  std::vector<folly::SemiFuture<uint64_t>> reads;
   auto stats = readPins(
       pins,
       payloadTotal / pins.size() < 10000 ? 25000 : 50000,
@@ -214,8 +247,18 @@ CoalesceIoStats SsdFile::load(
           int32_t /*end*/,
           uint64_t offset,
           const std::vector<folly::Range<char*>>& buffers) {
-        read(offset, buffers);
+        if (async) {
+          reads.push_back(readFile_->preadvAsync(offset, buffers));
+        } else {
+          read(offset, buffers);
+        }
       });
+  if (!reads.empty()) {
+    // Waits for all reads before throwing since they write into 'pins'.
+    for (auto& result : folly::collectAll(std::move(reads)).get()) {
+      result.value();
+    }
+  }
 
   for (auto i = 0; i < ssdPins.size(); ++i) {
     pins[i].checkedEntry()->setSsdFile(this, ssdPins[i].run().offset());
@@ -302,6 +345,7 @@ void SsdFile::clearRegionEntriesLocked(
     auto region = regionIndex(it->second.offset());
     if (std::find(regionIndices.begin(), regionIndices.end(), region) !=
         regionIndices.end()) {
+      decrementFileEntryCountLocked(it->first.fileNum.id());
       it = entries_.erase(it);
     } else {
       ++it;
@@ -349,7 +393,17 @@ void SsdFile::write(std::vector<CachePin>& pins) {
       ++numWritten;
     }
     VELOX_CHECK_GE(fileSize_, offset + bytes);
-    auto rc = folly::pwritev(fd_, iovecs.data(), iovecs.size(), offset);
+    int64_t rc;
+    if (auto ring = IoUring::instance()) {
+      try {
+        rc = ring->pwritev(fd_, std::move(iovecs), offset).get();
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Failed to write to SSD: " << e.what();
+        return;
+      }
+    } else {
+      rc = folly::pwritev(fd_, iovecs.data(), iovecs.size(), offset);
+    }
     if (rc != bytes) {
       LOG(ERROR) << "Failed to write to SSD " << errno;
       // If the write fails we return without adding the pins to the cache. The
@@ -364,7 +418,7 @@ void SsdFile::write(std::vector<CachePin>& pins) {
         auto size = entry->size();
         FileCacheKey key = {
             entry->key().fileNum, static_cast<uint64_t>(entry->offset())};
-        entries_[std::move(key)] = SsdRun(offset, size);
+        setEntryLocked(std::move(key), SsdRun(offset, size));
         if (FLAGS_ssd_verify_write) {
           verifyWrite(*entry, SsdRun(offset, size));
         }
@@ -429,6 +483,8 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
   stats.entriesRead += stats_.entriesRead;
   stats.bytesRead += stats_.bytesRead;
   stats.entriesCached += entries_.size();
+  stats.entriesRecovered += stats_.entriesRecovered;
+  stats.entriesDropped += stats_.entriesDropped;
   for (auto& regionSize : regionSize_) {
     stats.bytesCached += regionSize;
   }
@@ -440,6 +496,7 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
 void SsdFile::clear() {
   std::lock_guard<std::mutex> l(mutex_);
   entries_.clear();
+  fileEntryCounts_.clear();
   std::fill(regionSize_.begin(), regionSize_.end(), 0);
   writableRegions_.resize(numRegions_);
   std::iota(writableRegions_.begin(), writableRegions_.end(), 0);
@@ -632,6 +689,7 @@ void SsdFile::initializeCheckpoint() {
       LOG(ERROR) << "Error recovering from checkpoint " << e.what()
                  << ": Starting without checkpoint";
       entries_.clear();
+      fileEntryCounts_.clear();
       deleteCheckpoint(true);
     } catch (const std::exception& e) {
     }
@@ -656,7 +714,14 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
       maxRegions,
       maxRegions_,
       "Trying to start from checkpoint with a different capacity");
-  numRegions_ = readNumber<int32_t>(state);
+  // The regions in the file are as set by the constructor from the file
+  // size. If the file is shorter than at the time of the checkpoint, the
+  // entries past its end are dropped.
+  const auto checkpointRegions = readNumber<int32_t>(state);
+  if (checkpointRegions > numRegions_) {
+    LOG(WARNING) << "SSD cache file " << fileName_ << " has " << numRegions_
+                 << " regions, the checkpoint has " << checkpointRegions;
+  }
   std::vector<int64_t> scores(maxRegions);
   state.read(asChar(scores.data()), maxRegions_ * sizeof(uint64_t));
   std::unordered_map<uint64_t, StringIdLease> idMap;
@@ -679,6 +744,8 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
   for (auto region : evicted) {
     evictedMap.insert(region);
   }
+  std::vector<uint32_t> regionSizes(maxRegions_);
+  uint64_t numDropped = 0;
   for (;;) {
     uint64_t fileNum = readNumber<uint64_t>(state);
     if (fileNum == kCheckpointEndMarker) {
@@ -686,28 +753,42 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
     }
     uint64_t offset = readNumber<uint64_t>(state);
     auto run = SsdRun(readNumber<uint64_t>(state));
-    // Check that the recovered entry does not fall in an evicted region.
-    if (evictedMap.find(regionIndex(run.offset())) == evictedMap.end()) {
-      // The file may have a different id on restore.
-      auto it = idMap.find(fileNum);
-      VELOX_CHECK(it != idMap.end());
-      FileCacheKey key{it->second, offset};
-      entries_[std::move(key)] = run;
+    // The file may have a different id on restore.
+    auto it = idMap.find(fileNum);
+    VELOX_CHECK(it != idMap.end());
+    // Check that the recovered entry does not fall in an evicted region and
+    // is inside one region of the file.
+    const auto region = regionIndex(run.offset());
+    const auto end = run.offset() - region * kRegionSize + run.size();
+    if (evictedMap.count(region) || run.offset() + run.size() > fileSize_ ||
+        end > kRegionSize) {
+      ++numDropped;
+      continue;
     }
+    regionSizes[region] = std::max<uint32_t>(regionSizes[region], end);
+    FileCacheKey key{it->second, offset};
+    setEntryLocked(std::move(key), run);
   }
   // The state is successfully read. Install the access frequency scores and
-  // evicted regions.
+  // the sizes of the regions. The regions without entries, e.g. the evicted
+  // ones, are writable.
   VELOX_CHECK_EQ(scores.size(), tracker_.regionScores().size());
-  // Set the writable regions by deduplicated evicted regions.
+  regionSize_ = std::move(regionSizes);
   writableRegions_.clear();
-  for (auto region : evictedMap) {
-    writableRegions_.push_back(region);
+  for (auto region = 0; region < numRegions_; ++region) {
+    if (regionSize_[region] == 0) {
+      writableRegions_.push_back(region);
+    }
   }
   tracker_.regionScores() = scores;
+  stats_.entriesRecovered = entries_.size();
+  stats_.entriesDropped = numDropped;
   LOG(INFO) << fmt::format(
-      "Starting shard {} from checkpoint with {} entries, {} regions with {} free.",
+      "Starting shard {} from checkpoint with {} entries, {} dropped, "
+      "{} regions with {} free.",
       shardId_,
       entries_.size(),
+      numDropped,
       numRegions_,
       writableRegions_.size());
 }
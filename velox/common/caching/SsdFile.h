@@ -127,6 +127,11 @@ struct SsdCacheStats {
   uint64_t entriesCached{0};
   uint64_t bytesCached{0};
   int32_t numPins{0};
+  // Number of entries read from a checkpoint at startup.
+  uint64_t entriesRecovered{0};
+  // Number of entries in a checkpoint that were dropped at startup because
+  // their region was evicted after the checkpoint or is not in the file.
+  uint64_t entriesDropped{0};
 };
 
 // A shard of SsdCache. Corresponds to one file on SSD.  The data
@@ -161,6 +166,12 @@ class SsdFile {
   // Erases 'key'
   bool erase(RawFileCacheKey key);
 
+  // Returns true if 'this' has an entry for 'fileNum'.
+  bool isFileCached(uint64_t fileNum) const;
+
+  // Appends the file numbers that have entries in 'this' to 'fileNums'.
+  void appendFileNums(std::vector<uint64_t>& fileNums) const;
+
   // Copies the data in 'ssdPins' into 'pins'. Coalesces IO for nearby
   // entries if they are in ascending order and near enough.
   CoalesceIoStats load(
@@ -242,6 +253,13 @@ class SsdFile {
   // 'regionIndices'.
   void clearRegionEntriesLocked(const std::vector<int32_t>& regionIndices);
 
+  // Adds or replaces the entry for 'key' in 'entries_'.
+  void setEntryLocked(FileCacheKey key, SsdRun run);
+
+  // Decrements the count of entries of 'fileNum' in 'fileEntryCounts_'
+  // after an entry is erased from 'entries_'.
+  void decrementFileEntryCountLocked(uint64_t fileNum);
+
   // Clears one or more  regions for accommodating new entries. The regions are
   // added to 'writableRegions_'. Returns true if regions could be cleared.
   bool growOrEvictLocked();
@@ -258,7 +276,9 @@ class SsdFile {
 
   // Reads a checkpoint state file and sets 'this' accordingly if read
   // is successful. Return true for successful read. A failed read
-  // deletes the checkpoint and leaves the log truncated open.
+  // deletes the checkpoint and leaves the log truncated open. Entries in
+  // regions evicted after the checkpoint or past the end of the file are
+  // dropped. The regions without entries are writable.
   void readCheckpoint(std::ifstream& state);
 
   // Logs an error message, deletes the checkpoint and stop making new
@@ -277,7 +297,7 @@ class SsdFile {
   void logEviction(const std::vector<int32_t>& regions);
 
   // Serializes access to all private data members.
-  std::mutex mutex_;
+  mutable std::mutex mutex_;
   // Name of cache file, used as prefix for checkpoint files.
   std::string fileName_;
   static constexpr const char* FOLLY_NONNULL kLogExtension = ".log";
@@ -315,6 +335,9 @@ class SsdFile {
   // Map of file number and offset to location in file.
   folly::F14FastMap<FileCacheKey, SsdRun> entries_;
 
+  // Number of keys in 'entries_' per file number.
+  folly::F14FastMap<uint64_t, int32_t> fileEntryCounts_;
+
   // Name of backing file.
   const std::string filename_;
 
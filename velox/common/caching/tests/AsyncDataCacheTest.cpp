@@ -583,6 +583,202 @@ TEST_F(AsyncDataCacheTest, outOfCapacity) {
   EXPECT_EQ(4092, cache_->numAllocated());
 }
 
+TEST_F(AsyncDataCacheTest, admission) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 64 << 10;
+  initializeCache(kMaxBytes);
+  auto load = [&](uint64_t offset, int32_t size) {
+    RawFileCacheKey key{filenames_[0].id(), offset};
+    auto pin = cache_->findOrCreate(key, size, nullptr);
+    ASSERT_FALSE(pin.empty());
+    if (pin.entry()->isExclusive()) {
+      pin.entry()->setExclusiveToShared();
+    }
+  };
+
+  // Entries are admitted until half the capacity is cached. The entries
+  // after that are seen for the first time and are not admitted.
+  for (auto i = 0; i < 160; ++i) {
+    load(i * kSize, kSize);
+  }
+  auto stats = cache_->refreshStats();
+  EXPECT_EQ(128, stats.numAdmit);
+  EXPECT_EQ(32, stats.numReject);
+  EXPECT_EQ(160, stats.numEntries);
+
+  // A key that was hit before passes the filter when it is loaded again.
+  load(150 * kSize, kSize);
+  EXPECT_EQ(1, cache_->refreshStats().numHit);
+  load(150 * kSize, 2 * kSize);
+  stats = cache_->refreshStats();
+  EXPECT_EQ(129, stats.numAdmit);
+  EXPECT_EQ(32, stats.numReject);
+
+  // A new key does not.
+  load(1000 * kSize, kSize);
+  EXPECT_EQ(33, cache_->refreshStats().numReject);
+}
+
+TEST_F(AsyncDataCacheTest, compressCold) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 64 << 10;
+  constexpr int32_t kNumEntries = 16;
+  initializeCache(kMaxBytes);
+  auto fill = [](AsyncDataCacheEntry& entry, char value) {
+    auto& data = entry.data();
+    for (auto i = 0; i < data.numRuns(); ++i) {
+      auto run = data.runAt(i);
+      memset(run.data<char>(), value, run.numBytes());
+    }
+  };
+  for (auto i = 0; i < kNumEntries; ++i) {
+    RawFileCacheKey key{filenames_[0].id(), i * kSize};
+    auto pin = cache_->findOrCreate(key, kSize, nullptr);
+    ASSERT_TRUE(pin.entry()->isExclusive());
+    fill(*pin.entry(), i);
+    pin.entry()->setCompressible(true);
+    pin.entry()->setExclusiveToShared();
+  }
+
+  // Making space compresses the cold entries before evicting them.
+  const auto numPages =
+      (kMaxBytes - kSize) / MappedMemory::kPageSize - kNumEntries;
+  MappedMemory::Allocation allocation(cache_.get());
+  ASSERT_TRUE(cache_->allocate(numPages, 0, allocation));
+  auto stats = cache_->refreshStats();
+  EXPECT_LT(0, stats.numCompress);
+  EXPECT_LE(stats.numCompressed, stats.numCompress);
+  EXPECT_LT(0, stats.compressionSavings);
+  cache_->free(allocation);
+
+  // The entries that are still cached are decompressed on hit.
+  const auto numCompressed = stats.numCompressed;
+  for (auto i = 0; i < kNumEntries; ++i) {
+    RawFileCacheKey key{filenames_[0].id(), i * kSize};
+    auto pin = cache_->findOrCreate(key, kSize, nullptr);
+    ASSERT_FALSE(pin.empty());
+    auto entry = pin.entry();
+    if (entry->isExclusive()) {
+      // Evicted.
+      continue;
+    }
+    EXPECT_FALSE(entry->isCompressed());
+    auto run = entry->data().runAt(0);
+    for (auto j = 0; j < kSize && j < run.numBytes(); ++j) {
+      ASSERT_EQ(static_cast<char>(i), run.data<char>()[j]);
+    }
+  }
+  stats = cache_->refreshStats();
+  EXPECT_EQ(numCompressed, stats.numDecompress);
+  EXPECT_EQ(0, stats.numCompressed);
+}
+
+TEST_F(AsyncDataCacheTest, tenantPinning) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 64 << 10;
+  initializeCache(kMaxBytes);
+  cache_->setTenantBudget(1, 2 * kSize);
+  auto load = [&](uint64_t offset, int32_t tenant) {
+    RawFileCacheKey key{filenames_[0].id(), offset};
+    auto pin = cache_->findOrCreate(key, kSize, nullptr, tenant);
+    ASSERT_TRUE(pin.entry()->isExclusive());
+    EXPECT_EQ(
+        tenant != 0 && offset < 2 * kSize, pin.entry()->pinForTenant());
+    pin.entry()->setExclusiveToShared();
+  };
+  // The 3rd tagged entry is over the budget and is not pinned.
+  for (auto i = 0; i < 3; ++i) {
+    load(i * kSize, 1);
+  }
+  EXPECT_EQ(2 * kSize, cache_->tenantPinnedBytes(1));
+  EXPECT_EQ(3 * kSize, cache_->tenantBytes(1));
+
+  // Filling the cache twice over evicts everything but the pinned entries,
+  // which are the oldest.
+  for (auto i = 3; i < 2 * kMaxBytes / kSize; ++i) {
+    load(i * kSize, 0);
+  }
+  auto stats = cache_->refreshStats();
+  EXPECT_LT(0, stats.numEvict);
+  EXPECT_EQ(2 * kSize, stats.tenantPinnedBytes);
+  EXPECT_LE(2 * kSize, stats.tenants[1].bytes);
+  EXPECT_EQ(3, stats.tenants[1].numNew);
+  EXPECT_TRUE(cache_->exists({filenames_[0].id(), 0}));
+  EXPECT_TRUE(cache_->exists({filenames_[0].id(), kSize}));
+
+  // Without a budget the entries are evicted like the others.
+  cache_->setTenantBudget(1, 0);
+  cache_->clear();
+  EXPECT_EQ(0, cache_->tenantPinnedBytes(1));
+  EXPECT_EQ(0, cache_->tenantBytes(1));
+}
+
+TEST_F(AsyncDataCacheTest, tenantQuota) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 64 << 10;
+  constexpr int32_t kNumProduction = kMaxBytes / kSize / 2;
+  initializeCache(kMaxBytes);
+  cache_->setTenantQuota(2, kMaxBytes / 4);
+  auto load = [&](int32_t fileIndex, uint64_t offset, int32_t tenant) {
+    RawFileCacheKey key{filenames_[fileIndex].id(), offset};
+    auto pin = cache_->findOrCreate(key, kSize, nullptr, tenant);
+    ASSERT_FALSE(pin.empty());
+    if (pin.entry()->isExclusive()) {
+      pin.entry()->setExclusiveToShared();
+    }
+  };
+  // Tenant 1 fills half the cache and hits all of it once.
+  for (auto i = 0; i < kNumProduction; ++i) {
+    load(0, i * kSize, 1);
+  }
+  for (auto i = 0; i < kNumProduction; ++i) {
+    load(0, i * kSize, 1);
+  }
+
+  // Tenant 2 scans three times the cache size. Once the cache is full and
+  // tenant 2 is over its quota, its own entries make space for its new
+  // ones and the entries of tenant 1 stay.
+  for (auto i = 0; i < 3 * kMaxBytes / kSize; ++i) {
+    load(1, i * kSize, 2);
+  }
+  auto stats = cache_->refreshStats();
+  EXPECT_LT(0, stats.numQuotaEvict);
+  EXPECT_EQ(kNumProduction * kSize, stats.tenants[1].bytes);
+  EXPECT_LT(kMaxBytes / 4, stats.tenants[2].bytes);
+  EXPECT_GE(kMaxBytes - kNumProduction * kSize, stats.tenants[2].bytes);
+  EXPECT_EQ(kNumProduction, stats.tenants[1].numHit);
+  EXPECT_EQ(kNumProduction, stats.tenants[1].numNew);
+  EXPECT_EQ(0, stats.tenants[2].numHit);
+  EXPECT_EQ(3 * kMaxBytes / kSize, stats.tenants[2].numNew);
+  for (auto i = 0; i < kNumProduction; ++i) {
+    EXPECT_TRUE(cache_->exists({filenames_[0].id(), i * kSize}));
+  }
+
+  cache_->clear();
+  EXPECT_EQ(0, cache_->tenantBytes(1));
+  EXPECT_EQ(0, cache_->tenantBytes(2));
+}
+
+TEST_F(AsyncDataCacheTest, cachedFiles) {
+  initializeCache(16 << 20);
+  const auto fileNum = filenames_[0].id();
+  EXPECT_FALSE(cache_->isFileCached(fileNum));
+  for (auto i = 0; i < 2; ++i) {
+    auto pin = cache_->findOrCreate({fileNum, i * 1000UL}, 1000);
+    pin.entry()->setExclusiveToShared();
+  }
+  EXPECT_TRUE(cache_->isFileCached(fileNum));
+  EXPECT_FALSE(cache_->isFileCached(filenames_[1].id()));
+
+  // The filter is usable in another process after a copy of its bits.
+  BloomFilter<> filter;
+  filter.setBits(cache_->cachedFilesFilter().bits());
+  EXPECT_TRUE(filter.mayContain(filePathHash("testing_file_0")));
+
+  cache_->clear();
+  EXPECT_FALSE(cache_->isFileCached(fileNum));
+}
+
 namespace {
 // Cuts off the last 1/10th of file at 'path'.
 void corruptFile(const std::string& path) {
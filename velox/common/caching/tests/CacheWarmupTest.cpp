@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/caching/CacheWarmup.h"
+#include "velox/common/caching/FileIds.h"
+#include "velox/common/memory/MmapAllocator.h"
+#include "velox/exec/tests/utils/TempFilePath.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::cache;
+
+using memory::MappedMemory;
+
+class CacheWarmupTest : public testing::Test {
+ protected:
+  static constexpr int32_t kFileSize = 4 << 20;
+  static constexpr int64_t kCacheBytes = 64 << 20;
+
+  void SetUp() override {
+    memory::MmapAllocatorOptions options;
+    options.capacity = kCacheBytes;
+    cache_ = std::make_shared<AsyncDataCache>(
+        std::make_shared<memory::MmapAllocator>(options), kCacheBytes);
+    executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(1);
+    tempFile_ = exec::test::TempFilePath::create();
+    std::string data(kFileSize, 0);
+    for (auto i = 0; i < kFileSize; ++i) {
+      data[i] = i % 251;
+    }
+    tempFile_->append(data);
+    fileName_ = StringIdLease(fileIds(), tempFile_->path);
+  }
+
+  void TearDown() override {
+    executor_->join();
+    cache_->clear();
+  }
+
+  // Returns a pin on the entry at 'offset' if the entry is cached.
+  CachePin find(uint64_t offset, int32_t size) {
+    auto pin = cache_->findOrCreate({fileName_.id(), offset}, size, nullptr);
+    if (pin.empty() || pin.entry()->isExclusive()) {
+      return CachePin();
+    }
+    return pin;
+  }
+
+  // Checks that 'pin' holds the bytes of the file at its offset.
+  static void checkContents(const CachePin& pin) {
+    auto entry = pin.checkedEntry();
+    int64_t offset = entry->offset();
+    int32_t checked = 0;
+    const auto& data = entry->data();
+    for (auto i = 0; i < data.numRuns() && checked < entry->size(); ++i) {
+      auto run = data.runAt(i);
+      for (auto j = 0; j < run.numBytes() && checked < entry->size(); ++j) {
+        ASSERT_EQ(
+            static_cast<char>((offset + checked) % 251), run.data<char>()[j]);
+        ++checked;
+      }
+    }
+  }
+
+  std::shared_ptr<AsyncDataCache> cache_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+  std::shared_ptr<exec::test::TempFilePath> tempFile_;
+  StringIdLease fileName_;
+};
+
+TEST_F(CacheWarmupTest, load) {
+  constexpr int32_t kLoadQuantum = 256 << 10;
+  CacheWarmup warmup(cache_.get(), executor_.get(), kLoadQuantum);
+  // The second region is split into entries of 'kLoadQuantum'.
+  warmup.add(
+      std::make_shared<LocalReadFile>(tempFile_->path),
+      fileName_.id(),
+      {{100'000, 50'000}, {1'000'000, 2 * kLoadQuantum + 1000}});
+  warmup.wait();
+
+  auto stats = warmup.stats();
+  EXPECT_EQ(4, stats.numEntries);
+  EXPECT_EQ(50'000 + 2 * kLoadQuantum + 1000, stats.bytes);
+  EXPECT_EQ(0, stats.numErrors);
+
+  auto pin = find(100'000, 50'000);
+  ASSERT_FALSE(pin.empty());
+  checkContents(pin);
+  // The first use of a warmed up entry is not a hit.
+  EXPECT_TRUE(pin.entry()->getAndClearFirstUseFlag());
+  EXPECT_EQ(0, cache_->refreshStats().numHit);
+  pin = find(1'000'000 + 2 * kLoadQuantum, 1000);
+  ASSERT_FALSE(pin.empty());
+  checkContents(pin);
+  // Not in the warmed up ranges.
+  EXPECT_TRUE(find(200'000, 1000).empty());
+}
+
+TEST_F(CacheWarmupTest, tenant) {
+  constexpr int32_t kSize = 100'000;
+  cache_->setTenantBudget(1, 2 * kSize);
+  CacheWarmup warmup(cache_.get(), executor_.get());
+  std::vector<CacheWarmup::Region> regions;
+  for (auto i = 0; i < 3; ++i) {
+    regions.push_back({i * 2UL * kSize, kSize});
+  }
+  warmup.add(
+      std::make_shared<LocalReadFile>(tempFile_->path),
+      fileName_.id(),
+      std::move(regions),
+      1);
+  warmup.wait();
+  // The third entry does not fit in the budget.
+  EXPECT_EQ(2, warmup.stats().numPinned);
+  EXPECT_EQ(2 * kSize, cache_->tenantPinnedBytes(1));
+  EXPECT_EQ(3 * kSize, cache_->tenantBytes(1));
+
+  // Out of memory eviction drops soft-pinned entries as well.
+  cache_->clear();
+  EXPECT_EQ(0, cache_->tenantPinnedBytes(1));
+  EXPECT_EQ(0, cache_->tenantBytes(1));
+  EXPECT_EQ(0, cache_->refreshStats().numEntries);
+}
@@ -16,6 +16,8 @@
 
 #include "velox/common/caching/CachedFactory.h"
 
+#include <condition_variable>
+
 #include "folly/executors/EDFThreadPoolExecutor.h"
 #include "folly/executors/thread_factory/NamedThreadFactory.h"
 #include "gtest/gtest.h"
@@ -224,3 +226,48 @@ TEST(CachedFactoryTest, retrievedCached) {
   }
   ASSERT_EQ(*generated, 5);
 }
+
+TEST(CachedFactoryTest, asyncGeneration) {
+  auto generator = std::make_unique<DoublerGenerator>();
+  auto* generated = &generator->generated_;
+  CachedFactory<int, int, DoublerGenerator> factory(
+      std::make_unique<SimpleLRUCache<int, int>>(1000), std::move(generator));
+  folly::EDFThreadPoolExecutor pool(
+      10, std::make_shared<folly::NamedThreadFactory>("test_pool"));
+  const int numValues = 5;
+  const int requestsPerValue = 10;
+  std::vector<folly::SemiFuture<CachedPtr<int, int>>> futures;
+  for (int i = 0; i < requestsPerValue; i++) {
+    for (int j = 0; j < numValues; j++) {
+      futures.push_back(factory.generateAsync(j, &pool));
+    }
+  }
+  auto values = folly::collectAll(std::move(futures)).get();
+  ASSERT_EQ(*generated, numValues);
+  for (int i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(*values[i].value(), 2 * (i % numValues));
+  }
+
+  auto cached = factory.generateAsync(1, &pool).get();
+  ASSERT_TRUE(cached.wasCached());
+  ASSERT_EQ(*generated, numValues);
+}
+
+TEST(CachedFactoryTest, evict) {
+  auto generator = std::make_unique<DoublerGenerator>();
+  auto* generated = &generator->generated_;
+  CachedFactory<int, int, DoublerGenerator> factory(
+      std::make_unique<SimpleLRUCache<int, int>>(1000), std::move(generator));
+  {
+    auto value = factory.generate(1);
+    // A value in use is not evicted.
+    ASSERT_FALSE(factory.evict(1));
+  }
+  ASSERT_TRUE(factory.evict(1));
+  ASSERT_EQ(factory.currentSize(), 0);
+  ASSERT_TRUE(factory.evict(2));
+
+  auto value = factory.generate(1);
+  ASSERT_FALSE(value.wasCached());
+  ASSERT_EQ(*generated, 2);
+}
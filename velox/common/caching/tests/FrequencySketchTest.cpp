@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/FrequencySketch.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::cache;
+
+TEST(FrequencySketchTest, estimate) {
+  FrequencySketch sketch(1024);
+  EXPECT_EQ(0, sketch.estimate(1));
+  for (auto i = 0; i < 5; ++i) {
+    sketch.increment(1);
+  }
+  sketch.increment(2);
+  EXPECT_EQ(5, sketch.estimate(1));
+  EXPECT_EQ(1, sketch.estimate(2));
+  EXPECT_EQ(0, sketch.estimate(3));
+
+  // The counters saturate.
+  for (auto i = 0; i < 100; ++i) {
+    sketch.increment(1);
+  }
+  EXPECT_EQ(FrequencySketch::kMaxCount, sketch.estimate(1));
+}
+
+TEST(FrequencySketchTest, aging) {
+  constexpr int32_t kWidth = 1024;
+  FrequencySketch sketch(kWidth);
+  for (auto i = 0; i < 8; ++i) {
+    sketch.increment(1);
+  }
+  // Accesses to another key eventually halve the counts.
+  for (auto i = 0; i < 10 * kWidth - 8; ++i) {
+    sketch.increment(2);
+  }
+  EXPECT_EQ(4, sketch.estimate(1));
+  EXPECT_EQ(FrequencySketch::kMaxCount / 2, sketch.estimate(2));
+}
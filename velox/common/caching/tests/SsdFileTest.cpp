@@ -22,6 +22,8 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <unistd.h>
+
 using namespace facebook::velox;
 using namespace facebook::velox::cache;
 
@@ -47,7 +49,10 @@ class SsdFileTest : public testing::Test {
     }
   }
 
-  void initializeCache(int64_t maxBytes, int64_t ssdBytes = 0) {
+  void initializeCache(
+      int64_t maxBytes,
+      int64_t ssdBytes = 0,
+      int64_t checkpointIntervalBytes = 0) {
     // tmpfs does not support O_DIRECT, so turn this off for testing.
     FLAGS_ssd_odirect = false;
     cache_ = std::make_shared<AsyncDataCache>(
@@ -56,10 +61,22 @@ class SsdFileTest : public testing::Test {
     fileName_ = StringIdLease(fileIds(), "fileInStorage");
 
     tempDirectory_ = exec::test::TempDirectoryPath::create();
+    openFile(ssdBytes, checkpointIntervalBytes);
+  }
+
+  // Opens the SSD file in 'tempDirectory_', recovering from its checkpoint
+  // if 'checkpointIntervalBytes' is set.
+  void openFile(int64_t ssdBytes, int64_t checkpointIntervalBytes = 0) {
+    ssdFile_.reset();
     ssdFile_ = std::make_unique<SsdFile>(
-        fmt::format("{}/ssdtest", tempDirectory_->path),
+        filePath(),
         0,
-        bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize);
+        bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize,
+        checkpointIntervalBytes);
+  }
+
+  std::string filePath() const {
+    return fmt::format("{}/ssdtest", tempDirectory_->path);
   }
 
   static void initializeContents(
@@ -295,3 +312,40 @@ TEST_F(SsdFileTest, writeAndRead) {
     }
   }
 }
+
+TEST_F(SsdFileTest, recoverFromCheckpoint) {
+  constexpr int64_t kSsdSize = 4 * SsdFile::kRegionSize;
+  // Checkpoints are only made when forced.
+  constexpr int64_t kCheckpointIntervalBytes = 1L << 40;
+  initializeCache(128 * kMB, kSsdSize, kCheckpointIntervalBytes);
+  auto pins = makePins(fileName_.id(), 0, 4096, 2048 * 1025, 62 * kMB);
+  ssdFile_->write(pins);
+  const auto numEntries = pins.size();
+  pins.clear();
+  ssdFile_->checkpoint(true);
+
+  // A restarted file finds the entries of the checkpoint.
+  openFile(kSsdSize, kCheckpointIntervalBytes);
+  SsdCacheStats stats;
+  ssdFile_->updateStats(stats);
+  EXPECT_EQ(numEntries, stats.entriesRecovered);
+  EXPECT_EQ(0, stats.entriesDropped);
+  EXPECT_EQ(numEntries, stats.entriesCached);
+  EXPECT_LT(0, stats.bytesCached);
+  cache_->clear();
+  pins = makePins(fileName_.id(), 0, 4096, 2048 * 1025, 62 * kMB);
+  readAndCheckPins(pins);
+  pins.clear();
+  ssdFile_->checkpoint(true);
+
+  // The entries are dropped if the file no longer has their data.
+  ssdFile_.reset();
+  ASSERT_EQ(0, truncate(filePath().c_str(), 0));
+  openFile(kSsdSize, kCheckpointIntervalBytes);
+  stats = SsdCacheStats();
+  ssdFile_->updateStats(stats);
+  EXPECT_EQ(0, stats.entriesRecovered);
+  EXPECT_EQ(numEntries, stats.entriesDropped);
+  EXPECT_EQ(0, stats.entriesCached);
+  EXPECT_TRUE(ssdFile_->find(RawFileCacheKey{fileName_.id(), 0}).empty());
+}
@@ -15,6 +15,7 @@
  */
 
 #include "velox/common/file/File.h"
+#include "velox/common/file/IoUring.h"
 
 #include <fmt/format.h>
 #include <glog/logging.h>
@@ -23,6 +24,8 @@
 
 #include <fcntl.h>
 #include <folly/portability/SysUio.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 namespace facebook::velox {
 
@@ -64,11 +67,38 @@ uint64_t InMemoryWriteFile::size() const {
   return file_->size();
 }
 
-LocalReadFile::LocalReadFile(std::string_view path) {
+namespace {
+#ifdef __linux__
+constexpr int32_t kDirectFlag = O_DIRECT;
+#else
+constexpr int32_t kDirectFlag = 0;
+#endif
+
+// Largest scratch buffer for direct reads that are not aligned.
+constexpr uint64_t kMaxDirectScratch = 8 << 20;
+
+void fadvise(int32_t fd, uint64_t offset, uint64_t length, int32_t advice) {
+#ifdef __linux__
+  // The advice is a hint, so errors are ignored.
+  posix_fadvise(fd, offset, length, advice);
+#endif
+}
+
+struct AlignedFree {
+  void operator()(char* ptr) const {
+    ::free(ptr);
+  }
+};
+} // namespace
+
+LocalReadFile::LocalReadFile(
+    std::string_view path,
+    const LocalReadOptions& options)
+    : options_(options) {
   std::unique_ptr<char[]> buf(new char[path.size() + 1]);
   buf[path.size()] = 0;
   memcpy(buf.get(), path.data(), path.size());
-  fd_ = open(buf.get(), O_RDONLY);
+  fd_ = open(buf.get(), O_RDONLY | (options_.directIo ? kDirectFlag : 0));
   VELOX_CHECK_GE(
       fd_,
       0,
@@ -76,6 +106,7 @@ LocalReadFile::LocalReadFile(std::string_view path) {
       fd_,
       path,
       strerror(errno));
+  ownsFd_ = true;
   const off_t rc = lseek(fd_, 0, SEEK_END);
   VELOX_CHECK_GE(
       rc,
@@ -85,13 +116,60 @@ LocalReadFile::LocalReadFile(std::string_view path) {
       path,
       strerror(errno));
   size_ = rc;
+  adviseFile();
+}
+
+LocalReadFile::LocalReadFile(int32_t fd, const LocalReadOptions& options)
+    : options_(options), fd_(fd) {
+  adviseFile();
+}
+
+LocalReadFile::~LocalReadFile() {
+  if (ownsFd_) {
+    ::close(fd_);
+  }
+}
+
+void LocalReadFile::adviseFile() const {
+  VELOX_CHECK(
+      !options_.directIo ||
+          (options_.directIoAlignment > 0 &&
+           (options_.directIoAlignment & (options_.directIoAlignment - 1)) ==
+               0),
+      "directIoAlignment must be a power of 2: {}",
+      options_.directIoAlignment);
+#ifdef __linux__
+  switch (options_.advice) {
+    case LocalReadOptions::Advice::kNormal:
+      break;
+    case LocalReadOptions::Advice::kSequential:
+      fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+      break;
+    case LocalReadOptions::Advice::kRandom:
+      fadvise(fd_, 0, 0, POSIX_FADV_RANDOM);
+      break;
+  }
+#endif
 }
 
-LocalReadFile::LocalReadFile(int32_t fd) : fd_(fd) {}
+void LocalReadFile::adviseAfterRead(uint64_t offset, uint64_t length) const {
+#ifdef __linux__
+  if (options_.dropCache && !options_.directIo) {
+    fadvise(fd_, offset, length, POSIX_FADV_DONTNEED);
+  }
+  if (options_.readAheadBytes > 0 && !options_.directIo) {
+    fadvise(fd_, offset + length, options_.readAheadBytes, POSIX_FADV_WILLNEED);
+  }
+#endif
+}
 
 void LocalReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
     const {
   bytesRead_ += length;
+  if (options_.directIo) {
+    preadDirect(offset, length, pos);
+    return;
+  }
   auto bytesRead = ::pread(fd_, pos, length, offset);
   VELOX_CHECK_EQ(
       bytesRead,
@@ -99,6 +177,55 @@ void LocalReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
       "fread failure in LocalReadFile::PReadInternal, {} vs {}.",
       bytesRead,
       length);
+  adviseAfterRead(offset, length);
+}
+
+void LocalReadFile::preadDirect(uint64_t offset, uint64_t length, char* pos)
+    const {
+  const uint64_t alignment = options_.directIoAlignment;
+  if ((offset | length | reinterpret_cast<uintptr_t>(pos)) % alignment == 0) {
+    auto bytesRead = ::pread(fd_, pos, length, offset);
+    VELOX_CHECK_EQ(
+        bytesRead,
+        length,
+        "O_DIRECT read failure in LocalReadFile, {} vs {}: {}.",
+        bytesRead,
+        length,
+        strerror(errno));
+    return;
+  }
+  // Reads the aligned blocks covering the range into an aligned scratch
+  // buffer, at most kMaxDirectScratch at a time, and copies the range out.
+  const uint64_t end = offset + length;
+  const uint64_t firstBlock = offset & ~(alignment - 1);
+  const uint64_t scratchSize = std::min<uint64_t>(
+      ((end - firstBlock) + alignment - 1) & ~(alignment - 1),
+      kMaxDirectScratch);
+  char* rawScratch = nullptr;
+  VELOX_CHECK_EQ(
+      posix_memalign(
+          reinterpret_cast<void**>(&rawScratch), alignment, scratchSize),
+      0,
+      "Failed to allocate {} bytes for O_DIRECT read",
+      scratchSize);
+  std::unique_ptr<char, AlignedFree> scratch(rawScratch);
+  uint64_t blockOffset = firstBlock;
+  while (offset < end) {
+    // The read may be short at the end of the file.
+    auto bytesRead = ::pread(fd_, scratch.get(), scratchSize, blockOffset);
+    const uint64_t copyStart = offset - blockOffset;
+    VELOX_CHECK(
+        bytesRead > 0 && static_cast<uint64_t>(bytesRead) > copyStart,
+        "O_DIRECT read failure in LocalReadFile at {}: {}.",
+        blockOffset,
+        strerror(errno));
+    const uint64_t copySize =
+        std::min<uint64_t>(bytesRead - copyStart, end - offset);
+    memcpy(pos, scratch.get() + copyStart, copySize);
+    pos += copySize;
+    offset += copySize;
+    blockOffset += scratchSize;
+  }
 }
 
 std::string_view
@@ -114,12 +241,10 @@ std::string LocalReadFile::pread(uint64_t offset, uint64_t length) const {
   return result;
 }
 
-uint64_t LocalReadFile::preadv(
-    uint64_t offset,
-    const std::vector<folly::Range<char*>>& buffers) const {
-  // Dropped bytes sized so that a typical dropped range of 50K is not
-  // too many iovecs.
-  static thread_local std::vector<char> droppedBytes(16 * 1024);
+// static
+std::vector<iovec> LocalReadFile::makeIovecs(
+    const std::vector<folly::Range<char*>>& buffers,
+    std::vector<char>& droppedBytes) {
   std::vector<struct iovec> iovecs;
   iovecs.reserve(buffers.size());
   for (auto& range : buffers) {
@@ -134,7 +259,57 @@ uint64_t LocalReadFile::preadv(
       iovecs.push_back({range.data(), range.size()});
     }
   }
-  return folly::preadv(fd_, iovecs.data(), iovecs.size(), offset);
+  return iovecs;
+}
+
+uint64_t LocalReadFile::preadv(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  if (options_.directIo) {
+    // Reads the ranges one by one since the buffers are generally not
+    // aligned. The gaps are not read.
+    uint64_t numRead = 0;
+    for (auto& range : buffers) {
+      if (range.data()) {
+        preadInternal(offset + numRead, range.size(), range.data());
+      }
+      numRead += range.size();
+    }
+    return numRead;
+  }
+  if (IoUring::instance()) {
+    return preadvAsync(offset, buffers).get();
+  }
+  // Dropped bytes sized so that a typical dropped range of 50K is not
+  // too many iovecs.
+  static thread_local std::vector<char> droppedBytes(16 * 1024);
+  auto iovecs = makeIovecs(buffers, droppedBytes);
+  const auto numRead = folly::preadv(fd_, iovecs.data(), iovecs.size(), offset);
+  if (numRead > 0) {
+    adviseAfterRead(offset, numRead);
+  }
+  return numRead;
+}
+
+folly::SemiFuture<uint64_t> LocalReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  auto ring = IoUring::instance();
+  if (!ring || options_.directIo) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  // Shared by the reads in flight on all threads. The skipped bytes are
+  // not used, so concurrent reads into this do not matter.
+  static std::vector<char> droppedBytes(16 * 1024);
+  try {
+    return ring->preadv(fd_, makeIovecs(buffers, droppedBytes), offset);
+  } catch (const std::exception& e) {
+    return folly::makeSemiFuture<uint64_t>(e);
+  }
+}
+
+bool LocalReadFile::hasPreadvAsync() const {
+  return IoUring::instance() != nullptr && !options_.directIo;
 }
 
 uint64_t LocalReadFile::size() const {
@@ -35,6 +35,7 @@
 
 #include <folly/Range.h>
 #include <folly/futures/Future.h>
+#include <folly/portability/SysUio.h>
 
 #include "velox/common/base/Exceptions.h"
 
@@ -189,11 +190,47 @@ class InMemoryWriteFile final : public WriteFile {
 // internal arenaing), as local disk writes are expected to be cheap. Local
 // files match against any filepath starting with '/'.
 
+// Options for how a LocalReadFile uses the OS page cache. The defaults
+// leave the page cache and kernel readahead as they are.
+struct LocalReadOptions {
+  // Access pattern hint given to posix_fadvise() for the whole file.
+  enum class Advice { kNormal, kSequential, kRandom };
+
+  // Opens the file with O_DIRECT so that reads bypass the page cache, e.g.
+  // when the data is cached in AsyncDataCache. Reads into buffers aligned to
+  // 'directIoAlignment' at aligned offsets and sizes, e.g. MappedMemory
+  // pages, go straight to the buffer. Other reads go through an aligned
+  // scratch buffer.
+  bool directIo{false};
+
+  // Alignment of offsets, sizes and buffers for O_DIRECT. Must be a power of
+  // two and a multiple of the logical block size of the device.
+  int32_t directIoAlignment{4096};
+
+  Advice advice{Advice::kNormal};
+
+  // Advises the kernel to drop the pages of each range after it is read.
+  // Has the effect of 'directIo' for buffered reads without the alignment
+  // constraints.
+  bool dropCache{false};
+
+  // If non-zero, each read is followed by a POSIX_FADV_WILLNEED of this
+  // many bytes after the range read, so that sequential reads find their
+  // data in the page cache.
+  int64_t readAheadBytes{0};
+};
+
 class LocalReadFile final : public ReadFile {
  public:
-  explicit LocalReadFile(std::string_view path);
+  explicit LocalReadFile(
+      std::string_view path,
+      const LocalReadOptions& options = {});
 
-  explicit LocalReadFile(int32_t fd);
+  // Reads from 'fd', which stays owned by the caller. 'options.directIo'
+  // must match whether 'fd' was opened with O_DIRECT.
+  explicit LocalReadFile(int32_t fd, const LocalReadOptions& options = {});
+
+  ~LocalReadFile();
 
   std::string_view
   pread(uint64_t offset, uint64_t length, void* FOLLY_NONNULL buf) const final;
@@ -202,21 +239,56 @@ class LocalReadFile final : public ReadFile {
 
   uint64_t size() const final;
 
+  // Reads through IoUring::instance() if there is one.
   uint64_t preadv(
       uint64_t offset,
       const std::vector<folly::Range<char*>>& buffers) const final;
 
+  // Asynchronous if there is an IoUring::instance().
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  // Asynchronous if there is an IoUring::instance() and 'directIo' is off.
+  // Direct reads are synchronous.
+  bool hasPreadvAsync() const final;
+
   uint64_t memoryUsage() const final;
 
   bool shouldCoalesce() const final {
     return false;
   }
 
+  const LocalReadOptions& options() const {
+    return options_;
+  }
+
  private:
+  // Applies 'options_.advice'.
+  void adviseFile() const;
+
   void preadInternal(uint64_t offset, uint64_t length, char* FOLLY_NONNULL pos)
       const;
 
+  // Reads [offset, offset + length) with O_DIRECT into 'pos'.
+  void preadDirect(uint64_t offset, uint64_t length, char* FOLLY_NONNULL pos)
+      const;
+
+  // Gives the page cache hints of 'options_' after reading [offset, offset +
+  // length).
+  void adviseAfterRead(uint64_t offset, uint64_t length) const;
+
+  // Returns the iovecs for reading into 'buffers'. The ranges to skip are
+  // read into 'droppedBytes'.
+  static std::vector<iovec> makeIovecs(
+      const std::vector<folly::Range<char*>>& buffers,
+      std::vector<char>& droppedBytes);
+
+  const LocalReadOptions options_;
   int32_t fd_;
+  // True if 'fd_' was opened by the constructor and is closed by the
+  // destructor.
+  bool ownsFd_{false};
   long size_;
 };
 
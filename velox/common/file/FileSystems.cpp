@@ -64,11 +64,35 @@ namespace {
 
 folly::once_flag localFSInstantiationFlag;
 
+// Reads the LocalReadOptions of the files opened by the local file system
+// from 'config'.
+LocalReadOptions localReadOptions(const Config* config) {
+  LocalReadOptions options;
+  if (!config) {
+    return options;
+  }
+  options.directIo = config->get<bool>("local.direct-io", false);
+  options.directIoAlignment =
+      config->get<int32_t>("local.direct-io-alignment", 4096);
+  options.dropCache = config->get<bool>("local.drop-cache", false);
+  options.readAheadBytes = config->get<int64_t>("local.readahead-bytes", 0);
+  const auto advice = config->get<std::string>("local.fadvise", "normal");
+  if (advice == "sequential") {
+    options.advice = LocalReadOptions::Advice::kSequential;
+  } else if (advice == "random") {
+    options.advice = LocalReadOptions::Advice::kRandom;
+  } else {
+    VELOX_USER_CHECK_EQ(
+        advice, "normal", "Unknown value of local.fadvise: {}", advice);
+  }
+  return options;
+}
+
 // Implement Local FileSystem.
 class LocalFileSystem : public FileSystem {
  public:
   explicit LocalFileSystem(std::shared_ptr<const Config> config)
-      : FileSystem(config) {}
+      : FileSystem(config), readOptions_(localReadOptions(config.get())) {}
 
   ~LocalFileSystem() override {}
 
@@ -76,6 +100,11 @@ class LocalFileSystem : public FileSystem {
     return "Local FS";
   }
 
+  IoProfile ioProfile() const override {
+    // A local SSD: 100us to the first byte, then 2GB/s.
+    return {100, 2000};
+  }
+
   inline std::string_view extractPath(std::string_view path) {
     if (path.find(kFileScheme) == 0) {
       return path.substr(kFileScheme.length());
@@ -84,7 +113,7 @@ class LocalFileSystem : public FileSystem {
   }
 
   std::unique_ptr<ReadFile> openFileForRead(std::string_view path) override {
-    return std::make_unique<LocalReadFile>(extractPath(path));
+    return std::make_unique<LocalReadFile>(extractPath(path), readOptions_);
   }
 
   std::unique_ptr<WriteFile> openFileForWrite(std::string_view path) override {
@@ -136,6 +165,11 @@ class LocalFileSystem : public FileSystem {
       return lfs;
     };
   }
+
+ private:
+  // Applies to all files since one instance serves all callers. A caller
+  // that needs other options constructs the LocalReadFile directly.
+  const LocalReadOptions readOptions_;
 };
 } // namespace
 
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/base/CoalesceIo.h"
 #include "velox/common/base/Exceptions.h"
 
 #include <functional>
@@ -58,6 +59,12 @@ class FileSystem {
   // output if there are many entries in the folder.
   virtual std::vector<std::string> list(std::string_view path) = 0;
 
+  // Returns the expected latency and throughput of reads, used for
+  // coalescing nearby reads until measured. Empty if not known.
+  virtual IoProfile ioProfile() const {
+    return {};
+  }
+
  protected:
   std::shared_ptr<const Config> config_;
 };
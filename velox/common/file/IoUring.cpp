@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/file/IoUring.h"
+
+#include <glog/logging.h>
+#include <system_error>
+
+#include "velox/common/base/Exceptions.h"
+
+#ifdef VELOX_ENABLE_IO_URING
+#include <liburing.h>
+#endif
+
+DEFINE_bool(
+    velox_use_io_uring,
+    false,
+    "Use io_uring for the IO of local files and the SSD cache if available");
+
+DEFINE_int32(
+    velox_io_uring_queue_depth,
+    256,
+    "Maximum number of requests in flight on the io_uring");
+
+namespace facebook::velox {
+
+// static
+IoUring* IoUring::instance() {
+  if (!FLAGS_velox_use_io_uring) {
+    return nullptr;
+  }
+  static std::unique_ptr<IoUring> instance = []() {
+    try {
+      return std::make_unique<IoUring>(FLAGS_velox_io_uring_queue_depth);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Not using io_uring: " << e.what();
+      return std::unique_ptr<IoUring>();
+    }
+  }();
+  return instance.get();
+}
+
+folly::SemiFuture<uint64_t>
+IoUring::preadv(int32_t fd, std::vector<iovec> iovecs, uint64_t offset) {
+  std::vector<Request> requests;
+  requests.push_back({std::move(iovecs), offset});
+  return std::move(submit(fd, false, std::move(requests))[0]);
+}
+
+folly::SemiFuture<uint64_t>
+IoUring::pwritev(int32_t fd, std::vector<iovec> iovecs, uint64_t offset) {
+  std::vector<Request> requests;
+  requests.push_back({std::move(iovecs), offset});
+  return std::move(submit(fd, true, std::move(requests))[0]);
+}
+
+#ifdef VELOX_ENABLE_IO_URING
+
+// static
+bool IoUring::isAvailable() {
+  return true;
+}
+
+IoUring::IoUring(int32_t queueDepth)
+    : queueDepth_(queueDepth), ring_(new io_uring()) {
+  VELOX_CHECK_GT(queueDepth_, 0);
+  auto rc = io_uring_queue_init(queueDepth_, ring_, 0);
+  if (rc < 0) {
+    delete ring_;
+    VELOX_FAIL("io_uring_queue_init failed with {}", -rc);
+  }
+  reaper_ = std::thread([this]() { reap(); });
+}
+
+IoUring::~IoUring() {
+  {
+    std::unique_lock<std::mutex> l(submitMutex_);
+    stop_ = true;
+    // The requests in flight reference the memory of their callers.
+    spaceAvailable_.wait(l, [&]() { return numInFlight_ == 0; });
+    // Wakes up the reaper with a request without data.
+    auto sqe = io_uring_get_sqe(ring_);
+    VELOX_CHECK_NOT_NULL(sqe);
+    io_uring_prep_nop(sqe);
+    io_uring_sqe_set_data(sqe, nullptr);
+    io_uring_submit(ring_);
+  }
+  reaper_.join();
+  io_uring_queue_exit(ring_);
+  delete ring_;
+}
+
+std::vector<folly::SemiFuture<uint64_t>>
+IoUring::submit(int32_t fd, bool isWrite, std::vector<Request> requests) {
+  std::vector<folly::SemiFuture<uint64_t>> futures;
+  futures.reserve(requests.size());
+  std::unique_lock<std::mutex> l(submitMutex_);
+  VELOX_CHECK(!stop_);
+  int32_t index = 0;
+  while (index < requests.size()) {
+    // Submits as many requests as fit in the queue at a time. The
+    // submission queue is empty between batches since each batch is
+    // submitted in full.
+    spaceAvailable_.wait(l, [&]() { return numInFlight_ < queueDepth_; });
+    int32_t numInBatch = 0;
+    while (index < requests.size() &&
+           numInFlight_ + numInBatch < queueDepth_) {
+      auto& request = requests[index++];
+      auto sqe = io_uring_get_sqe(ring_);
+      VELOX_CHECK_NOT_NULL(sqe);
+      auto pending = new Pending{std::move(request.iovecs)};
+      futures.push_back(pending->promise.getSemiFuture());
+      if (isWrite) {
+        io_uring_prep_writev(
+            sqe,
+            fd,
+            pending->iovecs.data(),
+            pending->iovecs.size(),
+            request.offset);
+      } else {
+        io_uring_prep_readv(
+            sqe,
+            fd,
+            pending->iovecs.data(),
+            pending->iovecs.size(),
+            request.offset);
+      }
+      io_uring_sqe_set_data(sqe, pending);
+      ++numInBatch;
+    }
+    numInFlight_ += numInBatch;
+    while (numInBatch > 0) {
+      auto rc = io_uring_submit(ring_);
+      if (rc == -EINTR || rc == -EAGAIN || rc == -EBUSY) {
+        continue;
+      }
+      // The queued requests reference the caller's memory, so they cannot
+      // be abandoned.
+      LOG_IF(FATAL, rc < 0) << "io_uring_submit failed with " << -rc;
+      numInBatch -= rc;
+    }
+  }
+  return futures;
+}
+
+void IoUring::reap() {
+  for (;;) {
+    io_uring_cqe* cqe;
+    auto rc = io_uring_wait_cqe(ring_, &cqe);
+    if (rc == -EINTR) {
+      continue;
+    }
+    VELOX_CHECK_GE(rc, 0, "io_uring_wait_cqe failed");
+    auto pending = reinterpret_cast<Pending*>(io_uring_cqe_get_data(cqe));
+    const auto result = cqe->res;
+    io_uring_cqe_seen(ring_, cqe);
+    if (!pending) {
+      VELOX_CHECK(stop_);
+      return;
+    }
+    if (result < 0) {
+      pending->promise.setException(
+          std::system_error(-result, std::generic_category(), "io_uring"));
+    } else {
+      pending->promise.setValue(result);
+    }
+    delete pending;
+    {
+      std::lock_guard<std::mutex> l(submitMutex_);
+      --numInFlight_;
+    }
+    spaceAvailable_.notify_all();
+  }
+}
+
+#else
+
+// static
+bool IoUring::isAvailable() {
+  return false;
+}
+
+IoUring::IoUring(int32_t queueDepth) : queueDepth_(queueDepth) {
+  VELOX_UNSUPPORTED("Velox is built without VELOX_ENABLE_IO_URING");
+}
+
+IoUring::~IoUring() = default;
+
+std::vector<folly::SemiFuture<uint64_t>>
+IoUring::submit(int32_t, bool, std::vector<Request>) {
+  VELOX_UNSUPPORTED("Velox is built without VELOX_ENABLE_IO_URING");
+}
+
+void IoUring::reap() {}
+
+#endif
+
+} // namespace facebook::velox
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <folly/futures/Future.h>
+#include <gflags/gflags.h>
+#include <sys/uio.h>
+
+DECLARE_bool(velox_use_io_uring);
+DECLARE_int32(velox_io_uring_queue_depth);
+
+struct io_uring;
+
+namespace facebook::velox {
+
+// Submits reads and writes of local files to an io_uring and realizes their
+// futures from a completion thread, so that IO does not take a thread per
+// request. Available if built with VELOX_ENABLE_IO_URING. LocalReadFile and
+// SsdFile use the process-wide instance if FLAGS_velox_use_io_uring is set at
+// startup.
+class IoUring {
+ public:
+  // A read or write of 'iovecs' at 'offset' in one submission.
+  struct Request {
+    std::vector<iovec> iovecs;
+    uint64_t offset;
+  };
+
+  // Returns the process-wide ring, or nullptr if io_uring is not built in,
+  // not enabled by FLAGS_velox_use_io_uring or not supported by the kernel.
+  static IoUring* FOLLY_NULLABLE instance();
+
+  // Returns true if built with VELOX_ENABLE_IO_URING.
+  static bool isAvailable();
+
+  // Sets up a ring with 'queueDepth' entries and starts the completion
+  // thread. Throws if the ring cannot be set up.
+  explicit IoUring(int32_t queueDepth);
+
+  ~IoUring();
+
+  // Reads 'fd' at 'offset' into 'iovecs'. The future gives the bytes read
+  // or an exception with the errno of the read. The memory referenced by
+  // 'iovecs' must stay valid until the future is realized.
+  folly::SemiFuture<uint64_t>
+  preadv(int32_t fd, std::vector<iovec> iovecs, uint64_t offset);
+
+  // Writes 'iovecs' to 'fd' at 'offset'. Same as preadv() otherwise.
+  folly::SemiFuture<uint64_t>
+  pwritev(int32_t fd, std::vector<iovec> iovecs, uint64_t offset);
+
+  // Submits all of 'requests' on 'fd' with one system call. Returns a future
+  // for each request.
+  std::vector<folly::SemiFuture<uint64_t>>
+  submit(int32_t fd, bool isWrite, std::vector<Request> requests);
+
+  // Number of requests submitted and not yet completed.
+  int32_t numInFlight() const {
+    return numInFlight_;
+  }
+
+ private:
+  struct Pending {
+    std::vector<iovec> iovecs;
+    folly::Promise<uint64_t> promise;
+  };
+
+  // Takes completions off the ring and realizes their promises until
+  // 'stop_' is set.
+  void reap();
+
+  const int32_t queueDepth_;
+  io_uring* FOLLY_NULLABLE ring_{nullptr};
+
+  // Serializes access to the submission queue.
+  std::mutex submitMutex_;
+  // Signaled when a completion makes room for more requests in flight.
+  std::condition_variable spaceAvailable_;
+  std::atomic<int32_t> numInFlight_{0};
+
+  std::atomic<bool> stop_{false};
+  std::thread reaper_;
+};
+
+} // namespace facebook::velox
@@ -25,6 +25,18 @@ DEFINE_int64(
 DEFINE_int32(num_threads, 16, "Test paralelism");
 DEFINE_int32(seed, 0, "Random seed, 0 means no seed");
 DEFINE_bool(odirect, false, "Use O_DIRECT");
+DEFINE_string(
+    fadvise,
+    "normal",
+    "Access pattern advice for the file: normal, sequential or random");
+DEFINE_bool(
+    drop_cache,
+    false,
+    "Drop the pages of each read from the OS page cache after reading");
+DEFINE_int64(
+    readahead_bytes,
+    0,
+    "If non-0, advises the OS to prefetch this many bytes after each read");
 
 DEFINE_int32(
     bytes,
@@ -58,6 +70,8 @@ void ReadBenchmark::run() {
     modes(FLAGS_bytes, FLAGS_gap, FLAGS_num_in_run);
     return;
   }
+  sequentialReads(64 << 10);
+  sequentialReads(1 << 20);
   modes(1100, 0, 10);
   modes(1100, 1200, 10);
   modes(16 * 1024, 0, 10);
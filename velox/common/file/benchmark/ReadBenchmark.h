@@ -38,6 +38,9 @@ DECLARE_int64(file_size_gb);
 DECLARE_int32(num_threads);
 DECLARE_int32(seed);
 DECLARE_bool(odirect);
+DECLARE_string(fadvise);
+DECLARE_bool(drop_cache);
+DECLARE_int64(readahead_bytes);
 DECLARE_int32(bytes);
 DECLARE_int32(gap);
 DECLARE_int32(num_in_run);
@@ -66,23 +69,21 @@ class ReadBenchmark {
   virtual void initialize() {
     executor_ =
         std::make_unique<folly::IOThreadPoolExecutor>(FLAGS_num_threads);
-    if (FLAGS_odirect) {
-      int32_t o_direct =
-#ifdef linux
-          O_DIRECT;
-#else
-          0;
-#endif
-      fd_ = open(
-          FLAGS_path.c_str(),
-          O_CREAT | O_RDWR | (FLAGS_odirect ? o_direct : 0),
-          S_IRUSR | S_IWUSR);
-      if (fd_ < 0) {
-        LOG(ERROR) << "Could not open " << FLAGS_path;
+    if (FLAGS_odirect || FLAGS_drop_cache || FLAGS_readahead_bytes ||
+        FLAGS_fadvise != "normal") {
+      LocalReadOptions options;
+      options.directIo = FLAGS_odirect;
+      options.dropCache = FLAGS_drop_cache;
+      options.readAheadBytes = FLAGS_readahead_bytes;
+      if (FLAGS_fadvise == "sequential") {
+        options.advice = LocalReadOptions::Advice::kSequential;
+      } else if (FLAGS_fadvise == "random") {
+        options.advice = LocalReadOptions::Advice::kRandom;
+      } else if (FLAGS_fadvise != "normal") {
+        LOG(ERROR) << "Unknown --fadvise " << FLAGS_fadvise;
         exit(1);
       }
-      readFile_ = std::make_unique<LocalReadFile>(fd_);
-
+      readFile_ = std::make_unique<LocalReadFile>(FLAGS_path, options);
     } else {
       filesystems::registerLocalFileSystem();
       auto lfs = filesystems::getFileSystem(FLAGS_path, nullptr);
@@ -273,6 +274,28 @@ class ReadBenchmark {
               << std::endl;
   }
 
+  // Measures the throughput of reading the first --measurement_size bytes
+  // of the file front to back in reads of 'size' bytes. This is where the
+  // page cache options and readahead matter.
+  void sequentialReads(int32_t size) {
+    clearCache();
+    auto& scratch = getScratch(size);
+    const uint64_t end =
+        std::min<uint64_t>(fileSize_, FLAGS_measurement_size);
+    uint64_t usec = 0;
+    {
+      MicrosecondTimer timer(&usec);
+      for (uint64_t offset = 0; offset + size <= end; offset += size) {
+        readFile_->pread(offset, size, scratch.buffer.data());
+      }
+    }
+    std::cout << fmt::format(
+                     "{} MB/s sequential {}",
+                     static_cast<float>(end - end % size) / usec,
+                     size)
+              << std::endl;
+  }
+
   void modes(int32_t size, int32_t gap, int32_t count) {
     int repeats =
         std::max<int32_t>(3, (FLAGS_measurement_size) / (size * count));
@@ -298,7 +321,6 @@ class ReadBenchmark {
   static constexpr int32_t kWrite = -10000;
   // 0 means no op, kWrite means being written, other numbers are reader counts.
   std::string writeBatch_;
-  int32_t fd_;
   std::unique_ptr<folly::IOThreadPoolExecutor> executor_;
   std::unique_ptr<ReadFile> readFile_;
   folly::Random::DefaultGenerator rng_;
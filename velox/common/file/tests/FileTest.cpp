@@ -16,9 +16,13 @@
 
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/file/IoUring.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/exec/tests/utils/TempFilePath.h"
 
+#include <fcntl.h>
+#include <gflags/gflags.h>
+#include <unistd.h>
 #include "gtest/gtest.h"
 
 using namespace facebook::velox;
@@ -92,6 +96,86 @@ TEST(LocalFile, writeAndRead) {
   readData(&readFile);
 }
 
+TEST(LocalFile, ioUring) {
+  if (!IoUring::isAvailable()) {
+    return;
+  }
+  gflags::FlagSaver flagSaver;
+  FLAGS_velox_use_io_uring = true;
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  LocalReadFile readFile(filename);
+  ASSERT_TRUE(readFile.hasPreadvAsync());
+  readData(&readFile);
+
+  // Several reads in one submission on a ring smaller than the batch.
+  IoUring ring(2);
+  auto fd = open(filename, O_RDONLY);
+  ASSERT_LE(0, fd);
+  constexpr int32_t kNumReads = 5;
+  char buffers[kNumReads][5];
+  std::vector<IoUring::Request> requests;
+  for (auto i = 0; i < kNumReads; ++i) {
+    requests.push_back({{{buffers[i], 5}}, static_cast<uint64_t>(i * 5)});
+  }
+  auto futures = ring.submit(fd, false, std::move(requests));
+  ASSERT_EQ(kNumReads, futures.size());
+  for (auto i = 0; i < kNumReads; ++i) {
+    EXPECT_EQ(5, std::move(futures[i]).get());
+  }
+  EXPECT_EQ("aaaaa", std::string_view(buffers[0], 5));
+  EXPECT_EQ("bbbbb", std::string_view(buffers[1], 5));
+  EXPECT_EQ("ccccc", std::string_view(buffers[4], 5));
+  close(fd);
+}
+
+TEST(LocalFile, pageCacheOptions) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  LocalReadOptions options;
+  options.advice = LocalReadOptions::Advice::kSequential;
+  options.dropCache = true;
+  options.readAheadBytes = kOneMB;
+  {
+    LocalReadFile readFile(filename, options);
+    readData(&readFile);
+  }
+
+#ifdef __linux__
+  // O_DIRECT is not supported by all file systems, e.g. tmpfs.
+  auto fd = open(filename, O_RDONLY | O_DIRECT);
+  if (fd < 0) {
+    return;
+  }
+  close(fd);
+  options = LocalReadOptions();
+  options.directIo = true;
+  LocalReadFile readFile(filename, options);
+  ASSERT_FALSE(readFile.hasPreadvAsync());
+  // Unaligned reads go through an aligned scratch buffer.
+  readData(&readFile);
+
+  // An aligned read goes directly to the buffer.
+  constexpr int32_t kAlignment = 4096;
+  void* buffer = nullptr;
+  ASSERT_EQ(0, posix_memalign(&buffer, kAlignment, 2 * kAlignment));
+  ASSERT_EQ(
+      readFile.pread(kAlignment, 2 * kAlignment, buffer),
+      std::string(2 * kAlignment, 'c'));
+  free(buffer);
+#endif
+}
+
 TEST(LocalFile, viaRegistry) {
   filesystems::registerLocalFileSystem();
   auto tempFile = ::exec::test::TempFilePath::create();
@@ -18,6 +18,7 @@
 #include <exception>
 #include <sstream>
 #include "velox/common/base/IOUtils.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/common/hyperloglog/BiasCorrection.h"
 #include "velox/common/hyperloglog/HllUtils.h"
 
@@ -571,8 +572,9 @@ void DenseHll::mergeWith(
   int8_t newBaseline = std::max(baseline_, otherBaseline);
   int32_t baselineCount = 0;
 
-  int bucket = 0;
-  for (int i = 0; i < deltas_.size(); i++) {
+  // Merges the 2 buckets in the byte at 'i' of the deltas.
+  auto mergeSlot = [&](int32_t i) {
+    int32_t bucket = i * 2;
     int newSlot = 0;
 
     int8_t slot1 = deltas_[i];
@@ -613,6 +615,45 @@ void DenseHll::mergeWith(
     }
 
     deltas_[i] = newSlot;
+  };
+
+  // Merges a batch of bytes at a time, i.e. takes the max of the buckets of
+  // both HLLs and rebases these on the new baseline. Batches with a bucket
+  // that may have an overflow entry, i.e. has the max delta in either HLL, or
+  // that needs one after the merge go through mergeSlot().
+  using Batch = xsimd::batch<uint8_t>;
+  const auto maxDelta = Batch::broadcast(kMaxDelta);
+  const auto baseline1 = Batch::broadcast(baseline_);
+  const auto baseline2 = Batch::broadcast(otherBaseline);
+  const auto baseline = Batch::broadcast(newBaseline);
+  const auto zero = Batch::broadcast(0);
+  auto* rawDeltas = reinterpret_cast<uint8_t*>(deltas_.data());
+  auto* rawOtherDeltas = reinterpret_cast<const uint8_t*>(otherDeltas);
+  const int32_t numSlots = deltas_.size();
+  int32_t i = 0;
+  for (; i + Batch::size <= numSlots; i += Batch::size) {
+    auto slots1 = Batch::load_unaligned(rawDeltas + i);
+    auto slots2 = Batch::load_unaligned(rawOtherDeltas + i);
+    auto high1 = slots1 >> 4;
+    auto low1 = slots1 & maxDelta;
+    auto high2 = slots2 >> 4;
+    auto low2 = slots2 & maxDelta;
+    auto newHigh = xsimd::max(high1 + baseline1, high2 + baseline2) - baseline;
+    auto newLow = xsimd::max(low1 + baseline1, low2 + baseline2) - baseline;
+    if (xsimd::any(
+            (high1 == maxDelta) | (low1 == maxDelta) | (high2 == maxDelta) |
+            (low2 == maxDelta) | (newHigh > maxDelta) | (newLow > maxDelta))) {
+      for (auto j = i; j < i + Batch::size; ++j) {
+        mergeSlot(j);
+      }
+      continue;
+    }
+    ((newHigh << 4) | newLow).store_unaligned(rawDeltas + i);
+    baselineCount += __builtin_popcount(simd::toBitMask(newHigh == zero)) +
+        __builtin_popcount(simd::toBitMask(newLow == zero));
+  }
+  for (; i < numSlots; ++i) {
+    mergeSlot(i);
   }
 
   baseline_ = newBaseline;
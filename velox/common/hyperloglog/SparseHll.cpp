@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 #include "velox/common/hyperloglog/SparseHll.h"
+
+#include <algorithm>
+
 #include "velox/common/base/IOUtils.h"
 #include "velox/common/hyperloglog/HllUtils.h"
 
@@ -88,6 +91,30 @@ bool SparseHll::insertHash(uint64_t hash) {
   return entries_.size() >= softNumEntriesLimit_;
 }
 
+bool SparseHll::insertHashes(const uint64_t* hashes, int32_t numHashes) {
+  std::vector<uint32_t> batch(numHashes);
+  for (auto i = 0; i < numHashes; ++i) {
+    batch[i] = encode(
+        computeIndex(hashes[i], kIndexBitLength),
+        computeValue(hashes[i], kIndexBitLength));
+  }
+  // The value is in the low bits, so the last entry of each bucket has the
+  // largest value.
+  std::sort(batch.begin(), batch.end());
+  int32_t numEntries = 0;
+  for (auto i = 0; i < numHashes; ++i) {
+    if (i + 1 < numHashes &&
+        decodeIndex(batch[i]) == decodeIndex(batch[i + 1])) {
+      continue;
+    }
+    batch[numEntries++] = batch[i];
+  }
+  if (numEntries > 0) {
+    mergeWith(numEntries, batch.data());
+  }
+  return entries_.size() >= softNumEntriesLimit_;
+}
+
 int64_t SparseHll::cardinality() const {
   // Estimate the cardinality using linear counting over the theoretical
   // 2^kIndexBitLength buckets available due to the fact that we're
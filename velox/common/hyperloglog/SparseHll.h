@@ -35,6 +35,11 @@ class SparseHll {
   /// Returns true if soft memory limit has been reached. False, otherwise.
   bool insertHash(uint64_t hash);
 
+  /// Same as insertHash() for each of 'numHashes' 'hashes'. Sorts the
+  /// {bucket, value} pairs of the batch and merges them into the observed
+  /// buckets in one pass instead of a binary search and an insert per hash.
+  bool insertHashes(const uint64_t* hashes, int32_t numHashes);
+
   int64_t cardinality() const;
 
   /// Returns cardinality estimate from the specified serialized digest.
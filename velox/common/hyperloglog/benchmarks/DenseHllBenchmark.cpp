@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/hash/Hash.h>
+#include <folly/init/Init.h>
+
+#include "velox/common/hyperloglog/DenseHll.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::common::hll;
+
+namespace {
+
+HashStringAllocator& allocator() {
+  static HashStringAllocator allocator{memory::MappedMemory::getInstance()};
+  return allocator;
+}
+
+// Makes 'count' serialized HLLs with 'numValues' random values each.
+std::vector<std::string>
+makeSerializedHlls(int8_t indexBitLength, int32_t numValues, int32_t count) {
+  std::vector<std::string> serialized;
+  serialized.reserve(count);
+  for (auto i = 0; i < count; ++i) {
+    DenseHll hll{indexBitLength, &allocator()};
+    for (auto j = 0; j < numValues; ++j) {
+      hll.insertHash(folly::hash::twang_mix64(folly::Random::rand64()));
+    }
+    serialized.emplace_back(hll.serializedSize(), '\0');
+    hll.serialize(serialized.back().data());
+  }
+  return serialized;
+}
+
+// Merges 'count' serialized HLLs into one, as a final approx_distinct does
+// with the intermediate results of a group.
+void mergeSerialized(
+    int iters,
+    int8_t indexBitLength,
+    int32_t numValues,
+    int32_t count) {
+  std::vector<std::string> serialized;
+  BENCHMARK_SUSPEND {
+    serialized = makeSerializedHlls(indexBitLength, numValues, count);
+  }
+  for (auto i = 0; i < iters; ++i) {
+    DenseHll hll{indexBitLength, &allocator()};
+    for (const auto& other : serialized) {
+      hll.mergeWith(other.data());
+    }
+    folly::doNotOptimizeAway(hll.cardinality());
+  }
+}
+
+// Few values per HLL, i.e. few buckets with non-zero deltas.
+BENCHMARK_NAMED_PARAM(mergeSerialized, 11bits_100values, 11, 100, 1'000);
+BENCHMARK_NAMED_PARAM(mergeSerialized, 16bits_100values, 16, 100, 1'000);
+BENCHMARK_DRAW_LINE();
+// All buckets set.
+BENCHMARK_NAMED_PARAM(mergeSerialized, 11bits_100Kvalues, 11, 100'000, 1'000);
+BENCHMARK_NAMED_PARAM(mergeSerialized, 16bits_1Mvalues, 16, 1'000'000, 100);
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
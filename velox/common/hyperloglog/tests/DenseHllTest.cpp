@@ -219,6 +219,30 @@ TEST_P(DenseHllTest, mergeWith) {
   testMergeWith(indexBitLength, sequence(0, 2'000'000), sequence(0, 2'000'000));
 }
 
+TEST_P(DenseHllTest, mergeMany) {
+  int8_t indexBitLength = GetParam();
+
+  // Merges many HLLs of few values each. Most buckets stay below the max
+  // delta, while the baseline goes up as the merged HLL fills.
+  DenseHll merged{indexBitLength, &allocator_};
+  DenseHll expected{indexBitLength, &allocator_};
+  for (auto i = 0; i < 200; ++i) {
+    DenseHll hll{indexBitLength, &allocator_};
+    for (auto value : sequence(i * 50, i * 50 + 10 + i % 40)) {
+      auto hash = hashOne(value);
+      hll.insertHash(hash);
+      expected.insertHash(hash);
+    }
+    if (i % 2 == 0) {
+      merged.mergeWith(hll);
+    } else {
+      merged.mergeWith(serialize(hll).data());
+    }
+    ASSERT_EQ(serialize(merged), serialize(expected));
+  }
+  ASSERT_EQ(merged.cardinality(), expected.cardinality());
+}
+
 INSTANTIATE_TEST_SUITE_P(
     DenseHllTest,
     DenseHllTest,
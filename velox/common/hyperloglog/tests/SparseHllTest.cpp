@@ -138,6 +138,32 @@ TEST_F(SparseHllTest, highCardinality) {
   ASSERT_EQ(1'000, SparseHll::cardinality(serialized.data()));
 }
 
+TEST_F(SparseHllTest, insertHashes) {
+  SparseHll expected{&allocator_};
+  SparseHll sparseHll{&allocator_};
+  sparseHll.setSoftMemoryLimit(100 * 4);
+  expected.setSoftMemoryLimit(100 * 4);
+
+  // Batches overlap each other and repeat values within.
+  std::vector<uint64_t> hashes;
+  for (auto batch = 0; batch < 5; ++batch) {
+    hashes.clear();
+    bool limitReached = false;
+    for (auto i = 0; i < 50; ++i) {
+      hashes.push_back(hashOne(batch * 20 + i % 37));
+      limitReached = expected.insertHash(hashes.back());
+    }
+    ASSERT_EQ(
+        limitReached, sparseHll.insertHashes(hashes.data(), hashes.size()));
+    sparseHll.verify();
+    ASSERT_EQ(serialize(11, expected), serialize(11, sparseHll));
+  }
+  ASSERT_EQ(117, sparseHll.cardinality());
+
+  ASSERT_TRUE(sparseHll.insertHashes(nullptr, 0));
+  ASSERT_EQ(serialize(11, expected), serialize(11, sparseHll));
+}
+
 namespace {
 template <typename T>
 std::vector<T> sequence(T start, T end) {
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/AllocationSampler.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/SuccinctPrinter.h"
+
+namespace facebook::velox::memory {
+
+// static
+bool AllocationSampler::countDown(int64_t bytes, int64_t sampleBytes) {
+  thread_local int64_t bytesToSample = sampleBytes;
+  bytesToSample -= bytes;
+  if (bytesToSample > 0) {
+    return false;
+  }
+  bytesToSample = sampleBytes;
+  return true;
+}
+
+void AllocationSampler::record(int64_t bytes) {
+  // Skips the frame of record().
+  process::StackTrace stack(1);
+  const auto& frames = stack.getStack();
+  const auto hash = bits::hashBytes(
+      0,
+      reinterpret_cast<const char*>(frames.data()),
+      frames.size() * sizeof(void*));
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = sites_.find(hash);
+  if (it == sites_.end()) {
+    sites_.emplace(hash, Site{std::move(stack), 1, bytes});
+    return;
+  }
+  ++it->second.numSamples;
+  it->second.bytes += bytes;
+}
+
+std::vector<AllocationSampler::Site> AllocationSampler::sites() const {
+  std::vector<Site> sites;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    sites.reserve(sites_.size());
+    for (const auto& [hash, site] : sites_) {
+      sites.push_back(site);
+    }
+  }
+  std::sort(sites.begin(), sites.end(), [](const auto& a, const auto& b) {
+    return a.bytes > b.bytes;
+  });
+  return sites;
+}
+
+std::string AllocationSampler::toString(int32_t maxSites) const {
+  const auto allSites = sites();
+  std::stringstream out;
+  out << "Allocation sites: " << allSites.size() << "\n";
+  for (auto i = 0; i < allSites.size() && i < maxSites; ++i) {
+    const auto& site = allSites[i];
+    out << succinctBytes(site.bytes) << " in " << site.numSamples
+        << " samples:\n"
+        << site.stack.toString() << "\n";
+  }
+  return out.str();
+}
+
+void AllocationSampler::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  sites_.clear();
+}
+
+} // namespace facebook::velox::memory
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Likely.h>
+#include <gflags/gflags.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "velox/common/process/StackTrace.h"
+
+DECLARE_int64(velox_allocation_sample_bytes);
+
+namespace facebook::velox::memory {
+
+/// Records the call sites of a sample of the allocations of a MemoryPool or
+/// ScopedMappedMemory for finding out which code allocated the memory of a
+/// query. About one allocation per FLAGS_velox_allocation_sample_bytes bytes
+/// allocated on a thread is sampled. A sample records the stack trace of
+/// the allocation, aggregated by the hash of the stack. The bytes are the
+/// sum of the sampled allocations, not the memory currently allocated, since
+/// frees are not tracked. Sampling is off if the flag is 0, in which case
+/// the only cost is a check of the flag per allocation.
+class AllocationSampler {
+ public:
+  struct Site {
+    /// The stack of the first sample from the site.
+    process::StackTrace stack;
+    uint64_t numSamples{0};
+    int64_t bytes{0};
+  };
+
+  /// Returns true if an allocation of 'bytes' should be recorded with
+  /// record().
+  FOLLY_ALWAYS_INLINE static bool shouldSample(int64_t bytes) {
+    const auto sampleBytes = FLAGS_velox_allocation_sample_bytes;
+    if (FOLLY_LIKELY(sampleBytes <= 0)) {
+      return false;
+    }
+    return countDown(bytes, sampleBytes);
+  }
+
+  /// Records the call site of an allocation of 'bytes'.
+  void record(int64_t bytes);
+
+  /// Returns the sites recorded so far, the largest 'bytes' first.
+  std::vector<Site> sites() const;
+
+  /// Returns the 'maxSites' sites with the largest 'bytes' with their
+  /// symbolized stacks.
+  std::string toString(int32_t maxSites = 10) const;
+
+  void clear();
+
+ private:
+  // Subtracts 'bytes' from the bytes to allocate on this thread before the
+  // next sample. Returns true and starts the next countdown from
+  // 'sampleBytes' if at or below 0.
+  static bool countDown(int64_t bytes, int64_t sampleBytes);
+
+  mutable std::mutex mutex_;
+  // Keyed on the hash of the stack.
+  std::unordered_map<uint64_t, Site> sites_;
+};
+
+} // namespace facebook::velox::memory
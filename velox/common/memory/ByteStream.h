@@ -121,6 +121,17 @@ class ByteStream {
     lastRangeEnd_ = ranges_[0].size;
   }
 
+  /// Sets a holder of the memory of the input ranges. A reader that keeps
+  /// a reference to 'owner' may use the bytes in place after 'this' is gone
+  /// instead of copying them.
+  void setInputOwner(std::shared_ptr<void> owner) {
+    inputOwner_ = std::move(owner);
+  }
+
+  const std::shared_ptr<void>& inputOwner() const {
+    return inputOwner_;
+  }
+
   const std::vector<ByteRange>& ranges() const {
     return ranges_;
   }
@@ -253,6 +264,26 @@ class ByteStream {
         reinterpret_cast<char*>(current_->buffer) + position, viewSize);
   }
 
+  // Returns the next 'size' bytes and skips them if they are contiguous in
+  // one range, start at a multiple of 'alignment' and are followed by at
+  // least 'padding' more bytes of the range. Returns nullptr and does not
+  // skip otherwise.
+  const uint8_t*
+  nextContiguous(int32_t size, int32_t alignment, int32_t padding = 0) {
+    if (current_->position == current_->size && current_ != &ranges_.back()) {
+      next();
+    }
+    if (current_->size - current_->position < size + padding) {
+      return nullptr;
+    }
+    auto data = current_->buffer + current_->position;
+    if (reinterpret_cast<uintptr_t>(data) % alignment != 0) {
+      return nullptr;
+    }
+    current_->position += size;
+    return data;
+  }
+
   void skip(int32_t size) {
     for (;;) {
       int32_t available = current_->size - current_->position;
@@ -375,6 +406,9 @@ class ByteStream {
   // and the last may be partly full. The position in the last range
   // is not necessarily the the end if there has been a seek.
   int32_t lastRangeEnd_{0};
+
+  // Holds the memory of the input ranges if it can be used in place.
+  std::shared_ptr<void> inputOwner_;
 };
 
 template <>
@@ -229,6 +229,30 @@ HashStringAllocator::allocate(int32_t size, bool exactSize) {
   return header;
 }
 
+HashStringAllocator::Header* FOLLY_NULLABLE
+HashStringAllocator::findInFreeList(
+    int32_t index,
+    int32_t size,
+    int32_t maxChecked,
+    Header* FOLLY_NULLABLE& largest) {
+  auto& list = free_[index];
+  int32_t counter = 0;
+  for (auto* item = list.next(); item != &list; item = item->next()) {
+    auto header = headerOf(item);
+    VELOX_CHECK(header->isFree());
+    if (header->size() >= size) {
+      return header;
+    }
+    if (!largest || header->size() > largest->size()) {
+      largest = header;
+    }
+    if (++counter >= maxChecked) {
+      break;
+    }
+  }
+  return nullptr;
+}
+
 HashStringAllocator::Header* FOLLY_NULLABLE
 HashStringAllocator::allocateFromFreeList(
     int32_t preferredSize,
@@ -238,32 +262,36 @@ HashStringAllocator::allocateFromFreeList(
   if (!numFree_) {
     return nullptr;
   }
-  VELOX_CHECK(!free_.empty());
   preferredSize = std::max(kMinAlloc, preferredSize);
-  int32_t counter = 0;
+  const auto index = freeListIndex(preferredSize);
   Header* largest = nullptr;
-  Header* found = nullptr;
-  for (auto* item = free_.next(); item != &free_; item = item->next()) {
-    auto header = headerOf(item);
-    VELOX_CHECK(header->isFree());
-    auto size = header->size();
-    if (size >= preferredSize) {
-      found = header;
-      break;
-    }
-    if (!largest || size > largest->size()) {
-      largest = header;
-    }
-    if (!mustHaveSize && ++counter > kMaxCheckedForFit) {
-      break;
+  // A few blocks of the list for the size are checked first, so that a
+  // block of about the right size is preferred over splitting a larger one.
+  // Any block of a larger list fits.
+  Header* found =
+      findInFreeList(index, preferredSize, kMaxCheckedForFit, largest);
+  for (auto i = index + 1; !found && i < kNumFreeLists; ++i) {
+    if (!free_[i].empty()) {
+      found = headerOf(free_[i].next());
     }
   }
-  if (!mustHaveSize && !found) {
+  if (!found && mustHaveSize) {
+    found = findInFreeList(
+        index, preferredSize, std::numeric_limits<int32_t>::max(), largest);
+  }
+  if (!found && !mustHaveSize) {
+    // Any block will do. Takes the largest of a smaller size.
+    for (auto i = index - 1; !largest && i >= 0; --i) {
+      if (!free_[i].empty()) {
+        largest = headerOf(free_[i].next());
+      }
+    }
     found = largest;
   }
   if (!found) {
     return nullptr;
   }
+  VELOX_CHECK(found->isFree());
 
   --numFree_;
   freeBytes_ -= found->size() + sizeof(Header);
@@ -303,14 +331,16 @@ void HashStringAllocator::free(Header* _header) {
       }
     }
     if (header->isPreviousFree()) {
+      // The coalesced block may belong to a larger free list.
       auto previousFree = getPreviousFree(header);
+      removeFromFreeList(previousFree);
       previousFree->setSize(
           previousFree->size() + header->size() + sizeof(Header));
       header = previousFree;
     } else {
       ++numFree_;
-      free_.insert(reinterpret_cast<CompactDoubleList*>(header->begin()));
     }
+    insertIntoFreeList(header);
     markAsFree(header);
     header = continued;
   } while (header);
@@ -438,9 +468,13 @@ void HashStringAllocator::checkConsistency() const {
   VELOX_CHECK(freeBytes == freeBytes_);
   uint64_t numInFreeList = 0;
   uint64_t bytesInFreeList = 0;
-  for (auto free = free_.next(); free != &free_; free = free->next()) {
-    ++numInFreeList;
-    bytesInFreeList += headerOf(free)->size() + sizeof(Header);
+  for (auto i = 0; i < kNumFreeLists; ++i) {
+    for (auto free = free_[i].next(); free != &free_[i]; free = free->next()) {
+      auto header = headerOf(free);
+      VELOX_CHECK_EQ(freeListIndex(header->size()), i);
+      ++numInFreeList;
+      bytesInFreeList += header->size() + sizeof(Header);
+    }
   }
   VELOX_CHECK(numInFreeList == numFree_);
   VELOX_CHECK(bytesInFreeList == freeBytes_);
@@ -26,7 +26,7 @@ namespace facebook::velox {
 
 // Implements an arena backed by MappedMemory::Allocation. This is for backing
 // ByteStream or for allocating single blocks. Blocks can be individually freed.
-// Adjacent frees are coalesced and free blocks are kept in a free list.
+// Adjacent frees are coalesced and free blocks are kept in free lists by size.
 // Allocated blocks are prefixed with a Header. This has a size and flags.
 // kContinue means that last 8 bytes are a pointer to another Header after which
 // the contents of this allocation continue. kFree means the block is free. A
@@ -266,7 +266,9 @@ class HashStringAllocator : public StreamArena {
   void clear() {
     numFree_ = 0;
     freeBytes_ = 0;
-    new (&free_) CompactDoubleList();
+    for (auto& list : free_) {
+      new (&list) CompactDoubleList();
+    }
     pool_.clear();
   }
 
@@ -286,6 +288,17 @@ class HashStringAllocator : public StreamArena {
   static constexpr int32_t kUnitSize = 16 * memory::MappedMemory::kPageSize;
   static constexpr int32_t kMinContiguous = 48;
 
+  // Number of free lists. Free list i > 0 has the blocks of at least
+  // 2^(i + 5) bytes and less than twice that, free list 0 the smaller ones
+  // and the last list the larger ones.
+  static constexpr int32_t kNumFreeLists = 9;
+
+  // Returns the free list for a free block of 'size' bytes.
+  static int32_t freeListIndex(int32_t size) {
+    const int32_t log2 = 31 - __builtin_clz(std::max<int32_t>(size, 1));
+    return std::min(std::max(log2 - 5, 0), kNumFreeLists - 1);
+  }
+
   // Adds 'bytes' worth of contiguous space to the free list. This
   // grows the footprint in MappedMemory but does not allocate
   // anything yet. Throws if fails to grow. The caller typically knows
@@ -294,12 +307,29 @@ class HashStringAllocator : public StreamArena {
   // starting to process a batch of input.
   void newSlab(int32_t size);
 
+  // Removes 'header' from its free list. Must be called before the size of
+  // 'header' changes.
   void removeFromFreeList(Header* FOLLY_NONNULL header) {
     VELOX_CHECK(header->isFree());
     header->clearFree();
     reinterpret_cast<CompactDoubleList*>(header->begin())->remove();
   }
 
+  // Adds 'header' to the free list for its size.
+  void insertIntoFreeList(Header* FOLLY_NONNULL header) {
+    free_[freeListIndex(header->size())].insert(
+        reinterpret_cast<CompactDoubleList*>(header->begin()));
+  }
+
+  // Returns the first block of at least 'size' bytes in the first 'maxChecked'
+  // blocks of free list 'index', or nullptr. Sets 'largest' to the largest
+  // block checked if it is larger than 'largest'.
+  Header* FOLLY_NULLABLE findInFreeList(
+      int32_t index,
+      int32_t size,
+      int32_t maxChecked,
+      Header* FOLLY_NULLABLE& largest);
+
   /// Allocates a block of specified size. If exactSize is false, the block may
   /// be smaller or larger. Checks free list before allocating new memory.
   Header* FOLLY_NULLABLE allocate(int32_t size, bool exactSize);
@@ -321,10 +351,12 @@ class HashStringAllocator : public StreamArena {
   // blocks would be below minimum size.
   void freeRestOfBlock(Header* FOLLY_NONNULL header, int32_t keepBytes);
 
-  // Circular list of free blocks.
-  CompactDoubleList free_;
+  // Circular lists of free blocks by size, see freeListIndex(). The blocks of
+  // a list above the list for a size are at least that large, so that most
+  // allocations take the first block of a list.
+  CompactDoubleList free_[kNumFreeLists];
 
-  // Count of elements in 'free_'. This is 0 when free_.next() == &free_.
+  // Count of elements in 'free_'. This is 0 when all lists are empty.
   uint64_t numFree_ = 0;
 
   // Sum of the size of blocks in 'free_', excluding headers.
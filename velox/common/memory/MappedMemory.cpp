@@ -150,6 +150,11 @@ class MappedMemoryImpl : public MappedMemory {
         allocation.size(), [&]() { freeContiguousImpl(allocation); });
   }
 
+  bool growContiguous(
+      MachinePageCount increment,
+      ContiguousAllocation& allocation,
+      std::function<void(int64_t, bool)> userAllocCB = nullptr) override;
+
   MachinePageCount numAllocated() const override {
     return numAllocated_;
   }
@@ -352,6 +357,35 @@ void MappedMemoryImpl::freeContiguousImpl(ContiguousAllocation& allocation) {
   }
 }
 
+bool MappedMemoryImpl::growContiguous(
+    MachinePageCount increment,
+    ContiguousAllocation& allocation,
+    std::function<void(int64_t, bool)> userAllocCB) {
+  VELOX_CHECK_GT(allocation.numPages(), 0);
+#ifdef __linux__
+  const auto newSize = allocation.size() + increment * kPageSize;
+  if (userAllocCB != nullptr) {
+    userAllocCB(increment * kPageSize, true);
+  }
+  void* data =
+      mremap(allocation.data(), allocation.size(), newSize, MREMAP_MAYMOVE);
+  if (data == MAP_FAILED) {
+    LOG(WARNING) << "mremap got " << errno << " for " << allocation.data()
+                 << ", " << allocation.size() << " to " << newSize;
+    if (userAllocCB != nullptr) {
+      userAllocCB(increment * kPageSize, false);
+    }
+    return false;
+  }
+  numAllocated_.fetch_add(increment);
+  numMapped_.fetch_add(increment);
+  allocation.reset(this, data, newSize);
+  return true;
+#else
+  return false;
+#endif
+}
+
 bool MappedMemoryImpl::checkConsistency() const {
   if (FLAGS_velox_use_malloc) {
     return true;
@@ -472,6 +506,9 @@ bool ScopedMappedMemory::allocate(
     std::function<void(int64_t, bool)> userAllocCB,
     MachinePageCount minSizeClass) {
   free(out);
+  if (AllocationSampler::shouldSample(numPages * kPageSize)) {
+    allocationSampler_.record(numPages * kPageSize);
+  }
   return parent_->allocate(
       numPages,
       owner,
@@ -492,6 +529,9 @@ bool ScopedMappedMemory::allocateContiguous(
     Allocation* FOLLY_NULLABLE collateral,
     ContiguousAllocation& allocation,
     std::function<void(int64_t, bool)> userAllocCB) {
+  if (AllocationSampler::shouldSample(numPages * kPageSize)) {
+    allocationSampler_.record(numPages * kPageSize);
+  }
   bool success = parent_->allocateContiguous(
       numPages,
       collateral,
@@ -509,12 +549,39 @@ bool ScopedMappedMemory::allocateContiguous(
   }
   return success;
 }
+bool ScopedMappedMemory::growContiguous(
+    MachinePageCount increment,
+    ContiguousAllocation& allocation,
+    std::function<void(int64_t, bool)> userAllocCB) {
+  if (AllocationSampler::shouldSample(increment * kPageSize)) {
+    allocationSampler_.record(increment * kPageSize);
+  }
+  bool success = parent_->growContiguous(
+      increment,
+      allocation,
+      [this, userAllocCB](int64_t allocBytes, bool preAlloc) {
+        if (tracker_) {
+          tracker_->update(preAlloc ? allocBytes : -allocBytes);
+        }
+        if (userAllocCB) {
+          userAllocCB(allocBytes, preAlloc);
+        }
+      });
+  if (success) {
+    allocation.reset(this, allocation.data(), allocation.size());
+  }
+  return success;
+}
+
 Stats Stats::operator-(const Stats& other) const {
   Stats result;
   for (auto i = 0; i < sizes.size(); ++i) {
     result.sizes[i] = sizes[i] - other.sizes[i];
   }
   result.numAdvise = numAdvise - other.numAdvise;
+  result.numCrossNodeFreedPages =
+      numCrossNodeFreedPages - other.numCrossNodeFreedPages;
+  result.numAdvisedHugePages = numAdvisedHugePages - other.numAdvisedHugePages;
   return result;
 }
 
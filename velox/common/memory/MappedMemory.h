@@ -26,6 +26,7 @@
 #include <gflags/gflags.h>
 #include "velox/common/base/CheckedArithmetic.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/memory/AllocationSampler.h"
 #include "velox/common/memory/MemoryUsageTracker.h"
 #include "velox/common/time/Timer.h"
 
@@ -138,6 +139,15 @@ struct Stats {
 
   /// Cumulative count of pages advised away, if the allocator exposes this.
   int64_t numAdvise{0};
+
+  /// Cumulative count of pages freed by a thread on a different NUMA node
+  /// than the node the pages were placed on, if the allocator places memory
+  /// per node. This approximates the cross-node accesses to the memory.
+  int64_t numCrossNodeFreedPages{0};
+
+  /// Cumulative count of huge pages whose memory was advised away whole, if
+  /// the allocator backs its memory with huge pages.
+  int64_t numAdvisedHugePages{0};
 };
 
 class ScopedMappedMemory;
@@ -404,6 +414,20 @@ class MappedMemory : public std::enable_shared_from_this<MappedMemory> {
 
   virtual void freeContiguous(ContiguousAllocation& allocation) = 0;
 
+  /// Grows 'allocation', made by allocateContiguous(), by 'increment' pages
+  /// while keeping its contents. The kernel moves the pages with mremap
+  /// instead of copying them, so that growing does not need the old and
+  /// the new size at the same time. The address may change. The new pages
+  /// are zeroed. 'userAllocCB' is called with the increment as in
+  /// allocateContiguous(). Returns false and leaves 'allocation' unchanged
+  /// if the capacity would be exceeded or the allocation cannot be
+  /// remapped, e.g. because it is in an MmapArena, in which case the caller
+  /// can make a new allocation instead.
+  virtual bool growContiguous(
+      MachinePageCount increment,
+      ContiguousAllocation& allocation,
+      std::function<void(int64_t, bool)> userAllocCB = nullptr) = 0;
+
   // Allocates 'bytes' contiguous bytes and returns the pointer to the first
   // byte. If 'bytes' is less than 'maxMallocSize', delegates the allocation to
   // malloc. If the size is above that and below the largest size classes' size,
@@ -447,6 +471,12 @@ class MappedMemory : public std::enable_shared_from_this<MappedMemory> {
     return nullptr;
   }
 
+  // Returns the call sites of the sampled allocations of 'this' or nullptr
+  // if 'this' does not sample, see AllocationSampler.
+  virtual const AllocationSampler* FOLLY_NULLABLE allocationSampler() const {
+    return nullptr;
+  }
+
   // Returns static counters for allocateBytes usage.
 
   static AllocateBytesStats allocateBytesStats() {
@@ -563,6 +593,11 @@ class ScopedMappedMemory final : public MappedMemory {
     }
   }
 
+  bool growContiguous(
+      MachinePageCount increment,
+      ContiguousAllocation& allocation,
+      std::function<void(int64_t, bool)> userAllocCB = nullptr) override;
+
   bool checkConsistency() const override {
     return parent_->checkConsistency();
   }
@@ -592,10 +627,15 @@ class ScopedMappedMemory final : public MappedMemory {
     return parent_->stats();
   }
 
+  const AllocationSampler* FOLLY_NULLABLE allocationSampler() const override {
+    return &allocationSampler_;
+  }
+
  private:
   std::shared_ptr<MappedMemory> parentPtr_;
   MappedMemory* FOLLY_NONNULL parent_;
   std::shared_ptr<MemoryUsageTracker> tracker_;
+  AllocationSampler allocationSampler_;
 };
 
 // An Allocator backed by MappedMemory for for STL containers.
@@ -36,7 +36,9 @@
 #include "velox/common/base/CheckedArithmetic.h"
 #include "velox/common/base/GTestMacros.h"
 #include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/memory/AllocationSampler.h"
 #include "velox/common/memory/MappedMemory.h"
+#include "velox/common/memory/MemoryArbitrator.h"
 #include "velox/common/memory/MemoryUsage.h"
 #include "velox/common/memory/MemoryUsageTracker.h"
 
@@ -151,6 +153,12 @@ class MemoryPool : public AbstractMemoryPool {
   virtual void release(int64_t /* bytes */, bool /* mock */ = false) {
     VELOX_NYI("release() needs to be implemented in derived memory pool.");
   }
+
+  /// Returns the call sites of the sampled allocations of 'this' or nullptr
+  /// if 'this' does not sample, see AllocationSampler.
+  virtual const AllocationSampler* FOLLY_NULLABLE allocationSampler() const {
+    return nullptr;
+  }
 };
 
 namespace detail {
@@ -303,6 +311,10 @@ class ScopedMemoryPool final : public MemoryPool {
     pool_.release(bytes, mock);
   }
 
+  const AllocationSampler* FOLLY_NULLABLE allocationSampler() const override {
+    return pool_.allocationSampler();
+  }
+
  private:
   std::weak_ptr<MemoryPool> poolPtr_;
   MemoryPool& pool_;
@@ -507,6 +519,10 @@ class MemoryPoolImpl : public MemoryPoolBase {
   void reserve(int64_t size) override;
   void release(int64_t size, bool mock = false) override;
 
+  const AllocationSampler* FOLLY_NULLABLE allocationSampler() const override {
+    return &allocationSampler_;
+  }
+
  private:
   VELOX_FRIEND_TEST(MemoryPoolTest, Ctor);
 
@@ -568,6 +584,9 @@ class MemoryPoolImpl : public MemoryPoolBase {
   std::atomic_bool capped_{false};
 
   Allocator& allocator_;
+
+  // Call sites of the sampled allocations.
+  AllocationSampler allocationSampler_;
 };
 
 constexpr folly::StringPiece kRootNodeName{"__root__"};
@@ -600,6 +619,15 @@ class IMemoryManager {
   virtual bool reserve(int64_t size) = 0;
   // Subtracts from current total and regain memory quota.
   virtual void release(int64_t size) = 0;
+
+  /// Sets the arbitrator that divides the memory between the queries. The
+  /// QueryCtxs created afterwards add the trackers of their pools to it.
+  /// Must be called before any query starts.
+  virtual void setArbitrator(std::shared_ptr<MemoryArbitrator> arbitrator) = 0;
+
+  /// Returns the arbitrator set by setArbitrator() or nullptr if the query
+  /// pools have fixed caps.
+  virtual const std::shared_ptr<MemoryArbitrator>& arbitrator() const = 0;
 };
 
 // For now, users wanting multiple different allocators would need to
@@ -645,6 +673,14 @@ class MemoryManager final : public IMemoryManager {
   bool reserve(int64_t size) final;
   void release(int64_t size) final;
 
+  void setArbitrator(std::shared_ptr<MemoryArbitrator> arbitrator) final {
+    arbitrator_ = std::move(arbitrator);
+  }
+
+  const std::shared_ptr<MemoryArbitrator>& arbitrator() const final {
+    return arbitrator_;
+  }
+
   Allocator& getAllocator();
 
  private:
@@ -660,6 +696,7 @@ class MemoryManager final : public IMemoryManager {
   std::shared_ptr<MemoryPool> root_;
   mutable folly::SharedMutex mutex_;
   std::atomic_long totalBytes_{0};
+  std::shared_ptr<MemoryArbitrator> arbitrator_;
 };
 
 template <typename Allocator, uint16_t ALIGNMENT>
@@ -684,6 +721,9 @@ MemoryPoolImpl<Allocator, ALIGNMENT>::allocate(int64_t size) {
   }
   auto alignedSize = sizeAlign<ALIGNMENT>(ALIGNER<ALIGNMENT>{}, size);
   reserve(alignedSize);
+  if (AllocationSampler::shouldSample(alignedSize)) {
+    allocationSampler_.record(alignedSize);
+  }
   return allocAligned<ALIGNMENT>(ALIGNER<ALIGNMENT>{}, alignedSize);
 }
 
@@ -697,6 +737,9 @@ void* FOLLY_NULLABLE MemoryPoolImpl<Allocator, ALIGNMENT>::allocateZeroFilled(
     VELOX_MEM_MANUAL_CAP();
   }
   reserve(alignedSize * sizeEach);
+  if (AllocationSampler::shouldSample(alignedSize * sizeEach)) {
+    allocationSampler_.record(alignedSize * sizeEach);
+  }
   return allocator_.allocZeroFilled(alignedSize, sizeEach);
 }
 
@@ -715,6 +758,9 @@ void* FOLLY_NULLABLE MemoryPoolImpl<Allocator, ALIGNMENT>::reallocate(
   }
 
   reserve(difference);
+  if (AllocationSampler::shouldSample(difference)) {
+    allocationSampler_.record(difference);
+  }
   void* newP = reallocAligned<ALIGNMENT>(
       ALIGNER<ALIGNMENT>{}, p, alignedSize, alignedNewSize);
   if (UNLIKELY(!newP)) {
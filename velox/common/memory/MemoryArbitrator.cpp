@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/MemoryArbitrator.h"
+
+#include <algorithm>
+
+#include "velox/common/base/SuccinctPrinter.h"
+
+namespace facebook::velox::memory {
+
+std::string MemoryArbitrator::Stats::toString() const {
+  return fmt::format(
+      "requests {} grows {} failures {} reclaims {} reclaimed {} shrunk {}",
+      numRequests,
+      numGrows,
+      numFailures,
+      numReclaims,
+      succinctBytes(reclaimedBytes),
+      succinctBytes(shrunkBytes));
+}
+
+MemoryArbitrator::MemoryArbitrator(const Config& config)
+    : config_(config), freeCapacity_(config.capacity) {
+  VELOX_CHECK_GT(config_.capacity, 0);
+  VELOX_CHECK_GE(config_.initialCapacity, 0);
+  VELOX_CHECK_GT(config_.minGrowBytes, 0);
+}
+
+void MemoryArbitrator::addTracker(
+    const std::shared_ptr<MemoryUsageTracker>& tracker,
+    int32_t priority) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK_EQ(entries_.count(tracker.get()), 0, "Tracker added twice");
+  auto& entry = entries_[tracker.get()];
+  entry.tracker = tracker;
+  entry.priority = priority;
+  entry.capacity = 0;
+  const auto capacity = std::max(
+      tracker->totalReservedBytes(),
+      std::min(config_.initialCapacity, freeCapacity_));
+  setCapacityLocked(entry, *tracker, capacity);
+  tracker->setGrowCallback(
+      [this](
+          MemoryUsageTracker::UsageType /*type*/,
+          int64_t /*size*/,
+          MemoryUsageTracker& growing) { return grow(growing); });
+}
+
+void MemoryArbitrator::removeTracker(MemoryUsageTracker* tracker) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(tracker);
+  VELOX_CHECK(it != entries_.end(), "Tracker not added");
+  freeCapacity_ += it->second.capacity;
+  entries_.erase(it);
+  tracker->setGrowCallback(nullptr);
+}
+
+int64_t MemoryArbitrator::shrink(MemoryUsageTracker* tracker) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(tracker);
+  VELOX_CHECK(it != entries_.end(), "Tracker not added");
+  return shrinkLocked(it->second);
+}
+
+int64_t MemoryArbitrator::freeCapacity() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return freeCapacity_;
+}
+
+MemoryArbitrator::Stats MemoryArbitrator::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return stats_;
+}
+
+bool MemoryArbitrator::grow(MemoryUsageTracker& tracker) {
+  int32_t priority;
+  int64_t bytes;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    ++stats_.numRequests;
+    auto it = entries_.find(&tracker);
+    if (it == entries_.end()) {
+      ++stats_.numFailures;
+      return false;
+    }
+    auto& entry = it->second;
+    // The usage includes the allocation that exceeded the cap. Another
+    // thread may already have grown the cap far enough.
+    const auto needed = tracker.totalReservedBytes() - entry.capacity;
+    if (needed <= 0) {
+      return true;
+    }
+    priority = entry.priority;
+    bytes = std::max(needed, config_.minGrowBytes);
+    if (freeCapacity_ < bytes && freeCapacity_ >= needed) {
+      bytes = needed;
+    }
+    if (freeCapacity_ >= bytes) {
+      setCapacityLocked(entry, tracker, entry.capacity + bytes);
+      ++stats_.numGrows;
+      return true;
+    }
+    if (reclaiming_) {
+      ++stats_.numFailures;
+      return false;
+    }
+    reclaiming_ = true;
+  }
+
+  const bool success = reclaim(&tracker, priority, bytes);
+
+  std::lock_guard<std::mutex> l(mutex_);
+  reclaiming_ = false;
+  auto it = entries_.find(&tracker);
+  if (success && it != entries_.end()) {
+    auto& entry = it->second;
+    const auto needed = tracker.totalReservedBytes() - entry.capacity;
+    if (needed <= 0) {
+      return true;
+    }
+    if (freeCapacity_ >= needed) {
+      setCapacityLocked(
+          entry, tracker, entry.capacity + std::min(bytes, freeCapacity_));
+      ++stats_.numGrows;
+      return true;
+    }
+  }
+  ++stats_.numFailures;
+  return false;
+}
+
+bool MemoryArbitrator::reclaim(
+    MemoryUsageTracker* requestor,
+    int32_t priority,
+    int64_t bytes) {
+  struct Candidate {
+    int32_t priority;
+    int64_t usage;
+    std::shared_ptr<MemoryUsageTracker> tracker;
+  };
+  std::vector<Candidate> candidates;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    // Takes back the unused capacity of the other trackers first.
+    for (auto& [tracker, entry] : entries_) {
+      if (tracker != requestor) {
+        shrinkLocked(entry);
+      }
+    }
+    if (freeCapacity_ >= bytes) {
+      return true;
+    }
+    for (auto& [tracker, entry] : entries_) {
+      if (tracker == requestor || entry.priority > priority) {
+        continue;
+      }
+      if (auto candidate = entry.tracker.lock()) {
+        const auto usage = candidate->totalReservedBytes();
+        if (usage > 0) {
+          candidates.push_back({entry.priority, usage, std::move(candidate)});
+        }
+      }
+    }
+  }
+
+  // Reclaims from the lowest priority first and then from the largest.
+  std::sort(
+      candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        if (a.priority != b.priority) {
+          return a.priority < b.priority;
+        }
+        return a.usage > b.usage;
+      });
+  for (auto& candidate : candidates) {
+    auto& tracker = candidate.tracker;
+    int64_t targetBytes;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (freeCapacity_ >= bytes) {
+        return true;
+      }
+      targetBytes = bytes - freeCapacity_;
+    }
+    // Called without holding 'mutex_' since the reclaimer waits for the
+    // drivers of the reclaimed query, which may need to grow meanwhile.
+    const auto reclaimedBytes = tracker->reclaim(targetBytes);
+    std::lock_guard<std::mutex> l(mutex_);
+    ++stats_.numReclaims;
+    stats_.reclaimedBytes += reclaimedBytes;
+    auto it = entries_.find(tracker.get());
+    if (it != entries_.end()) {
+      shrinkLocked(it->second);
+    }
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  return freeCapacity_ >= bytes;
+}
+
+void MemoryArbitrator::setCapacityLocked(
+    Entry& entry,
+    MemoryUsageTracker& tracker,
+    int64_t capacity) {
+  freeCapacity_ -= capacity - entry.capacity;
+  entry.capacity = capacity;
+  tracker.updateConfig(
+      MemoryUsageConfigBuilder().maxTotalMemory(capacity).build());
+}
+
+int64_t MemoryArbitrator::shrinkLocked(Entry& entry) {
+  auto tracker = entry.tracker.lock();
+  if (!tracker) {
+    return 0;
+  }
+  const auto usage = tracker->totalReservedBytes();
+  if (usage >= entry.capacity) {
+    return 0;
+  }
+  const auto freed = entry.capacity - usage;
+  setCapacityLocked(entry, *tracker, usage);
+  stats_.shrunkBytes += freed;
+  return freed;
+}
+
+} // namespace facebook::velox::memory
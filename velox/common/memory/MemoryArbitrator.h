@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "velox/common/memory/MemoryUsageTracker.h"
+
+namespace facebook::velox::memory {
+
+/// Divides a process wide memory capacity between the root trackers of the
+/// queries. Each tracker starts with a small cap that is grown from the free
+/// capacity when an allocation would exceed it. If there is not enough free
+/// capacity, the unused capacity of the other trackers is taken back first
+/// and then memory is revoked from the trackers with the lowest priority
+/// through their reclaimers, see MemoryUsageTracker::addReclaimer(). After
+/// being reclaimed, the cap of a tracker is lowered to its usage. A tracker
+/// can only revoke memory from trackers of the same or lower priority.
+///
+/// Only one arbitration that reclaims memory runs at a time. A
+/// concurrent grow that would need to reclaim fails instead of waiting,
+/// since the trackers being reclaimed may need the waiting thread to go
+/// off thread first.
+class MemoryArbitrator {
+ public:
+  struct Config {
+    /// Memory divided between the trackers.
+    int64_t capacity;
+
+    /// Cap given to a tracker when it is added.
+    int64_t initialCapacity{64 << 20};
+
+    /// Minimum increment of the cap of a tracker.
+    int64_t minGrowBytes{8 << 20};
+  };
+
+  struct Stats {
+    /// Number of grows requested by the trackers.
+    uint64_t numRequests{0};
+    /// Number of requests that were granted.
+    uint64_t numGrows{0};
+    /// Number of requests that failed.
+    uint64_t numFailures{0};
+    /// Number of times a tracker was asked to free memory.
+    uint64_t numReclaims{0};
+    /// Bytes freed by the reclaimers.
+    int64_t reclaimedBytes{0};
+    /// Capacity taken back from the trackers by lowering their caps.
+    int64_t shrunkBytes{0};
+
+    std::string toString() const;
+  };
+
+  explicit MemoryArbitrator(const Config& config);
+
+  /// Adds 'tracker' with 'priority', sets its cap and makes it grow the cap
+  /// through 'this'. The trackers with a lower 'priority' are reclaimed
+  /// first. 'tracker' must not have a grow callback and must be removed
+  /// with removeTracker() before 'this' is destroyed.
+  void addTracker(
+      const std::shared_ptr<MemoryUsageTracker>& tracker,
+      int32_t priority = 0);
+
+  /// Removes 'tracker' and returns its capacity to the free capacity.
+  void removeTracker(MemoryUsageTracker* tracker);
+
+  /// Lowers the cap of 'tracker' to its current usage. Returns the
+  /// capacity freed.
+  int64_t shrink(MemoryUsageTracker* tracker);
+
+  int64_t capacity() const {
+    return config_.capacity;
+  }
+
+  /// Returns the capacity that is not given to any tracker.
+  int64_t freeCapacity() const;
+
+  Stats stats() const;
+
+ private:
+  struct Entry {
+    std::weak_ptr<MemoryUsageTracker> tracker;
+    int32_t priority;
+    // The cap of 'tracker'.
+    int64_t capacity;
+  };
+
+  // The GrowCallback of the trackers.
+  bool grow(MemoryUsageTracker& tracker);
+
+  // Revokes memory from the trackers other than 'requestor' until the free
+  // capacity is at least 'bytes'. Returns true if succeeded.
+  bool reclaim(MemoryUsageTracker* requestor, int32_t priority, int64_t bytes);
+
+  // Sets the cap of the tracker of 'entry' to 'capacity' and updates the
+  // free capacity.
+  void setCapacityLocked(
+      Entry& entry,
+      MemoryUsageTracker& tracker,
+      int64_t capacity);
+
+  // Lowers the cap of the tracker of 'entry' to its usage. Returns the
+  // capacity freed.
+  int64_t shrinkLocked(Entry& entry);
+
+  const Config config_;
+  mutable std::mutex mutex_;
+  std::unordered_map<const MemoryUsageTracker*, Entry> entries_;
+  int64_t freeCapacity_;
+  // True while a grow reclaims memory from the other trackers.
+  bool reclaiming_{false};
+  Stats stats_;
+};
+
+} // namespace facebook::velox::memory
@@ -20,7 +20,13 @@ namespace facebook {
 namespace velox {
 namespace memory {
 void MemoryUsage::incrementCurrentBytes(int64_t size) {
-  setCurrentBytes(currentBytes_.load(std::memory_order_relaxed) + size);
+  const auto newBytes =
+      currentBytes_.fetch_add(size, std::memory_order_relaxed) + size;
+  auto previousMaxBytes = maxBytes_.load(std::memory_order_relaxed);
+  while (newBytes > previousMaxBytes &&
+         !maxBytes_.compare_exchange_weak(
+             previousMaxBytes, newBytes, std::memory_order_relaxed)) {
+  }
 }
 
 void MemoryUsage::setCurrentBytes(int64_t size) {
@@ -24,10 +24,11 @@
 namespace facebook {
 namespace velox {
 namespace memory {
-// Memory tracking methods. All methods are single threaded. Aggregate nodes
-// will have their stats updated by a global aggregation thread. This also means
-// that aggregate nodes should not allocate memory and should do so by creating
-// children nodes.
+// Memory tracking methods. incrementCurrentBytes() may be called from
+// multiple threads, e.g. by writers encoding columns in parallel from one
+// pool. Aggregate nodes will have their stats updated by a global aggregation
+// thread. This also means that aggregate nodes should not allocate memory and
+// should do so by creating children nodes.
 struct MemoryUsage {
  public:
   int64_t getCurrentBytes() const;
@@ -35,8 +35,13 @@ std::shared_ptr<MemoryUsageTracker> MemoryUsageTracker::create(
 
 void MemoryUsageTracker::update(int64_t size, bool /* mock */) {
   if (size > 0) {
-    int64_t increment = 0;
     ++usage(numAllocs_, UsageType::kTotalMem);
+  }
+  if (tryUpdateLocal(size)) {
+    return;
+  }
+  if (size > 0) {
+    int64_t increment = 0;
     {
       std::lock_guard<std::mutex> l(mutex_);
       if (usedReservation_ + size > reservation_) {
@@ -64,6 +69,33 @@ void MemoryUsageTracker::update(int64_t size, bool /* mock */) {
   }
 }
 
+bool MemoryUsageTracker::tryUpdateLocal(int64_t size) {
+  auto used = usedReservation_.load();
+  for (;;) {
+    const auto newUsed = used + size;
+    if (size > 0) {
+      if (newUsed > reservation_) {
+        return false;
+      }
+    } else if (
+        quantizedSize(std::max(minReservation_.load(), newUsed)) !=
+        reservation_) {
+      // The reservation shrinks, which must be serialized on 'mutex_'.
+      return false;
+    }
+    if (usedReservation_.compare_exchange_weak(used, newUsed)) {
+      break;
+    }
+  }
+  if (size > 0 && used + size > reservation_) {
+    // A concurrent free under 'mutex_' shrank the reservation after it was
+    // read above. Undo and let the caller reserve under 'mutex_'.
+    usedReservation_.fetch_sub(size);
+    return false;
+  }
+  return true;
+}
+
 void MemoryUsageTracker::reserve(int64_t size) {
   int64_t increment;
   {
@@ -221,6 +253,44 @@ void MemoryUsageTracker::checkNonNegativeSizes(
   }
 }
 
+uint64_t MemoryUsageTracker::addReclaimer(Reclaimer reclaimer) {
+  std::lock_guard<std::mutex> l(reclaimerMutex_);
+  const auto id = nextReclaimerId_++;
+  reclaimers_.emplace_back(id, std::move(reclaimer));
+  return id;
+}
+
+void MemoryUsageTracker::removeReclaimer(uint64_t id) {
+  std::lock_guard<std::mutex> l(reclaimerMutex_);
+  auto it = std::find_if(
+      reclaimers_.begin(), reclaimers_.end(), [&](const auto& reclaimer) {
+        return reclaimer.first == id;
+      });
+  VELOX_CHECK(it != reclaimers_.end(), "No reclaimer with id {}", id);
+  reclaimers_.erase(it);
+}
+
+int64_t MemoryUsageTracker::reclaim(int64_t targetBytes) {
+  // Copies the reclaimers so that they are called without holding
+  // 'reclaimerMutex_'. A reclaimer may be removed meanwhile, so the
+  // reclaimers must tolerate being called after their removal.
+  std::vector<Reclaimer> reclaimers;
+  {
+    std::lock_guard<std::mutex> l(reclaimerMutex_);
+    for (const auto& [id, reclaimer] : reclaimers_) {
+      reclaimers.push_back(reclaimer);
+    }
+  }
+  int64_t reclaimedBytes = 0;
+  for (const auto& reclaimer : reclaimers) {
+    if (reclaimedBytes >= targetBytes) {
+      break;
+    }
+    reclaimedBytes += reclaimer(targetBytes - reclaimedBytes);
+  }
+  return reclaimedBytes;
+}
+
 std::string MemoryUsageTracker::toString() const {
   std::stringstream out;
   out << "<tracker total " << (getCurrentTotalBytes() >> 20) << " available "
@@ -20,6 +20,7 @@
 #include <atomic>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
@@ -120,6 +121,12 @@ class MemoryUsageTracker
   using MakeMemoryCapExceededMessage =
       std::function<std::string(MemoryUsageTracker& tracker)>;
 
+  /// Frees at least 'targetBytes', if possible, of the memory counted in a
+  /// tracker, e.g. by spilling the operators of a Task. Returns the bytes
+  /// freed. Called by a MemoryArbitrator that revokes memory from the
+  /// tracker. Must not throw.
+  using Reclaimer = std::function<int64_t(int64_t targetBytes)>;
+
   // Create default usage tracker. It aggregates both 'user' and 'system' memory
   // from its children and tracks the allocations as 'user' memory. It returns a
   // 'root' tracker.
@@ -164,7 +171,9 @@ class MemoryUsageTracker
   // Increments outstanding memory by 'size', which is positive for
   // allocation and negative for free. If there is no reservation or
   // the new allocated amount exceeds the reservation, propagates the
-  // change upward.
+  // change upward. Changes that stay within the reservation and do not
+  // shrink it are made without taking 'mutex_' and without touching the
+  // parents.
   // Sometimes the memory pool wants to mock an update for quota
   // accounting purposes and different memory usage trackers can
   // choose to accommodate this differently.
@@ -245,6 +254,17 @@ class MemoryUsageTracker
     makeMemoryCapExceededMessage_ = func;
   }
 
+  /// Adds 'reclaimer' to the reclaimers called by reclaim(). Returns an id
+  /// for removeReclaimer().
+  uint64_t addReclaimer(Reclaimer reclaimer);
+
+  /// Removes the reclaimer added with id 'id'.
+  void removeReclaimer(uint64_t id);
+
+  /// Calls the reclaimers in the order they were added until at least
+  /// 'targetBytes' are freed. Returns the bytes freed.
+  int64_t reclaim(int64_t targetBytes);
+
   /// Checks if it is likely that the reservation on 'this' can be
   /// incremented by 'increment'. Returns false if this seems
   /// unlikely. Otherwise attempts the reservation increment and returns
@@ -326,6 +346,12 @@ class MemoryUsageTracker
     return usage(array, UsageType::kTotalMem);
   }
 
+  // Adds 'size' to 'usedReservation_' without locking if the result fits
+  // in 'reservation_' and would not change the quantized reservation.
+  // Returns false if the change needs the reservation to be updated under
+  // 'mutex_', in which case 'usedReservation_' is unchanged.
+  bool tryUpdateLocal(int64_t size);
+
   int64_t reserveLocked(int64_t size) {
     int64_t neededSize = size - (reservation_ - usedReservation_);
     if (neededSize > 0) {
@@ -393,6 +419,11 @@ class MemoryUsageTracker
   GrowCallback growCallback_{};
 
   MakeMemoryCapExceededMessage makeMemoryCapExceededMessage_{};
+
+  // Serializes the changes to 'reclaimers_' with reclaim().
+  std::mutex reclaimerMutex_;
+  std::vector<std::pair<uint64_t, Reclaimer>> reclaimers_;
+  uint64_t nextReclaimerId_{0};
 };
 
 // A temporary solution to MemoryUsageTracker accounting leak without properly
@@ -16,6 +16,7 @@
 
 #include "velox/common/memory/MmapAllocator.h"
 #include "velox/common/base/Portability.h"
+#include "velox/common/process/Numa.h"
 #include "velox/common/testutil/TestValue.h"
 
 #include <sys/mman.h>
@@ -23,6 +24,17 @@
 using facebook::velox::common::testutil::TestValue;
 
 namespace facebook::velox::memory {
+namespace {
+// Advises the 'bytes' at 'address' for transparent huge pages. Returns false
+// if the kernel does not support them.
+bool adviseHugePages(void* FOLLY_NONNULL address, size_t bytes) {
+#ifdef MADV_HUGEPAGE
+  return madvise(address, bytes, MADV_HUGEPAGE) == 0;
+#else
+  return false;
+#endif
+}
+} // namespace
 
 MmapAllocator::MmapAllocator(const MmapAllocatorOptions& options)
     : MappedMemory(),
@@ -31,18 +43,32 @@ MmapAllocator::MmapAllocator(const MmapAllocatorOptions& options)
       capacity_(bits::roundUp(
           options.capacity / kPageSize,
           64 * sizeClassSizes_.back())),
-      useMmapArena_(options.useMmapArena) {
-  for (int size : sizeClassSizes_) {
-    sizeClasses_.push_back(std::make_unique<SizeClass>(capacity_ / size, size));
+      numNumaNodes_(options.numaAware ? process::numNumaNodes() : 1),
+      useMmapArena_(options.useMmapArena),
+      useHugePages_(options.useHugePages),
+      threadCachePages_(options.threadCachePages),
+      threadCaches_([this]() { return new ThreadCache(this); }) {
+  VELOX_CHECK_GE(options.minHugePageSizeClass, 8);
+  // Each node can hold the whole capacity since the capacity is enforced on
+  // 'numAllocated_' and 'numMapped_' across all of them.
+  for (auto node = 0; node < numNumaNodes_; ++node) {
+    for (int size : sizeClassSizes_) {
+      sizeClasses_.push_back(std::make_unique<SizeClass>(
+          capacity_ / size,
+          size,
+          numNumaNodes_ > 1 ? node : process::kNoNumaNode,
+          useHugePages_ && size >= options.minHugePageSizeClass));
+    }
   }
 
   if (useMmapArena_) {
     auto arenaSizeBytes = bits::roundUp(
         capacity_ * kPageSize / options.mmapArenaCapacityRatio, kPageSize);
-    managedArenas_ = std::make_unique<ManagedMmapArenas>(
-        arenaSizeBytes < MmapArena::kMinCapacityBytes
-            ? MmapArena::kMinCapacityBytes
-            : arenaSizeBytes);
+    for (auto node = 0; node < numNumaNodes_; ++node) {
+      managedArenas_.push_back(std::make_unique<ManagedMmapArenas>(
+          std::max<uint64_t>(arenaSizeBytes, MmapArena::kMinCapacityBytes),
+          numNumaNodes_ > 1 ? node : process::kNoNumaNode));
+    }
   }
 }
 
@@ -52,13 +78,30 @@ bool MmapAllocator::allocate(
     Allocation& out,
     std::function<void(int64_t, bool)> userAllocCB,
     MachinePageCount minSizeClass) {
-  auto numFreed = freeInternal(out);
-  if (numFreed != 0) {
-    numAllocated_.fetch_sub(numFreed);
+  if (!freeToCache(out)) {
+    auto numFreed = freeInternal(out);
+    if (numFreed != 0) {
+      numAllocated_.fetch_sub(numFreed);
+    }
   }
   auto mix = allocationSize(numPages, minSizeClass);
+  if (allocateFromCache(mix, out)) {
+    if (userAllocCB != nullptr) {
+      try {
+        userAllocCB(mix.totalPages * kPageSize, true);
+      } catch (const std::exception& e) {
+        free(out);
+        std::rethrow_exception(std::current_exception());
+      }
+    }
+    return true;
+  }
   if (numAllocated_ + mix.totalPages > capacity_) {
-    return false;
+    // The pages in the thread caches count as allocated.
+    flushThreadCaches();
+    if (numAllocated_ + mix.totalPages > capacity_) {
+      return false;
+    }
   }
   if (numAllocated_.fetch_add(mix.totalPages) + mix.totalPages > capacity_) {
     numAllocated_.fetch_sub(mix.totalPages);
@@ -75,13 +118,15 @@ bool MmapAllocator::allocate(
     }
   }
   MachinePageCount newMapsNeeded = 0;
+  const auto firstSizeClass = currentNumaNode() * sizeClassSizes_.size();
   for (int i = 0; i < mix.numSizes; ++i) {
     bool success;
+    auto& sizeClass = sizeClasses_[firstSizeClass + mix.sizeIndices[i]];
     stats_.recordAllocate(
         sizeClassSizes_[mix.sizeIndices[i]] * kPageSize,
         mix.sizeCounts[i],
         [&]() {
-          success = sizeClasses_[mix.sizeIndices[i]]->allocate(
+          success = sizeClass->allocate(
               mix.sizeCounts[i], owner, newMapsNeeded, out);
         });
     if (TestValue::enabled()) {
@@ -143,6 +188,9 @@ bool MmapAllocator::ensureEnoughMappedPages(int32_t newMappedNeeded) {
 }
 
 int64_t MmapAllocator::free(Allocation& allocation) {
+  if (auto numCached = freeToCache(allocation)) {
+    return numCached * kPageSize;
+  }
   auto numFreed = freeInternal(allocation);
   numAllocated_.fetch_sub(numFreed);
   return numFreed * kPageSize;
@@ -153,6 +201,8 @@ MachinePageCount MmapAllocator::freeInternal(Allocation& allocation) {
     return 0;
   }
   MachinePageCount numFreed = 0;
+  const auto numaNode =
+      numNumaNodes_ > 1 ? currentNumaNode() : process::kNoNumaNode;
 
   for (auto i = 0; i < sizeClasses_.size(); ++i) {
     auto& sizeClass = sizeClasses_[i];
@@ -166,15 +216,111 @@ MachinePageCount MmapAllocator::freeInternal(Allocation& allocation) {
       // Increment the free time only if the allocation contained
       // pages in the class. Note that size class indices in the
       // allocator are not necessarily the same as in the stats.
-      auto sizeIndex = Stats::sizeIndex(sizeClassSizes_[i] * kPageSize);
+      auto sizeIndex = Stats::sizeIndex(sizeClass->unitSize() * kPageSize);
       stats_.sizes[sizeIndex].freeClocks += clocks;
     }
+    if (pages && sizeClass->numaNode() != numaNode) {
+      numCrossNodeFreedPages_ += pages;
+    }
     numFreed += pages;
   }
   allocation.clear();
   return numFreed;
 }
 
+MmapAllocator::ThreadCache::ThreadCache(MmapAllocator* allocator)
+    : allocator(allocator), pages(allocator->sizeClasses_.size()) {}
+
+MmapAllocator::ThreadCache::~ThreadCache() {
+  std::lock_guard<std::mutex> l(mutex);
+  allocator->flushCacheLocked(*this);
+}
+
+bool MmapAllocator::allocateFromCache(const SizeMix& mix, Allocation& out) {
+  if (threadCachePages_ == 0 || mix.totalPages > threadCachePages_) {
+    return false;
+  }
+  auto& cache = *threadCaches_;
+  std::lock_guard<std::mutex> l(cache.mutex);
+  const auto firstSizeClass = currentNumaNode() * sizeClassSizes_.size();
+  for (int i = 0; i < mix.numSizes; ++i) {
+    if (cache.pages[firstSizeClass + mix.sizeIndices[i]].size() <
+        mix.sizeCounts[i]) {
+      return false;
+    }
+  }
+  for (int i = 0; i < mix.numSizes; ++i) {
+    auto& pages = cache.pages[firstSizeClass + mix.sizeIndices[i]];
+    const auto unitSize = sizeClassSizes_[mix.sizeIndices[i]];
+    for (auto j = 0; j < mix.sizeCounts[i]; ++j) {
+      out.append(pages.back(), unitSize);
+      pages.pop_back();
+    }
+  }
+  cache.numPages -= mix.totalPages;
+  numCachedPages_ -= mix.totalPages;
+  ++numAllocations_;
+  numAllocatedPages_ += mix.totalPages;
+  return true;
+}
+
+MachinePageCount MmapAllocator::freeToCache(Allocation& allocation) {
+  const auto numPages = allocation.numPages();
+  if (threadCachePages_ == 0 || numPages == 0 ||
+      numPages > threadCachePages_) {
+    return 0;
+  }
+  auto& cache = *threadCaches_;
+  std::lock_guard<std::mutex> l(cache.mutex);
+  if (cache.numPages + numPages > threadCachePages_) {
+    flushCacheLocked(cache);
+  }
+  for (auto i = 0; i < allocation.numRuns(); ++i) {
+    auto run = allocation.runAt(i);
+    auto sizeClass = 0;
+    while (!sizeClasses_[sizeClass]->isInRange(run.data())) {
+      ++sizeClass;
+      VELOX_CHECK_LT(
+          sizeClass, sizeClasses_.size(), "Freeing a page not in a size class");
+    }
+    const auto unitSize = sizeClasses_[sizeClass]->unitSize();
+    for (auto page = 0; page < run.numPages(); page += unitSize) {
+      cache.pages[sizeClass].push_back(run.data() + page * kPageSize);
+    }
+  }
+  cache.numPages += numPages;
+  numCachedPages_ += numPages;
+  allocation.clear();
+  return numPages;
+}
+
+void MmapAllocator::flushCacheLocked(ThreadCache& cache) {
+  if (cache.numPages == 0) {
+    return;
+  }
+  Allocation allocation(this);
+  for (auto i = 0; i < cache.pages.size(); ++i) {
+    for (auto* page : cache.pages[i]) {
+      allocation.append(page, sizeClasses_[i]->unitSize());
+    }
+    cache.pages[i].clear();
+  }
+  const auto numFreed = freeInternal(allocation);
+  numAllocated_ -= numFreed;
+  numCachedPages_ -= numFreed;
+  cache.numPages = 0;
+}
+
+void MmapAllocator::flushThreadCaches() {
+  if (threadCachePages_ == 0 || numCachedPages_ == 0) {
+    return;
+  }
+  for (auto& cache : threadCaches_.accessAllThreads()) {
+    std::lock_guard<std::mutex> l(cache.mutex);
+    flushCacheLocked(cache);
+  }
+}
+
 bool MmapAllocator::allocateContiguousImpl(
     MachinePageCount numPages,
     MmapAllocator::Allocation* FOLLY_NULLABLE collateral,
@@ -197,6 +343,10 @@ bool MmapAllocator::allocateContiguousImpl(
   // that the operation succeeds if 'collateral' and 'allocation'
   // cover the new size, as other threads might grab the transiently
   // free pages.
+  if (numAllocated_ + numPages > capacity_) {
+    // The pages in the thread caches count as allocated.
+    flushThreadCaches();
+  }
   if (collateral) {
     numCollateralPages = freeInternal(*collateral);
   }
@@ -204,7 +354,7 @@ bool MmapAllocator::allocateContiguousImpl(
   if (numLargeCollateralPages) {
     if (useMmapArena_) {
       std::lock_guard<std::mutex> l(arenaMutex_);
-      managedArenas_->free(allocation.data(), allocation.size());
+      freeToArenas(allocation.data(), allocation.size());
     } else {
       if (munmap(allocation.data(), allocation.size()) < 0) {
         LOG(ERROR) << "munmap got " << errno << "for " << allocation.data()
@@ -282,7 +432,7 @@ bool MmapAllocator::allocateContiguousImpl(
   } else {
     if (useMmapArena_) {
       std::lock_guard<std::mutex> l(arenaMutex_);
-      data = managedArenas_->allocate(numPages * kPageSize);
+      data = managedArenas_[currentNumaNode()]->allocate(numPages * kPageSize);
     } else {
       data = mmap(
           nullptr,
@@ -291,6 +441,19 @@ bool MmapAllocator::allocateContiguousImpl(
           MAP_PRIVATE | MAP_ANONYMOUS,
           -1,
           0);
+      if (data == MAP_FAILED) {
+        data = nullptr;
+      } else {
+        if (numNumaNodes_ > 1) {
+          process::bindToNumaNode(
+              data, numPages * kPageSize, currentNumaNode());
+        }
+        if (useHugePages_ && numPages * kPageSize >= kHugePageSize) {
+          // The kernel backs the aligned huge pages in the range. Failure only
+          // costs TLB misses.
+          adviseHugePages(data, numPages * kPageSize);
+        }
+      }
     }
   }
   if (!data) {
@@ -304,11 +467,74 @@ bool MmapAllocator::allocateContiguousImpl(
   return true;
 }
 
+bool MmapAllocator::growContiguous(
+    MachinePageCount increment,
+    ContiguousAllocation& allocation,
+    std::function<void(int64_t, bool)> userAllocCB) {
+  VELOX_CHECK_GT(allocation.numPages(), 0);
+#ifdef __linux__
+  if (useMmapArena_) {
+    // The ranges of an arena cannot be remapped.
+    return false;
+  }
+  if (numAllocated_ + increment > capacity_) {
+    flushThreadCaches();
+  }
+  if (userAllocCB) {
+    userAllocCB(increment * kPageSize, true);
+  }
+  auto rollback = [&](bool unmap) {
+    numAllocated_ -= increment;
+    if (unmap) {
+      numMapped_ -= increment;
+    }
+    if (userAllocCB) {
+      try {
+        userAllocCB(increment * kPageSize, false);
+      } catch (const std::exception& e) {
+        // Ignore exception, this is run on failure return path.
+      }
+    }
+  };
+  if (numAllocated_.fetch_add(increment) + increment > capacity_) {
+    rollback(false);
+    return false;
+  }
+  if (!ensureEnoughMappedPages(increment)) {
+    rollback(false);
+    return false;
+  }
+  const auto newSize = allocation.size() + increment * kPageSize;
+  void* data =
+      mremap(allocation.data(), allocation.size(), newSize, MREMAP_MAYMOVE);
+  if (data == MAP_FAILED) {
+    LOG(WARNING) << "mremap got " << errno << " for " << allocation.data()
+                 << ", " << allocation.size() << " to " << newSize;
+    rollback(true);
+    return false;
+  }
+  if (numNumaNodes_ > 1) {
+    process::bindToNumaNode(
+        reinterpret_cast<char*>(data) + allocation.size(),
+        increment * kPageSize,
+        currentNumaNode());
+  }
+  if (useHugePages_ && newSize >= kHugePageSize) {
+    adviseHugePages(data, newSize);
+  }
+  numExternalMapped_ += increment;
+  allocation.reset(this, data, newSize);
+  return true;
+#else
+  return false;
+#endif
+}
+
 void MmapAllocator::freeContiguousImpl(ContiguousAllocation& allocation) {
   if (allocation.data() && allocation.size()) {
     if (useMmapArena_) {
       std::lock_guard<std::mutex> l(arenaMutex_);
-      managedArenas_->free(allocation.data(), allocation.size());
+      freeToArenas(allocation.data(), allocation.size());
     } else {
       if (munmap(allocation.data(), allocation.size()) < 0) {
         LOG(ERROR) << "munmap returned " << errno << "for " << allocation.data()
@@ -328,8 +554,42 @@ void MmapAllocator::markAllMapped(const Allocation& allocation) {
   }
 }
 
+int32_t MmapAllocator::currentNumaNode() const {
+  return numNumaNodes_ > 1 ? process::currentNumaNode() : 0;
+}
+
+void MmapAllocator::freeToArenas(void* address, uint64_t bytes) {
+  if (managedArenas_.size() == 1) {
+    managedArenas_[0]->free(address, bytes);
+    return;
+  }
+  for (auto& arenas : managedArenas_) {
+    if (arenas->contains(address)) {
+      if (arenas->numaNode() != currentNumaNode()) {
+        numCrossNodeFreedPages_ += bytes / kPageSize;
+      }
+      arenas->free(address, bytes);
+      return;
+    }
+  }
+  VELOX_FAIL("Freeing an address that is not in the MmapArenas");
+}
+
 MachinePageCount MmapAllocator::adviseAway(MachinePageCount target) {
   int numAway = 0;
+  if (useHugePages_) {
+    // Advises away whole free huge pages first so that the huge pages with
+    // some free class pages stay intact.
+    uint64_t numHugePages = 0;
+    for (int i = sizeClasses_.size() - 1; i >= 0 && numAway < target; --i) {
+      numAway +=
+          sizeClasses_[i]->adviseAwayHugePages(target - numAway, numHugePages);
+    }
+    numAdvisedHugePages_ += numHugePages;
+    if (numAway >= target) {
+      return numAway;
+    }
+  }
   for (int i = sizeClasses_.size() - 1; i >= 0; --i) {
     numAway += sizeClasses_[i]->adviseAway(target - numAway, this);
     if (numAway >= target) {
@@ -339,9 +599,14 @@ MachinePageCount MmapAllocator::adviseAway(MachinePageCount target) {
   return numAway;
 }
 
-MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
+MmapAllocator::SizeClass::SizeClass(
+    size_t capacity,
+    MachinePageCount unitSize,
+    int32_t numaNode,
+    bool useHugePages)
     : capacity_(capacity),
       unitSize_(unitSize),
+      numaNode_(numaNode),
       byteSize_(capacity_ * unitSize_ * kPageSize),
       // Min 8 words + 1 bit for every 512 bits in 'pageAllocated_'.
       mappedFreeLookup_((capacity_ / kPagesPerLookupBit / 64) + kSimdTail),
@@ -350,9 +615,13 @@ MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
       pageMapped_(pageBitmapSize_ + kSimdTail) {
   VELOX_CHECK(
       capacity_ % 64 == 0, "Sizeclass must have a multiple of 64 capacity.");
+  // The range is a multiple of huge pages since the capacity is a multiple of
+  // 64 pages of at least 8 machine pages. Maps an extra huge page to align
+  // the start.
+  const size_t mapSize = byteSize_ + (useHugePages ? kHugePageSize : 0);
   void* ptr = mmap(
       nullptr,
-      capacity_ * unitSize_ * kPageSize,
+      mapSize,
       PROT_READ | PROT_WRITE,
       MAP_PRIVATE | MAP_ANONYMOUS,
       -1,
@@ -365,6 +634,30 @@ MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
         errno);
   }
   address_ = reinterpret_cast<uint8_t*>(ptr);
+  if (useHugePages) {
+    auto* aligned = reinterpret_cast<uint8_t*>(
+        bits::roundUp(reinterpret_cast<uint64_t>(ptr), kHugePageSize));
+    if (aligned > address_) {
+      munmap(address_, aligned - address_);
+    }
+    auto* end = reinterpret_cast<uint8_t*>(ptr) + mapSize;
+    if (end > aligned + byteSize_) {
+      munmap(aligned + byteSize_, end - (aligned + byteSize_));
+    }
+    address_ = aligned;
+    if (adviseHugePages(address_, byteSize_)) {
+      useHugePages_ = true;
+      pagesPerHugePage_ = kHugePageSize / (unitSize_ * kPageSize);
+    } else {
+      LOG(WARNING) << "Could not use huge pages for size class " << unitSize_
+                   << ": " << errno;
+    }
+  }
+  if (numaNode_ != process::kNoNumaNode &&
+      !process::bindToNumaNode(address_, byteSize_, numaNode_)) {
+    LOG(WARNING) << "Could not place size class " << unitSize_
+                 << " on NUMA node " << numaNode_ << ": " << errno;
+  }
 }
 
 MmapAllocator::SizeClass::~SizeClass() {
@@ -617,6 +910,67 @@ MachinePageCount MmapAllocator::SizeClass::adviseAway(
   return unitSize_ * target;
 }
 
+MachinePageCount MmapAllocator::SizeClass::adviseAwayHugePages(
+    MachinePageCount numPages,
+    uint64_t& numHugePages) {
+  if (!useHugePages_) {
+    return 0;
+  }
+  constexpr int32_t kWordsPerLookupBit = kPagesPerLookupBit / 64;
+  const uint64_t hugePageMask =
+      pagesPerHugePage_ == 64 ? kAllSet : bits::lowMask(pagesPerHugePage_);
+  MachinePageCount numAway = 0;
+  // The free class pages are not reserved by an allocation, so they are
+  // advised away inside 'mutex_'.
+  std::lock_guard<std::mutex> l(mutex_);
+  if (!numMappedFreePages_) {
+    return 0;
+  }
+  for (auto i = 0; i < pageBitmapSize_ && numAway < numPages; ++i) {
+    if (!(pageMapped_[i] & ~pageAllocated_[i])) {
+      continue;
+    }
+    bool anyAdvised = false;
+    for (auto bit = 0; bit < 64 && numAway < numPages;
+         bit += pagesPerHugePage_) {
+      const auto mask = hugePageMask << bit;
+      if ((pageAllocated_[i] & mask) || !(pageMapped_[i] & mask)) {
+        continue;
+      }
+      auto* address = address_ + (i * 64 + bit) * unitSize_ * kPageSize;
+      if (madvise(address, kHugePageSize, MADV_DONTNEED) < 0) {
+        LOG(WARNING) << "madvise got errno " << errno;
+        continue;
+      }
+      const auto numAdvised = __builtin_popcountll(pageMapped_[i] & mask);
+      pageMapped_[i] &= ~mask;
+      numMappedFreePages_ -= numAdvised;
+      numAdvisedAway_ += numAdvised;
+      numAway += numAdvised * unitSize_;
+      ++numHugePages;
+      anyAdvised = true;
+    }
+    if (!anyAdvised) {
+      continue;
+    }
+    // Clears the lookup bit if no mapped free page is left in its words.
+    const auto firstWord = i - i % kWordsPerLookupBit;
+    const auto endWord =
+        std::min<int32_t>(pageBitmapSize_, firstWord + kWordsPerLookupBit);
+    bool anyMappedFree = false;
+    for (auto j = firstWord; j < endWord; ++j) {
+      if (pageMapped_[j] & ~pageAllocated_[j]) {
+        anyMappedFree = true;
+        break;
+      }
+    }
+    if (!anyMappedFree) {
+      bits::setBit(mappedFreeLookup_.data(), i / kWordsPerLookupBit, false);
+    }
+  }
+  return numAway;
+}
+
 bool MmapAllocator::SizeClass::isInRange(uint8_t* ptr) const {
   if (ptr >= address_ && ptr < address_ + byteSize_) {
     // See that ptr falls on a page boundary.
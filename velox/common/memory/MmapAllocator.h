@@ -24,6 +24,8 @@
 #include <mutex>
 #include <unordered_set>
 
+#include <folly/ThreadLocal.h>
+
 #include "velox/common/base/SimdUtil.h"
 #include "velox/common/memory/MappedMemory.h"
 #include "velox/common/memory/MmapArena.h"
@@ -46,6 +48,26 @@ struct MmapAllocatorOptions {
   // Used to determine MmapArena capacity. The ratio represents system memory
   // capacity to single MmapArena capacity ratio.
   int32_t mmapArenaCapacityRatio = 10;
+
+  // If set true and the machine has more than one NUMA node, each node gets
+  // its own set of size classes whose memory is placed on the node. An
+  // allocation is served from the size classes of the node of the calling
+  // thread.
+  bool numaAware = false;
+
+  // If set true, the size classes of at least 'minHugePageSizeClass' machine
+  // pages and the contiguous allocations of at least a huge page are advised
+  // for transparent huge pages. When memory needs to be returned, whole
+  // free huge pages are advised away before splitting any.
+  bool useHugePages = false;
+
+  // The smallest size class backed by huge pages. At least 8 pages, so that a
+  // huge page has at most 64 pages of the size class.
+  MachinePageCount minHugePageSizeClass = 64;
+
+  // Maximum number of machine pages that a thread keeps in its cache of
+  // freed size class pages for its next allocations. 0 disables the caches.
+  MachinePageCount threadCachePages = 0;
 };
 
 // Implementation of MappedMemory with mmap and madvise. Each size
@@ -93,6 +115,11 @@ class MmapAllocator : public MappedMemory {
         allocation.size(), [&]() { freeContiguousImpl(allocation); });
   }
 
+  bool growContiguous(
+      MachinePageCount increment,
+      ContiguousAllocation& allocation,
+      std::function<void(int64_t, bool)> userAllocCB = nullptr) override;
+
   // Checks internal consistency of allocation data
   // structures. Returns true if OK. May return false if there are
   // concurrent alocations and frees during the consistency check. This
@@ -107,7 +134,7 @@ class MmapAllocator : public MappedMemory {
   }
 
   MachinePageCount numAllocated() const override {
-    return numAllocated_;
+    return numAllocated_ - numCachedPages_;
   }
 
   MachinePageCount numMapped() const override {
@@ -129,17 +156,43 @@ class MmapAllocator : public MappedMemory {
   Stats stats() const override {
     auto stats = stats_;
     stats.numAdvise = numAdvisedPages_;
+    stats.numCrossNodeFreedPages = numCrossNodeFreedPages_;
+    stats.numAdvisedHugePages = numAdvisedHugePages_;
     return stats;
   }
 
+  // Returns the number of NUMA nodes with their own size classes. 1 if not
+  // NUMA aware.
+  int32_t numNumaNodes() const {
+    return numNumaNodes_;
+  }
+
+  // Returns the number of machine pages in the caches of the threads.
+  MachinePageCount numCachedPages() const {
+    return numCachedPages_;
+  }
+
+  // Returns the pages in the caches of all threads to their size classes.
+  void flushThreadCaches();
+
  private:
   static constexpr uint64_t kAllSet = 0xffffffffffffffff;
 
+  // Size of a transparent huge page on x86_64 and most aarch64 kernels.
+  static constexpr uint64_t kHugePageSize = 2 << 20;
+
   // Represents a range of virtual addresses used for allocating entries of
   // 'unitSize_' machine pages.
   class SizeClass {
    public:
-    SizeClass(size_t capacity, MachinePageCount unitSize);
+    // Places the memory on 'numaNode' unless this is process::kNoNumaNode.
+    // Aligns the memory to huge pages and advises it for transparent huge
+    // pages if 'useHugePages' is true.
+    SizeClass(
+        size_t capacity,
+        MachinePageCount unitSize,
+        int32_t numaNode,
+        bool useHugePages);
 
     ~SizeClass();
 
@@ -147,6 +200,14 @@ class MmapAllocator : public MappedMemory {
       return unitSize_;
     }
 
+    int32_t numaNode() const {
+      return numaNode_;
+    }
+
+    bool useHugePages() const {
+      return useHugePages_;
+    }
+
     // Allocates 'numPages' from 'this' and appends these to
     // *out. '*numUnmapped' is incremented by the number of pages that
     // are not backed by memory.
@@ -172,6 +233,14 @@ class MmapAllocator : public MappedMemory {
         MachinePageCount numPages,
         MmapAllocator* FOLLY_NONNULL allocator);
 
+    // Advises away huge pages whose class pages are all free until at least
+    // 'numPages' machine pages are advised away. Returns the number of machine
+    // pages advised away and increments 'numHugePages' by the number of huge
+    // pages. Advises away nothing if 'this' does not use huge pages.
+    MachinePageCount adviseAwayHugePages(
+        MachinePageCount numPages,
+        uint64_t& numHugePages);
+
     // Sets the mapped bits for the runs in 'allocation' to 'value' for the
     // addresses that fall in the range of 'this'
     void setAllMapped(const Allocation& allocation, bool value);
@@ -252,6 +321,14 @@ class MmapAllocator : public MappedMemory {
     // Size of one size class page in machine pages.
     const MachinePageCount unitSize_;
 
+    const int32_t numaNode_;
+
+    // True if the address range is aligned to and advised for huge pages.
+    bool useHugePages_{false};
+
+    // Number of size class pages in a huge page if 'useHugePages_'.
+    int32_t pagesPerHugePage_{0};
+
     // Start of address range.
     uint8_t* FOLLY_NONNULL address_;
 
@@ -296,6 +373,41 @@ class MmapAllocator : public MappedMemory {
     uint64_t numAdvisedAway_ = 0;
   };
 
+  // Free class pages that a thread keeps for its next allocations. The pages
+  // stay allocated in their size classes and in 'numAllocated_' and are
+  // counted in 'numCachedPages_'.
+  struct ThreadCache {
+    explicit ThreadCache(MmapAllocator* FOLLY_NONNULL allocator);
+
+    // Returns the pages to the size classes.
+    ~ThreadCache();
+
+    MmapAllocator* FOLLY_NONNULL const allocator;
+
+    // Taken by the thread of 'this' and by flushThreadCaches().
+    std::mutex mutex;
+
+    // The addresses of the cached class pages of each size class in
+    // 'sizeClasses_'.
+    std::vector<std::vector<uint8_t*>> pages;
+
+    // Number of machine pages in 'pages'.
+    MachinePageCount numPages{0};
+  };
+
+  // Moves the class pages of 'mix' from the cache of the calling thread to
+  // 'out' if the cache has all of them. Returns false otherwise.
+  bool allocateFromCache(const SizeMix& mix, Allocation& out);
+
+  // Moves the pages of 'allocation' to the cache of the calling thread,
+  // flushing the cache first if they do not fit. Returns the number of
+  // cached machine pages, 0 if 'allocation' is larger than the cache.
+  MachinePageCount freeToCache(Allocation& allocation);
+
+  // Returns the pages of 'cache' to their size classes. Must be called inside
+  // the mutex of 'cache'.
+  void flushCacheLocked(ThreadCache& cache);
+
   bool allocateContiguousImpl(
       MachinePageCount numPages,
       Allocation* FOLLY_NULLABLE collateral,
@@ -319,6 +431,14 @@ class MmapAllocator : public MappedMemory {
 
   void markAllMapped(const Allocation& allocation);
 
+  // Returns the NUMA node of the calling thread if 'this' is NUMA aware,
+  // otherwise 0.
+  int32_t currentNumaNode() const;
+
+  // Frees the contiguous allocation of 'bytes' at 'address' into the managed
+  // arenas that contain it. Must be called inside 'arenaMutex_'.
+  void freeToArenas(void* FOLLY_NONNULL address, uint64_t bytes);
+
   // Finds at least  'target' unallocated pages in different size classes and
   // advises them away. Returns the number of pages advised away.
   MachinePageCount adviseAway(MachinePageCount target);
@@ -344,25 +464,46 @@ class MmapAllocator : public MappedMemory {
   std::atomic<MachinePageCount> numExternalMapped_{0};
   MachinePageCount capacity_ = 0;
 
+  // The size classes of each NUMA node one after the other, i.e. the size
+  // class i of node n is at n * sizeClassSizes_.size() + i.
   std::vector<std::unique_ptr<SizeClass>> sizeClasses_;
 
+  const int32_t numNumaNodes_;
+
   // Statistics.
   std::atomic<uint64_t> numAllocations_ = 0;
   std::atomic<uint64_t> numAllocatedPages_ = 0;
   std::atomic<uint64_t> numAdvisedPages_ = 0;
+  // Pages freed by a thread on another NUMA node than the one of the pages.
+  std::atomic<uint64_t> numCrossNodeFreedPages_ = 0;
+  // Huge pages advised away whole.
+  std::atomic<uint64_t> numAdvisedHugePages_ = 0;
 
   // Allocations that are larger than largest size classes will be delegated to
   // ManagedMmapArenas, to avoid calling mmap on every allocation.
+  // There is one ManagedMmapArenas per NUMA node.
   std::mutex arenaMutex_;
-  std::unique_ptr<ManagedMmapArenas> managedArenas_;
+  std::vector<std::unique_ptr<ManagedMmapArenas>> managedArenas_;
 
   // If set true, allocations larger than largest size class size will be
   // delegated to ManagedMmapArena. Otherwise a system mmap call will be
   // issued for each such allocation.
   bool useMmapArena_;
 
+  // See MmapAllocatorOptions::useHugePages.
+  const bool useHugePages_;
+
+  // See MmapAllocatorOptions::threadCachePages.
+  const MachinePageCount threadCachePages_;
+
+  std::atomic<MachinePageCount> numCachedPages_{0};
+
   Failure injectedFailure_{Failure::kNone};
   Stats stats_;
+
+  // Declared last so that the caches are flushed before the size classes are
+  // destroyed.
+  folly::ThreadLocal<ThreadCache> threadCaches_;
 };
 
 } // namespace facebook::velox::memory
@@ -24,7 +24,8 @@ uint64_t MmapArena::roundBytes(uint64_t bytes) {
   return bits::nextPowerOfTwo(bytes);
 }
 
-MmapArena::MmapArena(size_t capacityBytes) : byteSize_(capacityBytes) {
+MmapArena::MmapArena(size_t capacityBytes, int32_t numaNode)
+    : byteSize_(capacityBytes) {
   VELOX_CHECK(
       byteSize_ % kMinGrainSizeBytes == 0,
       "Arena must have a multiple of ",
@@ -44,6 +45,11 @@ MmapArena::MmapArena(size_t capacityBytes) : byteSize_(capacityBytes) {
         errno);
   }
   address_ = reinterpret_cast<uint8_t*>(ptr);
+  if (numaNode != process::kNoNumaNode &&
+      !process::bindToNumaNode(address_, byteSize_, numaNode)) {
+    LOG(WARNING) << "Could not place MmapArena on NUMA node " << numaNode
+                 << ": " << errno;
+  }
   addFreeBlock(reinterpret_cast<uint64_t>(address_), byteSize_);
   freeBytes_ = byteSize_;
 }
@@ -264,9 +270,11 @@ bool MmapArena::checkConsistency() const {
   return numErrors == 0;
 }
 
-ManagedMmapArenas::ManagedMmapArenas(uint64_t singleArenaCapacity)
-    : singleArenaCapacity_(singleArenaCapacity) {
-  auto arena = std::make_shared<MmapArena>(singleArenaCapacity);
+ManagedMmapArenas::ManagedMmapArenas(
+    uint64_t singleArenaCapacity,
+    int32_t numaNode)
+    : singleArenaCapacity_(singleArenaCapacity), numaNode_(numaNode) {
+  auto arena = std::make_shared<MmapArena>(singleArenaCapacity, numaNode_);
   arenas_.emplace(reinterpret_cast<uint64_t>(arena->address()), arena);
   currentArena_ = arena;
 }
@@ -280,7 +288,7 @@ void* FOLLY_NULLABLE ManagedMmapArenas::allocate(uint64_t bytes) {
   // If first allocation fails we create a new MmapArena for another attempt. If
   // it ever fails again then it means requested bytes is larger than a single
   // MmapArena's capacity. No further attempts will happen.
-  auto newArena = std::make_shared<MmapArena>(singleArenaCapacity_);
+  auto newArena = std::make_shared<MmapArena>(singleArenaCapacity_, numaNode_);
   arenas_.emplace(reinterpret_cast<uint64_t>(newArena->address()), newArena);
   currentArena_ = newArena;
   return currentArena_->allocate(bytes);
@@ -306,4 +314,14 @@ void ManagedMmapArenas::free(void* FOLLY_NONNULL address, uint64_t bytes) {
   }
 }
 
+bool ManagedMmapArenas::contains(const void* FOLLY_NONNULL address) const {
+  const auto addressUint64 = reinterpret_cast<uint64_t>(address);
+  auto iter = arenas_.upper_bound(addressUint64);
+  if (iter == arenas_.begin()) {
+    return false;
+  }
+  --iter;
+  return addressUint64 < iter->first + iter->second->byteSize();
+}
+
 } // namespace facebook::velox::memory
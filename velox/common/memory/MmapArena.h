@@ -22,6 +22,7 @@
 #include <memory>
 #include <unordered_set>
 #include "velox/common/memory/MappedMemory.h"
+#include "velox/common/process/Numa.h"
 
 namespace facebook::velox::memory {
 
@@ -35,7 +36,10 @@ class MmapArena {
   // MmapArena capacity should be multiple of kMinGrainSizeBytes.
   static constexpr uint64_t kMinGrainSizeBytes = 1024 * 1024; // 1M
 
-  MmapArena(size_t capacityBytes);
+  // Places the memory on 'numaNode' unless this is process::kNoNumaNode.
+  MmapArena(
+      size_t capacityBytes,
+      int32_t numaNode = process::kNoNumaNode);
   ~MmapArena();
 
   void* FOLLY_NULLABLE allocate(uint64_t bytes);
@@ -119,12 +123,23 @@ class MmapArena {
 /// fragmentation happens.
 class ManagedMmapArenas {
  public:
-  ManagedMmapArenas(uint64_t singleArenaCapacity);
+  /// Places the memory of the arenas on 'numaNode' unless this is
+  /// process::kNoNumaNode.
+  ManagedMmapArenas(
+      uint64_t singleArenaCapacity,
+      int32_t numaNode = process::kNoNumaNode);
 
   void* FOLLY_NULLABLE allocate(uint64_t bytes);
 
   void free(void* FOLLY_NONNULL address, uint64_t bytes);
 
+  /// True if 'address' is in one of the arenas of 'this'.
+  bool contains(const void* FOLLY_NONNULL address) const;
+
+  int32_t numaNode() const {
+    return numaNode_;
+  }
+
   const std::map<uint64_t, std::shared_ptr<MmapArena>>& arenas() const {
     return arenas_;
   }
@@ -139,6 +154,8 @@ class ManagedMmapArenas {
 
   /// Capacity in bytes for a single MmapArena managed by this.
   const uint64_t singleArenaCapacity_;
+
+  const int32_t numaNode_;
 };
 
 } // namespace facebook::velox::memory
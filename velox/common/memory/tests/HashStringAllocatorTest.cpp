@@ -108,6 +108,24 @@ TEST_F(HashStringAllocatorTest, allocate) {
   EXPECT_LE(instance_->retainedSize() - instance_->freeSpace(), 200);
 }
 
+TEST_F(HashStringAllocatorTest, sizeSegregatedFreeLists) {
+  // Frees a small and a large block with allocated blocks in between, so
+  // that they are not coalesced.
+  std::vector<HashStringAllocator::Header*> headers;
+  for (auto size : {100, 20, 5'000, 20}) {
+    headers.push_back(allocate(size));
+  }
+  instance_->free(headers[0]);
+  instance_->free(headers[2]);
+  instance_->checkConsistency();
+
+  // An allocation takes a free block of about its size instead of splitting
+  // a larger one.
+  EXPECT_EQ(headers[0], allocate(90));
+  EXPECT_EQ(headers[2], allocate(3'000));
+  instance_->checkConsistency();
+}
+
 TEST_F(HashStringAllocatorTest, multipart) {
   constexpr int32_t kNumSamples = 10'000;
   std::vector<Multipart> data(kNumSamples);
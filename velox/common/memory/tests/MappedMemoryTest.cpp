@@ -18,6 +18,7 @@
 #include "velox/common/memory/AllocationPool.h"
 #include "velox/common/memory/MmapAllocator.h"
 #include "velox/common/memory/MmapArena.h"
+#include "velox/common/process/Numa.h"
 #include "velox/common/testutil/TestValue.h"
 
 #include <thread>
@@ -779,6 +780,35 @@ TEST_P(MappedMemoryTest, contiguousScopedMappedMemoryAllocationFailure) {
   }
 }
 
+TEST_P(MappedMemoryTest, growContiguous) {
+  constexpr MachinePageCount kInitialPages = 16;
+  constexpr MachinePageCount kIncrement = 48;
+  const auto numAllocated = instance_->numAllocated();
+  MappedMemory::ContiguousAllocation allocation;
+  ASSERT_TRUE(
+      instance_->allocateContiguous(kInitialPages, nullptr, allocation));
+  auto* data = allocation.data<uint64_t>();
+  const auto numWords = allocation.size() / sizeof(uint64_t);
+  for (auto i = 0; i < numWords; ++i) {
+    data[i] = i;
+  }
+  ASSERT_TRUE(instance_->growContiguous(kIncrement, allocation));
+  EXPECT_EQ(kInitialPages + kIncrement, allocation.numPages());
+  EXPECT_EQ(
+      numAllocated + kInitialPages + kIncrement, instance_->numAllocated());
+  data = allocation.data<uint64_t>();
+  for (auto i = 0; i < numWords; ++i) {
+    ASSERT_EQ(i, data[i]);
+  }
+  // The added pages are zero filled.
+  for (auto i = numWords; i < allocation.size() / sizeof(uint64_t); ++i) {
+    ASSERT_EQ(0, data[i]);
+  }
+  EXPECT_TRUE(instance_->checkConsistency());
+  instance_->freeContiguous(allocation);
+  EXPECT_EQ(numAllocated, instance_->numAllocated());
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     MappedMemoryTests,
     MappedMemoryTest,
@@ -920,4 +950,130 @@ TEST_F(MmapArenaTest, managedMmapArenas) {
     EXPECT_EQ(managedArenas->arenas().size(), 2);
   }
 }
+
+TEST_F(MmapArenaTest, contains) {
+  ManagedMmapArenas managedArenas(kArenaCapacityBytes);
+  auto* data = reinterpret_cast<char*>(managedArenas.allocate(4096));
+  EXPECT_TRUE(managedArenas.contains(data));
+  EXPECT_TRUE(managedArenas.contains(data + 4095));
+  const auto& arena = managedArenas.arenas().begin()->second;
+  auto* arenaEnd =
+      reinterpret_cast<char*>(arena->address()) + kArenaCapacityBytes;
+  EXPECT_FALSE(managedArenas.contains(arenaEnd));
+  int32_t onStack;
+  EXPECT_FALSE(managedArenas.contains(&onStack));
+  managedArenas.free(data, 4096);
+}
+
+TEST(MmapAllocatorNumaTest, numaAware) {
+  MmapAllocatorOptions options;
+  options.capacity = kMaxMappedMemory;
+  options.useMmapArena = true;
+  options.numaAware = true;
+  MmapAllocator allocator(options);
+  const auto numNodes = process::numNumaNodes();
+  EXPECT_EQ(numNodes, allocator.numNumaNodes());
+
+  // Allocates on each node and frees on node 0. The pages of the other nodes
+  // are freed across nodes.
+  std::vector<MappedMemory::Allocation> allocations;
+  allocations.reserve(numNodes);
+  std::vector<MappedMemory::ContiguousAllocation> contiguous(numNodes);
+  for (auto node = 0; node < numNodes; ++node) {
+    std::thread([&]() {
+      process::ScopedNumaAffinity affinity(node);
+      allocations.emplace_back(&allocator);
+      ASSERT_TRUE(allocator.allocate(100, 0, allocations.back()));
+      ASSERT_TRUE(
+          allocator.allocateContiguous(1000, nullptr, contiguous[node]));
+    }).join();
+  }
+  EXPECT_TRUE(allocator.checkConsistency());
+  std::thread([&]() {
+    process::ScopedNumaAffinity affinity(0);
+    for (auto& allocation : allocations) {
+      allocator.free(allocation);
+    }
+    for (auto& allocation : contiguous) {
+      allocator.freeContiguous(allocation);
+    }
+  }).join();
+  EXPECT_EQ(0, allocator.numAllocated());
+  EXPECT_TRUE(allocator.checkConsistency());
+  if (numNodes == 1) {
+    EXPECT_EQ(0, allocator.stats().numCrossNodeFreedPages);
+  } else {
+    EXPECT_LE(
+        (numNodes - 1) * 1'100, allocator.stats().numCrossNodeFreedPages);
+  }
+}
+
+TEST(MmapAllocatorHugePageTest, adviseAwayWholeHugePages) {
+  MmapAllocatorOptions options;
+  options.capacity = kMaxMappedMemory;
+  options.useHugePages = true;
+  MmapAllocator allocator(options);
+  const auto capacity = allocator.capacity();
+
+  // Maps 16MB in the largest size class and frees it, then maps the whole
+  // capacity in one contiguous allocation. The 16MB are advised away as
+  // whole huge pages.
+  constexpr int32_t kNumPages = 16 << 20 >> 12;
+  MappedMemory::Allocation allocation(&allocator);
+  ASSERT_TRUE(allocator.allocate(kNumPages, 0, allocation));
+  allocator.free(allocation);
+  EXPECT_EQ(kNumPages, allocator.numMapped());
+  MappedMemory::ContiguousAllocation contiguous;
+  ASSERT_TRUE(allocator.allocateContiguous(capacity, nullptr, contiguous));
+  EXPECT_EQ(capacity, allocator.numMapped());
+  EXPECT_TRUE(allocator.checkConsistency());
+  const auto numHugePages = allocator.stats().numAdvisedHugePages;
+  // 0 if the kernel has no transparent huge pages.
+  EXPECT_TRUE(numHugePages == 0 || numHugePages == 8) << numHugePages;
+  EXPECT_EQ(kNumPages, allocator.stats().numAdvise);
+  allocator.freeContiguous(contiguous);
+  EXPECT_EQ(0, allocator.numAllocated());
+}
+
+TEST(MmapAllocatorThreadCacheTest, allocateFromCache) {
+  MmapAllocatorOptions options;
+  options.capacity = kMaxMappedMemory;
+  options.threadCachePages = 64;
+  MmapAllocator allocator(options);
+
+  MappedMemory::Allocation allocation(&allocator);
+  ASSERT_TRUE(allocator.allocate(16, 0, allocation));
+  auto* data = allocation.runAt(0).data();
+  EXPECT_EQ(16 * MappedMemory::kPageSize, allocator.free(allocation));
+  EXPECT_EQ(0, allocator.numAllocated());
+  EXPECT_EQ(16, allocator.numCachedPages());
+  EXPECT_TRUE(allocator.checkConsistency());
+
+  // The next allocation of the thread gets the cached pages.
+  ASSERT_TRUE(allocator.allocate(16, 0, allocation));
+  EXPECT_EQ(data, allocation.runAt(0).data());
+  EXPECT_EQ(16, allocator.numAllocated());
+  EXPECT_EQ(0, allocator.numCachedPages());
+
+  // An allocation larger than the cache is freed to the size classes.
+  MappedMemory::Allocation large(&allocator);
+  ASSERT_TRUE(allocator.allocate(100, 0, large));
+  allocator.free(large);
+  EXPECT_EQ(0, allocator.numCachedPages());
+  allocator.free(allocation);
+
+  // The cache of a thread is flushed when the thread exits.
+  std::thread([&]() {
+    MappedMemory::Allocation other(&allocator);
+    ASSERT_TRUE(allocator.allocate(8, 0, other));
+    allocator.free(other);
+    EXPECT_EQ(24, allocator.numCachedPages());
+  }).join();
+  EXPECT_EQ(16, allocator.numCachedPages());
+
+  allocator.flushThreadCaches();
+  EXPECT_EQ(0, allocator.numCachedPages());
+  EXPECT_EQ(0, allocator.numAllocated());
+  EXPECT_TRUE(allocator.checkConsistency());
+}
 } // namespace facebook::velox::memory
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/common/memory/MemoryArbitrator.h"
+
+using namespace ::facebook::velox::memory;
+using namespace ::facebook::velox;
+
+namespace {
+constexpr int64_t kMB = 1 << 20;
+
+MemoryArbitrator::Config makeConfig(int64_t capacity) {
+  MemoryArbitrator::Config config;
+  config.capacity = capacity;
+  config.initialCapacity = 4 * kMB;
+  config.minGrowBytes = 2 * kMB;
+  return config;
+}
+} // namespace
+
+TEST(MemoryArbitratorTest, growFromFreeCapacity) {
+  MemoryArbitrator arbitrator(makeConfig(16 * kMB));
+  auto tracker = MemoryUsageTracker::create();
+  arbitrator.addTracker(tracker);
+  EXPECT_EQ(4 * kMB, tracker->maxTotalBytes());
+  EXPECT_EQ(12 * kMB, arbitrator.freeCapacity());
+
+  // Growing past the initial cap takes at least 'minGrowBytes'.
+  tracker->update(5 * kMB);
+  EXPECT_EQ(6 * kMB, tracker->maxTotalBytes());
+  EXPECT_EQ(10 * kMB, arbitrator.freeCapacity());
+
+  // The last grow takes what is needed even if less than 'minGrowBytes'.
+  tracker->update(10 * kMB);
+  EXPECT_EQ(15 * kMB, tracker->maxTotalBytes());
+  EXPECT_EQ(kMB, arbitrator.freeCapacity());
+  EXPECT_THROW(tracker->update(2 * kMB), VeloxRuntimeError);
+
+  tracker->update(-15 * kMB);
+  EXPECT_EQ(15 * kMB, arbitrator.shrink(tracker.get()));
+  EXPECT_EQ(16 * kMB, arbitrator.freeCapacity());
+
+  auto stats = arbitrator.stats();
+  EXPECT_EQ(3, stats.numRequests);
+  EXPECT_EQ(2, stats.numGrows);
+  EXPECT_EQ(1, stats.numFailures);
+  EXPECT_EQ(15 * kMB, stats.shrunkBytes);
+
+  arbitrator.removeTracker(tracker.get());
+  EXPECT_EQ(16 * kMB, arbitrator.freeCapacity());
+}
+
+TEST(MemoryArbitratorTest, reclaimByPriority) {
+  MemoryArbitrator arbitrator(makeConfig(14 * kMB));
+  auto low = MemoryUsageTracker::create();
+  auto high = MemoryUsageTracker::create();
+  auto requestor = MemoryUsageTracker::create();
+  arbitrator.addTracker(low, 0);
+  arbitrator.addTracker(high, 2);
+  arbitrator.addTracker(requestor, 1);
+
+  // Each reclaimer frees all the memory of its tracker.
+  int32_t numLowReclaims = 0;
+  low->addReclaimer([&](int64_t /*targetBytes*/) {
+    ++numLowReclaims;
+    const auto bytes = low->getCurrentTotalBytes();
+    low->update(-bytes);
+    return bytes;
+  });
+  int32_t numHighReclaims = 0;
+  high->addReclaimer([&](int64_t /*targetBytes*/) {
+    ++numHighReclaims;
+    const auto bytes = high->getCurrentTotalBytes();
+    high->update(-bytes);
+    return bytes;
+  });
+
+  low->update(4 * kMB);
+  high->update(6 * kMB);
+  high->update(-2 * kMB);
+  EXPECT_EQ(6 * kMB, high->maxTotalBytes());
+  EXPECT_EQ(4 * kMB, requestor->maxTotalBytes());
+  EXPECT_EQ(0, arbitrator.freeCapacity());
+
+  // The unused capacity of 'high' is taken back without reclaiming.
+  requestor->update(5 * kMB);
+  EXPECT_EQ(0, numLowReclaims);
+  EXPECT_EQ(4 * kMB, high->maxTotalBytes());
+  EXPECT_EQ(6 * kMB, requestor->maxTotalBytes());
+
+  // The memory of 'low' is revoked, not that of 'high'.
+  requestor->update(4 * kMB);
+  EXPECT_EQ(1, numLowReclaims);
+  EXPECT_EQ(0, numHighReclaims);
+  EXPECT_EQ(0, low->maxTotalBytes());
+  EXPECT_EQ(4 * kMB, high->getCurrentTotalBytes());
+  EXPECT_EQ(9 * kMB, requestor->maxTotalBytes());
+
+  // 'requestor' can't revoke the memory of 'high'.
+  EXPECT_THROW(requestor->update(4 * kMB), VeloxRuntimeError);
+  EXPECT_EQ(0, numHighReclaims);
+
+  auto stats = arbitrator.stats();
+  EXPECT_EQ(1, stats.numReclaims);
+  EXPECT_EQ(4 * kMB, stats.reclaimedBytes);
+  EXPECT_EQ(1, stats.numFailures);
+
+  requestor->update(-9 * kMB);
+  high->update(-4 * kMB);
+  arbitrator.removeTracker(low.get());
+  arbitrator.removeTracker(high.get());
+  arbitrator.removeTracker(requestor.get());
+  EXPECT_EQ(14 * kMB, arbitrator.freeCapacity());
+}
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <gflags/gflags.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -388,6 +389,40 @@ TEST_P(MemoryPoolTest, AllocTest) {
   EXPECT_EQ(4 * kChunkSize, child.getMaxBytes());
 }
 
+TEST_P(MemoryPoolTest, allocationSampling) {
+  auto manager = getMemoryManager(8 * GB);
+  auto& root = manager->getRoot();
+  auto& child = root.addChild("sampled");
+  ASSERT_NE(nullptr, child.allocationSampler());
+
+  // Nothing is recorded with sampling off.
+  void* notSampled = child.allocate(KB);
+  EXPECT_TRUE(child.allocationSampler()->sites().empty());
+
+  gflags::FlagSaver flagSaver;
+  FLAGS_velox_allocation_sample_bytes = 1;
+  std::vector<void*> sampled;
+  for (auto i = 0; i < 3; ++i) {
+    sampled.push_back(child.allocate(MB));
+  }
+  void* otherSite = child.allocate(2 * MB);
+  auto sites = child.allocationSampler()->sites();
+  ASSERT_EQ(2, sites.size());
+  EXPECT_EQ(3 * MB, sites[0].bytes);
+  EXPECT_EQ(3, sites[0].numSamples);
+  EXPECT_EQ(2 * MB, sites[1].bytes);
+  EXPECT_EQ(1, sites[1].numSamples);
+  EXPECT_NE(
+      std::string::npos,
+      child.allocationSampler()->toString().find("Allocation sites: 2"));
+
+  for (auto* p : sampled) {
+    child.free(p, MB);
+  }
+  child.free(otherSite, 2 * MB);
+  child.free(notSampled, KB);
+}
+
 TEST_P(MemoryPoolTest, ReallocTestSameSize) {
   auto manager = getMemoryManager(8 * GB);
   auto& root = manager->getRoot();
@@ -15,6 +15,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <thread>
 
 #include "velox/common/memory/MemoryUsageTracker.h"
 
@@ -196,6 +197,48 @@ TEST(MemoryUsageTrackerTest, reserveAndUpdate) {
   EXPECT_EQ(2 * kMB - 2000, child1->getAvailableReservation());
 }
 
+TEST(MemoryUsageTrackerTest, concurrentUpdateWithinReservation) {
+  constexpr int64_t kMB = 1 << 20;
+  constexpr int32_t kNumThreads = 8;
+  constexpr int32_t kNumUpdates = 10'000;
+  auto config = MemoryUsageConfigBuilder().maxUserMemory(4 * kMB).build();
+  auto parent = MemoryUsageTracker::create(config);
+  auto child = parent->addChild();
+
+  // The updates stay within the first MB of reservation, so they do not
+  // change the parent's usage.
+  child->update(1000);
+  ASSERT_EQ(kMB, parent->getCurrentTotalBytes());
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&]() {
+      for (int32_t j = 0; j < kNumUpdates; ++j) {
+        child->update(64);
+        child->update(-64);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(1000, child->getCurrentTotalBytes());
+  EXPECT_EQ(kMB - 1000, child->getAvailableReservation());
+  EXPECT_EQ(kMB, parent->getCurrentTotalBytes());
+
+  // Filling the reservation exactly does not reserve more and going past
+  // the limit fails without changing the accounting.
+  child->update(kMB - 1000);
+  EXPECT_EQ(0, child->getAvailableReservation());
+  EXPECT_EQ(kMB, parent->getCurrentTotalBytes());
+  ASSERT_THROW(child->update(4 * kMB), VeloxRuntimeError);
+  EXPECT_EQ(0, child->getAvailableReservation());
+  EXPECT_EQ(kMB, parent->getCurrentTotalBytes());
+  child->update(1);
+  EXPECT_EQ(2 * kMB, parent->getCurrentTotalBytes());
+  child->update(-kMB - 1);
+  EXPECT_EQ(0, parent->getCurrentTotalBytes());
+}
+
 namespace {
 // Model implementation of a GrowCallback.
 bool grow(
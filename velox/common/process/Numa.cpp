@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/process/Numa.h"
+
+#include <fmt/format.h>
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <glog/logging.h>
+#include <mutex>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace facebook::velox::process {
+
+namespace {
+// Maximum number of nodes. This is the width of the node mask passed to
+// mbind.
+constexpr int32_t kMaxNumaNodes = 64;
+
+// The memory policy that prefers a node. Same as MPOL_PREFERRED of
+// <numaif.h>, which comes with libnuma.
+constexpr int kMpolPreferred = 1;
+
+struct NumaTopology {
+  // The CPUs of each node.
+  std::vector<std::vector<int32_t>> nodeCpus;
+};
+
+// Parses a sysfs CPU list like "0-3,8-11".
+std::vector<int32_t> parseCpuList(const std::string& text) {
+  std::vector<int32_t> cpus;
+  std::vector<folly::StringPiece> ranges;
+  folly::split(',', folly::trimWhitespace(text), ranges);
+  for (auto range : ranges) {
+    if (range.empty()) {
+      continue;
+    }
+    folly::StringPiece first;
+    folly::StringPiece last;
+    if (!folly::split('-', range, first, last)) {
+      first = range;
+      last = range;
+    }
+    for (auto cpu = folly::to<int32_t>(first); cpu <= folly::to<int32_t>(last);
+         ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+NumaTopology readTopology() {
+  NumaTopology topology;
+#ifdef __linux__
+  for (auto node = 0; node < kMaxNumaNodes; ++node) {
+    std::string cpuList;
+    if (!folly::readFile(
+            fmt::format("/sys/devices/system/node/node{}/cpulist", node)
+                .c_str(),
+            cpuList)) {
+      break;
+    }
+    try {
+      topology.nodeCpus.push_back(parseCpuList(cpuList));
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Cannot parse the CPUs of NUMA node " << node << ": "
+                   << e.what();
+      topology.nodeCpus.clear();
+      break;
+    }
+  }
+#endif
+  if (topology.nodeCpus.empty()) {
+    topology.nodeCpus.resize(1);
+  }
+  return topology;
+}
+
+const NumaTopology& topology() {
+  static const NumaTopology topology = readTopology();
+  return topology;
+}
+
+// The number of threads reserved on each node by reserveNumaNode().
+std::mutex reservationMutex;
+std::vector<int32_t> numReservedThreads;
+} // namespace
+
+int32_t numNumaNodes() {
+  return topology().nodeCpus.size();
+}
+
+const std::vector<int32_t>& numaNodeCpus(int32_t node) {
+  return topology().nodeCpus.at(node);
+}
+
+int32_t currentNumaNode() {
+  if (numNumaNodes() == 1) {
+    return 0;
+  }
+#ifdef __linux__
+  unsigned cpu = 0;
+  unsigned node = 0;
+  // A node past the nodes read from sysfs would be in a gap of the node
+  // numbers, which is not supported.
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 &&
+      node < numNumaNodes()) {
+    return node;
+  }
+#endif
+  return 0;
+}
+
+bool bindToNumaNode(void* address, size_t size, int32_t node) {
+#ifdef __linux__
+  if (numNumaNodes() == 1) {
+    return true;
+  }
+  DCHECK_LT(node, kMaxNumaNodes);
+  uint64_t nodeMask = 1UL << node;
+  return syscall(
+             SYS_mbind,
+             address,
+             size,
+             kMpolPreferred,
+             &nodeMask,
+             kMaxNumaNodes + 1,
+             0) == 0;
+#else
+  return true;
+#endif
+}
+
+int32_t reserveNumaNode(int32_t numThreads) {
+  const auto numNodes = numNumaNodes();
+  if (numNodes == 1) {
+    return kNoNumaNode;
+  }
+  std::lock_guard<std::mutex> l(reservationMutex);
+  numReservedThreads.resize(numNodes, 0);
+  int32_t bestNode = kNoNumaNode;
+  for (auto node = 0; node < numNodes; ++node) {
+    if (numaNodeCpus(node).size() < numThreads) {
+      continue;
+    }
+    if (bestNode == kNoNumaNode ||
+        numReservedThreads[node] < numReservedThreads[bestNode]) {
+      bestNode = node;
+    }
+  }
+  if (bestNode != kNoNumaNode) {
+    numReservedThreads[bestNode] += numThreads;
+  }
+  return bestNode;
+}
+
+void releaseNumaNode(int32_t node, int32_t numThreads) {
+  if (node == kNoNumaNode) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(reservationMutex);
+  numReservedThreads[node] -= numThreads;
+}
+
+ScopedNumaAffinity::ScopedNumaAffinity(int32_t node) {
+#ifdef __linux__
+  if (numNumaNodes() == 1) {
+    return;
+  }
+  crossNode_ = currentNumaNode() != node;
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+    return;
+  }
+  cpu_set_t nodeCpus;
+  CPU_ZERO(&nodeCpus);
+  for (auto cpu : numaNodeCpus(node)) {
+    CPU_SET(cpu, &nodeCpus);
+  }
+  if (CPU_EQUAL(&cpus, &nodeCpus) ||
+      pthread_setaffinity_np(pthread_self(), sizeof(nodeCpus), &nodeCpus) !=
+          0) {
+    return;
+  }
+  for (auto cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &cpus)) {
+      previousCpus_.push_back(cpu);
+    }
+  }
+#endif
+}
+
+ScopedNumaAffinity::~ScopedNumaAffinity() {
+#ifdef __linux__
+  if (previousCpus_.empty()) {
+    return;
+  }
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  for (auto cpu : previousCpus_) {
+    CPU_SET(cpu, &cpus);
+  }
+  pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#endif
+}
+
+} // namespace facebook::velox::process
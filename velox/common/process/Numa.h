@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace facebook::velox::process {
+
+/// Minimal NUMA topology and placement functions. These use the Linux
+/// sysfs files and system calls directly and do not depend on libnuma. On
+/// other systems, or if the topology can't be read, the machine has a
+/// single node 0 and binding and pinning are no-ops.
+
+/// Denotes no NUMA node, e.g. for a Task that is not pinned.
+constexpr int32_t kNoNumaNode = -1;
+
+/// Returns the number of NUMA nodes of the machine, at least 1.
+int32_t numNumaNodes();
+
+/// Returns the CPUs of 'node'.
+const std::vector<int32_t>& numaNodeCpus(int32_t node);
+
+/// Returns the NUMA node of the CPU that runs the calling thread.
+int32_t currentNumaNode();
+
+/// Sets the memory policy of the 'size' bytes at 'address' to prefer memory
+/// of 'node' when the pages are first touched. Prefers rather than binds so
+/// that a full node falls back to the other nodes instead of failing the
+/// page fault. Returns false if the policy could not be set.
+bool bindToNumaNode(void* address, size_t size, int32_t node);
+
+/// Reserves 'numThreads' threads on the NUMA node with the fewest reserved
+/// threads among the nodes that have at least 'numThreads' CPUs. Returns the
+/// node or kNoNumaNode if the machine has a single node or the threads don't
+/// fit on any node. A reserved node must be released with releaseNumaNode().
+int32_t reserveNumaNode(int32_t numThreads);
+
+void releaseNumaNode(int32_t node, int32_t numThreads);
+
+/// Restricts the calling thread to the CPUs of a NUMA node for the lifetime
+/// of 'this' and then restores the previous CPU affinity of the thread.
+class ScopedNumaAffinity {
+ public:
+  explicit ScopedNumaAffinity(int32_t node);
+
+  ~ScopedNumaAffinity();
+
+  /// True if the thread ran on a different node when 'this' was made, i.e.
+  /// the thread now accesses memory it touched on another node or vice
+  /// versa.
+  bool crossNode() const {
+    return crossNode_;
+  }
+
+ private:
+  bool crossNode_{false};
+  // The CPUs the thread could run on before 'this'. Empty if the affinity
+  // was not changed.
+  std::vector<int32_t> previousCpus_;
+};
+
+} // namespace facebook::velox::process
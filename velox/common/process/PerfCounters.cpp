@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/process/PerfCounters.h"
+
+#include <glog/logging.h>
+#include <memory>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace facebook::velox::process {
+
+#ifdef __linux__
+namespace {
+struct CounterSpec {
+  uint32_t type;
+  uint64_t config;
+  uint64_t PerfCounterValues::*field;
+};
+
+// The cycle counter comes first since it leads the group.
+const std::vector<CounterSpec>& counterSpecs() {
+  static const std::vector<CounterSpec> kSpecs = {
+      {PERF_TYPE_HARDWARE,
+       PERF_COUNT_HW_CPU_CYCLES,
+       &PerfCounterValues::cycles},
+      {PERF_TYPE_HARDWARE,
+       PERF_COUNT_HW_INSTRUCTIONS,
+       &PerfCounterValues::instructions},
+      {PERF_TYPE_HARDWARE,
+       PERF_COUNT_HW_CACHE_MISSES,
+       &PerfCounterValues::llcMisses},
+      {PERF_TYPE_HW_CACHE,
+       PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+       &PerfCounterValues::dtlbMisses},
+      {PERF_TYPE_HARDWARE,
+       PERF_COUNT_HW_BRANCH_MISSES,
+       &PerfCounterValues::branchMisses},
+  };
+  return kSpecs;
+}
+
+int openCounter(const CounterSpec& spec, int groupFd) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = spec.type;
+  attr.config = spec.config;
+  attr.disabled = groupFd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+      PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // Counts the calling thread on any CPU.
+  return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+} // namespace
+#endif
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (auto fd : fds_) {
+    close(fd);
+  }
+#endif
+}
+
+// static
+PerfCounters* PerfCounters::forCurrentThread() {
+  thread_local std::unique_ptr<PerfCounters> counters;
+  thread_local bool initialized = false;
+  if (!initialized) {
+    initialized = true;
+    std::unique_ptr<PerfCounters> newCounters(new PerfCounters());
+    if (newCounters->open()) {
+      counters = std::move(newCounters);
+    }
+  }
+  return counters.get();
+}
+
+bool PerfCounters::open() {
+#ifdef __linux__
+  for (const auto& spec : counterSpecs()) {
+    const auto fd = openCounter(spec, fds_.empty() ? -1 : fds_[0]);
+    if (fd < 0) {
+      if (fds_.empty()) {
+        LOG_FIRST_N(WARNING, 1)
+            << "Hardware performance counters are not available: errno "
+            << errno;
+        return false;
+      }
+      continue;
+    }
+    fds_.push_back(fd);
+    fields_.push_back(spec.field);
+  }
+  ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool PerfCounters::read(PerfCounterValues& values) const {
+#ifdef __linux__
+  // The layout for PERF_FORMAT_GROUP with both times: the number of
+  // counters, the times enabled and running and then a value per counter.
+  uint64_t buffer[3 + 8];
+  const auto size = (3 + fds_.size()) * sizeof(uint64_t);
+  if (::read(fds_[0], buffer, size) != static_cast<ssize_t>(size) ||
+      buffer[0] != fds_.size()) {
+    return false;
+  }
+  const auto enabled = buffer[1];
+  const auto running = buffer[2];
+  if (running == 0) {
+    return false;
+  }
+  values = PerfCounterValues();
+  for (auto i = 0; i < fields_.size(); ++i) {
+    auto value = buffer[3 + i];
+    if (running < enabled) {
+      value = static_cast<uint64_t>(
+          static_cast<double>(value) * enabled / running);
+    }
+    values.*fields_[i] = value;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+PerfCounterTimer::PerfCounterTimer(
+    std::function<void(const PerfCounterValues&)> onDelta)
+    : onDelta_(std::move(onDelta)),
+      counters_(PerfCounters::forCurrentThread()) {
+  if (counters_ && !counters_->read(start_)) {
+    counters_ = nullptr;
+  }
+}
+
+PerfCounterTimer::~PerfCounterTimer() {
+  PerfCounterValues end;
+  if (counters_ && counters_->read(end)) {
+    onDelta_(end - start_);
+  }
+}
+
+} // namespace facebook::velox::process
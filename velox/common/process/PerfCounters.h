@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace facebook::velox::process {
+
+/// Hardware events counted on a thread.
+struct PerfCounterValues {
+  uint64_t cycles{0};
+  uint64_t instructions{0};
+  uint64_t llcMisses{0};
+  uint64_t dtlbMisses{0};
+  uint64_t branchMisses{0};
+
+  /// Returns the events counted since 'other'. Values scaled for
+  /// multiplexing may decrease, so a difference is at least 0.
+  PerfCounterValues operator-(const PerfCounterValues& other) const {
+    return {
+        minus(cycles, other.cycles),
+        minus(instructions, other.instructions),
+        minus(llcMisses, other.llcMisses),
+        minus(dtlbMisses, other.dtlbMisses),
+        minus(branchMisses, other.branchMisses)};
+  }
+
+ private:
+  static uint64_t minus(uint64_t left, uint64_t right) {
+    return left > right ? left - right : 0;
+  }
+};
+
+/// Counts the cycles, instructions, last level cache misses, data TLB misses
+/// and branch mispredictions of a thread in user mode with
+/// perf_event_open(2). The counters are one group, so that they all count
+/// over the same intervals. Counters the CPU does not have read as 0.
+class PerfCounters {
+ public:
+  ~PerfCounters();
+
+  /// Returns the counters of the calling thread, opening them on first use,
+  /// or nullptr if they can't be opened, e.g. when not on Linux or when
+  /// /proc/sys/kernel/perf_event_paranoid does not allow it. The counters
+  /// must only be read on their thread.
+  static PerfCounters* forCurrentThread();
+
+  /// Sets 'values' to the events counted so far, scaled up if the kernel
+  /// multiplexed the counters. Returns false if the counters could not be
+  /// read.
+  bool read(PerfCounterValues& values) const;
+
+ private:
+  PerfCounters() = default;
+
+  // Opens the counters. Returns false if the cycle counter, which leads
+  // the group, can't be opened.
+  bool open();
+
+  // File descriptors of the counters that could be opened. The first one is
+  // the group leader.
+  std::vector<int> fds_;
+
+  // The member of PerfCounterValues each of 'fds_' counts, in the order in
+  // which read() returns the values of the group.
+  std::vector<uint64_t PerfCounterValues::*> fields_;
+};
+
+/// Calls 'onDelta' with the events counted on the calling thread between
+/// the construction and destruction of 'this'. Does nothing if the thread
+/// has no PerfCounters.
+class PerfCounterTimer {
+ public:
+  explicit PerfCounterTimer(
+      std::function<void(const PerfCounterValues&)> onDelta);
+
+  ~PerfCounterTimer();
+
+ private:
+  std::function<void(const PerfCounterValues&)> onDelta_;
+  const PerfCounters* counters_;
+  PerfCounterValues start_;
+};
+
+} // namespace facebook::velox::process
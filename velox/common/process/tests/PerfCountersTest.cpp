@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/process/PerfCounters.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace facebook::velox::process;
+
+TEST(PerfCountersTest, timer) {
+  if (!PerfCounters::forCurrentThread()) {
+    GTEST_SKIP() << "Hardware performance counters are not available";
+  }
+  PerfCounterValues delta;
+  int32_t numCalls = 0;
+  {
+    PerfCounterTimer timer([&](const PerfCounterValues& values) {
+      delta = values;
+      ++numCalls;
+    });
+    volatile int64_t sum = 0;
+    for (auto i = 0; i < 1'000'000; ++i) {
+      sum = sum + i;
+    }
+  }
+  EXPECT_EQ(1, numCalls);
+  EXPECT_LT(0, delta.cycles);
+  EXPECT_LT(1'000'000, delta.instructions);
+}
+
+TEST(PerfCountersTest, perThread) {
+  auto* counters = PerfCounters::forCurrentThread();
+  EXPECT_EQ(counters, PerfCounters::forCurrentThread());
+  if (!counters) {
+    return;
+  }
+  PerfCounters* otherCounters = nullptr;
+  std::thread([&]() {
+    otherCounters = PerfCounters::forCurrentThread();
+  }).join();
+  EXPECT_NE(nullptr, otherCounters);
+  EXPECT_NE(counters, otherCounters);
+}
+
+TEST(PerfCountersTest, difference) {
+  PerfCounterValues start{10, 20, 3, 4, 5};
+  PerfCounterValues end{15, 40, 2, 4, 6};
+  const auto delta = end - start;
+  EXPECT_EQ(5, delta.cycles);
+  EXPECT_EQ(20, delta.instructions);
+  // Scaled values of multiplexed counters may decrease.
+  EXPECT_EQ(0, delta.llcMisses);
+  EXPECT_EQ(0, delta.dtlbMisses);
+  EXPECT_EQ(1, delta.branchMisses);
+}
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/future/VeloxPromise.h"
@@ -34,6 +35,8 @@ class ExprSet;
 }
 namespace facebook::velox::connector {
 
+class DataSource;
+
 // A split represents a chunk of data that a connector should load and return
 // as a RowVectorPtr, potentially after processing pushdowns.
 struct ConnectorSplit {
@@ -43,6 +46,10 @@ struct ConnectorSplit {
   // async prefetch for the split.
   bool cancelled{false};
 
+  // A DataSource that has been given 'this' with addSplit() ahead of time,
+  // set if the split is preloaded. See DataSource::setFromDataSource().
+  std::shared_ptr<AsyncSource<DataSource>> dataSource;
+
   explicit ConnectorSplit(const std::string& _connectorId)
       : connectorId(_connectorId) {}
 
@@ -53,6 +60,18 @@ struct ConnectorSplit {
   }
 };
 
+// Scheduling hint for a split. See Connector::splitAffinity().
+struct SplitAffinity {
+  // Hash of the data the split reads. This is the same in all processes for
+  // splits over the same data. A scheduler that maps this to workers by
+  // consistent hashing sends these splits to the worker that has cached
+  // their data.
+  uint64_t key{0};
+
+  // True if data of the split is cached in memory or on SSD on this worker.
+  bool isCached{false};
+};
+
 class ColumnHandle {
  public:
   virtual ~ColumnHandle() = default;
@@ -87,6 +106,13 @@ class ConnectorInsertTableHandle {
   virtual bool supportsMultiThreading() const {
     return false;
   }
+
+  // Returns the handle for writing the file of bucket 'bucket' of a bucketed
+  // table write, see core::TableWriteNode::numBuckets().
+  virtual std::shared_ptr<ConnectorInsertTableHandle> bucketHandle(
+      int32_t /*bucket*/) const {
+    VELOX_UNSUPPORTED("Connector does not support bucketed writes");
+  }
 };
 
 class DataSink {
@@ -98,6 +124,21 @@ class DataSink {
   virtual void appendData(VectorPtr input) = 0;
 
   virtual void close() = 0;
+
+  // Returns the bytes of memory that reclaim() would free, e.g. the memory of
+  // the buffered data that is not yet written out. Called by the TableWriter
+  // operator while the drivers of its Task are paused.
+  virtual int64_t reclaimableBytes() const {
+    return 0;
+  }
+
+  // Frees the memory reported by reclaimableBytes(), e.g. by flushing the
+  // buffered data early.
+  virtual void reclaim() {}
+
+  virtual std::unordered_map<std::string, RuntimeCounter> runtimeStats() {
+    return {};
+  }
 };
 
 class DataSource {
@@ -145,6 +186,15 @@ class DataSource {
   virtual int64_t estimatedRowSize() {
     return kUnknownRowSize;
   }
+
+  // Takes over the split of 'source', a DataSource that has been made like
+  // 'this' and has been given the split with addSplit(), typically on a
+  // background thread. 'this' then processes the split as if it had been
+  // added to 'this'. Used for preloading splits if the connector
+  // supportsSplitPreload().
+  virtual void setFromDataSource(std::unique_ptr<DataSource> /*source*/) {
+    VELOX_UNSUPPORTED("setFromDataSource");
+  }
 };
 
 // Exposes expression evaluation functionality of the engine to the connector.
@@ -174,12 +224,14 @@ class ConnectorQueryCtx {
       Config* config,
       ExpressionEvaluator* expressionEvaluator,
       memory::MappedMemory* mappedMemory,
-      const std::string& scanId)
+      const std::string& scanId,
+      int32_t cacheTenant = 0)
       : pool_(pool),
         config_(config),
         expressionEvaluator_(expressionEvaluator),
         mappedMemory_(mappedMemory),
-        scanId_(scanId) {}
+        scanId_(scanId),
+        cacheTenant_(cacheTenant) {}
 
   memory::MemoryPool* memoryPool() const {
     return pool_;
@@ -208,12 +260,19 @@ class ConnectorQueryCtx {
     return scanId_;
   }
 
+  // Tenant to which the query's reads are accounted if 'mappedMemory_' is
+  // a cache::AsyncDataCache. See core::QueryConfig::kCacheTenant.
+  int32_t cacheTenant() const {
+    return cacheTenant_;
+  }
+
  private:
   memory::MemoryPool* pool_;
   Config* config_;
   ExpressionEvaluator* expressionEvaluator_;
   memory::MappedMemory* mappedMemory_;
   std::string scanId_;
+  const int32_t cacheTenant_;
 };
 
 class Connector {
@@ -239,7 +298,31 @@ class Connector {
     return false;
   }
 
-  virtual std::shared_ptr<DataSource> createDataSource(
+  // Returns true if the splits of this connector may be added to a separate
+  // DataSource ahead of time and taken over with
+  // DataSource::setFromDataSource(). The file open and metadata reads of the
+  // next splits then overlap the scan of the current one.
+  virtual bool supportsSplitPreload() const {
+    return false;
+  }
+
+  // Returns the executor for background work of the connector, e.g. split
+  // preloading, or nullptr if none.
+  virtual folly::Executor* FOLLY_NULLABLE executor() const {
+    return nullptr;
+  }
+
+  // Returns the scheduling affinity of 'split' or std::nullopt if the
+  // connector has no locality for it. 'mappedMemory' is the MappedMemory of
+  // the worker's queries. The residency of the split's data is checked if
+  // this is a cache::AsyncDataCache.
+  virtual std::optional<SplitAffinity> splitAffinity(
+      const ConnectorSplit& /*split*/,
+      memory::MappedMemory* FOLLY_NULLABLE /*mappedMemory*/) const {
+    return std::nullopt;
+  }
+
+  virtual std::unique_ptr<DataSource> createDataSource(
       const RowTypePtr& outputType,
       const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
       const std::unordered_map<
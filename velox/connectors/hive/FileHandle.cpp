@@ -15,7 +15,9 @@
  */
 
 #include "velox/connectors/hive/FileHandle.h"
+#include "velox/common/base/Exceptions.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
 
 #include <atomic>
 
@@ -39,10 +41,14 @@ std::string groupName(const std::string& filename) {
 std::unique_ptr<FileHandle> FileHandleGenerator::operator()(
     const std::string& filename) {
   auto fileHandle = std::make_unique<FileHandle>();
-  fileHandle->file = filesystems::getFileSystem(filename, properties_)
-                         ->openFileForRead(filename);
+  auto fileSystem = filesystems::getFileSystem(filename, properties_);
+  fileHandle->file = fileSystem->openFileForRead(filename);
+  fileHandle->ioProfile = dwio::common::ioProfileTracker(
+      fileSystem->name(), fileSystem->ioProfile());
   fileHandle->uuid = StringIdLease(fileIds(), filename);
   fileHandle->groupId = StringIdLease(fileIds(), groupName(filename));
+  fileHandle->size = fileHandle->file->size();
+  fileHandle->openTimeMs = getCurrentTimeMs();
   VLOG(1) << "Generating file handle for: " << filename
           << " uuid: " << fileHandle->uuid.id();
   // TODO: build the hash map/etc per file type -- presumably after reading
@@ -51,4 +57,67 @@ std::unique_ptr<FileHandle> FileHandleGenerator::operator()(
   return fileHandle;
 }
 
+FileHandleFactory::FileHandleFactory(
+    std::unique_ptr<FileHandleGenerator> generator,
+    int64_t maxSize,
+    int32_t numShards,
+    std::chrono::milliseconds ttl)
+    : generator_(std::move(generator)), ttlMs_(ttl.count()) {
+  VELOX_CHECK_GT(numShards, 0);
+  VELOX_CHECK_GE(ttl.count(), 0);
+  shards_.reserve(numShards);
+  for (auto i = 0; i < numShards; ++i) {
+    shards_.push_back(std::make_unique<Shard>(
+        std::make_unique<SimpleLRUCache<std::string, FileHandle>>(
+            maxSize / numShards),
+        std::make_unique<FileHandleGenerator>(*generator_)));
+  }
+}
+
+FileHandleCachedPtr FileHandleFactory::generate(const std::string& filename) {
+  return refreshIfExpired(filename, shard(filename).generate(filename));
+}
+
+folly::SemiFuture<FileHandleCachedPtr> FileHandleFactory::generateAsync(
+    const std::string& filename,
+    folly::Executor* executor) {
+  return shard(filename)
+      .generateAsync(filename, executor)
+      .deferValue([this, filename](FileHandleCachedPtr handle) {
+        return refreshIfExpired(filename, std::move(handle));
+      });
+}
+
+FileHandleCachedPtr FileHandleFactory::refreshIfExpired(
+    const std::string& filename,
+    FileHandleCachedPtr handle) {
+  if (ttlMs_ == 0 || getCurrentTimeMs() - handle->openTimeMs < ttlMs_) {
+    return handle;
+  }
+  handle = FileHandleCachedPtr();
+  auto& cache = shard(filename);
+  if (cache.evict(filename)) {
+    return cache.generate(filename);
+  }
+  // The expired handle is in use by another thread. Returns a new handle
+  // that is not cached. The expired one is reopened once not in use.
+  return FileHandleCachedPtr((*generator_)(filename).release());
+}
+
+int64_t FileHandleFactory::currentSize() const {
+  int64_t size = 0;
+  for (const auto& shard : shards_) {
+    size += shard->currentSize();
+  }
+  return size;
+}
+
+int64_t FileHandleFactory::maxSize() const {
+  int64_t size = 0;
+  for (const auto& shard : shards_) {
+    size += shard->maxSize();
+  }
+  return size;
+}
+
 } // namespace facebook::velox
@@ -19,21 +19,23 @@
 // we open a file we might build a hash map saying what region(s) on disk
 // correspond to a given column in a given stripe.
 //
-// The FileHandle will normally be used in conjunction with a CachedFactory
-// to speed up queries that hit the same files repeatedly; see the
-// FileHandleCache and FileHandleFactory.
+// The FileHandle will normally be used in conjunction with a
+// FileHandleFactory to speed up queries that hit the same files repeatedly.
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "velox/common/caching/CachedFactory.h"
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/file/File.h"
 #include "velox/core/Context.h"
 #include "velox/dwio/common/InputStream.h"
+#include "velox/dwio/common/IoStatistics.h"
 
 namespace facebook::velox {
 
@@ -51,6 +53,17 @@ struct FileHandle {
   // example to decide placing on SSD.
   StringIdLease groupId;
 
+  // Latency and throughput of the file system of 'file', shared by all
+  // files of the file system.
+  std::shared_ptr<dwio::common::IoProfileTracker> ioProfile;
+
+  // Size of 'file', taken when the file was opened.
+  uint64_t size{0};
+
+  // Time when the file was opened. Used for expiring cached handles of files
+  // that may have been replaced.
+  uint64_t openTimeMs{0};
+
   // We'll want to have a hash map here to record the identifier->byte range
   // mappings. Different formats may have different identifiers, so we may need
   // a union of maps. For example in orc you need 3 integers (I think, to be
@@ -63,8 +76,6 @@ struct FileHandleSizer {
   uint64_t operator()(const FileHandle& a);
 };
 
-using FileHandleCache = SimpleLRUCache<std::string, FileHandle>;
-
 // Creates FileHandles via the Generator interface the CachedFactory requires.
 class FileHandleGenerator {
  public:
@@ -77,12 +88,57 @@ class FileHandleGenerator {
   const std::shared_ptr<const Config> properties_;
 };
 
-using FileHandleFactory = CachedFactory<
-    std::string,
-    FileHandle,
-    FileHandleGenerator,
-    FileHandleSizer>;
-
 using FileHandleCachedPtr = CachedPtr<std::string, FileHandle>;
 
+// Cache of FileHandles keyed on the file path. The cache is split into
+// shards by the hash of the path, each with its own locks and a slice of the
+// capacity, so that concurrent lookups and opens of different files do not
+// contend. Concurrent requests for the same file wait for a single open.
+// Handles older than 'ttl' are reopened on the next request so that a
+// replaced file is seen. A 'ttl' of 0 keeps handles until evicted.
+class FileHandleFactory {
+ public:
+  static constexpr int32_t kDefaultNumShards = 16;
+
+  FileHandleFactory(
+      std::unique_ptr<FileHandleGenerator> generator,
+      int64_t maxSize,
+      int32_t numShards = kDefaultNumShards,
+      std::chrono::milliseconds ttl = std::chrono::milliseconds(0));
+
+  // Returns the handle for 'filename', opening the file on the calling
+  // thread if it is not cached.
+  FileHandleCachedPtr generate(const std::string& filename);
+
+  // Same as generate() but opens the file on 'executor'.
+  folly::SemiFuture<FileHandleCachedPtr> generateAsync(
+      const std::string& filename,
+      folly::Executor* executor);
+
+  // Total size of the cached handles.
+  int64_t currentSize() const;
+
+  int64_t maxSize() const;
+
+ private:
+  using Shard = CachedFactory<
+      std::string,
+      FileHandle,
+      FileHandleGenerator,
+      FileHandleSizer>;
+
+  Shard& shard(const std::string& filename) {
+    return *shards_[std::hash<std::string>()(filename) % shards_.size()];
+  }
+
+  // Returns 'handle' or a newly opened handle if 'handle' is expired.
+  FileHandleCachedPtr refreshIfExpired(
+      const std::string& filename,
+      FileHandleCachedPtr handle);
+
+  const std::unique_ptr<FileHandleGenerator> generator_;
+  const uint64_t ttlMs_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
 } // namespace facebook::velox
@@ -16,6 +16,8 @@
 
 #include "velox/connectors/hive/HiveConnector.h"
 
+#include "velox/common/caching/FileIds.h"
+
 #include "velox/dwio/common/InputStream.h"
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/expression/FieldReference.h"
@@ -33,6 +35,27 @@ DEFINE_int32(
     1024,
     "Amount of space for the file handle cache in mb.");
 
+DEFINE_int32(
+    file_handle_cache_shards,
+    16,
+    "Number of independently locked shards of the file handle cache.");
+
+DEFINE_int64(
+    file_handle_ttl_ms,
+    0,
+    "Time after which a cached file handle is reopened. 0 means never.");
+
+DEFINE_int32(
+    hive_scan_result_cache_mb,
+    0,
+    "Amount of memory for caching the filtered and projected output of "
+    "scans of splits. 0 disables the cache.");
+
+DEFINE_int32(
+    hive_scan_result_cache_max_entry_mb,
+    64,
+    "The output of a split larger than this is not cached.");
+
 namespace facebook::velox::connector::hive {
 namespace {
 static const char* kPath = "$path";
@@ -105,6 +128,21 @@ void HiveDataSink::close() {
   writer_->close();
 }
 
+int64_t HiveDataSink::reclaimableBytes() const {
+  return writer_->reclaimableBytes();
+}
+
+void HiveDataSink::reclaim() {
+  writer_->reclaim();
+}
+
+std::unordered_map<std::string, RuntimeCounter> HiveDataSink::runtimeStats() {
+  const auto& stats = writer_->forcedFlushStats();
+  return {
+      {"forcedFlushes.memoryBudget", RuntimeCounter(stats.memoryBudget)},
+      {"forcedFlushes.reclaim", RuntimeCounter(stats.reclaim)}};
+}
+
 namespace {
 static void makeFieldSpecs(
     const std::string& pathPrefix,
@@ -196,7 +234,9 @@ HiveDataSource::HiveDataSource(
     ExpressionEvaluator* expressionEvaluator,
     memory::MappedMemory* mappedMemory,
     const std::string& scanId,
-    folly::Executor* executor)
+    int32_t cacheTenant,
+    folly::Executor* executor,
+    ScanResultCache* scanResultCache)
     : outputType_(outputType),
       fileHandleFactory_(fileHandleFactory),
       pool_(pool),
@@ -204,7 +244,9 @@ HiveDataSource::HiveDataSource(
       expressionEvaluator_(expressionEvaluator),
       mappedMemory_(mappedMemory),
       scanId_(scanId),
-      executor_(executor) {
+      executor_(executor),
+      scanResultCache_(scanResultCache) {
+  readerOpts_.setCacheTenant(cacheTenant);
   // Column handled keyed on the column alias, the name used in the query.
   for (const auto& [canonicalizedName, columnHandle] : columnHandles) {
     auto handle = std::dynamic_pointer_cast<HiveColumnHandle>(columnHandle);
@@ -245,7 +287,10 @@ HiveDataSource::HiveDataSource(
   scanSpec_ =
       makeScanSpec(hiveTableHandle->subfieldFilters(), readerOutputType_);
 
-  const auto& remainingFilter = hiveTableHandle->remainingFilter();
+  auto remainingFilter = hiveTableHandle->remainingFilter();
+  if (remainingFilter) {
+    remainingFilter = extractPartitionFilter(remainingFilter);
+  }
   if (remainingFilter) {
     remainingFilterExprSet_ = expressionEvaluator_->compile(remainingFilter);
 
@@ -275,6 +320,76 @@ HiveDataSource::HiveDataSource(
   rowReaderOpts_.setScanSpec(scanSpec_);
 
   ioStats_ = std::make_shared<dwio::common::IoStatistics>();
+
+  // The results of a split depend only on the table handle and the columns
+  // read unless a filter is not deterministic.
+  if (scanResultCache_ &&
+      (!remainingFilterExprSet_ ||
+       remainingFilterExprSet_->expr(0)->isDeterministic()) &&
+      (!partitionFilterExprSet_ ||
+       partitionFilterExprSet_->expr(0)->isDeterministic())) {
+    scanFingerprint_ = fmt::format(
+        "{} {} {}",
+        hiveTableHandle->toString(),
+        readerOutputType_->toString(),
+        outputType_->toString());
+  }
+}
+
+namespace {
+// Appends the conjuncts of 'expr' to 'conjuncts'.
+void flattenConjuncts(
+    const core::TypedExprPtr& expr,
+    std::vector<core::TypedExprPtr>& conjuncts) {
+  auto call = std::dynamic_pointer_cast<const core::CallTypedExpr>(expr);
+  if (call && call->name() == "and") {
+    for (const auto& input : call->inputs()) {
+      flattenConjuncts(input, conjuncts);
+    }
+    return;
+  }
+  conjuncts.push_back(expr);
+}
+
+core::TypedExprPtr makeConjunction(std::vector<core::TypedExprPtr> conjuncts) {
+  if (conjuncts.empty()) {
+    return nullptr;
+  }
+  if (conjuncts.size() == 1) {
+    return conjuncts[0];
+  }
+  return std::make_shared<core::CallTypedExpr>(
+      BOOLEAN(), std::move(conjuncts), "and");
+}
+} // namespace
+
+core::TypedExprPtr HiveDataSource::extractPartitionFilter(
+    const core::TypedExprPtr& filter) {
+  if (partitionKeys_.empty()) {
+    return filter;
+  }
+  std::vector<core::TypedExprPtr> conjuncts;
+  flattenConjuncts(filter, conjuncts);
+  std::vector<core::TypedExprPtr> partitionConjuncts;
+  std::vector<core::TypedExprPtr> rowConjuncts;
+  for (const auto& conjunct : conjuncts) {
+    auto exprSet = expressionEvaluator_->compile(conjunct);
+    const auto& expr = exprSet->expr(0);
+    bool onlyPartitionKeys = expr->isDeterministic();
+    for (const auto* field : expr->distinctFields()) {
+      onlyPartitionKeys &= partitionKeys_.count(field->field()) > 0;
+    }
+    if (onlyPartitionKeys) {
+      partitionConjuncts.push_back(conjunct);
+    } else {
+      rowConjuncts.push_back(conjunct);
+    }
+  }
+  if (!partitionConjuncts.empty()) {
+    partitionFilterExprSet_ =
+        expressionEvaluator_->compile(makeConjunction(partitionConjuncts));
+  }
+  return makeConjunction(std::move(rowConjuncts));
 }
 
 namespace {
@@ -371,6 +486,9 @@ void HiveDataSource::addDynamicFilter(
     fieldSpec.setFilter(filter->clone());
   }
   scanSpec_->resetCachedValues();
+  // The results of the scan depend on the dynamic filter from now on.
+  scanFingerprint_.clear();
+  abandonScanResult();
 }
 
 void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
@@ -382,13 +500,37 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
 
   VLOG(1) << "Adding split " << split_->toString();
 
+  // Skips the split without opening the file if its partition is filtered
+  // out.
+  emptySplit_ = false;
+  if (partitionFilterExprSet_ && !testPartitionFilter()) {
+    VLOG(1) << "Skipping " << split_->filePath
+            << " based on partition key filter";
+    emptySplit_ = true;
+    ++runtimeStats_.skippedSplits;
+    runtimeStats_.skippedSplitBytes += split_->length;
+    return;
+  }
+
   fileHandle_ = fileHandleFactory_->generate(split_->filePath);
+  if (!scanFingerprint_.empty()) {
+    auto key = scanResultKey();
+    cachedBatches_ = scanResultCache_->find(key);
+    if (cachedBatches_) {
+      VLOG(1) << "Serving " << split_->toString() << " from the result cache";
+      ++numScanResultCacheHits_;
+      nextCachedBatch_ = 0;
+      return;
+    }
+    scanResultKey_ = std::move(key);
+  }
   // For DataCache and no cache, the stream keeps track of IO.
   auto asyncCache = dynamic_cast<cache::AsyncDataCache*>(mappedMemory_);
   // Decide between AsyncDataCache, legacy DataCache and no cache. All
   // three are supported to enable comparison.
   if (asyncCache) {
     readerOpts_.setFileNum(fileHandle_->uuid.id());
+    readerOpts_.setIoProfileTracker(fileHandle_->ioProfile);
     bufferedInputFactory_ =
         std::make_unique<dwio::common::CachedBufferedInputFactory>(
             (asyncCache),
@@ -423,7 +565,6 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
                         asyncCache ? nullptr : ioStats_.get()),
                     readerOpts_);
 
-  emptySplit_ = false;
   if (reader_->numberOfRows() == 0) {
     emptySplit_ = true;
     return;
@@ -502,9 +643,18 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
 
 std::optional<RowVectorPtr> HiveDataSource::next(
     uint64_t size,
-    velox::ContinueFuture& /*future*/) {
+    velox::ContinueFuture& future) {
   VELOX_CHECK(split_ != nullptr, "No split to process. Call addSplit first.");
+  if (cachedBatches_) {
+    if (nextCachedBatch_ < cachedBatches_->size()) {
+      return (*cachedBatches_)[nextCachedBatch_++];
+    }
+    cachedBatches_.reset();
+    resetSplit();
+    return nullptr;
+  }
   if (emptySplit_) {
+    finishScanResult();
     resetSplit();
     return nullptr;
   }
@@ -517,6 +667,14 @@ std::optional<RowVectorPtr> HiveDataSource::next(
   // column, e.g. rand() < 0.1. Evaluate that conjunct first, then scan only
   // rows that passed.
 
+  // Waits off thread while the stripe to read is being loaded by another
+  // thread.
+  auto wait = folly::SemiFuture<bool>::makeEmpty();
+  if (!rowReader_->prepareNext(&wait)) {
+    future = std::move(wait).deferValue([](bool /*unused*/) {});
+    return std::nullopt;
+  }
+
   auto rowsScanned = rowReader_->next(size, output_);
   completedRows_ += rowsScanned;
 
@@ -551,7 +709,8 @@ std::optional<RowVectorPtr> HiveDataSource::next(
     }
 
     if (outputType_->size() == 0) {
-      return exec::wrap(rowsRemaining, remainingIndices, rowVector);
+      return recordScanResult(
+          exec::wrap(rowsRemaining, remainingIndices, rowVector));
     }
 
     std::vector<VectorPtr> outputColumns;
@@ -561,16 +720,55 @@ std::optional<RowVectorPtr> HiveDataSource::next(
           rowsRemaining, remainingIndices, rowVector->childAt(i)));
     }
 
-    return std::make_shared<RowVector>(
-        pool_, outputType_, BufferPtr(nullptr), rowsRemaining, outputColumns);
+    return recordScanResult(std::make_shared<RowVector>(
+        pool_, outputType_, BufferPtr(nullptr), rowsRemaining, outputColumns));
   }
 
   rowReader_->updateRuntimeStats(runtimeStats_);
 
+  finishScanResult();
   resetSplit();
   return nullptr;
 }
 
+void HiveDataSource::setFromDataSource(std::unique_ptr<DataSource> source) {
+  auto* hiveSource = dynamic_cast<HiveDataSource*>(source.get());
+  VELOX_CHECK_NOT_NULL(hiveSource, "Wrong type of DataSource");
+  VELOX_CHECK(
+      split_ == nullptr,
+      "Previous split has not been processed yet. Call next to process the split.");
+  if (readerOpts_.getFileFormat() == dwio::common::FileFormat::UNKNOWN) {
+    readerOpts_.setFileFormat(hiveSource->readerOpts_.getFileFormat());
+  }
+  VELOX_CHECK(
+      readerOpts_.getFileFormat() == hiveSource->readerOpts_.getFileFormat(),
+      "HiveDataSource received splits of different formats: {} and {}",
+      toString(readerOpts_.getFileFormat()),
+      toString(hiveSource->readerOpts_.getFileFormat()));
+
+  split_ = std::move(hiveSource->split_);
+  emptySplit_ = hiveSource->emptySplit_;
+  // The readers read through the file handle and the IO statistics of
+  // 'source'. The IO so far is added to those of 'source'.
+  fileHandle_ = std::move(hiveSource->fileHandle_);
+  bufferedInputFactory_ = std::move(hiveSource->bufferedInputFactory_);
+  hiveSource->ioStats_->merge(*ioStats_);
+  ioStats_ = std::move(hiveSource->ioStats_);
+  runtimeStats_.skippedSplits += hiveSource->runtimeStats_.skippedSplits;
+  runtimeStats_.skippedSplitBytes +=
+      hiveSource->runtimeStats_.skippedSplitBytes;
+  // The row reader keeps the ScanSpec of 'source', which has the constant
+  // values for the split.
+  reader_ = std::move(hiveSource->reader_);
+  rowReader_ = std::move(hiveSource->rowReader_);
+  cachedBatches_ = std::move(hiveSource->cachedBatches_);
+  nextCachedBatch_ = hiveSource->nextCachedBatch_;
+  scanResultKey_ = std::move(hiveSource->scanResultKey_);
+  recordedBatches_ = std::move(hiveSource->recordedBatches_);
+  recordedBytes_ = hiveSource->recordedBytes_;
+  numScanResultCacheHits_ += hiveSource->numScanResultCacheHits_;
+}
+
 void HiveDataSource::resetSplit() {
   split_.reset();
   // Make sure to destroy Reader and RowReader in the opposite order of
@@ -579,6 +777,84 @@ void HiveDataSource::resetSplit() {
   reader_.reset();
 }
 
+std::string HiveDataSource::scanResultKey() const {
+  std::stringstream out;
+  // A changed file is recognized by its size since ReadFile does not expose
+  // a modification time. Files are expected to be immutable.
+  out << split_->filePath << " " << fileHandle_->size << " " << split_->start
+      << " " << split_->length;
+  // Partition key values and the bucket number come from the split.
+  const std::map<std::string, std::optional<std::string>> partitionKeys(
+      split_->partitionKeys.begin(), split_->partitionKeys.end());
+  for (const auto& [name, value] : partitionKeys) {
+    out << " " << name << "=" << (value.has_value() ? "'" + *value : "null");
+  }
+  if (split_->tableBucketNumber.has_value()) {
+    out << " bucket " << split_->tableBucketNumber.value();
+  }
+  out << " " << scanFingerprint_;
+  return out.str();
+}
+
+RowVectorPtr HiveDataSource::recordScanResult(RowVectorPtr output) {
+  if (scanResultKey_.empty()) {
+    return output;
+  }
+  auto copy = scanResultCache_->copy(output);
+  recordedBytes_ += copy->retainedSize();
+  if (recordedBytes_ > scanResultCache_->maxEntryBytes()) {
+    abandonScanResult();
+    return output;
+  }
+  recordedBatches_.push_back(std::move(copy));
+  return output;
+}
+
+void HiveDataSource::finishScanResult() {
+  if (!scanResultKey_.empty()) {
+    scanResultCache_->put(
+        scanResultKey_, std::move(recordedBatches_), recordedBytes_);
+  }
+  abandonScanResult();
+}
+
+void HiveDataSource::abandonScanResult() {
+  scanResultKey_.clear();
+  recordedBatches_.clear();
+  recordedBytes_ = 0;
+}
+
+bool HiveDataSource::testPartitionFilter() {
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  std::vector<VectorPtr> values;
+  names.reserve(partitionKeys_.size());
+  types.reserve(partitionKeys_.size());
+  values.reserve(partitionKeys_.size());
+  for (const auto& [name, handle] : partitionKeys_) {
+    const auto& type = handle->dataType();
+    auto it = split_->partitionKeys.find(name);
+    const auto value = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+        convertFromString,
+        type->kind(),
+        it == split_->partitionKeys.end() ? std::nullopt : it->second);
+    names.push_back(name);
+    types.push_back(type);
+    values.push_back(BaseVector::createConstant(value, 1, pool_));
+  }
+  auto input = std::make_shared<RowVector>(
+      pool_,
+      ROW(std::move(names), std::move(types)),
+      BufferPtr(nullptr),
+      1,
+      std::move(values));
+  SelectivityVector rows(1);
+  VectorPtr result;
+  expressionEvaluator_->evaluate(
+      partitionFilterExprSet_.get(), rows, input, &result);
+  return !result->isNullAt(0) && result->as<SimpleVector<bool>>()->valueAt(0);
+}
+
 vector_size_t HiveDataSource::evaluateRemainingFilter(RowVectorPtr& rowVector) {
   filterRows_.resize(output_->size());
 
@@ -632,6 +908,33 @@ std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
        {"ramReadBytes",
         RuntimeCounter(
             ioStats_->ramHit().bytes(), RuntimeCounter::Unit::kBytes)}});
+  // Batches of the top level columns by lazy or eager reading.
+  int64_t numLazyBatches = 0;
+  int64_t numLoadedLazyBatches = 0;
+  int64_t numEagerBatches = 0;
+  // The position of each filtered top level column in the filter order.
+  int64_t filterPosition = 0;
+  for (auto& child : scanSpec_->children()) {
+    auto& lazyStats = child->lazyLoadStats();
+    numLazyBatches += lazyStats.numLazyBatches;
+    numLoadedLazyBatches += lazyStats.numLoadedBatches;
+    numEagerBatches += lazyStats.numEagerBatches;
+    if (child->hasFilter()) {
+      res.insert(
+          {"filterOrder." + child->fieldName(),
+           RuntimeCounter(filterPosition++)});
+    }
+  }
+  res.insert(
+      {{"numLazyBatches", RuntimeCounter(numLazyBatches)},
+       {"numLoadedLazyBatches", RuntimeCounter(numLoadedLazyBatches)},
+       {"numEagerBatches", RuntimeCounter(numEagerBatches)},
+       {"numFilterReorders",
+        RuntimeCounter(scanSpec_->numFilterReorders())}});
+  if (scanResultCache_) {
+    res.insert(
+        {"numScanResultCacheHits", RuntimeCounter(numScanResultCacheHits_)});
+  }
   return res;
 }
 
@@ -652,10 +955,36 @@ HiveConnector::HiveConnector(
     folly::Executor* FOLLY_NULLABLE executor)
     : Connector(id, properties),
       fileHandleFactory_(
-          std::make_unique<SimpleLRUCache<std::string, FileHandle>>(
-              FLAGS_file_handle_cache_mb << 20),
-          std::make_unique<FileHandleGenerator>(std::move(properties))),
-      executor_(executor) {}
+          std::make_unique<FileHandleGenerator>(std::move(properties)),
+          static_cast<int64_t>(FLAGS_file_handle_cache_mb) << 20,
+          FLAGS_file_handle_cache_shards,
+          std::chrono::milliseconds(FLAGS_file_handle_ttl_ms)),
+      executor_(executor) {
+  if (FLAGS_hive_scan_result_cache_mb > 0) {
+    scanResultCache_ = std::make_unique<ScanResultCache>(
+        static_cast<int64_t>(FLAGS_hive_scan_result_cache_mb) << 20,
+        static_cast<int64_t>(FLAGS_hive_scan_result_cache_max_entry_mb) << 20);
+  }
+}
+
+std::optional<SplitAffinity> HiveConnector::splitAffinity(
+    const ConnectorSplit& split,
+    memory::MappedMemory* mappedMemory) const {
+  auto hiveSplit = dynamic_cast<const HiveConnectorSplit*>(&split);
+  VELOX_CHECK_NOT_NULL(hiveSplit, "Wrong type of split");
+  SplitAffinity affinity;
+  affinity.key = bits::hashMix(
+      bits::hashMix(filePathHash(hiveSplit->filePath), hiveSplit->start),
+      hiveSplit->length);
+  auto asyncCache = dynamic_cast<cache::AsyncDataCache*>(mappedMemory);
+  if (asyncCache) {
+    // A file that was never opened has no id and no cached data.
+    const auto fileNum = fileIds().id(hiveSplit->filePath);
+    affinity.isCached = fileNum != StringIdMap::kNoId &&
+        asyncCache->isFileCached(fileNum);
+  }
+  return affinity;
+}
 
 VELOX_REGISTER_CONNECTOR_FACTORY(std::make_shared<HiveConnectorFactory>())
 VELOX_REGISTER_CONNECTOR_FACTORY(
@@ -17,6 +17,7 @@
 
 #include "velox/connectors/hive/FileHandle.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
+#include "velox/connectors/hive/ScanResultCache.h"
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/dwio/common/IoStatistics.h"
 #include "velox/dwio/common/Reader.h"
@@ -104,6 +105,14 @@ class HiveInsertTableHandle : public ConnectorInsertTableHandle {
     return filePath_;
   }
 
+  // The file of a bucket is 'filePath' followed by '_' and the bucket number
+  // as 5 digits, e.g. 'path_00003' for bucket 3.
+  std::shared_ptr<ConnectorInsertTableHandle> bucketHandle(
+      int32_t bucket) const override {
+    return std::make_shared<HiveInsertTableHandle>(
+        fmt::format("{}_{:05d}", filePath_, bucket));
+  }
+
   virtual ~HiveInsertTableHandle() {}
 
  private:
@@ -121,6 +130,13 @@ class HiveDataSink : public DataSink {
 
   void close() override;
 
+  int64_t reclaimableBytes() const override;
+
+  // Flushes the current stripe of the file.
+  void reclaim() override;
+
+  std::unordered_map<std::string, RuntimeCounter> runtimeStats() override;
+
  private:
   const std::shared_ptr<const RowType> inputType_;
   std::unique_ptr<facebook::velox::dwrf::Writer> writer_;
@@ -141,7 +157,9 @@ class HiveDataSource : public DataSource {
       ExpressionEvaluator* FOLLY_NONNULL expressionEvaluator,
       memory::MappedMemory* FOLLY_NONNULL mappedMemory,
       const std::string& scanId,
-      folly::Executor* FOLLY_NULLABLE executor);
+      int32_t cacheTenant,
+      folly::Executor* FOLLY_NULLABLE executor,
+      ScanResultCache* FOLLY_NULLABLE scanResultCache = nullptr);
 
   void addSplit(std::shared_ptr<ConnectorSplit> split) override;
 
@@ -164,7 +182,18 @@ class HiveDataSource : public DataSource {
 
   int64_t estimatedRowSize() override;
 
+  void setFromDataSource(std::unique_ptr<DataSource> source) override;
+
  private:
+  // Moves the conjuncts of 'filter' that only depend on partition keys to
+  // 'partitionFilterExprSet_'. Returns the other conjuncts or nullptr if
+  // there are none.
+  core::TypedExprPtr extractPartitionFilter(const core::TypedExprPtr& filter);
+
+  // Returns true if the partition of 'split_' passes
+  // 'partitionFilterExprSet_'.
+  bool testPartitionFilter();
+
   // Evaluates remainingFilter_ on the specified vector. Returns number of rows
   // passed. Populates filterEvalCtx_.selectedIndices and selectedBits if only
   // some rows passed the filter. If none or all rows passed
@@ -187,6 +216,20 @@ class HiveDataSource : public DataSource {
   /// Clear split_, reader_ and rowReader_ after split has been fully processed.
   void resetSplit();
 
+  // Returns the key of the results of 'split_' in 'scanResultCache_'.
+  std::string scanResultKey() const;
+
+  // Adds a copy of 'output' to the results of 'split_' to cache if the split
+  // is being cached. Returns 'output'.
+  RowVectorPtr recordScanResult(RowVectorPtr output);
+
+  // Adds the results of 'split_' to 'scanResultCache_' if the split is being
+  // cached.
+  void finishScanResult();
+
+  // Stops caching the results of 'split_'.
+  void abandonScanResult();
+
   const std::shared_ptr<const RowType> outputType_;
   // Column handles for the partition key columns keyed on partition key column
   // name.
@@ -203,6 +246,9 @@ class HiveDataSource : public DataSource {
   std::unique_ptr<dwio::common::Reader> reader_;
   std::unique_ptr<dwio::common::RowReader> rowReader_;
   std::unique_ptr<exec::ExprSet> remainingFilterExprSet_;
+  // The conjuncts of the remaining filter that only depend on partition
+  // keys. Evaluated once per split instead of per row.
+  std::unique_ptr<exec::ExprSet> partitionFilterExprSet_;
   std::shared_ptr<const RowType> readerOutputType_;
   bool emptySplit_;
 
@@ -221,6 +267,22 @@ class HiveDataSource : public DataSource {
   memory::MappedMemory* const FOLLY_NONNULL mappedMemory_;
   const std::string& scanId_;
   folly::Executor* FOLLY_NULLABLE executor_;
+
+  ScanResultCache* FOLLY_NULLABLE scanResultCache_;
+  // Identifies the table, filters and projections of the scan in the keys of
+  // 'scanResultCache_'. Empty if the results can't be cached, e.g. if the
+  // remaining filter is not deterministic or there are dynamic filters.
+  std::string scanFingerprint_;
+  // The cached results of 'split_' and the index of the next one to return
+  // if the split is served from 'scanResultCache_'.
+  std::shared_ptr<const ScanResultCache::Batches> cachedBatches_;
+  size_t nextCachedBatch_{0};
+  // The key and the copies of the results of 'split_' if the split is being
+  // cached. 'scanResultKey_' is empty if the split is not being cached.
+  std::string scanResultKey_;
+  ScanResultCache::Batches recordedBatches_;
+  int64_t recordedBytes_{0};
+  uint64_t numScanResultCacheHits_{0};
 };
 
 class HiveConnector final : public Connector {
@@ -234,14 +296,18 @@ class HiveConnector final : public Connector {
     return true;
   }
 
-  std::shared_ptr<DataSource> createDataSource(
+  bool supportsSplitPreload() const override {
+    return true;
+  }
+
+  std::unique_ptr<DataSource> createDataSource(
       const std::shared_ptr<const RowType>& outputType,
       const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
       const std::unordered_map<
           std::string,
           std::shared_ptr<connector::ColumnHandle>>& columnHandles,
       ConnectorQueryCtx* FOLLY_NONNULL connectorQueryCtx) override final {
-    return std::make_shared<HiveDataSource>(
+    return std::make_unique<HiveDataSource>(
         outputType,
         tableHandle,
         columnHandles,
@@ -250,7 +316,9 @@ class HiveConnector final : public Connector {
         connectorQueryCtx->expressionEvaluator(),
         connectorQueryCtx->mappedMemory(),
         connectorQueryCtx->scanId(),
-        executor_);
+        connectorQueryCtx->cacheTenant(),
+        executor_,
+        scanResultCache_.get());
   }
 
   std::shared_ptr<DataSink> createDataSink(
@@ -268,13 +336,21 @@ class HiveConnector final : public Connector {
         connectorQueryCtx->memoryPool());
   }
 
-  folly::Executor* FOLLY_NULLABLE executor() {
+  folly::Executor* FOLLY_NULLABLE executor() const override {
     return executor_;
   }
 
+  // The key hashes the file path and byte range of the split. The split
+  // counts as cached if any part of its file is cached.
+  std::optional<SplitAffinity> splitAffinity(
+      const ConnectorSplit& split,
+      memory::MappedMemory* FOLLY_NULLABLE mappedMemory) const override;
+
  private:
   FileHandleFactory fileHandleFactory_;
   folly::Executor* FOLLY_NULLABLE executor_;
+  // Null unless FLAGS_hive_scan_result_cache_mb is set.
+  std::unique_ptr<ScanResultCache> scanResultCache_;
 
   static constexpr const char* FOLLY_NONNULL kNodeSelectionStrategy =
       "node_selection_strategy";
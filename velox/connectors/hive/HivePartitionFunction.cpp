@@ -23,19 +23,77 @@ void hashTyped(
     const DecodedVector& /* values */,
     vector_size_t /* size */,
     bool /* mix */,
-    std::vector<uint32_t>& /* hashes */) {
+    std::vector<uint32_t>& /* hashes */,
+    std::vector<uint32_t>& /* baseHashes */) {
   VELOX_UNSUPPORTED(
       "Hive partitioning function doesn't support {} type",
       TypeTraits<kind>::name);
 }
 
+void hashPrecomputed(
+    uint32_t precomputedHash,
+    vector_size_t numRows,
+    bool mix,
+    std::vector<uint32_t>& hashes) {
+  for (auto i = 0; i < numRows; ++i) {
+    hashes[i] = mix ? hashes[i] * 31 + precomputedHash : precomputedHash;
+  }
+}
+
 template <typename T, typename Func>
 void abstractHashTyped(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
     Func&& hashOne,
-    std::vector<uint32_t>& hashes) {
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
+  // A constant is hashed once.
+  if (values.isConstantMapping()) {
+    const uint32_t hash =
+        values.isNullAt(0) ? 0 : hashOne(values.valueAt<T>(0));
+    hashPrecomputed(hash, size, mix, hashes);
+    return;
+  }
+  // Flat values without nulls are hashed in loops over the raw values that
+  // the compiler can unroll and vectorize. Flat booleans are bits and can't
+  // be read as an array of T.
+  if constexpr (!std::is_same_v<T, bool>) {
+    if (values.isIdentityMapping() && !values.mayHaveNulls()) {
+      const auto* rawValues = values.data<T>();
+      if (mix) {
+        for (auto i = 0; i < size; ++i) {
+          hashes[i] = hashes[i] * 31 + hashOne(rawValues[i]);
+        }
+      } else {
+        for (auto i = 0; i < size; ++i) {
+          hashes[i] = hashOne(rawValues[i]);
+        }
+      }
+      return;
+    }
+    // A dictionary with fewer distinct entries than rows hashes each entry
+    // of its base once and looks the hashes up by index.
+    const auto baseSize = values.base()->size();
+    if (!values.isIdentityMapping() && baseSize < size) {
+      const auto* rawValues = values.data<T>();
+      const auto* baseNulls = values.base()->rawNulls();
+      if (baseHashes.size() < baseSize) {
+        baseHashes.resize(baseSize);
+      }
+      for (auto i = 0; i < baseSize; ++i) {
+        baseHashes[i] = (baseNulls && bits::isBitNull(baseNulls, i))
+            ? 0
+            : hashOne(rawValues[i]);
+      }
+      for (auto i = 0; i < size; ++i) {
+        const uint32_t hash =
+            values.isNullAt(i) ? 0 : baseHashes[values.index(i)];
+        hashes[i] = mix ? hashes[i] * 31 + hash : hash;
+      }
+      return;
+    }
+  }
   for (auto i = 0; i < size; ++i) {
     const uint32_t hash =
         (values.isNullAt(i)) ? 0 : hashOne(values.valueAt<T>(i));
@@ -48,9 +106,10 @@ void hashTyped<TypeKind::BOOLEAN>(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
   auto hashBool = [](bool value) { return value ? 1 : 0; };
-  abstractHashTyped<bool>(values, size, mix, hashBool, hashes);
+  abstractHashTyped<bool>(values, size, mix, hashBool, hashes, baseHashes);
 }
 
 template <>
@@ -58,9 +117,10 @@ void hashTyped<TypeKind::TINYINT>(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
   auto hashTinyint = [](int8_t value) { return static_cast<uint32_t>(value); };
-  abstractHashTyped<int8_t>(values, size, mix, hashTinyint, hashes);
+  abstractHashTyped<int8_t>(values, size, mix, hashTinyint, hashes, baseHashes);
 }
 
 template <>
@@ -68,11 +128,13 @@ void hashTyped<TypeKind::SMALLINT>(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
   auto hashSmallint = [](int16_t value) {
     return static_cast<uint32_t>(value);
   };
-  abstractHashTyped<int16_t>(values, size, mix, hashSmallint, hashes);
+  abstractHashTyped<int16_t>(
+      values, size, mix, hashSmallint, hashes, baseHashes);
 }
 
 template <>
@@ -80,9 +142,11 @@ void hashTyped<TypeKind::INTEGER>(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
   auto hashInteger = [](int32_t value) { return static_cast<uint32_t>(value); };
-  abstractHashTyped<int32_t>(values, size, mix, hashInteger, hashes);
+  abstractHashTyped<int32_t>(
+      values, size, mix, hashInteger, hashes, baseHashes);
 }
 
 template <>
@@ -90,8 +154,9 @@ void hashTyped<TypeKind::REAL>(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
-  hashTyped<TypeKind::INTEGER>(values, size, mix, hashes);
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
+  hashTyped<TypeKind::INTEGER>(values, size, mix, hashes, baseHashes);
 }
 
 int32_t hashInt64(int64_t value) {
@@ -103,8 +168,9 @@ void hashTyped<TypeKind::BIGINT>(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
-  abstractHashTyped<int64_t>(values, size, mix, hashInt64, hashes);
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
+  abstractHashTyped<int64_t>(values, size, mix, hashInt64, hashes, baseHashes);
 }
 
 template <>
@@ -112,8 +178,9 @@ void hashTyped<TypeKind::DOUBLE>(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
-  hashTyped<TypeKind::BIGINT>(values, size, mix, hashes);
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
+  hashTyped<TypeKind::BIGINT>(values, size, mix, hashes, baseHashes);
 }
 
 #if defined(__has_feature)
@@ -135,11 +202,13 @@ void hashTypedStringView(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
   auto hashStringView = [](const StringView& value) {
     return hashBytes(value, 0);
   };
-  abstractHashTyped<StringView>(values, size, mix, hashStringView, hashes);
+  abstractHashTyped<StringView>(
+      values, size, mix, hashStringView, hashes, baseHashes);
 }
 
 template <>
@@ -147,8 +216,9 @@ void hashTyped<TypeKind::VARCHAR>(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
-  hashTypedStringView(values, size, mix, hashes);
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
+  hashTypedStringView(values, size, mix, hashes, baseHashes);
 }
 
 template <>
@@ -156,8 +226,9 @@ void hashTyped<TypeKind::VARBINARY>(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
-  hashTypedStringView(values, size, mix, hashes);
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
+  hashTypedStringView(values, size, mix, hashes, baseHashes);
 }
 
 int32_t hashTimestamp(const Timestamp& ts) {
@@ -169,8 +240,10 @@ void hashTyped<TypeKind::TIMESTAMP>(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
-  abstractHashTyped<Timestamp>(values, size, mix, hashTimestamp, hashes);
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
+  abstractHashTyped<Timestamp>(
+      values, size, mix, hashTimestamp, hashes, baseHashes);
 }
 
 template <>
@@ -178,9 +251,10 @@ void hashTyped<TypeKind::DATE>(
     const DecodedVector& values,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
   auto hashDate = [](const Date& value) { return value.days(); };
-  abstractHashTyped<Date>(values, size, mix, hashDate, hashes);
+  abstractHashTyped<Date>(values, size, mix, hashDate, hashes, baseHashes);
 }
 
 void hash(
@@ -188,7 +262,8 @@ void hash(
     TypeKind typeKind,
     vector_size_t size,
     bool mix,
-    std::vector<uint32_t>& hashes) {
+    std::vector<uint32_t>& hashes,
+    std::vector<uint32_t>& baseHashes) {
   // This function mirrors the behavior of function hashCode in
   // HIVE-12025 ba83fd7bff
   // serde/src/java/org/apache/hadoop/hive/serde2/objectinspector/ObjectInspectorUtils.java
@@ -197,18 +272,10 @@ void hash(
   // HIVE-7148 proposed change to bucketing hash algorithms. If that gets
   // implemented, this function will need to change significantly.
 
-  VELOX_DYNAMIC_TYPE_DISPATCH(hashTyped, typeKind, values, size, mix, hashes);
+  VELOX_DYNAMIC_TYPE_DISPATCH(
+      hashTyped, typeKind, values, size, mix, hashes, baseHashes);
 }
 
-void hashPrecomputed(
-    uint32_t precomputedHash,
-    vector_size_t numRows,
-    bool mix,
-    std::vector<uint32_t>& hashes) {
-  for (auto i = 0; i < numRows; ++i) {
-    hashes[i] = mix ? hashes[i] * 31 + precomputedHash : precomputedHash;
-  }
-}
 } // namespace
 
 HivePartitionFunction::HivePartitionFunction(
@@ -217,6 +284,7 @@ HivePartitionFunction::HivePartitionFunction(
     std::vector<column_index_t> keyChannels,
     const std::vector<VectorPtr>& constValues)
     : numBuckets_{numBuckets},
+      bucketReciprocal_{UINT64_C(0xFFFFFFFFFFFFFFFF) / numBuckets + 1},
       bucketToPartition_{bucketToPartition},
       keyChannels_{std::move(keyChannels)} {
   decodedVectors_.resize(keyChannels_.size());
@@ -248,7 +316,8 @@ void HivePartitionFunction::partition(
           keyVector->typeKind(),
           keyVector->size(),
           i > 0,
-          hashes_);
+          hashes_,
+          baseHashes_);
     } else {
       hashPrecomputed(precomputedHashes_[i], numRows, i > 0, hashes_);
     }
@@ -256,9 +325,15 @@ void HivePartitionFunction::partition(
 
   static const int32_t kInt32Max = std::numeric_limits<int32_t>::max();
 
+  // The modulo by 'numBuckets_' is a multiply by its precomputed reciprocal
+  // instead of a division. See Lemire et al., "Faster Remainder by Direct
+  // Computation".
   for (auto i = 0; i < numRows; ++i) {
-    partitions[i] =
-        bucketToPartition_[((hashes_[i] & kInt32Max) % numBuckets_)];
+    const uint32_t hash = hashes_[i] & kInt32Max;
+    const uint64_t lowBits = bucketReciprocal_ * hash;
+    const auto bucket = static_cast<uint32_t>(
+        (static_cast<__uint128_t>(lowBits) * numBuckets_) >> 64);
+    partitions[i] = bucketToPartition_[bucket];
   }
 }
 
@@ -274,7 +349,13 @@ void HivePartitionFunction::precompute(
   decodedVectors_[channelIndex].decode(value, rows);
 
   std::vector<uint32_t> hashes{1};
-  hash(decodedVectors_[channelIndex], value.typeKind(), 1, false, hashes);
+  hash(
+      decodedVectors_[channelIndex],
+      value.typeKind(),
+      1,
+      false,
+      hashes,
+      baseHashes_);
   precomputedHashes_[channelIndex] = hashes[0];
 }
 
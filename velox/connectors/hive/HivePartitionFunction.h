@@ -38,11 +38,16 @@ class HivePartitionFunction : public core::PartitionFunction {
   void precompute(const BaseVector& value, size_t column_index_t);
 
   const int numBuckets_;
+  // 2^64 / 'numBuckets_', rounded up, for computing the modulo by
+  // 'numBuckets_' without a division.
+  const uint64_t bucketReciprocal_;
   const std::vector<int> bucketToPartition_;
   const std::vector<column_index_t> keyChannels_;
 
   // Reusable memory.
   std::vector<uint32_t> hashes_;
+  // Hashes of the distinct values of a dictionary-encoded key.
+  std::vector<uint32_t> baseHashes_;
   SelectivityVector rows_;
   std::vector<DecodedVector> decodedVectors_;
   // Precomputed hashes for constant partition keys (one per key).
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/connectors/hive/ScanResultCache.h"
+
+namespace facebook::velox::connector::hive {
+
+ScanResultCache::ScanResultCache(int64_t maxBytes, int64_t maxEntryBytes)
+    : maxEntryBytes_(maxEntryBytes),
+      pool_(memory::getDefaultScopedMemoryPool()),
+      cache_(maxBytes) {
+  VELOX_CHECK_GT(maxBytes, 0);
+  VELOX_CHECK_GT(maxEntryBytes, 0);
+}
+
+ScanResultCache::~ScanResultCache() = default;
+
+std::shared_ptr<const ScanResultCache::Batches> ScanResultCache::find(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto* batches = cache_.get(key);
+  if (!batches) {
+    ++numMisses_;
+    return nullptr;
+  }
+  ++numHits_;
+  // The copy of the shared_ptr keeps the batches alive if they are evicted
+  // while being read, so the entry need not stay pinned.
+  auto result = *batches;
+  cache_.release(key);
+  return result;
+}
+
+void ScanResultCache::put(
+    const std::string& key,
+    Batches batches,
+    int64_t bytes) {
+  if (bytes > maxEntryBytes_) {
+    return;
+  }
+  auto value = std::make_unique<std::shared_ptr<const Batches>>(
+      std::make_shared<const Batches>(std::move(batches)));
+  std::lock_guard<std::mutex> l(mutex_);
+  if (cache_.add(key, value.get(), bytes)) {
+    value.release();
+  }
+}
+
+RowVectorPtr ScanResultCache::copy(const RowVectorPtr& input) {
+  const auto size = input->size();
+  std::vector<VectorPtr> children;
+  children.reserve(input->childrenSize());
+  for (auto i = 0; i < input->childrenSize(); ++i) {
+    auto child = BaseVector::loadedVectorShared(input->childAt(i));
+    auto childCopy = BaseVector::create(child->type(), size, pool_.get());
+    childCopy->copy(child.get(), 0, 0, size);
+    children.push_back(std::move(childCopy));
+  }
+  return std::make_shared<RowVector>(
+      pool_.get(), input->type(), BufferPtr(nullptr), size, children);
+}
+
+ScanResultCache::Stats ScanResultCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  Stats stats;
+  stats.numHits = numHits_;
+  stats.numMisses = numMisses_;
+  stats.bytes = cache_.currentSize();
+  return stats;
+}
+
+} // namespace facebook::velox::connector::hive
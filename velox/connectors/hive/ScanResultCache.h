@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::connector::hive {
+
+/// Caches the filtered and projected output of the scans of splits so that
+/// repeated scans of immutable files with the same filters and projections
+/// are served without reading and decoding the file. The key identifies the
+/// split, the version of its file and the scan, see
+/// HiveDataSource::scanResultKey(). The cached vectors are compact flat
+/// copies allocated from a memory pool owned by the cache. Entries are
+/// evicted least recently used first when the retained size of the cached
+/// vectors exceeds 'maxBytes'. Thread safe.
+class ScanResultCache {
+ public:
+  using Batches = std::vector<RowVectorPtr>;
+
+  struct Stats {
+    int64_t numHits{0};
+    int64_t numMisses{0};
+    // Retained size of the cached vectors.
+    int64_t bytes{0};
+  };
+
+  /// Caches up to 'maxBytes' of vectors. The results of a split larger than
+  /// 'maxEntryBytes' are not cached.
+  ScanResultCache(int64_t maxBytes, int64_t maxEntryBytes);
+
+  ~ScanResultCache();
+
+  /// Returns the batches cached for 'key' or nullptr if there are none. The
+  /// returned batches stay valid after they are evicted.
+  std::shared_ptr<const Batches> find(const std::string& key);
+
+  /// Caches 'batches' of total retained size 'bytes' for 'key'. The vectors
+  /// must come from copy(). Does nothing if 'key' is already cached or
+  /// 'bytes' exceeds maxEntryBytes().
+  void put(const std::string& key, Batches batches, int64_t bytes);
+
+  /// Returns a flat copy of 'input' allocated from the pool of the cache.
+  /// Loads lazy vectors.
+  RowVectorPtr copy(const RowVectorPtr& input);
+
+  int64_t maxEntryBytes() const {
+    return maxEntryBytes_;
+  }
+
+  Stats stats() const;
+
+ private:
+  const int64_t maxEntryBytes_;
+  std::unique_ptr<memory::MemoryPool> pool_;
+
+  mutable std::mutex mutex_;
+  SimpleLRUCache<std::string, std::shared_ptr<const Batches>> cache_;
+  int64_t numHits_{0};
+  int64_t numMisses_{0};
+};
+
+} // namespace facebook::velox::connector::hive
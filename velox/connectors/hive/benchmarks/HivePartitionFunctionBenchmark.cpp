@@ -17,6 +17,7 @@
 #include <folly/init/Init.h>
 #include "velox/connectors/hive/HivePartitionFunction.h"
 #include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/sparksql/Hash.h"
 #include "velox/type/Type.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
@@ -42,6 +43,17 @@ constexpr std::array<TypeKind, 10> kSupportedTypes{
     TypeKind::TIMESTAMP,
     TypeKind::DATE};
 
+// The types of kSupportedTypes that Spark's hash() supports.
+constexpr std::array<TypeKind, 8> kSparkHashTypes{
+    TypeKind::BOOLEAN,
+    TypeKind::TINYINT,
+    TypeKind::SMALLINT,
+    TypeKind::INTEGER,
+    TypeKind::BIGINT,
+    TypeKind::REAL,
+    TypeKind::DOUBLE,
+    TypeKind::VARCHAR};
+
 class HivePartitionFunctionBenchmark
     : public functions::test::FunctionBenchmarkBase {
  public:
@@ -58,10 +70,47 @@ class HivePartitionFunctionBenchmark
       rowVectors_[typeKind] = vm.rowVector({flatVector});
     }
 
+    // Dictionaries over few distinct values, as produced by scans of
+    // dictionary-encoded columns, and a multi-column key.
+    auto indices = AlignedBuffer::allocate<vector_size_t>(vectorSize, pool());
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < vectorSize; ++i) {
+      rawIndices[i] = i % kNumDistinctValues;
+    }
+    auto dictionaryBigint = BaseVector::wrapInDictionary(
+        nullptr,
+        indices,
+        vectorSize,
+        fuzzer.fuzzFlat(BIGINT(), kNumDistinctValues));
+    auto dictionaryVarchar = BaseVector::wrapInDictionary(
+        nullptr,
+        indices,
+        vectorSize,
+        fuzzer.fuzzFlat(VARCHAR(), kNumDistinctValues));
+    dictionaryRowVectors_[TypeKind::BIGINT] = vm.rowVector({dictionaryBigint});
+    dictionaryRowVectors_[TypeKind::VARCHAR] =
+        vm.rowVector({dictionaryVarchar});
+    multiColumnRowVector_ = vm.rowVector(
+        {rowVectors_[TypeKind::BIGINT]->childAt(0),
+         rowVectors_[TypeKind::VARCHAR]->childAt(0),
+         dictionaryVarchar,
+         rowVectors_[TypeKind::INTEGER]->childAt(0)});
+    multiColumnFunction_ = createHivePartitionFunction(100, 4);
+
     // Prepare HivePartitionFunction
     fewBucketsFunction_ = createHivePartitionFunction(20);
     manyBucketsFunction_ = createHivePartitionFunction(100);
 
+    // Prepare the Spark hash over the same data for comparison.
+    exec::registerStatefulVectorFunction(
+        "spark_hash",
+        functions::sparksql::hashSignatures(),
+        functions::sparksql::makeHash);
+    for (auto typeKind : kSparkHashTypes) {
+      sparkHashExprs_[typeKind] = std::make_unique<exec::ExprSet>(
+          compileExpression("spark_hash(c0)", rowVectors_[typeKind]->type()));
+    }
+
     partitions_.resize(vectorSize);
   }
 
@@ -75,13 +124,37 @@ class HivePartitionFunctionBenchmark
     run<KIND>(manyBucketsFunction_.get());
   }
 
+  template <TypeKind KIND>
+  void runDictionary() {
+    manyBucketsFunction_->partition(
+        *dictionaryRowVectors_.at(KIND), partitions_);
+  }
+
+  template <TypeKind KIND>
+  void runFlat() {
+    manyBucketsFunction_->partition(*rowVectors_.at(KIND), partitions_);
+  }
+
+  void runMultiColumn() {
+    multiColumnFunction_->partition(*multiColumnRowVector_, partitions_);
+  }
+
+  template <TypeKind KIND>
+  void runSparkHash() {
+    folly::doNotOptimizeAway(
+        evaluate(*sparkHashExprs_.at(KIND), rowVectors_[KIND]));
+  }
+
  private:
+  static constexpr vector_size_t kNumDistinctValues = 64;
+
   std::unique_ptr<HivePartitionFunction> createHivePartitionFunction(
-      size_t bucketCount) {
+      size_t bucketCount,
+      column_index_t numKeys = 1) {
     std::vector<int> bucketToPartition(bucketCount);
     std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
-    std::vector<column_index_t> keyChannels;
-    keyChannels.emplace_back(0);
+    std::vector<column_index_t> keyChannels(numKeys);
+    std::iota(keyChannels.begin(), keyChannels.end(), 0);
     return std::make_unique<HivePartitionFunction>(
         bucketCount, bucketToPartition, keyChannels);
   }
@@ -96,8 +169,13 @@ class HivePartitionFunctionBenchmark
   }
 
   std::unordered_map<TypeKind, RowVectorPtr> rowVectors_;
+  std::unordered_map<TypeKind, RowVectorPtr> dictionaryRowVectors_;
+  RowVectorPtr multiColumnRowVector_;
   std::unique_ptr<HivePartitionFunction> fewBucketsFunction_;
   std::unique_ptr<HivePartitionFunction> manyBucketsFunction_;
+  std::unique_ptr<HivePartitionFunction> multiColumnFunction_;
+  std::unordered_map<TypeKind, std::unique_ptr<exec::ExprSet>>
+      sparkHashExprs_;
   std::vector<uint32_t> partitions_;
 };
 
@@ -282,6 +360,66 @@ BENCHMARK_RELATIVE(dateManyRowsManyBuckets) {
   benchmarkMany->runMany<TypeKind::DATE>();
 }
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(bigintManyRowsFlat) {
+  benchmarkMany->runFlat<TypeKind::BIGINT>();
+}
+
+BENCHMARK_RELATIVE(bigintManyRowsDictionary) {
+  benchmarkMany->runDictionary<TypeKind::BIGINT>();
+}
+
+BENCHMARK(varcharManyRowsFlat) {
+  benchmarkMany->runFlat<TypeKind::VARCHAR>();
+}
+
+BENCHMARK_RELATIVE(varcharManyRowsDictionary) {
+  benchmarkMany->runDictionary<TypeKind::VARCHAR>();
+}
+
+BENCHMARK(multiColumnFewRows) {
+  benchmarkFew->runMultiColumn();
+}
+
+BENCHMARK(multiColumnManyRows) {
+  benchmarkMany->runMultiColumn();
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(integerManyRowsHive) {
+  benchmarkMany->runFew<TypeKind::INTEGER>();
+}
+
+BENCHMARK_RELATIVE(integerManyRowsSparkHash) {
+  benchmarkMany->runSparkHash<TypeKind::INTEGER>();
+}
+
+BENCHMARK(bigintManyRowsHive) {
+  benchmarkMany->runFew<TypeKind::BIGINT>();
+}
+
+BENCHMARK_RELATIVE(bigintManyRowsSparkHash) {
+  benchmarkMany->runSparkHash<TypeKind::BIGINT>();
+}
+
+BENCHMARK(doubleManyRowsHive) {
+  benchmarkMany->runFew<TypeKind::DOUBLE>();
+}
+
+BENCHMARK_RELATIVE(doubleManyRowsSparkHash) {
+  benchmarkMany->runSparkHash<TypeKind::DOUBLE>();
+}
+
+BENCHMARK(varcharManyRowsHive) {
+  benchmarkMany->runFew<TypeKind::VARCHAR>();
+}
+
+BENCHMARK_RELATIVE(varcharManyRowsSparkHash) {
+  benchmarkMany->runSparkHash<TypeKind::VARCHAR>();
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
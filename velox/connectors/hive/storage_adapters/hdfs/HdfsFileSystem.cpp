@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "HdfsFileSystem.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <hdfs/hdfs.h>
 #include "HdfsReadFile.h"
 #include "velox/common/file/FileSystems.h"
@@ -30,14 +31,40 @@ class HdfsFileSystem::Impl {
     auto builder = hdfsNewBuilder();
     hdfsBuilderSetNameNode(builder, endpointInfo.host.c_str());
     hdfsBuilderSetNameNodePort(builder, endpointInfo.port);
+    // Reads the blocks on this host from the local disk instead of through
+    // the datanode. Needs the domain socket the datanode listens on.
+    const auto socketPath =
+        config->get<std::string>("hive.hdfs.domain-socket-path", "");
+    if (!socketPath.empty()) {
+      hdfsBuilderConfSetStr(
+          builder, "dfs.domain.socket.path", socketPath.c_str());
+      hdfsBuilderConfSetStr(
+          builder,
+          "dfs.client.read.shortcircuit",
+          config->get<bool>("hive.hdfs.short-circuit-read", true) ? "true"
+                                                                  : "false");
+    }
     hdfsClient_ = hdfsBuilderConnect(builder);
     VELOX_CHECK_NOT_NULL(
         hdfsClient_,
         "Unable to connect to HDFS, got error: {}.",
         hdfsGetLastError())
+
+    // A read slower than this is raced against a duplicate read. 0 disables
+    // hedging.
+    hedgeDelay_ = std::chrono::milliseconds(
+        config->get<int64_t>("hive.hdfs.hedged-read-delay-ms", 0));
+    if (hedgeDelay_.count() > 0) {
+      hedgeExecutor_ = std::make_shared<folly::CPUThreadPoolExecutor>(
+          config->get<int32_t>("hive.hdfs.hedged-read-threads", 16));
+    }
   }
 
   ~Impl() {
+    if (hedgeExecutor_) {
+      // The reads that lost a race may still be using the client.
+      hedgeExecutor_->join();
+    }
     LOG(INFO) << "Disconnecting HDFS file system";
     int disconnectResult = hdfsDisconnect(hdfsClient_);
     if (disconnectResult != 0) {
@@ -63,8 +90,20 @@ class HdfsFileSystem::Impl {
     return hdfsClient_;
   }
 
+  std::shared_ptr<folly::Executor> hedgeExecutor() const {
+    return hedgeExecutor_;
+  }
+
+  std::chrono::milliseconds hedgeDelay() const {
+    return hedgeDelay_;
+  }
+
  private:
   hdfsFS hdfsClient_;
+  std::chrono::milliseconds hedgeDelay_{0};
+  // Runs the reads of the files when hedging, so that a slow read can be
+  // waited for with a timeout.
+  std::shared_ptr<folly::CPUThreadPoolExecutor> hedgeExecutor_;
 };
 
 HdfsFileSystem::HdfsFileSystem(const std::shared_ptr<const Config>& config)
@@ -76,6 +115,11 @@ std::string HdfsFileSystem::name() const {
   return "HDFS";
 }
 
+IoProfile HdfsFileSystem::ioProfile() const {
+  // A disaggregated disk: 5ms to the first byte, then 100MB/s.
+  return {5000, 100};
+}
+
 std::unique_ptr<ReadFile> HdfsFileSystem::openFileForRead(
     std::string_view path) {
   if (path.find(kScheme) == 0) {
@@ -85,7 +129,8 @@ std::unique_ptr<ReadFile> HdfsFileSystem::openFileForRead(
     path.remove_prefix(index);
   }
 
-  return std::make_unique<HdfsReadFile>(impl_->hdfsClient(), path);
+  return std::make_unique<HdfsReadFile>(
+      impl_->hdfsClient(), path, impl_->hedgeExecutor(), impl_->hedgeDelay());
 }
 
 std::unique_ptr<WriteFile> HdfsFileSystem::openFileForWrite(
@@ -27,6 +27,15 @@ struct HdfsServiceEndpoint {
  * or "hdfs-client.xml" in working directory.
  *
  * Internally you can use hdfsBuilderConfSetStr to configure the client
+ *
+ * Besides the host and port, the config may set:
+ * - hive.hdfs.domain-socket-path: the domain socket of the local datanode.
+ *   Enables short-circuit reads of the blocks on this host unless
+ *   hive.hdfs.short-circuit-read is false.
+ * - hive.hdfs.hedged-read-delay-ms: a read slower than this is raced against
+ *   a duplicate read, which may go to another replica. 0, the default,
+ *   disables hedging.
+ * - hive.hdfs.hedged-read-threads: the threads running hedged reads.
  */
 class HdfsFileSystem : public FileSystem {
  private:
@@ -37,6 +46,8 @@ class HdfsFileSystem : public FileSystem {
 
   std::string name() const override;
 
+  IoProfile ioProfile() const override;
+
   std::unique_ptr<ReadFile> openFileForRead(std::string_view path) override;
 
   std::unique_ptr<WriteFile> openFileForWrite(std::string_view path) override;
@@ -15,52 +15,128 @@
  */
 
 #include "HdfsReadFile.h"
+#include <folly/futures/Future.h>
 #include <folly/synchronization/CallOnce.h>
 #include <hdfs/hdfs.h>
+#include <array>
 
 namespace facebook::velox {
 
-HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
-    : hdfsClient_(hdfs), filePath_(path) {
-  fileInfo_ = hdfsGetPathInfo(hdfsClient_, filePath_.data());
+namespace {
+hdfsFile openFile(hdfsFS hdfs, const std::string& path) {
+  auto file = hdfsOpenFile(hdfs, path.data(), O_RDONLY, 0, 0, 0);
   VELOX_CHECK_NOT_NULL(
-      fileInfo_,
-      "Unable to get file path info for file: {}. got error: {}",
-      filePath_,
-      hdfsGetLastError());
+      file, "Unable to open file {}. got error: {}", path, hdfsGetLastError());
+  return file;
 }
 
-void HdfsReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
-    const {
-  checkFileReadParameters(offset, length);
-  auto file = hdfsOpenFile(hdfsClient_, filePath_.data(), O_RDONLY, 0, 0, 0);
-  VELOX_CHECK_NOT_NULL(
-      file,
-      "Unable to open file {}. got error: {}",
-      filePath_,
-      hdfsGetLastError());
-  seekToPosition(file, offset);
+void closeFile(hdfsFS hdfs, hdfsFile file) {
+  if (hdfsCloseFile(hdfs, file) == -1) {
+    LOG(ERROR) << "Unable to close file, errno: " << errno;
+  }
+}
+
+void seekToPosition(
+    hdfsFS hdfs,
+    hdfsFile file,
+    const std::string& path,
+    uint64_t offset) {
+  auto seekStatus = hdfsSeek(hdfs, file, offset);
+  VELOX_CHECK_EQ(
+      seekStatus,
+      0,
+      "Cannot seek through HDFS file: {}, error: {}",
+      path,
+      std::string(hdfsGetLastError()));
+}
+
+void readFully(hdfsFS hdfs, hdfsFile file, uint64_t length, char* pos) {
   uint64_t totalBytesRead = 0;
   while (totalBytesRead < length) {
-    auto bytesRead = hdfsRead(hdfsClient_, file, pos, length - totalBytesRead);
+    auto bytesRead = hdfsRead(hdfs, file, pos, length - totalBytesRead);
     VELOX_CHECK(bytesRead >= 0, "Read failure in HDFSReadFile::preadInternal.")
     totalBytesRead += bytesRead;
     pos += bytesRead;
   }
+}
 
-  if (hdfsCloseFile(hdfsClient_, file) == -1) {
-    LOG(ERROR) << "Unable to close file, errno: " << errno;
+// Opens 'path', reads 'length' bytes at 'offset' into 'pos' and closes the
+// file.
+void readRange(
+    hdfsFS hdfs,
+    const std::string& path,
+    uint64_t offset,
+    uint64_t length,
+    char* pos) {
+  auto file = openFile(hdfs, path);
+  try {
+    seekToPosition(hdfs, file, path, offset);
+    readFully(hdfs, file, length, pos);
+  } catch (const std::exception&) {
+    closeFile(hdfs, file);
+    throw;
   }
+  closeFile(hdfs, file);
 }
+} // namespace
 
-void HdfsReadFile::seekToPosition(hdfsFile file, uint64_t offset) const {
-  auto seekStatus = hdfsSeek(hdfsClient_, file, offset);
-  VELOX_CHECK_EQ(
-      seekStatus,
-      0,
-      "Cannot seek through HDFS file: {}, error: {}",
+HdfsReadFile::HdfsReadFile(
+    hdfsFS hdfs,
+    const std::string_view path,
+    std::shared_ptr<folly::Executor> hedgeExecutor,
+    std::chrono::milliseconds hedgeDelay)
+    : hdfsClient_(hdfs),
+      filePath_(path),
+      hedgeExecutor_(std::move(hedgeExecutor)),
+      hedgeDelay_(hedgeDelay) {
+  fileInfo_ = hdfsGetPathInfo(hdfsClient_, filePath_.data());
+  VELOX_CHECK_NOT_NULL(
+      fileInfo_,
+      "Unable to get file path info for file: {}. got error: {}",
       filePath_,
-      std::string(hdfsGetLastError()));
+      hdfsGetLastError());
+}
+
+void HdfsReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
+    const {
+  checkFileReadParameters(offset, length);
+  if (hedgeExecutor_) {
+    preadHedged(offset, length, pos);
+    return;
+  }
+  readRange(hdfsClient_, filePath_, offset, length, pos);
+}
+
+void HdfsReadFile::preadHedged(uint64_t offset, uint64_t length, char* pos)
+    const {
+  // The reads go to buffers of their own since the read that loses keeps
+  // running after this returns.
+  auto buffers = std::make_shared<std::array<std::unique_ptr<char[]>, 2>>();
+  auto startRead = [&](int32_t index) {
+    (*buffers)[index] = std::make_unique<char[]>(length);
+    return folly::via(
+        hedgeExecutor_.get(),
+        [hdfs = hdfsClient_,
+         path = filePath_,
+         offset,
+         length,
+         buffers,
+         buffer = (*buffers)[index].get(),
+         index]() {
+          readRange(hdfs, path, offset, length, buffer);
+          return index;
+        });
+  };
+  std::vector<folly::Future<int32_t>> reads;
+  reads.push_back(startRead(0));
+  reads.back().wait(hedgeDelay_);
+  if (!reads.back().isReady()) {
+    reads.push_back(startRead(1));
+  }
+  // Throws the error of the last read if all fail.
+  const auto winner =
+      folly::collectAnyWithoutException(std::move(reads)).get().second;
+  memcpy(pos, (*buffers)[winner].get(), length);
 }
 
 std::string_view
@@ -76,6 +152,39 @@ std::string HdfsReadFile::pread(uint64_t offset, uint64_t length) const {
   return result;
 }
 
+uint64_t HdfsReadFile::preadv(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  uint64_t length = 0;
+  for (const auto& range : buffers) {
+    length += range.size();
+  }
+  checkFileReadParameters(offset, length);
+  auto file = openFile(hdfsClient_, filePath_);
+  try {
+    seekToPosition(hdfsClient_, file, filePath_, offset);
+    std::vector<char> droppedBytes;
+    auto position = offset;
+    for (const auto& range : buffers) {
+      if (range.data()) {
+        readFully(hdfsClient_, file, range.size(), range.data());
+      } else if (range.size() > kMaxReadThroughGap) {
+        seekToPosition(
+            hdfsClient_, file, filePath_, position + range.size());
+      } else {
+        droppedBytes.resize(std::max(droppedBytes.size(), range.size()));
+        readFully(hdfsClient_, file, range.size(), droppedBytes.data());
+      }
+      position += range.size();
+    }
+  } catch (const std::exception&) {
+    closeFile(hdfsClient_, file);
+    throw;
+  }
+  closeFile(hdfsClient_, file);
+  return length;
+}
+
 uint64_t HdfsReadFile::size() const {
   return fileInfo_->mSize;
 }
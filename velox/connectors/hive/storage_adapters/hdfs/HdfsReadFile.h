@@ -14,20 +14,38 @@
  * limitations under the License.
  */
 
+#include <folly/Executor.h>
 #include <hdfs/hdfs.h>
+#include <chrono>
 #include "velox/common/file/File.h"
 
 namespace facebook::velox {
 
+// Reads a file through libhdfs3. If 'hedgeExecutor' is set, a pread that
+// has not finished after 'hedgeDelay' is raced against a duplicate read on
+// 'hedgeExecutor'. The duplicate opens the file again, so libhdfs3 may serve
+// it from another replica, e.g. after the first read's datanode was marked
+// bad.
 class HdfsReadFile final : public ReadFile {
  public:
-  explicit HdfsReadFile(hdfsFS hdfs, std::string_view path);
+  explicit HdfsReadFile(
+      hdfsFS hdfs,
+      std::string_view path,
+      std::shared_ptr<folly::Executor> hedgeExecutor = nullptr,
+      std::chrono::milliseconds hedgeDelay = std::chrono::milliseconds(0));
 
   std::string_view pread(uint64_t offset, uint64_t length, void* buf)
       const final;
 
   std::string pread(uint64_t offset, uint64_t length) const final;
 
+  // Reads the ranges with one open and forward seeks. Gaps of up to
+  // kMaxReadThroughGap bytes are read and dropped instead since a seek may
+  // connect to the datanode again.
+  uint64_t preadv(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
   uint64_t size() const final;
 
   uint64_t memoryUsage() const final;
@@ -35,11 +53,15 @@ class HdfsReadFile final : public ReadFile {
   bool shouldCoalesce() const final;
 
  private:
+  static constexpr uint64_t kMaxReadThroughGap = 512 << 10;
+
   void preadInternal(uint64_t offset, uint64_t length, char* pos) const;
-  void seekToPosition(hdfsFile file, uint64_t offset) const;
+  void preadHedged(uint64_t offset, uint64_t length, char* pos) const;
   void checkFileReadParameters(uint64_t offset, uint64_t length) const;
   hdfsFS hdfsClient_;
   hdfsFileInfo* fileInfo_;
   std::string filePath_;
+  const std::shared_ptr<folly::Executor> hedgeExecutor_;
+  const std::chrono::milliseconds hedgeDelay_;
 };
 } // namespace facebook::velox
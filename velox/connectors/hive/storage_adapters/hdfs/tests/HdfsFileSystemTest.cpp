@@ -16,6 +16,7 @@
 #include "velox/connectors/hive/storage_adapters/hdfs/HdfsFileSystem.h"
 #include <boost/format.hpp>
 #include <connectors/hive/storage_adapters/hdfs/HdfsReadFile.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gmock/gmock-matchers.h>
 #include <hdfs/hdfs.h>
 #include <atomic>
@@ -164,6 +165,51 @@ TEST_F(HdfsFileSystemTest, read) {
   readData(&readFile);
 }
 
+TEST_F(HdfsFileSystemTest, preadv) {
+  struct hdfsBuilder* builder = hdfsNewBuilder();
+  hdfsBuilderSetNameNode(builder, localhost.c_str());
+  hdfsBuilderSetNameNodePort(builder, 7878);
+  auto hdfs = hdfsBuilderConnect(builder);
+  HdfsReadFile readFile(hdfs, destinationPath);
+  // Reads through the short gap and seeks over the long one.
+  char head[12];
+  char middle[4];
+  char tail[7];
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(head, sizeof(head)),
+      folly::Range<char*>(nullptr, (char*)(uint64_t)1000),
+      folly::Range<char*>(middle, sizeof(middle)),
+      folly::Range<char*>(
+          nullptr,
+          (char*)(uint64_t)(15 + kOneMB - 1000 - sizeof(head) - sizeof(middle) - sizeof(tail))),
+      folly::Range<char*>(tail, sizeof(tail))};
+  ASSERT_EQ(15 + kOneMB, readFile.preadv(0, buffers));
+  ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbbcc");
+  ASSERT_EQ(std::string_view(middle, sizeof(middle)), "cccc");
+  ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ccddddd");
+}
+
+TEST_F(HdfsFileSystemTest, hedgedRead) {
+  struct hdfsBuilder* builder = hdfsNewBuilder();
+  hdfsBuilderSetNameNode(builder, localhost.c_str());
+  hdfsBuilderSetNameNodePort(builder, 7878);
+  auto hdfs = hdfsBuilderConnect(builder);
+  // With no delay nearly every read is hedged.
+  auto executor = std::make_shared<folly::CPUThreadPoolExecutor>(4);
+  HdfsReadFile readFile(
+      hdfs, destinationPath, executor, std::chrono::milliseconds(0));
+  readData(&readFile);
+
+  auto memConfig = std::make_shared<const core::MemConfig>(
+      std::unordered_map<std::string, std::string>(
+          {{"hive.hdfs.host", localhost},
+           {"hive.hdfs.port", hdfsPort},
+           {"hive.hdfs.hedged-read-delay-ms", "1"}}));
+  filesystems::HdfsFileSystem hdfsFileSystem(memConfig);
+  auto fileSystemFile = hdfsFileSystem.openFileForRead(fullDestinationPath);
+  readData(fileSystemFile.get());
+}
+
 TEST_F(HdfsFileSystemTest, viaFileSystem) {
   facebook::velox::filesystems::registerHdfsFileSystem();
   auto memConfig = std::make_shared<const core::MemConfig>(configurationValues);
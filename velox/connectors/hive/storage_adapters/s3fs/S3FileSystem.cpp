@@ -15,13 +15,19 @@
  */
 
 #include "velox/connectors/hive/storage_adapters/s3fs/S3FileSystem.h"
+#include "velox/buffer/Buffer.h"
 #include "velox/common/file/File.h"
 #include "velox/connectors/hive/storage_adapters/s3fs/S3Util.h"
 #include "velox/core/Context.h"
 
 #include <fmt/format.h>
 #include <glog/logging.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 
 #include <aws/core/Aws.h>
@@ -29,10 +35,16 @@
 #include <aws/core/http/HttpResponse.h>
 #include <aws/core/utils/logging/ConsoleLogSystem.h>
 #include <aws/core/utils/stream/PreallocatedStreamBuf.h>
+#include <aws/core/utils/threading/Executor.h>
 #include <aws/identity-management/auth/STSAssumeRoleCredentialsProvider.h>
 #include <aws/s3/S3Client.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadObjectRequest.h>
+#include <aws/s3/model/PutObjectRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
 
 namespace facebook::velox {
 namespace {
@@ -59,10 +71,77 @@ Aws::IOStreamFactory AwsWriteableStreamFactory(void* data, int64_t nbytes) {
   return [=]() { return Aws::New<StringViewStream>("", data, nbytes); };
 }
 
+// How an S3ReadFile splits and hedges its reads.
+struct S3ReadOptions {
+  // Reads of at least two parts of this size are split into parallel GETs.
+  // 0 disables splitting.
+  uint64_t partSize{0};
+  // The maximum number of parallel GETs of one read.
+  int32_t maxParts{1};
+  // A GET slower than this percentile of the recent GETs is hedged with a
+  // duplicate GET. 0 disables hedging.
+  int32_t hedgePercentile{0};
+  // A GET is not hedged before this many microseconds.
+  uint64_t minHedgeDelayMicros{0};
+};
+
+// The GETs of one read. Shared with the callbacks of the GETs, which may
+// outlive the read when a hedged GET loses.
+struct PendingRead {
+  struct Part {
+    ReadPart range;
+    // Where the part goes in the buffer of the read.
+    char* destination{nullptr};
+    // Set by the first GET of the part to succeed or when all its GETs
+    // failed. Aborts the GETs of the part still in flight.
+    std::atomic<bool> done{false};
+    int32_t numInFlight{0};
+    bool hedged{false};
+    std::chrono::steady_clock::time_point startTime;
+    // The buffers of the original and the hedged GET if hedging is enabled.
+    // The GETs then do not write to 'destination' since the loser may still
+    // be writing after the read returned.
+    std::unique_ptr<char[]> buffers[2];
+  };
+
+  explicit PendingRead(size_t numParts)
+      : parts(numParts), numPending(numParts) {}
+
+  std::mutex mutex;
+  std::condition_variable finished;
+  std::vector<Part> parts;
+  // The parts not yet done.
+  size_t numPending;
+  // Set on the first failed part. Aborts all GETs in flight.
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+};
+
+void recordGet(
+    dwio::common::IoStatistics& stats,
+    LatencyTracker& latencies,
+    uint64_t bytes,
+    uint64_t micros,
+    bool hedged) {
+  latencies.record(micros);
+  stats.incRawBytesRead(bytes);
+  stats.read().increment(bytes);
+  stats.incOperationCounters(
+      hedged ? "HedgedGetObject" : "GetObject", 0, 0, 0, 0, micros / 1000, 0);
+}
+
 class S3ReadFile final : public ReadFile {
  public:
-  S3ReadFile(const std::string& path, Aws::S3::S3Client* client)
-      : client_(client) {
+  S3ReadFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      const S3ReadOptions& options,
+      std::shared_ptr<dwio::common::IoStatistics> stats,
+      std::shared_ptr<LatencyTracker> latencies)
+      : client_(client),
+        options_(options),
+        stats_(std::move(stats)),
+        latencies_(std::move(latencies)) {
     bucketAndKeyFromS3Path(path, bucket_, key_);
   }
 
@@ -107,6 +186,7 @@ class S3ReadFile final : public ReadFile {
     // multi-range. AWS S3 also charges by number of read requests and not size.
     // The idea here is to use a single read spanning all the ranges and then
     // populate individual ranges. We pre-allocate a buffer to support this.
+    // A large span is read with parallel GETs by preadInternal().
     size_t length = 0;
     for (const auto range : buffers) {
       length += range.size();
@@ -142,10 +222,177 @@ class S3ReadFile final : public ReadFile {
   // The assumption here is that "position" has space for at least "length"
   // bytes.
   void preadInternal(uint64_t offset, uint64_t length, char* position) const {
-    // Read the desired range of bytes.
+    const auto ranges = splitReadRange(
+        offset, length, options_.partSize, options_.maxParts);
+    if (ranges.size() == 1 && options_.hedgePercentile == 0) {
+      getObject(offset, length, position);
+      return;
+    }
+
+    auto read = std::make_shared<PendingRead>(ranges.size());
+    const bool hedge = options_.hedgePercentile > 0;
+    for (auto i = 0; i < ranges.size(); ++i) {
+      auto& part = read->parts[i];
+      part.range = ranges[i];
+      part.destination = position + (ranges[i].offset - offset);
+      if (hedge) {
+        part.buffers[0] = std::make_unique<char[]>(ranges[i].length);
+      }
+    }
+    for (auto i = 0; i < ranges.size(); ++i) {
+      startGet(read, i, false);
+    }
+
+    // Hedges the GETs that take longer than the delay. There is no delay
+    // until enough GETs have finished to know what is slow.
+    std::optional<std::chrono::microseconds> hedgeDelay;
+    if (hedge) {
+      if (auto latency = latencies_->percentile(options_.hedgePercentile)) {
+        hedgeDelay = std::chrono::microseconds(
+            std::max(*latency, options_.minHedgeDelayMicros));
+      }
+    }
+    std::unique_lock<std::mutex> l(read->mutex);
+    while (read->numPending > 0) {
+      if (!hedgeDelay.has_value() || read->failed) {
+        read->finished.wait(l);
+        continue;
+      }
+      const auto now = std::chrono::steady_clock::now();
+      auto deadline = std::chrono::steady_clock::time_point::max();
+      std::vector<int32_t> slowParts;
+      for (auto i = 0; i < read->parts.size(); ++i) {
+        auto& part = read->parts[i];
+        if (part.done || part.hedged) {
+          continue;
+        }
+        const auto due = part.startTime + *hedgeDelay;
+        if (due <= now) {
+          part.hedged = true;
+          part.buffers[1] = std::make_unique<char[]>(part.range.length);
+          slowParts.push_back(i);
+        } else {
+          deadline = std::min(deadline, due);
+        }
+      }
+      if (!slowParts.empty()) {
+        l.unlock();
+        for (auto i : slowParts) {
+          startGet(read, i, true);
+        }
+        l.lock();
+        continue;
+      }
+      if (deadline == std::chrono::steady_clock::time_point::max()) {
+        read->finished.wait(l);
+      } else {
+        read->finished.wait_until(l, deadline);
+      }
+    }
+    if (read->error) {
+      std::rethrow_exception(read->error);
+    }
+  }
+
+  // Reads [offset, offset + length) into 'position' with one GET.
+  void getObject(uint64_t offset, uint64_t length, char* position) const {
+    Aws::S3::Model::GetObjectRequest request;
+    makeRequest(offset, length, position, request);
+    const auto start = std::chrono::steady_clock::now();
+    auto outcome = client_->GetObject(request);
+    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to get S3 object", bucket_, key_);
+    recordGet(*stats_, *latencies_, length, microsSince(start), false);
+  }
+
+  // Starts a GET of the part 'index' of 'read'. The GET reads into the
+  // buffer of the part if hedging and else into its destination.
+  void startGet(
+      const std::shared_ptr<PendingRead>& read,
+      int32_t index,
+      bool hedged) const {
+    auto& part = read->parts[index];
+    char* buffer = part.buffers[hedged ? 1 : 0].get();
+    {
+      std::lock_guard<std::mutex> l(read->mutex);
+      ++part.numInFlight;
+      if (!hedged) {
+        part.startTime = std::chrono::steady_clock::now();
+      }
+    }
     Aws::S3::Model::GetObjectRequest request;
-    Aws::S3::Model::GetObjectResult result;
+    makeRequest(
+        part.range.offset,
+        part.range.length,
+        buffer ? buffer : part.destination,
+        request);
+    request.SetContinueRequestHandler(
+        [read, index](const Aws::Http::HttpRequest* /*request*/) {
+          return !read->parts[index].done && !read->failed;
+        });
+    // The callback may run after this file is gone and must not refer to it.
+    client_->GetObjectAsync(
+        request,
+        [read,
+         index,
+         buffer,
+         hedged,
+         stats = stats_,
+         latencies = latencies_,
+         bucket = bucket_,
+         key = key_,
+         start = std::chrono::steady_clock::now()](
+            const auto* /*client*/,
+            const auto& /*request*/,
+            auto outcome,
+            const auto& /*context*/) {
+          auto& part = read->parts[index];
+          if (outcome.IsSuccess()) {
+            if (!part.done.exchange(true)) {
+              if (buffer) {
+                memcpy(part.destination, buffer, part.range.length);
+              }
+              recordGet(
+                  *stats,
+                  *latencies,
+                  part.range.length,
+                  microsSince(start),
+                  hedged);
+              std::lock_guard<std::mutex> l(read->mutex);
+              --part.numInFlight;
+              --read->numPending;
+              read->finished.notify_all();
+              return;
+            }
+            std::lock_guard<std::mutex> l(read->mutex);
+            --part.numInFlight;
+            return;
+          }
+          std::exception_ptr error;
+          try {
+            VELOX_CHECK_AWS_OUTCOME(
+                outcome, "Failed to get S3 object", bucket, key);
+          } catch (const std::exception&) {
+            error = std::current_exception();
+          }
+          std::lock_guard<std::mutex> l(read->mutex);
+          // The part fails when no other GET of it may still succeed.
+          if (--part.numInFlight > 0 || part.done) {
+            return;
+          }
+          part.done = true;
+          if (!read->failed.exchange(true)) {
+            read->error = error;
+          }
+          --read->numPending;
+          read->finished.notify_all();
+        });
+  }
 
+  void makeRequest(
+      uint64_t offset,
+      uint64_t length,
+      char* position,
+      Aws::S3::Model::GetObjectRequest& request) const {
     request.SetBucket(awsString(bucket_));
     request.SetKey(awsString(key_));
     std::stringstream ss;
@@ -153,15 +400,304 @@ class S3ReadFile final : public ReadFile {
     request.SetRange(awsString(ss.str()));
     request.SetResponseStreamFactory(
         AwsWriteableStreamFactory(position, length));
-    auto outcome = client_->GetObject(request);
-    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to get S3 object", bucket_, key_);
+  }
+
+  static uint64_t microsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
   }
 
   Aws::S3::S3Client* client_;
+  const S3ReadOptions options_;
+  const std::shared_ptr<dwio::common::IoStatistics> stats_;
+  const std::shared_ptr<LatencyTracker> latencies_;
   std::string bucket_;
   std::string key_;
   int64_t length_ = -1;
 };
+
+// Writes an S3 object with a multipart upload. Uploads each part as soon
+// as 'partSize' bytes are appended, with at most 'maxPartsInFlight' uploads
+// at a time. The memory is at most 'maxPartsInFlight' + 1 part buffers,
+// allocated from 'pool'. An object of less than one part is written with a
+// single PutObject at close().
+class S3WriteFile final : public WriteFile {
+ public:
+  // The minimum size of a part other than the last, set by S3.
+  static constexpr uint64_t kMinPartSize = 5 << 20;
+
+  S3WriteFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      memory::MemoryPool* pool,
+      uint64_t partSize,
+      int32_t maxPartsInFlight,
+      std::shared_ptr<dwio::common::IoStatistics> stats)
+      : client_(client),
+        pool_(pool),
+        partSize_(partSize),
+        maxPartsInFlight_(maxPartsInFlight),
+        stats_(std::move(stats)) {
+    VELOX_USER_CHECK_GE(
+        partSize_, kMinPartSize, "S3 upload parts must be at least 5MB");
+    VELOX_USER_CHECK_GE(maxPartsInFlight_, 1);
+    bucketAndKeyFromS3Path(path, bucket_, key_);
+  }
+
+  ~S3WriteFile() override {
+    try {
+      close();
+    } catch (const std::exception& ex) {
+      // We cannot throw an exception from the destructor. Warn instead.
+      LOG(WARNING) << "Failed to close S3 object " << s3URI(bucket_, key_)
+                   << " in S3WriteFile destructor: " << ex.what();
+    }
+  }
+
+  void append(std::string_view data) override {
+    VELOX_CHECK(!closed_, "File is closed");
+    while (!data.empty()) {
+      if (!buffer_) {
+        buffer_ = nextBuffer();
+      }
+      const auto bytes = std::min<uint64_t>(data.size(), partSize_ - used_);
+      memcpy(buffer_->asMutable<char>() + used_, data.data(), bytes);
+      used_ += bytes;
+      size_ += bytes;
+      data.remove_prefix(bytes);
+      if (used_ == partSize_) {
+        uploadPart();
+      }
+    }
+  }
+
+  // Waits for the uploads of the full parts. The rest of the data is
+  // uploaded at close() since a part other than the last must be at least
+  // kMinPartSize.
+  void flush() override {
+    VELOX_CHECK(!closed_, "File is closed");
+    waitForUploads(0);
+    checkUploads();
+  }
+
+  // Uploads the last part and completes the upload. Aborts the upload on
+  // error.
+  void close() override {
+    if (closed_) {
+      return;
+    }
+    closed_ = true;
+    if (uploadId_.empty()) {
+      putObject();
+      buffer_.reset();
+      return;
+    }
+    try {
+      if (used_ > 0) {
+        uploadPart();
+      }
+      waitForUploads(0);
+      checkUploads();
+      completeUpload();
+    } catch (const std::exception&) {
+      waitForUploads(0);
+      abortUpload();
+      throw;
+    }
+    buffer_.reset();
+    freeBuffers_.clear();
+  }
+
+  uint64_t size() const override {
+    return size_;
+  }
+
+ private:
+  BufferPtr nextBuffer() {
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (!freeBuffers_.empty()) {
+        auto buffer = std::move(freeBuffers_.back());
+        freeBuffers_.pop_back();
+        return buffer;
+      }
+    }
+    return AlignedBuffer::allocate<char>(partSize_, pool_);
+  }
+
+  // Starts the upload of the first 'used_' bytes of 'buffer_' as the next
+  // part after waiting for a free upload slot.
+  void uploadPart() {
+    if (uploadId_.empty()) {
+      createUpload();
+    }
+    waitForUploads(maxPartsInFlight_ - 1);
+    checkUploads();
+
+    const auto partNumber = nextPartNumber_++;
+    Aws::S3::Model::UploadPartRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    request.SetPartNumber(partNumber);
+    request.SetContentLength(used_);
+    request.SetBody(
+        Aws::MakeShared<StringViewStream>("", buffer_->as<char>(), used_));
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      ++numInFlight_;
+    }
+    // The callback keeps the buffer alive until the part is uploaded. The
+    // file waits for all uploads before it is destroyed.
+    client_->UploadPartAsync(
+        request,
+        [this,
+         buffer = std::move(buffer_),
+         bytes = used_,
+         partNumber,
+         start = std::chrono::steady_clock::now()](
+            const auto* /*client*/,
+            const auto& /*request*/,
+            auto outcome,
+            const auto& /*context*/) mutable {
+          std::exception_ptr error;
+          if (outcome.IsSuccess()) {
+            recordWrite("UploadPart", bytes, start);
+          } else {
+            try {
+              VELOX_CHECK_AWS_OUTCOME(
+                  outcome, "Failed to upload S3 object part", bucket_, key_);
+            } catch (const std::exception&) {
+              error = std::current_exception();
+            }
+          }
+          std::lock_guard<std::mutex> l(mutex_);
+          if (error) {
+            if (!error_) {
+              error_ = error;
+            }
+          } else {
+            completedParts_.push_back(
+                Aws::S3::Model::CompletedPart()
+                    .WithETag(outcome.GetResult().GetETag())
+                    .WithPartNumber(partNumber));
+          }
+          freeBuffers_.push_back(std::move(buffer));
+          --numInFlight_;
+          uploadDone_.notify_all();
+        });
+    used_ = 0;
+  }
+
+  void waitForUploads(int32_t maxInFlight) {
+    std::unique_lock<std::mutex> l(mutex_);
+    uploadDone_.wait(l, [&]() { return numInFlight_ <= maxInFlight; });
+  }
+
+  // Throws the error of the first failed part upload.
+  void checkUploads() {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  void createUpload() {
+    Aws::S3::Model::CreateMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    auto outcome = client_->CreateMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to start upload of S3 object", bucket_, key_);
+    uploadId_ = outcome.GetResult().GetUploadId();
+  }
+
+  void completeUpload() {
+    // The parts finish in any order but must be listed by part number.
+    std::sort(
+        completedParts_.begin(),
+        completedParts_.end(),
+        [](const auto& left, const auto& right) {
+          return left.GetPartNumber() < right.GetPartNumber();
+        });
+    Aws::S3::Model::CompletedMultipartUpload upload;
+    upload.SetParts(
+        Aws::Vector<Aws::S3::Model::CompletedPart>(
+            completedParts_.begin(), completedParts_.end()));
+    Aws::S3::Model::CompleteMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    request.SetMultipartUpload(std::move(upload));
+    auto outcome = client_->CompleteMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to complete upload of S3 object", bucket_, key_);
+  }
+
+  // Discards the uploaded parts so that they are not charged for.
+  void abortUpload() {
+    Aws::S3::Model::AbortMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    auto outcome = client_->AbortMultipartUpload(request);
+    if (!outcome.IsSuccess()) {
+      LOG(WARNING) << "Failed to abort upload of S3 object "
+                   << s3URI(bucket_, key_) << ": "
+                   << outcome.GetError().GetMessage();
+    }
+  }
+
+  void putObject() {
+    Aws::S3::Model::PutObjectRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetContentLength(used_);
+    request.SetBody(Aws::MakeShared<StringViewStream>(
+        "", buffer_ ? buffer_->as<char>() : nullptr, used_));
+    const auto start = std::chrono::steady_clock::now();
+    auto outcome = client_->PutObject(request);
+    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to put S3 object", bucket_, key_);
+    recordWrite("PutObject", used_, start);
+  }
+
+  void recordWrite(
+      const char* operation,
+      uint64_t bytes,
+      std::chrono::steady_clock::time_point start) {
+    const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+    stats_->incRawBytesWritten(bytes);
+    stats_->incOperationCounters(operation, 0, 0, 0, 0, millis, 0);
+  }
+
+  Aws::S3::S3Client* client_;
+  memory::MemoryPool* const pool_;
+  const uint64_t partSize_;
+  const int32_t maxPartsInFlight_;
+  const std::shared_ptr<dwio::common::IoStatistics> stats_;
+  std::string bucket_;
+  std::string key_;
+  // Set by the first part upload.
+  Aws::String uploadId_;
+  int32_t nextPartNumber_{1};
+  // The part being appended to and its size.
+  BufferPtr buffer_;
+  uint64_t used_{0};
+  uint64_t size_{0};
+  bool closed_{false};
+
+  // Protects the members below, which the upload callbacks update.
+  std::mutex mutex_;
+  std::condition_variable uploadDone_;
+  int32_t numInFlight_{0};
+  std::vector<Aws::S3::Model::CompletedPart> completedParts_;
+  // The buffers of the uploaded parts for reuse.
+  std::vector<BufferPtr> freeBuffers_;
+  std::exception_ptr error_;
+};
 } // namespace
 
 namespace filesystems {
@@ -214,6 +750,43 @@ class S3Config {
         "hive.s3.iam-role-session-name", std::string("velox-session"));
   }
 
+  // Reads of at least twice this many bytes are split into parts read by
+  // parallel GETs. 0 reads with one GET.
+  uint64_t readPartSize() const {
+    return config_->get<uint64_t>("hive.s3.read-part-size", 8 << 20);
+  }
+
+  // The maximum number of parallel GETs of one read.
+  int32_t maxReadParts() const {
+    return config_->get<int32_t>("hive.s3.max-read-parts", 16);
+  }
+
+  // The threads running the parallel and hedged GETs of all reads.
+  int32_t readThreads() const {
+    return config_->get<int32_t>("hive.s3.read-threads", 32);
+  }
+
+  // A GET slower than this percentile of the recent GETs is hedged with a
+  // duplicate GET. 0 disables hedging.
+  int32_t hedgeLatencyPercentile() const {
+    return config_->get<int32_t>("hive.s3.hedge-latency-percentile", 0);
+  }
+
+  // A GET is not hedged before this many milliseconds.
+  uint64_t minHedgeDelayMs() const {
+    return config_->get<uint64_t>("hive.s3.min-hedge-delay-ms", 50);
+  }
+
+  // The size of the parts of the multipart uploads of written files.
+  uint64_t uploadPartSize() const {
+    return config_->get<uint64_t>("hive.s3.upload-part-size", 16 << 20);
+  }
+
+  // The maximum number of parts of one written file uploaded at a time.
+  int32_t maxUploadPartsInFlight() const {
+    return config_->get<int32_t>("hive.s3.max-upload-parts-in-flight", 4);
+  }
+
  private:
   const Config* FOLLY_NONNULL config_;
 };
@@ -313,6 +886,11 @@ class S3FileSystem::Impl {
       clientConfig.scheme = Aws::Http::Scheme::HTTP;
     }
 
+    // Runs the GetObjectAsync() calls of the parallel and hedged reads.
+    clientConfig.executor =
+        Aws::MakeShared<Aws::Utils::Threading::PooledThreadExecutor>(
+            "S3FileSystem", s3Config_.readThreads());
+
     auto credentialsProvider = getCredentialsProvider();
 
     client_ = std::make_shared<Aws::S3::S3Client>(
@@ -329,9 +907,45 @@ class S3FileSystem::Impl {
     return client_.get();
   }
 
+  S3ReadOptions readOptions() const {
+    S3ReadOptions options;
+    options.partSize = s3Config_.readPartSize();
+    options.maxParts = s3Config_.maxReadParts();
+    options.hedgePercentile = s3Config_.hedgeLatencyPercentile();
+    options.minHedgeDelayMicros = s3Config_.minHedgeDelayMs() * 1000;
+    VELOX_USER_CHECK_GE(options.maxParts, 1);
+    VELOX_USER_CHECK_GE(options.hedgePercentile, 0);
+    VELOX_USER_CHECK_LE(options.hedgePercentile, 100);
+    return options;
+  }
+
+  const std::shared_ptr<dwio::common::IoStatistics>& ioStatistics() const {
+    return ioStats_;
+  }
+
+  const std::shared_ptr<LatencyTracker>& latencies() const {
+    return latencies_;
+  }
+
+  const S3Config& s3Config() const {
+    return s3Config_;
+  }
+
+  memory::MemoryPool* pool() const {
+    return pool_.get();
+  }
+
  private:
   const S3Config s3Config_;
   std::shared_ptr<Aws::S3::S3Client> client_;
+  const std::shared_ptr<dwio::common::IoStatistics> ioStats_{
+      std::make_shared<dwio::common::IoStatistics>()};
+  // The latencies of the GETs of all files of the filesystem.
+  const std::shared_ptr<LatencyTracker> latencies_{
+      std::make_shared<LatencyTracker>()};
+  // The part buffers of the written files opened without a pool.
+  const std::unique_ptr<memory::ScopedMemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
   static std::atomic<size_t> initCounter_;
 };
 
@@ -349,20 +963,48 @@ void S3FileSystem::initializeClient() {
 
 std::unique_ptr<ReadFile> S3FileSystem::openFileForRead(std::string_view path) {
   const std::string file = s3Path(path);
-  auto s3file = std::make_unique<S3ReadFile>(file, impl_->s3Client());
+  auto s3file = std::make_unique<S3ReadFile>(
+      file,
+      impl_->s3Client(),
+      impl_->readOptions(),
+      impl_->ioStatistics(),
+      impl_->latencies());
   s3file->initialize();
   return s3file;
 }
 
 std::unique_ptr<WriteFile> S3FileSystem::openFileForWrite(
     std::string_view path) {
-  VELOX_NYI();
+  return openFileForWrite(path, impl_->pool());
+}
+
+std::unique_ptr<WriteFile> S3FileSystem::openFileForWrite(
+    std::string_view path,
+    memory::MemoryPool* pool) {
+  const auto& config = impl_->s3Config();
+  return std::make_unique<S3WriteFile>(
+      s3Path(path),
+      impl_->s3Client(),
+      pool,
+      config.uploadPartSize(),
+      config.maxUploadPartsInFlight(),
+      impl_->ioStatistics());
+}
+
+std::shared_ptr<dwio::common::IoStatistics> S3FileSystem::ioStatistics()
+    const {
+  return impl_->ioStatistics();
 }
 
 std::string S3FileSystem::name() const {
   return "S3";
 }
 
+IoProfile S3FileSystem::ioProfile() const {
+  // An object store: 30ms to the first byte, then 100MB/s per request.
+  return {30000, 100};
+}
+
 static std::function<std::shared_ptr<FileSystem>(std::shared_ptr<const Config>)>
     filesystemGenerator = [](std::shared_ptr<const Config> properties) {
       // Only one instance of S3FileSystem is supported for now.
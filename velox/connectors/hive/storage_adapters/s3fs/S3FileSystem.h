@@ -17,6 +17,8 @@
 #pragma once
 
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/dwio/common/IoStatistics.h"
 
 namespace facebook::velox::filesystems {
 
@@ -33,10 +35,26 @@ class S3FileSystem : public FileSystem {
 
   std::unique_ptr<ReadFile> openFileForRead(std::string_view path) override;
 
+  // Returns a file written with a multipart upload. The part buffers are
+  // allocated from a pool of the filesystem.
   std::unique_ptr<WriteFile> openFileForWrite(std::string_view path) override;
 
+  // Same as above but allocates the part buffers from 'pool', which must
+  // outlive the file.
+  std::unique_ptr<WriteFile> openFileForWrite(
+      std::string_view path,
+      memory::MemoryPool* pool);
+
   std::string name() const override;
 
+  IoProfile ioProfile() const override;
+
+  // The bytes and requests of the files of this filesystem. The operation
+  // stats count the GETs under "GetObject", the hedged GETs that finished
+  // first under "HedgedGetObject" and the writes under "UploadPart" and
+  // "PutObject".
+  std::shared_ptr<dwio::common::IoStatistics> ioStatistics() const;
+
   void remove(std::string_view path) override {
     VELOX_UNSUPPORTED("remove for S3 not implemented");
   }
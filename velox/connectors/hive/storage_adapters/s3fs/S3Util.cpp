@@ -21,6 +21,8 @@
 
 #include "velox/connectors/hive/storage_adapters/s3fs/S3Util.h"
 
+#include <algorithm>
+
 namespace facebook::velox {
 
 std::string getErrorStringFromS3Error(
@@ -43,4 +45,51 @@ std::string getErrorStringFromS3Error(
   }
 }
 
+std::vector<ReadPart> splitReadRange(
+    uint64_t offset,
+    uint64_t length,
+    uint64_t partSize,
+    int32_t maxParts) {
+  if (partSize == 0 || maxParts <= 1 || length < 2 * partSize) {
+    return {{offset, length}};
+  }
+  // Rounds up so that the last part is not much smaller than the others.
+  const auto numParts = std::min<uint64_t>(
+      maxParts, (length + partSize - 1) / partSize);
+  const auto size = (length + numParts - 1) / numParts;
+  std::vector<ReadPart> parts;
+  parts.reserve(numParts);
+  for (uint64_t start = 0; start < length; start += size) {
+    parts.push_back({offset + start, std::min(size, length - start)});
+  }
+  return parts;
+}
+
+void LatencyTracker::record(uint64_t micros) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (samples_.size() < kMaxSamples) {
+    samples_.push_back(micros);
+    return;
+  }
+  samples_[nextSample_] = micros;
+  nextSample_ = (nextSample_ + 1) % kMaxSamples;
+}
+
+std::optional<uint64_t> LatencyTracker::percentile(int32_t percentile) const {
+  VELOX_CHECK_GE(percentile, 0);
+  VELOX_CHECK_LE(percentile, 100);
+  std::vector<uint64_t> samples;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (samples_.size() < kMinSamples) {
+      return std::nullopt;
+    }
+    samples = samples_;
+  }
+  const auto index =
+      std::min<size_t>(samples.size() * percentile / 100, samples.size() - 1);
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return samples[index];
+}
+
 } // namespace facebook::velox
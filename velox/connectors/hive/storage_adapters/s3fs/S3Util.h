@@ -24,6 +24,10 @@
 #include <aws/s3/S3Errors.h>
 #include <aws/s3/model/HeadObjectResult.h>
 
+#include <mutex>
+#include <optional>
+#include <vector>
+
 #include "velox/common/base/Exceptions.h"
 
 namespace facebook::velox {
@@ -103,6 +107,45 @@ inline Aws::String awsString(const std::string& s) {
 std::string getErrorStringFromS3Error(
     const Aws::Client::AWSError<Aws::S3::S3Errors>& error);
 
+// A byte range of an S3 object read by one GET.
+struct ReadPart {
+  uint64_t offset;
+  uint64_t length;
+};
+
+// Splits [offset, offset + length) into parts of about 'partSize' bytes for
+// reading with parallel GETs. Makes the parts larger if there would be more
+// than 'maxParts'. Returns a single part if 'partSize' is 0 or 'length' is
+// less than two parts.
+std::vector<ReadPart> splitReadRange(
+    uint64_t offset,
+    uint64_t length,
+    uint64_t partSize,
+    int32_t maxParts);
+
+// Keeps the latencies of the most recent GETs for deciding after how long a
+// GET is slow enough to hedge with a duplicate. Thread-safe.
+class LatencyTracker {
+ public:
+  // Records a GET that took 'micros'.
+  void record(uint64_t micros);
+
+  // Returns the latency below which 'percentile' percent of the recent GETs
+  // finished, or std::nullopt if there are too few GETs to tell.
+  std::optional<uint64_t> percentile(int32_t percentile) const;
+
+ private:
+  // The number of GETs needed before percentile() returns a value.
+  static constexpr int32_t kMinSamples = 20;
+  // The size of the window of recent GETs.
+  static constexpr int32_t kMaxSamples = 512;
+
+  mutable std::mutex mutex_;
+  // Ring buffer of the latencies of the last 'kMaxSamples' GETs.
+  std::vector<uint64_t> samples_;
+  int32_t nextSample_{0};
+};
+
 namespace {
 inline std::string getS3BackendService(
     const Aws::Http::HeaderValueCollection& headers) {
@@ -146,12 +146,117 @@ TEST_F(S3FileSystemTest, fileHandle) {
   }
   auto hiveConfig = minioServer_->hiveConfig();
   FileHandleFactory factory(
-      std::make_unique<SimpleLRUCache<std::string, FileHandle>>(1000),
-      std::make_unique<FileHandleGenerator>(hiveConfig));
+      std::make_unique<FileHandleGenerator>(hiveConfig), 1000);
   auto fileHandle = factory.generate(s3File);
   readData(fileHandle->file.get());
 }
 
+TEST_F(S3FileSystemTest, parallelReads) {
+  const char* bucketName = "data4";
+  const char* file = "test.txt";
+  const std::string filename = localPath(bucketName) + "/" + file;
+  const std::string s3File = s3URI(bucketName, file);
+  addBucket(bucketName);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.read-part-size", std::to_string(64 << 10)},
+       {"hive.s3.max-read-parts", "8"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+  auto readFile = s3fs.openFileForRead(s3File);
+  readData(readFile.get());
+
+  // The reads of kOneMB and more take 8 GETs and the others one each.
+  const auto stats = s3fs.ioStatistics();
+  EXPECT_EQ(stats->operationStats()["GetObject"].requestCount, 21);
+  EXPECT_EQ(stats->operationStats().count("HedgedGetObject"), 0);
+  EXPECT_EQ(stats->rawBytesRead(), 2 * kOneMB + 63);
+}
+
+TEST_F(S3FileSystemTest, hedgedReads) {
+  const char* bucketName = "data5";
+  const char* file = "test.txt";
+  const std::string filename = localPath(bucketName) + "/" + file;
+  const std::string s3File = s3URI(bucketName, file);
+  addBucket(bucketName);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  // Hedges any GET slower than the median once enough GETs are done.
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.read-part-size", std::to_string(64 << 10)},
+       {"hive.s3.max-read-parts", "8"},
+       {"hive.s3.hedge-latency-percentile", "50"},
+       {"hive.s3.min-hedge-delay-ms", "0"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+  auto readFile = s3fs.openFileForRead(s3File);
+  for (auto i = 0; i < 3; ++i) {
+    readData(readFile.get());
+  }
+
+  // Either the original or the hedged GET of each part counts.
+  auto operationStats = s3fs.ioStatistics()->operationStats();
+  EXPECT_EQ(
+      operationStats["GetObject"].requestCount +
+          operationStats["HedgedGetObject"].requestCount,
+      3 * 21);
+  EXPECT_EQ(s3fs.ioStatistics()->rawBytesRead(), 3 * (2 * kOneMB + 63));
+}
+
+TEST_F(S3FileSystemTest, multipartUpload) {
+  const char* bucketName = "data6";
+  addBucket(bucketName);
+  constexpr int64_t kPartSize = 5 * kOneMB;
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.upload-part-size", std::to_string(kPartSize)},
+       {"hive.s3.max-upload-parts-in-flight", "2"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+  auto pool = memory::getDefaultScopedMemoryPool();
+
+  // Writes 3 parts, the last one short.
+  const std::string s3File = s3URI(bucketName, "upload.txt");
+  std::string data;
+  for (auto i = 0; i < 2 * kPartSize + 1000; ++i) {
+    data.push_back('a' + i % 26);
+  }
+  {
+    auto writeFile = s3fs.openFileForWrite(s3File, pool.get());
+    for (auto offset = 0; offset < data.size(); offset += 100'000) {
+      writeFile->append(std::string_view(data).substr(offset, 100'000));
+    }
+    EXPECT_EQ(writeFile->size(), data.size());
+    // At most 2 parts in flight and one being appended to.
+    EXPECT_LE(pool->getMaxBytes(), 3 * kPartSize + kOneMB);
+    writeFile->close();
+  }
+  EXPECT_EQ(pool->getCurrentBytes(), 0);
+  auto readFile = s3fs.openFileForRead(s3File);
+  ASSERT_EQ(readFile->size(), data.size());
+  EXPECT_EQ(readFile->pread(0, data.size()), data);
+
+  // A file of less than one part is written at close().
+  const std::string smallFile = s3URI(bucketName, "small.txt");
+  {
+    auto writeFile = s3fs.openFileForWrite(smallFile);
+    writeFile->append("aaaaa");
+    writeFile->append("bbbbb");
+    writeFile->flush();
+  }
+  readFile = s3fs.openFileForRead(smallFile);
+  EXPECT_EQ(readFile->pread(0, 10), "aaaaabbbbb");
+
+  auto operationStats = s3fs.ioStatistics()->operationStats();
+  EXPECT_EQ(operationStats["UploadPart"].requestCount, 3);
+  EXPECT_EQ(operationStats["PutObject"].requestCount, 1);
+  EXPECT_EQ(s3fs.ioStatistics()->rawBytesWritten(), data.size() + 10);
+}
+
 TEST_F(S3FileSystemTest, invalidCredentialsConfig) {
   {
     const std::unordered_map<std::string, std::string> config(
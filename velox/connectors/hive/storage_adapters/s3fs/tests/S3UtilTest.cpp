@@ -73,3 +73,49 @@ TEST(S3UtilTest, bucketAndKeyFromS3Path) {
   EXPECT_EQ(bucket, "bucket");
   EXPECT_EQ(key, "file.txt");
 }
+
+TEST(S3UtilTest, splitReadRange) {
+  // Less than two parts is read with one GET.
+  auto parts = splitReadRange(10, 150, 100, 8);
+  ASSERT_EQ(parts.size(), 1);
+  EXPECT_EQ(parts[0].offset, 10);
+  EXPECT_EQ(parts[0].length, 150);
+  EXPECT_EQ(splitReadRange(10, 1000, 0, 8).size(), 1);
+
+  parts = splitReadRange(10, 250, 100, 8);
+  ASSERT_EQ(parts.size(), 3);
+  uint64_t offset = 10;
+  for (const auto& part : parts) {
+    EXPECT_EQ(part.offset, offset);
+    EXPECT_LE(part.length, 100);
+    offset += part.length;
+  }
+  EXPECT_EQ(offset, 260);
+
+  // The parts grow to stay within 'maxParts'.
+  parts = splitReadRange(0, 1000, 10, 4);
+  ASSERT_EQ(parts.size(), 4);
+  for (const auto& part : parts) {
+    EXPECT_EQ(part.length, 250);
+  }
+}
+
+TEST(S3UtilTest, latencyTracker) {
+  LatencyTracker tracker;
+  for (auto i = 1; i < 20; ++i) {
+    tracker.record(i);
+  }
+  EXPECT_FALSE(tracker.percentile(50).has_value());
+  for (auto i = 20; i <= 100; ++i) {
+    tracker.record(i);
+  }
+  EXPECT_EQ(tracker.percentile(50).value(), 51);
+  EXPECT_EQ(tracker.percentile(90).value(), 91);
+  EXPECT_EQ(tracker.percentile(100).value(), 100);
+
+  // Only the most recent latencies count.
+  for (auto i = 0; i < 1000; ++i) {
+    tracker.record(1000);
+  }
+  EXPECT_EQ(tracker.percentile(0).value(), 1000);
+}
@@ -16,6 +16,8 @@
 
 #include "velox/connectors/hive/FileHandle.h"
 
+#include <thread>
+
 #include "gtest/gtest.h"
 #include "velox/common/caching/SimpleLRUCache.h"
 #include "velox/common/file/File.h"
@@ -36,9 +38,7 @@ TEST(FileHandleTest, localFile) {
     writeFile.append("foo");
   }
 
-  FileHandleFactory factory(
-      std::make_unique<SimpleLRUCache<std::string, FileHandle>>(1000),
-      std::make_unique<FileHandleGenerator>());
+  FileHandleFactory factory(std::make_unique<FileHandleGenerator>(), 1000);
   auto fileHandle = factory.generate(filename);
   ASSERT_EQ(fileHandle->file->size(), 3);
   char buffer[3];
@@ -47,3 +47,40 @@ TEST(FileHandleTest, localFile) {
   // Clean up
   remove(filename.c_str());
 }
+
+TEST(FileHandleTest, expiredHandle) {
+  filesystems::registerLocalFileSystem();
+
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path;
+  {
+    LocalWriteFile writeFile(filename);
+    writeFile.append("foo");
+  }
+
+  FileHandleFactory factory(
+      std::make_unique<FileHandleGenerator>(),
+      1000,
+      4,
+      std::chrono::milliseconds(100));
+  auto fileHandle = factory.generate(filename);
+  ASSERT_EQ(fileHandle->size, 3);
+  const auto openTimeMs = fileHandle->openTimeMs;
+  fileHandle = FileHandleCachedPtr();
+  ASSERT_TRUE(factory.generate(filename).wasCached());
+
+  // The file is replaced and the handle is reopened after the ttl.
+  remove(filename.c_str());
+  {
+    LocalWriteFile writeFile(filename);
+    writeFile.append("foobar");
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  fileHandle = factory.generate(filename);
+  ASSERT_FALSE(fileHandle.wasCached());
+  ASSERT_GT(fileHandle->openTimeMs, openTimeMs);
+  ASSERT_EQ(fileHandle->size, 6);
+  ASSERT_EQ(fileHandle->file->size(), 6);
+
+  remove(filename.c_str());
+}
@@ -277,3 +277,37 @@ TEST_F(HivePartitionFunctionTest, date) {
   assertPartitionsWithConstChannel(values, 500);
   assertPartitionsWithConstChannel(values, 997);
 }
+
+TEST_F(HivePartitionFunctionTest, dictionaryAndConstant) {
+  const vector_size_t size = 1'000;
+  auto bigints = makeNullableFlatVector<int64_t>(
+      {std::nullopt, 1, std::numeric_limits<int64_t>::max(), -7});
+  auto varchars = makeNullableFlatVector<StringView>(
+      {"abc", std::nullopt, "some longer string", ""});
+  // The dictionaries have fewer distinct values than rows and add nulls of
+  // their own.
+  auto indices = makeIndices(size, [](auto row) { return row % 4; });
+  auto nulls = makeNulls(size, [](auto row) { return row % 11 == 0; });
+  auto input = makeRowVector(
+      {BaseVector::wrapInDictionary(nulls, indices, size, bigints),
+       makeConstant<int32_t>(5, size),
+       BaseVector::wrapInDictionary(nullptr, indices, size, varchars),
+       makeNullConstant(TypeKind::DOUBLE, size)});
+  auto flatInput = makeRowVector(
+      {flatten(input->childAt(0)),
+       flatten(input->childAt(1)),
+       flatten(input->childAt(2)),
+       flatten(input->childAt(3))});
+
+  for (auto bucketCount : {1, 2, 500, 997}) {
+    std::vector<int> bucketToPartition(bucketCount);
+    std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+    connector::hive::HivePartitionFunction partitionFunction(
+        bucketCount, bucketToPartition, {0, 1, 2, 3});
+    std::vector<uint32_t> partitions;
+    partitionFunction.partition(*input, partitions);
+    std::vector<uint32_t> flatPartitions;
+    partitionFunction.partition(*flatInput, flatPartitions);
+    EXPECT_EQ(flatPartitions, partitions) << bucketCount << " buckets";
+  }
+}
@@ -53,6 +53,13 @@ RowVectorPtr getTpchData(
 } // namespace
 
 std::string TpchTableHandle::toString() const {
+  if (filterExpression_) {
+    return fmt::format(
+        "table: {}, scale factor: {}, filter: ({})",
+        toTableName(table_),
+        scaleFactor_,
+        filterExpression_->toString());
+  }
   return fmt::format(
       "table: {}, scale factor: {}", toTableName(table_), scaleFactor_);
 }
@@ -63,8 +70,14 @@ TpchDataSource::TpchDataSource(
     const std::unordered_map<
         std::string,
         std::shared_ptr<connector::ColumnHandle>>& columnHandles,
-    velox::memory::MemoryPool* FOLLY_NONNULL pool)
-    : pool_(pool) {
+    velox::memory::MemoryPool* FOLLY_NONNULL pool,
+    ExpressionEvaluator* FOLLY_NULLABLE expressionEvaluator,
+    folly::Executor* FOLLY_NULLABLE executor,
+    int32_t maxParallelBatches)
+    : pool_(pool),
+      expressionEvaluator_(expressionEvaluator),
+      executor_(executor),
+      maxParallelBatches_(executor ? std::max(1, maxParallelBatches) : 1) {
   auto tpchTableHandle =
       std::dynamic_pointer_cast<TpchTableHandle>(tableHandle);
   VELOX_CHECK_NOT_NULL(
@@ -103,6 +116,22 @@ TpchDataSource::TpchDataSource(
     outputColumnMappings_.emplace_back(*idx);
   }
   outputType_ = outputType;
+
+  // The filter is evaluated on all the generated columns, which include the
+  // ones that are not projected out.
+  if (auto& filter = tpchTableHandle->filterExpression()) {
+    VELOX_CHECK_NOT_NULL(
+        expressionEvaluator_,
+        "An expression evaluator is needed for a filter on TPC-H table '{}'",
+        toTableName(tpchTable_));
+    filterExprSet_ = expressionEvaluator_->compile(filter);
+  }
+}
+
+TpchDataSource::~TpchDataSource() {
+  for (auto& batch : batches_) {
+    batch->ready.getSemiFuture().wait();
+  }
 }
 
 RowVectorPtr TpchDataSource::projectOutputColumns(RowVectorPtr inputVector) {
@@ -136,30 +165,103 @@ void TpchDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
   splitEnd_ = splitOffset_ + partSize;
 }
 
+void TpchDataSource::scheduleBatches(uint64_t size) {
+  while (batches_.size() < static_cast<size_t>(maxParallelBatches_) &&
+         splitOffset_ < splitEnd_) {
+    const size_t maxRows = std::min(size, (splitEnd_ - splitOffset_));
+    auto batch = std::make_shared<Batch>();
+    executor_->add([batch,
+                    table = tpchTable_,
+                    maxRows,
+                    offset = splitOffset_,
+                    scaleFactor = scaleFactor_,
+                    pool = pool_]() {
+      try {
+        batch->data = getTpchData(table, maxRows, offset, scaleFactor, pool);
+      } catch (const std::exception&) {
+        batch->error = std::current_exception();
+      }
+      batch->ready.setValue();
+    });
+    batches_.push_back(std::move(batch));
+    // splitOffset needs to advance based on maxRows passed to getTpchData(),
+    // and not the actual number of returned rows in the output vector, as
+    // they are not the same for lineitem.
+    splitOffset_ += maxRows;
+  }
+}
+
 std::optional<RowVectorPtr> TpchDataSource::next(
     uint64_t size,
-    velox::ContinueFuture& /*future*/) {
+    velox::ContinueFuture& future) {
   VELOX_CHECK_NOT_NULL(
       currentSplit_, "No split to process. Call addSplit() first.");
 
-  size_t maxRows = std::min(size, (splitEnd_ - splitOffset_));
-  auto outputVector =
-      getTpchData(tpchTable_, maxRows, splitOffset_, scaleFactor_, pool_);
+  RowVectorPtr outputVector;
+  if (executor_) {
+    scheduleBatches(size);
+    if (!batches_.empty()) {
+      auto batch = batches_.front();
+      if (!batch->ready.isFulfilled()) {
+        future = batch->ready.getSemiFuture();
+        return std::nullopt;
+      }
+      batches_.pop_front();
+      if (batch->error) {
+        std::rethrow_exception(batch->error);
+      }
+      outputVector = std::move(batch->data);
+      // Keeps 'maxParallelBatches_' in flight while this one is consumed.
+      scheduleBatches(size);
+    }
+  } else if (splitOffset_ < splitEnd_) {
+    size_t maxRows = std::min(size, (splitEnd_ - splitOffset_));
+    outputVector =
+        getTpchData(tpchTable_, maxRows, splitOffset_, scaleFactor_, pool_);
+    // See scheduleBatches() for why this advances by 'maxRows'.
+    splitOffset_ += maxRows;
+  }
 
   // If the split is exhausted.
   if (!outputVector || outputVector->size() == 0) {
+    // The batches after an empty one are empty too.
+    for (auto& batch : batches_) {
+      batch->ready.getSemiFuture().wait();
+    }
+    batches_.clear();
     currentSplit_ = nullptr;
     return nullptr;
   }
 
-  // splitOffset needs to advance based on maxRows passed to getTpchData(), and
-  // not the actual number of returned rows in the output vector, as they are
-  // not the same for lineitem.
-  splitOffset_ += maxRows;
   completedRows_ += outputVector->size();
   completedBytes_ += outputVector->retainedSize();
 
-  return projectOutputColumns(outputVector);
+  return filterAndProject(outputVector);
+}
+
+RowVectorPtr TpchDataSource::filterAndProject(RowVectorPtr vector) {
+  if (!filterExprSet_) {
+    return projectOutputColumns(vector);
+  }
+  filterRows_.resize(vector->size());
+  expressionEvaluator_->evaluate(
+      filterExprSet_.get(), filterRows_, vector, &filterResult_);
+  const auto numPassed = exec::processFilterResults(
+      filterResult_, filterRows_, filterEvalCtx_, pool_);
+  if (numPassed == 0) {
+    return RowVector::createEmpty(outputType_, pool_);
+  }
+  if (numPassed == vector->size()) {
+    return projectOutputColumns(vector);
+  }
+  std::vector<VectorPtr> children;
+  children.reserve(outputColumnMappings_.size());
+  for (const auto channel : outputColumnMappings_) {
+    children.emplace_back(exec::wrapChild(
+        numPassed, filterEvalCtx_.selectedIndices, vector->childAt(channel)));
+  }
+  return std::make_shared<RowVector>(
+      pool_, outputType_, BufferPtr(), numPassed, std::move(children));
 }
 
 VELOX_REGISTER_CONNECTOR_FACTORY(std::make_shared<TpchConnectorFactory>())
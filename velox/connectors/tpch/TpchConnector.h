@@ -15,8 +15,14 @@
  */
 #pragma once
 
+#include <deque>
+
+#include <folly/futures/SharedPromise.h>
+
 #include "velox/connectors/Connector.h"
 #include "velox/connectors/tpch/TpchConnectorSplit.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/expression/Expr.h"
 #include "velox/tpch/gen/TpchGen.h"
 
 namespace facebook::velox::connector::tpch {
@@ -38,15 +44,20 @@ class TpchColumnHandle : public ColumnHandle {
 };
 
 // TPC-H table handle uses the underlying enum to describe the target table.
+// 'filterExpression' is an optional filter over the columns of the table that
+// the data source applies to the generated rows, so that benchmarks can
+// measure filtered scans without file I/O.
 class TpchTableHandle : public ConnectorTableHandle {
  public:
   explicit TpchTableHandle(
       std::string connectorId,
       velox::tpch::Table table,
-      double scaleFactor = 1.0)
+      double scaleFactor = 1.0,
+      core::TypedExprPtr filterExpression = nullptr)
       : ConnectorTableHandle(std::move(connectorId)),
         table_(table),
-        scaleFactor_(scaleFactor) {
+        scaleFactor_(scaleFactor),
+        filterExpression_(std::move(filterExpression)) {
     VELOX_CHECK_GE(scaleFactor, 0, "Tpch scale factor must be non-negative");
   }
 
@@ -62,11 +73,19 @@ class TpchTableHandle : public ConnectorTableHandle {
     return scaleFactor_;
   }
 
+  const core::TypedExprPtr& filterExpression() const {
+    return filterExpression_;
+  }
+
  private:
   const velox::tpch::Table table_;
   double scaleFactor_;
+  const core::TypedExprPtr filterExpression_;
 };
 
+// Generates the rows of a split in batches. If there is an executor, up to
+// 'maxParallelBatches' batches of the split are generated concurrently on
+// it, and next() returns a future while the next batch is not ready.
 class TpchDataSource : public DataSource {
  public:
   TpchDataSource(
@@ -75,7 +94,13 @@ class TpchDataSource : public DataSource {
       const std::unordered_map<
           std::string,
           std::shared_ptr<connector::ColumnHandle>>& columnHandles,
-      velox::memory::MemoryPool* FOLLY_NONNULL pool);
+      velox::memory::MemoryPool* FOLLY_NONNULL pool,
+      ExpressionEvaluator* FOLLY_NULLABLE expressionEvaluator = nullptr,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr,
+      int32_t maxParallelBatches = 1);
+
+  // Waits for the batches being generated, which use 'pool_'.
+  ~TpchDataSource() override;
 
   void addSplit(std::shared_ptr<ConnectorSplit> split) override;
 
@@ -102,6 +127,21 @@ class TpchDataSource : public DataSource {
   }
 
  private:
+  // A batch being generated on 'executor_'.
+  struct Batch {
+    RowVectorPtr data;
+    std::exception_ptr error;
+    folly::SharedPromise<folly::Unit> ready;
+  };
+
+  // Starts generating batches until 'maxParallelBatches_' are in flight or
+  // the split is exhausted.
+  void scheduleBatches(uint64_t size);
+
+  // Applies 'filterExprSet_' to 'vector' and returns the projection of the
+  // passing rows on the output columns.
+  RowVectorPtr filterAndProject(RowVectorPtr vector);
+
   RowVectorPtr projectOutputColumns(RowVectorPtr vector);
 
   velox::tpch::Table tpchTable_;
@@ -124,28 +164,50 @@ class TpchDataSource : public DataSource {
   size_t completedBytes_{0};
 
   memory::MemoryPool* FOLLY_NONNULL pool_;
+  ExpressionEvaluator* FOLLY_NULLABLE expressionEvaluator_;
+  folly::Executor* FOLLY_NULLABLE executor_;
+  const int32_t maxParallelBatches_;
+
+  // The batches being generated, in the order of their rows.
+  std::deque<std::shared_ptr<Batch>> batches_;
+
+  std::unique_ptr<exec::ExprSet> filterExprSet_;
+  VectorPtr filterResult_;
+  SelectivityVector filterRows_;
+  exec::FilterEvalCtx filterEvalCtx_;
 };
 
+// Generates data on 'executor' if one is given. The config key
+// tpch.max-parallel-batches sets how many batches of a split are generated
+// at a time.
 class TpchConnector final : public Connector {
  public:
   TpchConnector(
       const std::string& id,
       std::shared_ptr<const Config> properties,
-      folly::Executor* FOLLY_NULLABLE /*executor*/)
-      : Connector(id, properties) {}
-
-  std::shared_ptr<DataSource> createDataSource(
+      folly::Executor* FOLLY_NULLABLE executor)
+      : Connector(id, properties),
+        executor_(executor),
+        maxParallelBatches_(
+            properties ? properties->get<int32_t>(
+                             "tpch.max-parallel-batches", kMaxParallelBatches)
+                       : kMaxParallelBatches) {}
+
+  std::unique_ptr<DataSource> createDataSource(
       const std::shared_ptr<const RowType>& outputType,
       const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
       const std::unordered_map<
           std::string,
           std::shared_ptr<connector::ColumnHandle>>& columnHandles,
       ConnectorQueryCtx* FOLLY_NONNULL connectorQueryCtx) override final {
-    return std::make_shared<TpchDataSource>(
+    return std::make_unique<TpchDataSource>(
         outputType,
         tableHandle,
         columnHandles,
-        connectorQueryCtx->memoryPool());
+        connectorQueryCtx->memoryPool(),
+        connectorQueryCtx->expressionEvaluator(),
+        executor_,
+        maxParallelBatches_);
   }
 
   std::shared_ptr<DataSink> createDataSink(
@@ -155,6 +217,16 @@ class TpchConnector final : public Connector {
       ConnectorQueryCtx* FOLLY_NONNULL /*connectorQueryCtx*/) override final {
     VELOX_NYI("TpchConnector does not support data sink.");
   }
+
+  folly::Executor* FOLLY_NULLABLE executor() const override {
+    return executor_;
+  }
+
+ private:
+  static constexpr int32_t kMaxParallelBatches = 4;
+
+  folly::Executor* FOLLY_NULLABLE executor_;
+  const int32_t maxParallelBatches_;
 };
 
 class TpchConnectorFactory : public ConnectorFactory {
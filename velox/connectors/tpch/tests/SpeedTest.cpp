@@ -15,6 +15,7 @@
  */
 
 #include <fmt/format.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/init/Init.h>
 #include <chrono>
 
@@ -48,6 +49,18 @@ DEFINE_int32(
     1,
     "Maximum number of drivers (threads) per pipeline.");
 
+DEFINE_int32(
+    num_generator_threads,
+    0,
+    "If non-0, the connector generates several batches of each split "
+    "concurrently on this many threads.");
+
+DEFINE_string(
+    filter,
+    "",
+    "Optional filter over the columns of the table that the connector "
+    "applies to the generated rows.");
+
 using namespace facebook::velox;
 using namespace facebook::velox::exec::test;
 
@@ -56,10 +69,14 @@ using std::chrono::system_clock;
 class TpchSpeedTest {
  public:
   TpchSpeedTest() {
+    if (FLAGS_num_generator_threads > 0) {
+      executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+          FLAGS_num_generator_threads);
+    }
     auto tpchConnector =
         connector::getConnectorFactory(
             connector::tpch::TpchConnectorFactory::kTpchConnectorName)
-            ->newConnector(kTpchConnectorId_, nullptr);
+            ->newConnector(kTpchConnectorId_, nullptr, executor_.get());
     connector::registerConnector(tpchConnector);
   }
 
@@ -75,7 +92,10 @@ class TpchSpeedTest {
     auto plan =
         PlanBuilder()
             .tableScan(
-                table, folly::copy(getTableSchema(table)->names()), scaleFactor)
+                table,
+                folly::copy(getTableSchema(table)->names()),
+                scaleFactor,
+                FLAGS_filter)
             .capturePlanNodeId(scanId)
             .planNode();
 
@@ -166,6 +186,7 @@ class TpchSpeedTest {
   }
 
   const std::string kTpchConnectorId_{"test-tpch"};
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
 
   size_t totalRows_{0};
   size_t totalBytes_{0};
@@ -15,6 +15,7 @@
  */
 
 #include "velox/connectors/tpch/TpchConnector.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/init/Init.h>
 #include "gtest/gtest.h"
 #include "velox/common/base/tests/GTestUtils.h"
@@ -283,6 +284,67 @@ TEST_F(TpchConnectorTest, orderDateCount) {
   EXPECT_EQ(9, orderDate->size());
 }
 
+// The filter of the table handle can use columns that are not projected out.
+TEST_F(TpchConnectorTest, filterPushdown) {
+  auto plan =
+      PlanBuilder()
+          .tableScan(Table::TBL_NATION, {"n_name"}, 1, "n_regionkey = 1")
+          .planNode();
+
+  auto output = getResults(plan, {makeTpchSplit()});
+  auto expected = makeRowVector({makeFlatVector<StringView>({
+      "ARGENTINA",
+      "BRAZIL",
+      "CANADA",
+      "PERU",
+      "UNITED STATES",
+  })});
+  test::assertEqualVectors(expected, output);
+
+  plan = PlanBuilder()
+             .tableScan(Table::TBL_NATION, {"n_name"}, 1, "n_regionkey > 10")
+             .planNode();
+  EXPECT_EQ(0, getResults(plan, {makeTpchSplit()})->size());
+}
+
+// Generates batches of several splits concurrently on the executor of the
+// connector and checks that the result is the same as without an executor.
+TEST_F(TpchConnectorTest, parallelGeneration) {
+  auto plan =
+      PlanBuilder()
+          .tableScan(
+              Table::TBL_LINEITEM,
+              {"l_orderkey", "l_linenumber", "l_comment"},
+              0.01,
+              "l_quantity < 10.0")
+          .planNode();
+  auto makeSplits = [&]() {
+    std::vector<exec::Split> splits;
+    for (auto i = 0; i < 3; ++i) {
+      splits.emplace_back(makeTpchSplit(3, i));
+    }
+    return splits;
+  };
+  auto expected = getResults(plan, makeSplits());
+  ASSERT_GT(expected->size(), 0);
+
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  connector::unregisterConnector(kTpchConnectorId);
+  connector::registerConnector(
+      connector::getConnectorFactory(
+          connector::tpch::TpchConnectorFactory::kTpchConnectorName)
+          ->newConnector(kTpchConnectorId, nullptr, executor.get()));
+
+  auto output = getResults(plan, makeSplits());
+  test::assertEqualVectors(expected, output);
+
+  connector::unregisterConnector(kTpchConnectorId);
+  connector::registerConnector(
+      connector::getConnectorFactory(
+          connector::tpch::TpchConnectorFactory::kTpchConnectorName)
+          ->newConnector(kTpchConnectorId, nullptr));
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
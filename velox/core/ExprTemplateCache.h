@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/container/F14Map.h>
+#include <mutex>
+#include "velox/common/memory/Memory.h"
+#include "velox/core/ITypedExpr.h"
+
+namespace facebook::velox::core {
+
+/// Remembers the compile-time rewrites of the expressions of a query, i.e.
+/// the typed expression trees with their constant subexpressions replaced by
+/// the values they fold to, keyed on a fingerprint of the source trees. The
+/// Drivers of all the Tasks of the query that compile the same expressions,
+/// e.g. the FilterProject of each Driver of a pipeline, then skip evaluating
+/// the constant subexpressions. The trees are immutable and shared, while
+/// each ExprSet still makes its own Exprs for their per-Driver evaluation
+/// state. The folded values are copied into a pool owned by 'this' since the
+/// pool they were folded in belongs to one Driver.
+class ExprTemplateCache {
+ public:
+  using Template = std::shared_ptr<const std::vector<TypedExprPtr>>;
+
+  struct Stats {
+    uint64_t numHits{0};
+    uint64_t numMisses{0};
+    size_t numEntries{0};
+  };
+
+  static constexpr int32_t kMaxEntries = 1'000;
+
+  explicit ExprTemplateCache(memory::MemoryPool* parentPool)
+      : parentPool_(parentPool) {}
+
+  /// Returns the folded trees for 'fingerprint' or nullptr if none.
+  Template find(const std::string& fingerprint) {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = templates_.find(fingerprint);
+    if (it == templates_.end()) {
+      ++stats_.numMisses;
+      return nullptr;
+    }
+    ++stats_.numHits;
+    return it->second;
+  }
+
+  /// Adds the folded trees for 'fingerprint'. Keeps the trees of a previous
+  /// insert of the same fingerprint, e.g. by a concurrently compiling Driver.
+  /// Does nothing if the cache already has kMaxEntries templates.
+  void insert(const std::string& fingerprint, Template folded) {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (templates_.size() < kMaxEntries) {
+      templates_.emplace(fingerprint, std::move(folded));
+    }
+  }
+
+  /// Returns the pool for the folded values. Created on first use.
+  memory::MemoryPool* pool() {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!pool_) {
+      pool_ = parentPool_->addScopedChild("exprTemplates");
+    }
+    return pool_.get();
+  }
+
+  Stats stats() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto stats = stats_;
+    stats.numEntries = templates_.size();
+    return stats;
+  }
+
+ private:
+  memory::MemoryPool* const parentPool_;
+  mutable std::mutex mutex_;
+  // Declared before 'templates_' so that the folded values are freed first.
+  std::unique_ptr<memory::MemoryPool> pool_;
+  folly::F14FastMap<std::string, Template> templates_;
+  Stats stats_;
+};
+
+} // namespace facebook::velox::core
@@ -198,7 +198,9 @@ class CallTypedExpr : public ITypedExpr {
     if (!casted) {
       return false;
     }
-    if (casted->name() != this->name()) {
+    // Calls of the same function on the same inputs may differ in return
+    // type, e.g. when the planner resolves the type of an output field.
+    if (casted->name() != this->name() || *casted->type() != *this->type()) {
       return false;
     }
     return std::equal(
@@ -333,8 +335,9 @@ class ConcatTypedExpr : public ITypedExpr {
   }
 
   bool operator==(const ITypedExpr& other) const override {
-    const auto* casted = dynamic_cast<const FieldAccessTypedExpr*>(&other);
-    if (!casted) {
+    const auto* casted = dynamic_cast<const ConcatTypedExpr*>(&other);
+    // The field names are part of the type.
+    if (!casted || *casted->type() != *this->type()) {
       return false;
     }
     return std::equal(
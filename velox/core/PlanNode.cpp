@@ -63,7 +63,9 @@ AggregationNode::AggregationNode(
     const std::vector<CallTypedExprPtr>& aggregates,
     const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
     bool ignoreNullKeys,
-    PlanNodePtr source)
+    PlanNodePtr source,
+    const std::vector<bool>& distinctAggregates,
+    bool localMerge)
     : PlanNode(id),
       step_(step),
       groupingKeys_(groupingKeys),
@@ -72,6 +74,11 @@ AggregationNode::AggregationNode(
       aggregates_(aggregates),
       aggregateMasks_(aggregateMasks),
       ignoreNullKeys_(ignoreNullKeys),
+      distinctAggregates_(
+          distinctAggregates.empty()
+              ? std::vector<bool>(aggregates.size(), false)
+              : distinctAggregates),
+      localMerge_(localMerge),
       sources_{source},
       outputType_(getAggregationOutputType(
           groupingKeys_,
@@ -98,6 +105,42 @@ AggregationNode::AggregationNode(
         "Pre-grouped key must be one of the grouping keys: {}.",
         key->name());
   }
+
+  VELOX_CHECK_EQ(
+      distinctAggregates_.size(),
+      aggregates_.size(),
+      "Aggregation must specify a distinct flag for every aggregate");
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    if (!distinctAggregates_[i]) {
+      continue;
+    }
+    VELOX_USER_CHECK(
+        step_ == Step::kSingle,
+        "DISTINCT aggregates are supported only in single aggregation: {}",
+        aggregateNames_[i]);
+    VELOX_USER_CHECK(
+        !aggregates_[i]->inputs().empty(),
+        "DISTINCT aggregate must have arguments: {}",
+        aggregateNames_[i]);
+    for (const auto& input : aggregates_[i]->inputs()) {
+      VELOX_USER_CHECK_NOT_NULL(
+          std::dynamic_pointer_cast<const FieldAccessTypedExpr>(input),
+          "Arguments of DISTINCT aggregate must be columns: {}",
+          aggregateNames_[i]);
+    }
+  }
+
+  if (localMerge_) {
+    VELOX_USER_CHECK(
+        step_ == Step::kSingle || step_ == Step::kFinal,
+        "Local merge is supported only in final or single aggregation");
+    VELOX_USER_CHECK(
+        !groupingKeys_.empty() && !aggregates_.empty(),
+        "Local merge requires grouping keys and aggregates");
+    VELOX_USER_CHECK(
+        preGroupedKeys_.empty() && !hasDistinctAggregates(),
+        "Local merge does not support pre-grouped keys or DISTINCT aggregates");
+  }
 }
 
 namespace {
@@ -134,6 +177,9 @@ void addKeys(std::stringstream& stream, const std::vector<TypedExprPtr>& keys) {
 
 void AggregationNode::addDetails(std::stringstream& stream) const {
   stream << stepName(step_) << " ";
+  if (localMerge_) {
+    stream << "LOCAL MERGE ";
+  }
 
   if (!groupingKeys_.empty()) {
     stream << "[";
@@ -145,7 +191,20 @@ void AggregationNode::addDetails(std::stringstream& stream) const {
     if (i > 0) {
       stream << ", ";
     }
-    stream << aggregateNames_[i] << " := " << aggregates_[i]->toString();
+    stream << aggregateNames_[i] << " := ";
+    if (distinctAggregates_[i]) {
+      const auto& aggregate = aggregates_[i];
+      stream << aggregate->name() << "(DISTINCT ";
+      for (auto j = 0; j < aggregate->inputs().size(); ++j) {
+        if (j > 0) {
+          stream << ", ";
+        }
+        stream << aggregate->inputs()[j]->toString();
+      }
+      stream << ")";
+    } else {
+      stream << aggregates_[i]->toString();
+    }
   }
 }
 
@@ -230,6 +289,14 @@ void ValuesNode::addDetails(std::stringstream& stream) const {
   stream << totalCount << " rows in " << values_.size() << " vectors";
 }
 
+const std::vector<PlanNodePtr>& ArrowStreamNode::sources() const {
+  return kEmptySources;
+}
+
+void ArrowStreamNode::addDetails(std::stringstream& /* stream */) const {
+  // Nothing to add.
+}
+
 void ProjectNode::addDetails(std::stringstream& stream) const {
   stream << "expressions: ";
   for (auto i = 0; i < projections_.size(); i++) {
@@ -492,12 +559,14 @@ WindowNode::WindowNode(
     std::vector<SortOrder> sortingOrders,
     std::vector<std::string> windowColumnNames,
     std::vector<Function> windowFunctions,
+    bool inputsSorted,
     PlanNodePtr source)
     : PlanNode(std::move(id)),
       partitionKeys_(std::move(partitionKeys)),
       sortingKeys_(std::move(sortingKeys)),
       sortingOrders_(std::move(sortingOrders)),
       windowFunctions_(std::move(windowFunctions)),
+      inputsSorted_(inputsSorted),
       sources_{std::move(source)},
       outputType_(getWindowOutputType(
           sources_[0]->outputType(),
@@ -531,8 +600,18 @@ void LocalMergeNode::addDetails(std::stringstream& stream) const {
   addSortingKeys(stream, sortingKeys_, sortingOrders_);
 }
 
-void TableWriteNode::addDetails(std::stringstream& /* stream */) const {
+void TableWriteNode::addDetails(std::stringstream& stream) const {
   // TODO Add connector details.
+  if (numBuckets_ > 0) {
+    stream << "BUCKETS " << numBuckets_;
+  }
+  if (!sortingKeys_.empty()) {
+    if (numBuckets_ > 0) {
+      stream << " ";
+    }
+    stream << "SORTED BY ";
+    addSortingKeys(stream, sortingKeys_, sortingOrders_);
+  }
 }
 
 void MergeExchangeNode::addDetails(std::stringstream& stream) const {
@@ -556,8 +635,10 @@ void EnforceSingleRowNode::addDetails(std::stringstream& /* stream */) const {
 }
 
 void PartitionedOutputNode::addDetails(std::stringstream& stream) const {
-  if (broadcast_) {
+  if (kind_ == Kind::kBroadcast) {
     stream << "BROADCAST";
+  } else if (kind_ == Kind::kArbitrary) {
+    stream << "ARBITRARY";
   } else if (numPartitions_ == 1) {
     stream << "SINGLE";
   } else {
@@ -571,6 +652,17 @@ void PartitionedOutputNode::addDetails(std::stringstream& stream) const {
   }
 }
 
+void SortShuffleWriteNode::addDetails(std::stringstream& stream) const {
+  if (numPartitions_ == 1) {
+    stream << "SINGLE";
+  } else {
+    stream << "HASH(";
+    addKeys(stream, keys_);
+    stream << ") " << numPartitions_;
+  }
+  stream << " " << path_;
+}
+
 void TopNNode::addDetails(std::stringstream& stream) const {
   if (isPartial_) {
     stream << "PARTIAL ";
@@ -608,6 +700,10 @@ void WindowNode::addDetails(std::stringstream& stream) const {
   addSortingKeys(stream, sortingKeys_, sortingOrders_);
   stream << "] ";
 
+  if (inputsSorted_) {
+    stream << "inputs sorted ";
+  }
+
   auto numInputCols = sources_[0]->outputType()->size();
   auto numOutputCols = outputType_->size();
   for (auto i = numInputCols; i < numOutputCols; i++) {
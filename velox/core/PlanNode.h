@@ -18,6 +18,9 @@
 #include "velox/connectors/Connector.h"
 #include "velox/core/Expressions.h"
 
+/// Defined in <arrow/c/abi.h> or "velox/vector/arrow/Abi.h".
+struct ArrowArrayStream;
+
 namespace facebook::velox::core {
 
 typedef std::string PlanNodeId;
@@ -212,6 +215,44 @@ class ValuesNode : public PlanNode {
   const bool parallelizable_;
 };
 
+/// Produces the batches of an Arrow C stream interface ArrowArrayStream, e.g.
+/// one exported by pyarrow, as RowVectors. The batches are imported without
+/// copying where the Arrow layouts allow. The stream is read by a single
+/// driver. The caller keeps ownership of the stream, which is released by the
+/// deleter of 'arrowStream'.
+class ArrowStreamNode : public PlanNode {
+ public:
+  ArrowStreamNode(
+      const PlanNodeId& id,
+      RowTypePtr outputType,
+      std::shared_ptr<ArrowArrayStream> arrowStream)
+      : PlanNode(id),
+        outputType_(std::move(outputType)),
+        arrowStream_(std::move(arrowStream)) {
+    VELOX_CHECK_NOT_NULL(arrowStream_);
+  }
+
+  const RowTypePtr& outputType() const override {
+    return outputType_;
+  }
+
+  const std::vector<PlanNodePtr>& sources() const override;
+
+  const std::shared_ptr<ArrowArrayStream>& arrowStream() const {
+    return arrowStream_;
+  }
+
+  std::string_view name() const override {
+    return "ArrowStream";
+  }
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const RowTypePtr outputType_;
+  const std::shared_ptr<ArrowArrayStream> arrowStream_;
+};
+
 class FilterNode : public PlanNode {
  public:
   FilterNode(const PlanNodeId& id, TypedExprPtr filter, PlanNodePtr source)
@@ -362,6 +403,22 @@ class TableScanNode : public PlanNode {
           assignments_;
 };
 
+/// Calculates partition number for each row of the specified vector.
+class PartitionFunction {
+ public:
+  virtual ~PartitionFunction() = default;
+
+  /// @param input RowVector to split into partitions.
+  /// @param [out] partitions Computed partition numbers for each row in
+  /// 'input'.
+  virtual void partition(
+      const RowVector& input,
+      std::vector<uint32_t>& partitions) = 0;
+};
+
+using PartitionFunctionFactory =
+    std::function<std::unique_ptr<PartitionFunction>(int numPartitions)>;
+
 class TableWriteNode : public PlanNode {
  public:
   TableWriteNode(
@@ -370,17 +427,39 @@ class TableWriteNode : public PlanNode {
       const std::vector<std::string>& columnNames,
       const std::shared_ptr<InsertTableHandle>& insertTableHandle,
       const RowTypePtr& outputType,
-      const PlanNodePtr& source)
+      const PlanNodePtr& source,
+      int32_t numBuckets = 0,
+      PartitionFunctionFactory bucketFunctionFactory = nullptr,
+      const std::vector<FieldAccessTypedExprPtr>& sortingKeys = {},
+      const std::vector<SortOrder>& sortingOrders = {})
       : PlanNode(id),
         sources_{source},
         columns_{columns},
         columnNames_{columnNames},
         insertTableHandle_(insertTableHandle),
-        outputType_(outputType) {
+        outputType_(outputType),
+        numBuckets_(numBuckets),
+        bucketFunctionFactory_(std::move(bucketFunctionFactory)),
+        sortingKeys_(sortingKeys),
+        sortingOrders_(sortingOrders) {
     VELOX_CHECK_EQ(columns->size(), columnNames.size());
     for (const auto& column : columns->names()) {
       VELOX_CHECK(source->outputType()->containsChild(column));
     }
+    VELOX_CHECK_GE(numBuckets_, 0);
+    VELOX_CHECK(
+        numBuckets_ == 0 || bucketFunctionFactory_ != nullptr,
+        "Bucketed table write requires a bucket function");
+    VELOX_CHECK_EQ(
+        sortingKeys_.size(),
+        sortingOrders_.size(),
+        "Number of sorting keys and sorting orders in TableWrite must be the same");
+    for (const auto& key : sortingKeys_) {
+      VELOX_CHECK(
+          columns_->containsChild(key->name()),
+          "Sorting key {} of TableWrite is not a written column",
+          key->name());
+    }
   }
 
   const std::vector<PlanNodePtr>& sources() const override {
@@ -407,6 +486,27 @@ class TableWriteNode : public PlanNode {
     return insertTableHandle_;
   }
 
+  // Number of bucket files to write. 0 if the table is not bucketed.
+  int32_t numBuckets() const {
+    return numBuckets_;
+  }
+
+  // Makes the function that maps the rows of 'columns' to their bucket.
+  // Set if 'numBuckets' is not 0.
+  const PartitionFunctionFactory& bucketFunctionFactory() const {
+    return bucketFunctionFactory_;
+  }
+
+  // Columns of 'columns' on which the rows of each file are sorted. Empty if
+  // the rows are written in input order.
+  const std::vector<FieldAccessTypedExprPtr>& sortingKeys() const {
+    return sortingKeys_;
+  }
+
+  const std::vector<SortOrder>& sortingOrders() const {
+    return sortingOrders_;
+  }
+
   std::string_view name() const override {
     return "TableWrite";
   }
@@ -419,6 +519,10 @@ class TableWriteNode : public PlanNode {
   const std::vector<std::string> columnNames_;
   const std::shared_ptr<InsertTableHandle> insertTableHandle_;
   const RowTypePtr outputType_;
+  const int32_t numBuckets_;
+  const PartitionFunctionFactory bucketFunctionFactory_;
+  const std::vector<FieldAccessTypedExprPtr> sortingKeys_;
+  const std::vector<SortOrder> sortingOrders_;
 };
 
 class AggregationNode : public PlanNode {
@@ -456,6 +560,17 @@ class AggregationNode : public PlanNode {
    * @param ignoreNullKeys True if rows with at least one null key should be
    * ignored. Used when group by is a source of a join build side and grouping
    * keys are join keys.
+   * @param distinctAggregates Keeps a flag for every aggregation. If true, the
+   * aggregation sees only the distinct values of its arguments within each
+   * group, e.g. count(DISTINCT x). Can be empty if there are no such
+   * aggregations. Only supported in single aggregation since the distinct
+   * values of partial aggregations do not merge.
+   * @param localMerge True if the input of the drivers is not partitioned on
+   * the grouping keys, e.g. when the aggregation follows a partial
+   * aggregation in the same pipeline without a local exchange. Each driver
+   * then aggregates its own input and at the end, the drivers merge the
+   * groups of each hash partition of the grouping keys from each other. Only
+   * for final or single aggregations with grouping keys and aggregates.
    */
   AggregationNode(
       const PlanNodeId& id,
@@ -466,7 +581,9 @@ class AggregationNode : public PlanNode {
       const std::vector<CallTypedExprPtr>& aggregates,
       const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
       bool ignoreNullKeys,
-      PlanNodePtr source);
+      PlanNodePtr source,
+      const std::vector<bool>& distinctAggregates = {},
+      bool localMerge = false);
 
   const std::vector<PlanNodePtr>& sources() const override {
     return sources_;
@@ -504,6 +621,21 @@ class AggregationNode : public PlanNode {
     return ignoreNullKeys_;
   }
 
+  /// Has one flag per aggregation.
+  const std::vector<bool>& distinctAggregates() const {
+    return distinctAggregates_;
+  }
+
+  bool hasDistinctAggregates() const {
+    return std::find(
+               distinctAggregates_.begin(), distinctAggregates_.end(), true) !=
+        distinctAggregates_.end();
+  }
+
+  bool localMerge() const {
+    return localMerge_;
+  }
+
   std::string_view name() const override {
     return "Aggregation";
   }
@@ -520,6 +652,8 @@ class AggregationNode : public PlanNode {
   // to a boolean projection column, used to mask out rows for the aggregation.
   const std::vector<FieldAccessTypedExprPtr> aggregateMasks_;
   const bool ignoreNullKeys_;
+  const std::vector<bool> distinctAggregates_;
+  const bool localMerge_;
   const std::vector<PlanNodePtr> sources_;
   const RowTypePtr outputType_;
 };
@@ -593,7 +727,7 @@ class GroupIdNode : public PlanNode {
     return aggregationInputs_;
   }
 
-  const std::string& groupIdName() {
+  const std::string& groupIdName() const {
     return groupIdName_;
   }
 
@@ -711,22 +845,6 @@ class LocalMergeNode : public PlanNode {
   const std::vector<SortOrder> sortingOrders_;
 };
 
-/// Calculates partition number for each row of the specified vector.
-class PartitionFunction {
- public:
-  virtual ~PartitionFunction() = default;
-
-  /// @param input RowVector to split into partitions.
-  /// @param [out] partitions Computed partition numbers for each row in
-  /// 'input'.
-  virtual void partition(
-      const RowVector& input,
-      std::vector<uint32_t>& partitions) = 0;
-};
-
-using PartitionFunctionFactory =
-    std::function<std::unique_ptr<PartitionFunction>(int numPartitions)>;
-
 /// Partitions data using specified partition function. The number of partitions
 /// is determined by the parallelism of the upstream pipeline. Can be used to
 /// gather data from multiple sources.
@@ -804,11 +922,22 @@ class LocalPartitionNode : public PlanNode {
 
 class PartitionedOutputNode : public PlanNode {
  public:
+  enum class Kind {
+    /// Each row goes to the destination of its partition.
+    kPartitioned,
+    /// Each page goes to all destinations.
+    kBroadcast,
+    /// Each page goes to any one destination, the first to ask for data.
+    /// Balances the load over consumers whose speeds differ when it does
+    /// not matter which consumer gets which rows.
+    kArbitrary,
+  };
+
   PartitionedOutputNode(
       const PlanNodeId& id,
       const std::vector<TypedExprPtr>& keys,
       int numPartitions,
-      bool broadcast,
+      Kind kind,
       bool replicateNullsAndAny,
       PartitionFunctionFactory partitionFunctionFactory,
       RowTypePtr outputType,
@@ -817,7 +946,7 @@ class PartitionedOutputNode : public PlanNode {
         sources_{{std::move(source)}},
         keys_(keys),
         numPartitions_(numPartitions),
-        broadcast_(broadcast),
+        kind_(kind),
         replicateNullsAndAny_(replicateNullsAndAny),
         partitionFunctionFactory_(std::move(partitionFunctionFactory)),
         outputType_(std::move(outputType)) {
@@ -827,11 +956,16 @@ class PartitionedOutputNode : public PlanNode {
           keys_.empty(),
           "Non-empty partitioning keys require more than one partition");
     }
-    if (broadcast) {
+    if (kind_ == Kind::kBroadcast) {
       VELOX_CHECK(
           keys_.empty(),
           "Broadcast partitioning doesn't allow for partitioning keys");
     }
+    if (kind_ == Kind::kArbitrary) {
+      VELOX_CHECK(
+          keys_.empty(),
+          "Arbitrary partitioning doesn't allow for partitioning keys");
+    }
   }
 
   static std::shared_ptr<PartitionedOutputNode> broadcast(
@@ -844,7 +978,25 @@ class PartitionedOutputNode : public PlanNode {
         id,
         noKeys,
         numPartitions,
-        true,
+        Kind::kBroadcast,
+        false,
+        [](auto /*numPartitions*/) -> std::unique_ptr<PartitionFunction> {
+          VELOX_UNREACHABLE();
+        },
+        std::move(outputType),
+        std::move(source));
+  }
+
+  static std::shared_ptr<PartitionedOutputNode> arbitrary(
+      const PlanNodeId& id,
+      RowTypePtr outputType,
+      PlanNodePtr source) {
+    std::vector<TypedExprPtr> noKeys;
+    return std::make_shared<PartitionedOutputNode>(
+        id,
+        noKeys,
+        1,
+        Kind::kArbitrary,
         false,
         [](auto /*numPartitions*/) -> std::unique_ptr<PartitionFunction> {
           VELOX_UNREACHABLE();
@@ -860,7 +1012,7 @@ class PartitionedOutputNode : public PlanNode {
         id,
         noKeys,
         1,
-        false,
+        Kind::kPartitioned,
         false,
         [](auto /*numPartitions*/) -> std::unique_ptr<PartitionFunction> {
           VELOX_UNREACHABLE();
@@ -889,8 +1041,16 @@ class PartitionedOutputNode : public PlanNode {
     return numPartitions_;
   }
 
+  Kind kind() const {
+    return kind_;
+  }
+
   bool isBroadcast() const {
-    return broadcast_;
+    return kind_ == Kind::kBroadcast;
+  }
+
+  bool isArbitrary() const {
+    return kind_ == Kind::kArbitrary;
   }
 
   /// Returns true if an arbitrary row and all rows with null keys must be
@@ -915,12 +1075,82 @@ class PartitionedOutputNode : public PlanNode {
   const std::vector<PlanNodePtr> sources_;
   const std::vector<TypedExprPtr> keys_;
   const int numPartitions_;
-  const bool broadcast_;
+  const Kind kind_;
   const bool replicateNullsAndAny_;
   const PartitionFunctionFactory partitionFunctionFactory_;
   const RowTypePtr outputType_;
 };
 
+/// Writes the input to one data file sorted by partition and an index of
+/// the offsets of the partitions in the data file. Unlike
+/// PartitionedOutputNode, this does not keep a buffer per destination, so
+/// the memory does not grow with the number of partitions. The input is
+/// sorted in memory and spilled if it does not fit. The files are
+/// '<path>.data' and '<path>.index'. An Exchange reads a partition with a
+/// RemoteConnectorSplit for "sortshuffle://<path>", see
+/// SortShuffleExchangeSource. The files are not deleted by Velox.
+class SortShuffleWriteNode : public PlanNode {
+ public:
+  SortShuffleWriteNode(
+      const PlanNodeId& id,
+      const std::vector<TypedExprPtr>& keys,
+      int numPartitions,
+      PartitionFunctionFactory partitionFunctionFactory,
+      const std::string& path,
+      PlanNodePtr source)
+      : PlanNode(id),
+        sources_{{std::move(source)}},
+        keys_(keys),
+        numPartitions_(numPartitions),
+        partitionFunctionFactory_(std::move(partitionFunctionFactory)),
+        path_(path) {
+    VELOX_CHECK(numPartitions > 0, "numPartitions must be greater than zero");
+    if (numPartitions == 1) {
+      VELOX_CHECK(
+          keys_.empty(),
+          "Non-empty partitioning keys require more than one partition");
+    }
+    VELOX_CHECK(!path_.empty(), "Sort shuffle path must not be empty");
+  }
+
+  const RowTypePtr& outputType() const override {
+    return sources_[0]->outputType();
+  }
+
+  const std::vector<PlanNodePtr>& sources() const override {
+    return sources_;
+  }
+
+  const std::vector<TypedExprPtr>& keys() const {
+    return keys_;
+  }
+
+  int numPartitions() const {
+    return numPartitions_;
+  }
+
+  const PartitionFunctionFactory& partitionFunctionFactory() const {
+    return partitionFunctionFactory_;
+  }
+
+  const std::string& path() const {
+    return path_;
+  }
+
+  std::string_view name() const override {
+    return "SortShuffleWrite";
+  }
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::vector<PlanNodePtr> sources_;
+  const std::vector<TypedExprPtr> keys_;
+  const int numPartitions_;
+  const PartitionFunctionFactory partitionFunctionFactory_;
+  const std::string path_;
+};
+
 enum class JoinType {
   kInner,
   kLeft,
@@ -1063,6 +1293,19 @@ class AbstractJoinNode : public PlanNode {
 /// Represents inner/outer/semi/anti hash joins. Translates to an
 /// exec::HashBuild and exec::HashProbe. A separate pipeline is produced for the
 /// build side when generating exec::Operators.
+///
+/// If 'useHashTableCache' is true, the build side input is the same in all
+/// the tasks of the query on a worker, e.g. in a broadcast join. The first
+/// task to start builds the hash table and the other tasks of the query probe
+/// the same table instead of building their own. Only supported for inner,
+/// left and left semi joins since these leave the table unchanged while
+/// probing.
+///
+/// If 'hashTableCacheKey' is not empty, the table is also kept after the query
+/// finishes and later queries with the same key probe it without reading the
+/// build side. The key must identify the build side input, e.g. combine the
+/// table handle, the splits and the modification times of their files, and is
+/// supplied by the planner. Requires 'useHashTableCache'.
 class HashJoinNode : public AbstractJoinNode {
  public:
   HashJoinNode(
@@ -1073,7 +1316,9 @@ class HashJoinNode : public AbstractJoinNode {
       TypedExprPtr filter,
       PlanNodePtr left,
       PlanNodePtr right,
-      const RowTypePtr outputType)
+      const RowTypePtr outputType,
+      bool useHashTableCache = false,
+      std::string hashTableCacheKey = "")
       : AbstractJoinNode(
             id,
             joinType,
@@ -1082,11 +1327,34 @@ class HashJoinNode : public AbstractJoinNode {
             filter,
             left,
             right,
-            outputType) {}
+            outputType),
+        useHashTableCache_(useHashTableCache),
+        hashTableCacheKey_(std::move(hashTableCacheKey)) {
+    VELOX_USER_CHECK(
+        !useHashTableCache_ || isInnerJoin() || isLeftJoin() ||
+            isLeftSemiJoin(),
+        "Hash table cache is not supported for {} join",
+        joinTypeName(joinType));
+    VELOX_USER_CHECK(
+        hashTableCacheKey_.empty() || useHashTableCache_,
+        "Hash table cache key requires the hash table cache");
+  }
 
   std::string_view name() const override {
     return "HashJoin";
   }
+
+  bool useHashTableCache() const {
+    return useHashTableCache_;
+  }
+
+  const std::string& hashTableCacheKey() const {
+    return hashTableCacheKey_;
+  }
+
+ private:
+  const bool useHashTableCache_;
+  const std::string hashTableCacheKey_;
 };
 
 /// Represents inner/outer/semi/anti merge joins. Translates to an
@@ -1501,6 +1769,10 @@ class WindowNode : public PlanNode {
   /// @param windowColumnNames specifies the output column
   /// names for each window function column. So
   /// windowColumnNames.length() = windowFunctions.length().
+  /// @param inputsSorted true if the input rows of each partition arrive
+  /// together and ordered by the sorting keys, e.g. from a MergeExchange or
+  /// a sorted table. The Window operator then processes the partitions as
+  /// they arrive instead of buffering and sorting the whole input.
   WindowNode(
       PlanNodeId id,
       std::vector<FieldAccessTypedExprPtr> partitionKeys,
@@ -1508,6 +1780,7 @@ class WindowNode : public PlanNode {
       std::vector<SortOrder> sortingOrders,
       std::vector<std::string> windowColumnNames,
       std::vector<Function> windowFunctions,
+      bool inputsSorted,
       PlanNodePtr source);
 
   const std::vector<PlanNodePtr>& sources() const override {
@@ -1536,6 +1809,10 @@ class WindowNode : public PlanNode {
     return windowFunctions_;
   }
 
+  bool inputsSorted() const {
+    return inputsSorted_;
+  }
+
   std::string_view name() const override {
     return "Window";
   }
@@ -1550,6 +1827,8 @@ class WindowNode : public PlanNode {
 
   const std::vector<Function> windowFunctions_;
 
+  const bool inputsSorted_;
+
   const std::vector<PlanNodePtr> sources_;
 
   const RowTypePtr outputType_;
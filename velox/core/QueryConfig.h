@@ -54,15 +54,49 @@ class QueryConfig {
 
   // Whether to track CPU usage for individual expressions (supported by call
   // and cast expressions). False by default. Can be expensive when processing
-  // small batches, e.g. < 10K rows.
+  // small batches, e.g. < 10K rows. If true, FilterProject also reports the
+  // stats of its expressions by function name in its runtime stats.
   static constexpr const char* kExprTrackCpuUsage =
       "expression.track_cpu_usage";
 
+  // Max number of distinct values of a string argument for which a
+  // deterministic function remembers its results across batches, so that
+  // expensive functions over low cardinality columns, e.g. regexes or
+  // json_extract, run once per value. A function stops remembering when it
+  // sees more distinct values. 0, the default, disables the memo.
+  static constexpr const char* kExprValueMemoMaxEntries =
+      "expression.value_memo_max_entries";
+
+  // If true, the Drivers of a query that compile the same expressions share
+  // the expression trees with their constant subexpressions folded, so that
+  // only the first compilation evaluates them. False by default. See
+  // ExprTemplateCache.
+  static constexpr const char* kExprTemplateCacheEnabled =
+      "expression.template_cache_enabled";
+
   // Whether to track CPU usage for stages of individual operators. True by
   // default. Can be expensive when processing small batches, e.g. < 10K rows.
   static constexpr const char* kOperatorTrackCpuUsage =
       "driver.track_operator_cpu_usage";
 
+  // Whether to count the cycles, instructions, LLC misses, dTLB misses and
+  // branch mispredictions of Operator::addInput() and getOutput() with the
+  // hardware performance counters of the CPU. The counts are added to the
+  // runtime stats of the operator. False by default. Each call then reads
+  // the counters twice with a system call. Has no effect if the counters
+  // can't be opened, e.g. because of /proc/sys/kernel/perf_event_paranoid.
+  static constexpr const char* kOperatorTrackPerfCounters =
+      "driver.track_operator_perf_counters";
+
+  // A Driver that has run this long on an executor thread yields the thread
+  // and goes to the end of the executor's queue, so that long running
+  // Drivers do not hold up the others. 0, the default, means no time limit.
+  static constexpr const char* kDriverTimeSliceMs = "driver.time_slice_ms";
+
+  // Whether to record when the Drivers of a Task are queued, on thread and
+  // blocked. False by default. See Task::driverTrace().
+  static constexpr const char* kDriverTraceEnabled = "driver.trace_enabled";
+
   // Flags used to configure the CAST operator:
 
   // This flag makes the Row conversion to by applied
@@ -79,6 +113,32 @@ class QueryConfig {
   static constexpr const char* kMaxLocalExchangeBufferSize =
       "max_local_exchange_buffer_size";
 
+  /// Maximum number of Drivers a pipeline that scans a table into a local
+  /// exchange grows to at runtime. The Task adds a Driver to such a pipeline
+  /// while the local exchange is drained and splits are waiting, and retires
+  /// Drivers while the local exchange is full. 0, the default, keeps the
+  /// number of Drivers fixed.
+  static constexpr const char* kAdaptiveMaxDriversPerPipeline =
+      "adaptive_max_drivers_per_pipeline";
+
+  /// Minimum time between two changes of the number of Drivers of a pipeline.
+  static constexpr const char* kAdaptiveDriversIntervalMs =
+      "adaptive_drivers_interval_ms";
+
+  /// If true and the Drivers of a Task fit on the CPUs of one NUMA node, the
+  /// Task is placed on the least loaded such node and its Drivers run on the
+  /// CPUs of that node, so that the memory they touch stays local.
+  static constexpr const char* kNumaAwareTasks = "numa_aware_tasks";
+
+  /// In grouped execution, a Task starts another split group only while its
+  /// memory, plus as much again as the average running group uses, stays
+  /// within this fraction of the memory limit of the Task. A group is always
+  /// started when none runs. The number of concurrent split groups passed to
+  /// Task::start() stays the maximum. 0, the default, or a Task without a
+  /// memory limit, runs that many groups regardless of memory.
+  static constexpr const char* kSplitGroupsMemoryFraction =
+      "split_groups_memory_fraction";
+
   static constexpr const char* kMaxPartialAggregationMemory =
       "max_partial_aggregation_memory";
 
@@ -91,17 +151,111 @@ class QueryConfig {
   static constexpr const char* kPartialAggregationGoodPct =
       "partial_aggregation_reduction_ratio_threshold";
 
+  /// Number of input rows over which a partial aggregation estimates the
+  /// number of distinct grouping keys before deciding whether to aggregate
+  /// the following input or to pass it through. The estimate is repeated
+  /// after each flush and, while passing rows through, for every this many
+  /// rows. 0 disables the estimate.
+  static constexpr const char* kAbandonPartialAggregationMinRows =
+      "abandon_partial_aggregation_min_rows";
+
+  /// If the estimated number of distinct grouping keys is at least this
+  /// percentage of the rows, partial aggregation stops aggregating and turns
+  /// each input row into an intermediate result of its own.
+  static constexpr const char* kAbandonPartialAggregationMinPct =
+      "abandon_partial_aggregation_min_pct";
+
+  /// If true, a partial aggregation checks whether each input batch is
+  /// clustered on the grouping keys, i.e. has long runs of rows with identical
+  /// keys. If so, it outputs the groups that end within the batch right away,
+  /// as if the input were declared pre-grouped on all grouping keys.
+  static constexpr const char* kPartialAggregationDetectClusteredInput =
+      "partial_aggregation_detect_clustered_input";
+
+  /// If true, hash aggregations whose accumulators are all fixed width keep
+  /// these in one array per aggregate, indexed by group number, instead of
+  /// in the rows of the hash table. Updating one aggregate then touches only
+  /// its own array, which helps aggregations with many aggregates. Such
+  /// aggregations do not spill.
+  static constexpr const char* kAggregationColumnarAccumulators =
+      "aggregation_columnar_accumulators";
+
+  /// If true, a partial or single aggregation over a GroupId computes the
+  /// grouping sets from a single aggregation of the input on all grouping
+  /// keys, accumulating each coarser grouping set from the intermediate
+  /// results of these groups, instead of aggregating the input once per
+  /// grouping set. Applies when the aggregates take their inputs from the
+  /// aggregation inputs of the GroupId and use no masks or DISTINCT. Such
+  /// aggregations do not spill and do not flush partial results on memory
+  /// limits.
+  static constexpr const char* kAggregationDeriveGroupingSets =
+      "aggregation_derive_grouping_sets";
+
   static constexpr const char* kMaxPartitionedOutputBufferSize =
       "driver.max-page-partitioning-buffer-size";
 
+  /// Compression codec of the pages a PartitionedOutput sends to the
+  /// exchanges of the consumers: "none", "lz4" or "zstd". The consumers must
+  /// use the same codec. A page that compresses poorly is sent uncompressed.
+  /// "none" by default.
+  static constexpr const char* kExchangeCompressionCodec =
+      "exchange_compression_codec";
+
+  /// Number of splits after the current one that a TableScan prepares in the
+  /// background, i.e. opens the file and reads its metadata, if the
+  /// connector supports it. 0 disables preloading.
+  static constexpr const char* kMaxSplitPreloadPerDriver =
+      "max_split_preload_per_driver";
+
   /// Preffered number of rows to be returned by operators from
   /// Operator::getOutput.
   static constexpr const char* kPreferredOutputBatchSize =
       "preferred_output_batch_size";
 
+  /// Preferred size in bytes of the batches returned by operators that size
+  /// their output by the width of its rows, see Operator::outputBatchRows().
+  /// 0, the default, sizes batches by kPreferredOutputBatchSize rows only.
+  static constexpr const char* kPreferredOutputBatchBytes =
+      "preferred_output_batch_bytes";
+
+  /// Maximum number of rows in a batch sized by kPreferredOutputBatchBytes.
+  static constexpr const char* kMaxOutputBatchRows = "max_output_batch_rows";
+
   static constexpr const char* kHashAdaptivityEnabled =
       "driver.hash_adaptivity_enabled";
 
+  /// If true, a hash join on a single integer key whose build side has too
+  /// many distinct values for an exact IN-list filter pushes a Bloom filter
+  /// on the build side keys into the probe side table scan. False by default.
+  static constexpr const char* kHashJoinBloomFilterEnabled =
+      "driver.hash_join_bloom_filter_enabled";
+
+  /// Max number of build side rows for which the hash join Bloom filter is
+  /// made. The filter takes 2 bytes per row.
+  static constexpr const char* kHashJoinBloomFilterMaxRows =
+      "driver.hash_join_bloom_filter_max_rows";
+
+  /// Minimum size in bytes of a join hash table for which probe rows are
+  /// probed in the order of the high bits of their bucket number. This keeps
+  /// the probes of a batch within a cache-friendly part of a large table. 0
+  /// disables partitioned probing.
+  static constexpr const char* kHashProbePartitionedMinTableSize =
+      "driver.hash_probe_partitioned_min_table_size";
+
+  /// Number of probes of a hash join or hash aggregation for which the hash
+  /// table buckets are prefetched before any of them is compared. 0 disables
+  /// prefetching.
+  static constexpr const char* kHashTablePrefetchBatchSize =
+      "driver.hash_table_prefetch_batch_size";
+
+  /// Minimum percentage of the build side rows of an inner or left hash join
+  /// that share a join key for the key to be treated as a heavy hitter. The
+  /// probe rows with a heavy hitter key are spread over all the probe drivers
+  /// of the join instead of being expanded by the driver that received them.
+  /// 0 disables the detection.
+  static constexpr const char* kHashJoinSkewedKeyMinPct =
+      "driver.hash_join_skewed_key_min_pct";
+
   static constexpr const char* kAdaptiveFilterReorderingEnabled =
       "driver.adaptive_filter_reordering_enabled";
 
@@ -110,9 +264,44 @@ class QueryConfig {
   /// Global enable spilling flag.
   static constexpr const char* kSpillEnabled = "spill_enabled";
 
-  /// Spill path. "/tmp" by default.
+  /// Spill path. "/tmp" by default. May be on any registered file system,
+  /// e.g. an object store.
   static constexpr const char* kSpillPath = "spiller-spill-path";
 
+  /// Size of the chunks in which spill files are written. Appends are buffered
+  /// up to this size, so that a spill file on a remote file system is
+  /// uploaded in a few large parts. 0 disables the buffering.
+  static constexpr const char* kSpillWriteBufferSize =
+      "spill_write_buffer_size";
+
+  /// Directory on local disk for spill files in front of "spiller-spill-path".
+  /// Spill files are written here while the local spill files of the process
+  /// stay within "spill_local_max_bytes" and to the spill path after that.
+  /// Not set by default.
+  static constexpr const char* kSpillLocalPath = "spill_local_path";
+
+  static constexpr const char* kSpillLocalMaxBytes = "spill_local_max_bytes";
+
+  /// The maximum bytes of the spill files of a query on disk. A spilling
+  /// operator stops taking input while the query is above this, until other
+  /// operators of the query release their spill files. 0, the default, means
+  /// no limit.
+  static constexpr const char* kMaxSpillBytes = "max_spill_bytes";
+
+  /// Size of the read buffer of each spill file being read back.
+  static constexpr const char* kSpillReadBufferSize = "spill_read_buffer_size";
+
+  /// If true, the next read buffer of each spill file being read is filled on
+  /// the spill executor while the current one is consumed. Takes effect only
+  /// if the query has a spill executor.
+  static constexpr const char* kSpillReadAheadEnabled =
+      "spill_read_ahead_enabled";
+
+  /// The maximum number of spill files merged at once when restoring sorted
+  /// spilled data. More files are first merged into fewer, larger files in
+  /// passes of this many files each. 0, the default, means no limit.
+  static constexpr const char* kSpillMaxMergeFanIn = "spill_max_merge_fan_in";
+
   /// Aggregation spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kAggregationSpillEnabled =
       "aggregation_spill_enabled";
@@ -120,9 +309,46 @@ class QueryConfig {
   /// Join spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kJoinSpillEnabled = "join_spill_enabled";
 
+  /// The max number of right side rows with the same join keys that a merge
+  /// join keeps in memory. A longer run of matching rows is spilled to disk
+  /// and streamed back while producing the output. Only applies if
+  /// "spill_enabled" and "join_spill_enabled" are set.
+  static constexpr const char* kMergeJoinSpillMatchRows =
+      "merge_join_spill_match_rows";
+
+  /// The max bytes of build side input that a cross join driver keeps in
+  /// memory. Beyond this, the build side is spilled to disk in blocks and each
+  /// probe batch is joined with the blocks read back one at a time. Only
+  /// applies if "spill_enabled" and "join_spill_enabled" are set.
+  static constexpr const char* kCrossJoinSpillBuildBytes =
+      "cross_join_spill_build_bytes";
+
   /// OrderBy spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kOrderBySpillEnabled = "order_by_spill_enabled";
 
+  /// If true, the drivers of a partial OrderBy sort cooperatively and each
+  /// returns a range of the sorted rows of all drivers, so that a LocalMerge
+  /// over the OrderBy concatenates the ranges instead of merging. Does not
+  /// apply if OrderBy spilling is enabled.
+  static constexpr const char* kOrderByParallelSortEnabled =
+      "order_by_parallel_sort_enabled";
+
+  /// Window spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kWindowSpillEnabled = "window_spill_enabled";
+
+  /// TopN spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kTopNSpillEnabled = "topn_spill_enabled";
+
+  /// Sort shuffle write spilling flag, only applies if "spill_enabled" flag
+  /// is set.
+  static constexpr const char* kSortShuffleSpillEnabled =
+      "sort_shuffle_spill_enabled";
+
+  /// Spilling flag of sorted or bucketed table writes, only applies if
+  /// "spill_enabled" flag is set.
+  static constexpr const char* kTableWriterSpillEnabled =
+      "table_writer_spill_enabled";
+
   /// The max memory that a final aggregation can use before spilling. If it 0,
   /// then there is no limit.
   static constexpr const char* kAggregationSpillMemoryThreshold =
@@ -133,6 +359,16 @@ class QueryConfig {
   static constexpr const char* kOrderBySpillMemoryThreshold =
       "order_by_spill_memory_threshold";
 
+  /// The max memory that a window can use before spilling. If it 0, then
+  /// there is no limit.
+  static constexpr const char* kWindowSpillMemoryThreshold =
+      "window_spill_memory_threshold";
+
+  /// The max memory that a TopN can use before spilling. If it 0, then there
+  /// is no limit.
+  static constexpr const char* kTopNSpillMemoryThreshold =
+      "topn_spill_memory_threshold";
+
   static constexpr const char* kTestingSpillPct = "testing.spill-pct";
 
   static constexpr const char* kSpillStartPartitionBit =
@@ -140,12 +376,78 @@ class QueryConfig {
 
   static constexpr const char* kSpillPartitionBits = "spiller-partition-bits";
 
+  /// The max level of recursive spilling. A hash join build side partition
+  /// that is restored from disk and still doesn't fit in memory is spilled
+  /// again on the next "spiller-partition-bits" of the hash, up to this
+  /// level. 0 is the level of the initial spilling.
+  static constexpr const char* kMaxSpillLevel = "max_spill_level";
+
   static constexpr const char* kSpillFileSizeFactor =
       "spiller-file-size-factor";
 
   static constexpr const char* kSpillableReservationGrowthPct =
       "spillable-reservation-growth-pct";
 
+  /// If true, a spilling operator that fails to grow its memory reservation
+  /// first asks its Task to spill the operators with the most memory, which
+  /// pauses the other drivers of the Task meanwhile. The operator spills
+  /// itself only if this doesn't free enough memory. Applies to order by,
+  /// aggregation, window and top-n spilling. false by default.
+  static constexpr const char* kSpillArbitrationEnabled =
+      "spill_arbitration_enabled";
+
+  /// Priority of the query when the memory arbitrator of the process
+  /// revokes memory, see memory::MemoryArbitrator. The queries with a lower
+  /// priority are reclaimed first and a query can only revoke memory from
+  /// queries of the same or lower priority. 0 by default.
+  static constexpr const char* kMemoryReclaimPriority =
+      "memory_reclaim_priority";
+
+  /// Tenant of the query in the AsyncDataCache, a number below
+  /// cache::kMaxCacheTenants. The cache entries read by the query are
+  /// accounted to the tenant, which may have a quota, see
+  /// cache::AsyncDataCache::setTenantQuota(). 0, the default, is no tenant.
+  static constexpr const char* kCacheTenant = "cache_tenant";
+
+  /// Compression codec of spill files: "none", "lz4", "zstd", "snappy" or
+  /// "zlib". Applies to all spilling operators unless overridden by one of the
+  /// per-operator options below. "none" by default.
+  static constexpr const char* kSpillCompressionCodec =
+      "spill_compression_codec";
+
+  /// Compression codec of aggregation spill files.
+  static constexpr const char* kAggregationSpillCompressionCodec =
+      "aggregation_spill_compression_codec";
+
+  /// Compression codec of join spill files, for both the build and the probe
+  /// side.
+  static constexpr const char* kJoinSpillCompressionCodec =
+      "join_spill_compression_codec";
+
+  /// Compression codec of order by spill files.
+  static constexpr const char* kOrderBySpillCompressionCodec =
+      "order_by_spill_compression_codec";
+
+  /// Compression codec of window spill files.
+  static constexpr const char* kWindowSpillCompressionCodec =
+      "window_spill_compression_codec";
+
+  /// Compression codec of TopN spill files.
+  static constexpr const char* kTopNSpillCompressionCodec =
+      "topn_spill_compression_codec";
+
+  /// Compression codec of sort shuffle write spill files.
+  static constexpr const char* kSortShuffleSpillCompressionCodec =
+      "sort_shuffle_spill_compression_codec";
+
+  /// Compression codec of sorted or bucketed table write spill files.
+  static constexpr const char* kTableWriterSpillCompressionCodec =
+      "table_writer_spill_compression_codec";
+
+  double splitGroupsMemoryFraction() const {
+    return get<double>(kSplitGroupsMemoryFraction, 0);
+  }
+
   uint64_t maxPartialAggregationMemoryUsage() const {
     static constexpr uint64_t kDefault = 1L << 24;
     return get<uint64_t>(kMaxPartialAggregationMemory, kDefault);
@@ -166,11 +468,41 @@ class QueryConfig {
     return get<double>(kPartialAggregationGoodPct, kDefault);
   }
 
+  int64_t abandonPartialAggregationMinRows() const {
+    return get<int64_t>(kAbandonPartialAggregationMinRows, 0);
+  }
+
+  int32_t abandonPartialAggregationMinPct() const {
+    return get<int32_t>(kAbandonPartialAggregationMinPct, 80);
+  }
+
+  bool partialAggregationDetectClusteredInput() const {
+    return get<bool>(kPartialAggregationDetectClusteredInput, false);
+  }
+
+  bool aggregationColumnarAccumulators() const {
+    return get<bool>(kAggregationColumnarAccumulators, false);
+  }
+
+  bool aggregationDeriveGroupingSets() const {
+    return get<bool>(kAggregationDeriveGroupingSets, false);
+  }
+
   uint64_t orderBySpillMemoryThreshold() const {
     static constexpr uint64_t kDefault = 0;
     return get<uint64_t>(kOrderBySpillMemoryThreshold, kDefault);
   }
 
+  uint64_t windowSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kWindowSpillMemoryThreshold, kDefault);
+  }
+
+  uint64_t topNSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kTopNSpillMemoryThreshold, kDefault);
+  }
+
   // Returns the target size for a Task's buffered output. The
   // producer Drivers are blocked when the buffered size exceeds
   // this. The Drivers are resumed when the buffered size goes below
@@ -180,15 +512,43 @@ class QueryConfig {
     return get<uint64_t>(kMaxPartitionedOutputBufferSize, kDefault);
   }
 
+  std::string exchangeCompressionCodec() const {
+    return get<std::string>(kExchangeCompressionCodec, std::string("none"));
+  }
+
+  int32_t maxSplitPreloadPerDriver() const {
+    return get<int32_t>(kMaxSplitPreloadPerDriver, 2);
+  }
+
   uint64_t maxLocalExchangeBufferSize() const {
     static constexpr uint64_t kDefault = 32UL << 20;
     return get<uint64_t>(kMaxLocalExchangeBufferSize, kDefault);
   }
 
+  uint32_t adaptiveMaxDriversPerPipeline() const {
+    return get<uint32_t>(kAdaptiveMaxDriversPerPipeline, 0);
+  }
+
+  uint64_t adaptiveDriversIntervalMs() const {
+    return get<uint64_t>(kAdaptiveDriversIntervalMs, 100);
+  }
+
+  bool numaAwareTasks() const {
+    return get<bool>(kNumaAwareTasks, false);
+  }
+
   uint32_t preferredOutputBatchSize() const {
     return get<uint32_t>(kPreferredOutputBatchSize, 1024);
   }
 
+  uint64_t preferredOutputBatchBytes() const {
+    return get<uint64_t>(kPreferredOutputBatchBytes, 0);
+  }
+
+  uint32_t maxOutputBatchRows() const {
+    return get<uint32_t>(kMaxOutputBatchRows, 10'000);
+  }
+
   bool hashAdaptivityEnabled() const {
     return get<bool>(kHashAdaptivityEnabled, true);
   }
@@ -203,6 +563,29 @@ class QueryConfig {
     return kDefault;
   }
 
+  bool hashJoinBloomFilterEnabled() const {
+    return get<bool>(kHashJoinBloomFilterEnabled, false);
+  }
+
+  uint64_t hashJoinBloomFilterMaxRows() const {
+    static constexpr uint64_t kDefault = 16UL << 20;
+    return get<uint64_t>(kHashJoinBloomFilterMaxRows, kDefault);
+  }
+
+  uint64_t hashProbePartitionedMinTableSize() const {
+    static constexpr uint64_t kDefault = 16UL << 20;
+    return get<uint64_t>(kHashProbePartitionedMinTableSize, kDefault);
+  }
+
+  int32_t hashTablePrefetchBatchSize() const {
+    static constexpr int32_t kDefault = 32;
+    return get<int32_t>(kHashTablePrefetchBatchSize, kDefault);
+  }
+
+  int32_t hashJoinSkewedKeyMinPct() const {
+    return get<int32_t>(kHashJoinSkewedKeyMinPct, 0);
+  }
+
   bool adaptiveFilterReorderingEnabled() const {
     return get<bool>(kAdaptiveFilterReorderingEnabled, true);
   }
@@ -258,6 +641,36 @@ class QueryConfig {
     return get<std::string>(kSpillPath, "/tmp");
   }
 
+  uint64_t spillWriteBufferSize() const {
+    constexpr uint64_t kDefaultWriteBufferSize = 1L << 20;
+    return get<uint64_t>(kSpillWriteBufferSize, kDefaultWriteBufferSize);
+  }
+
+  std::optional<std::string> spillLocalPath() const {
+    return get<std::string>(kSpillLocalPath);
+  }
+
+  uint64_t spillLocalMaxBytes() const {
+    return get<uint64_t>(kSpillLocalMaxBytes, 0);
+  }
+
+  uint64_t maxSpillBytes() const {
+    return get<uint64_t>(kMaxSpillBytes, 0);
+  }
+
+  uint64_t spillReadBufferSize() const {
+    constexpr uint64_t kDefaultReadBufferSize = 1L << 20;
+    return get<uint64_t>(kSpillReadBufferSize, kDefaultReadBufferSize);
+  }
+
+  bool spillReadAheadEnabled() const {
+    return get<bool>(kSpillReadAheadEnabled, false);
+  }
+
+  int32_t spillMaxMergeFanIn() const {
+    return get<int32_t>(kSpillMaxMergeFanIn, 0);
+  }
+
   /// Returns 'is aggregation spilling enabled' flag. Must also check the
   /// spillEnabled()!
   bool aggregationSpillEnabled() const {
@@ -270,12 +683,50 @@ class QueryConfig {
     return get<bool>(kJoinSpillEnabled, false);
   }
 
+  uint64_t mergeJoinSpillMatchRows() const {
+    static constexpr uint64_t kDefault = 1UL << 20;
+    return get<uint64_t>(kMergeJoinSpillMatchRows, kDefault);
+  }
+
+  uint64_t crossJoinSpillBuildBytes() const {
+    static constexpr uint64_t kDefault = 256UL << 20;
+    return get<uint64_t>(kCrossJoinSpillBuildBytes, kDefault);
+  }
+
   /// Returns 'is orderby spilling enabled' flag. Must also check the
   /// spillEnabled()!
   bool orderBySpillEnabled() const {
     return get<bool>(kOrderBySpillEnabled, false);
   }
 
+  bool orderByParallelSortEnabled() const {
+    return get<bool>(kOrderByParallelSortEnabled, false);
+  }
+
+  /// Returns 'is window spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool windowSpillEnabled() const {
+    return get<bool>(kWindowSpillEnabled, false);
+  }
+
+  /// Returns 'is TopN spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool topNSpillEnabled() const {
+    return get<bool>(kTopNSpillEnabled, false);
+  }
+
+  /// Returns 'is sort shuffle write spilling enabled' flag. Must also check
+  /// the spillEnabled()!
+  bool sortShuffleSpillEnabled() const {
+    return get<bool>(kSortShuffleSpillEnabled, false);
+  }
+
+  /// Returns 'is sorted or bucketed table write spilling enabled' flag. Must
+  /// also check the spillEnabled()!
+  bool tableWriterSpillEnabled() const {
+    return get<bool>(kTableWriterSpillEnabled, false);
+  }
+
   // Returns a percentage of aggregation or join input batches that
   // will be forced to spill for testing. 0 means no extra spilling.
   int32_t testingSpillPct() const {
@@ -299,6 +750,23 @@ class QueryConfig {
     return std::min(kMaxBits, get<int32_t>(kSpillPartitionBits, kDefaultBits));
   }
 
+  bool spillArbitrationEnabled() const {
+    return get<bool>(kSpillArbitrationEnabled, false);
+  }
+
+  int32_t memoryReclaimPriority() const {
+    return get<int32_t>(kMemoryReclaimPriority, 0);
+  }
+
+  int32_t cacheTenant() const {
+    return get<int32_t>(kCacheTenant, 0);
+  }
+
+  int32_t maxSpillLevel() const {
+    constexpr int32_t kDefaultMaxSpillLevel = 4;
+    return get<int32_t>(kMaxSpillLevel, kDefaultMaxSpillLevel);
+  }
+
   /// Returns the factor used to determine the target spill file size based on
   /// the spilling operator's memory usage. For instance, if the spilling
   /// operator has used 1GB memory and this factor is 0.5, then the target spill
@@ -317,14 +785,43 @@ class QueryConfig {
     return get<double>(kSpillableReservationGrowthPct, kDefaultPct);
   }
 
+  /// Returns the name of the spill compression codec of the operators with
+  /// the per-operator codec option 'operatorCodecKey', e.g.
+  /// kAggregationSpillCompressionCodec. Falls back to kSpillCompressionCodec.
+  std::string spillCompressionCodec(const char* operatorCodecKey) const {
+    return get<std::string>(
+        operatorCodecKey,
+        get<std::string>(kSpillCompressionCodec, std::string("none")));
+  }
+
   bool exprTrackCpuUsage() const {
     return get<bool>(kExprTrackCpuUsage, false);
   }
 
+  int32_t exprValueMemoMaxEntries() const {
+    return get<int32_t>(kExprValueMemoMaxEntries, 0);
+  }
+
+  bool exprTemplateCacheEnabled() const {
+    return get<bool>(kExprTemplateCacheEnabled, false);
+  }
+
   bool operatorTrackCpuUsage() const {
     return get<bool>(kOperatorTrackCpuUsage, true);
   }
 
+  bool operatorTrackPerfCounters() const {
+    return get<bool>(kOperatorTrackPerfCounters, false);
+  }
+
+  uint64_t driverTimeSliceMs() const {
+    return get<uint64_t>(kDriverTimeSliceMs, 0);
+  }
+
+  bool driverTraceEnabled() const {
+    return get<bool>(kDriverTraceEnabled, false);
+  }
+
   template <typename T>
   T get(const std::string& key, const T& defaultValue) const {
     return config_->get<T>(key, defaultValue);
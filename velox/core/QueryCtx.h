@@ -20,7 +20,9 @@
 #include "velox/common/memory/MappedMemory.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/core/Context.h"
+#include "velox/core/ExprTemplateCache.h"
 #include "velox/core/QueryConfig.h"
+#include "velox/core/SpillDiskTracker.h"
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/VectorPool.h"
 
@@ -67,6 +69,7 @@ class QueryCtx : public Context {
     if (!pool_) {
       initPool(queryId);
     }
+    exprTemplateCache_ = std::make_unique<ExprTemplateCache>(pool_.get());
   }
 
   // Constructor to block the destruction of executor while this
@@ -93,6 +96,13 @@ class QueryCtx : public Context {
     if (!pool_) {
       initPool(queryId);
     }
+    exprTemplateCache_ = std::make_unique<ExprTemplateCache>(pool_.get());
+  }
+
+  ~QueryCtx() {
+    if (arbitrator_) {
+      arbitrator_->removeTracker(pool_->getMemoryUsageTracker().get());
+    }
   }
 
   static std::string generatePoolName(const std::string& queryId) {
@@ -145,6 +155,26 @@ class QueryCtx : public Context {
     return queryId_;
   }
 
+  /// Adds to the time the Drivers of the query have run on executor threads.
+  void addDriverRunNanos(uint64_t nanos) {
+    driverRunNanos_ += nanos;
+  }
+
+  uint64_t driverRunNanos() const {
+    return driverRunNanos_;
+  }
+
+  /// Returns the folded expression trees shared by the Drivers of the query.
+  /// See QueryConfig::exprTemplateCacheEnabled().
+  ExprTemplateCache& exprTemplateCache() const {
+    return *exprTemplateCache_;
+  }
+
+  /// Returns the tracker of the spill files of the query on disk.
+  const std::shared_ptr<SpillDiskTracker>& spillDiskTracker() const {
+    return spillDiskTracker_;
+  }
+
  private:
   static Config* FOLLY_NONNULL getEmptyConfig() {
     static const std::unique_ptr<Config> kEmptyConfig =
@@ -158,9 +188,17 @@ class QueryCtx : public Context {
     static const auto kUnlimited = std::numeric_limits<int64_t>::max();
     pool_->setMemoryUsageTracker(
         memory::MemoryUsageTracker::create(kUnlimited, kUnlimited, kUnlimited));
+    arbitrator_ = memory::getProcessDefaultMemoryManager().arbitrator();
+    if (arbitrator_) {
+      arbitrator_->addTracker(
+          pool_->getMemoryUsageTracker(), config_.memoryReclaimPriority());
+    }
   }
 
   std::unique_ptr<memory::MemoryPool> pool_;
+  // The arbitrator that grows and shrinks the cap of 'pool_' if 'pool_' is
+  // made by 'this' and the process has an arbitrator.
+  std::shared_ptr<memory::MemoryArbitrator> arbitrator_;
   memory::MappedMemory* FOLLY_NONNULL mappedMemory_;
   std::unordered_map<std::string, std::shared_ptr<Config>> connectorConfigs_;
   std::shared_ptr<folly::Executor> executor_;
@@ -168,6 +206,11 @@ class QueryCtx : public Context {
   QueryConfig config_;
   const std::string queryId_;
   std::shared_ptr<folly::Executor> spillExecutor_;
+  const std::shared_ptr<SpillDiskTracker> spillDiskTracker_{
+      std::make_shared<SpillDiskTracker>()};
+  std::atomic<uint64_t> driverRunNanos_{0};
+  // Allocates from 'pool_', so declared after it.
+  std::unique_ptr<ExprTemplateCache> exprTemplateCache_;
 };
 
 // Represents the state of one thread of query execution.
@@ -234,6 +277,27 @@ class ExecCtx : public Context {
     decodedVectorPool_.push_back(std::move(vector));
   }
 
+  /// Returns a vector for the errors of an expression evaluation that was
+  /// released by releaseErrorVector(), or nullptr if there is none. The
+  /// vector has the size and contents it had when released.
+  VectorPtr getErrorVector() {
+    if (errorVectorPool_.empty()) {
+      return nullptr;
+    }
+    auto vector = std::move(errorVectorPool_.back());
+    errorVectorPool_.pop_back();
+    return vector;
+  }
+
+  /// Keeps 'vector' for reuse by getErrorVector() if nothing else references
+  /// it and the pool is not full.
+  void releaseErrorVector(VectorPtr&& vector) {
+    if (vector != nullptr && vector.unique() &&
+        errorVectorPool_.size() < kMaxErrorVectors) {
+      errorVectorPool_.push_back(std::move(vector));
+    }
+  }
+
   VectorPool& vectorPool() {
     return vectorPool_;
   }
@@ -257,6 +321,8 @@ class ExecCtx : public Context {
   }
 
  private:
+  static constexpr int32_t kMaxErrorVectors = 4;
+
   // Pool for all Buffers for this thread
   memory::MemoryPool* FOLLY_NONNULL pool_;
   QueryCtx* FOLLY_NULLABLE queryCtx_;
@@ -265,6 +331,9 @@ class ExecCtx : public Context {
   // A pool of preallocated SelectivityVectors for use by expressions
   // and operators.
   std::vector<std::unique_ptr<SelectivityVector>> selectivityVectorPool_;
+  // Error vectors of evaluations that have completed, reused by the next
+  // evaluations instead of allocating their own.
+  std::vector<VectorPtr> errorVectorPool_;
   VectorPool vectorPool_;
 };
 
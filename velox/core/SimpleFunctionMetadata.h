@@ -505,6 +505,7 @@ class UDFHolder final
   DECLARE_METHOD_RESOLVER(callNullable_method_resolver, callNullable);
   DECLARE_METHOD_RESOLVER(callNullFree_method_resolver, callNullFree);
   DECLARE_METHOD_RESOLVER(callAscii_method_resolver, callAscii);
+  DECLARE_METHOD_RESOLVER(callBatch_method_resolver, callBatch);
   DECLARE_METHOD_RESOLVER(initialize_method_resolver, initialize);
 
   // Check which flavor of the call() method is provided by the UDF object. UDFs
@@ -520,6 +521,7 @@ class UDFHolder final
   // Optionally, UDFs can also provide the following methods:
   //
   // - bool|void callAscii(...)
+  // - void callBatch(result, size, args...)
   // - void initialize(...)
 
   // call():
@@ -604,6 +606,23 @@ class UDFHolder final
         (udf_has_callAscii_return_void && udf_has_call_return_bool)),
       "The return type for callAscii() must match the return type for call().");
 
+  // callBatch(): Takes the raw values of flat result and argument vectors
+  // and computes the first 'size' rows at once. The result is bit-packed
+  // for boolean results. Used instead of call() when all rows are selected
+  // and all arguments are flat primitives without nulls, so it must not
+  // throw and must compute the same values as call().
+  using batch_return_type = std::conditional_t<
+      std::is_same_v<exec_return_type, bool>,
+      uint64_t,
+      exec_return_type>;
+  static constexpr bool udf_has_callBatch = util::has_method<
+      Fun,
+      callBatch_method_resolver,
+      void,
+      batch_return_type*,
+      int32_t,
+      const exec_arg_type<TArgs>*...>::value;
+
   // initialize():
   static constexpr bool udf_has_initialize = util::has_method<
       Fun,
@@ -729,6 +748,19 @@ class UDFHolder final
     }
   }
 
+  FOLLY_ALWAYS_INLINE void callBatch(
+      batch_return_type* out,
+      int32_t size,
+      const exec_arg_type<TArgs>*... args) {
+    if constexpr (udf_has_callBatch) {
+      instance_.callBatch(out, size, args...);
+    } else {
+      VELOX_UNREACHABLE(
+          "callBatch should never be called if the UDF does not "
+          "implement callBatch.");
+    }
+  }
+
   // Helper functions to handle void vs bool return type.
 
   FOLLY_ALWAYS_INLINE bool callImpl(
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
+#include <mutex>
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/future/VeloxPromise.h"
+
+namespace facebook::velox::core {
+
+/// Tracks the bytes of the spill files of a query on disk. Each spill file
+/// adds its bytes on behalf of a holder, i.e. the spilling operator, as it
+/// grows and releases them when it is deleted. A holder that finds the query
+/// over its spill disk budget waits for the other holders to release space.
+class SpillDiskTracker {
+ public:
+  /// Adds 'bytes' to the usage of 'holder'. A negative 'bytes' releases space
+  /// and wakes up the waiting holders.
+  void update(const void* holder, int64_t bytes) {
+    std::vector<ContinuePromise> promises;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      auto& holderBytes = holderBytes_[holder];
+      VELOX_CHECK_GE(holderBytes + bytes, 0);
+      holderBytes += bytes;
+      if (holderBytes == 0) {
+        holderBytes_.erase(holder);
+      }
+      bytes_ += bytes;
+      peakBytes_ = std::max(peakBytes_, bytes_);
+      if (bytes < 0) {
+        promises.swap(promises_);
+        waiting_.clear();
+      }
+    }
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+  }
+
+  /// Returns false if the usage is within 'maxBytes' or 'maxBytes' is 0.
+  /// Otherwise returns true and sets 'future' to be completed when some space
+  /// is released. Throws if 'holder' would wait for itself, i.e. if all the
+  /// other holders of space are waiting too, since nothing would then release
+  /// space.
+  bool waitIfExceeded(
+      const void* holder,
+      uint64_t maxBytes,
+      ContinueFuture* future) {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (maxBytes == 0 || bytes_ <= maxBytes) {
+      return false;
+    }
+    bool canRelease = false;
+    for (const auto& [otherHolder, bytes] : holderBytes_) {
+      if (otherHolder != holder && !waiting_.contains(otherHolder)) {
+        canRelease = true;
+        break;
+      }
+    }
+    VELOX_USER_CHECK(
+        canRelease,
+        "Exceeded the spill disk budget of the query: {} bytes used, {} "
+        "bytes allowed",
+        bytes_,
+        maxBytes);
+    waiting_.insert(holder);
+    promises_.emplace_back("SpillDiskTracker::waitIfExceeded");
+    *future = promises_.back().getSemiFuture();
+    return true;
+  }
+
+  uint64_t bytes() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return bytes_;
+  }
+
+  uint64_t peakBytes() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return peakBytes_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  uint64_t bytes_{0};
+  uint64_t peakBytes_{0};
+  folly::F14FastMap<const void*, int64_t> holderBytes_;
+  // The holders waiting on 'promises_'.
+  folly::F14FastSet<const void*> waiting_;
+  std::vector<ContinuePromise> promises_;
+};
+
+} // namespace facebook::velox::core
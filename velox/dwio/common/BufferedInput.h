@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <folly/futures/Future.h>
+
 #include "velox/dwio/common/DataBuffer.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/common/StreamIdentifier.h"
@@ -51,6 +53,14 @@ class BufferedInput {
   // load all regions to be read in an optimized way (IO efficiency)
   virtual void load(const LogType);
 
+  // Returns true if the regions of the last load() can be read without
+  // waiting for IO that runs on another thread. Otherwise returns false and
+  // sets 'future' to be realized when the IO is done, so that the caller can
+  // wait without occupying its thread.
+  virtual bool loadedOrFuture(folly::SemiFuture<bool>* FOLLY_NONNULL future) {
+    return true;
+  }
+
   virtual bool isBuffered(uint64_t offset, uint64_t length) const {
     return !!readBuffer(offset, length);
   }
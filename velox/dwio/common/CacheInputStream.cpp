@@ -157,7 +157,8 @@ void CacheInputStream::loadSync(Region region) {
     folly::SemiFuture<bool> wait(false);
     cache::RawFileCacheKey key{fileNum_, region.offset};
     pin_.clear();
-    pin_ = cache_->findOrCreate(key, region.length, &wait);
+    pin_ = cache_->findOrCreate(
+        key, region.length, &wait, bufferedInput_->cacheTenant());
     if (pin_.empty()) {
       VELOX_CHECK(wait.valid());
       auto& exec = folly::QueuedImmediateExecutor::instance();
@@ -173,6 +174,10 @@ void CacheInputStream::loadSync(Region region) {
     if (entry->isExclusive()) {
       entry->setGroupId(groupId_);
       entry->setTrackingId(trackingId_);
+      entry->setCompressible(
+          tracker_ && !trackingId_.empty() &&
+          tracker_->readPct(trackingId_) <
+              FLAGS_cache_compress_max_read_pct);
       if (loadFromSsd(region, *entry)) {
         return;
       }
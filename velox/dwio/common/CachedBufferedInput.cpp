@@ -16,6 +16,7 @@
 
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/common/process/TraceContext.h"
+#include "velox/common/time/Timer.h"
 #include "velox/dwio/common/CacheInputStream.h"
 
 DEFINE_int32(
@@ -23,6 +24,12 @@ DEFINE_int32(
     80,
     "Minimum percentage of actual uses over references to a column for prefetching. No prefetch if > 100");
 
+DEFINE_int32(
+    cache_compress_max_read_pct,
+    0,
+    "Cached data of columns read in under this percentage of references is "
+    "kept LZ4 compressed in memory when cold. 0 disables compression");
+
 namespace facebook::velox::dwio::common {
 
 using cache::CachePin;
@@ -49,7 +56,9 @@ std::unique_ptr<SeekableInputStream> CachedBufferedInput::enqueue(
   VELOX_CHECK_LE(region.offset + region.length, fileSize_);
   requests_.emplace_back(
       RawFileCacheKey{fileNum_, region.offset}, region.length, id);
-  tracker_->recordReference(id, region.length, fileNum_, groupId_);
+  if (trackReferences_) {
+    tracker_->recordReference(id, region.length, fileNum_, groupId_);
+  }
   auto stream = std::make_unique<CacheInputStream>(
       this,
       ioStats_.get(),
@@ -130,6 +139,7 @@ std::vector<CacheRequest*> makeRequestParts(
         request.trackingId));
     parts.push_back(extraRequests.back().get());
     parts.back()->coalesces = prefetch;
+    parts.back()->compressible = request.compressible;
   }
   return parts;
 }
@@ -147,6 +157,7 @@ int32_t adjustedReadPct(const cache::TrackingData& trackingData) {
 void CachedBufferedInput::load(const LogType) {
   // 'requests_ is cleared on exit.
   auto requests = std::move(requests_);
+  lastLoadStart_ = allCoalescedLoads_.size();
   cache::SsdFile* FOLLY_NULLABLE ssdFile = nullptr;
   auto ssdCache = cache_->ssdCache();
   if (ssdCache) {
@@ -172,6 +183,8 @@ void CachedBufferedInput::load(const LogType) {
       if (request.trackingId.empty() ||
           adjustedReadPct(trackingData) >= readPct) {
         request.processed = true;
+        request.compressible = !request.trackingId.empty() &&
+            adjustedReadPct(trackingData) < FLAGS_cache_compress_max_read_pct;
         auto parts = makeRequestParts(
             request, trackingData, loadQuantum_, extraRequests);
         for (auto part : parts) {
@@ -200,6 +213,11 @@ void CachedBufferedInput::load(const LogType) {
   }
 }
 
+CoalescePolicy CachedBufferedInput::coalescePolicy() const {
+  return makeCoalescePolicy(
+      ioProfile_ ? ioProfile_->profile() : IoProfile(), maxCoalesceDistance_);
+}
+
 void CachedBufferedInput::makeLoads(
     std::vector<CacheRequest*> requests,
     bool prefetch) {
@@ -207,7 +225,9 @@ void CachedBufferedInput::makeLoads(
     return;
   }
   bool isSsd = !requests[0]->ssdPin.empty();
-  int32_t maxDistance = isSsd ? 20000 : maxCoalesceDistance_;
+  const auto policy = isSsd
+      ? CoalescePolicy{20000, std::numeric_limits<int64_t>::max()}
+      : coalescePolicy();
   std::sort(
       requests.begin(),
       requests.end(),
@@ -224,7 +244,7 @@ void CachedBufferedInput::makeLoads(
 
   coalesceIo<CacheRequest*, CacheRequest*>(
       requests,
-      maxDistance,
+      policy.maxGap,
       // Break batches up. Better load more short ones i parallel.
       40,
       [&](int32_t index) {
@@ -245,8 +265,9 @@ void CachedBufferedInput::makeLoads(
           uint64_t /*offset*/,
           const std::vector<CacheRequest*>& ranges) {
         ++numNewLoads;
-        readRegion(ranges, prefetch);
-      });
+        readRegion(ranges, prefetch, policy);
+      },
+      policy.maxIoBytes);
   if (prefetch && executor_) {
     for (auto& load : allCoalescedLoads_) {
       if (load->state() == LoadState::kPlanned) {
@@ -259,6 +280,42 @@ void CachedBufferedInput::makeLoads(
   }
 }
 
+bool CachedBufferedInput::loadedOrFuture(folly::SemiFuture<bool>* future) {
+  std::vector<folly::SemiFuture<bool>> waits;
+  for (auto i = lastLoadStart_; i < allCoalescedLoads_.size(); ++i) {
+    auto& load = allCoalescedLoads_[i];
+    auto state = load->state();
+    if (state == LoadState::kPlanned && executor_) {
+      // Moves the load off the calling thread. If the load fails, the reader
+      // reads the data itself and gets the error.
+      auto [promise, loadFuture] = folly::makePromiseContract<bool>();
+      executor_->add(
+          [pendingLoad = load, promise = std::move(promise)]() mutable {
+            process::TraceContext trace("Read Ahead");
+            try {
+              pendingLoad->loadOrFuture(nullptr);
+            } catch (const std::exception& e) {
+              LOG(WARNING) << "Error in background load: " << e.what();
+            }
+            promise.setValue(true);
+          });
+      waits.push_back(std::move(loadFuture));
+    } else if (state == LoadState::kLoading) {
+      auto wait = folly::SemiFuture<bool>::makeEmpty();
+      if (!load->loadOrFuture(&wait)) {
+        waits.push_back(std::move(wait));
+      }
+    }
+  }
+  if (waits.empty()) {
+    return true;
+  }
+  *future = folly::collectAll(std::move(waits)).deferValue([](auto&&) {
+    return true;
+  });
+  return false;
+}
+
 namespace {
 // Base class for CoalescedLoads for different storage types.
 class DwioCoalescedLoadBase : public cache::CoalescedLoad {
@@ -267,11 +324,13 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
       cache::AsyncDataCache& cache,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
+      int32_t tenant,
       std::vector<CacheRequest*> requests)
       : CoalescedLoad(makeKeys(requests), makeSizes(requests)),
         cache_(cache),
         ioStats_(std::move(ioStats)),
-        groupId_(groupId) {
+        groupId_(groupId),
+        tenant_(tenant) {
     for (auto& request : requests) {
       requests_.push_back(std::move(*request));
     }
@@ -334,6 +393,7 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
   std::vector<CacheRequest> requests_;
   std::shared_ptr<IoStatistics> ioStats_;
   const uint64_t groupId_;
+  const int32_t tenant_;
 };
 
 // Represents a CoalescedLoad from ReadFile, e.g. disagg disk.
@@ -344,11 +404,19 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
       std::unique_ptr<AbstractInputStreamHolder> input,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
+      int32_t tenant,
       std::vector<CacheRequest*> requests,
-      int32_t maxCoalesceDistance)
-      : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)),
+      const CoalescePolicy& policy,
+      std::shared_ptr<IoProfileTracker> ioProfile)
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            tenant,
+            std::move(requests)),
         input_(std::move(input)),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        policy_(policy),
+        ioProfile_(std::move(ioProfile)) {}
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
     auto& stream = input_->get();
@@ -357,15 +425,17 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
     cache_.makePins(
         keys_,
         [&](int32_t index) { return sizes_[index]; },
-        [&](int32_t /*index*/, CachePin pin) {
+        [&](int32_t index, CachePin pin) {
+          pin.checkedEntry()->setCompressible(requests_[index].compressible);
           pins.push_back(std::move(pin));
-        });
+        },
+        tenant_);
     if (pins.empty()) {
       return pins;
     }
     auto stats = cache::readPins(
         pins,
-        maxCoalesceDistance_,
+        policy_.maxGap,
         1000,
         [&](int32_t i) { return pins[i].entry()->offset(); },
         [&](const std::vector<CachePin>& /*pins*/,
@@ -373,14 +443,38 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
             int32_t /*end*/,
             uint64_t offset,
             const std::vector<folly::Range<char*>>& buffers) {
-          stream.read(buffers, offset, LogType::FILE);
-        });
+          uint64_t usec = 0;
+          {
+            MicrosecondTimer timer(&usec);
+            stream.read(buffers, offset, LogType::FILE);
+          }
+          recordRead(buffers, usec);
+        },
+        policy_.maxIoBytes);
     updateStats(stats, isPrefetch, false);
     return pins;
   }
 
+  // Records the time of a read into 'buffers' for fitting the latency and
+  // throughput of the storage.
+  void recordRead(
+      const std::vector<folly::Range<char*>>& buffers,
+      uint64_t usec) {
+    uint64_t bytes = 0;
+    for (auto& buffer : buffers) {
+      bytes += buffer.size();
+    }
+    if (ioStats_) {
+      ioStats_->storageProfile().record(bytes, usec);
+    }
+    if (ioProfile_) {
+      ioProfile_->record(bytes, usec);
+    }
+  }
+
   std::unique_ptr<AbstractInputStreamHolder> input_;
-  const int32_t maxCoalesceDistance_;
+  const CoalescePolicy policy_;
+  const std::shared_ptr<IoProfileTracker> ioProfile_;
 };
 
 // Represents a CoalescedLoad from local SSD cache.
@@ -390,8 +484,14 @@ class SsdLoad : public DwioCoalescedLoadBase {
       cache::AsyncDataCache& cache,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
+      int32_t tenant,
       std::vector<CacheRequest*> requests)
-      : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)) {}
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            tenant,
+            std::move(requests)) {}
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
     std::vector<SsdPin> ssdPins;
@@ -400,9 +500,11 @@ class SsdLoad : public DwioCoalescedLoadBase {
         keys_,
         [&](int32_t index) { return sizes_[index]; },
         [&](int32_t index, CachePin pin) {
+          pin.checkedEntry()->setCompressible(requests_[index].compressible);
           pins.push_back(std::move(pin));
           ssdPins.push_back(std::move(requests_[index].ssdPin));
-        });
+        },
+        tenant_);
     if (pins.empty()) {
       return pins;
     }
@@ -417,21 +519,25 @@ class SsdLoad : public DwioCoalescedLoadBase {
 
 void CachedBufferedInput::readRegion(
     std::vector<CacheRequest*> requests,
-    bool prefetch) {
+    bool prefetch,
+    const CoalescePolicy& policy) {
   if (requests.empty() || (requests.size() == 1 && !prefetch)) {
     return;
   }
   std::shared_ptr<cache::CoalescedLoad> load;
   if (!requests[0]->ssdPin.empty()) {
-    load = std::make_shared<SsdLoad>(*cache_, ioStats_, groupId_, requests);
+    load = std::make_shared<SsdLoad>(
+        *cache_, ioStats_, groupId_, cacheTenant_, requests);
   } else {
     load = std::make_shared<DwioCoalescedLoad>(
         *cache_,
         streamSource_(),
         ioStats_,
         groupId_,
+        cacheTenant_,
         requests,
-        maxCoalesceDistance_);
+        policy,
+        ioProfile_);
   }
   allCoalescedLoads_.push_back(load);
   coalescedLoads_.withWLock([&](auto& loads) {
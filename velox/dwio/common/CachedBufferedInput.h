@@ -28,6 +28,7 @@
 #include "velox/dwio/common/Options.h"
 
 DECLARE_int32(cache_load_quantum);
+DECLARE_int32(cache_compress_max_read_pct);
 
 namespace facebook::velox::dwio::common {
 
@@ -68,6 +69,10 @@ struct CacheRequest {
   // for sparsely accessed large columns where hitting one piece
   // should not load the adjacent pieces.
   bool coalesces{true};
+
+  // True if the cache may keep the entry LZ4 compressed when it is cold.
+  // Set for streams that are seldom read after being referenced.
+  bool compressible{false};
   const SeekableInputStream* FOLLY_NONNULL stream;
 };
 
@@ -84,7 +89,9 @@ class CachedBufferedInput : public BufferedInput {
       std::shared_ptr<IoStatistics> ioStats,
       folly::Executor* FOLLY_NULLABLE executor,
       int32_t loadQuantum,
-      int32_t maxCoalesceDistance)
+      int32_t maxCoalesceDistance,
+      int32_t cacheTenant = 0,
+      std::shared_ptr<IoProfileTracker> ioProfile = nullptr)
       : BufferedInput(input, pool),
         cache_(cache),
         fileNum_(fileNum),
@@ -95,7 +102,9 @@ class CachedBufferedInput : public BufferedInput {
         executor_(executor),
         fileSize_(input.getLength()),
         loadQuantum_(loadQuantum),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        cacheTenant_(cacheTenant),
+        ioProfile_(std::move(ioProfile)) {}
 
   ~CachedBufferedInput() override {
     for (auto& load : allCoalescedLoads_) {
@@ -113,6 +122,8 @@ class CachedBufferedInput : public BufferedInput {
 
   void load(const LogType) override;
 
+  bool loadedOrFuture(folly::SemiFuture<bool>* FOLLY_NONNULL future) override;
+
   bool isBuffered(uint64_t offset, uint64_t length) const override;
 
   std::unique_ptr<SeekableInputStream>
@@ -135,6 +146,19 @@ class CachedBufferedInput : public BufferedInput {
     return cache_;
   }
 
+  // If false, enqueue() does not count references in 'tracker_'. Used when
+  // reading ahead of the reader, which counts the references when it gets
+  // to the data.
+  void setTrackReferences(bool flag) {
+    trackReferences_ = flag;
+  }
+
+  // The tenant to which the cache entries read through 'this' are
+  // accounted. See AsyncDataCache::setTenantQuota().
+  int32_t cacheTenant() const {
+    return cacheTenant_;
+  }
+
   // Returns the CoalescedLoad that contains the correlated loads for
   // 'stream' or nullptr if none. Returns nullptr on all but first
   // call for 'stream' since the load is to be triggered by the first
@@ -150,9 +174,14 @@ class CachedBufferedInput : public BufferedInput {
   // Makes a CoalescedLoad for 'requests' to be read together, coalescing
   // IO is appropriate. If 'prefetch' is set, schedules the CoalescedLoad
   // on 'executor_'. Links the CoalescedLoad  to all CacheInputStreams that it
-  // concerns.
+  // concerns. 'policy' limits the reads of a load from storage.
+  void readRegion(
+      std::vector<CacheRequest*> requests,
+      bool prefetch,
+      const CoalescePolicy& policy);
 
-  void readRegion(std::vector<CacheRequest*> requests, bool prefetch);
+  // Returns the coalescing limits for reads from storage.
+  CoalescePolicy coalescePolicy() const;
 
   cache::AsyncDataCache* FOLLY_NONNULL cache_;
   const uint64_t fileNum_;
@@ -174,9 +203,18 @@ class CachedBufferedInput : public BufferedInput {
   // Distinct coalesced loads in 'coalescedLoads_'.
   std::vector<std::shared_ptr<cache::CoalescedLoad>> allCoalescedLoads_;
 
+  // Index of the first element of 'allCoalescedLoads_' made by the last
+  // load().
+  size_t lastLoadStart_{0};
+
   const uint64_t fileSize_;
   const int32_t loadQuantum_;
   const int32_t maxCoalesceDistance_;
+  const int32_t cacheTenant_;
+  // Latency and throughput of the storage of 'this'. Sets the coalescing
+  // distance of the loads from storage if it has a profile.
+  const std::shared_ptr<IoProfileTracker> ioProfile_;
+  bool trackReferences_{true};
 };
 
 class CachedBufferedInputFactory : public BufferedInputFactory {
@@ -196,7 +234,9 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
         ioStats_(ioStats),
         executor_(executor),
         loadQuantum_(readerOpts.loadQuantum()),
-        maxCoalesceDistance_(readerOpts.maxCoalesceDistance()) {}
+        maxCoalesceDistance_(readerOpts.maxCoalesceDistance()),
+        cacheTenant_(readerOpts.cacheTenant()),
+        ioProfile_(readerOpts.ioProfileTracker()) {}
 
   std::unique_ptr<BufferedInput> create(
       InputStream& input,
@@ -213,7 +253,9 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
         ioStats_,
         executor_,
         loadQuantum_,
-        maxCoalesceDistance_);
+        maxCoalesceDistance_,
+        cacheTenant_,
+        ioProfile_);
   }
 
   std::string toString() const {
@@ -236,5 +278,7 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
   folly::Executor* FOLLY_NULLABLE executor_;
   int32_t loadQuantum_;
   int32_t maxCoalesceDistance_;
+  int32_t cacheTenant_;
+  std::shared_ptr<IoProfileTracker> ioProfile_;
 };
 } // namespace facebook::velox::dwio::common
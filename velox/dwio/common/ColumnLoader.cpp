@@ -72,6 +72,11 @@ void ColumnLoader::loadInternal(
   }
 
   structReader_->advanceFieldReader(fieldReader_, offset);
+  if (!hook) {
+    // A load into a ValueHook, e.g. for aggregation pushdown, is cheaper
+    // than reading eagerly and does not count.
+    fieldReader_->scanSpec()->recordLazyLoad(effectiveRows.size());
+  }
   fieldReader_->scanSpec()->setValueHook(hook);
   fieldReader_->read(offset, effectiveRows, incomingNulls);
   if (fieldReader_->type()->kind() == TypeKind::ROW) {
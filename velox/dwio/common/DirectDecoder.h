@@ -147,6 +147,45 @@ class DirectDecoder : public IntDecoder<isSigned> {
     return temp;
   }
 
+  // Decodes the varints at 'rows' and filters them in batches that stay in
+  // the L1 cache, instead of decoding all of 'rows' before filtering. The
+  // passing row numbers go to 'filterHits' and if not 'filterOnly', the
+  // passing values to 'values', both starting at 'numValues'.
+  template <typename T, bool filterOnly, bool dense, typename TFilter>
+  void filterVIntsInBatches(
+      folly::Range<const int32_t*> rows,
+      T* FOLLY_NONNULL values,
+      int32_t* FOLLY_NONNULL filterHits,
+      int32_t& numValues,
+      TFilter& filter) {
+    // A multiple of the SIMD width. 4KB of int64_t.
+    constexpr int32_t kBatch = 512;
+    NoHook noHook;
+    for (int32_t begin = 0; begin < rows.size(); begin += kBatch) {
+      const auto numInput = std::min<int32_t>(kBatch, rows.size() - begin);
+      // The passing values of the previous batches are before
+      // values[numValues], so the batch is decoded after them.
+      if (dense) {
+        super::bulkRead(numInput, values + numValues);
+      } else {
+        super::bulkReadRows(
+            folly::Range<const int32_t*>(rows.data() + begin, numInput),
+            values + numValues,
+            begin == 0 ? 0 : rows[begin - 1] + 1);
+      }
+      processFixedWidthRun<T, filterOnly, false, dense>(
+          rows,
+          begin,
+          numInput,
+          nullptr,
+          values,
+          filterHits,
+          numValues,
+          filter,
+          noHook);
+    }
+  }
+
   template <bool hasNulls, typename Visitor>
   void fastPath(const uint64_t* FOLLY_NULLABLE nulls, Visitor& visitor) {
     using T = typename Visitor::DataType;
@@ -234,7 +273,14 @@ class DirectDecoder : public IntDecoder<isSigned> {
         skip<false>(tailSkip, 0, nullptr);
       }
     } else {
-      if (super::useVInts) {
+      if (super::useVInts && hasFilter && !hasHook) {
+        filterVIntsInBatches<T, filterOnly, Visitor::dense>(
+            rowsAsRange,
+            visitor.rawValues(numRows),
+            visitor.outputRows(numRows),
+            numValues,
+            visitor.filter());
+      } else if (super::useVInts) {
         if (Visitor::dense) {
           super::bulkRead(numRows, visitor.rawValues(numRows));
         } else {
@@ -96,6 +96,7 @@ void IoStatistics::merge(const IoStatistics& other) {
   ramHit_.merge(other.ramHit_);
   ssdRead_.merge(other.ssdRead_);
   queryThreadIoLatency_.merge(other.queryThreadIoLatency_);
+  storageProfile_.merge(other.storageProfile_);
   std::lock_guard<std::mutex> l(operationStatsMutex_);
   for (auto& item : other.operationStats_) {
     operationStats_[item.first].merge(item.second);
@@ -112,6 +113,75 @@ void OperationCounters::merge(const OperationCounters& other) {
   delayInjectedInSecs += other.delayInjectedInSecs;
 }
 
+void IoProfileTracker::record(uint64_t bytes, uint64_t micros) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (++numReads_ % kMaxReads == 0) {
+    weight_ /= 2;
+    sumBytes_ /= 2;
+    sumMicros_ /= 2;
+    sumBytes2_ /= 2;
+    sumBytesMicros_ /= 2;
+  }
+  const double x = bytes;
+  const double y = micros;
+  weight_ += 1;
+  sumBytes_ += x;
+  sumMicros_ += y;
+  sumBytes2_ += x * x;
+  sumBytesMicros_ += x * y;
+}
+
+IoProfile IoProfileTracker::profile() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (numReads_ < kMinReads) {
+    return hint_;
+  }
+  const double variance = weight_ * sumBytes2_ - sumBytes_ * sumBytes_;
+  // Requires the sizes to vary by more than a rounding error.
+  if (variance <= 1e-6 * weight_ * sumBytes2_) {
+    return hint_;
+  }
+  const double microsPerByte =
+      (weight_ * sumBytesMicros_ - sumBytes_ * sumMicros_) / variance;
+  const double latencyUs = (sumMicros_ - microsPerByte * sumBytes_) / weight_;
+  if (microsPerByte <= 0 || latencyUs <= 0) {
+    return hint_;
+  }
+  return {latencyUs, 1 / microsPerByte};
+}
+
+void IoProfileTracker::merge(const IoProfileTracker& other) {
+  if (&other == this) {
+    return;
+  }
+  std::scoped_lock l(mutex_, other.mutex_);
+  numReads_ += other.numReads_;
+  weight_ += other.weight_;
+  sumBytes_ += other.sumBytes_;
+  sumMicros_ += other.sumMicros_;
+  sumBytes2_ += other.sumBytes2_;
+  sumBytesMicros_ += other.sumBytesMicros_;
+}
+
+uint64_t IoProfileTracker::numReads() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return numReads_;
+}
+
+std::shared_ptr<IoProfileTracker> ioProfileTracker(
+    const std::string& name,
+    const IoProfile& hint) {
+  static std::mutex mutex;
+  static auto trackers =
+      new std::unordered_map<std::string, std::shared_ptr<IoProfileTracker>>();
+  std::lock_guard<std::mutex> l(mutex);
+  auto& tracker = (*trackers)[name];
+  if (!tracker) {
+    tracker = std::make_shared<IoProfileTracker>(hint);
+  }
+  return tracker;
+}
+
 folly::dynamic serialize(const OperationCounters& counters) {
   folly::dynamic json = folly::dynamic::object;
   json["latencyInMs"] = counters.latencyInMs;
@@ -24,6 +24,8 @@
 
 #include <folly/dynamic.h>
 
+#include "velox/common/base/CoalesceIo.h"
+
 namespace facebook::velox::dwio::common {
 
 struct OperationCounters {
@@ -63,6 +65,52 @@ class IoCounter {
   std::atomic<uint64_t> bytes_{0};
 };
 
+// Estimates the latency and throughput of a storage device from the times
+// of its reads. Fits time = latency + bytes / throughput by least squares
+// over the recent reads. Thread-safe.
+class IoProfileTracker {
+ public:
+  // 'hint' is the profile until the reads determine one, e.g. the
+  // FileSystem::ioProfile() of the device.
+  explicit IoProfileTracker(IoProfile hint = {}) : hint_(hint) {}
+
+  // Records a read of 'bytes' that took 'micros'.
+  void record(uint64_t bytes, uint64_t micros);
+
+  // Returns the fitted profile or 'hint_' if there are too few reads or
+  // their sizes are too uniform to separate latency from transfer time.
+  IoProfile profile() const;
+
+  // Adds the reads recorded in 'other'.
+  void merge(const IoProfileTracker& other);
+
+  uint64_t numReads() const;
+
+ private:
+  // Reads needed before the fit replaces 'hint_'.
+  static constexpr int32_t kMinReads = 16;
+  // After this many reads the sums are halved so that the fit follows
+  // changes in the load of the device.
+  static constexpr int32_t kMaxReads = 1024;
+
+  const IoProfile hint_;
+  mutable std::mutex mutex_;
+  uint64_t numReads_{0};
+  // Sums of the bytes, time, bytes squared and bytes times time of the
+  // reads. Weighs older reads less after halving.
+  double weight_{0};
+  double sumBytes_{0};
+  double sumMicros_{0};
+  double sumBytes2_{0};
+  double sumBytesMicros_{0};
+};
+
+// Returns the process-wide IoProfileTracker for the device called 'name',
+// e.g. a FileSystem::name(). 'hint' initializes the tracker on first use.
+std::shared_ptr<IoProfileTracker> ioProfileTracker(
+    const std::string& name,
+    const IoProfile& hint);
+
 class IoStatistics {
  public:
   uint64_t rawBytesRead() const;
@@ -97,6 +145,10 @@ class IoStatistics {
     return queryThreadIoLatency_;
   }
 
+  IoProfileTracker& storageProfile() {
+    return storageProfile_;
+  }
+
   void incOperationCounters(
       const std::string& operation,
       const uint64_t resourceThrottleCount,
@@ -136,6 +188,9 @@ class IoStatistics {
   // issued IO or for an in-progress read-ahead to finish.
   IoCounter queryThreadIoLatency_;
 
+  // Latency and throughput of the coalesced reads from storage.
+  IoProfileTracker storageProfile_;
+
   std::unordered_map<std::string, OperationCounters> operationStats_;
   mutable std::mutex operationStatsMutex_;
 };
@@ -322,6 +322,8 @@ class ReaderOptions {
   PrefetchMode prefetchMode;
   int32_t loadQuantum_{kDefaultLoadQuantum};
   int32_t maxCoalesceDistance_{kDefaultCoalesceDistance};
+  int32_t cacheTenant_{0};
+  std::shared_ptr<IoProfileTracker> ioProfileTracker_;
   SerDeOptions serDeOptions;
   uint64_t fileNum;
   std::shared_ptr<encryption::DecrypterFactory> decrypterFactory_;
@@ -442,6 +444,26 @@ class ReaderOptions {
     return *this;
   }
 
+  /**
+   * Modify the tenant to which the reads are accounted in the
+   * AsyncDataCache.
+   */
+  ReaderOptions& setCacheTenant(int32_t tenant) {
+    cacheTenant_ = tenant;
+    return *this;
+  }
+
+  /**
+   * Modify the tracker of the latency and throughput of the storage, used
+   * for choosing the coalescing distance. If not set or if the tracker
+   * has no profile, reads are coalesced up to maxCoalesceDistance().
+   */
+  ReaderOptions& setIoProfileTracker(
+      std::shared_ptr<IoProfileTracker> tracker) {
+    ioProfileTracker_ = std::move(tracker);
+    return *this;
+  }
+
   /**
    * Modify the serialization-deserialization options.
    */
@@ -511,6 +533,14 @@ class ReaderOptions {
     return maxCoalesceDistance_;
   }
 
+  int32_t cacheTenant() const {
+    return cacheTenant_;
+  }
+
+  const std::shared_ptr<IoProfileTracker>& ioProfileTracker() const {
+    return ioProfileTracker_;
+  }
+
   SerDeOptions& getSerDeOptions() {
     return serDeOptions;
   }
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <folly/futures/Future.h>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -50,6 +51,17 @@ class RowReader {
    */
   virtual uint64_t next(uint64_t size, velox::VectorPtr& result) = 0;
 
+  /**
+   * Starts the IO for the rows of the next call to next() if not started.
+   * @param future set to be realized when the IO is done if the IO runs on
+   * another thread
+   * @return true if next() can read its rows without waiting for IO
+   * on another thread, false if the caller should wait for 'future' first
+   */
+  virtual bool prepareNext(folly::SemiFuture<bool>* FOLLY_NONNULL future) {
+    return true;
+  }
+
   /**
    * Update current reader statistics. The set of updated values is
    * implementation specific and depends on a format of a file being read.
@@ -58,10 +58,52 @@ uint64_t ScanSpec::newRead() {
   return numReads_++;
 }
 
+namespace {
+// Number of batches returned as LazyVectors before deciding to read a
+// column eagerly.
+constexpr uint64_t kMinLazyBatches = 10;
+// Number of batches read eagerly before going back to LazyVectors.
+constexpr uint64_t kEagerBatches = 100;
+// Percentage of the rows of the LazyVectors of a column that must be loaded
+// for reading the column eagerly.
+constexpr uint64_t kMinEagerLoadPct = 90;
+} // namespace
+
+void ScanSpec::decideLazyLoad() {
+  auto& stats = lazyLoadStats_;
+  auto& start = lazyLoadRunStart_;
+  if (readsEagerly_) {
+    if (stats.numEagerBatches - start.numEagerBatches < kEagerBatches) {
+      ++stats.numEagerBatches;
+      return;
+    }
+    readsEagerly_ = false;
+    start = stats;
+    return;
+  }
+  if (stats.numLazyBatches - start.numLazyBatches < kMinLazyBatches) {
+    return;
+  }
+  auto numLazyRows = stats.numLazyRows - start.numLazyRows;
+  auto numLoadedRows = stats.numLoadedRows - start.numLoadedRows;
+  readsEagerly_ = 100 * numLoadedRows >= kMinEagerLoadPct * numLazyRows;
+  start = stats;
+  if (readsEagerly_) {
+    ++stats.numEagerBatches;
+  }
+}
+
 void ScanSpec::reorder() {
   if (children_.empty()) {
     return;
   }
+  std::vector<ScanSpec*> oldOrder;
+  if (numReads_) {
+    oldOrder.reserve(children_.size());
+    for (auto& child : children_) {
+      oldOrder.push_back(child.get());
+    }
+  }
   std::sort(
       children_.begin(),
       children_.end(),
@@ -97,6 +139,28 @@ void ScanSpec::reorder() {
         }
         return left->fieldName_ < right->fieldName_;
       });
+  if (oldOrder.empty()) {
+    return;
+  }
+  for (auto i = 0; i < children_.size(); ++i) {
+    if (children_[i].get() != oldOrder[i]) {
+      ++numFilterReorders_;
+      VLOG(1) << "Reordered filters: " << filterOrderString();
+      break;
+    }
+  }
+}
+
+std::string ScanSpec::filterOrderString() const {
+  std::stringstream out;
+  for (auto& child : children_) {
+    if (!child->hasFilter()) {
+      break;
+    }
+    out << child->fieldName_ << " "
+        << child->selectivity_.timeToDropValue() << " clocks/row, ";
+  }
+  return out.str();
 }
 
 bool ScanSpec::hasFilter() const {
@@ -32,6 +32,22 @@ class ColumnStatistics;
 }
 namespace common {
 
+// Counts of the batches of a column that could be returned as
+// LazyVectors. Used for choosing between lazy and eager reading of the
+// column.
+struct LazyLoadStats {
+  // Batches returned as LazyVectors and their rows.
+  uint64_t numLazyBatches{0};
+  uint64_t numLazyRows{0};
+  // LazyVectors that were loaded and the rows they were loaded for. The
+  // rows loaded per row of the loaded LazyVectors give the selectivity of
+  // the downstream filters at load time.
+  uint64_t numLoadedBatches{0};
+  uint64_t numLoadedRows{0};
+  // Batches read eagerly, i.e. with the filtered columns.
+  uint64_t numEagerBatches{0};
+};
+
 // Describes the filtering and value extraction for a
 // SelectiveColumnReader. This is owned by the TableScan Operator and
 // is passed to SelectiveColumnReaders at construction.  This is
@@ -248,6 +264,49 @@ class ScanSpec {
     enableFilterReorder_ = enableFilterReorder;
   }
 
+  // Number of times the children with filters were put in a different order
+  // after the first read. The order follows the time to drop a row, i.e. the
+  // measured time per row of a child divided by the fraction of rows it
+  // drops, so that a selective filter on an expensive column can go after a
+  // less selective one on a cheap column.
+  uint64_t numFilterReorders() const {
+    return numFilterReorders_;
+  }
+
+  // Returns the names of the children with filters in the order they are
+  // evaluated, with their time to drop a row.
+  std::string filterOrderString() const;
+
+  // True if the batch being read reads 'this' with the filtered columns
+  // instead of returning a LazyVector. Set by decideLazyLoad().
+  bool readsEagerly() const {
+    return readsEagerly_;
+  }
+
+  // Decides whether the batch being read returns 'this' as a LazyVector or
+  // reads it eagerly. A column is read eagerly once nearly all the rows of
+  // its recent LazyVectors have been loaded, since the LazyVectors then
+  // only add overhead. An eagerly read column goes back to LazyVectors
+  // every so often to see if the use has changed. Called once per batch
+  // for a column that can be returned as a LazyVector.
+  void decideLazyLoad();
+
+  // Records that a LazyVector of 'numRows' rows was made for 'this'.
+  void recordLazyBatch(uint64_t numRows) {
+    ++lazyLoadStats_.numLazyBatches;
+    lazyLoadStats_.numLazyRows += numRows;
+  }
+
+  // Records that a LazyVector of 'this' was loaded for 'numRows' rows.
+  void recordLazyLoad(uint64_t numRows) {
+    ++lazyLoadStats_.numLoadedBatches;
+    lazyLoadStats_.numLoadedRows += numRows;
+  }
+
+  const LazyLoadStats& lazyLoadStats() const {
+    return lazyLoadStats_;
+  }
+
   // Returns the child which produces values for 'channel'. Throws if not found.
   ScanSpec& getChildByChannel(column_index_t channel);
 
@@ -261,6 +320,8 @@ class ScanSpec {
   // number for LazyVectors.
   uint64_t numReads_ = 0;
 
+  uint64_t numFilterReorders_ = 0;
+
   // Ordinal position of 'this' in its containing spec. For a struct
   // member this is the position of the reader in the child
   // readers. If this describes an operation on an array element or a
@@ -301,6 +362,11 @@ class ScanSpec {
 
   std::vector<std::unique_ptr<ScanSpec>> children_;
   mutable std::optional<bool> hasFilter_;
+  LazyLoadStats lazyLoadStats_;
+  // 'lazyLoadStats_' at the start of the current run of lazy or eager
+  // batches.
+  LazyLoadStats lazyLoadRunStart_;
+  bool readsEagerly_{false};
   ValueHook* valueHook_ = nullptr;
 };
 
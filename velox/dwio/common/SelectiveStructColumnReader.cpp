@@ -15,6 +15,9 @@
  */
 
 #include "velox/dwio/common/SelectiveStructColumnReader.h"
+
+#include <folly/futures/Future.h>
+
 #include "velox/dwio/common/ColumnLoader.h"
 
 namespace facebook::velox::dwio::common {
@@ -31,7 +34,8 @@ std::vector<uint32_t> SelectiveStructColumnReader::filterRowGroups(
     } else {
       std::vector<uint32_t> merged;
       merged.reserve(childStridesToSkip.size() + stridesToSkip.size());
-      std::merge(
+      // Strides dropped by several children are listed once.
+      std::set_union(
           childStridesToSkip.begin(),
           childStridesToSkip.end(),
           stridesToSkip.begin(),
@@ -133,6 +137,9 @@ void SelectiveStructColumnReader::read(
   }
 
   assert(!children_.empty());
+  // Children without filters that are read after the filters have produced
+  // the final rows. Read in parallel if there is a 'decodingExecutor_'.
+  std::vector<SelectiveColumnReader*> parallelReaders;
   for (size_t i = 0; i < childSpecs.size(); ++i) {
     auto& childSpec = childSpecs[i];
     if (childSpec->isConstant()) {
@@ -142,8 +149,11 @@ void SelectiveStructColumnReader::read(
     auto reader = children_.at(fieldIndex).get();
     if (reader->isTopLevel() && childSpec->projectOut() &&
         !childSpec->hasFilter() && !childSpec->extractValues()) {
-      // Will make a LazyVector.
-      continue;
+      childSpec->decideLazyLoad();
+      if (!childSpec->readsEagerly()) {
+        // Will make a LazyVector.
+        continue;
+      }
     }
     advanceFieldReader(reader, offset);
     if (childSpec->hasFilter()) {
@@ -163,10 +173,17 @@ void SelectiveStructColumnReader::read(
       if (activeRows.empty()) {
         break;
       }
+    } else if (decodingExecutor_) {
+      // The filters are ordered before the other children, so 'activeRows'
+      // is final.
+      parallelReaders.push_back(reader);
     } else {
       reader->read(offset, activeRows, structNulls);
     }
   }
+  if (!parallelReaders.empty()) {
+    readInParallel(parallelReaders, offset, activeRows, structNulls);
+  }
   // If this adds nulls, the field readers will miss a value for each null added
   // here.
   recordParentNullsInChildren(offset, rows);
@@ -178,6 +195,37 @@ void SelectiveStructColumnReader::read(
   readOffset_ = offset + rows.back() + 1;
 }
 
+void SelectiveStructColumnReader::readInParallel(
+    const std::vector<SelectiveColumnReader*>& readers,
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* incomingNulls) {
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(readers.size() - 1);
+  for (auto i = 1; i < readers.size(); ++i) {
+    auto reader = readers[i];
+    futures.push_back(
+        folly::via(decodingExecutor_, [reader, offset, rows, incomingNulls]() {
+          reader->read(offset, rows, incomingNulls);
+        }));
+  }
+  // The first reader runs on this thread. The others reference 'rows' and
+  // must be done before returning, also on error.
+  std::exception_ptr error;
+  try {
+    readers[0]->read(offset, rows, incomingNulls);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  auto results = folly::collectAll(std::move(futures)).get();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  for (auto& result : results) {
+    result.value();
+  }
+}
+
 void SelectiveStructColumnReader::recordParentNullsInChildren(
     vector_size_t offset,
     RowSet rows) {
@@ -268,7 +316,7 @@ void SelectiveStructColumnReader::getValues(RowSet rows, VectorPtr* result) {
           rows.size(), 0, childSpec->constantValue());
     } else {
       if (!childSpec->extractValues() && !childSpec->hasFilter() &&
-          children_[index]->isTopLevel()) {
+          children_[index]->isTopLevel() && !childSpec->readsEagerly()) {
         // LazyVector result.
         if (!lazyPrepared) {
           if (rows.size() != outputRows_.size()) {
@@ -282,6 +330,7 @@ void SelectiveStructColumnReader::getValues(RowSet rows, VectorPtr* result) {
             rows.size(),
             std::make_unique<ColumnLoader>(
                 this, children_[index].get(), numReads_));
+        childSpec->recordLazyBatch(rows.size());
       } else {
         children_[index]->getValues(rows, &resultRow->childAt(channel));
       }
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+
 #include "velox/dwio/common/SelectiveColumnReaderInternal.h"
 
 namespace facebook::velox::dwio::common {
@@ -105,6 +107,15 @@ class SelectiveStructColumnReader : public SelectiveColumnReader {
     return debugString_;
   }
 
+  // Reads the children without filters in parallel on 'executor' after the
+  // filters have made the final rows of a batch. The children with filters
+  // are read in order on the calling thread so that each one only reads the
+  // rows passed by the previous ones. The children must not share state
+  // that is not thread safe, other than the memory pool.
+  void setDecodingExecutor(folly::Executor* FOLLY_NULLABLE executor) {
+    decodingExecutor_ = executor;
+  }
+
  protected:
   // Records the number of nulls added by 'this' between the end
   // position of each child reader and the end of the range of
@@ -112,6 +123,13 @@ class SelectiveStructColumnReader : public SelectiveColumnReader {
   // know how much to skip when seeking forward within the row group.
   void recordParentNullsInChildren(vector_size_t offset, RowSet rows);
 
+  // Reads 'readers' for 'rows', all but the first on 'decodingExecutor_'.
+  void readInParallel(
+      const std::vector<SelectiveColumnReader*>& readers,
+      vector_size_t offset,
+      RowSet rows,
+      const uint64_t* FOLLY_NULLABLE incomingNulls);
+
   const std::shared_ptr<const dwio::common::TypeWithId> requestedType_;
   std::vector<std::unique_ptr<SelectiveColumnReader>> children_;
   // Sequence number of output batch. Checked against ColumnLoaders
@@ -122,6 +140,8 @@ class SelectiveStructColumnReader : public SelectiveColumnReader {
   // Dense set of rows to read in next().
   raw_vector<vector_size_t> rows_;
 
+  folly::Executor* FOLLY_NULLABLE decodingExecutor_{nullptr};
+
   // Context information obtained from ExceptionContext. Stored here
   // so that LazyVector readers under this can add this to their
   // ExceptionContext. Allows contextualizing reader errors to split
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/common/IoStatistics.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+TEST(IoStatisticsTest, ioProfile) {
+  const IoProfile hint{100, 2000};
+  IoProfileTracker tracker(hint);
+  // Reads of 1ms + 1us per 100 bytes.
+  auto recordReads = [](IoProfileTracker& tracker, int32_t numReads) {
+    for (auto i = 0; i < numReads; ++i) {
+      const uint64_t bytes = (1 + i % 10) * 100000;
+      tracker.record(bytes, 1000 + bytes / 100);
+    }
+  };
+  recordReads(tracker, 10);
+  // Too few reads to replace the hint.
+  EXPECT_EQ(100, tracker.profile().latencyUs);
+  EXPECT_EQ(2000, tracker.profile().bytesPerUs);
+
+  recordReads(tracker, 2000);
+  EXPECT_EQ(2010, tracker.numReads());
+  EXPECT_NEAR(1000, tracker.profile().latencyUs, 1);
+  EXPECT_NEAR(100, tracker.profile().bytesPerUs, 0.1);
+
+  // Reads of a single size do not separate latency from throughput.
+  IoProfileTracker uniform(hint);
+  for (auto i = 0; i < 100; ++i) {
+    uniform.record(100000, 2000);
+  }
+  EXPECT_EQ(100, uniform.profile().latencyUs);
+
+  uniform.merge(tracker);
+  EXPECT_EQ(2110, uniform.numReads());
+  EXPECT_LT(0, uniform.profile().latencyUs);
+}
+
+TEST(IoStatisticsTest, fileSystemTracker) {
+  auto tracker = ioProfileTracker("test fs", IoProfile{100, 2000});
+  // The same tracker is returned for the same name and the hint of the
+  // first call is kept.
+  EXPECT_EQ(tracker, ioProfileTracker("test fs", IoProfile{1, 1}));
+  EXPECT_EQ(100, tracker->profile().latencyUs);
+  EXPECT_NE(tracker, ioProfileTracker("other fs", IoProfile{}));
+}
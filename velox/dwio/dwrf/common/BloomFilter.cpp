@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/common/BloomFilter.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "velox/dwio/common/exception/Exception.h"
+
+namespace facebook::velox::dwrf {
+
+namespace {
+
+constexpr uint32_t kMurmurSeed = 104729;
+
+inline uint64_t rotl64(uint64_t x, int8_t r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t fmix64(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+} // namespace
+
+BloomFilter::BloomFilter(uint64_t expectedEntries, double fpp) {
+  DWIO_ENSURE(fpp > 0.0 && fpp < 1.0, "Invalid false positive rate ", fpp);
+  const double n = std::max<uint64_t>(expectedEntries, 1);
+  const double ln2 = std::log(2.0);
+  const auto bits = static_cast<uint64_t>(
+      std::ceil(-n * std::log(fpp) / (ln2 * ln2)));
+  // Rounds up to whole words.
+  numBits_ = std::max<uint64_t>(64, (bits + 63) / 64 * 64);
+  numHashFunctions_ = std::max<int32_t>(
+      1, static_cast<int32_t>(std::round(numBits_ / n * ln2)));
+  bits_.resize(numBits_ / 64);
+}
+
+BloomFilter::BloomFilter(const proto::BloomFilter& filter)
+    : numBits_{static_cast<uint64_t>(filter.bitset_size()) * 64},
+      numHashFunctions_{static_cast<int32_t>(filter.numhashfunctions())},
+      bits_{filter.bitset().begin(), filter.bitset().end()} {
+  DWIO_ENSURE_GT(numBits_, 0, "Empty bloom filter");
+  DWIO_ENSURE_GT(numHashFunctions_, 0, "Bloom filter without hash functions");
+}
+
+void BloomFilter::reset() {
+  std::fill(bits_.begin(), bits_.end(), 0);
+}
+
+void BloomFilter::toProto(proto::BloomFilter& filter) const {
+  filter.set_numhashfunctions(numHashFunctions_);
+  filter.mutable_bitset()->Reserve(bits_.size());
+  for (auto word : bits_) {
+    filter.add_bitset(word);
+  }
+}
+
+void BloomFilter::addHash(uint64_t hash) {
+  const auto hash1 = static_cast<int32_t>(hash);
+  const auto hash2 = static_cast<int32_t>(hash >> 32);
+  for (int32_t i = 1; i <= numHashFunctions_; ++i) {
+    // Wraps like the Java int arithmetic of the ORC writer.
+    auto combined = static_cast<int32_t>(
+        static_cast<uint32_t>(hash1) +
+        static_cast<uint32_t>(i) * static_cast<uint32_t>(hash2));
+    if (combined < 0) {
+      combined = ~combined;
+    }
+    const auto pos = combined % numBits_;
+    bits_[pos / 64] |= 1ULL << (pos % 64);
+  }
+}
+
+bool BloomFilter::testHash(uint64_t hash) const {
+  const auto hash1 = static_cast<int32_t>(hash);
+  const auto hash2 = static_cast<int32_t>(hash >> 32);
+  for (int32_t i = 1; i <= numHashFunctions_; ++i) {
+    auto combined = static_cast<int32_t>(
+        static_cast<uint32_t>(hash1) +
+        static_cast<uint32_t>(i) * static_cast<uint32_t>(hash2));
+    if (combined < 0) {
+      combined = ~combined;
+    }
+    const auto pos = combined % numBits_;
+    if (!(bits_[pos / 64] & (1ULL << (pos % 64)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// static
+uint64_t BloomFilter::hashLong(int64_t value) {
+  auto key = static_cast<uint64_t>(value);
+  key = (~key) + (key << 21);
+  key = key ^ (key >> 24);
+  key = (key + (key << 3)) + (key << 8);
+  key = key ^ (key >> 14);
+  key = (key + (key << 2)) + (key << 4);
+  key = key ^ (key >> 28);
+  key = key + (key << 31);
+  return key;
+}
+
+// static
+uint64_t BloomFilter::hashBytes(const char* data, int32_t length) {
+  constexpr uint64_t kC1 = 0x87c37b91114253d5ULL;
+  constexpr uint64_t kC2 = 0x4cf5ad432745937fULL;
+  auto bytes = reinterpret_cast<const uint8_t*>(data);
+  uint64_t h = kMurmurSeed;
+  const int32_t numBlocks = length >> 3;
+  for (int32_t i = 0; i < numBlocks; ++i) {
+    uint64_t k;
+    memcpy(&k, bytes + i * 8, sizeof(k));
+    k *= kC1;
+    k = rotl64(k, 31);
+    k *= kC2;
+    h ^= k;
+    h = rotl64(h, 27);
+    h = h * 5 + 0x52dce729;
+  }
+  const auto tail = bytes + (numBlocks << 3);
+  uint64_t k = 0;
+  switch (length & 7) {
+    case 7:
+      k ^= static_cast<uint64_t>(tail[6]) << 48;
+      [[fallthrough]];
+    case 6:
+      k ^= static_cast<uint64_t>(tail[5]) << 40;
+      [[fallthrough]];
+    case 5:
+      k ^= static_cast<uint64_t>(tail[4]) << 32;
+      [[fallthrough]];
+    case 4:
+      k ^= static_cast<uint64_t>(tail[3]) << 24;
+      [[fallthrough]];
+    case 3:
+      k ^= static_cast<uint64_t>(tail[2]) << 16;
+      [[fallthrough]];
+    case 2:
+      k ^= static_cast<uint64_t>(tail[1]) << 8;
+      [[fallthrough]];
+    case 1:
+      k ^= static_cast<uint64_t>(tail[0]);
+      k *= kC1;
+      k = rotl64(k, 31);
+      k *= kC2;
+      h ^= k;
+  }
+  h ^= length;
+  return fmix64(h);
+}
+
+} // namespace facebook::velox::dwrf
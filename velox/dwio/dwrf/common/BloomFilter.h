@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <folly/Range.h>
+
+#include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
+
+namespace facebook::velox::dwrf {
+
+// Bloom filter over the values of a stride, stored in the BLOOM_FILTER_UTF8
+// stream as one proto::BloomFilter per row index entry. The hashing is that
+// of the ORC bloom filters: integers are hashed with Thomas Wang's 64 bit
+// mix, strings with Murmur3, and the k probes are h1 + i * h2 over the low
+// and high halves of the hash.
+class BloomFilter {
+ public:
+  // Creates an empty filter sized for 'expectedEntries' distinct values with
+  // a false positive probability of 'fpp'.
+  BloomFilter(uint64_t expectedEntries, double fpp);
+
+  explicit BloomFilter(const proto::BloomFilter& filter);
+
+  void addLong(int64_t value) {
+    addHash(hashLong(value));
+  }
+
+  void addBytes(const char* data, int32_t length) {
+    addHash(hashBytes(data, length));
+  }
+
+  void addBytes(folly::StringPiece value) {
+    addBytes(value.data(), value.size());
+  }
+
+  // Returns false if 'value' was certainly not added.
+  bool testLong(int64_t value) const {
+    return testHash(hashLong(value));
+  }
+
+  bool testBytes(const char* data, int32_t length) const {
+    return testHash(hashBytes(data, length));
+  }
+
+  bool testBytes(folly::StringPiece value) const {
+    return testBytes(value.data(), value.size());
+  }
+
+  // Clears the bits, keeping the size and number of hash functions.
+  void reset();
+
+  void toProto(proto::BloomFilter& filter) const;
+
+  uint64_t numBits() const {
+    return numBits_;
+  }
+
+  int32_t numHashFunctions() const {
+    return numHashFunctions_;
+  }
+
+  static uint64_t hashLong(int64_t value);
+
+  static uint64_t hashBytes(const char* data, int32_t length);
+
+ private:
+  void addHash(uint64_t hash);
+
+  bool testHash(uint64_t hash) const;
+
+  uint64_t numBits_;
+  int32_t numHashFunctions_;
+  std::vector<uint64_t> bits_;
+};
+
+} // namespace facebook::velox::dwrf
@@ -96,6 +96,7 @@ class Config {
   static Entry<float> DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD;
   static Entry<float> DICTIONARY_STRING_KEY_SIZE_THRESHOLD;
   static Entry<bool> DICTIONARY_SORT_KEYS;
+  static Entry<uint32_t> DICTIONARY_EARLY_DECISION_ROWS;
   static Entry<float> ENTROPY_KEY_STRING_SIZE_THRESHOLD;
   static Entry<uint32_t> ENTROPY_STRING_MIN_SAMPLES;
   static Entry<float> ENTROPY_STRING_DICT_SAMPLE_FRACTION;
@@ -123,6 +124,10 @@ class Config {
   // to write oversized stripes.
   static Entry<uint64_t> RAW_DATA_SIZE_PER_BATCH;
   static Entry<bool> MAP_STATISTICS;
+  // Top level columns whose integer and string streams get a bloom filter
+  // per row index entry.
+  static Entry<const std::vector<uint32_t>> BLOOM_FILTER_COLS;
+  static Entry<float> BLOOM_FILTER_FPP;
 
  private:
   std::unordered_map<std::string, std::string> configs_;
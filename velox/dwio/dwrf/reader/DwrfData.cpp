@@ -16,12 +16,15 @@
 
 #include "velox/dwio/dwrf/reader/DwrfData.h"
 
+#include <algorithm>
+
 namespace facebook::velox::dwrf {
 
 DwrfData::DwrfData(
     std::shared_ptr<const dwio::common::TypeWithId> nodeType,
     StripeStreams& stripe,
-    FlatMapContext flatMapContext)
+    FlatMapContext flatMapContext,
+    bool loadBloomFilters)
     : memoryPool_(stripe.getMemoryPool()),
       nodeType_(std::move(nodeType)),
       flatMapContext_(std::move(flatMapContext)),
@@ -40,6 +43,10 @@ DwrfData::DwrfData(
   // time pushdown.
   indexStream_ = stripe.getStream(
       encodingKey.forKind(proto::Stream_Kind_ROW_INDEX), false);
+  if (loadBloomFilters) {
+    bloomFilterStream_ = stripe.getStream(
+        encodingKey.forKind(proto::Stream_Kind_BLOOM_FILTER_UTF8), false);
+  }
 }
 
 uint64_t DwrfData::skipNulls(uint64_t numValues, bool /*nullsOnly*/) {
@@ -66,6 +73,10 @@ void DwrfData::ensureRowGroupIndex() {
   if (indexStream_) {
     index_ = ProtoUtils::readProto<proto::RowIndex>(std::move(indexStream_));
   }
+  if (bloomFilterStream_) {
+    bloomFilters_ = ProtoUtils::readProto<proto::BloomFilterIndex>(
+        std::move(bloomFilterStream_));
+  }
 }
 
 dwio::common::PositionProvider DwrfData::seekToRowGroup(uint32_t index) {
@@ -128,9 +139,76 @@ std::vector<uint32_t> DwrfData::filterRowGroups(
     if (!testFilter(filter, columnStats.get(), rowGroupSize, nodeType_->type)) {
       VLOG(1) << "Drop stride " << i << " on " << scanSpec.toString();
       stridesToSkip.push_back(i); // Skipping stride based on column stats.
+      continue;
+    }
+    // A stride with nulls is kept if the filter passes nulls.
+    if (bloomFilters_ && i < bloomFilters_->bloomfilter_size() &&
+        !(filter->testNull() && columnStats->hasNull().value_or(true)) &&
+        !testBloomFilter(*filter, BloomFilter(bloomFilters_->bloomfilter(i)))) {
+      VLOG(1) << "Drop stride " << i << " by bloom filter on "
+              << scanSpec.toString();
+      stridesToSkip.push_back(i);
     }
   }
   return stridesToSkip;
 }
 
+// static
+bool DwrfData::canUseBloomFilter(const common::Filter* FOLLY_NULLABLE filter) {
+  if (!filter) {
+    return false;
+  }
+  switch (filter->kind()) {
+    case common::FilterKind::kBigintRange:
+      return static_cast<const common::BigintRange*>(filter)->isSingleValue();
+    case common::FilterKind::kBytesRange:
+      return static_cast<const common::BytesRange*>(filter)->isSingleValue();
+    case common::FilterKind::kBigintValuesUsingHashTable:
+    case common::FilterKind::kBigintValuesUsingBitmask:
+    case common::FilterKind::kBytesValues:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// static
+bool DwrfData::testBloomFilter(
+    const common::Filter& filter,
+    const BloomFilter& bloomFilter) {
+  auto testLongs = [&](const std::vector<int64_t>& values) {
+    return std::any_of(values.begin(), values.end(), [&](int64_t value) {
+      return bloomFilter.testLong(value);
+    });
+  };
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange: {
+      auto& range = static_cast<const common::BigintRange&>(filter);
+      return !range.isSingleValue() || bloomFilter.testLong(range.lower());
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      return testLongs(
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values());
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      return testLongs(
+          static_cast<const common::BigintValuesUsingBitmask&>(filter)
+              .values());
+    case common::FilterKind::kBytesRange: {
+      auto& range = static_cast<const common::BytesRange&>(filter);
+      return !range.isSingleValue() || bloomFilter.testBytes(range.lower());
+    }
+    case common::FilterKind::kBytesValues: {
+      const auto& values =
+          static_cast<const common::BytesValues&>(filter).values();
+      return std::any_of(
+          values.begin(), values.end(), [&](const std::string& value) {
+            return bloomFilter.testBytes(value);
+          });
+    }
+    default:
+      return true;
+  }
+}
+
 } // namespace facebook::velox::dwrf
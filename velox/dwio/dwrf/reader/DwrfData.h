@@ -20,6 +20,7 @@
 #include "velox/dwio/common/ColumnSelector.h"
 #include "velox/dwio/common/FormatData.h"
 #include "velox/dwio/common/TypeWithId.h"
+#include "velox/dwio/dwrf/common/BloomFilter.h"
 #include "velox/dwio/dwrf/common/ByteRLE.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 #include "velox/dwio/dwrf/common/RLEv1.h"
@@ -36,7 +37,8 @@ class DwrfData : public dwio::common::FormatData {
   DwrfData(
       std::shared_ptr<const dwio::common::TypeWithId> nodeType,
       StripeStreams& stripe,
-      FlatMapContext flatMapContext);
+      FlatMapContext flatMapContext,
+      bool loadBloomFilters = false);
 
   void readNulls(
       vector_size_t numValues,
@@ -90,6 +92,16 @@ class DwrfData : public dwio::common::FormatData {
     return *index_;
   }
 
+  // True if 'filter' passes only a few discrete values that can be looked up
+  // in the bloom filters of the row index entries.
+  static bool canUseBloomFilter(const common::Filter* FOLLY_NULLABLE filter);
+
+  // Returns false if no value that passes 'filter' was added to
+  // 'bloomFilter'.
+  static bool testBloomFilter(
+      const common::Filter& filter,
+      const BloomFilter& bloomFilter);
+
  private:
   static std::vector<uint64_t> toPositionsInner(
       const proto::RowIndexEntry& entry) {
@@ -103,6 +115,10 @@ class DwrfData : public dwio::common::FormatData {
   std::unique_ptr<ByteRleDecoder> notNullDecoder_;
   std::unique_ptr<dwio::common::SeekableInputStream> indexStream_;
   std::unique_ptr<proto::RowIndex> index_;
+  // Bloom filters per row index entry. Requested only if the column has a
+  // filter that can use them when constructed.
+  std::unique_ptr<dwio::common::SeekableInputStream> bloomFilterStream_;
+  std::unique_ptr<proto::BloomFilterIndex> bloomFilters_;
   // Number of rows in a row group. Last row group may have fewer rows.
   uint32_t rowsPerRowGroup_;
 
@@ -123,8 +139,12 @@ class DwrfParams : public dwio::common::FormatParams {
 
   std::unique_ptr<dwio::common::FormatData> toFormatData(
       const std::shared_ptr<const dwio::common::TypeWithId>& type,
-      const common::ScanSpec& /*scanSpec*/) override {
-    return std::make_unique<DwrfData>(type, stripeStreams_, flatMapContext_);
+      const common::ScanSpec& scanSpec) override {
+    return std::make_unique<DwrfData>(
+        type,
+        stripeStreams_,
+        flatMapContext_,
+        DwrfData::canUseBloomFilter(scanSpec.filter()));
   }
 
   StripeStreams& stripeStreams() {
@@ -15,9 +15,18 @@
  */
 
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/common/CachedBufferedInput.h"
+#include "velox/dwio/common/SelectiveStructColumnReader.h"
 #include "velox/dwio/common/TypeUtils.h"
 #include "velox/dwio/common/exception/Exception.h"
 
+DEFINE_int32(
+    velox_dwrf_prefetch_stripes,
+    1,
+    "Number of stripes after the current one whose frequently read "
+    "streams a DWRF reader loads in the background through the "
+    "AsyncDataCache");
+
 namespace facebook::velox::dwrf {
 
 using dwio::common::ColumnSelector;
@@ -213,20 +222,21 @@ void DwrfRowReader::checkSkipStrides(
     return;
   }
 
+  // 'stridesToSkip_' is sorted. Looks up the current stride instead of
+  // scanning from the start at every stride of the stripe.
   bool foundStridesToSkip = false;
-  auto currentStride = currentRowInStripe / strideSize;
-  for (auto strideToSkip : stridesToSkip_) {
-    if (currentStride < strideToSkip) {
-      break;
-    }
-
-    if (currentStride == strideToSkip) {
-      foundStridesToSkip = true;
-      currentRowInStripe =
-          std::min(currentRowInStripe + strideSize, rowsInCurrentStripe);
-      currentStride++;
-      skippedStrides_++;
+  uint32_t currentStride = currentRowInStripe / strideSize;
+  auto it = std::lower_bound(
+      stridesToSkip_.begin(), stridesToSkip_.end(), currentStride);
+  for (; it != stridesToSkip_.end() && *it <= currentStride; ++it) {
+    if (*it < currentStride) {
+      continue;
     }
+    foundStridesToSkip = true;
+    currentRowInStripe =
+        std::min(currentRowInStripe + strideSize, rowsInCurrentStripe);
+    currentStride++;
+    skippedStrides_++;
   }
   if (foundStridesToSkip && currentRowInStripe < rowsInCurrentStripe) {
     selectiveColumnReader_->seekToRowGroup(currentStride);
@@ -304,6 +314,14 @@ void DwrfRowReader::resetFilterCaches() {
   // For columnReader_, this is no-op.
 }
 
+bool DwrfRowReader::prepareNext(folly::SemiFuture<bool>* future) {
+  if (currentStripe >= lastStripe || currentRowInStripe != 0) {
+    return true;
+  }
+  startNextStripe();
+  return getStripeInput().loadedOrFuture(future);
+}
+
 void DwrfRowReader::startNextStripe() {
   if (newStripeLoaded || currentStripe >= lastStripe) {
     return;
@@ -324,19 +342,7 @@ void DwrfRowReader::startNextStripe() {
   // Create column reader
   columnReader_.reset();
   selectiveColumnReader_.reset();
-  auto scanSpec = options_.getScanSpec().get();
-  auto requestedType = getColumnSelector().getSchemaWithId();
-  auto dataType = getReader().getSchemaWithId();
-  auto flatMapContext = FlatMapContext::nonFlatMapContext();
-
-  if (scanSpec) {
-    selectiveColumnReader_ = SelectiveDwrfReader::build(
-        requestedType, dataType, stripeStreams, scanSpec, flatMapContext);
-    selectiveColumnReader_->setIsTopLevel();
-  } else {
-    columnReader_ = ColumnReader::build(
-        requestedType, dataType, stripeStreams, flatMapContext);
-  }
+  makeColumnReaders(stripeStreams, columnReader_, selectiveColumnReader_);
   DWIO_ENSURE(
       (columnReader_ != nullptr) != (selectiveColumnReader_ != nullptr),
       "ColumnReader was not created");
@@ -351,6 +357,94 @@ void DwrfRowReader::startNextStripe() {
 
   stripeDictionaryCache_ = stripeStreams.getStripeDictionaryCache();
   newStripeLoaded = true;
+  prefetchStripes();
+}
+
+void DwrfRowReader::makeColumnReaders(
+    StripeStreamsImpl& stripeStreams,
+    std::unique_ptr<ColumnReader>& columnReader,
+    std::unique_ptr<dwio::common::SelectiveColumnReader>&
+        selectiveColumnReader) {
+  auto scanSpec = options_.getScanSpec().get();
+  auto requestedType = getColumnSelector().getSchemaWithId();
+  auto dataType = getReader().getSchemaWithId();
+  auto flatMapContext = FlatMapContext::nonFlatMapContext();
+
+  if (scanSpec) {
+    selectiveColumnReader = SelectiveDwrfReader::build(
+        requestedType, dataType, stripeStreams, scanSpec, flatMapContext);
+    selectiveColumnReader->setIsTopLevel();
+    auto structReader =
+        dynamic_cast<dwio::common::SelectiveStructColumnReader*>(
+            selectiveColumnReader.get());
+    if (structReader && options_.getDecodingExecutor()) {
+      structReader->setDecodingExecutor(options_.getDecodingExecutor().get());
+    }
+  } else {
+    columnReader = ColumnReader::build(
+        requestedType, dataType, stripeStreams, flatMapContext);
+  }
+}
+
+void DwrfRowReader::prefetchStripes() {
+  // The prefetches up to the current stripe are done. Loads that have not
+  // started by now are read by the current stripe itself.
+  while (!stripePrefetches_.empty() &&
+         stripePrefetches_.front().stripe <= currentStripe) {
+    freePrefetchReaders_.push_back(
+        std::move(stripePrefetches_.front().reader));
+    stripePrefetches_.pop_front();
+  }
+  if (FLAGS_velox_dwrf_prefetch_stripes <= 0 ||
+      !getReader().getBufferedInput().shouldPrefetchStripes()) {
+    return;
+  }
+  const auto endStripe = std::min<uint64_t>(
+      lastStripe,
+      static_cast<uint64_t>(currentStripe) + 1 +
+          FLAGS_velox_dwrf_prefetch_stripes);
+  for (auto stripe = currentStripe + 1; stripe < endStripe; ++stripe) {
+    if (!stripePrefetches_.empty() &&
+        stripePrefetches_.back().stripe >= stripe) {
+      continue;
+    }
+    std::unique_ptr<StripeReaderBase> reader;
+    if (freePrefetchReaders_.empty()) {
+      reader = std::make_unique<StripeReaderBase>(readerBaseShared());
+    } else {
+      reader = std::move(freePrefetchReaders_.back());
+      freePrefetchReaders_.pop_back();
+    }
+    bool preload = false;
+    auto stripeInfo = reader->loadStripe(stripe, preload);
+    auto cachedInput = dynamic_cast<dwio::common::CachedBufferedInput*>(
+        &reader->getStripeInput());
+    if (!cachedInput) {
+      freePrefetchReaders_.push_back(std::move(reader));
+      return;
+    }
+    // The reader records the references when it gets to the stripe.
+    cachedInput->setTrackReferences(false);
+    StripeStreamsImpl stripeStreams(
+        *reader,
+        getColumnSelector(),
+        options_,
+        stripeInfo.offset(),
+        *this,
+        stripe);
+    // Making the column readers enqueues their streams.
+    std::unique_ptr<ColumnReader> columnReader;
+    std::unique_ptr<dwio::common::SelectiveColumnReader> selectiveReader;
+    makeColumnReaders(stripeStreams, columnReader, selectiveReader);
+    if (!cachedInput->shouldPreload()) {
+      freePrefetchReaders_.push_back(std::move(reader));
+      return;
+    }
+    // Schedules the streams that are dense enough for prefetch on the
+    // executor of the input.
+    cachedInput->load(dwio::common::LogType::STREAM_BUNDLE);
+    stripePrefetches_.push_back({stripe, std::move(reader)});
+  }
 }
 
 size_t DwrfRowReader::estimatedReaderMemory() const {
@@ -16,10 +16,16 @@
 
 #pragma once
 
+#include <deque>
+
+#include <gflags/gflags.h>
+
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/dwio/dwrf/reader/ColumnReader.h"
 #include "velox/dwio/dwrf/reader/SelectiveDwrfReader.h"
 
+DECLARE_int32(velox_dwrf_prefetch_stripes);
+
 namespace facebook::velox::dwrf {
 
 class DwrfRowReader : public StrideIndexProvider,
@@ -84,6 +90,10 @@ class DwrfRowReader : public StrideIndexProvider,
   // Returns number of rows read. Guaranteed to be less then or equal to size.
   uint64_t next(uint64_t size, VectorPtr& result) override;
 
+  // Loads the next stripe if next() would start it and returns false with
+  // 'future' set if its streams are being read on another thread.
+  bool prepareNext(folly::SemiFuture<bool>* future) override;
+
   void updateRuntimeStats(
       dwio::common::RuntimeStatistics& stats) const override {
     stats.skippedStrides += skippedStrides_;
@@ -133,12 +143,42 @@ class DwrfRowReader : public StrideIndexProvider,
   // next stride instead of next stripe.
   bool recomputeStridesToSkip_{false};
 
+  struct StripePrefetch {
+    uint32_t stripe;
+    // Holds the input whose loads bring the streams of 'stripe' into the
+    // cache. Destroying this cancels the loads that have not started.
+    std::unique_ptr<StripeReaderBase> reader;
+  };
+
+  // Prefetches of the stripes after the current one, in stripe order.
+  std::deque<StripePrefetch> stripePrefetches_;
+
+  // Readers of finished prefetches. Reused so that each prefetch does not
+  // allocate a new stripe footer in the arena of the file.
+  std::vector<std::unique_ptr<StripeReaderBase>> freePrefetchReaders_;
+
   // internal methods
 
   // Creates column reader tree and may start prefetch of frequently read
   // columns.
   void startNextStripe();
 
+  // Makes the column readers for the stripe of 'stripeStreams'. Sets
+  // 'selectiveColumnReader' if the options have a ScanSpec and
+  // 'columnReader' otherwise.
+  void makeColumnReaders(
+      StripeStreamsImpl& stripeStreams,
+      std::unique_ptr<ColumnReader>& columnReader,
+      std::unique_ptr<dwio::common::SelectiveColumnReader>&
+          selectiveColumnReader);
+
+  // Starts background loads of the frequently read streams of the
+  // FLAGS_velox_dwrf_prefetch_stripes stripes after 'currentStripe', so that
+  // the reader does not wait for storage at each stripe boundary. Only
+  // applies when reading through the AsyncDataCache. A stripe is not
+  // prefetched if the cache has no room for it.
+  void prefetchStripes();
+
   std::optional<size_t> estimatedRowSizeHelper(
       const FooterWrapper& footer,
       const dwio::common::Statistics& stats,
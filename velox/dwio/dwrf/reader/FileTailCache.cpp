@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/dwrf/reader/FileTailCache.h"
+
+DEFINE_int64(
+    velox_dwrf_file_tail_cache_bytes,
+    0,
+    "Capacity in bytes of the process-wide cache of parsed DWRF file tails. "
+    "0 disables the cache");
+
+namespace facebook::velox::dwrf {
+
+FileTailCache::FileTailCache(int64_t maxBytes)
+    : maxBytes_(maxBytes),
+      pool_(memory::getDefaultScopedMemoryPool()),
+      cache_(std::make_unique<TailLruCache>(maxBytes_)) {
+  VELOX_CHECK_GT(maxBytes_, 0);
+}
+
+// static
+FileTailCache* FileTailCache::instance() {
+  if (FLAGS_velox_dwrf_file_tail_cache_bytes <= 0) {
+    return nullptr;
+  }
+  static auto cache =
+      std::make_unique<FileTailCache>(FLAGS_velox_dwrf_file_tail_cache_bytes);
+  return cache.get();
+}
+
+std::shared_ptr<const FileTail> FileTailCache::find(
+    uint64_t fileNum,
+    uint64_t fileLength) {
+  const Key key{fileNum, fileLength};
+  std::lock_guard<std::mutex> l(mutex_);
+  auto* tail = cache_->get(key);
+  if (!tail) {
+    ++stats_.numMisses;
+    return nullptr;
+  }
+  auto result = *tail;
+  cache_->release(key);
+  ++stats_.numHits;
+  return result;
+}
+
+void FileTailCache::insert(
+    uint64_t fileNum,
+    std::shared_ptr<const FileTail> tail) {
+  VELOX_CHECK_NOT_NULL(tail);
+  const Key key{fileNum, tail->fileLength};
+  const auto bytes = tail->bytes;
+  auto value = std::make_unique<TailPtr>(std::move(tail));
+  std::lock_guard<std::mutex> l(mutex_);
+  if (cache_->add(key, value.get(), bytes)) {
+    value.release();
+  }
+}
+
+FileTailCache::Stats FileTailCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto stats = stats_;
+  stats.bytes = cache_->currentSize();
+  return stats;
+}
+
+void FileTailCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  cache_ = std::make_unique<TailLruCache>(maxBytes_);
+}
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <folly/hash/Hash.h>
+#include <gflags/gflags.h>
+#include <memory>
+#include <mutex>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/dwrf/common/FileMetadata.h"
+#include "velox/type/Type.h"
+
+DECLARE_int64(velox_dwrf_file_tail_cache_bytes);
+
+namespace facebook::velox::dwrf {
+
+/// The parsed tail of a DWRF or ORC file. Made once by the first ReaderBase
+/// of the file and immutable after that, so that it can be shared by all
+/// readers of the file through FileTailCache.
+struct FileTail {
+  uint64_t fileLength{0};
+  uint64_t psLength{0};
+  std::shared_ptr<const PostScript> postScript;
+  // Owns the footer. The per-reader arena of ReaderBase holds the stripe
+  // footers, which are read by each reader.
+  std::unique_ptr<google::protobuf::Arena> arena;
+  std::unique_ptr<FooterWrapper> footer;
+  RowTypePtr schema;
+  // The contents of the stripe metadata cache. nullptr if the file has none
+  // or if they are read through CacheInputStream, which caches them itself.
+  std::shared_ptr<dwio::common::DataBuffer<char>> stripeCache;
+  // Estimate of the memory held by 'this'.
+  int64_t bytes{0};
+};
+
+/// Process-wide LRU cache of FileTails bounded by the total bytes of the
+/// tails. Repeated scans of the same files skip reading and parsing the
+/// tail. Keyed on the file number of the reader and the file length. The
+/// length stands in for a modification time, which InputStream does not
+/// expose. A rewritten file of another length gets a new entry and the old
+/// one ages out.
+class FileTailCache {
+ public:
+  struct Stats {
+    int64_t numHits{0};
+    int64_t numMisses{0};
+    int64_t bytes{0};
+  };
+
+  explicit FileTailCache(int64_t maxBytes);
+
+  /// Returns the process-wide instance, nullptr if
+  /// FLAGS_velox_dwrf_file_tail_cache_bytes is 0.
+  static FileTailCache* instance();
+
+  /// Returns the tail of 'fileNum' with 'fileLength' or nullptr if not
+  /// cached.
+  std::shared_ptr<const FileTail> find(uint64_t fileNum, uint64_t fileLength);
+
+  /// Adds 'tail' for 'fileNum' and 'tail->fileLength', evicting the least
+  /// recently used tails if over capacity. Does nothing if the key is
+  /// already cached or if 'tail' is larger than the capacity.
+  void insert(uint64_t fileNum, std::shared_ptr<const FileTail> tail);
+
+  /// Pool for the stripe metadata cache buffers of the cached tails. These
+  /// outlive the query that read them and must not count against its pool.
+  memory::MemoryPool& pool() {
+    return *pool_;
+  }
+
+  Stats stats() const;
+
+  void clear();
+
+ private:
+  using TailPtr = std::shared_ptr<const FileTail>;
+
+  struct Key {
+    uint64_t fileNum;
+    uint64_t fileLength;
+
+    bool operator==(const Key& other) const {
+      return fileNum == other.fileNum && fileLength == other.fileLength;
+    }
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const {
+      return folly::hash::hash_combine(key.fileNum, key.fileLength);
+    }
+  };
+
+  using TailLruCache =
+      SimpleLRUCache<Key, TailPtr, std::equal_to<Key>, KeyHasher>;
+
+  const int64_t maxBytes_;
+  std::unique_ptr<memory::ScopedMemoryPool> pool_;
+  mutable std::mutex mutex_;
+  // Replaced by clear(), which drops all entries. The entries are pinned
+  // only while 'mutex_' is held.
+  std::unique_ptr<TailLruCache> cache_;
+  Stats stats_;
+};
+
+} // namespace facebook::velox::dwrf
@@ -198,6 +198,28 @@ class KeyPredicate {
   std::function<bool(const KeyValue<T>&, const Lookup&)> predicate_;
 };
 
+// Returns the key of the flat map value stream with key info 'info'.
+template <typename T>
+KeyValue<T> extractKey(const proto::KeyInfo& info);
+
+template <>
+KeyValue<StringView> extractKey<StringView>(const proto::KeyInfo& info);
+
+// Parses a key given as a string in a key projection.
+template <typename T>
+KeyValue<T> parseKeyValue(std::string_view str);
+
+template <>
+KeyValue<StringView> parseKeyValue<StringView>(std::string_view str);
+
+// Returns the predicate for the keys to read of the flat map at
+// 'requestedType' from the key projection in the column selector of
+// 'stripe'. Allows all keys if there is no projection.
+template <typename T>
+KeyPredicate<T> prepareKeyPredicate(
+    const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+    StripeStreams& stripe);
+
 template <typename T>
 class FlatMapColumnReader : public ColumnReader {
  public:
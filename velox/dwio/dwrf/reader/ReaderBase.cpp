@@ -104,12 +104,74 @@ ReaderBase::ReaderBase(
               : dwio::common::BufferedInputFactory::baseFactoryShared()) {
   input_ = bufferedInputFactory_->create(*stream_, pool, fileNum);
 
-  // read last bytes into buffer to get PostScript
-  // If file is small, load the entire file.
-  // TODO: make a config
   fileLength_ = stream_->getLength();
   DWIO_ENSURE(fileLength_ > 0, "ORC file is empty");
 
+  auto* tailCache =
+      fileNum_ == kDefaultFileNum ? nullptr : FileTailCache::instance();
+  if (tailCache) {
+    tail_ = tailCache->find(fileNum_, fileLength_);
+  }
+  if (!tail_) {
+    tail_ = readTail(fileFormat, tailCache);
+    if (tailCache) {
+      tailCache->insert(fileNum_, tail_);
+    }
+  }
+  psLength_ = tail_->psLength;
+  postScript_ = tail_->postScript;
+  footer_ = std::make_unique<FooterWrapper>(*tail_->footer);
+  schema_ = tail_->schema;
+
+  // load stripe index/footer cache
+  const uint64_t cacheSize =
+      postScript_->hasCacheSize() ? postScript_->cacheSize() : 0;
+  if (cacheSize > 0) {
+    if (tail_->stripeCache) {
+      cache_ = std::make_unique<StripeMetadataCache>(
+          postScript_->cacheMode(), *footer_, tail_->stripeCache);
+    } else if (input_->shouldPrefetchStripes()) {
+      const uint64_t tailSize =
+          1 + psLength_ + postScript_->footerLength() + cacheSize;
+      cache_ = std::make_unique<StripeMetadataCache>(
+          postScript_->cacheMode(),
+          *footer_,
+          input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER));
+      input_->load(LogType::FOOTER);
+    } else {
+      // The tail was cached by a reader that read the stripe metadata
+      // through CacheInputStream.
+      cache_ = std::make_unique<StripeMetadataCache>(
+          postScript_->cacheMode(),
+          *footer_,
+          readStripeCache(pool_, cacheSize));
+    }
+  }
+  if (!cache_ && input_->shouldPrefetchStripes()) {
+    auto numStripes = getFooter().stripesSize();
+    for (auto i = 0; i < numStripes; i++) {
+      const auto stripe = getFooter().stripes(i);
+      input_->enqueue(
+          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
+           stripe.footerLength()});
+    }
+    if (numStripes) {
+      input_->load(LogType::FOOTER);
+    }
+  }
+  // initialize file decrypter
+  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+}
+
+std::shared_ptr<const FileTail> ReaderBase::readTail(
+    FileFormat fileFormat,
+    FileTailCache* tailCache) {
+  auto tail = std::make_shared<FileTail>();
+  tail->fileLength = fileLength_;
+
+  // read last bytes into buffer to get PostScript
+  // If file is small, load the entire file.
+  // TODO: make a config
   auto preloadFile = fileLength_ <= FILE_PRELOAD_THRESHOLD;
   uint64_t readSize =
       preloadFile ? fileLength_ : std::min(fileLength_, DIRECTORY_SIZE_GUESS);
@@ -135,11 +197,11 @@ ReaderBase::ReaderBase(
   if (fileFormat == FileFormat::DWRF) {
     auto postScript = ProtoUtils::readProto<proto::PostScript>(
         input_->read(fileLength_ - psLength_ - 1, psLength_, LogType::FOOTER));
-    postScript_ = std::make_unique<PostScript>(std::move(postScript));
+    postScript_ = std::make_shared<PostScript>(std::move(postScript));
   } else {
     auto postScript = ProtoUtils::readProto<proto::orc::PostScript>(
         input_->read(fileLength_ - psLength_ - 1, psLength_, LogType::FOOTER));
-    postScript_ = std::make_unique<PostScript>(std::move(postScript));
+    postScript_ = std::make_shared<PostScript>(std::move(postScript));
   }
 
   uint64_t footerSize = postScript_->footerLength();
@@ -168,59 +230,56 @@ ReaderBase::ReaderBase(
     input_->load(LogType::FOOTER);
   }
 
+  tail->arena = std::make_unique<google::protobuf::Arena>();
   auto footerStream = input_->read(
       fileLength_ - psLength_ - footerSize - 1, footerSize, LogType::FOOTER);
   if (fileFormat == FileFormat::DWRF) {
-    auto footer =
-        google::protobuf::Arena::CreateMessage<proto::Footer>(arena_.get());
+    auto footer = google::protobuf::Arena::CreateMessage<proto::Footer>(
+        tail->arena.get());
     ProtoUtils::readProtoInto<proto::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
-    footer_ = std::make_unique<FooterWrapper>(footer);
+    tail->footer = std::make_unique<FooterWrapper>(footer);
   } else {
     auto footer = google::protobuf::Arena::CreateMessage<proto::orc::Footer>(
-        arena_.get());
+        tail->arena.get());
     ProtoUtils::readProtoInto<proto::orc::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
-    footer_ = std::make_unique<FooterWrapper>(footer);
+    tail->footer = std::make_unique<FooterWrapper>(footer);
   }
 
-  schema_ = std::dynamic_pointer_cast<const RowType>(convertType(*footer_));
-  DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
+  tail->schema =
+      std::dynamic_pointer_cast<const RowType>(convertType(*tail->footer));
+  DWIO_ENSURE_NOT_NULL(tail->schema, "invalid schema");
 
-  // load stripe index/footer cache
   if (cacheSize > 0) {
     DWIO_ENSURE_EQ(format(), DwrfFormat::kDwrf);
-    if (input_->shouldPrefetchStripes()) {
-      cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(),
-          *footer_,
-          input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER));
-      input_->load(LogType::FOOTER);
-    } else {
-      auto cacheBuffer =
-          std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
-      input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
-          ->readFully(cacheBuffer->data(), cacheSize);
-      cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
-    }
-  }
-  if (!cache_ && input_->shouldPrefetchStripes()) {
-    auto numStripes = getFooter().stripesSize();
-    for (auto i = 0; i < numStripes; i++) {
-      const auto stripe = getFooter().stripes(i);
-      input_->enqueue(
-          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
-           stripe.footerLength()});
-    }
-    if (numStripes) {
-      input_->load(LogType::FOOTER);
+    // With CacheInputStream the stripe metadata is read through the data
+    // cache, which also keeps it across readers.
+    if (!input_->shouldPrefetchStripes()) {
+      tail->stripeCache = readStripeCache(
+          tailCache ? tailCache->pool() : pool_, cacheSize);
     }
   }
-  // initialize file decrypter
-  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+
+  tail->psLength = psLength_;
+  tail->postScript = postScript_;
+  tail->bytes = psLength_ + tail->arena->SpaceAllocated() +
+      (tail->stripeCache ? tail->stripeCache->capacity() : 0);
+  return tail;
+}
+
+std::shared_ptr<dwio::common::DataBuffer<char>> ReaderBase::readStripeCache(
+    MemoryPool& pool,
+    uint64_t cacheSize) {
+  const uint64_t tailSize =
+      1 + psLength_ + postScript_->footerLength() + cacheSize;
+  auto buffer = std::make_shared<dwio::common::DataBuffer<char>>(
+      pool, cacheSize);
+  input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
+      ->readFully(buffer->data(), cacheSize);
+  return buffer;
 }
 
 std::vector<uint64_t> ReaderBase::getRowsPerStripe() const {
@@ -23,6 +23,7 @@
 #include "velox/dwio/dwrf/common/Compression.h"
 #include "velox/dwio/dwrf/common/FileMetadata.h"
 #include "velox/dwio/dwrf/common/Statistics.h"
+#include "velox/dwio/dwrf/reader/FileTailCache.h"
 #include "velox/dwio/dwrf/reader/StripeMetadataCache.h"
 #include "velox/dwio/dwrf/utils/ProtoUtils.h"
 
@@ -245,14 +246,32 @@ class ReaderBase {
   }
 
  private:
+  // Reads and parses the tail of the file. Allocates the stripe metadata
+  // cache from the pool of 'tailCache' if given, since the tail may then
+  // outlive 'this'.
+  std::shared_ptr<const FileTail> readTail(
+      dwio::common::FileFormat fileFormat,
+      FileTailCache* tailCache);
+
+  // Reads the 'cacheSize' bytes of the stripe metadata cache of the file
+  // into a buffer from 'pool'.
+  std::shared_ptr<dwio::common::DataBuffer<char>> readStripeCache(
+      memory::MemoryPool& pool,
+      uint64_t cacheSize);
+
   static std::shared_ptr<const Type> convertType(
       const FooterWrapper& footer,
       uint32_t index = 0);
 
   memory::MemoryPool& pool_;
   std::unique_ptr<dwio::common::InputStream> stream_;
+  // Holds the stripe footers read by 'this'. The file footer is in the
+  // arena of 'tail_'.
   std::unique_ptr<google::protobuf::Arena> arena_;
-  std::unique_ptr<PostScript> postScript_;
+  // The parsed tail, possibly shared with other readers of the file through
+  // FileTailCache. nullptr if 'this' is made from metadata.
+  std::shared_ptr<const FileTail> tail_;
+  std::shared_ptr<const PostScript> postScript_;
   std::unique_ptr<FooterWrapper> footer_ = nullptr;
   uint64_t fileNum_;
   std::unique_ptr<StripeMetadataCache> cache_;
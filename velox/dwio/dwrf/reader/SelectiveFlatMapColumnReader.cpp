@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/reader/SelectiveFlatMapColumnReader.h"
+
+#include "velox/dwio/dwrf/reader/FlatMapColumnReader.h"
+#include "velox/dwio/dwrf/reader/SelectiveDwrfReader.h"
+
+namespace facebook::velox::dwrf {
+
+using dwio::common::TypeWithId;
+
+template <typename T>
+SelectiveFlatMapColumnReader<T>::SelectiveFlatMapColumnReader(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    DwrfParams& params,
+    common::ScanSpec& scanSpec)
+    : SelectiveColumnReader(dataType, params, scanSpec, dataType->type),
+      requestedType_{requestedType} {
+  DWIO_ENSURE_EQ(nodeType_->id, dataType->id, "working on the same node");
+  auto& stripe = params.stripeStreams();
+  if (scanSpec_->children().empty()) {
+    scanSpec_->getOrCreateChild(common::Subfield("keys"));
+    scanSpec_->getOrCreateChild(common::Subfield("elements"));
+  }
+  scanSpec_->children()[0]->setProjectOut(true);
+  scanSpec_->children()[0]->setExtractValues(true);
+  scanSpec_->children()[1]->setProjectOut(true);
+  scanSpec_->children()[1]->setExtractValues(true);
+  auto& valueSpec = *scanSpec_->children()[1];
+
+  // With struct encoding only the keys of the struct are read.
+  const auto& mapColumnIdAsStruct =
+      stripe.getRowReaderOptions().getMapColumnIdAsStruct();
+  auto structIt = mapColumnIdAsStruct.find(requestedType_->id);
+  std::unordered_set<KeyValue<T>, KeyValueHash<T>> structKeys;
+  if (structIt != mapColumnIdAsStruct.end()) {
+    structKeys_ = structIt->second;
+    for (const auto& key : structKeys_) {
+      structKeys.insert(parseKeyValue<T>(key));
+    }
+  }
+  const auto keyPredicate = prepareKeyPredicate<T>(requestedType_, stripe);
+
+  const auto& requestedValueType = requestedType_->childAt(1);
+  const auto& dataValueType = nodeType_->childAt(1);
+  std::unordered_set<uint32_t> processed;
+  stripe.visitStreamsOfNode(
+      dataValueType->id, [&](const StreamInformation& stream) {
+        const auto sequence = stream.getSequence();
+        // Sequence 0 has the dictionary shared by all keys.
+        if (sequence == 0 || !processed.insert(sequence).second) {
+          return;
+        }
+        EncodingKey seqEk(dataValueType->id, sequence);
+        auto key = extractKey<T>(stripe.getEncoding(seqEk).key());
+        if (!keyPredicate(key) ||
+            (!structKeys_.empty() && structKeys.count(key) == 0)) {
+          return;
+        }
+        auto inMap =
+            stripe.getStream(seqEk.forKind(proto::Stream_Kind_IN_MAP), true);
+        DWIO_ENSURE_NOT_NULL(inMap, "In map stream is required");
+        auto node = std::make_unique<KeyNode>();
+        node->key = key.get();
+        node->sequence = sequence;
+        node->inMap = createBooleanRleDecoder(std::move(inMap), seqEk);
+        // The value reader seeks 'inMap' in seekToRowGroup().
+        DwrfParams valueParams(
+            stripe, FlatMapContext{sequence, node->inMap.get()});
+        node->reader = SelectiveDwrfReader::build(
+            requestedValueType, dataValueType, valueParams, valueSpec);
+        keyNodes_.push_back(std::move(node));
+      });
+  std::sort(
+      keyNodes_.begin(), keyNodes_.end(), [](const auto& a, const auto& b) {
+        return a->sequence < b->sequence;
+      });
+
+  if constexpr (std::is_same_v<T, StringView>) {
+    // The keys point to the stripe footer. Copies them so that the result
+    // can outlive the stripe.
+    size_t size = 0;
+    for (auto& node : keyNodes_) {
+      size += node->key.size();
+    }
+    keyBuffer_ = AlignedBuffer::allocate<char>(size, &memoryPool_);
+    auto* data = keyBuffer_->asMutable<char>();
+    for (auto& node : keyNodes_) {
+      const auto keySize = node->key.size();
+      memcpy(data, node->key.data(), keySize);
+      node->key = StringView(data, keySize);
+      data += keySize;
+    }
+  }
+
+  if (!structKeys_.empty()) {
+    std::unordered_map<KeyValue<T>, KeyNode*, KeyValueHash<T>> nodes;
+    for (auto& node : keyNodes_) {
+      nodes.emplace(KeyValue<T>(node->key), node.get());
+    }
+    for (const auto& key : structKeys_) {
+      auto it = nodes.find(parseKeyValue<T>(key));
+      structNodes_.push_back(it == nodes.end() ? nullptr : it->second);
+    }
+  }
+
+  VLOG(1) << "[Flat-Map] Initialized a selective flat map reader for node "
+          << nodeType_->id << ", keys=" << keyNodes_.size();
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::seekToRowGroup(uint32_t index) {
+  SelectiveColumnReader::seekToRowGroup(index);
+  formatData_->seekToRowGroup(index);
+  for (auto& node : keyNodes_) {
+    node->reader->seekToRowGroup(index);
+    node->reader->setReadOffsetRecursive(0);
+    node->targetReadOffset = 0;
+  }
+}
+
+template <typename T>
+uint64_t SelectiveFlatMapColumnReader<T>::skip(uint64_t numValues) {
+  const auto numMaps = formatData_->skipNulls(numValues);
+  if (numMaps == 0) {
+    return numValues;
+  }
+  // Only the in map streams are read here. The value readers skip to
+  // 'targetReadOffset' at the next read().
+  constexpr uint64_t kBufferWords = 128;
+  std::array<uint64_t, kBufferWords> buffer;
+  for (auto& node : keyNodes_) {
+    uint64_t remaining = numMaps;
+    while (remaining > 0) {
+      const auto chunk = std::min(remaining, kBufferWords * 64);
+      node->inMap->next(reinterpret_cast<char*>(buffer.data()), chunk, nullptr);
+      node->targetReadOffset += bits::countBits(buffer.data(), 0, chunk);
+      remaining -= chunk;
+    }
+  }
+  return numValues;
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::makeValueRows(
+    const KeyNode& node,
+    RowSet rows,
+    raw_vector<vector_size_t>& valueRows) const {
+  const auto* inMap = node.inMapBits.data();
+  valueRows.clear();
+  // The position of the value of a row is the count of maps with the key
+  // before the row.
+  vector_size_t position = 0;
+  vector_size_t counted = 0;
+  for (auto row : rows) {
+    if (!bits::isBitSet(inMap, row)) {
+      continue;
+    }
+    position += bits::countBits(inMap, counted, row);
+    counted = row;
+    valueRows.push_back(position);
+  }
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::read(
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* incomingNulls) {
+  prepareRead<char>(offset, rows, incomingNulls);
+  const vector_size_t numRows = rows.back() + 1;
+  const auto* nulls =
+      nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
+  for (auto& node : keyNodes_) {
+    // The in map stream has a flag per non-null map. Reading with 'nulls'
+    // aligns the flags with the rows and leaves 0 for null maps.
+    node->inMapBits.resize(bits::nwords(numRows));
+    node->inMap->next(
+        reinterpret_cast<char*>(node->inMapBits.data()), numRows, nulls);
+    makeValueRows(*node, rows, valueRows_);
+    const auto valueOffset = node->targetReadOffset;
+    node->targetReadOffset +=
+        bits::countBits(node->inMapBits.data(), 0, numRows);
+    if (!valueRows_.empty()) {
+      node->reader->read(valueOffset, valueRows_, nullptr);
+    }
+  }
+  numValues_ = rows.size();
+  readOffset_ = offset + numRows;
+}
+
+template <typename T>
+BufferPtr SelectiveFlatMapColumnReader<T>::makeResultNulls(RowSet rows) {
+  if (!nullsInReadRange_) {
+    return nullptr;
+  }
+  const auto* rawNulls = nullsInReadRange_->as<uint64_t>();
+  auto nulls = AlignedBuffer::allocate<bool>(rows.size(), &memoryPool_);
+  auto* rawResultNulls = nulls->asMutable<uint64_t>();
+  for (auto i = 0; i < rows.size(); ++i) {
+    bits::setNull(rawResultNulls, i, bits::isBitNull(rawNulls, rows[i]));
+  }
+  return nulls;
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::getValues(
+    RowSet rows,
+    VectorPtr* result) {
+  for (auto& node : keyNodes_) {
+    makeValueRows(*node, rows, valueRows_);
+    if (valueRows_.empty()) {
+      node->values.reset();
+    } else {
+      node->reader->getValues(valueRows_, &node->values);
+    }
+  }
+  auto nulls = makeResultNulls(rows);
+  if (structKeys_.empty()) {
+    makeMapResult(rows, std::move(nulls), result);
+  } else {
+    makeStructResult(rows, std::move(nulls), result);
+  }
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::makeMapResult(
+    RowSet rows,
+    BufferPtr nulls,
+    VectorPtr* result) {
+  // The values of each key are in their own vector. The map values are a
+  // dictionary over these laid end to end.
+  std::vector<KeyNode*> nodes;
+  std::vector<vector_size_t> starts;
+  vector_size_t numEntries = 0;
+  for (auto& node : keyNodes_) {
+    if (node->values) {
+      nodes.push_back(node.get());
+      starts.push_back(numEntries);
+      numEntries += node->values->size();
+    }
+  }
+  const auto& valueType = nodes.empty() ? requestedType_->type->childAt(1)
+                                         : nodes[0]->values->type();
+  auto values = BaseVector::create(valueType, numEntries, &memoryPool_);
+  for (auto i = 0; i < nodes.size(); ++i) {
+    values->copy(
+        nodes[i]->values.get(), starts[i], 0, nodes[i]->values->size());
+  }
+  auto keys = BaseVector::create<FlatVector<T>>(
+      requestedType_->type->childAt(0), numEntries, &memoryPool_);
+  if (keyBuffer_) {
+    keys->setStringBuffers({keyBuffer_});
+  }
+  auto* rawKeys = keys->mutableRawValues();
+  auto indices = allocateIndices(numEntries, &memoryPool_);
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  auto offsets = allocateIndices(rows.size(), &memoryPool_);
+  auto* rawOffsets = offsets->asMutable<vector_size_t>();
+  auto sizes = allocateIndices(rows.size(), &memoryPool_);
+  auto* rawSizes = sizes->asMutable<vector_size_t>();
+
+  vector_size_t entry = 0;
+  for (auto i = 0; i < rows.size(); ++i) {
+    const auto row = rows[i];
+    rawOffsets[i] = entry;
+    for (auto j = 0; j < nodes.size(); ++j) {
+      if (bits::isBitSet(nodes[j]->inMapBits.data(), row)) {
+        rawKeys[entry] = nodes[j]->key;
+        rawIndices[entry] = starts[j]++;
+        ++entry;
+      }
+    }
+    rawSizes[i] = entry - rawOffsets[i];
+  }
+  VELOX_CHECK_EQ(numEntries, entry);
+
+  *result = std::make_shared<MapVector>(
+      &memoryPool_,
+      requestedType_->type,
+      std::move(nulls),
+      rows.size(),
+      std::move(offsets),
+      std::move(sizes),
+      std::move(keys),
+      BaseVector::wrapInDictionary(
+          nullptr, std::move(indices), numEntries, std::move(values)));
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::makeStructResult(
+    RowSet rows,
+    BufferPtr nulls,
+    VectorPtr* result) {
+  const auto& valueType = requestedType_->type->childAt(1);
+  std::vector<VectorPtr> children;
+  children.reserve(structNodes_.size());
+  for (auto* node : structNodes_) {
+    if (!node || !node->values) {
+      children.push_back(
+          BaseVector::createNullConstant(valueType, rows.size(), &memoryPool_));
+      continue;
+    }
+    // The rows that do not have the key are null.
+    auto indices = allocateIndices(rows.size(), &memoryPool_);
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    auto childNulls = AlignedBuffer::allocate<bool>(
+        rows.size(), &memoryPool_, bits::kNotNull);
+    auto* rawChildNulls = childNulls->asMutable<uint64_t>();
+    vector_size_t position = 0;
+    for (auto i = 0; i < rows.size(); ++i) {
+      if (bits::isBitSet(node->inMapBits.data(), rows[i])) {
+        rawIndices[i] = position++;
+      } else {
+        rawIndices[i] = 0;
+        bits::setNull(rawChildNulls, i);
+      }
+    }
+    children.push_back(BaseVector::wrapInDictionary(
+        std::move(childNulls), std::move(indices), rows.size(), node->values));
+  }
+  *result = std::make_shared<RowVector>(
+      &memoryPool_,
+      ROW(std::vector<std::string>(structKeys_),
+          std::vector<TypePtr>(structKeys_.size(), valueType)),
+      std::move(nulls),
+      rows.size(),
+      std::move(children));
+}
+
+namespace {
+template <typename T>
+std::unique_ptr<dwio::common::SelectiveColumnReader> makeReader(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    DwrfParams& params,
+    common::ScanSpec& scanSpec) {
+  return std::make_unique<SelectiveFlatMapColumnReader<T>>(
+      requestedType, dataType, params, scanSpec);
+}
+} // namespace
+
+std::unique_ptr<dwio::common::SelectiveColumnReader>
+createSelectiveFlatMapColumnReader(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    DwrfParams& params,
+    common::ScanSpec& scanSpec) {
+  const auto kind = dataType->childAt(0)->type->kind();
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return makeReader<int8_t>(requestedType, dataType, params, scanSpec);
+    case TypeKind::SMALLINT:
+      return makeReader<int16_t>(requestedType, dataType, params, scanSpec);
+    case TypeKind::INTEGER:
+      return makeReader<int32_t>(requestedType, dataType, params, scanSpec);
+    case TypeKind::BIGINT:
+      return makeReader<int64_t>(requestedType, dataType, params, scanSpec);
+    case TypeKind::VARBINARY:
+    case TypeKind::VARCHAR:
+      return makeReader<StringView>(requestedType, dataType, params, scanSpec);
+    default:
+      DWIO_RAISE("Not supported key type: ", kind);
+  }
+}
+
+template class SelectiveFlatMapColumnReader<int8_t>;
+template class SelectiveFlatMapColumnReader<int16_t>;
+template class SelectiveFlatMapColumnReader<int32_t>;
+template class SelectiveFlatMapColumnReader<int64_t>;
+template class SelectiveFlatMapColumnReader<StringView>;
+
+} // namespace facebook::velox::dwrf
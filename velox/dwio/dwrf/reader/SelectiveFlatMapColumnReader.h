@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/SelectiveColumnReaderInternal.h"
+#include "velox/dwio/dwrf/reader/DwrfData.h"
+
+namespace facebook::velox::dwrf {
+
+// Selective reader for a map column with flat map encoding. A flat map
+// stores the values of each key in separate streams, with an in map stream
+// telling which maps have the key. Only the keys allowed by the key
+// projection in the column selector are read, so that the streams of the
+// other keys are not loaded or decoded. Produces a MapVector or, if the
+// column is in RowReaderOptions::getMapColumnIdAsStruct(), a RowVector with
+// one child per projected key.
+template <typename T>
+class SelectiveFlatMapColumnReader
+    : public dwio::common::SelectiveColumnReader {
+ public:
+  SelectiveFlatMapColumnReader(
+      const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+      const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+      DwrfParams& params,
+      common::ScanSpec& scanSpec);
+
+  bool useBulkPath() const override {
+    return false;
+  }
+
+  void resetFilterCaches() override {
+    for (auto& node : keyNodes_) {
+      node->reader->resetFilterCaches();
+    }
+  }
+
+  void seekToRowGroup(uint32_t index) override;
+
+  uint64_t skip(uint64_t numValues) override;
+
+  void read(vector_size_t offset, RowSet rows, const uint64_t* incomingNulls)
+      override;
+
+  void getValues(RowSet rows, VectorPtr* result) override;
+
+ private:
+  struct KeyNode {
+    T key;
+    uint32_t sequence;
+    std::unique_ptr<BooleanRleDecoder> inMap;
+    std::unique_ptr<dwio::common::SelectiveColumnReader> reader;
+    // In map flags for the rows of the map in the last read(), 0 for null
+    // maps.
+    raw_vector<uint64_t> inMapBits;
+    // Position in the values of the key after the maps read or skipped so
+    // far. 'reader' catches up to this at the next read().
+    vector_size_t targetReadOffset{0};
+    // Values of the key in the rows of the last getValues().
+    VectorPtr values;
+  };
+
+  // Sets 'valueRows' to the positions in the values of 'node' read in the
+  // last read() for the non-null maps in 'rows' that have the key.
+  void makeValueRows(
+      const KeyNode& node,
+      RowSet rows,
+      raw_vector<vector_size_t>& valueRows) const;
+
+  // Returns the nulls for 'rows' of the last read(), nullptr if none.
+  BufferPtr makeResultNulls(RowSet rows);
+
+  void makeMapResult(RowSet rows, BufferPtr nulls, VectorPtr* result);
+
+  void makeStructResult(RowSet rows, BufferPtr nulls, VectorPtr* result);
+
+  const std::shared_ptr<const dwio::common::TypeWithId> requestedType_;
+  // The keys to read, ordered on the sequence of their streams.
+  std::vector<std::unique_ptr<KeyNode>> keyNodes_;
+  // Backs the keys of 'keyNodes_' if these are strings.
+  BufferPtr keyBuffer_;
+  // Projected keys if returning a struct. 'structNodes_' has the node of
+  // each, nullptr if the key is not in the stripe.
+  std::vector<std::string> structKeys_;
+  std::vector<KeyNode*> structNodes_;
+  raw_vector<vector_size_t> valueRows_;
+};
+
+// Returns a SelectiveFlatMapColumnReader for the key type of 'dataType'.
+std::unique_ptr<dwio::common::SelectiveColumnReader>
+createSelectiveFlatMapColumnReader(
+    const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+    const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+    DwrfParams& params,
+    common::ScanSpec& scanSpec);
+
+} // namespace facebook::velox::dwrf
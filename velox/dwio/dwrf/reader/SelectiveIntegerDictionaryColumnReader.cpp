@@ -31,7 +31,9 @@ SelectiveIntegerDictionaryColumnReader::SelectiveIntegerDictionaryColumnReader(
           std::move(requestedType),
           params,
           scanSpec,
-          dataType->type) {
+          dataType->type),
+      numBytes_(numBytes),
+      dictionaryCache_(params.stripeStreams().getStripeDictionaryCache()) {
   EncodingKey encodingKey{nodeType_->id, params.flatMapContext().sequence};
   auto& stripe = params.stripeStreams();
   auto encoding = stripe.getEncoding(encodingKey);
@@ -99,9 +101,61 @@ void SelectiveIntegerDictionaryColumnReader::read(
 
   // lazy load dictionary only when it's needed
   ensureInitialized();
+  if (needFilterResults_) {
+    loadFilterResults();
+  }
   readCommon<SelectiveIntegerDictionaryColumnReader>(rows);
 }
 
+void SelectiveIntegerDictionaryColumnReader::resetFilterCaches() {
+  SelectiveColumnReader::resetFilterCaches();
+  if (scanState_.dictionary.values) {
+    dictionaryCache_->clearFilterResults(scanState_.dictionary.values);
+  }
+  needFilterResults_ = true;
+}
+
+template <typename T>
+void SelectiveIntegerDictionaryColumnReader::filterDictionary(
+    const common::Filter& filter,
+    int32_t numValues,
+    uint8_t* results) const {
+  const auto* values = scanState_.dictionary.values->as<T>();
+  for (auto i = 0; i < numValues; ++i) {
+    results[i] = filter.testInt64(values[i]) ? FilterResult::kSuccess
+                                             : FilterResult::kFailure;
+  }
+}
+
+void SelectiveIntegerDictionaryColumnReader::loadFilterResults() {
+  needFilterResults_ = false;
+  auto* filter = scanSpec_->filter();
+  const auto numValues = scanState_.dictionary.numValues;
+  if (!StripeDictionaryCache::shouldFilterDictionary(filter, numValues)) {
+    return;
+  }
+  const auto& results = dictionaryCache_->getFilterResults(
+      scanState_.dictionary.values,
+      filter,
+      numValues,
+      [&](uint8_t* results) {
+        switch (numBytes_) {
+          case 2:
+            filterDictionary<int16_t>(*filter, numValues, results);
+            break;
+          case 4:
+            filterDictionary<int32_t>(*filter, numValues, results);
+            break;
+          case 8:
+            filterDictionary<int64_t>(*filter, numValues, results);
+            break;
+          default:
+            VELOX_FAIL("Bad dictionary width {}", numBytes_);
+        }
+      });
+  memcpy(scanState_.filterCache.data(), results.data(), numValues);
+}
+
 void SelectiveIntegerDictionaryColumnReader::ensureInitialized() {
   if (LIKELY(initialized_)) {
     return;
@@ -53,15 +53,34 @@ class SelectiveIntegerDictionaryColumnReader
   template <typename ColumnVisitor>
   void readWithVisitor(RowSet rows, ColumnVisitor visitor);
 
+  void resetFilterCaches() override;
+
  private:
   void ensureInitialized();
 
+  // Fills the filter cache with the results of the filter over all the
+  // entries of the dictionary if it is small enough.
+  void loadFilterResults();
+
+  template <typename T>
+  void filterDictionary(
+      const common::Filter& filter,
+      int32_t numValues,
+      uint8_t* FOLLY_NONNULL results) const;
+
   std::unique_ptr<ByteRleDecoder> inDictionaryReader_;
   std::unique_ptr<dwio::common::IntDecoder</* isSigned = */ false>> dataReader_;
   std::unique_ptr<dwio::common::IntDecoder</* isSigned = */ true>> dictReader_;
   std::function<BufferPtr()> dictInit_;
   RleVersion rleVersion_;
   bool initialized_{false};
+
+  // Width of the dictionary entries.
+  const uint32_t numBytes_;
+  // Shares the filter results over the dictionary with the other readers of
+  // the stripe.
+  std::shared_ptr<StripeDictionaryCache> dictionaryCache_;
+  bool needFilterResults_{true};
 };
 
 template <typename ColumnVisitor>
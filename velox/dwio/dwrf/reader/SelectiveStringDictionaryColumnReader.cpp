@@ -28,7 +28,8 @@ SelectiveStringDictionaryColumnReader::SelectiveStringDictionaryColumnReader(
     common::ScanSpec& scanSpec)
     : SelectiveColumnReader(nodeType, params, scanSpec, nodeType->type),
       lastStrideIndex_(-1),
-      provider_(params.stripeStreams().getStrideIndexProvider()) {
+      provider_(params.stripeStreams().getStrideIndexProvider()),
+      dictionaryCache_(params.stripeStreams().getStripeDictionaryCache()) {
   auto& stripe = params.stripeStreams();
   EncodingKey encodingKey{nodeType_->id, params.flatMapContext().sequence};
   RleVersion rleVersion =
@@ -202,6 +203,9 @@ void SelectiveStringDictionaryColumnReader::read(
       nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
   // lazy loading dictionary data when first hit
   ensureInitialized();
+  if (needFilterResults_) {
+    loadFilterResults();
+  }
 
   if (inDictionaryReader_) {
     auto end = rows.back() + 1;
@@ -278,6 +282,36 @@ void SelectiveStringDictionaryColumnReader::getValues(
   }
 }
 
+void SelectiveStringDictionaryColumnReader::resetFilterCaches() {
+  SelectiveColumnReader::resetFilterCaches();
+  if (scanState_.dictionary.values) {
+    dictionaryCache_->clearFilterResults(scanState_.dictionary.values);
+  }
+  needFilterResults_ = true;
+}
+
+void SelectiveStringDictionaryColumnReader::loadFilterResults() {
+  needFilterResults_ = false;
+  auto* filter = scanSpec_->filter();
+  const auto numValues = scanState_.dictionary.numValues;
+  if (!StripeDictionaryCache::shouldFilterDictionary(filter, numValues)) {
+    return;
+  }
+  const auto* values = scanState_.dictionary.values->as<StringView>();
+  const auto& results = dictionaryCache_->getFilterResults(
+      scanState_.dictionary.values,
+      filter,
+      numValues,
+      [&](uint8_t* results) {
+        for (auto i = 0; i < numValues; ++i) {
+          results[i] = filter->testBytes(values[i].data(), values[i].size())
+              ? FilterResult::kSuccess
+              : FilterResult::kFailure;
+        }
+      });
+  memcpy(scanState_.filterCache.data(), results.data(), numValues);
+}
+
 void SelectiveStringDictionaryColumnReader::ensureInitialized() {
   if (LIKELY(initialized_)) {
     return;
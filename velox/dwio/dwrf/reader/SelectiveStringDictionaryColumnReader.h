@@ -57,8 +57,16 @@ class SelectiveStringDictionaryColumnReader
 
   void getValues(RowSet rows, VectorPtr* result) override;
 
+  void resetFilterCaches() override;
+
  private:
   void loadStrideDictionary();
+
+  // Fills the filter cache for the stripe dictionary with the results of
+  // the filter over all of its entries if the dictionary is small enough.
+  // The rows are then filtered by a gather of the results by index without
+  // looking at the strings.
+  void loadFilterResults();
   void makeDictionaryBaseVector();
 
   template <typename TVisitor>
@@ -98,6 +106,11 @@ class SelectiveStringDictionaryColumnReader
   std::unique_ptr<dwio::common::IntDecoder</*isSigned*/ false>> lengthDecoder_;
   std::unique_ptr<dwio::common::SeekableInputStream> blobStream_;
   bool initialized_{false};
+
+  // Shares the filter results over the stripe dictionary with the other
+  // readers of the stripe.
+  std::shared_ptr<StripeDictionaryCache> dictionaryCache_;
+  bool needFilterResults_{true};
 };
 
 template <typename TVisitor>
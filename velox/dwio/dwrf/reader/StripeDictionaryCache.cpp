@@ -16,6 +16,12 @@
 
 #include "velox/dwio/dwrf/reader/StripeDictionaryCache.h"
 
+DEFINE_int32(
+    velox_dwrf_max_dictionary_filter_size,
+    100000,
+    "Max entries of a stripe dictionary for which a filter is evaluated "
+    "over the whole dictionary when the dictionary is loaded. 0 disables.");
+
 namespace facebook::velox::dwrf {
 StripeDictionaryCache::DictionaryEntry::DictionaryEntry(
     folly::Function<BufferPtr(velox::memory::MemoryPool*)>&& dictGen)
@@ -45,4 +51,48 @@ BufferPtr StripeDictionaryCache::getIntDictionary(const EncodingKey& ek) {
   return intDictionaryFactories_.at(ek)->getDictionaryBuffer(pool_);
 }
 
+// static
+bool StripeDictionaryCache::shouldFilterDictionary(
+    const common::Filter* filter,
+    int32_t numValues) {
+  if (!filter || !filter->isDeterministic() || numValues == 0 ||
+      numValues > FLAGS_velox_dwrf_max_dictionary_filter_size) {
+    return false;
+  }
+  // Filters on nulls only do not look at the values.
+  switch (filter->kind()) {
+    case common::FilterKind::kAlwaysTrue:
+    case common::FilterKind::kAlwaysFalse:
+    case common::FilterKind::kIsNull:
+    case common::FilterKind::kIsNotNull:
+      return false;
+    default:
+      return true;
+  }
+}
+
+const std::vector<uint8_t>& StripeDictionaryCache::getFilterResults(
+    const BufferPtr& dictionary,
+    const common::Filter* filter,
+    int32_t numValues,
+    folly::FunctionRef<void(uint8_t* results)> evaluate) {
+  auto& entry = filterResults_[dictionary.get()];
+  entry.dictionary = dictionary;
+  for (auto& filterResults : entry.filters) {
+    if (filterResults.filter == filter &&
+        static_cast<int32_t>(filterResults.results.size()) == numValues) {
+      return filterResults.results;
+    }
+  }
+  auto& filterResults = entry.filters.emplace_back();
+  filterResults.filter = filter;
+  filterResults.results.resize(numValues);
+  evaluate(filterResults.results.data());
+  return filterResults.results;
+}
+
+void StripeDictionaryCache::clearFilterResults(const BufferPtr& dictionary) {
+  filterResults_.erase(dictionary.get());
+}
+
 } // namespace facebook::velox::dwrf
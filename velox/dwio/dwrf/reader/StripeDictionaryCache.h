@@ -17,12 +17,16 @@
 #pragma once
 
 #include <folly/Function.h>
+#include <gflags/gflags.h>
 
 #include "velox/common/base/GTestMacros.h"
 #include "velox/dwio/common/IntDecoder.h"
 #include "velox/dwio/dwrf/common/Common.h"
+#include "velox/type/Filter.h"
 #include "velox/vector/BaseVector.h"
 
+DECLARE_int32(velox_dwrf_max_dictionary_filter_size);
+
 namespace facebook::velox::dwrf {
 class StripeDictionaryCache {
   // This could be potentially made an interface to be shared for
@@ -49,7 +53,41 @@ class StripeDictionaryCache {
 
   BufferPtr getIntDictionary(const EncodingKey& ek);
 
+  // Returns true if 'filter' should be evaluated over all the 'numValues'
+  // entries of a stripe dictionary when the dictionary is loaded, so that
+  // the rows are filtered by looking up the results by dictionary index.
+  static bool shouldFilterDictionary(
+      const common::Filter* FOLLY_NULLABLE filter,
+      int32_t numValues);
+
+  // Returns the results of 'filter' for each of the 'numValues' entries of
+  // 'dictionary'. 'evaluate' fills the results on first use for
+  // 'dictionary' and 'filter'. Readers of the same dictionary with the same
+  // filter share the results, e.g. the readers of flat map values sharing
+  // the dictionary of the map. The reference is valid until the next call.
+  const std::vector<uint8_t>& getFilterResults(
+      const BufferPtr& dictionary,
+      const common::Filter* FOLLY_NONNULL filter,
+      int32_t numValues,
+      folly::FunctionRef<void(uint8_t* FOLLY_NONNULL results)> evaluate);
+
+  // Drops the filter results for 'dictionary', e.g. after its filter
+  // changed.
+  void clearFilterResults(const BufferPtr& dictionary);
+
  private:
+  struct FilterResults {
+    const common::Filter* FOLLY_NONNULL filter;
+    std::vector<uint8_t> results;
+  };
+
+  struct DictionaryFilterResults {
+    // Keeps the dictionary alive so that its address is not reused for
+    // another dictionary.
+    BufferPtr dictionary;
+    std::vector<FilterResults> filters;
+  };
+
   // This is typically the reader's memory pool.
   memory::MemoryPool* pool_;
   std::unordered_map<
@@ -57,6 +95,7 @@ class StripeDictionaryCache {
       std::unique_ptr<DictionaryEntry>,
       EncodingKeyHash>
       intDictionaryFactories_;
+  std::unordered_map<const Buffer*, DictionaryFilterResults> filterResults_;
 
   VELOX_FRIEND_TEST(TestStripeDictionaryCache, RegisterDictionary);
 };
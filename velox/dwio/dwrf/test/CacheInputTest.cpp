@@ -514,6 +514,94 @@ TEST_F(CacheTest, window) {
   EXPECT_FALSE(clone->Next(&buffer, &size));
 }
 
+TEST_F(CacheTest, loadedOrFuture) {
+  constexpr int32_t kMB = 1 << 20;
+  initializeCache(64 * kMB);
+  auto tracker = std::make_shared<ScanTracker>(
+      "testTracker",
+      nullptr,
+      dwio::common::ReaderOptions::kDefaultLoadQuantum,
+      groupStats_);
+  uint64_t fileId;
+  uint64_t groupId;
+  std::shared_ptr<InputStream> file =
+      inputByPath("test_for_loaded_or_future", fileId, groupId);
+  auto input = std::make_unique<CachedBufferedInput>(
+      *file,
+      *pool_,
+      fileId,
+      cache_.get(),
+      tracker,
+      groupId,
+      [file]() { return std::make_unique<TestInputStreamHolder>(file); },
+      ioStats_,
+      executor_.get(),
+      dwio::common::ReaderOptions::kDefaultLoadQuantum,
+      512 << 10);
+  std::vector<std::unique_ptr<SeekableInputStream>> streams;
+  for (auto i = 0; i < 4; ++i) {
+    streams.push_back(
+        input->enqueue({static_cast<uint64_t>(i) * kMB, 100'000}));
+  }
+  input->load(LogType::TEST);
+
+  // The loads run on 'executor_' and the caller waits for them instead of
+  // reading.
+  auto future = folly::SemiFuture<bool>::makeEmpty();
+  while (!input->loadedOrFuture(&future)) {
+    std::move(future).wait();
+  }
+  for (auto& stream : streams) {
+    const void* buffer;
+    int32_t size;
+    int32_t numRead = 0;
+    while (stream->Next(&buffer, &size)) {
+      numRead += size;
+    }
+    EXPECT_EQ(100'000, numRead);
+  }
+  // Nothing is pending after the streams are read.
+  EXPECT_TRUE(input->loadedOrFuture(&future));
+}
+
+TEST_F(CacheTest, readAheadReferences) {
+  initializeCache(64 << 20);
+  auto tracker = std::make_shared<ScanTracker>(
+      "testTracker",
+      nullptr,
+      dwio::common::ReaderOptions::kDefaultLoadQuantum,
+      groupStats_);
+  uint64_t fileId;
+  uint64_t groupId;
+  std::shared_ptr<InputStream> file =
+      inputByPath("test_for_read_ahead", fileId, groupId);
+  auto makeInput = [&]() {
+    return std::make_unique<CachedBufferedInput>(
+        *file,
+        *pool_,
+        fileId,
+        cache_.get(),
+        tracker,
+        groupId,
+        [file]() { return std::make_unique<TestInputStreamHolder>(file); },
+        ioStats_,
+        executor_.get(),
+        dwio::common::ReaderOptions::kDefaultLoadQuantum,
+        512 << 10);
+  };
+  const TrackingId id(streamIds_[0]->getId());
+
+  // A read-ahead of the reader does not count as a reference.
+  auto readAhead = makeInput();
+  readAhead->setTrackReferences(false);
+  auto readAheadStream = readAhead->enqueue({0, 100'000}, streamIds_[0].get());
+  EXPECT_EQ(0, tracker->trackingData(id).numReferences);
+
+  auto input = makeInput();
+  auto stream = input->enqueue({0, 100'000}, streamIds_[0].get());
+  EXPECT_EQ(1, tracker->trackingData(id).numReferences);
+}
+
 TEST_F(CacheTest, bufferedInput) {
   // Size 160 MB. Frequent evictions and not everything fits in prefetch window.
   initializeCache(160 << 20);
@@ -4127,6 +4127,64 @@ TEST(ColumnWriterTests, ShortDictWriterDictValueOverflow) {
   }
 }
 
+TEST(ColumnWriterTests, earlyDictionaryDecision) {
+  auto scopedPool = getDefaultScopedMemoryPool();
+  auto& pool = scopedPool->getPool();
+  constexpr size_t size = 1'000;
+  std::vector<std::optional<int64_t>> distinctInts;
+  std::vector<std::optional<int64_t>> repeatedInts;
+  std::vector<std::string> strings;
+  std::vector<std::optional<StringView>> distinctStrings;
+  std::vector<std::optional<StringView>> repeatedStrings;
+  for (auto i = 0; i < size; ++i) {
+    distinctInts.push_back(i * 7);
+    repeatedInts.push_back(i % 10);
+    strings.push_back(fmt::format("s{}", i));
+  }
+  for (auto i = 0; i < size; ++i) {
+    distinctStrings.push_back(StringView(strings[i]));
+    repeatedStrings.push_back(StringView(strings[i % 10]));
+  }
+
+  // Returns the encoding of the stripe with 'vector' and whether the
+  // dictionary was still there to abandon after the write.
+  auto test = [&](const VectorPtr& vector, uint32_t earlyDecisionRows) {
+    auto config = std::make_shared<Config>();
+    config->set(Config::DICTIONARY_EARLY_DECISION_ROWS, earlyDecisionRows);
+    WriterContext context{config, getDefaultScopedMemoryPool()};
+    auto typeWithId = TypeWithId::create(vector->type(), 1);
+    auto writer = BaseColumnWriter::create(context, *typeWithId, 0);
+    writer->write(vector, Ranges::of(0, size));
+    auto abandoned = writer->tryAbandonDictionaries(false);
+    writer->createIndexEntry();
+    proto::StripeFooter sf;
+    writer->flush([&sf](auto /* unused */) -> proto::ColumnEncoding& {
+      return *sf.add_encoding();
+    });
+    return std::make_pair(sf.encoding(0).kind(), abandoned);
+  };
+
+  for (const auto& vector :
+       {populateBatch<int64_t>(distinctInts, &pool),
+        populateBatch<StringView>(distinctStrings, &pool)}) {
+    // The dictionary is built until the writer asks to abandon it.
+    EXPECT_EQ(
+        std::make_pair(proto::ColumnEncoding_Kind_DIRECT, true),
+        test(vector, 0));
+    // The dictionary is abandoned during the write.
+    EXPECT_EQ(
+        std::make_pair(proto::ColumnEncoding_Kind_DIRECT, false),
+        test(vector, size));
+  }
+  for (const auto& vector :
+       {populateBatch<int64_t>(repeatedInts, &pool),
+        populateBatch<StringView>(repeatedStrings, &pool)}) {
+    EXPECT_EQ(
+        std::make_pair(proto::ColumnEncoding_Kind_DICTIONARY, false),
+        test(vector, size));
+  }
+}
+
 TEST(ColumnWriterTests, RemovePresentStream) {
   auto config = std::make_shared<Config>();
   auto scopedPool = getDefaultScopedMemoryPool();
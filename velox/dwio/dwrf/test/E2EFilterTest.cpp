@@ -37,6 +37,7 @@ class E2EFilterTest : public E2EFilterTestBase {
     auto config = std::make_shared<dwrf::Config>();
     config->set(dwrf::Config::COMPRESSION, CompressionKind_NONE);
     config->set(dwrf::Config::USE_VINTS, useVInts_);
+    config->set(dwrf::Config::BLOOM_FILTER_COLS, bloomFilterColumns_);
     WriterOptions options;
     options.config = config;
     options.schema = type;
@@ -65,6 +66,8 @@ class E2EFilterTest : public E2EFilterTestBase {
   }
 
   std::unique_ptr<Writer> writer_;
+  // Top level columns written with bloom filters.
+  std::vector<uint32_t> bloomFilterColumns_;
 };
 
 TEST_F(E2EFilterTest, integerDirect) {
@@ -181,6 +184,31 @@ TEST_F(E2EFilterTest, stringDictionary) {
       true);
 }
 
+TEST_F(E2EFilterTest, bloomFilter) {
+  // All columns are inside the struct at column 0.
+  bloomFilterColumns_ = {0};
+  testWithTypes(
+      "long_val:bigint,"
+      "int_val:int,"
+      "string_val:string",
+      [&]() {
+        makeIntDistribution<int64_t>(
+            Subfield("long_val"),
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            10000000000, // rareMax
+            true); // keepNulls
+        makeStringDistribution(Subfield("string_val"), 100, true, false);
+      },
+      true,
+      {"long_val", "int_val", "string_val"},
+      20,
+      true);
+}
+
 TEST_F(E2EFilterTest, timestamp) {
   testWithTypes(
       "timestamp_val:timestamp,"
@@ -15,6 +15,7 @@
  */
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <random>
 #include "velox/dwio/common/MemoryInputStream.h"
 #include "velox/dwio/common/Options.h"
@@ -635,6 +636,122 @@ TEST(E2EWriterTests, PartialStride) {
   ASSERT_EQ(true, reader->columnStatistics(1)->hasNull().value());
 }
 
+TEST(E2EWriterTests, parallelEncoding) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  auto& pool = *scopedPool;
+
+  HiveTypeParser parser;
+  auto type = parser.parse(
+      "struct<"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string,"
+      "array_val:array<float>,"
+      "map_val:map<bigint,double>," /* this is column 5 */
+      "struct_val:struct<a:float,b:string>"
+      ">");
+  auto config = std::make_shared<Config>();
+  config->set(Config::ROW_INDEX_STRIDE, static_cast<uint32_t>(1000));
+  config->set(Config::FLATTEN_MAP, true);
+  config->set(Config::MAP_FLAT_COLS, {5});
+
+  std::vector<VectorPtr> batches;
+  for (auto i = 0; i < 10; ++i) {
+    batches.push_back(BatchMaker::createBatch(type, 1'500, pool, nullptr, i));
+  }
+
+  auto write = [&](const std::shared_ptr<folly::Executor>& executor) {
+    auto sink = std::make_unique<MemorySink>(pool, 20 * kSizeMB);
+    auto sinkPtr = sink.get();
+    WriterOptions options;
+    options.config = config;
+    options.schema = type;
+    options.encodingExecutor = executor;
+    options.flushPolicyFactory =
+        E2EWriterTestUtil::simpleFlushPolicyFactory(false);
+    Writer writer{options, std::move(sink), pool};
+    for (auto& batch : batches) {
+      writer.write(batch);
+    }
+    writer.close();
+    return std::string(sinkPtr->getData(), sinkPtr->size());
+  };
+
+  // Columns are encoded in parallel but the streams are laid out in the
+  // same order as with serial encoding, so the files are identical.
+  auto serial = write(nullptr);
+  auto parallel = write(std::make_shared<folly::CPUThreadPoolExecutor>(4));
+  ASSERT_EQ(serial, parallel);
+
+  auto input = std::make_unique<MemoryInputStream>(
+      parallel.data(), parallel.size());
+  ReaderOptions readerOpts;
+  RowReaderOptions rowReaderOpts;
+  auto reader = std::make_unique<DwrfReader>(readerOpts, std::move(input));
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+  VectorPtr result;
+  for (auto& batch : batches) {
+    ASSERT_TRUE(rowReader->next(batch->size(), result));
+    for (auto i = 0; i < batch->size(); ++i) {
+      ASSERT_TRUE(batch->equalValueAt(result.get(), i, i)) << "at " << i;
+    }
+  }
+  ASSERT_FALSE(rowReader->next(1, result));
+}
+
+TEST(E2EWriterTests, reclaim) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  auto& pool = *scopedPool;
+
+  HiveTypeParser parser;
+  auto type = parser.parse("struct<long_val:bigint,string_val:string>");
+  auto config = std::make_shared<Config>();
+  auto sink = std::make_unique<MemorySink>(pool, 20 * kSizeMB);
+  auto sinkPtr = sink.get();
+
+  WriterOptions options;
+  options.config = config;
+  options.schema = type;
+  options.flushPolicyFactory =
+      E2EWriterTestUtil::simpleFlushPolicyFactory(false);
+  Writer writer{options, std::move(sink), pool};
+  EXPECT_EQ(0, writer.reclaimableBytes());
+  // Nothing to flush.
+  writer.reclaim();
+  EXPECT_EQ(0, writer.forcedFlushStats().reclaim);
+
+  std::vector<VectorPtr> batches;
+  for (auto i = 0; i < 4; ++i) {
+    batches.push_back(BatchMaker::createBatch(type, 1'000, pool, nullptr, i));
+    writer.write(batches.back());
+    if (i % 2 == 1) {
+      EXPECT_LT(0, writer.reclaimableBytes());
+      writer.reclaim();
+      EXPECT_EQ(0, writer.reclaimableBytes());
+    }
+  }
+  writer.close();
+  EXPECT_EQ(2, writer.forcedFlushStats().reclaim);
+  EXPECT_EQ(0, writer.forcedFlushStats().memoryBudget);
+
+  auto input =
+      std::make_unique<MemoryInputStream>(sinkPtr->getData(), sinkPtr->size());
+  ReaderOptions readerOpts;
+  RowReaderOptions rowReaderOpts;
+  auto reader = std::make_unique<DwrfReader>(readerOpts, std::move(input));
+  EXPECT_EQ(2, reader->getNumberOfStripes());
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+  VectorPtr result;
+  for (auto& batch : batches) {
+    ASSERT_TRUE(rowReader->next(batch->size(), result));
+    ASSERT_EQ(batch->size(), result->size());
+    for (auto i = 0; i < batch->size(); ++i) {
+      ASSERT_TRUE(batch->equalValueAt(result.get(), i, i)) << "at " << i;
+    }
+  }
+}
+
 TEST(E2EWriterTests, OversizeRows) {
   auto scopedPool = facebook::velox::memory::getDefaultScopedMemoryPool();
   auto& pool = scopedPool->getPool();
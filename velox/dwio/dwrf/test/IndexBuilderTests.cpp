@@ -17,6 +17,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/dwrf/reader/DwrfData.h"
 #include "velox/dwio/dwrf/writer/IndexBuilder.h"
 
 using namespace testing;
@@ -147,4 +149,69 @@ TEST_F(IndexBuilderTest, RemovePresentStreamPositions) {
   }
 }
 
+TEST_F(IndexBuilderTest, BloomFilter) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  auto& pool = scopedPool->getPool();
+  dwio::common::MemorySink indexSink{pool, 1024};
+  dwio::common::MemorySink bloomFilterSink{pool, 1024};
+  DataBufferHolder indexHolder{
+      pool, 1024, 0, DEFAULT_PAGE_GROW_RATIO, &indexSink};
+  DataBufferHolder bloomFilterHolder{
+      pool, 1024, 0, DEFAULT_PAGE_GROW_RATIO, &bloomFilterSink};
+  IndexBuilder builder{std::make_unique<BufferedOutputStream>(indexHolder)};
+  builder.setBloomFilterStream(
+      std::make_unique<BufferedOutputStream>(bloomFilterHolder));
+
+  // The first entry has the even numbers below 2000, the second the strings
+  // of the odd ones.
+  IntegerStatisticsBuilder sb{options_};
+  sb.setBloomFilter(std::make_unique<BloomFilter>(1000, 0.05));
+  for (auto i = 0; i < 2000; i += 2) {
+    sb.addValues(i);
+  }
+  builder.addEntry(sb);
+  StringStatisticsBuilder stringSb{options_};
+  stringSb.setBloomFilter(std::make_unique<BloomFilter>(1000, 0.05));
+  for (auto i = 1; i < 2000; i += 2) {
+    stringSb.addValues(folly::to<std::string>(i));
+  }
+  builder.addEntry(stringSb);
+  builder.flush();
+
+  proto::BloomFilterIndex index;
+  ASSERT_TRUE(
+      index.ParseFromArray(bloomFilterSink.getData(), bloomFilterSink.size()));
+  ASSERT_EQ(2, index.bloomfilter_size());
+  BloomFilter evens{index.bloomfilter(0)};
+  BloomFilter odds{index.bloomfilter(1)};
+  int32_t numFalsePositives = 0;
+  for (auto i = 0; i < 2000; i += 2) {
+    EXPECT_TRUE(evens.testLong(i));
+    EXPECT_TRUE(odds.testBytes(folly::to<std::string>(i + 1)));
+    numFalsePositives += evens.testLong(i + 1);
+  }
+  EXPECT_LT(numFalsePositives, 100);
+
+  // Only filters for a few discrete values look at the bloom filter.
+  common::BigintRange range{10, 20, false};
+  common::BigintRange singleValue{11, 11, false};
+  EXPECT_FALSE(DwrfData::canUseBloomFilter(&range));
+  EXPECT_TRUE(DwrfData::canUseBloomFilter(&singleValue));
+  EXPECT_TRUE(DwrfData::testBloomFilter(range, evens));
+  EXPECT_TRUE(
+      DwrfData::testBloomFilter(common::BigintRange{12, 12, false}, evens));
+  std::vector<std::string> values{"1", "3", "1999"};
+  common::BytesValues bytesValues{values, false};
+  EXPECT_TRUE(DwrfData::canUseBloomFilter(&bytesValues));
+  EXPECT_TRUE(DwrfData::testBloomFilter(bytesValues, odds));
+  int32_t numPassed = 0;
+  for (auto i = 0; i < 2000; i += 2) {
+    numPassed += DwrfData::testBloomFilter(
+        common::BytesValues{
+            std::vector<std::string>{folly::to<std::string>(i)}, false},
+        odds);
+  }
+  EXPECT_LT(numPassed, 100);
+}
+
 } // namespace facebook::velox::dwrf
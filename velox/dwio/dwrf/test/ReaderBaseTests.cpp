@@ -209,3 +209,41 @@ TEST(ReaderBaseTest, InvalidPostScriptThrows) {
   EXPECT_THROW(
       { createCorruptedFileReader(0, 1'000'000); }, exception::LoggedException);
 }
+
+TEST(FileTailCacheTest, findAndEvict) {
+  auto makeTail = [](uint64_t fileLength, int64_t bytes) {
+    auto tail = std::make_shared<FileTail>();
+    tail->fileLength = fileLength;
+    tail->bytes = bytes;
+    return tail;
+  };
+  FileTailCache cache(1000);
+  cache.insert(1, makeTail(100, 400));
+  cache.insert(2, makeTail(200, 400));
+  auto tail = cache.find(1, 100);
+  ASSERT_NE(nullptr, tail);
+  EXPECT_EQ(100, tail->fileLength);
+  // A different length is a different version of the file.
+  EXPECT_EQ(nullptr, cache.find(1, 101));
+
+  // The oldest tail is evicted to make room.
+  cache.insert(3, makeTail(300, 400));
+  EXPECT_EQ(nullptr, cache.find(1, 100));
+  EXPECT_NE(nullptr, cache.find(2, 200));
+  EXPECT_NE(nullptr, cache.find(3, 300));
+  // An evicted tail stays valid for its readers.
+  EXPECT_EQ(100, tail->fileLength);
+
+  // A tail larger than the cache is not added.
+  cache.insert(4, makeTail(400, 2000));
+  EXPECT_EQ(nullptr, cache.find(4, 400));
+
+  auto stats = cache.stats();
+  EXPECT_EQ(3, stats.numHits);
+  EXPECT_EQ(3, stats.numMisses);
+  EXPECT_EQ(800, stats.bytes);
+
+  cache.clear();
+  EXPECT_EQ(nullptr, cache.find(2, 200));
+  EXPECT_EQ(0, cache.stats().bytes);
+}
@@ -18,11 +18,13 @@
 #include <gtest/gtest.h>
 #include <velox/buffer/Buffer.h>
 #include "folly/Random.h"
+#include "folly/executors/CPUThreadPoolExecutor.h"
 #include "folly/lang/Assume.h"
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/dwio/common/DataSink.h"
 #include "velox/dwio/common/MemoryInputStream.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
+#include "velox/dwio/common/tests/utils/FilterGenerator.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
 #include "velox/dwio/dwrf/test/OrcTest.h"
@@ -444,6 +446,122 @@ TEST(TestReader, testReadFlatMapWithKeyRejectList) {
   } while (true);
 }
 
+TEST(TestReader, testSelectiveFlatMap) {
+  const std::string fmSmall(getExampleFilePath("fm_small.orc"));
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  std::shared_ptr<const RowType> rowType =
+      std::dynamic_pointer_cast<const RowType>(HiveTypeParser().parse("struct<\
+          id:int,\
+      map1:map<int, array<float>>,\
+      map2:map<string, map<smallint,bigint>>,\
+      map3:map<int,int>,\
+      map4:map<int,struct<field1:int,field2:float,field3:string>>,\
+      memo:string>"));
+  ReaderOptions readerOpts;
+  auto reader = DwrfReader::create(
+      std::make_unique<FileInputStream>(fmSmall), readerOpts);
+  RowReaderOptions rowReaderOpts;
+  rowReaderOpts.select(std::make_shared<ColumnSelector>(rowType));
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+  // The spec must stay live over the lifetime of the reader.
+  auto spec = FilterGenerator(rowType).makeScanSpec(SubfieldFilters{});
+  rowReaderOpts.setScanSpec(spec);
+  auto selectiveRowReader = reader->createRowReader(rowReaderOpts);
+
+  VectorPtr expected;
+  auto batch = BaseVector::create(rowType, 0, scopedPool.get());
+  int64_t numRows = 0;
+  while (rowReader->next(100, expected)) {
+    ASSERT_TRUE(selectiveRowReader->next(100, batch));
+    ASSERT_EQ(expected->size(), batch->size());
+    for (auto i = 0; i < batch->size(); ++i) {
+      ASSERT_TRUE(expected->equalValueAt(batch.get(), i, i)) << i;
+    }
+    numRows += batch->size();
+  }
+  EXPECT_LT(0, numRows);
+  EXPECT_FALSE(selectiveRowReader->next(100, batch));
+}
+
+TEST(TestReader, testSelectiveFlatMapWithKeyFilter) {
+  const std::string fmSmall(getExampleFilePath("fm_small.orc"));
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  std::shared_ptr<const RowType> rowType =
+      std::dynamic_pointer_cast<const RowType>(HiveTypeParser().parse(
+          "struct<map2:map<string, map<smallint,bigint>>>"));
+  ReaderOptions readerOpts;
+  auto reader = DwrfReader::create(
+      std::make_unique<FileInputStream>(fmSmall), readerOpts);
+  RowReaderOptions rowReaderOpts;
+  rowReaderOpts.select(std::make_shared<ColumnSelector>(
+      reader->getSchema(), std::vector<std::string>{"map2#[\"key-1\"]"}));
+  auto spec = FilterGenerator(rowType).makeScanSpec(SubfieldFilters{});
+  rowReaderOpts.setScanSpec(spec);
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+
+  auto batch = BaseVector::create(rowType, 0, scopedPool.get());
+  int64_t numKeys = 0;
+  while (rowReader->next(1000, batch)) {
+    auto map2 = batch->as<RowVector>()->childAt(0)->as<MapVector>();
+    auto keys = map2->mapKeys()->as<SimpleVector<StringView>>();
+    for (auto i = 0; i < map2->size(); ++i) {
+      // "key-1" is in every map.
+      ASSERT_EQ(1, map2->sizeAt(i));
+      EXPECT_EQ("key-1", keys->valueAt(map2->offsetAt(i)).str());
+    }
+    numKeys += keys->size();
+  }
+  EXPECT_LT(0, numKeys);
+}
+
+TEST(TestReader, testParallelDecoding) {
+  const std::string fmSmall(getExampleFilePath("fm_small.orc"));
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  std::shared_ptr<const RowType> rowType =
+      std::dynamic_pointer_cast<const RowType>(HiveTypeParser().parse(
+          "struct<id:int,map1:map<int, array<float>>,"
+          "map2:map<string, map<smallint,bigint>>,map3:map<int,int>,"
+          "map4:map<int,struct<field1:int,field2:float,field3:string>>,"
+          "memo:string>"));
+  ReaderOptions readerOpts;
+  auto reader = DwrfReader::create(
+      std::make_unique<FileInputStream>(fmSmall), readerOpts);
+  // The filter on 'memo' is read first, the other columns in parallel once
+  // they are read eagerly.
+  auto makeSpec = [&]() {
+    SubfieldFilters filters;
+    filters[Subfield("memo")] =
+        std::make_unique<facebook::velox::common::IsNotNull>();
+    return FilterGenerator(rowType).makeScanSpec(std::move(filters));
+  };
+  auto serialSpec = makeSpec();
+  auto parallelSpec = makeSpec();
+  RowReaderOptions serialOpts;
+  serialOpts.select(std::make_shared<ColumnSelector>(rowType));
+  serialOpts.setScanSpec(serialSpec);
+  RowReaderOptions parallelOpts;
+  parallelOpts.select(std::make_shared<ColumnSelector>(rowType));
+  parallelOpts.setScanSpec(parallelSpec);
+  parallelOpts.setDecodingExecutor(
+      std::make_shared<folly::CPUThreadPoolExecutor>(4));
+  auto serialReader = reader->createRowReader(serialOpts);
+  auto parallelReader = reader->createRowReader(parallelOpts);
+
+  auto expected = BaseVector::create(rowType, 0, scopedPool.get());
+  auto batch = BaseVector::create(rowType, 0, scopedPool.get());
+  int64_t numRows = 0;
+  while (serialReader->next(10, expected)) {
+    ASSERT_TRUE(parallelReader->next(10, batch));
+    ASSERT_EQ(expected->size(), batch->size());
+    for (auto i = 0; i < batch->size(); ++i) {
+      ASSERT_TRUE(expected->equalValueAt(batch.get(), i, i)) << i;
+    }
+    numRows += batch->size();
+  }
+  EXPECT_LT(0, numRows);
+  EXPECT_FALSE(parallelReader->next(10, batch));
+}
+
 namespace {
 
 std::vector<std::string> stringify(const std::vector<int32_t>& values) {
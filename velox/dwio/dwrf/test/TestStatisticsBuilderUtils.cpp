@@ -146,6 +146,51 @@ TEST(TestStatisticsBuilderUtils, addDoubleValues) {
   }
 }
 
+template <typename Builder, typename T>
+void expectBatchEqualsValues(const std::vector<T>& values) {
+  Builder byValue{options};
+  Builder byBatch{options};
+  for (auto value : values) {
+    byValue.addValues(value);
+  }
+  // Adds in uneven batches to cover the SIMD tails.
+  for (size_t begin = 0; begin < values.size(); begin += 37) {
+    byBatch.addBatch(
+        values.data() + begin, std::min<size_t>(37, values.size() - begin));
+  }
+  auto expected = byValue.build();
+  auto actual = byBatch.build();
+  EXPECT_EQ(expected->toString(), actual->toString());
+}
+
+TEST(TestStatisticsBuilderUtils, addBatch) {
+  std::vector<int16_t> shorts;
+  std::vector<int64_t> longs;
+  std::vector<double> doubles;
+  for (auto i = 0; i < 1'000; ++i) {
+    shorts.push_back((i * 7'919) % 65'536 - 32'768);
+    longs.push_back(i * 1'000'000'007LL * (i % 2 ? 1 : -1));
+    doubles.push_back(i * 0.37 - 100);
+  }
+  expectBatchEqualsValues<IntegerStatisticsBuilder>(shorts);
+  expectBatchEqualsValues<IntegerStatisticsBuilder>(longs);
+  expectBatchEqualsValues<DoubleStatisticsBuilder>(doubles);
+
+  // The sum overflows.
+  longs.push_back(std::numeric_limits<int64_t>::max());
+  longs.push_back(std::numeric_limits<int64_t>::max());
+  expectBatchEqualsValues<IntegerStatisticsBuilder>(longs);
+
+  // Infinities of both signs make the sum NaN but keep min and max.
+  doubles.push_back(std::numeric_limits<double>::infinity());
+  doubles.push_back(-std::numeric_limits<double>::infinity());
+  expectBatchEqualsValues<DoubleStatisticsBuilder>(doubles);
+
+  // A NaN clears min, max and sum.
+  doubles.insert(doubles.begin() + 500, std::nan(""));
+  expectBatchEqualsValues<DoubleStatisticsBuilder>(doubles);
+}
+
 TEST(TestStatisticsBuilderUtils, addStringValues) {
   StringStatisticsBuilder builder{options};
 
@@ -125,4 +125,62 @@ TEST(TestStripeDictionaryCache, GetDictionaryBuffer) {
     EXPECT_ANY_THROW(cache.getIntDictionary({2, 0}));
   }
 }
+
+TEST(TestStripeDictionaryCache, FilterResults) {
+  auto& pool = memory::getProcessDefaultMemoryManager().getRoot();
+  StripeDictionaryCache cache{&pool};
+  cache.registerIntDictionary({9, 0}, genConsecutiveRangeBuffer(0, 100));
+  auto dictionary = cache.getIntDictionary({9, 0});
+  common::BigintRange filter(10, 19, false);
+  common::BigintRange otherFilter(0, 4, false);
+
+  int32_t numEvaluations = 0;
+  auto evaluate = [&](const common::Filter& filter) {
+    return [&](uint8_t* results) {
+      ++numEvaluations;
+      auto values = dictionary->as<int64_t>();
+      for (auto i = 0; i < 100; ++i) {
+        results[i] = filter.testInt64(values[i]);
+      }
+    };
+  };
+  auto expectResults = [&](const std::vector<uint8_t>& results,
+                           int64_t begin,
+                           int64_t end) {
+    ASSERT_EQ(100, results.size());
+    for (auto i = 0; i < 100; ++i) {
+      EXPECT_EQ(i >= begin && i <= end, results[i]) << i;
+    }
+  };
+
+  expectResults(
+      cache.getFilterResults(dictionary, &filter, 100, evaluate(filter)),
+      10,
+      19);
+  // Another reader of the dictionary with the same filter shares the
+  // results.
+  expectResults(
+      cache.getFilterResults(dictionary, &filter, 100, evaluate(filter)),
+      10,
+      19);
+  EXPECT_EQ(1, numEvaluations);
+  expectResults(
+      cache.getFilterResults(
+          dictionary, &otherFilter, 100, evaluate(otherFilter)),
+      0,
+      4);
+  EXPECT_EQ(2, numEvaluations);
+
+  cache.clearFilterResults(dictionary);
+  cache.getFilterResults(dictionary, &filter, 100, evaluate(filter));
+  EXPECT_EQ(3, numEvaluations);
+
+  EXPECT_TRUE(StripeDictionaryCache::shouldFilterDictionary(&filter, 100));
+  EXPECT_FALSE(StripeDictionaryCache::shouldFilterDictionary(&filter, 0));
+  EXPECT_FALSE(StripeDictionaryCache::shouldFilterDictionary(
+      &filter, FLAGS_velox_dwrf_max_dictionary_filter_size + 1));
+  EXPECT_FALSE(StripeDictionaryCache::shouldFilterDictionary(nullptr, 100));
+  common::IsNotNull isNotNull;
+  EXPECT_FALSE(StripeDictionaryCache::shouldFilterDictionary(&isNotNull, 100));
+}
 } // namespace facebook::velox::dwrf
@@ -15,7 +15,9 @@
  */
 
 #include "velox/dwio/dwrf/writer/ColumnWriter.h"
+#include <folly/futures/Future.h>
 #include <velox/dwio/common/exception/Exception.h>
+#include <numeric>
 #include "velox/dwio/common/ChainedBuffer.h"
 #include "velox/dwio/dwrf/common/EncoderUtil.h"
 #include "velox/dwio/dwrf/writer/DictionaryEncodingUtils.h"
@@ -35,16 +37,24 @@ namespace facebook::velox::dwrf {
 WriterContext::LocalDecodedVector BaseColumnWriter::decode(
     const VectorPtr& slice,
     const Ranges& ranges) {
-  auto& selected = context_.getSharedSelectivityVector(slice->size());
-  // initialize
-  selected.clearAll();
-  for (auto& range : ranges.getRanges()) {
-    selected.setValidRange(std::get<0>(range), std::get<1>(range), true);
-  }
-  selected.updateBounds();
-  // decode
   auto localDecoded = context_.getLocalDecodedVector();
-  localDecoded.get().decode(*slice, selected);
+  auto decodeRanges = [&](SelectivityVector& selected) {
+    // initialize
+    selected.clearAll();
+    for (auto& range : ranges.getRanges()) {
+      selected.setValidRange(std::get<0>(range), std::get<1>(range), true);
+    }
+    selected.updateBounds();
+    // decode
+    localDecoded.get().decode(*slice, selected);
+  };
+  if (context_.encodingExecutor()) {
+    // Columns may be decoded on several threads.
+    SelectivityVector selected(slice->size());
+    decodeRanges(selected);
+  } else {
+    decodeRanges(context_.getSharedSelectivityVector(slice->size()));
+  }
   return localDecoded;
 }
 
@@ -476,7 +486,11 @@ uint64_t IntegerColumnWriter<T>::write(
     // Decode and then write
     auto localDecoded = decode(slice, ranges);
     auto& decodedVector = localDecoded.get();
-    return writeDict(decodedVector, ranges);
+    auto rawSize = writeDict(decodedVector, ranges);
+    if (firstStripe_ && shouldDecideDictionaryEarly(rows_.size())) {
+      tryAbandonDictionaries(false);
+    }
+    return rawSize;
   } else {
     // If the input is not a flat vector we make a complete copy and convert
     // it to flat vector
@@ -1087,7 +1101,11 @@ uint64_t StringColumnWriter::write(
   auto& decodedVector = localDecoded.get();
 
   if (useDictionaryEncoding_) {
-    return writeDict(decodedVector, ranges);
+    auto rawSize = writeDict(decodedVector, ranges);
+    if (firstStripe_ && shouldDecideDictionaryEarly(rows_.size())) {
+      tryAbandonDictionaries(false);
+    }
+    return rawSize;
   } else {
     return writeDirect(decodedVector, ranges);
   }
@@ -1379,24 +1397,24 @@ uint64_t FloatColumnWriter<T>::write(
             data_.write(reinterpret_cast<const char*>(buf), size * sizeof(T));
           });
 
-      auto processRow = [&](size_t pos) {
-        auto val = data[pos];
-        writer.add(val);
-        statsBuilder.addValues(val);
-      };
-
-      for (auto& pos : ranges) {
-        if (bits::isBitNull(nulls, pos)) {
-          ++nullCount;
-        } else {
-          processRow(pos);
-        }
-      }
+      nullCount = StatisticsBuilderUtils::forEachNonNull(
+          statsBuilder,
+          nulls,
+          ranges,
+          [&](size_t begin, size_t end) {
+            for (auto pos = begin; pos < end; ++pos) {
+              writer.add(data[pos]);
+            }
+            statsBuilder.addBatch(data + begin, end - begin);
+          },
+          [&](vector_size_t pos) {
+            auto val = data[pos];
+            writer.add(val);
+            statsBuilder.addValues(val);
+          });
     } else {
-      for (auto& pos : ranges) {
-        statsBuilder.addValues(data[pos]);
-      }
       for (const auto& [start, end] : ranges.getRanges()) {
+        statsBuilder.addBatch(data + start, end - start);
         const char* srcPtr = reinterpret_cast<const char*>(data + start);
         size_t sz = end - start;
         data_.write(srcPtr, sz * sizeof(T));
@@ -1591,6 +1609,15 @@ class StructColumnWriter : public BaseColumnWriter {
       const RowVector* rowSlice,
       const Ranges& ranges,
       uint64_t nullCount);
+
+  // Writes the top level columns on the encoding executor of the context.
+  uint64_t writeChildrenInParallel(
+      const RowVector* rowSlice,
+      const Ranges& ranges);
+
+  // True for the top level columns that must be written on the calling
+  // thread. Filled on first parallel write.
+  std::vector<bool> serialChildren_;
 };
 
 uint64_t StructColumnWriter::writeChildrenAndStats(
@@ -1599,8 +1626,12 @@ uint64_t StructColumnWriter::writeChildrenAndStats(
     uint64_t nullCount) {
   uint64_t rawSize = 0;
   if (ranges.size() > 0) {
-    for (size_t i = 0; i < children_.size(); ++i) {
-      rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
+    if (isRoot() && context_.encodingExecutor() && children_.size() > 1) {
+      rawSize = writeChildrenInParallel(rowSlice, ranges);
+    } else {
+      for (size_t i = 0; i < children_.size(); ++i) {
+        rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
+      }
     }
   }
   if (nullCount) {
@@ -1612,6 +1643,53 @@ uint64_t StructColumnWriter::writeChildrenAndStats(
   return rawSize;
 }
 
+uint64_t StructColumnWriter::writeChildrenInParallel(
+    const RowVector* rowSlice,
+    const Ranges& ranges) {
+  if (serialChildren_.empty()) {
+    // Flat map writers add streams and dictionary encoders to the context
+    // while writing, so they stay on the calling thread.
+    serialChildren_.resize(children_.size(), false);
+    if (getConfig(Config::FLATTEN_MAP)) {
+      for (auto column : getConfig(Config::MAP_FLAT_COLS)) {
+        if (column < serialChildren_.size()) {
+          serialChildren_[column] = true;
+        }
+      }
+    }
+  }
+  std::vector<uint64_t> rawSizes(children_.size());
+  std::vector<folly::Future<folly::Unit>> futures;
+  for (size_t i = 0; i < children_.size(); ++i) {
+    if (serialChildren_[i]) {
+      continue;
+    }
+    futures.push_back(folly::via(context_.encodingExecutor(), [&, i]() {
+      rawSizes[i] = children_[i]->write(rowSlice->childAt(i), ranges);
+    }));
+  }
+  // The tasks reference the locals, so all must be done before returning,
+  // also on error.
+  std::exception_ptr error;
+  try {
+    for (size_t i = 0; i < children_.size(); ++i) {
+      if (serialChildren_[i]) {
+        rawSizes[i] = children_[i]->write(rowSlice->childAt(i), ranges);
+      }
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  auto results = folly::collectAll(std::move(futures)).get();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  for (auto& result : results) {
+    result.value();
+  }
+  return std::accumulate(rawSizes.begin(), rawSizes.end(), 0UL);
+}
+
 uint64_t StructColumnWriter::write(
     const VectorPtr& slice,
     const Ranges& ranges) {
@@ -159,7 +159,9 @@ class BaseColumnWriter : public ColumnWriter {
         type_{type},
         indexBuilder_{context_.newIndexBuilder(
             newStream(StreamKind::StreamKind_ROW_INDEX))},
-        onRecordPosition_{std::move(onRecordPosition)} {
+        onRecordPosition_{std::move(onRecordPosition)},
+        earlyDictionaryDecisionRows_{
+            getConfig(Config::DICTIONARY_EARLY_DECISION_ROWS)} {
     if (!isRoot()) {
       present_ =
           createBooleanRleEncoder(newStream(StreamKind::StreamKind_PRESENT));
@@ -167,6 +169,29 @@ class BaseColumnWriter : public ColumnWriter {
     auto options = StatisticsBuilderOptions::fromConfig(context.getConfigs());
     indexStatsBuilder_ = StatisticsBuilder::create(*type.type, options);
     fileStatsBuilder_ = StatisticsBuilder::create(*type.type, options);
+    if (hasBloomFilter()) {
+      indexStatsBuilder_->setBloomFilter(std::make_unique<BloomFilter>(
+          context_.indexStride, getConfig(Config::BLOOM_FILTER_FPP)));
+      indexBuilder_->setBloomFilterStream(
+          newStream(StreamKind::StreamKind_BLOOM_FILTER_UTF8));
+    }
+  }
+
+  // True if the values of 'this' go into a bloom filter per row index entry.
+  bool hasBloomFilter() const {
+    switch (type_.type->kind()) {
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::VARCHAR:
+        break;
+      default:
+        return false;
+    }
+    const auto& columns = getConfig(Config::BLOOM_FILTER_COLS);
+    return std::find(columns.begin(), columns.end(), type_.column) !=
+        columns.end();
   }
 
   uint64_t writeNulls(const VectorPtr& slice, const Ranges& ranges) {
@@ -246,6 +271,20 @@ class BaseColumnWriter : public ColumnWriter {
         !context_.isLowMemoryMode();
   }
 
+  // Returns true once, when the dictionary of the first stripe has
+  // 'numValues' values and this reaches DICTIONARY_EARLY_DECISION_ROWS. The
+  // dictionary writers then decide whether to keep the dictionary instead of
+  // building it for the whole stripe, which is wasted on high cardinality
+  // columns.
+  bool shouldDecideDictionaryEarly(uint64_t numValues) {
+    if (earlyDictionaryDecisionRows_ == 0 ||
+        numValues < earlyDictionaryDecisionRows_) {
+      return false;
+    }
+    earlyDictionaryDecisionRows_ = 0;
+    return true;
+  }
+
   WriterContext::LocalDecodedVector decode(
       const VectorPtr& slice,
       const Ranges& ranges);
@@ -261,6 +300,8 @@ class BaseColumnWriter : public ColumnWriter {
   // callback used to inject the logic that captures positions for flat map
   // in_map stream
   const std::function<void(IndexBuilder&)> onRecordPosition_;
+  // Reset to 0 after the early dictionary decision.
+  uint32_t earlyDictionaryDecisionRows_;
 
   VELOX_FRIEND_TEST(ColumnWriterTests, LowMemoryModeConfig);
   friend class ValueStatisticsBuilder;
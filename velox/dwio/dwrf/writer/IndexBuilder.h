@@ -46,6 +46,17 @@ class IndexBuilder : public PositionRecorder {
     writer.toProto(*stats);
     *index_.add_entry() = entry_;
     entry_.Clear();
+    if (bloomFilterOut_) {
+      auto bloomFilter = writer.bloomFilter();
+      DWIO_ENSURE_NOT_NULL(bloomFilter, "Stats without bloom filter");
+      bloomFilter->toProto(*bloomFilterIndex_.add_bloomfilter());
+    }
+  }
+
+  // Makes addEntry() also collect the bloom filter of the stats, to be
+  // written to 'out' on flush.
+  void setBloomFilterStream(std::unique_ptr<BufferedOutputStream> out) {
+    bloomFilterOut_ = std::move(out);
   }
 
   virtual size_t getEntrySize() const {
@@ -60,6 +71,11 @@ class IndexBuilder : public PositionRecorder {
     out_->flush();
     index_.Clear();
     entry_.Clear();
+    if (bloomFilterOut_) {
+      bloomFilterIndex_.SerializeToZeroCopyStream(bloomFilterOut_.get());
+      bloomFilterOut_->flush();
+      bloomFilterIndex_.Clear();
+    }
   }
 
   void capturePresentStreamOffset() {
@@ -88,6 +104,8 @@ class IndexBuilder : public PositionRecorder {
   proto::RowIndex index_;
   proto::RowIndexEntry entry_;
   std::optional<int32_t> presentStreamOffset_;
+  std::unique_ptr<BufferedOutputStream> bloomFilterOut_;
+  proto::BloomFilterIndex bloomFilterIndex_;
 
   proto::RowIndexEntry* getEntry(int32_t index) {
     if (index < 0) {
@@ -17,6 +17,8 @@
 #pragma once
 
 #include <velox/common/base/Exceptions.h>
+#include "velox/common/base/SimdUtil.h"
+#include "velox/dwio/dwrf/common/BloomFilter.h"
 #include "velox/dwio/dwrf/common/Config.h"
 #include "velox/dwio/dwrf/common/Statistics.h"
 #include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
@@ -131,6 +133,22 @@ class StatisticsBuilder : public virtual dwio::common::ColumnStatistics {
    */
   virtual void reset() {
     init();
+    if (bloomFilter_) {
+      bloomFilter_->reset();
+    }
+  }
+
+  /*
+   * Collect the values also into 'bloomFilter'. Only the integer and string
+   * builders add to it, and it is not merged, so it is meant for the stats of
+   * row index entries.
+   */
+  void setBloomFilter(std::unique_ptr<BloomFilter> bloomFilter) {
+    bloomFilter_ = std::move(bloomFilter);
+  }
+
+  const BloomFilter* bloomFilter() const {
+    return bloomFilter_.get();
   }
 
   /*
@@ -160,6 +178,7 @@ class StatisticsBuilder : public virtual dwio::common::ColumnStatistics {
 
  protected:
   StatisticsBuilderOptions options_;
+  std::unique_ptr<BloomFilter> bloomFilter_;
 };
 
 class BooleanStatisticsBuilder : public StatisticsBuilder,
@@ -213,6 +232,43 @@ class IntegerStatisticsBuilder : public StatisticsBuilder,
       max_ = value;
     }
     addWithOverflowCheck(sum_, value, count);
+    if (bloomFilter_) {
+      bloomFilter_->addLong(value);
+    }
+  }
+
+  /*
+   * Adds values[0] to values[size - 1]. Same as addValues() for each value
+   * but the min, max and sum are computed with SIMD.
+   */
+  template <typename T>
+  void addBatch(const T* values, int32_t size) {
+    if (bloomFilter_) {
+      for (auto i = 0; i < size; ++i) {
+        addValues(values[i]);
+      }
+      return;
+    }
+    increaseValueCount(size);
+    if (min_.has_value()) {
+      min_ = std::min<int64_t>(
+          min_.value(),
+          simd::reduceMin(values, size, std::numeric_limits<T>::max()));
+    }
+    if (max_.has_value()) {
+      max_ = std::max<int64_t>(
+          max_.value(),
+          simd::reduceMax(values, size, std::numeric_limits<T>::min()));
+    }
+    if (sum_.has_value()) {
+      bool overflow = false;
+      const auto sum = simd::reduceSum<int64_t>(values, size, &overflow);
+      if (overflow) {
+        sum_.reset();
+      } else {
+        addWithOverflowCheck<int64_t>(sum_, sum, 1);
+      }
+    }
   }
 
   void merge(const dwio::common::ColumnStatistics& other) override;
@@ -272,6 +328,54 @@ class DoubleStatisticsBuilder : public StatisticsBuilder,
     }
   }
 
+  /*
+   * Adds values[0] to values[size - 1]. Same as addValues() for each value
+   * but the min and max are computed with SIMD. The sum is added in order
+   * like addValues() does, so that it does not change in the last bits.
+   */
+  template <typename T>
+  void addBatch(const T* values, int32_t size) {
+    increaseValueCount(size);
+    if (!min_.has_value() && !max_.has_value() && !sum_.has_value()) {
+      return;
+    }
+    double sum = sum_.value_or(0);
+    if (sum_.has_value()) {
+      for (auto i = 0; i < size; ++i) {
+        sum += values[i];
+      }
+    }
+    // A NaN value makes the sum NaN. So does adding infinities of different
+    // signs, or the sum may have been reset before.
+    if (!sum_.has_value() || std::isnan(sum)) {
+      bool hasNaN = false;
+      for (auto i = 0; i < size; ++i) {
+        hasNaN |= std::isnan(values[i]);
+      }
+      if (hasNaN) {
+        clear();
+        return;
+      }
+    }
+    if (sum_.has_value()) {
+      if (std::isnan(sum)) {
+        sum_.reset();
+      } else {
+        sum_ = sum;
+      }
+    }
+    if (min_.has_value()) {
+      min_ = std::min<double>(
+          min_.value(),
+          simd::reduceMin(values, size, std::numeric_limits<T>::infinity()));
+    }
+    if (max_.has_value()) {
+      max_ = std::max<double>(
+          max_.value(),
+          simd::reduceMax(values, size, -std::numeric_limits<T>::infinity()));
+    }
+  }
+
   void merge(const dwio::common::ColumnStatistics& other) override;
 
   void reset() override {
@@ -324,6 +428,9 @@ class StringStatisticsBuilder : public StatisticsBuilder,
     }
 
     addWithOverflowCheck<uint64_t>(length_, value.size(), count);
+    if (bloomFilter_) {
+      bloomFilter_->addBytes(value);
+    }
   }
 
   void merge(const dwio::common::ColumnStatistics& other) override;
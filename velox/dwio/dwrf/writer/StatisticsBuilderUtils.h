@@ -67,28 +67,59 @@ class StatisticsBuilderUtils {
       BinaryStatisticsBuilder& builder,
       const VectorPtr& vector,
       const Ranges& ranges);
+
+  /// Calls 'addBatch(begin, end)' for each run of 'ranges' with no nulls and
+  /// 'addValue(index)' for each non-null index in the other runs. Runs with
+  /// no nulls are found by a popcount of 'nulls'. 'nulls' may be nullptr.
+  /// Calls builder.setHasNull() if there is a null. Returns the number of
+  /// nulls.
+  template <typename AddBatch, typename AddValue>
+  static uint64_t forEachNonNull(
+      StatisticsBuilder& builder,
+      const uint64_t* nulls,
+      const Ranges& ranges,
+      AddBatch addBatch,
+      AddValue addValue);
 };
 
+template <typename AddBatch, typename AddValue>
+uint64_t StatisticsBuilderUtils::forEachNonNull(
+    StatisticsBuilder& builder,
+    const uint64_t* nulls,
+    const Ranges& ranges,
+    AddBatch addBatch,
+    AddValue addValue) {
+  uint64_t nullCount = 0;
+  for (const auto& [begin, end] : ranges.getRanges()) {
+    const auto numNulls =
+        nulls ? end - begin - bits::countBits(nulls, begin, end) : 0;
+    if (numNulls == 0) {
+      addBatch(begin, end);
+    } else {
+      nullCount += numNulls;
+      bits::forEachSetBit(nulls, begin, end, addValue);
+    }
+  }
+  if (nullCount > 0) {
+    builder.setHasNull();
+  }
+  return nullCount;
+}
+
 template <typename INT>
 void StatisticsBuilderUtils::addValues(
     IntegerStatisticsBuilder& builder,
     const VectorPtr& vector,
     const Ranges& ranges) {
-  auto nulls = vector->rawNulls();
   auto vals = vector->asFlatVector<INT>()->rawValues();
-  if (vector->mayHaveNulls()) {
-    for (auto& pos : ranges) {
-      if (bits::isBitNull(nulls, pos)) {
-        builder.setHasNull();
-      } else {
-        builder.addValues(vals[pos]);
-      }
-    }
-  } else {
-    for (auto& pos : ranges) {
-      builder.addValues(vals[pos]);
-    }
-  }
+  forEachNonNull(
+      builder,
+      vector->mayHaveNulls() ? vector->rawNulls() : nullptr,
+      ranges,
+      [&](size_t begin, size_t end) {
+        builder.addBatch(vals + begin, end - begin);
+      },
+      [&](vector_size_t pos) { builder.addValues(vals[pos]); });
 }
 
 template <typename INT>
@@ -116,21 +147,15 @@ void StatisticsBuilderUtils::addValues(
     DoubleStatisticsBuilder& builder,
     const VectorPtr& vector,
     const Ranges& ranges) {
-  auto nulls = vector->rawNulls();
   auto vals = vector->asFlatVector<FLOAT>()->rawValues();
-  if (vector->mayHaveNulls()) {
-    for (auto& pos : ranges) {
-      if (bits::isBitNull(nulls, pos)) {
-        builder.setHasNull();
-      } else {
-        builder.addValues(vals[pos]);
-      }
-    }
-  } else {
-    for (auto& pos : ranges) {
-      builder.addValues(vals[pos]);
-    }
-  }
+  forEachNonNull(
+      builder,
+      vector->mayHaveNulls() ? vector->rawNulls() : nullptr,
+      ranges,
+      [&](size_t begin, size_t end) {
+        builder.addBatch(vals + begin, end - begin);
+      },
+      [&](vector_size_t pos) { builder.addValues(vals[pos]); });
 }
 
 } // namespace facebook::velox::dwrf
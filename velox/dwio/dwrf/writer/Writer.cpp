@@ -236,6 +236,9 @@ void Writer::write(const VectorPtr& slice) {
         flushDecision = shouldFlush(context, length);
       }
       if (flushDecision) {
+        if (overBudgetFlush_) {
+          ++forcedFlushStats_.memoryBudget;
+        }
         flush();
       }
     }
@@ -324,6 +327,8 @@ bool Writer::shouldFlush(const WriterContext& context, size_t nextWriteLength) {
 
   const bool decision = overBudget || stripeProgressDecision ||
       dwrfFlushDecision == FlushDecision::FLUSH_DICTIONARY;
+  overBudgetFlush_ = overBudget && !stripeProgressDecision &&
+      dwrfFlushDecision != FlushDecision::FLUSH_DICTIONARY;
   if (decision) {
     VLOG(1) << fmt::format(
         "overMemoryBudget: {}, dictionaryMemUsage: {}, outputStreamSize: {}, generalMemUsage: {}, estimatedStripeSize: {}",
@@ -341,6 +346,28 @@ void Writer::setLowMemoryMode() {
   getContext().setLowMemoryMode();
 }
 
+int64_t Writer::reclaimableBytes() const {
+  const auto& context = getContext();
+  if (context.stripeRowCount == 0) {
+    return 0;
+  }
+  return context.getTotalMemoryUsage();
+}
+
+void Writer::reclaim() {
+  const auto& context = getContext();
+  if (context.stripeRowCount == 0) {
+    return;
+  }
+  ++forcedFlushStats_.reclaim;
+  LOG(INFO) << fmt::format(
+      "Flushing stripe {} with {} rows to reclaim {} bytes",
+      context.stripeIndex,
+      context.stripeRowCount,
+      context.getTotalMemoryUsage());
+  flush();
+}
+
 // Low memory allows for the writer to write the same data with a lower
 // memory budget.
 // Currently this method is only called locally to switch encoding if
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <folly/Executor.h>
 #include <iterator>
 #include <limits>
 
@@ -124,17 +125,31 @@ struct WriterOptions {
       WriterContext& context,
       const velox::dwio::common::TypeWithId& type)>
       columnWriterFactory;
+  // If set, the top level columns of each write are encoded and compressed
+  // in parallel on this executor. Flat map columns and the stripe flush
+  // stay on the calling thread.
+  std::shared_ptr<folly::Executor> encodingExecutor;
 };
 
 class Writer : public WriterBase {
  public:
+  // Counts of the stripes flushed before the flush policy asked for it, by
+  // reason.
+  struct ForcedFlushStats {
+    // The next write would have exceeded the memory budget of the writer.
+    uint64_t memoryBudget{0};
+    // The memory of the writer was reclaimed with reclaim().
+    uint64_t reclaim{0};
+  };
+
   Writer(
       const WriterOptions& options,
       std::unique_ptr<dwio::common::DataSink> sink,
       memory::MemoryPool& parentPool)
       : WriterBase{std::move(sink)},
         schema_{dwio::common::TypeWithId::create(options.schema)},
-        layoutPlannerFactory_{options.layoutPlannerFactory} {
+        layoutPlannerFactory_{options.layoutPlannerFactory},
+        encodingExecutor_{options.encodingExecutor} {
     auto handler =
         (options.encryptionSpec ? encryption::EncryptionHandler::create(
                                       schema_,
@@ -149,6 +164,7 @@ class Writer : public WriterBase {
                 folly::to<std::string>(folly::Random::rand64())),
             std::min(options.memoryBudget, parentPool.getCap())),
         std::move(handler));
+    getContext().setEncodingExecutor(encodingExecutor_.get());
     if (!options.flushPolicyFactory) {
       auto& context = getContext();
       flushPolicy_ = std::make_unique<DefaultFlushPolicy>(
@@ -183,6 +199,19 @@ class Writer : public WriterBase {
 
   void setLowMemoryMode();
 
+  // Returns the memory that reclaim() would free. 0 if there is no
+  // unflushed data.
+  int64_t reclaimableBytes() const;
+
+  // Flushes the current stripe to free the memory of the dictionaries and
+  // the buffered streams. Called when the memory of the query is needed
+  // elsewhere, e.g. from the reclaimer of the operator that owns 'this'.
+  void reclaim();
+
+  const ForcedFlushStats& forcedFlushStats() const {
+    return forcedFlushStats_;
+  }
+
   uint64_t flushTimeMemoryUsageEstimate(
       const WriterContext& context,
       size_t nextWriteSize) const;
@@ -227,7 +256,12 @@ class Writer : public WriterBase {
   std::function<
       std::unique_ptr<LayoutPlanner>(StreamList, const EncodingContainer&)>
       layoutPlannerFactory_;
+  const std::shared_ptr<folly::Executor> encodingExecutor_;
   std::unique_ptr<ColumnWriter> writer_;
+  ForcedFlushStats forcedFlushStats_;
+  // True if the last flush decision of shouldFlush() was only made to stay
+  // in the memory budget.
+  bool overBudgetFlush_{false};
 
   friend class WriterTestHelper;
 };
@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+#include <mutex>
+
 #include "velox/common/base/GTestMacros.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/dwio/dwrf/common/Compression.h"
@@ -70,8 +73,9 @@ class WriterContext : public CompressionBufferPool {
     }
     validateConfigs();
     VLOG(1) << fmt::format("Compression config: {}", compression);
-    compressionBuffer_ = std::make_unique<dwio::common::DataBuffer<char>>(
-        generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+    compressionBuffers_.push_back(
+        std::make_unique<dwio::common::DataBuffer<char>>(
+            generalPool_, compressionBlockSize + PAGE_HEADER_SIZE));
   }
 
   bool hasStream(const DwrfStreamIdentifier& stream) const {
@@ -98,22 +102,28 @@ class WriterContext : public CompressionBufferPool {
   // flush policy evaluation and would be more accurate after flush.
   std::unique_ptr<BufferedOutputStream> newStream(
       const DwrfStreamIdentifier& stream) {
-    DWIO_ENSURE(
-        !hasStream(stream), "Stream already exists ", stream.toString());
-    streams_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(stream),
-        std::forward_as_tuple(
-            getMemoryPool(MemoryUsageCategory::OUTPUT_STREAM),
-            compressionBlockSize,
-            getConfig(Config::COMPRESSION_BLOCK_SIZE_MIN),
-            getConfig(Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO)));
-    auto& holder = streams_.at(stream);
+    DataBufferHolder* holder;
+    {
+      // Column writers on 'encodingExecutor_' may switch encodings and add
+      // streams while writing.
+      std::lock_guard<std::mutex> l(mutex_);
+      DWIO_ENSURE(
+          !hasStream(stream), "Stream already exists ", stream.toString());
+      streams_.emplace(
+          std::piecewise_construct,
+          std::forward_as_tuple(stream),
+          std::forward_as_tuple(
+              getMemoryPool(MemoryUsageCategory::OUTPUT_STREAM),
+              compressionBlockSize,
+              getConfig(Config::COMPRESSION_BLOCK_SIZE_MIN),
+              getConfig(Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO)));
+      holder = &streams_.at(stream);
+    }
     auto encrypter = handler_->isEncrypted(stream.encodingKey().node)
         ? std::addressof(
               handler_->getEncryptionProvider(stream.encodingKey().node))
         : nullptr;
-    return newStream(compression, holder, encrypter);
+    return newStream(compression, *holder, encrypter);
   }
 
   std::unique_ptr<DataBufferHolder> newDataBufferHolder(
@@ -169,6 +179,7 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void suppressStream(const DwrfStreamIdentifier& stream) {
+    std::lock_guard<std::mutex> l(mutex_);
     DWIO_ENSURE(hasStream(stream));
     auto& collector = streams_.at(stream);
     collector.suppress();
@@ -294,18 +305,42 @@ class WriterContext : public CompressionBufferPool {
     }
   }
 
+  // There is one compression buffer per stream being compressed at the same
+  // time. This is one unless columns are encoded on 'encodingExecutor()'.
   std::unique_ptr<dwio::common::DataBuffer<char>> getBuffer(
       uint64_t size) override {
-    DWIO_ENSURE_NOT_NULL(compressionBuffer_);
-    DWIO_ENSURE_GE(compressionBuffer_->size(), size);
-    return std::move(compressionBuffer_);
+    std::unique_ptr<dwio::common::DataBuffer<char>> buffer;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (!compressionBuffers_.empty()) {
+        buffer = std::move(compressionBuffers_.back());
+        compressionBuffers_.pop_back();
+      }
+    }
+    if (!buffer) {
+      buffer = std::make_unique<dwio::common::DataBuffer<char>>(
+          generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+    }
+    DWIO_ENSURE_GE(buffer->size(), size);
+    return buffer;
   }
 
   void returnBuffer(
       std::unique_ptr<dwio::common::DataBuffer<char>> buffer) override {
     DWIO_ENSURE_NOT_NULL(buffer);
-    DWIO_ENSURE(!compressionBuffer_);
-    compressionBuffer_ = std::move(buffer);
+    std::lock_guard<std::mutex> l(mutex_);
+    compressionBuffers_.push_back(std::move(buffer));
+  }
+
+  // Executor for encoding the top level columns in parallel. Set from
+  // WriterOptions. Full pages of the streams are compressed as they fill up,
+  // so compression also runs in parallel.
+  folly::Executor* FOLLY_NULLABLE encodingExecutor() const {
+    return encodingExecutor_;
+  }
+
+  void setEncodingExecutor(folly::Executor* FOLLY_NULLABLE executor) {
+    encodingExecutor_ = executor;
   }
 
   void incrementNodeSize(uint32_t node, uint64_t size) {
@@ -414,6 +449,7 @@ class WriterContext : public CompressionBufferPool {
     return LocalDecodedVector{*this};
   }
 
+  // Not thread safe. Only used if there is no 'encodingExecutor_'.
   SelectivityVector& getSharedSelectivityVector(velox::vector_size_t size) {
     if (UNLIKELY(!selectivityVector_)) {
       selectivityVector_ = std::make_unique<velox::SelectivityVector>(size);
@@ -427,6 +463,7 @@ class WriterContext : public CompressionBufferPool {
   void validateConfigs() const;
 
   std::unique_ptr<velox::DecodedVector> getDecodedVector() {
+    std::lock_guard<std::mutex> l(mutex_);
     if (decodedVectorPool_.empty()) {
       return std::make_unique<velox::DecodedVector>();
     }
@@ -436,6 +473,7 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void releaseDecodedVector(std::unique_ptr<velox::DecodedVector>&& vector) {
+    std::lock_guard<std::mutex> l(mutex_);
     decodedVectorPool_.push_back(std::move(vector));
   }
 
@@ -460,11 +498,16 @@ class WriterContext : public CompressionBufferPool {
   std::function<std::unique_ptr<IndexBuilder>(
       std::unique_ptr<BufferedOutputStream>)>
       indexBuilderFactory_;
-  std::unique_ptr<dwio::common::DataBuffer<char>> compressionBuffer_;
+  // Serializes access to the pools below from column writers running on
+  // 'encodingExecutor_'.
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<dwio::common::DataBuffer<char>>>
+      compressionBuffers_;
   // A pool of reusable DecodedVectors.
   std::vector<std::unique_ptr<velox::DecodedVector>> decodedVectorPool_;
   // Reusable SelectivityVector
   std::unique_ptr<velox::SelectivityVector> selectivityVector_;
+  folly::Executor* FOLLY_NULLABLE encodingExecutor_{nullptr};
 
   std::unique_ptr<encryption::EncryptionHandler> handler_;
   folly::F14FastMap<uint32_t, uint64_t> nodeSize;
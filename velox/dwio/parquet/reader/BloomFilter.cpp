@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+
+#include <cstring>
+
+#include <xsimd/xsimd.hpp>
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::parquet {
+
+namespace {
+
+// The salts of the 8 hash functions, one per word of a block.
+alignas(32) constexpr uint32_t kSalts[8] = {
+    0x47b6137bU,
+    0x44974d91U,
+    0x8824ad5bU,
+    0xa2b7289dU,
+    0x705495c7U,
+    0x2df1424bU,
+    0x9efc4947U,
+    0x5c6bfb31U};
+
+// Returns the bit of word 'i' of the block that is set for 'key'.
+inline uint32_t mask(uint32_t key, int32_t i) {
+  return 1U << ((key * kSalts[i]) >> 27);
+}
+
+} // namespace
+
+SplitBlockBloomFilter::SplitBlockBloomFilter(int32_t numBytes) {
+  VELOX_CHECK_GT(numBytes, 0);
+  VELOX_CHECK_EQ(numBytes % kBytesPerBlock, 0);
+  words_.resize(numBytes / sizeof(uint32_t));
+}
+
+SplitBlockBloomFilter::SplitBlockBloomFilter(
+    const char* data,
+    int32_t numBytes)
+    : SplitBlockBloomFilter(numBytes) {
+  memcpy(words_.data(), data, numBytes);
+}
+
+const uint32_t* SplitBlockBloomFilter::block(uint64_t hash) const {
+  const uint64_t numBlocks = words_.size() / 8;
+  return words_.data() + (((hash >> 32) * numBlocks) >> 32) * 8;
+}
+
+void SplitBlockBloomFilter::insertHash(uint64_t hash) {
+  auto words = const_cast<uint32_t*>(block(hash));
+  const auto key = static_cast<uint32_t>(hash);
+  for (auto i = 0; i < 8; ++i) {
+    words[i] |= mask(key, i);
+  }
+}
+
+bool SplitBlockBloomFilter::testHash(uint64_t hash) const {
+  const auto words = block(hash);
+  const auto key = static_cast<uint32_t>(hash);
+#if XSIMD_WITH_AVX2
+  // Computes the 8 masks in one vector and checks that all their bits are
+  // set in the block.
+  const auto salts =
+      _mm256_load_si256(reinterpret_cast<const __m256i*>(kSalts));
+  const auto shifts = _mm256_srli_epi32(
+      _mm256_mullo_epi32(_mm256_set1_epi32(key), salts), 27);
+  const auto masks = _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+  const auto bits =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words));
+  return _mm256_testc_si256(bits, masks);
+#else
+  for (auto i = 0; i < 8; ++i) {
+    if ((words[i] & mask(key, i)) == 0) {
+      return false;
+    }
+  }
+  return true;
+#endif
+}
+
+// static
+uint64_t SplitBlockBloomFilter::hashInt32(int32_t value) {
+  return XXH64(&value, sizeof(value), 0);
+}
+
+// static
+uint64_t SplitBlockBloomFilter::hashInt64(int64_t value) {
+  return XXH64(&value, sizeof(value), 0);
+}
+
+// static
+uint64_t SplitBlockBloomFilter::hashBytes(const char* data, int32_t length) {
+  return XXH64(data, length, 0);
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <folly/Range.h>
+
+namespace facebook::velox::parquet {
+
+/// Split block Bloom filter of a Parquet column chunk as specified in
+/// parquet-format. The filter is an array of 256 bit blocks. A value sets
+/// one bit in each of the 8 words of one block. The hash is the XXH64 of
+/// the plain encoding of the value, i.e. the little endian bytes of a
+/// fixed width value and the bytes of a string without length.
+class SplitBlockBloomFilter {
+ public:
+  static constexpr int32_t kBytesPerBlock = 32;
+
+  /// Creates an empty filter of 'numBytes', which is a multiple of
+  /// kBytesPerBlock.
+  explicit SplitBlockBloomFilter(int32_t numBytes);
+
+  /// Makes a filter over the bitset of 'numBytes' at 'data'.
+  SplitBlockBloomFilter(const char* data, int32_t numBytes);
+
+  void insertHash(uint64_t hash);
+
+  /// Returns false if no value with 'hash' was inserted.
+  bool testHash(uint64_t hash) const;
+
+  void insertInt32(int32_t value) {
+    insertHash(hashInt32(value));
+  }
+
+  void insertInt64(int64_t value) {
+    insertHash(hashInt64(value));
+  }
+
+  void insertBytes(folly::StringPiece value) {
+    insertHash(hashBytes(value.data(), value.size()));
+  }
+
+  bool testInt32(int32_t value) const {
+    return testHash(hashInt32(value));
+  }
+
+  bool testInt64(int64_t value) const {
+    return testHash(hashInt64(value));
+  }
+
+  bool testBytes(folly::StringPiece value) const {
+    return testHash(hashBytes(value.data(), value.size()));
+  }
+
+  int32_t numBytes() const {
+    return words_.size() * sizeof(uint32_t);
+  }
+
+  static uint64_t hashInt32(int32_t value);
+
+  static uint64_t hashInt64(int64_t value);
+
+  static uint64_t hashBytes(const char* data, int32_t length);
+
+ private:
+  // Returns the first word of the block selected by 'hash'.
+  const uint32_t* block(uint64_t hash) const;
+
+  std::vector<uint32_t> words_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/encode/Coding.h"
+
+#include <cstring>
+#include <vector>
+
+namespace facebook::velox::parquet {
+
+/// Decodes the DELTA_BINARY_PACKED encoding of Parquet. The stream starts
+/// with a header of block size, number of miniblocks per block, number of
+/// values and the first value. Each block has the minimum delta of the
+/// block and the bit width of each miniblock followed by the miniblocks of
+/// bit packed deltas. The deltas are decoded and added up a miniblock at a
+/// time.
+class DeltaBpDecoder {
+ public:
+  DeltaBpDecoder(const char* FOLLY_NONNULL start, const char* FOLLY_NONNULL end)
+      : bufferStart_(start), bufferEnd_(end) {
+    blockSize_ = readVuLong();
+    numMiniblocks_ = readVuLong();
+    numValues_ = readVuLong();
+    lastValue_ = ZigZag::decode(readVuLong());
+    VELOX_CHECK(
+        blockSize_ > 0 && blockSize_ % 128 == 0,
+        "Bad DELTA_BINARY_PACKED block size {}",
+        blockSize_);
+    VELOX_CHECK(
+        numMiniblocks_ > 0 && blockSize_ % numMiniblocks_ == 0 &&
+            (blockSize_ / numMiniblocks_) % 32 == 0,
+        "Bad DELTA_BINARY_PACKED miniblock count {}",
+        numMiniblocks_);
+    miniblockSize_ = blockSize_ / numMiniblocks_;
+    bitWidths_.resize(numMiniblocks_);
+    values_.resize(miniblockSize_);
+    miniblockInBlock_ = numMiniblocks_;
+    valueInMiniblock_ = miniblockSize_;
+  }
+
+  /// Total number of values in the stream.
+  uint64_t numValues() const {
+    return numValues_;
+  }
+
+  /// Returns the first byte after the miniblocks read so far. After all
+  /// values are read this is the end of the encoded stream.
+  const char* FOLLY_NONNULL bufferStart() const {
+    return bufferStart_;
+  }
+
+  /// Decodes the next 'count' values into 'values'. The values of INT32
+  /// columns are decoded with 64 bit arithmetic and truncated, which gives
+  /// the same result as 32 bit arithmetic with wrap around.
+  template <typename T>
+  void readValues(T* FOLLY_NONNULL values, uint64_t count) {
+    VELOX_CHECK_LE(
+        count,
+        numValues_ - numRead_,
+        "Reading past end of DELTA_BINARY_PACKED stream");
+    uint64_t i = 0;
+    if (count > 0 && numRead_ == 0) {
+      values[i++] = static_cast<T>(lastValue_);
+    }
+    while (i < count) {
+      if (valueInMiniblock_ == miniblockSize_) {
+        nextMiniblock();
+      }
+      const auto numCopied =
+          std::min<uint64_t>(count - i, miniblockSize_ - valueInMiniblock_);
+      for (auto j = 0; j < numCopied; ++j) {
+        values[i + j] = static_cast<T>(values_[valueInMiniblock_ + j]);
+      }
+      i += numCopied;
+      valueInMiniblock_ += numCopied;
+    }
+    numRead_ += count;
+  }
+
+ private:
+  uint64_t readVuLong() {
+    uint64_t result = 0;
+    for (auto shift = 0; shift < 64; shift += 7) {
+      VELOX_CHECK(
+          bufferStart_ < bufferEnd_, "Truncated DELTA_BINARY_PACKED stream");
+      const auto byte = static_cast<uint8_t>(*bufferStart_++);
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return result;
+      }
+    }
+    VELOX_FAIL("Bad varint in DELTA_BINARY_PACKED stream");
+  }
+
+  // Reads the header of the next block.
+  void nextBlock() {
+    minDelta_ = ZigZag::decode(readVuLong());
+    VELOX_CHECK(
+        bufferStart_ + numMiniblocks_ <= bufferEnd_,
+        "Truncated DELTA_BINARY_PACKED stream");
+    for (auto i = 0; i < numMiniblocks_; ++i) {
+      bitWidths_[i] = static_cast<uint8_t>(bufferStart_[i]);
+      VELOX_CHECK_LE(bitWidths_[i], 64, "Bad DELTA_BINARY_PACKED bit width");
+    }
+    bufferStart_ += numMiniblocks_;
+    miniblockInBlock_ = 0;
+  }
+
+  // Decodes the next miniblock into 'values_'. A miniblock with values is
+  // always complete, padded to 'miniblockSize_' values if needed.
+  void nextMiniblock() {
+    if (miniblockInBlock_ == numMiniblocks_) {
+      nextBlock();
+    }
+    const auto bitWidth = bitWidths_[miniblockInBlock_++];
+    const auto numBytes = miniblockSize_ * bitWidth / 8;
+    VELOX_CHECK(
+        bufferStart_ + numBytes <= bufferEnd_,
+        "Truncated DELTA_BINARY_PACKED stream");
+    // The deltas are added with unsigned arithmetic, so that overflow wraps
+    // around like in the writer.
+    auto value = static_cast<uint64_t>(lastValue_);
+    const auto minDelta = static_cast<uint64_t>(minDelta_);
+    if (bitWidth == 0) {
+      for (auto i = 0; i < miniblockSize_; ++i) {
+        value += minDelta;
+        values_[i] = value;
+      }
+    } else {
+      const auto* data = reinterpret_cast<const uint8_t*>(bufferStart_);
+      const auto* end = data + numBytes;
+      const uint64_t mask = bitWidth == 64 ? ~0UL : bits::lowMask(bitWidth);
+      uint64_t bit = 0;
+      for (auto i = 0; i < miniblockSize_; ++i, bit += bitWidth) {
+        value += minDelta + (loadBits(data + bit / 8, end, bit % 8) & mask);
+        values_[i] = value;
+      }
+    }
+    lastValue_ = static_cast<int64_t>(value);
+    bufferStart_ += numBytes;
+    valueInMiniblock_ = 0;
+  }
+
+  // Returns the 64 bits starting at bit 'shift' of 'data'. Does not read
+  // at or after 'end'.
+  static uint64_t loadBits(
+      const uint8_t* FOLLY_NONNULL data,
+      const uint8_t* FOLLY_NONNULL end,
+      int32_t shift) {
+    uint64_t word = 0;
+    const auto available = end - data;
+    if (FOLLY_LIKELY(available >= 8)) {
+      memcpy(&word, data, 8);
+    } else {
+      memcpy(&word, data, available);
+    }
+    word >>= shift;
+    if (shift > 0 && available > 8) {
+      word |= static_cast<uint64_t>(data[8]) << (64 - shift);
+    }
+    return word;
+  }
+
+  const char* FOLLY_NONNULL bufferStart_;
+  const char* FOLLY_NONNULL const bufferEnd_;
+  uint64_t blockSize_;
+  uint64_t numMiniblocks_;
+  uint64_t miniblockSize_;
+  uint64_t numValues_;
+
+  // Number of values returned from readValues().
+  uint64_t numRead_{0};
+
+  // The last decoded value. The first value of the stream before the first
+  // miniblock.
+  int64_t lastValue_;
+  int64_t minDelta_{0};
+  std::vector<uint8_t> bitWidths_;
+  uint64_t miniblockInBlock_;
+
+  // Values of the current miniblock.
+  std::vector<int64_t> values_;
+  uint64_t valueInMiniblock_;
+};
+
+} // namespace facebook::velox::parquet
@@ -21,19 +21,28 @@
 #include "velox/vector/FlatVector.h"
 
 #include <arrow/util/rle_encoding.h>
+#include <gflags/gflags.h>
 #include <snappy.h>
 #include <thrift/protocol/TCompactProtocol.h> //@manual
 #include <zlib.h>
 #include <zstd.h>
 
+DEFINE_int32(
+    velox_parquet_max_dictionary_filter_size,
+    100000,
+    "Max entries of a Parquet dictionary for which a filter is evaluated "
+    "over the whole dictionary when the dictionary is loaded. 0 disables.");
+
 namespace facebook::velox::parquet {
 
 using thrift::Encoding;
 using thrift::PageHeader;
 
 void PageReader::readNextPage(int64_t row) {
+  if (isNested_) {
+    preloadLevels();
+  }
   defineDecoder_.reset();
-  repeatDecoder_.reset();
   // 'rowOfPage_' is the row number of the first row of the next page.
   rowOfPage_ += numRowsInPage_;
   for (;;) {
@@ -216,7 +225,7 @@ void PageReader::prepareDataPageV1(const PageHeader& pageHeader, int64_t row) {
   VELOX_CHECK(
       pageHeader.type == thrift::PageType::DATA_PAGE &&
       pageHeader.__isset.data_page_header);
-  numRowsInPage_ = pageHeader.data_page_header.num_values;
+  numRowsInPage_ = numRowsInDataPage(pageHeader.data_page_header.num_values);
   if (numRowsInPage_ + rowOfPage_ <= row) {
     return;
   }
@@ -226,22 +235,20 @@ void PageReader::prepareDataPageV1(const PageHeader& pageHeader, int64_t row) {
       pageHeader.compressed_page_size,
       pageHeader.uncompressed_page_size);
   auto pageEnd = pageData_ + pageHeader.uncompressed_page_size;
+  // The levels of a nested column were decoded by preloadLevels().
   if (maxRepeat_ > 0) {
-    uint32_t repeatLength = readField<int32_t>(pageData_);
-    pageData_ += repeatLength;
-    repeatDecoder_ = std::make_unique<RleDecoder<false>>(
-        pageData_,
-        pageData_ + repeatLength,
-        arrow::bit_util::NumRequiredBits(maxRepeat_));
+    auto repeatLength = readField<uint32_t>(pageData_);
     pageData_ += repeatLength;
   }
 
   if (maxDefine_ > 0) {
     auto defineLength = readField<uint32_t>(pageData_);
-    defineDecoder_ = std::make_unique<RleDecoder<false>>(
-        pageData_,
-        pageData_ + defineLength,
-        arrow::bit_util::NumRequiredBits(maxDefine_));
+    if (!isNested_) {
+      defineDecoder_ = std::make_unique<RleDecoder<false>>(
+          pageData_,
+          pageData_ + defineLength,
+          arrow::bit_util::NumRequiredBits(maxDefine_));
+    }
     pageData_ += defineLength;
   }
   encodedDataSize_ = pageEnd - pageData_;
@@ -252,7 +259,8 @@ void PageReader::prepareDataPageV1(const PageHeader& pageHeader, int64_t row) {
 
 void PageReader::prepareDataPageV2(const PageHeader& pageHeader, int64_t row) {
   VELOX_CHECK(pageHeader.__isset.data_page_header_v2);
-  numRowsInPage_ = pageHeader.data_page_header_v2.num_values;
+  numRowsInPage_ =
+      numRowsInDataPage(pageHeader.data_page_header_v2.num_values);
   if (numRowsInPage_ + rowOfPage_ <= row) {
     return;
   }
@@ -266,14 +274,8 @@ void PageReader::prepareDataPageV2(const PageHeader& pageHeader, int64_t row) {
   auto bytes = pageHeader.compressed_page_size;
   pageData_ = readBytes(bytes, pageBuffer_);
 
-  if (repeatLength) {
-    repeatDecoder_ = std::make_unique<RleDecoder<false>>(
-        pageData_,
-        pageData_ + repeatLength,
-        arrow::bit_util::NumRequiredBits(maxRepeat_));
-  }
-
-  if (maxDefine_ > 0) {
+  // The levels of a nested column were decoded by preloadLevels().
+  if (maxDefine_ > 0 && !isNested_) {
     defineDecoder_ = std::make_unique<RleDecoder<false>>(
         pageData_ + repeatLength,
         pageData_ + repeatLength + defineLength,
@@ -293,6 +295,114 @@ void PageReader::prepareDataPageV2(const PageHeader& pageHeader, int64_t row) {
   makeDecoder();
 }
 
+int32_t PageReader::numRowsInDataPage(int32_t numLevels) {
+  if (!isNested_) {
+    return numLevels;
+  }
+  VELOX_CHECK_LT(dataPageIndex_, leavesInPage_.size());
+  return leavesInPage_[dataPageIndex_++];
+}
+
+void PageReader::preloadLevels() {
+  if (levelsLoaded_) {
+    return;
+  }
+  levelsLoaded_ = true;
+  VELOX_CHECK_EQ(pageStart_, 0, "Levels must be read before the pages");
+  while (pageStart_ < chunkSize_) {
+    PageHeader pageHeader = readPageHeader(chunkSize_ - pageStart_);
+    pageStart_ = pageDataStart_ + pageHeader.compressed_page_size;
+    if (pageHeader.type == thrift::PageType::DATA_PAGE ||
+        pageHeader.type == thrift::PageType::DATA_PAGE_V2) {
+      readPageLevels(pageHeader);
+    } else {
+      dwio::common::skipBytes(
+          pageHeader.compressed_page_size,
+          inputStream_.get(),
+          bufferStart_,
+          bufferEnd_);
+    }
+  }
+  // Rewind to the first page for reading the values.
+  pageStart_ = 0;
+  pageDataStart_ = 0;
+  std::vector<uint64_t> start = {0};
+  dwio::common::PositionProvider position(start);
+  inputStream_->seekToPosition(position);
+  bufferStart_ = bufferEnd_ = nullptr;
+}
+
+void PageReader::readPageLevels(const PageHeader& pageHeader) {
+  const char* repeatData = nullptr;
+  const char* defineData = nullptr;
+  int32_t repeatLength = 0;
+  int32_t defineLength = 0;
+  int32_t numLevels;
+  auto data = readBytes(pageHeader.compressed_page_size, pageBuffer_);
+  if (pageHeader.type == thrift::PageType::DATA_PAGE) {
+    // The levels are compressed with the values.
+    numLevels = pageHeader.data_page_header.num_values;
+    data = uncompressData(
+        data,
+        pageHeader.compressed_page_size,
+        pageHeader.uncompressed_page_size);
+    if (maxRepeat_ > 0) {
+      repeatLength = readField<int32_t>(data);
+      repeatData = data;
+      data += repeatLength;
+    }
+    if (maxDefine_ > 0) {
+      defineLength = readField<int32_t>(data);
+      defineData = data;
+    }
+  } else {
+    // The levels precede the values and are not compressed.
+    auto& header = pageHeader.data_page_header_v2;
+    numLevels = header.num_values;
+    repeatLength = header.repetition_levels_byte_length;
+    defineLength = header.definition_levels_byte_length;
+    repeatData = data;
+    defineData = data + repeatLength;
+  }
+
+  auto decodeLevels = [&](const char* levels,
+                          int32_t length,
+                          int32_t maxLevel,
+                          std::vector<int16_t>& result) {
+    auto begin = result.size();
+    result.resize(begin + numLevels);
+    if (maxLevel == 0) {
+      std::fill(result.begin() + begin, result.end(), 0);
+      return;
+    }
+    arrow::util::RleDecoder decoder(
+        reinterpret_cast<const uint8_t*>(levels),
+        length,
+        arrow::bit_util::NumRequiredBits(maxLevel));
+    VELOX_CHECK_EQ(
+        numLevels,
+        decoder.GetBatch(result.data() + begin, numLevels),
+        "Too few levels in Parquet page");
+  };
+  decodeLevels(repeatData, repeatLength, maxRepeat_, repetitions_);
+  decodeLevels(defineData, defineLength, maxDefine_, definitions_);
+
+  // Sets the null flags of the leaf positions of the page.
+  const auto* defines = definitions_.data() + definitions_.size() - numLevels;
+  leafNulls_.resize(bits::nwords(numLeaves_ + numLevels));
+  int32_t numLeavesInPage = 0;
+  for (auto i = 0; i < numLevels; ++i) {
+    if (defines[i] >= leafDefine_) {
+      bits::setBit(
+          leafNulls_.data(),
+          numLeaves_ + numLeavesInPage++,
+          defines[i] == maxDefine_);
+    }
+  }
+  numLeaves_ += numLeavesInPage;
+  leavesInPage_.push_back(numLeavesInPage);
+}
+
 void PageReader::prepareDictionary(const PageHeader& pageHeader) {
   dictionary_.numValues = pageHeader.dictionary_page_header.num_values;
   dictionaryEncoding_ = pageHeader.dictionary_page_header.encoding;
@@ -433,15 +543,114 @@ void PageReader::prepareDictionary(const PageHeader& pageHeader) {
   }
 }
 
-void PageReader::makeFilterCache(dwio::common::ScanState& state) {
+void PageReader::makeFilterCache(
+    dwio::common::ScanState& state,
+    const common::Filter* filter) {
   VELOX_CHECK(
       !state.dictionary2.values, "Parquet supports only one dictionary");
   state.filterCache.resize(state.dictionary.numValues);
+  state.rawState.filterCache = state.filterCache.data();
+  if (filter && filter->isDeterministic() &&
+      state.dictionary.numValues <=
+          FLAGS_velox_parquet_max_dictionary_filter_size &&
+      filterDictionary(*filter, state.filterCache.data())) {
+    return;
+  }
   simd::memset(
       state.filterCache.data(),
       dwio::common::FilterResult::kUnknown,
       state.filterCache.size());
-  state.rawState.filterCache = state.filterCache.data();
+}
+
+namespace {
+template <typename T, typename Test>
+void testDictionary(
+    const BufferPtr& values,
+    int32_t numValues,
+    Test test,
+    uint8_t* results) {
+  auto* rawValues = values->as<T>();
+  for (auto i = 0; i < numValues; ++i) {
+    results[i] = test(rawValues[i]) ? dwio::common::FilterResult::kSuccess
+                                    : dwio::common::FilterResult::kFailure;
+  }
+}
+} // namespace
+
+bool PageReader::filterDictionary(
+    const common::Filter& filter,
+    uint8_t* results) const {
+  switch (filter.kind()) {
+    // Filters on nulls only do not look at the values.
+    case common::FilterKind::kAlwaysTrue:
+    case common::FilterKind::kAlwaysFalse:
+    case common::FilterKind::kIsNull:
+    case common::FilterKind::kIsNotNull:
+      return false;
+    default:
+      break;
+  }
+  const auto& values = dictionary_.values;
+  const auto numValues = dictionary_.numValues;
+  // The dictionary entries are of the Velox type only for these
+  // combinations of Parquet and Velox types.
+  switch (type_->type->kind()) {
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      if (type_->parquetType_ != thrift::Type::BYTE_ARRAY) {
+        return false;
+      }
+      testDictionary<StringView>(
+          values,
+          numValues,
+          [&](StringView value) {
+            return filter.testBytes(value.data(), value.size());
+          },
+          results);
+      return true;
+    case TypeKind::INTEGER:
+      if (type_->parquetType_ != thrift::Type::INT32) {
+        return false;
+      }
+      testDictionary<int32_t>(
+          values,
+          numValues,
+          [&](int32_t value) { return filter.testInt64(value); },
+          results);
+      return true;
+    case TypeKind::BIGINT:
+      if (type_->parquetType_ != thrift::Type::INT64) {
+        return false;
+      }
+      testDictionary<int64_t>(
+          values,
+          numValues,
+          [&](int64_t value) { return filter.testInt64(value); },
+          results);
+      return true;
+    case TypeKind::REAL:
+      if (type_->parquetType_ != thrift::Type::FLOAT) {
+        return false;
+      }
+      testDictionary<float>(
+          values,
+          numValues,
+          [&](float value) { return filter.testFloat(value); },
+          results);
+      return true;
+    case TypeKind::DOUBLE:
+      if (type_->parquetType_ != thrift::Type::DOUBLE) {
+        return false;
+      }
+      testDictionary<double>(
+          values,
+          numValues,
+          [&](double value) { return filter.testDouble(value); },
+          results);
+      return true;
+    default:
+      return false;
+  }
 }
 
 namespace {
@@ -467,33 +676,162 @@ void PageReader::makeDecoder() {
       rleDecoder_ = std::make_unique<RleDecoder<false>>(
           pageData_ + 1, pageData_ + encodedDataSize_, pageData_[0]);
       break;
+    case Encoding::DELTA_BINARY_PACKED:
+    case Encoding::DELTA_LENGTH_BYTE_ARRAY:
+    case Encoding::DELTA_BYTE_ARRAY:
+    case Encoding::BYTE_STREAM_SPLIT:
+      // The page is converted to PLAIN so that the values are read by the
+      // decoders of PLAIN, including their fast paths for filters.
+      decodeToPlain(parquetType);
+      makePlainDecoder(parquetType);
+      break;
     case Encoding::PLAIN:
-      switch (parquetType) {
-        case thrift::Type::BYTE_ARRAY:
-          stringDecoder_ = std::make_unique<StringDecoder>(
-              pageData_, pageData_ + encodedDataSize_);
-          break;
-        case thrift::Type::FIXED_LEN_BYTE_ARRAY:
-          directDecoder_ = std::make_unique<dwio::common::DirectDecoder<true>>(
-              std::make_unique<dwio::common::SeekableArrayInputStream>(
-                  pageData_, encodedDataSize_),
-              false,
-              type_->typeLength_,
-              true);
-          break;
-        default: {
-          directDecoder_ = std::make_unique<dwio::common::DirectDecoder<true>>(
-              std::make_unique<dwio::common::SeekableArrayInputStream>(
-                  pageData_, encodedDataSize_),
-              false,
-              parquetTypeBytes(type_->parquetType_.value()));
+      makePlainDecoder(parquetType);
+      break;
+    default:
+      VELOX_UNSUPPORTED("Encoding not supported yet: {}", encoding_);
+  }
+}
+
+void PageReader::makePlainDecoder(thrift::Type::type parquetType) {
+  switch (parquetType) {
+    case thrift::Type::BYTE_ARRAY:
+      stringDecoder_ = std::make_unique<StringDecoder>(
+          pageData_, pageData_ + encodedDataSize_);
+      break;
+    case thrift::Type::FIXED_LEN_BYTE_ARRAY:
+      directDecoder_ = std::make_unique<dwio::common::DirectDecoder<true>>(
+          std::make_unique<dwio::common::SeekableArrayInputStream>(
+              pageData_, encodedDataSize_),
+          false,
+          type_->typeLength_,
+          true);
+      break;
+    default: {
+      directDecoder_ = std::make_unique<dwio::common::DirectDecoder<true>>(
+          std::make_unique<dwio::common::SeekableArrayInputStream>(
+              pageData_, encodedDataSize_),
+          false,
+          parquetTypeBytes(parquetType));
+    }
+  }
+}
+
+template <typename T>
+T* PageReader::allocatePlain(int64_t size) {
+  // The padding lets the decoders of PLAIN load full words at the end.
+  dwio::common::ensureCapacity<char>(
+      decodedPage_, size + simd::kPadding, &pool_);
+  return decodedPage_->asMutable<T>();
+}
+
+void PageReader::decodeToPlain(thrift::Type::type parquetType) {
+  const char* end = pageData_ + encodedDataSize_;
+  int64_t plainSize = 0;
+  switch (encoding_) {
+    case Encoding::DELTA_BINARY_PACKED: {
+      DeltaBpDecoder decoder(pageData_, end);
+      const auto numValues = decoder.numValues();
+      if (parquetType == thrift::Type::INT32) {
+        plainSize = numValues * sizeof(int32_t);
+        decoder.readValues(allocatePlain<int32_t>(plainSize), numValues);
+      } else if (parquetType == thrift::Type::INT64) {
+        plainSize = numValues * sizeof(int64_t);
+        decoder.readValues(allocatePlain<int64_t>(plainSize), numValues);
+      } else {
+        VELOX_UNSUPPORTED(
+            "DELTA_BINARY_PACKED not supported for Parquet type {}",
+            parquetType);
+      }
+      break;
+    }
+    case Encoding::DELTA_LENGTH_BYTE_ARRAY: {
+      // The lengths are followed by the concatenated values.
+      DeltaBpDecoder lengthDecoder(pageData_, end);
+      const auto numValues = lengthDecoder.numValues();
+      lengths_.resize(numValues);
+      lengthDecoder.readValues(lengths_.data(), numValues);
+      const char* data = lengthDecoder.bufferStart();
+      plainSize = numValues * sizeof(int32_t);
+      for (auto length : lengths_) {
+        VELOX_CHECK_GE(length, 0);
+        plainSize += length;
+      }
+      VELOX_CHECK(
+          data + plainSize - numValues * sizeof(int32_t) <= end,
+          "Truncated DELTA_LENGTH_BYTE_ARRAY page");
+      auto* plain = allocatePlain<char>(plainSize);
+      for (auto length : lengths_) {
+        memcpy(plain, &length, sizeof(int32_t));
+        memcpy(plain + sizeof(int32_t), data, length);
+        plain += sizeof(int32_t) + length;
+        data += length;
+      }
+      break;
+    }
+    case Encoding::DELTA_BYTE_ARRAY: {
+      // Each value is a prefix of the previous value followed by a suffix.
+      // The prefix lengths are followed by the suffixes in the
+      // DELTA_LENGTH_BYTE_ARRAY encoding.
+      DeltaBpDecoder prefixDecoder(pageData_, end);
+      const auto numValues = prefixDecoder.numValues();
+      prefixLengths_.resize(numValues);
+      prefixDecoder.readValues(prefixLengths_.data(), numValues);
+      DeltaBpDecoder suffixDecoder(prefixDecoder.bufferStart(), end);
+      VELOX_CHECK_EQ(numValues, suffixDecoder.numValues());
+      lengths_.resize(numValues);
+      suffixDecoder.readValues(lengths_.data(), numValues);
+      const char* data = suffixDecoder.bufferStart();
+      plainSize = numValues * sizeof(int32_t);
+      int64_t suffixSize = 0;
+      for (auto i = 0; i < numValues; ++i) {
+        VELOX_CHECK(prefixLengths_[i] >= 0 && lengths_[i] >= 0);
+        plainSize += prefixLengths_[i] + lengths_[i];
+        suffixSize += lengths_[i];
+      }
+      VELOX_CHECK(data + suffixSize <= end, "Truncated DELTA_BYTE_ARRAY page");
+      auto* plain = allocatePlain<char>(plainSize);
+      const char* previous = nullptr;
+      int32_t previousLength = 0;
+      for (auto i = 0; i < numValues; ++i) {
+        const auto prefixLength = prefixLengths_[i];
+        const auto suffixLength = lengths_[i];
+        VELOX_CHECK_LE(prefixLength, previousLength);
+        const int32_t length = prefixLength + suffixLength;
+        memcpy(plain, &length, sizeof(int32_t));
+        plain += sizeof(int32_t);
+        if (prefixLength > 0) {
+          memcpy(plain, previous, prefixLength);
         }
+        memcpy(plain + prefixLength, data, suffixLength);
+        previous = plain;
+        previousLength = length;
+        plain += length;
+        data += suffixLength;
       }
       break;
-    case Encoding::DELTA_BINARY_PACKED:
+    }
+    case Encoding::BYTE_STREAM_SPLIT: {
+      // Byte 'k' of value 'i' is at 'k' * 'numValues' + 'i'.
+      const auto width = parquetType == thrift::Type::FIXED_LEN_BYTE_ARRAY
+          ? type_->typeLength_
+          : parquetTypeBytes(parquetType);
+      const auto numValues = encodedDataSize_ / width;
+      plainSize = numValues * width;
+      auto* plain = allocatePlain<char>(plainSize);
+      for (auto k = 0; k < width; ++k) {
+        const char* stream = pageData_ + k * numValues;
+        for (auto i = 0; i < numValues; ++i) {
+          plain[i * width + k] = stream[i];
+        }
+      }
+      break;
+    }
     default:
-      VELOX_UNSUPPORTED("Encoding not supported yet");
+      VELOX_UNREACHABLE();
   }
+  pageData_ = decodedPage_->as<char>();
+  encodedDataSize_ = plainSize;
 }
 
 void PageReader::skip(int64_t numRows) {
@@ -524,6 +862,11 @@ void PageReader::skip(int64_t numRows) {
 }
 
 int32_t PageReader::skipNulls(int32_t numValues) {
+  if (isNested_) {
+    // The skipped leaf positions end at 'firstUnvisited_'.
+    return bits::countBits(
+        leafNulls_.data(), firstUnvisited_ - numValues, firstUnvisited_);
+  }
   if (!defineDecoder_) {
     return numValues;
   }
@@ -548,8 +891,7 @@ void PageReader::skipNullsOnly(int64_t numRows) {
   auto toSkip = numRows;
   if (firstUnvisited_ + numRows >= rowOfPage_ + numRowsInPage_) {
     readNextPage(firstUnvisited_ + numRows);
-    firstUnvisited_ += numRows;
-    toSkip = firstUnvisited_ - rowOfPage_;
+    toSkip = firstUnvisited_ + numRows - rowOfPage_;
   }
   firstUnvisited_ += numRows;
 
@@ -580,6 +922,20 @@ void PageReader::readNullsOnly(int64_t numValues, BufferPtr& buffer) {
 
 const uint64_t* FOLLY_NULLABLE
 PageReader::readNulls(int32_t numValues, BufferPtr& buffer) {
+  if (isNested_) {
+    if (bits::isAllSet(
+            leafNulls_.data(), firstUnvisited_, firstUnvisited_ + numValues)) {
+      return nullptr;
+    }
+    dwio::common::ensureCapacity<bool>(buffer, numValues, &pool_);
+    bits::copyBits(
+        leafNulls_.data(),
+        firstUnvisited_,
+        buffer->asMutable<uint64_t>(),
+        0,
+        numValues);
+    return buffer->as<uint64_t>();
+  }
   if (!defineDecoder_) {
     buffer = nullptr;
     return nullptr;
@@ -620,7 +976,7 @@ bool PageReader::rowsForPage(
     if (scanState.dictionary.values != dictionary_.values) {
       scanState.dictionary = dictionary_;
       if (hasFilter) {
-        makeFilterCache(scanState);
+        makeFilterCache(scanState, reader.scanSpec()->filter());
       }
       scanState.updateRawState();
     }
@@ -20,6 +20,7 @@
 #include "velox/dwio/common/BitConcatenation.h"
 #include "velox/dwio/common/DirectDecoder.h"
 #include "velox/dwio/common/SelectiveColumnReader.h"
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
 #include "velox/dwio/parquet/reader/ParquetTypeWithId.h"
 #include "velox/dwio/parquet/reader/RleDecoder.h"
 #include "velox/dwio/parquet/reader/StringDecoder.h"
@@ -45,6 +46,8 @@ class PageReader {
         maxDefine_(type_->maxDefine_),
         codec_(codec),
         chunkSize_(chunkSize),
+        isNested_(maxRepeat_ > 0 || maxDefine_ > 1),
+        leafDefine_(type_->enclosingElementDefine()),
         nullConcatenation_(pool_) {}
 
   /// Advances 'numRows' top level rows.
@@ -81,6 +84,33 @@ class PageReader {
     dictionaryValues_.reset();
   }
 
+  /// True if the column is inside a list, map or optional struct. The
+  /// repetition and definition levels of the whole ColumnChunk are then
+  /// decoded on first use and the rows of 'this' are the leaf positions of
+  /// the ColumnChunk, i.e. the levels at which the innermost enclosing list
+  /// or map has an element. Without an enclosing list or map, these are the
+  /// top level rows.
+  bool isNested() const {
+    return isNested_;
+  }
+
+  /// Decodes the repetition and definition levels of all the data pages of
+  /// the ColumnChunk. Must be called before the first page is read. No-op
+  /// after the first call.
+  void preloadLevels();
+
+  /// The repetition levels of the ColumnChunk of a nested column.
+  const std::vector<int16_t>& repetitions() {
+    preloadLevels();
+    return repetitions_;
+  }
+
+  /// The definition levels of the ColumnChunk of a nested column.
+  const std::vector<int16_t>& definitions() {
+    preloadLevels();
+    return definitions_;
+  }
+
  private:
   // If the current page has nulls, returns a nulls bitmap owned by 'this'. This
   // is filled for 'numRows' bits.
@@ -91,8 +121,21 @@ class PageReader {
   // current page.
   int32_t skipNulls(int32_t numRows);
 
-  // Initializes a filter result cache for the dictionary in 'state'.
-  void makeFilterCache(dwio::common::ScanState& state);
+  // Initializes a filter result cache for the dictionary in 'state'. If
+  // 'filter' is non-null and the dictionary is small enough, evaluates
+  // 'filter' over all the dictionary entries so that rows are filtered by
+  // looking up their dictionary index.
+  void makeFilterCache(
+      dwio::common::ScanState& state,
+      const common::Filter* FOLLY_NULLABLE filter);
+
+  // Fills 'results' with the result of 'filter' for each entry of
+  // 'dictionary_'. Returns false if the entries are not of a type 'filter'
+  // can be evaluated on, in which case the results are computed on first
+  // use.
+  bool filterDictionary(
+      const common::Filter& filter,
+      uint8_t* FOLLY_NONNULL results) const;
 
   // Makes a decoder based on 'encoding_' for bytes from ''pageData_' to
   // 'pageData_' + 'encodedDataSize_'.
@@ -112,6 +155,28 @@ class PageReader {
   void prepareDictionary(const thrift::PageHeader& pageHeader);
   void makeDecoder();
 
+  // Decodes the repetition and definition levels of the data page with
+  // 'pageHeader' at 'inputStream_' and appends them to 'repetitions_' and
+  // 'definitions_'. Sets the null flags of the page's leaf positions in
+  // 'leafNulls_'.
+  void readPageLevels(const thrift::PageHeader& pageHeader);
+
+  // Returns the number of rows in the data page with 'numLevels' levels.
+  int32_t numRowsInDataPage(int32_t numLevels);
+
+  // Makes a decoder for the PLAIN encoding of 'parquetType' at 'pageData_'.
+  void makePlainDecoder(thrift::Type::type parquetType);
+
+  // Converts the DELTA_BINARY_PACKED, DELTA_LENGTH_BYTE_ARRAY,
+  // DELTA_BYTE_ARRAY or BYTE_STREAM_SPLIT encoded values at 'pageData_' to
+  // the PLAIN encoding in 'decodedPage_' and points 'pageData_' and
+  // 'encodedDataSize_' to the result.
+  void decodeToPlain(thrift::Type::type parquetType);
+
+  // Returns 'decodedPage_' with space for 'size' bytes of values.
+  template <typename T>
+  T* FOLLY_NONNULL allocatePlain(int64_t size);
+
   // Returns a pointer to contiguous space for the next 'size' bytes
   // from current position. Copies data into 'copy' if the range
   // straddles buffers. Allocates or resizes 'copy' as needed.
@@ -249,9 +314,32 @@ class PageReader {
   BufferPtr tempNulls_;
   BufferPtr nullsInReadRange_;
   BufferPtr multiPageNulls_;
-  std::unique_ptr<RleDecoder<false>> repeatDecoder_;
   std::unique_ptr<RleDecoder<false>> defineDecoder_;
 
+  // True if the levels are decoded per ColumnChunk. See isNested().
+  const bool isNested_;
+
+  // Definition level at and above which a level is a leaf position.
+  const int16_t leafDefine_;
+
+  // True after preloadLevels().
+  bool levelsLoaded_{false};
+
+  // Repetition and definition levels of the ColumnChunk if 'isNested_'.
+  std::vector<int16_t> repetitions_;
+  std::vector<int16_t> definitions_;
+
+  // Null flags of the leaf positions of the ColumnChunk if 'isNested_'.
+  std::vector<uint64_t> leafNulls_;
+  int64_t numLeaves_{0};
+
+  // Number of leaf positions in each data page of the ColumnChunk if
+  // 'isNested_'.
+  std::vector<int32_t> leavesInPage_;
+
+  // Index of the next data page in 'leavesInPage_'.
+  uint32_t dataPageIndex_{0};
+
   // Encoding of current page.
   thrift::Encoding::type encoding_;
 
@@ -271,6 +359,15 @@ class PageReader {
   // contiguous run of bytes.
   const char* FOLLY_NULLABLE pageData_{nullptr};
 
+  // The values of a page of an encoding other than PLAIN or dictionary
+  // converted to PLAIN.
+  BufferPtr decodedPage_;
+
+  // Lengths of values and of prefixes of values in DELTA_LENGTH_BYTE_ARRAY
+  // and DELTA_BYTE_ARRAY pages.
+  std::vector<int32_t> lengths_;
+  std::vector<int32_t> prefixLengths_;
+
   // Dictionary contents.
   dwio::common::DictionaryValues dictionary_;
   thrift::Encoding::type dictionaryEncoding_;
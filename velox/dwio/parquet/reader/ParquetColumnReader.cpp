@@ -22,6 +22,7 @@
 #include "velox/dwio/common/SelectiveColumnReaderInternal.h"
 #include "velox/dwio/parquet/reader/FloatingPointColumnReader.h"
 #include "velox/dwio/parquet/reader/IntegerColumnReader.h"
+#include "velox/dwio/parquet/reader/RepeatedColumnReader.h"
 #include "velox/dwio/parquet/reader/StringColumnReader.h"
 #include "velox/dwio/parquet/reader/StructColumnReader.h"
 
@@ -62,10 +63,13 @@ std::unique_ptr<dwio::common::SelectiveColumnReader> ParquetColumnReader::build(
     case TypeKind::VARCHAR:
       return std::make_unique<StringColumnReader>(dataType, params, scanSpec);
 
-    case TypeKind::BOOLEAN:
     case TypeKind::ARRAY:
+      return std::make_unique<ListColumnReader>(dataType, params, scanSpec);
+
     case TypeKind::MAP:
+      return std::make_unique<MapColumnReader>(dataType, params, scanSpec);
 
+    case TypeKind::BOOLEAN:
       VELOX_UNSUPPORTED("Type is not supported: ", dataType->type->kind());
     default:
       VELOX_FAIL(
@@ -74,4 +78,18 @@ std::unique_ptr<dwio::common::SelectiveColumnReader> ParquetColumnReader::build(
   }
 }
 
+// static
+void ParquetColumnReader::enqueueRowGroup(
+    dwio::common::SelectiveColumnReader& reader,
+    uint32_t index,
+    dwio::common::BufferedInput& input) {
+  if (auto structReader = dynamic_cast<StructColumnReader*>(&reader)) {
+    structReader->enqueueRowGroup(index, input);
+  } else if (auto repeated = dynamic_cast<RepeatedColumnReader*>(&reader)) {
+    repeated->enqueueRowGroup(index, input);
+  } else {
+    reader.formatData().as<ParquetData>().enqueueRowGroup(index, input);
+  }
+}
+
 } // namespace facebook::velox::parquet
@@ -47,5 +47,12 @@ class ParquetColumnReader {
       const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
       ParquetParams& params,
       common::ScanSpec& scanSpec);
+
+  /// Creates the streams of the leaf columns under 'reader' for 'index'th
+  /// row group in 'input'. Does not load yet.
+  static void enqueueRowGroup(
+      dwio::common::SelectiveColumnReader& reader,
+      uint32_t index,
+      dwio::common::BufferedInput& input);
 };
 } // namespace facebook::velox::parquet
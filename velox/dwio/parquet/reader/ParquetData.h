@@ -130,6 +130,13 @@ class ParquetData : public dwio::common::FormatData {
     return reader_->isDictionary();
   }
 
+  /// Returns the PageReader of the current row group. The lists and maps
+  /// enclosing a leaf column read their lengths and nulls from its levels.
+  PageReader& pageReader() {
+    VELOX_CHECK_NOT_NULL(reader_, "No row group for Parquet column");
+    return *reader_;
+  }
+
  protected:
   memory::MemoryPool& pool_;
   std::shared_ptr<const ParquetTypeWithId> type_;
@@ -16,8 +16,10 @@
 
 #include "velox/dwio/parquet/reader/ParquetReader.h"
 #include <thrift/protocol/TCompactProtocol.h> //@manual
+#include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/dwio/common/MetricsLog.h"
 #include "velox/dwio/common/TypeUtils.h"
+#include "velox/dwio/parquet/reader/Statistics.h"
 #include "velox/dwio/parquet/reader/StructColumnReader.h"
 #include "velox/dwio/parquet/thrift/ThriftTransport.h"
 
@@ -40,6 +42,9 @@ ReaderBase::ReaderBase(
 
   loadFileMetaData();
   initializeSchema();
+  // Lets the cache know how many row groups the file has for tracking the
+  // fraction of the file that is read.
+  input_->setNumStripes(fileMetaData_->row_groups.size());
 }
 
 void ReaderBase::loadFileMetaData() {
@@ -160,10 +165,16 @@ std::shared_ptr<const ParquetTypeWithId> ReaderBase::getParquetColumnInfo(
       switch (schemaElement.converted_type) {
         case thrift::ConvertedType::LIST:
         case thrift::ConvertedType::MAP: {
-          auto element = children.at(0)->getChildren();
           VELOX_CHECK_EQ(children.size(), 1);
+          auto element = children.at(0)->getChildren();
+          // The repeated group of a MAP need not be annotated as
+          // MAP_KEY_VALUE, so the map type is made from its children.
+          auto type = schemaElement.converted_type == thrift::ConvertedType::MAP
+              ? TypeFactory<TypeKind::MAP>::create(
+                    element.at(0)->type, element.at(1)->type)
+              : children[0]->type;
           return std::make_shared<const ParquetTypeWithId>(
-              children[0]->type,
+              std::move(type),
               std::move(element),
               curSchemaIdx, // TODO: there are holes in the ids
               maxSchemaElementIdx,
@@ -200,11 +211,12 @@ std::shared_ptr<const ParquetTypeWithId> ReaderBase::getParquetColumnInfo(
     } else {
       if (schemaElement.repetition_type ==
           thrift::FieldRepetitionType::REPEATED) {
-        // child of LIST: "bag"
-        assert(children.size() == 1);
+        // child of LIST: "bag". The key_value group of a MAP has 2 children.
+        auto elementType = children.size() == 1 ? children[0]->type
+                                                : createRowType(children);
         auto childrenCopy = children;
         return std::make_shared<ParquetTypeWithId>(
-            TypeFactory<TypeKind::ARRAY>::create(children[0]->type),
+            TypeFactory<TypeKind::ARRAY>::create(std::move(elementType)),
             std::move(childrenCopy),
             curSchemaIdx,
             maxSchemaElementIdx,
@@ -262,7 +274,7 @@ std::shared_ptr<const ParquetTypeWithId> ReaderBase::getParquetColumnInfo(
           std::move(children),
           curSchemaIdx,
           maxSchemaElementIdx,
-          columnIdx++,
+          ParquetTypeWithId::kNonLeaf,
           schemaElement.name,
           std::nullopt,
           maxRepeat,
@@ -441,18 +453,44 @@ void ReaderBase::scheduleRowGroups(
     newInput->load(dwio::common::LogType::STRIPE);
     inputs_[thisGroup] = std::move(newInput);
   }
-  if (nextGroup) {
+  if (nextGroup && !inputs_.count(nextGroup) &&
+      !prefetchInputs_.count(nextGroup)) {
     auto newInput =
         bufferedInputFactory_->create(*stream_, pool_, options_.getFileNum());
-    reader.enqueueRowGroup(nextGroup, *newInput);
-    newInput->load(dwio::common::LogType::STRIPE);
-    inputs_[nextGroup] = std::move(newInput);
+    auto cachedInput =
+        dynamic_cast<dwio::common::CachedBufferedInput*>(newInput.get());
+    if (cachedInput) {
+      // The input of 'nextGroup' records the references when the reader gets
+      // to the group. This one only warms the cache and is loaded only if
+      // there is memory to spare.
+      cachedInput->setTrackReferences(false);
+      reader.enqueueRowGroup(nextGroup, *newInput);
+      if (cachedInput->shouldPreload()) {
+        newInput->load(dwio::common::LogType::STRIPE);
+      }
+      prefetchInputs_[nextGroup] = std::move(newInput);
+    } else {
+      reader.enqueueRowGroup(nextGroup, *newInput);
+      newInput->load(dwio::common::LogType::STRIPE);
+      inputs_[nextGroup] = std::move(newInput);
+    }
   }
   if (currentGroup > 1) {
     inputs_.erase(rowGroupIds[currentGroup - 1]);
+    prefetchInputs_.erase(rowGroupIds[currentGroup - 1]);
   }
 }
 
+bool ReaderBase::rowGroupLoadedOrFuture(
+    uint32_t rowGroup,
+    folly::SemiFuture<bool>* future) {
+  auto it = inputs_.find(rowGroup);
+  if (it == inputs_.end()) {
+    return true;
+  }
+  return it->second->loadedOrFuture(future);
+}
+
 int64_t ReaderBase::rowGroupUncompressedSize(
     int32_t rowGroupIndex,
     const dwio::common::TypeWithId& type) const {
@@ -468,6 +506,98 @@ int64_t ReaderBase::rowGroupUncompressedSize(
   return sum;
 }
 
+bool ReaderBase::readPageIndex(
+    uint32_t rowGroup,
+    uint32_t column,
+    thrift::ColumnIndex& columnIndex,
+    thrift::OffsetIndex& offsetIndex) const {
+  const auto& chunk = fileMetaData_->row_groups[rowGroup].columns[column];
+  if (!chunk.__isset.column_index_offset ||
+      !chunk.__isset.column_index_length ||
+      !chunk.__isset.offset_index_offset ||
+      !chunk.__isset.offset_index_length) {
+    return false;
+  }
+  readThrift(
+      chunk.column_index_offset, chunk.column_index_length, columnIndex);
+  readThrift(
+      chunk.offset_index_offset, chunk.offset_index_length, offsetIndex);
+  return true;
+}
+
+template <typename T>
+void ReaderBase::readThrift(int64_t offset, int32_t length, T& result) const {
+  VELOX_CHECK_GE(offset, 0);
+  VELOX_CHECK_GT(length, 0);
+  VELOX_CHECK_LE(offset + length, fileLength_);
+  auto stream =
+      input_->read(offset, length, dwio::common::LogType::STRIPE_INDEX);
+  std::vector<char> copy(length);
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  dwio::common::readBytes(
+      length, stream.get(), copy.data(), bufferStart, bufferEnd);
+  auto thriftTransport =
+      std::make_shared<thrift::ThriftBufferedTransport>(copy.data(), length);
+  auto thriftProtocol =
+      std::make_unique<apache::thrift::protocol::TCompactProtocolT<
+          thrift::ThriftBufferedTransport>>(thriftTransport);
+  result.read(thriftProtocol.get());
+}
+
+std::unique_ptr<SplitBlockBloomFilter> ReaderBase::readBloomFilter(
+    uint32_t rowGroup,
+    uint32_t column) const {
+  // The header is a few bytes of Thrift. Its length is not recorded, so a
+  // prefix that is certain to contain it is read first.
+  constexpr int64_t kHeaderSizeGuess = 256;
+  const auto& chunk = fileMetaData_->row_groups[rowGroup].columns[column];
+  if (!chunk.__isset.meta_data ||
+      !chunk.meta_data.__isset.bloom_filter_offset) {
+    return nullptr;
+  }
+  const int64_t offset = chunk.meta_data.bloom_filter_offset;
+  VELOX_CHECK_GE(offset, 0);
+  VELOX_CHECK_LT(offset, fileLength_);
+  const int64_t readSize = std::min<int64_t>(
+      kHeaderSizeGuess, static_cast<int64_t>(fileLength_) - offset);
+  auto stream =
+      input_->read(offset, readSize, dwio::common::LogType::STRIPE_INDEX);
+  std::vector<char> copy(readSize);
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  dwio::common::readBytes(
+      readSize, stream.get(), copy.data(), bufferStart, bufferEnd);
+  auto thriftTransport =
+      std::make_shared<thrift::ThriftBufferedTransport>(copy.data(), readSize);
+  auto thriftProtocol =
+      std::make_unique<apache::thrift::protocol::TCompactProtocolT<
+          thrift::ThriftBufferedTransport>>(thriftTransport);
+  thrift::BloomFilterHeader header;
+  const int64_t headerSize = header.read(thriftProtocol.get());
+  if (!header.algorithm.__isset.BLOCK || !header.hash.__isset.XXHASH ||
+      !header.compression.__isset.UNCOMPRESSED || header.numBytes <= 0 ||
+      header.numBytes % SplitBlockBloomFilter::kBytesPerBlock != 0) {
+    return nullptr;
+  }
+  VELOX_CHECK_LE(offset + headerSize + header.numBytes, fileLength_);
+  if (headerSize + header.numBytes <= readSize) {
+    return std::make_unique<SplitBlockBloomFilter>(
+        copy.data() + headerSize, header.numBytes);
+  }
+  stream = input_->read(
+      offset + headerSize,
+      header.numBytes,
+      dwio::common::LogType::STRIPE_INDEX);
+  copy.resize(header.numBytes);
+  bufferStart = nullptr;
+  bufferEnd = nullptr;
+  dwio::common::readBytes(
+      header.numBytes, stream.get(), copy.data(), bufferStart, bufferEnd);
+  return std::make_unique<SplitBlockBloomFilter>(
+      copy.data(), header.numBytes);
+}
+
 ParquetRowReader::ParquetRowReader(
     const std::shared_ptr<ReaderBase>& readerBase,
     const dwio::common::RowReaderOptions& options)
@@ -521,7 +651,12 @@ void ParquetRowReader::filterRowGroups() {
          fileOffset < options_.getLimit());
     // A skipped row group is one that is in range and is in the excluded list.
     if (rowGroupInRange) {
-      if (columnReader_->rowGroupMatches(i)) {
+      if (columnReader_->rowGroupMatches(i) &&
+          bloomFiltersMatch(
+              i,
+              static_cast<const ParquetTypeWithId&>(
+                  *readerBase_->schemaWithId()),
+              *options_.getScanSpec())) {
         rowGroupIds_.push_back(i);
       } else {
         ++skippedRowGroups_;
@@ -530,25 +665,290 @@ void ParquetRowReader::filterRowGroups() {
   }
 }
 
+namespace {
+
+// Returns true if the values that pass 'filter' can be looked up in a Bloom
+// filter of a column of 'physicalType' read as 'kind'.
+bool canUseBloomFilter(
+    const common::Filter& filter,
+    TypeKind kind,
+    thrift::Type::type physicalType) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+      if (physicalType != thrift::Type::INT32) {
+        return false;
+      }
+      break;
+    case TypeKind::BIGINT:
+      if (physicalType != thrift::Type::INT64) {
+        return false;
+      }
+      break;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      if (physicalType != thrift::Type::BYTE_ARRAY) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+  }
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return static_cast<const common::BigintRange&>(filter).isSingleValue();
+    case common::FilterKind::kBytesRange:
+      return static_cast<const common::BytesRange&>(filter).isSingleValue();
+    case common::FilterKind::kBigintValuesUsingHashTable:
+    case common::FilterKind::kBigintValuesUsingBitmask:
+    case common::FilterKind::kBytesValues:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns false if none of the values that pass 'filter' is in
+// 'bloomFilter'. 'filter' is one for which canUseBloomFilter() is true.
+bool testBloomFilter(
+    const common::Filter& filter,
+    thrift::Type::type physicalType,
+    const SplitBlockBloomFilter& bloomFilter) {
+  auto testLong = [&](int64_t value) {
+    if (physicalType == thrift::Type::INT64) {
+      return bloomFilter.testInt64(value);
+    }
+    // A value outside of the range of INT32 can't be in the column.
+    return value >= std::numeric_limits<int32_t>::min() &&
+        value <= std::numeric_limits<int32_t>::max() &&
+        bloomFilter.testInt32(value);
+  };
+  auto testLongs = [&](const std::vector<int64_t>& values) {
+    return std::any_of(values.begin(), values.end(), testLong);
+  };
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return testLong(static_cast<const common::BigintRange&>(filter).lower());
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      return testLongs(
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values());
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      return testLongs(
+          static_cast<const common::BigintValuesUsingBitmask&>(filter)
+              .values());
+    case common::FilterKind::kBytesRange:
+      return bloomFilter.testBytes(
+          static_cast<const common::BytesRange&>(filter).lower());
+    case common::FilterKind::kBytesValues: {
+      const auto& values =
+          static_cast<const common::BytesValues&>(filter).values();
+      return std::any_of(
+          values.begin(), values.end(), [&](const std::string& value) {
+            return bloomFilter.testBytes(value);
+          });
+    }
+    default:
+      return true;
+  }
+}
+
+} // namespace
+
+bool ParquetRowReader::bloomFiltersMatch(
+    uint32_t rowGroup,
+    const ParquetTypeWithId& type,
+    const common::ScanSpec& spec) {
+  if (type.type->kind() == TypeKind::ROW) {
+    for (auto& childSpec : spec.children()) {
+      if (childSpec->isConstant() ||
+          !type.type->asRow().containsChild(childSpec->fieldName())) {
+        continue;
+      }
+      if (!bloomFiltersMatch(
+              rowGroup,
+              static_cast<const ParquetTypeWithId&>(
+                  *type.childByName(childSpec->fieldName())),
+              *childSpec)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  auto filter = spec.filter();
+  if (!filter || type.column == ParquetTypeWithId::kNonLeaf ||
+      type.maxRepeat_ > 0) {
+    return true;
+  }
+  const auto& metaData = rowGroups_[rowGroup].columns[type.column].meta_data;
+  if (!canUseBloomFilter(*filter, type.type->kind(), metaData.type)) {
+    return true;
+  }
+  // The Bloom filter has only the non-null values.
+  if (filter->testNull() &&
+      (!metaData.__isset.statistics ||
+       !metaData.statistics.__isset.null_count ||
+       metaData.statistics.null_count > 0)) {
+    return true;
+  }
+  auto bloomFilter = readerBase_->readBloomFilter(rowGroup, type.column);
+  return !bloomFilter || testBloomFilter(*filter, metaData.type, *bloomFilter);
+}
+
+void ParquetRowReader::filterPages(uint32_t rowGroup) {
+  skippedRanges_.clear();
+  nextSkippedRange_ = 0;
+  filterPages(
+      rowGroup,
+      static_cast<const ParquetTypeWithId&>(*readerBase_->schemaWithId()),
+      *options_.getScanSpec());
+  if (skippedRanges_.empty()) {
+    return;
+  }
+  // The ranges of different columns may overlap. Merges them so that each
+  // row is skipped once.
+  std::sort(skippedRanges_.begin(), skippedRanges_.end());
+  int32_t numMerged = 0;
+  for (auto i = 1; i < skippedRanges_.size(); ++i) {
+    auto& last = skippedRanges_[numMerged];
+    if (skippedRanges_[i].first <= last.second) {
+      last.second = std::max(last.second, skippedRanges_[i].second);
+    } else {
+      skippedRanges_[++numMerged] = skippedRanges_[i];
+    }
+  }
+  skippedRanges_.resize(numMerged + 1);
+}
+
+void ParquetRowReader::filterPages(
+    uint32_t rowGroup,
+    const ParquetTypeWithId& type,
+    const common::ScanSpec& spec) {
+  if (type.type->kind() == TypeKind::ROW) {
+    // The pages of repeated columns do not start at top level row boundaries.
+    // Recurses only through structs.
+    for (auto& childSpec : spec.children()) {
+      if (childSpec->isConstant() ||
+          !type.type->asRow().containsChild(childSpec->fieldName())) {
+        continue;
+      }
+      filterPages(
+          rowGroup,
+          static_cast<const ParquetTypeWithId&>(
+              *type.childByName(childSpec->fieldName())),
+          *childSpec);
+    }
+    return;
+  }
+  auto filter = spec.filter();
+  if (!filter || type.column == ParquetTypeWithId::kNonLeaf ||
+      type.maxRepeat_ > 0) {
+    return;
+  }
+  thrift::ColumnIndex columnIndex;
+  thrift::OffsetIndex offsetIndex;
+  if (!readerBase_->readPageIndex(
+          rowGroup, type.column, columnIndex, offsetIndex)) {
+    return;
+  }
+  const auto& pages = offsetIndex.page_locations;
+  const auto numPages = pages.size();
+  if (columnIndex.null_pages.size() != numPages ||
+      columnIndex.min_values.size() != numPages ||
+      columnIndex.max_values.size() != numPages) {
+    return;
+  }
+  const auto numRows = rowGroups_[rowGroup].num_rows;
+  for (auto i = 0; i < numPages; ++i) {
+    const uint64_t firstRow = pages[i].first_row_index;
+    const uint64_t endRow =
+        i + 1 < numPages ? pages[i + 1].first_row_index : numRows;
+    if (endRow <= firstRow) {
+      continue;
+    }
+    thrift::Statistics pageStats;
+    if (columnIndex.null_pages[i]) {
+      pageStats.__set_null_count(endRow - firstRow);
+    } else {
+      pageStats.__set_min_value(columnIndex.min_values[i]);
+      pageStats.__set_max_value(columnIndex.max_values[i]);
+      if (columnIndex.__isset.null_counts &&
+          columnIndex.null_counts.size() == numPages) {
+        pageStats.__set_null_count(columnIndex.null_counts[i]);
+      }
+    }
+    auto columnStats = buildColumnStatisticsFromThrift(
+        pageStats, *type.type, endRow - firstRow);
+    if (!testFilter(filter, columnStats.get(), endRow - firstRow, type.type)) {
+      skippedRanges_.emplace_back(firstRow, endRow);
+      ++skippedPages_;
+    }
+  }
+}
+
+uint64_t ParquetRowReader::skipFilteredRows() {
+  if (nextSkippedRange_ >= skippedRanges_.size() ||
+      skippedRanges_[nextSkippedRange_].first > currentRowInGroup_) {
+    return 0;
+  }
+  const auto numRows =
+      skippedRanges_[nextSkippedRange_].second - currentRowInGroup_;
+  ++nextSkippedRange_;
+  // Only moves the position of the root reader. The column readers seek to
+  // the read offset of the root, skipping the pages in between by their
+  // headers, when they are next read.
+  columnReader_->setReadOffset(columnReader_->readOffset() + numRows);
+  currentRowInGroup_ += numRows;
+  return numRows;
+}
+
 uint64_t ParquetRowReader::next(uint64_t size, velox::VectorPtr& result) {
   VELOX_CHECK_GT(size, 0);
 
-  if (currentRowInGroup_ >= rowsInCurrentRowGroup_) {
-    // attempt to advance to next row group
-    if (!advanceToNextRowGroup()) {
-      return 0;
+  uint64_t rowsSkipped = 0;
+  for (;;) {
+    if (currentRowInGroup_ >= rowsInCurrentRowGroup_) {
+      // attempt to advance to next row group
+      if (!advanceToNextRowGroup()) {
+        // 'result' is not set if all the remaining rows were skipped.
+        return 0;
+      }
+    }
+    auto numSkipped = skipFilteredRows();
+    if (numSkipped == 0) {
+      break;
     }
+    rowsSkipped += numSkipped;
   }
 
   uint64_t rowsToRead = std::min(
       static_cast<uint64_t>(size), rowsInCurrentRowGroup_ - currentRowInGroup_);
+  if (nextSkippedRange_ < skippedRanges_.size()) {
+    rowsToRead = std::min<uint64_t>(
+        rowsToRead,
+        skippedRanges_[nextSkippedRange_].first - currentRowInGroup_);
+  }
 
   if (rowsToRead > 0) {
     columnReader_->next(rowsToRead, result, nullptr);
     currentRowInGroup_ += rowsToRead;
   }
 
-  return rowsToRead;
+  return rowsSkipped + rowsToRead;
+}
+
+bool ParquetRowReader::prepareNext(folly::SemiFuture<bool>* future) {
+  if (currentRowInGroup_ < rowsInCurrentRowGroup_ ||
+      currentRowGroupIdsIdx_ == rowGroupIds_.size()) {
+    return true;
+  }
+  readerBase_->scheduleRowGroups(
+      rowGroupIds_,
+      currentRowGroupIdsIdx_,
+      *reinterpret_cast<StructColumnReader*>(columnReader_.get()));
+  return readerBase_->rowGroupLoadedOrFuture(
+      rowGroupIds_[currentRowGroupIdsIdx_], future);
 }
 
 bool ParquetRowReader::advanceToNextRowGroup() {
@@ -566,12 +966,14 @@ bool ParquetRowReader::advanceToNextRowGroup() {
   currentRowInGroup_ = 0;
   currentRowGroupIdsIdx_++;
   columnReader_->seekToRowGroup(nextRowGroupIndex);
+  filterPages(nextRowGroupIndex);
   return true;
 }
 
 void ParquetRowReader::updateRuntimeStats(
     dwio::common::RuntimeStatistics& stats) const {
   stats.skippedStrides += skippedRowGroups_;
+  stats.skippedPages += skippedPages_;
 }
 
 void ParquetRowReader::resetFilterCaches() {
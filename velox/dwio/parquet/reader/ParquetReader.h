@@ -20,6 +20,7 @@
 #include "velox/dwio/common/Reader.h"
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/dwio/common/SelectiveColumnReader.h"
+#include "velox/dwio/parquet/reader/BloomFilter.h"
 #include "velox/dwio/parquet/reader/ParquetTypeWithId.h"
 #include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
 
@@ -80,6 +81,13 @@ class ReaderBase {
       int32_t currentGroup,
       StructColumnReader& reader);
 
+  /// Returns true if the data of 'rowGroup' scheduled by scheduleRowGroups()
+  /// can be read without waiting for IO. Otherwise returns false and sets
+  /// 'future' to be realized when the IO is done.
+  bool rowGroupLoadedOrFuture(
+      uint32_t rowGroup,
+      folly::SemiFuture<bool>* FOLLY_NONNULL future);
+
   /// Returns the uncompressed size for columns in 'type' and its children in
   /// row
   /// group.
@@ -87,7 +95,27 @@ class ReaderBase {
       int32_t rowGroupIndex,
       const dwio::common::TypeWithId& type) const;
 
+  /// Reads the ColumnIndex and OffsetIndex of the ColumnChunk of 'column' in
+  /// 'rowGroup'. Returns false if the file has no page index for the
+  /// ColumnChunk.
+  bool readPageIndex(
+      uint32_t rowGroup,
+      uint32_t column,
+      thrift::ColumnIndex& columnIndex,
+      thrift::OffsetIndex& offsetIndex) const;
+
+  /// Reads the split block Bloom filter of the ColumnChunk of 'column' in
+  /// 'rowGroup'. Returns nullptr if the ColumnChunk has no Bloom filter or
+  /// the filter uses an unsupported algorithm, hash or compression.
+  std::unique_ptr<SplitBlockBloomFilter> readBloomFilter(
+      uint32_t rowGroup,
+      uint32_t column) const;
+
  private:
+  // Reads the Thrift struct of 'length' bytes at 'offset' into 'result'.
+  template <typename T>
+  void readThrift(int64_t offset, int32_t length, T& result) const;
+
   // Reads and parses file footer.
   void loadFileMetaData();
 
@@ -121,6 +149,12 @@ class ReaderBase {
   // Map from row group index to pre-created loading BufferedInput.
   std::unordered_map<uint32_t, std::unique_ptr<dwio::common::BufferedInput>>
       inputs_;
+
+  // Map from row group index to a BufferedInput that loads the row group
+  // into the cache ahead of the reader without recording references.
+  // Used when the inputs are CachedBufferedInputs.
+  std::unordered_map<uint32_t, std::unique_ptr<dwio::common::BufferedInput>>
+      prefetchInputs_;
 };
 
 /// Implements the RowReader interface for Parquet.
@@ -133,6 +167,8 @@ class ParquetRowReader : public dwio::common::RowReader {
 
   uint64_t next(uint64_t size, velox::VectorPtr& result) override;
 
+  bool prepareNext(folly::SemiFuture<bool>* FOLLY_NONNULL future) override;
+
   void updateRuntimeStats(
       dwio::common::RuntimeStatistics& stats) const override;
 
@@ -153,6 +189,29 @@ class ParquetRowReader : public dwio::common::RowReader {
   // by filterRowGroups().
   bool advanceToNextRowGroup();
 
+  // Compares the page index of the columns with filters in 'rowGroup' to the
+  // filters and sets 'skippedRanges_' to the row ranges no row of which can
+  // pass the filters.
+  void filterPages(uint32_t rowGroup);
+
+  // Adds the row ranges of the pages of the leaf columns under 'type' whose
+  // statistics fail the filters in 'spec' to 'skippedRanges_'.
+  void filterPages(
+      uint32_t rowGroup,
+      const ParquetTypeWithId& type,
+      const common::ScanSpec& spec);
+
+  // Returns false if the Bloom filter of a column with an equality or IN
+  // filter in 'spec' shows that no row of 'rowGroup' can pass the filter.
+  bool bloomFiltersMatch(
+      uint32_t rowGroup,
+      const ParquetTypeWithId& type,
+      const common::ScanSpec& spec);
+
+  // Skips the rows of the range in 'skippedRanges_' that starts at
+  // 'currentRowInGroup_', if any. Returns the number of rows skipped.
+  uint64_t skipFilteredRows();
+
   memory::MemoryPool& pool_;
   const std::shared_ptr<ReaderBase> readerBase_;
   const dwio::common::RowReaderOptions& options_;
@@ -170,6 +229,15 @@ class ParquetRowReader : public dwio::common::RowReader {
   // Number of row groups skipped based on stats.
   int32_t skippedRowGroups_{0};
 
+  // Sorted, disjoint [begin, end) ranges of rows of the current row group
+  // that are skipped based on the page index.
+  std::vector<std::pair<uint64_t, uint64_t>> skippedRanges_;
+  // Index of the first range in 'skippedRanges_' after 'currentRowInGroup_'.
+  int32_t nextSkippedRange_{0};
+
+  // Number of pages skipped based on the page index.
+  int64_t skippedPages_{0};
+
   std::unique_ptr<dwio::common::SelectiveColumnReader> columnReader_;
 
   RowTypePtr requestedType_;
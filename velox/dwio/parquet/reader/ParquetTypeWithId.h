@@ -58,6 +58,37 @@ class ParquetTypeWithId : public dwio::common::TypeWithId {
     return *reinterpret_cast<const ParquetTypeWithId*>(childAt(index).get());
   }
 
+  /// Repetition level of the elements of a list or map node.
+  uint32_t elementRepeat() const {
+    return parquetChildAt(0).maxRepeat_;
+  }
+
+  /// Definition level at and above which a list or map node has an
+  /// element. A 3-level LIST or MAP has the levels of its outer group and its
+  /// children have one more repetition and definition level. A repeated
+  /// field that is not in a LIST or MAP has the levels of its elements.
+  uint32_t elementDefine() const {
+    return elementRepeat() > maxRepeat_ ? maxDefine_ + 1 : maxDefine_;
+  }
+
+  /// Definition level at and above which a list or map node is not null. A
+  /// bare repeated field is never null, only empty.
+  uint32_t nonNullDefine() const {
+    return elementRepeat() > maxRepeat_ ? maxDefine_ : 0;
+  }
+
+  /// Definition level at and above which the innermost list or map enclosing
+  /// 'this' has an element. 0 if 'this' is not inside a list or map.
+  uint32_t enclosingElementDefine() const {
+    for (auto* node = parent; node; node = node->parent) {
+      auto kind = node->type->kind();
+      if (kind == TypeKind::ARRAY || kind == TypeKind::MAP) {
+        return static_cast<const ParquetTypeWithId*>(node)->elementDefine();
+      }
+    }
+    return 0;
+  }
+
   const std::string name_;
   const std::optional<thrift::Type::type> parquetType_;
   const uint32_t maxRepeat_;
@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/RepeatedColumnReader.h"
+#include "velox/dwio/common/BufferUtil.h"
+#include "velox/dwio/parquet/reader/StructColumnReader.h"
+
+namespace facebook::velox::parquet {
+
+namespace {
+const ParquetTypeWithId& parquetType(
+    const std::shared_ptr<const dwio::common::TypeWithId>& type) {
+  return static_cast<const ParquetTypeWithId&>(*type);
+}
+
+// Returns a leaf column reader under 'reader' or 'reader' itself if a leaf.
+dwio::common::SelectiveColumnReader& leafOf(
+    dwio::common::SelectiveColumnReader& reader) {
+  if (auto* repeated = dynamic_cast<RepeatedColumnReader*>(&reader)) {
+    return repeated->leaf();
+  }
+  if (auto* structReader = dynamic_cast<StructColumnReader*>(&reader)) {
+    auto& children = structReader->children();
+    VELOX_CHECK(
+        !children.empty(),
+        "A struct in a Parquet list or map must have a column to read");
+    return leafOf(*children[0]);
+  }
+  return reader;
+}
+} // namespace
+
+RepeatedColumnReader::RepeatedColumnReader(
+    const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+    ParquetParams& params,
+    common::ScanSpec& scanSpec)
+    : SelectiveColumnReader(dataType, params, scanSpec, dataType->type),
+      elementRepeat_(parquetType(dataType).elementRepeat()),
+      elementDefine_(parquetType(dataType).elementDefine()),
+      nonNullDefine_(parquetType(dataType).nonNullDefine()),
+      enclosingDefine_(parquetType(dataType).enclosingElementDefine()) {}
+
+void RepeatedColumnReader::makeChildren(ParquetParams& params) {
+  auto& childSpecs = scanSpec_->children();
+  for (auto i = 0; i < childSpecs.size(); ++i) {
+    childSpecs[i]->setProjectOut(true);
+    childSpecs[i]->setExtractValues(true);
+    children_.push_back(ParquetColumnReader::build(
+        nodeType_->childAt(i), params, *childSpecs[i]));
+  }
+  leaf_ = &leafOf(*children_[0]);
+}
+
+void RepeatedColumnReader::enqueueRowGroup(
+    uint32_t index,
+    dwio::common::BufferedInput& input) {
+  for (auto& child : children_) {
+    ParquetColumnReader::enqueueRowGroup(*child, index, input);
+  }
+}
+
+void RepeatedColumnReader::seekToRowGroup(uint32_t index) {
+  SelectiveColumnReader::seekToRowGroup(index);
+  readOffset_ = 0;
+  for (auto& child : children_) {
+    child->seekToRowGroup(index);
+    child->setReadOffsetRecursive(0);
+  }
+  childTargetReadOffset_ = 0;
+  levels_ = &leaf_->formatData().as<ParquetData>().pageReader();
+  levelIndex_ = 0;
+}
+
+int64_t RepeatedColumnReader::readLengths(
+    int32_t numRows,
+    vector_size_t* lengths,
+    uint64_t* nulls) {
+  const auto* repetitions = levels_->repetitions().data();
+  const auto* definitions = levels_->definitions().data();
+  const int64_t numLevels = levels_->repetitions().size();
+  int64_t numElements = 0;
+  int32_t row = -1;
+  auto i = levelIndex_;
+  for (; i < numLevels; ++i) {
+    const auto repeat = repetitions[i];
+    const auto define = definitions[i];
+    if (repeat < elementRepeat_) {
+      if (define < enclosingDefine_) {
+        // The enclosing list or map has no element here.
+        continue;
+      }
+      if (row + 1 == numRows) {
+        break;
+      }
+      ++row;
+      const int32_t length = define >= elementDefine_;
+      if (lengths) {
+        lengths[row] = length;
+      }
+      if (nulls && define < nonNullDefine_) {
+        bits::setNull(nulls, row);
+      }
+      numElements += length;
+    } else if (repeat == elementRepeat_) {
+      // Levels with a higher repetition are inside the elements.
+      if (lengths) {
+        ++lengths[row];
+      }
+      ++numElements;
+    }
+  }
+  VELOX_CHECK_EQ(row + 1, numRows, "Too few levels for Parquet list or map");
+  levelIndex_ = i;
+  return numElements;
+}
+
+uint64_t RepeatedColumnReader::skip(uint64_t numValues) {
+  // The children are positioned at 'childTargetReadOffset_' at the next
+  // read.
+  childTargetReadOffset_ += readLengths(numValues, nullptr, nullptr);
+  return numValues;
+}
+
+void RepeatedColumnReader::makeNestedRowSet(RowSet rows) {
+  const auto numRows = rows.back() + 1;
+  allLengths_.resize(numRows);
+  dwio::common::ensureCapacity<bool>(lengthNulls_, numRows, &memoryPool_);
+  auto* nulls = lengthNulls_->asMutable<uint64_t>();
+  bits::fillBits(nulls, 0, numRows, bits::kNotNull);
+  readLengths(numRows, allLengths_.data(), nulls);
+  if (bits::isAllSet(nulls, 0, numRows, bits::kNotNull)) {
+    nulls = nullptr;
+  } else {
+    nullsInReadRange_ = lengthNulls_;
+    allNull_ = bits::isAllSet(nulls, 0, numRows, bits::kNull);
+    prepareNulls(rows, true);
+  }
+  dwio::common::ensureCapacity<vector_size_t>(
+      offsets_, rows.size(), &memoryPool_);
+  dwio::common::ensureCapacity<vector_size_t>(
+      sizes_, rows.size(), &memoryPool_);
+  auto rawOffsets = offsets_->asMutable<vector_size_t>();
+  auto rawSizes = sizes_->asMutable<vector_size_t>();
+  vector_size_t nestedLength = 0;
+  for (auto row : rows) {
+    nestedLength += allLengths_[row];
+  }
+  nestedRows_.resize(nestedLength);
+  vector_size_t currentRow = 0;
+  vector_size_t nestedRow = 0;
+  vector_size_t nestedOffset = 0;
+  for (auto rowIndex = 0; rowIndex < rows.size(); ++rowIndex) {
+    auto row = rows[rowIndex];
+    // Add up the lengths of the rows skipped since the last row. The
+    // lengths of nulls are 0.
+    for (auto i = currentRow; i < row; ++i) {
+      nestedOffset += allLengths_[i];
+    }
+    currentRow = row + 1;
+    if (nulls && bits::isBitNull(nulls, row)) {
+      rawOffsets[rowIndex] = 0;
+      rawSizes[rowIndex] = 0;
+      bits::setNull(rawResultNulls_, rowIndex);
+      anyNulls_ = true;
+      continue;
+    }
+
+    auto lengthAtRow = allLengths_[row];
+    std::iota(
+        &nestedRows_[nestedRow],
+        &nestedRows_[nestedRow + lengthAtRow],
+        nestedOffset);
+    rawOffsets[rowIndex] = nestedRow;
+    rawSizes[rowIndex] = lengthAtRow;
+    nestedRow += lengthAtRow;
+    nestedOffset += lengthAtRow;
+  }
+  childTargetReadOffset_ += nestedOffset;
+}
+
+void RepeatedColumnReader::compactOffsets(RowSet rows) {
+  auto rawOffsets = offsets_->asMutable<vector_size_t>();
+  auto rawSizes = sizes_->asMutable<vector_size_t>();
+  VELOX_CHECK(outputRows_.empty(), "Repeated reader does not support filters");
+  RowSet rowsToCompact;
+  if (valueRows_.empty()) {
+    valueRows_.resize(rows.size());
+    rowsToCompact = inputRows_;
+  } else {
+    rowsToCompact = valueRows_;
+  }
+  if (rows.size() == rowsToCompact.size()) {
+    return;
+  }
+
+  int32_t current = 0;
+  bool moveNulls = shouldMoveNulls(rows);
+  for (int i = 0; i < rows.size(); ++i) {
+    auto row = rows[i];
+    while (rowsToCompact[current] < row) {
+      ++current;
+    }
+    VELOX_CHECK(rowsToCompact[current] == row);
+    valueRows_[i] = row;
+    rawOffsets[i] = rawOffsets[current];
+    rawSizes[i] = rawSizes[current];
+    if (moveNulls && i != current) {
+      bits::setBit(
+          rawResultNulls_, i, bits::isBitSet(rawResultNulls_, current));
+    }
+  }
+  numValues_ = rows.size();
+  valueRows_.resize(numValues_);
+  offsets_->setSize(numValues_ * sizeof(vector_size_t));
+  sizes_->setSize(numValues_ * sizeof(vector_size_t));
+}
+
+ListColumnReader::ListColumnReader(
+    const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+    ParquetParams& params,
+    common::ScanSpec& scanSpec)
+    : RepeatedColumnReader(dataType, params, scanSpec) {
+  if (scanSpec_->children().empty()) {
+    scanSpec_->getOrCreateChild(common::Subfield("elements"));
+  }
+  makeChildren(params);
+}
+
+void ListColumnReader::read(
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* incomingNulls) {
+  prepareRead<char>(offset, rows, incomingNulls);
+  auto& child = children_[0];
+  // Catch up if the child is behind the levels.
+  child->seekTo(childTargetReadOffset_, false);
+  makeNestedRowSet(rows);
+  if (!nestedRows_.empty()) {
+    child->read(child->readOffset(), nestedRows_, nullptr);
+  }
+  numValues_ = rows.size();
+  readOffset_ = offset + rows.back() + 1;
+}
+
+void ListColumnReader::getValues(RowSet rows, VectorPtr* result) {
+  compactOffsets(rows);
+  VectorPtr elements;
+  if (!nestedRows_.empty()) {
+    prepareStructResult(type_->childAt(0), &elements);
+    children_[0]->getValues(nestedRows_, &elements);
+  }
+  *result = std::make_shared<ArrayVector>(
+      &memoryPool_,
+      nodeType_->type,
+      anyNulls_ ? resultNulls_ : nullptr,
+      rows.size(),
+      offsets_,
+      sizes_,
+      elements);
+}
+
+MapColumnReader::MapColumnReader(
+    const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+    ParquetParams& params,
+    common::ScanSpec& scanSpec)
+    : RepeatedColumnReader(dataType, params, scanSpec) {
+  if (scanSpec_->children().empty()) {
+    scanSpec_->getOrCreateChild(common::Subfield("keys"));
+    scanSpec_->getOrCreateChild(common::Subfield("elements"));
+  }
+  VELOX_CHECK_EQ(
+      scanSpec_->children().size(), 2, "A map must read keys and values");
+  makeChildren(params);
+}
+
+void MapColumnReader::read(
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* incomingNulls) {
+  prepareRead<char>(offset, rows, incomingNulls);
+  // Catch up if the children are behind the levels.
+  for (auto& child : children_) {
+    child->seekTo(childTargetReadOffset_, false);
+  }
+  makeNestedRowSet(rows);
+  if (!nestedRows_.empty()) {
+    for (auto& child : children_) {
+      child->read(child->readOffset(), nestedRows_, nullptr);
+    }
+  }
+  numValues_ = rows.size();
+  readOffset_ = offset + rows.back() + 1;
+}
+
+void MapColumnReader::getValues(RowSet rows, VectorPtr* result) {
+  compactOffsets(rows);
+  VectorPtr keys;
+  VectorPtr values;
+  if (!nestedRows_.empty()) {
+    children_[0]->getValues(nestedRows_, &keys);
+    prepareStructResult(type_->childAt(1), &values);
+    children_[1]->getValues(nestedRows_, &values);
+  }
+  *result = std::make_shared<MapVector>(
+      &memoryPool_,
+      nodeType_->type,
+      anyNulls_ ? resultNulls_ : nullptr,
+      rows.size(),
+      offsets_,
+      sizes_,
+      keys,
+      values);
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/SelectiveColumnReaderInternal.h"
+#include "velox/dwio/parquet/reader/ParquetColumnReader.h"
+
+namespace facebook::velox::parquet {
+
+/// Abstract superclass of the Parquet list and map readers. Parquet has no
+/// length stream, so the lengths and null flags of the lists or maps are
+/// decoded from the repetition and definition levels of a leaf column under
+/// 'this'. The rows of the leaf and struct readers under a list or map are
+/// the elements of the list or map across the row group, like in
+/// dwrf::SelectiveRepeatedColumnReader.
+class RepeatedColumnReader : public dwio::common::SelectiveColumnReader {
+ public:
+  bool useBulkPath() const override {
+    return false;
+  }
+
+  void resetFilterCaches() override {
+    for (auto& child : children_) {
+      child->resetFilterCaches();
+    }
+  }
+
+  /// Creates the streams of the leaf columns under 'this' for 'index'th row
+  /// group. Does not load yet.
+  void enqueueRowGroup(uint32_t index, dwio::common::BufferedInput& input);
+
+  void seekToRowGroup(uint32_t index) override;
+
+  uint64_t skip(uint64_t numValues) override;
+
+  /// Returns the leaf column reader whose levels give the lengths and nulls
+  /// of 'this'. Any leaf under 'this' has the same levels up to the levels
+  /// of 'this'.
+  dwio::common::SelectiveColumnReader& leaf() const {
+    return *leaf_;
+  }
+
+ protected:
+  RepeatedColumnReader(
+      const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+      ParquetParams& params,
+      common::ScanSpec& scanSpec);
+
+  // Builds the readers of the children of 'nodeType_' for the children of
+  // 'scanSpec_'.
+  void makeChildren(ParquetParams& params);
+
+  // Reads the lengths and nulls of 'rows' from the levels and sets
+  // 'nestedRows_', 'offsets_' and 'sizes_' to the elements of the non-null
+  // lists or maps in 'rows'.
+  void makeNestedRowSet(RowSet rows);
+
+  // Reads the lengths of the next 'numRows' lists or maps from the levels
+  // into 'lengths' and sets the bit of each null one in 'nulls'. The lengths
+  // of nulls are 0. 'lengths' and 'nulls' are not set if nullptr. Returns
+  // the total number of elements.
+  int64_t readLengths(
+      int32_t numRows,
+      vector_size_t* FOLLY_NULLABLE lengths,
+      uint64_t* FOLLY_NULLABLE nulls);
+
+  void compactOffsets(RowSet rows);
+
+  // Creates a struct if '*result' is empty and 'type' is a row.
+  void prepareStructResult(const TypePtr& type, VectorPtr* result) {
+    if (!*result && type->kind() == TypeKind::ROW) {
+      *result = BaseVector::create(type, 0, &memoryPool_);
+    }
+  }
+
+  // Repetition level of the elements of 'this'.
+  const int16_t elementRepeat_;
+  // Definition level at and above which a list or map has an element.
+  const int16_t elementDefine_;
+  // Definition level at and above which a list or map is not null.
+  const int16_t nonNullDefine_;
+  // Definition level below which a level is not a position of 'this'
+  // because the enclosing list or map has no element there.
+  const int16_t enclosingDefine_;
+
+  // The element reader of a list or the key and value readers of a map.
+  std::vector<std::unique_ptr<dwio::common::SelectiveColumnReader>> children_;
+  dwio::common::SelectiveColumnReader* FOLLY_NULLABLE leaf_{nullptr};
+
+  // The PageReader of 'leaf_' for the current row group.
+  PageReader* FOLLY_NULLABLE levels_{nullptr};
+  // Index in the levels of 'levels_' of the first level after the lists or
+  // maps read so far.
+  int64_t levelIndex_{0};
+
+  std::vector<vector_size_t> allLengths_;
+  BufferPtr lengthNulls_;
+  raw_vector<vector_size_t> nestedRows_;
+  BufferPtr offsets_;
+  BufferPtr sizes_;
+  // The position in the child readers that corresponds to the
+  // position in the levels. The child readers can be behind if
+  // the last parents were null, so that the children were only
+  // read up to the last position corresponding to the last non-null
+  // parent.
+  vector_size_t childTargetReadOffset_ = 0;
+};
+
+class ListColumnReader : public RepeatedColumnReader {
+ public:
+  ListColumnReader(
+      const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+      ParquetParams& params,
+      common::ScanSpec& scanSpec);
+
+  void read(vector_size_t offset, RowSet rows, const uint64_t* incomingNulls)
+      override;
+
+  void getValues(RowSet rows, VectorPtr* result) override;
+};
+
+class MapColumnReader : public RepeatedColumnReader {
+ public:
+  MapColumnReader(
+      const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+      ParquetParams& params,
+      common::ScanSpec& scanSpec);
+
+  void read(vector_size_t offset, RowSet rows, const uint64_t* incomingNulls)
+      override;
+
+  void getValues(RowSet rows, VectorPtr* result) override;
+};
+
+} // namespace facebook::velox::parquet
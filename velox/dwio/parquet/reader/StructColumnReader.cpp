@@ -44,11 +44,7 @@ void StructColumnReader::enqueueRowGroup(
     uint32_t index,
     dwio::common::BufferedInput& input) {
   for (auto& child : children_) {
-    if (auto structChild = dynamic_cast<StructColumnReader*>(child.get())) {
-      structChild->enqueueRowGroup(index, input);
-    } else {
-      child->formatData().as<ParquetData>().enqueueRowGroup(index, input);
-    }
+    ParquetColumnReader::enqueueRowGroup(*child, index, input);
   }
 }
 
@@ -33,6 +33,11 @@ class StructColumnReader : public dwio::common::SelectiveStructColumnReader {
   /// Creates the streams for 'rowGroup in 'input'. Does not load yet.
   void enqueueRowGroup(uint32_t index, dwio::common::BufferedInput& input);
 
+  const std::vector<std::unique_ptr<dwio::common::SelectiveColumnReader>>&
+  children() const {
+    return children_;
+  }
+
   // No-op in Parquet. All readers switch row groups at the same time, there is
   // no on-demand skipping to a new row group.
   void advanceFieldReader(
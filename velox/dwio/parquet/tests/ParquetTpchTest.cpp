@@ -29,11 +29,20 @@ TEST_P(MultiParquetTpchTest, Q1) {
   assertQuery(1);
 }
 
+TEST_P(MultiParquetTpchTest, Q2) {
+  assertQuery(2);
+}
+
 TEST_P(MultiParquetTpchTest, Q3) {
   std::vector<uint32_t> sortingKeys{1, 2};
   assertQuery(3, std::move(sortingKeys));
 }
 
+TEST_P(MultiParquetTpchTest, Q4) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(4, std::move(sortingKeys));
+}
+
 TEST_P(MultiParquetTpchTest, Q5) {
   std::vector<uint32_t> sortingKeys{1};
   assertQuery(5, std::move(sortingKeys));
@@ -63,6 +72,11 @@ TEST_P(MultiParquetTpchTest, Q10) {
   assertQuery(10, std::move(sortingKeys));
 }
 
+TEST_P(MultiParquetTpchTest, Q11) {
+  std::vector<uint32_t> sortingKeys{1};
+  assertQuery(11, std::move(sortingKeys));
+}
+
 TEST_P(MultiParquetTpchTest, Q12) {
   std::vector<uint32_t> sortingKeys{0};
   assertQuery(12, std::move(sortingKeys));
@@ -87,6 +101,10 @@ TEST_P(MultiParquetTpchTest, Q16) {
   assertQuery(16, std::move(sortingKeys));
 }
 
+TEST_P(MultiParquetTpchTest, Q17) {
+  assertQuery(17);
+}
+
 TEST_P(MultiParquetTpchTest, Q18) {
   assertQuery(18);
 }
@@ -95,6 +113,16 @@ TEST_P(MultiParquetTpchTest, Q19) {
   assertQuery(19);
 }
 
+TEST_P(MultiParquetTpchTest, Q20) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(20, std::move(sortingKeys));
+}
+
+TEST_P(MultiParquetTpchTest, Q21) {
+  std::vector<uint32_t> sortingKeys{0, 1};
+  assertQuery(21, std::move(sortingKeys));
+}
+
 TEST_P(MultiParquetTpchTest, Q22) {
   std::vector<uint32_t> sortingKeys{0};
   assertQuery(22, std::move(sortingKeys));
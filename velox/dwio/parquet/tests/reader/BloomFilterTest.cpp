@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+
+#include <folly/Random.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::parquet;
+
+TEST(BloomFilterTest, insertAndTest) {
+  SplitBlockBloomFilter filter(4 * 1024);
+  EXPECT_EQ(4 * 1024, filter.numBytes());
+  folly::Random::DefaultGenerator rng(1);
+  std::vector<int64_t> values;
+  for (auto i = 0; i < 1000; ++i) {
+    values.push_back(folly::Random::rand64(rng));
+    filter.insertInt64(values.back());
+    filter.insertInt32(i);
+    filter.insertBytes(std::to_string(values.back()));
+  }
+  for (auto i = 0; i < values.size(); ++i) {
+    EXPECT_TRUE(filter.testInt64(values[i]));
+    EXPECT_TRUE(filter.testInt32(i));
+    EXPECT_TRUE(filter.testBytes(std::to_string(values[i])));
+  }
+
+  // The filter has 1024 blocks for 3000 values. The false positive rate of
+  // a split block filter with about 3 values per block is well under 1%.
+  int32_t numFalsePositives = 0;
+  for (auto i = 0; i < 10000; ++i) {
+    numFalsePositives += filter.testInt32(1000 + i);
+  }
+  EXPECT_LT(numFalsePositives, 100);
+}
+
+TEST(BloomFilterTest, fromBytes) {
+  SplitBlockBloomFilter filter(SplitBlockBloomFilter::kBytesPerBlock * 2);
+  filter.insertBytes("abc");
+  EXPECT_FALSE(filter.testBytes("abd"));
+  EXPECT_FALSE(filter.testInt64(11));
+
+  // An all-ones bitset contains every value.
+  std::string bits(SplitBlockBloomFilter::kBytesPerBlock, '\xff');
+  SplitBlockBloomFilter full(bits.data(), bits.size());
+  EXPECT_TRUE(full.testInt64(11));
+  EXPECT_TRUE(full.testBytes("abd"));
+
+  std::string zeros(SplitBlockBloomFilter::kBytesPerBlock, '\0');
+  SplitBlockBloomFilter empty(zeros.data(), zeros.size());
+  EXPECT_FALSE(empty.testInt64(11));
+  EXPECT_FALSE(empty.testBytes("abd"));
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+
+#include <folly/Random.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+
+void appendVuLong(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+// Encodes 'values' in DELTA_BINARY_PACKED with blocks of 'blockSize' values
+// in 'numMiniblocks' miniblocks.
+std::string encode(
+    const std::vector<int64_t>& values,
+    int32_t blockSize = 128,
+    int32_t numMiniblocks = 4) {
+  std::string out;
+  appendVuLong(out, blockSize);
+  appendVuLong(out, numMiniblocks);
+  appendVuLong(out, values.size());
+  appendVuLong(out, ZigZag::encode(values.empty() ? 0 : values[0]));
+  const int32_t miniblockSize = blockSize / numMiniblocks;
+  for (size_t begin = 1; begin < values.size(); begin += blockSize) {
+    const auto end = std::min(values.size(), begin + blockSize);
+    std::vector<uint64_t> deltas;
+    for (auto i = begin; i < end; ++i) {
+      deltas.push_back(
+          static_cast<uint64_t>(values[i]) -
+          static_cast<uint64_t>(values[i - 1]));
+    }
+    const auto minDelta = static_cast<int64_t>(*std::min_element(
+        deltas.begin(), deltas.end(), [](uint64_t left, uint64_t right) {
+          return static_cast<int64_t>(left) < static_cast<int64_t>(right);
+        }));
+    appendVuLong(out, ZigZag::encode(minDelta));
+    for (auto& delta : deltas) {
+      delta -= minDelta;
+    }
+    deltas.resize(bits::roundUp(deltas.size(), miniblockSize), 0);
+    const int32_t numUsed = deltas.size() / miniblockSize;
+    std::vector<int32_t> bitWidths(numMiniblocks, 0);
+    for (auto i = 0; i < numUsed; ++i) {
+      for (auto j = 0; j < miniblockSize; ++j) {
+        const auto delta = deltas[i * miniblockSize + j];
+        if (delta != 0) {
+          bitWidths[i] = std::max(bitWidths[i], 64 - __builtin_clzll(delta));
+        }
+      }
+    }
+    for (auto width : bitWidths) {
+      out.push_back(static_cast<char>(width));
+    }
+    for (auto i = 0; i < numUsed; ++i) {
+      std::string packed(miniblockSize * bitWidths[i] / 8, '\0');
+      for (auto j = 0; j < miniblockSize; ++j) {
+        const auto delta = deltas[i * miniblockSize + j];
+        for (auto bit = 0; bit < bitWidths[i]; ++bit) {
+          if (delta & (1UL << bit)) {
+            const auto offset = j * bitWidths[i] + bit;
+            packed[offset / 8] |= 1 << (offset % 8);
+          }
+        }
+      }
+      out += packed;
+    }
+  }
+  return out;
+}
+
+template <typename T>
+void testRoundTrip(const std::vector<int64_t>& values) {
+  // Bytes after the stream must not be read.
+  const auto encoded = encode(values) + "trailer";
+  DeltaBpDecoder decoder(encoded.data(), encoded.data() + encoded.size());
+  ASSERT_EQ(values.size(), decoder.numValues());
+  std::vector<T> result(values.size());
+  // Reads in uneven batches that cross miniblocks and blocks.
+  size_t numRead = 0;
+  for (auto batch = 1; numRead < values.size(); batch = batch * 2 + 1) {
+    const auto count = std::min<size_t>(batch, values.size() - numRead);
+    decoder.readValues(result.data() + numRead, count);
+    numRead += count;
+  }
+  for (auto i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(static_cast<T>(values[i]), result[i]) << "at " << i;
+  }
+  EXPECT_EQ(
+      encoded.data() + encoded.size() - strlen("trailer"),
+      decoder.bufferStart());
+}
+} // namespace
+
+TEST(DeltaBpDecoderTest, specExamples) {
+  // Examples from the Parquet encoding specification.
+  testRoundTrip<int32_t>({1, 2, 3, 4, 5});
+  testRoundTrip<int32_t>({7, 5, 3, 1, 2, 3, 4, 5});
+  testRoundTrip<int64_t>({42});
+  testRoundTrip<int64_t>({});
+}
+
+TEST(DeltaBpDecoderTest, random) {
+  folly::Random::DefaultGenerator rng(1);
+  for (const auto range : {0UL, 100UL, 1UL << 20, 1UL << 40}) {
+    std::vector<int64_t> values(10'000);
+    int64_t value = 0;
+    for (auto& v : values) {
+      if (range != 0) {
+        value += static_cast<int64_t>(folly::Random::rand64(rng) % range) -
+            static_cast<int64_t>(range / 2);
+      }
+      v = value;
+    }
+    testRoundTrip<int64_t>(values);
+  }
+
+  // Deltas alternating between the smallest and largest int64_t need 64 bits
+  // of width and the sums wrap around.
+  std::vector<int64_t> extremes;
+  uint64_t extreme = 0;
+  for (auto i = 0; i < 1000; ++i) {
+    extremes.push_back(static_cast<int64_t>(extreme));
+    extreme += i % 2 ? std::numeric_limits<int64_t>::max()
+                     : std::numeric_limits<int64_t>::min();
+  }
+  testRoundTrip<int64_t>(extremes);
+
+  // INT32 values wrap around like in 32 bit arithmetic.
+  std::vector<int64_t> ints;
+  for (auto i = 0; i < 1000; ++i) {
+    ints.push_back(static_cast<int32_t>(folly::Random::rand32(rng)));
+  }
+  testRoundTrip<int32_t>(ints);
+}
+
+TEST(DeltaBpDecoderTest, truncated) {
+  const auto encoded = encode({1, 100, 10'000, 1'000'000});
+  DeltaBpDecoder decoder(encoded.data(), encoded.data() + encoded.size() - 1);
+  std::vector<int64_t> result(4);
+  EXPECT_THROW(decoder.readValues(result.data(), 4), VeloxRuntimeError);
+}
@@ -16,10 +16,14 @@
 
 #include "velox/dwio/common/tests/E2EFilterTestBase.h"
 #include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/dwio/parquet/writer/NativeWriter.h"
 #include "velox/dwio/parquet/writer/Writer.h"
 
+#include <arrow/util/config.h>
 #include <folly/init/Init.h>
 
+DECLARE_int32(velox_parquet_max_dictionary_filter_size);
+
 using namespace facebook::velox;
 using namespace facebook::velox::common;
 using namespace facebook::velox::dwio::common;
@@ -42,6 +46,21 @@ class E2EFilterTest : public E2EFilterTestBase {
     auto sink = std::make_unique<MemorySink>(*pool_, 200 * 1024 * 1024);
     sinkPtr_ = sink.get();
 
+    if (useNativeWriter_) {
+      NativeWriterOptions options;
+      options.dataPageSize = 4 * 1024;
+      options.enableDictionary = nativeDictionary_;
+      options.flushPolicy = std::make_unique<RowGroupFlushPolicy>(
+          rowGroupSize_, std::numeric_limits<int64_t>::max());
+      nativeWriter_ = std::make_unique<NativeWriter>(
+          std::move(sink), *pool_, std::move(options));
+      for (auto& batch : batches) {
+        nativeWriter_->write(batch);
+      }
+      nativeWriter_->close();
+      return;
+    }
+
     writer_ = std::make_unique<facebook::velox::parquet::Writer>(
         std::move(sink), *pool_, rowGroupSize_, writerProperties_);
     for (auto& batch : batches) {
@@ -59,6 +78,9 @@ class E2EFilterTest : public E2EFilterTestBase {
   std::unique_ptr<facebook::velox::parquet::Writer> writer_;
   std::shared_ptr<::parquet::WriterProperties> writerProperties_;
   int32_t rowGroupSize_{10000};
+  std::unique_ptr<NativeWriter> nativeWriter_;
+  bool useNativeWriter_{false};
+  bool nativeDictionary_{true};
 };
 
 TEST_F(E2EFilterTest, writerMagic) {
@@ -89,6 +111,24 @@ TEST_F(E2EFilterTest, integerDirect) {
       true);
 }
 
+TEST_F(E2EFilterTest, integerDeltaBinaryPacked) {
+  writerProperties_ = ::parquet::WriterProperties::Builder()
+                          .disable_dictionary()
+                          ->encoding(::parquet::Encoding::DELTA_BINARY_PACKED)
+                          ->data_pagesize(4 * 1024)
+                          ->build();
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "long_null:bigint",
+      [&]() { makeAllNulls("long_null"); },
+      false,
+      {"short_val", "int_val", "long_val"},
+      20,
+      true);
+}
+
 TEST_F(E2EFilterTest, integerDictionary) {
   for (const auto compression :
        {::parquet::Compression::SNAPPY,
@@ -171,6 +211,31 @@ TEST_F(E2EFilterTest, floatAndDoubleDirect) {
       false);
 }
 
+TEST_F(E2EFilterTest, floatAndDoubleByteStreamSplit) {
+  writerProperties_ = ::parquet::WriterProperties::Builder()
+                          .disable_dictionary()
+                          ->encoding(::parquet::Encoding::BYTE_STREAM_SPLIT)
+                          ->data_pagesize(4 * 1024)
+                          ->build();
+
+  testWithTypes(
+      "float_val:float,"
+      "double_val:double,"
+      "float_val2:float,"
+      "double_val2:double,"
+      "float_null:float",
+      [&]() {
+        makeAllNulls("float_null");
+        makeQuantizedFloat<float>(Subfield("float_val2"), 200, true);
+        makeQuantizedFloat<double>(Subfield("double_val2"), 522, true);
+      },
+      false,
+      {"float_val", "double_val", "float_val2", "double_val2", "float_null"},
+      20,
+      true,
+      false);
+}
+
 TEST_F(E2EFilterTest, floatAndDouble) {
   // float_val and double_val may be direct since the
   // values are random.float_val2 and double_val2 are expected to be
@@ -342,6 +407,34 @@ TEST_F(E2EFilterTest, stringDirect) {
       true);
 }
 
+// The Arrow Parquet writer writes the delta encodings of strings from
+// version 12 on.
+#if ARROW_VERSION_MAJOR >= 12
+TEST_F(E2EFilterTest, stringDelta) {
+  for (const auto encoding :
+       {::parquet::Encoding::DELTA_LENGTH_BYTE_ARRAY,
+        ::parquet::Encoding::DELTA_BYTE_ARRAY}) {
+    writerProperties_ = ::parquet::WriterProperties::Builder()
+                            .disable_dictionary()
+                            ->encoding(encoding)
+                            ->data_pagesize(4 * 1024)
+                            ->build();
+
+    testWithTypes(
+        "string_val:string,"
+        "string_val_2:string",
+        [&]() {
+          makeStringUnique(Subfield("string_val"));
+          makeStringDistribution(Subfield("string_val_2"), 170, false, true);
+        },
+        false,
+        {"string_val", "string_val_2"},
+        20,
+        true);
+  }
+}
+#endif
+
 TEST_F(E2EFilterTest, stringDictionary) {
   testWithTypes(
       "string_val:string,"
@@ -356,6 +449,24 @@ TEST_F(E2EFilterTest, stringDictionary) {
       true);
 }
 
+TEST_F(E2EFilterTest, stringDictionaryLazyFilter) {
+  // Dictionary entries are tested on first use instead of when the
+  // dictionary is loaded.
+  auto maxSize = FLAGS_velox_parquet_max_dictionary_filter_size;
+  FLAGS_velox_parquet_max_dictionary_filter_size = 0;
+  testWithTypes(
+      "long_val:bigint,"
+      "string_val:string",
+      [&]() {
+        makeStringDistribution(Subfield("string_val"), 100, true, false);
+      },
+      false,
+      {"long_val", "string_val"},
+      20,
+      true);
+  FLAGS_velox_parquet_max_dictionary_filter_size = maxSize;
+}
+
 TEST_F(E2EFilterTest, dedictionarize) {
   writerProperties_ = ::parquet::WriterProperties::Builder()
                           .max_row_group_length(10000000)
@@ -376,6 +487,101 @@ TEST_F(E2EFilterTest, dedictionarize) {
       true);
 }
 
+TEST_F(E2EFilterTest, listAndMap) {
+  writerProperties_ = ::parquet::WriterProperties::Builder()
+                          .data_pagesize(4 * 1024)
+                          ->build();
+  testWithTypes(
+      "long_val:bigint,"
+      "array_val:array<int>,"
+      "nested_array_val:array<array<bigint>>,"
+      "map_val:map<bigint,double>",
+      [&]() {},
+      false,
+      {"long_val"},
+      10,
+      true);
+}
+
+// The Arrow Parquet writer writes the page index from version 12 on.
+#if ARROW_VERSION_MAJOR >= 12
+TEST_F(E2EFilterTest, pageIndex) {
+  writerProperties_ = ::parquet::WriterProperties::Builder()
+                          .disable_dictionary()
+                          ->data_pagesize(4 * 1024)
+                          ->enable_write_page_index()
+                          ->build();
+  testWithTypes(
+      "long_val:bigint,"
+      "int_val:int,"
+      "string_val:string",
+      [&]() {
+        // Makes 'long_val' ascending so that the pages have disjoint ranges
+        // of values and range filters skip pages inside a row group.
+        int64_t counter = 0;
+        for (auto& batch : batches_) {
+          auto values = batch->childAt(0)->asFlatVector<int64_t>();
+          for (auto i = 0; i < values->size(); ++i) {
+            values->set(i, counter++);
+          }
+        }
+      },
+      false,
+      {"long_val", "int_val"},
+      20,
+      true);
+}
+#endif
+
+TEST_F(E2EFilterTest, nativeWriter) {
+  useNativeWriter_ = true;
+  for (const bool enableDictionary : {false, true}) {
+    nativeDictionary_ = enableDictionary;
+    testWithTypes(
+        "tiny_val:tinyint,"
+        "short_val:smallint,"
+        "int_val:int,"
+        "long_val:bigint,"
+        "float_val:float,"
+        "double_val:double,"
+        "string_val:string,"
+        "string_val_2:string",
+        [&]() {
+          makeStringDistribution(Subfield("string_val"), 100, true, false);
+          makeStringDistribution(Subfield("string_val_2"), 170, false, true);
+        },
+        false,
+        {"short_val", "int_val", "long_val", "double_val", "string_val"},
+        20,
+        true);
+  }
+}
+
+TEST_F(E2EFilterTest, nativeWriterDictionaryInput) {
+  useNativeWriter_ = true;
+  testWithTypes(
+      "long_val:bigint,"
+      "string_val:string",
+      [&]() {
+        // Wraps the columns in dictionaries so that their dictionary ids
+        // are looked up per distinct base value.
+        for (auto& batch : batches_) {
+          const auto size = batch->size();
+          auto indices = allocateIndices(size, pool_.get());
+          auto rawIndices = indices->asMutable<vector_size_t>();
+          for (auto i = 0; i < size; ++i) {
+            rawIndices[i] = (i * 7) % size;
+          }
+          for (auto& child : batch->children()) {
+            child = BaseVector::wrapInDictionary(nullptr, indices, size, child);
+          }
+        }
+      },
+      false,
+      {"long_val", "string_val"},
+      20);
+}
+
 // Define main so that gflags get processed.
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/common/MemoryInputStream.h"
+#include "velox/dwio/common/ScanSpec.h"
+#include "velox/dwio/parquet/duckdb_reader/ParquetReader.h"
+#include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/dwio/parquet/writer/Writer.h"
+#include "velox/vector/FlatVector.h"
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+// Compares reading the encodings of Parquet with the native reader and the
+// DuckDB based reader. Each file has one column of 'kNumRows' rows written
+// without dictionary in the encoding in the name of the benchmark.
+
+namespace {
+
+using NativeReader = facebook::velox::parquet::ParquetReader;
+using DuckDbReader = facebook::velox::parquet::duckdb_reader::ParquetReader;
+
+constexpr int32_t kNumRows = 1'000'000;
+
+std::unique_ptr<memory::ScopedMemoryPool> scopedPool;
+std::unordered_map<std::string, std::string> files;
+
+RowVectorPtr makeData(const TypePtr& type) {
+  auto& pool = scopedPool->getPool();
+  folly::Random::DefaultGenerator rng(1);
+  VectorPtr values;
+  if (type->kind() == TypeKind::BIGINT) {
+    // Increasing values with small deltas, e.g. timestamps or ids.
+    auto flat = BaseVector::create<FlatVector<int64_t>>(type, kNumRows, &pool);
+    int64_t value = 1'600'000'000'000;
+    for (auto i = 0; i < kNumRows; ++i) {
+      value += folly::Random::rand32(1000, rng);
+      flat->set(i, value);
+    }
+    values = flat;
+  } else {
+    auto flat = BaseVector::create<FlatVector<double>>(type, kNumRows, &pool);
+    for (auto i = 0; i < kNumRows; ++i) {
+      flat->set(i, 100 + folly::Random::randDouble01(rng));
+    }
+    values = flat;
+  }
+  return std::make_shared<RowVector>(
+      &pool,
+      ROW({"c0"}, {type}),
+      nullptr,
+      kNumRows,
+      std::vector<VectorPtr>{values});
+}
+
+void writeFile(
+    const std::string& name,
+    const TypePtr& type,
+    ::parquet::Encoding::type encoding) {
+  auto& pool = scopedPool->getPool();
+  auto sink = std::make_unique<MemorySink>(pool, 64 << 20);
+  auto* sinkPtr = sink.get();
+  auto properties = ::parquet::WriterProperties::Builder()
+                        .disable_dictionary()
+                        ->encoding(encoding)
+                        ->build();
+  facebook::velox::parquet::Writer writer(
+      std::move(sink), pool, kNumRows, properties);
+  writer.write(makeData(type));
+  writer.close();
+  files[name] = std::string(sinkPtr->getData(), sinkPtr->size());
+}
+
+template <typename TReader>
+void read(const std::string& name, uint32_t iterations) {
+  auto& data = files.at(name);
+  auto& pool = scopedPool->getPool();
+  for (auto iteration = 0; iteration < iterations; ++iteration) {
+    ReaderOptions readerOptions;
+    TReader reader(
+        std::make_unique<MemoryInputStream>(data.data(), data.size()),
+        readerOptions);
+    const auto& rowType = reader.rowType();
+    auto spec = std::make_shared<common::ScanSpec>("root");
+    for (auto i = 0; i < rowType->size(); ++i) {
+      auto* fieldSpec =
+          spec->getOrCreateChild(common::Subfield(rowType->nameOf(i)));
+      fieldSpec->setProjectOut(true);
+      fieldSpec->setExtractValues(true);
+      fieldSpec->setChannel(i);
+    }
+    RowReaderOptions rowReaderOptions;
+    rowReaderOptions.select(
+        std::make_shared<ColumnSelector>(rowType, rowType->names()));
+    rowReaderOptions.setScanSpec(spec);
+    auto rowReader = reader.createRowReader(rowReaderOptions);
+    VectorPtr batch = BaseVector::create(rowType, 0, &pool);
+    int64_t numRows = 0;
+    while (rowReader->next(10'000, batch)) {
+      numRows += batch->size();
+    }
+    VELOX_CHECK_EQ(kNumRows, numRows);
+  }
+}
+
+#define PARQUET_BENCHMARKS(name)         \
+  BENCHMARK(name##Native, n) {           \
+    read<NativeReader>(#name, n);        \
+  }                                      \
+  BENCHMARK_RELATIVE(name##DuckDb, n) {  \
+    read<DuckDbReader>(#name, n);        \
+  }                                      \
+  BENCHMARK_DRAW_LINE();
+
+PARQUET_BENCHMARKS(bigintPlain)
+PARQUET_BENCHMARKS(bigintDeltaBinaryPacked)
+PARQUET_BENCHMARKS(doublePlain)
+PARQUET_BENCHMARKS(doubleByteStreamSplit)
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  scopedPool = memory::getDefaultScopedMemoryPool();
+  writeFile("bigintPlain", BIGINT(), ::parquet::Encoding::PLAIN);
+  writeFile(
+      "bigintDeltaBinaryPacked",
+      BIGINT(),
+      ::parquet::Encoding::DELTA_BINARY_PACKED);
+  writeFile("doublePlain", DOUBLE(), ::parquet::Encoding::PLAIN);
+  writeFile(
+      "doubleByteStreamSplit",
+      DOUBLE(),
+      ::parquet::Encoding::BYTE_STREAM_SPLIT);
+  folly::runBenchmarks();
+  scopedPool.reset();
+  return 0;
+}
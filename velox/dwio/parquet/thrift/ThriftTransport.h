@@ -18,6 +18,7 @@
 
 #include <thrift/transport/TVirtualTransport.h>
 #include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/DataBuffer.h"
 
 namespace facebook::velox::parquet::thrift {
 
@@ -43,4 +44,20 @@ class ThriftBufferedTransport
   uint64_t offset_;
 };
 
+// Appends the output of a Thrift protocol to a DataBuffer.
+class ThriftBufferSink
+    : public apache::thrift::transport::TVirtualTransport<ThriftBufferSink> {
+ public:
+  explicit ThriftBufferSink(dwio::common::DataBuffer<char>& buffer)
+      : buffer_(buffer) {}
+
+  void write(const uint8_t* data, uint32_t len) {
+    buffer_.extendAppend(
+        buffer_.size(), reinterpret_cast<const char*>(data), len);
+  }
+
+ private:
+  dwio::common::DataBuffer<char>& buffer_;
+};
+
 } // namespace facebook::velox::parquet::thrift
@@ -0,0 +1,625 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/ColumnChunkWriter.h"
+
+#include <cmath>
+#include <deque>
+
+#include <folly/container/F14Map.h>
+#include <snappy.h>
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include <zstd.h>
+
+#include "velox/dwio/parquet/thrift/ThriftTransport.h"
+
+namespace facebook::velox::parquet {
+
+using dwio::common::DataBuffer;
+
+namespace {
+
+void appendVarint(DataBuffer<char>& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.append(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.append(static_cast<char>(value));
+}
+
+// Appends 'numValues' values of 'bitWidth' bits from 'values' to 'out' in
+// the RLE/bit-packing hybrid encoding. A group of at least 8 equal values
+// becomes an RLE run. The other values are bit-packed in groups of 8. The
+// last values that do not fill a group are RLE runs.
+template <typename T>
+void encodeRleBitPacked(
+    const T* values,
+    int32_t numValues,
+    int32_t bitWidth,
+    DataBuffer<char>& out) {
+  VELOX_DCHECK_LE(bitWidth, 32);
+  const int32_t valueBytes = (bitWidth + 7) / 8;
+  auto appendRun = [&](uint32_t value, int32_t count) {
+    appendVarint(out, static_cast<uint64_t>(count) << 1);
+    for (auto i = 0; i < valueBytes; ++i) {
+      out.append(static_cast<char>(value >> (8 * i)));
+    }
+  };
+  auto appendGroups = [&](int32_t begin, int32_t end) {
+    if (begin == end) {
+      return;
+    }
+    appendVarint(out, (static_cast<uint64_t>((end - begin) / 8) << 1) | 1);
+    uint64_t bits = 0;
+    int32_t numBits = 0;
+    for (auto i = begin; i < end; ++i) {
+      bits |= static_cast<uint64_t>(static_cast<uint32_t>(values[i]))
+          << numBits;
+      numBits += bitWidth;
+      while (numBits >= 8) {
+        out.append(static_cast<char>(bits));
+        bits >>= 8;
+        numBits -= 8;
+      }
+    }
+  };
+  auto runEnd = [&](int32_t begin) {
+    auto end = begin + 1;
+    while (end < numValues && values[end] == values[begin]) {
+      ++end;
+    }
+    return end;
+  };
+
+  int32_t groupsBegin = 0;
+  int32_t i = 0;
+  while (i + 8 <= numValues) {
+    const auto end = runEnd(i);
+    if (end - i >= 8) {
+      appendGroups(groupsBegin, i);
+      appendRun(values[i], end - i);
+      i = end;
+      groupsBegin = i;
+    } else {
+      i += 8;
+    }
+  }
+  appendGroups(groupsBegin, i);
+  while (i < numValues) {
+    const auto end = runEnd(i);
+    appendRun(values[i], end - i);
+    i = end;
+  }
+}
+
+// Returns the bit width of the indices of a dictionary of 'size' entries.
+int32_t indexBitWidth(int32_t size) {
+  return size <= 1 ? 1 : 64 - __builtin_clzll(size - 1);
+}
+
+template <typename P>
+void appendPlain(DataBuffer<char>& out, P value) {
+  out.extendAppend(
+      out.size(), reinterpret_cast<const char*>(&value), sizeof(P));
+}
+
+template <>
+void appendPlain(DataBuffer<char>& out, StringView value) {
+  const int32_t length = value.size();
+  appendPlain(out, length);
+  out.extendAppend(out.size(), value.data(), length);
+}
+
+// The key of a value in the dictionary of a chunk. Floating point values
+// are keyed on their bits so that -0.0 and 0.0 are distinct entries.
+template <typename P>
+struct DictionaryKey {
+  using Type = std::conditional_t<sizeof(P) == 4, uint32_t, uint64_t>;
+
+  static Type of(P value) {
+    Type key;
+    memcpy(&key, &value, sizeof(key));
+    return key;
+  }
+};
+
+template <>
+struct DictionaryKey<StringView> {
+  using Type = std::string_view;
+
+  static Type of(StringView value) {
+    return std::string_view(value.data(), value.size());
+  }
+};
+
+// Min and max of the non-null values of a chunk.
+template <typename P>
+class ValueStats {
+ public:
+  void add(P value) {
+    if constexpr (std::is_floating_point_v<P>) {
+      if (std::isnan(value)) {
+        return;
+      }
+    }
+    if (!min_.has_value() || value < *min_) {
+      min_ = value;
+    }
+    if (!max_.has_value() || value > *max_) {
+      max_ = value;
+    }
+  }
+
+  void toThrift(thrift::Statistics& stats) const {
+    if (!min_.has_value()) {
+      return;
+    }
+    auto min = *min_;
+    auto max = *max_;
+    if constexpr (std::is_floating_point_v<P>) {
+      // A zero min is written as -0.0 and a zero max as +0.0 since the
+      // sign of zeros is not ordered.
+      if (min == 0) {
+        min = -0.0;
+      }
+      if (max == 0) {
+        max = 0.0;
+      }
+    }
+    stats.__set_min_value(
+        std::string(reinterpret_cast<const char*>(&min), sizeof(P)));
+    stats.__set_max_value(
+        std::string(reinterpret_cast<const char*>(&max), sizeof(P)));
+  }
+
+  void reset() {
+    min_.reset();
+    max_.reset();
+  }
+
+ private:
+  std::optional<P> min_;
+  std::optional<P> max_;
+};
+
+template <>
+class ValueStats<StringView> {
+ public:
+  void add(StringView value) {
+    const std::string_view view(value.data(), value.size());
+    if (!min_.has_value() || view < *min_) {
+      min_ = std::string(view);
+    }
+    if (!max_.has_value() || view > *max_) {
+      max_ = std::string(view);
+    }
+  }
+
+  void toThrift(thrift::Statistics& stats) const {
+    if (min_.has_value()) {
+      stats.__set_min_value(*min_);
+      stats.__set_max_value(*max_);
+    }
+  }
+
+  void reset() {
+    min_.reset();
+    max_.reset();
+  }
+
+ private:
+  std::optional<std::string> min_;
+  std::optional<std::string> max_;
+};
+
+// Writer of a column of Velox type T stored as Parquet physical type P.
+template <typename T, typename P>
+class TypedChunkWriter : public ColumnChunkWriter {
+ public:
+  TypedChunkWriter(
+      std::string name,
+      thrift::Type::type physicalType,
+      std::optional<thrift::ConvertedType::type> convertedType,
+      const NativeWriterOptions& options,
+      memory::MemoryPool& pool)
+      : ColumnChunkWriter(std::move(name), physicalType, options, pool),
+        convertedType_(convertedType),
+        values_(pool),
+        indices_(pool),
+        dictionaryValues_(pool),
+        scratch_(pool) {
+    useDictionary_ = canUseDictionary();
+  }
+
+  void setInput(const DecodedVector& decoded) override {
+    ColumnChunkWriter::setInput(decoded);
+    // The dictionary id of each base value of a dictionary encoded input is
+    // looked up once.
+    baseToId_.clear();
+    if (useDictionary_ && !decoded.isIdentityMapping() &&
+        !decoded.isConstantMapping() &&
+        decoded.base()->size() <= decoded.size()) {
+      baseToId_.resize(decoded.base()->size(), -1);
+    }
+  }
+
+  void write(vector_size_t begin, vector_size_t end) override {
+    const auto& decoded = *decoded_;
+    const bool mayHaveNulls = decoded.mayHaveNulls();
+    for (auto row = begin; row < end; ++row) {
+      if (mayHaveNulls && decoded.isNullAt(row)) {
+        addLevel(true);
+      } else {
+        addLevel(false);
+        const P value = decoded.valueAt<T>(row);
+        stats_.add(value);
+        if (useDictionary_) {
+          indices_.append(dictionaryId(decoded.index(row), value));
+        } else {
+          appendValue(value);
+        }
+      }
+      if (pageBytes() >= options_.dataPageSize) {
+        flushPage();
+      }
+    }
+    if (useDictionary_ &&
+        dictionaryValues_.size() > options_.dictionaryPageSizeLimit) {
+      // The rest of the chunk is PLAIN.
+      flushPage();
+      useDictionary_ = false;
+    }
+  }
+
+  thrift::SchemaElement schemaElement() const override {
+    auto element = ColumnChunkWriter::schemaElement();
+    if (convertedType_.has_value()) {
+      element.__set_converted_type(convertedType_.value());
+    }
+    return element;
+  }
+
+ protected:
+  int64_t pageBytes() const override {
+    const int64_t levelBytes = numPageLevels() / 8;
+    if (useDictionary_) {
+      return levelBytes +
+          indices_.size() * indexBitWidth(dictionary_.size()) / 8;
+    }
+    return levelBytes + values_.size();
+  }
+
+  void flushPage() override {
+    if (numPageLevels() == 0) {
+      return;
+    }
+    if (useDictionary_) {
+      const auto bitWidth = indexBitWidth(dictionary_.size());
+      scratch_.resize(0);
+      scratch_.append(static_cast<char>(bitWidth));
+      encodeRleBitPacked(indices_.data(), indices_.size(), bitWidth, scratch_);
+      writePage(
+          thrift::Encoding::RLE_DICTIONARY, scratch_.data(), scratch_.size());
+      indices_.resize(0);
+      hasDictionaryPages_ = true;
+    } else {
+      writePage(thrift::Encoding::PLAIN, values_.data(), values_.size());
+      values_.resize(0);
+      numPageBits_ = 0;
+    }
+  }
+
+  void finishChunk(thrift::ColumnMetaData& metaData) override {
+    if (hasDictionaryPages_) {
+      writeDictionaryPage(
+          dictionaryValues_.data(),
+          dictionaryValues_.size(),
+          dictionary_.size());
+    }
+    stats_.toThrift(metaData.statistics);
+    stats_.reset();
+    dictionary_.clear();
+    dictionaryStrings_.clear();
+    dictionaryValues_.resize(0);
+    std::fill(baseToId_.begin(), baseToId_.end(), -1);
+    hasDictionaryPages_ = false;
+    // A chunk that fell back to PLAIN does not make the next one PLAIN.
+    useDictionary_ = canUseDictionary();
+  }
+
+ private:
+  bool canUseDictionary() const {
+    return options_.enableDictionary && !std::is_same_v<P, bool>;
+  }
+
+  void appendValue(P value) {
+    if constexpr (std::is_same_v<P, bool>) {
+      // PLAIN booleans are bit-packed from the least significant bit.
+      if (numPageBits_ % 8 == 0) {
+        values_.append(0);
+      }
+      if (value) {
+        values_[values_.size() - 1] |= 1 << (numPageBits_ % 8);
+      }
+      ++numPageBits_;
+    } else {
+      appendPlain(values_, value);
+    }
+  }
+
+  int32_t dictionaryId(vector_size_t baseIndex, P value) {
+    if (baseToId_.empty()) {
+      return lookup(value);
+    }
+    auto& id = baseToId_[baseIndex];
+    if (id < 0) {
+      id = lookup(value);
+    }
+    return id;
+  }
+
+  // Returns the id of 'value' in the dictionary, adding it if new.
+  int32_t lookup(P value) {
+    using Key = DictionaryKey<P>;
+    auto key = Key::of(value);
+    auto it = dictionary_.find(key);
+    if (it != dictionary_.end()) {
+      return it->second;
+    }
+    const int32_t id = dictionary_.size();
+    if constexpr (std::is_same_v<P, StringView>) {
+      // The key refers to a copy that lives as long as the dictionary.
+      key = dictionaryStrings_.emplace_back(key);
+    }
+    dictionary_.emplace(key, id);
+    appendPlain(dictionaryValues_, value);
+    return id;
+  }
+
+  const std::optional<thrift::ConvertedType::type> convertedType_;
+  // PLAIN encoded values of the current page.
+  DataBuffer<char> values_;
+  // Number of booleans in 'values_'.
+  int64_t numPageBits_{0};
+  // Dictionary ids of the values of the current page.
+  DataBuffer<int32_t> indices_;
+  bool useDictionary_;
+  // True if a page of the current chunk is dictionary encoded.
+  bool hasDictionaryPages_{false};
+  folly::F14FastMap<typename DictionaryKey<P>::Type, int32_t> dictionary_;
+  std::deque<std::string> dictionaryStrings_;
+  // The PLAIN encoded entries of 'dictionary_' in order of id.
+  DataBuffer<char> dictionaryValues_;
+  // Dictionary id for each value of the base of a dictionary encoded
+  // input, -1 if not looked up.
+  std::vector<int32_t> baseToId_;
+  DataBuffer<char> scratch_;
+  ValueStats<P> stats_;
+};
+
+template <typename T, typename P>
+std::unique_ptr<ColumnChunkWriter> makeWriter(
+    const std::string& name,
+    thrift::Type::type physicalType,
+    std::optional<thrift::ConvertedType::type> convertedType,
+    const NativeWriterOptions& options,
+    memory::MemoryPool& pool) {
+  return std::make_unique<TypedChunkWriter<T, P>>(
+      name, physicalType, convertedType, options, pool);
+}
+
+} // namespace
+
+ColumnChunkWriter::ColumnChunkWriter(
+    std::string name,
+    thrift::Type::type physicalType,
+    const NativeWriterOptions& options,
+    memory::MemoryPool& pool)
+    : name_(std::move(name)),
+      physicalType_(physicalType),
+      options_(options),
+      pool_(pool),
+      definitions_(pool),
+      dictionaryPage_(pool),
+      dataPages_(pool),
+      pageBuffer_(pool),
+      compressed_(pool) {}
+
+// static
+std::unique_ptr<ColumnChunkWriter> ColumnChunkWriter::create(
+    const std::string& name,
+    const TypePtr& type,
+    const NativeWriterOptions& options,
+    memory::MemoryPool& pool) {
+  using thrift::ConvertedType;
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+      return makeWriter<bool, bool>(
+          name, thrift::Type::BOOLEAN, std::nullopt, options, pool);
+    case TypeKind::TINYINT:
+      return makeWriter<int8_t, int32_t>(
+          name, thrift::Type::INT32, ConvertedType::INT_8, options, pool);
+    case TypeKind::SMALLINT:
+      return makeWriter<int16_t, int32_t>(
+          name, thrift::Type::INT32, ConvertedType::INT_16, options, pool);
+    case TypeKind::INTEGER:
+      return makeWriter<int32_t, int32_t>(
+          name, thrift::Type::INT32, std::nullopt, options, pool);
+    case TypeKind::BIGINT:
+      return makeWriter<int64_t, int64_t>(
+          name, thrift::Type::INT64, std::nullopt, options, pool);
+    case TypeKind::REAL:
+      return makeWriter<float, float>(
+          name, thrift::Type::FLOAT, std::nullopt, options, pool);
+    case TypeKind::DOUBLE:
+      return makeWriter<double, double>(
+          name, thrift::Type::DOUBLE, std::nullopt, options, pool);
+    case TypeKind::VARCHAR:
+      return makeWriter<StringView, StringView>(
+          name, thrift::Type::BYTE_ARRAY, ConvertedType::UTF8, options, pool);
+    case TypeKind::VARBINARY:
+      return makeWriter<StringView, StringView>(
+          name, thrift::Type::BYTE_ARRAY, std::nullopt, options, pool);
+    default:
+      VELOX_UNSUPPORTED(
+          "Type not supported by the native Parquet writer: {}",
+          type->toString());
+  }
+}
+
+std::vector<DataBuffer<char>> ColumnChunkWriter::finish(
+    int64_t fileOffset,
+    thrift::ColumnChunk& chunk) {
+  flushPage();
+  thrift::ColumnMetaData metaData;
+  finishChunk(metaData);
+  metaData.statistics.__set_null_count(nullCount_);
+  metaData.__isset.statistics = true;
+  metaData.__set_type(physicalType_);
+  auto encodings = encodings_;
+  encodings.push_back(thrift::Encoding::RLE);
+  metaData.__set_encodings(encodings);
+  metaData.__set_path_in_schema({name_});
+  metaData.__set_codec(options_.codec);
+  metaData.__set_num_values(numValues_);
+  metaData.__set_total_uncompressed_size(totalUncompressedSize_);
+  metaData.__set_total_compressed_size(
+      dictionaryPage_.size() + dataPages_.size());
+  if (dictionaryPage_.size() > 0) {
+    metaData.__set_dictionary_page_offset(fileOffset);
+  }
+  metaData.__set_data_page_offset(fileOffset + dictionaryPage_.size());
+  chunk.__set_file_offset(fileOffset);
+  chunk.__set_meta_data(metaData);
+
+  std::vector<DataBuffer<char>> buffers;
+  if (dictionaryPage_.size() > 0) {
+    buffers.push_back(std::move(dictionaryPage_));
+  }
+  buffers.push_back(std::move(dataPages_));
+  numValues_ = 0;
+  nullCount_ = 0;
+  totalUncompressedSize_ = 0;
+  encodings_.clear();
+  return buffers;
+}
+
+thrift::SchemaElement ColumnChunkWriter::schemaElement() const {
+  thrift::SchemaElement element;
+  element.__set_name(name_);
+  element.__set_type(physicalType_);
+  element.__set_repetition_type(thrift::FieldRepetitionType::OPTIONAL);
+  return element;
+}
+
+void ColumnChunkWriter::writePage(
+    thrift::Encoding::type encoding,
+    const char* values,
+    int32_t size) {
+  const int32_t numLevels = definitions_.size();
+  // The definition levels are preceded by their length in V1 data pages.
+  pageBuffer_.resize(sizeof(int32_t));
+  encodeRleBitPacked(definitions_.data(), numLevels, 1, pageBuffer_);
+  const int32_t levelsSize = pageBuffer_.size() - sizeof(int32_t);
+  memcpy(pageBuffer_.data(), &levelsSize, sizeof(int32_t));
+  pageBuffer_.extendAppend(pageBuffer_.size(), values, size);
+
+  thrift::DataPageHeader dataHeader;
+  dataHeader.__set_num_values(numLevels);
+  dataHeader.__set_encoding(encoding);
+  dataHeader.__set_definition_level_encoding(thrift::Encoding::RLE);
+  dataHeader.__set_repetition_level_encoding(thrift::Encoding::RLE);
+  thrift::PageHeader header;
+  header.__set_type(thrift::PageType::DATA_PAGE);
+  header.__set_data_page_header(dataHeader);
+  appendPage(header, pageBuffer_.data(), pageBuffer_.size(), dataPages_);
+
+  numValues_ += numLevels;
+  if (std::find(encodings_.begin(), encodings_.end(), encoding) ==
+      encodings_.end()) {
+    encodings_.push_back(encoding);
+  }
+  definitions_.resize(0);
+}
+
+void ColumnChunkWriter::writeDictionaryPage(
+    const char* values,
+    int32_t size,
+    int32_t numEntries) {
+  thrift::DictionaryPageHeader dictionaryHeader;
+  dictionaryHeader.__set_num_values(numEntries);
+  dictionaryHeader.__set_encoding(thrift::Encoding::PLAIN);
+  thrift::PageHeader header;
+  header.__set_type(thrift::PageType::DICTIONARY_PAGE);
+  header.__set_dictionary_page_header(dictionaryHeader);
+  appendPage(header, values, size, dictionaryPage_);
+  if (std::find(
+          encodings_.begin(), encodings_.end(), thrift::Encoding::PLAIN) ==
+      encodings_.end()) {
+    encodings_.push_back(thrift::Encoding::PLAIN);
+  }
+}
+
+void ColumnChunkWriter::appendPage(
+    thrift::PageHeader& header,
+    const char* data,
+    int32_t size,
+    DataBuffer<char>& out) {
+  const char* pageData = data;
+  int32_t compressedSize = size;
+  switch (options_.codec) {
+    case thrift::CompressionCodec::UNCOMPRESSED:
+      break;
+    case thrift::CompressionCodec::SNAPPY: {
+      compressed_.resize(snappy::MaxCompressedLength(size));
+      size_t snappySize;
+      snappy::RawCompress(data, size, compressed_.data(), &snappySize);
+      pageData = compressed_.data();
+      compressedSize = snappySize;
+      break;
+    }
+    case thrift::CompressionCodec::ZSTD: {
+      compressed_.resize(ZSTD_compressBound(size));
+      const auto zstdSize = ZSTD_compress(
+          compressed_.data(),
+          compressed_.size(),
+          data,
+          size,
+          ZSTD_CLEVEL_DEFAULT);
+      VELOX_CHECK(
+          !ZSTD_isError(zstdSize),
+          "ZSTD compression failed: {}",
+          ZSTD_getErrorName(zstdSize));
+      pageData = compressed_.data();
+      compressedSize = zstdSize;
+      break;
+    }
+    default:
+      VELOX_UNSUPPORTED(
+          "Codec not supported by the native Parquet writer: {}",
+          options_.codec);
+  }
+  header.__set_uncompressed_page_size(size);
+  header.__set_compressed_page_size(compressedSize);
+  auto transport = std::make_shared<thrift::ThriftBufferSink>(out);
+  apache::thrift::protocol::TCompactProtocolT<thrift::ThriftBufferSink>
+      protocol(transport);
+  const int64_t headerSize = header.write(&protocol);
+  out.extendAppend(out.size(), pageData, compressedSize);
+  totalUncompressedSize_ += headerSize + size;
+}
+
+} // namespace facebook::velox::parquet
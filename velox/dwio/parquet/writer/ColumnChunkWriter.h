@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::parquet {
+
+// Encodes the values of a top level column into the pages of a column
+// chunk. The levels and values of the current page are buffered until they
+// reach the data page size. The page is then encoded, compressed and
+// appended to the pages of the chunk, which are held until the row group
+// ends.
+class ColumnChunkWriter {
+ public:
+  ColumnChunkWriter(
+      std::string name,
+      thrift::Type::type physicalType,
+      const NativeWriterOptions& options,
+      memory::MemoryPool& pool);
+
+  virtual ~ColumnChunkWriter() = default;
+
+  // Returns a writer for a column of 'type'.
+  static std::unique_ptr<ColumnChunkWriter> create(
+      const std::string& name,
+      const TypePtr& type,
+      const NativeWriterOptions& options,
+      memory::MemoryPool& pool);
+
+  // Sets the vector from which the following write() calls take their
+  // values. 'decoded' must stay live until the next setInput().
+  virtual void setInput(const DecodedVector& decoded) {
+    decoded_ = &decoded;
+  }
+
+  // Appends the rows in [begin, end) of the input.
+  virtual void write(vector_size_t begin, vector_size_t end) = 0;
+
+  // Returns the bytes of the encoded pages and the values of the current
+  // page.
+  int64_t bufferedBytes() const {
+    return dictionaryPage_.size() + dataPages_.size() + pageBytes();
+  }
+
+  // Ends the column chunk. Sets 'chunk' to describe the chunk starting at
+  // 'fileOffset' and returns its bytes. The writer is then ready for the
+  // next row group.
+  std::vector<dwio::common::DataBuffer<char>> finish(
+      int64_t fileOffset,
+      thrift::ColumnChunk& chunk);
+
+  // Returns the element of the column in the schema of the file.
+  virtual thrift::SchemaElement schemaElement() const;
+
+ protected:
+  // Returns the bytes of the values of the current page.
+  virtual int64_t pageBytes() const = 0;
+
+  // Encodes the current page with writePage().
+  virtual void flushPage() = 0;
+
+  // Writes the dictionary page with writeDictionaryPage() if the chunk is
+  // dictionary encoded, adds the statistics to 'metaData' and resets the
+  // dictionary and the statistics for the next chunk.
+  virtual void finishChunk(thrift::ColumnMetaData& metaData) = 0;
+
+  // Adds a definition level for a null or non-null value to the current
+  // page.
+  void addLevel(bool isNull) {
+    definitions_.append(isNull ? 0 : 1);
+    nullCount_ += isNull;
+  }
+
+  int32_t numPageLevels() const {
+    return definitions_.size();
+  }
+
+  // Appends a data page with the levels of the current page and 'size'
+  // bytes of 'values' in 'encoding'. Clears the levels.
+  void writePage(
+      thrift::Encoding::type encoding,
+      const char* values,
+      int32_t size);
+
+  // Writes the dictionary page of 'numEntries' PLAIN encoded values.
+  void
+  writeDictionaryPage(const char* values, int32_t size, int32_t numEntries);
+
+  const std::string name_;
+  const thrift::Type::type physicalType_;
+  const NativeWriterOptions& options_;
+  memory::MemoryPool& pool_;
+  const DecodedVector* decoded_{nullptr};
+
+ private:
+  // Compresses 'size' bytes at 'data' with the codec in 'options_' and
+  // appends the page with 'header' to 'out'.
+  void appendPage(
+      thrift::PageHeader& header,
+      const char* data,
+      int32_t size,
+      dwio::common::DataBuffer<char>& out);
+
+  // Definition levels of the current page. 0 is null and 1 is not null.
+  dwio::common::DataBuffer<uint8_t> definitions_;
+  // The dictionary page of the chunk, if any. It precedes 'dataPages_'.
+  dwio::common::DataBuffer<char> dictionaryPage_;
+  dwio::common::DataBuffer<char> dataPages_;
+  // Scratch for the levels and values of a page and for their compression.
+  dwio::common::DataBuffer<char> pageBuffer_;
+  dwio::common::DataBuffer<char> compressed_;
+
+  int64_t numValues_{0};
+  int64_t nullCount_{0};
+  int64_t totalUncompressedSize_{0};
+  std::vector<thrift::Encoding::type> encodings_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+
+#include "velox/dwio/parquet/thrift/ThriftTransport.h"
+#include "velox/dwio/parquet/writer/ColumnChunkWriter.h"
+
+namespace facebook::velox::parquet {
+
+namespace {
+
+constexpr uint64_t kDefaultRowsInRowGroup = 1'000'000;
+constexpr int64_t kDefaultBytesInRowGroup = 128 << 20;
+
+// The flush policy is consulted after each batch of this many rows.
+constexpr vector_size_t kRowsPerFlushCheck = 1024;
+
+constexpr const char* kMagic = "PAR1";
+constexpr int32_t kMagicSize = 4;
+
+} // namespace
+
+NativeWriter::NativeWriter(
+    std::unique_ptr<dwio::common::DataSink> sink,
+    memory::MemoryPool& pool,
+    NativeWriterOptions options)
+    : pool_(pool), sink_(std::move(sink)), options_(std::move(options)) {
+  VELOX_CHECK_NOT_NULL(sink_);
+  VELOX_CHECK_GT(options_.dataPageSize, 0);
+  if (!options_.flushPolicy) {
+    options_.flushPolicy = std::make_unique<RowGroupFlushPolicy>(
+        kDefaultRowsInRowGroup, kDefaultBytesInRowGroup);
+  }
+}
+
+NativeWriter::~NativeWriter() = default;
+
+void NativeWriter::initialize(const RowTypePtr& type) {
+  type_ = type;
+  columns_.reserve(type_->size());
+  for (auto i = 0; i < type_->size(); ++i) {
+    columns_.push_back(ColumnChunkWriter::create(
+        type_->nameOf(i), type_->childAt(i), options_, pool_));
+  }
+  dwio::common::DataBuffer<char> magic(pool_);
+  magic.append(0, kMagic, kMagicSize);
+  sink_->write(std::move(magic));
+}
+
+void NativeWriter::write(const RowVectorPtr& data) {
+  VELOX_CHECK(!closed_, "Writing to a closed Parquet writer");
+  if (!type_) {
+    initialize(asRowType(data->type()));
+  } else {
+    VELOX_CHECK(
+        type_->equivalent(*data->type()),
+        "Type {} does not match the type of the file {}",
+        data->type()->toString(),
+        type_->toString());
+  }
+  const vector_size_t numRows = data->size();
+  std::vector<DecodedVector> decoded;
+  decoded.reserve(columns_.size());
+  for (auto i = 0; i < columns_.size(); ++i) {
+    decoded.emplace_back(*data->childAt(i));
+    columns_[i]->setInput(decoded.back());
+  }
+  for (vector_size_t begin = 0; begin < numRows;) {
+    const auto end = std::min(numRows, begin + kRowsPerFlushCheck);
+    for (auto& column : columns_) {
+      column->write(begin, end);
+    }
+    rowGroupRows_ += end - begin;
+    numRows_ += end - begin;
+    begin = end;
+    if (options_.flushPolicy->shouldFlush(progress())) {
+      flush();
+    }
+  }
+}
+
+dwio::common::StripeProgress NativeWriter::progress() const {
+  dwio::common::StripeProgress progress;
+  progress.stripeIndex = rowGroups_.size();
+  progress.stripeRowCount = rowGroupRows_;
+  progress.totalMemoryUsage = pool_.getCurrentBytes();
+  for (auto& column : columns_) {
+    progress.stripeSizeEstimate += column->bufferedBytes();
+  }
+  return progress;
+}
+
+void NativeWriter::flush() {
+  if (rowGroupRows_ == 0) {
+    return;
+  }
+  thrift::RowGroup rowGroup;
+  rowGroup.__set_file_offset(sink_->size());
+  rowGroup.__set_num_rows(rowGroupRows_);
+  int64_t totalByteSize = 0;
+  int64_t totalCompressedSize = 0;
+  for (auto& column : columns_) {
+    thrift::ColumnChunk chunk;
+    auto buffers = column->finish(sink_->size(), chunk);
+    // Each chunk goes to the sink as soon as it is complete so that only
+    // one row group of pages is held in memory.
+    sink_->writeWithLogging(buffers);
+    totalByteSize += chunk.meta_data.total_uncompressed_size;
+    totalCompressedSize += chunk.meta_data.total_compressed_size;
+    rowGroup.columns.push_back(std::move(chunk));
+  }
+  rowGroup.__set_total_byte_size(totalByteSize);
+  rowGroup.__set_total_compressed_size(totalCompressedSize);
+  rowGroup.__set_ordinal(rowGroups_.size());
+  rowGroups_.push_back(std::move(rowGroup));
+  rowGroupRows_ = 0;
+}
+
+void NativeWriter::close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  if (!type_) {
+    return;
+  }
+  flush();
+
+  std::vector<thrift::SchemaElement> schema;
+  thrift::SchemaElement root;
+  root.__set_name("schema");
+  root.__set_repetition_type(thrift::FieldRepetitionType::REQUIRED);
+  root.__set_num_children(columns_.size());
+  schema.push_back(std::move(root));
+  for (auto& column : columns_) {
+    schema.push_back(column->schemaElement());
+  }
+  thrift::FileMetaData fileMetaData;
+  fileMetaData.__set_version(1);
+  fileMetaData.__set_schema(schema);
+  fileMetaData.__set_num_rows(numRows_);
+  fileMetaData.__set_row_groups(rowGroups_);
+  fileMetaData.__set_created_by("velox");
+
+  dwio::common::DataBuffer<char> footer(pool_);
+  auto transport = std::make_shared<thrift::ThriftBufferSink>(footer);
+  apache::thrift::protocol::TCompactProtocolT<thrift::ThriftBufferSink>
+      protocol(transport);
+  const uint32_t footerSize = fileMetaData.write(&protocol);
+  footer.extendAppend(
+      footer.size(),
+      reinterpret_cast<const char*>(&footerSize),
+      sizeof(footerSize));
+  footer.extendAppend(footer.size(), kMagic, kMagicSize);
+  sink_->write(std::move(footer));
+  options_.flushPolicy->onClose();
+}
+
+} // namespace facebook::velox::parquet
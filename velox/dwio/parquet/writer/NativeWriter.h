@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/common/FlushPolicy.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::parquet {
+
+class ColumnChunkWriter;
+
+// Ends a row group when it has 'rowsInRowGroup' rows or when its encoded
+// pages take 'bytesInRowGroup' bytes.
+class RowGroupFlushPolicy : public dwio::common::FlushPolicy {
+ public:
+  RowGroupFlushPolicy(uint64_t rowsInRowGroup, int64_t bytesInRowGroup)
+      : rowsInRowGroup_(rowsInRowGroup), bytesInRowGroup_(bytesInRowGroup) {}
+
+  bool shouldFlush(const dwio::common::StripeProgress& progress) override {
+    return progress.stripeRowCount >= rowsInRowGroup_ ||
+        progress.stripeSizeEstimate >= bytesInRowGroup_;
+  }
+
+  void onClose() override {}
+
+ private:
+  const uint64_t rowsInRowGroup_;
+  const int64_t bytesInRowGroup_;
+};
+
+struct NativeWriterOptions {
+  // Target size of the encoded levels and values of a data page.
+  int32_t dataPageSize{1 << 20};
+
+  // If true, a column chunk is dictionary encoded until its dictionary
+  // exceeds 'dictionaryPageSizeLimit' bytes. The pages after that are PLAIN.
+  bool enableDictionary{true};
+  int32_t dictionaryPageSizeLimit{1 << 20};
+
+  // One of UNCOMPRESSED, SNAPPY or ZSTD.
+  thrift::CompressionCodec::type codec{thrift::CompressionCodec::UNCOMPRESSED};
+
+  // Decides when to end a row group. The progress has the rows and the
+  // encoded bytes of the row group. Defaults to a RowGroupFlushPolicy of 1M
+  // rows and 128MB.
+  std::unique_ptr<dwio::common::FlushPolicy> flushPolicy;
+};
+
+// Writes Velox vectors into a DataSink as Parquet without going through
+// Arrow. The values are encoded straight from the vectors. The values of a
+// DictionaryVector are added to the dictionary of the column chunk once per
+// distinct base value. The pages of a row group are held in buffers of
+// 'pool' and each column chunk is written to the sink as the row group
+// ends. Supports top level columns of BOOLEAN, TINYINT, SMALLINT, INTEGER,
+// BIGINT, REAL, DOUBLE, VARCHAR and VARBINARY. Writer still covers the other
+// types through Arrow.
+class NativeWriter {
+ public:
+  NativeWriter(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      memory::MemoryPool& pool,
+      NativeWriterOptions options = {});
+
+  ~NativeWriter();
+
+  // Appends 'data' into the writer. All calls must have the same type.
+  void write(const RowVectorPtr& data);
+
+  // Ends the current row group if it has rows.
+  void flush();
+
+  // Ends the last row group and writes the footer. No data can be added
+  // after close.
+  void close();
+
+ private:
+  void initialize(const RowTypePtr& type);
+
+  dwio::common::StripeProgress progress() const;
+
+  memory::MemoryPool& pool_;
+  std::unique_ptr<dwio::common::DataSink> sink_;
+  NativeWriterOptions options_;
+  RowTypePtr type_;
+  std::vector<std::unique_ptr<ColumnChunkWriter>> columns_;
+  std::vector<thrift::RowGroup> rowGroups_;
+  // Rows in the current row group.
+  uint64_t rowGroupRows_{0};
+  int64_t numRows_{0};
+  bool closed_{false};
+};
+
+} // namespace facebook::velox::parquet
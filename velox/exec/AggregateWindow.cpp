@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/AggregateWindow.h"
+
+#include <numeric>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/exec/Aggregate.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/WindowFunction.h"
+#include "velox/expression/FunctionSignature.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+
+// Computes an aggregate over the frames of the rows of a partition. The
+// accumulators of the rows of the partition are the leaves of a segment tree
+// in which each inner node holds the combined accumulators of its two
+// children. The aggregate over a frame combines the intermediate results of
+// the O(log n) nodes that cover the frame, so that sliding frames cost
+// O(n log n) per partition instead of O(n * frame size). The nodes are
+// combined in the order of their rows for order sensitive aggregates like
+// array_agg.
+class AggregateWindowFunction : public WindowFunction {
+ public:
+  AggregateWindowFunction(
+      const std::string& name,
+      const std::vector<WindowFunctionArg>& args,
+      const TypePtr& resultType,
+      memory::MemoryPool* pool)
+      : WindowFunction(resultType, pool),
+        args_(args),
+        mappedMemory_(memory::MappedMemory::getInstance()->addChild(
+            pool->getMemoryUsageTracker())),
+        stringAllocator_(mappedMemory_.get()) {
+    std::vector<TypePtr> argTypes;
+    argTypes.reserve(args.size());
+    for (const auto& arg : args) {
+      argTypes.push_back(arg.type);
+    }
+    aggregate_ = Aggregate::create(
+        name, core::AggregationNode::Step::kSingle, argTypes, resultType);
+    aggregate_->setAllocator(&stringAllocator_);
+
+    // Each accumulator is on its own row with the null flag in the first
+    // byte and the row size at kRowSizeOffset, as in a global aggregation.
+    const auto alignment = std::max<int32_t>(
+        aggregate_->accumulatorAlignmentSize(), sizeof(uint64_t));
+    const auto offset =
+        bits::roundUp(kRowSizeOffset + sizeof(uint32_t), alignment);
+    aggregate_->setOffsets(
+        offset,
+        RowContainer::nullByte(0),
+        RowContainer::nullMask(0),
+        kRowSizeOffset);
+    rowSize_ = bits::roundUp(
+        offset + aggregate_->accumulatorFixedWidthSize(), alignment);
+  }
+
+  ~AggregateWindowFunction() override {
+    clearTree();
+  }
+
+  void resetPartition(const WindowPartition* partition) override {
+    clearTree();
+    partition_ = partition;
+  }
+
+  void apply(
+      const BufferPtr& /*peerGroupStarts*/,
+      const BufferPtr& /*peerGroupEnds*/,
+      const BufferPtr& frameStarts,
+      const BufferPtr& frameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) override {
+    if (nodes_.empty()) {
+      buildTree();
+    }
+    const auto numRows = frameStarts->size() / sizeof(vector_size_t);
+    const auto* rawFrameStarts = frameStarts->as<vector_size_t>();
+    const auto* rawFrameEnds = frameEnds->as<vector_size_t>();
+
+    std::vector<char*> groups;
+    auto groupsBuffer = allocateGroups(numRows, groups);
+
+    // Collects the nodes to combine into the accumulator of each row. A row
+    // with an empty frame keeps its initial accumulator.
+    const vector_size_t numLeaves = partition_->numRows();
+    combineGroups_.clear();
+    combineNodes_.clear();
+    for (auto i = 0; i < numRows; ++i) {
+      auto left = rawFrameStarts[i] + numLeaves;
+      auto right = rawFrameEnds[i] + numLeaves + 1;
+      rightNodes_.clear();
+      for (; left < right; left /= 2, right /= 2) {
+        if (left & 1) {
+          combineGroups_.push_back(groups[i]);
+          combineNodes_.push_back(left++);
+        }
+        if (right & 1) {
+          rightNodes_.push_back(--right);
+        }
+      }
+      for (auto it = rightNodes_.rbegin(); it != rightNodes_.rend(); ++it) {
+        combineGroups_.push_back(groups[i]);
+        combineNodes_.push_back(*it);
+      }
+    }
+
+    if (!combineNodes_.empty()) {
+      const vector_size_t numCombined = combineNodes_.size();
+      auto indices = allocateIndices(numCombined, pool_);
+      std::copy(
+          combineNodes_.begin(),
+          combineNodes_.end(),
+          indices->asMutable<vector_size_t>());
+      auto intermediates = BaseVector::wrapInDictionary(
+          nullptr, indices, numCombined, nodeIntermediates_);
+      aggregate_->addIntermediateResults(
+          combineGroups_.data(),
+          SelectivityVector(numCombined),
+          {intermediates},
+          false);
+    }
+
+    auto values = BaseVector::create(resultType_, numRows, pool_);
+    aggregate_->finalize(groups.data(), numRows);
+    aggregate_->extractValues(groups.data(), numRows, &values);
+    aggregate_->destroy(folly::Range(groups.data(), groups.size()));
+    result->copy(values.get(), resultOffset, 0, numRows);
+  }
+
+ private:
+  static constexpr int32_t kRowSizeOffset = 4;
+
+  // Returns a buffer of 'numGroups' initialized accumulator rows and sets
+  // 'groups' to point to them.
+  BufferPtr allocateGroups(
+      vector_size_t numGroups,
+      std::vector<char*>& groups) {
+    auto buffer =
+        AlignedBuffer::allocate<char>(numGroups * rowSize_, pool_, char(0));
+    auto* rawBuffer = buffer->asMutable<char>();
+    groups.resize(numGroups);
+    for (auto i = 0; i < numGroups; ++i) {
+      groups[i] = rawBuffer + i * rowSize_;
+    }
+    std::vector<vector_size_t> indices(numGroups);
+    std::iota(indices.begin(), indices.end(), 0);
+    aggregate_->initializeNewGroups(groups.data(), indices);
+    return buffer;
+  }
+
+  // Builds the segment tree over the rows of 'partition_'. The leaves are
+  // nodes n to 2n - 1 for n rows and node i combines nodes 2i and 2i + 1.
+  // Node 0 is not used.
+  void buildTree() {
+    const vector_size_t numLeaves = partition_->numRows();
+    const vector_size_t numNodes = 2 * numLeaves;
+    nodesBuffer_ = allocateGroups(numNodes, nodes_);
+
+    std::vector<VectorPtr> args;
+    args.reserve(args_.size());
+    for (const auto& arg : args_) {
+      if (arg.constantValue) {
+        args.push_back(
+            BaseVector::wrapInConstant(numLeaves, 0, arg.constantValue));
+      } else {
+        auto column = BaseVector::create(arg.type, numLeaves, pool_);
+        partition_->extractColumn(arg.index.value(), 0, numLeaves, 0, column);
+        args.push_back(std::move(column));
+      }
+    }
+    aggregate_->addRawInput(
+        nodes_.data() + numLeaves, SelectivityVector(numLeaves), args, false);
+
+    // Combines the nodes a level at a time. The parents of the nodes from
+    // 'first' on are complete once all these nodes are.
+    std::vector<char*> parents;
+    VectorPtr children;
+    for (auto first = numLeaves; first > 1;) {
+      const auto firstParent = (first + 1) / 2;
+      const auto firstChild = 2 * firstParent;
+      const auto numChildren = 2 * first - firstChild;
+      parents.resize(numChildren);
+      for (auto i = 0; i < numChildren; ++i) {
+        parents[i] = nodes_[(firstChild + i) / 2];
+      }
+      aggregate_->finalize(nodes_.data() + firstChild, numChildren);
+      aggregate_->extractAccumulators(
+          nodes_.data() + firstChild, numChildren, &children);
+      aggregate_->addIntermediateResults(
+          parents.data(), SelectivityVector(numChildren), {children}, false);
+      first = firstParent;
+    }
+    // Nodes 0 and 1 are no node's children.
+    aggregate_->finalize(nodes_.data(), 2);
+    aggregate_->extractAccumulators(
+        nodes_.data(), numNodes, &nodeIntermediates_);
+  }
+
+  void clearTree() {
+    if (!nodes_.empty()) {
+      aggregate_->destroy(folly::Range(nodes_.data(), nodes_.size()));
+      nodes_.clear();
+    }
+    nodesBuffer_.reset();
+    nodeIntermediates_.reset();
+  }
+
+  std::vector<WindowFunctionArg> args_;
+  std::unique_ptr<Aggregate> aggregate_;
+  std::shared_ptr<memory::MappedMemory> mappedMemory_;
+  HashStringAllocator stringAllocator_;
+  // Size of an accumulator row, a multiple of its alignment.
+  int32_t rowSize_;
+
+  const WindowPartition* partition_{nullptr};
+
+  // The accumulators of the nodes of the segment tree over 'partition_' and
+  // their intermediate results. Empty until the first apply() over the
+  // partition.
+  BufferPtr nodesBuffer_;
+  std::vector<char*> nodes_;
+  VectorPtr nodeIntermediates_;
+
+  // Reused in apply() for the accumulators to combine the nodes into.
+  std::vector<char*> combineGroups_;
+  std::vector<vector_size_t> combineNodes_;
+  std::vector<vector_size_t> rightNodes_;
+};
+
+} // namespace
+
+void registerAggregateWindowFunction(const std::string& name) {
+  auto aggregateSignatures = getAggregateFunctionSignatures(name);
+  VELOX_CHECK(
+      aggregateSignatures.has_value(),
+      "Aggregate function not registered: {}",
+      name);
+  std::vector<FunctionSignaturePtr> signatures{
+      aggregateSignatures->begin(), aggregateSignatures->end()};
+  registerWindowFunction(
+      name,
+      std::move(signatures),
+      [name](
+          const std::vector<WindowFunctionArg>& args,
+          const TypePtr& resultType,
+          bool /*ignoreNulls*/,
+          memory::MemoryPool* pool) -> std::unique_ptr<WindowFunction> {
+        return std::make_unique<AggregateWindowFunction>(
+            name, args, resultType, pool);
+      });
+}
+
+} // namespace facebook::velox::exec
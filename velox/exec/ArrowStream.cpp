@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/ArrowStream.h"
+#include "velox/vector/arrow/Abi.h"
+#include "velox/vector/arrow/Bridge.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+std::string lastError(ArrowArrayStream& stream) {
+  const char* error = stream.get_last_error(&stream);
+  return error ? error : "unknown error";
+}
+} // namespace
+
+ArrowStream::ArrowStream(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    std::shared_ptr<const core::ArrowStreamNode> arrowStreamNode)
+    : SourceOperator(
+          driverCtx,
+          arrowStreamNode->outputType(),
+          operatorId,
+          arrowStreamNode->id(),
+          "ArrowStream"),
+      arrowStream_(arrowStreamNode->arrowStream()) {}
+
+RowVectorPtr ArrowStream::getOutput() {
+  if (finished_) {
+    return nullptr;
+  }
+  ArrowArray arrowArray;
+  if (arrowStream_->get_next(arrowStream_.get(), &arrowArray) != 0) {
+    VELOX_FAIL(
+        "Failed to get the next batch of an ArrowArrayStream: {}",
+        lastError(*arrowStream_));
+  }
+  // A released array marks the end of the stream.
+  if (arrowArray.release == nullptr) {
+    finished_ = true;
+    return nullptr;
+  }
+
+  // Importing as owner releases the schema with the batch, so each batch
+  // gets its own copy of the schema.
+  ArrowSchema arrowSchema;
+  if (arrowStream_->get_schema(arrowStream_.get(), &arrowSchema) != 0) {
+    arrowArray.release(&arrowArray);
+    VELOX_FAIL(
+        "Failed to get the schema of an ArrowArrayStream: {}",
+        lastError(*arrowStream_));
+  }
+  auto vector = importFromArrowAsOwner(arrowSchema, arrowArray, pool());
+  VELOX_CHECK(
+      vector->type()->isRow(),
+      "ArrowArrayStream must produce struct arrays, got {}",
+      vector->type()->toString());
+  VELOX_CHECK(
+      vector->type()->kindEquals(outputType_),
+      "ArrowArrayStream produced {}, expected {}",
+      vector->type()->toString(),
+      outputType_->toString());
+  // Names come from the plan rather than from the stream.
+  return std::make_shared<RowVector>(
+      pool(),
+      outputType_,
+      vector->nulls(),
+      vector->size(),
+      vector->asUnchecked<RowVector>()->children());
+}
+
+void ArrowStream::close() {
+  finished_ = true;
+  Operator::close();
+}
+
+} // namespace facebook::velox::exec
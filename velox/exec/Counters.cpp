@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/Counters.h"
+
+#include <array>
+
+#include "velox/common/base/StatsReporter.h"
+#include "velox/common/memory/MappedMemory.h"
+#include "velox/exec/Driver.h"
+
+namespace facebook::velox::exec {
+namespace {
+constexpr int32_t kNumBlockingReasons =
+    static_cast<int32_t>(BlockingReason::kWaitForPeers) + 1;
+
+using ReasonKeys = std::array<std::string, kNumBlockingReasons>;
+
+ReasonKeys makeReasonKeys(const std::string& prefix) {
+  ReasonKeys keys;
+  for (auto i = 0; i < kNumBlockingReasons; ++i) {
+    keys[i] =
+        prefix + blockingReasonToString(static_cast<BlockingReason>(i));
+  }
+  return keys;
+}
+
+const ReasonKeys& blockedCountKeys() {
+  static const ReasonKeys keys = makeReasonKeys("velox.driver_blocked_count.");
+  return keys;
+}
+
+const ReasonKeys& blockedTimeKeys() {
+  static const ReasonKeys keys = makeReasonKeys("velox.driver_blocked_ms.");
+  return keys;
+}
+} // namespace
+
+const std::string& driverBlockedCountKey(BlockingReason reason) {
+  return blockedCountKeys()[static_cast<int32_t>(reason)];
+}
+
+const std::string& driverBlockedTimeKey(BlockingReason reason) {
+  return blockedTimeKeys()[static_cast<int32_t>(reason)];
+}
+
+void registerVeloxCounters() {
+  for (auto key :
+       {kCounterCacheNumHit,
+        kCounterCacheNumNew,
+        kCounterCacheNumEvict,
+        kCounterSsdBytesRead,
+        kCounterSsdBytesWritten,
+        kCounterSsdEntriesRead,
+        kCounterSsdEntriesWritten,
+        kCounterMemoryNumAdvisedPages,
+        kCounterMemoryNumAdvisedHugePages,
+        kCounterSpillBytes,
+        kCounterSpillRows,
+        kCounterSpillFiles,
+        kCounterSpillWriteTimeUs,
+        kCounterSpillReadTimeUs}) {
+    REPORT_ADD_STAT_EXPORT_TYPE(key, StatType::SUM);
+  }
+  for (auto key :
+       {kCounterCacheBytes,
+        kCounterCacheNumEntries,
+        kCounterMemoryAllocatedBytes,
+        kCounterMemoryMappedBytes,
+        kCounterMemoryExternalMappedBytes,
+        kCounterExchangeQueueBytes,
+        kCounterExchangePageWaitMs,
+        kCounterDriverNumBlocked,
+        kCounterDriverQueuedTimeMs}) {
+    REPORT_ADD_STAT_EXPORT_TYPE(key, StatType::AVG);
+  }
+  for (auto i = 0; i < memory::Stats::kNumSizes; ++i) {
+    REPORT_ADD_STAT_EXPORT_TYPE(
+        folly::StringPiece(
+            kCounterMemoryNumAllocationsPrefix + std::to_string(1 << i)),
+        StatType::SUM);
+  }
+  for (auto i = 0; i < kNumBlockingReasons; ++i) {
+    REPORT_ADD_STAT_EXPORT_TYPE(
+        folly::StringPiece(blockedCountKeys()[i]), StatType::COUNT);
+    REPORT_ADD_STAT_EXPORT_TYPE(
+        folly::StringPiece(blockedTimeKeys()[i]), StatType::SUM);
+  }
+}
+
+} // namespace facebook::velox::exec
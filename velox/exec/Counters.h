@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace facebook::velox::exec {
+
+enum class BlockingReason;
+
+/// Registers the export types of the process-wide stats that Velox reports
+/// through StatsReporter. Call once at startup after setting up the
+/// BaseStatsReporter singleton. Counters count events, sums add up the
+/// changes of cumulative values and gauges average the sampled values.
+void registerVeloxCounters();
+
+/// Returns the key of the count of Drivers that went off thread for
+/// 'reason'.
+const std::string& driverBlockedCountKey(BlockingReason reason);
+
+/// Returns the key of the time Drivers were blocked for 'reason'.
+const std::string& driverBlockedTimeKey(BlockingReason reason);
+
+// AsyncDataCache. Sums of the changes between reports.
+constexpr const char* kCounterCacheNumHit = "velox.cache_num_hit";
+constexpr const char* kCounterCacheNumNew = "velox.cache_num_new";
+constexpr const char* kCounterCacheNumEvict = "velox.cache_num_evict";
+constexpr const char* kCounterSsdBytesRead = "velox.ssd_cache_bytes_read";
+constexpr const char* kCounterSsdBytesWritten =
+    "velox.ssd_cache_bytes_written";
+constexpr const char* kCounterSsdEntriesRead = "velox.ssd_cache_entries_read";
+constexpr const char* kCounterSsdEntriesWritten =
+    "velox.ssd_cache_entries_written";
+// AsyncDataCache. Gauges.
+constexpr const char* kCounterCacheBytes = "velox.cache_bytes";
+constexpr const char* kCounterCacheNumEntries = "velox.cache_num_entries";
+
+// MappedMemory. Gauges.
+constexpr const char* kCounterMemoryAllocatedBytes =
+    "velox.memory_allocated_bytes";
+constexpr const char* kCounterMemoryMappedBytes = "velox.memory_mapped_bytes";
+constexpr const char* kCounterMemoryExternalMappedBytes =
+    "velox.memory_external_mapped_bytes";
+// MappedMemory. Sums of the changes between reports.
+constexpr const char* kCounterMemoryNumAdvisedPages =
+    "velox.memory_num_advised_pages";
+constexpr const char* kCounterMemoryNumAdvisedHugePages =
+    "velox.memory_num_advised_huge_pages";
+// Followed by the size class in pages, e.g. velox.memory_num_allocations.16.
+// Only counted with --velox_time_allocations.
+constexpr const char* kCounterMemoryNumAllocationsPrefix =
+    "velox.memory_num_allocations.";
+
+// ExchangeClient. Gauges sampled at each read from the queue.
+constexpr const char* kCounterExchangeQueueBytes = "velox.exchange_queue_bytes";
+constexpr const char* kCounterExchangePageWaitMs =
+    "velox.exchange_page_wait_ms";
+
+// Spiller. Sums.
+constexpr const char* kCounterSpillBytes = "velox.spill_bytes";
+constexpr const char* kCounterSpillRows = "velox.spill_rows";
+constexpr const char* kCounterSpillFiles = "velox.spill_files";
+constexpr const char* kCounterSpillWriteTimeUs = "velox.spill_write_time_us";
+constexpr const char* kCounterSpillReadTimeUs = "velox.spill_read_time_us";
+
+// Driver. Gauges.
+constexpr const char* kCounterDriverNumBlocked = "velox.driver_num_blocked";
+constexpr const char* kCounterDriverQueuedTimeMs =
+    "velox.driver_queued_time_ms";
+
+} // namespace facebook::velox::exec
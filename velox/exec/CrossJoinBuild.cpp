@@ -14,16 +14,20 @@
  * limitations under the License.
  */
 #include "velox/exec/CrossJoinBuild.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
 
-void CrossJoinBridge::setData(std::vector<VectorPtr> data) {
+void CrossJoinBridge::setData(
+    std::vector<VectorPtr> data,
+    std::shared_ptr<const SpillFiles> spillFiles) {
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!data_.has_value(), "setData may be called only once");
     data_ = std::move(data);
+    spillFiles_ = std::move(spillFiles);
     promises = std::move(promises_);
   }
   notify(std::move(promises));
@@ -41,6 +45,12 @@ std::optional<std::vector<VectorPtr>> CrossJoinBridge::dataOrFuture(
   return std::nullopt;
 }
 
+std::shared_ptr<const SpillFiles> CrossJoinBridge::spillFiles() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(data_.has_value(), "Getting spill files before the data");
+  return spillFiles_;
+}
+
 CrossJoinBuild::CrossJoinBuild(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -50,7 +60,14 @@ CrossJoinBuild::CrossJoinBuild(
           nullptr,
           operatorId,
           joinNode->id(),
-          "CrossJoinBuild") {}
+          "CrossJoinBuild"),
+      spillConfig_(makeOperatorSpillConfig(
+          *operatorCtx_->task()->queryCtx(),
+          *operatorCtx_,
+          core::QueryConfig::kJoinSpillEnabled,
+          core::QueryConfig::kJoinSpillCompressionCodec,
+          operatorId)),
+      spillBuildBytes_{driverCtx->queryConfig().crossJoinSpillBuildBytes()} {}
 
 void CrossJoinBuild::addInput(RowVectorPtr input) {
   if (input->size() > 0) {
@@ -58,10 +75,48 @@ void CrossJoinBuild::addInput(RowVectorPtr input) {
     for (auto& child : input->children()) {
       child->loadedVector();
     }
+    dataBytes_ += input->retainedSize();
     data_.emplace_back(std::move(input));
+    if (spillConfig_.has_value() && dataBytes_ >= spillBuildBytes_) {
+      spillData();
+    }
   }
 }
 
+void CrossJoinBuild::spillData() {
+  if (data_.empty()) {
+    return;
+  }
+  if (spill_ == nullptr) {
+    spill_ = std::make_unique<SpillFileList>(
+        std::static_pointer_cast<const RowType>(data_[0]->type()),
+        0,
+        std::vector<CompareFlags>(),
+        spillConfig_->filePath,
+        operatorCtx_->task()
+                ->queryCtx()
+                ->pool()
+                ->getMemoryUsageTracker()
+                ->maxTotalBytes() *
+            spillConfig_->fileSizeFactor,
+        Spiller::spillPool(),
+        *operatorCtx_->mappedMemory(),
+        spillConfig_->compressionKind,
+        spillConfig_->executor,
+        spillConfig_->writeOptions);
+  }
+  for (const auto& data : data_) {
+    auto rowVector = std::static_pointer_cast<RowVector>(data);
+    IndexRange range{0, rowVector->size()};
+    spill_->write(rowVector, folly::Range<IndexRange*>(&range, 1));
+    stats_.spilledRows += rowVector->size();
+  }
+  stats_.spilledBytes = spill_->spilledBytes();
+  stats_.spilledUncompressedBytes = spill_->spilledUncompressedBytes();
+  data_.clear();
+  dataBytes_ = 0;
+}
+
 BlockingReason CrossJoinBuild::isBlocked(ContinueFuture* future) {
   if (!future_.valid()) {
     return BlockingReason::kNotBlocked;
@@ -72,6 +127,10 @@ BlockingReason CrossJoinBuild::isBlocked(ContinueFuture* future) {
 
 void CrossJoinBuild::noMoreInput() {
   Operator::noMoreInput();
+  // Once spilled, streams all of the input of this driver from disk.
+  if (spill_ != nullptr) {
+    spillData();
+  }
   std::vector<ContinuePromise> promises;
   std::vector<std::shared_ptr<Driver>> peers;
   // The last Driver to hit CrossJoinBuild::finish gathers the data from
@@ -84,11 +143,24 @@ void CrossJoinBuild::noMoreInput() {
     return;
   }
 
+  SpillFiles spillFiles;
+  if (spill_ != nullptr) {
+    spillFiles = spill_->files();
+    spill_.reset();
+  }
   for (auto& peer : peers) {
     auto op = peer->findOperator(planNodeId());
     auto* build = dynamic_cast<CrossJoinBuild*>(op);
     VELOX_CHECK(build);
     data_.insert(data_.begin(), build->data_.begin(), build->data_.end());
+    if (build->spill_ != nullptr) {
+      auto files = build->spill_->files();
+      build->spill_.reset();
+      spillFiles.insert(
+          spillFiles.end(),
+          std::make_move_iterator(files.begin()),
+          std::make_move_iterator(files.end()));
+    }
   }
 
   // Realize the promises so that the other Drivers (which were not
@@ -101,7 +173,11 @@ void CrossJoinBuild::noMoreInput() {
   operatorCtx_->task()
       ->getCrossJoinBridge(
           operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-      ->setData(std::move(data_));
+      ->setData(
+          std::move(data_),
+          spillFiles.empty()
+              ? nullptr
+              : std::make_shared<const SpillFiles>(std::move(spillFiles)));
 }
 
 bool CrossJoinBuild::isFinished() {
@@ -17,17 +17,28 @@
 
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spill.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
 class CrossJoinBridge : public JoinBridge {
  public:
-  void setData(std::vector<VectorPtr> data);
+  /// Sets the build side input. 'spillFiles' has the part of the input that
+  /// did not fit in memory, if any.
+  void setData(
+      std::vector<VectorPtr> data,
+      std::shared_ptr<const SpillFiles> spillFiles = nullptr);
 
   std::optional<std::vector<VectorPtr>> dataOrFuture(ContinueFuture* future);
 
+  /// Returns the spilled build side input. May be called after dataOrFuture()
+  /// returned the data. Returns nullptr if nothing was spilled.
+  std::shared_ptr<const SpillFiles> spillFiles();
+
  private:
   std::optional<std::vector<VectorPtr>> data_;
+  std::shared_ptr<const SpillFiles> spillFiles_;
 };
 
 class CrossJoinBuild : public Operator {
@@ -55,12 +66,27 @@ class CrossJoinBuild : public Operator {
 
   void close() override {
     data_.clear();
+    spill_.reset();
     Operator::close();
   }
 
  private:
+  // Writes 'data_' to 'spill_' and clears 'data_'.
+  void spillData();
+
+  const std::optional<Spiller::Config> spillConfig_;
+
+  // Max total retained size of 'data_' before spilling.
+  const uint64_t spillBuildBytes_;
+
   std::vector<VectorPtr> data_;
 
+  // Retained size of 'data_'.
+  uint64_t dataBytes_{0};
+
+  // Build side input that did not fit in memory. Created on the first spill.
+  std::unique_ptr<SpillFileList> spill_;
+
   // Future for synchronizing with other Drivers of the same pipeline. All build
   // Drivers must be completed before making data available for the probe side.
   ContinueFuture future_{ContinueFuture::makeEmpty()};
@@ -71,8 +71,13 @@ BlockingReason CrossJoinProbe::isBlocked(ContinueFuture* future) {
   }
 
   buildData_ = std::move(buildData);
+  spillFiles_ =
+      operatorCtx_->task()
+          ->getCrossJoinBridge(
+              operatorCtx_->driverCtx()->splitGroupId, planNodeId())
+          ->spillFiles();
 
-  if (buildData_->empty()) {
+  if (buildData_->empty() && spillFiles_ == nullptr) {
     // Build side is empty. Return empty set of rows and  terminate the pipeline
     // early.
     buildSideEmpty_ = true;
@@ -91,6 +96,46 @@ void CrossJoinProbe::addInput(RowVectorPtr input) {
   input_ = std::move(input);
 }
 
+RowVectorPtr CrossJoinProbe::currentBuild() {
+  if (buildIndex_ < buildData_->size()) {
+    return std::static_pointer_cast<RowVector>(
+        buildData_.value()[buildIndex_]);
+  }
+  if (spillBatch_ != nullptr) {
+    return spillBatch_;
+  }
+  if (spillFiles_ == nullptr) {
+    return nullptr;
+  }
+  while (spillFileIndex_ < spillFiles_->size()) {
+    const auto& file = (*spillFiles_)[spillFileIndex_];
+    if (spillInput_ == nullptr) {
+      spillInput_ = file->openInput(*pool());
+    }
+    if (file->readBatch(*spillInput_, *pool(), spillBatch_)) {
+      return spillBatch_;
+    }
+    spillInput_.reset();
+    ++spillFileIndex_;
+  }
+  return nullptr;
+}
+
+bool CrossJoinProbe::advanceBuild() {
+  if (buildIndex_ < buildData_->size()) {
+    ++buildIndex_;
+  } else {
+    spillBatch_ = nullptr;
+  }
+  if (currentBuild() != nullptr) {
+    return true;
+  }
+  buildIndex_ = 0;
+  spillFileIndex_ = 0;
+  spillInput_.reset();
+  return false;
+}
+
 RowVectorPtr CrossJoinProbe::getOutput() {
   if (!input_) {
     return nullptr;
@@ -98,7 +143,9 @@ RowVectorPtr CrossJoinProbe::getOutput() {
 
   const auto inputSize = input_->size();
 
-  auto buildSize = buildData_.value()[buildIndex_]->size();
+  auto build = currentBuild();
+  VELOX_CHECK_NOT_NULL(build);
+  auto buildSize = build->size();
   vector_size_t probeCnt;
   if (buildSize > outputBatchSize_) {
     probeCnt = 1;
@@ -130,10 +177,8 @@ RowVectorPtr CrossJoinProbe::getOutput() {
     }
   }
 
-  auto buildRowVector =
-      buildData_.value()[buildIndex_]->asUnchecked<RowVector>();
   for (const auto& projection : buildProjections_) {
-    VectorPtr buildVector = buildRowVector->childAt(projection.inputChannel);
+    VectorPtr buildVector = build->childAt(projection.inputChannel);
 
     if (buildIndices) {
       buildVector = BaseVector::wrapInDictionary(
@@ -145,9 +190,7 @@ RowVectorPtr CrossJoinProbe::getOutput() {
   probeRow_ += probeCnt;
   if (probeRow_ == inputSize) {
     probeRow_ = 0;
-    ++buildIndex_;
-    if (buildIndex_ == buildData_->size()) {
-      buildIndex_ = 0;
+    if (!advanceBuild()) {
       input_.reset();
     }
   }
@@ -160,6 +203,9 @@ bool CrossJoinProbe::isFinished() {
 
 void CrossJoinProbe::close() {
   buildData_.reset();
+  spillBatch_.reset();
+  spillInput_.reset();
+  spillFiles_.reset();
   Operator::close();
 }
 } // namespace facebook::velox::exec
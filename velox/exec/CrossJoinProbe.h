@@ -41,6 +41,15 @@ class CrossJoinProbe : public Operator {
   void close() override;
 
  private:
+  // Returns the build side vector to join with 'input_' on next call to
+  // getOutput(). Reads the next spilled vector if the in-memory ones are done.
+  // Returns nullptr after the last build side vector.
+  RowVectorPtr currentBuild();
+
+  // Moves to the next build side vector. Returns false and starts over from
+  // the first one after the last.
+  bool advanceBuild();
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
@@ -52,6 +61,19 @@ class CrossJoinProbe : public Operator {
   // getOutput().
   size_t buildIndex_{0};
 
+  // Build side vectors that did not fit in memory. These are read back for
+  // each probe side input after the ones in 'buildData_'.
+  std::shared_ptr<const SpillFiles> spillFiles_;
+
+  // Index into 'spillFiles_' of the file being read.
+  size_t spillFileIndex_{0};
+
+  // Stream over the file being read.
+  std::unique_ptr<SpillInput> spillInput_;
+
+  // The spilled build side vector being joined.
+  RowVectorPtr spillBatch_;
+
   // Input row to process on next call to getOutput().
   vector_size_t probeRow_{0};
 
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/DecodedVectorCache.h"
+
+#include <algorithm>
+
+namespace facebook::velox::exec {
+
+const DecodedVector& DecodedVectorCache::decode(
+    const VectorPtr& vector,
+    const SelectivityVector& rows) {
+  for (auto& entry : entries_) {
+    if (entry->vector.get() == vector.get() && covers(entry->rows, rows)) {
+      ++stats_.numHits;
+      return entry->decoded;
+    }
+  }
+  ++stats_.numMisses;
+  std::unique_ptr<Entry> entry;
+  if (freeEntries_.empty()) {
+    entry = std::make_unique<Entry>();
+  } else {
+    entry = std::move(freeEntries_.back());
+    freeEntries_.pop_back();
+  }
+  entry->vector = vector;
+  entry->rows = rows;
+  entry->decoded.decode(*vector, rows);
+  entry->operatorIndex = operatorIndex_;
+  entries_.push_back(std::move(entry));
+  return entries_.back()->decoded;
+}
+
+void DecodedVectorCache::startOperator(int32_t operatorIndex) {
+  operatorIndex_ = operatorIndex;
+  auto it = std::partition(
+      entries_.begin(), entries_.end(), [&](const auto& entry) {
+        return entry->operatorIndex <= operatorIndex;
+      });
+  for (auto dropped = it; dropped != entries_.end(); ++dropped) {
+    release(std::move(*dropped));
+  }
+  entries_.erase(it, entries_.end());
+}
+
+void DecodedVectorCache::clear() {
+  for (auto& entry : entries_) {
+    release(std::move(entry));
+  }
+  entries_.clear();
+}
+
+void DecodedVectorCache::release(std::unique_ptr<Entry> entry) {
+  // Keeps the decoding memory but not the vector.
+  entry->vector = nullptr;
+  freeEntries_.push_back(std::move(entry));
+}
+
+// static
+bool DecodedVectorCache::covers(
+    const SelectivityVector& decodedRows,
+    const SelectivityVector& rows) {
+  if (rows.end() > decodedRows.size()) {
+    return false;
+  }
+  if (decodedRows.isAllSelected()) {
+    return true;
+  }
+  const auto* rowBits = rows.asRange().bits();
+  const auto* decodedBits = decodedRows.asRange().bits();
+  return bits::testWords(
+      rows.begin(),
+      rows.end(),
+      [&](int32_t index, uint64_t mask) {
+        return (rowBits[index] & ~decodedBits[index] & mask) == 0;
+      },
+      [&](int32_t index) {
+        return (rowBits[index] & ~decodedBits[index]) == 0;
+      });
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::exec {
+
+/// Decodings of the vectors that pass through the operators of a Driver. A
+/// column that flows unchanged through several operators is decoded once
+/// and the later operators get the cached decoding. The DecodedVectors are
+/// pooled and reused for the next vectors.
+///
+/// The Driver calls startOperator() before each call into an operator. The
+/// decodings cached by the operators downstream of it are then dropped, since
+/// the operator and its upstream may reuse and overwrite the vectors that
+/// they produced. A cached vector is referenced by the cache, so it is not
+/// singly referenced and can't be changed in place while cached.
+class DecodedVectorCache {
+ public:
+  struct Stats {
+    uint64_t numHits{0};
+    uint64_t numMisses{0};
+  };
+
+  /// Returns a decoding of 'vector' for at least 'rows'. Returns the
+  /// decoding cached by this or an upstream operator if it covers 'rows',
+  /// else decodes 'vector' and caches the result. The decoding is valid
+  /// until the next startOperator() for an upstream operator or clear().
+  const DecodedVector& decode(
+      const VectorPtr& vector,
+      const SelectivityVector& rows);
+
+  /// Marks the start of a call into the operator at 'operatorIndex' in the
+  /// pipeline. Drops the decodings cached by the operators after it.
+  void startOperator(int32_t operatorIndex);
+
+  /// Drops all decodings, e.g. when the Driver closes.
+  void clear();
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+  const Stats& stats() const {
+    return stats_;
+  }
+
+ private:
+  struct Entry {
+    VectorPtr vector;
+    // The rows 'decoded' is valid for.
+    SelectivityVector rows;
+    DecodedVector decoded;
+    // The operator that decoded 'vector'.
+    int32_t operatorIndex;
+  };
+
+  // Returns true if all of 'rows' are in 'decodedRows'.
+  static bool covers(
+      const SelectivityVector& decodedRows,
+      const SelectivityVector& rows);
+
+  void release(std::unique_ptr<Entry> entry);
+
+  std::vector<std::unique_ptr<Entry>> entries_;
+  // Entries for reuse, with their DecodedVector and SelectivityVector
+  // memory.
+  std::vector<std::unique_ptr<Entry>> freeEntries_;
+  int32_t operatorIndex_{0};
+  Stats stats_;
+};
+
+} // namespace facebook::velox::exec
@@ -19,9 +19,15 @@
 #include <folly/executors/task_queue/UnboundedBlockingQueue.h>
 #include <folly/executors/thread_factory/InitThreadFactory.h>
 #include <gflags/gflags.h>
+#include "velox/common/base/StatsReporter.h"
+#include "velox/common/process/Numa.h"
 #include "velox/common/time/Timer.h"
+#include "velox/exec/Counters.h"
+#include "velox/exec/DriverTrace.h"
+#include "velox/exec/FairShareExecutor.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/Task.h"
+#include "velox/exec/WorkStealingExecutor.h"
 
 namespace facebook::velox::exec {
 
@@ -65,6 +71,7 @@ BlockingState::BlockingState(
   // Set before leaving the thread.
   driver_->state().hasBlockingFuture = true;
   numBlockedDrivers_++;
+  REPORT_ADD_STAT_VALUE(driverBlockedCountKey(reason));
 }
 
 // static
@@ -76,6 +83,27 @@ void BlockingState::setResume(std::shared_ptr<BlockingState> state) {
       .thenValue([state](auto&& /* unused */) {
         auto driver = state->driver_;
         auto task = driver->task();
+        // 'sinceMicros_' is on the clock of Operator::recordBlockingTime().
+        const uint64_t nowMicros =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now().time_since_epoch())
+                .count();
+        REPORT_ADD_STAT_VALUE(
+            driverBlockedTimeKey(state->reason_),
+            (nowMicros - state->sinceMicros_) / 1'000);
+
+        if (const auto traceId = driver->traceId()) {
+          DriverTraceEvent event;
+          event.traceId = traceId;
+          event.startMicros = state->sinceMicros_;
+          event.endMicros = getCurrentTimeMicro();
+          event.pipelineId = driver->driverCtx()->pipelineId;
+          event.driverId = driver->driverCtx()->driverId;
+          event.operatorId = state->operator_->stats().operatorId;
+          event.kind = DriverTraceEvent::Kind::kBlocked;
+          event.blockingReason = state->reason_;
+          recordDriverTrace(event);
+        }
 
         std::lock_guard<std::mutex> l(task->mutex());
         if (!driver->state().isTerminated) {
@@ -149,8 +177,26 @@ void Driver::enqueue(std::shared_ptr<Driver> driver) {
   if (driver->closed_) {
     return;
   }
-  driver->task()->queryCtx()->executor()->add(
-      [driver]() { Driver::run(driver); });
+  auto* executor = driver->task()->queryCtx()->executor();
+  if (auto* workStealing = dynamic_cast<WorkStealingExecutor*>(executor)) {
+    // Returns the Driver to the worker that last ran it, so that it finds its
+    // state in the caches of that core.
+    workStealing->addWithAffinity(
+        [driver, workStealing]() {
+          driver->lastWorker_ = workStealing->currentWorker();
+          Driver::run(driver);
+        },
+        driver->lastWorker_);
+    return;
+  }
+  if (auto* fairShare = dynamic_cast<FairShareExecutor*>(executor)) {
+    // Queues the Driver behind the Drivers of queries that have run less.
+    fairShare->add(
+        [driver]() { Driver::run(driver); },
+        driver->task()->queryCtx()->driverRunNanos());
+    return;
+  }
+  executor->add([driver]() { Driver::run(driver); });
 }
 
 Driver::Driver(
@@ -161,6 +207,10 @@ Driver::Driver(
   // Operators need access to their Driver for adaptation.
   ctx_->driver = this;
   trackOperatorCpuUsage_ = ctx_->queryConfig().operatorTrackCpuUsage();
+  trackOperatorPerfCounters_ =
+      ctx_->queryConfig().operatorTrackPerfCounters();
+  timeSliceMicros_ = ctx_->queryConfig().driverTimeSliceMs() * 1'000;
+  traceId_ = ctx_->task->driverTraceId();
 }
 
 namespace {
@@ -233,7 +283,10 @@ RowVectorPtr Driver::next(std::shared_ptr<BlockingState>& blockingState) {
 
   auto self = shared_from_this();
   RowVectorPtr result;
-  auto stop = runInternal(self, blockingState, result);
+  const auto queuedMicros = queueTimeStartMicros_;
+  const auto startMicros = getCurrentTimeMicro();
+  auto stop = runInternal(self, blockingState, result, false);
+  traceRun(queuedMicros, startMicros, getCurrentTimeMicro(), stop);
 
   // We get kBlock if 'result' was produced; kAtEnd if pipeline has finished
   // processing and no more results will be produced; kAlreadyTerminated on
@@ -255,8 +308,11 @@ void Driver::enqueueInternal() {
 StopReason Driver::runInternal(
     std::shared_ptr<Driver>& self,
     std::shared_ptr<BlockingState>& blockingState,
-    RowVectorPtr& result) {
+    RowVectorPtr& result,
+    bool timeSliced) {
+  const auto startMicros = getCurrentTimeMicro();
   auto queuedTime = (getCurrentTimeMicro() - queueTimeStartMicros_) * 1'000;
+  REPORT_ADD_STAT_VALUE(kCounterDriverQueuedTimeMs, queuedTime / 1'000'000);
   // Update the next operator's queueTime.
   auto stop = closed_ ? StopReason::kTerminate : task()->enter(state_);
   if (stop != StopReason::kNone) {
@@ -285,6 +341,17 @@ StopReason Driver::runInternal(
         RuntimeCounter(queuedTime, RuntimeCounter::Unit::kNanos));
   }
 
+  // Runs on the CPUs of the NUMA node of the Task while on an executor and
+  // then restores the affinity of the executor thread.
+  std::optional<process::ScopedNumaAffinity> numaAffinity;
+  if (timeSliced && task()->numaNode() != process::kNoNumaNode) {
+    numaAffinity.emplace(task()->numaNode());
+    if (numaAffinity->crossNode() && curOpIndex_ < operators_.size()) {
+      operators_[curOpIndex_]->stats().addRuntimeStat(
+          "crossNumaNodeRuns", RuntimeCounter(1));
+    }
+  }
+
   CancelGuard guard(task().get(), &state_, [&](StopReason reason) {
     // This is run on error or cancel exit.
     if (reason == StopReason::kTerminate) {
@@ -317,6 +384,13 @@ StopReason Driver::runInternal(
           guard.notThrown();
           return stop;
         }
+        if (timeSliced && timeSliceMicros_ > 0 &&
+            getCurrentTimeMicro() - startMicros >= timeSliceMicros_) {
+          operators_[i]->stats().addRuntimeStat(
+              "timeSliceYields", RuntimeCounter(1));
+          guard.notThrown();
+          return StopReason::kYield;
+        }
 
         auto op = operators_[i].get();
         // In case we are blocked, this index will point to the operator, whose
@@ -346,28 +420,47 @@ StopReason Driver::runInternal(
           }
           if (nextOp->needsInput()) {
             uint64_t resultBytes = 0;
+            vector_size_t resultRows = 0;
             RowVectorPtr result;
+            // The output rows of 'result' if only some of its rows are the
+            // output.
+            const SelectivityVector* outputRows = nullptr;
             {
               auto timer = cpuWallTimer(op->stats().getOutputTiming);
-              result = op->getOutput();
+              auto perfTimer = perfCounterTimer(op);
+              ctx_->decodedVectorCache.startOperator(i);
+              result = nextOp->supportsInputRows()
+                  ? op->getOutputRows(&outputRows)
+                  : op->getOutput();
               if (result) {
                 VELOX_CHECK(
                     result->size() > 0,
                     "Operator::getOutput() must return nullptr or a non-empty vector: {}",
                     op->stats().operatorType);
+                resultRows = outputRows ? outputRows->countSelected()
+                                        : result->size();
                 op->stats().outputVectors += 1;
-                op->stats().outputPositions += result->size();
+                op->stats().outputPositions += resultRows;
                 resultBytes = result->estimateFlatSize();
+                if (resultRows < result->size()) {
+                  resultBytes = resultBytes * resultRows / result->size();
+                }
                 op->stats().outputBytes += resultBytes;
               }
             }
             pushdownFilters(i);
             if (result) {
               auto timer = cpuWallTimer(op->stats().addInputTiming);
+              auto perfTimer = perfCounterTimer(nextOp);
               nextOp->stats().inputVectors += 1;
-              nextOp->stats().inputPositions += result->size();
+              nextOp->stats().inputPositions += resultRows;
               nextOp->stats().inputBytes += resultBytes;
-              nextOp->addInput(result);
+              ctx_->decodedVectorCache.startOperator(i + 1);
+              if (outputRows) {
+                nextOp->addInputRows(result, *outputRows);
+              } else {
+                nextOp->addInput(result);
+              }
               // The next iteration will see if operators_[i + 1] has
               // output now that it got input.
               i += 2;
@@ -393,6 +486,7 @@ StopReason Driver::runInternal(
               }
               if (op->isFinished()) {
                 auto timer = cpuWallTimer(op->stats().finishTiming);
+                ctx_->decodedVectorCache.startOperator(i + 1);
                 nextOp->noMoreInput();
                 break;
               }
@@ -405,6 +499,8 @@ StopReason Driver::runInternal(
           // will come back here after this is again on thread.
           {
             auto timer = cpuWallTimer(op->stats().getOutputTiming);
+            auto perfTimer = perfCounterTimer(op);
+            ctx_->decodedVectorCache.startOperator(i);
             result = op->getOutput();
             if (result) {
               VELOX_CHECK(
@@ -443,7 +539,13 @@ StopReason Driver::runInternal(
 void Driver::run(std::shared_ptr<Driver> self) {
   std::shared_ptr<BlockingState> blockingState;
   RowVectorPtr nullResult;
-  auto reason = self->runInternal(self, blockingState, nullResult);
+  const auto queuedMicros = self->queueTimeStartMicros_;
+  const auto startMicros = getCurrentTimeMicro();
+  auto reason = self->runInternal(self, blockingState, nullResult, true);
+  const auto endMicros = getCurrentTimeMicro();
+  self->task()->queryCtx()->addDriverRunNanos(
+      (endMicros - startMicros) * 1'000);
+  self->traceRun(queuedMicros, startMicros, endMicros, reason);
 
   // When Driver runs on an executor, the last operator (sink) must not produce
   // any results.
@@ -475,6 +577,32 @@ void Driver::run(std::shared_ptr<Driver> self) {
   }
 }
 
+void Driver::traceRun(
+    uint64_t queuedMicros,
+    uint64_t startMicros,
+    uint64_t endMicros,
+    StopReason reason) {
+  if (traceId_ == 0) {
+    return;
+  }
+  DriverTraceEvent event;
+  event.traceId = traceId_;
+  event.pipelineId = ctx_->pipelineId;
+  event.driverId = ctx_->driverId;
+  event.kind = DriverTraceEvent::Kind::kQueued;
+  event.startMicros = queuedMicros;
+  event.endMicros = startMicros;
+  recordDriverTrace(event);
+
+  event.kind = DriverTraceEvent::Kind::kOnThread;
+  event.startMicros = startMicros;
+  event.endMicros = endMicros;
+  event.operatorId = curOpIndex_ < operators_.size() ? curOpIndex_ : -1;
+  event.stopReason = reason;
+  event.blockingReason = blockingReason_;
+  recordDriverTrace(event);
+}
+
 void Driver::initializeOperatorStats(std::vector<OperatorStats>& stats) {
   stats.resize(operators_.size(), OperatorStats(0, 0, "", ""));
   // initialize the place in stats given by the operatorId. Use the
@@ -507,6 +635,7 @@ void Driver::close() {
     LOG(FATAL) << "Driver::close is only allowed from the Driver's thread";
   }
   addStatsToTask();
+  ctx_->decodedVectorCache.clear();
   for (auto& op : operators_) {
     op->close();
   }
@@ -517,6 +646,7 @@ void Driver::close() {
 void Driver::closeByTask() {
   VELOX_CHECK(isTerminated());
   addStatsToTask();
+  ctx_->decodedVectorCache.clear();
   for (auto& op : operators_) {
     op->close();
   }
@@ -661,6 +791,8 @@ std::string blockingReasonToString(BlockingReason reason) {
       return "kWaitForConnector";
     case BlockingReason::kWaitForSpill:
       return "kWaitForSpill";
+    case BlockingReason::kWaitForPeers:
+      return "kWaitForPeers";
   }
   VELOX_UNREACHABLE();
   return "";
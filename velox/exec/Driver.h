@@ -24,6 +24,7 @@
 #include "velox/connectors/Connector.h"
 #include "velox/core/PlanNode.h"
 #include "velox/core/QueryCtx.h"
+#include "velox/exec/DecodedVectorCache.h"
 
 namespace facebook::velox::exec {
 
@@ -134,6 +135,9 @@ enum class BlockingReason {
   /// Build operator is blocked waiting for all its peers to stop to run group
   /// spill on all of them.
   kWaitForSpill,
+  /// Operator is blocked waiting for all its peers to finish their input,
+  /// e.g. to merge their results.
+  kWaitForPeers,
 };
 
 std::string blockingReasonToString(BlockingReason reason);
@@ -195,6 +199,9 @@ struct DriverCtx {
   std::shared_ptr<Task> task;
   memory::MemoryPool* FOLLY_NONNULL pool;
   Driver* FOLLY_NONNULL driver;
+  /// Decodings of the input vectors of the operators, shared by the
+  /// operators of the pipeline so that a column is decoded once.
+  DecodedVectorCache decodedVectorCache;
 
   explicit DriverCtx(
       std::shared_ptr<Task> _task,
@@ -277,6 +284,12 @@ class Driver : public std::enable_shared_from_this<Driver> {
     return ctx_->task;
   }
 
+  /// Returns the id of the Driver trace of the Task or 0 if the Task does not
+  /// trace its Drivers.
+  uint64_t traceId() const {
+    return traceId_;
+  }
+
   // Updates the stats in Task and frees resources. Only called by Task for
   // closing non-running Drivers.
   void closeByTask();
@@ -286,13 +299,25 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   static void run(std::shared_ptr<Driver> self);
 
+  // Runs the Driver until it blocks, finishes or is stopped. If
+  // 'timeSliced' is true, i.e. when on an executor thread, also returns
+  // kYield after running for 'timeSliceMicros_'.
   StopReason runInternal(
       std::shared_ptr<Driver>& self,
       std::shared_ptr<BlockingState>& blockingState,
-      RowVectorPtr& result);
+      RowVectorPtr& result,
+      bool timeSliced);
 
   void close();
 
+  // Records the time 'this' was queued before 'startMicros' and the time it
+  // then ran on thread until it left for 'reason' at 'endMicros'.
+  void traceRun(
+      uint64_t queuedMicros,
+      uint64_t startMicros,
+      uint64_t endMicros,
+      StopReason reason);
+
   // Push down dynamic filters produced by the operator at the specified
   // position in the pipeline.
   void pushdownFilters(int operatorIndex);
@@ -302,6 +327,17 @@ class Driver : public std::enable_shared_from_this<Driver> {
                                   : nullptr;
   }
 
+  // Returns a timer that adds the hardware events of a call of 'op' to the
+  // runtime stats of 'op', or nullptr if not tracking perf counters.
+  std::unique_ptr<process::PerfCounterTimer> perfCounterTimer(Operator* op) {
+    return trackOperatorPerfCounters_
+        ? std::make_unique<process::PerfCounterTimer>(
+              [op](const process::PerfCounterValues& values) {
+                op->stats().addPerfCounters(values);
+              })
+        : nullptr;
+  }
+
   std::unique_ptr<DriverCtx> ctx_;
   std::atomic_bool closed_{false};
 
@@ -319,6 +355,18 @@ class Driver : public std::enable_shared_from_this<Driver> {
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
 
   bool trackOperatorCpuUsage_;
+
+  bool trackOperatorPerfCounters_;
+
+  // Time a Driver runs on an executor thread before yielding. 0 means no
+  // limit.
+  uint64_t timeSliceMicros_;
+
+  // The worker of a WorkStealingExecutor that last ran 'this', -1 if none.
+  std::atomic<int32_t> lastWorker_{-1};
+
+  // Id of the Driver trace of the Task, 0 if the Drivers are not traced.
+  uint64_t traceId_{0};
 };
 
 using OperatorSupplier = std::function<std::unique_ptr<Operator>(
@@ -423,6 +471,12 @@ struct DriverFactory {
 
     return joinNodeIds;
   }
+
+  /// Returns true if Drivers may be added to and retired from the pipeline at
+  /// runtime: the Drivers share the splits of a table scan, feed a local
+  /// exchange, which takes a variable number of producers, and have no
+  /// operators that synchronize with their peers.
+  bool supportsAdaptiveDrivers() const;
 };
 
 // Begins and ends a section where a thread is running but not
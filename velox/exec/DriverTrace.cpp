@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverTrace.h"
+
+#include <folly/dynamic.h>
+#include <folly/json.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+
+namespace facebook::velox::exec {
+
+namespace {
+// Number of events kept per thread.
+constexpr size_t kEventsPerThread = 4096;
+
+struct ThreadTraceBuffer {
+  explicit ThreadTraceBuffer(int32_t _threadIndex)
+      : threadIndex(_threadIndex) {}
+
+  const int32_t threadIndex;
+  std::mutex mutex;
+  // Ring of events. The oldest event is at 'numEvents % kEventsPerThread'
+  // once the ring is full.
+  std::vector<DriverTraceEvent> events;
+  uint64_t numEvents{0};
+};
+
+// The buffers of the live threads.
+struct TraceBufferRegistry {
+  std::mutex mutex;
+  std::unordered_set<ThreadTraceBuffer*> buffers;
+  int32_t nextThreadIndex{0};
+};
+
+TraceBufferRegistry& registry() {
+  // Leaked so that it outlives the thread local buffers of all threads.
+  static auto* registry = new TraceBufferRegistry();
+  return *registry;
+}
+
+// Registers the buffer of a thread for its lifetime.
+class ThreadTraceBufferHolder {
+ public:
+  ThreadTraceBufferHolder() {
+    auto& registry = exec::registry();
+    std::lock_guard<std::mutex> l(registry.mutex);
+    buffer_ = std::make_unique<ThreadTraceBuffer>(registry.nextThreadIndex++);
+    registry.buffers.insert(buffer_.get());
+  }
+
+  ~ThreadTraceBufferHolder() {
+    auto& registry = exec::registry();
+    std::lock_guard<std::mutex> l(registry.mutex);
+    registry.buffers.erase(buffer_.get());
+  }
+
+  ThreadTraceBuffer& buffer() {
+    return *buffer_;
+  }
+
+ private:
+  std::unique_ptr<ThreadTraceBuffer> buffer_;
+};
+
+ThreadTraceBuffer& threadBuffer() {
+  thread_local ThreadTraceBufferHolder holder;
+  return holder.buffer();
+}
+
+std::string stopReasonName(StopReason reason) {
+  switch (reason) {
+    case StopReason::kNone:
+      return "kNone";
+    case StopReason::kPause:
+      return "kPause";
+    case StopReason::kTerminate:
+      return "kTerminate";
+    case StopReason::kAlreadyTerminated:
+      return "kAlreadyTerminated";
+    case StopReason::kYield:
+      return "kYield";
+    case StopReason::kBlock:
+      return "kBlock";
+    case StopReason::kAtEnd:
+      return "kAtEnd";
+    case StopReason::kAlreadyOnThread:
+      return "kAlreadyOnThread";
+  }
+  return fmt::format("unknown {}", static_cast<int>(reason));
+}
+} // namespace
+
+uint64_t newDriverTraceId() {
+  static std::atomic<uint64_t> nextId{1};
+  return nextId++;
+}
+
+void recordDriverTrace(DriverTraceEvent event) {
+  auto& buffer = threadBuffer();
+  event.threadIndex = buffer.threadIndex;
+  std::lock_guard<std::mutex> l(buffer.mutex);
+  if (buffer.events.size() < kEventsPerThread) {
+    buffer.events.push_back(event);
+  } else {
+    buffer.events[buffer.numEvents % kEventsPerThread] = event;
+  }
+  ++buffer.numEvents;
+}
+
+std::vector<DriverTraceEvent> driverTraceEvents(uint64_t traceId) {
+  std::vector<DriverTraceEvent> events;
+  {
+    auto& registry = exec::registry();
+    std::lock_guard<std::mutex> l(registry.mutex);
+    for (auto* buffer : registry.buffers) {
+      std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+      for (const auto& event : buffer->events) {
+        if (event.traceId == traceId) {
+          events.push_back(event);
+        }
+      }
+    }
+  }
+  std::sort(
+      events.begin(),
+      events.end(),
+      [](const DriverTraceEvent& left, const DriverTraceEvent& right) {
+        return left.startMicros < right.startMicros;
+      });
+  return events;
+}
+
+std::string driverTraceToJson(
+    const std::vector<DriverTraceEvent>& events,
+    const std::function<std::string(int32_t pipelineId, int32_t operatorId)>&
+        operatorName) {
+  auto traceEvents = folly::dynamic::array();
+  std::unordered_set<int32_t> pipelineIds;
+  for (const auto& event : events) {
+    if (pipelineIds.insert(event.pipelineId).second) {
+      // Names the process of the pipeline in the trace viewer.
+      auto metadata = folly::dynamic::object("name", "process_name")("ph", "M");
+      metadata["pid"] = event.pipelineId;
+      metadata["args"] = folly::dynamic::object(
+          "name", fmt::format("Pipeline {}", event.pipelineId));
+      traceEvents.push_back(std::move(metadata));
+    }
+    auto args = folly::dynamic::object("thread", event.threadIndex);
+    if (event.operatorId >= 0) {
+      args["operator"] = operatorName(event.pipelineId, event.operatorId);
+    }
+    std::string name;
+    switch (event.kind) {
+      case DriverTraceEvent::Kind::kQueued:
+        name = "Queued";
+        break;
+      case DriverTraceEvent::Kind::kOnThread:
+        name = "OnThread";
+        args["stopReason"] = stopReasonName(event.stopReason);
+        if (event.stopReason == StopReason::kBlock) {
+          args["blockingReason"] =
+              blockingReasonToString(event.blockingReason);
+        }
+        break;
+      case DriverTraceEvent::Kind::kBlocked:
+        name = blockingReasonToString(event.blockingReason);
+        break;
+    }
+    auto traceEvent = folly::dynamic::object("name", name)("cat", "driver");
+    traceEvent["ph"] = "X";
+    traceEvent["ts"] = static_cast<int64_t>(event.startMicros);
+    traceEvent["dur"] =
+        static_cast<int64_t>(event.endMicros - event.startMicros);
+    traceEvent["pid"] = event.pipelineId;
+    traceEvent["tid"] = event.driverId;
+    traceEvent["args"] = std::move(args);
+    traceEvents.push_back(std::move(traceEvent));
+  }
+  return folly::toJson(folly::dynamic::object(
+      "traceEvents", std::move(traceEvents))("displayTimeUnit", "ms"));
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "velox/exec/Driver.h"
+
+namespace facebook::velox::exec {
+
+/// An interval in the timeline of a Driver. Recorded if
+/// QueryConfig::kDriverTraceEnabled is set. See Task::driverTrace().
+struct DriverTraceEvent {
+  enum class Kind : uint8_t {
+    /// The Driver was in the queue of the executor.
+    kQueued,
+    /// The Driver ran on a thread. 'operatorId' is the operator that had the
+    /// thread when the Driver went off thread for 'stopReason'.
+    kOnThread,
+    /// The Driver waited for 'blockingReason' of the operator 'operatorId'.
+    kBlocked,
+  };
+
+  /// Identifies the Task of the Driver, see newDriverTraceId().
+  uint64_t traceId;
+  uint64_t startMicros;
+  uint64_t endMicros;
+  int32_t pipelineId;
+  int32_t driverId;
+  /// Index of the operator in the Driver or -1 if none.
+  int32_t operatorId{-1};
+  /// The index of the thread that recorded the event. Set by
+  /// recordDriverTrace().
+  int32_t threadIndex{0};
+  Kind kind;
+  StopReason stopReason{StopReason::kNone};
+  BlockingReason blockingReason{BlockingReason::kNotBlocked};
+};
+
+/// Returns a process-wide unique non-zero id for the Driver trace of a Task.
+uint64_t newDriverTraceId();
+
+/// Adds 'event' to the ring buffer of the calling thread. A full buffer
+/// overwrites its oldest event, so that the trace keeps the last events of
+/// each thread. Takes only the mutex of the calling thread's buffer, which is
+/// contended only while the trace is collected.
+void recordDriverTrace(DriverTraceEvent event);
+
+/// Returns the events with 'traceId' that are in the buffers of the live
+/// threads, ordered by start time. The events of a thread that exited are
+/// dropped with its buffer.
+std::vector<DriverTraceEvent> driverTraceEvents(uint64_t traceId);
+
+/// Returns 'events' in the Chrome trace event format, which the Chrome trace
+/// viewer and Perfetto open. A pipeline is a process and a Driver is a thread
+/// in the trace. 'operatorName' returns the name of an operator of a
+/// pipeline.
+std::string driverTraceToJson(
+    const std::vector<DriverTraceEvent>& events,
+    const std::function<std::string(int32_t pipelineId, int32_t operatorId)>&
+        operatorName);
+
+} // namespace facebook::velox::exec
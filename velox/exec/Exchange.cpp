@@ -14,8 +14,11 @@
  * limitations under the License.
  */
 #include "velox/exec/Exchange.h"
+#include <algorithm>
 #include <velox/common/base/Exceptions.h>
 #include <velox/common/memory/Memory.h>
+#include "velox/common/base/StatsReporter.h"
+#include "velox/exec/Counters.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/vector/VectorStream.h"
 
@@ -93,20 +96,23 @@ class LocalExchangeSource : public ExchangeSource {
     return !requestPending_.exchange(true);
   }
 
-  void request() override {
+  void request(uint64_t maxBytes) override {
     auto buffers = PartitionedOutputBufferManager::getInstance().lock();
     VELOX_CHECK_NOT_NULL(buffers, "invalid PartitionedOutputBufferManager");
     VELOX_CHECK(requestPending_);
     auto requestedSequence = sequence_;
+    const auto requestTimeMicros = getCurrentTimeMicro();
+    // getData() acknowledges all pages before 'sequence_'.
+    unackedBytes_ = 0;
     auto self = shared_from_this();
     buffers->getData(
         taskId_,
         destination_,
-        kMaxBytes,
+        maxBytes,
         sequence_,
         // Since this lambda may outlive 'this', we need to capture a
         // shared_ptr to the current object (self).
-        [self, requestedSequence, buffers, this](
+        [self, requestedSequence, requestTimeMicros, maxBytes, buffers, this](
             std::vector<std::unique_ptr<folly::IOBuf>> data, int64_t sequence) {
           if (requestedSequence > sequence) {
             VLOG(2) << "Receives earlier sequence than requested: task "
@@ -120,6 +126,7 @@ class LocalExchangeSource : public ExchangeSource {
           }
           std::vector<std::unique_ptr<SerializedPage>> pages;
           bool atEnd = false;
+          uint64_t bytes = 0;
           for (auto& inputPage : data) {
             if (!inputPage) {
               atEnd = true;
@@ -129,12 +136,16 @@ class LocalExchangeSource : public ExchangeSource {
             inputPage->unshare();
             pages.push_back(
                 std::make_unique<SerializedPage>(std::move(inputPage), pool_));
+            bytes += pages.back()->size();
             inputPage = nullptr;
           }
           int64_t ackSequence;
+          bool acknowledge = false;
           {
             std::lock_guard<std::mutex> l(queue_->mutex());
             requestPending_ = false;
+            queue_->releaseCreditLocked(maxBytes);
+            recordResponseLocked(requestTimeMicros, pages);
             for (auto& page : pages) {
               queue_->enqueue(std::move(page));
             }
@@ -143,11 +154,19 @@ class LocalExchangeSource : public ExchangeSource {
               atEnd_ = true;
             }
             ackSequence = sequence_ = sequence + pages.size();
+            // The next request acknowledges the pages. An early
+            // acknowledge frees the memory of the producer before that but
+            // is sent only once per kMaxUnackedBytes.
+            unackedBytes_ += bytes;
+            if (unackedBytes_ >= kMaxUnackedBytes) {
+              acknowledge = true;
+              unackedBytes_ = 0;
+            }
           }
           // Outside of queue mutex.
           if (atEnd_) {
             buffers->deleteResults(taskId_, destination_);
-          } else {
+          } else if (acknowledge) {
             buffers->acknowledge(taskId_, destination_, ackSequence);
           }
         });
@@ -159,7 +178,12 @@ class LocalExchangeSource : public ExchangeSource {
   }
 
  private:
-  static constexpr uint64_t kMaxBytes = 32 * 1024 * 1024; // 32 MB
+  static constexpr uint64_t kMaxUnackedBytes = 1 << 20; // 1 MB
+
+  // Bytes received since the last acknowledge. Guarded by the mutex of
+  // 'queue_' in the response and only accessed by request() while no
+  // request is pending.
+  uint64_t unackedBytes_{0};
 };
 
 std::unique_ptr<ExchangeSource> createLocalExchangeSource(
@@ -181,7 +205,7 @@ void ExchangeClient::initialize(memory::MemoryPool* FOLLY_NONNULL pool) {
 }
 
 void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
-  std::shared_ptr<ExchangeSource> toRequest;
+  std::vector<SourceRequest> toRequest;
   std::shared_ptr<ExchangeSource> toClose;
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
@@ -199,17 +223,16 @@ void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
     } else {
       sources_.push_back(source);
       queue_->addSource();
-      if (source->shouldRequestLocked()) {
-        toRequest = source;
-      }
+      toRequest = pickSourcesToRequestLocked();
     }
   }
 
   // Outside of lock.
   if (toClose) {
     toClose->close();
-  } else if (toRequest) {
-    toRequest->request();
+  }
+  for (auto& request : toRequest) {
+    request.source->request(request.maxBytes);
   }
 }
 
@@ -242,32 +265,93 @@ void ExchangeClient::close() {
 std::unique_ptr<SerializedPage> ExchangeClient::next(
     bool* atEnd,
     ContinueFuture* future) {
-  std::vector<std::shared_ptr<ExchangeSource>> toRequest;
-  std::unique_ptr<SerializedPage> page;
+  auto pages = next(0, atEnd, future);
+  return pages.empty() ? nullptr : std::move(pages.front());
+}
+
+std::vector<std::unique_ptr<SerializedPage>> ExchangeClient::next(
+    uint64_t maxBytes,
+    bool* atEnd,
+    ContinueFuture* future) {
+  std::vector<SourceRequest> toRequest;
+  std::vector<std::unique_ptr<SerializedPage>> pages;
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
     *atEnd = false;
-    page = queue_->dequeue(atEnd, future);
+    pages = queue_->dequeue(maxBytes, atEnd, future);
+    REPORT_ADD_STAT_VALUE(kCounterExchangeQueueBytes, queue_->totalBytes());
     if (*atEnd) {
-      return page;
+      return pages;
     }
-    if (page && queue_->totalBytes() > queue_->minBytes()) {
-      return page;
+    if (!pages.empty() && queue_->totalBytes() > queue_->minBytes()) {
+      return pages;
     }
     // There is space for more data, send requests to sources with no pending
     // request.
-    for (auto& source : sources_) {
-      if (source->shouldRequestLocked()) {
-        toRequest.push_back(source);
-      }
-    }
+    toRequest = pickSourcesToRequestLocked();
   }
 
   // Outside of lock
-  for (auto& source : toRequest) {
-    source->request();
+  for (auto& request : toRequest) {
+    request.source->request(request.maxBytes);
+  }
+  return pages;
+}
+
+std::vector<ExchangeClient::SourceRequest>
+ExchangeClient::pickSourcesToRequestLocked() {
+  if (sources_.empty()) {
+    return {};
+  }
+  const int64_t space = static_cast<int64_t>(queue_->minBytes()) -
+      static_cast<int64_t>(queue_->totalBytes() + queue_->creditBytes());
+  size_t numCredits;
+  uint64_t credit;
+  if (space > 0) {
+    numCredits =
+        std::clamp<size_t>(space / kMinCreditBytes, 1, sources_.size());
+    credit = std::max<uint64_t>(space / numCredits, 1);
+  } else if (queue_->empty() && queue_->creditBytes() == 0) {
+    numCredits = 1;
+    credit = kMinCreditBytes;
+  } else {
+    return {};
+  }
+
+  std::vector<SourceRequest> requests;
+  size_t numVisited = 0;
+  for (; numVisited < sources_.size() && requests.size() < numCredits;
+       ++numVisited) {
+    auto& source = sources_[(nextSource_ + numVisited) % sources_.size()];
+    if (source->shouldRequestLocked()) {
+      queue_->grantCreditLocked(credit);
+      requests.push_back({source, credit});
+    }
   }
-  return page;
+  nextSource_ = (nextSource_ + numVisited) % sources_.size();
+  return requests;
+}
+
+std::unordered_map<std::string, RuntimeMetric> ExchangeClient::sourceStats() {
+  std::unordered_map<std::string, RuntimeMetric> stats;
+  std::lock_guard<std::mutex> l(queue_->mutex());
+  if (sources_.empty()) {
+    return stats;
+  }
+  auto& bytes = stats.emplace("sourceBytes", RuntimeCounter::Unit::kBytes)
+                    .first->second;
+  auto& pages = stats.emplace("sourcePages", RuntimeCounter::Unit::kNone)
+                    .first->second;
+  auto& wait =
+      stats.emplace("sourceResponseWaitNanos", RuntimeCounter::Unit::kNanos)
+          .first->second;
+  for (const auto& source : sources_) {
+    const auto& sourceStats = source->statsLocked();
+    bytes.addValue(sourceStats.numBytes);
+    pages.addValue(sourceStats.numPages);
+    wait.addValue(sourceStats.responseWaitMicros * 1'000);
+  }
+  return stats;
 }
 
 ExchangeClient::~ExchangeClient() {
@@ -317,7 +401,7 @@ bool Exchange::getSplits(ContinueFuture* FOLLY_NONNULL future) {
 }
 
 BlockingReason Exchange::isBlocked(ContinueFuture* FOLLY_NONNULL future) {
-  if (currentPage_ || atEnd_) {
+  if (!currentPages_.empty() || atEnd_) {
     return BlockingReason::kNotBlocked;
   }
 
@@ -329,8 +413,15 @@ BlockingReason Exchange::isBlocked(ContinueFuture* FOLLY_NONNULL future) {
   }
 
   ContinueFuture dataFuture;
-  currentPage_ = exchangeClient_->next(&atEnd_, &dataFuture);
-  if (currentPage_ || atEnd_) {
+  for (auto& page :
+       exchangeClient_->next(kMaxCoalescedBytes, &atEnd_, &dataFuture)) {
+    recordPageStats(*page);
+    currentPages_.push_back(std::move(page));
+  }
+  if (atEnd_) {
+    recordSourceStats();
+  }
+  if (!currentPages_.empty() || atEnd_) {
     if (atEnd_ && noMoreSplits_) {
       operatorCtx_->task()->multipleSplitsFinished(stats_.numSplits);
     }
@@ -354,32 +445,107 @@ BlockingReason Exchange::isBlocked(ContinueFuture* FOLLY_NONNULL future) {
                                : BlockingReason::kWaitForExchange;
 }
 
+void Exchange::recordPageStats(const SerializedPage& page) {
+  // Upper bounds of the page size histogram buckets. A bucket counts the
+  // pages over the previous bound and up to its own.
+  static const std::vector<std::pair<uint64_t, std::string>> kBuckets = {
+      {4 << 10, "pageSizeUpTo4KB"},
+      {16 << 10, "pageSizeUpTo16KB"},
+      {64 << 10, "pageSizeUpTo64KB"},
+      {256 << 10, "pageSizeUpTo256KB"},
+      {1 << 20, "pageSizeUpTo1MB"},
+      {4 << 20, "pageSizeUpTo4MB"},
+      {std::numeric_limits<uint64_t>::max(), "pageSizeOver4MB"}};
+
+  stats_.addRuntimeStat(
+      "pageBytes", RuntimeCounter(page.size(), RuntimeCounter::Unit::kBytes));
+  for (const auto& [bound, name] : kBuckets) {
+    if (page.size() <= bound) {
+      stats_.addRuntimeStat(name, RuntimeCounter(1));
+      break;
+    }
+  }
+  if (page.enqueueTimeMicros() != 0) {
+    const auto queuedMicros = getCurrentTimeMicro() - page.enqueueTimeMicros();
+    stats_.addRuntimeStat(
+        "pageQueuedWallNanos",
+        RuntimeCounter(queuedMicros * 1'000, RuntimeCounter::Unit::kNanos));
+    REPORT_ADD_STAT_VALUE(kCounterExchangePageWaitMs, queuedMicros / 1'000);
+  }
+}
+
+void Exchange::recordSourceStats() {
+  if (operatorCtx_->driverCtx()->driverId != 0) {
+    return;
+  }
+  for (auto& [name, metric] : exchangeClient_->sourceStats()) {
+    stats_.runtimeStats.emplace(name, metric);
+  }
+}
+
 bool Exchange::isFinished() {
   return atEnd_;
 }
 
 RowVectorPtr Exchange::getOutput() {
-  if (!currentPage_) {
+  if (currentPages_.empty()) {
     return nullptr;
   }
 
-  if (!inputStream_) {
-    inputStream_ = std::make_unique<ByteStream>();
-    stats_.rawInputBytes += currentPage_->size();
-    currentPage_->prepareStreamForDeserialize(inputStream_.get());
-  }
+  // A page whose values are read in place is returned alone. Otherwise the
+  // rows of the following pages are read after the rows of the first page
+  // until there are enough rows for a batch.
+  std::optional<uint32_t> maxRows;
+  vector_size_t numRows = 0;
+  CpuWallTiming deserializeTiming;
+  for (;;) {
+    if (!inputStream_) {
+      auto& page = currentPages_.front();
+      inputStream_ = std::make_unique<ByteStream>();
+      stats_.rawInputBytes += page->size();
+      page->prepareStreamForDeserialize(inputStream_.get());
+      if (numRows == 0 && currentPages_.size() == 1) {
+        inputStream_->setInputOwner(page);
+      }
+    }
+    const bool inPlace = inputStream_->inputOwner() != nullptr;
+
+    {
+      CpuWallTimer timer(deserializeTiming);
+      VectorStreamGroup::read(
+          inputStream_.get(),
+          operatorCtx_->pool(),
+          outputType_,
+          &result_,
+          numRows,
+          serdeOptions_.get());
+    }
+    numRows = result_->size();
 
-  VectorStreamGroup::read(
-      inputStream_.get(), operatorCtx_->pool(), outputType_, &result_);
+    if (inputStream_->atEnd()) {
+      currentPages_.pop_front();
+      inputStream_ = nullptr;
+    }
+    if (inPlace || currentPages_.empty()) {
+      break;
+    }
+    if (!maxRows.has_value()) {
+      maxRows = outputBatchRows(averageRowBytes(*result_));
+    }
+    if (numRows >= maxRows.value()) {
+      break;
+    }
+  }
 
   stats_.inputPositions += result_->size();
   stats_.inputBytes += result_->retainedSize();
-
-  if (inputStream_->atEnd()) {
-    currentPage_ = nullptr;
-    inputStream_ = nullptr;
-  }
-
+  stats_.addRuntimeStat(
+      "deserializeCpuNanos",
+      RuntimeCounter(deserializeTiming.cpuNanos, RuntimeCounter::Unit::kNanos));
+  stats_.addRuntimeStat(
+      "deserializeWallNanos",
+      RuntimeCounter(
+          deserializeTiming.wallNanos, RuntimeCounter::Unit::kNanos));
   return result_;
 }
 
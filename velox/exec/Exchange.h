@@ -19,7 +19,9 @@
 #include <velox/common/memory/Memory.h>
 #include <memory>
 #include "velox/common/memory/ByteStream.h"
+#include "velox/common/time/Timer.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/OperatorUtils.h"
 
 namespace facebook::velox::exec {
 
@@ -53,6 +55,15 @@ class SerializedPage {
     return iobuf_->clone();
   }
 
+  // Time when 'this' was added to an ExchangeQueue, 0 if not queued.
+  uint64_t enqueueTimeMicros() const {
+    return enqueueTimeMicros_;
+  }
+
+  void setEnqueueTimeMicros(uint64_t micros) {
+    enqueueTimeMicros_ = micros;
+  }
+
  private:
   static int64_t chainBytes(folly::IOBuf& iobuf) {
     int64_t size = 0;
@@ -71,6 +82,7 @@ class SerializedPage {
   // Number of payload bytes in 'iobuf_'.
   const int64_t iobufBytes_;
   memory::MemoryPool* FOLLY_NULLABLE pool_;
+  uint64_t enqueueTimeMicros_{0};
 
   // Callback that will be called on destruction of the SerializedPage,
   // primarily used to free externally allocated memory backing folly::IOBuf
@@ -106,6 +118,7 @@ class ExchangeQueue {
       return;
     }
     totalBytes_ += page->size();
+    page->setEnqueueTimeMicros(getCurrentTimeMicro());
     queue_.push_back(std::move(page));
     if (!promises_.empty()) {
       // Resume one of the waiting drivers.
@@ -151,6 +164,30 @@ class ExchangeQueue {
     return page;
   }
 
+  // Returns the first page like dequeue() followed by the next pages that fit
+  // in 'maxBytes' together with the first page. Returns only the first page
+  // if 'maxBytes' is 0.
+  std::vector<std::unique_ptr<SerializedPage>> dequeue(
+      uint64_t maxBytes,
+      bool* FOLLY_NONNULL atEnd,
+      ContinueFuture* FOLLY_NONNULL future) {
+    std::vector<std::unique_ptr<SerializedPage>> pages;
+    auto page = dequeue(atEnd, future);
+    if (!page) {
+      return pages;
+    }
+    auto bytes = page->size();
+    pages.push_back(std::move(page));
+    while (bytes < maxBytes && !queue_.empty() &&
+           bytes + queue_.front()->size() <= maxBytes) {
+      bytes += queue_.front()->size();
+      totalBytes_ -= queue_.front()->size();
+      pages.push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    return pages;
+  }
+
   // Returns the total bytes held by SerializedPages in 'this'.
   uint64_t totalBytes() const {
     return totalBytes_;
@@ -163,6 +200,23 @@ class ExchangeQueue {
     return minBytes_;
   }
 
+  // Records 'bytes' of credit granted to a source for a request. The credit
+  // counts against minBytes() until the source releases it with
+  // releaseCreditLocked() on receiving the response.
+  void grantCreditLocked(uint64_t bytes) {
+    creditBytes_ += bytes;
+  }
+
+  void releaseCreditLocked(uint64_t bytes) {
+    VELOX_CHECK_GE(creditBytes_, bytes);
+    creditBytes_ -= bytes;
+  }
+
+  // Returns the credit granted to sources for pending requests.
+  uint64_t creditBytes() const {
+    return creditBytes_;
+  }
+
   void addSource() {
     VELOX_CHECK(!noMoreSources_, "addSource called after noMoreSources");
     numSources_++;
@@ -208,6 +262,9 @@ class ExchangeQueue {
   // If 'totalBytes_' < 'minBytes_', an exchange should request more data from
   // producers.
   uint64_t minBytes_;
+
+  // Bytes the sources may still receive for their pending requests.
+  uint64_t creditBytes_{0};
 };
 
 class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
@@ -247,8 +304,11 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
 
   // Requests the producer to generate more data. Call only if shouldRequest()
   // was true. The object handles its own lifetime by acquiring a
-  // shared_from_this() pointer if needed.
-  virtual void request() = 0;
+  // shared_from_this() pointer if needed. 'maxBytes' is the credit granted
+  // to 'this' with ExchangeQueue::grantCreditLocked(). The producer returns
+  // data up to 'maxBytes', or a single page if it is larger, and 'this'
+  // releases the credit when the response is enqueued.
+  virtual void request(uint64_t maxBytes) = 0;
 
   // Close the exchange source. May be called before all data
   // has been received and proessed. This can happen in case
@@ -272,6 +332,20 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
 
   static std::vector<Factory>& factories();
 
+  // Counters of the responses of the producer.
+  struct Stats {
+    uint64_t numBytes{0};
+    uint64_t numPages{0};
+    uint64_t numResponses{0};
+    // Sum of the time from sending a request to receiving its response.
+    uint64_t responseWaitMicros{0};
+  };
+
+  // Call while holding a lock over queue_.mutex().
+  const Stats& statsLocked() const {
+    return stats_;
+  }
+
   // ID of the task producing data
   const std::string taskId_;
   // Destination number of 'this' on producer
@@ -282,7 +356,23 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   bool atEnd_ = false;
 
  protected:
+  // Records the response 'pages' to a request sent at 'requestTimeMicros'.
+  // Call while holding a lock over queue_.mutex().
+  void recordResponseLocked(
+      uint64_t requestTimeMicros,
+      const std::vector<std::unique_ptr<SerializedPage>>& pages) {
+    ++stats_.numResponses;
+    stats_.responseWaitMicros += getCurrentTimeMicro() - requestTimeMicros;
+    stats_.numPages += pages.size();
+    for (const auto& page : pages) {
+      stats_.numBytes += page->size();
+    }
+  }
+
   memory::MemoryPool* FOLLY_NONNULL pool_;
+
+ private:
+  Stats stats_;
 };
 
 struct RemoteConnectorSplit : public connector::ConnectorSplit {
@@ -334,13 +424,45 @@ class ExchangeClient {
       bool* FOLLY_NONNULL atEnd,
       ContinueFuture* FOLLY_NONNULL future);
 
+  // Returns the next page like next() followed by the queued pages that fit
+  // in 'maxBytes' together with it. Returns no pages if next() would return
+  // nullptr.
+  std::vector<std::unique_ptr<SerializedPage>> next(
+      uint64_t maxBytes,
+      bool* FOLLY_NONNULL atEnd,
+      ContinueFuture* FOLLY_NONNULL future);
+
   std::string toString();
 
+  // Returns the distribution of the bytes, pages and response wait time of
+  // the sources, one value per source, so that the min and max show a slow
+  // or skewed source. Empty after close().
+  std::unordered_map<std::string, RuntimeMetric> sourceStats();
+
  private:
+  // The minimum credit granted to a source for one request.
+  static constexpr uint64_t kMinCreditBytes = 1 << 20;
+
+  struct SourceRequest {
+    std::shared_ptr<ExchangeSource> source;
+    uint64_t maxBytes;
+  };
+
+  // Picks the sources to request data from and grants each a credit. The
+  // space of the queue below minBytes() that is not granted yet is divided
+  // into credits of at least kMinCreditBytes for sources with no pending
+  // request. The sources are taken in turn, so that all of a wide exchange
+  // get their share. A single source is granted kMinCreditBytes if there is
+  // no space but the queue is empty and nothing is pending, so that the
+  // exchange keeps making progress.
+  std::vector<SourceRequest> pickSourcesToRequestLocked();
+
   const int destination_;
   std::shared_ptr<ExchangeQueue> queue_;
   std::unordered_set<std::string> taskIds_;
   std::vector<std::shared_ptr<ExchangeSource>> sources_;
+  // The index in 'sources_' of the first source to consider for a credit.
+  size_t nextSource_{0};
   memory::MemoryPool* FOLLY_NULLABLE pool_{nullptr};
   bool closed_{false};
 };
@@ -359,7 +481,9 @@ class Exchange : public SourceOperator {
             exchangeNode->id(),
             "Exchange"),
         planNodeId_(exchangeNode->id()),
-        exchangeClient_(std::move(exchangeClient)) {
+        exchangeClient_(std::move(exchangeClient)),
+        serdeOptions_(makeExchangeSerdeOptions(
+            ctx->task->queryCtx()->config())) {
     if (operatorCtx_->driverCtx()->driverId == 0) {
       // As all Exchange operators share the same ExchangeClient, we only
       // need one to do client initialization.
@@ -375,7 +499,8 @@ class Exchange : public SourceOperator {
 
   void close() override {
     SourceOperator::close();
-    currentPage_ = nullptr;
+    currentPages_.clear();
+    inputStream_ = nullptr;
     result_ = nullptr;
     if (exchangeClient_) {
       exchangeClient_->close();
@@ -397,6 +522,18 @@ class Exchange : public SourceOperator {
   /// exchangeClient_.
   bool getSplits(ContinueFuture* FOLLY_NONNULL future);
 
+  // Adds the size of 'page', its histogram bucket and the time it was queued
+  // to the runtime stats.
+  void recordPageStats(const SerializedPage& page);
+
+  // Adds the stats of the sources of 'exchangeClient_' to the runtime stats
+  // of the first Exchange of the shared client once all data is received.
+  void recordSourceStats();
+
+  // Maximum total size of the queued pages that are taken at a time to be
+  // read into one output batch.
+  static constexpr uint64_t kMaxCoalescedBytes = 1 << 20;
+
   const core::PlanNodeId planNodeId_;
   bool noMoreSplits_ = false;
 
@@ -406,7 +543,13 @@ class Exchange : public SourceOperator {
 
   RowVectorPtr result_;
   std::shared_ptr<ExchangeClient> exchangeClient_;
-  std::unique_ptr<SerializedPage> currentPage_;
+  // Options for deserializing the pages, e.g. their compression. nullptr for
+  // the defaults.
+  const std::unique_ptr<VectorSerde::Options> serdeOptions_;
+  // The pages that are read into the next output batches. A page is shared
+  // with the vectors that are deserialized in place from it.
+  std::deque<std::shared_ptr<SerializedPage>> currentPages_;
+  // Reads the first page of 'currentPages_'.
   std::unique_ptr<ByteStream> inputStream_;
   bool atEnd_{false};
 };
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/FairShareExecutor.h"
+#include <glog/logging.h>
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/time/Timer.h"
+
+namespace facebook::velox::exec {
+namespace {
+// Query run time at which each level above 0 starts.
+constexpr std::array<uint64_t, FairShareExecutor::kNumLevels - 1>
+    kLevelThresholdNanos = {
+        1'000'000'000UL,
+        10'000'000'000UL,
+        60'000'000'000UL,
+        300'000'000'000UL};
+} // namespace
+
+FairShareExecutor::FairShareExecutor(int32_t numThreads) {
+  VELOX_CHECK_GT(numThreads, 0);
+  threads_.reserve(numThreads);
+  for (auto i = 0; i < numThreads; ++i) {
+    threads_.emplace_back([this]() { run(); });
+  }
+}
+
+FairShareExecutor::~FairShareExecutor() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+// static
+int32_t FairShareExecutor::levelOf(uint64_t queryRunNanos) {
+  int32_t level = 0;
+  while (level < kLevelThresholdNanos.size() &&
+         queryRunNanos >= kLevelThresholdNanos[level]) {
+    ++level;
+  }
+  return level;
+}
+
+void FairShareExecutor::add(folly::Func func, uint64_t queryRunNanos) {
+  const auto level = levelOf(queryRunNanos);
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (queues_[level].empty() && numRunning_[level] == 0) {
+      // A level does not bank the share it did not use while idle: it
+      // starts even with the least served of the non-empty levels.
+      const auto next = nextLevelLocked();
+      if (next != -1 &&
+          weightedRunNanosLocked(level) < weightedRunNanosLocked(next)) {
+        levelRunNanos_[level] = weightedRunNanosLocked(next) >> level;
+      }
+    }
+    queues_[level].push_back(std::move(func));
+  }
+  condition_.notify_one();
+}
+
+uint64_t FairShareExecutor::levelRunNanos(int32_t level) const {
+  VELOX_CHECK_LT(level, kNumLevels);
+  std::lock_guard<std::mutex> l(mutex_);
+  return levelRunNanos_[level];
+}
+
+int32_t FairShareExecutor::nextLevelLocked() const {
+  int32_t next = -1;
+  for (auto level = 0; level < kNumLevels; ++level) {
+    if (queues_[level].empty()) {
+      continue;
+    }
+    if (next == -1 ||
+        weightedRunNanosLocked(level) < weightedRunNanosLocked(next)) {
+      next = level;
+    }
+  }
+  return next;
+}
+
+void FairShareExecutor::run() {
+  std::unique_lock<std::mutex> l(mutex_);
+  for (;;) {
+    const auto level = nextLevelLocked();
+    if (level == -1) {
+      if (stop_) {
+        return;
+      }
+      condition_.wait(l);
+      continue;
+    }
+    auto func = std::move(queues_[level].front());
+    queues_[level].pop_front();
+    ++numRunning_[level];
+    l.unlock();
+    const auto startMicros = getCurrentTimeMicro();
+    try {
+      func();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Exception in FairShareExecutor: " << e.what();
+    }
+    // Destroys the function, which may hold a Driver, outside of 'mutex_'.
+    func = nullptr;
+    const auto runNanos = (getCurrentTimeMicro() - startMicros) * 1'000;
+    l.lock();
+    levelRunNanos_[level] += runNanos;
+    --numRunning_[level];
+  }
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Executor.h>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace facebook::velox::exec {
+
+/// An executor that shares its threads between queries by the time their
+/// Drivers have run. A function is queued at a level picked by the run time
+/// of its query so far: level 0 for queries that have run less than 1s, then
+/// 10s, 60s, 300s and above. A thread takes the oldest function of the
+/// non-empty level that has used the least of its share of the threads, the
+/// share of each level being half the share of the level below. New and
+/// short queries thus overtake long running ones, which still progress.
+///
+/// Driver::enqueue() passes the run time of the query of the Driver when the
+/// QueryCtx executor is a FairShareExecutor. Together with
+/// QueryConfig::kDriverTimeSliceMs a long running Driver goes back to the
+/// queue at a lower level after each time slice.
+class FairShareExecutor : public folly::Executor {
+ public:
+  static constexpr int32_t kNumLevels = 5;
+
+  explicit FairShareExecutor(int32_t numThreads);
+
+  /// Runs the functions that are still queued and joins the threads.
+  ~FairShareExecutor() override;
+
+  /// Adds 'func' at level 0.
+  void add(folly::Func func) override {
+    add(std::move(func), 0);
+  }
+
+  /// Adds 'func' on behalf of a query that has run for 'queryRunNanos'.
+  void add(folly::Func func, uint64_t queryRunNanos);
+
+  /// Returns the level of a query that has run for 'queryRunNanos'.
+  static int32_t levelOf(uint64_t queryRunNanos);
+
+  /// Returns the time the functions of 'level' have run.
+  uint64_t levelRunNanos(int32_t level) const;
+
+ private:
+  // Returns the run time of 'level' scaled by the inverse of its share.
+  uint64_t weightedRunNanosLocked(int32_t level) const {
+    return levelRunNanos_[level] << level;
+  }
+
+  // Returns the non-empty level with the least weighted run time or -1 if
+  // all levels are empty.
+  int32_t nextLevelLocked() const;
+
+  void run();
+
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  std::array<std::deque<folly::Func>, kNumLevels> queues_;
+  std::array<uint64_t, kNumLevels> levelRunNanos_{};
+  // Number of functions of each level that are running.
+  std::array<int32_t, kNumLevels> numRunning_{};
+  bool stop_{false};
+  std::vector<std::thread> threads_;
+};
+
+} // namespace facebook::velox::exec
@@ -52,7 +52,8 @@ FilterProject::FilterProject(
           operatorId,
           project ? project->id() : filter->id(),
           "FilterProject"),
-      hasFilter_(filter != nullptr) {
+      hasFilter_(filter != nullptr),
+      trackExprStats_(driverCtx->queryConfig().exprTrackCpuUsage()) {
   std::vector<core::TypedExprPtr> allExprs;
   if (hasFilter_) {
     allExprs.push_back(filter->filter());
@@ -121,7 +122,36 @@ bool FilterProject::allInputProcessed() {
 }
 
 bool FilterProject::isFinished() {
-  return noMoreInput_ && allInputProcessed();
+  if (noMoreInput_ && allInputProcessed()) {
+    addExprStats();
+    return true;
+  }
+  return false;
+}
+
+void FilterProject::addExprStats() {
+  if (!trackExprStats_ || exprStatsAdded_) {
+    return;
+  }
+  exprStatsAdded_ = true;
+  for (const auto& [name, exprStats] : exprs_->stats()) {
+    stats_.addRuntimeStat(
+        fmt::format("expr.{}.cpuNanos", name),
+        RuntimeCounter(
+            exprStats.timing.cpuNanos, RuntimeCounter::Unit::kNanos));
+    stats_.addRuntimeStat(
+        fmt::format("expr.{}.numProcessedRows", name),
+        RuntimeCounter(exprStats.numProcessedRows));
+    stats_.addRuntimeStat(
+        fmt::format("expr.{}.numProcessedVectors", name),
+        RuntimeCounter(exprStats.numProcessedVectors));
+    stats_.addRuntimeStat(
+        fmt::format("expr.{}.numPeeledVectors", name),
+        RuntimeCounter(exprStats.numPeeledVectors));
+    stats_.addRuntimeStat(
+        fmt::format("expr.{}.numDefaultNullVectors", name),
+        RuntimeCounter(exprStats.numDefaultNullVectors));
+  }
 }
 
 RowVectorPtr FilterProject::getOutput() {
@@ -183,6 +213,41 @@ RowVectorPtr FilterProject::getOutput() {
       numOut, allRowsSelected ? nullptr : filterEvalCtx_.selectedIndices);
 }
 
+RowVectorPtr FilterProject::getOutputRows(const SelectivityVector** rows) {
+  *rows = nullptr;
+  if (!hasFilter_) {
+    // The output is not wrapped.
+    return getOutput();
+  }
+  if (allInputProcessed()) {
+    return nullptr;
+  }
+
+  const vector_size_t size = input_->size();
+  outputRows_.resizeFill(size);
+  EvalCtx evalCtx(operatorCtx_->execCtx(), exprs_.get(), input_.get());
+  for (auto fieldIdx : multiplyReferencedFieldIndices_) {
+    evalCtx.ensureFieldLoaded(fieldIdx, outputRows_);
+  }
+
+  auto numOut = filter(evalCtx, outputRows_);
+  numProcessedInputRows_ = size;
+  if (numOut == 0) {
+    input_ = nullptr;
+    return nullptr;
+  }
+  if (numOut < size) {
+    outputRows_.setFromBits(filterEvalCtx_.selectedBits->as<uint64_t>(), size);
+    // The projections are evaluated up to the last passing row.
+    outputRows_.resize(outputRows_.end());
+    *rows = &outputRows_;
+  }
+  if (!isIdentityProjection_) {
+    project(outputRows_, evalCtx);
+  }
+  return fillOutput(outputRows_.size(), nullptr);
+}
+
 void FilterProject::project(const SelectivityVector& rows, EvalCtx& evalCtx) {
   exprs_->eval(
       hasFilter_ ? 1 : 0, numExprs_, !hasFilter_, rows, evalCtx, results_);
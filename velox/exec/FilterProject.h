@@ -45,6 +45,10 @@ class FilterProject : public Operator {
 
   RowVectorPtr getOutput() override;
 
+  // Returns the input columns and projections unwrapped with the rows that
+  // passed the filter as '*rows'.
+  RowVectorPtr getOutputRows(const SelectivityVector** rows) override;
+
   BlockingReason isBlocked(ContinueFuture* /* unused */) override {
     return BlockingReason::kNotBlocked;
   }
@@ -62,6 +66,11 @@ class FilterProject : public Operator {
   // should return nullptr.
   bool allInputProcessed();
 
+  // Adds the stats of the expressions to the runtime stats of the operator,
+  // keyed on 'expr.<function name>.<stat>'. Called once when finished if
+  // 'trackExprStats_' is true.
+  void addExprStats();
+
   // Evaluate filter on all rows. Return number of rows that passed the filter.
   // Populate filterEvalCtx_.selectedBits and selectedIndices with the indices
   // of the passing rows if only some rows pass the filter. If all or no rows
@@ -75,11 +84,19 @@ class FilterProject : public Operator {
 
   // If true exprs_[0] is a filter and the other expressions are projections
   const bool hasFilter_{false};
+
+  // True if the per-expression stats should be added to the runtime stats.
+  const bool trackExprStats_;
+  bool exprStatsAdded_{false};
+
   std::unique_ptr<ExprSet> exprs_;
   int32_t numExprs_;
 
   FilterEvalCtx filterEvalCtx_;
 
+  // The rows that passed the filter in getOutputRows().
+  SelectivityVector outputRows_;
+
   vector_size_t numProcessedInputRows_{0};
 
   // Indices for fields/input columns that are both an identity projection and
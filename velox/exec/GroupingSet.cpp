@@ -35,6 +35,33 @@ bool areAllLazyNotLoaded(const std::vector<VectorPtr>& vectors) {
     return isLazyNotLoaded(*vector);
   });
 }
+
+// Min average number of rows per run of identical grouping keys for an input
+// batch to count as clustered.
+constexpr vector_size_t kMinClusteredRunLength = 16;
+
+bool anyDistinct(const std::vector<bool>& distinctAggregates) {
+  return std::find(
+             distinctAggregates.begin(), distinctAggregates.end(), true) !=
+      distinctAggregates.end();
+}
+
+bool useColumnarAccumulators(
+    bool isGlobal,
+    const std::vector<std::unique_ptr<Aggregate>>& aggregates,
+    OperatorCtx* operatorCtx) {
+  if (isGlobal || aggregates.empty() ||
+      !operatorCtx->driverCtx()
+           ->queryConfig()
+           .aggregationColumnarAccumulators()) {
+    return false;
+  }
+  return std::all_of(
+      aggregates.begin(), aggregates.end(), [](const auto& aggregate) {
+        return aggregate->isFixedSize() &&
+            !aggregate->accumulatorUsesExternalMemory();
+      });
+}
 } // namespace
 
 GroupingSet::GroupingSet(
@@ -49,8 +76,15 @@ GroupingSet::GroupingSet(
     bool isPartial,
     bool isRawInput,
     const Spiller::Config* spillConfig,
-    OperatorCtx* operatorCtx)
+    OperatorCtx* operatorCtx,
+    const std::vector<bool>& distinctAggregates)
     : preGroupedKeyChannels_(std::move(preGroupedKeys)),
+      detectClusteredInput_(
+          isPartial && !hashers.empty() && !aggregates.empty() &&
+          preGroupedKeyChannels_.empty() &&
+          operatorCtx->driverCtx()
+              ->queryConfig()
+              .partialAggregationDetectClusteredInput()),
       hashers_(std::move(hashers)),
       isGlobal_(hashers_.empty()),
       isPartial_(isPartial),
@@ -60,17 +94,30 @@ GroupingSet::GroupingSet(
       channelLists_(std::move(channelLists)),
       constantLists_(std::move(constantLists)),
       intermediateTypes_(std::move(intermediateTypes)),
+      columnarAccumulators_(
+          useColumnarAccumulators(isGlobal_, aggregates_, operatorCtx)),
       ignoreNullKeys_(ignoreNullKeys),
       mappedMemory_(operatorCtx->mappedMemory()),
       spillMemoryThreshold_(operatorCtx->driverCtx()
                                 ->queryConfig()
                                 .aggregationSpillMemoryThreshold()),
-      spillConfig_(spillConfig),
+      // The combinations seen by DISTINCT aggregates and the accumulators
+      // outside of the rows are not spilled.
+      spillConfig_(
+          anyDistinct(distinctAggregates) || columnarAccumulators_
+              ? nullptr
+              : spillConfig),
       stringAllocator_(mappedMemory_),
       rows_(mappedMemory_),
+      intermediateRows_(mappedMemory_),
+      columnsPool_(mappedMemory_),
       isAdaptive_(
           operatorCtx->task()->queryCtx()->config().hashAdaptivityEnabled()),
-      pool_(*operatorCtx->pool()) {
+      prefetchBatchSize_(operatorCtx->driverCtx()
+                             ->queryConfig()
+                             .hashTablePrefetchBatchSize()),
+      pool_(*operatorCtx->pool()),
+      operatorCtx_(operatorCtx) {
   for (auto& hasher : hashers_) {
     keyChannels_.push_back(hasher->channel());
   }
@@ -83,6 +130,34 @@ GroupingSet::GroupingSet(
   for (const std::vector<column_index_t>& argList : channelLists_) {
     mayPushdown_.push_back(allAreSinglyReferenced(argList, channelUseCount));
   }
+  if (anyDistinct(distinctAggregates)) {
+    VELOX_CHECK_EQ(distinctAggregates.size(), aggregates_.size());
+    VELOX_CHECK(
+        isRawInput_ && !isPartial_,
+        "DISTINCT aggregates are supported only in single aggregation");
+    distinctInputs_.resize(aggregates_.size());
+    for (auto i = 0; i < aggregates_.size(); ++i) {
+      if (distinctAggregates[i]) {
+        distinctInputs_[i] = std::make_unique<DistinctInput>();
+      }
+    }
+  }
+  if (columnarAccumulators_) {
+    // Each group has a null flag at byte 0 of its slot, followed by the
+    // accumulator.
+    for (auto& aggregate : aggregates_) {
+      const auto alignment = aggregate->accumulatorAlignmentSize();
+      const auto offset = bits::roundUp(1, alignment);
+      aggregate->setAllocator(&stringAllocator_);
+      aggregate->setOffsets(
+          offset, RowContainer::nullByte(0), RowContainer::nullMask(0), 0);
+      AccumulatorColumn column;
+      column.slotSize = bits::roundUp(
+          offset + aggregate->accumulatorFixedWidthSize(), alignment);
+      column.alignment = alignment;
+      columns_.push_back(std::move(column));
+    }
+  }
 }
 
 GroupingSet::~GroupingSet() {
@@ -110,18 +185,29 @@ bool equalKeys(
 
 void GroupingSet::addInput(const RowVectorPtr& input, bool mayPushdown) {
   if (isGlobal_) {
+    activeRows_.resize(input->size());
+    activeRows_.setAll();
     addGlobalAggregationInput(input, mayPushdown);
     return;
   }
 
   auto numRows = input->size();
+  if (detectClusteredInput_ && remainingInput_) {
+    addRemainingInput();
+  }
+  const std::vector<column_index_t>* clusteredKeys = nullptr;
   if (!preGroupedKeyChannels_.empty()) {
+    clusteredKeys = &preGroupedKeyChannels_;
+  } else if (detectClusteredInput_ && isClustered(input)) {
+    clusteredKeys = &keyChannels_;
+  }
+  if (clusteredKeys != nullptr) {
     if (remainingInput_) {
       addRemainingInput();
     }
     // Look for the last group of pre-grouped keys.
     for (auto i = input->size() - 2; i >= 0; --i) {
-      if (!equalKeys(preGroupedKeyChannels_, input, i, i + 1)) {
+      if (!equalKeys(*clusteredKeys, input, i, i + 1)) {
         // Process that many rows, flush the accumulators and the hash
         // table, then add remaining rows.
         numRows = i + 1;
@@ -140,6 +226,34 @@ void GroupingSet::addInput(const RowVectorPtr& input, bool mayPushdown) {
   addInputForActiveRows(input, mayPushdown);
 }
 
+void GroupingSet::addInputRows(
+    const RowVectorPtr& input,
+    const SelectivityVector& rows,
+    bool mayPushdown) {
+  VELOX_CHECK(supportsInputRows());
+  activeRows_ = rows;
+  if (isGlobal_) {
+    addGlobalAggregationInput(input, mayPushdown);
+  } else {
+    addInputForActiveRows(input, mayPushdown);
+  }
+}
+
+bool GroupingSet::isClustered(const RowVectorPtr& input) const {
+  const auto numRows = input->size();
+  const auto maxRuns = numRows / kMinClusteredRunLength;
+  if (maxRuns < 2) {
+    return false;
+  }
+  vector_size_t numRuns = 1;
+  for (auto i = 1; i < numRows; ++i) {
+    if (!equalKeys(keyChannels_, input, i - 1, i) && ++numRuns > maxRuns) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void GroupingSet::noMoreInput() {
   noMoreInput_ = true;
 
@@ -152,9 +266,18 @@ bool GroupingSet::hasOutput() {
   return noMoreInput_ || remainingInput_;
 }
 
+void GroupingSet::addPartialGroups(const RowVectorPtr& groups) {
+  VELOX_CHECK(!isGlobal_);
+  VELOX_CHECK(distinctInputs_.empty());
+  activeRows_.resize(groups->size());
+  activeRows_.setAll();
+  addInputForActiveRows(groups, false, true);
+}
+
 void GroupingSet::addInputForActiveRows(
     const RowVectorPtr& input,
-    bool mayPushdown) {
+    bool mayPushdown,
+    bool isPartialGroups) {
   VELOX_CHECK(!isGlobal_);
   bool rehash = false;
   if (!table_) {
@@ -167,7 +290,9 @@ void GroupingSet::addInputForActiveRows(
   ensureInputFits(input);
 
   for (auto i = 0; i < hashers.size(); ++i) {
-    auto key = input->childAt(hashers[i]->channel())->loadedVector();
+    // Partial groups have the keys first.
+    auto key = input->childAt(isPartialGroups ? i : hashers[i]->channel())
+                   ->loadedVector();
     hashers[i]->decode(*key, activeRows_);
   }
 
@@ -190,7 +315,7 @@ void GroupingSet::addInputForActiveRows(
     if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
       table_->decideHashMode(input->size());
     }
-    addInputForActiveRows(input, mayPushdown);
+    addInputForActiveRows(input, mayPushdown, isPartialGroups);
     return;
   }
 
@@ -205,37 +330,99 @@ void GroupingSet::addInputForActiveRows(
   }
 
   table_->groupProbe(*lookup_);
-  masks_.addInput(input, activeRows_);
+  if (!isPartialGroups) {
+    masks_.addInput(input, activeRows_);
+  }
+  if (columnarAccumulators_) {
+    assignGroupIds();
+  }
 
   for (auto i = 0; i < aggregates_.size(); ++i) {
+    auto* groups = columnarAccumulators_
+        ? columnarGroups(i, lookup_->rows)
+        : lookup_->hits.data();
     if (!lookup_->newGroups.empty()) {
-      aggregates_[i]->initializeNewGroups(
-          lookup_->hits.data(), lookup_->newGroups);
+      aggregates_[i]->initializeNewGroups(groups, lookup_->newGroups);
+    }
+
+    if (isPartialGroups) {
+      tempVectors_ = {input->childAt(keyChannels_.size() + i)};
+      aggregates_[i]->addIntermediateResults(
+          groups, activeRows_, tempVectors_, false);
+      continue;
     }
 
-    const auto& rows = getSelectivityVector(i);
+    const auto* rows = &getSelectivityVector(i);
     // Check is mask is false for all rows.
-    if (!rows.hasSelections()) {
+    if (!rows->hasSelections()) {
       continue;
     }
+    if (!distinctInputs_.empty() && distinctInputs_[i] != nullptr) {
+      rows = &distinctRows(i, input, *rows);
+      if (!rows->hasSelections()) {
+        continue;
+      }
+    }
 
     populateTempVectors(i, input);
     // TODO(spershin): We disable the pushdown at the moment if selectivity
     // vector has changed after groups generation, we might want to revisit
     // this.
-    const bool canPushdown = (&rows == &activeRows_) && mayPushdown &&
+    const bool canPushdown = (rows == &activeRows_) && mayPushdown &&
         mayPushdown_[i] && areAllLazyNotLoaded(tempVectors_);
     if (isRawInput_) {
-      aggregates_[i]->addRawInput(
-          lookup_->hits.data(), rows, tempVectors_, canPushdown);
+      aggregates_[i]->addRawInput(groups, *rows, tempVectors_, canPushdown);
     } else {
       aggregates_[i]->addIntermediateResults(
-          lookup_->hits.data(), rows, tempVectors_, canPushdown);
+          groups, *rows, tempVectors_, canPushdown);
     }
   }
   tempVectors_.clear();
 }
 
+void GroupingSet::assignGroupIds() {
+  const auto& hits = lookup_->hits;
+  for (auto row : lookup_->newGroups) {
+    if (numColumnarGroups_ % kGroupsPerBlock == 0) {
+      for (auto& column : columns_) {
+        auto* block = columnsPool_.allocateFixed(
+            column.slotSize * kGroupsPerBlock + column.alignment);
+        column.blocks.push_back(reinterpret_cast<char*>(bits::roundUp(
+            reinterpret_cast<uint64_t>(block), column.alignment)));
+      }
+    }
+    *reinterpret_cast<int32_t*>(hits[row] + groupIdOffset_) =
+        numColumnarGroups_;
+    // A new group starts as null, as in a row of a RowContainer.
+    for (auto i = 0; i < columns_.size(); ++i) {
+      *columnarAccumulator(i, numColumnarGroups_) = RowContainer::nullMask(0);
+    }
+    ++numColumnarGroups_;
+  }
+  groupIds_.resize(hits.size());
+  for (auto row : lookup_->rows) {
+    groupIds_[row] = *reinterpret_cast<int32_t*>(hits[row] + groupIdOffset_);
+  }
+}
+
+char** GroupingSet::columnarGroups(
+    int32_t aggregateIndex,
+    folly::Range<const vector_size_t*> rows) {
+  columnarGroups_.resize(groupIds_.size());
+  for (auto row : rows) {
+    columnarGroups_[row] = columnarAccumulator(aggregateIndex, groupIds_[row]);
+  }
+  return columnarGroups_.data();
+}
+
+void GroupingSet::clearColumnarAccumulators() {
+  for (auto& column : columns_) {
+    column.blocks.clear();
+  }
+  columnsPool_.clear();
+  numColumnarGroups_ = 0;
+}
+
 void GroupingSet::addRemainingInput() {
   activeRows_.resize(remainingInput_->size());
   activeRows_.clearAll();
@@ -247,13 +434,38 @@ void GroupingSet::addRemainingInput() {
 }
 
 void GroupingSet::createHashTable() {
-  if (ignoreNullKeys_) {
+  if (columnarAccumulators_) {
+    // The rows keep the group id instead of the accumulators.
+    static const std::vector<std::unique_ptr<Aggregate>> kNoAggregates;
+    const auto numKeys = hashers_.size();
+    if (ignoreNullKeys_) {
+      table_ = std::make_unique<HashTable<true>>(
+          std::move(hashers_),
+          kNoAggregates,
+          std::vector<TypePtr>{INTEGER()},
+          false, // allowDuplicates
+          false, // isJoinBuild
+          false, // hasProbedFlag
+          mappedMemory_);
+    } else {
+      table_ = std::make_unique<HashTable<false>>(
+          std::move(hashers_),
+          kNoAggregates,
+          std::vector<TypePtr>{INTEGER()},
+          false, // allowDuplicates
+          false, // isJoinBuild
+          false, // hasProbedFlag
+          mappedMemory_);
+    }
+    groupIdOffset_ = table_->rows()->columnAt(numKeys).offset();
+  } else if (ignoreNullKeys_) {
     table_ = HashTable<true>::createForAggregation(
         std::move(hashers_), aggregates_, mappedMemory_);
   } else {
     table_ = HashTable<false>::createForAggregation(
         std::move(hashers_), aggregates_, mappedMemory_);
   }
+  table_->setProbePrefetchBatchSize(prefetchBatchSize_);
   lookup_ = std::make_unique<HashLookup>(table_->hashers());
   if (!isAdaptive_ && table_->hashMode() != BaseHashTable::HashMode::kHash) {
     table_->forceGenericHashMode();
@@ -305,28 +517,32 @@ void GroupingSet::addGlobalAggregationInput(
     bool mayPushdown) {
   initializeGlobalAggregation();
 
-  auto numRows = input->size();
-  activeRows_.resize(numRows);
-  activeRows_.setAll();
-
   masks_.addInput(input, activeRows_);
   for (auto i = 0; i < aggregates_.size(); ++i) {
-    const auto& rows = getSelectivityVector(i);
+    const auto* rows = &getSelectivityVector(i);
 
     // Check is mask is false for all rows.
-    if (!rows.hasSelections()) {
+    if (!rows->hasSelections()) {
       continue;
     }
+    bool isDistinct = false;
+    if (!distinctInputs_.empty() && distinctInputs_[i] != nullptr) {
+      rows = &distinctRows(i, input, *rows);
+      if (!rows->hasSelections()) {
+        continue;
+      }
+      isDistinct = true;
+    }
 
     populateTempVectors(i, input);
-    const bool canPushdown =
-        mayPushdown && mayPushdown_[i] && areAllLazyNotLoaded(tempVectors_);
+    const bool canPushdown = !isDistinct && mayPushdown && mayPushdown_[i] &&
+        areAllLazyNotLoaded(tempVectors_);
     if (isRawInput_) {
       aggregates_[i]->addSingleGroupRawInput(
-          lookup_->hits[0], rows, tempVectors_, canPushdown);
+          lookup_->hits[0], *rows, tempVectors_, canPushdown);
     } else {
       aggregates_[i]->addSingleGroupIntermediateResults(
-          lookup_->hits[0], rows, tempVectors_, canPushdown);
+          lookup_->hits[0], *rows, tempVectors_, canPushdown);
     }
   }
   tempVectors_.clear();
@@ -398,38 +614,202 @@ const SelectivityVector& GroupingSet::getSelectivityVector(
   return *rows;
 }
 
+const SelectivityVector& GroupingSet::distinctRows(
+    size_t aggregateIndex,
+    const RowVectorPtr& input,
+    const SelectivityVector& rows) {
+  auto& distinct = *distinctInputs_[aggregateIndex];
+  if (distinct.table == nullptr) {
+    std::vector<std::unique_ptr<VectorHasher>> hashers;
+    for (auto channel : keyChannels_) {
+      hashers.push_back(
+          VectorHasher::create(input->childAt(channel)->type(), channel));
+    }
+    for (auto channel : channelLists_[aggregateIndex]) {
+      hashers.push_back(
+          VectorHasher::create(input->childAt(channel)->type(), channel));
+    }
+    distinct.table = HashTable<false>::createForAggregation(
+        std::move(hashers), {}, mappedMemory_);
+    distinct.lookup = std::make_unique<HashLookup>(distinct.table->hashers());
+  }
+
+  auto& table = *distinct.table;
+  auto& lookup = *distinct.lookup;
+  auto& hashers = lookup.hashers;
+  for (auto& hasher : hashers) {
+    auto arg = input->childAt(hasher->channel())->loadedVector();
+    hasher->decode(*arg, rows);
+  }
+  for (;;) {
+    lookup.reset(rows.end());
+    bool rehash = false;
+    const auto mode = table.hashMode();
+    for (int32_t i = 0; i < hashers.size(); ++i) {
+      if (mode != BaseHashTable::HashMode::kHash) {
+        if (!hashers[i]->computeValueIds(rows, lookup.hashes)) {
+          rehash = true;
+        }
+      } else {
+        hashers[i]->hash(rows, i > 0, lookup.hashes);
+      }
+    }
+    if (!rehash) {
+      break;
+    }
+    table.decideHashMode(input->size());
+  }
+
+  lookup.rows.clear();
+  rows.applyToSelected([&](auto row) { lookup.rows.push_back(row); });
+  table.groupProbe(lookup);
+
+  distinct.rows.resizeFill(rows.end(), false);
+  for (auto row : lookup.newGroups) {
+    distinct.rows.setValid(row, true);
+  }
+  distinct.rows.updateBounds();
+  return distinct.rows;
+}
+
 bool GroupingSet::getOutput(
     int32_t batchSize,
     RowContainerIterator& iterator,
-    RowVectorPtr& result) {
+    RowVectorPtr& result,
+    const RowVectorPtr& intermediate) {
   if (isGlobal_) {
+    VELOX_CHECK_NULL(intermediate);
     return getGlobalAggregationOutput(batchSize, isPartial_, iterator, result);
   }
   if (spiller_) {
+    VELOX_CHECK_NULL(intermediate);
     return getOutputWithSpill(result);
   }
 
   // @lint-ignore CLANGTIDY
   char* groups[batchSize];
-  int32_t numGroups =
-      table_ ? table_->rows()->listRows(&iterator, batchSize, groups) : 0;
+  int32_t numGroups = 0;
+  while (table_) {
+    numGroups = table_->rows()->listRows(&iterator, batchSize, groups);
+    if (numMergePartitions_ > 1 && numGroups > 0) {
+      // Skips the groups that other drivers output.
+      numGroups = keepPartition(groups, numGroups, mergePartition_);
+      if (numGroups == 0) {
+        continue;
+      }
+    }
+    break;
+  }
   if (!numGroups) {
     if (table_) {
       table_->clear();
+      clearColumnarAccumulators();
+    }
+    // The groups are done, so are their distinct values.
+    for (auto& distinct : distinctInputs_) {
+      if (distinct != nullptr && distinct->table != nullptr) {
+        distinct->table->clear();
+      }
     }
     if (remainingInput_) {
       addRemainingInput();
     }
     return false;
   }
-  extractGroups(folly::Range<char**>(groups, numGroups), result);
+  extractGroups(
+      folly::Range<char**>(groups, numGroups), result, isPartial_, intermediate);
   return true;
 }
 
+void GroupingSet::setMergePartition(int32_t partition, int32_t numPartitions) {
+  VELOX_CHECK(!isGlobal_);
+  VELOX_CHECK_LT(partition, numPartitions);
+  mergePartition_ = partition;
+  numMergePartitions_ = numPartitions;
+}
+
+std::vector<std::vector<RowVectorPtr>> GroupingSet::extractPartitions(
+    int32_t batchSize) {
+  VELOX_CHECK_GT(numMergePartitions_, 1);
+  std::vector<std::vector<RowVectorPtr>> partitions(numMergePartitions_);
+  if (!table_) {
+    return partitions;
+  }
+  // The keys followed by the intermediate results.
+  auto types = table_->rows()->keyTypes();
+  types.insert(
+      types.end(), intermediateTypes_.begin(), intermediateTypes_.end());
+  std::vector<std::string> names;
+  for (auto i = 0; i < types.size(); ++i) {
+    names.push_back(fmt::format("c{}", i));
+  }
+  auto type = ROW(std::move(names), std::move(types));
+  RowContainerIterator iterator;
+  std::vector<char*> groups(batchSize);
+  std::vector<char*> partitionGroups(batchSize);
+  for (;;) {
+    auto numGroups =
+        table_->rows()->listRows(&iterator, batchSize, groups.data());
+    if (numGroups == 0) {
+      break;
+    }
+    for (auto partition = 0; partition < numMergePartitions_; ++partition) {
+      if (partition == mergePartition_) {
+        continue;
+      }
+      std::copy(
+          groups.begin(), groups.begin() + numGroups, partitionGroups.begin());
+      auto numPartitionGroups =
+          keepPartition(partitionGroups.data(), numGroups, partition);
+      if (numPartitionGroups == 0) {
+        continue;
+      }
+      auto result = std::static_pointer_cast<RowVector>(
+          BaseVector::create(type, numPartitionGroups, &pool_));
+      extractGroups(
+          folly::Range<char**>(partitionGroups.data(), numPartitionGroups),
+          result,
+          true);
+      partitions[partition].push_back(std::move(result));
+    }
+  }
+  return partitions;
+}
+
+int32_t GroupingSet::keepPartition(
+    char** groups,
+    int32_t numGroups,
+    int32_t partition) {
+  auto* rows = table_->rows();
+  mergeHashes_.resize(numGroups);
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    rows->hash(
+        i, folly::Range<char**>(groups, numGroups), i > 0, mergeHashes_.data());
+  }
+  int32_t numKept = 0;
+  for (auto i = 0; i < numGroups; ++i) {
+    if (mergeHashes_[i] % numMergePartitions_ == partition) {
+      groups[numKept++] = groups[i];
+    }
+  }
+  return numKept;
+}
+
 void GroupingSet::extractGroups(
     folly::Range<char**> groups,
     const RowVectorPtr& result) {
+  extractGroups(groups, result, isPartial_);
+}
+
+void GroupingSet::extractGroups(
+    folly::Range<char**> groups,
+    const RowVectorPtr& result,
+    bool isPartial,
+    const RowVectorPtr& intermediate) {
   result->resize(groups.size());
+  if (intermediate) {
+    intermediate->resize(groups.size());
+  }
   if (groups.empty()) {
     return;
   }
@@ -438,32 +818,126 @@ void GroupingSet::extractGroups(
   for (int32_t i = 0; i < totalKeys; ++i) {
     auto keyVector = result->childAt(i);
     rows.extractColumn(groups.data(), groups.size(), i, keyVector);
+    if (intermediate) {
+      auto intermediateKeyVector = intermediate->childAt(i);
+      rows.extractColumn(
+          groups.data(), groups.size(), i, intermediateKeyVector);
+    }
+  }
+  std::vector<vector_size_t> allGroups;
+  if (columnarAccumulators_) {
+    groupIds_.resize(groups.size());
+    allGroups.resize(groups.size());
+    for (auto i = 0; i < groups.size(); ++i) {
+      groupIds_[i] = *reinterpret_cast<int32_t*>(groups[i] + groupIdOffset_);
+      allGroups[i] = i;
+    }
   }
   for (int32_t i = 0; i < aggregates_.size(); ++i) {
-    aggregates_[i]->finalize(groups.data(), groups.size());
+    auto* aggregateGroups = columnarAccumulators_
+        ? columnarGroups(i, allGroups)
+        : groups.data();
+    // Accumulators are finalized once, before extracting any of the results.
+    aggregates_[i]->finalize(aggregateGroups, groups.size());
+    if (intermediate) {
+      aggregates_[i]->extractAccumulators(
+          aggregateGroups,
+          groups.size(),
+          &intermediate->childAt(i + totalKeys));
+    }
     auto& aggregateVector = result->childAt(i + totalKeys);
-    if (isPartial_) {
+    if (isPartial) {
       aggregates_[i]->extractAccumulators(
-          groups.data(), groups.size(), &aggregateVector);
+          aggregateGroups, groups.size(), &aggregateVector);
     } else {
       aggregates_[i]->extractValues(
-          groups.data(), groups.size(), &aggregateVector);
+          aggregateGroups, groups.size(), &aggregateVector);
+    }
+  }
+}
+
+void GroupingSet::toIntermediate(
+    const RowVectorPtr& input,
+    RowVectorPtr& result) {
+  VELOX_CHECK(isPartial_ && isRawInput_ && !isGlobal_);
+  VELOX_CHECK(distinctInputs_.empty());
+  if (!table_) {
+    createHashTable();
+  }
+  const auto numRows = input->size();
+  activeRows_.resize(numRows);
+  activeRows_.setAll();
+  masks_.addInput(input, activeRows_);
+
+  result->resize(numRows);
+  auto numKeys = keyChannels_.size();
+  for (auto i = 0; i < numKeys; ++i) {
+    result->childAt(i) =
+        BaseVector::loadedVectorShared(input->childAt(keyChannels_[i]));
+  }
+
+  // Makes one group per row with the layout of the rows of 'table_'. The
+  // aggregates take turns using the same groups if the accumulators are not
+  // in the rows.
+  auto rowSize = table_->rows()->fixedRowSize();
+  if (columnarAccumulators_) {
+    rowSize = 0;
+    for (const auto& column : columns_) {
+      rowSize = std::max(rowSize, column.slotSize);
     }
   }
+  auto* rows = intermediateRows_.allocateFixed(rowSize * numRows);
+  memset(rows, 0, rowSize * numRows);
+  intermediateGroups_.resize(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    intermediateGroups_[i] = rows + i * rowSize;
+  }
+  auto* groups = intermediateGroups_.data();
+  std::vector<vector_size_t> allRows(numRows);
+  std::iota(allRows.begin(), allRows.end(), 0);
+
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    if (columnarAccumulators_ && i > 0) {
+      memset(rows, 0, rowSize * numRows);
+    }
+    aggregates_[i]->initializeNewGroups(groups, allRows);
+    const auto& aggregateRows = getSelectivityVector(i);
+    if (aggregateRows.hasSelections()) {
+      populateTempVectors(i, input);
+      aggregates_[i]->addRawInput(groups, aggregateRows, tempVectors_, false);
+    }
+    aggregates_[i]->finalize(groups, numRows);
+    aggregates_[i]->extractAccumulators(
+        groups, numRows, &result->childAt(numKeys + i));
+    if (aggregates_[i]->accumulatorUsesExternalMemory()) {
+      aggregates_[i]->destroy(folly::Range<char**>(groups, numRows));
+    }
+  }
+  tempVectors_.clear();
+  intermediateRows_.clear();
 }
 
 void GroupingSet::resetPartial() {
   if (table_ != nullptr) {
     table_->clear();
+    clearColumnarAccumulators();
   }
 }
 
 uint64_t GroupingSet::allocatedBytes() const {
+  uint64_t distinctBytes = 0;
+  for (const auto& distinct : distinctInputs_) {
+    if (distinct != nullptr && distinct->table != nullptr) {
+      distinctBytes += distinct->table->allocatedBytes();
+    }
+  }
   if (table_) {
-    return table_->allocatedBytes();
+    return table_->allocatedBytes() + columnsPool_.allocatedBytes() +
+        distinctBytes;
   }
 
-  return stringAllocator_.retainedSize() + rows_.allocatedBytes();
+  return stringAllocator_.retainedSize() + rows_.allocatedBytes() +
+      distinctBytes;
 }
 
 const HashLookup& GroupingSet::hashLookup() const {
@@ -543,6 +1017,12 @@ void GroupingSet::ensureInputFits(const RowVectorPtr& input) {
   if (tracker->maybeReserve(targetIncrement)) {
     return;
   }
+  // The Task may spill another operator that holds more memory, or 'this'.
+  if (operatorCtx_->reclaimFromTask(targetIncrement) &&
+      (table_->numDistinct() < numDistinct ||
+       tracker->maybeReserve(targetIncrement))) {
+    return;
+  }
   auto rowsToSpill = std::max<int64_t>(
       1, targetIncrement / (rows->fixedRowSize() + outOfLineBytesPerRow));
   spill(
@@ -551,6 +1031,14 @@ void GroupingSet::ensureInputFits(const RowVectorPtr& input) {
           0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
 }
 
+int64_t GroupingSet::reclaimableBytes() const {
+  if (isPartial_ || spillConfig_ == nullptr || noMoreInput_ ||
+      table_ == nullptr || table_->numDistinct() == 0) {
+    return 0;
+  }
+  return allocatedBytes();
+}
+
 void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
   if (!spiller_) {
     auto rows = table_->rows();
@@ -577,7 +1065,9 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig_->filePath,
         fileSize,
         Spiller::spillPool(),
-        spillConfig_->executor);
+        spillConfig_->executor,
+        spillConfig_->compressionKind,
+        spillConfig_->writeOptions);
   }
   spiller_->spill(targetRows, targetBytes);
 }
@@ -631,7 +1121,8 @@ bool GroupingSet::getOutputWithSpill(const RowVectorPtr& result) {
   }
   while (outputPartition_ < spiller_->state().maxPartitions()) {
     if (!merge_) {
-      merge_ = spiller_->startMerge(outputPartition_);
+      merge_ = spiller_->startMerge(
+          outputPartition_, spillConfig_->readOptions);
     }
     // NOTE: 'merge_' might be nullptr if 'outputPartition_' is empty.
     if (merge_ == nullptr || !mergeNext(result)) {
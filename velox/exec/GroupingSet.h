@@ -39,12 +39,27 @@ class GroupingSet {
       bool isPartial,
       bool isRawInput,
       const Spiller::Config* FOLLY_NULLABLE spillConfig,
-      OperatorCtx* FOLLY_NONNULL operatorCtx);
+      OperatorCtx* FOLLY_NONNULL operatorCtx,
+      const std::vector<bool>& distinctAggregates = {});
 
   ~GroupingSet();
 
   void addInput(const RowVectorPtr& input, bool mayPushdown);
 
+  /// True if addInputRows() is supported. It is not when the input is
+  /// pre-grouped or checked for clustering, since these look at consecutive
+  /// rows.
+  bool supportsInputRows() const {
+    return preGroupedKeyChannels_.empty() && !detectClusteredInput_;
+  }
+
+  /// Adds the 'rows' of 'input', e.g. the rows that passed a filter, without
+  /// the rows being copied or wrapped.
+  void addInputRows(
+      const RowVectorPtr& input,
+      const SelectivityVector& rows,
+      bool mayPushdown);
+
   void noMoreInput();
 
   /// Typically, the output is not available until all input has been added.
@@ -56,11 +71,36 @@ class GroupingSet {
   bool hasOutput();
 
   /// Called if partial aggregation has reached memory limit or if hasOutput()
-  /// returns true.
+  /// returns true. If 'intermediate' is not null, also copies the grouping
+  /// keys and the intermediate results of the same groups into it. This is
+  /// not supported for global aggregations or after spilling.
   bool getOutput(
       int32_t batchSize,
       RowContainerIterator& iterator,
-      RowVectorPtr& result);
+      RowVectorPtr& result,
+      const RowVectorPtr& intermediate = nullptr);
+
+  /// Converts each row of 'input' into an intermediate result of its own with
+  /// the grouping keys of the row, without adding the row to the hash table.
+  /// Used by partial aggregation when the input has so many distinct keys that
+  /// aggregating does not pay off.
+  void toIntermediate(const RowVectorPtr& input, RowVectorPtr& result);
+
+  /// Adds the groups of other drivers of an aggregation with
+  /// core::AggregationNode::localMerge(). 'groups' has the grouping keys
+  /// followed by the intermediate results, as made by extractPartitions().
+  void addPartialGroups(const RowVectorPtr& groups);
+
+  /// Makes getOutput() return only the groups in hash partition 'partition'
+  /// of 'numPartitions' partitions of the grouping keys. The groups in the
+  /// other partitions are merged by other drivers. See
+  /// core::AggregationNode::localMerge().
+  void setMergePartition(int32_t partition, int32_t numPartitions);
+
+  /// Returns the groups of each partition other than the one given to
+  /// setMergePartition() in batches of up to 'batchSize' rows, with the
+  /// grouping keys followed by the intermediate results.
+  std::vector<std::vector<RowVectorPtr>> extractPartitions(int32_t batchSize);
 
   uint64_t allocatedBytes() const;
 
@@ -77,25 +117,45 @@ class GroupingSet {
   /// of this will be in a paused state and off thread.
   void spill(int64_t targetRows, int64_t targetBytes);
 
+  /// Returns the memory that spill(0, 0) would free. 0 if 'this' doesn't
+  /// spill or has no more input to accumulate.
+  int64_t reclaimableBytes() const;
+
   /// Returns the spiller stats including total bytes and rows spilled so far.
   Spiller::Stats spilledStats() const {
     return spiller_ != nullptr ? spiller_->stats() : Spiller::Stats{};
   }
 
+  /// Returns the switches of hash mode of the hash table so far.
+  BaseHashTable::HashModeStats hashModeStats() const {
+    return table_ != nullptr ? table_->hashModeStats()
+                             : BaseHashTable::HashModeStats{};
+  }
+
   /// Return the number of rows kept in memory.
   int64_t numRows() const {
     return table_ ? table_->rows()->numRows() : 0;
   }
 
  private:
-  void addInputForActiveRows(const RowVectorPtr& input, bool mayPushdown);
+  // Adds the active rows of 'input'. If 'isPartialGroups' is true, 'input' is
+  // from addPartialGroups().
+  void addInputForActiveRows(
+      const RowVectorPtr& input,
+      bool mayPushdown,
+      bool isPartialGroups = false);
 
   void addRemainingInput();
 
+  // Returns true if 'input' has long runs of rows with identical grouping
+  // keys.
+  bool isClustered(const RowVectorPtr& input) const;
+
   void initializeGlobalAggregation();
 
   void destroyGlobalAggregations();
 
+  // Adds the active rows of 'input' to the global aggregates.
   void addGlobalAggregationInput(const RowVectorPtr& input, bool mayPushdown);
 
   bool getGlobalAggregationOutput(
@@ -113,16 +173,61 @@ class GroupingSet {
   // index for this aggregation), otherwise it returns reference to activeRows_.
   const SelectivityVector& getSelectivityVector(size_t aggregateIndex) const;
 
+  // Returns the subset of 'rows' of 'input' with the first occurrence of each
+  // combination of grouping keys and arguments of the DISTINCT aggregate at
+  // 'aggregateIndex'. Remembers the combinations for the next calls.
+  const SelectivityVector& distinctRows(
+      size_t aggregateIndex,
+      const RowVectorPtr& input,
+      const SelectivityVector& rows);
+
   // Checks if input will fit in the existing memory and increases
   // reservation if not. If reservation cannot be increased, spills
   // enough to make 'input' fit.
   void ensureInputFits(const RowVectorPtr& input);
 
+  // Gives a group id to the new groups in 'lookup_' and makes space for their
+  // accumulators in 'columns_'. Sets 'groupIds_' to the group ids of the rows
+  // of 'lookup_'. Used with 'columnarAccumulators_'.
+  void assignGroupIds();
+
+  // Sets 'columnarGroups_[rows[i]]' to the accumulator of the aggregate at
+  // 'aggregateIndex' for the group with id 'groupIds_[rows[i]]'. Returns
+  // 'columnarGroups_'.
+  char** columnarGroups(
+      int32_t aggregateIndex,
+      folly::Range<const vector_size_t*> rows);
+
+  // Returns the accumulator of the aggregate at 'aggregateIndex' for the group
+  // with 'groupId'.
+  char* FOLLY_NONNULL
+  columnarAccumulator(int32_t aggregateIndex, int32_t groupId) const {
+    const auto& column = columns_[aggregateIndex];
+    return column.blocks[groupId / kGroupsPerBlock] +
+        (groupId % kGroupsPerBlock) * column.slotSize;
+  }
+
+  // Drops the groups in 'columns_'.
+  void clearColumnarAccumulators();
+
   // Copies the grouping keys and aggregates for 'groups' into 'result' If
   // partial output, extracts the intermediate type for aggregates, final result
   // otherwise.
   void extractGroups(folly::Range<char**> groups, const RowVectorPtr& result);
 
+  // Same as above but extracts the intermediate type for aggregates if
+  // 'isPartial' is true. If 'intermediate' is not null, also copies the keys
+  // and the intermediate type for aggregates into it.
+  void extractGroups(
+      folly::Range<char**> groups,
+      const RowVectorPtr& result,
+      bool isPartial,
+      const RowVectorPtr& intermediate = nullptr);
+
+  // Moves the groups in hash partition 'partition' of 'numMergePartitions_'
+  // to the start of 'groups'. Returns their number.
+  int32_t keepPartition(char** groups, int32_t numGroups, int32_t partition);
+
   /// Produces output in if spilling has occurred. First produces data
   /// from non-spilled partitions, then merges spill runs and
   /// unspilled data form spilled partitions. Returns nullptr when at
@@ -160,6 +265,11 @@ class GroupingSet {
   /// A subset of grouping keys on which the input is clustered.
   const std::vector<column_index_t> preGroupedKeyChannels_;
 
+  /// True if input batches found clustered on all grouping keys are processed
+  /// as if pre-grouped on these. Only for partial output, where a group that
+  /// appears again later is output again.
+  const bool detectClusteredInput_;
+
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
   const bool isGlobal_;
   const bool isPartial_;
@@ -176,6 +286,58 @@ class GroupingSet {
   // Types for extracting accumulators for spilling.
   const std::vector<TypePtr> intermediateTypes_;
 
+  // True if the accumulators are kept in 'columns_' instead of the rows of
+  // 'table_'. The rows then have the group id as their only dependent field.
+  // See QueryConfig::kAggregationColumnarAccumulators.
+  const bool columnarAccumulators_;
+
+  // Number of groups in a block of an AccumulatorColumn.
+  static constexpr int32_t kGroupsPerBlock = 4096;
+
+  // The accumulators of one aggregate, indexed by group id. Group 'i' is at
+  // blocks[i / kGroupsPerBlock] + (i % kGroupsPerBlock) * slotSize.
+  struct AccumulatorColumn {
+    // Bytes per group, i.e. a null flag followed by the aligned accumulator.
+    int32_t slotSize;
+    int32_t alignment;
+    std::vector<char*> blocks;
+  };
+
+  // Corresponds pairwise to 'aggregates_' if 'columnarAccumulators_' is set.
+  std::vector<AccumulatorColumn> columns_;
+
+  // Number of groups in 'columns_'.
+  int32_t numColumnarGroups_{0};
+
+  // Offset of the group id in the rows of 'table_'.
+  int32_t groupIdOffset_{0};
+
+  // Group ids of the rows of the last input.
+  std::vector<int32_t> groupIds_;
+
+  // Accumulators of one aggregate for the rows of the last input.
+  std::vector<char*> columnarGroups_;
+
+  // See setMergePartition().
+  int32_t mergePartition_{0};
+  int32_t numMergePartitions_{1};
+
+  // Hashes of the grouping keys in keepPartition().
+  std::vector<uint64_t> mergeHashes_;
+
+  // The combinations of grouping keys and arguments seen by a DISTINCT
+  // aggregate. The table has no accumulators.
+  struct DistinctInput {
+    std::unique_ptr<BaseHashTable> table;
+    std::unique_ptr<HashLookup> lookup;
+    // The rows with new combinations in the last input.
+    SelectivityVector rows;
+  };
+
+  // Corresponds pairwise to 'aggregates_'. nullptr for aggregates without
+  // DISTINCT.
+  std::vector<std::unique_ptr<DistinctInput>> distinctInputs_;
+
   const bool ignoreNullKeys_;
 
   memory::MappedMemory* FOLLY_NONNULL const mappedMemory_;
@@ -202,8 +364,20 @@ class GroupingSet {
   // aggregation
   HashStringAllocator stringAllocator_;
   AllocationPool rows_;
+
+  // Accumulators for the rows given to toIntermediate(). Freed after each
+  // call.
+  AllocationPool intermediateRows_;
+  std::vector<char*> intermediateGroups_;
+
+  // Memory for the blocks of 'columns_'.
+  AllocationPool columnsPool_;
   const bool isAdaptive_;
 
+  // Number of probes for which 'table_' prefetches buckets ahead of the
+  // compares.
+  const int32_t prefetchBatchSize_;
+
   bool noMoreInput_{false};
 
   /// In case of partial streaming aggregation, the input vector passed to
@@ -252,6 +426,9 @@ class GroupingSet {
   // Pool of the OperatorCtx. Used for spilling.
   memory::MemoryPool& pool_;
 
+  // Used for asking the Task to reclaim memory before spilling.
+  OperatorCtx* FOLLY_NONNULL const operatorCtx_;
+
   // The RowContainer of 'table_' is moved here before freeing
   // 'table_' when starting to read spill output.
   std::unique_ptr<RowContainer> rowsWhileReadingSpill_;
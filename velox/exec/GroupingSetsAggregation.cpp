@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/GroupingSetsAggregation.h"
+#include "velox/exec/Aggregate.h"
+
+namespace facebook::velox::exec {
+namespace {
+RowTypePtr makeRowType(std::vector<TypePtr> types) {
+  std::vector<std::string> names;
+  names.reserve(types.size());
+  for (auto i = 0; i < types.size(); ++i) {
+    names.push_back(fmt::format("c{}", i));
+  }
+  return ROW(std::move(names), std::move(types));
+}
+} // namespace
+
+GroupingSetsAggregation::GroupingSetsAggregation(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::GroupIdNode>& groupIdNode,
+    const std::shared_ptr<const core::AggregationNode>& aggregationNode)
+    : Operator(
+          driverCtx,
+          aggregationNode->outputType(),
+          operatorId,
+          aggregationNode->id(),
+          aggregationNode->step() == core::AggregationNode::Step::kPartial
+              ? "PartialAggregation"
+              : "Aggregation"),
+      outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
+      isPartialOutput_(isPartialOutput(aggregationNode->step())) {
+  VELOX_CHECK(canDerive(*groupIdNode, *aggregationNode));
+  const auto& groupIdType = groupIdNode->outputType();
+  const auto& inputType = groupIdNode->sources()[0]->outputType();
+
+  // The grouping keys of the output other than the group id map to the
+  // grouping keys in the input of the GroupId.
+  const auto& groupingKeys = aggregationNode->groupingKeys();
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  std::vector<TypePtr> keyTypes;
+  std::unordered_map<std::string, column_index_t> inputKeyToBaseKey;
+  for (auto i = 0; i < groupingKeys.size(); ++i) {
+    const auto& name = groupingKeys[i]->name();
+    if (name == groupIdNode->groupIdName()) {
+      groupIdKey_ = i;
+      outputKeys_.emplace_back(std::nullopt);
+      continue;
+    }
+    const auto& inputKey = groupIdNode->outputGroupingKeyNames().at(name);
+    const auto channel = inputType->getChildIdx(inputKey->name());
+    inputKeyToBaseKey[inputKey->name()] = hashers.size();
+    outputKeys_.emplace_back(hashers.size());
+    baseKeys_.push_back(hashers.size());
+    keyTypes.push_back(inputType->childAt(channel));
+    hashers.push_back(VectorHasher::create(keyTypes.back(), channel));
+  }
+
+  // The aggregation inputs of the GroupId keep their names.
+  const auto numAggregates = aggregationNode->aggregates().size();
+  std::vector<std::unique_ptr<Aggregate>> aggregates;
+  std::vector<std::optional<column_index_t>> aggrMaskChannels;
+  std::vector<std::vector<column_index_t>> args;
+  std::vector<std::vector<VectorPtr>> constantLists;
+  std::vector<TypePtr> intermediateTypes;
+  std::vector<TypePtr> resultTypes;
+  for (auto i = 0; i < numAggregates; ++i) {
+    const auto& aggregate = aggregationNode->aggregates()[i];
+    std::vector<column_index_t> channels;
+    std::vector<VectorPtr> constants;
+    std::vector<TypePtr> argTypes;
+    for (auto& arg : aggregate->inputs()) {
+      argTypes.push_back(arg->type());
+      auto channel = exprToChannel(arg.get(), groupIdType);
+      if (channel == kConstantChannel) {
+        auto constant = dynamic_cast<const core::ConstantTypedExpr*>(arg.get());
+        if (constant->hasValueVector()) {
+          constants.push_back(
+              BaseVector::wrapInConstant(1, 0, constant->valueVector()));
+        } else {
+          constants.push_back(BaseVector::createConstant(
+              constant->value(), 1, operatorCtx_->pool()));
+        }
+      } else {
+        channel = inputType->getChildIdx(groupIdType->nameOf(channel));
+        constants.push_back(nullptr);
+      }
+      channels.push_back(channel);
+    }
+    intermediateTypes.push_back(
+        Aggregate::intermediateType(aggregate->name(), argTypes));
+    resultTypes.push_back(outputType_->childAt(groupingKeys.size() + i));
+    aggregates.push_back(Aggregate::create(
+        aggregate->name(), aggregationNode->step(), argTypes, resultTypes[i]));
+    aggrMaskChannels.emplace_back(std::nullopt);
+    args.push_back(std::move(channels));
+    constantLists.push_back(std::move(constants));
+  }
+
+  auto baseResultTypes = keyTypes;
+  baseResultTypes.insert(
+      baseResultTypes.end(), resultTypes.begin(), resultTypes.end());
+  baseResultType_ = makeRowType(std::move(baseResultTypes));
+  auto baseIntermediateTypes = keyTypes;
+  baseIntermediateTypes.insert(
+      baseIntermediateTypes.end(),
+      intermediateTypes.begin(),
+      intermediateTypes.end());
+  baseIntermediateType_ = makeRowType(std::move(baseIntermediateTypes));
+
+  // The derived sets aggregate the intermediate results of the base groups.
+  const auto derivedStep = isPartialOutput_
+      ? core::AggregationNode::Step::kIntermediate
+      : core::AggregationNode::Step::kFinal;
+  const auto& groupingSets = groupIdNode->groupingSets();
+  for (auto groupId = 0; groupId < groupingSets.size(); ++groupId) {
+    std::vector<column_index_t> keys;
+    for (const auto& key : groupingSets[groupId]) {
+      keys.push_back(inputKeyToBaseKey.at(key->name()));
+    }
+    std::sort(keys.begin(), keys.end());
+    if (keys == baseKeys_ && !baseGroupId_.has_value()) {
+      baseGroupId_ = groupId;
+      continue;
+    }
+
+    std::vector<std::unique_ptr<VectorHasher>> setHashers;
+    std::vector<TypePtr> setInputTypes;
+    for (auto i = 0; i < keys.size(); ++i) {
+      setHashers.push_back(VectorHasher::create(keyTypes[keys[i]], i));
+      setInputTypes.push_back(keyTypes[keys[i]]);
+    }
+    auto setResultTypes = setInputTypes;
+    std::vector<std::unique_ptr<Aggregate>> setAggregates;
+    std::vector<std::optional<column_index_t>> setMaskChannels;
+    std::vector<std::vector<column_index_t>> setArgs;
+    std::vector<std::vector<VectorPtr>> setConstants;
+    for (auto i = 0; i < numAggregates; ++i) {
+      setAggregates.push_back(Aggregate::create(
+          aggregationNode->aggregates()[i]->name(),
+          derivedStep,
+          {intermediateTypes[i]},
+          resultTypes[i]));
+      setMaskChannels.emplace_back(std::nullopt);
+      setArgs.push_back({static_cast<column_index_t>(keys.size() + i)});
+      setConstants.push_back({nullptr});
+      setInputTypes.push_back(intermediateTypes[i]);
+      setResultTypes.push_back(resultTypes[i]);
+    }
+    auto setIntermediateTypes = intermediateTypes;
+
+    DerivedSet set;
+    set.groupId = groupId;
+    set.keys = std::move(keys);
+    set.inputType = makeRowType(std::move(setInputTypes));
+    set.resultType = makeRowType(std::move(setResultTypes));
+    set.groupingSet = std::make_unique<GroupingSet>(
+        std::move(setHashers),
+        std::vector<column_index_t>{},
+        std::move(setAggregates),
+        std::move(setMaskChannels),
+        std::move(setArgs),
+        std::move(setConstants),
+        std::move(setIntermediateTypes),
+        false,
+        isPartialOutput_,
+        false,
+        nullptr,
+        operatorCtx_.get());
+    derivedSets_.push_back(std::move(set));
+  }
+
+  // The groups are kept until all are added to the derived sets, so the
+  // base aggregation does not spill.
+  baseGroupingSet_ = std::make_unique<GroupingSet>(
+      std::move(hashers),
+      std::vector<column_index_t>{},
+      std::move(aggregates),
+      std::move(aggrMaskChannels),
+      std::move(args),
+      std::move(constantLists),
+      std::move(intermediateTypes),
+      false,
+      isPartialOutput_,
+      true,
+      nullptr,
+      operatorCtx_.get());
+}
+
+// static
+bool GroupingSetsAggregation::canDerive(
+    const core::GroupIdNode& groupIdNode,
+    const core::AggregationNode& aggregationNode) {
+  const auto step = aggregationNode.step();
+  if ((step != core::AggregationNode::Step::kPartial &&
+       step != core::AggregationNode::Step::kSingle) ||
+      aggregationNode.aggregates().empty() ||
+      aggregationNode.hasDistinctAggregates() ||
+      !aggregationNode.preGroupedKeys().empty() ||
+      aggregationNode.localMerge() || aggregationNode.ignoreNullKeys()) {
+    return false;
+  }
+  for (const auto& mask : aggregationNode.aggregateMasks()) {
+    if (mask != nullptr) {
+      return false;
+    }
+  }
+
+  // The aggregation must group on all the grouping keys and the group id.
+  const auto numGroupingKeys = groupIdNode.numGroupingKeys();
+  const auto& groupingKeys = aggregationNode.groupingKeys();
+  if (numGroupingKeys == 0 || groupingKeys.size() != numGroupingKeys + 1) {
+    return false;
+  }
+  std::unordered_set<std::string> inputKeys;
+  for (const auto& key : groupingKeys) {
+    if (key->name() == groupIdNode.groupIdName()) {
+      continue;
+    }
+    auto it = groupIdNode.outputGroupingKeyNames().find(key->name());
+    if (it == groupIdNode.outputGroupingKeyNames().end() ||
+        !inputKeys.insert(it->second->name()).second) {
+      return false;
+    }
+  }
+  if (inputKeys.size() != numGroupingKeys) {
+    return false;
+  }
+
+  // The aggregates may only read the aggregation inputs of the GroupId, which
+  // are the same in all grouping sets.
+  const auto& groupIdType = groupIdNode.outputType();
+  const auto numAggregationInputs = groupIdNode.aggregationInputs().size();
+  for (const auto& aggregate : aggregationNode.aggregates()) {
+    for (const auto& arg : aggregate->inputs()) {
+      if (dynamic_cast<const core::ConstantTypedExpr*>(arg.get())) {
+        continue;
+      }
+      auto field = dynamic_cast<const core::FieldAccessTypedExpr*>(arg.get());
+      if (field == nullptr) {
+        return false;
+      }
+      auto channel = groupIdType->getChildIdxIfExists(field->name());
+      if (!channel.has_value() || channel.value() < numGroupingKeys ||
+          channel.value() >= numGroupingKeys + numAggregationInputs) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void GroupingSetsAggregation::addInput(RowVectorPtr input) {
+  baseGroupingSet_->addInput(input, false);
+}
+
+void GroupingSetsAggregation::noMoreInput() {
+  baseGroupingSet_->noMoreInput();
+  Operator::noMoreInput();
+}
+
+RowVectorPtr GroupingSetsAggregation::getOutput() {
+  if (finished_) {
+    return nullptr;
+  }
+
+  if (!baseDone_) {
+    // A partial aggregation over clustered input may have groups ready before
+    // the end of its input. These are output and added to the derived sets
+    // right away.
+    if (!noMoreInput_ && !baseGroupingSet_->hasOutput()) {
+      return nullptr;
+    }
+    for (;;) {
+      auto result = std::static_pointer_cast<RowVector>(
+          operatorCtx_->execCtx()->vectorPool().getReusable(
+              baseResultType_, outputBatchSize_));
+      // Partial output consists of the intermediate results.
+      RowVectorPtr intermediate = isPartialOutput_
+          ? nullptr
+          : std::static_pointer_cast<RowVector>(BaseVector::create(
+                baseIntermediateType_, outputBatchSize_, pool()));
+      if (!baseGroupingSet_->getOutput(
+              outputBatchSize_, baseIterator_, result, intermediate)) {
+        baseIterator_.reset();
+        if (!noMoreInput_) {
+          return nullptr;
+        }
+        baseDone_ = true;
+        for (auto& set : derivedSets_) {
+          set.groupingSet->noMoreInput();
+        }
+        break;
+      }
+      hasBaseGroups_ = true;
+      addToDerivedSets(isPartialOutput_ ? result : intermediate);
+      if (baseGroupId_.has_value()) {
+        return makeOutput(baseGroupId_.value(), baseKeys_, result);
+      }
+    }
+  }
+
+  auto output = hasBaseGroups_ ? getDerivedOutput() : nullptr;
+  if (output == nullptr) {
+    finished_ = true;
+  }
+  return output;
+}
+
+void GroupingSetsAggregation::addToDerivedSets(
+    const RowVectorPtr& intermediate) {
+  const auto numBaseKeys = baseKeys_.size();
+  const auto numAggregates = outputType_->size() - outputKeys_.size();
+  for (auto& set : derivedSets_) {
+    std::vector<VectorPtr> children;
+    children.reserve(set.keys.size() + numAggregates);
+    for (auto key : set.keys) {
+      children.push_back(intermediate->childAt(key));
+    }
+    for (auto i = 0; i < numAggregates; ++i) {
+      children.push_back(intermediate->childAt(numBaseKeys + i));
+    }
+    set.groupingSet->addInput(
+        std::make_shared<RowVector>(
+            pool(),
+            set.inputType,
+            nullptr,
+            intermediate->size(),
+            std::move(children)),
+        false);
+  }
+}
+
+RowVectorPtr GroupingSetsAggregation::getDerivedOutput() {
+  while (derivedOutputIndex_ < derivedSets_.size()) {
+    auto& set = derivedSets_[derivedOutputIndex_];
+    const auto batchSize = set.keys.empty() ? 1 : outputBatchSize_;
+    auto result = std::static_pointer_cast<RowVector>(
+        operatorCtx_->execCtx()->vectorPool().getReusable(
+            set.resultType, batchSize));
+    if (set.groupingSet->getOutput(batchSize, set.iterator, result)) {
+      return makeOutput(set.groupId, set.keys, result);
+    }
+    // Frees the groups of the set.
+    set.groupingSet.reset();
+    ++derivedOutputIndex_;
+  }
+  return nullptr;
+}
+
+RowVectorPtr GroupingSetsAggregation::makeOutput(
+    int64_t groupId,
+    const std::vector<column_index_t>& setKeys,
+    const RowVectorPtr& groups) {
+  const auto numRows = groups->size();
+  const auto numKeys = outputKeys_.size();
+  std::vector<VectorPtr> columns(outputType_->size());
+  for (auto i = 0; i < numKeys; ++i) {
+    if (i == groupIdKey_) {
+      columns[i] = BaseVector::createConstant(groupId, numRows, pool());
+      continue;
+    }
+    auto it =
+        std::find(setKeys.begin(), setKeys.end(), outputKeys_[i].value());
+    if (it == setKeys.end()) {
+      // The key is not in the grouping set.
+      columns[i] = BaseVector::createNullConstant(
+          outputType_->childAt(i), numRows, pool());
+    } else {
+      columns[i] = groups->childAt(it - setKeys.begin());
+    }
+  }
+  for (auto i = numKeys; i < columns.size(); ++i) {
+    columns[i] = groups->childAt(setKeys.size() + i - numKeys);
+  }
+  return std::make_shared<RowVector>(
+      pool(), outputType_, nullptr, numRows, std::move(columns));
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/GroupingSet.h"
+#include "velox/exec/Operator.h"
+
+namespace facebook::velox::exec {
+
+/// Runs a partial or single aggregation over a GroupId, i.e. GROUPING SETS,
+/// CUBE or ROLLUP, without replicating the input once per grouping set. The
+/// input of the GroupId is aggregated once on all grouping keys. The
+/// intermediate results of these groups are then aggregated again on the keys
+/// of each grouping set. A grouping set with all the grouping keys is output
+/// directly from the first aggregation. See
+/// QueryConfig::kAggregationDeriveGroupingSets.
+class GroupingSetsAggregation : public Operator {
+ public:
+  GroupingSetsAggregation(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::GroupIdNode>& groupIdNode,
+      const std::shared_ptr<const core::AggregationNode>& aggregationNode);
+
+  /// Returns true if 'aggregationNode' over 'groupIdNode' can run as a
+  /// GroupingSetsAggregation.
+  static bool canDerive(
+      const core::GroupIdNode& groupIdNode,
+      const core::AggregationNode& aggregationNode);
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void noMoreInput() override;
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return finished_;
+  }
+
+  void close() override {
+    Operator::close();
+    baseGroupingSet_.reset();
+    derivedSets_.clear();
+  }
+
+ private:
+  // A grouping set aggregated from the intermediate results of
+  // 'baseGroupingSet_'.
+  struct DerivedSet {
+    // Index of the grouping set in the GroupId.
+    int64_t groupId;
+    // Indices of the grouping keys of the set in the keys of
+    // 'baseGroupingSet_'.
+    std::vector<column_index_t> keys;
+    // The keys of the set followed by the intermediate results, respectively
+    // the output types of the aggregates.
+    RowTypePtr inputType;
+    RowTypePtr resultType;
+    std::unique_ptr<GroupingSet> groupingSet;
+    RowContainerIterator iterator;
+  };
+
+  // Makes the output for the grouping set with 'groupId' from 'groups', which
+  // has the keys of the set followed by the aggregates.
+  RowVectorPtr makeOutput(
+      int64_t groupId,
+      const std::vector<column_index_t>& setKeys,
+      const RowVectorPtr& groups);
+
+  // Adds the intermediate results of a batch of groups of 'baseGroupingSet_'
+  // to the derived sets.
+  void addToDerivedSets(const RowVectorPtr& intermediate);
+
+  // Returns the next batch of output of the derived sets. Returns nullptr when
+  // all are done.
+  RowVectorPtr getDerivedOutput();
+
+  const uint32_t outputBatchSize_;
+  const bool isPartialOutput_;
+
+  // Position of the group id among the grouping keys of the output.
+  column_index_t groupIdKey_{0};
+
+  // The position of each grouping key of the output, other than the group id,
+  // in the keys of 'baseGroupingSet_'.
+  std::vector<std::optional<column_index_t>> outputKeys_;
+
+  // Types of the keys of 'baseGroupingSet_' followed by the output types of
+  // the aggregates, respectively their intermediate types.
+  RowTypePtr baseResultType_;
+  RowTypePtr baseIntermediateType_;
+
+  // Aggregates the input on all the grouping keys.
+  std::unique_ptr<GroupingSet> baseGroupingSet_;
+  RowContainerIterator baseIterator_;
+
+  // Group id of the grouping set with all the grouping keys, if any.
+  std::optional<int64_t> baseGroupId_;
+  std::vector<column_index_t> baseKeys_;
+
+  std::vector<DerivedSet> derivedSets_;
+
+  // Index of the derived set in 'derivedSets_' being output.
+  int32_t derivedOutputIndex_{0};
+
+  // True if 'baseGroupingSet_' had any groups. An empty input produces no
+  // groups, not even for the grouping sets without keys.
+  bool hasBaseGroups_{false};
+
+  // True once all the groups of 'baseGroupingSet_' are added to the derived
+  // sets.
+  bool baseDone_{false};
+
+  bool finished_{false};
+};
+
+} // namespace facebook::velox::exec
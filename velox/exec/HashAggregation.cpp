@@ -14,12 +14,18 @@
  * limitations under the License.
  */
 #include "velox/exec/HashAggregation.h"
+#include <folly/hash/Hash.h>
 #include <optional>
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
+namespace {
+// Number of index bits of the HLL for estimating the number of distinct
+// grouping keys. Gives a standard error of about 3%.
+constexpr int8_t kSampleHllIndexBitLength = 11;
+} // namespace
 
 HashAggregation::HashAggregation(
     int32_t operatorId,
@@ -46,9 +52,21 @@ HashAggregation::HashAggregation(
           *operatorCtx_->task()->queryCtx(),
           *operatorCtx_,
           core::QueryConfig::kAggregationSpillEnabled,
+          core::QueryConfig::kAggregationSpillCompressionCodec,
           operatorId)),
       maxPartialAggregationMemoryUsage_(
-          driverCtx->queryConfig().maxPartialAggregationMemoryUsage()) {
+          driverCtx->queryConfig().maxPartialAggregationMemoryUsage()),
+      // Passing rows through applies to partial aggregations over raw input
+      // that are not flushed on pre-grouped keys.
+      abandonPartialAggregationMinRows_(
+          aggregationNode->step() == core::AggregationNode::Step::kPartial &&
+                  !isDistinct_ && !isGlobal_ &&
+                  aggregationNode->preGroupedKeys().empty()
+              ? driverCtx->queryConfig().abandonPartialAggregationMinRows()
+              : 0),
+      abandonPartialAggregationMinPct_(
+          driverCtx->queryConfig().abandonPartialAggregationMinPct()),
+      localMerge_(aggregationNode->localMerge()) {
   VELOX_CHECK_NOT_NULL(memoryTracker_, "Memory usage tracker is not set");
   auto inputType = aggregationNode->sources()[0]->outputType();
 
@@ -62,6 +80,16 @@ HashAggregation::HashAggregation(
         kConstantChannel,
         "Aggregation doesn't allow constant grouping keys");
     hashers.push_back(VectorHasher::create(key->type(), channel));
+    if (abandonPartialAggregationMinRows_ > 0) {
+      sampleHashers_.push_back(VectorHasher::create(key->type(), channel));
+    }
+  }
+  if (abandonPartialAggregationMinRows_ > 0) {
+    sampleAllocator_ =
+        std::make_unique<HashStringAllocator>(operatorCtx_->mappedMemory());
+    sampleHll_ = std::make_unique<common::hll::DenseHll>(
+        kSampleHllIndexBitLength, sampleAllocator_.get());
+    sampling_ = true;
   }
 
   std::vector<column_index_t> preGroupedChannels;
@@ -163,21 +191,60 @@ HashAggregation::HashAggregation(
       aggregationNode->ignoreNullKeys(),
       isPartialOutput_,
       isRawInput(aggregationNode->step()),
-      spillConfig_.has_value() ? &spillConfig_.value() : nullptr,
-      operatorCtx_.get());
+      // The groups handed over to other drivers in a local merge are not
+      // spilled.
+      spillConfig_.has_value() && !localMerge_ ? &spillConfig_.value()
+                                               : nullptr,
+      operatorCtx_.get(),
+      aggregationNode->distinctAggregates());
 }
 
 void HashAggregation::addInput(RowVectorPtr input) {
+  if (abandonedPartial_) {
+    sampleKeys(input);
+    if (abandonedPartial_) {
+      // Converted to intermediate results in getOutput().
+      input_ = std::move(input);
+      return;
+    }
+  }
   if (!pushdownChecked_) {
     mayPushdown_ = operatorCtx_->driver()->mayPushdownAggregation(this);
     pushdownChecked_ = true;
   }
   groupingSet_->addInput(input, mayPushdown_);
   numInputRows_ += input->size();
-  auto spilledStats = groupingSet_->spilledStats();
-  stats_.spilledBytes = spilledStats.spilledBytes;
-  stats_.spilledRows = spilledStats.spilledRows;
-  stats_.spilledPartitions = spilledStats.spilledPartitions;
+  checkPartialFull();
+
+  if (sampling_) {
+    sampleKeys(input);
+  }
+
+  if (isDistinct_) {
+    newDistincts_ = !groupingSet_->hashLookup().newGroups.empty();
+
+    if (newDistincts_) {
+      // Save input to use for output in getOutput().
+      input_ = input;
+    }
+  }
+}
+
+void HashAggregation::addInputRows(
+    RowVectorPtr input,
+    const SelectivityVector& rows) {
+  if (!pushdownChecked_) {
+    mayPushdown_ = operatorCtx_->driver()->mayPushdownAggregation(this);
+    pushdownChecked_ = true;
+  }
+  groupingSet_->addInputRows(input, rows, mayPushdown_);
+  numInputRows_ += rows.countSelected();
+  checkPartialFull();
+}
+
+void HashAggregation::checkPartialFull() {
+  updateSpilledStats();
+  updateHashModeStats();
 
   // NOTE: we should not trigger partial output flush in case of global
   // aggregation as the final aggregator will handle it the same way as the
@@ -186,17 +253,150 @@ void HashAggregation::addInput(RowVectorPtr input) {
       groupingSet_->allocatedBytes() > maxPartialAggregationMemoryUsage_) {
     partialFull_ = true;
   }
+}
 
-  if (isDistinct_) {
-    newDistincts_ = !groupingSet_->hashLookup().newGroups.empty();
+void HashAggregation::updateHashModeStats() {
+  const auto hashModeStats = groupingSet_->hashModeStats();
+  if (hashModeStats.numSwitches <= reportedHashModeStats_.numSwitches) {
+    // No new switches or a new table.
+    reportedHashModeStats_ = hashModeStats;
+    return;
+  }
+  stats().addRuntimeStat(
+      "hashModeSwitches",
+      RuntimeCounter(
+          hashModeStats.numSwitches - reportedHashModeStats_.numSwitches));
+  stats().addRuntimeStat(
+      "hashModeSwitchWallNanos",
+      RuntimeCounter(
+          (hashModeStats.switchTimeUs - reportedHashModeStats_.switchTimeUs) *
+              1'000,
+          RuntimeCounter::Unit::kNanos));
+  reportedHashModeStats_ = hashModeStats;
+}
 
-    if (newDistincts_) {
-      // Save input to use for output in getOutput().
-      input_ = input;
+void HashAggregation::updateSpilledStats() {
+  auto spilledStats = groupingSet_->spilledStats();
+  stats_.spilledBytes = spilledStats.spilledBytes;
+  stats_.spilledRows = spilledStats.spilledRows;
+  stats_.spilledPartitions = spilledStats.spilledPartitions;
+  stats_.spilledUncompressedBytes = spilledStats.spilledUncompressedBytes;
+  stats_.spilledFiles = spilledStats.spilledFiles;
+  stats_.spillWriteTimeUs = spilledStats.spillWriteTimeUs;
+  stats_.spillPeakDiskBytes = operatorCtx_->spillDiskTracker().peakBytes();
+}
+
+void HashAggregation::reclaim() {
+  groupingSet_->spill(0, 0);
+  updateSpilledStats();
+}
+
+void HashAggregation::noMoreInput() {
+  groupingSet_->noMoreInput();
+  Operator::noMoreInput();
+  if (localMerge_) {
+    startLocalMerge();
+  }
+}
+
+void HashAggregation::startLocalMerge() {
+  auto* driverCtx = operatorCtx_->driverCtx();
+  const auto numPartitions =
+      operatorCtx_->task()->numDrivers(driverCtx->pipelineId);
+  if (numPartitions == 1) {
+    return;
+  }
+  groupingSet_->setMergePartition(driverCtx->partitionId, numPartitions);
+  localPartitions_ = groupingSet_->extractPartitions(outputBatchSize_);
+
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    waitingForPeers_ = true;
+    return;
+  }
+
+  std::vector<HashAggregation*> aggregations(numPartitions, nullptr);
+  aggregations[driverCtx->partitionId] = this;
+  for (auto& peer : peers) {
+    auto* aggregation =
+        dynamic_cast<HashAggregation*>(peer->findOperator(planNodeId()));
+    VELOX_CHECK_NOT_NULL(aggregation);
+    aggregations[peer->driverCtx()->partitionId] = aggregation;
+  }
+  for (auto* source : aggregations) {
+    VELOX_CHECK_NOT_NULL(source);
+    for (auto partition = 0; partition < numPartitions; ++partition) {
+      auto& groups = source->localPartitions_[partition];
+      auto& mergeInput = aggregations[partition]->mergeInput_;
+      mergeInput.insert(mergeInput.end(), groups.begin(), groups.end());
     }
+    source->localPartitions_.clear();
+  }
+  peers.clear();
+  for (auto& promise : promises) {
+    promise.setValue();
   }
 }
 
+BlockingReason HashAggregation::isBlocked(ContinueFuture* future) {
+  if (waitingForPeers_) {
+    if (future_.valid()) {
+      *future = std::move(future_);
+      return BlockingReason::kWaitForPeers;
+    }
+    waitingForPeers_ = false;
+  }
+  // Takes no more input while the spill files of the query are over budget.
+  if (spillConfig_.has_value() && !noMoreInput_ &&
+      operatorCtx_->waitForSpillDisk(future)) {
+    return BlockingReason::kWaitForSpill;
+  }
+  return BlockingReason::kNotBlocked;
+}
+
+void HashAggregation::sampleKeys(const RowVectorPtr& input) {
+  const auto numRows = input->size();
+  sampleRows_.resize(numRows);
+  sampleRows_.setAll();
+  sampleHashes_.resize(numRows);
+  for (auto i = 0; i < sampleHashers_.size(); ++i) {
+    auto& hasher = sampleHashers_[i];
+    hasher->decode(
+        *input->childAt(hasher->channel())->loadedVector(), sampleRows_);
+    hasher->hash(sampleRows_, i > 0, sampleHashes_);
+  }
+  for (auto i = 0; i < numRows; ++i) {
+    // HLL needs well mixed bits and the hash of a single integer key is not.
+    sampleHll_->insertHash(folly::hash::twang_mix64(sampleHashes_[i]));
+  }
+  numSampledRows_ += numRows;
+  if (numSampledRows_ < abandonPartialAggregationMinRows_) {
+    return;
+  }
+
+  const double distinctPct =
+      100.0 * sampleHll_->cardinality() / numSampledRows_;
+  const bool abandon = distinctPct >= abandonPartialAggregationMinPct_;
+  sampleHll_.reset();
+  sampleHll_ = std::make_unique<common::hll::DenseHll>(
+      kSampleHllIndexBitLength, sampleAllocator_.get());
+  numSampledRows_ = 0;
+  if (abandon != abandonedPartial_) {
+    abandonedPartial_ = abandon;
+    stats().addRuntimeStat(
+        abandon ? "abandonedPartialAggregation" : "resumedPartialAggregation",
+        RuntimeCounter(1));
+    if (abandon) {
+      // Flushes the groups aggregated so far.
+      partialFull_ = true;
+    }
+  }
+  // While aggregating, the next estimate starts after the next flush.
+  sampling_ = abandonedPartial_;
+}
+
 void HashAggregation::prepareOutput(vector_size_t size) {
   if (output_) {
     VectorPtr output = std::move(output_);
@@ -222,6 +422,9 @@ void HashAggregation::resetPartialOutputIfNeed() {
   partialFull_ = false;
   numOutputRows_ = 0;
   numInputRows_ = 0;
+  if (abandonPartialAggregationMinRows_ > 0) {
+    sampling_ = true;
+  }
   if (!finished_) {
     maybeIncreasePartialAggregationMemoryUsage(aggregationPct);
   }
@@ -264,6 +467,15 @@ RowVectorPtr HashAggregation::getOutput() {
     return nullptr;
   }
 
+  if (abandonedPartial_ && input_ != nullptr) {
+    prepareOutput(input_->size());
+    groupingSet_->toIntermediate(input_, output_);
+    stats().addRuntimeStat(
+        "abandonedPartialAggregationRows", RuntimeCounter(input_->size()));
+    input_ = nullptr;
+    return output_;
+  }
+
   // Produce results if one of the following is true:
   // - received no-more-input message;
   // - partial aggregation reached memory limit;
@@ -300,12 +512,24 @@ RowVectorPtr HashAggregation::getOutput() {
     return output;
   }
 
+  if (waitingForPeers_) {
+    return nullptr;
+  }
+  for (auto& groups : mergeInput_) {
+    groupingSet_->addPartialGroups(groups);
+  }
+  mergeInput_.clear();
+
   auto batchSize = isGlobal_ ? 1 : outputBatchSize_;
 
   // Reuse output vectors if possible.
   prepareOutput(batchSize);
 
   bool hasData = groupingSet_->getOutput(batchSize, resultIterator_, output_);
+  if (spillConfig_.has_value()) {
+    // The spilled bytes and files are not counted once they are being read.
+    stats_.spillReadTimeUs = groupingSet_->spilledStats().spillReadTimeUs;
+  }
   if (!hasData) {
     resultIterator_.reset();
     if (noMoreInput_) {
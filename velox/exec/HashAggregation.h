@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/hyperloglog/DenseHll.h"
 #include "velox/exec/GroupingSet.h"
 #include "velox/exec/Operator.h"
 
@@ -29,20 +30,27 @@ class HashAggregation : public Operator {
 
   void addInput(RowVectorPtr input) override;
 
+  /// Takes the rows of the input directly, e.g. the rows that passed a
+  /// FilterProject, unless the input rows are needed for the output, as for
+  /// distinct aggregations or after abandoning partial aggregation.
+  bool supportsInputRows() const override {
+    return !isDistinct_ && !abandonedPartial_ && !sampling_ &&
+        groupingSet_->supportsInputRows();
+  }
+
+  void addInputRows(RowVectorPtr input, const SelectivityVector& rows)
+      override;
+
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_ && !partialFull_;
+    return !noMoreInput_ && !partialFull_ &&
+        !(abandonedPartial_ && input_ != nullptr);
   }
 
-  void noMoreInput() override {
-    groupingSet_->noMoreInput();
-    Operator::noMoreInput();
-  }
+  void noMoreInput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override;
 
@@ -51,7 +59,24 @@ class HashAggregation : public Operator {
     groupingSet_.reset();
   }
 
+  int64_t reclaimableBytes() const override {
+    return groupingSet_ != nullptr ? groupingSet_->reclaimableBytes() : 0;
+  }
+
+  void reclaim() override;
+
  private:
+  // Copies the spill stats of 'groupingSet_' to 'stats_'.
+  void updateSpilledStats();
+
+  // Adds the switches of hash mode of 'groupingSet_' since the previous call
+  // to the runtime stats.
+  void updateHashModeStats();
+
+  // Updates the spill stats and sets 'partialFull_' if a partial aggregation
+  // is over its memory limit. Called after adding input.
+  void checkPartialFull();
+
   void prepareOutput(vector_size_t size);
 
   /// Invoked to reset partial aggregation state if it was full and has been
@@ -64,6 +89,17 @@ class HashAggregation : public Operator {
   /// measure of the effectiveness of the partial aggregation.
   void maybeIncreasePartialAggregationMemoryUsage(double aggregationPct);
 
+  /// Adds the grouping keys of 'input' to the estimate of the number of
+  /// distinct keys. At the end of an estimate over
+  /// 'abandonPartialAggregationMinRows_' rows, decides whether the following
+  /// input is aggregated or passed through as intermediate results.
+  void sampleKeys(const RowVectorPtr& input);
+
+  /// Called at no more input with core::AggregationNode::localMerge(). Hands
+  /// the groups of the other drivers' partitions over to these. The last
+  /// driver to get here distributes the groups of all drivers.
+  void startLocalMerge();
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
@@ -78,6 +114,24 @@ class HashAggregation : public Operator {
   int64_t maxPartialAggregationMemoryUsage_;
   std::unique_ptr<GroupingSet> groupingSet_;
 
+  /// Number of rows over which to estimate the number of distinct grouping
+  /// keys. 0 if partial aggregation always aggregates.
+  const int64_t abandonPartialAggregationMinRows_;
+  const int32_t abandonPartialAggregationMinPct_;
+
+  /// True if passing input rows through as intermediate results instead of
+  /// aggregating them.
+  bool abandonedPartial_ = false;
+
+  /// True while estimating the number of distinct grouping keys.
+  bool sampling_ = false;
+  int64_t numSampledRows_ = 0;
+  std::unique_ptr<HashStringAllocator> sampleAllocator_;
+  std::unique_ptr<common::hll::DenseHll> sampleHll_;
+  std::vector<std::unique_ptr<VectorHasher>> sampleHashers_;
+  SelectivityVector sampleRows_;
+  raw_vector<uint64_t> sampleHashes_;
+
   bool partialFull_ = false;
   bool newDistincts_ = false;
   bool finished_ = false;
@@ -85,6 +139,9 @@ class HashAggregation : public Operator {
   bool pushdownChecked_ = false;
   bool mayPushdown_ = false;
 
+  // The hash mode stats of 'groupingSet_' at the last updateHashModeStats().
+  BaseHashTable::HashModeStats reportedHashModeStats_;
+
   /// Count the number of input rows. It is reset on partial aggregation output
   /// flush.
   int64_t numInputRows_ = 0;
@@ -94,6 +151,21 @@ class HashAggregation : public Operator {
 
   /// Possibly reusable output vector.
   RowVectorPtr output_;
+
+  /// See core::AggregationNode::localMerge().
+  const bool localMerge_;
+
+  /// True while waiting for the peers to hand over the groups to merge.
+  bool waitingForPeers_ = false;
+  ContinueFuture future_;
+
+  /// The groups of this driver's input, by hash partition. Taken by the last
+  /// driver in startLocalMerge().
+  std::vector<std::vector<RowVectorPtr>> localPartitions_;
+
+  /// The groups of this driver's partition from the other drivers. Added to
+  /// 'groupingSet_' before producing output.
+  std::vector<RowVectorPtr> mergeInput_;
 };
 
 } // namespace facebook::velox::exec
@@ -21,6 +21,13 @@
 
 namespace facebook::velox::exec {
 namespace {
+// Number of join key hashes tracked for finding heavy hitter keys. A key with
+// more than 1 / kSkewSummaryCapacity of the sampled rows is always tracked.
+constexpr int32_t kSkewSummaryCapacity = 128;
+
+// One out of this many input rows is sampled for finding heavy hitter keys.
+constexpr int32_t kSkewSampleStride = 8;
+
 // Map HashBuild 'state' to the corresponding driver blocking reason.
 BlockingReason fromStateToBlockingReason(HashBuild::State state) {
   switch (state) {
@@ -31,6 +38,8 @@ BlockingReason fromStateToBlockingReason(HashBuild::State state) {
     case HashBuild::State::kWaitForSpill:
       return BlockingReason::kWaitForSpill;
     case HashBuild::State::kWaitForBuild:
+      FOLLY_FALLTHROUGH;
+    case HashBuild::State::kWaitForCachedTable:
       return BlockingReason::kWaitForJoinBuild;
     case HashBuild::State::kWaitForProbe:
       return BlockingReason::kWaitForJoinProbe;
@@ -38,6 +47,38 @@ BlockingReason fromStateToBlockingReason(HashBuild::State state) {
       VELOX_UNREACHABLE(HashBuild::stateName(state));
   }
 }
+
+// Returns the entry in HashTableCache for the table of 'joinNode', or nullptr
+// if the join does not use the cache. The key of a table kept across queries
+// adds the parts of the plan that determine the table layout to the key from
+// the plan.
+std::shared_ptr<HashTableCache::Entry> getCacheEntry(
+    const core::HashJoinNode& joinNode,
+    const OperatorCtx& operatorCtx) {
+  if (!joinNode.useHashTableCache()) {
+    return nullptr;
+  }
+  const auto splitGroupId = operatorCtx.driverCtx()->splitGroupId;
+  if (joinNode.hashTableCacheKey().empty()) {
+    return HashTableCache::instance()->get(
+        operatorCtx.task()->queryCtx(),
+        joinNode.id(),
+        splitGroupId,
+        operatorCtx.taskId());
+  }
+  std::string cacheKey = fmt::format(
+      "{}|{}|{}|{}|",
+      joinNode.hashTableCacheKey(),
+      core::joinTypeName(joinNode.joinType()),
+      joinNode.filter() != nullptr,
+      splitGroupId);
+  for (const auto& key : joinNode.rightKeys()) {
+    cacheKey += key->name();
+    cacheKey += ',';
+  }
+  cacheKey += joinNode.sources()[1]->outputType()->toString();
+  return HashTableCache::instance()->get(cacheKey, operatorCtx.taskId());
+}
 } // namespace
 
 HashBuild::HashBuild(
@@ -47,15 +88,37 @@ HashBuild::HashBuild(
     : Operator(driverCtx, nullptr, operatorId, joinNode->id(), "HashBuild"),
       joinNode_(std::move(joinNode)),
       joinType_{joinNode_->joinType()},
-      mappedMemory_(operatorCtx_->mappedMemory()),
+      // Only inner and left joins expand the probe rows with the matching
+      // build rows.
+      skewedKeyMinPct_{
+          joinNode_->isInnerJoin() || joinNode_->isLeftJoin()
+              ? driverCtx->queryConfig().hashJoinSkewedKeyMinPct()
+              : 0},
+      cacheEntry_(getCacheEntry(*joinNode_, *operatorCtx_)),
+      useCachedTable_(
+          cacheEntry_ != nullptr &&
+          cacheEntry_->builderTaskId != operatorCtx_->taskId()),
+      // A table kept across queries must not be accounted to the query that
+      // happened to build it.
+      mappedMemory_(
+          cacheEntry_ == nullptr
+              ? operatorCtx_->mappedMemory()
+              : (cacheEntry_->cacheKey.empty()
+                     ? operatorCtx_->task()->queryCtx()->mappedMemory()
+                     : HashTableCache::instance()->mappedMemory())),
       joinBridge_(operatorCtx_->task()->getHashJoinBridgeLocked(
           operatorCtx_->driverCtx()->splitGroupId,
           planNodeId())),
-      spillConfig_(makeOperatorSpillConfig(
-          *operatorCtx_->task()->queryCtx(),
-          *operatorCtx_,
-          core::QueryConfig::kJoinSpillEnabled,
-          operatorId)),
+      // A table shared through the cache must be complete in memory.
+      spillConfig_(
+          cacheEntry_ != nullptr ? std::nullopt
+                                 : makeOperatorSpillConfig(
+                                       *operatorCtx_->task()->queryCtx(),
+                                       *operatorCtx_,
+                                       core::QueryConfig::kJoinSpillEnabled,
+                                       core::QueryConfig::
+                                           kJoinSpillCompressionCodec,
+                                       operatorId)),
       spillGroup_(
           spillEnabled() ? operatorCtx_->task()->getSpillOperatorGroupLocked(
                                operatorCtx_->driverCtx()->splitGroupId,
@@ -64,6 +127,11 @@ HashBuild::HashBuild(
   VELOX_CHECK_NOT_NULL(joinBridge_);
   joinBridge_->addBuilder();
 
+  if (skewedKeyMinPct_ > 0) {
+    VELOX_CHECK_LE(skewedKeyMinPct_, 100);
+    skewSummary_.setCapacity(kSkewSummaryCapacity);
+  }
+
   auto outputType = joinNode_->sources()[1]->outputType();
 
   auto numKeys = joinNode_->rightKeys().size();
@@ -83,11 +151,13 @@ HashBuild::HashBuild(
     types.emplace_back(outputType->childAt(channel));
   }
 
-  // Identify the non-key build side columns and make a decoder for each.
-  const auto numDependents = outputType->size() - numKeys;
+  // Identify the non-key build side columns and make a decoder for each. An
+  // existence join never reads these, so its table only has the keys.
+  const bool keysOnly = isExistenceJoin(*joinNode_);
+  const auto numDependents = keysOnly ? 0 : outputType->size() - numKeys;
   dependentChannels_.reserve(numDependents);
   decoders_.reserve(numDependents);
-  for (auto i = 0; i < outputType->size(); ++i) {
+  for (auto i = 0; !keysOnly && i < outputType->size(); ++i) {
     if (keyChannelPosition.find(i) == keyChannelPosition.end()) {
       dependentChannels_.emplace_back(i);
       decoders_.emplace_back(std::make_unique<DecodedVector>());
@@ -169,6 +239,12 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
   const auto& spillConfig = spillConfig_.value();
   HashBitRange hashBits = spillConfig.hashBitRange;
   if (spillPartition != nullptr) {
+    if (spillConfig.exceedsMaxSpillLevel(spillPartition->id())) {
+      // Build the table of the restored partition in memory.
+      stats_.addRuntimeStat("exceededMaxSpillLevel", RuntimeCounter(1));
+      spillInputReader_ = spillPartition->createReader();
+      return;
+    }
     const auto startBit = spillPartition->id().partitionBitOffset() +
         spillConfig.hashBitRange.numBits();
     hashBits =
@@ -190,7 +266,9 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
               ->maxTotalBytes() *
           spillConfig.fileSizeFactor,
       Spiller::spillPool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.compressionKind,
+      spillConfig.writeOptions);
 
   if (spillPartition == nullptr) {
     spillGroup_->addOperator(
@@ -268,6 +346,11 @@ void HashBuild::removeFilterInputNullRows() {
 void HashBuild::addInput(RowVectorPtr input) {
   checkRunning();
 
+  if (useCachedTable_) {
+    // Another task of the query builds the table from the same input.
+    return;
+  }
+
   if (!ensureInputFits(input)) {
     VELOX_CHECK_NOT_NULL(input_);
     VELOX_CHECK(future_.valid());
@@ -313,6 +396,10 @@ void HashBuild::addInput(RowVectorPtr input) {
     return;
   }
 
+  if (skewedKeyMinPct_ > 0) {
+    sampleSkewedKeys();
+  }
+
   if (analyzeKeys_ && hashes_.size() < activeRows_.end()) {
     hashes_.resize(activeRows_.end());
   }
@@ -352,7 +439,7 @@ void HashBuild::addInput(RowVectorPtr input) {
 bool HashBuild::ensureInputFits(RowVectorPtr& input) {
   // NOTE: we don't need memory reservation if all the partitions are spilling
   // as we spill all the input rows to disk directly.
-  if (!spillEnabled() || spiller_->isAllSpilled()) {
+  if (!canSpill() || spiller_->isAllSpilled()) {
     return true;
   }
 
@@ -439,7 +526,7 @@ bool HashBuild::reserveMemory(const RowVectorPtr& input) {
 void HashBuild::spillInput(const RowVectorPtr& input) {
   VELOX_CHECK_EQ(input->size(), activeRows_.size());
 
-  if (!spillEnabled() || !spiller_->isAnySpilled() ||
+  if (!canSpill() || !spiller_->isAnySpilled() ||
       !activeRows_.hasSelections()) {
     return;
   }
@@ -649,6 +736,13 @@ void HashBuild::noMoreInputInternal() {
     spillGroup_->operatorStopped(*this);
   }
 
+  if (useCachedTable_ &&
+      !HashTableCache::instance()->tableOrFuture(cacheEntry_, &future_)) {
+    VELOX_CHECK(future_.valid());
+    setState(State::kWaitForCachedTable);
+    return;
+  }
+
   if (!finishHashBuild()) {
     return;
   }
@@ -672,6 +766,18 @@ bool HashBuild::finishHashBuild() {
     return false;
   }
 
+  if (useCachedTable_) {
+    VELOX_CHECK_NOT_NULL(cacheEntry_->table);
+    joinBridge_->setHashTable(
+        cacheEntry_->table, SpillPartitionSet{}, cacheEntry_->keyFilter);
+    table_.reset();
+    peers.clear();
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+    return true;
+  }
+
   std::vector<std::unique_ptr<BaseHashTable>> otherTables;
   otherTables.reserve(peers.size());
   SpillPartitionSet spillPartitions;
@@ -686,6 +792,13 @@ bool HashBuild::finishHashBuild() {
         break;
       }
       otherTables.push_back(std::move(build->table_));
+      if (skewedKeyMinPct_ > 0) {
+        const auto& summary = build->skewSummary_;
+        for (auto i = 0; i < summary.size(); ++i) {
+          skewSummary_.insert(summary.values()[i], summary.counts()[i]);
+        }
+        numSkewSampledRows_ += build->numSkewSampledRows_;
+      }
       if (build->spiller_ != nullptr) {
         spillStats += build->spiller_->stats();
         build->spiller_->finishSpill(spillPartitions);
@@ -698,6 +811,11 @@ bool HashBuild::finishHashBuild() {
       stats_.spilledBytes = spillStats.spilledBytes;
       stats_.spilledRows = spillStats.spilledRows;
       stats_.spilledPartitions = spillStats.spilledPartitions;
+      stats_.spilledUncompressedBytes = spillStats.spilledUncompressedBytes;
+      stats_.spilledFiles = spillStats.spilledFiles;
+      stats_.spillWriteTimeUs = spillStats.spillWriteTimeUs;
+      stats_.spillPeakDiskBytes =
+          operatorCtx_->spillDiskTracker().peakBytes();
 
       spiller_->finishSpill(spillPartitions);
 
@@ -712,10 +830,29 @@ bool HashBuild::finishHashBuild() {
       }
     }
     table_->prepareJoinTable(std::move(otherTables));
+    const auto& queryConfig = operatorCtx_->driverCtx()->queryConfig();
+    table_->setPartitionedProbeMinSize(
+        queryConfig.hashProbePartitionedMinTableSize());
+    table_->setProbePrefetchBatchSize(queryConfig.hashTablePrefetchBatchSize());
 
     addRuntimeStats();
+    // The Bloom filter must cover all the build side keys, hence, it cannot be
+    // made if any part of the build side is on disk.
+    std::shared_ptr<common::Filter> keyFilter;
+    std::vector<uint64_t> skewedKeyHashes;
+    if (spillPartitions.empty() && !isInputFromSpill()) {
+      keyFilter = makeBloomFilter();
+      skewedKeyHashes = findSkewedKeys();
+    }
+    std::shared_ptr<BaseHashTable> table = std::move(table_);
+    if (cacheEntry_ != nullptr) {
+      HashTableCache::instance()->setTable(cacheEntry_, table, keyFilter);
+    }
     if (joinBridge_->setHashTable(
-            std::move(table_), std::move(spillPartitions))) {
+            std::move(table),
+            std::move(spillPartitions),
+            std::move(keyFilter),
+            std::move(skewedKeyHashes))) {
       spillGroup_->restart();
     }
   } else {
@@ -809,11 +946,151 @@ void HashBuild::addRuntimeStats() {
   }
 }
 
+namespace {
+template <TypeKind Kind>
+void addKeysToBloomFilter(
+    const BaseVector& keys,
+    vector_size_t numRows,
+    BloomFilter<>& bloomFilter,
+    int64_t& min,
+    int64_t& max) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  auto values = keys.asUnchecked<FlatVector<T>>();
+  for (auto i = 0; i < numRows; ++i) {
+    if (values->isNullAt(i)) {
+      continue;
+    }
+    const int64_t value = values->valueAt(i);
+    bloomFilter.insert(value);
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+}
+} // namespace
+
+void HashBuild::sampleSkewedKeys() {
+  const auto& hashers = table_->hashers();
+  skewHashes_.resize(activeRows_.end());
+  for (auto i = 0; i < hashers.size(); ++i) {
+    hashers[i]->hash(activeRows_, i > 0, skewHashes_);
+  }
+  activeRows_.applyToSelected([&](auto row) {
+    if (numSkewInputRows_++ % kSkewSampleStride == 0) {
+      skewSummary_.insert(skewHashes_[row]);
+      ++numSkewSampledRows_;
+    }
+  });
+}
+
+std::vector<uint64_t> HashBuild::findSkewedKeys() {
+  std::vector<uint64_t> skewedKeyHashes;
+  if (skewedKeyMinPct_ == 0 || !table_->hasDuplicateKeys()) {
+    return skewedKeyHashes;
+  }
+  const auto* hashes = skewSummary_.values();
+  const auto* counts = skewSummary_.counts();
+  for (auto i = 0; i < skewSummary_.size(); ++i) {
+    // A key with a single sampled row is not worth spreading.
+    if (counts[i] > 1 &&
+        counts[i] * 100 >= numSkewSampledRows_ * skewedKeyMinPct_) {
+      skewedKeyHashes.push_back(hashes[i]);
+    }
+  }
+  return skewedKeyHashes;
+}
+
+std::shared_ptr<common::Filter> HashBuild::makeBloomFilter() {
+  const auto& queryConfig = operatorCtx_->driverCtx()->queryConfig();
+  if (!queryConfig.hashJoinBloomFilterEnabled()) {
+    return nullptr;
+  }
+  if (keyChannels_.size() != 1) {
+    return nullptr;
+  }
+  // HashProbe makes an exact IN-list filter from the VectorHasher if this
+  // knows all the distinct values.
+  if (table_->hashMode() != BaseHashTable::HashMode::kHash &&
+      !table_->hashers()[0]->distinctOverflow()) {
+    return nullptr;
+  }
+  // These are the join types for which HashProbe pushes down dynamic filters.
+  if (!isInnerJoin(joinType_) && !isLeftSemiJoin(joinType_) &&
+      !isRightSemiJoin(joinType_)) {
+    return nullptr;
+  }
+  const auto& keyType = tableType_->childAt(0);
+  switch (keyType->kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+      break;
+    default:
+      return nullptr;
+  }
+  const auto numRows = table_->numDistinct();
+  if (numRows == 0 || numRows > queryConfig.hashJoinBloomFilterMaxRows()) {
+    return nullptr;
+  }
+
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(numRows);
+  int64_t min = std::numeric_limits<int64_t>::max();
+  int64_t max = std::numeric_limits<int64_t>::min();
+
+  constexpr int32_t kBatchSize = 1024;
+  std::vector<char*> rows(kBatchSize);
+  auto keys = BaseVector::create(keyType, kBatchSize, pool());
+  const auto keyColumn = table_->rows()->columnAt(0);
+  BaseHashTable::RowsIterator iter;
+  for (;;) {
+    const auto numListed = table_->listAllRows(
+        &iter, kBatchSize, RowContainer::kUnlimited, rows.data());
+    if (numListed == 0) {
+      break;
+    }
+    RowContainer::extractColumn(rows.data(), numListed, keyColumn, keys);
+    switch (keyType->kind()) {
+      case TypeKind::TINYINT:
+        addKeysToBloomFilter<TypeKind::TINYINT>(
+            *keys, numListed, *bloomFilter, min, max);
+        break;
+      case TypeKind::SMALLINT:
+        addKeysToBloomFilter<TypeKind::SMALLINT>(
+            *keys, numListed, *bloomFilter, min, max);
+        break;
+      case TypeKind::INTEGER:
+        addKeysToBloomFilter<TypeKind::INTEGER>(
+            *keys, numListed, *bloomFilter, min, max);
+        break;
+      case TypeKind::BIGINT:
+        addKeysToBloomFilter<TypeKind::BIGINT>(
+            *keys, numListed, *bloomFilter, min, max);
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+  }
+  if (min > max) {
+    // All keys are null.
+    return nullptr;
+  }
+  stats_.addRuntimeStat("bloomFilterRows", RuntimeCounter(numRows));
+  return std::make_shared<common::BigintValuesUsingBloomFilter>(
+      min, max, std::move(bloomFilter), false);
+}
+
 BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
   switch (state_) {
     case State::kRunning:
       if (isInputFromSpill()) {
         processSpillInput();
+      } else if (
+          useCachedTable_ && !noMoreInput_ &&
+          HashTableCache::instance()->hasTable(cacheEntry_)) {
+        // The table is already built, e.g. by an earlier query. Finishes
+        // without reading the rest of the build side input.
+        noMoreInput();
       }
       break;
     case State::kFinish:
@@ -833,6 +1110,12 @@ BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
         postHashBuildProcess();
       }
       break;
+    case State::kWaitForCachedTable:
+      if (!future_.valid()) {
+        setRunning();
+        noMoreInputInternal();
+      }
+      break;
     default:
       VELOX_UNREACHABLE("Unexpected state: {}", stateName(state_));
       break;
@@ -844,6 +1127,14 @@ BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
   return fromStateToBlockingReason(state_);
 }
 
+void HashBuild::close() {
+  // Wakes up the tasks waiting for the cached table if this task was to build
+  // it but did not, e.g. because it was aborted.
+  if (cacheEntry_ != nullptr && !useCachedTable_) {
+    HashTableCache::instance()->abandon(cacheEntry_);
+  }
+}
+
 bool HashBuild::isFinished() {
   return state_ == State::kFinish;
 }
@@ -870,7 +1161,10 @@ void HashBuild::stateTransitionCheck(State state) {
   switch (state) {
     case State::kRunning:
       if (!spillEnabled()) {
-        VELOX_CHECK_EQ(state_, State::kWaitForBuild);
+        VELOX_CHECK(
+            state_ == State::kWaitForBuild ||
+                state_ == State::kWaitForCachedTable,
+            stateName(state_));
       } else {
         VELOX_CHECK_NE(state_, State::kFinish);
       }
@@ -881,6 +1175,8 @@ void HashBuild::stateTransitionCheck(State state) {
       FOLLY_FALLTHROUGH;
     case State::kWaitForProbe:
       FOLLY_FALLTHROUGH;
+    case State::kWaitForCachedTable:
+      FOLLY_FALLTHROUGH;
     case State::kFinish:
       VELOX_CHECK_EQ(state_, State::kRunning);
       break;
@@ -902,6 +1198,8 @@ std::string HashBuild::stateName(State state) {
       return "WAIT_FOR_PROBE";
     case State::kFinish:
       return "FINISH";
+    case State::kWaitForCachedTable:
+      return "WAIT_FOR_CACHED_TABLE";
     default:
       return fmt::format("UNKNOWN: {}", static_cast<int>(state));
   }
@@ -17,6 +17,7 @@
 
 #include "velox/exec/HashJoinBridge.h"
 #include "velox/exec/HashTable.h"
+#include "velox/exec/HashTableCache.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/Spill.h"
 #include "velox/exec/SpillOperatorGroup.h"
@@ -24,6 +25,7 @@
 #include "velox/exec/UnorderedStreamReader.h"
 #include "velox/exec/VectorHasher.h"
 #include "velox/expression/Expr.h"
+#include "velox/functions/lib/ApproxMostFrequentStreamSummary.h"
 
 namespace facebook::velox::exec {
 
@@ -53,6 +55,9 @@ class HashBuild final : public Operator {
     kWaitForProbe = 4,
     /// The finishing state.
     kFinish = 5,
+    /// The state that waits for another task of the query to build the hash
+    /// table shared through HashTableCache.
+    kWaitForCachedTable = 6,
   };
   static std::string stateName(State state);
 
@@ -77,7 +82,7 @@ class HashBuild final : public Operator {
 
   bool isFinished() override;
 
-  void close() override {}
+  void close() override;
 
  private:
   void setState(State state);
@@ -114,6 +119,13 @@ class HashBuild final : public Operator {
     return spillConfig_.has_value() ? &spillConfig_.value() : nullptr;
   }
 
+  // Indicates if the input can be spilled. This is false if spilling is
+  // disabled or if the restored spill partition being built is at the max
+  // spill level.
+  bool canSpill() const {
+    return spiller_ != nullptr;
+  }
+
   // Indicates if the input is read from spill data or not.
   bool isInputFromSpill() const;
 
@@ -126,7 +138,8 @@ class HashBuild final : public Operator {
   // is not null, then the input is from the spilled data instead of from build
   // source. The function will need to setup a spill input reader to read input
   // from the spilled data for restoring. If the spilled data can't still fit
-  // in memory, then we will recursively spill part(s) of its data on disk.
+  // in memory, then we will recursively spill part(s) of its data on disk,
+  // unless the spilled data is at Spiller::Config::maxSpillLevel.
   void setupSpiller(SpillPartition* FOLLY_NULLABLE spillPartition = nullptr);
 
   // Invoked when either there is no more input from the build source or from
@@ -212,6 +225,21 @@ class HashBuild final : public Operator {
 
   void addRuntimeStats();
 
+  // Invoked by the last build driver after the join table has been prepared.
+  // Returns a Bloom filter on the single integer join key for pushdown into the
+  // probe side scan if enabled and the keys have too many distinct values for
+  // an exact IN-list. Returns nullptr otherwise.
+  std::shared_ptr<common::Filter> makeBloomFilter();
+
+  // Adds a sample of the join key hashes of the active rows of the input to
+  // 'skewSummary_'.
+  void sampleSkewedKeys();
+
+  // Invoked by the last build driver after the join table has been prepared.
+  // Returns the hashes of the join keys that hold at least
+  // 'skewedKeyMinPct_' percent of the sampled build side rows.
+  std::vector<uint64_t> findSkewedKeys();
+
   // Invoked to check if it needs to trigger spilling for test purpose only.
   bool testingTriggerSpill();
 
@@ -226,7 +254,21 @@ class HashBuild final : public Operator {
 
   const core::JoinType joinType_;
 
-  // Holds the areas in RowContainer of 'table_'
+  // Minimum percentage of the build side rows that share a key for the key to
+  // be a heavy hitter. 0 if heavy hitters are not looked for.
+  const int32_t skewedKeyMinPct_;
+
+  // Set if the table is shared with the other tasks of the query through
+  // HashTableCache.
+  const std::shared_ptr<HashTableCache::Entry> cacheEntry_;
+
+  // True if another task builds the table of 'cacheEntry_'. If so, the input
+  // is dropped and the cached table is handed to 'joinBridge_'.
+  const bool useCachedTable_;
+
+  // Holds the areas in RowContainer of 'table_'. A table shared through
+  // 'cacheEntry_' may outlive this task, hence it is allocated from the
+  // query's memory.
   memory::MappedMemory* const FOLLY_NONNULL mappedMemory_;
 
   const std::shared_ptr<HashJoinBridge> joinBridge_;
@@ -266,6 +308,18 @@ class HashBuild final : public Operator {
   // Set of active rows during addInput().
   SelectivityVector activeRows_;
 
+  // Counts of a sample of the join key hashes of the input. Used to find the
+  // heavy hitter keys if 'skewedKeyMinPct_' is not 0.
+  functions::ApproxMostFrequentStreamSummary<uint64_t> skewSummary_;
+
+  // Number of input rows seen by sampleSkewedKeys() and the number of these
+  // added to 'skewSummary_'.
+  uint64_t numSkewInputRows_{0};
+  uint64_t numSkewSampledRows_{0};
+
+  // Temporary space for the join key hashes in sampleSkewedKeys().
+  raw_vector<uint64_t> skewHashes_;
+
   // True if this is a build side of an anti join and has at least one entry
   // with null join keys.
   bool antiJoinHasNullKeys_{false};
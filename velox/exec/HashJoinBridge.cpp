@@ -30,9 +30,17 @@ void HashJoinBridge::addBuilder() {
   ++numBuilders_;
 }
 
+void HashJoinBridge::addProber() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!started_);
+  ++numProbers_;
+}
+
 bool HashJoinBridge::setHashTable(
-    std::unique_ptr<BaseHashTable> table,
-    SpillPartitionSet spillPartitionSet) {
+    std::shared_ptr<BaseHashTable> table,
+    SpillPartitionSet spillPartitionSet,
+    std::shared_ptr<common::Filter> keyFilter,
+    std::vector<uint64_t> skewedKeyHashes) {
   VELOX_CHECK_NOT_NULL(table, "setHashTable called with null table");
 
   auto spillPartitionIdSet = toSpillPartitionIdSet(spillPartitionSet);
@@ -61,7 +69,9 @@ bool HashJoinBridge::setHashTable(
     buildResult_ = HashBuildResult(
         std::move(table),
         std::move(restoringSpillPartitionId_),
-        std::move(spillPartitionIdSet));
+        std::move(spillPartitionIdSet),
+        std::move(keyFilter),
+        std::move(skewedKeyHashes));
     restoringSpillPartitionId_.reset();
 
     hasSpillData = !spillPartitionSets_.empty();
@@ -106,6 +116,15 @@ std::optional<HashJoinBridge::HashBuildResult> HashJoinBridge::tableOrFuture(
   return std::nullopt;
 }
 
+void HashJoinBridge::probeClosed() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK_LT(numClosedProbers_, numProbers_);
+  if (++numClosedProbers_ == numProbers_ && buildResult_.has_value() &&
+      spillPartitionSets_.empty()) {
+    buildResult_->table.reset();
+  }
+}
+
 bool HashJoinBridge::probeFinished() {
   std::vector<ContinuePromise> promises;
   bool hasSpillInput = false;
@@ -162,4 +181,33 @@ std::optional<HashJoinBridge::SpillInput> HashJoinBridge::spillInputOrFuture(
   return SpillInput(std::move(spillShard));
 }
 
+void HashJoinBridge::addSkewedProbeInput(RowVectorPtr input) {
+  std::lock_guard<std::mutex> l(mutex_);
+  skewedProbeInputs_.push_back(std::move(input));
+}
+
+RowVectorPtr HashJoinBridge::nextSkewedProbeInput() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (skewedProbeInputs_.empty()) {
+    return nullptr;
+  }
+  auto input = std::move(skewedProbeInputs_.front());
+  skewedProbeInputs_.pop_front();
+  return input;
+}
+
+bool isExistenceJoin(const core::HashJoinNode& joinNode) {
+  if (joinNode.filter() ||
+      !(joinNode.isLeftSemiJoin() || joinNode.isNullAwareAntiJoin())) {
+    return false;
+  }
+  const auto& buildType = joinNode.sources()[1]->outputType();
+  const auto& outputType = joinNode.outputType();
+  for (auto i = 0; i < outputType->size(); ++i) {
+    if (buildType->containsChild(outputType->nameOf(i))) {
+      return false;
+    }
+  }
+  return true;
+}
 } // namespace facebook::velox::exec
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/core/PlanNode.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Spill.h"
@@ -34,19 +35,36 @@ class HashJoinBridge : public JoinBridge {
   /// HashBuild operators to parallelize the restoring operation.
   void addBuilder();
 
+  /// Invoked by HashProbe operator ctor to add to this bridge by incrementing
+  /// 'numProbers_'. The latter is used to spread the probe rows with heavy
+  /// hitter keys over the HashProbe operators.
+  void addProber();
+
+  uint32_t numProbers() const {
+    return numProbers_;
+  }
+
   /// 'spillPartitionSet' contains the spilled partitions while building
   /// 'table'. The function returns true if there is spill data to restore
   /// after HashProbe operators process 'table', otherwise false. This only
-  /// applies if the disk spilling is enabled.
+  /// applies if the disk spilling is enabled. 'keyFilter' is an optional
+  /// approximate filter on the single join key which HashProbe can push down
+  /// when the table has too many distinct keys for an exact filter.
+  /// 'skewedKeyHashes' are the hashes of the heavy hitter join keys of
+  /// 'table', if any.
   bool setHashTable(
-      std::unique_ptr<BaseHashTable> table,
-      SpillPartitionSet spillPartitionSet);
+      std::shared_ptr<BaseHashTable> table,
+      SpillPartitionSet spillPartitionSet,
+      std::shared_ptr<common::Filter> keyFilter = nullptr,
+      std::vector<uint64_t> skewedKeyHashes = {});
 
   void setAntiJoinHasNullKeys();
 
   /// Represents the result of HashBuild operators: a hash table, an optional
-  /// restored spill partition id associated with the table, and the spilled
-  /// partitions while building the table if not empty. In case of an anti join,
+  /// restored spill partition id associated with the table, the spilled
+  /// partitions while building the table if not empty, an optional
+  /// approximate filter on the join key and the hashes of the join keys that
+  /// hold a large fraction of the build side rows. In case of an anti join,
   /// a build side entry with a null in a join key makes the join return
   /// nothing. In this case, HashBuild operators finishes early without
   /// processing all the input and without finishing building the hash table.
@@ -54,11 +72,15 @@ class HashJoinBridge : public JoinBridge {
     HashBuildResult(
         std::shared_ptr<BaseHashTable> _table,
         std::optional<SpillPartitionId> _restoredPartitionId,
-        SpillPartitionIdSet _spillPartitionIds)
+        SpillPartitionIdSet _spillPartitionIds,
+        std::shared_ptr<common::Filter> _keyFilter = nullptr,
+        std::vector<uint64_t> _skewedKeyHashes = {})
         : antiJoinHasNullKeys(false),
           table(std::move(_table)),
           restoredPartitionId(std::move(_restoredPartitionId)),
-          spillPartitionIds(std::move(_spillPartitionIds)) {}
+          spillPartitionIds(std::move(_spillPartitionIds)),
+          keyFilter(std::move(_keyFilter)),
+          skewedKeyHashes(std::move(_skewedKeyHashes)) {}
 
     HashBuildResult() : antiJoinHasNullKeys(true) {}
 
@@ -66,6 +88,8 @@ class HashJoinBridge : public JoinBridge {
     std::shared_ptr<BaseHashTable> table;
     std::optional<SpillPartitionId> restoredPartitionId;
     SpillPartitionIdSet spillPartitionIds;
+    std::shared_ptr<common::Filter> keyFilter;
+    std::vector<uint64_t> skewedKeyHashes;
   };
 
   /// Invoked by HashProbe operator to get the table to probe which is built by
@@ -82,6 +106,12 @@ class HashJoinBridge : public JoinBridge {
   /// HashBuild operators next.
   bool probeFinished();
 
+  /// Invoked by HashProbe operator when it closes. When all HashProbe
+  /// operators have closed and there is no spilled data to restore, frees the
+  /// hash table, so that a finished join does not hold its memory until the
+  /// end of the split group or the Task.
+  void probeClosed();
+
   /// Contains the spill input for one HashBuild operator: a shard of previously
   /// spilled partition data. 'spillPartition' is null if there is no more spill
   /// data to restore.
@@ -102,9 +132,25 @@ class HashJoinBridge : public JoinBridge {
   std::optional<SpillInput> spillInputOrFuture(
       ContinueFuture* FOLLY_NONNULL future);
 
+  /// Invoked by HashProbe operator to hand probe rows with heavy hitter keys
+  /// over to the HashProbe operators that run out of their own input first.
+  void addSkewedProbeInput(RowVectorPtr input);
+
+  /// Returns the next batch added by addSkewedProbeInput() or nullptr if there
+  /// is none.
+  RowVectorPtr nextSkewedProbeInput();
+
  private:
   uint32_t numBuilders_{0};
 
+  uint32_t numProbers_{0};
+
+  uint32_t numClosedProbers_{0};
+
+  // Probe rows with heavy hitter keys waiting for any HashProbe operator to
+  // process them.
+  std::deque<RowVectorPtr> skewedProbeInputs_;
+
   std::optional<HashBuildResult> buildResult_;
 
   // restoringSpillPartitionXxx member variables are populated by the
@@ -127,4 +173,10 @@ class HashJoinBridge : public JoinBridge {
   // memory and engages in recursive spilling.
   SpillPartitionSet spillPartitionSets_;
 };
+
+/// Returns true if 'joinNode' only needs to know whether a probe row has a
+/// match: a left semi or anti join without a filter and with no build side
+/// columns in the output. The hash table of such a join stores only the
+/// distinct keys and the probe does not list the matching build side rows.
+bool isExistenceJoin(const core::HashJoinNode& joinNode);
 } // namespace facebook::velox::exec
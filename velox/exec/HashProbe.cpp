@@ -96,10 +96,15 @@ HashProbe::HashProbe(
           operatorId,
           joinNode->id(),
           "HashProbe"),
-      outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
       joinType_{joinNode->joinType()},
-      filterResult_(1),
-      outputRows_(outputBatchSize_) {
+      existenceJoin_{isExistenceJoin(*joinNode)},
+      joinBridge_(operatorCtx_->task()->getHashJoinBridgeLocked(
+          operatorCtx_->driverCtx()->splitGroupId,
+          planNodeId())),
+      filterResult_(1) {
+  VELOX_CHECK_NOT_NULL(joinBridge_);
+  joinBridge_->addProber();
+
   auto probeType = joinNode->sources()[0]->outputType();
   auto numKeys = joinNode->leftKeys().size();
   keyChannels_.reserve(numKeys);
@@ -198,11 +203,7 @@ BlockingReason HashProbe::isBlocked(ContinueFuture* future) {
     return BlockingReason::kNotBlocked;
   }
 
-  auto hashBuildResult =
-      operatorCtx_->task()
-          ->getHashJoinBridge(
-              operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-          ->tableOrFuture(future);
+  auto hashBuildResult = joinBridge_->tableOrFuture(future);
   if (!hashBuildResult.has_value()) {
     VELOX_CHECK_NOT_NULL(future);
     return BlockingReason::kWaitForJoinBuild;
@@ -214,6 +215,10 @@ BlockingReason HashProbe::isBlocked(ContinueFuture* future) {
     finished_ = true;
   } else {
     table_ = hashBuildResult->table;
+    const auto& skewedKeyHashes = hashBuildResult->skewedKeyHashes;
+    if (!skewedKeyHashes.empty() && joinBridge_->numProbers() > 1) {
+      skewedKeyHashes_.insert(skewedKeyHashes.begin(), skewedKeyHashes.end());
+    }
     if (table_->numDistinct() == 0) {
       // Build side is empty. Inner, right and semi joins return nothing in this
       // case, hence, we can terminate the pipeline early.
@@ -224,20 +229,31 @@ BlockingReason HashProbe::isBlocked(ContinueFuture* future) {
     } else if (
         (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_) ||
          isRightSemiJoin(joinType_)) &&
-        table_->hashMode() != BaseHashTable::HashMode::kHash) {
+        (table_->hashMode() != BaseHashTable::HashMode::kHash ||
+         hashBuildResult->keyFilter != nullptr)) {
       // Find out whether there are any upstream operators that can accept
       // dynamic filters on all or a subset of the join keys. Create dynamic
       // filters to push down.
-      const auto& buildHashers = table_->hashers();
       auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
           this, keyChannels_);
-      for (auto i = 0; i < keyChannels_.size(); i++) {
-        if (channels.find(keyChannels_[i]) != channels.end()) {
-          if (auto filter = buildHashers[i]->getFilter(false)) {
-            dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
+      if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
+        const auto& buildHashers = table_->hashers();
+        for (auto i = 0; i < keyChannels_.size(); i++) {
+          if (channels.find(keyChannels_[i]) != channels.end()) {
+            if (auto filter = buildHashers[i]->getFilter(false)) {
+              dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
+            }
           }
         }
       }
+      // The build side has too many distinct keys for an exact filter and
+      // HashBuild made a Bloom filter on the single join key instead.
+      if (dynamicFilters_.empty() && hashBuildResult->keyFilter != nullptr &&
+          channels.find(keyChannels_[0]) != channels.end()) {
+        VELOX_CHECK_EQ(keyChannels_.size(), 1);
+        dynamicFilters_.emplace(keyChannels_[0], hashBuildResult->keyFilter);
+        dynamicFilterIsApproximate_ = true;
+      }
     }
     if (isNullAwareAntiJoin(joinType_) && filter_) {
       prepareForNullAwareAntiJoinWithFilter();
@@ -251,9 +267,11 @@ void HashProbe::clearDynamicFilters() {
   // The join can be completely replaced with a pushed down
   // filter when the following conditions are met:
   //  * hash table has a single key with unique values,
-  //  * build side has no dependent columns.
+  //  * build side has no dependent columns,
+  //  * the pushed down filter is exact.
   if (keyChannels_.size() == 1 && !table_->hasDuplicateKeys() &&
-      tableResultProjections_.empty() && !filter_ && !dynamicFilters_.empty()) {
+      tableResultProjections_.empty() && !filter_ && !dynamicFilters_.empty() &&
+      !dynamicFilterIsApproximate_) {
     canReplaceWithDynamicFilter_ = true;
   }
 
@@ -261,6 +279,63 @@ void HashProbe::clearDynamicFilters() {
 }
 
 void HashProbe::addInput(RowVectorPtr input) {
+  if (!skewedKeyHashes_.empty() && !canReplaceWithDynamicFilter_) {
+    input = spreadSkewedRows(std::move(input));
+  }
+  probeInput(std::move(input));
+}
+
+RowVectorPtr HashProbe::spreadSkewedRows(RowVectorPtr input) {
+  const auto numInput = input->size();
+  nonNullRows_.resize(numInput);
+  nonNullRows_.setAll();
+  for (auto& hasher : hashers_) {
+    auto key = input->childAt(hasher->channel())->loadedVector();
+    hasher->decode(*key, nonNullRows_);
+  }
+  deselectRowsWithNulls(hashers_, nonNullRows_);
+  skewHashes_.resize(numInput);
+  for (auto i = 0; i < hashers_.size(); ++i) {
+    hashers_[i]->hash(nonNullRows_, i > 0, skewHashes_);
+  }
+
+  // The heavy hitter rows are dealt round robin to one share per HashProbe.
+  // This operator keeps the first share and the rest of the rows.
+  const auto numShares = joinBridge_->numProbers();
+  std::vector<std::vector<vector_size_t>> shares(numShares);
+  vector_size_t numSkewedRows = 0;
+  for (auto row = 0; row < numInput; ++row) {
+    if (nonNullRows_.isValid(row) &&
+        skewedKeyHashes_.count(skewHashes_[row])) {
+      shares[numSkewedRows++ % numShares].push_back(row);
+    } else {
+      shares[0].push_back(row);
+    }
+  }
+  if (numSkewedRows < 2) {
+    return input;
+  }
+
+  // The shares are probed by other threads, hence, these must not have lazy
+  // vectors.
+  loadColumns(input, *operatorCtx_->execCtx());
+  auto wrapShare = [&](const std::vector<vector_size_t>& rows) {
+    auto indices = allocateIndices(rows.size(), pool());
+    std::copy(rows.begin(), rows.end(), indices->asMutable<vector_size_t>());
+    return wrap(rows.size(), std::move(indices), input);
+  };
+  vector_size_t numSpreadRows = 0;
+  for (auto i = 1; i < numShares; ++i) {
+    if (!shares[i].empty()) {
+      numSpreadRows += shares[i].size();
+      joinBridge_->addSkewedProbeInput(wrapShare(shares[i]));
+    }
+  }
+  stats_.addRuntimeStat("skewedProbeRows", RuntimeCounter(numSpreadRows));
+  return wrapShare(shares[0]);
+}
+
+void HashProbe::probeInput(RowVectorPtr input) {
   input_ = std::move(input);
 
   if (canReplaceWithDynamicFilter_) {
@@ -323,8 +398,15 @@ void HashProbe::addInput(RowVectorPtr input) {
     auto& hits = lookup_->hits;
     hits.resize(numInput);
     std::fill(hits.data(), hits.data() + numInput, nullptr);
+    if (existenceJoin_) {
+      matches_.assign(bits::nwords(numInput), 0);
+    }
     if (!lookup_->rows.empty()) {
-      table_->joinProbe(*lookup_);
+      if (existenceJoin_) {
+        table_->joinProbeExists(*lookup_, matches_.data());
+      } else {
+        table_->joinProbe(*lookup_);
+      }
     }
 
     // Update lookup_->rows to include all input rows, not just activeRows_ as
@@ -338,7 +420,12 @@ void HashProbe::addInput(RowVectorPtr input) {
       return;
     }
     lookup_->hits.resize(lookup_->rows.back() + 1);
-    table_->joinProbe(*lookup_);
+    if (existenceJoin_) {
+      matches_.assign(bits::nwords(input_->size()), 0);
+      table_->joinProbeExists(*lookup_, matches_.data());
+    } else {
+      table_->joinProbe(*lookup_);
+    }
   }
   results_.reset(*lookup_);
 }
@@ -379,20 +466,31 @@ void HashProbe::fillOutput(vector_size_t size) {
       output_);
 }
 
+std::optional<uint64_t> HashProbe::estimateOutputRowSize() const {
+  const auto probeRowSize = averageRowBytes(*input_);
+  const auto buildRowSize = table_->rows()->estimateRowSize();
+  if (!probeRowSize.has_value() || !buildRowSize.has_value()) {
+    return std::nullopt;
+  }
+  return probeRowSize.value() + buildRowSize.value();
+}
+
 RowVectorPtr HashProbe::getBuildSideOutput() {
-  outputRows_.resize(outputBatchSize_);
+  const auto outputBatchSize =
+      outputBatchRows(table_->rows()->estimateRowSize());
+  outputRows_.resize(outputBatchSize);
   int32_t numOut;
   if (isRightSemiJoin(joinType_)) {
     numOut = table_->listProbedRows(
         &lastProbeIterator_,
-        outputBatchSize_,
+        outputBatchSize,
         RowContainer::kUnlimited,
         outputRows_.data());
   } else {
     // Must be a right join or full join.
     numOut = table_->listNotProbedRows(
         &lastProbeIterator_,
-        outputBatchSize_,
+        outputBatchSize,
         RowContainer::kUnlimited,
         outputRows_.data());
   }
@@ -428,6 +526,17 @@ void HashProbe::clearIdentityProjectedOutput() {
 
 RowVectorPtr HashProbe::getOutput() {
   clearIdentityProjectedOutput();
+  if (!input_ && !skewedKeyHashes_.empty()) {
+    // Takes over the probe rows with heavy hitter keys from the other
+    // HashProbe operators.
+    while (!input_) {
+      auto input = joinBridge_->nextSkewedProbeInput();
+      if (input == nullptr) {
+        break;
+      }
+      probeInput(std::move(input));
+    }
+  }
   if (!input_) {
     if (noMoreInput_ &&
         (isRightJoin(joinType_) || isFullJoin(joinType_) ||
@@ -465,7 +574,7 @@ RowVectorPtr HashProbe::getOutput() {
   // no extra filter we can process each batch of input in one go.
   auto outputBatchSize = (isLeftSemiOrAntiJoinNoFilter || emptyBuildSide)
       ? inputSize
-      : outputBatchSize_;
+      : outputBatchRows(estimateOutputRowSize());
   auto mapping =
       initializeRowNumberMapping(rowNumberMapping_, outputBatchSize, pool());
   outputRows_.resize(outputBatchSize);
@@ -478,6 +587,8 @@ RowVectorPtr HashProbe::getOutput() {
       // rows, including ones with null join keys.
       std::iota(mapping.begin(), mapping.end(), 0);
       numOut = inputSize;
+    } else if (existenceJoin_) {
+      numOut = listExistenceJoinResults(mapping);
     } else if (isNullAwareAntiJoin(joinType_) && !filter_) {
       // When build side is not empty, anti join without a filter returns probe
       // rows with no nulls in the join key and no match in the build side.
@@ -537,6 +648,26 @@ RowVectorPtr HashProbe::getOutput() {
   }
 }
 
+vector_size_t HashProbe::listExistenceJoinResults(
+    folly::Range<vector_size_t*> mapping) {
+  vector_size_t numOut = 0;
+  const auto* matches = matches_.data();
+  if (isLeftSemiJoin(joinType_)) {
+    bits::forEachSetBit(matches, 0, input_->size(), [&](auto row) {
+      mapping[numOut++] = row;
+    });
+    return numOut;
+  }
+  // Anti join returns the rows with no nulls in the join key and no match.
+  bits::forEachSetBit(
+      nonNullRows_.asRange().bits(), 0, input_->size(), [&](auto row) {
+        if (!bits::isBitSet(matches, row)) {
+          mapping[numOut++] = row;
+        }
+      });
+  return numOut;
+}
+
 void HashProbe::fillFilterInput(vector_size_t size) {
   if (!filterInput_) {
     filterInput_ = std::static_pointer_cast<RowVector>(
@@ -818,4 +949,15 @@ void HashProbe::noMoreInput() {
 bool HashProbe::isFinished() {
   return finished_;
 }
+
+void HashProbe::close() {
+  Operator::close();
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  lookup_.reset();
+  table_.reset();
+  joinBridge_->probeClosed();
+}
 } // namespace facebook::velox::exec
@@ -54,6 +54,10 @@ class HashProbe : public Operator {
 
   void clearDynamicFilters() override;
 
+  /// Releases the hash table. The last HashProbe of the join to close frees
+  /// it, without waiting for the end of the split group or the Task.
+  void close() override;
+
  private:
   // Sets up 'filter_' and related members.
   void initializeFilter(
@@ -70,6 +74,15 @@ class HashProbe : public Operator {
   // Populate output columns.
   void fillOutput(vector_size_t size);
 
+  // Probes 'table_' with 'input' and sets 'input_' for producing the results.
+  void probeInput(RowVectorPtr input);
+
+  // Spreads the rows of 'input' with a heavy hitter join key over the
+  // HashProbe operators of the join through 'joinBridge_'. Returns the rows
+  // to be probed by this operator: the other rows of 'input' and a share of
+  // the heavy hitter rows.
+  RowVectorPtr spreadSkewedRows(RowVectorPtr input);
+
   // Clears the columns of 'output_' that are projected from
   // 'input_'. This should be done when preparing to produce a next
   // batch of output to drop any lingering references to row
@@ -95,6 +108,11 @@ class HashProbe : public Operator {
   // side.  Only keep the rows not passing the filter.
   void testFilterOnBuildSide(SelectivityVector& rows, bool nullKeyRowsOnly);
 
+  // Fills 'mapping' with the input rows an existence join returns, i.e. the
+  // rows with a match for a semi join and the rows with no nulls in the join
+  // key and no match for an anti join. Returns the number of rows.
+  vector_size_t listExistenceJoinResults(folly::Range<vector_size_t*> mapping);
+
   // Applies 'filter_' to 'outputRows_' and updates 'outputRows_' and
   // 'rowNumberMapping_'. Returns the number of passing rows.
   vector_size_t evalFilter(vector_size_t numRows);
@@ -105,11 +123,18 @@ class HashProbe : public Operator {
 
   void ensureLoadedIfNotAtEnd(column_index_t channel);
 
-  // TODO: Define batch size as bytes based on RowContainer row sizes.
-  const uint32_t outputBatchSize_;
+  // Returns the estimated size of an output row from the sizes of the rows
+  // of 'input_' and the hash table.
+  std::optional<uint64_t> estimateOutputRowSize() const;
 
   const core::JoinType joinType_;
 
+  // True for a left semi or anti join that only checks whether a probe row
+  // has a match. See isExistenceJoin().
+  const bool existenceJoin_;
+
+  const std::shared_ptr<HashJoinBridge> joinBridge_;
+
   std::unique_ptr<HashLookup> lookup_;
 
   // Channel of probe keys in 'input_'.
@@ -121,6 +146,11 @@ class HashProbe : public Operator {
   // True if the join became a no-op after pushing down the filter.
   bool replacedWithDynamicFilter_{false};
 
+  // True if the pushed down dynamic filter is a Bloom filter which may pass
+  // rows with no match in the build side. The join cannot be replaced with
+  // such a filter.
+  bool dynamicFilterIsApproximate_{false};
+
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
 
   // Table shared between other HashProbes in other Drivers of the
@@ -267,8 +297,25 @@ class HashProbe : public Operator {
   // join keys and a superset of rows that have a match on the build side.
   SelectivityVector activeRows_;
 
+  // Bit mask of input rows with a match on the build side. Used instead of
+  // listing the join results if 'existenceJoin_' is true.
+  std::vector<uint64_t> matches_;
+
+  // Hashes of the join keys that hold a large fraction of the build side rows.
+  // The probe rows with these keys are spread over all the HashProbe operators
+  // of the join. Empty if the table has no such keys or there is a single
+  // HashProbe.
+  folly::F14FastSet<uint64_t> skewedKeyHashes_;
+
+  // Temporary space for the join key hashes in spreadSkewedRows().
+  raw_vector<uint64_t> skewHashes_;
+
   bool finished_{false};
 
+  // True after close() told 'joinBridge_' that this does not use the table
+  // any more.
+  bool closed_{false};
+
   // True if passingInputRows is up to date.
   bool passingInputRowsInitialized_;
 
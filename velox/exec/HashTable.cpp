@@ -19,11 +19,48 @@
 #include "velox/common/base/Portability.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/common/process/ProcessBase.h"
+#include "velox/common/time/Timer.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/HashBitRange.h"
 #include "velox/vector/VectorTypeUtils.h"
 
 namespace facebook::velox::exec {
 
+namespace {
+// Returns the width of a join key of 'kind' in a row if values of 'kind' are
+// equal if their bytes are equal, 0 otherwise.
+int32_t packedKeyWidth(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return sizeof(int8_t);
+    case TypeKind::SMALLINT:
+      return sizeof(int16_t);
+    case TypeKind::INTEGER:
+      return sizeof(int32_t);
+    case TypeKind::BIGINT:
+      return sizeof(int64_t);
+    case TypeKind::DATE:
+      return sizeof(Date);
+    default:
+      return 0;
+  }
+}
+
+template <TypeKind Kind>
+void packKey(
+    const DecodedVector& decoded,
+    folly::Range<const vector_size_t*> rows,
+    int32_t offset,
+    int32_t stride,
+    char* packed) {
+  using T = typename KindToFlatVector<Kind>::HashRowType;
+  for (auto row : rows) {
+    *reinterpret_cast<T*>(packed + row * stride + offset) =
+        decoded.valueAt<T>(row);
+  }
+}
+} // namespace
+
 template <bool ignoreNullKeys>
 HashTable<ignoreNullKeys>::HashTable(
     std::vector<std::unique_ptr<VectorHasher>>&& hashers,
@@ -53,6 +90,19 @@ HashTable<ignoreNullKeys>::HashTable(
       mappedMemory,
       ContainerRowSerde::instance());
   nextOffset_ = rows_->nextOffset();
+
+  if (ignoreNullKeys && isJoinBuild && hashers_.size() > 1) {
+    int32_t packedKeySize = 0;
+    for (auto i = 0; i < hashers_.size(); ++i) {
+      const auto width = packedKeyWidth(hashers_[i]->typeKind());
+      if (width == 0 || rows_->columnAt(i).offset() != packedKeySize) {
+        packedKeySize = 0;
+        break;
+      }
+      packedKeySize += width;
+    }
+    packedKeySize_ = packedKeySize;
+  }
 }
 
 class ProbeState {
@@ -305,6 +355,9 @@ template <bool ignoreNullKeys>
 bool HashTable<ignoreNullKeys>::compareKeys(
     const char* group,
     const char* inserted) {
+  if (packedKeySize_ > 0) {
+    return memcmp(group, inserted, packedKeySize_) == 0;
+  }
   auto numKeys = hashers_.size();
   int32_t i = 0;
   do {
@@ -340,6 +393,24 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::fullProbe(
         !isJoin && extraCheck);
     return;
   }
+  if (isJoin && packedKeySize_ > 0) {
+    const auto* packedKeys =
+        reinterpret_cast<const char*>(lookup.packedKeys.data());
+    const auto stride = packedKeyStride();
+    // NOLINT
+    lookup.hits[state.row()] = state.fullProbe<op>(
+        tags_,
+        table_,
+        sizeMask_,
+        0,
+        [&](char* group, int32_t row) INLINE_LAMBDA {
+          return memcmp(group, packedKeys + row * stride, packedKeySize_) ==
+              0;
+        },
+        [&](int32_t /*index*/, int32_t /*row*/) { return nullptr; },
+        false);
+    return;
+  }
   // NOLINT
   lookup.hits[state.row()] = state.fullProbe<op>(
       tags_,
@@ -386,6 +457,7 @@ void populateNormalizedKeys(HashLookup& lookup, int8_t sizeBits) {
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
+  numProbedRows_ += lookup.rows.size();
   if (hashMode_ == HashMode::kArray) {
     arrayGroupProbe(lookup);
     return;
@@ -403,7 +475,12 @@ void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
   int32_t probeIndex = 0;
   int32_t numProbes = lookup.rows.size();
   auto rows = lookup.rows.data();
+  int32_t prefetchEnd = 0;
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    if (probeIndex >= prefetchEnd) {
+      prefetchEnd =
+          prefetchProbes(lookup.hashes.data(), rows, probeIndex, numProbes);
+    }
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
     row = rows[probeIndex + 1];
@@ -495,14 +572,22 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
     joinNormalizedKeyProbe(lookup);
     return;
   }
+  if (packedKeySize_ > 0) {
+    packKeys(lookup);
+  }
   int32_t probeIndex = 0;
   int32_t numProbes = lookup.rows.size();
-  const vector_size_t* rows = lookup.rows.data();
+  const vector_size_t* rows = probeRows(lookup);
   ProbeState state1;
   ProbeState state2;
   ProbeState state3;
   ProbeState state4;
+  int32_t prefetchEnd = 0;
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    if (probeIndex >= prefetchEnd) {
+      prefetchEnd =
+          prefetchProbes(lookup.hashes.data(), rows, probeIndex, numProbes);
+    }
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, lookup.hashes[row], row);
     row = rows[probeIndex + 1];
@@ -528,11 +613,109 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
   }
 }
 
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::packKeys(HashLookup& lookup) {
+  const auto stride = packedKeyStride();
+  lookup.packedKeys.resize(
+      (lookup.rows.back() + 1) * stride / sizeof(uint64_t));
+  auto* packed = reinterpret_cast<char*>(lookup.packedKeys.data());
+  const folly::Range<const vector_size_t*> rows(
+      lookup.rows.data(), lookup.rows.size());
+  for (auto i = 0; i < lookup.hashers.size(); ++i) {
+    const auto& decoded = lookup.hashers[i]->decodedVector();
+    const auto offset = rows_->columnAt(i).offset();
+    switch (lookup.hashers[i]->typeKind()) {
+      case TypeKind::TINYINT:
+        packKey<TypeKind::TINYINT>(decoded, rows, offset, stride, packed);
+        break;
+      case TypeKind::SMALLINT:
+        packKey<TypeKind::SMALLINT>(decoded, rows, offset, stride, packed);
+        break;
+      case TypeKind::INTEGER:
+        packKey<TypeKind::INTEGER>(decoded, rows, offset, stride, packed);
+        break;
+      case TypeKind::BIGINT:
+        packKey<TypeKind::BIGINT>(decoded, rows, offset, stride, packed);
+        break;
+      case TypeKind::DATE:
+        packKey<TypeKind::DATE>(decoded, rows, offset, stride, packed);
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+  }
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::joinProbeExists(
+    HashLookup& lookup,
+    uint64_t* matches) {
+  joinProbe(lookup);
+  const auto* hits = lookup.hits.data();
+  for (auto row : lookup.rows) {
+    if (hits[row]) {
+      bits::setBit(matches, row);
+    }
+  }
+}
+
+template <bool ignoreNullKeys>
+int32_t HashTable<ignoreNullKeys>::prefetchProbes(
+    const uint64_t* hashes,
+    const vector_size_t* rows,
+    int32_t begin,
+    int32_t numProbes) {
+  if (probePrefetchBatchSize_ == 0) {
+    return numProbes;
+  }
+  const auto end = std::min(begin + probePrefetchBatchSize_, numProbes);
+  for (auto i = begin; i < end; ++i) {
+    const auto offset = ProbeState::tagsByteOffset(hashes[rows[i]], sizeMask_);
+    __builtin_prefetch(tags_ + offset);
+    __builtin_prefetch(table_ + offset);
+  }
+  return end;
+}
+
+template <bool ignoreNullKeys>
+const vector_size_t* HashTable<ignoreNullKeys>::probeRows(HashLookup& lookup) {
+  const int32_t numProbes = lookup.rows.size();
+  if (partitionedProbeMinSize_ == 0 || numProbes < kMinPartitionedProbeRows ||
+      sizeBits_ <= kProbePartitionBits ||
+      size_ * (1 + sizeof(char*)) < partitionedProbeMinSize_) {
+    return lookup.rows.data();
+  }
+  // The partition is given by the high bits of the bucket index, i.e. the
+  // bits below 'sizeBits_' of the hash number. Consecutive probes then go to
+  // the same range of 'tags_' and 'table_'.
+  const HashBitRange partitionBits(
+      std::max<int32_t>(
+          kProbePartitionBits, sizeBits_ - kMaxProbePartitionBits),
+      sizeBits_);
+  const auto* rows = lookup.rows.data();
+  const auto* hashes = lookup.hashes.data();
+  auto& offsets = lookup.partitionOffsets;
+  offsets.assign(partitionBits.numPartitions() + 1, 0);
+  for (auto i = 0; i < numProbes; ++i) {
+    ++offsets[partitionBits.partition(hashes[rows[i]]) + 1];
+  }
+  for (auto i = 1; i < offsets.size(); ++i) {
+    offsets[i] += offsets[i - 1];
+  }
+  lookup.partitionedRows.resize(numProbes);
+  auto* partitionedRows = lookup.partitionedRows.data();
+  for (auto i = 0; i < numProbes; ++i) {
+    const auto row = rows[i];
+    partitionedRows[offsets[partitionBits.partition(hashes[row])]++] = row;
+  }
+  return partitionedRows;
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::joinNormalizedKeyProbe(HashLookup& lookup) {
   int32_t probeIndex = 0;
   int32_t numProbes = lookup.rows.size();
-  const vector_size_t* rows = lookup.rows.data();
+  const vector_size_t* rows = probeRows(lookup);
   ProbeState state1;
   ProbeState state2;
   ProbeState state3;
@@ -540,7 +723,11 @@ void HashTable<ignoreNullKeys>::joinNormalizedKeyProbe(HashLookup& lookup) {
   const uint64_t* keys = lookup.normalizedKeys.data();
   const uint64_t* hashes = lookup.hashes.data();
   char** hits = lookup.hits.data();
+  int32_t prefetchEnd = 0;
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    if (probeIndex >= prefetchEnd) {
+      prefetchEnd = prefetchProbes(hashes, rows, probeIndex, numProbes);
+    }
     int32_t row = rows[probeIndex];
     state1.preProbe(tags_, sizeMask_, hashes[row], row);
     row = rows[probeIndex + 1];
@@ -582,7 +769,15 @@ void HashTable<ignoreNullKeys>::allocateTables(uint64_t size) {
     // The total size is 9 bytes per slot, 8 in the pointers table and 1 in the
     // tags table.
     auto numPages = bits::roundUp(size * 9, kPageSize) / kPageSize;
-    if (!rows_->mappedMemory()->allocateContiguous(
+    const auto numOldPages = tableAllocation_.numPages();
+    // The table is rebuilt from the rows, so the contents do not matter. But
+    // growing in place keeps the old pages mapped, which saves the unmap and
+    // the page faults on them.
+    const bool grown = numOldPages > 0 && numPages > numOldPages &&
+        rows_->mappedMemory()->growContiguous(
+            numPages - numOldPages, tableAllocation_);
+    if (!grown &&
+        !rows_->mappedMemory()->allocateContiguous(
             numPages, nullptr, tableAllocation_)) {
       VELOX_FAIL("Could not allocate join/group by hash table");
     }
@@ -604,6 +799,8 @@ void HashTable<ignoreNullKeys>::clear() {
     memset(table_, 0, sizeof(char*) * size_);
   }
   numDistinct_ = 0;
+  numProbedRows_ = 0;
+  numSwitchRehashedRows_ = 0;
 }
 
 template <bool ignoreNullKeys>
@@ -1194,6 +1391,26 @@ void HashTable<ignoreNullKeys>::clearUseRange(std::vector<bool>& useRange) {
   }
 }
 
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::isSparseArray(
+    uint64_t arraySize,
+    int32_t numNew) const {
+  if (numProbedRows_ == 0 || arraySize * sizeof(char*) <= kArrayCacheBytes) {
+    return false;
+  }
+  // Projects the number of groups after at least as many more rows as seen so
+  // far at the rate of new groups per row seen so far.
+  const double newPerRow = static_cast<double>(numDistinct_) / numProbedRows_;
+  const uint64_t numGroups = numDistinct_ +
+      newPerRow * std::max<int64_t>(numProbedRows_, numNew);
+  // Tags, row pointers and a normalized key per row for a table of
+  // 'numGroups' at the F14 load factor.
+  const uint64_t hashBytes =
+      bits::nextPowerOfTwo(numGroups + numGroups / 7) * (sizeof(char*) + 1) +
+      numGroups * sizeof(normalized_key_t);
+  return arraySize * sizeof(char*) > kSparseArrayFactor * hashBytes;
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::decideHashMode(int32_t numNew) {
   std::vector<uint64_t> rangeSizes(hashers_.size());
@@ -1202,7 +1419,35 @@ void HashTable<ignoreNullKeys>::decideHashMode(int32_t numNew) {
   uint64_t bestWithReserve = 1;
   uint64_t distinctsWithReserve = 1;
   uint64_t rangesWithReserve = 1;
-  if (numDistinct_ && !isJoinBuild_) {
+  // A decision for a non-empty group by table rehashes all its rows.
+  const bool isSwitch = numDistinct_ && !isJoinBuild_;
+  std::optional<MicrosecondTimer> switchTimer;
+  if (isSwitch) {
+    ++hashModeStats_.numSwitches;
+    switchTimer.emplace(&hashModeStats_.switchTimeUs);
+    numSwitchRehashedRows_ += numDistinct_;
+    if (numSwitchRehashedRows_ > kMaxSwitchRehashFactor * numProbedRows_) {
+      // The keys keep outgrowing the ranges and ids of the VectorHashers.
+      // kHash is not switched from.
+      setHashMode(HashMode::kHash, numNew);
+      return;
+    }
+  }
+  // Once out of kArray, a group by table does not go back since the keys
+  // that made it leave are likely to do so again.
+  auto useArray = [&](uint64_t arraySize) {
+    if (arraySize >= kArrayHashMaxSize) {
+      return false;
+    }
+    if (isJoinBuild_) {
+      return true;
+    }
+    if (isSwitch && hashMode_ == HashMode::kNormalizedKey) {
+      return false;
+    }
+    return !isSparseArray(arraySize, numNew);
+  };
+  if (isSwitch) {
     if (!analyze()) {
       setHashMode(HashMode::kHash, numNew);
       return;
@@ -1226,14 +1471,14 @@ void HashTable<ignoreNullKeys>::decideHashMode(int32_t numNew) {
     }
   }
 
-  if (rangesWithReserve < kArrayHashMaxSize) {
+  if (useArray(rangesWithReserve)) {
     std::fill(useRange.begin(), useRange.end(), true);
     size_ = setHasherMode(hashers_, useRange, rangeSizes, distinctSizes);
     setHashMode(HashMode::kArray, numNew);
     return;
   }
 
-  if (bestWithReserve < kArrayHashMaxSize) {
+  if (useArray(bestWithReserve)) {
     size_ = setHasherMode(hashers_, useRange, rangeSizes, distinctSizes);
     setHashMode(HashMode::kArray, numNew);
     return;
@@ -1251,7 +1496,7 @@ void HashTable<ignoreNullKeys>::decideHashMode(int32_t numNew) {
     return;
   }
 
-  if (distinctsWithReserve < kArrayHashMaxSize) {
+  if (useArray(distinctsWithReserve)) {
     clearUseRange(useRange);
     size_ = setHasherMode(hashers_, useRange, rangeSizes, distinctSizes);
     setHashMode(HashMode::kArray, numNew);
@@ -1516,6 +1761,15 @@ int32_t HashTable<ignoreNullKeys>::listProbedRows(
       iter, maxRows, maxBytes, rows);
 }
 
+template <bool ignoreNullKeys>
+int32_t HashTable<ignoreNullKeys>::listAllRows(
+    RowsIterator* iter,
+    int32_t maxRows,
+    uint64_t maxBytes,
+    char** rows) {
+  return listRows<RowContainer::ProbeType::kAll>(iter, maxRows, maxBytes, rows);
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::erase(folly::Range<char**> rows) {
   auto numRows = rows.size();
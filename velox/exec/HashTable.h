@@ -42,10 +42,20 @@ struct HashLookup {
   raw_vector<uint64_t> hashes;
   // If using valueIds, list of concatenated valueIds. 1:1 with 'hashes'.
   raw_vector<uint64_t> normalizedKeys;
+  // Join keys of each input row laid out as in a row of the hash table. Used
+  // instead of the decoded keys for comparing composite integer keys in
+  // kHash mode. See HashTable::packKeys().
+  raw_vector<uint64_t> packedKeys;
   // Hit for each row of input. nullptr if no hit. Points to the
   // corresponding group row.
   raw_vector<char*> hits;
   std::vector<vector_size_t> newGroups;
+
+  // Scratch for probing the rows one hash table partition at a time. Holds a
+  // permutation of 'rows' ordered on the partition of the hash number. See
+  // BaseHashTable::setPartitionedProbeMinSize().
+  raw_vector<vector_size_t> partitionedRows;
+  std::vector<int32_t> partitionOffsets;
 };
 
 class BaseHashTable {
@@ -91,6 +101,13 @@ class BaseHashTable {
     RowContainerIterator rowContainerIterator_;
   };
 
+  /// Counts the decideHashMode() calls that rehashed the rows of a non-empty
+  /// group by table and the time spent in them.
+  struct HashModeStats {
+    int64_t numSwitches{0};
+    uint64_t switchTimeUs{0};
+  };
+
   /// Takes ownership of 'hashers'. These are used to keep key-level
   /// encodings like distinct values, ranges. These are stateful for
   /// kArray and kNormalizedKey hash modes and track the data
@@ -112,6 +129,14 @@ class BaseHashTable {
   /// join probe. Use listJoinResults to iterate over the results.
   virtual void joinProbe(HashLookup& lookup) = 0;
 
+  /// Like joinProbe() but also sets the bit in 'matches' for each row in
+  /// 'lookup.rows' that has a match. The bits of the other rows are left
+  /// unchanged. For use in semi and anti joins which only need to know
+  /// whether a key has a match.
+  virtual void joinProbeExists(
+      HashLookup& lookup,
+      uint64_t* FOLLY_NONNULL matches) = 0;
+
   /// Fills 'hits' with consecutive hash join results. The corresponding element
   /// of 'inputRows' is set to the corresponding row number in probe keys.
   /// Returns the number of hits produced. If this s less than hits.size() then
@@ -140,6 +165,14 @@ class BaseHashTable {
       uint64_t maxBytes,
       char* FOLLY_NULLABLE* FOLLY_NULLABLE rows) = 0;
 
+  /// Returns all rows, including the ones in the tables merged by
+  /// prepareJoinTable(). Used to summarize the build side keys of a join.
+  virtual int32_t listAllRows(
+      RowsIterator* FOLLY_NULLABLE iter,
+      int32_t maxRows,
+      uint64_t maxBytes,
+      char* FOLLY_NULLABLE* FOLLY_NULLABLE rows) = 0;
+
   virtual void prepareJoinTable(
       std::vector<std::unique_ptr<BaseHashTable>> tables,
       folly::Executor* FOLLY_NULLABLE executor = nullptr) = 0;
@@ -168,6 +201,25 @@ class BaseHashTable {
   /// VectorHashers of 'this'.
   virtual HashMode hashMode() const = 0;
 
+  /// Sets the minimum size in bytes of the tags and row pointers of a join
+  /// table above which joinProbe() probes the rows of a batch one table
+  /// partition at a time. The partitions are ranges of consecutive
+  /// buckets, selected by the high bits of the bucket index and sized so
+  /// that the tags and row pointers of one partition stay in cache while its
+  /// rows are probed. 0 disables partitioned probing.
+  void setPartitionedProbeMinSize(uint64_t minSize) {
+    partitionedProbeMinSize_ = minSize;
+  }
+
+  /// Sets the number of probes for which groupProbe() and joinProbe() first
+  /// prefetch the tags and row pointers before comparing any of them. This
+  /// overlaps the cache misses of the probes of a batch. 0 disables
+  /// prefetching.
+  void setProbePrefetchBatchSize(int32_t batchSize) {
+    VELOX_CHECK_GE(batchSize, 0);
+    probePrefetchBatchSize_ = batchSize;
+  }
+
   /// Disables use of array or normalized key hash modes.
   void forceGenericHashMode() {
     setHashMode(HashMode::kHash, 0);
@@ -185,6 +237,10 @@ class BaseHashTable {
   /// distinct entries before needing to rehash.
   virtual void decideHashMode(int32_t numNew) = 0;
 
+  const HashModeStats& hashModeStats() const {
+    return hashModeStats_;
+  }
+
   // Removes 'rows'  from the hash table and its RowContainer. 'rows' must exist
   // and be unique.
   virtual void erase(folly::Range<char**> rows) = 0;
@@ -250,6 +306,13 @@ class BaseHashTable {
  protected:
   virtual void setHashMode(HashMode mode, int32_t numNew) = 0;
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
+
+  // See setPartitionedProbeMinSize().
+  uint64_t partitionedProbeMinSize_{0};
+
+  // See setProbePrefetchBatchSize().
+  int32_t probePrefetchBatchSize_{0};
+  HashModeStats hashModeStats_;
   std::unique_ptr<RowContainer> rows_;
 };
 
@@ -311,6 +374,9 @@ class HashTable : public BaseHashTable {
 
   void joinProbe(HashLookup& lookup) override;
 
+  void joinProbeExists(HashLookup& lookup, uint64_t* FOLLY_NONNULL matches)
+      override;
+
   int32_t listJoinResults(
       JoinResultIterator& iter,
       bool includeMisses,
@@ -329,6 +395,12 @@ class HashTable : public BaseHashTable {
       uint64_t maxBytes,
       char* FOLLY_NULLABLE* FOLLY_NULLABLE rows) override;
 
+  int32_t listAllRows(
+      RowsIterator* FOLLY_NULLABLE iter,
+      int32_t maxRows,
+      uint64_t maxBytes,
+      char* FOLLY_NULLABLE* FOLLY_NULLABLE rows) override;
+
   void clear() override;
 
   int64_t allocatedBytes() const override {
@@ -402,6 +474,33 @@ class HashTable : public BaseHashTable {
 
   void arrayGroupProbe(HashLookup& lookup);
 
+  // Log2 of the number of buckets, i.e. tags and row pointers, in a
+  // partition of a partitioned probe. 64K tags and row pointers take 576KB.
+  static constexpr int32_t kProbePartitionBits = 16;
+
+  // Max number of bits used for the partition number in a partitioned probe.
+  static constexpr int32_t kMaxProbePartitionBits = 10;
+
+  // Prefetches the tags and row pointers for the probes in 'rows' starting at
+  // 'begin'. Covers up to 'probePrefetchBatchSize_' probes and returns the
+  // index of the first probe not covered. Returns 'numProbes' if prefetching
+  // is disabled.
+  int32_t prefetchProbes(
+      const uint64_t* FOLLY_NONNULL hashes,
+      const vector_size_t* FOLLY_NONNULL rows,
+      int32_t begin,
+      int32_t numProbes);
+
+  // Min number of rows in a batch for a partitioned probe. Below this, the
+  // cost of ordering the rows exceeds the gain in cache locality.
+  static constexpr int32_t kMinPartitionedProbeRows = 256;
+
+  // Returns the rows of 'lookup' ordered on the partition of the hash table
+  // they fall in, if the table is large enough for this to pay off. Returns
+  // 'lookup.rows' otherwise. Must be called after the hashes in 'lookup' are
+  // final, i.e. after populateNormalizedKeys() in kNormalizedKey mode.
+  const vector_size_t* FOLLY_NONNULL probeRows(HashLookup& lookup);
+
   void setHashMode(HashMode mode, int32_t numNew) override;
 
   // Fast path for join results when there are no duplicates in the table.
@@ -429,6 +528,13 @@ class HashTable : public BaseHashTable {
   // VectorHashers.
   void clearUseRange(std::vector<bool>& useRange);
 
+  // Returns true if a group by array of 'arraySize' entries would be mostly
+  // empty and larger than the cache while a hash table for the projected
+  // number of groups would be several times smaller. The array is zeroed at
+  // each rehash and flush and each probe of it is likely a cache miss.
+  // 'numNew' is the number of rows about to be inserted.
+  bool isSparseArray(uint64_t arraySize, int32_t numNew) const;
+
   void rehash();
   void storeKeys(HashLookup& lookup, vector_size_t row);
 
@@ -516,6 +622,16 @@ class HashTable : public BaseHashTable {
       const char* FOLLY_NULLABLE group,
       const char* FOLLY_NULLABLE inserted);
 
+  // Number of bytes between the packed keys of consecutive rows in
+  // HashLookup::packedKeys.
+  int32_t packedKeyStride() const {
+    return bits::roundUp(packedKeySize_, sizeof(uint64_t));
+  }
+
+  // Copies the keys of 'lookup.rows' into 'lookup.packedKeys'. Used for join
+  // probes if 'packedKeySize_' is not 0.
+  void packKeys(HashLookup& lookup);
+
   template <bool isJoin>
   void fullProbe(HashLookup& lookup, ProbeState& state, bool extraCheck);
 
@@ -555,11 +671,26 @@ class HashTable : public BaseHashTable {
 
   // Returns the percentage of values to reserve for new keys in range
   // or distinct mode VectorHashers in a group by hash table. 0 for
-  // join build sides.
+  // join build sides. Doubled after the first switch since keys that
+  // outgrew the reserve once are likely to do so again.
   int32_t reservePct() const {
-    return isJoinBuild_ ? 0 : 50;
+    if (isJoinBuild_) {
+      return 0;
+    }
+    return hashModeStats_.numSwitches > 1 ? 100 : 50;
   }
 
+  // A group by table goes to kHash if the rows rehashed by switches of hash
+  // mode exceed this many times the probed rows.
+  static constexpr int64_t kMaxSwitchRehashFactor = 8;
+
+  // Size of a group by array that is expected to stay in cache.
+  static constexpr uint64_t kArrayCacheBytes = 2 << 20;
+
+  // Min ratio of the size of a sparse group by array to the size of the hash
+  // table replacing it.
+  static constexpr uint64_t kSparseArrayFactor = 8;
+
   int8_t sizeBits_;
   bool isJoinBuild_ = false;
 
@@ -571,12 +702,23 @@ class HashTable : public BaseHashTable {
   // Offset of next row link for join build side, 0 if none. Copied
   // from 'rows_'.
   int32_t nextOffset_;
+
+  // Width in bytes of the keys at the start of a row of a join table with no
+  // null keys if there are several keys and all are integers or dates. Such
+  // keys are equal if their bytes are equal, so that a probe can pack its keys
+  // in the same layout and compare them to a row with a single memcmp. 0
+  // otherwise.
+  int32_t packedKeySize_{0};
   uint8_t* FOLLY_NULLABLE tags_ = nullptr;
   char* FOLLY_NULLABLE* FOLLY_NULLABLE table_ = nullptr;
   memory::MappedMemory::ContiguousAllocation tableAllocation_;
   int64_t size_ = 0;
   int64_t sizeMask_ = 0;
   int64_t numDistinct_ = 0;
+  // Number of rows probed by groupProbe() since the last clear().
+  int64_t numProbedRows_ = 0;
+  // Number of rows rehashed by switches of hash mode since the last clear().
+  int64_t numSwitchRehashedRows_ = 0;
   HashMode hashMode_ = HashMode::kArray;
   // Owns the memory of multiple build side hash join tables that are
   // combined into a single probe hash table.
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/HashTableCache.h"
+
+namespace facebook::velox::exec {
+
+// static
+HashTableCache* HashTableCache::instance() {
+  static HashTableCache cache;
+  return &cache;
+}
+
+std::shared_ptr<HashTableCache::Entry> HashTableCache::get(
+    const std::shared_ptr<core::QueryCtx>& queryCtx,
+    const core::PlanNodeId& planNodeId,
+    uint32_t splitGroupId,
+    const std::string& taskId) {
+  std::lock_guard<std::mutex> l(mutex_);
+  pruneLocked();
+  auto& query = queries_[queryCtx->queryId()];
+  if (query.queryCtx.expired()) {
+    query.queryCtx = queryCtx;
+  } else {
+    VELOX_CHECK(
+        query.queryCtx.lock() == queryCtx,
+        "Two running queries with the same id: {}",
+        queryCtx->queryId());
+  }
+  auto& entry =
+      query.entries[fmt::format("{}.{}", planNodeId, splitGroupId)];
+  if (!entry) {
+    entry = std::make_shared<Entry>(taskId);
+  }
+  return entry;
+}
+
+std::shared_ptr<HashTableCache::Entry> HashTableCache::get(
+    const std::string& cacheKey,
+    const std::string& taskId) {
+  VELOX_CHECK(!cacheKey.empty());
+  std::lock_guard<std::mutex> l(mutex_);
+  auto& shared = sharedEntries_[cacheKey];
+  if (!shared.entry || shared.entry->abandoned) {
+    shared.entry = std::make_shared<Entry>(taskId, cacheKey);
+    sharedBytes_ -= shared.bytes;
+    shared.bytes = 0;
+  }
+  shared.lastUse = ++useCounter_;
+  return shared.entry;
+}
+
+void HashTableCache::setTable(
+    const std::shared_ptr<Entry>& entry,
+    std::shared_ptr<BaseHashTable> table,
+    std::shared_ptr<common::Filter> keyFilter) {
+  VELOX_CHECK_NOT_NULL(table);
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK_NULL(entry->table);
+    VELOX_CHECK(!entry->abandoned);
+    entry->table = std::move(table);
+    entry->keyFilter = std::move(keyFilter);
+    promises = std::move(entry->promises);
+    if (!entry->cacheKey.empty()) {
+      auto it = sharedEntries_.find(entry->cacheKey);
+      if (it != sharedEntries_.end() && it->second.entry == entry) {
+        it->second.bytes = entry->table->allocatedBytes();
+        sharedBytes_ += it->second.bytes;
+        evictLocked();
+      }
+    }
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void HashTableCache::abandon(const std::shared_ptr<Entry>& entry) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (entry->table || entry->abandoned) {
+      return;
+    }
+    entry->abandoned = true;
+    promises = std::move(entry->promises);
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+bool HashTableCache::hasTable(const std::shared_ptr<Entry>& entry) {
+  std::lock_guard<std::mutex> l(mutex_);
+  return entry->table != nullptr;
+}
+
+bool HashTableCache::tableOrFuture(
+    const std::shared_ptr<Entry>& entry,
+    ContinueFuture* future) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(
+      !entry->abandoned,
+      "Build of the shared hash table was abandoned by task {}",
+      entry->builderTaskId);
+  if (entry->table) {
+    return true;
+  }
+  entry->promises.emplace_back("HashTableCache::tableOrFuture");
+  *future = entry->promises.back().getSemiFuture();
+  return false;
+}
+
+size_t HashTableCache::numEntries() {
+  std::lock_guard<std::mutex> l(mutex_);
+  pruneLocked();
+  size_t numEntries = 0;
+  for (const auto& [_, query] : queries_) {
+    numEntries += query.entries.size();
+  }
+  return numEntries;
+}
+
+memory::MappedMemory* HashTableCache::mappedMemory() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (mappedMemory_ == nullptr) {
+    tracker_ = memory::MemoryUsageTracker::create();
+    mappedMemory_ = memory::MappedMemory::getInstance()->addChild(tracker_);
+  }
+  return mappedMemory_.get();
+}
+
+void HashTableCache::setMaxBytes(int64_t maxBytes) {
+  VELOX_CHECK_GE(maxBytes, 0);
+  std::lock_guard<std::mutex> l(mutex_);
+  maxBytes_ = maxBytes;
+  evictLocked();
+}
+
+int64_t HashTableCache::maxBytes() {
+  std::lock_guard<std::mutex> l(mutex_);
+  return maxBytes_;
+}
+
+size_t HashTableCache::numSharedEntries() {
+  std::lock_guard<std::mutex> l(mutex_);
+  return sharedEntries_.size();
+}
+
+int64_t HashTableCache::sharedBytes() {
+  std::lock_guard<std::mutex> l(mutex_);
+  return sharedBytes_;
+}
+
+void HashTableCache::clearShared() {
+  std::lock_guard<std::mutex> l(mutex_);
+  sharedEntries_.clear();
+  sharedBytes_ = 0;
+}
+
+void HashTableCache::evictLocked() {
+  while (sharedBytes_ > maxBytes_) {
+    // Tables that are still being built have no size and are not evicted.
+    auto victim = sharedEntries_.end();
+    for (auto it = sharedEntries_.begin(); it != sharedEntries_.end(); ++it) {
+      if (it->second.bytes > 0 &&
+          (victim == sharedEntries_.end() ||
+           it->second.lastUse < victim->second.lastUse)) {
+        victim = it;
+      }
+    }
+    VELOX_CHECK(victim != sharedEntries_.end());
+    sharedBytes_ -= victim->second.bytes;
+    sharedEntries_.erase(victim);
+  }
+}
+
+void HashTableCache::pruneLocked() {
+  for (auto it = queries_.begin(); it != queries_.end();) {
+    if (it->second.queryCtx.expired()) {
+      it = queries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+} // namespace facebook::velox::exec
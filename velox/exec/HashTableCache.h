@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/container/F14Map.h>
+
+#include "velox/common/future/VeloxPromise.h"
+#include "velox/common/memory/MappedMemory.h"
+#include "velox/core/PlanNode.h"
+#include "velox/core/QueryCtx.h"
+#include "velox/exec/HashTable.h"
+#include "velox/type/Filter.h"
+
+namespace facebook::velox::exec {
+
+/// Worker-wide registry of join hash tables shared by the tasks of a query.
+/// Used for hash joins with core::HashJoinNode::useHashTableCache() set, e.g.
+/// broadcast joins, where all tasks see the same build side input. Tables are
+/// keyed on query id, plan node id and split group id. The first task to ask
+/// for a table builds it and the other tasks wait for it and probe the same
+/// immutable table. The entries of a query are dropped once its QueryCtx is
+/// destroyed.
+///
+/// Joins with core::HashJoinNode::hashTableCacheKey() set, e.g. on small
+/// dimension tables, keep their tables across queries instead. These tables
+/// are allocated from mappedMemory(), which is accounted to a tracker of its
+/// own, and the least recently used ones are evicted when their total size
+/// exceeds maxBytes().
+class HashTableCache {
+ public:
+  /// Default for maxBytes().
+  static constexpr int64_t kDefaultMaxBytes = 1L << 30;
+
+  struct Entry {
+    explicit Entry(std::string _builderTaskId, std::string _cacheKey = "")
+        : builderTaskId(std::move(_builderTaskId)),
+          cacheKey(std::move(_cacheKey)) {}
+
+    /// Id of the task that builds the table.
+    const std::string builderTaskId;
+
+    /// Key of a table kept across queries. Empty for a table of a single
+    /// query.
+    const std::string cacheKey;
+
+    /// The table. Set once the build is complete.
+    std::shared_ptr<BaseHashTable> table;
+
+    /// Optional approximate filter on the join key. See
+    /// HashJoinBridge::setHashTable().
+    std::shared_ptr<common::Filter> keyFilter;
+
+    /// True if the builder task aborted without making the table.
+    bool abandoned{false};
+
+    /// Promises of the tasks waiting for the table.
+    std::vector<ContinuePromise> promises;
+  };
+
+  static HashTableCache* FOLLY_NONNULL instance();
+
+  /// Returns the entry for the table of 'planNodeId' and 'splitGroupId' in
+  /// the query of 'queryCtx'. Makes a new entry with 'taskId' as its builder
+  /// if there is none.
+  std::shared_ptr<Entry> get(
+      const std::shared_ptr<core::QueryCtx>& queryCtx,
+      const core::PlanNodeId& planNodeId,
+      uint32_t splitGroupId,
+      const std::string& taskId);
+
+  /// Returns the entry for the table with 'cacheKey' that is kept across
+  /// queries and marks it as the most recently used. Makes a new entry with
+  /// 'taskId' as its builder if there is none or if the builder of the
+  /// previous one abandoned it.
+  std::shared_ptr<Entry> get(
+      const std::string& cacheKey,
+      const std::string& taskId);
+
+  /// Sets the built table of 'entry' and wakes up the waiting tasks.
+  void setTable(
+      const std::shared_ptr<Entry>& entry,
+      std::shared_ptr<BaseHashTable> table,
+      std::shared_ptr<common::Filter> keyFilter);
+
+  /// Marks 'entry' as abandoned if it has no table yet. The waiting tasks
+  /// are woken up and fail.
+  void abandon(const std::shared_ptr<Entry>& entry);
+
+  /// Returns true if the table of 'entry' is ready.
+  bool hasTable(const std::shared_ptr<Entry>& entry);
+
+  /// Returns true if the table of 'entry' is ready. Otherwise sets 'future'
+  /// to wait for it. Throws if the builder abandoned the entry.
+  bool tableOrFuture(
+      const std::shared_ptr<Entry>& entry,
+      ContinueFuture* FOLLY_NONNULL future);
+
+  /// Returns the number of entries of queries that are still running.
+  size_t numEntries();
+
+  /// Returns the memory for the tables that are kept across queries.
+  memory::MappedMemory* FOLLY_NONNULL mappedMemory();
+
+  /// Sets the max total size of the tables kept across queries. Tables in use
+  /// by running queries stay alive until these finish, even if evicted.
+  void setMaxBytes(int64_t maxBytes);
+
+  int64_t maxBytes();
+
+  /// Returns the number of tables kept across queries and their total size.
+  size_t numSharedEntries();
+  int64_t sharedBytes();
+
+  /// Drops all the tables kept across queries.
+  void clearShared();
+
+ private:
+  struct SharedEntry {
+    std::shared_ptr<Entry> entry;
+    // Size of the table. 0 until the table is set.
+    int64_t bytes{0};
+    // Value of 'useCounter_' at the last get().
+    uint64_t lastUse{0};
+  };
+
+  struct QueryEntries {
+    std::weak_ptr<core::QueryCtx> queryCtx;
+    // Keyed on plan node id and split group id.
+    folly::F14FastMap<std::string, std::shared_ptr<Entry>> entries;
+  };
+
+  // Drops the entries of the queries whose QueryCtx is gone.
+  void pruneLocked();
+
+  // Evicts the least recently used tables kept across queries until their
+  // total size is within 'maxBytes_'.
+  void evictLocked();
+
+  std::mutex mutex_;
+  folly::F14FastMap<std::string, QueryEntries> queries_;
+
+  // Tables kept across queries, keyed on cache key.
+  folly::F14FastMap<std::string, SharedEntry> sharedEntries_;
+  int64_t sharedBytes_{0};
+  int64_t maxBytes_{kDefaultMaxBytes};
+  uint64_t useCounter_{0};
+
+  std::shared_ptr<memory::MemoryUsageTracker> tracker_;
+  std::shared_ptr<memory::MappedMemory> mappedMemory_;
+};
+
+} // namespace facebook::velox::exec
@@ -29,55 +29,66 @@ void notify(std::vector<ContinuePromise>& promises) {
 bool LocalExchangeMemoryManager::increaseMemoryUsage(
     ContinueFuture* future,
     int64_t added) {
-  std::lock_guard<std::mutex> l(mutex_);
-  bufferedBytes_ += added;
-
-  if (bufferedBytes_ >= maxBufferSize_) {
-    promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
-    *future = promises_.back().getSemiFuture();
-    return true;
+  if ((bufferedBytes_ += added) < maxBufferSize_) {
+    return false;
   }
 
-  return false;
+  std::lock_guard<std::mutex> l(mutex_);
+  // Announces the wait before checking the usage again, so that a concurrent
+  // decreaseMemoryUsage() either sees the waiter or is seen here.
+  ++numWaiting_;
+  if (bufferedBytes_ < maxBufferSize_) {
+    --numWaiting_;
+    return false;
+  }
+  promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
+  *future = promises_.back().getSemiFuture();
+  return true;
 }
 
 std::vector<ContinuePromise> LocalExchangeMemoryManager::decreaseMemoryUsage(
     int64_t removed) {
   std::vector<ContinuePromise> promises;
-  {
-    std::lock_guard<std::mutex> l(mutex_);
-    bufferedBytes_ -= removed;
+  bufferedBytes_ -= removed;
+  if (numWaiting_ == 0) {
+    return promises;
+  }
 
-    if (bufferedBytes_ < maxBufferSize_) {
-      promises = std::move(promises_);
-    }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (bufferedBytes_ < maxBufferSize_) {
+    promises = std::move(promises_);
+    numWaiting_ = 0;
   }
   return promises;
 }
 
 void LocalExchangeQueue::addProducer() {
-  queue_.withWLock([&](auto& /*queue*/) {
-    VELOX_CHECK(!noMoreProducers_, "addProducer called after noMoreProducers");
-    ++pendingProducers_;
-  });
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(
+      !noMoreProducers_ || pendingProducers_ > 0,
+      "addProducer called after all producers finished");
+  ++pendingProducers_;
 }
 
 void LocalExchangeQueue::noMoreProducers() {
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> producerPromises;
-  queue_.withWLock([&](auto& queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!noMoreProducers_, "noMoreProducers can be called only once");
     noMoreProducers_ = true;
     if (pendingProducers_ == 0) {
       // No more data will be produced.
+      noMoreData_ = true;
       consumerPromises = std::move(consumerPromises_);
+      numWaitingConsumers_ = 0;
 
-      if (queue.empty()) {
+      if (numQueued_ == 0) {
         // All data has been consumed.
         producerPromises = std::move(producerPromises_);
       }
     }
-  });
+  }
   notify(consumerPromises);
   notify(producerPromises);
 }
@@ -85,136 +96,151 @@ void LocalExchangeQueue::noMoreProducers() {
 BlockingReason LocalExchangeQueue::enqueue(
     RowVectorPtr input,
     ContinueFuture* future) {
-  auto inputBytes = input->retainedSize();
+  if (closed_) {
+    return BlockingReason::kNotBlocked;
+  }
 
-  std::vector<ContinuePromise> consumerPromises;
-  bool isClosed = queue_.withWLock([&](auto& queue) {
-    if (closed_) {
-      return true;
-    }
-    queue.push(std::move(input));
-    consumerPromises = std::move(consumerPromises_);
-    return false;
-  });
+  // The memory is accounted before the vector can be taken, so that taking it
+  // never decreases the usage below zero.
+  const bool blocked =
+      memoryManager_->increaseMemoryUsage(future, input->retainedSize());
+  ++numQueued_;
+  queue_.enqueue(std::move(input));
 
-  if (isClosed) {
+  // Pairs with the fences in next() and close(): either they see the vector
+  // or this sees the waiting consumer or the close.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (closed_) {
+    // close() may have drained the queue before the vector was added.
+    drain();
     return BlockingReason::kNotBlocked;
   }
 
-  notify(consumerPromises);
-
-  if (memoryManager_->increaseMemoryUsage(future, inputBytes)) {
-    return BlockingReason::kWaitForConsumer;
+  if (numWaitingConsumers_ > 0) {
+    std::vector<ContinuePromise> consumerPromises;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      consumerPromises = std::move(consumerPromises_);
+      numWaitingConsumers_ = 0;
+    }
+    notify(consumerPromises);
   }
 
-  return BlockingReason::kNotBlocked;
+  return blocked ? BlockingReason::kWaitForConsumer
+                 : BlockingReason::kNotBlocked;
 }
 
 void LocalExchangeQueue::noMoreData() {
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> producerPromises;
-  queue_.withWLock([&](auto queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK_GT(pendingProducers_, 0);
     --pendingProducers_;
     if (noMoreProducers_ && pendingProducers_ == 0) {
+      noMoreData_ = true;
       consumerPromises = std::move(consumerPromises_);
-      if (queue.empty()) {
+      numWaitingConsumers_ = 0;
+      if (numQueued_ == 0) {
         producerPromises = std::move(producerPromises_);
       }
     }
-  });
+  }
   notify(consumerPromises);
   notify(producerPromises);
 }
 
-BlockingReason LocalExchangeQueue::next(
-    ContinueFuture* future,
-    memory::MemoryPool* pool,
-    RowVectorPtr* data) {
-  std::vector<ContinuePromise> producerPromises;
-  std::vector<ContinuePromise> memoryPromises;
-  auto blockingReason = queue_.withWLock([&](auto& queue) {
-    *data = nullptr;
-    if (queue.empty()) {
-      if (isFinishedLocked(queue)) {
-        return BlockingReason::kNotBlocked;
-      }
-
-      consumerPromises_.emplace_back("LocalExchangeQueue::next");
-      *future = consumerPromises_.back().getSemiFuture();
-
-      return BlockingReason::kWaitForExchange;
-    }
-
-    *data = queue.front();
-    queue.pop();
+void LocalExchangeQueue::dequeued(const RowVectorPtr& data) {
+  auto memoryPromises =
+      memoryManager_->decreaseMemoryUsage(data->retainedSize());
+  const bool empty = --numQueued_ == 0;
+  notify(memoryPromises);
+  if (empty && noMoreData_) {
+    notifyIfFinished();
+  }
+}
 
-    memoryPromises =
-        memoryManager_->decreaseMemoryUsage((*data)->retainedSize());
+void LocalExchangeQueue::drain() {
+  RowVectorPtr data;
+  while (queue_.try_dequeue(data)) {
+    dequeued(data);
+  }
+}
 
-    if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
+void LocalExchangeQueue::notifyIfFinished() {
+  std::vector<ContinuePromise> producerPromises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (isFinished()) {
       producerPromises = std::move(producerPromises_);
     }
-
-    return BlockingReason::kNotBlocked;
-  });
-  notify(memoryPromises);
+  }
   notify(producerPromises);
-  return blockingReason;
 }
 
-bool LocalExchangeQueue::isFinishedLocked(
-    const std::queue<RowVectorPtr>& queue) const {
+BlockingReason LocalExchangeQueue::next(
+    ContinueFuture* future,
+    memory::MemoryPool* /*pool*/,
+    RowVectorPtr* data) {
+  *data = nullptr;
   if (closed_) {
-    return true;
+    return BlockingReason::kNotBlocked;
   }
 
-  if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
-    return true;
+  if (!queue_.try_dequeue(*data)) {
+    std::lock_guard<std::mutex> l(mutex_);
+    ++numWaitingConsumers_;
+    // Pairs with the fence in enqueue().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!closed_ && !queue_.try_dequeue(*data) && !isFinished()) {
+      consumerPromises_.emplace_back("LocalExchangeQueue::next");
+      *future = consumerPromises_.back().getSemiFuture();
+      return BlockingReason::kWaitForExchange;
+    }
+    --numWaitingConsumers_;
   }
 
-  return false;
+  if (*data != nullptr) {
+    dequeued(*data);
+  }
+  return BlockingReason::kNotBlocked;
 }
 
 BlockingReason LocalExchangeQueue::isFinished(ContinueFuture* future) {
-  return queue_.withWLock([&](auto& queue) {
-    if (isFinishedLocked(queue)) {
-      return BlockingReason::kNotBlocked;
-    }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (isFinished()) {
+    return BlockingReason::kNotBlocked;
+  }
 
-    producerPromises_.emplace_back("LocalExchangeQueue::isFinished");
-    *future = producerPromises_.back().getSemiFuture();
+  producerPromises_.emplace_back("LocalExchangeQueue::isFinished");
+  *future = producerPromises_.back().getSemiFuture();
 
-    return BlockingReason::kWaitForConsumer;
-  });
+  return BlockingReason::kWaitForConsumer;
 }
 
-bool LocalExchangeQueue::isFinished() {
-  return queue_.withWLock([&](auto& queue) { return isFinishedLocked(queue); });
+bool LocalExchangeQueue::isFinished() const {
+  if (closed_) {
+    return true;
+  }
+
+  return noMoreData_ && numQueued_ == 0;
 }
 
 void LocalExchangeQueue::close() {
   std::vector<ContinuePromise> producerPromises;
   std::vector<ContinuePromise> consumerPromises;
-  std::vector<ContinuePromise> memoryPromises;
-  queue_.withWLock([&](auto& queue) {
-    uint64_t freedBytes = 0;
-    while (!queue.empty()) {
-      freedBytes += queue.front()->retainedSize();
-      queue.pop();
-    }
-
-    if (freedBytes) {
-      memoryPromises = memoryManager_->decreaseMemoryUsage(freedBytes);
-    }
-
+  closed_ = true;
+  // Pairs with the fence in enqueue().
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  drain();
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     producerPromises = std::move(producerPromises_);
     consumerPromises = std::move(consumerPromises_);
-    closed_ = true;
-  });
+    numWaitingConsumers_ = 0;
+  }
   notify(producerPromises);
   notify(consumerPromises);
-  notify(memoryPromises);
 }
 
 LocalExchange::LocalExchange(
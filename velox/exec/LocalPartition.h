@@ -15,13 +15,16 @@
  */
 #pragma once
 
+#include <folly/concurrency/UnboundedQueue.h>
+
 #include "velox/exec/Operator.h"
 #include "velox/exec/VectorHasher.h"
 
 namespace facebook::velox::exec {
 
 /// Keeps track of the total size in bytes of the data buffered in all
-/// LocalExchangeQueues.
+/// LocalExchangeQueues. The byte count is atomic. The mutex is taken only to
+/// block a producer over the limit and to wake up blocked producers.
 class LocalExchangeMemoryManager {
  public:
   explicit LocalExchangeMemoryManager(int64_t maxBufferSize)
@@ -36,19 +39,37 @@ class LocalExchangeMemoryManager {
   /// caller to fulfill.
   std::vector<ContinuePromise> decreaseMemoryUsage(int64_t removed);
 
+  int64_t bufferedBytes() const {
+    return bufferedBytes_;
+  }
+
+  int64_t maxBufferSize() const {
+    return maxBufferSize_;
+  }
+
  private:
   const int64_t maxBufferSize_;
+  std::atomic<int64_t> bufferedBytes_{0};
+  // Number of entries in 'promises_'. Lets decreaseMemoryUsage() skip the
+  // mutex when no producer is blocked.
+  std::atomic<int32_t> numWaiting_{0};
   std::mutex mutex_;
-  int64_t bufferedBytes_{0};
   std::vector<ContinuePromise> promises_;
 };
 
 /// Buffers data for a single partition produced by local exchange. Allows
 /// multiple producers to enqueue data and multiple consumers fetch data. Each
 /// producer must be registered with a call to 'addProducer'. 'noMoreProducers'
-/// must be called after all producers have been registered. A producer calls
+/// must be called after all producers have been registered. A producer may
+/// still be added after that while another producer is not done, e.g. by a
+/// Driver added to the producing pipeline at runtime. A producer calls
 /// 'enqueue' multiple time to put the data and calls 'noMoreData' when done.
 /// Consumers call 'next' repeatedly to fetch the data.
+///
+/// The data is in a lock-free queue, so that adding and fetching a vector does
+/// not take a lock. The mutex guards the producer registration and the
+/// promises and is taken only to block a consumer on an empty queue, to wake
+/// it up and on the producer transitions.
 class LocalExchangeQueue {
  public:
   LocalExchangeQueue(
@@ -90,18 +111,41 @@ class LocalExchangeQueue {
   /// copied into the consumers memory pool.
   BlockingReason isFinished(ContinueFuture* future);
 
-  bool isFinished();
+  bool isFinished() const;
 
   /// Drop remaining data from the queue and notify consumers and producers if
   /// called before all the data has been processed. No-op otherwise.
   void close();
 
  private:
-  bool isFinishedLocked(const std::queue<RowVectorPtr>& queue) const;
+  // Updates the memory usage and the producers after 'data' was taken from
+  // 'queue_'. Must be called without holding 'mutex_'.
+  void dequeued(const RowVectorPtr& data);
+
+  // Removes all vectors from 'queue_'. Called by close() and by a producer
+  // that raced with close().
+  void drain();
+
+  // Wakes up the producers waiting in isFinished() if all data has been
+  // fetched.
+  void notifyIfFinished();
 
   std::shared_ptr<LocalExchangeMemoryManager> memoryManager_;
   const int partition_;
-  folly::Synchronized<std::queue<RowVectorPtr>> queue_;
+  folly::UMPMCQueue<RowVectorPtr, false> queue_;
+  // Number of vectors in 'queue_'. Incremented before a vector is added and
+  // decremented after it is taken, so that it is never below the size of
+  // 'queue_'.
+  std::atomic<int64_t> numQueued_{0};
+  // Number of consumers waiting on 'consumerPromises_'. A producer takes the
+  // mutex to wake them up only if this is not 0.
+  std::atomic<int32_t> numWaitingConsumers_{0};
+  // True once all producers are done, i.e. noMoreProducers_ is true and
+  // pendingProducers_ is zero.
+  std::atomic_bool noMoreData_{false};
+  std::atomic_bool closed_{false};
+
+  std::mutex mutex_;
   // Satisfied when data becomes available or all producers report that they
   // finished producing, e.g. queue_ is not empty or noMoreProducers_ is true
   // and pendingProducers_ is zero.
@@ -112,7 +156,6 @@ class LocalExchangeQueue {
   std::vector<ContinuePromise> producerPromises_;
   int pendingProducers_{0};
   bool noMoreProducers_{false};
-  bool closed_{false};
 };
 
 /// Fetches data for a single partition produced by local exchange from
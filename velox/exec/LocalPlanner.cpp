@@ -15,6 +15,7 @@
  */
 #include "velox/exec/LocalPlanner.h"
 #include "velox/core/PlanFragment.h"
+#include "velox/exec/ArrowStream.h"
 #include "velox/exec/AssignUniqueId.h"
 #include "velox/exec/CallbackSink.h"
 #include "velox/exec/CrossJoinBuild.h"
@@ -23,6 +24,7 @@
 #include "velox/exec/Exchange.h"
 #include "velox/exec/FilterProject.h"
 #include "velox/exec/GroupId.h"
+#include "velox/exec/GroupingSetsAggregation.h"
 #include "velox/exec/HashAggregation.h"
 #include "velox/exec/HashBuild.h"
 #include "velox/exec/HashProbe.h"
@@ -31,6 +33,7 @@
 #include "velox/exec/MergeJoin.h"
 #include "velox/exec/OrderBy.h"
 #include "velox/exec/PartitionedOutput.h"
+#include "velox/exec/SortShuffleWriter.h"
 #include "velox/exec/StreamingAggregation.h"
 #include "velox/exec/TableScan.h"
 #include "velox/exec/TableWriter.h"
@@ -182,6 +185,9 @@ uint32_t maxDrivers(const DriverFactory& driverFactory) {
       if (!values->isParallelizable()) {
         return 1;
       }
+    } else if (std::dynamic_pointer_cast<const core::ArrowStreamNode>(node)) {
+      // An ArrowArrayStream can only be read by one thread.
+      return 1;
     } else if (
         auto limit = std::dynamic_pointer_cast<const core::LimitNode>(node)) {
       // final limit must run single-threaded
@@ -211,9 +217,17 @@ uint32_t maxDrivers(const DriverFactory& driverFactory) {
     } else if (std::dynamic_pointer_cast<const core::MergeJoinNode>(node)) {
       // Merge join must run single-threaded.
       return 1;
+    } else if (
+        std::dynamic_pointer_cast<const core::SortShuffleWriteNode>(node)) {
+      // Sort shuffle write makes a single data file per task.
+      return 1;
     } else if (
         auto tableWrite =
             std::dynamic_pointer_cast<const core::TableWriteNode>(node)) {
+      // The drivers of a bucketed write would write the same bucket files.
+      if (tableWrite->numBuckets() > 0) {
+        return 1;
+      }
       if (!tableWrite->insertTableHandle()
                ->connectorInsertTableHandle()
                ->supportsMultiThreading()) {
@@ -269,6 +283,31 @@ void LocalPlanner::plan(
   }
 }
 
+bool DriverFactory::supportsAdaptiveDrivers() const {
+  VELOX_CHECK(!planNodes.empty());
+  if (!std::dynamic_pointer_cast<const core::LocalPartitionNode>(
+          consumerNode) ||
+      !std::dynamic_pointer_cast<const core::TableScanNode>(
+          planNodes.front())) {
+    return false;
+  }
+  for (auto i = 1; i < planNodes.size(); ++i) {
+    const auto& planNode = planNodes[i];
+    if (std::dynamic_pointer_cast<const core::FilterNode>(planNode) ||
+        std::dynamic_pointer_cast<const core::ProjectNode>(planNode)) {
+      continue;
+    }
+    auto aggregationNode =
+        std::dynamic_pointer_cast<const core::AggregationNode>(planNode);
+    if (aggregationNode &&
+        aggregationNode->step() == core::AggregationNode::Step::kPartial) {
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
 std::shared_ptr<Driver> DriverFactory::createDriver(
     std::unique_ptr<DriverCtx> ctx,
     std::shared_ptr<ExchangeClient> exchangeClient,
@@ -304,11 +343,30 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
         auto valuesNode =
             std::dynamic_pointer_cast<const core::ValuesNode>(planNode)) {
       operators.push_back(std::make_unique<Values>(id, ctx.get(), valuesNode));
+    } else if (
+        auto arrowStreamNode =
+            std::dynamic_pointer_cast<const core::ArrowStreamNode>(planNode)) {
+      operators.push_back(
+          std::make_unique<ArrowStream>(id, ctx.get(), arrowStreamNode));
     } else if (
         auto tableScanNode =
             std::dynamic_pointer_cast<const core::TableScanNode>(planNode)) {
+      // A Limit that takes the rows of the scan as is bounds the number of
+      // rows the Drivers of the scan need to produce together. The partial
+      // Limits of the Drivers each skip 'offset' rows of their own, so these
+      // would need more.
+      std::optional<int64_t> maxRows;
+      if (i < planNodes.size() - 1) {
+        auto limitNode =
+            std::dynamic_pointer_cast<const core::LimitNode>(planNodes[i + 1]);
+        if (limitNode &&
+            (!limitNode->isPartial() || limitNode->offset() == 0)) {
+          maxRows =
+              static_cast<int64_t>(limitNode->offset()) + limitNode->count();
+        }
+      }
       operators.push_back(
-          std::make_unique<TableScan>(id, ctx.get(), tableScanNode));
+          std::make_unique<TableScan>(id, ctx.get(), tableScanNode, maxRows));
     } else if (
         auto tableWriteNode =
             std::dynamic_pointer_cast<const core::TableWriteNode>(planNode)) {
@@ -331,6 +389,12 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
                 planNode)) {
       operators.push_back(std::make_unique<PartitionedOutput>(
           id, ctx.get(), partitionedOutputNode));
+    } else if (
+        auto sortShuffleWriteNode =
+            std::dynamic_pointer_cast<const core::SortShuffleWriteNode>(
+                planNode)) {
+      operators.push_back(std::make_unique<SortShuffleWriter>(
+          id, ctx.get(), sortShuffleWriteNode));
     } else if (
         auto joinNode =
             std::dynamic_pointer_cast<const core::HashJoinNode>(planNode)) {
@@ -343,9 +407,11 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
     } else if (
         auto aggregationNode =
             std::dynamic_pointer_cast<const core::AggregationNode>(planNode)) {
+      // DISTINCT aggregates need the hash tables of GroupingSet.
       if (!aggregationNode->preGroupedKeys().empty() &&
           aggregationNode->preGroupedKeys().size() ==
-              aggregationNode->groupingKeys().size()) {
+              aggregationNode->groupingKeys().size() &&
+          !aggregationNode->hasDistinctAggregates()) {
         operators.push_back(std::make_unique<StreamingAggregation>(
             id, ctx.get(), aggregationNode));
       } else {
@@ -355,6 +421,20 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
     } else if (
         auto groupIdNode =
             std::dynamic_pointer_cast<const core::GroupIdNode>(planNode)) {
+      if (i < planNodes.size() - 1 &&
+          ctx->queryConfig().aggregationDeriveGroupingSets()) {
+        auto aggregationNode =
+            std::dynamic_pointer_cast<const core::AggregationNode>(
+                planNodes[i + 1]);
+        if (aggregationNode &&
+            GroupingSetsAggregation::canDerive(
+                *groupIdNode, *aggregationNode)) {
+          operators.push_back(std::make_unique<GroupingSetsAggregation>(
+              id, ctx.get(), groupIdNode, aggregationNode));
+          i++;
+          continue;
+        }
+      }
       operators.push_back(
           std::make_unique<GroupId>(id, ctx.get(), groupIdNode));
     } else if (
@@ -16,6 +16,7 @@
 
 #include "velox/exec/Merge.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/exec/OrderBy.h"
 #include "velox/exec/Task.h"
 
 using facebook::velox::common::testutil::TestValue;
@@ -60,7 +61,7 @@ void Merge::initializeTreeOfLosers() {
   sourceCursors.reserve(sources_.size());
   for (auto& source : sources_) {
     sourceCursors.push_back(std::make_unique<SourceStream>(
-        source.get(), sortingKeys_, outputBatchSize_));
+        source.get(), sortingKeys_));
   }
 
   // Save the pointers to cursors before moving these into the TreeOfLosers.
@@ -73,6 +74,22 @@ void Merge::initializeTreeOfLosers() {
       std::make_unique<TreeOfLosers<SourceStream>>(std::move(sourceCursors));
 }
 
+std::optional<uint64_t> Merge::estimateRowSize() const {
+  uint64_t numBytes = 0;
+  uint64_t numRows = 0;
+  for (const auto* stream : streams_) {
+    const auto& data = stream->data();
+    if (stream->hasData() && data != nullptr) {
+      numBytes += data->estimateFlatSize();
+      numRows += data->size();
+    }
+  }
+  if (numRows == 0) {
+    return std::nullopt;
+  }
+  return numBytes / numRows;
+}
+
 BlockingReason Merge::isBlocked(ContinueFuture* future) {
   auto reason = addMergeSources(future);
   if (reason != BlockingReason::kNotBlocked) {
@@ -80,7 +97,7 @@ BlockingReason Merge::isBlocked(ContinueFuture* future) {
   }
 
   // No merging is needed if there is only one source.
-  if (streams_.empty() && sources_.size() > 1) {
+  if (streams_.empty() && sources_.size() > 1 && !concatenate_) {
     initializeTreeOfLosers();
   }
 
@@ -110,22 +127,16 @@ RowVectorPtr Merge::getOutput() {
   }
 
   // No merging is needed if there is only one source.
-  if (sources_.size() == 1) {
-    ContinueFuture future;
-    RowVectorPtr data;
-    auto reason = sources_[0]->next(data, &future);
-    if (reason != BlockingReason::kNotBlocked) {
-      sourceBlockingFutures_.emplace_back(std::move(future));
-      return nullptr;
-    }
-
-    finished_ = data == nullptr;
-    return data;
+  if (sources_.size() == 1 || concatenate_) {
+    return getOutputConcatenated();
   }
 
   if (!output_) {
-    output_ = std::dynamic_pointer_cast<RowVector>(BaseVector::create(
-        outputType_, outputBatchSize_, operatorCtx_->pool()));
+    outputBatchSize_ = outputBatchRows(estimateRowSize());
+    // Reuses the memory of a previous output once the consumer drops it.
+    output_ = std::static_pointer_cast<RowVector>(
+        operatorCtx_->execCtx()->vectorPool().getReusable(
+            outputType_, outputBatchSize_));
     for (auto& child : output_->children()) {
       child->resize(outputBatchSize_);
     }
@@ -146,13 +157,23 @@ RowVectorPtr Merge::getOutput() {
       return std::move(output_);
     }
 
-    if (stream->setOutputRow(outputSize_)) {
+    // When the same stream wins twice in a row its rows are likely to come
+    // in runs. Takes the rows up to the head of the runner-up in one range
+    // then, without a pass through the tree for each row.
+    vector_size_t numRows = 1;
+    if (stream == lastStream_ && outputBatchSize_ - outputSize_ > 1) {
+      numRows = stream->runSize(
+          treeOfLosers_->runnerUp(), outputBatchSize_ - outputSize_);
+    }
+    lastStream_ = stream;
+
+    if (stream->setOutputRows(outputSize_, numRows)) {
       // The stream is at end of input batch. Need to copy out the rows before
       // fetching next batch in 'pop'.
       stream->copyToOutput(output_);
     }
 
-    ++outputSize_;
+    outputSize_ += numRows;
 
     // Advance the stream.
     stream->pop(sourceBlockingFutures_);
@@ -173,6 +194,24 @@ RowVectorPtr Merge::getOutput() {
   }
 }
 
+RowVectorPtr Merge::getOutputConcatenated() {
+  while (currentSource_ < sources_.size()) {
+    ContinueFuture future;
+    RowVectorPtr data;
+    auto reason = sources_[currentSource_]->next(data, &future);
+    if (reason != BlockingReason::kNotBlocked) {
+      sourceBlockingFutures_.emplace_back(std::move(future));
+      return nullptr;
+    }
+    if (data != nullptr) {
+      return data;
+    }
+    ++currentSource_;
+  }
+  finished_ = true;
+  return nullptr;
+}
+
 void Merge::close() {
   for (auto& source : sources_) {
     source->close();
@@ -199,11 +238,36 @@ bool SourceStream::operator<(const MergeStream& other) const {
   return false;
 }
 
+vector_size_t SourceStream::runSize(
+    const SourceStream* other,
+    vector_size_t maxRows) const {
+  const auto numRows =
+      std::min<vector_size_t>(maxRows, data_->size() - currentSourceRow_);
+  if (other == nullptr) {
+    return numRows;
+  }
+  return gallopingRunSize<vector_size_t>(numRows, [&](vector_size_t offset) {
+    const auto row = currentSourceRow_ + offset;
+    for (auto i = 0; i < sortingKeys_.size(); ++i) {
+      if (auto result = keyColumns_[i]
+                            ->compare(
+                                other->keyColumns_[i],
+                                row,
+                                other->currentSourceRow_,
+                                sortingKeys_[i].second)
+                            .value()) {
+        return result < 0;
+      }
+    }
+    return true;
+  });
+}
+
 bool SourceStream::pop(std::vector<ContinueFuture>& futures) {
   ++currentSourceRow_;
   if (currentSourceRow_ == data_->size()) {
     // Make sure all current data has been copied out.
-    VELOX_CHECK(!outputRows_.hasSelections());
+    VELOX_CHECK(copyRanges_.empty());
     return fetchMoreData(futures);
   }
 
@@ -211,28 +275,17 @@ bool SourceStream::pop(std::vector<ContinueFuture>& futures) {
 }
 
 void SourceStream::copyToOutput(RowVectorPtr& output) {
-  outputRows_.updateBounds();
-
-  if (!outputRows_.hasSelections()) {
+  if (copyRanges_.empty()) {
     return;
   }
 
-  vector_size_t sourceRow = firstSourceRow_;
-  outputRows_.applyToSelected(
-      [&](auto row) { sourceRows_[row] = sourceRow++; });
-
   for (auto i = 0; i < output->type()->size(); ++i) {
-    output->childAt(i)->copy(
-        data_->childAt(i).get(), outputRows_, sourceRows_.data());
+    output->childAt(i)->copyRanges(
+        data_->childAt(i).get(),
+        folly::Range(copyRanges_.data(), copyRanges_.size()));
   }
 
-  outputRows_.clearAll();
-
-  if (sourceRow == data_->size()) {
-    firstSourceRow_ = 0;
-  } else {
-    firstSourceRow_ = sourceRow;
-  }
+  copyRanges_.clear();
 }
 
 bool SourceStream::fetchMoreData(std::vector<ContinueFuture>& futures) {
@@ -276,6 +329,15 @@ LocalMerge::LocalMerge(
       operatorCtx_->driverCtx()->driverId,
       0,
       "LocalMerge needs to run single-threaded");
+  // The drivers of a parallel sort return ranges in partition id order,
+  // which is the order in which they add their sources.
+  if (localMergeNode->sources().size() == 1) {
+    if (auto orderBy = std::dynamic_pointer_cast<const core::OrderByNode>(
+            localMergeNode->sources()[0])) {
+      concatenate_ =
+          OrderBy::isParallelSort(*orderBy, driverCtx->queryConfig());
+    }
+  }
 }
 
 BlockingReason LocalMerge::addMergeSources(ContinueFuture* /* future */) {
@@ -297,7 +359,9 @@ MergeExchange::MergeExchange(
           mergeExchangeNode->sortingKeys(),
           mergeExchangeNode->sortingOrders(),
           mergeExchangeNode->id(),
-          "MergeExchange") {}
+          "MergeExchange"),
+      serdeOptions_(makeExchangeSerdeOptions(
+          driverCtx->task->queryCtx()->config())) {}
 
 BlockingReason MergeExchange::addMergeSources(ContinueFuture* future) {
   if (operatorCtx_->driverCtx()->driverId != 0) {
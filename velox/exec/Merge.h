@@ -59,11 +59,23 @@ class Merge : public SourceOperator {
 
   std::vector<std::shared_ptr<MergeSource>> sources_;
 
+  /// True if the sources are ranges of the sorted rows in source order, so
+  /// that the output is the rows of one source after the other.
+  bool concatenate_{false};
+
  private:
+  /// Returns the next batch of the source being read if 'concatenate_'.
+  RowVectorPtr getOutputConcatenated();
+
   void initializeTreeOfLosers();
 
-  /// Maximum number of rows in the output batch.
-  const uint32_t outputBatchSize_;
+  /// Returns the average size of the rows in the current batches of the
+  /// sources or std::nullopt if no source has a batch.
+  std::optional<uint64_t> estimateRowSize() const;
+
+  /// Maximum number of rows in the output batch. Set for each output batch
+  /// from the size of the source rows.
+  uint32_t outputBatchSize_;
 
   std::vector<std::pair<column_index_t, CompareFlags>> sortingKeys_;
 
@@ -74,6 +86,10 @@ class Merge : public SourceOperator {
   /// Used to merge data from two or more sources.
   std::unique_ptr<TreeOfLosers<SourceStream>> treeOfLosers_;
 
+  /// The stream that produced the last output row. Runs of rows are looked
+  /// for only when the same stream wins twice in a row.
+  SourceStream* lastStream_{nullptr};
+
   RowVectorPtr output_;
 
   /// Number of rows accumulated in 'output_' so far.
@@ -81,6 +97,9 @@ class Merge : public SourceOperator {
 
   bool finished_{false};
 
+  /// The source read by getOutputConcatenated().
+  size_t currentSource_{0};
+
   /// A list of blocking futures for sources. These are populates when a given
   /// source is blocked waiting for the next batch of data.
   std::vector<ContinueFuture> sourceBlockingFutures_;
@@ -90,12 +109,8 @@ class SourceStream final : public MergeStream {
  public:
   SourceStream(
       MergeSource* source,
-      const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys,
-      uint32_t outputBatchSize)
-      : source_{source},
-        sortingKeys_{sortingKeys},
-        outputRows_(outputBatchSize, false),
-        sourceRows_(outputBatchSize) {
+      const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys)
+      : source_{source}, sortingKeys_{sortingKeys} {
     keyColumns_.reserve(sortingKeys.size());
   }
 
@@ -116,6 +131,14 @@ class SourceStream final : public MergeStream {
   /// 'other'.
   bool operator<(const MergeStream& other) const override;
 
+  /// Returns the number of consecutive rows from the current row, at most
+  /// 'maxRows' and not past the end of the current batch, that are not
+  /// greater than the current row of 'other', or all of these rows if
+  /// 'other' is nullptr. The current row must not be greater than the
+  /// current row of 'other'. These rows can be copied out as one range.
+  vector_size_t runSize(const SourceStream* other, vector_size_t maxRows)
+      const;
+
   /// Advances to the next row. Returns true and appends a future to 'futures'
   /// if runs out of rows in the current batch and needs to wait for the
   /// source to produce the next batch. The return flag has the meaning of
@@ -128,7 +151,25 @@ class SourceStream final : public MergeStream {
   /// call 'setOutputRow' before calling 'pop'. The output rows must
   /// monotonically increase in between calls to 'copyToOutput'.
   bool setOutputRow(vector_size_t row) {
-    outputRows_.setValid(row, true);
+    return setOutputRows(row, 1);
+  }
+
+  /// Records the output rows starting at 'firstRow' for 'numRows' source
+  /// rows starting at the current row and advances to the last of these.
+  /// The caller then proceeds as after setOutputRow() for the last row.
+  bool setOutputRows(vector_size_t firstRow, vector_size_t numRows) {
+    VELOX_DCHECK_GT(numRows, 0);
+    VELOX_DCHECK_LE(currentSourceRow_ + numRows, data_->size());
+    if (!copyRanges_.empty() &&
+        copyRanges_.back().sourceIndex + copyRanges_.back().count ==
+            currentSourceRow_ &&
+        copyRanges_.back().targetIndex + copyRanges_.back().count ==
+            firstRow) {
+      copyRanges_.back().count += numRows;
+    } else {
+      copyRanges_.push_back({currentSourceRow_, firstRow, numRows});
+    }
+    currentSourceRow_ += numRows - 1;
     return currentSourceRow_ == data_->size() - 1;
   }
 
@@ -137,6 +178,12 @@ class SourceStream final : public MergeStream {
   /// output batch.
   void copyToOutput(RowVectorPtr& output);
 
+  /// Returns the current batch of source rows. nullptr or empty if there is
+  /// none.
+  const RowVectorPtr& data() const {
+    return data_;
+  }
+
  private:
   bool fetchMoreData(std::vector<ContinueFuture>& futures);
 
@@ -161,14 +208,9 @@ class SourceStream final : public MergeStream {
   /// returned by 'source_->next()'.
   bool needData_{true};
 
-  /// First source row that hasn't been copied out yet.
-  vector_size_t firstSourceRow_{0};
-
-  /// Output row numbers for source rows that haven't been copied out yet.
-  SelectivityVector outputRows_;
-
-  /// Reusable memory.
-  std::vector<vector_size_t> sourceRows_;
+  /// Ranges of source rows that haven't been copied out yet and their
+  /// output rows. Consecutive rows taken one at a time extend the last range.
+  std::vector<BaseVector::CopyRange> copyRanges_;
 };
 
 // LocalMerge merges its source's output into a single stream of
@@ -195,10 +237,17 @@ class MergeExchange : public Merge {
       DriverCtx* driverCtx,
       const std::shared_ptr<const core::MergeExchangeNode>& orderByNode);
 
+  /// Options for deserializing the pages of the sources. nullptr for the
+  /// defaults.
+  const VectorSerde::Options* FOLLY_NULLABLE serdeOptions() const {
+    return serdeOptions_.get();
+  }
+
  protected:
   BlockingReason addMergeSources(ContinueFuture* future) override;
 
  private:
+  const std::unique_ptr<VectorSerde::Options> serdeOptions_;
   bool noMoreSplits_ = false;
   size_t numSplits_{0}; // Number of splits we took to process so far.
 };
@@ -32,7 +32,19 @@ MergeJoin::MergeJoin(
           "MergeJoin"),
       outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
       joinType_{joinNode->joinType()},
-      numKeys_{joinNode->leftKeys().size()} {
+      numKeys_{joinNode->leftKeys().size()},
+      // Spilled right side rows are added to the output out of left side
+      // order, which a left join with a filter does not allow.
+      spillConfig_(
+          joinNode->isLeftJoin() && joinNode->filter()
+              ? std::nullopt
+              : makeOperatorSpillConfig(
+                    *operatorCtx_->task()->queryCtx(),
+                    *operatorCtx_,
+                    core::QueryConfig::kJoinSpillEnabled,
+                    core::QueryConfig::kJoinSpillCompressionCodec,
+                    operatorId)),
+      spillMatchRows_{driverCtx->queryConfig().mergeJoinSpillMatchRows()} {
   VELOX_USER_CHECK(
       joinNode->isInnerJoin() || joinNode->isLeftJoin(),
       "Merge join supports only inner and left joins. Other join types are not supported yet.");
@@ -249,18 +261,13 @@ void MergeJoin::addOutputRow(
 
 void MergeJoin::prepareOutput() {
   if (output_ == nullptr) {
-    std::vector<VectorPtr> localColumns(outputType_->size());
-    for (auto i = 0; i < outputType_->size(); ++i) {
-      localColumns[i] = BaseVector::create(
-          outputType_->childAt(i), outputBatchSize_, operatorCtx_->pool());
+    // Reuses the memory of a previous output once the consumer drops it.
+    output_ = std::static_pointer_cast<RowVector>(
+        operatorCtx_->execCtx()->vectorPool().getReusable(
+            outputType_, outputBatchSize_));
+    for (auto& child : output_->children()) {
+      child->resize(outputBatchSize_);
     }
-
-    output_ = std::make_shared<RowVector>(
-        operatorCtx_->pool(),
-        outputType_,
-        nullptr,
-        outputBatchSize_,
-        std::move(localColumns));
     outputSize_ = 0;
 
     if (filterInput_ != nullptr) {
@@ -300,6 +307,10 @@ void MergeJoin::prepareOutput() {
 bool MergeJoin::addToOutput() {
   prepareOutput();
 
+  if (rightMatch_->isSpilled()) {
+    return addSpilledToOutput();
+  }
+
   size_t firstLeftBatch;
   vector_size_t leftStartIndex;
   if (leftMatch_->cursor) {
@@ -352,6 +363,132 @@ bool MergeJoin::addToOutput() {
   return outputSize_ == outputBatchSize_;
 }
 
+void MergeJoin::maybeSpillRightMatch() {
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+  auto& match = rightMatch_.value();
+  uint64_t numRows = 0;
+  for (const auto& input : match.inputs) {
+    numRows += input->size();
+  }
+  numRows -= match.startIndex;
+  if (numRows < spillMatchRows_ || match.inputs.size() < 2) {
+    return;
+  }
+  spillMatchBatches(match, match.inputs.size() - 1);
+}
+
+void MergeJoin::spillMatchBatches(Match& match, size_t numBatches) {
+  VELOX_CHECK_LE(numBatches, match.inputs.size());
+  if (match.spill == nullptr) {
+    const auto& type = match.inputs[0]->type();
+    match.spill = std::make_unique<SpillFileList>(
+        std::static_pointer_cast<const RowType>(type),
+        0,
+        std::vector<CompareFlags>(),
+        spillConfig_->filePath,
+        operatorCtx_->task()
+                ->queryCtx()
+                ->pool()
+                ->getMemoryUsageTracker()
+                ->maxTotalBytes() *
+            spillConfig_->fileSizeFactor,
+        Spiller::spillPool(),
+        *operatorCtx_->mappedMemory(),
+        spillConfig_->compressionKind,
+        spillConfig_->executor,
+        spillConfig_->writeOptions);
+  }
+  const auto numInputs = match.inputs.size();
+  for (size_t i = 0; i < numBatches; ++i) {
+    const auto& input = match.inputs[i];
+    const vector_size_t begin = i == 0 ? match.startIndex : 0;
+    const vector_size_t end =
+        i == numInputs - 1 ? match.endIndex : input->size();
+    if (begin == end) {
+      continue;
+    }
+    loadColumns(input, *operatorCtx_->execCtx());
+    IndexRange range{begin, end - begin};
+    match.spill->write(input, folly::Range<IndexRange*>(&range, 1));
+    stats_.spilledRows += end - begin;
+  }
+  match.inputs.erase(match.inputs.begin(), match.inputs.begin() + numBatches);
+  match.startIndex = 0;
+  stats_.spilledBytes = match.spill->spilledBytes();
+  stats_.spilledUncompressedBytes = match.spill->spilledUncompressedBytes();
+}
+
+bool MergeJoin::nextSpillBatch(Match& match) {
+  while (match.spillFileIndex < match.spillFiles.size()) {
+    if (match.spillFiles[match.spillFileIndex]->nextBatch(match.spillBatch)) {
+      return true;
+    }
+    // Deletes the file.
+    match.spillFiles[match.spillFileIndex].reset();
+    if (++match.spillFileIndex < match.spillFiles.size()) {
+      match.spillFiles[match.spillFileIndex]->startRead();
+    }
+  }
+  return false;
+}
+
+bool MergeJoin::addSpilledToOutput() {
+  auto& rightMatch = rightMatch_.value();
+  VELOX_CHECK(rightMatch.complete);
+  if (rightMatch.spill != nullptr) {
+    // Spills the rest of the rows so that all of them are read back in order.
+    spillMatchBatches(rightMatch, rightMatch.inputs.size());
+    rightMatch.spillFiles = rightMatch.spill->files();
+    rightMatch.spill.reset();
+    rightMatch.spillFiles[0]->startRead();
+  }
+
+  const size_t numLefts = leftMatch_->inputs.size();
+  for (;;) {
+    if (rightMatch.spillBatch == nullptr && !nextSpillBatch(rightMatch)) {
+      break;
+    }
+    size_t firstLeftBatch = 0;
+    vector_size_t leftStartIndex = leftMatch_->startIndex;
+    vector_size_t rightStartIndex = 0;
+    if (leftMatch_->cursor) {
+      firstLeftBatch = leftMatch_->cursor->batchIndex;
+      leftStartIndex = leftMatch_->cursor->index;
+      rightStartIndex = rightMatch.cursor->index;
+      leftMatch_->cursor.reset();
+      rightMatch.cursor.reset();
+    }
+
+    const auto& right = rightMatch.spillBatch;
+    for (size_t l = firstLeftBatch; l < numLefts; ++l) {
+      const auto& left = leftMatch_->inputs[l];
+      const auto leftStart = l == firstLeftBatch ? leftStartIndex : 0;
+      const auto leftEnd =
+          l == numLefts - 1 ? leftMatch_->endIndex : left->size();
+      for (auto i = leftStart; i < leftEnd; ++i) {
+        const auto rightStart =
+            (l == firstLeftBatch && i == leftStart) ? rightStartIndex : 0;
+        for (auto j = rightStart; j < right->size(); ++j) {
+          if (outputSize_ == outputBatchSize_) {
+            leftMatch_->setCursor(l, i);
+            rightMatch.setCursor(0, j);
+            return true;
+          }
+          addOutputRow(left, i, right, j);
+        }
+      }
+    }
+    rightMatch.spillBatch = nullptr;
+  }
+
+  leftMatch_.reset();
+  rightMatch_.reset();
+
+  return outputSize_ == outputBatchSize_;
+}
+
 RowVectorPtr MergeJoin::getOutput() {
   // Make sure to have is-blocked or needs-input as true if returning null
   // output. Otherwise, Driver assumes the operator is finished.
@@ -438,6 +575,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
 
     if (rightInput_) {
       if (!findEndOfMatch(rightMatch_.value(), rightInput_, rightKeys_)) {
+        maybeSpillRightMatch();
         // Continue looking for the end of the match.
         rightInput_ = nullptr;
         return nullptr;
@@ -16,6 +16,8 @@
 #pragma once
 #include "velox/exec/MergeSource.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spill.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 class MergeJoin : public Operator {
@@ -134,6 +136,26 @@ class MergeJoin : public Operator {
     void setCursor(size_t batchIndex, vector_size_t index) {
       cursor = Cursor{batchIndex, index};
     }
+
+    /// Set if some of the rows were spilled to disk because there were too
+    /// many to keep in memory. Only used on the right side. The rows in
+    /// 'inputs' follow the spilled rows.
+    std::unique_ptr<SpillFileList> spill;
+
+    /// The spilled rows when reading them back. Set from 'spill' once the
+    /// match is complete. 'inputs' is then empty.
+    SpillFiles spillFiles;
+
+    /// Index of the file in 'spillFiles' being read.
+    size_t spillFileIndex{0};
+
+    /// The batch of spilled rows being added to the output. 'cursor' is a
+    /// position in this batch.
+    RowVectorPtr spillBatch;
+
+    bool isSpilled() const {
+      return spill != nullptr || !spillFiles.empty();
+    }
   };
 
   /// Given a partial set of rows with matching keys (match) finds all rows from
@@ -160,6 +182,26 @@ class MergeJoin : public Operator {
   // rightMatchCursor_ if output_ filled up before all rows were added.
   bool addToOutput();
 
+  // Spills the rows of the right side match if there are more than
+  // 'spillMatchRows_'. Keeps the last batch in memory for finding the end of
+  // the match.
+  void maybeSpillRightMatch();
+
+  // Writes the rows of the first 'numBatches' batches of 'match.inputs' to
+  // 'match.spill' and removes the batches from 'match'.
+  void spillMatchBatches(Match& match, size_t numBatches);
+
+  // Appends the cartesian product of leftMatch_ and a spilled rightMatch_ to
+  // output_. Reads the spilled right side rows one batch at a time and pairs
+  // each batch with all the left side rows, so that the spilled rows are read
+  // only once. Returns true if output_ is full, with leftMatch_ and
+  // rightMatch_ cursors set to continue from.
+  bool addSpilledToOutput();
+
+  // Reads the next batch of spilled rows of 'match' into 'match.spillBatch'.
+  // Returns false if all the spilled rows have been read.
+  bool nextSpillBatch(Match& match);
+
   // Adds one row of output by copying values from left and right batches at the
   // specified rows. Advances outputSize_. Assumes that output_ has room.
   //
@@ -383,6 +425,14 @@ class MergeJoin : public Operator {
   /// A set of rows with matching keys on the right side.
   std::optional<Match> rightMatch_;
 
+  /// Set if a long run of matching rows on the right side may be spilled to
+  /// disk.
+  const std::optional<Spiller::Config> spillConfig_;
+
+  /// Max number of rows of a right side match to keep in memory before
+  /// spilling. Only used if 'spillConfig_' is set.
+  const uint64_t spillMatchRows_;
+
   RowVectorPtr output_;
 
   /// Number of rows accumulated in the output_.
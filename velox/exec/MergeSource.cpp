@@ -148,6 +148,7 @@ class MergeExchangeSource : public MergeSource {
       inputStream_ = std::make_unique<ByteStream>();
       mergeExchange_->stats().rawInputBytes += currentPage_->size();
       currentPage_->prepareStreamForDeserialize(inputStream_.get());
+      inputStream_->setInputOwner(currentPage_);
     }
 
     if (!inputStream_->atEnd()) {
@@ -155,7 +156,8 @@ class MergeExchangeSource : public MergeSource {
           inputStream_.get(),
           mergeExchange_->pool(),
           mergeExchange_->outputType(),
-          &data);
+          &data,
+          mergeExchange_->serdeOptions());
 
       mergeExchange_->stats().inputPositions += data->size();
       mergeExchange_->stats().inputBytes += data->retainedSize();
@@ -183,7 +185,8 @@ class MergeExchangeSource : public MergeSource {
   MergeExchange* mergeExchange_;
   std::unique_ptr<ExchangeClient> client_;
   std::unique_ptr<ByteStream> inputStream_;
-  std::unique_ptr<SerializedPage> currentPage_;
+  // Shared with the vectors that are deserialized in place from the page.
+  std::shared_ptr<SerializedPage> currentPage_;
   bool atEnd_ = false;
 
   BlockingReason enqueue(RowVectorPtr input, ContinueFuture* future) override {
@@ -78,7 +78,41 @@ OperatorCtx::createConnectorQueryCtx(
       driverCtx_->task->queryCtx()->getConnectorConfig(connectorId),
       expressionEvaluator_.get(),
       driverCtx_->task->queryCtx()->mappedMemory(),
+      fmt::format("{}.{}", driverCtx_->task->taskId(), planNodeId),
+      driverCtx_->task->queryCtx()->config().cacheTenant());
+}
+
+std::shared_ptr<connector::ConnectorQueryCtx>
+OperatorCtx::createDetachedConnectorQueryCtx(
+    const std::string& connectorId,
+    const std::string& planNodeId) const {
+  struct Holder {
+    Holder(
+        memory::MemoryPool* pool,
+        core::QueryCtx* queryCtx,
+        const std::string& connectorId,
+        std::string scanId)
+        : execCtx(pool, queryCtx),
+          expressionEvaluator(&execCtx),
+          connectorQueryCtx(
+              pool,
+              queryCtx->getConnectorConfig(connectorId),
+              &expressionEvaluator,
+              queryCtx->mappedMemory(),
+              std::move(scanId),
+              queryCtx->config().cacheTenant()) {}
+
+    core::ExecCtx execCtx;
+    SimpleExpressionEvaluator expressionEvaluator;
+    connector::ConnectorQueryCtx connectorQueryCtx;
+  };
+  auto holder = std::make_shared<Holder>(
+      pool_,
+      driverCtx_->task->queryCtx().get(),
+      connectorId,
       fmt::format("{}.{}", driverCtx_->task->taskId(), planNodeId));
+  return std::shared_ptr<connector::ConnectorQueryCtx>(
+      holder, &holder->connectorQueryCtx);
 }
 
 Operator::Operator(
@@ -188,6 +222,26 @@ memory::MappedMemory* OperatorCtx::mappedMemory() const {
   return mappedMemory_;
 }
 
+bool OperatorCtx::reclaimFromTask(int64_t targetBytes) const {
+  if (!driverCtx_->queryConfig().spillArbitrationEnabled()) {
+    return false;
+  }
+  return driverCtx_->task->reclaimMemory(driverCtx_->driver, targetBytes) >=
+      targetBytes;
+}
+
+core::SpillDiskTracker& OperatorCtx::spillDiskTracker() const {
+  return *driverCtx_->task->queryCtx()->spillDiskTracker();
+}
+
+bool OperatorCtx::waitForSpillDisk(ContinueFuture* future) const {
+  const auto maxBytes = driverCtx_->queryConfig().maxSpillBytes();
+  if (maxBytes == 0) {
+    return false;
+  }
+  return spillDiskTracker().waitIfExceeded(this, maxBytes, future);
+}
+
 const std::string& OperatorCtx::taskId() const {
   return driverCtx_->task->taskId();
 }
@@ -237,6 +291,30 @@ RowVectorPtr Operator::fillOutput(vector_size_t size, BufferPtr mapping) {
       std::move(columns));
 }
 
+uint32_t Operator::outputBatchRows(
+    std::optional<uint64_t> averageRowBytes) const {
+  const auto& config = operatorCtx_->driverCtx()->queryConfig();
+  const auto preferredBytes = config.preferredOutputBatchBytes();
+  if (!averageRowBytes.has_value() || preferredBytes == 0) {
+    return config.preferredOutputBatchSize();
+  }
+  const uint64_t maxRows = config.maxOutputBatchRows();
+  if (averageRowBytes.value() == 0) {
+    return maxRows;
+  }
+  return std::clamp<uint64_t>(
+      preferredBytes / averageRowBytes.value(), 1, maxRows);
+}
+
+// static
+std::optional<uint64_t> Operator::averageRowBytes(
+    const BaseVector& vector) {
+  if (vector.size() == 0) {
+    return std::nullopt;
+  }
+  return vector.estimateFlatSize() / vector.size();
+}
+
 void Operator::recordBlockingTime(uint64_t start) {
   uint64_t now =
       std::chrono::duration_cast<std::chrono::microseconds>(
@@ -345,6 +423,11 @@ void OperatorStats::add(const OperatorStats& other) {
   spilledBytes += other.spilledBytes;
   spilledRows += other.spilledRows;
   spilledPartitions += other.spilledPartitions;
+  spilledUncompressedBytes += other.spilledUncompressedBytes;
+  spilledFiles += other.spilledFiles;
+  spillWriteTimeUs += other.spillWriteTimeUs;
+  spillReadTimeUs += other.spillReadTimeUs;
+  spillPeakDiskBytes = std::max(spillPeakDiskBytes, other.spillPeakDiskBytes);
 }
 
 void OperatorStats::clear() {
@@ -15,6 +15,7 @@
  */
 #pragma once
 #include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/process/PerfCounters.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Driver.h"
@@ -135,6 +136,21 @@ struct OperatorStats {
   // Total spilled partitions.
   uint32_t spilledPartitions{0};
 
+  // Total serialized bytes of the spilled data before compression. Equals
+  // 'spilledBytes' if spilling is not compressed.
+  uint64_t spilledUncompressedBytes{0};
+
+  // Total spill files written.
+  uint64_t spilledFiles{0};
+
+  // Time spent writing and reading spill files.
+  uint64_t spillWriteTimeUs{0};
+  uint64_t spillReadTimeUs{0};
+
+  // The peak bytes of the spill files of the query on disk, as seen by the
+  // operator.
+  uint64_t spillPeakDiskBytes{0};
+
   std::unordered_map<std::string, RuntimeMetric> runtimeStats;
 
   int numDrivers = 0;
@@ -158,6 +174,25 @@ struct OperatorStats {
     runtimeStats.at(name).addValue(value.value);
   }
 
+  /// Adds the hardware events counted in a call of the operator to the
+  /// runtime stats.
+  void addPerfCounters(const process::PerfCounterValues& values) {
+    addRuntimeStat("perfCycles", RuntimeCounter(values.cycles));
+    addRuntimeStat("perfInstructions", RuntimeCounter(values.instructions));
+    addRuntimeStat("perfLlcMisses", RuntimeCounter(values.llcMisses));
+    addRuntimeStat("perfDtlbMisses", RuntimeCounter(values.dtlbMisses));
+    addRuntimeStat("perfBranchMisses", RuntimeCounter(values.branchMisses));
+  }
+
+  /// Returns the ratio of the uncompressed to the written size of the spilled
+  /// data. 1 if nothing was spilled.
+  double spillCompressionRatio() const {
+    if (spilledBytes == 0) {
+      return 1;
+    }
+    return static_cast<double>(spilledUncompressedBytes) / spilledBytes;
+  }
+
   void add(const OperatorStats& other);
   void clear();
 };
@@ -188,6 +223,24 @@ class OperatorCtx {
 
   memory::MappedMemory* mappedMemory() const;
 
+  /// Asks the Task to free 'targetBytes' by reclaiming the operators that
+  /// hold the most reclaimable memory first, see Operator::reclaim(). Called
+  /// by a spilling operator that failed to grow its reservation, which may or
+  /// may not be reclaimed itself. Returns true if at least 'targetBytes' were
+  /// freed. Returns false without doing anything unless
+  /// QueryConfig::kSpillArbitrationEnabled is set.
+  bool reclaimFromTask(int64_t targetBytes) const;
+
+  /// Returns the tracker of the spill files of the query on disk.
+  core::SpillDiskTracker& spillDiskTracker() const;
+
+  /// Returns true and sets 'future' if the spill files of the query exceed
+  /// QueryConfig::kMaxSpillBytes. 'future' is completed when some spill files
+  /// of the query are released. Called by a spilling operator before taking
+  /// more input. Throws if no other operator of the query could release spill
+  /// files.
+  bool waitForSpillDisk(ContinueFuture* future) const;
+
   core::ExecCtx* execCtx() const;
 
   // Makes an extract of QueryCtx for use in a connector. 'planNodeId'
@@ -197,6 +250,15 @@ class OperatorCtx {
       const std::string& connectorId,
       const std::string& planNodeId) const;
 
+  // Same as createConnectorQueryCtx() but the result has its own ExecCtx and
+  // ExpressionEvaluator. It may then be used on another thread than the
+  // Driver and outlive 'this' while the Task lives, e.g. for preloading
+  // splits.
+  std::shared_ptr<connector::ConnectorQueryCtx>
+  createDetachedConnectorQueryCtx(
+      const std::string& connectorId,
+      const std::string& planNodeId) const;
+
  private:
   DriverCtx* driverCtx_;
   velox::memory::MemoryPool* pool_;
@@ -273,6 +335,22 @@ class Operator {
   // @param input Non-empty input vector.
   virtual void addInput(RowVectorPtr input) = 0;
 
+  // Returns true if addInputRows() may be called with the next input, i.e.
+  // 'this' can consume some rows of an input directly. The Driver then gets
+  // the output of the previous operator with getOutputRows().
+  virtual bool supportsInputRows() const {
+    return false;
+  }
+
+  // Adds the 'rows' of 'input'. 'input' has at least rows.end() rows and the
+  // other rows are ignored. Called only if supportsInputRows().
+  virtual void addInputRows(
+      RowVectorPtr /*input*/,
+      const SelectivityVector& /*rows*/) {
+    VELOX_UNSUPPORTED(
+        "{} does not support addInputRows", stats_.operatorType);
+  }
+
   // Informs 'this' that addInput will no longer be called. This means
   // that any partial state kept by 'this' should be returned by
   // the next call(s) to getOutput. Not used if operator is a source operator,
@@ -289,6 +367,17 @@ class Operator {
   // @return nullptr or a non-empty output vector.
   virtual RowVectorPtr getOutput() = 0;
 
+  // Same as getOutput() but may return a RowVector of which only '*rows' is
+  // the output, e.g. a filter may return its input and the rows that passed
+  // instead of wrapping the passing rows in dictionaries. Sets '*rows' to
+  // nullptr if all rows of the result are the output. Called only if the
+  // next operator supportsInputRows(). '*rows' stays valid until the next
+  // call on 'this'.
+  virtual RowVectorPtr getOutputRows(const SelectivityVector** rows) {
+    *rows = nullptr;
+    return getOutput();
+  }
+
   // Returns kNotBlocked if 'this' is not prevented from
   // advancing. Otherwise, returns a reason and sets 'future' to a
   // future that will be realized when the reason is no longer present.
@@ -350,6 +439,18 @@ class Operator {
     operatorCtx_->pool()->getMemoryUsageTracker()->release();
   }
 
+  // Returns the bytes of memory that reclaim() would free, e.g. the memory of
+  // the rows that a spilling operator still holds. 0 if 'this' can't free
+  // memory now. Called by Task::reclaimMemory() while the other drivers of the
+  // Task are off thread.
+  virtual int64_t reclaimableBytes() const {
+    return 0;
+  }
+
+  // Frees the memory reported by reclaimableBytes(), e.g. by spilling all the
+  // rows held by 'this'. Called only if reclaimableBytes() is not 0.
+  virtual void reclaim() {}
+
   // Returns true if 'this' never has more output rows than input rows.
   virtual bool isFilter() const {
     return false;
@@ -408,6 +509,20 @@ class Operator {
   // 'identityProjections_' and 'resultProjections_'.
   RowVectorPtr fillOutput(vector_size_t size, BufferPtr mapping);
 
+  // Returns the number of rows of an output batch whose rows are about
+  // 'averageRowBytes' each. This is the number of such rows in
+  // QueryConfig::preferredOutputBatchBytes(), between 1 and
+  // QueryConfig::maxOutputBatchRows(). Returns
+  // QueryConfig::preferredOutputBatchSize() if the row size is not known or
+  // batches are not sized by bytes. All operators that choose the size of
+  // their output batches size them with this.
+  uint32_t outputBatchRows(
+      std::optional<uint64_t> averageRowBytes = std::nullopt) const;
+
+  // Returns the average flat size of the rows of 'vector' or std::nullopt if
+  // 'vector' is empty.
+  static std::optional<uint64_t> averageRowBytes(const BaseVector& vector);
+
   std::unique_ptr<OperatorCtx> operatorCtx_;
   OperatorStats stats_;
   const RowTypePtr outputType_;
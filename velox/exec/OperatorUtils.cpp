@@ -17,6 +17,7 @@
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/VectorHasher.h"
 #include "velox/expression/EvalCtx.h"
+#include "velox/serializers/PrestoSerializer.h"
 #include "velox/vector/ConstantVector.h"
 #include "velox/vector/FlatVector.h"
 
@@ -243,7 +244,7 @@ VectorPtr wrapChild(
     return child;
   }
 
-  return BaseVector::wrapInDictionary(nulls, mapping, size, child);
+  return BaseVector::wrapInDictionaryOrCopy(nulls, mapping, size, child);
 }
 
 RowVectorPtr
@@ -348,6 +349,7 @@ std::optional<Spiller::Config> makeOperatorSpillConfig(
     const core::QueryCtx& queryCtx,
     const OperatorCtx& operatorCtx,
     const char* spillConfigPropertyName,
+    const char* spillCompressionPropertyName,
     int32_t operatorId) {
   const auto& queryConfig = queryCtx.config();
   if (not queryConfig.spillEnabled() or
@@ -371,7 +373,38 @@ std::optional<Spiller::Config> makeOperatorSpillConfig(
           queryConfig.spillStartPartitionBit(),
           queryConfig.spillStartPartitionBit() +
               queryConfig.spillPartitionBits()),
-      queryConfig.testingSpillPct());
+      queryConfig.testingSpillPct(),
+      spillCompressionKindFromString(
+          queryConfig.spillCompressionCodec(spillCompressionPropertyName)),
+      queryConfig.maxSpillLevel(),
+      SpillWriteOptions{
+          queryConfig.spillWriteBufferSize(),
+          queryConfig.spillLocalPath().value_or(""),
+          queryConfig.spillLocalMaxBytes(),
+          queryCtx.spillDiskTracker(),
+          &operatorCtx},
+      SpillReadOptions{
+          queryConfig.spillReadBufferSize(),
+          queryConfig.spillReadAheadEnabled() ? queryCtx.spillExecutor()
+                                              : nullptr,
+          queryConfig.spillMaxMergeFanIn()});
+}
+
+std::unique_ptr<VectorSerde::Options> makeExchangeSerdeOptions(
+    const core::QueryConfig& queryConfig) {
+  static const std::unordered_map<std::string, folly::io::CodecType> kCodecs = {
+      {"lz4", folly::io::CodecType::LZ4},
+      {"zstd", folly::io::CodecType::ZSTD},
+  };
+  const auto name = queryConfig.exchangeCompressionCodec();
+  if (name == "none") {
+    return nullptr;
+  }
+  auto it = kCodecs.find(name);
+  VELOX_USER_CHECK(
+      it != kCodecs.end(), "Unknown exchange compression codec: {}", name);
+  return std::make_unique<serializer::presto::PrestoVectorSerde::PrestoOptions>(
+      false, it->second);
 }
 
 } // namespace facebook::velox::exec
@@ -65,7 +65,8 @@ vector_size_t processFilterResults(
 
 // Wraps the specified vector into a dictionary using the specified mapping.
 // Returns vector as-is if mapping is null. An optional nulls buffer can be
-// provided to introduce additional nulls.
+// provided to introduce additional nulls. Copies the mapped rows into a flat
+// vector instead if BaseVector::shouldCopyInsteadOfWrap().
 VectorPtr wrapChild(
     vector_size_t size,
     BufferPtr mapping,
@@ -117,11 +118,20 @@ std::string makeOperatorSpillPath(
     int32_t operatorId);
 
 /// Generates the spiller config for a given operator if the disk spilling is
-/// enabled, otherwise returns null.
+/// enabled, otherwise returns null. 'spillCompressionPropertyName' is the
+/// per-operator option for the spill compression codec, e.g.
+/// QueryConfig::kAggregationSpillCompressionCodec.
 std::optional<Spiller::Config> makeOperatorSpillConfig(
     const core::QueryCtx& queryCtx,
     const OperatorCtx& operatorCtx,
     const char* spillConfigPropertyName,
+    const char* spillCompressionPropertyName,
     int32_t operatorId);
 
+/// Returns the serde options for the pages of the exchanges of a query or
+/// nullptr if the pages are not compressed. Throws if
+/// QueryConfig::kExchangeCompressionCodec is not a known codec.
+std::unique_ptr<VectorSerde::Options> makeExchangeSerdeOptions(
+    const core::QueryConfig& queryConfig);
+
 } // namespace facebook::velox::exec
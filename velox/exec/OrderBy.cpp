@@ -15,6 +15,7 @@
  */
 #include "velox/exec/OrderBy.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/PrefixSort.h"
 #include "velox/exec/Task.h"
 #include "velox/vector/FlatVector.h"
 
@@ -24,8 +25,23 @@ namespace {
 CompareFlags fromSortOrderToCompareFlags(const core::SortOrder& sortOrder) {
   return {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false};
 }
+
+// Number of samples per range for picking the splitters of a parallel sort.
+constexpr int32_t kSamplesPerRange = 64;
 } // namespace
 
+// static
+bool OrderBy::isParallelSort(
+    const core::OrderByNode& orderByNode,
+    const core::QueryConfig& config) {
+  // The ranges are made from all the rows of each driver, so a parallel sort
+  // does not spill.
+  const bool canSpill = config.spillEnabled() &&
+      config.orderBySpillEnabled() && config.spillPath().has_value();
+  return config.orderByParallelSortEnabled() && orderByNode.isPartial() &&
+      !canSpill;
+}
+
 OrderBy::OrderBy(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -45,7 +61,11 @@ OrderBy::OrderBy(
           *operatorCtx_->task()->queryCtx(),
           *operatorCtx_,
           core::QueryConfig::kOrderBySpillEnabled,
-          operatorId)) {
+          core::QueryConfig::kOrderBySpillCompressionCodec,
+          operatorId)),
+      parallelSort_(
+          isParallelSort(*orderByNode, driverCtx->queryConfig()) &&
+          operatorCtx_->task()->numDrivers(driverCtx->pipelineId) > 1) {
   std::vector<TypePtr> keyTypes;
   std::vector<TypePtr> dependentTypes;
   std::vector<TypePtr> types;
@@ -121,6 +141,10 @@ void OrderBy::addInput(RowVectorPtr input) {
     stats_.spilledBytes = stats.spilledBytes;
     stats_.spilledRows = stats.spilledRows;
     stats_.spilledPartitions = stats.spilledPartitions;
+    stats_.spilledUncompressedBytes = stats.spilledUncompressedBytes;
+    stats_.spilledFiles = stats.spilledFiles;
+    stats_.spillWriteTimeUs = stats.spillWriteTimeUs;
+    stats_.spillPeakDiskBytes = operatorCtx_->spillDiskTracker().peakBytes();
     VELOX_DCHECK_LE(stats_.spilledPartitions, 1);
   }
 }
@@ -196,6 +220,12 @@ void OrderBy::ensureInputFits(const RowVectorPtr& input) {
   if (tracker->maybeReserve(targetIncrementBytes)) {
     return;
   }
+  // The Task may spill another operator that holds more memory, or 'this'.
+  if (operatorCtx_->reclaimFromTask(targetIncrementBytes) &&
+      (data_->numRows() < numRows ||
+       tracker->maybeReserve(targetIncrementBytes))) {
+    return;
+  }
   const int64_t rowsToSpill = std::max<int64_t>(
       1, targetIncrementBytes / (data_->fixedRowSize() + outOfLineBytesPerRow));
   spill(
@@ -204,6 +234,17 @@ void OrderBy::ensureInputFits(const RowVectorPtr& input) {
           0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
 }
 
+int64_t OrderBy::reclaimableBytes() const {
+  if (!spillConfig_.has_value() || noMoreInput_ || data_->numRows() == 0) {
+    return 0;
+  }
+  return data_->allocatedBytes();
+}
+
+void OrderBy::reclaim() {
+  spill(0, 0);
+}
+
 void OrderBy::spill(int64_t targetRows, int64_t targetBytes) {
   VELOX_CHECK_GE(targetRows, 0);
   VELOX_CHECK_GE(targetBytes, 0);
@@ -223,15 +264,199 @@ void OrderBy::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig.filePath,
         spillFileSize,
         Spiller::spillPool(),
-        spillConfig.executor);
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.writeOptions);
     VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
   }
   spiller_->spill(targetRows, targetBytes);
 }
 
+void OrderBy::sortRows() {
+  VELOX_CHECK_EQ(numRows_, data_->numRows());
+  // Sort the pointers to the rows in RowContainer (data_) instead of sorting
+  // the rows.
+  returningRows_.resize(numRows_);
+  RowContainerIterator iter;
+  data_->listRows(&iter, numRows_, returningRows_.data());
+  PrefixSort::sort(
+      *data_,
+      PrefixSort::leadingKeys(numSortKeys_, keyCompareFlags_),
+      folly::Range<char**>(returningRows_.data(), returningRows_.size()));
+}
+
+void OrderBy::startParallelSort() {
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    waitingForPeers_ = true;
+    return;
+  }
+
+  auto* driverCtx = operatorCtx_->driverCtx();
+  std::vector<OrderBy*> orderBys(
+      operatorCtx_->task()->numDrivers(driverCtx->pipelineId), nullptr);
+  orderBys[driverCtx->partitionId] = this;
+  for (auto& peer : peers) {
+    auto* orderBy = dynamic_cast<OrderBy*>(peer->findOperator(planNodeId()));
+    VELOX_CHECK_NOT_NULL(orderBy);
+    orderBys[peer->driverCtx()->partitionId] = orderBy;
+  }
+  for (auto* orderBy : orderBys) {
+    VELOX_CHECK_NOT_NULL(orderBy);
+  }
+  auto state = makeRanges(orderBys);
+  // The peers are blocked until the promises are realized.
+  for (auto* orderBy : orderBys) {
+    orderBy->parallelSortState_ = state;
+  }
+  peers.clear();
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+std::shared_ptr<OrderBy::ParallelSortState> OrderBy::makeRanges(
+    const std::vector<OrderBy*>& orderBys) {
+  const auto numRanges = orderBys.size();
+  size_t totalRows = 0;
+  for (auto* orderBy : orderBys) {
+    totalRows += orderBy->returningRows_.size();
+  }
+
+  // Takes evenly spaced rows from the sorted rows of each driver, so that
+  // each driver contributes samples in proportion to its rows.
+  const auto stride =
+      std::max<size_t>(1, totalRows / (kSamplesPerRange * numRanges));
+  std::vector<char*> samples;
+  for (auto* orderBy : orderBys) {
+    const auto& rows = orderBy->returningRows_;
+    for (auto i = stride / 2; i < rows.size(); i += stride) {
+      samples.push_back(rows[i]);
+    }
+  }
+  auto lessThan = [&](const char* left, const char* right) {
+    return data_->compareRows(left, right, keyCompareFlags_) < 0;
+  };
+  std::sort(samples.begin(), samples.end(), lessThan);
+
+  std::vector<char*> splitters;
+  if (!samples.empty()) {
+    for (auto i = 1; i < numRanges; ++i) {
+      splitters.push_back(samples[i * samples.size() / numRanges]);
+    }
+  }
+
+  // Range i of a driver has its rows from splitter i - 1 up to but not
+  // including splitter i. The samples point to the rows of the drivers, so
+  // the ranges are made before taking the rows.
+  auto state = std::make_shared<ParallelSortState>();
+  for (auto* orderBy : orderBys) {
+    auto& rows = orderBy->returningRows_;
+    std::vector<size_t> starts{0};
+    for (auto* splitter : splitters) {
+      starts.push_back(
+          std::lower_bound(rows.begin(), rows.end(), splitter, lessThan) -
+          rows.begin());
+    }
+    starts.resize(numRanges, rows.size());
+    starts.push_back(rows.size());
+    state->rangeStarts.push_back(std::move(starts));
+  }
+  for (auto* orderBy : orderBys) {
+    state->containers.push_back(orderBy->data_);
+    state->sortedRows.push_back(std::move(orderBy->returningRows_));
+    orderBy->returningRows_.clear();
+  }
+  return state;
+}
+
+void OrderBy::startRangeMerge() {
+  VELOX_CHECK_NOT_NULL(parallelSortState_);
+  rangeMergeStarted_ = true;
+  const auto range = operatorCtx_->driverCtx()->partitionId;
+  std::vector<std::unique_ptr<SortedRowStream>> streams;
+  numRows_ = 0;
+  numRowsReturned_ = 0;
+  for (auto i = 0; i < parallelSortState_->sortedRows.size(); ++i) {
+    const auto& rows = parallelSortState_->sortedRows[i];
+    const auto& starts = parallelSortState_->rangeStarts[i];
+    if (starts[range + 1] == starts[range]) {
+      continue;
+    }
+    numRows_ += starts[range + 1] - starts[range];
+    streams.push_back(std::make_unique<SortedRowStream>(
+        data_.get(),
+        keyCompareFlags_,
+        folly::Range<char* const*>(
+            rows.data() + starts[range], rows.data() + starts[range + 1])));
+  }
+  if (!streams.empty()) {
+    rangeMerge_ =
+        std::make_unique<TreeOfLosers<SortedRowStream>>(std::move(streams));
+  }
+}
+
+RowVectorPtr OrderBy::getOutputFromRange() {
+  if (!rangeMergeStarted_) {
+    startRangeMerge();
+  }
+  if (numRowsReturned_ == numRows_) {
+    finished_ = true;
+    return nullptr;
+  }
+  prepareOutput();
+
+  // The rows of the range are in the RowContainers of all drivers. These
+  // have the same layout as 'data_'.
+  const auto numOutput = output_->size();
+  returningRows_.resize(numOutput);
+  for (auto i = 0; i < numOutput; ++i) {
+    auto* stream = rangeMerge_->next();
+    VELOX_CHECK_NOT_NULL(stream);
+    returningRows_[i] = stream->current();
+    stream->pop();
+  }
+  for (const auto& columnProjection : columnMap_) {
+    data_->extractColumn(
+        returningRows_.data(),
+        numOutput,
+        columnProjection.inputChannel,
+        output_->childAt(columnProjection.outputChannel));
+  }
+  numRowsReturned_ += numOutput;
+  finished_ = (numRowsReturned_ == numRows_);
+  return output_;
+}
+
+BlockingReason OrderBy::isBlocked(ContinueFuture* future) {
+  if (waitingForPeers_) {
+    if (future_.valid()) {
+      *future = std::move(future_);
+      return BlockingReason::kWaitForPeers;
+    }
+    waitingForPeers_ = false;
+  }
+  // Takes no more input while the spill files of the query are over budget.
+  if (spillConfig_.has_value() && !noMoreInput_ &&
+      operatorCtx_->waitForSpillDisk(future)) {
+    return BlockingReason::kWaitForSpill;
+  }
+  return BlockingReason::kNotBlocked;
+}
+
 void OrderBy::noMoreInput() {
   Operator::noMoreInput();
 
+  if (parallelSort_) {
+    // Takes part in the parallel sort even without rows since the range of
+    // this driver may have rows of the other drivers.
+    sortRows();
+    startParallelSort();
+    return;
+  }
+
   // No data.
   if (numRows_ == 0) {
     finished_ = true;
@@ -239,25 +464,7 @@ void OrderBy::noMoreInput() {
   }
 
   if (spiller_ == nullptr) {
-    VELOX_CHECK_EQ(numRows_, data_->numRows());
-    // Sort the pointers to the rows in RowContainer (data_) instead of sorting
-    // the rows.
-    returningRows_.resize(numRows_);
-    RowContainerIterator iter;
-    data_->listRows(&iter, numRows_, returningRows_.data());
-    std::sort(
-        returningRows_.begin(),
-        returningRows_.end(),
-        [this](const char* leftRow, const char* rightRow) {
-          for (vector_size_t index = 0; index < numSortKeys_; ++index) {
-            if (auto result = data_->compare(
-                    leftRow, rightRow, index, keyCompareFlags_[index])) {
-              return result < 0;
-            }
-          }
-          return false;
-        });
-
+    sortRows();
   } else {
     // Finish spill, and we shouldn't get any rows from non-spilled partition as
     // there is only one hash partition for orderBy operator.
@@ -265,13 +472,19 @@ void OrderBy::noMoreInput() {
     VELOX_CHECK(nonSpilledRows.empty());
     VELOX_CHECK_NULL(spillMerge_);
 
-    spillMerge_ = spiller_->startMerge(0);
+    spillMerge_ = spiller_->startMerge(0, spillConfig_->readOptions);
     spillSources_.resize(outputBatchSize_);
     spillSourceRows_.resize(outputBatchSize_);
   }
 }
 
 RowVectorPtr OrderBy::getOutput() {
+  if (parallelSort_) {
+    if (finished_ || !noMoreInput_ || waitingForPeers_) {
+      return nullptr;
+    }
+    return getOutputFromRange();
+  }
   if (finished_ || !noMoreInput_ || numRows_ == numRowsReturned_) {
     return nullptr;
   }
@@ -320,6 +533,30 @@ void OrderBy::getOutputWithSpill() {
     SpillMergeStream* stream = spillMerge_->next();
     VELOX_CHECK_NOT_NULL(stream);
 
+    // When the same stream wins twice in a row, the spilled runs are likely
+    // to not overlap much. Copies the rows up to the head of the runner-up
+    // as one range then.
+    if (stream == lastSpillStream_) {
+      const auto numRows = stream->runSize(
+          spillMerge_->runnerUp(), output_->size() - outputRow - outputSize);
+      if (numRows > 1) {
+        gatherCopy(
+            output_.get(),
+            outputRow,
+            outputSize,
+            spillSources_,
+            spillSourceRows_,
+            columnMap_);
+        outputRow += outputSize;
+        outputSize = 0;
+        copySpillRun(*stream, outputRow, numRows);
+        outputRow += numRows;
+        stream->pop(numRows);
+        continue;
+      }
+    }
+    lastSpillStream_ = stream;
+
     spillSources_[outputSize] = &stream->current();
     spillSourceRows_[outputSize] = stream->currentIndex(&isEndOfBatch);
     ++outputSize;
@@ -353,6 +590,30 @@ void OrderBy::getOutputWithSpill() {
   }
 
   numRowsReturned_ += output_->size();
+  stats_.spillReadTimeUs = spiller_->state().ioStats().readTimeUs;
+}
+
+void OrderBy::copySpillRun(
+    const SpillMergeStream& stream,
+    vector_size_t outputRow,
+    vector_size_t numRows) {
+  const auto& source = stream.current();
+  const auto sourceRow = stream.currentIndex();
+  if (columnMap_.empty()) {
+    for (auto i = 0; i < output_->type()->size(); ++i) {
+      output_->childAt(i)->copy(
+          source.childAt(i).get(), outputRow, sourceRow, numRows);
+    }
+    return;
+  }
+  for (const auto& columnProjection : columnMap_) {
+    output_->childAt(columnProjection.outputChannel)
+        ->copy(
+            source.childAt(columnProjection.inputChannel).get(),
+            outputRow,
+            sourceRow,
+            numRows);
+  }
 }
 
 void OrderBy::prepareOutput() {
@@ -19,9 +19,51 @@
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
 #include "velox/exec/Spiller.h"
+#include "velox/exec/TreeOfLosers.h"
 
 namespace facebook::velox::exec {
 
+/// A run of rows of a RowContainer sorted on its keys. Used for merging the
+/// runs of the drivers of a parallel sort. The rows may come from another
+/// RowContainer with the same types as 'container'.
+class SortedRowStream final : public MergeStream {
+ public:
+  SortedRowStream(
+      RowContainer* FOLLY_NONNULL container,
+      const std::vector<CompareFlags>& compareFlags,
+      folly::Range<char* const*> rows)
+      : container_(container), compareFlags_(compareFlags), rows_(rows) {}
+
+  bool hasData() const final {
+    return index_ < rows_.size();
+  }
+
+  bool operator<(const MergeStream& other) const final {
+    return compare(other) < 0;
+  }
+
+  int32_t compare(const MergeStream& other) const final {
+    return container_->compareRows(
+        current(),
+        static_cast<const SortedRowStream&>(other).current(),
+        compareFlags_);
+  }
+
+  char* FOLLY_NONNULL current() const {
+    return rows_[index_];
+  }
+
+  void pop() {
+    ++index_;
+  }
+
+ private:
+  RowContainer* FOLLY_NONNULL const container_;
+  const std::vector<CompareFlags>& compareFlags_;
+  const folly::Range<char* const*> rows_;
+  size_t index_{0};
+};
+
 /// OrderBy operator implementation: OrderBy stores all its inputs in a
 /// RowContainer as the inputs are added. Until all inputs are available,
 /// it blocks the pipeline. Once all inputs are available, it sorts pointers
@@ -31,6 +73,14 @@ namespace facebook::velox::exec {
 /// Limitations:
 /// * It memcopies twice: 1) input to RowContainer and 2) RowContainer to
 /// output.
+///
+/// With 'order_by_parallel_sort_enabled', the drivers of a partial OrderBy
+/// sort cooperatively: each driver sorts its rows, the last one to finish
+/// its input picks splitters from samples of the sorted rows of all drivers,
+/// and then the driver with partition id i returns the rows between
+/// splitters i - 1 and i of all drivers. The output of the drivers is then
+/// in partition id order, which a LocalMerge over the OrderBy concatenates
+/// instead of merging.
 class OrderBy : public Operator {
  public:
   OrderBy(
@@ -48,15 +98,35 @@ class OrderBy : public Operator {
 
   RowVectorPtr getOutput() override;
 
-  BlockingReason isBlocked(ContinueFuture* FOLLY_NULLABLE /*future*/) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override {
     return finished_;
   }
 
+  int64_t reclaimableBytes() const override;
+
+  void reclaim() override;
+
+  /// Returns true if the drivers of 'orderByNode' run a parallel sort with
+  /// 'config'.
+  static bool isParallelSort(
+      const core::OrderByNode& orderByNode,
+      const core::QueryConfig& config);
+
  private:
+  // The rows of all the drivers of a parallel sort. Shared by the drivers so
+  // that the RowContainers live until all drivers have returned their rows.
+  struct ParallelSortState {
+    std::vector<std::shared_ptr<RowContainer>> containers;
+
+    // The sorted rows of each driver.
+    std::vector<std::vector<char*>> sortedRows;
+
+    // For each driver, the index in 'sortedRows' of the first row of each
+    // range followed by the number of rows.
+    std::vector<std::vector<size_t>> rangeStarts;
+  };
   static const int32_t kBatchSizeInBytes{2 * 1024 * 1024};
 
   // Checks if input will fit in the existing memory and increases
@@ -71,6 +141,31 @@ class OrderBy : public Operator {
   void getOutputWithoutSpill();
   void getOutputWithSpill();
 
+  // Copies 'numRows' rows from the current row of 'stream' to 'output_'
+  // starting at 'outputRow'.
+  void copySpillRun(
+      const SpillMergeStream& stream,
+      vector_size_t outputRow,
+      vector_size_t numRows);
+
+  // Sorts the pointers to the rows in 'data_' into 'returningRows_'.
+  void sortRows();
+
+  // Waits for the peers to sort their rows. The last driver makes the ranges
+  // of all drivers.
+  void startParallelSort();
+
+  // Picks a splitter per driver from samples of the sorted rows of
+  // 'orderBys' and makes the ranges between the splitters. Takes the rows of
+  // 'orderBys'.
+  std::shared_ptr<ParallelSortState> makeRanges(
+      const std::vector<OrderBy*>& orderBys);
+
+  // Starts merging the rows of the range of this driver.
+  void startRangeMerge();
+
+  RowVectorPtr getOutputFromRange();
+
   // Spills content until under 'targetRows' and under 'targetBytes' of out of
   // line data are left. If 'targetRows' is 0, spills everything and physically
   // frees the data in the 'data_'. This is called by ensureInputFits or by
@@ -97,7 +192,7 @@ class OrderBy : public Operator {
 
   std::vector<CompareFlags> keyCompareFlags_;
 
-  std::unique_ptr<RowContainer> data_;
+  std::shared_ptr<RowContainer> data_;
 
   // The row type used to store input data in row container and for spilling
   // internally.
@@ -131,6 +226,24 @@ class OrderBy : public Operator {
   std::vector<const RowVector*> spillSources_;
   std::vector<vector_size_t> spillSourceRows_;
 
+  // The stream that produced the last row taken from 'spillMerge_'.
+  const SpillMergeStream* lastSpillStream_{nullptr};
+
+  // True if sorting cooperatively with the other drivers. See
+  // isParallelSort().
+  const bool parallelSort_;
+
+  // True while waiting for the peers to sort their rows.
+  bool waitingForPeers_ = false;
+  ContinueFuture future_;
+
+  std::shared_ptr<ParallelSortState> parallelSortState_;
+
+  // Merges the runs of the range of this driver. nullptr if not started or
+  // if the range is empty.
+  std::unique_ptr<TreeOfLosers<SortedRowStream>> rangeMerge_;
+  bool rangeMergeStarted_ = false;
+
   bool finished_ = false;
 };
 } // namespace facebook::velox::exec
@@ -69,7 +69,7 @@ void Destination::serialize(
     for (vector_size_t i = begin; i < end; i++) {
       numRows += rows_[i].size;
     }
-    current_->createStreamTree(rowType, numRows);
+    current_->createStreamTree(rowType, numRows, serdeOptions_);
   }
   current_->append(output, folly::Range(&rows_[begin], end - begin));
 }
@@ -124,8 +124,8 @@ void PartitionedOutput::initializeDestinations() {
   if (destinations_.empty()) {
     auto taskId = operatorCtx_->taskId();
     for (int i = 0; i < numDestinations_; ++i) {
-      destinations_.push_back(
-          std::make_unique<Destination>(taskId, i, mappedMemory_));
+      destinations_.push_back(std::make_unique<Destination>(
+          taskId, i, mappedMemory_, serdeOptions_.get()));
     }
   }
 }
@@ -192,20 +192,61 @@ void PartitionedOutput::addInput(RowVectorPtr input) {
         // Make sure not to replicate first row twice.
         start = 1;
       }
-      for (auto i = start; i < numInput; ++i) {
-        if (nullRows_.isValid(i)) {
-          for (auto& destination : destinations_) {
-            destination->addRow(i);
+      if (nullRows_.hasSelections()) {
+        nullRows_.applyToSelected([&](auto row) {
+          if (row >= start) {
+            for (auto& destination : destinations_) {
+              destination->addRow(row);
+            }
           }
-        } else {
-          destinations_[partitions_[i]]->addRow(i);
-        }
+        });
       }
+      addRowsByPartition(start, nullRows_.hasSelections());
     } else {
-      for (vector_size_t i = 0; i < numInput; ++i) {
-        destinations_[partitions_[i]]->addRow(i);
+      addRowsByPartition(0, false);
+    }
+  }
+}
+
+void PartitionedOutput::addRowsByPartition(
+    vector_size_t begin,
+    bool skipNullRows) {
+  const auto numInput = input_->size();
+  partitionOffsets_.assign(numDestinations_ + 1, 0);
+  for (auto i = begin; i < numInput; ++i) {
+    if (skipNullRows && nullRows_.isValid(i)) {
+      continue;
+    }
+    ++partitionOffsets_[partitions_[i] + 1];
+  }
+  for (auto i = 1; i <= numDestinations_; ++i) {
+    partitionOffsets_[i] += partitionOffsets_[i - 1];
+  }
+  sortedRows_.resize(partitionOffsets_[numDestinations_]);
+  // Fills 'sortedRows_' and advances each partition offset to the start of
+  // the next partition.
+  for (auto i = begin; i < numInput; ++i) {
+    if (skipNullRows && nullRows_.isValid(i)) {
+      continue;
+    }
+    sortedRows_[partitionOffsets_[partitions_[i]]++] = i;
+  }
+  vector_size_t partitionBegin = 0;
+  for (auto partition = 0; partition < numDestinations_; ++partition) {
+    const auto partitionEnd = partitionOffsets_[partition];
+    auto& destination = destinations_[partition];
+    auto i = partitionBegin;
+    while (i < partitionEnd) {
+      // Adds the run of consecutive rows that starts at 'i'.
+      auto runEnd = i + 1;
+      while (runEnd < partitionEnd &&
+             sortedRows_[runEnd] == sortedRows_[runEnd - 1] + 1) {
+        ++runEnd;
       }
+      destination->addRows(IndexRange{sortedRows_[i], runEnd - i});
+      i = runEnd;
     }
+    partitionBegin = partitionEnd;
   }
 }
 
@@ -217,13 +258,12 @@ void PartitionedOutput::collectNullRows() {
   nullRows_.resize(size);
   nullRows_.clearAll();
 
-  decodedVectors_.resize(keyChannels_.size());
-
+  auto& decodedVectorCache = operatorCtx_->driverCtx()->decodedVectorCache;
   for (auto i : keyChannels_) {
     auto& keyVector = input_->childAt(i);
     if (keyVector->mayHaveNulls()) {
-      decodedVectors_[i].decode(*keyVector, rows_);
-      if (auto* rawNulls = decodedVectors_[i].nulls()) {
+      const auto& decoded = decodedVectorCache.decode(keyVector, rows_);
+      if (auto* rawNulls = decoded.nulls()) {
         bits::orWithNegatedBits(
             nullRows_.asMutableRange().bits(), rawNulls, 0, size);
       }
@@ -17,6 +17,7 @@
 
 #include <folly/Random.h>
 #include "velox/exec/Operator.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/vector/VectorStream.h"
 
@@ -24,11 +25,16 @@ namespace facebook::velox::exec {
 
 class Destination {
  public:
+  /// 'serdeOptions' may be nullptr for the default options of the serde.
   Destination(
       const std::string& taskId,
       int destination,
-      memory::MappedMemory* FOLLY_NONNULL memory)
-      : taskId_(taskId), destination_(destination), memory_(memory) {
+      memory::MappedMemory* FOLLY_NONNULL memory,
+      const VectorSerde::Options* FOLLY_NULLABLE serdeOptions = nullptr)
+      : taskId_(taskId),
+        destination_(destination),
+        memory_(memory),
+        serdeOptions_(serdeOptions) {
     setTargetSizePct();
   }
 
@@ -39,10 +45,17 @@ class Destination {
   }
 
   void addRow(vector_size_t row) {
-    rows_.push_back(IndexRange{row, 1});
+    addRows(IndexRange{row, 1});
   }
 
+  /// Adds 'rows'. Extends the last range if 'rows' follows it, so that
+  /// consecutive rows are serialized as one range.
   void addRows(const IndexRange& rows) {
+    if (!rows_.empty() &&
+        rows_.back().begin + rows_.back().size == rows.begin) {
+      rows_.back().size += rows.size;
+      return;
+    }
     rows_.push_back(rows);
   }
 
@@ -90,6 +103,7 @@ class Destination {
   const std::string taskId_;
   const int destination_;
   memory::MappedMemory* FOLLY_NONNULL const memory_;
+  const VectorSerde::Options* FOLLY_NULLABLE const serdeOptions_;
   uint64_t bytesInCurrent_{0};
   std::vector<IndexRange> rows_;
 
@@ -150,7 +164,9 @@ class PartitionedOutput : public Operator {
         bufferManager_(PartitionedOutputBufferManager::getInstance()),
         maxBufferedBytes_(
             ctx->task->queryCtx()->config().maxPartitionedOutputBufferSize()),
-        mappedMemory_{operatorCtx_->mappedMemory()} {
+        mappedMemory_{operatorCtx_->mappedMemory()},
+        serdeOptions_(makeExchangeSerdeOptions(
+            ctx->task->queryCtx()->config())) {
     if (numDestinations_ == 1 || planNode->isBroadcast()) {
       VELOX_CHECK(keyChannels_.empty());
       VELOX_CHECK_NULL(partitionFunction_);
@@ -197,6 +213,12 @@ class PartitionedOutput : public Operator {
   /// Collect all rows with null keys into nullRows_.
   void collectNullRows();
 
+  /// Adds the rows of 'input_' to their destinations in 'partitions_'. Sorts
+  /// the rows by partition with a counting sort, so that each destination
+  /// gets its rows as runs of consecutive rows instead of one at a time.
+  /// Skips the rows in 'nullRows_' if 'skipNullRows' is true.
+  void addRowsByPartition(vector_size_t begin, bool skipNullRows);
+
   const std::vector<column_index_t> keyChannels_;
   const int numDestinations_;
   const bool replicateNullsAndAny_;
@@ -217,13 +239,19 @@ class PartitionedOutput : public Operator {
   std::weak_ptr<exec::PartitionedOutputBufferManager> bufferManager_;
   const int64_t maxBufferedBytes_;
   memory::MappedMemory* FOLLY_NONNULL mappedMemory_;
+  // Options of the serialized pages, e.g. their compression. nullptr for the
+  // defaults.
+  const std::unique_ptr<VectorSerde::Options> serdeOptions_;
   RowVectorPtr output_;
 
   // Reusable memory.
   SelectivityVector rows_;
   SelectivityVector nullRows_;
   std::vector<uint32_t> partitions_;
-  std::vector<DecodedVector> decodedVectors_;
+  // Start of the rows of each partition in 'sortedRows_' plus the end.
+  std::vector<vector_size_t> partitionOffsets_;
+  // 'input_' rows sorted by partition.
+  std::vector<vector_size_t> sortedRows_;
 };
 
 } // namespace facebook::velox::exec
@@ -148,11 +148,12 @@ void releaseAfterAcknowledge(
 
 PartitionedOutputBuffer::PartitionedOutputBuffer(
     std::shared_ptr<Task> task,
-    bool broadcast,
+    core::PartitionedOutputNode::Kind kind,
     int numDestinations,
     uint32_t numDrivers)
     : task_(std::move(task)),
-      broadcast_(broadcast),
+      broadcast_(kind == core::PartitionedOutputNode::Kind::kBroadcast),
+      arbitrary_(kind == core::PartitionedOutputNode::Kind::kArbitrary),
       numDrivers_(numDrivers),
       maxSize_(task_->queryCtx()->config().maxPartitionedOutputBufferSize()),
       continueSize_((maxSize_ * kContinuePct) / 100) {
@@ -165,7 +166,7 @@ PartitionedOutputBuffer::PartitionedOutputBuffer(
 void PartitionedOutputBuffer::updateBroadcastOutputBuffers(
     int numBuffers,
     bool noMoreBuffers) {
-  VELOX_CHECK(broadcast_);
+  VELOX_CHECK(broadcast_ || arbitrary_);
 
   std::vector<ContinuePromise> promises;
   bool isFinished;
@@ -173,7 +174,7 @@ void PartitionedOutputBuffer::updateBroadcastOutputBuffers(
     std::lock_guard<std::mutex> l(mutex_);
 
     if (numBuffers > buffers_.size()) {
-      addBroadcastOutputBuffersLocked(numBuffers);
+      addOutputBuffersLocked(numBuffers);
     }
 
     if (!noMoreBuffers) {
@@ -206,7 +207,7 @@ void PartitionedOutputBuffer::updateNumDrivers(uint32_t newNumDrivers) {
   }
 }
 
-void PartitionedOutputBuffer::addBroadcastOutputBuffersLocked(int numBuffers) {
+void PartitionedOutputBuffer::addOutputBuffersLocked(int numBuffers) {
   VELOX_CHECK(!noMoreBroadcastBuffers_)
   buffers_.reserve(numBuffers);
   for (auto i = buffers_.size(); i < numBuffers; i++) {
@@ -214,13 +215,48 @@ void PartitionedOutputBuffer::addBroadcastOutputBuffersLocked(int numBuffers) {
     for (const auto& data : dataToBroadcast_) {
       buffer->enqueue(data);
     }
-    if (atEnd_) {
+    // An arbitrary buffer gets its end marker once all pages are taken.
+    if (atEnd_ && arbitraryPages_.empty()) {
       buffer->enqueue(nullptr);
     }
     buffers_.emplace_back(std::move(buffer));
   }
 }
 
+void PartitionedOutputBuffer::takeArbitraryPagesLocked(
+    DestinationBuffer& buffer,
+    uint64_t maxBytes) {
+  uint64_t bytes = 0;
+  while (!arbitraryPages_.empty() && bytes < maxBytes) {
+    bytes += arbitraryPages_.front()->size();
+    buffer.enqueue(std::move(arbitraryPages_.front()));
+    arbitraryPages_.pop_front();
+  }
+}
+
+void PartitionedOutputBuffer::assignArbitraryPagesLocked(
+    std::vector<DataAvailable>& dataAvailable) {
+  // Each waiting destination gets pages in turn.
+  const int numBuffers = buffers_.size();
+  for (auto i = 0; i < numBuffers && !arbitraryPages_.empty(); ++i) {
+    auto* buffer = buffers_[(nextArbitraryDestination_ + i) % numBuffers].get();
+    if (buffer && buffer->waitingForData()) {
+      takeArbitraryPagesLocked(*buffer, buffer->notifyMaxBytes());
+      dataAvailable.push_back(buffer->getAndClearNotify());
+      nextArbitraryDestination_ =
+          (nextArbitraryDestination_ + i + 1) % numBuffers;
+    }
+  }
+  if (atEnd_ && arbitraryPages_.empty()) {
+    for (auto& buffer : buffers_) {
+      if (buffer) {
+        buffer->enqueue(nullptr);
+        dataAvailable.push_back(buffer->getAndClearNotify());
+      }
+    }
+  }
+}
+
 BlockingReason PartitionedOutputBuffer::enqueue(
     int destination,
     std::unique_ptr<SerializedPage> data,
@@ -247,6 +283,9 @@ BlockingReason PartitionedOutputBuffer::enqueue(
       if (!noMoreBroadcastBuffers_) {
         dataToBroadcast_.emplace_back(sharedData);
       }
+    } else if (arbitrary_) {
+      arbitraryPages_.push_back(std::move(data));
+      assignArbitraryPagesLocked(dataAvailableCallbacks);
     } else {
       if (auto buffer = buffers_[destination].get()) {
         buffer->enqueue(std::move(data));
@@ -294,7 +333,9 @@ void PartitionedOutputBuffer::checkIfDone(bool oneDriverFinished) {
         numDrivers_,
         "Each driver should call noMoreData exactly once");
     atEnd_ = numFinished_ == numDrivers_;
-    if (atEnd_) {
+    if (atEnd_ && arbitrary_) {
+      assignArbitraryPagesLocked(finished);
+    } else if (atEnd_) {
       for (auto& buffer : buffers_) {
         if (buffer) {
           buffer->enqueue(nullptr);
@@ -316,7 +357,7 @@ bool PartitionedOutputBuffer::isFinished() {
 }
 
 bool PartitionedOutputBuffer::isFinishedLocked() {
-  if (broadcast_ && !noMoreBroadcastBuffers_) {
+  if ((broadcast_ || arbitrary_) && !noMoreBroadcastBuffers_) {
     return false;
   }
   for (auto& buffer : buffers_) {
@@ -413,11 +454,12 @@ void PartitionedOutputBuffer::getData(
   std::vector<std::unique_ptr<folly::IOBuf>> data;
   std::vector<std::shared_ptr<SerializedPage>> freed;
   std::vector<ContinuePromise> promises;
+  std::vector<DataAvailable> dataAvailable;
   {
     std::lock_guard<std::mutex> l(mutex_);
 
-    if (broadcast_ && destination >= buffers_.size()) {
-      addBroadcastOutputBuffersLocked(destination + 1);
+    if ((broadcast_ || arbitrary_) && destination >= buffers_.size()) {
+      addOutputBuffersLocked(destination + 1);
     }
 
     VELOX_CHECK_LT(destination, buffers_.size());
@@ -429,9 +471,20 @@ void PartitionedOutputBuffer::getData(
         sequence);
     freed = destinationBuffer->acknowledge(sequence, true);
     updateAfterAcknowledgeLocked(freed, promises);
+    if (arbitrary_ && destinationBuffer->empty()) {
+      // The destination has consumed all the pages it has taken before.
+      takeArbitraryPagesLocked(*destinationBuffer, maxBytes);
+      if (atEnd_ && arbitraryPages_.empty()) {
+        assignArbitraryPagesLocked(dataAvailable);
+      }
+    }
     data = destinationBuffer->getData(maxBytes, sequence, notify);
   }
   releaseAfterAcknowledge(freed, promises);
+  // The end markers for the other destinations.
+  for (auto& other : dataAvailable) {
+    other.notify();
+  }
   if (!data.empty()) {
     notify(std::move(data), sequence);
   }
@@ -548,7 +601,7 @@ void PartitionedOutputBufferManager::getData(
 
 void PartitionedOutputBufferManager::initializeTask(
     std::shared_ptr<Task> task,
-    bool broadcast,
+    core::PartitionedOutputNode::Kind kind,
     int numDestinations,
     int numDrivers) {
   const auto& taskId = task->taskId();
@@ -557,7 +610,7 @@ void PartitionedOutputBufferManager::initializeTask(
     auto it = buffers.find(taskId);
     if (it == buffers.end()) {
       buffers[taskId] = std::make_shared<PartitionedOutputBuffer>(
-          std::move(task), broadcast, numDestinations, numDrivers);
+          std::move(task), kind, numDestinations, numDrivers);
     } else {
       VELOX_FAIL(
           "Registering an output buffer for pre-existing taskId {}", taskId);
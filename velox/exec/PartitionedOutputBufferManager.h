@@ -72,6 +72,22 @@ class DestinationBuffer {
   // the callback.
   DataAvailable getAndClearNotify();
 
+  // Returns true if the consumer waits for data, i.e. a notify callback is
+  // installed.
+  bool waitingForData() const {
+    return notify_ != nullptr;
+  }
+
+  // Returns the bytes the waiting consumer asked for.
+  uint64_t notifyMaxBytes() const {
+    return notifyMaxBytes_;
+  }
+
+  // Returns true if there is no data that is not acknowledged.
+  bool empty() const {
+    return data_.empty();
+  }
+
   std::string toString();
 
  private:
@@ -88,13 +104,13 @@ class PartitionedOutputBuffer {
  public:
   PartitionedOutputBuffer(
       std::shared_ptr<Task> task,
-      bool broadcast,
+      core::PartitionedOutputNode::Kind kind,
       int numDestinations,
       uint32_t numDrivers);
 
-  /// The total number of broadcast buffers may not be known at the task start
-  /// time. This method can be called to update the total number of broadcast
-  /// destinations while the task is running.
+  /// The total number of broadcast or arbitrary buffers may not be known at
+  /// the task start time. This method can be called to update the total
+  /// number of destinations while the task is running.
   void updateBroadcastOutputBuffers(int numBuffers, bool noMoreBuffers);
 
   /// When we understand the final number of split groups (for grouped execution
@@ -150,12 +166,24 @@ class PartitionedOutputBuffer {
       const std::vector<std::shared_ptr<SerializedPage>>& freed,
       std::vector<ContinuePromise>& promises);
 
-  /// Given an updated total number of broadcast buffers, add any missing ones
-  /// and enqueue data that has been produced so far (e.g. dataToBroadcast_).
-  void addBroadcastOutputBuffersLocked(int numBuffers);
+  /// Given an updated total number of broadcast or arbitrary buffers, add any
+  /// missing ones and enqueue data that has been produced so far (e.g.
+  /// dataToBroadcast_).
+  void addOutputBuffersLocked(int numBuffers);
+
+  // Moves pages of 'arbitraryPages_' to 'buffer' until at least 'maxBytes'
+  // are moved or no pages are left.
+  void takeArbitraryPagesLocked(DestinationBuffer& buffer, uint64_t maxBytes);
+
+  // Gives pages of 'arbitraryPages_' to the destinations that wait for data
+  // and, after no more data, adds the end markers once all pages are taken.
+  // Returns the notifications to send to the destinations in 'dataAvailable'.
+  void assignArbitraryPagesLocked(std::vector<DataAvailable>& dataAvailable);
 
   const std::shared_ptr<Task> task_;
   const bool broadcast_;
+  // If true, each page goes to the first destination that asks for data.
+  const bool arbitrary_;
   /// Total number of drivers expected to produce results. This number will
   /// decrease in the end of grouped execution, when we understand the real
   /// number of producer drivers (depending on the number of split groups).
@@ -173,6 +201,12 @@ class PartitionedOutputBuffer {
   // after receiving no-more-broadcast-buffers signal.
   std::vector<std::shared_ptr<SerializedPage>> dataToBroadcast_;
 
+  // The pages of an arbitrary buffer that no destination has taken yet.
+  std::deque<std::shared_ptr<SerializedPage>> arbitraryPages_;
+  // The destination that gets the next page of 'arbitraryPages_' when
+  // several destinations wait for data.
+  int nextArbitraryDestination_{0};
+
   std::mutex mutex_;
   // Actual data size in 'buffers_'.
   uint64_t totalSize_ = 0;
@@ -189,7 +223,7 @@ class PartitionedOutputBufferManager {
  public:
   void initializeTask(
       std::shared_ptr<Task> task,
-      bool broadcast,
+      core::PartitionedOutputNode::Kind kind,
       int numDestinations,
       int numDrivers);
 
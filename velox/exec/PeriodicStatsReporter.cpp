@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/PeriodicStatsReporter.h"
+
+#include "velox/common/base/StatsReporter.h"
+#include "velox/common/caching/SsdCache.h"
+#include "velox/common/memory/MmapAllocator.h"
+#include "velox/exec/Counters.h"
+#include "velox/exec/Driver.h"
+
+namespace facebook::velox::exec {
+
+PeriodicStatsReporter::PeriodicStatsReporter(const Options& options)
+    : options_(options) {
+  VELOX_CHECK_GT(options_.intervalMs, 0);
+}
+
+PeriodicStatsReporter::~PeriodicStatsReporter() {
+  stop();
+}
+
+void PeriodicStatsReporter::start() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!running_, "PeriodicStatsReporter already started");
+  running_ = true;
+  thread_ = std::thread([this]() {
+    std::unique_lock<std::mutex> l(mutex_);
+    while (running_) {
+      if (stopped_.wait_for(
+              l, std::chrono::milliseconds(options_.intervalMs), [&]() {
+                return !running_;
+              })) {
+        break;
+      }
+      l.unlock();
+      report();
+      l.lock();
+    }
+  });
+}
+
+void PeriodicStatsReporter::stop() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+  }
+  stopped_.notify_all();
+  thread_.join();
+}
+
+void PeriodicStatsReporter::report() {
+  if (options_.cache) {
+    reportCache();
+  }
+  if (options_.allocator) {
+    reportAllocator();
+  }
+  REPORT_ADD_STAT_VALUE(
+      kCounterDriverNumBlocked, BlockingState::numBlockedDrivers());
+}
+
+void PeriodicStatsReporter::reportCache() {
+  const auto stats = options_.cache->refreshStats();
+  REPORT_ADD_STAT_VALUE(
+      kCounterCacheNumHit, stats.numHit - lastCacheStats_.numHit);
+  REPORT_ADD_STAT_VALUE(
+      kCounterCacheNumNew, stats.numNew - lastCacheStats_.numNew);
+  REPORT_ADD_STAT_VALUE(
+      kCounterCacheNumEvict, stats.numEvict - lastCacheStats_.numEvict);
+  REPORT_ADD_STAT_VALUE(kCounterCacheBytes, stats.tinySize + stats.largeSize);
+  REPORT_ADD_STAT_VALUE(kCounterCacheNumEntries, stats.numEntries);
+  lastCacheStats_ = stats;
+
+  if (auto* ssdCache = options_.cache->ssdCache()) {
+    const auto ssdStats = ssdCache->stats();
+    REPORT_ADD_STAT_VALUE(
+        kCounterSsdBytesRead, ssdStats.bytesRead - lastSsdStats_.bytesRead);
+    REPORT_ADD_STAT_VALUE(
+        kCounterSsdBytesWritten,
+        ssdStats.bytesWritten - lastSsdStats_.bytesWritten);
+    REPORT_ADD_STAT_VALUE(
+        kCounterSsdEntriesRead,
+        ssdStats.entriesRead - lastSsdStats_.entriesRead);
+    REPORT_ADD_STAT_VALUE(
+        kCounterSsdEntriesWritten,
+        ssdStats.entriesWritten - lastSsdStats_.entriesWritten);
+    lastSsdStats_ = ssdStats;
+  }
+}
+
+void PeriodicStatsReporter::reportAllocator() {
+  constexpr auto kPageSize = memory::MappedMemory::kPageSize;
+  const auto* allocator = options_.allocator;
+  REPORT_ADD_STAT_VALUE(
+      kCounterMemoryAllocatedBytes, allocator->numAllocated() * kPageSize);
+  REPORT_ADD_STAT_VALUE(
+      kCounterMemoryMappedBytes, allocator->numMapped() * kPageSize);
+  if (auto* mmap = dynamic_cast<const memory::MmapAllocator*>(allocator)) {
+    REPORT_ADD_STAT_VALUE(
+        kCounterMemoryExternalMappedBytes,
+        mmap->numExternalMapped() * kPageSize);
+  }
+
+  const auto stats = allocator->stats();
+  const auto delta = stats - lastAllocatorStats_;
+  REPORT_ADD_STAT_VALUE(kCounterMemoryNumAdvisedPages, delta.numAdvise);
+  REPORT_ADD_STAT_VALUE(
+      kCounterMemoryNumAdvisedHugePages, delta.numAdvisedHugePages);
+  for (const auto& size : delta.sizes) {
+    if (size.numAllocations > 0) {
+      REPORT_ADD_STAT_VALUE(
+          kCounterMemoryNumAllocationsPrefix + std::to_string(size.size),
+          size.numAllocations);
+    }
+  }
+  lastAllocatorStats_ = stats;
+}
+
+} // namespace facebook::velox::exec
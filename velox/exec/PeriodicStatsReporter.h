@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/memory/MappedMemory.h"
+
+namespace facebook::velox::exec {
+
+/// Reports the process-wide stats of the memory allocator, the cache and the
+/// Drivers through StatsReporter every 'intervalMs' on a thread of its own.
+/// Cumulative stats, e.g. cache hits, are reported as their change since the
+/// previous report. Gauges, e.g. the allocated bytes, are reported as their
+/// current value. See Counters.h for the keys.
+class PeriodicStatsReporter {
+ public:
+  struct Options {
+    /// The allocator whose usage is reported. Not reported if nullptr.
+    const memory::MappedMemory* allocator{nullptr};
+
+    /// The cache whose stats are reported. Not reported if nullptr.
+    const cache::AsyncDataCache* cache{nullptr};
+
+    uint64_t intervalMs{60'000};
+  };
+
+  explicit PeriodicStatsReporter(const Options& options);
+
+  /// Stops the reporting thread if running.
+  ~PeriodicStatsReporter();
+
+  /// Starts the reporting thread.
+  void start();
+
+  /// Stops the reporting thread after the current report, if any.
+  void stop();
+
+  /// Reports the stats once. Called every 'intervalMs' by the reporting
+  /// thread. Public for testing.
+  void report();
+
+ private:
+  void reportCache();
+
+  void reportAllocator();
+
+  const Options options_;
+
+  std::mutex mutex_;
+  std::condition_variable stopped_;
+  bool running_{false};
+  std::thread thread_;
+
+  // The cumulative stats at the previous report.
+  cache::CacheStats lastCacheStats_;
+  cache::SsdCacheStats lastSsdStats_;
+  memory::Stats lastAllocatorStats_;
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+
+#include <folly/lang/Bits.h>
+
+namespace facebook::velox::exec {
+namespace {
+
+// Describes how a sort key is encoded in the prefix.
+struct PrefixKey {
+  RowColumn column;
+  TypeKind kind;
+  CompareFlags flags;
+  // Offset of the null byte of the key in the prefix. The value follows.
+  int32_t offset;
+  // Number of value bytes in the prefix.
+  int32_t size;
+  // True if the value is in the prefix in full, so that equal prefixes mean
+  // equal keys.
+  bool complete;
+};
+
+// Returns the size of the normalized value of 'kind', -1 for a variable width
+// value or 0 if the values of 'kind' are not normalized.
+int32_t normalizedSize(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+      return 1;
+    case TypeKind::SMALLINT:
+      return 2;
+    case TypeKind::INTEGER:
+    case TypeKind::REAL:
+    case TypeKind::DATE:
+      return 4;
+    case TypeKind::BIGINT:
+    case TypeKind::DOUBLE:
+      return 8;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return -1;
+    default:
+      return 0;
+  }
+}
+
+std::vector<PrefixKey> makePrefixKeys(
+    const RowContainer& container,
+    const std::vector<PrefixSort::Key>& keys) {
+  std::vector<PrefixKey> prefixKeys;
+  int32_t offset = 0;
+  for (const auto& [column, flags] : keys) {
+    const auto kind = container.columnTypes()[column]->kind();
+    const auto size = normalizedSize(kind);
+    // Space for the value after the null byte.
+    const auto available = PrefixSort::kPrefixBytes - offset - 1;
+    if (size == 0 || available <= 0) {
+      break;
+    }
+    const bool complete = size > 0 && size <= available;
+    const auto encodedSize = complete ? size : available;
+    prefixKeys.push_back(
+        {container.columnAt(column),
+         kind,
+         flags,
+         offset,
+         encodedSize,
+         complete});
+    offset += 1 + encodedSize;
+    if (!complete) {
+      break;
+    }
+  }
+  return prefixKeys;
+}
+
+// Writes the 'size' most significant bytes of 'value' to 'out', most
+// significant first.
+template <typename U>
+inline void storeBigEndian(U value, int32_t size, uint8_t* out) {
+  for (auto i = 0; i < size; ++i) {
+    out[i] = static_cast<uint8_t>(value >> (8 * (sizeof(U) - 1 - i)));
+  }
+}
+
+// Maps a signed integer to an unsigned one with the same order.
+template <typename T>
+inline std::make_unsigned_t<T> normalizeInteger(T value) {
+  using U = std::make_unsigned_t<T>;
+  return static_cast<U>(value) ^ (U(1) << (8 * sizeof(T) - 1));
+}
+
+// Maps a floating point number to an unsigned integer with the order of
+// RowContainer::compare(), where NaN is larger than any other value and -0.0
+// equals 0.0.
+template <typename T, typename U>
+inline U normalizeFloatingPoint(T value) {
+  if (std::isnan(value)) {
+    return ~U(0);
+  }
+  if (value == 0) {
+    value = 0;
+  }
+  U bits;
+  memcpy(&bits, &value, sizeof(T));
+  constexpr U kSignBit = U(1) << (8 * sizeof(T) - 1);
+  return (bits & kSignBit) ? ~bits : bits | kSignBit;
+}
+
+void encodeKey(const PrefixKey& key, const char* row, uint8_t* prefix) {
+  auto* out = prefix + key.offset;
+  if (RowContainer::isNullAt(
+          row, key.column.nullByte(), key.column.nullMask())) {
+    // Nulls have the value bytes 0, so that the next keys decide.
+    // RowContainer::compare() places nulls regardless of 'ascending'.
+    out[0] = key.flags.nullsFirst ? 0 : 2;
+    return;
+  }
+  out[0] = 1;
+  auto* value = out + 1;
+  const auto* data = row + key.column.offset();
+  switch (key.kind) {
+    case TypeKind::BOOLEAN:
+      value[0] = *reinterpret_cast<const bool*>(data) ? 1 : 0;
+      break;
+    case TypeKind::TINYINT:
+      storeBigEndian(
+          normalizeInteger(*reinterpret_cast<const int8_t*>(data)),
+          key.size,
+          value);
+      break;
+    case TypeKind::SMALLINT:
+      storeBigEndian(
+          normalizeInteger(*reinterpret_cast<const int16_t*>(data)),
+          key.size,
+          value);
+      break;
+    case TypeKind::INTEGER:
+      storeBigEndian(
+          normalizeInteger(*reinterpret_cast<const int32_t*>(data)),
+          key.size,
+          value);
+      break;
+    case TypeKind::DATE:
+      storeBigEndian(
+          normalizeInteger(reinterpret_cast<const Date*>(data)->days()),
+          key.size,
+          value);
+      break;
+    case TypeKind::BIGINT:
+      storeBigEndian(
+          normalizeInteger(*reinterpret_cast<const int64_t*>(data)),
+          key.size,
+          value);
+      break;
+    case TypeKind::REAL:
+      storeBigEndian(
+          normalizeFloatingPoint<float, uint32_t>(
+              *reinterpret_cast<const float*>(data)),
+          key.size,
+          value);
+      break;
+    case TypeKind::DOUBLE:
+      storeBigEndian(
+          normalizeFloatingPoint<double, uint64_t>(
+              *reinterpret_cast<const double*>(data)),
+          key.size,
+          value);
+      break;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY: {
+      // The bytes past the end of a short string stay 0. A string that is a
+      // prefix of another then has an equal or lower prefix.
+      std::string storage;
+      const auto view = HashStringAllocator::contiguousString(
+          *reinterpret_cast<const StringView*>(data), storage);
+      memcpy(value, view.data(), std::min<int32_t>(view.size(), key.size));
+      break;
+    }
+    default:
+      VELOX_UNREACHABLE();
+  }
+  if (!key.flags.ascending) {
+    for (auto i = 0; i < key.size; ++i) {
+      value[i] = ~value[i];
+    }
+  }
+}
+
+inline uint64_t loadBigEndian(const uint8_t* data) {
+  uint64_t word;
+  memcpy(&word, data, sizeof(word));
+  return folly::Endian::big(word);
+}
+
+} // namespace
+
+// static
+void PrefixSort::sort(
+    RowContainer& container,
+    const std::vector<Key>& keys,
+    folly::Range<char**> rows) {
+  auto lessFrom = [&](const char* left, const char* right, int32_t firstKey) {
+    for (auto i = firstKey; i < keys.size(); ++i) {
+      if (auto result =
+              container.compare(left, right, keys[i].first, keys[i].second)) {
+        return result < 0;
+      }
+    }
+    return false;
+  };
+
+  const auto prefixKeys = makePrefixKeys(container, keys);
+  if (prefixKeys.empty()) {
+    std::sort(
+        rows.begin(), rows.end(), [&](const char* left, const char* right) {
+          return lessFrom(left, right, 0);
+        });
+    return;
+  }
+  // The keys that are in the prefix in full are equal for equal prefixes.
+  int32_t numCompleteKeys = 0;
+  while (numCompleteKeys < prefixKeys.size() &&
+         prefixKeys[numCompleteKeys].complete) {
+    ++numCompleteKeys;
+  }
+
+  static_assert(kPrefixBytes == 2 * sizeof(uint64_t));
+  struct Entry {
+    // The prefix as two words that compare like the bytes.
+    uint64_t high;
+    uint64_t low;
+    char* row;
+  };
+  std::vector<Entry> entries(rows.size());
+  uint8_t prefix[kPrefixBytes];
+  for (auto i = 0; i < rows.size(); ++i) {
+    memset(prefix, 0, kPrefixBytes);
+    for (const auto& key : prefixKeys) {
+      encodeKey(key, rows[i], prefix);
+    }
+    entries[i] = {loadBigEndian(prefix), loadBigEndian(prefix + 8), rows[i]};
+  }
+  std::sort(
+      entries.begin(),
+      entries.end(),
+      [&](const Entry& left, const Entry& right) {
+        if (left.high != right.high) {
+          return left.high < right.high;
+        }
+        if (left.low != right.low) {
+          return left.low < right.low;
+        }
+        return lessFrom(left.row, right.row, numCompleteKeys);
+      });
+  for (auto i = 0; i < rows.size(); ++i) {
+    rows[i] = entries[i].row;
+  }
+}
+
+// static
+std::vector<PrefixSort::Key> PrefixSort::leadingKeys(
+    int32_t numKeys,
+    const std::vector<CompareFlags>& compareFlags) {
+  VELOX_CHECK(compareFlags.empty() || compareFlags.size() == numKeys);
+  std::vector<Key> keys;
+  keys.reserve(numKeys);
+  for (auto i = 0; i < numKeys; ++i) {
+    keys.emplace_back(
+        i, compareFlags.empty() ? CompareFlags() : compareFlags[i]);
+  }
+  return keys;
+}
+
+// static
+int32_t PrefixSort::testingNumPrefixKeys(
+    const RowContainer& container,
+    const std::vector<Key>& keys) {
+  return makePrefixKeys(container, keys).size();
+}
+
+} // namespace facebook::velox::exec
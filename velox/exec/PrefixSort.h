@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+/// Sorts rows of a RowContainer on some of its columns. The leading bytes of
+/// the sort keys of each row are first normalized into a fixed width prefix
+/// that compares like the keys with memcmp. The rows are then sorted on the
+/// prefixes and RowContainer::compare() is only called for rows with equal
+/// prefixes.
+///
+/// The prefix has a null byte per key followed by the value. Integers, dates,
+/// floating point numbers and booleans are encoded in full if they fit and
+/// strings are encoded by their leading bytes. A string or a key that is
+/// encoded in part is the last key in the prefix. Rows are sorted with
+/// RowContainer::compare() alone if the first key can't be encoded, e.g. for a
+/// complex type.
+class PrefixSort {
+ public:
+  /// Width of the prefix in bytes.
+  static constexpr int32_t kPrefixBytes = 16;
+
+  /// A sort key: the index of a column in the container and its order.
+  using Key = std::pair<column_index_t, CompareFlags>;
+
+  /// Sorts 'rows' of 'container' on 'keys'.
+  static void sort(
+      RowContainer& container,
+      const std::vector<Key>& keys,
+      folly::Range<char**> rows);
+
+  /// Returns the keys for sorting on the first 'numKeys' columns with
+  /// 'compareFlags'. The default CompareFlags apply if 'compareFlags' is
+  /// empty.
+  static std::vector<Key> leadingKeys(
+      int32_t numKeys,
+      const std::vector<CompareFlags>& compareFlags);
+
+  /// Returns the number of leading 'keys' encoded in the prefix, including a
+  /// last key that is encoded in part. For testing.
+  static int32_t testingNumPrefixKeys(
+      const RowContainer& container,
+      const std::vector<Key>& keys);
+};
+
+} // namespace facebook::velox::exec
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/common/memory/HashStringAllocator.h"
 #include "velox/common/memory/MappedMemory.h"
 #include "velox/exec/Aggregate.h"
@@ -503,6 +504,15 @@ class RowContainer {
     return rows_.allocatedBytes() + stringAllocator_.retainedSize();
   }
 
+  // Returns the average size of a row including its out-of-line variable
+  // length data or std::nullopt if 'this' has no rows.
+  std::optional<uint64_t> estimateRowSize() const {
+    if (numRows_ == 0) {
+      return std::nullopt;
+    }
+    return fixedRowSize_ + stringAllocator_.retainedSize() / numRows_;
+  }
+
   // Returns the number of fixed size rows that can be allocated
   // without growing the container and the number of unused bytes of
   // reserved storage for variable length data.
@@ -725,6 +735,51 @@ class RowContainer {
     }
   }
 
+  // Number of rows ahead of the copied row whose values are prefetched.
+  static constexpr int32_t kPrefetchDistance = 16;
+
+  // True if the values of type 'T' are copied out by gatherValues() when
+  // the rows are consecutive and not null.
+  template <typename T>
+  static constexpr bool isGatherable() {
+    return !std::is_same_v<T, StringView> && !std::is_same_v<T, bool>;
+  }
+
+  // Copies the values at 'offset' in the 'numRows' non-null 'rows' to
+  // 'values'. As rows are usually scattered over memory, the values some
+  // rows ahead are prefetched. 8 byte values are gathered a SIMD batch at
+  // a time.
+  template <typename T>
+  static void gatherValues(
+      const char* FOLLY_NONNULL const* FOLLY_NONNULL rows,
+      int32_t numRows,
+      int32_t offset,
+      T* FOLLY_NONNULL values) {
+    auto prefetch = [&](int32_t begin, int32_t end) {
+      for (auto i = begin; i < std::min(end, numRows); ++i) {
+        __builtin_prefetch(rows[i] + offset);
+      }
+    };
+    int32_t i = 0;
+    if constexpr (sizeof(T) == sizeof(int64_t)) {
+      using Batch = xsimd::batch<int64_t>;
+      // The addresses of the values are the row pointers plus 'offset', so
+      // the gather has 'offset' as base and the row pointers as indices.
+      auto base =
+          reinterpret_cast<const int64_t*>(static_cast<intptr_t>(offset));
+      for (; i + Batch::size <= numRows; i += Batch::size) {
+        prefetch(i + kPrefetchDistance, i + kPrefetchDistance + Batch::size);
+        simd::gather<int64_t, int64_t, 1>(
+            base, reinterpret_cast<const int64_t*>(rows + i))
+            .store_unaligned(reinterpret_cast<int64_t*>(values + i));
+      }
+    }
+    for (; i < numRows; ++i) {
+      prefetch(i + kPrefetchDistance, i + kPrefetchDistance + 1);
+      values[i] = valueAt<T>(rows[i], offset);
+    }
+  }
+
   template <bool useRowNumbers, typename T>
   static void extractValuesWithNulls(
       const char* FOLLY_NONNULL const* FOLLY_NONNULL rows,
@@ -742,6 +797,18 @@ class RowContainer {
     auto nulls = nullBuffer->asMutable<uint64_t>();
     BufferPtr valuesBuffer = result->mutableValues(maxRows);
     auto values = valuesBuffer->asMutableRange<T>();
+    if constexpr (!useRowNumbers && isGatherable<T>()) {
+      // The values of null keys and dependents are initialized, so all the
+      // values are copied and the null flags are set after.
+      if (std::find(rows, rows + numRows, nullptr) == rows + numRows) {
+        gatherValues(rows, numRows, offset, values.data() + resultOffset);
+        for (int32_t i = 0; i < numRows; ++i) {
+          bits::setNull(
+              nulls, resultOffset + i, isNullAt(rows[i], nullByte, nullMask));
+        }
+        return;
+      }
+    }
     for (int32_t i = 0; i < numRows; ++i) {
       const char* row;
       if constexpr (useRowNumbers) {
@@ -776,6 +843,16 @@ class RowContainer {
     VELOX_DCHECK_LE(maxRows, result->size());
     BufferPtr valuesBuffer = result->mutableValues(maxRows);
     auto values = valuesBuffer->asMutableRange<T>();
+    if constexpr (!useRowNumbers && isGatherable<T>()) {
+      if (std::find(rows, rows + numRows, nullptr) == rows + numRows) {
+        gatherValues(rows, numRows, offset, values.data() + resultOffset);
+        if (result->rawNulls()) {
+          bits::fillBits(
+              result->mutableRawNulls(), resultOffset, maxRows, bits::kNotNull);
+        }
+        return;
+      }
+    }
     for (int32_t i = 0; i < numRows; ++i) {
       const char* row;
       if constexpr (useRowNumbers) {
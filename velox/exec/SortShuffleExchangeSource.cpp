@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SortShuffleExchangeSource.h"
+#include "velox/common/file/FileSystems.h"
+
+namespace facebook::velox::exec {
+
+void SortShuffleExchangeSource::open() {
+  const auto indexPath = path_ + ".index";
+  auto fs = filesystems::getFileSystem(indexPath, nullptr);
+  auto indexFile = fs->openFileForRead(indexPath);
+  // The index has the start of each partition followed by the end of the
+  // last.
+  int64_t offsets[2];
+  VELOX_CHECK_LE(
+      (destination_ + 2) * sizeof(int64_t),
+      indexFile->size(),
+      "No partition {} in sort shuffle index {}",
+      destination_,
+      indexPath);
+  indexFile->pread(destination_ * sizeof(int64_t), sizeof(offsets), offsets);
+  offset_ = offsets[0];
+  end_ = offsets[1];
+
+  const auto dataPath = path_ + ".data";
+  dataFile_ = fs->openFileForRead(dataPath);
+  VELOX_CHECK_LE(end_, dataFile_->size());
+}
+
+std::vector<std::unique_ptr<SerializedPage>>
+SortShuffleExchangeSource::readPages(uint64_t maxBytes) {
+  std::vector<std::unique_ptr<SerializedPage>> pages;
+  uint64_t bytes = 0;
+  while (offset_ < end_) {
+    int32_t pageSize;
+    dataFile_->pread(offset_, sizeof(pageSize), &pageSize);
+    VELOX_CHECK_LE(offset_ + sizeof(pageSize) + pageSize, end_);
+    if (!pages.empty() && bytes + pageSize > maxBytes) {
+      break;
+    }
+    auto iobuf = folly::IOBuf::create(pageSize);
+    dataFile_->pread(
+        offset_ + sizeof(pageSize), pageSize, iobuf->writableData());
+    iobuf->append(pageSize);
+    offset_ += sizeof(pageSize) + pageSize;
+    bytes += pageSize;
+    pages.push_back(std::make_unique<SerializedPage>(std::move(iobuf), pool_));
+  }
+  return pages;
+}
+
+void SortShuffleExchangeSource::request(uint64_t maxBytes) {
+  VELOX_CHECK(requestPending_);
+  const auto requestTimeMicros = getCurrentTimeMicro();
+  std::vector<std::unique_ptr<SerializedPage>> pages;
+  std::string error;
+  try {
+    if (dataFile_ == nullptr) {
+      open();
+    }
+    pages = readPages(maxBytes);
+  } catch (const std::exception& e) {
+    error = e.what();
+  }
+
+  std::lock_guard<std::mutex> l(queue_->mutex());
+  requestPending_ = false;
+  queue_->releaseCreditLocked(maxBytes);
+  if (!error.empty()) {
+    atEnd_ = true;
+    queue_->setErrorLocked(error);
+    return;
+  }
+  recordResponseLocked(requestTimeMicros, pages);
+  for (auto& page : pages) {
+    queue_->enqueue(std::move(page));
+  }
+  if (offset_ >= end_) {
+    queue_->enqueue(nullptr);
+    atEnd_ = true;
+    dataFile_.reset();
+  }
+}
+
+namespace {
+std::unique_ptr<ExchangeSource> createSortShuffleExchangeSource(
+    const std::string& taskId,
+    int destination,
+    std::shared_ptr<ExchangeQueue> queue,
+    memory::MemoryPool* FOLLY_NONNULL pool) {
+  if (strncmp(
+          taskId.c_str(),
+          SortShuffleExchangeSource::kPrefix,
+          strlen(SortShuffleExchangeSource::kPrefix)) == 0) {
+    return std::make_unique<SortShuffleExchangeSource>(
+        taskId, destination, std::move(queue), pool);
+  }
+  return nullptr;
+}
+} // namespace
+
+VELOX_REGISTER_EXCHANGE_SOURCE_METHOD_DEFINITION(
+    SortShuffleExchangeSource,
+    createSortShuffleExchangeSource);
+
+} // namespace facebook::velox::exec
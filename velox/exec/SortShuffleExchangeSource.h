@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/file/File.h"
+#include "velox/exec/Exchange.h"
+
+namespace facebook::velox::exec {
+
+/// Reads the pages of a partition from the files of a SortShuffleWriter.
+/// The task id is "sortshuffle://<path>" for the files of
+/// core::SortShuffleWriteNode with 'path' and the destination is the
+/// partition. The pages are read on the thread that calls request().
+class SortShuffleExchangeSource : public ExchangeSource {
+ public:
+  static constexpr const char* kPrefix = "sortshuffle://";
+
+  SortShuffleExchangeSource(
+      const std::string& taskId,
+      int destination,
+      std::shared_ptr<ExchangeQueue> queue,
+      memory::MemoryPool* FOLLY_NONNULL pool)
+      : ExchangeSource(taskId, destination, std::move(queue), pool),
+        path_(taskId.substr(strlen(kPrefix))) {}
+
+  bool shouldRequestLocked() override {
+    if (atEnd_) {
+      return false;
+    }
+    return !requestPending_.exchange(true);
+  }
+
+  void request(uint64_t maxBytes) override;
+
+  void close() override {
+    dataFile_.reset();
+  }
+
+  /// Registers the factory of 'this'. The factory makes a source for task
+  /// ids that start with kPrefix.
+  static void registerFactory();
+
+ private:
+  // Reads the offsets of the partition from the index.
+  void open();
+
+  // Reads the pages from 'offset_' up to 'maxBytes' or at least one page.
+  std::vector<std::unique_ptr<SerializedPage>> readPages(uint64_t maxBytes);
+
+  const std::string path_;
+  std::unique_ptr<ReadFile> dataFile_;
+  // Offset of the next page of the partition in the data file.
+  uint64_t offset_{0};
+  // End of the partition in the data file.
+  uint64_t end_{0};
+};
+
+} // namespace facebook::velox::exec
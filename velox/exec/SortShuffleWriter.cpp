@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SortShuffleWriter.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/PrefixSort.h"
+#include "velox/exec/Task.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+
+SortShuffleWriter::SortShuffleWriter(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::SortShuffleWriteNode>& planNode)
+    : Operator(
+          driverCtx,
+          planNode->outputType(),
+          operatorId,
+          planNode->id(),
+          "SortShuffleWrite"),
+      numPartitions_(planNode->numPartitions()),
+      partitionFunction_(
+          numPartitions_ == 1
+              ? nullptr
+              : planNode->partitionFunctionFactory()(numPartitions_)),
+      path_(planNode->path()),
+      mappedMemory_(operatorCtx_->mappedMemory()),
+      serdeOptions_(makeExchangeSerdeOptions(driverCtx->queryConfig())),
+      spillConfig_(makeOperatorSpillConfig(
+          *operatorCtx_->task()->queryCtx(),
+          *operatorCtx_,
+          core::QueryConfig::kSortShuffleSpillEnabled,
+          core::QueryConfig::kSortShuffleSpillCompressionCodec,
+          operatorId)),
+      partitionOffsets_(numPartitions_ + 1, 0) {
+  std::vector<std::string> names{"partition"};
+  std::vector<TypePtr> types{INTEGER()};
+  for (auto i = 0; i < outputType_->size(); ++i) {
+    names.push_back(outputType_->nameOf(i));
+    types.push_back(outputType_->childAt(i));
+  }
+  data_ = std::make_unique<RowContainer>(
+      std::vector<TypePtr>{INTEGER()},
+      outputType_->children(),
+      operatorCtx_->mappedMemory());
+  internalStoreType_ = ROW(std::move(names), std::move(types));
+  batchSize_ = std::max<uint32_t>(
+      driverCtx->queryConfig().preferredOutputBatchSize(),
+      data_->estimatedNumRowsPerBatch(kBatchSizeInBytes));
+}
+
+void SortShuffleWriter::addInput(RowVectorPtr input) {
+  // TODO Report outputBytes as bytes after serialization
+  stats_.outputBytes += input->retainedSize();
+  stats_.outputPositions += input->size();
+
+  ensureInputFits(input);
+
+  const auto numInput = input->size();
+  if (partitionFunction_ != nullptr) {
+    partitionFunction_->partition(*input, partitions_);
+  } else {
+    partitions_.assign(numInput, 0);
+  }
+  auto partitionVector =
+      BaseVector::create<FlatVector<int32_t>>(INTEGER(), numInput, pool());
+  for (auto i = 0; i < numInput; ++i) {
+    partitionVector->set(i, partitions_[i]);
+  }
+
+  newRows_.resize(numInput);
+  for (auto i = 0; i < numInput; ++i) {
+    newRows_[i] = data_->newRow();
+  }
+  SelectivityVector allRows(numInput);
+  DecodedVector decoded(*partitionVector, allRows);
+  for (auto i = 0; i < numInput; ++i) {
+    data_->store(decoded, i, newRows_[i], 0);
+  }
+  for (auto column = 0; column < input->childrenSize(); ++column) {
+    decoded.decode(*input->childAt(column), allRows);
+    for (auto i = 0; i < numInput; ++i) {
+      data_->store(decoded, i, newRows_[i], column + 1);
+    }
+  }
+  numRows_ += numInput;
+  updateSpillStats();
+}
+
+void SortShuffleWriter::ensureInputFits(const RowVectorPtr& input) {
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    return;
+  }
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t outOfLineBytesPerRow = outOfLineBytes / numRows;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    const int64_t rowsToSpill = std::max<int64_t>(1, numRows / 10);
+    spill(
+        numRows - rowsToSpill,
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    return;
+  }
+
+  auto tracker = mappedMemory_->tracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->getCurrentUserBytes();
+  const int64_t incrementBytes =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0);
+  if (tracker->getAvailableReservation() > 2 * incrementBytes) {
+    return;
+  }
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  // The Task may spill another operator that holds more memory, or 'this'.
+  if (operatorCtx_->reclaimFromTask(targetIncrementBytes) &&
+      (data_->numRows() < numRows ||
+       tracker->maybeReserve(targetIncrementBytes))) {
+    return;
+  }
+  const int64_t rowsToSpill = std::max<int64_t>(
+      1, targetIncrementBytes / (data_->fixedRowSize() + outOfLineBytesPerRow));
+  spill(
+      std::max<int64_t>(0, numRows - rowsToSpill),
+      std::max<int64_t>(
+          0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+}
+
+int64_t SortShuffleWriter::reclaimableBytes() const {
+  if (!spillConfig_.has_value() || noMoreInput_ || data_->numRows() == 0) {
+    return 0;
+  }
+  return data_->allocatedBytes();
+}
+
+void SortShuffleWriter::reclaim() {
+  spill(0, 0);
+}
+
+void SortShuffleWriter::spill(int64_t targetRows, int64_t targetBytes) {
+  VELOX_CHECK_GE(targetRows, 0);
+  VELOX_CHECK_GE(targetBytes, 0);
+
+  if (spiller_ == nullptr) {
+    VELOX_DCHECK(mappedMemory_->tracker() != nullptr);
+    const auto& spillConfig = spillConfig_.value();
+    const auto spillFileSize = mappedMemory_->tracker()->getCurrentUserBytes() *
+        spillConfig.fileSizeFactor;
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kOrderBy,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        internalStoreType_,
+        1,
+        std::vector<CompareFlags>{CompareFlags{}},
+        spillConfig.filePath,
+        spillFileSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.writeOptions);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  spiller_->spill(targetRows, targetBytes);
+}
+
+void SortShuffleWriter::updateSpillStats() {
+  if (spiller_ == nullptr) {
+    return;
+  }
+  const auto stats = spiller_->stats();
+  stats_.spilledBytes = stats.spilledBytes;
+  stats_.spilledRows = stats.spilledRows;
+  stats_.spilledPartitions = stats.spilledPartitions;
+  stats_.spilledUncompressedBytes = stats.spilledUncompressedBytes;
+  stats_.spilledFiles = stats.spilledFiles;
+  stats_.spillWriteTimeUs = stats.spillWriteTimeUs;
+  stats_.spillReadTimeUs = stats.spillReadTimeUs;
+  stats_.spillPeakDiskBytes = operatorCtx_->spillDiskTracker().peakBytes();
+}
+
+BlockingReason SortShuffleWriter::isBlocked(ContinueFuture* future) {
+  // Takes no more input while the spill files of the query are over budget.
+  if (spillConfig_.has_value() && !noMoreInput_ &&
+      operatorCtx_->waitForSpillDisk(future)) {
+    return BlockingReason::kWaitForSpill;
+  }
+  return BlockingReason::kNotBlocked;
+}
+
+void SortShuffleWriter::noMoreInput() {
+  Operator::noMoreInput();
+  if (spiller_ == nullptr) {
+    VELOX_CHECK_EQ(numRows_, data_->numRows());
+    sortedRows_.resize(numRows_);
+    RowContainerIterator iter;
+    data_->listRows(&iter, numRows_, sortedRows_.data());
+    PrefixSort::sort(
+        *data_,
+        PrefixSort::leadingKeys(1, {}),
+        folly::Range<char**>(sortedRows_.data(), sortedRows_.size()));
+  } else {
+    // There is a single spill partition, so all rows are spilled or in the
+    // merge.
+    auto nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    spillMerge_ = spiller_->startMerge(0, spillConfig_->readOptions);
+    spillSources_.resize(batchSize_);
+    spillSourceRows_.resize(batchSize_);
+  }
+}
+
+RowVectorPtr SortShuffleWriter::getOutput() {
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+  if (numRowsWritten_ < numRows_) {
+    nextBatch();
+    writeBatch();
+    return nullptr;
+  }
+  finishFiles();
+  updateSpillStats();
+  finished_ = true;
+  return nullptr;
+}
+
+void SortShuffleWriter::nextBatch() {
+  const vector_size_t size =
+      std::min<size_t>(numRows_ - numRowsWritten_, batchSize_);
+  if (batch_ != nullptr) {
+    VectorPtr batch = std::move(batch_);
+    BaseVector::prepareForReuse(batch, size);
+    batch_ = std::static_pointer_cast<RowVector>(batch);
+  } else {
+    batch_ = std::static_pointer_cast<RowVector>(
+        BaseVector::create(internalStoreType_, size, pool()));
+  }
+  for (auto& child : batch_->children()) {
+    child->resize(size);
+  }
+
+  if (spillMerge_ == nullptr) {
+    for (auto column = 0; column < internalStoreType_->size(); ++column) {
+      data_->extractColumn(
+          sortedRows_.data() + numRowsWritten_,
+          size,
+          column,
+          batch_->childAt(column));
+    }
+    numRowsWritten_ += size;
+    return;
+  }
+
+  vector_size_t batchRow = 0;
+  vector_size_t numSources = 0;
+  bool isEndOfBatch = false;
+  while (batchRow + numSources < size) {
+    auto* stream = spillMerge_->next();
+    VELOX_CHECK_NOT_NULL(stream);
+    spillSources_[numSources] = &stream->current();
+    spillSourceRows_[numSources] = stream->currentIndex(&isEndOfBatch);
+    ++numSources;
+    if (FOLLY_UNLIKELY(isEndOfBatch)) {
+      // The rows must be copied before pop() replaces the batch of 'stream'.
+      gatherCopy(
+          batch_.get(), batchRow, numSources, spillSources_, spillSourceRows_);
+      batchRow += numSources;
+      numSources = 0;
+    }
+    stream->pop();
+  }
+  if (numSources != 0) {
+    gatherCopy(
+        batch_.get(), batchRow, numSources, spillSources_, spillSourceRows_);
+  }
+  numRowsWritten_ += size;
+}
+
+void SortShuffleWriter::writeBatch() {
+  const auto size = batch_->size();
+  const auto* partitions =
+      batch_->childAt(0)->asFlatVector<int32_t>()->rawValues();
+  std::vector<VectorPtr> columns(
+      batch_->children().begin() + 1, batch_->children().end());
+  auto rows = std::make_shared<RowVector>(
+      pool(), outputType_, nullptr, size, std::move(columns));
+
+  vector_size_t begin = 0;
+  while (begin < size) {
+    const auto partition = partitions[begin];
+    auto end = begin + 1;
+    while (end < size && partitions[end] == partition) {
+      ++end;
+    }
+    if (partition != currentPartition_) {
+      VELOX_CHECK_GT(partition, currentPartition_);
+      flushPage();
+      startPartitions(partition);
+    }
+    if (page_ == nullptr) {
+      page_ = std::make_unique<VectorStreamGroup>(mappedMemory_);
+      page_->createStreamTree(outputType_, end - begin, serdeOptions_.get());
+    }
+    IndexRange range{begin, end - begin};
+    page_->append(rows, folly::Range(&range, 1));
+    if (page_->size() >= kPageBytes) {
+      flushPage();
+    }
+    begin = end;
+  }
+}
+
+void SortShuffleWriter::flushPage() {
+  if (page_ == nullptr) {
+    return;
+  }
+  // Upper limit of message size with no columns.
+  constexpr int32_t kMinMessageSize = 128;
+  IOBufOutputStream stream(
+      *mappedMemory_,
+      nullptr,
+      std::max<int64_t>(kMinMessageSize, page_->size()));
+  page_->flush(&stream);
+  page_.reset();
+  auto iobuf = stream.getIOBuf();
+  const int32_t pageSize = iobuf->computeChainDataLength();
+  auto& file = dataFile();
+  file.append(std::string_view(
+      reinterpret_cast<const char*>(&pageSize), sizeof(pageSize)));
+  for (auto& range : *iobuf) {
+    file.append(std::string_view(
+        reinterpret_cast<const char*>(range.data()), range.size()));
+  }
+  dataBytes_ += sizeof(pageSize) + pageSize;
+}
+
+void SortShuffleWriter::startPartitions(int32_t partition) {
+  for (auto i = currentPartition_ + 1; i <= partition; ++i) {
+    partitionOffsets_[i] = dataBytes_;
+  }
+  currentPartition_ = partition;
+}
+
+void SortShuffleWriter::finishFiles() {
+  flushPage();
+  startPartitions(numPartitions_);
+  dataFile().close();
+  dataFile_.reset();
+
+  const auto indexPath = path_ + ".index";
+  auto fs = filesystems::getFileSystem(indexPath, nullptr);
+  auto indexFile = fs->openFileForWrite(indexPath);
+  indexFile->append(std::string_view(
+      reinterpret_cast<const char*>(partitionOffsets_.data()),
+      partitionOffsets_.size() * sizeof(int64_t)));
+  indexFile->close();
+}
+
+WriteFile& SortShuffleWriter::dataFile() {
+  if (dataFile_ == nullptr) {
+    const auto dataPath = path_ + ".data";
+    auto fs = filesystems::getFileSystem(dataPath, nullptr);
+    dataFile_ = fs->openFileForWrite(dataPath);
+  }
+  return *dataFile_;
+}
+
+} // namespace facebook::velox::exec
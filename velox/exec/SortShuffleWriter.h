@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/file/File.h"
+#include "velox/exec/Operator.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
+#include "velox/vector/VectorStream.h"
+
+namespace facebook::velox::exec {
+
+/// Writes its input to a data file sorted by partition and an index file,
+/// see core::SortShuffleWriteNode. The input rows are stored in a
+/// RowContainer with the partition number as the only key and are sorted on
+/// it after the last input, spilling like OrderBy if they do not fit. The
+/// sorted rows are then written a batch per getOutput() call as pages of
+/// the exchange serde, each preceded by its size as an int32. The index
+/// file has the offset of each partition followed by the size of the data
+/// file as int64s.
+class SortShuffleWriter : public Operator {
+ public:
+  SortShuffleWriter(
+      int32_t operatorId,
+      DriverCtx* FOLLY_NONNULL driverCtx,
+      const std::shared_ptr<const core::SortShuffleWriteNode>& planNode);
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  void noMoreInput() override;
+
+  // Writes the next batch of sorted rows and, after the last, the index.
+  // Always returns nullptr.
+  RowVectorPtr getOutput() override;
+
+  BlockingReason isBlocked(ContinueFuture* FOLLY_NONNULL future) override;
+
+  bool isFinished() override {
+    return finished_;
+  }
+
+  int64_t reclaimableBytes() const override;
+
+  void reclaim() override;
+
+ private:
+  static constexpr int32_t kBatchSizeInBytes{2 * 1024 * 1024};
+
+  // Serialized size at which a page is written to the data file.
+  static constexpr uint64_t kPageBytes{1 << 20};
+
+  // Same as OrderBy::ensureInputFits().
+  void ensureInputFits(const RowVectorPtr& input);
+
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  void updateSpillStats();
+
+  // Fills 'batch_' with the next rows in the order of their partitions.
+  void nextBatch();
+
+  // Appends the rows of 'batch_' to 'page_' a run of rows of a partition at
+  // a time, writing 'page_' when it is full or the partition changes.
+  void writeBatch();
+
+  // Writes 'page_' to the data file if not empty.
+  void flushPage();
+
+  // Sets the offsets of the partitions after 'currentPartition_' up to
+  // 'partition' to the end of the data file.
+  void startPartitions(int32_t partition);
+
+  // Writes the index file and closes the files.
+  void finishFiles();
+
+  WriteFile& dataFile();
+
+  const int32_t numPartitions_;
+  const std::unique_ptr<core::PartitionFunction> partitionFunction_;
+  const std::string path_;
+  memory::MappedMemory* FOLLY_NONNULL const mappedMemory_;
+  // Options of the pages, e.g. their compression. nullptr for the defaults.
+  const std::unique_ptr<VectorSerde::Options> serdeOptions_;
+  const std::optional<Spiller::Config> spillConfig_;
+
+  // The partition number followed by the input columns.
+  RowTypePtr internalStoreType_;
+  std::unique_ptr<RowContainer> data_;
+  std::unique_ptr<Spiller> spiller_;
+  uint64_t spillTestCounter_{0};
+
+  // Maximum number of rows in 'batch_'.
+  vector_size_t batchSize_;
+
+  size_t numRows_{0};
+  size_t numRowsWritten_{0};
+
+  // 'data_' rows sorted on partition if not spilled.
+  std::vector<char*> sortedRows_;
+
+  // Merges the spilled and unspilled rows if spilled.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
+
+  // Sorted rows of 'internalStoreType_' being written.
+  RowVectorPtr batch_;
+
+  // The rows of the partition that are not written yet.
+  std::unique_ptr<VectorStreamGroup> page_;
+
+  // The partition of the rows in 'page_' or of the last rows written, -1 at
+  // start.
+  int32_t currentPartition_{-1};
+
+  // Offset of each partition in the data file followed by its size.
+  std::vector<int64_t> partitionOffsets_;
+
+  std::unique_ptr<WriteFile> dataFile_;
+  int64_t dataBytes_{0};
+
+  // Reusable memory.
+  std::vector<uint32_t> partitions_;
+  std::vector<char*> newRows_;
+
+  bool finished_{false};
+};
+
+} // namespace facebook::velox::exec
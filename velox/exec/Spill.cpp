@@ -15,7 +15,9 @@
  */
 
 #include "velox/exec/Spill.h"
+#include <folly/hash/Checksum.h>
 #include "velox/common/file/FileSystems.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/serializers/PrestoSerializer.h"
 
 namespace facebook::velox::exec {
@@ -29,13 +31,98 @@ static const serializer::presto::PrestoVectorSerde::PrestoOptions
     kDefaultSerdeOptions(/*useLosslessTimestamp*/ true);
 
 std::atomic<int32_t> SpillFile::ordinalCounter_;
+std::atomic<uint64_t> SpillFile::localSpillBytes_;
+
+namespace {
+// Precedes each batch of a compressed spill file.
+struct SpillBatchHeader {
+  // Serialized size of the batch.
+  int32_t uncompressedSize;
+  // Size of the compressed batch that follows the header.
+  int32_t compressedSize;
+  // CRC32C of the compressed batch.
+  uint32_t checksum;
+};
+
+// Adds the microseconds from construction to destruction to 'counter' if
+// set.
+class SpillTimer {
+ public:
+  explicit SpillTimer(std::atomic<uint64_t>* counter)
+      : counter_(counter), start_(std::chrono::steady_clock::now()) {}
+
+  ~SpillTimer() {
+    if (counter_ != nullptr) {
+      *counter_ += std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - start_)
+                       .count();
+    }
+  }
+
+ private:
+  std::atomic<uint64_t>* const counter_;
+  const std::chrono::steady_clock::time_point start_;
+};
+} // namespace
+
+folly::io::CodecType spillCompressionKindFromString(const std::string& name) {
+  static const std::unordered_map<std::string, folly::io::CodecType> kCodecs = {
+      {"none", folly::io::CodecType::NO_COMPRESSION},
+      {"lz4", folly::io::CodecType::LZ4},
+      {"zstd", folly::io::CodecType::ZSTD},
+      {"snappy", folly::io::CodecType::SNAPPY},
+      {"zlib", folly::io::CodecType::ZLIB},
+  };
+  auto it = kCodecs.find(name);
+  VELOX_USER_CHECK(
+      it != kCodecs.end(), "Unknown spill compression codec: {}", name);
+  return it->second;
+}
+
+SpillInput::~SpillInput() {
+  try {
+    waitForReadAhead();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Error reading ahead spill file: " << e.what();
+  }
+}
 
 void SpillInput::next(bool /*throwIfPastEnd*/) {
-  int32_t readBytes = std::min(input_->size() - offset_, buffer_->capacity());
+  int32_t readBytes = std::min(size_ - offset_, readSize_);
   VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
+  if (readAhead_ != nullptr) {
+    // 'readAheadBuffer_' gets the range at 'offset_'.
+    waitForReadAhead();
+    std::swap(buffer_, readAheadBuffer_);
+  } else {
+    input_->pread(offset_, readBytes, buffer_->asMutable<char>());
+  }
   setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
-  input_->pread(offset_, readBytes, buffer_->asMutable<char>());
   offset_ += readBytes;
+  startReadAhead();
+}
+
+void SpillInput::startReadAhead() {
+  if (readAheadExecutor_ == nullptr || offset_ >= size_) {
+    return;
+  }
+  const auto offset = offset_;
+  const auto readBytes = std::min(size_ - offset, readSize_);
+  readAhead_ = std::make_shared<AsyncSource<folly::Unit>>(
+      [this, offset, readBytes]() {
+        input_->pread(offset, readBytes, readAheadBuffer_->asMutable<char>());
+        return std::make_unique<folly::Unit>();
+      });
+  readAheadExecutor_->add(
+      [readAhead = readAhead_]() { readAhead->prepare(); });
+}
+
+void SpillInput::waitForReadAhead() {
+  if (readAhead_ == nullptr) {
+    return;
+  }
+  auto readAhead = std::move(readAhead_);
+  readAhead->move();
 }
 
 void SpillMergeStream::pop() {
@@ -44,7 +131,32 @@ void SpillMergeStream::pop() {
   }
 }
 
+void SpillMergeStream::pop(vector_size_t numRows) {
+  VELOX_DCHECK_GT(numRows, 0);
+  VELOX_DCHECK_LE(index_ + numRows, size_);
+  index_ += numRows;
+  if (index_ >= size_) {
+    setNextBatch();
+  }
+}
+
+vector_size_t SpillMergeStream::runSize(
+    const SpillMergeStream* other,
+    vector_size_t maxRows) const {
+  const auto numRows = std::min<vector_size_t>(maxRows, size_ - index_);
+  if (other == nullptr) {
+    return numRows;
+  }
+  return gallopingRunSize<vector_size_t>(numRows, [&](vector_size_t offset) {
+    return compareRow(index_ + offset, *other) <= 0;
+  });
+}
+
 SpillFile::~SpillFile() {
+  localSpillBytes_ -= localBytes_;
+  if (diskBytes_ > 0) {
+    diskTracker_->update(diskHolder_, -static_cast<int64_t>(diskBytes_));
+  }
   try {
     auto fs = filesystems::getFileSystem(path_, nullptr);
     fs->remove(path_);
@@ -61,58 +173,253 @@ WriteFile& SpillFile::output() {
   return *output_;
 }
 
-void SpillFile::startRead() {
-  constexpr uint64_t kMaxReadBufferSize =
-      (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
-  VELOX_CHECK(!output_);
+void SpillFile::append(std::string_view data) {
+  if (writeBufferSize_ == 0) {
+    output().append(data);
+  } else {
+    if (writeBuffer_.empty()) {
+      writeBuffer_.reserve(writeBufferSize_);
+    }
+    writeBuffer_.append(data);
+    if (writeBuffer_.size() >= writeBufferSize_) {
+      flushWriteBuffer();
+    }
+  }
+  updateDiskBytes();
+}
+
+void SpillFile::updateDiskBytes() {
+  if (diskTracker_ == nullptr) {
+    return;
+  }
+  const auto bytes = size();
+  if (bytes != diskBytes_) {
+    diskTracker_->update(
+        diskHolder_,
+        static_cast<int64_t>(bytes) - static_cast<int64_t>(diskBytes_));
+    diskBytes_ = bytes;
+  }
+}
+
+void SpillFile::flushWriteBuffer() {
+  if (!writeBuffer_.empty()) {
+    output().append(writeBuffer_);
+    writeBuffer_.clear();
+  }
+}
+
+void SpillFile::finishWrite() {
+  VELOX_CHECK(output_);
+  flushWriteBuffer();
+  std::string().swap(writeBuffer_);
+  fileSize_ = output_->size();
+  // Completes the upload of a file on a remote file system.
+  output_->close();
+  output_ = nullptr;
+  updateDiskBytes();
+  if (localBytes_ > 0) {
+    // Keeps the reservation of the local spill directory to the actual size.
+    localSpillBytes_ += fileSize_;
+    localSpillBytes_ -= localBytes_;
+    localBytes_ = fileSize_;
+  }
+}
+
+bool SpillFile::tryReserveLocalBytes(uint64_t bytes, uint64_t maxBytes) {
+  auto current = localSpillBytes_.load();
+  do {
+    if (current + bytes > maxBytes) {
+      return false;
+    }
+  } while (!localSpillBytes_.compare_exchange_weak(current, current + bytes));
+  return true;
+}
+
+void SpillFile::startRead(const SpillReadOptions& readOptions) {
   VELOX_CHECK(!input_);
+  input_ = openInput(pool_, readOptions);
+}
+
+bool SpillFile::nextBatch(RowVectorPtr& rowVector) {
+  return readBatch(*input_, pool_, rowVector);
+}
+
+std::unique_ptr<SpillInput> SpillFile::openInput(
+    memory::MemoryPool& pool,
+    const SpillReadOptions& readOptions) const {
+  VELOX_CHECK(!output_);
+  VELOX_CHECK_GT(readOptions.readBufferSize, 0);
   auto fs = filesystems::getFileSystem(path_, nullptr);
   auto file = fs->openFileForRead(path_);
-  auto buffer = AlignedBuffer::allocate<char>(
-      std::min<uint64_t>(fileSize_, kMaxReadBufferSize), &pool_);
-  input_ = std::make_unique<SpillInput>(std::move(file), std::move(buffer));
+  const auto bufferSize =
+      std::min<uint64_t>(fileSize_, readOptions.readBufferSize);
+  auto buffer = AlignedBuffer::allocate<char>(bufferSize, &pool);
+  // Reads ahead only if the file does not fit in one buffer.
+  if (readOptions.readAheadExecutor == nullptr || fileSize_ <= bufferSize) {
+    return std::make_unique<SpillInput>(std::move(file), std::move(buffer));
+  }
+  auto readAheadBuffer =
+      AlignedBuffer::allocate<char>(buffer->capacity(), &pool);
+  return std::make_unique<SpillInput>(
+      std::move(file),
+      std::move(buffer),
+      readOptions.readAheadExecutor,
+      std::move(readAheadBuffer));
 }
 
-bool SpillFile::nextBatch(RowVectorPtr& rowVector) {
-  if (input_->atEnd()) {
+bool SpillFile::readBatch(
+    SpillInput& input,
+    memory::MemoryPool& pool,
+    RowVectorPtr& rowVector) const {
+  if (input.atEnd()) {
     return false;
   }
+  SpillTimer timer(ioStats_ ? &ioStats_->readTimeUs : nullptr);
+  if (compressionKind_ == folly::io::CodecType::NO_COMPRESSION) {
+    VectorStreamGroup::read(
+        &input, &pool, type_, &rowVector, &kDefaultSerdeOptions);
+    return true;
+  }
+
+  SpillBatchHeader header;
+  input.readBytes(
+      reinterpret_cast<uint8_t*>(&header), sizeof(SpillBatchHeader));
+  auto compressed = folly::IOBuf::create(header.compressedSize);
+  input.readBytes(compressed->writableData(), header.compressedSize);
+  compressed->append(header.compressedSize);
+  VELOX_CHECK_EQ(
+      folly::crc32c(compressed->data(), header.compressedSize),
+      header.checksum,
+      "Checksum mismatch in spill file {}",
+      path_);
+  // A codec is made per batch since readBatch() may run on concurrent
+  // readers.
+  auto uncompressed = folly::io::getCodec(compressionKind_)
+                          ->uncompress(compressed.get(), header.uncompressedSize);
+  std::vector<ByteRange> ranges;
+  for (const auto& range : *uncompressed) {
+    ranges.push_back(
+        {const_cast<uint8_t*>(range.data()),
+         static_cast<int32_t>(range.size()),
+         0});
+  }
+  ByteStream batchInput;
+  batchInput.resetInput(std::move(ranges));
   VectorStreamGroup::read(
-      input_.get(), &pool_, type_, &rowVector, &kDefaultSerdeOptions);
+      &batchInput, &pool, type_, &rowVector, &kDefaultSerdeOptions);
   return true;
 }
 
-WriteFile& SpillFileList::currentOutput() {
+SpillFileList::~SpillFileList() {
+  try {
+    waitForWrite();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Error writing spill file " << path_ << " : " << e.what();
+  }
+}
+
+SpillFile& SpillFileList::currentOutput() {
   if (files_.empty() || !files_.back()->isWritable() ||
       files_.back()->size() > targetFileSize_ * 1.5) {
     if (!files_.empty() && files_.back()->isWritable()) {
       files_.back()->finishWrite();
     }
+    auto localPath = tryLocalPath();
     files_.push_back(std::make_unique<SpillFile>(
         type_,
         numSortingKeys_,
         sortCompareFlags_,
-        fmt::format("{}-{}", path_, files_.size()),
-        pool_));
+        fmt::format("{}-{}", localPath.value_or(path_), files_.size()),
+        pool_,
+        compressionKind_,
+        writeOptions_,
+        localPath.has_value() ? targetFileSize_ : 0));
+    // Opens the file so that it is writable.
+    files_.back()->output();
+  }
+  return *files_.back();
+}
+
+std::optional<std::string> SpillFileList::tryLocalPath() {
+  if (writeOptions_.localPath.empty() ||
+      !SpillFile::tryReserveLocalBytes(
+          targetFileSize_, writeOptions_.localMaxBytes)) {
+    return std::nullopt;
   }
-  return files_.back()->output();
+  // The files keep their names, only the directory changes.
+  const auto slash = path_.rfind('/');
+  return fmt::format(
+      "{}/{}",
+      writeOptions_.localPath,
+      slash == std::string::npos ? path_ : path_.substr(slash + 1));
 }
 
 void SpillFileList::flush() {
   if (batch_) {
-    IOBufOutputStream out(
-        mappedMemory_, nullptr, std::max<int64_t>(64 * 1024, batch_->size()));
-    batch_->flush(&out);
-    batch_.reset();
-    auto iobuf = out.getIOBuf();
+    std::unique_ptr<folly::IOBuf> iobuf;
+    {
+      // The write of the batch by writeBatch() is timed there.
+      SpillTimer timer(
+          writeOptions_.ioStats ? &writeOptions_.ioStats->writeTimeUs
+                                : nullptr);
+      IOBufOutputStream out(
+          mappedMemory_,
+          nullptr,
+          std::max<int64_t>(64 * 1024, batch_->size()));
+      batch_->flush(&out);
+      batch_.reset();
+      iobuf = out.getIOBuf();
+    }
+    uncompressedBytes_ += iobuf->computeChainDataLength();
+    // The previous batch must be in its file before picking the file for
+    // this one.
+    waitForWrite();
     auto& file = currentOutput();
-    for (auto& range : *iobuf) {
-      file.append(std::string_view(
-          reinterpret_cast<const char*>(range.data()), range.size()));
+    if (writeExecutor_ == nullptr) {
+      writeBatch(*iobuf, file);
+      return;
     }
+    pendingWrite_ = std::make_shared<AsyncSource<folly::Unit>>(
+        [this,
+         iobuf = std::shared_ptr<folly::IOBuf>(std::move(iobuf)),
+         &file]() {
+          writeBatch(*iobuf, file);
+          return std::make_unique<folly::Unit>();
+        });
+    writeExecutor_->add([write = pendingWrite_]() { write->prepare(); });
   }
 }
 
+void SpillFileList::writeBatch(const folly::IOBuf& iobuf, SpillFile& file) {
+  SpillTimer timer(
+      writeOptions_.ioStats ? &writeOptions_.ioStats->writeTimeUs : nullptr);
+  const folly::IOBuf* data = &iobuf;
+  std::unique_ptr<folly::IOBuf> compressed;
+  if (codec_ != nullptr) {
+    compressed = codec_->compress(&iobuf);
+    compressed->coalesce();
+    SpillBatchHeader header{
+        static_cast<int32_t>(iobuf.computeChainDataLength()),
+        static_cast<int32_t>(compressed->length()),
+        folly::crc32c(compressed->data(), compressed->length())};
+    file.append(std::string_view(
+        reinterpret_cast<const char*>(&header), sizeof(SpillBatchHeader)));
+    data = compressed.get();
+  }
+  for (auto& range : *data) {
+    file.append(std::string_view(
+        reinterpret_cast<const char*>(range.data()), range.size()));
+  }
+}
+
+void SpillFileList::waitForWrite() const {
+  if (pendingWrite_ == nullptr) {
+    return;
+  }
+  auto write = std::move(pendingWrite_);
+  write->move();
+}
+
 void SpillFileList::write(
     const RowVectorPtr& rows,
     const folly::Range<IndexRange*>& indices) {
@@ -130,6 +437,7 @@ void SpillFileList::write(
 
 void SpillFileList::finishFile() {
   flush();
+  waitForWrite();
   if (files_.empty()) {
     return;
   }
@@ -139,6 +447,7 @@ void SpillFileList::finishFile() {
 }
 
 uint64_t SpillFileList::spilledBytes() const {
+  waitForWrite();
   uint64_t bytes = 0;
   for (auto& file : files_) {
     bytes += file->size();
@@ -154,6 +463,16 @@ std::vector<std::string> SpillFileList::testingSpilledFilePaths() const {
   return spilledFiles;
 }
 
+// static
+SpillWriteOptions SpillState::withIoStats(
+    const SpillWriteOptions& writeOptions) {
+  auto options = writeOptions;
+  if (options.ioStats == nullptr) {
+    options.ioStats = std::make_shared<SpillIoStats>();
+  }
+  return options;
+}
+
 void SpillState::setPartitionSpilled(int32_t partition) {
   VELOX_DCHECK_LT(partition, maxPartitions_);
   VELOX_DCHECK_LT(spilledPartitionSet_.size(), maxPartitions_);
@@ -174,7 +493,10 @@ void SpillState::appendToPartition(
         fmt::format("{}-spill-{}", path_, partition),
         targetFileSize_,
         pool_,
-        mappedMemory_);
+        mappedMemory_,
+        compressionKind_,
+        writeExecutor_,
+        writeOptions_);
   }
 
   IndexRange range{0, rows->size()};
@@ -183,12 +505,36 @@ void SpillState::appendToPartition(
 
 std::unique_ptr<TreeOfLosers<SpillMergeStream>> SpillState::startMerge(
     int32_t partition,
-    std::unique_ptr<SpillMergeStream>&& extra) {
+    std::unique_ptr<SpillMergeStream>&& extra,
+    const SpillReadOptions& readOptions) {
   VELOX_CHECK_LT(partition, files_.size());
   std::vector<std::unique_ptr<SpillMergeStream>> result;
   if (auto list = std::move(files_[partition]); list) {
-    for (auto& file : list->files()) {
-      result.push_back(FileSpillMergeStream::create(std::move(file)));
+    auto files = list->files();
+    const auto fanIn = readOptions.maxMergeFanIn;
+    if (fanIn > 0 && files.size() > fanIn) {
+      VELOX_CHECK_GE(fanIn, 2, "Spill merge fan-in must be at least 2");
+    }
+    // Each pass merges groups of 'fanIn' files into one file.
+    while (fanIn > 0 && files.size() > fanIn) {
+      SpillFiles mergedFiles;
+      for (auto i = 0; i < files.size(); i += fanIn) {
+        SpillFiles group;
+        for (auto j = i; j < std::min<size_t>(i + fanIn, files.size()); ++j) {
+          group.push_back(std::move(files[j]));
+        }
+        if (group.size() == 1) {
+          mergedFiles.push_back(std::move(group[0]));
+        } else {
+          mergedFiles.push_back(
+              mergeFiles(partition, std::move(group), readOptions));
+        }
+      }
+      files = std::move(mergedFiles);
+    }
+    for (auto& file : files) {
+      result.push_back(
+          FileSpillMergeStream::create(std::move(file), readOptions));
     }
   }
   VELOX_DCHECK_EQ(!result.empty(), isPartitionSpilled(partition));
@@ -202,6 +548,76 @@ std::unique_ptr<TreeOfLosers<SpillMergeStream>> SpillState::startMerge(
   return std::make_unique<TreeOfLosers<SpillMergeStream>>(std::move(result));
 }
 
+std::unique_ptr<SpillFile> SpillState::mergeFiles(
+    int32_t partition,
+    SpillFiles files,
+    const SpillReadOptions& readOptions) {
+  VELOX_CHECK_GT(files.size(), 1);
+  const auto type = files[0]->type();
+  std::vector<std::unique_ptr<SpillMergeStream>> streams;
+  streams.reserve(files.size());
+  for (auto& file : files) {
+    streams.push_back(
+        FileSpillMergeStream::create(std::move(file), readOptions));
+  }
+  TreeOfLosers<SpillMergeStream> merge(std::move(streams));
+
+  // The merged data goes to a single file. It is written on the caller
+  // thread since the caller waits for it anyway.
+  SpillFileList list(
+      type,
+      numSortingKeys_,
+      sortCompareFlags_,
+      fmt::format("{}-spill-{}-merge", path_, partition),
+      std::numeric_limits<uint64_t>::max(),
+      pool_,
+      mappedMemory_,
+      compressionKind_,
+      nullptr,
+      writeOptions_);
+  constexpr vector_size_t kBatchSize = 1'000;
+  std::vector<const RowVector*> sources(kBatchSize);
+  std::vector<vector_size_t> sourceRows(kBatchSize);
+  for (;;) {
+    auto output = BaseVector::create<RowVector>(type, kBatchSize, &pool_);
+    vector_size_t outputRow = 0;
+    vector_size_t outputSize = 0;
+    bool isEndOfBatch = false;
+    while (outputRow + outputSize < kBatchSize) {
+      auto* stream = merge.next();
+      if (stream == nullptr) {
+        break;
+      }
+      sources[outputSize] = &stream->current();
+      sourceRows[outputSize] = stream->currentIndex(&isEndOfBatch);
+      ++outputSize;
+      if (isEndOfBatch) {
+        // The rows must be copied out before pop() loads the next batch.
+        gatherCopy(output.get(), outputRow, outputSize, sources, sourceRows);
+        outputRow += outputSize;
+        outputSize = 0;
+      }
+      stream->pop();
+    }
+    if (outputSize != 0) {
+      gatherCopy(output.get(), outputRow, outputSize, sources, sourceRows);
+      outputRow += outputSize;
+    }
+    if (outputRow == 0) {
+      break;
+    }
+    output->resize(outputRow);
+    IndexRange range{0, outputRow};
+    list.write(output, folly::Range<IndexRange*>(&range, 1));
+    if (outputRow < kBatchSize) {
+      break;
+    }
+  }
+  auto mergedFiles = list.files();
+  VELOX_CHECK_EQ(mergedFiles.size(), 1);
+  return std::move(mergedFiles[0]);
+}
+
 SpillFiles SpillState::files(int32_t partition) {
   VELOX_CHECK_LT(partition, files_.size());
 
@@ -222,6 +638,16 @@ uint64_t SpillState::spilledBytes() const {
   return bytes;
 }
 
+uint64_t SpillState::spilledUncompressedBytes() const {
+  uint64_t bytes = 0;
+  for (auto& list : files_) {
+    if (list) {
+      bytes += list->spilledUncompressedBytes();
+    }
+  }
+  return bytes;
+}
+
 uint32_t SpillState::spilledPartitions() const {
   return spilledPartitionSet_.size();
 }
@@ -16,7 +16,11 @@
 
 #pragma once
 
+#include <folly/compression/Compression.h>
+
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/file/File.h"
+#include "velox/core/SpillDiskTracker.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/TreeOfLosers.h"
 #include "velox/exec/UnorderedStreamReader.h"
@@ -26,17 +30,87 @@
 
 namespace facebook::velox::exec {
 
+/// Returns the compression codec of spill files for the value of
+/// QueryConfig::kSpillCompressionCodec and the related options. Throws on an
+/// unknown name.
+folly::io::CodecType spillCompressionKindFromString(const std::string& name);
+
+/// Time spent on the spill files of a spilling operator. Shared by the files,
+/// which may be written on the spill executor and read after the Spiller that
+/// made them is gone.
+struct SpillIoStats {
+  /// Time spent serializing, compressing and writing the spilled batches.
+  std::atomic<uint64_t> writeTimeUs{0};
+  /// Time spent reading, decompressing and deserializing the spilled batches.
+  std::atomic<uint64_t> readTimeUs{0};
+};
+
+/// Options for where and in what chunks spill files are written. The spill
+/// path may be on any registered filesystems::FileSystem, e.g. an object
+/// store, where many small appends are costly.
+struct SpillWriteOptions {
+  /// Size of the chunks in which a spill file is written. Appends are buffered
+  /// until this many bytes so that a remote file is uploaded in few large
+  /// parts. 0 appends each batch as is.
+  uint64_t writeBufferSize{0};
+
+  /// Directory for spill files on local disk. If set, a new spill file is
+  /// written here instead of the spill path as long as the local spill files
+  /// of the process stay within 'localMaxBytes'.
+  std::string localPath;
+  uint64_t localMaxBytes{0};
+
+  /// Tracks the bytes of the spill files on disk on behalf of 'diskHolder',
+  /// e.g. the spilling operator, if set.
+  std::shared_ptr<core::SpillDiskTracker> diskTracker;
+  const void* diskHolder{nullptr};
+
+  /// Counts the time spent writing and reading the spill files if set.
+  std::shared_ptr<SpillIoStats> ioStats;
+};
+
+/// Options for reading spill files back.
+struct SpillReadOptions {
+  /// Size of the read buffer of each spill file being read.
+  uint64_t readBufferSize{1 << 20};
+
+  /// If set, the next buffer of each spill file is read on this executor
+  /// while the current one is consumed. This takes a second read buffer per
+  /// file.
+  folly::Executor* FOLLY_NULLABLE readAheadExecutor{nullptr};
+
+  /// The maximum number of spill files merged at once. If a sorted partition
+  /// has more files, they are first merged into fewer, larger files in
+  /// passes of this many files each. 0 means no limit.
+  int32_t maxMergeFanIn{0};
+};
+
 // Input stream backed by spill file.
 class SpillInput : public ByteStream {
  public:
-  // Reads from 'input' using 'buffer' for buffering reads.
-  SpillInput(std::unique_ptr<ReadFile>&& input, BufferPtr buffer)
+  // Reads from 'input' using 'buffer' for buffering reads. If
+  // 'readAheadExecutor' is set, the range after 'buffer' is read into
+  // 'readAheadBuffer' on the executor while 'buffer' is consumed.
+  SpillInput(
+      std::unique_ptr<ReadFile>&& input,
+      BufferPtr buffer,
+      folly::Executor* FOLLY_NULLABLE readAheadExecutor = nullptr,
+      BufferPtr readAheadBuffer = nullptr)
       : input_(std::move(input)),
         buffer_(std::move(buffer)),
-        size_(input_->size()) {
+        size_(input_->size()),
+        readSize_(buffer_->capacity()),
+        readAheadExecutor_(readAheadExecutor),
+        readAheadBuffer_(std::move(readAheadBuffer)) {
+    VELOX_CHECK(
+        readAheadExecutor_ == nullptr ||
+        (readAheadBuffer_ != nullptr &&
+         readAheadBuffer_->capacity() >= readSize_));
     next(true);
   }
 
+  ~SpillInput() override;
+
   void next(bool throwIfPastEnd) override;
 
   // True if all of the file has been read into vectors.
@@ -45,16 +119,42 @@ class SpillInput : public ByteStream {
   }
 
  private:
+  // Starts reading the range after 'buffer_' into 'readAheadBuffer_' on
+  // 'readAheadExecutor_' unless at end.
+  void startReadAhead();
+
+  // Waits for the read ahead if any. Rethrows its error.
+  void waitForReadAhead();
+
   std::unique_ptr<ReadFile> input_;
   BufferPtr buffer_;
   const uint64_t size_;
+  // Bytes read into a buffer at a time.
+  const uint64_t readSize_;
   // Offset of first byte not in 'buffer_'
   uint64_t offset_ = 0;
+  folly::Executor* FOLLY_NULLABLE const readAheadExecutor_;
+  BufferPtr readAheadBuffer_;
+  // The read of the range at 'offset_' into 'readAheadBuffer_'. Set while
+  // the read may be in progress.
+  std::shared_ptr<AsyncSource<folly::Unit>> readAhead_;
 };
 
 /// Represents a spill file that is first in write mode and then
 /// turns into a source of spilled RowVectors. Owns a file system file that
 /// contains the spilled data and is live for the duration of 'this'.
+///
+/// If 'compressionKind' is not NO_COMPRESSION, each serialized batch is
+/// compressed and written after a header with the sizes and a checksum of the
+/// compressed data. The checksum is verified on read.
+///
+/// If the 'writeBufferSize' of 'writeOptions' is not 0, append() buffers the
+/// data and writes it to the file in chunks of about this size. The size of
+/// the file is added to the 'diskTracker' of 'writeOptions' if set and the
+/// read time to its 'ioStats'. 'localBytes' is the space reserved for 'this'
+/// with tryReserveLocalBytes() if the file is in the local spill directory.
+/// The reservation follows the size of the file and is released when 'this'
+/// is destroyed.
 class SpillFile {
  public:
   SpillFile(
@@ -62,13 +162,23 @@ class SpillFile {
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION,
+      const SpillWriteOptions& writeOptions = {},
+      uint64_t localBytes = 0)
       : type_(std::move(type)),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         pool_(pool),
+        compressionKind_(compressionKind),
+        writeBufferSize_(writeOptions.writeBufferSize),
+        diskTracker_(writeOptions.diskTracker),
+        diskHolder_(writeOptions.diskHolder),
+        ioStats_(writeOptions.ioStats),
         ordinal_(ordinalCounter_++),
-        path_(fmt::format("{}-{}", path, ordinal_)) {
+        path_(fmt::format("{}-{}", path, ordinal_)),
+        localBytes_(localBytes) {
     // NOTE: if the spilling operator has specified the sort comparison flags,
     // then it must match the number of sorting keys.
     VELOX_CHECK(
@@ -78,6 +188,10 @@ class SpillFile {
 
   ~SpillFile();
 
+  const RowTypePtr& type() const {
+    return type_;
+  }
+
   int32_t numSortingKeys() const {
     return numSortingKeys_;
   }
@@ -93,29 +207,43 @@ class SpillFile {
   // sorted.
   WriteFile& output();
 
+  /// Appends 'data' to output(), through the write buffer if any.
+  void append(std::string_view data);
+
   bool isWritable() const {
     return output_ != nullptr;
   }
 
-  /// Finishes writing and flushes any unwritten data.
-  void finishWrite() {
-    VELOX_CHECK(output_);
-    fileSize_ = output_->size();
-    output_ = nullptr;
-  }
+  /// Finishes writing, flushes any unwritten data and closes the file.
+  void finishWrite();
 
   /// Prepares 'this' for reading. Positions the read at the first row of
   /// content. The caller must call output() and finishWrite() before this.
-  void startRead();
+  void startRead(const SpillReadOptions& readOptions = {});
 
   bool nextBatch(RowVectorPtr& rowVector);
 
+  /// Returns a new stream over the content of 'this' for reading with
+  /// readBatch(). Unlike startRead(), may be called any number of times after
+  /// finishWrite(), also from concurrent readers. 'pool' is used for the read
+  /// buffers.
+  std::unique_ptr<SpillInput> openInput(
+      memory::MemoryPool& pool,
+      const SpillReadOptions& readOptions = {}) const;
+
+  /// Reads the next RowVector from 'input' made by openInput() into
+  /// 'rowVector'. Returns false at the end of 'input'.
+  bool readBatch(
+      SpillInput& input,
+      memory::MemoryPool& pool,
+      RowVectorPtr& rowVector) const;
+
   /// Returns the file size in bytes. During the writing phase this is
   /// the current size of the file, during reading this is the final
   // size.
   uint64_t size() const {
     if (output_) {
-      return output_->size();
+      return output_->size() + writeBuffer_.size();
     }
     return fileSize_;
   }
@@ -128,22 +256,55 @@ class SpillFile {
     return path_;
   }
 
+  folly::io::CodecType compressionKind() const {
+    return compressionKind_;
+  }
+
+  /// Reserves 'bytes' of the local spill directory of the process if this
+  /// keeps its spill files within 'maxBytes'. Returns false otherwise.
+  static bool tryReserveLocalBytes(uint64_t bytes, uint64_t maxBytes);
+
+  /// Returns the bytes reserved in the local spill directory of the process.
+  static uint64_t localSpillBytes() {
+    return localSpillBytes_;
+  }
+
  private:
   static std::atomic<int32_t> ordinalCounter_;
+  static std::atomic<uint64_t> localSpillBytes_;
+
+  // Writes out 'writeBuffer_'.
+  void flushWriteBuffer();
+
+  // Brings the bytes of 'this' in 'diskTracker_' up to date with size().
+  void updateDiskBytes();
 
   // Type of 'rowVector_'. Needed for setting up writing.
   const RowTypePtr type_;
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   memory::MemoryPool& pool_;
+  const folly::io::CodecType compressionKind_;
+  const uint64_t writeBufferSize_;
+  const std::shared_ptr<core::SpillDiskTracker> diskTracker_;
+  const void* const diskHolder_;
+  const std::shared_ptr<SpillIoStats> ioStats_;
 
   // Ordinal number used for making a label for debugging.
   const int32_t ordinal_;
   const std::string path_;
 
+  // Space of 'localSpillBytes_' held by 'this'. 0 if not a local file.
+  uint64_t localBytes_;
+
+  // Bytes of 'this' added to 'diskTracker_'.
+  uint64_t diskBytes_{0};
+
   // Byte size of the backing file. Set when finishing writing.
   uint64_t fileSize_ = 0;
   std::unique_ptr<WriteFile> output_;
+  // Data appended and not yet written to 'output_'.
+  std::string writeBuffer_;
   std::unique_ptr<SpillInput> input_;
 };
 
@@ -159,7 +320,18 @@ class SpillFileList {
   /// data is sorted. 'path' is a file path prefix. ' 'targetFileSize' is the
   /// target byte size of a single file in the file set. 'pool' and
   /// 'mappedMemory' are used for buffering and constructing the result data
-  /// read from 'this'.
+  /// read from 'this'. 'compressionKind' is the codec of the files.
+  ///
+  /// If 'writeExecutor' is set, the files are written behind the caller: a
+  /// write() serializes its rows while the previous batch is compressed and
+  /// written on 'writeExecutor', and only waits for that write before handing
+  /// over its own batch. So at most two serialized batches are in memory. The
+  /// caller writes the batch itself if the executor has not started it yet.
+  ///
+  /// 'writeOptions' sets the chunk size of the writes and the local spill
+  /// directory, if any. A file goes to the local directory if its target size
+  /// still fits there when the file is started. The file sizes and the time
+  /// of the writes are counted in its 'diskTracker' and 'ioStats' if set.
   ///
   /// When writing sorted spill runs, the caller is responsible for buffering
   /// and sorting the data. write is called multiple times, followed by flush().
@@ -170,14 +342,25 @@ class SpillFileList {
       const std::string& path,
       uint64_t targetFileSize,
       memory::MemoryPool& pool,
-      memory::MappedMemory& mappedMemory)
+      memory::MappedMemory& mappedMemory,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION,
+      folly::Executor* FOLLY_NULLABLE writeExecutor = nullptr,
+      const SpillWriteOptions& writeOptions = {})
       : type_(type),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         path_(path),
         targetFileSize_(targetFileSize),
         pool_(pool),
-        mappedMemory_(mappedMemory) {
+        mappedMemory_(mappedMemory),
+        compressionKind_(compressionKind),
+        codec_(
+            compressionKind == folly::io::CodecType::NO_COMPRESSION
+                ? nullptr
+                : folly::io::getCodec(compressionKind)),
+        writeExecutor_(writeExecutor),
+        writeOptions_(writeOptions) {
     // NOTE: if the associated spilling operator has specified the sort
     // comparison flags, then it must match the number of sorting keys.
     VELOX_CHECK(
@@ -203,8 +386,17 @@ class SpillFileList {
     return std::move(files_);
   }
 
+  ~SpillFileList();
+
+  /// Returns the bytes written to the files. Waits for a pending write.
   uint64_t spilledBytes() const;
 
+  /// Returns the serialized size of the spilled data before compression.
+  /// Equals spilledBytes() if the files are not compressed.
+  uint64_t spilledUncompressedBytes() const {
+    return uncompressedBytes_;
+  }
+
   int64_t spilledFiles() const {
     return files_.size();
   }
@@ -213,10 +405,21 @@ class SpillFileList {
 
  private:
   // Returns the current file to write to and creates one if needed.
-  WriteFile& currentOutput();
+  SpillFile& currentOutput();
+
+  // Returns the path prefix for the next file in the local spill directory
+  // and reserves its space there. Returns std::nullopt if there is no local
+  // spill directory or it is full.
+  std::optional<std::string> tryLocalPath();
   // Writes data from 'batch_' to the current output file.
   void flush();
 
+  // Compresses 'iobuf' if needed and appends it to 'file'.
+  void writeBatch(const folly::IOBuf& iobuf, SpillFile& file);
+
+  // Waits for the write on 'writeExecutor_' if any. Rethrows its error.
+  void waitForWrite() const;
+
   const RowTypePtr type_;
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
@@ -224,8 +427,17 @@ class SpillFileList {
   const uint64_t targetFileSize_;
   memory::MemoryPool& pool_;
   memory::MappedMemory& mappedMemory_;
+  const folly::io::CodecType compressionKind_;
+  // Compresses the batches. nullptr if the files are not compressed.
+  const std::unique_ptr<folly::io::Codec> codec_;
+  folly::Executor* FOLLY_NULLABLE const writeExecutor_;
+  const SpillWriteOptions writeOptions_;
   std::unique_ptr<VectorStreamGroup> batch_;
   SpillFiles files_;
+  uint64_t uncompressedBytes_{0};
+  // The write of the previous batch. Set if 'writeExecutor_' is set and a
+  // write may be in progress.
+  mutable std::shared_ptr<AsyncSource<folly::Unit>> pendingWrite_;
 };
 
 // A source of sorted spilled RowVectors coming either from a file or memory.
@@ -243,7 +455,48 @@ class SpillMergeStream : public MergeStream {
   }
 
   int32_t compare(const MergeStream& other) const override {
-    auto& otherStream = static_cast<const SpillMergeStream&>(other);
+    return compareRow(index_, static_cast<const SpillMergeStream&>(other));
+  }
+
+  void pop();
+
+  /// Advances past 'numRows' rows of the current batch. Like pop() for the
+  /// last of these.
+  void pop(vector_size_t numRows);
+
+  /// Returns the number of consecutive rows from the current row, at most
+  /// 'maxRows' and not past the end of the current batch, that are not
+  /// greater than the current row of 'other', or all of these rows if
+  /// 'other' is nullptr. The current row must not be greater than the
+  /// current row of 'other'.
+  vector_size_t runSize(const SpillMergeStream* other, vector_size_t maxRows)
+      const;
+
+  const RowVector& current() const {
+    return *rowVector_;
+  }
+
+  /// Invoked to get the current row index in 'rowVector_'. If 'isLastRow' is
+  /// not null, it is set to true if current row is the last one in the current
+  /// batch, in which case the caller must call copy out current batch data if
+  /// required before calling pop().
+  vector_size_t currentIndex(bool* isLastRow = nullptr) const {
+    if (isLastRow != nullptr) {
+      *isLastRow = (index_ == (rowVector_->size() - 1));
+    }
+    return index_;
+  }
+
+  // Returns a DecodedVector set decoding the 'index'th child of 'rowVector_'
+  DecodedVector& decoded(int32_t index) {
+    ensureDecodedValid(index);
+    return decoded_[index];
+  }
+
+ protected:
+  // Compares row 'index' of 'this' with the current row of 'otherStream'.
+  int32_t compareRow(vector_size_t index, const SpillMergeStream& otherStream)
+      const {
     auto& children = rowVector_->children();
     auto& otherChildren = otherStream.current().children();
     int32_t key = 0;
@@ -252,7 +505,7 @@ class SpillMergeStream : public MergeStream {
         auto result = children[key]
                           ->compare(
                               otherChildren[key].get(),
-                              index_,
+                              index,
                               otherStream.index_,
                               CompareFlags())
                           .value();
@@ -265,7 +518,7 @@ class SpillMergeStream : public MergeStream {
         auto result = children[key]
                           ->compare(
                               otherChildren[key].get(),
-                              index_,
+                              index,
                               otherStream.index_,
                               sortCompareFlags()[key])
                           .value();
@@ -277,30 +530,6 @@ class SpillMergeStream : public MergeStream {
     return 0;
   }
 
-  void pop();
-
-  const RowVector& current() const {
-    return *rowVector_;
-  }
-
-  /// Invoked to get the current row index in 'rowVector_'. If 'isLastRow' is
-  /// not null, it is set to true if current row is the last one in the current
-  /// batch, in which case the caller must call copy out current batch data if
-  /// required before calling pop().
-  vector_size_t currentIndex(bool* isLastRow = nullptr) const {
-    if (isLastRow != nullptr) {
-      *isLastRow = (index_ == (rowVector_->size() - 1));
-    }
-    return index_;
-  }
-
-  // Returns a DecodedVector set decoding the 'index'th child of 'rowVector_'
-  DecodedVector& decoded(int32_t index) {
-    ensureDecodedValid(index);
-    return decoded_[index];
-  }
-
- protected:
   virtual int32_t numSortingKeys() const = 0;
 
   virtual const std::vector<CompareFlags>& sortCompareFlags() const = 0;
@@ -357,8 +586,9 @@ class SpillMergeStream : public MergeStream {
 class FileSpillMergeStream : public SpillMergeStream {
  public:
   static std::unique_ptr<SpillMergeStream> create(
-      std::unique_ptr<SpillFile> spillFile) {
-    spillFile->startRead();
+      std::unique_ptr<SpillFile> spillFile,
+      const SpillReadOptions& readOptions = {}) {
+    spillFile->startRead(readOptions);
     auto* spillStream = new FileSpillMergeStream(std::move(spillFile));
     spillStream->nextBatch();
     return std::unique_ptr<SpillMergeStream>(spillStream);
@@ -477,6 +707,18 @@ class SpillPartitionId {
     return partitionNumber_;
   }
 
+  /// Returns the level of recursive spilling of this partition if the
+  /// partition bits of the initial spilling start at 'startPartitionBitOffset'
+  /// and each level takes the next 'numPartitionBits'. The partitions spilled
+  /// from the operator input are at level 0, the ones spilled while restoring
+  /// a level 0 partition are at level 1 and so on.
+  int32_t spillLevel(uint8_t startPartitionBitOffset, uint8_t numPartitionBits)
+      const {
+    VELOX_CHECK_GE(partitionBitOffset_, startPartitionBitOffset);
+    VELOX_CHECK_GT(numPartitionBits, 0);
+    return (partitionBitOffset_ - startPartitionBitOffset) / numPartitionBits;
+  }
+
  private:
   uint8_t partitionBitOffset_{0};
   int32_t partitionNumber_{0};
@@ -544,7 +786,10 @@ class SpillState {
   // on which the data is sorted, 0 if only hash partitioning is used.
   // 'targetFileSize' is the target size of a single
   // file.  'pool' and 'mappedMemory' own
-  // the memory for state and results.
+  // the memory for state and results. 'compressionKind' is the codec of the
+  // spill files. 'writeExecutor' writes the files behind the caller and
+  // 'writeOptions' sets the write chunk size and local spill directory, see
+  // SpillFileList.
   SpillState(
       const std::string& path,
       int32_t maxPartitions,
@@ -552,7 +797,11 @@ class SpillState {
       const std::vector<CompareFlags>& sortCompareFlags,
       uint64_t targetFileSize,
       memory::MemoryPool& pool,
-      memory::MappedMemory& mappedMemory)
+      memory::MappedMemory& mappedMemory,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION,
+      folly::Executor* FOLLY_NULLABLE writeExecutor = nullptr,
+      const SpillWriteOptions& writeOptions = {})
       : path_(path),
         maxPartitions_(maxPartitions),
         numSortingKeys_(numSortingKeys),
@@ -560,6 +809,9 @@ class SpillState {
         targetFileSize_(targetFileSize),
         pool_(pool),
         mappedMemory_(mappedMemory),
+        compressionKind_(compressionKind),
+        writeExecutor_(writeExecutor),
+        writeOptions_(withIoStats(writeOptions)),
         files_(maxPartitions_) {}
 
   /// Indicates if a given 'partition' has been spilled or not.
@@ -614,10 +866,14 @@ class SpillState {
 
   // Starts reading values for 'partition'. If 'extra' is non-null, it can be
   // a stream of rows from a RowContainer so as to merge unspilled data with
-  // spilled data.
+  // spilled data. 'readOptions' sets the reading of the files. If there are
+  // more than its 'maxMergeFanIn' files, these are first merged into fewer
+  // files, so that the returned merge reads at most 'maxMergeFanIn' files
+  // besides 'extra'.
   std::unique_ptr<TreeOfLosers<SpillMergeStream>> startMerge(
       int32_t partition,
-      std::unique_ptr<SpillMergeStream>&& extra);
+      std::unique_ptr<SpillMergeStream>&& extra,
+      const SpillReadOptions& readOptions = {});
 
   bool hasFiles(int32_t partition) const {
     return partition < files_.size() && files_[partition];
@@ -625,6 +881,9 @@ class SpillState {
 
   uint64_t spilledBytes() const;
 
+  /// Returns the serialized size of the spilled data before compression.
+  uint64_t spilledUncompressedBytes() const;
+
   /// Return the number of spilled partitions.
   uint32_t spilledPartitions() const;
 
@@ -633,9 +892,24 @@ class SpillState {
 
   int64_t spilledFiles() const;
 
+  /// Returns the time spent on the files of 'this', also after they have been
+  /// handed out by files() or startMerge().
+  const SpillIoStats& ioStats() const {
+    return *writeOptions_.ioStats;
+  }
+
   std::vector<std::string> testingSpilledFilePaths() const;
 
  private:
+  // Returns 'writeOptions' with 'ioStats' set.
+  static SpillWriteOptions withIoStats(const SpillWriteOptions& writeOptions);
+
+  // Merges 'files' of 'partition' into one sorted file.
+  std::unique_ptr<SpillFile> mergeFiles(
+      int32_t partition,
+      SpillFiles files,
+      const SpillReadOptions& readOptions);
+
   const RowTypePtr type_;
   const std::string path_;
   const int32_t maxPartitions_;
@@ -645,6 +919,9 @@ class SpillState {
 
   memory::MemoryPool& pool_;
   memory::MappedMemory& mappedMemory_;
+  const folly::io::CodecType compressionKind_;
+  folly::Executor* FOLLY_NULLABLE const writeExecutor_;
+  const SpillWriteOptions writeOptions_;
 
   // A set of spilled partition numbers.
   SpillPartitionNumSet spilledPartitionSet_;
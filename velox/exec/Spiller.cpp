@@ -19,7 +19,10 @@
 #include "velox/common/base/AsyncSource.h"
 
 #include <folly/ScopeGuard.h>
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/exec/Counters.h"
+#include "velox/exec/PrefixSort.h"
 
 using facebook::velox::common::testutil::TestValue;
 
@@ -37,7 +40,9 @@ Spiller::Spiller(
     const std::string& path,
     int64_t targetFileSize,
     memory::MemoryPool& pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    folly::io::CodecType compressionKind,
+    const SpillWriteOptions& writeOptions)
     : Spiller(
           type,
           container,
@@ -49,8 +54,10 @@ Spiller::Spiller(
           path,
           targetFileSize,
           pool,
-          executor) {
-  VELOX_CHECK_EQ(type_, Type::kOrderBy);
+          executor,
+          compressionKind,
+          writeOptions) {
+  VELOX_CHECK(type_ == Type::kOrderBy || type_ == Type::kWindow);
 }
 
 Spiller::Spiller(
@@ -60,7 +67,9 @@ Spiller::Spiller(
     const std::string& path,
     int64_t targetFileSize,
     memory::MemoryPool& pool,
-    folly::Executor* FOLLY_NULLABLE executor)
+    folly::Executor* FOLLY_NULLABLE executor,
+    folly::io::CodecType compressionKind,
+    const SpillWriteOptions& writeOptions)
     : Spiller(
           type,
           nullptr,
@@ -72,7 +81,9 @@ Spiller::Spiller(
           path,
           targetFileSize,
           pool,
-          executor) {
+          executor,
+          compressionKind,
+          writeOptions) {
   VELOX_CHECK_EQ(type_, Type::kHashJoinProbe);
 }
 
@@ -87,7 +98,9 @@ Spiller::Spiller(
     const std::string& path,
     int64_t targetFileSize,
     memory::MemoryPool& pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    folly::io::CodecType compressionKind,
+    const SpillWriteOptions& writeOptions)
     : type_(type),
       container_(container),
       eraser_(eraser),
@@ -100,15 +113,20 @@ Spiller::Spiller(
           sortCompareFlags,
           targetFileSize,
           pool,
-          spillMappedMemory()),
+          spillMappedMemory(),
+          compressionKind,
+          executor,
+          writeOptions),
       pool_(pool),
       executor_(executor) {
   TestValue::adjust(
       "facebook::velox::exec::Spiller", const_cast<HashBitRange*>(&bits_));
 
   VELOX_CHECK_EQ(container_ == nullptr, type_ == Type::kHashJoinProbe);
-  // kOrderBy spiller type must only have one partition.
-  VELOX_CHECK((type_ != Type::kOrderBy) || (state_.maxPartitions() == 1));
+  // kOrderBy and kWindow spiller types must only have one partition.
+  VELOX_CHECK(
+      (type_ != Type::kOrderBy && type_ != Type::kWindow) ||
+      (state_.maxPartitions() == 1));
   spillRuns_.reserve(state_.maxPartitions());
   for (int i = 0; i < state_.maxPartitions(); ++i) {
     spillRuns_.emplace_back(spillMappedMemory());
@@ -239,13 +257,11 @@ std::unique_ptr<SpillMergeStream> Spiller::spillMergeStreamOverRows(
 void Spiller::ensureSorted(SpillRun& run) {
   // The spill data of a hash join doesn't need to be sorted.
   if (!run.sorted && needSort()) {
-    std::sort(
-        run.rows.begin(),
-        run.rows.end(),
-        [&](const char* left, const char* right) {
-          return container_->compareRows(
-                     left, right, state_.sortCompareFlags()) < 0;
-        });
+    PrefixSort::sort(
+        *container_,
+        PrefixSort::leadingKeys(
+            container_->keyTypes().size(), state_.sortCompareFlags()),
+        folly::Range<char**>(run.rows.data(), run.rows.size()));
     run.sorted = true;
   }
 }
@@ -282,6 +298,27 @@ std::unique_ptr<Spiller::SpillStatus> Spiller::writeSpill(int32_t partition) {
   }
 }
 
+Spiller::~Spiller() {
+  reportStats();
+}
+
+void Spiller::reportStats() {
+  const auto current = stats();
+  REPORT_ADD_STAT_VALUE(
+      kCounterSpillBytes, current.spilledBytes - reportedStats_.spilledBytes);
+  REPORT_ADD_STAT_VALUE(
+      kCounterSpillRows, current.spilledRows - reportedStats_.spilledRows);
+  REPORT_ADD_STAT_VALUE(
+      kCounterSpillFiles, current.spilledFiles - reportedStats_.spilledFiles);
+  REPORT_ADD_STAT_VALUE(
+      kCounterSpillWriteTimeUs,
+      current.spillWriteTimeUs - reportedStats_.spillWriteTimeUs);
+  REPORT_ADD_STAT_VALUE(
+      kCounterSpillReadTimeUs,
+      current.spillReadTimeUs - reportedStats_.spillReadTimeUs);
+  reportedStats_ = current;
+}
+
 void Spiller::advanceSpill() {
   std::vector<std::shared_ptr<AsyncSource<SpillStatus>>> writes;
   for (auto partition = 0; partition < spillRuns_.size(); ++partition) {
@@ -333,6 +370,7 @@ void Spiller::advanceSpill() {
       pendingSpillPartitions_.erase(partition);
     }
   }
+  reportStats();
 }
 
 bool Spiller::needSort() const {
@@ -449,6 +487,7 @@ void Spiller::spill(uint32_t partition, const RowVectorPtr& spillVector) {
   }
 
   state_.appendToPartition(partition, spillVector);
+  reportStats();
 }
 
 int32_t Spiller::pickNextPartitionToSpill() {
@@ -531,7 +570,8 @@ void Spiller::fillSpillRuns(SpillRows* rowsFromNonSpillingPartitions) {
     for (auto i = 0; i < numRows; ++i) {
       // TODO: consider to cache the hash bits in row container so we only need
       // to calculate them once.
-      const auto partition = (type_ == Type::kOrderBy)
+      const auto partition =
+          (type_ == Type::kOrderBy || type_ == Type::kWindow)
           ? 0
           : bits_.partition(hashes[i], state_.maxPartitions());
       VELOX_DCHECK_GE(partition, 0);
@@ -574,6 +614,8 @@ std::string Spiller::typeName(Type type) {
   switch (type) {
     case Type::kOrderBy:
       return "ORDER_BY";
+    case Type::kWindow:
+      return "WINDOW";
     case Type::kHashJoinBuild:
       return "HASH_JOIN_BUILD";
     case Type::kHashJoinProbe:
@@ -33,8 +33,11 @@ class Spiller {
     kHashJoinProbe = 2,
     // Used for order by.
     kOrderBy = 3,
+    // Used for window. The rows are sorted on the partition keys followed by
+    // the sorting keys.
+    kWindow = 4,
   };
-  static constexpr int kNumTypes = 4;
+  static constexpr int kNumTypes = 5;
   static std::string typeName(Type);
 
   // Specifies the config for spilling.
@@ -45,13 +48,32 @@ class Spiller {
         folly::Executor* FOLLY_NULLABLE _executor,
         int32_t _spillableReservationGrowthPct,
         const HashBitRange& _hashBitRange,
-        int32_t _testSpillPct)
+        int32_t _testSpillPct,
+        folly::io::CodecType _compressionKind =
+            folly::io::CodecType::NO_COMPRESSION,
+        int32_t _maxSpillLevel = 4,
+        SpillWriteOptions _writeOptions = {},
+        SpillReadOptions _readOptions = {})
         : filePath(_filePath),
           fileSizeFactor(_fileSizeFactor),
           executor(_executor),
           spillableReservationGrowthPct(_spillableReservationGrowthPct),
           hashBitRange(_hashBitRange),
-          testSpillPct(_testSpillPct) {}
+          testSpillPct(_testSpillPct),
+          compressionKind(_compressionKind),
+          maxSpillLevel(_maxSpillLevel),
+          writeOptions(std::move(_writeOptions)),
+          readOptions(_readOptions) {}
+
+    // Returns true if a spill partition at 'partitionId' can't be spilled
+    // again while restoring it, either because the next level would exceed
+    // 'maxSpillLevel' or because there are no hash bits left for it.
+    bool exceedsMaxSpillLevel(const SpillPartitionId& partitionId) const {
+      const auto numBits = hashBitRange.numBits();
+      return partitionId.spillLevel(hashBitRange.begin(), numBits) + 1 >
+          maxSpillLevel ||
+          partitionId.partitionBitOffset() + 2 * numBits > 64;
+    }
 
     // Filesystem path for spill files.
     std::string filePath;
@@ -73,12 +95,27 @@ class Spiller {
     // Percentage of input batches to be spilled for testing. 0 means no
     // spilling for test.
     int32_t testSpillPct;
+
+    // Codec for compressing the spill files.
+    folly::io::CodecType compressionKind;
+
+    // The max level of recursive spilling, where 0 is the spilling of the
+    // operator input. Beyond it, a restored spill partition is processed in
+    // memory without spilling.
+    int32_t maxSpillLevel;
+
+    // The write chunk size and the local spill directory, if any.
+    SpillWriteOptions writeOptions;
+
+    // The read buffer size, read ahead and merge fan-in.
+    SpillReadOptions readOptions;
   };
 
   using SpillRows = std::vector<char*, memory::StlMappedMemoryAllocator<char*>>;
 
   // The constructor without specifying hash bits which will only use one
-  // partition by default. It is only used by kOrderBy spiller type as for now.
+  // partition by default. It is only used by kOrderBy and kWindow spiller
+  // types as for now.
   Spiller(
       Type type,
       RowContainer* FOLLY_NONNULL container,
@@ -89,7 +126,10 @@ class Spiller {
       const std::string& path,
       int64_t targetFileSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION,
+      const SpillWriteOptions& writeOptions = {});
 
   Spiller(
       Type type,
@@ -98,7 +138,10 @@ class Spiller {
       const std::string& path,
       int64_t targetFileSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION,
+      const SpillWriteOptions& writeOptions = {});
 
   Spiller(
       Type type,
@@ -111,7 +154,14 @@ class Spiller {
       const std::string& path,
       int64_t targetFileSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION,
+      const SpillWriteOptions& writeOptions = {});
+
+  /// Reports the stats not reported yet, e.g. the time spent reading back
+  /// the spilled data, through StatsReporter.
+  ~Spiller();
 
   /// Spills rows from 'this' until there are under 'targetRows' rows
   /// and 'targetBytes' of allocated variable length space in use. spill()
@@ -200,12 +250,16 @@ class Spiller {
   /// stats in 'statsList' by partition number.
   void fillSpillRuns(std::vector<SpillableStats>& statsList);
 
+  /// Starts merging the spilled and the unspilled rows of 'partition'. See
+  /// SpillState::startMerge() for 'readOptions'.
   std::unique_ptr<TreeOfLosers<SpillMergeStream>> startMerge(
-      int32_t partition) {
+      int32_t partition,
+      const SpillReadOptions& readOptions = {}) {
     if (FOLLY_UNLIKELY(!needSort())) {
       VELOX_FAIL("Can't sort merge the unsorted spill data: {}", toString());
     }
-    return state_.startMerge(partition, spillMergeStreamOverRows(partition));
+    return state_.startMerge(
+        partition, spillMergeStreamOverRows(partition), readOptions);
   }
 
   /// Define the spiller stats.
@@ -215,14 +269,28 @@ class Spiller {
     /// NOTE: when we sum up the stats from a group of spill operators, it is
     /// the total number of spilled partitions X number of operators.
     uint32_t spilledPartitions{0};
+    /// The serialized size of the spilled data before compression.
+    uint64_t spilledUncompressedBytes{0};
+    uint64_t spilledFiles{0};
+    /// Time spent writing and reading the spill files, see SpillIoStats.
+    uint64_t spillWriteTimeUs{0};
+    uint64_t spillReadTimeUs{0};
 
     Stats(
         uint64_t _spilledBytes,
         uint64_t _spilledRows,
-        uint32_t _spilledPartitions)
+        uint32_t _spilledPartitions,
+        uint64_t _spilledUncompressedBytes = 0,
+        uint64_t _spilledFiles = 0,
+        uint64_t _spillWriteTimeUs = 0,
+        uint64_t _spillReadTimeUs = 0)
         : spilledBytes(_spilledBytes),
           spilledRows(_spilledRows),
-          spilledPartitions(_spilledPartitions) {}
+          spilledPartitions(_spilledPartitions),
+          spilledUncompressedBytes(_spilledUncompressedBytes),
+          spilledFiles(_spilledFiles),
+          spillWriteTimeUs(_spillWriteTimeUs),
+          spillReadTimeUs(_spillReadTimeUs) {}
 
     Stats() = default;
 
@@ -230,13 +298,23 @@ class Spiller {
       spilledBytes += other.spilledBytes;
       spilledRows += other.spilledRows;
       spilledPartitions += other.spilledPartitions;
+      spilledUncompressedBytes += other.spilledUncompressedBytes;
+      spilledFiles += other.spilledFiles;
+      spillWriteTimeUs += other.spillWriteTimeUs;
+      spillReadTimeUs += other.spillReadTimeUs;
       return *this;
     }
   };
 
   Stats stats() const {
     return Stats{
-        state_.spilledBytes(), spilledRows_, state_.spilledPartitions()};
+        state_.spilledBytes(),
+        spilledRows_,
+        state_.spilledPartitions(),
+        state_.spilledUncompressedBytes(),
+        static_cast<uint64_t>(state_.spilledFiles()),
+        state_.ioStats().writeTimeUs,
+        state_.ioStats().readTimeUs};
   }
 
   int64_t spilledFiles() const {
@@ -346,6 +424,10 @@ class Spiller {
   // Writes out and erases rows marked for spilling.
   void advanceSpill();
 
+  // Reports the change of stats() since the previous call through
+  // StatsReporter.
+  void reportStats();
+
   // Indicates if the spill data needs to be sorted before write to file. It is
   // based on the spiller type. As for now, we need to sort spill data for any
   // non hash join types of spilling.
@@ -375,6 +457,8 @@ class Spiller {
   memory::MemoryPool& pool_;
   folly::Executor* FOLLY_NULLABLE const executor_;
   uint64_t spilledRows_{0};
+  // The stats at the previous reportStats().
+  Stats reportedStats_;
 };
 
 } // namespace facebook::velox::exec
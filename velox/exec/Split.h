@@ -63,4 +63,9 @@ struct Split {
   }
 };
 
+/// Starts preparing a connector split in the background. See
+/// Task::getSplitOrFuture().
+using ConnectorSplitPreloadFunc =
+    std::function<void(const std::shared_ptr<connector::ConnectorSplit>&)>;
+
 } // namespace facebook::velox::exec
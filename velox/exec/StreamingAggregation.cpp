@@ -154,7 +154,7 @@ char* StreamingAggregation::startNewGroup(vector_size_t index) {
 
 void StreamingAggregation::storeKeys(char* group, vector_size_t index) {
   for (auto i = 0; i < groupingKeys_.size(); ++i) {
-    rows_->store(decodedKeys_[i], index, group, i);
+    rows_->store(*decodedKeys_[i], index, group, i);
   }
 }
 
@@ -201,8 +201,10 @@ void StreamingAggregation::assignGroups() {
   }
 
   if (index < numInput) {
+    auto& decodedVectorCache = operatorCtx_->driverCtx()->decodedVectorCache;
     for (auto i = 0; i < groupingKeys_.size(); ++i) {
-      decodedKeys_[i].decode(*input_->childAt(groupingKeys_[i]), inputRows_);
+      decodedKeys_[i] = &decodedVectorCache.decode(
+          input_->childAt(groupingKeys_[i]), inputRows_);
     }
 
     auto* newGroup = startNewGroup(index);
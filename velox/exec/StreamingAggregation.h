@@ -78,7 +78,9 @@ class StreamingAggregation : public Operator {
   std::unique_ptr<AggregationMasks> masks_;
   std::vector<std::vector<column_index_t>> args_;
   std::vector<std::vector<VectorPtr>> constantArgs_;
-  std::vector<DecodedVector> decodedKeys_;
+  // Decoded grouping keys of 'input_' from the DecodedVectorCache of the
+  // Driver.
+  std::vector<const DecodedVector*> decodedKeys_;
 
   // Storage of grouping keys and accumulators.
   std::unique_ptr<RowContainer> rows_;
@@ -23,7 +23,8 @@ namespace facebook::velox::exec {
 TableScan::TableScan(
     int32_t operatorId,
     DriverCtx* driverCtx,
-    std::shared_ptr<const core::TableScanNode> tableScanNode)
+    std::shared_ptr<const core::TableScanNode> tableScanNode,
+    std::optional<int64_t> maxRows)
     : SourceOperator(
           driverCtx,
           tableScanNode->outputType(),
@@ -32,8 +33,23 @@ TableScan::TableScan(
           "TableScan"),
       tableHandle_(tableScanNode->tableHandle()),
       columnHandles_(tableScanNode->assignments()),
-      driverCtx_(driverCtx) {
+      driverCtx_(driverCtx),
+      adaptiveDrivers_(
+          driverCtx->queryConfig().adaptiveMaxDriversPerPipeline() > 0) {
+  if (maxRows.has_value()) {
+    rowBudget_ = driverCtx_->task->getScanRowBudgetLocked(
+        driverCtx_->splitGroupId, planNodeId(), maxRows.value());
+  }
   connector_ = connector::getConnector(tableHandle_->connectorId());
+  if (connector_->supportsSplitPreload() && connector_->executor()) {
+    maxPreloadSplits_ = driverCtx_->queryConfig().maxSplitPreloadPerDriver();
+    if (maxPreloadSplits_ > 0) {
+      splitPreloader_ =
+          [this](const std::shared_ptr<connector::ConnectorSplit>& split) {
+            preload(split);
+          };
+    }
+  }
 }
 
 RowVectorPtr TableScan::getOutput() {
@@ -42,29 +58,32 @@ RowVectorPtr TableScan::getOutput() {
   }
 
   for (;;) {
+    if (rowBudget_ && *rowBudget_ <= 0) {
+      finishEarly();
+      return nullptr;
+    }
+
     if (needNewSplit_) {
       exec::Split split;
-      blockingReason_ = driverCtx_->task->getSplitOrFuture(
-          driverCtx_->splitGroupId, planNodeId(), split, blockingFuture_);
-      if (blockingReason_ != BlockingReason::kNotBlocked) {
-        return nullptr;
+      // A retiring Driver takes no more splits and finishes as if there were
+      // none left. The other Drivers of the pipeline take the rest.
+      if (!adaptiveDrivers_ ||
+          !driverCtx_->task->adjustDriverParallelism(*driverCtx_)) {
+        blockingReason_ = driverCtx_->task->getSplitOrFuture(
+            driverCtx_->splitGroupId,
+            planNodeId(),
+            split,
+            blockingFuture_,
+            maxPreloadSplits_,
+            splitPreloader_);
+        if (blockingReason_ != BlockingReason::kNotBlocked) {
+          return nullptr;
+        }
       }
 
       if (!split.hasConnectorSplit()) {
         noMoreSplits_ = true;
-
-        if (dataSource_) {
-          auto connectorStats = dataSource_->runtimeStats();
-          for (const auto& [name, counter] : connectorStats) {
-            if (UNLIKELY(stats_.runtimeStats.count(name) == 0)) {
-              stats_.runtimeStats.insert(
-                  std::make_pair(name, RuntimeMetric(counter.unit)));
-            } else {
-              VELOX_CHECK_EQ(stats_.runtimeStats.at(name).unit, counter.unit);
-            }
-            stats_.runtimeStats.at(name).addValue(counter.value);
-          }
-        }
+        addDataSourceStats();
         return nullptr;
       }
 
@@ -84,17 +103,27 @@ RowVectorPtr TableScan::getOutput() {
             tableHandle_,
             columnHandles_,
             connectorQueryCtx_.get());
-        for (const auto& entry : pendingDynamicFilters_) {
+        for (const auto& entry : dynamicFilters_) {
           dataSource_->addDynamicFilter(entry.first, entry.second);
         }
-        pendingDynamicFilters_.clear();
       }
 
       debugString_ = fmt::format(
           "Split {} Task {}",
           connectorSplit->toString(),
           operatorCtx_->task()->taskId());
-      dataSource_->addSplit(connectorSplit);
+      std::unique_ptr<connector::DataSource> preparedDataSource;
+      if (connectorSplit->dataSource) {
+        // Null if the preload failed to start, e.g. on cancellation.
+        preparedDataSource = connectorSplit->dataSource->move();
+        connectorSplit->dataSource.reset();
+      }
+      if (preparedDataSource) {
+        stats_.addRuntimeStat("preloadedSplits", RuntimeCounter(1));
+        dataSource_->setFromDataSource(std::move(preparedDataSource));
+      } else {
+        dataSource_->addSplit(connectorSplit);
+      }
       ++stats_.numSplits;
       setBatchSize();
     }
@@ -106,7 +135,11 @@ RowVectorPtr TableScan::getOutput() {
          },
          &debugString_});
 
-    auto dataOptional = dataSource_->next(readBatchSize_, blockingFuture_);
+    // Reads no more rows than the Drivers of the scan still need together.
+    const auto readSize = rowBudget_
+        ? std::clamp<int64_t>(*rowBudget_, 1, readBatchSize_)
+        : readBatchSize_;
+    auto dataOptional = dataSource_->next(readSize, blockingFuture_);
     if (!dataOptional.has_value()) {
       blockingReason_ = BlockingReason::kWaitForConnector;
       return nullptr;
@@ -124,6 +157,9 @@ RowVectorPtr TableScan::getOutput() {
       if (data->size() > 0) {
         stats_.inputPositions += data->size();
         stats_.inputBytes += data->retainedSize();
+        if (rowBudget_) {
+          *rowBudget_ -= data->size();
+        }
         return data;
       }
       continue;
@@ -138,6 +174,32 @@ bool TableScan::isFinished() {
   return noMoreSplits_;
 }
 
+void TableScan::finishEarly() {
+  if (!needNewSplit_) {
+    driverCtx_->task->splitFinished();
+    needNewSplit_ = true;
+  }
+  noMoreSplits_ = true;
+  stats_.addRuntimeStat("finishedOnRowLimit", RuntimeCounter(1));
+  addDataSourceStats();
+}
+
+void TableScan::addDataSourceStats() {
+  if (!dataSource_) {
+    return;
+  }
+  auto connectorStats = dataSource_->runtimeStats();
+  for (const auto& [name, counter] : connectorStats) {
+    if (UNLIKELY(stats_.runtimeStats.count(name) == 0)) {
+      stats_.runtimeStats.insert(
+          std::make_pair(name, RuntimeMetric(counter.unit)));
+    } else {
+      VELOX_CHECK_EQ(stats_.runtimeStats.at(name).unit, counter.unit);
+    }
+    stats_.runtimeStats.at(name).addValue(counter.value);
+  }
+}
+
 void TableScan::setBatchSize() {
   constexpr int64_t kMB = 1 << 20;
   auto estimate = dataSource_->estimatedRowSize();
@@ -152,14 +214,52 @@ void TableScan::setBatchSize() {
   readBatchSize_ = std::min<int64_t>(100, 10 * kMB / estimate);
 }
 
+void TableScan::preload(
+    const std::shared_ptr<connector::ConnectorSplit>& split) {
+  // A preloaded split holds a file handle, the file metadata and read
+  // buffers. Stops preloading while the query uses over half of its memory
+  // limit.
+  auto* queryPool = operatorCtx_->task()->queryCtx()->pool();
+  if (queryPool->getCurrentBytes() > queryPool->getCap() / 2) {
+    return;
+  }
+  // The DataSource is made with a ConnectorQueryCtx of its own, since 'this'
+  // may be gone by the time it runs. The Task keeps the memory pool alive.
+  // 'split' is held weakly because it holds the AsyncSource.
+  split->dataSource = std::make_shared<AsyncSource<connector::DataSource>>(
+      [type = outputType_,
+       table = tableHandle_,
+       columns = columnHandles_,
+       connector = connector_,
+       ctx = operatorCtx_->createDetachedConnectorQueryCtx(
+           split->connectorId, planNodeId()),
+       task = operatorCtx_->task(),
+       dynamicFilters = dynamicFilters_,
+       weakSplit = std::weak_ptr<connector::ConnectorSplit>(split)]()
+          -> std::unique_ptr<connector::DataSource> {
+        auto split = weakSplit.lock();
+        if (!split || split->cancelled || !task->isRunning()) {
+          return nullptr;
+        }
+        auto dataSource =
+            connector->createDataSource(type, table, columns, ctx.get());
+        for (const auto& [channel, filter] : dynamicFilters) {
+          dataSource->addDynamicFilter(channel, filter);
+        }
+        dataSource->addSplit(split);
+        return dataSource;
+      });
+  connector_->executor()->add(
+      [source = split->dataSource]() { source->prepare(); });
+}
+
 void TableScan::addDynamicFilter(
     column_index_t outputChannel,
     const std::shared_ptr<common::Filter>& filter) {
   if (dataSource_) {
     dataSource_->addDynamicFilter(outputChannel, filter);
-  } else {
-    pendingDynamicFilters_.emplace(outputChannel, filter);
   }
+  dynamicFilters_.emplace(outputChannel, filter);
 }
 
 } // namespace facebook::velox::exec
@@ -17,6 +17,7 @@
 
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Split.h"
 
 namespace facebook::velox::exec {
 
@@ -25,7 +26,8 @@ class TableScan : public SourceOperator {
   TableScan(
       int32_t operatorId,
       DriverCtx* driverCtx,
-      std::shared_ptr<const core::TableScanNode> tableScanNode);
+      std::shared_ptr<const core::TableScanNode> tableScanNode,
+      std::optional<int64_t> maxRows = std::nullopt);
 
   RowVectorPtr getOutput() override;
 
@@ -53,11 +55,25 @@ class TableScan : public SourceOperator {
   // Adjust batch size according to split information.
   void setBatchSize();
 
+  // Finishes without reading the remaining splits. Called when the Drivers
+  // of the scan have produced 'maxRows' rows together.
+  void finishEarly();
+
+  // Adds the runtime stats of 'dataSource_' to the stats of 'this'.
+  void addDataSourceStats();
+
+  // Sets 'split->dataSource' to a DataSource that is given 'split' on the
+  // connector executor.
+  void preload(const std::shared_ptr<connector::ConnectorSplit>& split);
+
   const std::shared_ptr<connector::ConnectorTableHandle> tableHandle_;
   const std::
       unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
           columnHandles_;
   DriverCtx* driverCtx_;
+  // True if the pipeline may add and retire Drivers at runtime. See
+  // Task::adjustDriverParallelism().
+  const bool adaptiveDrivers_;
   ContinueFuture blockingFuture_{ContinueFuture::makeEmpty()};
   BlockingReason blockingReason_;
   bool needNewSplit_ = true;
@@ -65,10 +81,20 @@ class TableScan : public SourceOperator {
   std::shared_ptr<connector::ConnectorQueryCtx> connectorQueryCtx_;
   std::shared_ptr<connector::DataSource> dataSource_;
   bool noMoreSplits_ = false;
-  // Dynamic filters to add to the data source when it gets created.
+  // Dynamic filters to add to the data source when it gets created and to
+  // the data sources of preloaded splits.
   std::unordered_map<column_index_t, std::shared_ptr<common::Filter>>
-      pendingDynamicFilters_;
+      dynamicFilters_;
+  // Number of queued splits to preload. 0 if the connector does not support
+  // preloading.
+  int32_t maxPreloadSplits_{0};
+  ConnectorSplitPreloadFunc splitPreloader_{nullptr};
   int32_t readBatchSize_{kDefaultBatchSize};
+  // The number of rows the Drivers of the scan may still produce together if
+  // a Limit consumes the scan. Shared by the Drivers. Reads are capped by it
+  // and the scan finishes once it is used up, without reading the remaining
+  // splits.
+  std::shared_ptr<std::atomic<int64_t>> rowBudget_;
 
   // String shown in ExceptionContext inside DataSource and LazyVector loading.
   std::string debugString_;
@@ -15,9 +15,13 @@
  */
 
 #include "velox/exec/TableWriter.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/PrefixSort.h"
 #include "velox/exec/Task.h"
 #include "velox/vector/FlatVector.h"
 
+#include <unordered_set>
+
 namespace facebook::velox::exec {
 
 TableWriter::TableWriter(
@@ -35,7 +39,9 @@ TableWriter::TableWriter(
       closed_(false),
       driverCtx_(driverCtx),
       insertTableHandle_(
-          tableWriteNode->insertTableHandle()->connectorInsertTableHandle()) {
+          tableWriteNode->insertTableHandle()->connectorInsertTableHandle()),
+      numBuckets_(tableWriteNode->numBuckets()),
+      mappedMemory_(operatorCtx_->mappedMemory()) {
   // For the time being the table writer supports one file
   // To extend it we can create a new data sink for each
   // partition
@@ -55,18 +61,88 @@ TableWriter::TableWriter(
   }
 
   mappedType_ = ROW(std::move(names), std::move(types));
+  if (numBuckets_ > 0 || !tableWriteNode->sortingKeys().empty()) {
+    initBuffer(*tableWriteNode, operatorId);
+  }
   const auto& config = driverCtx_->task->queryCtx()->config();
-  if (config.createEmptyFiles()) {
+  // The files of a bucketed write are made for the buckets with rows.
+  if (config.createEmptyFiles() && numBuckets_ == 0) {
     LOG(INFO) << "Enforce creating empty files\n";
     createDataSink();
   }
 }
 
+void TableWriter::initBuffer(
+    const core::TableWriteNode& tableWriteNode,
+    int32_t operatorId) {
+  if (numBuckets_ > 0) {
+    bucketFunction_ = tableWriteNode.bucketFunctionFactory()(numBuckets_);
+  }
+  spillConfig_ = makeOperatorSpillConfig(
+      *operatorCtx_->task()->queryCtx(),
+      *operatorCtx_,
+      core::QueryConfig::kTableWriterSpillEnabled,
+      core::QueryConfig::kTableWriterSpillCompressionCodec,
+      operatorId);
+
+  std::vector<TypePtr> keyTypes;
+  std::vector<std::string> names;
+  if (numBuckets_ > 0) {
+    keyTypes.push_back(INTEGER());
+    names.push_back("bucket");
+    keyCompareFlags_.push_back(CompareFlags{});
+  }
+  // Stores the sorting keys first so that the rows can be sorted and merged
+  // after spilling on the leading columns of 'data_'.
+  std::unordered_set<column_index_t> keyChannels;
+  const auto& sortingOrders = tableWriteNode.sortingOrders();
+  for (auto i = 0; i < tableWriteNode.sortingKeys().size(); ++i) {
+    const auto channel = tableWriteNode.columns()->getChildIdx(
+        tableWriteNode.sortingKeys()[i]->name());
+    columnMap_.emplace_back(keyTypes.size(), channel);
+    keyTypes.push_back(mappedType_->childAt(channel));
+    names.push_back(mappedType_->nameOf(channel));
+    keyCompareFlags_.push_back(
+        {sortingOrders[i].isNullsFirst(),
+         sortingOrders[i].isAscending(),
+         false,
+         false});
+    keyChannels.insert(channel);
+  }
+  numKeys_ = keyTypes.size();
+
+  std::vector<TypePtr> dependentTypes;
+  for (auto channel = 0; channel < mappedType_->size(); ++channel) {
+    if (keyChannels.count(channel) != 0) {
+      continue;
+    }
+    columnMap_.emplace_back(numKeys_ + dependentTypes.size(), channel);
+    dependentTypes.push_back(mappedType_->childAt(channel));
+    names.push_back(mappedType_->nameOf(channel));
+  }
+  std::vector<TypePtr> types = keyTypes;
+  types.insert(types.end(), dependentTypes.begin(), dependentTypes.end());
+  data_ = std::make_unique<RowContainer>(
+      keyTypes, dependentTypes, mappedMemory_);
+  internalStoreType_ = ROW(std::move(names), std::move(types));
+  batchSize_ = std::max<uint32_t>(
+      driverCtx_->queryConfig().preferredOutputBatchSize(),
+      data_->estimatedNumRowsPerBatch(kBatchSizeInBytes));
+}
+
 void TableWriter::createDataSink() {
   dataSink_ = connector_->createDataSink(
       mappedType_, insertTableHandle_, connectorQueryCtx_.get());
 }
 
+void TableWriter::closeDataSink() {
+  dataSink_->close();
+  for (const auto& [name, counter] : dataSink_->runtimeStats()) {
+    stats_.addRuntimeStat(name, counter);
+  }
+  dataSink_.reset();
+}
+
 void TableWriter::addInput(RowVectorPtr input) {
   if (input->size() == 0) {
     return;
@@ -86,12 +162,311 @@ void TableWriter::addInput(RowVectorPtr input) {
       mappedChildren,
       input->getNullCount());
 
+  numWrittenRows_ += input->size();
+  if (isBuffered()) {
+    bufferInput(mappedInput);
+    return;
+  }
   // Lazily instantiate data sink to prevent leftover empty files.
   if (!dataSink_) {
     createDataSink();
   }
   dataSink_->appendData(mappedInput);
-  numWrittenRows_ += input->size();
+}
+
+void TableWriter::bufferInput(const RowVectorPtr& input) {
+  ensureInputFits(input);
+
+  const auto numInput = input->size();
+  newRows_.resize(numInput);
+  for (auto i = 0; i < numInput; ++i) {
+    newRows_[i] = data_->newRow();
+  }
+  SelectivityVector allRows(numInput);
+  DecodedVector decoded;
+  if (bucketFunction_ != nullptr) {
+    bucketFunction_->partition(*input, buckets_);
+    auto bucketVector =
+        BaseVector::create<FlatVector<int32_t>>(INTEGER(), numInput, pool());
+    for (auto i = 0; i < numInput; ++i) {
+      bucketVector->set(i, buckets_[i]);
+    }
+    decoded.decode(*bucketVector, allRows);
+    for (auto i = 0; i < numInput; ++i) {
+      data_->store(decoded, i, newRows_[i], 0);
+    }
+  }
+  for (const auto& projection : columnMap_) {
+    decoded.decode(*input->childAt(projection.outputChannel), allRows);
+    for (auto i = 0; i < numInput; ++i) {
+      data_->store(decoded, i, newRows_[i], projection.inputChannel);
+    }
+  }
+  numRows_ += numInput;
+  updateSpillStats();
+}
+
+void TableWriter::ensureInputFits(const RowVectorPtr& input) {
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    return;
+  }
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t outOfLineBytesPerRow = outOfLineBytes / numRows;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    const int64_t rowsToSpill = std::max<int64_t>(1, numRows / 10);
+    spill(
+        numRows - rowsToSpill,
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    return;
+  }
+
+  auto tracker = mappedMemory_->tracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->getCurrentUserBytes();
+  const int64_t incrementBytes =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0);
+  if (tracker->getAvailableReservation() > 2 * incrementBytes) {
+    return;
+  }
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  // The Task may spill another operator that holds more memory, or 'this'.
+  if (operatorCtx_->reclaimFromTask(targetIncrementBytes) &&
+      (data_->numRows() < numRows ||
+       tracker->maybeReserve(targetIncrementBytes))) {
+    return;
+  }
+  const int64_t rowsToSpill = std::max<int64_t>(
+      1, targetIncrementBytes / (data_->fixedRowSize() + outOfLineBytesPerRow));
+  spill(
+      std::max<int64_t>(0, numRows - rowsToSpill),
+      std::max<int64_t>(
+          0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+}
+
+void TableWriter::spill(int64_t targetRows, int64_t targetBytes) {
+  VELOX_CHECK_GE(targetRows, 0);
+  VELOX_CHECK_GE(targetBytes, 0);
+
+  if (spiller_ == nullptr) {
+    VELOX_DCHECK(mappedMemory_->tracker() != nullptr);
+    const auto& spillConfig = spillConfig_.value();
+    const auto spillFileSize = mappedMemory_->tracker()->getCurrentUserBytes() *
+        spillConfig.fileSizeFactor;
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kOrderBy,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        internalStoreType_,
+        numKeys_,
+        keyCompareFlags_,
+        spillConfig.filePath,
+        spillFileSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.writeOptions);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  spiller_->spill(targetRows, targetBytes);
+}
+
+void TableWriter::updateSpillStats() {
+  if (spiller_ == nullptr) {
+    return;
+  }
+  const auto stats = spiller_->stats();
+  stats_.spilledBytes = stats.spilledBytes;
+  stats_.spilledRows = stats.spilledRows;
+  stats_.spilledPartitions = stats.spilledPartitions;
+  stats_.spilledUncompressedBytes = stats.spilledUncompressedBytes;
+  stats_.spilledFiles = stats.spilledFiles;
+  stats_.spillWriteTimeUs = stats.spillWriteTimeUs;
+  stats_.spillReadTimeUs = stats.spillReadTimeUs;
+  stats_.spillPeakDiskBytes = operatorCtx_->spillDiskTracker().peakBytes();
+}
+
+BlockingReason TableWriter::isBlocked(ContinueFuture* future) {
+  // Takes no more input while the spill files of the query are over budget.
+  if (spillConfig_.has_value() && !noMoreInput_ &&
+      operatorCtx_->waitForSpillDisk(future)) {
+    return BlockingReason::kWaitForSpill;
+  }
+  return BlockingReason::kNotBlocked;
+}
+
+void TableWriter::noMoreInput() {
+  Operator::noMoreInput();
+  if (!isBuffered()) {
+    close();
+    return;
+  }
+  if (spiller_ == nullptr) {
+    VELOX_CHECK_EQ(numRows_, data_->numRows());
+    sortedRows_.resize(numRows_);
+    RowContainerIterator iter;
+    data_->listRows(&iter, numRows_, sortedRows_.data());
+    PrefixSort::sort(
+        *data_,
+        PrefixSort::leadingKeys(numKeys_, keyCompareFlags_),
+        folly::Range<char**>(sortedRows_.data(), sortedRows_.size()));
+  } else {
+    // There is a single spill partition, so all rows are spilled or in the
+    // merge.
+    auto nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    spillMerge_ = spiller_->startMerge(0, spillConfig_->readOptions);
+    spillSources_.resize(batchSize_);
+    spillSourceRows_.resize(batchSize_);
+  }
+}
+
+void TableWriter::nextBatch() {
+  const vector_size_t size =
+      std::min<size_t>(numRows_ - numRowsWritten_, batchSize_);
+  if (batch_ != nullptr) {
+    VectorPtr batch = std::move(batch_);
+    BaseVector::prepareForReuse(batch, size);
+    batch_ = std::static_pointer_cast<RowVector>(batch);
+  } else {
+    batch_ = std::static_pointer_cast<RowVector>(
+        BaseVector::create(internalStoreType_, size, pool()));
+  }
+  for (auto& child : batch_->children()) {
+    child->resize(size);
+  }
+
+  if (spillMerge_ == nullptr) {
+    for (auto column = 0; column < internalStoreType_->size(); ++column) {
+      data_->extractColumn(
+          sortedRows_.data() + numRowsWritten_,
+          size,
+          column,
+          batch_->childAt(column));
+    }
+    numRowsWritten_ += size;
+    return;
+  }
+
+  vector_size_t batchRow = 0;
+  vector_size_t numSources = 0;
+  bool isEndOfBatch = false;
+  while (batchRow + numSources < size) {
+    auto* stream = spillMerge_->next();
+    VELOX_CHECK_NOT_NULL(stream);
+    spillSources_[numSources] = &stream->current();
+    spillSourceRows_[numSources] = stream->currentIndex(&isEndOfBatch);
+    ++numSources;
+    if (FOLLY_UNLIKELY(isEndOfBatch)) {
+      // The rows must be copied before pop() replaces the batch of 'stream'.
+      gatherCopy(
+          batch_.get(), batchRow, numSources, spillSources_, spillSourceRows_);
+      batchRow += numSources;
+      numSources = 0;
+    }
+    stream->pop();
+  }
+  if (numSources != 0) {
+    gatherCopy(
+        batch_.get(), batchRow, numSources, spillSources_, spillSourceRows_);
+  }
+  numRowsWritten_ += size;
+}
+
+void TableWriter::writeBatch() {
+  const auto size = batch_->size();
+  std::vector<VectorPtr> columns(mappedType_->size());
+  for (const auto& projection : columnMap_) {
+    columns[projection.outputChannel] =
+        batch_->childAt(projection.inputChannel);
+  }
+  auto rows = std::make_shared<RowVector>(
+      pool(), mappedType_, nullptr, size, std::move(columns));
+  if (numBuckets_ == 0) {
+    if (!dataSink_) {
+      createDataSink();
+    }
+    dataSink_->appendData(rows);
+    return;
+  }
+
+  const auto* buckets =
+      batch_->childAt(0)->asFlatVector<int32_t>()->rawValues();
+  vector_size_t begin = 0;
+  while (begin < size) {
+    const auto bucket = buckets[begin];
+    auto end = begin + 1;
+    while (end < size && buckets[end] == bucket) {
+      ++end;
+    }
+    if (bucket != currentBucket_) {
+      VELOX_CHECK_GT(bucket, currentBucket_);
+      if (dataSink_) {
+        closeDataSink();
+      }
+      dataSink_ = connector_->createDataSink(
+          mappedType_,
+          insertTableHandle_->bucketHandle(bucket),
+          connectorQueryCtx_.get());
+      currentBucket_ = bucket;
+    }
+    dataSink_->appendData(
+        begin == 0 && end == size ? rows : rows->slice(begin, end - begin));
+    begin = end;
+  }
+}
+
+void TableWriter::close() {
+  if (!closed_) {
+    if (dataSink_) {
+      closeDataSink();
+    }
+    closed_ = true;
+  }
+}
+
+int64_t TableWriter::reclaimableBytes() const {
+  if (isBuffered()) {
+    if (!spillConfig_.has_value() || noMoreInput_ || data_->numRows() == 0) {
+      return 0;
+    }
+    return data_->allocatedBytes();
+  }
+  if (closed_ || !dataSink_) {
+    return 0;
+  }
+  return dataSink_->reclaimableBytes();
+}
+
+void TableWriter::reclaim() {
+  if (isBuffered()) {
+    spill(0, 0);
+    return;
+  }
+  dataSink_->reclaim();
 }
 
 RowVectorPtr TableWriter::getOutput() {
@@ -99,6 +474,15 @@ RowVectorPtr TableWriter::getOutput() {
   if (!noMoreInput_ || finished_) {
     return nullptr;
   }
+  if (isBuffered()) {
+    if (numRowsWritten_ < numRows_) {
+      nextBatch();
+      writeBatch();
+      return nullptr;
+    }
+    close();
+    updateSpillStats();
+  }
   finished_ = true;
 
   auto rowsWritten = std::dynamic_pointer_cast<FlatVector<int64_t>>(
@@ -18,11 +18,19 @@
 
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
 /**
  * The class implements a simple table writer VELOX operator
+ *
+ * If the table is bucketed or sorted, see core::TableWriteNode, the input
+ * rows are stored in a RowContainer with the bucket number and the sorting
+ * keys as keys and are sorted on these after the last input, spilling like
+ * OrderBy if they do not fit. The sorted rows are then written a batch per
+ * getOutput() call, the rows of each bucket to a data sink of their own.
  */
 class TableWriter : public Operator {
  public:
@@ -31,29 +39,17 @@ class TableWriter : public Operator {
       DriverCtx* driverCtx,
       const std::shared_ptr<const core::TableWriteNode>& tableWriteNode);
 
-  BlockingReason isBlocked(ContinueFuture* /* future */) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   void addInput(RowVectorPtr input) override;
 
-  void noMoreInput() override {
-    Operator::noMoreInput();
-    close();
-  }
+  void noMoreInput() override;
 
   virtual bool needsInput() const override {
-    return true;
+    return !noMoreInput_;
   }
 
-  void close() override {
-    if (!closed_) {
-      if (dataSink_) {
-        dataSink_->close();
-      }
-      closed_ = true;
-    }
-  }
+  void close() override;
 
   RowVectorPtr getOutput() override;
 
@@ -61,9 +57,49 @@ class TableWriter : public Operator {
     return finished_;
   }
 
+  // Returns the memory of the buffered rows if the write is sorted or
+  // bucketed, otherwise of the data buffered in the data sink.
+  int64_t reclaimableBytes() const override;
+
+  // Spills the buffered rows or makes the data sink write out its buffered
+  // data, e.g. flush a stripe early.
+  void reclaim() override;
+
  private:
+  static constexpr int32_t kBatchSizeInBytes{2 * 1024 * 1024};
+
+  bool isBuffered() const {
+    return data_ != nullptr;
+  }
+
+  // Sets up buffering the rows of a bucketed or sorted write in 'data_'.
+  void initBuffer(
+      const core::TableWriteNode& tableWriteNode,
+      int32_t operatorId);
+
   void createDataSink();
 
+  // Closes 'dataSink_' and adds its runtime stats to the stats of 'this'.
+  void closeDataSink();
+
+  // Adds 'input' to 'data_' with the bucket number of each row.
+  void bufferInput(const RowVectorPtr& input);
+
+  // Same as OrderBy::ensureInputFits().
+  void ensureInputFits(const RowVectorPtr& input);
+
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  void updateSpillStats();
+
+  // Fills 'batch_' with the next rows in the order of their buckets and
+  // sorting keys.
+  void nextBatch();
+
+  // Writes the rows of 'batch_' a run of rows of a bucket at a time, opening
+  // the data sink of a bucket at its first row.
+  void writeBatch();
+
   std::vector<column_index_t> inputMapping_;
   std::shared_ptr<const RowType> mappedType_;
   vector_size_t numWrittenRows_;
@@ -74,5 +110,47 @@ class TableWriter : public Operator {
   std::shared_ptr<connector::ConnectorQueryCtx> connectorQueryCtx_;
   std::shared_ptr<connector::DataSink> dataSink_;
   std::shared_ptr<connector::ConnectorInsertTableHandle> insertTableHandle_;
+
+  // Number of bucket files. 0 if not bucketed.
+  const int32_t numBuckets_;
+  std::unique_ptr<core::PartitionFunction> bucketFunction_;
+  memory::MappedMemory* FOLLY_NONNULL const mappedMemory_;
+  std::optional<Spiller::Config> spillConfig_;
+
+  // The bucket number if bucketed, followed by the sorting keys and the
+  // other columns of 'mappedType_'. nullptr if the rows are written in input
+  // order.
+  std::unique_ptr<RowContainer> data_;
+  RowTypePtr internalStoreType_;
+  // Number of leading key columns of 'internalStoreType_'.
+  int32_t numKeys_{0};
+  std::vector<CompareFlags> keyCompareFlags_;
+  // Maps the columns of 'internalStoreType_' to the columns of 'mappedType_'.
+  std::vector<IdentityProjection> columnMap_;
+  std::unique_ptr<Spiller> spiller_;
+  uint64_t spillTestCounter_{0};
+
+  // Maximum number of rows in 'batch_'.
+  vector_size_t batchSize_{0};
+  size_t numRows_{0};
+  size_t numRowsWritten_{0};
+
+  // 'data_' rows in write order if not spilled.
+  std::vector<char*> sortedRows_;
+
+  // Merges the spilled and unspilled rows if spilled.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
+
+  // Sorted rows of 'internalStoreType_' being written.
+  RowVectorPtr batch_;
+
+  // The bucket of 'dataSink_', -1 before the first.
+  int32_t currentBucket_{-1};
+
+  // Reusable memory.
+  std::vector<uint32_t> buckets_;
+  std::vector<char*> newRows_;
 };
 } // namespace facebook::velox::exec
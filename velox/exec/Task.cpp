@@ -16,12 +16,14 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <folly/ScopeGuard.h>
 #include <string>
 
 #include "velox/codegen/Codegen.h"
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/time/Timer.h"
 #include "velox/exec/CrossJoinBuild.h"
+#include "velox/exec/DriverTrace.h"
 #include "velox/exec/Exchange.h"
 #include "velox/exec/HashBuild.h"
 #include "velox/exec/LocalPlanner.h"
@@ -151,6 +153,9 @@ Task::Task(
       consumerSupplier_(std::move(consumerSupplier)),
       onError_(onError),
       bufferManager_(PartitionedOutputBufferManager::getInstance()) {
+  if (queryCtx_->config().driverTraceEnabled()) {
+    driverTraceId_ = newDriverTraceId();
+  }
   auto memoryUsageTracker = pool_->getMemoryUsageTracker();
   if (memoryUsageTracker) {
     memoryUsageTracker->setMakeMemoryCapExceededMessage(
@@ -171,6 +176,11 @@ Task::~Task() {
   } catch (const std::exception& e) {
     LOG(WARNING) << "Caught exception in ~Task(): " << e.what();
   }
+  if (reclaimerId_.has_value()) {
+    queryCtx_->pool()->getMemoryUsageTracker()->removeReclaimer(
+        reclaimerId_.value());
+  }
+  process::releaseNumaNode(numaNode_, numNumaThreads_);
   // NOTE: this is a hack to enforce destruction on 'planFragment_'. We found in
   // some case the task dtor doesn't call 'planFragment_' dtor which cause the
   // memory leak of the vectors held by the plan node such as Value node.
@@ -334,6 +344,25 @@ void Task::start(
     self->taskStats_.executionStartTimeMs = getCurrentTimeMs();
   }
 
+  // Lets the memory arbitrator of the process revoke memory from the query
+  // by spilling the operators of 'self'.
+  if (const auto& tracker = self->queryCtx_->pool()->getMemoryUsageTracker()) {
+    self->reclaimerId_ = tracker->addReclaimer(
+        [weakTask = std::weak_ptr<Task>(self)](int64_t targetBytes) {
+          auto task = weakTask.lock();
+          if (task == nullptr || !task->isRunning()) {
+            return int64_t{0};
+          }
+          try {
+            return task->reclaimMemory(nullptr, targetBytes);
+          } catch (const std::exception& e) {
+            LOG(ERROR) << "Error reclaiming memory from task "
+                       << task->taskId() << ": " << e.what();
+            return int64_t{0};
+          }
+        });
+  }
+
 #if CODEGEN_ENABLED == 1
   const auto& config = self->queryCtx()->config();
   if (config.codegenEnabled() &&
@@ -376,6 +405,12 @@ void Task::start(
         factory->inputDriver, factory->outputDriver);
   }
 
+  if (self->queryCtx()->config().numaAwareTasks()) {
+    self->numNumaThreads_ = self->numDriversPerSplitGroup_ *
+        (self->isUngroupedExecution() ? 1 : concurrentSplitGroups);
+    self->numaNode_ = process::reserveNumaNode(self->numNumaThreads_);
+  }
+
   // Register self for possible memory recovery callback. Do this
   // after sizing 'drivers_' but before starting the
   // Drivers. 'drivers_' can be read by memory recovery or
@@ -401,7 +436,7 @@ void Task::start(
       self->hasPartitionedOutput_ = true;
       bufferManager->initializeTask(
           self,
-          partitionedOutputNode->isBroadcast(),
+          partitionedOutputNode->kind(),
           partitionedOutputNode->numPartitions(),
           self->numDriversInPartitionedOutput_ * numSplitGroups);
     }
@@ -430,6 +465,21 @@ void Task::start(
     self->createSplitGroupStateLocked(self, 0);
     self->createDriversLocked(self, 0, drivers);
 
+    // Drivers are added from inside 'mutex_', which does not work with an
+    // inline executor.
+    if (self->queryCtx()->config().adaptiveMaxDriversPerPipeline() > 0 &&
+        !dynamic_cast<const folly::InlineLikeExecutor*>(
+            self->queryCtx()->executor())) {
+      for (auto pipeline = 0; pipeline < numPipelines; ++pipeline) {
+        const auto& factory = self->driverFactories_[pipeline];
+        if (factory->supportsAdaptiveDrivers()) {
+          auto& state = self->adaptivePipelines_[pipeline];
+          state.numActiveDrivers = factory->numDrivers;
+          state.numCreatedDrivers = factory->numDrivers;
+        }
+      }
+    }
+
     // Set and start all Drivers together inside 'mutex_' so that cancellations
     // and pauses have well defined timing. For example, do not pause and
     // restart a task while it is still adding Drivers.
@@ -619,6 +669,23 @@ void Task::removeDriver(std::shared_ptr<Task> self, Driver* driver) {
   }
 }
 
+bool Task::hasMemoryForSplitGroupLocked() const {
+  if (numRunningSplitGroups_ == 0) {
+    return true;
+  }
+  const auto fraction = queryCtx_->config().splitGroupsMemoryFraction();
+  const auto& tracker = pool_->getMemoryUsageTracker();
+  if (fraction <= 0 || tracker == nullptr ||
+      tracker->maxTotalBytes() == memory::kMaxMemory) {
+    return true;
+  }
+  // Assumes that the next group uses as much memory as the average running
+  // group.
+  const auto usedBytes = tracker->getCurrentTotalBytes();
+  return usedBytes + usedBytes / numRunningSplitGroups_ <=
+      tracker->maxTotalBytes() * fraction;
+}
+
 void Task::ensureSplitGroupsAreBeingProcessedLocked(
     std::shared_ptr<Task>& self) {
   // Only try creating more drivers if we are running.
@@ -628,6 +695,11 @@ void Task::ensureSplitGroupsAreBeingProcessedLocked(
 
   while (numRunningSplitGroups_ < concurrentSplitGroups_ and
          not queuedSplitGroups_.empty()) {
+    if (!hasMemoryForSplitGroupLocked()) {
+      // Retried when a running group finishes and frees its memory.
+      ++taskStats_.numMemoryDeferredSplitGroups;
+      break;
+    }
     const uint32_t splitGroupId = queuedSplitGroups_.front();
     queuedSplitGroups_.pop();
 
@@ -902,24 +974,36 @@ BlockingReason Task::getSplitOrFuture(
     uint32_t splitGroupId,
     const core::PlanNodeId& planNodeId,
     exec::Split& split,
-    ContinueFuture& future) {
+    ContinueFuture& future,
+    int32_t maxPreloadSplits,
+    const ConnectorSplitPreloadFunc& preload) {
   std::lock_guard<std::mutex> l(mutex_);
 
   auto& splitsState = splitsStates_[planNodeId];
 
   if (isUngroupedExecution()) {
     return getSplitOrFutureLocked(
-        splitsState.groupSplitsStores[0], split, future);
+        splitsState.groupSplitsStores[0],
+        split,
+        future,
+        maxPreloadSplits,
+        preload);
   } else {
     return getSplitOrFutureLocked(
-        splitsState.groupSplitsStores[splitGroupId], split, future);
+        splitsState.groupSplitsStores[splitGroupId],
+        split,
+        future,
+        maxPreloadSplits,
+        preload);
   }
 }
 
 BlockingReason Task::getSplitOrFutureLocked(
     SplitsStore& splitsStore,
     exec::Split& split,
-    ContinueFuture& future) {
+    ContinueFuture& future,
+    int32_t maxPreloadSplits,
+    const ConnectorSplitPreloadFunc& preload) {
   if (splitsStore.splits.empty()) {
     if (splitsStore.noMoreSplits) {
       return BlockingReason::kNotBlocked;
@@ -932,6 +1016,16 @@ BlockingReason Task::getSplitOrFutureLocked(
   }
 
   split = getSplitLocked(splitsStore);
+  if (preload) {
+    const auto numSplits =
+        std::min<size_t>(maxPreloadSplits, splitsStore.splits.size());
+    for (auto i = 0; i < numSplits; ++i) {
+      auto& connectorSplit = splitsStore.splits[i].connectorSplit;
+      if (connectorSplit && !connectorSplit->dataSource) {
+        preload(connectorSplit);
+      }
+    }
+  }
   return BlockingReason::kNotBlocked;
 }
 
@@ -949,6 +1043,70 @@ exec::Split Task::getSplitLocked(SplitsStore& splitsStore) {
   return split;
 }
 
+bool Task::adjustDriverParallelism(const DriverCtx& driverCtx) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = adaptivePipelines_.find(driverCtx.pipelineId);
+  if (it == adaptivePipelines_.end() || !isRunningLocked()) {
+    return false;
+  }
+  auto& state = it->second;
+  const auto& config = queryCtx_->config();
+  const auto nowMs = getCurrentTimeMs();
+  if (nowMs - state.lastChangeTimeMs < config.adaptiveDriversIntervalMs()) {
+    return false;
+  }
+
+  const auto pipelineId = driverCtx.pipelineId;
+  const auto& factory = driverFactories_[pipelineId];
+  auto& splitGroupState = splitGroupStates_[0];
+  const auto& memoryManager =
+      splitGroupState.localExchanges.at(factory->consumerNode->id())
+          .memoryManager;
+  const auto bufferedBytes = memoryManager->bufferedBytes();
+  if (bufferedBytes >= memoryManager->maxBufferSize()) {
+    // The consumers are behind and the producers are blocked.
+    if (state.numActiveDrivers <= 1) {
+      return false;
+    }
+    --state.numActiveDrivers;
+    state.lastChangeTimeMs = nowMs;
+    ++taskStats_.numRetiredDrivers;
+    return true;
+  }
+
+  const auto& splitsStore = splitsStates_[factory->planNodes.front()->id()]
+                                .groupSplitsStores[0];
+  if (bufferedBytes > 0 ||
+      splitsStore.splits.size() <= state.numActiveDrivers ||
+      state.numActiveDrivers >= config.adaptiveMaxDriversPerPipeline()) {
+    return false;
+  }
+
+  // The consumers are starved and there is work for one more Driver. The
+  // calling Driver is a producer of the local exchange that has not finished,
+  // so the new Driver can still register as a producer.
+  auto self = shared_from_this();
+  const auto driverId = state.numCreatedDrivers;
+  auto driver = factory->createDriver(
+      std::make_unique<DriverCtx>(self, driverId, pipelineId, 0, driverId),
+      exchangeClients_[pipelineId],
+      [self](size_t i) {
+        return i < self->driverFactories_.size()
+            ? self->driverFactories_[i]->numTotalDrivers
+            : 0;
+      });
+  ++state.numCreatedDrivers;
+  ++state.numActiveDrivers;
+  state.lastChangeTimeMs = nowMs;
+  ++taskStats_.numAddedDrivers;
+  ++numTotalDrivers_;
+  ++numRunningDrivers_;
+  ++splitGroupState.numRunningDrivers;
+  drivers_.push_back(driver);
+  Driver::enqueue(std::move(driver));
+  return false;
+}
+
 void Task::splitFinished() {
   std::lock_guard<std::mutex> l(mutex_);
   ++taskStats_.numFinishedSplits;
@@ -1395,6 +1553,34 @@ void Task::addOperatorStats(OperatorStats& stats) {
   stats.clear();
 }
 
+std::string Task::driverTrace() const {
+  VELOX_USER_CHECK_NE(
+      driverTraceId_,
+      0,
+      "Drivers of Task {} are not traced, set {}",
+      taskId_,
+      core::QueryConfig::kDriverTraceEnabled);
+  auto events = driverTraceEvents(driverTraceId_);
+  std::vector<std::vector<std::string>> operatorTypes;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (const auto& pipelineStats : taskStats_.pipelineStats) {
+      auto& types = operatorTypes.emplace_back();
+      for (const auto& operatorStats : pipelineStats.operatorStats) {
+        types.push_back(operatorStats.operatorType);
+      }
+    }
+  }
+  return driverTraceToJson(
+      events, [&](int32_t pipelineId, int32_t operatorId) -> std::string {
+        if (pipelineId < operatorTypes.size() &&
+            operatorId < operatorTypes[pipelineId].size()) {
+          return operatorTypes[pipelineId][operatorId];
+        }
+        return fmt::format("{}", operatorId);
+      });
+}
+
 uint64_t Task::timeSinceStartMs() const {
   std::lock_guard<std::mutex> l(mutex_);
   if (taskStats_.executionStartTimeMs == 0UL) {
@@ -1767,6 +1953,59 @@ ContinueFuture Task::requestPauseLocked(bool pause) {
   return makeFinishFutureLocked("Task::requestPause");
 }
 
+int64_t Task::reclaimMemory(Driver* driver, int64_t targetBytes) {
+  // The caller does not count as on thread while it waits for the other
+  // drivers to go off thread or for another driver to finish reclaiming.
+  std::optional<SuspendedSection> suspended;
+  if (driver != nullptr) {
+    suspended.emplace(driver);
+  }
+  std::lock_guard<std::mutex> reclaimLock(reclaimMutex_);
+  requestPause(true).wait();
+  auto resumeGuard = folly::makeGuard([this]() {
+    try {
+      Task::resume(shared_from_this());
+    } catch (const std::exception& e) {
+      // A failed Task is not resumed. Its drivers see the error.
+      LOG(ERROR) << "Error resuming task " << taskId_
+                 << " after reclaiming memory: " << e.what();
+    }
+  });
+
+  std::vector<std::pair<int64_t, Operator*>> candidates;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (const auto& taskDriver : drivers_) {
+      if (taskDriver == nullptr) {
+        continue;
+      }
+      for (auto* op : taskDriver->operators()) {
+        if (const auto bytes = op->reclaimableBytes(); bytes > 0) {
+          candidates.emplace_back(bytes, op);
+        }
+      }
+    }
+  }
+  std::sort(
+      candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+      });
+
+  int64_t reclaimedBytes = 0;
+  for (auto& [bytes, op] : candidates) {
+    if (reclaimedBytes >= targetBytes) {
+      break;
+    }
+    op->reclaim();
+    const auto opReclaimedBytes = bytes - op->reclaimableBytes();
+    op->stats().addRuntimeStat(
+        "taskReclaimedBytes",
+        RuntimeCounter(opReclaimedBytes, RuntimeCounter::Unit::kBytes));
+    reclaimedBytes += opReclaimedBytes;
+  }
+  return reclaimedBytes;
+}
+
 Task::TaskCompletionNotifier::~TaskCompletionNotifier() {
   notify();
 }
@@ -1960,6 +2199,17 @@ static std::string getQueryMemoryUsageString(memory::MemoryPool* queryPool) {
   return out.str();
 }
 
+std::shared_ptr<std::atomic<int64_t>> Task::getScanRowBudgetLocked(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId,
+    int64_t maxRows) {
+  auto& budget = splitGroupStates_[splitGroupId].scanRowBudgets[planNodeId];
+  if (!budget) {
+    budget = std::make_shared<std::atomic<int64_t>>(maxRows);
+  }
+  return budget;
+}
+
 std::shared_ptr<SpillOperatorGroup> Task::getSpillOperatorGroupLocked(
     uint32_t splitGroupId,
     const core::PlanNodeId& planNodeId) {
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #pragma once
+#include "velox/common/process/Numa.h"
 #include "velox/core/PlanFragment.h"
 #include "velox/core/QueryCtx.h"
 #include "velox/exec/Driver.h"
@@ -92,6 +93,26 @@ class Task : public std::enable_shared_from_this<Task> {
     return queryCtx_;
   }
 
+  /// Returns the NUMA node the Drivers run on or process::kNoNumaNode if the
+  /// Task is not placed on a node. See QueryConfig::kNumaAwareTasks.
+  int32_t numaNode() const {
+    return numaNode_;
+  }
+
+  /// Returns the id of the Driver trace of 'this' or 0 if
+  /// QueryConfig::kDriverTraceEnabled is not set.
+  uint64_t driverTraceId() const {
+    return driverTraceId_;
+  }
+
+  /// Returns the timeline of the Drivers in the Chrome trace event format,
+  /// which the Chrome trace viewer and Perfetto open. Each Driver has the
+  /// intervals it was queued, on thread and blocked, with the blocking reason
+  /// and the operator that had the thread. The events are kept in per-thread
+  /// ring buffers, so a long running Task has only its latest events. Throws
+  /// if QueryConfig::kDriverTraceEnabled is not set.
+  std::string driverTrace() const;
+
   /// Returns MemoryPool used to allocate memory during execution. This instance
   /// is a child of the MemoryPool passed in the constructor.
   memory::MemoryPool* FOLLY_NONNULL pool() const {
@@ -238,6 +259,12 @@ class Task : public std::enable_shared_from_this<Task> {
     return numDrivers(getOutputPipelineId());
   }
 
+  /// Returns the number of drivers of the pipeline with 'pipelineId' in each
+  /// split group.
+  uint32_t numDrivers(int pipelineId) const {
+    return driverFactories_[pipelineId]->numDrivers;
+  }
+
   /// Returns the number of running drivers.
   uint32_t numRunningDrivers() const {
     std::lock_guard<std::mutex> taskLock(mutex_);
@@ -287,17 +314,30 @@ class Task : public std::enable_shared_from_this<Task> {
   // specified ID. If there are no splits and no-more-splits signal has been
   // received, sets split to null and returns kNotBlocked. Otherwise, returns
   // kWaitForSplit and sets a future that will complete when split becomes
-  // available or no-more-splits signal is received.
+  // available or no-more-splits signal is received. Calls 'preload' on the
+  // connector splits of up to 'maxPreloadSplits' splits that are queued
+  // after 'split' and are not yet preloaded.
   BlockingReason getSplitOrFuture(
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId,
       exec::Split& split,
-      ContinueFuture& future);
+      ContinueFuture& future,
+      int32_t maxPreloadSplits = 0,
+      const ConnectorSplitPreloadFunc& preload = nullptr);
 
   void splitFinished();
 
   void multipleSplitsFinished(int32_t numSplits);
 
+  // Called by the TableScan of a Driver in a pipeline that adapts its number
+  // of Drivers before it takes a split. Adds a Driver to the pipeline while
+  // the local exchange that the pipeline feeds is drained and splits are
+  // queued. Returns true while the local exchange is full and the pipeline
+  // has other active Drivers; the calling Driver then retires, i.e. finishes
+  // without taking more splits. Changes are at least
+  // QueryConfig::kAdaptiveDriversIntervalMs apart.
+  bool adjustDriverParallelism(const DriverCtx& driverCtx);
+
   /// Adds a MergeSource for the specified splitGroupId and planNodeId.
   std::shared_ptr<MergeSource> addLocalMergeSource(
       uint32_t splitGroupId,
@@ -400,6 +440,14 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId);
 
+  // Returns the number of rows the Drivers of the TableScan 'planNodeId'
+  // may still produce together in 'splitGroupId'. The first caller sets it
+  // to 'maxRows'. Used for stopping the scan under a Limit early.
+  std::shared_ptr<std::atomic<int64_t>> getScanRowBudgetLocked(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId,
+      int64_t maxRows);
+
   // Transitions this to kFinished state if all Drivers are
   // finished. Otherwise sets a flag so that the last Driver to finish
   // will transition the state.
@@ -456,6 +504,15 @@ class Task : public std::enable_shared_from_this<Task> {
 
   ContinueFuture requestPauseLocked(bool pause);
 
+  /// Frees at least 'targetBytes' of memory, if possible, by reclaiming the
+  /// operators of 'this' with the most reclaimable memory first, see
+  /// Operator::reclaim(). Called from a running 'driver' of 'this' or, with
+  /// a null 'driver', from a thread that does not run 'this', e.g. by the
+  /// memory arbitrator of the process. 'driver' is suspended and the other
+  /// drivers are paused while reclaiming. Only one driver reclaims at a
+  /// time. Returns the bytes freed.
+  int64_t reclaimMemory(Driver* FOLLY_NULLABLE driver, int64_t targetBytes);
+
   // Requests activity of 'this' to stop. The returned future will be
   // realized when the last thread stops running for 'this'. This is used to
   // mark cancellation by the user.
@@ -544,7 +601,9 @@ class Task : public std::enable_shared_from_this<Task> {
   BlockingReason getSplitOrFutureLocked(
       SplitsStore& splitsStore,
       exec::Split& split,
-      ContinueFuture& future);
+      ContinueFuture& future,
+      int32_t maxPreloadSplits,
+      const ConnectorSplitPreloadFunc& preload);
 
   /// Returns next split from the store. The caller must ensure the store is not
   /// empty.
@@ -567,6 +626,10 @@ class Task : public std::enable_shared_from_this<Task> {
   /// processed. If yes, creates split group state and Drivers and runs them.
   void ensureSplitGroupsAreBeingProcessedLocked(std::shared_ptr<Task>& self);
 
+  /// Returns true if another split group fits in the memory of the Task. See
+  /// QueryConfig::kSplitGroupsMemoryFraction.
+  bool hasMemoryForSplitGroupLocked() const;
+
   void driverClosedLocked();
 
   /// Returns true if Task is in kRunning state, but all output drivers finished
@@ -626,10 +689,6 @@ class Task : public std::enable_shared_from_this<Task> {
     return driverFactories_[pipelineId]->outputDriver;
   }
 
-  uint32_t numDrivers(int pipelineId) const {
-    return driverFactories_[pipelineId]->numDrivers;
-  }
-
   int getOutputPipelineId() const;
 
   /// Callback function added to the MemoryUsageTracker to return a descriptive
@@ -762,6 +821,13 @@ class Task : public std::enable_shared_from_this<Task> {
   std::exception_ptr exception_ = nullptr;
   mutable std::mutex mutex_;
 
+  // Serializes the calls to reclaimMemory().
+  std::mutex reclaimMutex_;
+
+  // Id of the reclaimer of 'this' in the tracker of the query pool, set if
+  // the query pool has a tracker.
+  std::optional<uint64_t> reclaimerId_;
+
   ConsumerSupplier consumerSupplier_;
 
   // The function that is executed when the task encounters its first error,
@@ -793,6 +859,15 @@ class Task : public std::enable_shared_from_this<Task> {
   uint32_t numDriversInPartitionedOutput_{0};
   /// The number of splits groups we run concurrently.
   uint32_t concurrentSplitGroups_{1};
+  /// The pipelines that add and retire Drivers at runtime, keyed on pipeline
+  /// id. Only in ungrouped execution.
+  std::unordered_map<int, AdaptivePipelineState> adaptivePipelines_;
+  /// The NUMA node the Drivers run on and the number of threads reserved on
+  /// it.
+  int32_t numaNode_{process::kNoNumaNode};
+  int32_t numNumaThreads_{0};
+  /// Id of the Driver trace, 0 if the Drivers are not traced.
+  uint64_t driverTraceId_{0};
 
   /// Have we initialized operators' stats already?
   bool initializedOpStats_{false};
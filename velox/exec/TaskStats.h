@@ -45,6 +45,9 @@ struct TaskStats {
   int32_t numRunningSplits{0};
   int32_t numQueuedSplits{0};
   std::unordered_set<int32_t> completedSplitGroups;
+  // Number of times a queued split group was not started because the running
+  // groups used too much memory. See QueryConfig::kSplitGroupsMemoryFraction.
+  int32_t numMemoryDeferredSplitGroups{0};
 
   // The subscript is given by each Operator's
   // DriverCtx::pipelineId. This is a sum total reflecting fully
@@ -67,5 +70,10 @@ struct TaskStats {
   // Epoch time (ms) when the task completed, e.g. all splits were processed and
   // results have been consumed.
   uint64_t endTimeMs{0};
+
+  // Number of Drivers added to and retired from pipelines at runtime. See
+  // QueryConfig::kAdaptiveMaxDriversPerPipeline.
+  int32_t numAddedDrivers{0};
+  int32_t numRetiredDrivers{0};
 };
 } // namespace facebook::velox::exec
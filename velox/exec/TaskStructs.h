@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #pragma once
+#include <atomic>
 #include <limits>
 #include <unordered_set>
 #include <vector>
@@ -67,6 +68,17 @@ struct SplitsState {
   SplitsState& operator=(SplitsState const&) = delete;
 };
 
+/// State of a pipeline whose number of Drivers changes at runtime.
+struct AdaptivePipelineState {
+  /// Drivers of the pipeline that run and are not retiring.
+  uint32_t numActiveDrivers{0};
+  /// Drivers created for the pipeline, including the initial ones. Gives the
+  /// id of the next Driver.
+  uint32_t numCreatedDrivers{0};
+  /// Epoch time (ms) of the last change of the number of Drivers.
+  uint64_t lastChangeTimeMs{0};
+};
+
 /// Stores local exchange queues with the memory manager.
 struct LocalExchangeState {
   std::shared_ptr<LocalExchangeMemoryManager> memoryManager;
@@ -98,6 +110,11 @@ struct SplitGroupState {
   /// Map of local exchanges keyed on LocalPartition plan node ID.
   std::unordered_map<core::PlanNodeId, LocalExchangeState> localExchanges;
 
+  /// Map of the rows the Drivers of a TableScan consumed by a Limit may still
+  /// produce, keyed on TableScan plan node ID.
+  std::unordered_map<core::PlanNodeId, std::shared_ptr<std::atomic<int64_t>>>
+      scanRowBudgets;
+
   /// Drivers created and still running for this split group.
   /// The split group is finished when this numbers reaches zero.
   uint32_t numRunningDrivers{0};
@@ -117,6 +134,7 @@ struct SplitGroupState {
     localMergeSources.clear();
     mergeJoinSources.clear();
     localExchanges.clear();
+    scanRowBudgets.clear();
   }
 };
 
@@ -15,9 +15,76 @@
  */
 #include "velox/exec/TopN.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Task.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
+namespace {
+// Returns the output channels of the distinct sorting keys of 'topNNode' in
+// order, with their sort orders. A repeated sorting key doesn't change the
+// order and is skipped.
+std::vector<std::pair<column_index_t, core::SortOrder>> distinctSortingKeys(
+    const RowTypePtr& type,
+    const core::TopNNode& topNNode) {
+  std::vector<std::pair<column_index_t, core::SortOrder>> keys;
+  for (int i = 0; i < topNNode.sortingKeys().size(); ++i) {
+    auto channel = exprToChannel(topNNode.sortingKeys()[i].get(), type);
+    VELOX_CHECK(
+        channel != kConstantChannel,
+        "TopN doesn't allow constant comparison keys");
+    if (std::find_if(keys.begin(), keys.end(), [&](const auto& key) {
+          return key.first == channel;
+        }) == keys.end()) {
+      keys.emplace_back(channel, topNNode.sortingOrders()[i]);
+    }
+  }
+  return keys;
+}
+
+// Stores the sorting keys first in the row container, followed by the other
+// columns.
+std::vector<IdentityProjection> makeColumnMap(
+    const RowTypePtr& type,
+    const core::TopNNode& topNNode) {
+  std::vector<IdentityProjection> columnMap;
+  std::vector<bool> isKey(type->size(), false);
+  for (const auto& key : distinctSortingKeys(type, topNNode)) {
+    columnMap.emplace_back(columnMap.size(), key.first);
+    isKey[key.first] = true;
+  }
+  for (column_index_t channel = 0; channel < type->size(); ++channel) {
+    if (!isKey[channel]) {
+      columnMap.emplace_back(columnMap.size(), channel);
+    }
+  }
+  return columnMap;
+}
+
+std::vector<CompareFlags> makeKeyCompareFlags(
+    const RowTypePtr& type,
+    const core::TopNNode& topNNode) {
+  std::vector<CompareFlags> compareFlags;
+  for (const auto& key : distinctSortingKeys(type, topNNode)) {
+    compareFlags.push_back(
+        {key.second.isNullsFirst(), key.second.isAscending(), false, false});
+  }
+  return compareFlags;
+}
+
+RowTypePtr makeInternalStoreType(
+    const RowTypePtr& type,
+    const std::vector<IdentityProjection>& columnMap) {
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (const auto& projection : columnMap) {
+    names.push_back(type->nameOf(projection.outputChannel));
+    types.push_back(type->childAt(projection.outputChannel));
+  }
+  return ROW(std::move(names), std::move(types));
+}
+} // namespace
+
 TopN::TopN(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -29,43 +96,45 @@ TopN::TopN(
           topNNode->id(),
           "TopN"),
       count_(topNNode->count()),
+      spillMemoryThreshold_(
+          driverCtx->queryConfig().topNSpillMemoryThreshold()),
+      spillConfig_(makeOperatorSpillConfig(
+          *operatorCtx_->task()->queryCtx(),
+          *operatorCtx_,
+          core::QueryConfig::kTopNSpillEnabled,
+          core::QueryConfig::kTopNSpillCompressionCodec,
+          operatorId)),
+      columnMap_(makeColumnMap(outputType_, *topNNode)),
+      keyCompareFlags_(makeKeyCompareFlags(outputType_, *topNNode)),
+      internalStoreType_(makeInternalStoreType(outputType_, columnMap_)),
       data_(std::make_unique<RowContainer>(
-          outputType_->children(),
+          std::vector<TypePtr>(
+              internalStoreType_->children().begin(),
+              internalStoreType_->children().begin() +
+                  keyCompareFlags_.size()),
+          std::vector<TypePtr>(
+              internalStoreType_->children().begin() + keyCompareFlags_.size(),
+              internalStoreType_->children().end()),
           operatorCtx_->mappedMemory())),
-      comparator_(
-          outputType_,
-          topNNode->sortingKeys(),
-          topNNode->sortingOrders(),
-          data_.get()),
+      comparator_(keyCompareFlags_, data_.get()),
       topRows_(comparator_),
       decodedVectors_(outputType_->children().size()) {}
 
-TopN::Comparator::Comparator(
-    const RowTypePtr& type,
-    const std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>&
-        sortingKeys,
-    const std::vector<core::SortOrder>& sortingOrders,
-    RowContainer* rowContainer)
-    : rowContainer_(rowContainer) {
-  auto numKeys = sortingKeys.size();
-  for (int i = 0; i < numKeys; ++i) {
-    auto channel = exprToChannel(sortingKeys[i].get(), type);
-    VELOX_CHECK(
-        channel != kConstantChannel,
-        "TopN doesn't allow constant comparison keys");
-    keyInfo_.push_back(std::make_pair(channel, sortingOrders[i]));
-  }
-}
-
 void TopN::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   SelectivityVector allRows(input->size());
 
   // TODO Decode keys first, then decode the rest only for passing positions
-  for (int col = 0; col < input->childrenSize(); ++col) {
-    decodedVectors_[col].decode(*input->childAt(col), allRows);
+  for (const auto& projection : columnMap_) {
+    decodedVectors_[projection.inputChannel].decode(
+        *input->childAt(projection.outputChannel), allRows);
   }
 
   for (int row = 0; row < input->size(); ++row) {
+    if (spillCutoff_ != nullptr && isAboveSpillCutoff(input, row)) {
+      continue;
+    }
     char* newRow = nullptr;
     if (topRows_.size() < count_) {
       newRow = data_->newRow();
@@ -86,6 +155,149 @@ void TopN::addInput(RowVectorPtr input) {
 
     topRows_.push(newRow);
   }
+
+  if (spiller_ != nullptr) {
+    const auto stats = spiller_->stats();
+    stats_.spilledBytes = stats.spilledBytes;
+    stats_.spilledRows = stats.spilledRows;
+    stats_.spilledPartitions = stats.spilledPartitions;
+    stats_.spilledUncompressedBytes = stats.spilledUncompressedBytes;
+    stats_.spilledFiles = stats.spilledFiles;
+    stats_.spillWriteTimeUs = stats.spillWriteTimeUs;
+    stats_.spillPeakDiskBytes = operatorCtx_->spillDiskTracker().peakBytes();
+  }
+}
+
+bool TopN::isAboveSpillCutoff(const RowVectorPtr& input, vector_size_t row)
+    const {
+  for (auto i = 0; i < keyCompareFlags_.size(); ++i) {
+    const auto result = input->childAt(columnMap_[i].outputChannel)
+                            ->compare(
+                                spillCutoff_->childAt(i).get(),
+                                row,
+                                0,
+                                keyCompareFlags_[i])
+                            .value();
+    if (result != 0) {
+      return result > 0;
+    }
+  }
+  // A row equal to the cutoff is not needed either.
+  return true;
+}
+
+void TopN::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    spill();
+    return;
+  }
+
+  auto tracker = operatorCtx_->mappedMemory()->tracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->getCurrentUserBytes();
+  if (spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) {
+    spill();
+    return;
+  }
+
+  // Once the heap is full, the rows of the input replace rows in the heap and
+  // only need space for variable length data.
+  const int64_t numNewRows = std::min<int64_t>(
+      input->size(), std::max<int64_t>(0, count_ - topRows_.size()));
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+  if (freeRows > numNewRows &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    return;
+  }
+
+  const int64_t incrementBytes =
+      data_->sizeIncrement(numNewRows, outOfLineBytes ? flatInputBytes : 0);
+  if (tracker->getAvailableReservation() > 2 * incrementBytes) {
+    return;
+  }
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  // The Task may spill another operator that holds more memory, or 'this'.
+  if (operatorCtx_->reclaimFromTask(targetIncrementBytes) &&
+      (data_->numRows() < numRows ||
+       tracker->maybeReserve(targetIncrementBytes))) {
+    return;
+  }
+  spill();
+}
+
+int64_t TopN::reclaimableBytes() const {
+  if (!spillConfig_.has_value() || noMoreInput_ || data_->numRows() == 0) {
+    return 0;
+  }
+  return data_->allocatedBytes();
+}
+
+void TopN::reclaim() {
+  spill();
+}
+
+void TopN::spill() {
+  if (spiller_ == nullptr) {
+    auto* mappedMemory = operatorCtx_->mappedMemory();
+    VELOX_DCHECK(mappedMemory->tracker() != nullptr);
+    const auto& spillConfig = spillConfig_.value();
+    const auto spillFileSize = mappedMemory->tracker()->getCurrentUserBytes() *
+        spillConfig.fileSizeFactor;
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kOrderBy,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        internalStoreType_,
+        data_->keyTypes().size(),
+        keyCompareFlags_,
+        spillConfig.filePath,
+        spillFileSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.writeOptions);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+
+  if (topRows_.size() == count_) {
+    // The run has 'count_' rows that are not greater than its top row, so no
+    // greater row can be in the output. The rows in 'topRows_' are all below
+    // the previous cutoff, so the top row is the new cutoff.
+    char* top = topRows_.top();
+    if (spillCutoff_ == nullptr) {
+      spillCutoff_ =
+          BaseVector::create<RowVector>(internalStoreType_, 1, pool());
+    }
+    for (auto i = 0; i < keyCompareFlags_.size(); ++i) {
+      data_->extractColumn(&top, 1, i, spillCutoff_->childAt(i));
+    }
+  }
+  // The spiller erases the spilled rows from 'data_'.
+  topRows_ = decltype(topRows_)(comparator_);
+  spiller_->spill(0, 0);
 }
 
 RowVectorPtr TopN::getOutput() {
@@ -93,6 +305,10 @@ RowVectorPtr TopN::getOutput() {
     return nullptr;
   }
 
+  if (spillMerge_ != nullptr) {
+    return getOutputWithSpill();
+  }
+
   uint32_t numRowsToReturn =
       std::min(kMaxNumRowsToReturn, rows_.size() - numRowsReturned_);
   VELOX_CHECK(numRowsToReturn > 0);
@@ -100,20 +316,95 @@ RowVectorPtr TopN::getOutput() {
   auto result = std::dynamic_pointer_cast<RowVector>(
       BaseVector::create(outputType_, numRowsToReturn, operatorCtx_->pool()));
 
-  for (int i = 0; i < outputType_->size(); ++i) {
+  for (const auto& projection : columnMap_) {
     data_->extractColumn(
         rows_.data() + numRowsReturned_,
         numRowsToReturn,
-        i,
-        result->childAt(i));
+        projection.inputChannel,
+        result->childAt(projection.outputChannel));
   }
   numRowsReturned_ += numRowsToReturn;
   finished_ = (numRowsReturned_ == rows_.size());
   return result;
 }
 
+RowVectorPtr TopN::getOutputWithSpill() {
+  const auto maxRows =
+      std::min<size_t>(kMaxNumRowsToReturn, count_ - numRowsReturned_);
+  spillSources_.resize(maxRows);
+  spillSourceRows_.resize(maxRows);
+  auto result = BaseVector::create<RowVector>(outputType_, maxRows, pool());
+
+  int32_t outputRow = 0;
+  int32_t outputSize = 0;
+  bool isEndOfBatch = false;
+  while (outputRow + outputSize < maxRows) {
+    SpillMergeStream* stream = spillMerge_->next();
+    if (stream == nullptr) {
+      break;
+    }
+    spillSources_[outputSize] = &stream->current();
+    spillSourceRows_[outputSize] = stream->currentIndex(&isEndOfBatch);
+    ++outputSize;
+    if (FOLLY_UNLIKELY(isEndOfBatch)) {
+      // The stream is at end of input batch. Need to copy out the rows before
+      // fetching next batch in 'pop'.
+      gatherCopy(
+          result.get(),
+          outputRow,
+          outputSize,
+          spillSources_,
+          spillSourceRows_,
+          columnMap_);
+      outputRow += outputSize;
+      outputSize = 0;
+    }
+    stream->pop();
+  }
+  if (outputSize != 0) {
+    gatherCopy(
+        result.get(),
+        outputRow,
+        outputSize,
+        spillSources_,
+        spillSourceRows_,
+        columnMap_);
+    outputRow += outputSize;
+  }
+
+  numRowsReturned_ += outputRow;
+  stats_.spillReadTimeUs = spiller_->state().ioStats().readTimeUs;
+  if (outputRow < maxRows || numRowsReturned_ == count_) {
+    finished_ = true;
+    spillMerge_.reset();
+  }
+  if (outputRow == 0) {
+    return nullptr;
+  }
+  result->resize(outputRow);
+  return result;
+}
+
+BlockingReason TopN::isBlocked(ContinueFuture* future) {
+  // Takes no more input while the spill files of the query are over budget.
+  if (spillConfig_.has_value() && !noMoreInput_ &&
+      operatorCtx_->waitForSpillDisk(future)) {
+    return BlockingReason::kWaitForSpill;
+  }
+  return BlockingReason::kNotBlocked;
+}
+
 void TopN::noMoreInput() {
   Operator::noMoreInput();
+  if (spiller_ != nullptr) {
+    // The rows left in 'data_' are merged with the spilled runs. There is only
+    // one spill partition, so all of them go to the spill runs.
+    topRows_ = decltype(topRows_)(comparator_);
+    Spiller::SpillRows nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    spillMerge_ = spiller_->startMerge(0, spillConfig_->readOptions);
+    return;
+  }
   if (topRows_.empty()) {
     finished_ = true;
     return;
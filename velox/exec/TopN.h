@@ -17,9 +17,14 @@
 
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
+/// Keeps the top N rows of the input in a heap over the rows of a
+/// RowContainer. If spilling is enabled and the heap does not fit in memory,
+/// it is spilled as a sorted run and emptied. Once all input is received, the
+/// runs are merged and the first N rows of the merge are returned.
 class TopN : public Operator {
  public:
   TopN(
@@ -37,34 +42,32 @@ class TopN : public Operator {
 
   void noMoreInput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override;
 
+  int64_t reclaimableBytes() const override;
+
+  void reclaim() override;
+
  private:
   static constexpr size_t kMaxNumRowsToReturn = 1024;
   class Comparator {
    public:
+    // Compares on the keys of 'rowContainer' with 'keyCompareFlags'.
     Comparator(
-        const RowTypePtr& outputType,
-        const std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>&
-            sortingKeys,
-        const std::vector<core::SortOrder>& sortingOrders,
-        RowContainer* rowContainer);
+        const std::vector<CompareFlags>& keyCompareFlags,
+        RowContainer* rowContainer)
+        : keyCompareFlags_(keyCompareFlags), rowContainer_(rowContainer) {}
 
     // Returns true if lhs < rhs, false otherwise.
     bool operator()(const char* lhs, const char* rhs) {
       if (lhs == rhs) {
         return false;
       }
-      for (auto& key : keyInfo_) {
-        if (auto result = rowContainer_->compare(
-                lhs,
-                rhs,
-                key.first,
-                {key.second.isNullsFirst(), key.second.isAscending(), false})) {
+      for (auto i = 0; i < keyCompareFlags_.size(); ++i) {
+        if (auto result =
+                rowContainer_->compare(lhs, rhs, i, keyCompareFlags_[i])) {
           return result < 0;
         }
       }
@@ -72,17 +75,18 @@ class TopN : public Operator {
     }
 
     // Returns true if lhs < decodeVectors[index], false otherwise.
+    // 'decodedVectors' are indexed on the columns of the RowContainer.
     bool operator()(
         const char* lhs,
         const std::vector<DecodedVector>& decodedVectors,
         vector_size_t index) {
-      for (auto& key : keyInfo_) {
+      for (auto i = 0; i < keyCompareFlags_.size(); ++i) {
         if (auto result = rowContainer_->compare(
                 lhs,
-                rowContainer_->columnAt(key.first),
-                decodedVectors[key.first],
+                rowContainer_->columnAt(i),
+                decodedVectors[i],
                 index,
-                {key.second.isNullsFirst(), key.second.isAscending(), false})) {
+                keyCompareFlags_[i])) {
           return result < 0;
         }
       }
@@ -90,15 +94,47 @@ class TopN : public Operator {
     }
 
    private:
-    std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
+    std::vector<CompareFlags> keyCompareFlags_;
     RowContainer* rowContainer_;
   };
 
+  // Checks if input will fit in the existing memory and increases
+  // reservation if not. If reservation cannot be increased, spills the rows in
+  // 'topRows_'.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills the rows in 'topRows_' as a sorted run and empties it.
+  void spill();
+
+  // Returns true if 'row' of 'input' can't be in the output because the
+  // spilled rows have at least 'count_' rows that are not greater than it.
+  bool isAboveSpillCutoff(const RowVectorPtr& input, vector_size_t row) const;
+
+  RowVectorPtr getOutputWithSpill();
+
   const int32_t count_;
 
+  // The max memory that a TopN can hold before spilling. If it is zero, then
+  // there is no such limit.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
   bool finished_ = false;
   uint32_t numRowsReturned_ = 0;
 
+  // The map from the columns of 'data_' to the output columns. The distinct
+  // sorting keys are stored first as the keys of 'data_', so that the spiller
+  // can sort the rows on them, followed by the other columns.
+  std::vector<IdentityProjection> columnMap_;
+
+  // Compare flags of the keys of 'data_'.
+  std::vector<CompareFlags> keyCompareFlags_;
+
+  // The row type of 'data_' used for spilling.
+  RowTypePtr internalStoreType_;
+
   // As the inputs are added to TopN operator, we use topRows_ (a priority
   // queue) to keep track of the pointers to rows stored in the
   // RowContainer (data_). We only update the RowContainer if a row is a
@@ -114,5 +150,22 @@ class TopN : public Operator {
   std::vector<char*> rows_;
 
   std::vector<DecodedVector> decodedVectors_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  // The greatest row of the last spilled run with 'count_' rows, as a single
+  // row vector of 'internalStoreType_'. Null if there is no such run.
+  RowVectorPtr spillCutoff_;
+
+  // Set to read back spilled data if disk spilling has been triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // Record the source rows to copy to the output in order.
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
 };
 } // namespace facebook::velox::exec
@@ -148,6 +148,30 @@ class TreeOfLosers {
         : std::make_pair(streams_[lastIndex_].get(), result.second);
   }
 
+  // Returns the stream with the lowest first element other than the stream
+  // returned by the last next(), or nullptr if there is no other stream with
+  // data. These are the losers on the path of the last winner. The caller
+  // may take all the elements of the last winner that are not greater than
+  // the first element of the runner-up without calling next() in between.
+  // Must be called before popping from the last winner.
+  Stream* runnerUp() const {
+    if (lastIndex_ == kEmpty || values_.empty()) {
+      return nullptr;
+    }
+    TIndex best = kEmpty;
+    for (auto node = parent(firstStream_ + lastIndex_);; node = parent(node)) {
+      const auto candidate = values_[node];
+      if (candidate != kEmpty &&
+          (best == kEmpty || *streams_[candidate] < *streams_[best])) {
+        best = candidate;
+      }
+      if (node == 0) {
+        break;
+      }
+    }
+    return best == kEmpty ? nullptr : streams_[best].get();
+  }
+
  private:
   static constexpr TIndex kEmpty = std::numeric_limits<TIndex>::max();
 
@@ -357,4 +381,32 @@ class MergeArray {
   std::vector<std::unique_ptr<Stream>> streams_;
 };
 
+// Returns the number of leading elements in [0, 'size') for which
+// 'inRun(index)' is true. 'inRun' must be true for 0 and must not become
+// true again after it is false for an index, as is the case for the
+// elements of a sorted stream that are not greater than a given value. The
+// search gallops ahead in steps of 1, 2, 4 ... and then does a binary search
+// in the last step, so the cost is logarithmic in the length of the run.
+template <typename TIndex, typename InRun>
+TIndex gallopingRunSize(TIndex size, InRun inRun) {
+  VELOX_DCHECK_GT(size, 0);
+  // 'inRun' is true at 'low' and false at 'high' or 'high' is 'size'.
+  TIndex low = 0;
+  TIndex step = 1;
+  while (step < size - low && inRun(low + step)) {
+    low += step;
+    step *= 2;
+  }
+  TIndex high = std::min<TIndex>(size, low + step);
+  while (high - low > 1) {
+    const TIndex middle = low + (high - low) / 2;
+    if (inRun(middle)) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  return low + 1;
+}
+
 } // namespace facebook::velox
@@ -58,51 +58,48 @@ Unnest::Unnest(
 
 void Unnest::addInput(RowVectorPtr input) {
   input_ = std::move(input);
-}
-
-RowVectorPtr Unnest::getOutput() {
-  if (!input_) {
-    return nullptr;
-  }
+  nextInputRow_ = 0;
+  nextElement_ = 0;
 
-  auto size = input_->size();
+  const auto size = input_->size();
   inputRows_.resize(size);
 
   // The max number of elements at each row across all unnested columns.
-  auto maxSizes = AlignedBuffer::allocate<int64_t>(size, pool(), 0);
-  auto rawMaxSizes = maxSizes->asMutable<int64_t>();
-
-  std::vector<const vector_size_t*> rawSizes;
-  std::vector<const vector_size_t*> rawOffsets;
-  std::vector<const vector_size_t*> rawIndices;
+  maxSizes_ = AlignedBuffer::allocate<int64_t>(size, pool(), 0);
+  auto rawMaxSizes = maxSizes_->asMutable<int64_t>();
 
-  rawSizes.resize(unnestChannels_.size());
-  rawOffsets.resize(unnestChannels_.size());
-  rawIndices.resize(unnestChannels_.size());
+  rawSizes_.resize(unnestChannels_.size());
+  rawOffsets_.resize(unnestChannels_.size());
+  rawIndices_.resize(unnestChannels_.size());
 
+  uint64_t elementBytes = 0;
   for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
     const auto& unnestVector = input_->childAt(unnestChannels_[channel]);
     unnestDecoded_[channel].decode(*unnestVector, inputRows_);
 
     auto& currentDecoded = unnestDecoded_[channel];
-    rawIndices[channel] = currentDecoded.indices();
+    rawIndices_[channel] = currentDecoded.indices();
 
     const ArrayVector* unnestBaseArray;
     const MapVector* unnestBaseMap;
     if (unnestVector->typeKind() == TypeKind::ARRAY) {
       unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
-      rawSizes[channel] = unnestBaseArray->rawSizes();
-      rawOffsets[channel] = unnestBaseArray->rawOffsets();
+      rawSizes_[channel] = unnestBaseArray->rawSizes();
+      rawOffsets_[channel] = unnestBaseArray->rawOffsets();
+      elementBytes +=
+          averageRowBytes(*unnestBaseArray->elements()).value_or(0);
     } else {
       VELOX_CHECK(unnestVector->typeKind() == TypeKind::MAP);
       unnestBaseMap = currentDecoded.base()->as<MapVector>();
-      rawSizes[channel] = unnestBaseMap->rawSizes();
-      rawOffsets[channel] = unnestBaseMap->rawOffsets();
+      rawSizes_[channel] = unnestBaseMap->rawSizes();
+      rawOffsets_[channel] = unnestBaseMap->rawOffsets();
+      elementBytes += averageRowBytes(*unnestBaseMap->mapKeys()).value_or(0) +
+          averageRowBytes(*unnestBaseMap->mapValues()).value_or(0);
     }
 
     // Count max number of elements per row.
-    auto currentSizes = rawSizes[channel];
-    auto currentIndices = rawIndices[channel];
+    auto currentSizes = rawSizes_[channel];
+    auto currentIndices = rawIndices_[channel];
     for (auto row = 0; row < size; ++row) {
       if (!currentDecoded.isNullAt(row)) {
         auto unnestSize = currentSizes[currentIndices[row]];
@@ -113,25 +110,70 @@ RowVectorPtr Unnest::getOutput() {
     }
   }
 
-  // Calculate the number of rows in the unnest result.
-  int numElements = 0;
-  for (auto row = 0; row < size; ++row) {
-    numElements += rawMaxSizes[row];
+  // An output row has the replicated columns of its input row and an
+  // element of each unnested column.
+  uint64_t replicatedBytes = 0;
+  for (const auto& projection : identityProjections_) {
+    replicatedBytes +=
+        averageRowBytes(*input_->childAt(projection.inputChannel))
+            .value_or(0);
   }
+  outputRowBytes_ = replicatedBytes + elementBytes;
+}
+
+RowVectorPtr Unnest::getOutput() {
+  if (!input_) {
+    return nullptr;
+  }
+
+  const auto size = input_->size();
+  const auto* rawMaxSizes = maxSizes_->as<int64_t>();
+
+  // Takes input rows until the output batch is full. A row with more elements
+  // than fit in a batch is split over several batches, so that large arrays
+  // do not make arbitrarily large batches.
+  const vector_size_t maxOutputRows = outputBatchRows(outputRowBytes_);
+  const auto firstRow = nextInputRow_;
+  const auto firstElement = nextElement_;
+  vector_size_t numElements = 0;
+  auto inputRow = firstRow;
+  vector_size_t element = firstElement;
+  for (; inputRow < size; ++inputRow, element = 0) {
+    const vector_size_t rowElements = rawMaxSizes[inputRow] - element;
+    if (numElements + rowElements > maxOutputRows) {
+      element += maxOutputRows - numElements;
+      numElements = maxOutputRows;
+      break;
+    }
+    numElements += rowElements;
+  }
+  nextInputRow_ = inputRow;
+  nextElement_ = inputRow < size ? element : 0;
 
   if (numElements == 0) {
-    // All arrays/maps are null or empty.
+    // All remaining arrays/maps are null or empty.
     input_ = nullptr;
     return nullptr;
   }
 
+  // The rows of 'input_' in this batch are [firstRow, endRow). The first and
+  // last may be partly in the batch.
+  const auto endRow = std::min(nextInputRow_ + 1, size);
+  // Returns the range of the elements of 'row' that are in this batch.
+  auto elementRange = [&](vector_size_t row) {
+    return std::pair<vector_size_t, vector_size_t>(
+        row == firstRow ? firstElement : 0,
+        row == nextInputRow_ ? nextElement_ : rawMaxSizes[row]);
+  };
+
   // Create "indices" buffer to repeat rows as many times as there are elements
   // in the array (or map) in unnestDecoded.
   auto repeatedIndices = allocateIndices(numElements, pool());
   auto* rawRepeatedIndices = repeatedIndices->asMutable<vector_size_t>();
   vector_size_t index = 0;
-  for (auto row = 0; row < size; ++row) {
-    for (auto i = 0; i < rawMaxSizes[row]; i++) {
+  for (auto row = firstRow; row < endRow; ++row) {
+    const auto [begin, end] = elementRange(row);
+    for (auto i = begin; i < end; ++i) {
       rawRepeatedIndices[index++] = row;
     }
   }
@@ -147,43 +189,75 @@ RowVectorPtr Unnest::getOutput() {
   vector_size_t outputsIndex = identityProjections_.size();
   for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
     auto& currentDecoded = unnestDecoded_[channel];
-    auto currentSizes = rawSizes[channel];
-    auto currentOffsets = rawOffsets[channel];
-    auto currentIndices = rawIndices[channel];
-
-    BufferPtr elementIndices = allocateIndices(numElements, pool());
-    auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
-
-    auto nulls =
-        AlignedBuffer::allocate<bool>(numElements, pool(), bits::kNotNull);
-    auto rawNulls = nulls->asMutable<uint64_t>();
-
-    // Make dictionary index for elements column since they may be out of order.
+    auto currentSizes = rawSizes_[channel];
+    auto currentOffsets = rawOffsets_[channel];
+    auto currentIndices = rawIndices_[channel];
+
+    // The elements of the batch can be a slice of the elements of the base
+    // vector if they are consecutive and need no null padding.
+    std::optional<vector_size_t> firstOffset;
+    bool contiguous = true;
     index = 0;
-    bool identityMapping = true;
-    for (auto row = 0; row < size; ++row) {
-      auto maxSize = rawMaxSizes[row];
-
-      if (!currentDecoded.isNullAt(row)) {
-        auto offset = currentOffsets[currentIndices[row]];
-        auto unnestSize = currentSizes[currentIndices[row]];
-
-        if (index != offset || unnestSize < maxSize) {
-          identityMapping = false;
-        }
-
-        for (auto i = 0; i < unnestSize; i++) {
-          rawElementIndices[index++] = offset + i;
-        }
+    for (auto row = firstRow; row < endRow; ++row) {
+      const auto [begin, end] = elementRange(row);
+      if (begin == end) {
+        continue;
+      }
+      if (currentDecoded.isNullAt(row) ||
+          currentSizes[currentIndices[row]] < end) {
+        contiguous = false;
+        break;
+      }
+      const auto offset = currentOffsets[currentIndices[row]] + begin;
+      if (!firstOffset.has_value()) {
+        firstOffset = offset;
+      } else if (offset != firstOffset.value() + index) {
+        contiguous = false;
+        break;
+      }
+      index += end - begin;
+    }
 
-        for (auto i = unnestSize; i < maxSize; ++i) {
-          bits::setNull(rawNulls, index++, true);
+    auto makeOutput = [&](const VectorPtr& elements,
+                          const BufferPtr& elementIndices,
+                          const BufferPtr& nulls) -> VectorPtr {
+      if (contiguous) {
+        if (firstOffset.value() == 0 && numElements == elements->size()) {
+          return elements;
         }
-      } else if (maxSize > 0) {
-        identityMapping = false;
-
-        for (auto i = 0; i < maxSize; ++i) {
-          bits::setNull(rawNulls, index++, true);
+        return elements->slice(firstOffset.value(), numElements);
+      }
+      return wrapChild(numElements, elementIndices, elements, nulls);
+    };
+
+    BufferPtr elementIndices;
+    BufferPtr nulls;
+    if (!contiguous) {
+      // Make dictionary index for elements column since they may be out of
+      // order.
+      elementIndices = allocateIndices(numElements, pool());
+      auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
+      nulls =
+          AlignedBuffer::allocate<bool>(numElements, pool(), bits::kNotNull);
+      auto rawNulls = nulls->asMutable<uint64_t>();
+
+      index = 0;
+      for (auto row = firstRow; row < endRow; ++row) {
+        const auto [begin, end] = elementRange(row);
+        if (!currentDecoded.isNullAt(row)) {
+          const auto offset = currentOffsets[currentIndices[row]];
+          const auto unnestSize = currentSizes[currentIndices[row]];
+          for (auto i = begin; i < end; ++i) {
+            if (i < unnestSize) {
+              rawElementIndices[index++] = offset + i;
+            } else {
+              bits::setNull(rawNulls, index++, true);
+            }
+          }
+        } else {
+          for (auto i = begin; i < end; ++i) {
+            bits::setNull(rawNulls, index++, true);
+          }
         }
       }
     }
@@ -192,25 +266,16 @@ RowVectorPtr Unnest::getOutput() {
       // Construct unnest column using Array elements wrapped using above
       // created dictionary.
       auto unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseArray->elements()
-          : wrapChild(
-                numElements,
-                elementIndices,
-                unnestBaseArray->elements(),
-                nulls);
+      outputs[outputsIndex++] =
+          makeOutput(unnestBaseArray->elements(), elementIndices, nulls);
     } else {
       // Construct two unnest columns for Map keys and values vectors wrapped
       // using above created dictionary.
       auto unnestBaseMap = currentDecoded.base()->as<MapVector>();
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseMap->mapKeys()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapKeys(), nulls);
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseMap->mapValues()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapValues(), nulls);
+      outputs[outputsIndex++] =
+          makeOutput(unnestBaseMap->mapKeys(), elementIndices, nulls);
+      outputs[outputsIndex++] =
+          makeOutput(unnestBaseMap->mapValues(), elementIndices, nulls);
     }
   }
 
@@ -221,17 +286,19 @@ RowVectorPtr Unnest::getOutput() {
     // Set the ordinality at each result row to be the index of the element in
     // the original array (or map) plus one.
     auto rawOrdinality = ordinalityVector->mutableRawValues();
-    for (auto row = 0; row < size; ++row) {
-      auto maxSize = rawMaxSizes[row];
-      std::iota(rawOrdinality, rawOrdinality + maxSize, 1);
-      rawOrdinality += maxSize;
+    for (auto row = firstRow; row < endRow; ++row) {
+      const auto [begin, end] = elementRange(row);
+      std::iota(rawOrdinality, rawOrdinality + end - begin, begin + 1);
+      rawOrdinality += end - begin;
     }
 
     // Ordinality column is always at the end.
     outputs.back() = std::move(ordinalityVector);
   }
 
-  input_ = nullptr;
+  if (nextInputRow_ == size) {
+    input_ = nullptr;
+  }
   return std::make_shared<RowVector>(
       pool(), outputType_, BufferPtr(nullptr), numElements, std::move(outputs));
 }
@@ -29,7 +29,7 @@ class Unnest : public Operator {
   }
 
   bool needsInput() const override {
-    return true;
+    return !input_;
   }
 
   void addInput(RowVectorPtr input) override;
@@ -44,6 +44,26 @@ class Unnest : public Operator {
   SelectivityVector inputRows_;
   std::vector<DecodedVector> unnestDecoded_;
 
+  // The sizes, offsets and indices of the decoded unnested columns of
+  // 'input_'.
+  std::vector<const vector_size_t*> rawSizes_;
+  std::vector<const vector_size_t*> rawOffsets_;
+  std::vector<const vector_size_t*> rawIndices_;
+
+  // The max number of elements of each row of 'input_' across all unnested
+  // columns.
+  BufferPtr maxSizes_;
+
+  // The first row of 'input_' that is not fully in an output batch yet.
+  vector_size_t nextInputRow_{0};
+
+  // The first element of 'nextInputRow_' that is not in an output batch yet.
+  // Non-zero if the row has more elements than fit in a batch.
+  vector_size_t nextElement_{0};
+
+  // The estimated size of an output row for 'input_'.
+  std::optional<uint64_t> outputRowBytes_;
+
   const bool withOrdinality_;
 };
 } // namespace facebook::velox::exec
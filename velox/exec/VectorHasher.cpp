@@ -93,18 +93,17 @@ void VectorHasher::hashValues(
       result[row] = mix ? bits::hashMix(result[row], hash) : hash;
     });
   } else {
-    cachedHashes_.resize(decoded_.base()->size());
-    std::fill(cachedHashes_.begin(), cachedHashes_.end(), kNullHash);
+    auto* cachedHashes = dictionaryCache(dictionaryHashes_, kNullHash);
     rows.applyToSelected([&](vector_size_t row) {
       if (decoded_.isNullAt(row)) {
         result[row] = mix ? bits::hashMix(result[row], kNullHash) : kNullHash;
         return;
       }
       auto baseIndex = decoded_.index(row);
-      uint64_t hash = cachedHashes_[baseIndex];
+      uint64_t hash = cachedHashes[baseIndex];
       if (hash == kNullHash) {
         hash = hashOne<Kind>(decoded_, row);
-        cachedHashes_[baseIndex] = hash;
+        cachedHashes[baseIndex] = hash;
       }
       result[row] = mix ? bits::hashMix(result[row], hash) : hash;
     });
@@ -246,9 +245,7 @@ template <typename T, bool mayHaveNulls>
 bool VectorHasher::makeValueIdsDecoded(
     const SelectivityVector& rows,
     uint64_t* result) {
-  cachedHashes_.resize(decoded_.base()->size());
-  std::fill(cachedHashes_.begin(), cachedHashes_.end(), 0);
-
+  auto* cachedIds = dictionaryCache(dictionaryIds_, 0);
   auto indices = decoded_.indices();
   auto values = decoded_.data<T>();
 
@@ -263,7 +260,7 @@ bool VectorHasher::makeValueIdsDecoded(
       }
     }
     auto baseIndex = indices[row];
-    uint64_t id = cachedHashes_[baseIndex];
+    uint64_t id = cachedIds[baseIndex];
     if (id == 0) {
       T value = values[baseIndex];
 
@@ -279,7 +276,7 @@ bool VectorHasher::makeValueIdsDecoded(
         success = false;
         return;
       }
-      cachedHashes_[baseIndex] = id;
+      cachedIds[baseIndex] = id;
     }
     result[row] = multiplier_ == 1 ? id : result[row] + multiplier_ * id;
   });
@@ -521,6 +518,49 @@ void VectorHasher::lookupValueIds(
       noNulls);
 }
 
+void VectorHasher::decode(
+    const BaseVector& vector,
+    const SelectivityVector& rows) {
+  decoded_.decode(vector, rows);
+  if ((typeKind_ == TypeKind::VARCHAR || typeKind_ == TypeKind::VARBINARY) &&
+      !decoded_.isIdentityMapping() && !decoded_.isConstantMapping()) {
+    trackDictionary(vector);
+  }
+}
+
+void VectorHasher::trackDictionary(const BaseVector& vector) {
+  VectorPtr base;
+  for (auto* wrapper = &vector;
+       wrapper->encoding() == VectorEncoding::Simple::DICTIONARY;
+       wrapper = base.get()) {
+    base = wrapper->valueVector();
+  }
+  if (base.get() != decoded_.base()) {
+    // Not a chain of dictionaries over the decoded base, e.g. a lazy base.
+    return;
+  }
+  if (base == dictionaryBase_) {
+    return;
+  }
+  dictionaryBase_ = std::move(base);
+  const auto size = dictionaryBase_->size();
+  dictionaryHashes_.resize(size);
+  std::fill(dictionaryHashes_.begin(), dictionaryHashes_.end(), kNullHash);
+  dictionaryIds_.resize(size);
+  clearDictionaryIds();
+}
+
+uint64_t* VectorHasher::dictionaryCache(
+    raw_vector<uint64_t>& cache,
+    uint64_t empty) {
+  if (dictionaryBase_ && dictionaryBase_.get() == decoded_.base()) {
+    return cache.data();
+  }
+  cachedHashes_.resize(decoded_.base()->size());
+  std::fill(cachedHashes_.begin(), cachedHashes_.end(), empty);
+  return cachedHashes_.data();
+}
+
 void VectorHasher::hash(
     const SelectivityVector& rows,
     bool mix,
@@ -759,6 +799,7 @@ uint64_t VectorHasher::enableValueIds(uint64_t multiplier, int32_t reservePct) {
   multiplier_ = multiplier;
   rangeSize_ = addIdReserve(uniqueValues_.size(), reservePct) + 1;
   isRange_ = false;
+  clearDictionaryIds();
   uint64_t result;
   if (__builtin_mul_overflow(multiplier_, rangeSize_, &result)) {
     return kRangeTooLarge;
@@ -774,6 +815,7 @@ uint64_t VectorHasher::enableValueRange(
   VELOX_CHECK(hasRange_);
   extendRange(type_->kind(), reservePct, min_, max_);
   isRange_ = true;
+  clearDictionaryIds();
   // No overflow because max range is under 63 bits.
   if (typeKind_ == TypeKind::BOOLEAN) {
     rangeSize_ = 3;
@@ -795,6 +837,7 @@ void VectorHasher::copyStatsFrom(const VectorHasher& other) {
   min_ = other.min_;
   max_ = other.max_;
   uniqueValues_ = other.uniqueValues_;
+  clearDictionaryIds();
 }
 
 void VectorHasher::merge(const VectorHasher& other) {
@@ -808,6 +851,7 @@ void VectorHasher::merge(const VectorHasher& other) {
     copyStatsFrom(other);
     return;
   }
+  clearDictionaryIds();
   if (hasRange_ && other.hasRange_ && !rangeOverflow_ &&
       !other.rangeOverflow_) {
     min_ = std::min(min_, other.min_);
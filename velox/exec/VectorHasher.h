@@ -177,10 +177,11 @@ class VectorHasher {
 
   // Decodes the 'vector' in preparation for calling hash() or
   // computeValueIds(). The decoded vector can be accessed via decodedVector()
-  // getter.
-  void decode(const BaseVector& vector, const SelectivityVector& rows) {
-    decoded_.decode(vector, rows);
-  }
+  // getter. If 'vector' is a dictionary over strings, the hashes and value ids
+  // of the dictionary elements are remembered across calls with the same
+  // dictionary, so that each element is hashed and looked up once, not once
+  // per batch.
+  void decode(const BaseVector& vector, const SelectivityVector& rows);
 
   DecodedVector& decodedVector() {
     return decoded_;
@@ -250,6 +251,11 @@ class VectorHasher {
     return hasRange_ || !distinctOverflow_;
   }
 
+  // Returns true if there are too many distinct values to keep track of them.
+  bool distinctOverflow() const {
+    return distinctOverflow_;
+  }
+
   // Returns an instance of the filter corresponding to a set of unique values.
   // Returns null if distinctOverflow_ is true.
   std::unique_ptr<common::Filter> getFilter(bool nullAllowed) const;
@@ -257,6 +263,7 @@ class VectorHasher {
   void resetStats() {
     uniqueValues_.clear();
     uniqueValuesStorage_.clear();
+    clearDictionaryIds();
   }
 
   // Sets 'this' to range mode and adds 'reservePct' values to the
@@ -526,6 +533,21 @@ class VectorHasher {
 
   void copyStringToLocal(const UniqueValue* unique);
 
+  // Sets 'dictionaryBase_' to the base of the dictionary 'vector' decoded
+  // into 'decoded_'. Keeps the cached hashes and ids if it is the same base
+  // as before.
+  void trackDictionary(const BaseVector& vector);
+
+  // Returns the hashes or value ids cached for the base of 'decoded_' if
+  // 'decoded_' is over 'dictionaryBase_', else resets and returns
+  // 'cachedHashes_'. 'empty' marks an element without a cached value.
+  uint64_t* dictionaryCache(raw_vector<uint64_t>& cache, uint64_t empty);
+
+  // Called when the mapping of values to ids changes.
+  void clearDictionaryIds() {
+    std::fill(dictionaryIds_.begin(), dictionaryIds_.end(), 0);
+  }
+
   static inline bool
   isNullAt(const char* group, int32_t nullByte, uint8_t nullMask) {
     return (group[nullByte] & nullMask) != 0;
@@ -546,6 +568,15 @@ class VectorHasher {
   DecodedVector decoded_;
   raw_vector<uint64_t> cachedHashes_;
 
+  // The base of the last string dictionary given to decode(). Holding a
+  // reference keeps it from being reused for different values, so the
+  // hashes and value ids of its elements stay valid across batches.
+  VectorPtr dictionaryBase_;
+  // The hashes of the elements of 'dictionaryBase_'. kNullHash if not set.
+  raw_vector<uint64_t> dictionaryHashes_;
+  // The value ids of the elements of 'dictionaryBase_'. 0 if not set.
+  raw_vector<uint64_t> dictionaryIds_;
+
   // Single precomputed hash for constant partition keys.
   uint64_t precomputedHash_{0};
 
@@ -15,6 +15,7 @@
  */
 #include "velox/exec/Window.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/PrefixSort.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -41,16 +42,96 @@ void initKeyInfo(
   }
 }
 
-void checkDefaultWindowFrame(const core::WindowNode::Function& windowFunction) {
-  VELOX_CHECK_EQ(
-      windowFunction.frame.type, core::WindowNode::WindowType::kRange);
-  VELOX_CHECK_EQ(
-      windowFunction.frame.startType,
-      core::WindowNode::BoundType::kUnboundedPreceding);
-  VELOX_CHECK_EQ(
-      windowFunction.frame.endType, core::WindowNode::BoundType::kCurrentRow);
-  VELOX_CHECK_EQ(windowFunction.frame.startValue, nullptr);
-  VELOX_CHECK_EQ(windowFunction.frame.endValue, nullptr);
+CompareFlags fromSortOrderToCompareFlags(const core::SortOrder& sortOrder) {
+  return {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false};
+}
+
+void checkWindowFrame(const core::WindowNode::Frame& frame) {
+  using BoundType = core::WindowNode::BoundType;
+  VELOX_USER_CHECK(
+      frame.startType != BoundType::kUnboundedFollowing,
+      "Window frame can't start with UNBOUNDED FOLLOWING");
+  VELOX_USER_CHECK(
+      frame.endType != BoundType::kUnboundedPreceding,
+      "Window frame can't end with UNBOUNDED PRECEDING");
+  auto hasOffset = [](BoundType bound) {
+    return bound == BoundType::kPreceding || bound == BoundType::kFollowing;
+  };
+  if (frame.type == core::WindowNode::WindowType::kRange) {
+    VELOX_CHECK(
+        !hasOffset(frame.startType) && !hasOffset(frame.endType),
+        "Window doesn't support RANGE frames with offset bounds");
+  }
+  VELOX_CHECK_EQ(hasOffset(frame.startType), frame.startValue != nullptr);
+  VELOX_CHECK_EQ(hasOffset(frame.endType), frame.endValue != nullptr);
+}
+
+// Returns the frame offset at 'row' of 'decoded'. The offset is a number of
+// rows and must be a non-null, non-negative integer.
+int64_t frameOffsetAt(const DecodedVector& decoded, vector_size_t row) {
+  VELOX_USER_CHECK(
+      !decoded.isNullAt(row), "Window frame offset must not be null");
+  int64_t offset;
+  switch (decoded.base()->typeKind()) {
+    case TypeKind::TINYINT:
+      offset = decoded.valueAt<int8_t>(row);
+      break;
+    case TypeKind::SMALLINT:
+      offset = decoded.valueAt<int16_t>(row);
+      break;
+    case TypeKind::INTEGER:
+      offset = decoded.valueAt<int32_t>(row);
+      break;
+    case TypeKind::BIGINT:
+      offset = decoded.valueAt<int64_t>(row);
+      break;
+    default:
+      VELOX_USER_FAIL(
+          "Window frame offset must be an integer, not {}",
+          decoded.base()->type()->toString());
+  }
+  VELOX_USER_CHECK_GE(offset, 0, "Window frame offset must not be negative");
+  return offset;
+}
+
+// Returns the row in the partition of a frame bound of 'boundType' and
+// 'offset' for the row 'row' with peers from 'peerStart' to 'peerEnd'. A
+// start before the partition is moved to its first row and an end after the
+// partition to its last row. A start after the partition is 'numRows' and an
+// end before it is -1, so that the frame is empty.
+vector_size_t frameBound(
+    core::WindowNode::WindowType type,
+    core::WindowNode::BoundType boundType,
+    bool isStart,
+    int64_t offset,
+    vector_size_t row,
+    vector_size_t peerStart,
+    vector_size_t peerEnd,
+    vector_size_t numRows) {
+  int64_t bound;
+  switch (boundType) {
+    case core::WindowNode::BoundType::kUnboundedPreceding:
+      return 0;
+    case core::WindowNode::BoundType::kUnboundedFollowing:
+      return numRows - 1;
+    case core::WindowNode::BoundType::kCurrentRow:
+      if (type == core::WindowNode::WindowType::kRange) {
+        return isStart ? peerStart : peerEnd;
+      }
+      return row;
+    case core::WindowNode::BoundType::kPreceding:
+      bound = row - offset;
+      break;
+    case core::WindowNode::BoundType::kFollowing:
+      bound = row + offset;
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+  if (isStart) {
+    return std::max<int64_t>(0, std::min<int64_t>(bound, numRows));
+  }
+  return std::max<int64_t>(-1, std::min<int64_t>(bound, numRows - 1));
 }
 
 }; // namespace
@@ -65,12 +146,22 @@ Window::Window(
           operatorId,
           windowNode->id(),
           "Window"),
+      inputsSorted_(windowNode->inputsSorted()),
       outputBatchSizeInBytes_(
           driverCtx->queryConfig().preferredOutputBatchSize()),
       numInputColumns_(windowNode->sources()[0]->outputType()->size()),
-      data_(std::make_unique<RowContainer>(
-          windowNode->sources()[0]->outputType()->children(),
-          operatorCtx_->mappedMemory())),
+      mappedMemory_(operatorCtx_->mappedMemory()),
+      spillMemoryThreshold_(
+          driverCtx->queryConfig().windowSpillMemoryThreshold()),
+      // Sorted inputs are processed a partition at a time without spilling.
+      spillConfig_(
+          inputsSorted_ ? std::nullopt
+                        : makeOperatorSpillConfig(
+                              *operatorCtx_->task()->queryCtx(),
+                              *operatorCtx_,
+                              core::QueryConfig::kWindowSpillEnabled,
+                              core::QueryConfig::kWindowSpillCompressionCodec,
+                              operatorId)),
       decodedInputVectors_(numInputColumns_) {
   auto inputType = windowNode->sources()[0]->outputType();
   initKeyInfo(inputType, windowNode->partitionKeys(), {}, partitionKeyInfo_);
@@ -85,18 +176,63 @@ Window::Window(
   allKeyInfo_.insert(
       allKeyInfo_.cend(), sortKeyInfo_.begin(), sortKeyInfo_.end());
 
+  // Store the distinct partition and sort key columns first in the row
+  // container, in the order of 'allKeyInfo_'. This enables the spiller to sort
+  // the rows on them.
+  static constexpr auto kNoColumn = std::numeric_limits<column_index_t>::max();
+  columnMap_.resize(numInputColumns_, kNoColumn);
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<TypePtr> types;
+  std::vector<std::string> names;
+  for (const auto& [channel, sortOrder] : allKeyInfo_) {
+    if (columnMap_[channel] != kNoColumn) {
+      continue;
+    }
+    columnMap_[channel] = keyTypes.size();
+    keyTypes.push_back(inputType->childAt(channel));
+    types.push_back(keyTypes.back());
+    names.push_back(inputType->nameOf(channel));
+    keyCompareFlags_.push_back(fromSortOrderToCompareFlags(sortOrder));
+  }
+  for (column_index_t channel = 0; channel < numInputColumns_; ++channel) {
+    if (columnMap_[channel] != kNoColumn) {
+      continue;
+    }
+    columnMap_[channel] = keyTypes.size() + dependentTypes.size();
+    dependentTypes.push_back(inputType->childAt(channel));
+    types.push_back(dependentTypes.back());
+    names.push_back(inputType->nameOf(channel));
+  }
+  data_ = std::make_unique<RowContainer>(
+      keyTypes, dependentTypes, operatorCtx_->mappedMemory());
+  outputData_ = data_.get();
+  internalStoreType_ = ROW(std::move(names), std::move(types));
+
+  // The key infos refer to the columns of 'data_' from here on.
+  for (auto* keyInfo : {&partitionKeyInfo_, &sortKeyInfo_, &allKeyInfo_}) {
+    for (auto& key : *keyInfo) {
+      key.first = columnMap_[key.first];
+    }
+  }
+
+  createWindowPartition(*data_);
+  createWindowFunctions(windowNode, inputType);
+}
+
+void Window::createWindowPartition(RowContainer& data) {
   std::vector<exec::RowColumn> inputColumns;
-  for (int i = 0; i < inputType->children().size(); i++) {
-    inputColumns.push_back(data_->columnAt(i));
+  std::vector<TypePtr> inputTypes;
+  for (int i = 0; i < numInputColumns_; i++) {
+    inputColumns.push_back(data.columnAt(columnMap_[i]));
+    inputTypes.push_back(data.columnTypes()[columnMap_[i]]);
   }
   // The WindowPartition is structured over all the input columns data.
   // Individual functions access its input argument column values from it.
   // The RowColumns are copied by the WindowPartition, so its fine to use
   // a local variable here.
   windowPartition_ =
-      std::make_unique<WindowPartition>(inputColumns, inputType->children());
-
-  createWindowFunctions(windowNode, inputType);
+      std::make_unique<WindowPartition>(inputColumns, inputTypes);
 }
 
 void Window::createWindowFunctions(
@@ -123,12 +259,28 @@ void Window::createWindowFunctions(
           exprToChannel(arg.get(), inputType);
       VELOX_CHECK(
           argChannel.value() != kConstantChannel,
-          "Window doesn't allow constant arguments or frame end-points");
+          "Window doesn't allow constant arguments");
       return argChannel;
     }
     return std::nullopt;
   };
 
+  // Returns the channel of a frame offset or its value if it is constant.
+  auto frameOffset = [&](const core::TypedExprPtr& arg,
+                         std::optional<column_index_t>& channel,
+                         std::optional<int64_t>& constant) {
+    if (!arg) {
+      return;
+    }
+    if (auto value = constantArg(arg)) {
+      SelectivityVector rows(1);
+      DecodedVector decoded(*value, rows);
+      constant = frameOffsetAt(decoded, 0);
+      return;
+    }
+    channel = fieldArgToChannel(arg);
+  };
+
   for (const auto& windowNodeFunction : windowNode->windowFunctions()) {
     std::vector<WindowFunctionArg> functionArgs;
     functionArgs.reserve(windowNodeFunction.functionCall->inputs().size());
@@ -145,20 +297,32 @@ void Window::createWindowFunctions(
         windowNodeFunction.functionCall->name(),
         functionArgs,
         windowNodeFunction.functionCall->type(),
+        windowNodeFunction.ignoreNulls,
         operatorCtx_->pool()));
 
-    checkDefaultWindowFrame(windowNodeFunction);
+    const auto& frame = windowNodeFunction.frame;
+    checkWindowFrame(frame);
 
+    std::optional<column_index_t> startChannel;
+    std::optional<column_index_t> endChannel;
+    std::optional<int64_t> startConstant;
+    std::optional<int64_t> endConstant;
+    frameOffset(frame.startValue, startChannel, startConstant);
+    frameOffset(frame.endValue, endChannel, endConstant);
     windowFrames_.push_back(
-        {windowNodeFunction.frame.type,
-         windowNodeFunction.frame.startType,
-         windowNodeFunction.frame.endType,
-         fieldArgToChannel(windowNodeFunction.frame.startValue),
-         fieldArgToChannel(windowNodeFunction.frame.endValue)});
+        {frame.type,
+         frame.startType,
+         frame.endType,
+         startChannel,
+         endChannel,
+         startConstant,
+         endConstant});
   }
 }
 
 void Window::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   inputRows_.resize(input->size());
 
   for (auto col = 0; col < input->childrenSize(); ++col) {
@@ -166,14 +330,200 @@ void Window::addInput(RowVectorPtr input) {
   }
 
   // Add all the rows into the RowContainer.
+  const vector_size_t firstNewRow = sortedRows_.size();
   for (auto row = 0; row < input->size(); ++row) {
     char* newRow = data_->newRow();
 
     for (auto col = 0; col < input->childrenSize(); ++col) {
-      data_->store(decodedInputVectors_[col], row, newRow, col);
+      data_->store(decodedInputVectors_[col], row, newRow, columnMap_[col]);
+    }
+    if (inputsSorted_) {
+      sortedRows_.push_back(newRow);
     }
   }
   numRows_ += inputRows_.size();
+  if (inputsSorted_) {
+    addPartitionStartRows(firstNewRow);
+  }
+  if (spiller_ != nullptr) {
+    const auto stats = spiller_->stats();
+    stats_.spilledBytes = stats.spilledBytes;
+    stats_.spilledRows = stats.spilledRows;
+    stats_.spilledPartitions = stats.spilledPartitions;
+    stats_.spilledUncompressedBytes = stats.spilledUncompressedBytes;
+    stats_.spilledFiles = stats.spilledFiles;
+    stats_.spillWriteTimeUs = stats.spillWriteTimeUs;
+    stats_.spillPeakDiskBytes = operatorCtx_->spillDiskTracker().peakBytes();
+    VELOX_DCHECK_LE(stats_.spilledPartitions, 1);
+  }
+}
+
+void Window::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t outOfLineBytesPerRow = outOfLineBytes / numRows;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    const int64_t rowsToSpill = std::max<int64_t>(1, numRows / 10);
+    spill(
+        numRows - rowsToSpill,
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  auto tracker = mappedMemory_->tracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->getCurrentUserBytes();
+  if (spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) {
+    const int64_t bytesToSpill =
+        currentUsage * spillConfig.spillableReservationGrowthPct / 100;
+    auto rowsToSpill = std::max<int64_t>(
+        1, bytesToSpill / (data_->fixedRowSize() + outOfLineBytesPerRow));
+    spill(
+        std::max<int64_t>(0, numRows - rowsToSpill),
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const int64_t incrementBytes =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->getAvailableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  // The Task may spill another operator that holds more memory, or 'this'.
+  if (operatorCtx_->reclaimFromTask(targetIncrementBytes) &&
+      (data_->numRows() < numRows ||
+       tracker->maybeReserve(targetIncrementBytes))) {
+    return;
+  }
+  const int64_t rowsToSpill = std::max<int64_t>(
+      1, targetIncrementBytes / (data_->fixedRowSize() + outOfLineBytesPerRow));
+  spill(
+      std::max<int64_t>(0, numRows - rowsToSpill),
+      std::max<int64_t>(
+          0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+}
+
+int64_t Window::reclaimableBytes() const {
+  if (!spillConfig_.has_value() || noMoreInput_ || data_->numRows() == 0) {
+    return 0;
+  }
+  return data_->allocatedBytes();
+}
+
+void Window::reclaim() {
+  spill(0, 0);
+}
+
+void Window::spill(int64_t targetRows, int64_t targetBytes) {
+  VELOX_CHECK_GE(targetRows, 0);
+  VELOX_CHECK_GE(targetBytes, 0);
+
+  if (spiller_ == nullptr) {
+    VELOX_DCHECK(mappedMemory_->tracker() != nullptr);
+    const auto& spillConfig = spillConfig_.value();
+    const auto spillFileSize = mappedMemory_->tracker()->getCurrentUserBytes() *
+        spillConfig.fileSizeFactor;
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kWindow,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        internalStoreType_,
+        data_->keyTypes().size(),
+        keyCompareFlags_,
+        spillConfig.filePath,
+        spillFileSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.writeOptions);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  spiller_->spill(targetRows, targetBytes);
+}
+
+void Window::loadSpilledPartitions() {
+  VELOX_CHECK_NOT_NULL(spillMerge_);
+  spilledPartitionData_->clear();
+  sortedRows_.clear();
+  partitionStartRows_.clear();
+  numProcessedRows_ = 0;
+  currentPartition_ = 0;
+
+  // The rows come sorted on the partition keys followed by the sort keys. A
+  // partition is read back whole as the window functions need all its rows.
+  for (;;) {
+    auto* stream = spillMerge_->next();
+    if (stream == nullptr) {
+      break;
+    }
+    const auto index = stream->currentIndex();
+    if (sortedRows_.size() >= numRowsPerOutput_) {
+      bool samePartition = true;
+      for (const auto& key : partitionKeyInfo_) {
+        if (spilledPartitionData_->compare(
+                sortedRows_.back(),
+                spilledPartitionData_->columnAt(key.first),
+                stream->decoded(key.first),
+                index) != 0) {
+          samePartition = false;
+          break;
+        }
+      }
+      if (!samePartition) {
+        // The row starts the next partition. Leave it in the stream for the
+        // next load.
+        break;
+      }
+    }
+
+    char* row = spilledPartitionData_->newRow();
+    for (auto i = 0; i < internalStoreType_->size(); ++i) {
+      spilledPartitionData_->store(stream->decoded(i), index, row, i);
+    }
+    sortedRows_.push_back(row);
+    stream->pop();
+  }
+
+  if (!sortedRows_.empty()) {
+    computePartitionStartRows();
+  }
 }
 
 inline bool Window::compareRowsWithKeys(
@@ -184,7 +534,7 @@ inline bool Window::compareRowsWithKeys(
     return false;
   }
   for (auto& key : keys) {
-    if (auto result = data_->compare(
+    if (auto result = outputData_->compare(
             lhs,
             rhs,
             key.first,
@@ -221,7 +571,7 @@ void Window::createPeerAndFrameBuffers() {
 
 void Window::computePartitionStartRows() {
   // Randomly assuming that max 10000 partitions are in the data.
-  partitionStartRows_.reserve(numRows_);
+  partitionStartRows_.reserve(sortedRows_.size() + 1);
   auto partitionCompare = [&](const char* lhs, const char* rhs) -> bool {
     return compareRowsWithKeys(lhs, rhs, partitionKeyInfo_);
   };
@@ -245,6 +595,38 @@ void Window::computePartitionStartRows() {
   partitionStartRows_.push_back(sortedRows_.size());
 }
 
+void Window::addPartitionStartRows(vector_size_t firstNewRow) {
+  if (partitionStartRows_.empty()) {
+    partitionStartRows_.push_back(0);
+  }
+  // The partition keys may be in any order, so a row starts a partition if
+  // its keys are not equal to those of the previous row.
+  auto samePartition = [&](const char* lhs, const char* rhs) {
+    for (const auto& key : partitionKeyInfo_) {
+      if (data_->compare(lhs, rhs, key.first, CompareFlags()) != 0) {
+        return false;
+      }
+    }
+    return true;
+  };
+  for (auto i = std::max<vector_size_t>(firstNewRow, 1);
+       i < sortedRows_.size();
+       ++i) {
+    if (!samePartition(sortedRows_[i - 1], sortedRows_[i])) {
+      partitionStartRows_.push_back(i);
+    }
+  }
+}
+
+void Window::releaseProcessedRows() {
+  data_->eraseRows(folly::Range<char**>(sortedRows_.data(), numProcessedRows_));
+  sortedRows_.erase(
+      sortedRows_.begin(), sortedRows_.begin() + numProcessedRows_);
+  partitionStartRows_.assign(1, 0);
+  numProcessedRows_ = 0;
+  currentPartition_ = 0;
+}
+
 void Window::sortPartitions() {
   // This is a very inefficient but easy implementation to order the input rows
   // by partition keys + sort keys.
@@ -254,18 +636,32 @@ void Window::sortPartitions() {
   RowContainerIterator iter;
   data_->listRows(&iter, numRows_, sortedRows_.data());
 
-  std::sort(
-      sortedRows_.begin(),
-      sortedRows_.end(),
-      [this](const char* leftRow, const char* rightRow) {
-        return compareRowsWithKeys(leftRow, rightRow, allKeyInfo_);
-      });
+  std::vector<PrefixSort::Key> keys;
+  keys.reserve(allKeyInfo_.size());
+  for (const auto& [column, sortOrder] : allKeyInfo_) {
+    keys.emplace_back(
+        column,
+        CompareFlags{sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+  }
+  PrefixSort::sort(
+      *data_,
+      keys,
+      folly::Range<char**>(sortedRows_.data(), sortedRows_.size()));
 
   computePartitionStartRows();
 
   currentPartition_ = 0;
 }
 
+BlockingReason Window::isBlocked(ContinueFuture* future) {
+  // Takes no more input while the spill files of the query are over budget.
+  if (spillConfig_.has_value() && !noMoreInput_ &&
+      operatorCtx_->waitForSpillDisk(future)) {
+    return BlockingReason::kWaitForSpill;
+  }
+  return BlockingReason::kNotBlocked;
+}
+
 void Window::noMoreInput() {
   Operator::noMoreInput();
   // No data.
@@ -274,6 +670,38 @@ void Window::noMoreInput() {
     return;
   }
 
+  if (inputsSorted_) {
+    // The last partition is complete.
+    partitionStartRows_.push_back(sortedRows_.size());
+    if (peerStartBuffer_ == nullptr) {
+      createPeerAndFrameBuffers();
+    }
+    return;
+  }
+
+  if (spiller_ != nullptr) {
+    // There is only one spill partition, so all the rows go to the spill
+    // runs.
+    Spiller::SpillRows nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    VELOX_CHECK_NULL(spillMerge_);
+    spillMerge_ = spiller_->startMerge(0, spillConfig_->readOptions);
+
+    // The merge reads the rows that are not spilled from 'data_', so the
+    // partitions read back go to a separate container of the same layout.
+    const auto& types = internalStoreType_->children();
+    const auto numKeys = data_->keyTypes().size();
+    spilledPartitionData_ = std::make_unique<RowContainer>(
+        std::vector<TypePtr>(types.begin(), types.begin() + numKeys),
+        std::vector<TypePtr>(types.begin() + numKeys, types.end()),
+        mappedMemory_);
+    outputData_ = spilledPartitionData_.get();
+    createWindowPartition(*spilledPartitionData_);
+    createPeerAndFrameBuffers();
+    loadSpilledPartitions();
+    return;
+  }
+
   // At this point we have seen all the input rows. We can start
   // outputting rows now.
   // However, some preparation is needed. The rows should be
@@ -294,6 +722,66 @@ void Window::callResetPartition(vector_size_t partitionNumber) {
   }
 }
 
+void Window::computeFrameBounds(
+    const WindowFrame& frame,
+    vector_size_t startRow,
+    vector_size_t numRows,
+    vector_size_t partitionSize,
+    const vector_size_t* rawPeerStarts,
+    const vector_size_t* rawPeerEnds,
+    vector_size_t* rawFrameStarts,
+    vector_size_t* rawFrameEnds) {
+  // Reads the offsets of the rows from 'channel' if they are not constant.
+  SelectivityVector rows(numRows);
+  auto decodeOffsets = [&](std::optional<column_index_t> channel,
+                           VectorPtr& values,
+                           DecodedVector& decoded) {
+    if (!channel.has_value()) {
+      return false;
+    }
+    values = BaseVector::create(
+        outputType_->childAt(channel.value()), numRows, pool());
+    windowPartition_->extractColumn(
+        channel.value(), startRow, numRows, 0, values);
+    decoded.decode(*values, rows);
+    return true;
+  };
+  VectorPtr startValues;
+  VectorPtr endValues;
+  DecodedVector startOffsets;
+  DecodedVector endOffsets;
+  const bool startFromColumn =
+      decodeOffsets(frame.startChannel, startValues, startOffsets);
+  const bool endFromColumn =
+      decodeOffsets(frame.endChannel, endValues, endOffsets);
+
+  for (auto i = 0; i < numRows; ++i) {
+    const auto startOffset = startFromColumn
+        ? frameOffsetAt(startOffsets, i)
+        : frame.startConstant.value_or(0);
+    const auto endOffset = endFromColumn ? frameOffsetAt(endOffsets, i)
+                                         : frame.endConstant.value_or(0);
+    rawFrameStarts[i] = frameBound(
+        frame.type,
+        frame.startType,
+        true,
+        startOffset,
+        startRow + i,
+        rawPeerStarts[i],
+        rawPeerEnds[i],
+        partitionSize);
+    rawFrameEnds[i] = frameBound(
+        frame.type,
+        frame.endType,
+        false,
+        endOffset,
+        startRow + i,
+        rawPeerStarts[i],
+        rawPeerEnds[i],
+        partitionSize);
+  }
+}
+
 void Window::callApplyForPartitionRows(
     vector_size_t startRow,
     vector_size_t endRow,
@@ -360,9 +848,20 @@ void Window::callApplyForPartitionRows(
     // as WindowFunction only sees one partition at a time.
     rawPeerStarts[j] = peerStartRow_ - firstPartitionRow;
     rawPeerEnds[j] = peerEndRow_ - 1 - firstPartitionRow;
+  }
 
-    // TODO: Calculate frame buffer values.
+  for (auto w = 0; w < numFuncs; w++) {
+    computeFrameBounds(
+        windowFrames_[w],
+        startRow - firstPartitionRow,
+        numRows,
+        lastPartitionRow + 1 - firstPartitionRow,
+        rawPeerStarts,
+        rawPeerEnds,
+        rawFrameStartBuffers[w],
+        rawFrameEndBuffers[w]);
   }
+
   // Invoke the apply method for the WindowFunctions.
   for (auto w = 0; w < numFuncs; w++) {
     windowFunctions_[w]->apply(
@@ -417,21 +916,30 @@ void Window::callApplyLoop(
 }
 
 RowVectorPtr Window::getOutput() {
-  if (finished_ || !noMoreInput_) {
+  if (finished_ || (!noMoreInput_ && !inputsSorted_)) {
     return nullptr;
   }
+  if (inputsSorted_) {
+    if (numProcessedRows_ == numCompleteRows()) {
+      // Waits for the first row of the next partition or noMoreInput().
+      return nullptr;
+    }
+    if (peerStartBuffer_ == nullptr) {
+      createPeerAndFrameBuffers();
+    }
+  }
 
-  auto numRowsLeft = numRows_ - numProcessedRows_;
+  vector_size_t numRowsLeft = numCompleteRows() - numProcessedRows_;
   auto numOutputRows = std::min(numRowsPerOutput_, numRowsLeft);
   auto result = std::dynamic_pointer_cast<RowVector>(
       BaseVector::create(outputType_, numOutputRows, operatorCtx_->pool()));
 
   // Set all passthrough input columns.
   for (int i = 0; i < numInputColumns_; ++i) {
-    data_->extractColumn(
+    outputData_->extractColumn(
         sortedRows_.data() + numProcessedRows_,
         numOutputRows,
-        i,
+        columnMap_[i],
         result->childAt(i));
   }
 
@@ -451,7 +959,26 @@ RowVectorPtr Window::getOutput() {
     result->childAt(j) = windowOutputs[j - numInputColumns_];
   }
 
+  if (inputsSorted_) {
+    if (numProcessedRows_ == numCompleteRows()) {
+      if (noMoreInput_) {
+        finished_ = true;
+      } else {
+        // The output has copied the rows of the complete partitions.
+        releaseProcessedRows();
+      }
+    }
+    return result;
+  }
+
   finished_ = (numProcessedRows_ == sortedRows_.size());
+  if (finished_ && spillMerge_ != nullptr) {
+    // The output has copied the rows, so the next partitions can replace
+    // them.
+    loadSpilledPartitions();
+    finished_ = sortedRows_.empty();
+    stats_.spillReadTimeUs = spiller_->state().ioStats().readTimeUs;
+  }
   return result;
 }
 
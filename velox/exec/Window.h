@@ -17,6 +17,7 @@
 
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/exec/WindowPartition.h"
 
@@ -32,6 +33,17 @@ namespace facebook::velox::exec {
 /// It is also sorted in the order required for the WindowFunction
 /// to process it.
 ///
+/// If spilling is enabled and the input does not fit in memory, the rows are
+/// spilled in sorted runs by (partition_by keys + order_by keys). After all
+/// the input is received, the runs are merged and read back a few whole
+/// partitions at a time.
+///
+/// If the WindowNode says that the inputs are sorted, the rows of each
+/// partition arrive together and ordered by the sort keys. The operator then
+/// skips the sort and outputs each partition as soon as it sees the first row
+/// of the next partition. The rows of a partition are freed once it is
+/// output, so the memory is bounded by the size of the largest partition.
+///
 /// We will revise this algorithm in the future using a HashTable based
 /// approach pending some profiling results.
 class Window : public Operator {
@@ -46,27 +58,36 @@ class Window : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_;
+    // With sorted inputs, the complete partitions are output before taking
+    // more input.
+    return !noMoreInput_ &&
+        (!inputsSorted_ || numProcessedRows_ == numCompleteRows());
   }
 
   void noMoreInput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override {
     return finished_;
   }
 
+  int64_t reclaimableBytes() const override;
+
+  void reclaim() override;
+
  private:
-  // Structure for the window frame for each function.
+  // Structure for the window frame for each function. The offset of a
+  // PRECEDING or FOLLOWING bound is either read from the input column at
+  // its channel or is a constant.
   struct WindowFrame {
     const core::WindowNode::WindowType type;
     const core::WindowNode::BoundType startType;
     const core::WindowNode::BoundType endType;
     const std::optional<column_index_t> startChannel;
     const std::optional<column_index_t> endChannel;
+    const std::optional<int64_t> startConstant;
+    const std::optional<int64_t> endConstant;
   };
 
   // Helper function to create WindowFunction and frame objects
@@ -75,6 +96,40 @@ class Window : public Operator {
       const std::shared_ptr<const core::WindowNode>& windowNode,
       const RowTypePtr& inputType);
 
+  // Makes 'windowPartition_' over the input columns stored in 'data'.
+  void createWindowPartition(RowContainer& data);
+
+  // Checks if input will fit in the existing memory and increases
+  // reservation if not. If reservation cannot be increased, spills enough to
+  // make 'input' fit.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills content until under 'targetRows' and under 'targetBytes' of out of
+  // line data are left.
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  // Reads the next whole partitions from 'spillMerge_' into
+  // 'spilledPartitionData_' until there are at least 'numRowsPerOutput_' rows
+  // or the spilled rows are all read. Sets 'sortedRows_' and
+  // 'partitionStartRows_' for these rows.
+  void loadSpilledPartitions();
+
+  // Returns the number of rows of 'sortedRows_' in complete partitions. With
+  // sorted inputs, the rows after these are in the partition that is still
+  // receiving input.
+  vector_size_t numCompleteRows() const {
+    return partitionStartRows_.empty() ? 0 : partitionStartRows_.back();
+  }
+
+  // Appends the starts of the partitions in 'sortedRows_' from
+  // 'firstNewRow' on to 'partitionStartRows_'. Used with sorted inputs.
+  void addPartitionStartRows(vector_size_t firstNewRow);
+
+  // Frees the rows of the partitions that have been output, leaving the
+  // rows of the partition that is still receiving input. Used with sorted
+  // inputs.
+  void releaseProcessedRows();
+
   // Helper function to create the buffers for peer and frame
   // row indices to send in window function apply invocations.
   void createPeerAndFrameBuffers();
@@ -99,6 +154,19 @@ class Window : public Operator {
   // all WindowFunctions.
   void callResetPartition(vector_size_t partitionNumber);
 
+  // Fills 'rawFrameStarts' and 'rawFrameEnds' with the bounds of 'frame' for
+  // the 'numRows' rows starting at 'startRow' of the current partition of
+  // 'partitionSize' rows. The bounds are inclusive rows of the partition.
+  void computeFrameBounds(
+      const WindowFrame& frame,
+      vector_size_t startRow,
+      vector_size_t numRows,
+      vector_size_t partitionSize,
+      const vector_size_t* rawPeerStarts,
+      const vector_size_t* rawPeerEnds,
+      vector_size_t* rawFrameStarts,
+      vector_size_t* rawFrameEnds);
+
   // Helper method to call WindowFunction::apply to all the rows
   // of a partition between startRow and endRow. The outputs
   // will be written to the vectors in windowFunctionOutputs
@@ -125,18 +193,57 @@ class Window : public Operator {
       const std::vector<VectorPtr>& windowOutputs);
 
   bool finished_ = false;
+  // True if the rows of each partition arrive together and sorted.
+  const bool inputsSorted_;
   const vector_size_t outputBatchSizeInBytes_;
   const vector_size_t numInputColumns_;
 
+  memory::MappedMemory* const mappedMemory_;
+
+  // The max memory that a window can hold before spilling. If it is zero,
+  // then there is no such limit.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
   // The Window operator needs to see all the input rows before starting
   // any function computation. As the Window operators gets input rows
-  // we store the rows in the RowContainer (data_).
+  // we store the rows in the RowContainer (data_). The partition and sort
+  // keys are stored first as the keys of 'data_', so that the spiller can
+  // sort the rows on them. The other input columns follow as dependents.
   std::unique_ptr<RowContainer> data_;
+
+  // The column in 'data_' of each input channel.
+  std::vector<column_index_t> columnMap_;
+
+  // Compare flags of the keys of 'data_'.
+  std::vector<CompareFlags> keyCompareFlags_;
+
+  // The row type of 'data_' used for spilling.
+  RowTypePtr internalStoreType_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  // Set to read back the spilled rows if disk spilling has been triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // Holds the partitions read back from 'spillMerge_'.
+  std::unique_ptr<RowContainer> spilledPartitionData_;
+
+  // The RowContainer with the rows in 'sortedRows_'. This is 'data_' unless
+  // the input has been spilled, otherwise 'spilledPartitionData_'.
+  RowContainer* outputData_;
+
   // The decodedInputVectors_ are reused across addInput() calls to decode
   // the partition and sort keys for the above RowContainer.
   std::vector<DecodedVector> decodedInputVectors_;
 
-  // The below 3 vectors represent the ChannelIndex of the partition keys,
+  // The below 3 vectors represent the column in 'data_' of the partition keys,
   // the order by keys and the concatenation of the 2. These keyInfo are
   // used for sorting by those key combinations during the processing.
   // partitionKeyInfo_ is used to separate partitions in the rows.
@@ -165,7 +272,9 @@ class Window : public Operator {
   // Vector of pointers to each input row in the data_ RowContainer.
   // The rows are sorted by partitionKeys + sortKeys. This total
   // ordering can be used to split partitions (with the correct
-  // order by) for the processing.
+  // order by) for the processing. If the input has been spilled, this
+  // has only the rows of the partitions read back by the last
+  // loadSpilledPartitions().
   std::vector<char*> sortedRows_;
 
   // Window partition object used to provide per-partition
@@ -178,7 +287,8 @@ class Window : public Operator {
   // This is a vector that gives the index of the start row
   // (in sortedRows_) of each partition in the RowContainer data_.
   // This auxiliary structure helps demarcate partitions in
-  // getOutput calls.
+  // getOutput calls. With sorted inputs, the last entry is the start of
+  // the partition that is still receiving input until noMoreInput().
   std::vector<vector_size_t> partitionStartRows_;
 
   // The following 4 Buffers are used to pass peer and frame start and
@@ -60,10 +60,11 @@ std::unique_ptr<WindowFunction> WindowFunction::create(
     const std::string& name,
     const std::vector<WindowFunctionArg>& args,
     const TypePtr& resultType,
+    bool ignoreNulls,
     memory::MemoryPool* pool) {
   // Lookup the function in the new registry first.
   if (auto func = getWindowFunctionEntry(name)) {
-    return func.value()->factory(args, resultType, pool);
+    return func.value()->factory(args, resultType, ignoreNulls, pool);
   }
 
   VELOX_USER_FAIL("Window function not registered: {}", name);
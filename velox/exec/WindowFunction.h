@@ -63,7 +63,10 @@ class WindowFunction {
   /// @param frameStarts  A buffer of the indexes of rows at which the
   /// frame for the current row starts.
   /// @param frameEnds  A buffer of the indexes of rows at which the frame
-  /// for the current row ends.
+  /// for the current row ends. The frame bounds are inclusive and relative
+  /// to the start of the partition. A frame start before the partition is
+  /// its first row and a frame end after the partition is its last row. The
+  /// frame of a row is empty if its start is past its end.
   /// @param resultOffset  This function is invoked multiple times for a
   /// partition as output buffers are available for it. resultOffset
   /// is the offset in the result buffer corresponding to the current
@@ -86,6 +89,7 @@ class WindowFunction {
       const std::string& name,
       const std::vector<WindowFunctionArg>& args,
       const TypePtr& resultType,
+      bool ignoreNulls,
       memory::MemoryPool* pool);
 
  protected:
@@ -99,9 +103,12 @@ class WindowFunction {
 /// operator. These indices are used to access data from the WindowPartition
 /// object.
 /// @param resultType  Type of the result of the function.
+/// @param ignoreNulls  True if the function was called with IGNORE NULLS.
+/// Only value functions like lag or first_value act on it.
 using WindowFunctionFactory = std::function<std::unique_ptr<WindowFunction>(
     const std::vector<WindowFunctionArg>& args,
     const TypePtr& resultType,
+    bool ignoreNulls,
     memory::MemoryPool* pool)>;
 
 /// Register a window function with the specified name and signatures.
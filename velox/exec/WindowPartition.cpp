@@ -26,4 +26,50 @@ void WindowPartition::resetPartition(const folly::Range<char**>& rows) {
   partition_ = rows;
 }
 
+void WindowPartition::extractColumn(
+    column_index_t columnIndex,
+    vector_size_t partitionOffset,
+    vector_size_t numRows,
+    vector_size_t resultOffset,
+    const VectorPtr& result) const {
+  VELOX_CHECK_LE(partitionOffset + numRows, partition_.size());
+  RowContainer::extractColumn(
+      partition_.data() + partitionOffset,
+      numRows,
+      columns_[columnIndex],
+      resultOffset,
+      result);
+}
+
+void WindowPartition::extractColumn(
+    column_index_t columnIndex,
+    folly::Range<const vector_size_t*> rowNumbers,
+    vector_size_t resultOffset,
+    const VectorPtr& result) const {
+  RowContainer::extractColumn(
+      partition_.data(),
+      rowNumbers,
+      columns_[columnIndex],
+      resultOffset,
+      result);
+}
+
+void WindowPartition::extractNulls(
+    column_index_t columnIndex,
+    vector_size_t partitionOffset,
+    vector_size_t numRows,
+    uint64_t* nulls) const {
+  VELOX_CHECK_LE(partitionOffset + numRows, partition_.size());
+  const auto& column = columns_[columnIndex];
+  for (auto i = 0; i < numRows; ++i) {
+    bits::setBit(
+        nulls,
+        i,
+        RowContainer::isNullAt(
+            partition_[partitionOffset + i],
+            column.nullByte(),
+            column.nullMask()));
+  }
+}
+
 } // namespace facebook::velox::exec
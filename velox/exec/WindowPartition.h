@@ -20,7 +20,8 @@
 
 /// Simple WindowPartition that builds over the RowContainer used for storing
 /// the input rows in the Window Operator. This works completely in-memory.
-/// TODO: This implementation will be revised for Spill to disk semantics.
+/// If the Window Operator has spilled its input, the rows of the partition
+/// are read back into memory before the partition is reset.
 
 namespace facebook::velox::exec {
 class WindowPartition {
@@ -36,6 +37,38 @@ class WindowPartition {
 
   void resetPartition(const folly::Range<char**>& rows);
 
+  /// Copies the values of the column at 'columnIndex' of the 'numRows' rows
+  /// starting at 'partitionOffset' in the partition into 'result' starting
+  /// at 'resultOffset'. 'columnIndex' is the position of the column in the
+  /// input row of the Window operator.
+  void extractColumn(
+      column_index_t columnIndex,
+      vector_size_t partitionOffset,
+      vector_size_t numRows,
+      vector_size_t resultOffset,
+      const VectorPtr& result) const;
+
+  /// Copies the values of the column at 'columnIndex' of the rows at
+  /// 'rowNumbers' in the partition into 'result' starting at 'resultOffset'.
+  /// The values are read directly from the rows of the partition, so that
+  /// only the values at 'rowNumbers' are copied. A negative row number sets
+  /// the corresponding row of 'result' to null.
+  void extractColumn(
+      column_index_t columnIndex,
+      folly::Range<const vector_size_t*> rowNumbers,
+      vector_size_t resultOffset,
+      const VectorPtr& result) const;
+
+  /// Sets the bits in 'nulls' for the 'numRows' rows starting at
+  /// 'partitionOffset' in the partition for which the column at
+  /// 'columnIndex' is null. 'nulls' must have at least 'numRows' bits. Bit i
+  /// is for row 'partitionOffset' + i.
+  void extractNulls(
+      column_index_t columnIndex,
+      vector_size_t partitionOffset,
+      vector_size_t numRows,
+      uint64_t* nulls) const;
+
  private:
   // This is a copy of the input RowColumn objects that are used for
   // accessing the partition row columns. These RowColumn objects
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/WorkStealingExecutor.h"
+#include <glog/logging.h>
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::exec {
+namespace {
+// The executor and the worker index of the calling thread if it is a worker.
+thread_local const WorkStealingExecutor* currentExecutor = nullptr;
+thread_local int32_t currentWorkerIndex = -1;
+} // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(int32_t numThreads) {
+  VELOX_CHECK_GT(numThreads, 0);
+  queues_.reserve(numThreads);
+  for (auto i = 0; i < numThreads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  threads_.reserve(numThreads);
+  for (auto i = 0; i < numThreads; ++i) {
+    threads_.emplace_back([this, i]() { run(i); });
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  {
+    std::lock_guard<std::mutex> l(idleMutex_);
+    stop_ = true;
+    for (auto& queue : queues_) {
+      queue->idle.notify_one();
+    }
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkStealingExecutor::add(folly::Func func) {
+  addWithAffinity(std::move(func), currentWorker());
+}
+
+void WorkStealingExecutor::addWithAffinity(folly::Func func, int32_t worker) {
+  if (worker < 0 || worker >= queues_.size()) {
+    worker = nextQueue_++ % queues_.size();
+  }
+  push(worker, std::move(func));
+}
+
+int32_t WorkStealingExecutor::currentWorker() const {
+  return currentExecutor == this ? currentWorkerIndex : -1;
+}
+
+void WorkStealingExecutor::push(int32_t worker, folly::Func func) {
+  {
+    auto& queue = *queues_[worker];
+    std::lock_guard<std::mutex> l(queue.mutex);
+    queue.funcs.push_back(std::move(func));
+  }
+  ++numQueued_;
+  // A worker that goes idle increments 'numSleeping_' before checking
+  // 'numQueued_', so either it sees the function or it is woken up here.
+  if (numSleeping_ > 0) {
+    wakeUp(worker);
+  }
+}
+
+void WorkStealingExecutor::wakeUp(int32_t worker) {
+  std::lock_guard<std::mutex> l(idleMutex_);
+  for (auto i = 0; i < queues_.size(); ++i) {
+    auto& queue = *queues_[(worker + i) % queues_.size()];
+    if (queue.sleeping) {
+      queue.sleeping = false;
+      queue.idle.notify_one();
+      return;
+    }
+  }
+}
+
+folly::Func WorkStealingExecutor::take(int32_t worker) {
+  {
+    auto& queue = *queues_[worker];
+    std::lock_guard<std::mutex> l(queue.mutex);
+    if (!queue.funcs.empty()) {
+      auto func = std::move(queue.funcs.front());
+      queue.funcs.pop_front();
+      --numQueued_;
+      return func;
+    }
+  }
+  // Steals the most recently queued function of another worker, so that the
+  // victim keeps the ones that have waited longest.
+  const auto numQueues = queues_.size();
+  for (auto i = 1; i < numQueues; ++i) {
+    auto& queue = *queues_[(worker + i) % numQueues];
+    std::lock_guard<std::mutex> l(queue.mutex);
+    if (!queue.funcs.empty()) {
+      auto func = std::move(queue.funcs.back());
+      queue.funcs.pop_back();
+      --numQueued_;
+      ++numStolen_;
+      return func;
+    }
+  }
+  return nullptr;
+}
+
+void WorkStealingExecutor::run(int32_t worker) {
+  currentExecutor = this;
+  currentWorkerIndex = worker;
+  for (;;) {
+    if (auto func = take(worker)) {
+      try {
+        func();
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Exception in WorkStealingExecutor: " << e.what();
+      }
+      continue;
+    }
+    auto& queue = *queues_[worker];
+    std::unique_lock<std::mutex> l(idleMutex_);
+    if (stop_ && numQueued_ == 0) {
+      return;
+    }
+    ++numSleeping_;
+    if (numQueued_ > 0) {
+      // A function was added after take().
+      --numSleeping_;
+      continue;
+    }
+    queue.sleeping = true;
+    queue.idle.wait(l, [&]() { return !queue.sleeping || stop_; });
+    queue.sleeping = false;
+    --numSleeping_;
+  }
+}
+
+} // namespace facebook::velox::exec
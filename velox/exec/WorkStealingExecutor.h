@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Executor.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace facebook::velox::exec {
+
+/// An executor for Drivers with a run queue per worker thread. A worker runs
+/// the functions of its own queue in order and steals from the other queues
+/// when its own is empty. A function added from a worker goes to the queue of
+/// that worker and may be placed on a given worker with addWithAffinity(), so
+/// that a Driver resumes on the worker, and so the core, that last ran it.
+/// Adding to a worker's queue only contends with that worker and with
+/// stealing, unlike a single shared queue.
+///
+/// Driver::enqueue() uses the affinity when the QueryCtx executor is a
+/// WorkStealingExecutor.
+class WorkStealingExecutor : public folly::Executor {
+ public:
+  explicit WorkStealingExecutor(int32_t numThreads);
+
+  /// Runs the functions that are still queued and joins the threads.
+  ~WorkStealingExecutor() override;
+
+  /// Adds 'func' to the queue of the calling worker or, if not called from a
+  /// worker of 'this', to the queues in turn.
+  void add(folly::Func func) override;
+
+  /// Adds 'func' to the queue of 'worker'. Same as add() if 'worker' is not a
+  /// worker index of 'this', e.g. -1.
+  void addWithAffinity(folly::Func func, int32_t worker);
+
+  /// Returns the index of the worker of 'this' that runs the calling thread,
+  /// or -1 if the calling thread is not a worker of 'this'.
+  int32_t currentWorker() const;
+
+  int32_t numThreads() const {
+    return queues_.size();
+  }
+
+  /// Returns the number of functions that ran on a worker other than the one
+  /// they were queued on.
+  uint64_t numStolen() const {
+    return numStolen_;
+  }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<folly::Func> funcs;
+    // The worker waits here when all queues are empty. 'sleeping' is
+    // guarded by 'idleMutex_' and cleared by the thread that wakes the
+    // worker.
+    std::condition_variable idle;
+    bool sleeping{false};
+  };
+
+  void push(int32_t worker, folly::Func func);
+
+  // Wakes up the worker of 'worker' if it sleeps and otherwise another
+  // sleeping worker, which may steal the function.
+  void wakeUp(int32_t worker);
+
+  // Takes the oldest function of the queue of 'worker' or, if empty, the
+  // newest of another queue. Returns nullptr if all queues are empty.
+  folly::Func take(int32_t worker);
+
+  void run(int32_t worker);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  // Number of queued functions in all queues.
+  std::atomic<int64_t> numQueued_{0};
+  std::atomic<int32_t> numSleeping_{0};
+  std::atomic<uint64_t> nextQueue_{0};
+  std::atomic<uint64_t> numStolen_{0};
+  std::atomic_bool stop_{false};
+  std::mutex idleMutex_;
+};
+
+} // namespace facebook::velox::exec
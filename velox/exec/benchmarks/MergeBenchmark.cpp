@@ -26,6 +26,9 @@ using namespace facebook::velox::exec::test;
 TestData narrow;
 TestData medium;
 TestData wide;
+// 37 streams with the values in clusters of 100 and 10000 consecutive values.
+TestData clustered100;
+TestData clustered10K;
 
 BENCHMARK(narrowTree) {
   MergeTestBase::test<TreeOfLosers<TestingStream>>(narrow, false);
@@ -43,6 +46,13 @@ BENCHMARK_RELATIVE(mediumArray) {
   MergeTestBase::test<MergeArray<TestingStream>>(medium, false);
 }
 
+// Taking the rows of the winner up to the runner-up at a time costs little
+// when the streams interleave row by row and saves most of the comparisons
+// when they come in runs.
+BENCHMARK_RELATIVE(mediumTreeRuns) {
+  MergeTestBase::testRuns(medium, false);
+}
+
 BENCHMARK(wideTree) {
   MergeTestBase::test<TreeOfLosers<TestingStream>>(wide, false);
 }
@@ -51,6 +61,22 @@ BENCHMARK_RELATIVE(wideArray) {
   MergeTestBase::test<MergeArray<TestingStream>>(wide, false);
 }
 
+BENCHMARK(clustered100Tree) {
+  MergeTestBase::test<TreeOfLosers<TestingStream>>(clustered100, false);
+}
+
+BENCHMARK_RELATIVE(clustered100TreeRuns) {
+  MergeTestBase::testRuns(clustered100, false);
+}
+
+BENCHMARK(clustered10KTree) {
+  MergeTestBase::test<TreeOfLosers<TestingStream>>(clustered10K, false);
+}
+
+BENCHMARK_RELATIVE(clustered10KTreeRuns) {
+  MergeTestBase::testRuns(clustered10K, false);
+}
+
 int main(int argc, char* argv[]) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
   MergeTestBase test;
@@ -58,6 +84,8 @@ int main(int argc, char* argv[]) {
   narrow = test.makeTestData(100'000'000, 7);
   medium = test.makeTestData(10'000'0000, 37);
   wide = test.makeTestData(10'000'0000, 1029);
+  clustered100 = test.makeTestData(10'000'000, 37, 100);
+  clustered10K = test.makeTestData(10'000'000, 37, 10'000);
   folly::runBenchmarks();
   return 0;
 }
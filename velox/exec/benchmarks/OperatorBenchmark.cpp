@@ -0,0 +1,657 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Microbenchmarks for the building blocks of the hash join, aggregation,
+// order by and merge operators. The inputs are made with VectorFuzzer and
+// the benchmarks are a cross product of the key types, key cardinalities,
+// row widths, null ratios and encodings given by the flags below. Each
+// benchmark counts one iteration per row, so the folly output gives the time
+// per row. A summary of rows/s and bytes/s over the flat size of the input
+// is printed after the benchmarks have run.
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/Random.h>
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
+#include "velox/exec/HashTable.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Spiller.h"
+#include "velox/exec/TreeOfLosers.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+DEFINE_int32(batch_size, 10'000, "Rows per input batch");
+DEFINE_int32(num_batches, 10, "Input batches per benchmark");
+DEFINE_string(
+    key_types,
+    "BIGINT,VARCHAR,INTEGER:VARCHAR",
+    "Comma separated key types. Multicolumn keys are separated by ':'");
+DEFINE_string(
+    cardinalities,
+    "1000,100000",
+    "Comma separated numbers of distinct keys");
+DEFINE_string(
+    row_widths,
+    "2,8",
+    "Comma separated numbers of dependent columns besides the keys");
+DEFINE_string(null_ratios, "0,0.1", "Comma separated null ratios");
+DEFINE_string(
+    encodings,
+    "flat,dictionary,constant",
+    "Comma separated encodings of the input columns");
+DEFINE_string(
+    operations,
+    "hashBuild,joinProbe,groupProbe,store,extract,spill,restore,merge",
+    "Comma separated operations to benchmark");
+DEFINE_int32(merge_fan_in, 16, "Number of sorted runs for the merge");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+
+enum class Encoding { kFlat, kDictionary, kConstant };
+
+Encoding encodingFromName(const std::string& name) {
+  if (name == "flat") {
+    return Encoding::kFlat;
+  }
+  if (name == "dictionary") {
+    return Encoding::kDictionary;
+  }
+  if (name == "constant") {
+    return Encoding::kConstant;
+  }
+  VELOX_USER_FAIL("Unknown encoding: {}", name);
+}
+
+template <typename T>
+std::vector<T> splitFlag(const std::string& flag, char delimiter = ',') {
+  std::vector<std::string> pieces;
+  folly::split(delimiter, flag, pieces, true);
+  std::vector<T> values;
+  for (auto& piece : pieces) {
+    values.push_back(folly::to<T>(piece));
+  }
+  return values;
+}
+
+struct BenchmarkParams {
+  std::string keyTypesName;
+  std::vector<TypePtr> keyTypes;
+  int32_t cardinality;
+  int32_t numDependents;
+  double nullRatio;
+  std::string encodingName;
+  Encoding encoding;
+
+  std::string toString() const {
+    return fmt::format(
+        "{}_card{}_width{}_nulls{}_{}",
+        keyTypesName,
+        cardinality,
+        numDependents,
+        nullRatio,
+        encodingName);
+  }
+};
+
+struct Throughput {
+  uint64_t rows{0};
+  uint64_t bytes{0};
+  uint64_t micros{0};
+};
+
+// Merges the rows of a RowContainer from runs sorted on the keys.
+class RowStream final : public MergeStream {
+ public:
+  RowStream(RowContainer* container, std::vector<char*> rows)
+      : container_(container), rows_(std::move(rows)) {}
+
+  bool hasData() const final {
+    return index_ < rows_.size();
+  }
+
+  bool operator<(const MergeStream& other) const final {
+    return compare(other) < 0;
+  }
+
+  int32_t compare(const MergeStream& other) const final {
+    return container_->compareRows(
+        current(), static_cast<const RowStream&>(other).current());
+  }
+
+  char* current() const {
+    return rows_[index_];
+  }
+
+  void pop() {
+    ++index_;
+  }
+
+ private:
+  RowContainer* const container_;
+  const std::vector<char*> rows_;
+  size_t index_{0};
+};
+
+// Holds the input for one BenchmarkParams and runs the operations on it.
+class OperatorBenchmark {
+ public:
+  explicit OperatorBenchmark(const BenchmarkParams& params)
+      : params_(params) {
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    for (auto i = 0; i < params_.keyTypes.size(); ++i) {
+      names.push_back(fmt::format("k{}", i));
+      types.push_back(params_.keyTypes[i]);
+    }
+    static const std::vector<TypePtr> kDependentTypes = {
+        BIGINT(), DOUBLE(), VARCHAR()};
+    for (auto i = 0; i < params_.numDependents; ++i) {
+      names.push_back(fmt::format("d{}", i));
+      dependentTypes_.push_back(kDependentTypes[i % kDependentTypes.size()]);
+      types.push_back(dependentTypes_.back());
+    }
+    rowType_ = ROW(std::move(names), std::move(types));
+    makeBatches();
+  }
+
+  const BenchmarkParams& params() const {
+    return params_;
+  }
+
+  unsigned
+  run(const std::string& operation, unsigned iters, Throughput& total) {
+    for (auto i = 0; i < iters; ++i) {
+      if (operation == "hashBuild") {
+        hashBuild(total);
+      } else if (operation == "joinProbe") {
+        joinProbe(total);
+      } else if (operation == "groupProbe") {
+        groupProbe(total);
+      } else if (operation == "store") {
+        store(total);
+      } else if (operation == "extract") {
+        extract(total);
+      } else if (operation == "spill") {
+        spill(total, false);
+      } else if (operation == "restore") {
+        spill(total, true);
+      } else if (operation == "merge") {
+        merge(total);
+      } else {
+        VELOX_USER_FAIL("Unknown operation: {}", operation);
+      }
+      total.rows += numRows_;
+      total.bytes += numBytes_;
+    }
+    return static_cast<unsigned>(iters * numRows_);
+  }
+
+ private:
+  int32_t numKeys() const {
+    return params_.keyTypes.size();
+  }
+
+  BufferPtr makeIndices(int32_t size, int32_t range) {
+    auto indices = AlignedBuffer::allocate<vector_size_t>(size, pool_.get());
+    auto rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < size; ++i) {
+      rawIndices[i] = folly::Random::rand32(range, rng_);
+    }
+    return indices;
+  }
+
+  VectorPtr encode(const VectorPtr& base, const BufferPtr& indices) {
+    const auto size = FLAGS_batch_size;
+    switch (params_.encoding) {
+      case Encoding::kFlat: {
+        auto flat = BaseVector::wrapInDictionary(nullptr, indices, size, base);
+        BaseVector::flattenVector(flat, size);
+        return flat;
+      }
+      case Encoding::kDictionary:
+        return BaseVector::wrapInDictionary(nullptr, indices, size, base);
+      case Encoding::kConstant:
+        return BaseVector::wrapInConstant(
+            size, indices->as<vector_size_t>()[0], base);
+    }
+    VELOX_UNREACHABLE();
+  }
+
+  // Makes the batches so that the keys of all batches together take
+  // 'cardinality' distinct values. The columns of a multicolumn key share
+  // the indices into their distinct values.
+  void makeBatches() {
+    VectorFuzzer::Options options;
+    options.nullRatio = params_.nullRatio;
+    options.stringLength = 20;
+    options.stringVariableLength = true;
+    VectorFuzzer fuzzer(options, pool_.get());
+
+    std::vector<VectorPtr> distinctKeys;
+    for (auto& type : params_.keyTypes) {
+      distinctKeys.push_back(fuzzer.fuzzFlat(type, params_.cardinality));
+    }
+    for (auto batchIndex = 0; batchIndex < FLAGS_num_batches; ++batchIndex) {
+      std::vector<VectorPtr> children;
+      auto keyIndices = makeIndices(FLAGS_batch_size, params_.cardinality);
+      for (auto& keys : distinctKeys) {
+        children.push_back(encode(keys, keyIndices));
+      }
+      for (auto& type : dependentTypes_) {
+        auto base = fuzzer.fuzzFlat(type, FLAGS_batch_size);
+        children.push_back(
+            encode(base, makeIndices(FLAGS_batch_size, FLAGS_batch_size)));
+      }
+      batches_.push_back(std::make_shared<RowVector>(
+          pool_.get(),
+          rowType_,
+          nullptr,
+          FLAGS_batch_size,
+          std::move(children)));
+      numBytes_ += batches_.back()->estimateFlatSize();
+    }
+    numRows_ = FLAGS_batch_size * FLAGS_num_batches;
+  }
+
+  std::vector<std::unique_ptr<VectorHasher>> makeHashers() const {
+    std::vector<std::unique_ptr<VectorHasher>> hashers;
+    for (auto i = 0; i < numKeys(); ++i) {
+      hashers.push_back(
+          std::make_unique<VectorHasher>(params_.keyTypes[i], i));
+    }
+    return hashers;
+  }
+
+  // Adds the rows with non-null keys to a join table like HashBuild.
+  std::unique_ptr<HashTable<true>> buildJoinTable() {
+    auto table = HashTable<true>::createForJoin(
+        makeHashers(), dependentTypes_, true, false, mappedMemory_);
+    auto& hashers = table->hashers();
+    auto rowContainer = table->rows();
+    const auto nextOffset = rowContainer->nextOffset();
+    std::vector<DecodedVector> decoders(params_.numDependents);
+    raw_vector<uint64_t> hashes(FLAGS_batch_size);
+    bool analyzeKeys = true;
+    SelectivityVector rows(FLAGS_batch_size);
+    for (auto& batch : batches_) {
+      rows.setAll();
+      for (auto i = 0; i < hashers.size(); ++i) {
+        hashers[i]->decode(*batch->childAt(i), rows);
+      }
+      deselectRowsWithNulls(hashers, rows);
+      for (auto i = 0; i < decoders.size(); ++i) {
+        decoders[i].decode(*batch->childAt(i + numKeys()), rows);
+      }
+      for (auto& hasher : hashers) {
+        if (analyzeKeys) {
+          hasher->computeValueIds(rows, hashes);
+          analyzeKeys = hasher->mayUseValueIds();
+        }
+      }
+      rows.applyToSelected([&](auto row) {
+        char* newRow = rowContainer->newRow();
+        if (nextOffset) {
+          *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+        }
+        for (auto i = 0; i < hashers.size(); ++i) {
+          rowContainer->store(hashers[i]->decodedVector(), row, newRow, i);
+        }
+        for (auto i = 0; i < decoders.size(); ++i) {
+          rowContainer->store(decoders[i], row, newRow, i + numKeys());
+        }
+      });
+    }
+    table->prepareJoinTable({});
+    return table;
+  }
+
+  void hashBuild(Throughput& total) {
+    MicrosecondTimer timer(&total.micros);
+    auto table = buildJoinTable();
+    folly::doNotOptimizeAway(table->numDistinct());
+  }
+
+  // Probes the join table with the input like HashProbe.
+  void joinProbe(Throughput& total) {
+    folly::BenchmarkSuspender suspender;
+    auto table = buildJoinTable();
+    auto hashers = makeHashers();
+    auto& buildHashers = table->hashers();
+    const auto mode = table->hashMode();
+    HashLookup lookup(buildHashers);
+    VectorHasher::ScratchMemory scratchMemory;
+    SelectivityVector rows(FLAGS_batch_size);
+    int64_t numHits = 0;
+    suspender.dismiss();
+
+    MicrosecondTimer timer(&total.micros);
+    for (auto& batch : batches_) {
+      rows.setAll();
+      for (auto i = 0; i < hashers.size(); ++i) {
+        hashers[i]->decode(*batch->childAt(i), rows);
+      }
+      deselectRowsWithNulls(hashers, rows);
+      lookup.reset(batch->size());
+      for (auto i = 0; i < hashers.size(); ++i) {
+        if (mode != BaseHashTable::HashMode::kHash) {
+          buildHashers[i]->lookupValueIds(
+              *batch->childAt(i), rows, scratchMemory, lookup.hashes);
+        } else {
+          hashers[i]->hash(rows, i > 0, lookup.hashes);
+        }
+      }
+      lookup.rows.clear();
+      rows.applyToSelected([&](auto row) { lookup.rows.push_back(row); });
+      if (lookup.rows.empty()) {
+        continue;
+      }
+      table->joinProbe(lookup);
+      for (auto row : lookup.rows) {
+        numHits += lookup.hits[row] != nullptr;
+      }
+    }
+    folly::doNotOptimizeAway(numHits);
+  }
+
+  // Adds the input to a group by table like GroupingSet.
+  void groupProbe(Throughput& total) {
+    folly::BenchmarkSuspender suspender;
+    static const std::vector<std::unique_ptr<Aggregate>> kNoAggregates;
+    auto table = HashTable<false>::createForAggregation(
+        makeHashers(), kNoAggregates, mappedMemory_);
+    HashLookup lookup(table->hashers());
+    SelectivityVector rows(FLAGS_batch_size);
+    suspender.dismiss();
+
+    MicrosecondTimer timer(&total.micros);
+    for (auto& batch : batches_) {
+      insertGroups(*batch, rows, lookup, *table);
+    }
+    folly::doNotOptimizeAway(table->numDistinct());
+  }
+
+  void insertGroups(
+      const RowVector& input,
+      const SelectivityVector& rows,
+      HashLookup& lookup,
+      HashTable<false>& table) {
+    lookup.reset(rows.end());
+    lookup.rows.resize(rows.end());
+    std::iota(lookup.rows.begin(), lookup.rows.end(), 0);
+    auto& hashers = table.hashers();
+    const auto mode = table.hashMode();
+    bool rehash = false;
+    for (auto i = 0; i < hashers.size(); ++i) {
+      hashers[i]->decode(*input.childAt(i), rows);
+      if (mode != BaseHashTable::HashMode::kHash) {
+        if (!hashers[i]->computeValueIds(rows, lookup.hashes)) {
+          rehash = true;
+        }
+      } else {
+        hashers[i]->hash(rows, i > 0, lookup.hashes);
+      }
+    }
+    if (rehash) {
+      if (table.hashMode() != BaseHashTable::HashMode::kHash) {
+        table.decideHashMode(input.size());
+      }
+      insertGroups(input, rows, lookup, table);
+      return;
+    }
+    table.groupProbe(lookup);
+  }
+
+  std::unique_ptr<RowContainer> makeRowContainer() const {
+    return std::make_unique<RowContainer>(
+        params_.keyTypes, dependentTypes_, mappedMemory_);
+  }
+
+  // Stores all the input in 'container' and returns the rows.
+  std::vector<char*> storeRows(RowContainer& container) {
+    std::vector<char*> rows(numRows_);
+    std::vector<DecodedVector> decoders(rowType_->size());
+    SelectivityVector allRows(FLAGS_batch_size);
+    auto* nextRow = rows.data();
+    for (auto& batch : batches_) {
+      for (auto i = 0; i < decoders.size(); ++i) {
+        decoders[i].decode(*batch->childAt(i), allRows);
+      }
+      for (auto row = 0; row < batch->size(); ++row) {
+        *nextRow = container.newRow();
+        for (auto i = 0; i < decoders.size(); ++i) {
+          container.store(decoders[i], row, *nextRow, i);
+        }
+        ++nextRow;
+      }
+    }
+    return rows;
+  }
+
+  void store(Throughput& total) {
+    folly::BenchmarkSuspender suspender;
+    auto container = makeRowContainer();
+    suspender.dismiss();
+
+    MicrosecondTimer timer(&total.micros);
+    folly::doNotOptimizeAway(storeRows(*container).size());
+  }
+
+  void extract(Throughput& total) {
+    folly::BenchmarkSuspender suspender;
+    auto container = makeRowContainer();
+    const auto rows = storeRows(*container);
+    std::vector<VectorPtr> columns;
+    for (auto i = 0; i < rowType_->size(); ++i) {
+      columns.push_back(BaseVector::create(
+          rowType_->childAt(i), FLAGS_batch_size, pool_.get()));
+    }
+    suspender.dismiss();
+
+    MicrosecondTimer timer(&total.micros);
+    for (auto offset = 0; offset < rows.size(); offset += FLAGS_batch_size) {
+      const auto numRows =
+          std::min<int32_t>(FLAGS_batch_size, rows.size() - offset);
+      for (auto i = 0; i < columns.size(); ++i) {
+        container->extractColumn(rows.data() + offset, numRows, i, columns[i]);
+      }
+    }
+  }
+
+  // Spills all the input sorted on the keys like OrderBy. If 'restore' is
+  // true, times reading the spilled rows back in key order instead of the
+  // spilling.
+  void spill(Throughput& total, bool restore) {
+    folly::BenchmarkSuspender suspender;
+    auto container = makeRowContainer();
+    storeRows(*container);
+    Spiller spiller(
+        Spiller::Type::kOrderBy,
+        container.get(),
+        [&](folly::Range<char**> rows) { container->eraseRows(rows); },
+        rowType_,
+        numKeys(),
+        {},
+        spillPath_->path,
+        1L << 30,
+        *pool_,
+        nullptr);
+    if (!restore) {
+      suspender.dismiss();
+      MicrosecondTimer timer(&total.micros);
+      spiller.spill(0, 0);
+      spiller.finishSpill();
+      return;
+    }
+    spiller.spill(0, 0);
+    spiller.finishSpill();
+    suspender.dismiss();
+
+    MicrosecondTimer timer(&total.micros);
+    auto merge = spiller.startMerge(0);
+    int64_t numRows = 0;
+    while (auto* stream = merge->next()) {
+      ++numRows;
+      stream->pop();
+    }
+    VELOX_CHECK_EQ(numRows, numRows_);
+  }
+
+  // Merges 'merge_fan_in' runs of the input sorted on the keys.
+  void merge(Throughput& total) {
+    folly::BenchmarkSuspender suspender;
+    auto container = makeRowContainer();
+    const auto rows = storeRows(*container);
+    std::vector<std::vector<char*>> runs(FLAGS_merge_fan_in);
+    for (auto i = 0; i < rows.size(); ++i) {
+      runs[i % runs.size()].push_back(rows[i]);
+    }
+    std::vector<std::unique_ptr<RowStream>> streams;
+    for (auto& run : runs) {
+      std::sort(run.begin(), run.end(), [&](char* left, char* right) {
+        return container->compareRows(left, right) < 0;
+      });
+      streams.push_back(
+          std::make_unique<RowStream>(container.get(), std::move(run)));
+    }
+    TreeOfLosers<RowStream> tree(std::move(streams));
+    suspender.dismiss();
+
+    MicrosecondTimer timer(&total.micros);
+    int64_t numRows = 0;
+    while (auto* stream = tree.next()) {
+      ++numRows;
+      stream->pop();
+    }
+    VELOX_CHECK_EQ(numRows, rows.size());
+  }
+
+  const BenchmarkParams params_;
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  memory::MappedMemory* const mappedMemory_{
+      memory::MappedMemory::getInstance()};
+  const std::shared_ptr<exec::test::TempDirectoryPath> spillPath_{
+      exec::test::TempDirectoryPath::create()};
+  folly::Random::DefaultGenerator rng_{1};
+  std::vector<TypePtr> dependentTypes_;
+  RowTypePtr rowType_;
+  std::vector<RowVectorPtr> batches_;
+  int64_t numRows_{0};
+  int64_t numBytes_{0};
+};
+
+// The benchmarks of one BenchmarkParams run one after the other, so only the
+// input of the latest one is kept.
+OperatorBenchmark& benchmarkFor(const BenchmarkParams& params) {
+  static std::unique_ptr<OperatorBenchmark> current;
+  if (!current || current->params().toString() != params.toString()) {
+    current.reset();
+    current = std::make_unique<OperatorBenchmark>(params);
+  }
+  return *current;
+}
+
+std::vector<BenchmarkParams> makeParams() {
+  std::vector<BenchmarkParams> allParams;
+  for (auto& keyTypesName : splitFlag<std::string>(FLAGS_key_types)) {
+    std::vector<TypePtr> keyTypes;
+    for (auto& name : splitFlag<std::string>(keyTypesName, ':')) {
+      keyTypes.push_back(createScalarType(mapNameToTypeKind(name)));
+    }
+    for (auto cardinality : splitFlag<int32_t>(FLAGS_cardinalities)) {
+      for (auto width : splitFlag<int32_t>(FLAGS_row_widths)) {
+        for (auto nullRatio : splitFlag<double>(FLAGS_null_ratios)) {
+          for (auto& encoding : splitFlag<std::string>(FLAGS_encodings)) {
+            allParams.push_back(
+                {keyTypesName,
+                 keyTypes,
+                 cardinality,
+                 width,
+                 nullRatio,
+                 encoding,
+                 encodingFromName(encoding)});
+          }
+        }
+      }
+    }
+  }
+  return allParams;
+}
+
+std::vector<std::pair<std::string, Throughput>>& throughputs() {
+  static std::vector<std::pair<std::string, Throughput>> throughputs;
+  return throughputs;
+}
+
+void printThroughputs() {
+  std::cout << fmt::format(
+                   "{:<60} {:>14} {:>14}", "benchmark", "rows/s", "bytes/s")
+            << std::endl;
+  for (auto& [name, throughput] : throughputs()) {
+    if (throughput.micros == 0) {
+      continue;
+    }
+    const double seconds = throughput.micros / 1'000'000.0;
+    const auto bytesPerSecond =
+        static_cast<uint64_t>(throughput.bytes / seconds);
+    std::cout << fmt::format(
+                     "{:<60} {:>14.0f} {:>14}",
+                     name,
+                     throughput.rows / seconds,
+                     succinctBytes(bytesPerSecond))
+              << std::endl;
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  filesystems::registerLocalFileSystem();
+
+  const auto allParams = makeParams();
+  const auto operations = splitFlag<std::string>(FLAGS_operations);
+  // Reserved up front since the benchmarks keep pointers to the elements.
+  throughputs().reserve(allParams.size() * operations.size());
+  for (auto& params : allParams) {
+    for (auto& operation : operations) {
+      const auto name = fmt::format("{}_{}", operation, params.toString());
+      throughputs().push_back({name, Throughput{}});
+      auto* total = &throughputs().back().second;
+      folly::addBenchmark(
+          __FILE__, name, [params, operation, total](unsigned iters) {
+            OperatorBenchmark* benchmark;
+            BENCHMARK_SUSPEND {
+              benchmark = &benchmarkFor(params);
+            }
+            return benchmark->run(operation, iters, *total);
+          });
+    }
+  }
+  folly::runBenchmarks();
+  printThroughputs();
+  return 0;
+}
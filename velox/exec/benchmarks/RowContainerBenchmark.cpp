@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <random>
+#include "velox/exec/RowContainer.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+
+// Extracts the columns of scattered rows, as HashProbe does for the
+// dependents of matching rows and OrderBy for the sorted rows.
+class RowContainerBenchmark {
+ public:
+  static constexpr vector_size_t kNumRows = 1'000'000;
+  static constexpr vector_size_t kBatchSize = 10'000;
+
+  RowContainerBenchmark() {
+    auto data = vectorMaker_.rowVector({
+        vectorMaker_.flatVector<int64_t>(
+            kNumRows, [](auto row) { return row; }),
+        vectorMaker_.flatVector<double>(
+            kNumRows,
+            [](auto row) { return row * 0.1; },
+            VectorMaker::nullEvery(7)),
+        vectorMaker_.flatVector<int32_t>(
+            kNumRows, [](auto row) { return row % 1'000; }),
+    });
+    container_ = std::make_unique<RowContainer>(
+        std::vector<TypePtr>{BIGINT()},
+        std::vector<TypePtr>{DOUBLE(), INTEGER()},
+        memory::MappedMemory::getInstance());
+    SelectivityVector allRows(kNumRows);
+    rows_.resize(kNumRows);
+    for (auto i = 0; i < kNumRows; ++i) {
+      rows_[i] = container_->newRow();
+    }
+    for (auto column = 0; column < data->childrenSize(); ++column) {
+      DecodedVector decoded(*data->childAt(column), allRows);
+      for (auto i = 0; i < kNumRows; ++i) {
+        container_->store(decoded, i, rows_[i], column);
+      }
+    }
+    std::shuffle(rows_.begin(), rows_.end(), std::mt19937(1));
+  }
+
+  // Extracts 'column' of all the rows in batches of kBatchSize.
+  void extract(int32_t column, const TypePtr& type) {
+    folly::BenchmarkSuspender suspender;
+    auto result = BaseVector::create(type, kBatchSize, pool_.get());
+    suspender.dismiss();
+    for (auto i = 0; i < kNumRows; i += kBatchSize) {
+      container_->extractColumn(
+          rows_.data() + i, kBatchSize, column, result);
+      folly::doNotOptimizeAway(result);
+    }
+  }
+
+ private:
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::unique_ptr<RowContainer> container_;
+  std::vector<char*> rows_;
+};
+
+std::unique_ptr<RowContainerBenchmark> benchmark;
+
+BENCHMARK(extractBigintKey) {
+  benchmark->extract(0, BIGINT());
+}
+
+BENCHMARK(extractNullableDouble) {
+  benchmark->extract(1, DOUBLE());
+}
+
+BENCHMARK(extractInteger) {
+  benchmark->extract(2, INTEGER());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<RowContainerBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -686,6 +686,236 @@ TEST_F(AggregationTest, partialAggregationMemoryLimit) {
           .customStats.count("flushRowCount"));
 }
 
+TEST_F(AggregationTest, abandonPartialAggregation) {
+  // Unique keys followed by few keys.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 14; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            100, [&](auto row) { return i < 4 ? i * 100 + row : row % 5; }),
+        makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+        makeFlatVector<StringView>(
+            100,
+            [](auto row) { return StringView(std::string(row % 20, 'x')); },
+            nullEvery(7)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId aggNodeId;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .partialAggregation(
+                      {"c0"}, {"count(1)", "sum(c1)", "max(c2)", "avg(c1)"})
+                  .capturePlanNodeId(aggNodeId)
+                  .finalAggregation()
+                  .planNode();
+  const std::string referenceQuery =
+      "SELECT c0, count(1), sum(c1), max(c2), avg(c1) FROM tmp GROUP BY 1";
+
+  // The first batch is aggregated, then the estimate shows all keys distinct
+  // and the next 3 batches pass through. The estimate over the 5th batch shows
+  // few keys and the rest is aggregated again.
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(QueryConfig::kAbandonPartialAggregationMinRows, "100")
+          .config(QueryConfig::kAbandonPartialAggregationMinPct, "80")
+          .plan(plan)
+          .assertResults(referenceQuery);
+  auto stats = toPlanStats(task->taskStats()).at(aggNodeId).customStats;
+  EXPECT_EQ(1, stats.at("abandonedPartialAggregation").sum);
+  EXPECT_EQ(1, stats.at("resumedPartialAggregation").sum);
+  EXPECT_EQ(300, stats.at("abandonedPartialAggregationRows").sum);
+
+  // Disabled by default.
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .plan(plan)
+             .assertResults(referenceQuery);
+  stats = toPlanStats(task->taskStats()).at(aggNodeId).customStats;
+  EXPECT_EQ(0, stats.count("abandonedPartialAggregation"));
+}
+
+TEST_F(AggregationTest, detectClusteredInput) {
+  // Runs of 30 rows per key that span the batch boundaries.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (i * 1'000 + row) / 30; }),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId aggNodeId;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .partialAggregation({"c0"}, {"count(1)", "sum(c1)"})
+                  .capturePlanNodeId(aggNodeId)
+                  .finalAggregation()
+                  .planNode();
+  const std::string referenceQuery =
+      "SELECT c0, count(1), sum(c1) FROM tmp GROUP BY 1";
+
+  // Outputs the groups that end in each batch right after the batch. A group
+  // that continues into the next batch is output once.
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .config(
+                      QueryConfig::kPartialAggregationDetectClusteredInput,
+                      "true")
+                  .plan(plan)
+                  .assertResults(referenceQuery);
+  auto stats = toPlanStats(task->taskStats()).at(aggNodeId);
+  EXPECT_EQ(334, stats.outputRows);
+  EXPECT_GE(stats.outputVectors, vectors.size());
+
+  // Without detection, all groups are output at the end.
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .plan(plan)
+             .assertResults(referenceQuery);
+  stats = toPlanStats(task->taskStats()).at(aggNodeId);
+  EXPECT_EQ(334, stats.outputRows);
+  EXPECT_LT(stats.outputVectors, vectors.size());
+
+  // Interleaved keys are aggregated as usual.
+  std::vector<RowVectorPtr> interleaved;
+  for (auto i = 0; i < 10; ++i) {
+    interleaved.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 7; }),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+    }));
+  }
+  createDuckDbTable(interleaved);
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .config(
+                 QueryConfig::kPartialAggregationDetectClusteredInput, "true")
+             .plan(PlanBuilder()
+                       .values(interleaved)
+                       .partialAggregation({"c0"}, {"count(1)", "sum(c1)"})
+                       .capturePlanNodeId(aggNodeId)
+                       .finalAggregation()
+                       .planNode())
+             .assertResults(referenceQuery);
+  EXPECT_EQ(7, toPlanStats(task->taskStats()).at(aggNodeId).outputRows);
+}
+
+TEST_F(AggregationTest, filterProjectInputRows) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 17; }),
+        makeFlatVector<int64_t>(1'000, [&](auto row) { return i + row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  // The aggregation takes the rows that pass the filter without them being
+  // wrapped. The last rows of a batch fail the second filter.
+  for (const auto& [filter, numRows] :
+       std::vector<std::pair<std::string, int64_t>>{
+           {"c1 % 3 = 0", 3'334}, {"c1 < 500", 4'955}}) {
+    SCOPED_TRACE(filter);
+    core::PlanNodeId projectNodeId;
+    core::PlanNodeId aggNodeId;
+    auto task =
+        AssertQueryBuilder(duckDbQueryRunner_)
+            .plan(PlanBuilder()
+                      .values(vectors)
+                      .filter(filter)
+                      .project({"c0", "c1 * 2 AS d"})
+                      .capturePlanNodeId(projectNodeId)
+                      .partialAggregation({"c0"}, {"count(1)", "sum(d)"})
+                      .capturePlanNodeId(aggNodeId)
+                      .finalAggregation()
+                      .planNode())
+            .assertResults(fmt::format(
+                "SELECT c0, count(1), sum(c1 * 2) FROM tmp WHERE {} "
+                "GROUP BY 1",
+                filter));
+    auto planStats = toPlanStats(task->taskStats());
+    EXPECT_EQ(numRows, planStats.at(projectNodeId).outputRows);
+    EXPECT_EQ(numRows, planStats.at(aggNodeId).inputRows);
+
+    // A filter without a projection and a global aggregation.
+    AssertQueryBuilder(duckDbQueryRunner_)
+        .plan(PlanBuilder()
+                  .values(vectors)
+                  .filter(filter)
+                  .partialAggregation({}, {"count(1)", "sum(c1)"})
+                  .finalAggregation()
+                  .planNode())
+        .assertResults(
+            fmt::format("SELECT count(1), sum(c1) FROM tmp WHERE {}", filter));
+  }
+}
+
+TEST_F(AggregationTest, columnarAccumulators) {
+  // More groups than fit in one block of accumulators.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            2'000, [&](auto row) { return (i * 2'000 + row) % 6'000; }),
+        makeFlatVector<int32_t>(
+            2'000, [](auto row) { return row; }, nullEvery(7)),
+        makeFlatVector<double>(
+            2'000, [](auto row) { return row * 0.1; }, nullEvery(11)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  const std::vector<std::string> aggregates = {
+      "count(1)",
+      "count(c1)",
+      "sum(c1)",
+      "min(c1)",
+      "max(c2)",
+      "avg(c2)",
+      "sum(c2)"};
+  const std::string referenceQuery =
+      "SELECT c0, count(1), count(c1), sum(c1), min(c1), max(c2), avg(c2), "
+      "sum(c2) FROM tmp GROUP BY 1";
+
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .config(QueryConfig::kAggregationColumnarAccumulators, "true")
+      .plan(PlanBuilder()
+                .values(vectors)
+                .singleAggregation({"c0"}, aggregates)
+                .planNode())
+      .assertResults(referenceQuery);
+
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .config(QueryConfig::kAggregationColumnarAccumulators, "true")
+      .plan(PlanBuilder()
+                .values(vectors)
+                .partialAggregation({"c0"}, aggregates)
+                .finalAggregation()
+                .planNode())
+      .assertResults(referenceQuery);
+
+  // The partial aggregation flushes its groups when running out of memory
+  // and starts over with new groups.
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .config(QueryConfig::kAggregationColumnarAccumulators, "true")
+      .config(QueryConfig::kMaxPartialAggregationMemory, "100000")
+      .plan(PlanBuilder()
+                .values(vectors)
+                .partialAggregation({"c0"}, aggregates)
+                .finalAggregation()
+                .planNode())
+      .assertResults(referenceQuery);
+
+  // Aggregates with variable width accumulators keep these in the rows.
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .config(QueryConfig::kAggregationColumnarAccumulators, "true")
+      .plan(PlanBuilder()
+                .values(vectors)
+                .singleAggregation({"c0"}, {"sum(c1)", "array_agg(c0)"})
+                .project({"c0", "a0", "cardinality(a1)"})
+                .planNode())
+      .assertResults("SELECT c0, sum(c1), count(1) FROM tmp GROUP BY 1");
+}
+
 TEST_F(AggregationTest, partialAggregationMemoryLimitIncrease) {
   constexpr int64_t kGB = 1 << 30;
   constexpr int64_t kB = 1 << 10;
@@ -1159,6 +1389,182 @@ TEST_F(AggregationTest, memoryAllocations) {
   ASSERT_EQ(5, planStats.at(aggNodeId).numMemoryAllocations);
 }
 
+TEST_F(AggregationTest, distinctAggregates) {
+  vector_size_t size = 1'000;
+  auto data = makeRowVector(
+      {"k", "a", "b"},
+      {
+          makeFlatVector<int64_t>(size, [](auto row) { return row % 7; }),
+          makeFlatVector<int64_t>(
+              size, [](auto row) { return row % 13; }, nullEvery(11)),
+          makeFlatVector<StringView>(
+              size,
+              [](auto row) { return StringView(std::string(row % 5, 'x')); }),
+      });
+
+  createDuckDbTable({data, data});
+
+  // Makes a copy of the aggregation node at the root of 'plan' with DISTINCT
+  // set for the aggregates in 'distinctAggregates'.
+  auto withDistinct = [](const core::PlanNodePtr& plan,
+                         const std::vector<bool>& distinctAggregates) {
+    auto aggregation =
+        std::dynamic_pointer_cast<const core::AggregationNode>(plan);
+    return std::make_shared<core::AggregationNode>(
+        aggregation->id(),
+        aggregation->step(),
+        aggregation->groupingKeys(),
+        aggregation->preGroupedKeys(),
+        aggregation->aggregateNames(),
+        aggregation->aggregates(),
+        aggregation->aggregateMasks(),
+        aggregation->ignoreNullKeys(),
+        aggregation->sources()[0],
+        distinctAggregates);
+  };
+
+  // Each combination of group and value appears in both input vectors.
+  const std::vector<std::string> aggregates = {
+      "count(a)", "sum(a)", "count(b)", "max(a)"};
+  const std::vector<bool> distinctAggregates = {true, true, true, false};
+  auto plan = withDistinct(
+      PlanBuilder()
+          .values({data, data})
+          .singleAggregation({"k"}, aggregates)
+          .planNode(),
+      distinctAggregates);
+  ASSERT_EQ(
+      "-- Aggregation[SINGLE [k] a0 := count(DISTINCT ROW[\"a\"]), a1 := sum(DISTINCT ROW[\"a\"]), a2 := count(DISTINCT ROW[\"b\"]), a3 := max(ROW[\"a\"])] -> k:BIGINT, a0:BIGINT, a1:BIGINT, a2:BIGINT, a3:BIGINT\n",
+      plan->toString(true, false));
+  assertQuery(
+      plan,
+      "SELECT k, count(DISTINCT a), sum(DISTINCT a), count(DISTINCT b), max(a) "
+      "FROM tmp GROUP BY k");
+
+  // Global aggregation.
+  plan = withDistinct(
+      PlanBuilder()
+          .values({data, data})
+          .singleAggregation({}, aggregates)
+          .planNode(),
+      distinctAggregates);
+  assertQuery(
+      plan,
+      "SELECT count(DISTINCT a), sum(DISTINCT a), count(DISTINCT b), max(a) "
+      "FROM tmp");
+
+  // Input clustered on the grouping key.
+  auto sorted = makeRowVector(
+      {"k", "a"},
+      {makeFlatVector<int64_t>(size, [](auto row) { return row / 100; }),
+       makeFlatVector<int64_t>(size, [](auto row) { return row % 3; })});
+  createDuckDbTable({sorted});
+  auto aggregation = std::dynamic_pointer_cast<const core::AggregationNode>(
+      PlanBuilder()
+          .values({sorted})
+          .partialStreamingAggregation({"k"}, {"count(a)"})
+          .planNode());
+  plan = std::make_shared<core::AggregationNode>(
+      aggregation->id(),
+      core::AggregationNode::Step::kSingle,
+      aggregation->groupingKeys(),
+      aggregation->preGroupedKeys(),
+      aggregation->aggregateNames(),
+      aggregation->aggregates(),
+      aggregation->aggregateMasks(),
+      aggregation->ignoreNullKeys(),
+      aggregation->sources()[0],
+      std::vector<bool>{true});
+  assertQuery(plan, "SELECT k, count(DISTINCT a) FROM tmp GROUP BY k");
+
+  // Partial aggregation cannot dedup across drivers.
+  VELOX_ASSERT_THROW(
+      withDistinct(
+          PlanBuilder()
+              .values({data})
+              .partialAggregation({"k"}, {"count(a)"})
+              .planNode(),
+          {true}),
+      "DISTINCT aggregates are supported only in single aggregation");
+}
+
+TEST_F(AggregationTest, localMerge) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [&](auto row) { return row % 317; }),
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return row + i; }, nullEvery(7)),
+    }));
+  }
+  // Makes a copy of the aggregation node at the root of 'plan' with local
+  // merge.
+  auto withLocalMerge = [](const core::PlanNodePtr& plan) {
+    auto aggregation =
+        std::dynamic_pointer_cast<const core::AggregationNode>(plan);
+    return std::make_shared<core::AggregationNode>(
+        aggregation->id(),
+        aggregation->step(),
+        aggregation->groupingKeys(),
+        aggregation->preGroupedKeys(),
+        aggregation->aggregateNames(),
+        aggregation->aggregates(),
+        aggregation->aggregateMasks(),
+        aggregation->ignoreNullKeys(),
+        aggregation->sources()[0],
+        aggregation->distinctAggregates(),
+        true);
+  };
+
+  const std::string referenceQuery =
+      "SELECT c0, count(c1), sum(c1), max(c1) FROM tmp GROUP BY 1";
+
+  // One driver.
+  createDuckDbTable(vectors);
+  auto singlePlan = withLocalMerge(
+      PlanBuilder()
+          .values(vectors, true)
+          .singleAggregation({"c0"}, {"count(c1)", "sum(c1)", "max(c1)"})
+          .planNode());
+  AssertQueryBuilder(singlePlan, duckDbQueryRunner_)
+      .maxDrivers(1)
+      .assertResults(referenceQuery);
+
+  // Each of the 4 drivers reads all of 'vectors'.
+  constexpr int32_t kNumDrivers = 4;
+  std::vector<RowVectorPtr> allVectors;
+  for (auto i = 0; i < kNumDrivers; ++i) {
+    allVectors.insert(allVectors.end(), vectors.begin(), vectors.end());
+  }
+  createDuckDbTable(allVectors);
+
+  // Partial and final aggregation in the same pipeline.
+  auto plan = withLocalMerge(
+      PlanBuilder()
+          .values(vectors, true)
+          .partialAggregation({"c0"}, {"count(c1)", "sum(c1)", "max(c1)"})
+          .finalAggregation()
+          .planNode());
+  ASSERT_EQ(
+      "-- Aggregation[FINAL LOCAL MERGE [c0] a0 := count(ROW[\"a0\"]), a1 := sum(ROW[\"a1\"]), a2 := max(ROW[\"a2\"])] -> c0:BIGINT, a0:BIGINT, a1:BIGINT, a2:BIGINT\n",
+      plan->toString(true, false));
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .maxDrivers(kNumDrivers)
+      .assertResults(referenceQuery);
+
+  // Single aggregation.
+  AssertQueryBuilder(singlePlan, duckDbQueryRunner_)
+      .maxDrivers(kNumDrivers)
+      .assertResults(referenceQuery);
+
+  VELOX_ASSERT_THROW(
+      withLocalMerge(PlanBuilder()
+                         .values(vectors)
+                         .partialAggregation({"c0"}, {"sum(c1)"})
+                         .planNode()),
+      "Local merge is supported only in final or single aggregation");
+}
+
 TEST_F(AggregationTest, groupingSets) {
   vector_size_t size = 1'000;
   auto data = makeRowVector(
@@ -1243,5 +1649,68 @@ TEST_F(AggregationTest, groupingSets) {
       "SELECT k1, k2, count(1), sum(a), max(b) FROM tmp GROUP BY ROLLUP (k1, k2)");
 }
 
+TEST_F(AggregationTest, derivedGroupingSets) {
+  vector_size_t size = 1'000;
+  auto data = makeRowVector(
+      {"k1", "k2", "a", "b"},
+      {
+          makeFlatVector<int64_t>(
+              size, [](auto row) { return row % 11; }, nullEvery(7)),
+          makeFlatVector<int64_t>(size, [](auto row) { return row % 17; }),
+          makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+          makeFlatVector<StringView>(
+              size,
+              [](auto row) { return StringView(std::string(row % 12, 'x')); }),
+      });
+
+  createDuckDbTable({data});
+
+  auto makePlan = [&](const std::vector<std::vector<std::string>>& sets,
+                      bool partial) {
+    const std::vector<std::string> keys = {"k1", "k2", "group_id"};
+    const std::vector<std::string> aggregates = {
+        "count(1) as count_1",
+        "sum(a) as sum_a",
+        "avg(a) as avg_a",
+        "max(b) as max_b"};
+    PlanBuilder builder;
+    builder.values({data}).groupId(sets, {"a", "b"});
+    if (partial) {
+      builder.partialAggregation(keys, aggregates).finalAggregation();
+    } else {
+      builder.singleAggregation(keys, aggregates);
+    }
+    return builder.project({"k1", "k2", "count_1", "sum_a", "avg_a", "max_b"})
+        .planNode();
+  };
+
+  const std::string select =
+      "SELECT k1, k2, count(1), sum(a), avg(a), max(b) FROM tmp ";
+  const std::vector<
+      std::pair<std::vector<std::vector<std::string>>, std::string>>
+      testSettings = {
+          {{{"k1", "k2"}, {"k1"}, {}}, "GROUP BY ROLLUP (k1, k2)"},
+          {{{"k1", "k2"}, {"k1"}, {"k2"}, {}}, "GROUP BY CUBE (k1, k2)"},
+          {{{"k1"}, {"k2"}}, "GROUP BY GROUPING SETS ((k1), (k2))"},
+      };
+  for (const auto& [sets, groupBy] : testSettings) {
+    for (bool partial : {false, true}) {
+      SCOPED_TRACE(fmt::format("{} partial: {}", groupBy, partial));
+      auto task = AssertQueryBuilder(makePlan(sets, partial), duckDbQueryRunner_)
+                      .config(
+                          core::QueryConfig::kAggregationDeriveGroupingSets,
+                          "true")
+                      .assertResults(select + groupBy);
+
+      // The input is not replicated per grouping set.
+      for (const auto& pipeline : task->taskStats().pipelineStats) {
+        for (const auto& op : pipeline.operatorStats) {
+          ASSERT_NE("GroupId", op.operatorType);
+        }
+      }
+    }
+  }
+}
+
 } // namespace
 } // namespace facebook::velox::exec::test
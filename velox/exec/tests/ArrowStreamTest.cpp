@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/ArrowStream.h"
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/vector/arrow/Abi.h"
+#include "velox/vector/arrow/Bridge.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class ArrowStreamTest : public OperatorTestBase {
+ protected:
+  static std::shared_ptr<ArrowArrayStream> makeStream() {
+    return std::shared_ptr<ArrowArrayStream>(
+        new ArrowArrayStream(), [](ArrowArrayStream* stream) {
+          if (stream->release) {
+            stream->release(stream);
+          }
+          delete stream;
+        });
+  }
+
+  // Returns a stream over the results of a single-threaded Task that reads
+  // 'data'.
+  std::shared_ptr<ArrowArrayStream> makeTaskStream(
+      const std::vector<RowVectorPtr>& data,
+      const ArrowOptions& options = {}) {
+    auto plan = PlanBuilder().values(data).planNode();
+    auto task = std::make_shared<Task>(
+        "arrow.stream.task.0",
+        core::PlanFragment{plan},
+        0,
+        std::make_shared<core::QueryCtx>());
+    auto stream = makeStream();
+    exportToArrowStream(
+        plan->outputType(),
+        [task]() { return task->next(); },
+        *stream,
+        pool(),
+        options);
+    return stream;
+  }
+
+  void testRoundTrip(
+      const std::vector<RowVectorPtr>& data,
+      const ArrowOptions& options = {}) {
+    auto plan =
+        PlanBuilder()
+            .arrowStream(
+                asRowType(data[0]->type()), makeTaskStream(data, options))
+            .planNode();
+    AssertQueryBuilder(plan).assertResults(data);
+  }
+};
+
+TEST_F(ArrowStreamTest, roundTrip) {
+  std::vector<RowVectorPtr> data;
+  for (auto i = 0; i < 3; ++i) {
+    data.push_back(makeRowVector({
+        makeFlatVector<int64_t>(100, [i](auto row) { return i * 100 + row; }),
+        makeFlatVector<StringView>(
+            100,
+            [](auto row) {
+              return StringView(
+                  row % 2 ? "short" : "a string that is not inlined");
+            },
+            nullEvery(7)),
+        makeArrayVector<int32_t>(
+            100,
+            [](auto row) { return row % 3; },
+            [](auto row) { return row; }),
+    }));
+  }
+  testRoundTrip(data);
+
+  ArrowOptions options;
+  options.exportToStringView = true;
+  testRoundTrip(data, options);
+}
+
+TEST_F(ArrowStreamTest, encodings) {
+  auto indices = makeIndices(100, [](auto row) { return row % 3; });
+  auto data = makeRowVector({
+      wrapInDictionary(indices, makeFlatVector<int64_t>({1, 2, 3})),
+      makeConstant(StringView("a constant that is not inlined"), 100),
+      makeFlatVector<int32_t>(100, [](auto row) { return row; }),
+  });
+  testRoundTrip({data, data});
+}
+
+TEST_F(ArrowStreamTest, error) {
+  auto type = ROW({"c0"}, {BIGINT()});
+  auto stream = makeStream();
+  exportToArrowStream(
+      type, []() -> RowVectorPtr { VELOX_FAIL("Test error"); }, *stream);
+  auto plan = PlanBuilder().arrowStream(type, stream).planNode();
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(plan).copyResults(pool()),
+      "Failed to get the next batch of an ArrowArrayStream");
+}
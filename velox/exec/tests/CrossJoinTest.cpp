@@ -13,8 +13,10 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
@@ -258,3 +260,61 @@ TEST_F(CrossJoinTest, parallelism) {
 
   OperatorTestBase::assertQuery(params, "VALUES (30), (30), (30), (30), (30)");
 }
+
+TEST_F(CrossJoinTest, spillBuild) {
+  std::vector<RowVectorPtr> left;
+  for (auto i = 0; i < 3; ++i) {
+    left.push_back(makeRowVector({sequence<int32_t>(7, i * 7)}));
+  }
+  std::vector<RowVectorPtr> right;
+  for (auto i = 0; i < 10; ++i) {
+    right.push_back(makeRowVector(
+        {"u_c0", "u_c1"},
+        {sequence<int32_t>(100, i * 100), sequence<int32_t>(100, -i * 100)}));
+  }
+
+  createDuckDbTable("t", left);
+  createDuckDbTable("u", right);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .values(left)
+          .crossJoin(
+              PlanBuilder(planNodeIdGenerator).values(right).planNode(),
+              {"c0", "u_c0", "u_c1"})
+          .planNode();
+
+  // Keeps at most about 2 build side vectors in memory at a time. The rest
+  // is read back from disk for each probe side vector.
+  auto spillDirectory = TempDirectoryPath::create();
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .config(core::QueryConfig::kSpillEnabled, "true")
+          .config(core::QueryConfig::kJoinSpillEnabled, "true")
+          .config(core::QueryConfig::kSpillPath, spillDirectory->path)
+          .config(
+              core::QueryConfig::kCrossJoinSpillBuildBytes,
+              std::to_string(2 * right[0]->retainedSize()))
+          .assertResults("SELECT * FROM t, u");
+
+  uint64_t spilledRows = 0;
+  for (const auto& pipeline : task->taskStats().pipelineStats) {
+    for (const auto& op : pipeline.operatorStats) {
+      spilledRows += op.spilledRows;
+    }
+  }
+  ASSERT_EQ(spilledRows, 1'000);
+
+  // No spilling without the join spill flag.
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .config(core::QueryConfig::kSpillEnabled, "true")
+             .config(core::QueryConfig::kSpillPath, spillDirectory->path)
+             .config(core::QueryConfig::kCrossJoinSpillBuildBytes, "1")
+             .assertResults("SELECT * FROM t, u");
+  for (const auto& pipeline : task->taskStats().pipelineStats) {
+    for (const auto& op : pipeline.operatorStats) {
+      ASSERT_EQ(op.spilledRows, 0);
+    }
+  }
+}
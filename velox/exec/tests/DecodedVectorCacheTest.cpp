@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/DecodedVectorCache.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+class DecodedVectorCacheTest : public testing::Test,
+                               public test::VectorTestBase {};
+
+TEST_F(DecodedVectorCacheTest, hitsAndMisses) {
+  DecodedVectorCache cache;
+  VectorPtr flat = makeFlatVector<int32_t>(100, [](auto row) { return row; });
+  auto dictionary = wrapInDictionary(
+      makeIndices(100, [](auto row) { return 99 - row; }), 100, flat);
+
+  SelectivityVector allRows(100);
+  const auto& decoded = cache.decode(dictionary, allRows);
+  ASSERT_FALSE(decoded.isIdentityMapping());
+  for (auto i = 0; i < 100; ++i) {
+    ASSERT_EQ(99 - i, decoded.valueAt<int32_t>(i));
+  }
+  EXPECT_EQ(&decoded, &cache.decode(dictionary, allRows));
+
+  // A subset of the decoded rows is a hit, a superset is not.
+  SelectivityVector someRows(100, false);
+  someRows.setValidRange(10, 70, true);
+  someRows.updateBounds();
+  EXPECT_EQ(&decoded, &cache.decode(dictionary, someRows));
+
+  const auto& flatDecoded = cache.decode(flat, someRows);
+  EXPECT_NE(&decoded, &flatDecoded);
+  EXPECT_TRUE(flatDecoded.isIdentityMapping());
+  EXPECT_EQ(&flatDecoded, &cache.decode(flat, someRows));
+  EXPECT_NE(&flatDecoded, &cache.decode(flat, allRows));
+
+  EXPECT_EQ(3, cache.size());
+  EXPECT_EQ(3, cache.stats().numHits);
+  EXPECT_EQ(3, cache.stats().numMisses);
+}
+
+TEST_F(DecodedVectorCacheTest, startOperator) {
+  DecodedVectorCache cache;
+  VectorPtr source = makeFlatVector<int64_t>(10, [](auto row) { return row; });
+  VectorPtr projected = makeConstant<int64_t>(3, 10);
+  SelectivityVector rows(10);
+
+  // The operator at 1 decodes its input from the operator at 0 and passes
+  // it on. The operator at 2 gets the decoding of 1.
+  cache.startOperator(1);
+  const auto* decoded = &cache.decode(source, rows);
+  cache.startOperator(2);
+  EXPECT_EQ(decoded, &cache.decode(source, rows));
+  cache.decode(projected, rows);
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ(2, projected.use_count());
+
+  // The operator at 1 produces its next output. The decodings of 2 are
+  // dropped since 1 may reuse the vectors it produced.
+  cache.startOperator(1);
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(1, projected.use_count());
+  EXPECT_EQ(decoded, &cache.decode(source, rows));
+
+  // The source produces its next output.
+  cache.startOperator(0);
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(2, source.use_count());
+
+  // The freed decodings are reused.
+  cache.startOperator(1);
+  VectorPtr next = makeFlatVector<int64_t>(10, [](auto row) { return -row; });
+  const auto& nextDecoded = cache.decode(next, rows);
+  EXPECT_EQ(-5, nextDecoded.valueAt<int64_t>(5));
+
+  cache.clear();
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(1, next.use_count());
+}
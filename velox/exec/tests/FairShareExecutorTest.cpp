@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/FairShareExecutor.h"
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class FairShareExecutorTest : public OperatorTestBase {};
+
+TEST_F(FairShareExecutorTest, levelOf) {
+  EXPECT_EQ(0, FairShareExecutor::levelOf(0));
+  EXPECT_EQ(0, FairShareExecutor::levelOf(999'999'999));
+  EXPECT_EQ(1, FairShareExecutor::levelOf(1'000'000'000));
+  EXPECT_EQ(2, FairShareExecutor::levelOf(10'000'000'000));
+  EXPECT_EQ(3, FairShareExecutor::levelOf(60'000'000'000));
+  EXPECT_EQ(4, FairShareExecutor::levelOf(300'000'000'000));
+  EXPECT_EQ(4, FairShareExecutor::levelOf(1'000'000'000'000));
+}
+
+TEST_F(FairShareExecutorTest, newQueryFirst) {
+  constexpr int32_t kNumFuncs = 10;
+  constexpr uint64_t kLongRunNanos = 1'000'000'000'000;
+  std::vector<int32_t> order;
+  {
+    FairShareExecutor executor(1);
+    folly::Baton<> blocked;
+    folly::Baton<> release;
+    executor.add(
+        [&]() {
+          blocked.post();
+          release.wait();
+        },
+        kLongRunNanos);
+    blocked.wait();
+
+    for (auto i = 0; i < kNumFuncs; ++i) {
+      executor.add([&order, i]() { order.push_back(i); }, kLongRunNanos);
+    }
+    executor.add([&]() { order.push_back(-1); });
+    release.post();
+  }
+  // The destructor runs the queued functions. The function of the new query
+  // runs before those of the long running one.
+  ASSERT_EQ(kNumFuncs + 1, order.size());
+  EXPECT_EQ(-1, order[0]);
+  for (auto i = 0; i < kNumFuncs; ++i) {
+    EXPECT_EQ(i, order[i + 1]);
+  }
+}
+
+TEST_F(FairShareExecutorTest, share) {
+  constexpr int32_t kNumFuncs = 20;
+  constexpr uint64_t kLongRunNanos = 1'000'000'000'000;
+  FairShareExecutor executor(1);
+  folly::Baton<> blocked;
+  folly::Baton<> release;
+  executor.add([&]() {
+    blocked.post();
+    release.wait();
+  });
+  blocked.wait();
+
+  // Each function requeues itself at its level until it has run kNumFuncs
+  // times. Level 0 gets 16 times the share of level 4 and so finishes first.
+  std::atomic<int32_t> numRun[2] = {0, 0};
+  std::atomic<int32_t> firstDone{-1};
+  folly::Baton<> done;
+  std::function<void(int32_t)> addFunc = [&](int32_t query) {
+    executor.add(
+        [&, query]() {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          if (++numRun[query] < kNumFuncs) {
+            addFunc(query);
+            return;
+          }
+          int32_t none = -1;
+          if (!firstDone.compare_exchange_strong(none, query)) {
+            done.post();
+          }
+        },
+        query == 0 ? 0 : kLongRunNanos);
+  };
+  addFunc(1);
+  addFunc(0);
+  release.post();
+  done.wait();
+  EXPECT_EQ(0, firstDone);
+  EXPECT_LT(0, executor.levelRunNanos(0));
+  EXPECT_LT(0, executor.levelRunNanos(FairShareExecutor::kNumLevels - 1));
+}
+
+TEST_F(FairShareExecutorTest, timeSlice) {
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 100; ++i) {
+    batches.push_back(makeRowVector({makeFlatVector<int64_t>(
+        10'000, [i](auto row) { return i * 10'000 + row; })}));
+  }
+  createDuckDbTable(batches);
+
+  constexpr int32_t kNumDrivers = 2;
+  auto plan = PlanBuilder()
+                  .values(batches, true)
+                  .filter("c0 % 3 = 0")
+                  .project({"c0 + 1"})
+                  .planNode();
+  std::string sql = "SELECT c0 + 1 FROM tmp WHERE c0 % 3 = 0";
+  for (auto i = 1; i < kNumDrivers; ++i) {
+    sql += " UNION ALL SELECT c0 + 1 FROM tmp WHERE c0 % 3 = 0";
+  }
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      std::make_shared<FairShareExecutor>(kNumDrivers),
+      std::make_shared<core::MemConfig>(
+          std::unordered_map<std::string, std::string>{
+              {core::QueryConfig::kDriverTimeSliceMs, "1"}}));
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .queryCtx(queryCtx)
+                  .maxDrivers(kNumDrivers)
+                  .assertResults(sql);
+
+  // Each Driver runs well over 1ms and so yields and resumes.
+  int64_t numYields = 0;
+  for (const auto& pipeline : task->taskStats().pipelineStats) {
+    for (const auto& op : pipeline.operatorStats) {
+      auto it = op.runtimeStats.find("timeSliceYields");
+      if (it != op.runtimeStats.end()) {
+        numYields += it->second.sum;
+      }
+    }
+  }
+  EXPECT_LT(0, numYields);
+  EXPECT_LT(0, queryCtx->driverRunNanos());
+}
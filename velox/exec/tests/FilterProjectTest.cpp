@@ -15,6 +15,7 @@
  */
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -333,3 +334,38 @@ TEST_F(FilterProjectTest, projectAndIdentityOverLazy) {
                   .planNode();
   assertQuery(plan, "SELECT c0 < 10 AND c1 < 10, c1 FROM tmp");
 }
+
+TEST_F(FilterProjectTest, exprStats) {
+  vector_size_t size = 1'000;
+  auto vectors = makeRowVector({
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row; }, nullEvery(5)),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 7; }),
+  });
+  createDuckDbTable({vectors});
+
+  core::PlanNodeId projectNodeId;
+  auto plan = PlanBuilder()
+                  .values({vectors})
+                  .project({"c0 + c1"})
+                  .capturePlanNodeId(projectNodeId)
+                  .planNode();
+
+  // The stats of the expressions are reported only if tracked.
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .assertResults("SELECT c0 + c1 FROM tmp");
+  auto runtimeStats =
+      toPlanStats(task->taskStats()).at(projectNodeId).customStats;
+  ASSERT_EQ(0, runtimeStats.count("expr.plus.numProcessedRows"));
+
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .config(core::QueryConfig::kExprTrackCpuUsage, "true")
+             .assertResults("SELECT c0 + c1 FROM tmp");
+  runtimeStats = toPlanStats(task->taskStats()).at(projectNodeId).customStats;
+  // The rows with null 'c0' are not processed.
+  ASSERT_EQ(800, runtimeStats.at("expr.plus.numProcessedRows").sum);
+  ASSERT_EQ(1, runtimeStats.at("expr.plus.numProcessedVectors").sum);
+  ASSERT_EQ(1, runtimeStats.at("expr.plus.numDefaultNullVectors").sum);
+  ASSERT_EQ(0, runtimeStats.at("expr.plus.numPeeledVectors").sum);
+  ASSERT_EQ(1, runtimeStats.count("expr.plus.cpuNanos"));
+}
@@ -484,6 +484,31 @@ TEST_P(HashJoinBridgeTest, multiThreading) {
   }
 }
 
+TEST_P(HashJoinBridgeTest, probeClosed) {
+  auto joinBridge = createJoinBridge();
+  for (int32_t i = 0; i < numBuilders_; ++i) {
+    joinBridge->addBuilder();
+  }
+  for (int32_t i = 0; i < numProbers_; ++i) {
+    joinBridge->addProber();
+  }
+  joinBridge->start();
+  joinBridge->setHashTable(createFakeHashTable(), {});
+
+  ContinueFuture future;
+  std::weak_ptr<BaseHashTable> table =
+      joinBridge->tableOrFuture(&future).value().table;
+  ASSERT_FALSE(table.expired());
+
+  // The table is freed when the last prober closes.
+  for (int32_t i = 0; i < numProbers_; ++i) {
+    ASSERT_FALSE(table.expired());
+    joinBridge->probeClosed();
+  }
+  ASSERT_TRUE(table.expired());
+  ASSERT_ANY_THROW(joinBridge->probeClosed());
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     HashJoinBridgeTest,
     HashJoinBridgeTest,
@@ -16,6 +16,7 @@
 
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
+#include "velox/exec/HashTableCache.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
@@ -508,7 +509,9 @@ class HashJoinBuilder {
       config(core::QueryConfig::kSpillPath, spillDirectory->path);
     }
     if (!configs_.empty()) {
-      queryCtx->setConfigOverridesUnsafe(std::move(configs_));
+      // NOTE: copy the configs as the test might run more than once.
+      auto configs = configs_;
+      queryCtx->setConfigOverridesUnsafe(std::move(configs));
     }
     if (tracker_ != nullptr) {
       queryCtx->pool()->setMemoryUsageTracker(tracker_);
@@ -681,6 +684,37 @@ TEST_P(MultiThreadedHashJoinTest, bigintArray) {
       .run();
 }
 
+TEST_P(MultiThreadedHashJoinTest, maxSpillLevel) {
+  for (int32_t maxSpillLevel : {0, 2}) {
+    SCOPED_TRACE(fmt::format("maxSpillLevel: {}", maxSpillLevel));
+    HashJoinBuilder(*pool_, duckDbQueryRunner_)
+        .numDrivers(numDrivers_)
+        .keyTypes({BIGINT()})
+        .probeVectors(1600, 5)
+        .buildVectors(1500, 5)
+        .injectSpill(true)
+        .config(
+            core::QueryConfig::kMaxSpillLevel, std::to_string(maxSpillLevel))
+        .referenceQuery(
+            "SELECT t_k0, t_data, u_k0, u_data FROM t, u WHERE t.t_k0 = u.u_k0")
+        .verifier([&](const std::shared_ptr<Task>& task) {
+          if (maxSpillLevel != 0 || taskSpilledStats(*task).spilledRows == 0) {
+            return;
+          }
+          // The restored partitions are built in memory.
+          int64_t numExceeded = 0;
+          for (const auto& [nodeId, stats] : toPlanStats(task->taskStats())) {
+            auto it = stats.customStats.find("exceededMaxSpillLevel");
+            if (it != stats.customStats.end()) {
+              numExceeded += it->second.sum;
+            }
+          }
+          ASSERT_GT(numExceeded, 0);
+        })
+        .run();
+  }
+}
+
 TEST_P(MultiThreadedHashJoinTest, outOfJoinKeyColumnOrder) {
   HashJoinBuilder(*pool_, duckDbQueryRunner_)
       .numDrivers(numDrivers_)
@@ -2894,6 +2928,320 @@ TEST_F(HashJoinTest, dynamicFilters) {
   }
 }
 
+TEST_F(HashJoinTest, bloomFilterDynamicFilter) {
+  const int32_t numSplits = 10;
+  const int32_t numRowsProbe = 10'000;
+  // More distinct keys than VectorHasher keeps track of, so there is no exact
+  // IN-list filter to push down.
+  const int32_t numRowsBuild = 2 * VectorHasher::kMaxDistinct;
+
+  std::vector<RowVectorPtr> probeVectors;
+  probeVectors.reserve(numSplits);
+  auto probeFiles = makeFilePaths(numSplits);
+  for (int i = 0; i < numSplits; i++) {
+    auto rowVector = makeRowVector({
+        makeFlatVector<int32_t>(
+            numRowsProbe, [&](auto row) { return (row + i * numRowsProbe); }),
+        makeFlatVector<int64_t>(numRowsProbe, [](auto row) { return row; }),
+    });
+    probeVectors.push_back(rowVector);
+    writeToFile(probeFiles[i]->path, rowVector);
+  }
+
+  // Only even keys are on the build side.
+  std::vector<RowVectorPtr> buildVectors = {makeRowVector(
+      {"u_c0"},
+      {makeFlatVector<int32_t>(
+          numRowsBuild, [](auto row) { return row * 2; })})};
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto probeType = ROW({"c0", "c1"}, {INTEGER(), BIGINT()});
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto buildSide =
+      PlanBuilder(planNodeIdGenerator).values(buildVectors).planNode();
+
+  core::PlanNodeId probeScanId;
+  auto op = PlanBuilder(planNodeIdGenerator)
+                .tableScan(probeType)
+                .capturePlanNodeId(probeScanId)
+                .hashJoin(
+                    {"c0"},
+                    {"u_c0"},
+                    buildSide,
+                    "",
+                    {"c0", "c1"},
+                    core::JoinType::kInner)
+                .project({"c0", "c1 + 1"})
+                .planNode();
+
+  // Disabled by default.
+  HashJoinBuilder(*pool_, duckDbQueryRunner_)
+      .planNode(core::PlanNodePtr(op))
+      .inputSplits(makeSpiltInput({probeScanId}, {probeFiles}))
+      .referenceQuery("SELECT t.c0, t.c1 + 1 FROM t, u WHERE t.c0 = u.c0")
+      .verifier([&](const std::shared_ptr<Task>& task) {
+        ASSERT_EQ(0, getFiltersProduced(task, 1).sum);
+        ASSERT_EQ(numRowsProbe * numSplits, getInputPositions(task, 1));
+      })
+      .run();
+
+  HashJoinBuilder(*pool_, duckDbQueryRunner_)
+      .planNode(std::move(op))
+      .inputSplits(makeSpiltInput({probeScanId}, {probeFiles}))
+      .config(core::QueryConfig::kHashJoinBloomFilterEnabled, "true")
+      .referenceQuery("SELECT t.c0, t.c1 + 1 FROM t, u WHERE t.c0 = u.c0")
+      .verifier([&](const std::shared_ptr<Task>& task) {
+        ASSERT_EQ(1, getFiltersProduced(task, 1).sum);
+        ASSERT_EQ(1, getFiltersAccepted(task, 0).sum);
+        // The Bloom filter may have false positives, hence, the join must
+        // not be replaced with the filter.
+        ASSERT_EQ(0, getReplacedWithFilterRows(task, 1).sum);
+        // Most of the odd keys are filtered out in the scan.
+        ASSERT_LT(getInputPositions(task, 1), numRowsProbe * numSplits * 0.6);
+      })
+      .run();
+}
+
+TEST_F(HashJoinTest, hashTableCache) {
+  std::vector<RowVectorPtr> probeVectors = {makeRowVector({
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row % 100; }),
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+  })};
+  std::vector<RowVectorPtr> evenBuildVectors = {makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatVector<int32_t>(50, [](auto row) { return row * 2; }),
+       makeFlatVector<int64_t>(50, [](auto row) { return row; })})};
+  std::vector<RowVectorPtr> oddBuildVectors = {makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatVector<int32_t>(50, [](auto row) { return row * 2 + 1; }),
+       makeFlatVector<int64_t>(50, [](auto row) { return row; })})};
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", evenBuildVectors);
+
+  // Makes the same plan node ids for each of the build sides.
+  auto makePlan = [&](const std::vector<RowVectorPtr>& buildVectors) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(probeVectors)
+                    .hashJoin(
+                        {"c0"},
+                        {"u_c0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(buildVectors)
+                            .planNode(),
+                        "",
+                        {"c0", "c1", "u_c1"})
+                    .planNode();
+    auto join = std::dynamic_pointer_cast<const core::HashJoinNode>(plan);
+    return std::make_shared<core::HashJoinNode>(
+        join->id(),
+        join->joinType(),
+        join->leftKeys(),
+        join->rightKeys(),
+        join->filter(),
+        join->sources()[0],
+        join->sources()[1],
+        join->outputType(),
+        true);
+  };
+
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      std::make_shared<folly::CPUThreadPoolExecutor>(4),
+      std::make_shared<core::MemConfig>(),
+      std::unordered_map<std::string, std::shared_ptr<Config>>{},
+      memory::MappedMemory::getInstance(),
+      nullptr,
+      nullptr,
+      "hashTableCache");
+  const std::string referenceQuery =
+      "SELECT t.c0, t.c1, u.c1 FROM t, u WHERE t.c0 = u.c0";
+
+  // The first task builds the table.
+  AssertQueryBuilder(makePlan(evenBuildVectors), duckDbQueryRunner_)
+      .queryCtx(queryCtx)
+      .maxDrivers(2)
+      .assertResults(referenceQuery);
+  ASSERT_EQ(1, HashTableCache::instance()->numEntries());
+
+  // The second task of the query probes the same table and ignores its own
+  // build side input.
+  AssertQueryBuilder(makePlan(oddBuildVectors), duckDbQueryRunner_)
+      .queryCtx(queryCtx)
+      .maxDrivers(2)
+      .assertResults(referenceQuery);
+  ASSERT_EQ(1, HashTableCache::instance()->numEntries());
+
+  // Right and full joins set probed flags in the table.
+  auto join = makePlan(evenBuildVectors);
+  VELOX_ASSERT_THROW(
+      std::make_shared<core::HashJoinNode>(
+          join->id(),
+          core::JoinType::kRight,
+          join->leftKeys(),
+          join->rightKeys(),
+          nullptr,
+          join->sources()[0],
+          join->sources()[1],
+          join->outputType(),
+          true),
+      "Hash table cache is not supported for RIGHT join");
+}
+
+TEST_F(HashJoinTest, hashTableCacheAcrossQueries) {
+  std::vector<RowVectorPtr> probeVectors = {makeRowVector({
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row % 100; }),
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+  })};
+  std::vector<RowVectorPtr> evenBuildVectors = {makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatVector<int32_t>(50, [](auto row) { return row * 2; }),
+       makeFlatVector<int64_t>(50, [](auto row) { return row; })})};
+  std::vector<RowVectorPtr> oddBuildVectors = {makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatVector<int32_t>(50, [](auto row) { return row * 2 + 1; }),
+       makeFlatVector<int64_t>(50, [](auto row) { return row; })})};
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", evenBuildVectors);
+
+  auto makePlan = [&](const std::vector<RowVectorPtr>& buildVectors,
+                      const std::string& cacheKey) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(probeVectors)
+                    .hashJoin(
+                        {"c0"},
+                        {"u_c0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(buildVectors)
+                            .planNode(),
+                        "",
+                        {"c0", "c1", "u_c1"})
+                    .planNode();
+    auto join = std::dynamic_pointer_cast<const core::HashJoinNode>(plan);
+    return std::make_shared<core::HashJoinNode>(
+        join->id(),
+        join->joinType(),
+        join->leftKeys(),
+        join->rightKeys(),
+        join->filter(),
+        join->sources()[0],
+        join->sources()[1],
+        join->outputType(),
+        true,
+        cacheKey);
+  };
+
+  auto* cache = HashTableCache::instance();
+  cache->clearShared();
+  const std::string referenceQuery =
+      "SELECT t.c0, t.c1, u.c1 FROM t, u WHERE t.c0 = u.c0";
+
+  // The first query builds the table and leaves it in the cache.
+  AssertQueryBuilder(makePlan(evenBuildVectors, "u.even"), duckDbQueryRunner_)
+      .maxDrivers(2)
+      .assertResults(referenceQuery);
+  ASSERT_EQ(1, cache->numSharedEntries());
+  ASSERT_GT(cache->sharedBytes(), 0);
+
+  // A later query with the same key probes the cached table and ignores its
+  // own build side input.
+  AssertQueryBuilder(makePlan(oddBuildVectors, "u.even"), duckDbQueryRunner_)
+      .maxDrivers(2)
+      .assertResults(referenceQuery);
+  ASSERT_EQ(1, cache->numSharedEntries());
+
+  // A different key builds another table. The least recently used one is
+  // evicted once the tables do not fit.
+  createDuckDbTable("u", oddBuildVectors);
+  cache->setMaxBytes(cache->sharedBytes() * 3 / 2);
+  AssertQueryBuilder(makePlan(oddBuildVectors, "u.odd"), duckDbQueryRunner_)
+      .maxDrivers(2)
+      .assertResults(referenceQuery);
+  ASSERT_EQ(1, cache->numSharedEntries());
+
+  cache->setMaxBytes(HashTableCache::kDefaultMaxBytes);
+  cache->clearShared();
+  ASSERT_EQ(0, cache->sharedBytes());
+
+  auto join = makePlan(evenBuildVectors, "");
+  VELOX_ASSERT_THROW(
+      std::make_shared<core::HashJoinNode>(
+          join->id(),
+          join->joinType(),
+          join->leftKeys(),
+          join->rightKeys(),
+          nullptr,
+          join->sources()[0],
+          join->sources()[1],
+          join->outputType(),
+          false,
+          "u.even"),
+      "Hash table cache key requires the hash table cache");
+}
+
+TEST_F(HashJoinTest, skewedKeys) {
+  // Half of the probe rows and most of the build rows have key 0.
+  std::vector<RowVectorPtr> probeVectors = {makeRowVector({
+      makeFlatVector<int32_t>(
+          100, [](auto row) { return row % 2 == 0 ? 0 : row; }),
+      makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+  })};
+  std::vector<RowVectorPtr> buildVectors = {makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatVector<int32_t>(
+           100, [](auto row) { return row < 50 ? 0 : row; }),
+       makeFlatVector<int64_t>(100, [](auto row) { return row; })})};
+
+  // Each driver reads a copy of the values.
+  const int32_t numDrivers = 4;
+  std::vector<RowVectorPtr> allProbeVectors(numDrivers, probeVectors[0]);
+  std::vector<RowVectorPtr> allBuildVectors(numDrivers, buildVectors[0]);
+  createDuckDbTable("t", allProbeVectors);
+  createDuckDbTable("u", allBuildVectors);
+
+  for (auto joinType : {core::JoinType::kInner, core::JoinType::kLeft}) {
+    SCOPED_TRACE(core::joinTypeName(joinType));
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    core::PlanNodeId joinNodeId;
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(probeVectors, true)
+                    .hashJoin(
+                        {"c0"},
+                        {"u_c0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(buildVectors, true)
+                            .planNode(),
+                        "",
+                        {"c0", "c1", "u_c1"},
+                        joinType)
+                    .capturePlanNodeId(joinNodeId)
+                    .planNode();
+    const auto referenceQuery = fmt::format(
+        "SELECT t.c0, t.c1, u.c1 FROM t {} JOIN u ON t.c0 = u.c0",
+        joinType == core::JoinType::kInner ? "INNER" : "LEFT");
+
+    // Disabled by default.
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .maxDrivers(numDrivers)
+                    .assertResults(referenceQuery);
+    auto planStats = toPlanStats(task->taskStats());
+    ASSERT_EQ(0, planStats.at(joinNodeId).customStats.count("skewedProbeRows"));
+
+    task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+               .maxDrivers(numDrivers)
+               .config(core::QueryConfig::kHashJoinSkewedKeyMinPct, "20")
+               .assertResults(referenceQuery);
+    planStats = toPlanStats(task->taskStats());
+    const auto& skewedProbeRows =
+        planStats.at(joinNodeId).customStats.at("skewedProbeRows");
+    ASSERT_GT(skewedProbeRows.sum, 0);
+  }
+}
+
 // Verify the size of the join output vectors when projecting build-side
 // variable-width column.
 TEST_F(HashJoinTest, memoryUsage) {
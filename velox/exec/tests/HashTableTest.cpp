@@ -95,6 +95,13 @@ class HashTableTest : public testing::TestWithParam<bool> {
     EXPECT_EQ(topTable_->hashMode(), mode);
     LOG(INFO) << "Made table " << describeTable();
     testProbe();
+    // Probes again with probe rows reordered by bucket partition.
+    topTable_->setPartitionedProbeMinSize(1);
+    testProbe();
+    topTable_->setPartitionedProbeMinSize(0);
+    // Probes with bucket prefetching for the remaining probes.
+    topTable_->setProbePrefetchBatchSize(16);
+    testProbe();
     testEraseEveryN(3);
     testProbe();
     testEraseEveryN(4);
@@ -110,6 +117,7 @@ class HashTableTest : public testing::TestWithParam<bool> {
     int32_t sequence = 0;
     std::vector<RowVectorPtr> batches;
     auto table = createHashTableForAggregation(tableType, numKeys);
+    table->setProbePrefetchBatchSize(16);
     auto lookup = std::make_unique<HashLookup>(table->hashers());
     std::vector<char*> allInserted;
     int32_t numErased = 0;
@@ -307,6 +315,12 @@ class HashTableTest : public testing::TestWithParam<bool> {
             [&](vector_size_t row) { return keySpacing_ * (sequence + row); },
             nullptr);
 
+      case TypeKind::INTEGER:
+        return vectorMaker_->flatVector<int32_t>(
+            size,
+            [&](vector_size_t row) { return keySpacing_ * (sequence + row); },
+            nullptr);
+
       case TypeKind::VARCHAR: {
         auto strings = std::static_pointer_cast<FlatVector<StringView>>(
             BaseVector::create(VARCHAR(), size, pool_.get()));
@@ -408,6 +422,13 @@ class HashTableTest : public testing::TestWithParam<bool> {
           numHit += lookup->hits[key] != nullptr;
           ASSERT_EQ(rowOfKey_[startOffset + key], lookup->hits[key]);
         }
+        std::vector<uint64_t> matches(bits::nwords(batch->size()), 0);
+        topTable_->joinProbeExists(*lookup, matches.data());
+        for (auto key : lookup->rows) {
+          ASSERT_EQ(
+              rowOfKey_[startOffset + key] != nullptr,
+              bits::isBitSet(matches.data(), key));
+        }
       }
     }
     LOG(INFO)
@@ -507,6 +528,15 @@ TEST_P(HashTableTest, mixed6Sparse) {
   testCycle(BaseHashTable::HashMode::kHash, 100000, 9, type, 6);
 }
 
+// Composite integer keys with too large ranges for a normalized key are
+// compared as packed bytes.
+TEST_P(HashTableTest, int4SparseHash) {
+  auto type =
+      ROW({"k1", "k2", "k3", "k4"}, {BIGINT(), INTEGER(), BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  testCycle(BaseHashTable::HashMode::kHash, 100000, 9, type, 4);
+}
+
 // It should be safe to call clear() before we insert any data into HashTable
 TEST_P(HashTableTest, clear) {
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
@@ -585,6 +615,41 @@ TEST_P(HashTableTest, arrayProbeNormalizedKey) {
   }
 
   ASSERT_TRUE(table->hashMode() == BaseHashTable::HashMode::kNormalizedKey);
+  // The reserve grows after the first switch. With a fixed reserve this
+  // takes 9 switches.
+  ASSERT_LT(0, table->hashModeStats().numSwitches);
+  ASSERT_GE(8, table->hashModeStats().numSwitches);
+}
+
+TEST_P(HashTableTest, sparseGroupByArray) {
+  auto table = createHashTableForAggregation(ROW({"a"}, {BIGINT()}), 1);
+  auto lookup = std::make_unique<HashLookup>(table->hashers());
+  // Keys 100 apart.
+  auto makeKeys = [&](int32_t begin, int32_t end) {
+    return vectorMaker_->rowVector({vectorMaker_->flatVector<int64_t>(
+        end - begin, [&](auto row) { return (begin + row) * 100; })});
+  };
+
+  // The first batch decides the hash mode with no rows seen before.
+  insertGroups(*makeKeys(0, 2'500), *lookup, *table);
+  ASSERT_EQ(BaseHashTable::HashMode::kArray, table->hashMode());
+  ASSERT_EQ(0, table->hashModeStats().numSwitches);
+
+  ASSERT_TRUE(table->hashers()[0]->isRange());
+
+  // Keys past the range need a 9MB array by range for 5K groups. The array
+  // is indexed by distinct value ids instead.
+  insertGroups(*makeKeys(2'500, 5'000), *lookup, *table);
+  ASSERT_EQ(BaseHashTable::HashMode::kArray, table->hashMode());
+  ASSERT_FALSE(table->hashers()[0]->isRange());
+  ASSERT_EQ(1, table->hashModeStats().numSwitches);
+  ASSERT_EQ(5'000, table->numDistinct());
+
+  insertGroups(*makeKeys(5'000, 8'000), *lookup, *table);
+  ASSERT_EQ(BaseHashTable::HashMode::kArray, table->hashMode());
+  ASSERT_FALSE(table->hashers()[0]->isRange());
+  ASSERT_EQ(2, table->hashModeStats().numSwitches);
+  ASSERT_EQ(8'000, table->numDistinct());
 }
 
 VELOX_INSTANTIATE_TEST_SUITE_P(
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/LocalPartition.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -509,3 +510,118 @@ TEST_F(LocalPartitionTest, unionAllLocalExchange) {
       "   SELECT * FROM (VALUES ('y')) as t2(c0)"
       ")");
 }
+
+TEST_F(LocalPartitionTest, adaptiveDrivers) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 20; i++) {
+    vectors.emplace_back(makeRowVector({makeFlatSequence<int32_t>(
+        i * 100, 1'000, 1'000)}));
+  }
+  auto filePaths = writeToFiles(vectors);
+  auto rowType = getRowType(vectors[0]);
+  createDuckDbTable(vectors);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId scanNodeId;
+  auto scanAggNode = PlanBuilder(planNodeIdGenerator)
+                         .tableScan(rowType)
+                         .capturePlanNodeId(scanNodeId)
+                         .partialAggregation({"c0"}, {"count(1)"})
+                         .planNode();
+  auto op = PlanBuilder(planNodeIdGenerator)
+                .localPartition({"c0"}, {scanAggNode})
+                .finalAggregation()
+                .planNode();
+
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+  for (const auto& filePath : filePaths) {
+    splits.push_back(makeHiveConnectorSplit(filePath->path));
+  }
+
+  // The partial aggregation holds its output until the end, so the local
+  // exchange stays drained and the scan starting with one Driver grows.
+  auto task =
+      AssertQueryBuilder(op, duckDbQueryRunner_)
+          .maxDrivers(1)
+          .config(core::QueryConfig::kAdaptiveMaxDriversPerPipeline, "4")
+          .config(core::QueryConfig::kAdaptiveDriversIntervalMs, "0")
+          .splits(scanNodeId, splits)
+          .assertResults("SELECT c0, count(1) FROM tmp GROUP BY 1");
+  EXPECT_LT(0, task->taskStats().numAddedDrivers);
+  EXPECT_GE(3, task->taskStats().numAddedDrivers);
+
+  // A full local exchange retires scan Drivers. Only the result is
+  // deterministic.
+  auto scanNode = PlanBuilder(planNodeIdGenerator)
+                      .tableScan(rowType)
+                      .capturePlanNodeId(scanNodeId)
+                      .planNode();
+  op = PlanBuilder(planNodeIdGenerator)
+           .localPartition({}, {scanNode})
+           .singleAggregation({"c0"}, {"count(1)"})
+           .planNode();
+  splits.clear();
+  for (const auto& filePath : filePaths) {
+    splits.push_back(makeHiveConnectorSplit(filePath->path));
+  }
+  AssertQueryBuilder(op, duckDbQueryRunner_)
+      .maxDrivers(4)
+      .config(core::QueryConfig::kAdaptiveMaxDriversPerPipeline, "4")
+      .config(core::QueryConfig::kAdaptiveDriversIntervalMs, "0")
+      .config(core::QueryConfig::kMaxLocalExchangeBufferSize, "1")
+      .splits(scanNodeId, splits)
+      .assertResults("SELECT c0, count(1) FROM tmp GROUP BY 1");
+}
+
+TEST_F(LocalPartitionTest, concurrentQueue) {
+  constexpr int32_t kNumProducers = 8;
+  constexpr int32_t kNumConsumers = 4;
+  constexpr int32_t kNumVectors = 1'000;
+  auto data = makeRowVector({makeFlatSequence<int32_t>(0, 10)});
+  // A small buffer makes the producers block on the consumers.
+  auto memoryManager = std::make_shared<exec::LocalExchangeMemoryManager>(
+      10 * data->retainedSize());
+  auto queue = std::make_shared<exec::LocalExchangeQueue>(memoryManager, 0);
+  for (auto i = 0; i < kNumProducers; ++i) {
+    queue->addProducer();
+  }
+  queue->noMoreProducers();
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < kNumProducers; ++i) {
+    threads.emplace_back([&]() {
+      for (auto j = 0; j < kNumVectors; ++j) {
+        ContinueFuture future;
+        if (queue->enqueue(data, &future) !=
+            exec::BlockingReason::kNotBlocked) {
+          future.wait();
+        }
+      }
+      queue->noMoreData();
+    });
+  }
+  std::atomic<int32_t> numFetched{0};
+  for (auto i = 0; i < kNumConsumers; ++i) {
+    threads.emplace_back([&]() {
+      for (;;) {
+        ContinueFuture future;
+        RowVectorPtr fetched;
+        if (queue->next(&future, pool(), &fetched) !=
+            exec::BlockingReason::kNotBlocked) {
+          future.wait();
+          continue;
+        }
+        if (fetched == nullptr) {
+          break;
+        }
+        ++numFetched;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(kNumProducers * kNumVectors, numFetched);
+  EXPECT_TRUE(queue->isFinished());
+  EXPECT_EQ(0, memoryManager->bufferedBytes());
+}
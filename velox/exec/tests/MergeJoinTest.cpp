@@ -17,6 +17,7 @@
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
@@ -445,6 +446,73 @@ TEST_F(MergeJoinTest, numDrivers) {
   EXPECT_EQ(2, task->numFinishedDrivers());
 }
 
+// Verify that a long run of right-side rows with the same key is spilled and
+// joined back in batches.
+TEST_F(MergeJoinTest, spillLargeMatch) {
+  std::vector<RowVectorPtr> left = {makeRowVector(
+      {"t_c0", "t_c1"},
+      {makeFlatVector<int32_t>({1, 5, 5, 5, 7}),
+       makeFlatVector<int32_t>({0, 1, 2, 3, 4})})};
+
+  std::vector<RowVectorPtr> right;
+  for (auto i = 0; i < 10; ++i) {
+    right.push_back(makeRowVector(
+        {"u_c0", "u_c1"},
+        {makeFlatVector<int32_t>(100, [&](auto row) {
+           return i == 9 && row >= 50 ? 7 : 5;
+         }),
+         makeFlatVector<int32_t>(
+             100, [&](auto row) { return i * 100 + row; })}));
+  }
+
+  createDuckDbTable("t", left);
+  createDuckDbTable("u", right);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .values(left)
+          .mergeJoin(
+              {"t_c0"},
+              {"u_c0"},
+              PlanBuilder(planNodeIdGenerator).values(right).planNode(),
+              "",
+              {"t_c0", "t_c1", "u_c0", "u_c1"},
+              core::JoinType::kInner)
+          .planNode();
+
+  auto spillDirectory = TempDirectoryPath::create();
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .config(core::QueryConfig::kSpillEnabled, "true")
+          .config(core::QueryConfig::kJoinSpillEnabled, "true")
+          .config(core::QueryConfig::kSpillPath, spillDirectory->path)
+          .config(core::QueryConfig::kMergeJoinSpillMatchRows, "200")
+          .assertResults(
+              "SELECT t_c0, t_c1, u_c0, u_c1 FROM t, u WHERE t_c0 = u_c0");
+
+  uint64_t spilledRows = 0;
+  for (const auto& pipeline : task->taskStats().pipelineStats) {
+    for (const auto& op : pipeline.operatorStats) {
+      spilledRows += op.spilledRows;
+    }
+  }
+  ASSERT_GT(spilledRows, 0);
+
+  // No spilling without the join spill flag.
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .config(core::QueryConfig::kSpillEnabled, "true")
+             .config(core::QueryConfig::kSpillPath, spillDirectory->path)
+             .config(core::QueryConfig::kMergeJoinSpillMatchRows, "200")
+             .assertResults(
+                 "SELECT t_c0, t_c1, u_c0, u_c1 FROM t, u WHERE t_c0 = u_c0");
+  for (const auto& pipeline : task->taskStats().pipelineStats) {
+    for (const auto& op : pipeline.operatorStats) {
+      ASSERT_EQ(op.spilledRows, 0);
+    }
+  }
+}
+
 TEST_F(MergeJoinTest, lazyVectors) {
   // a dataset of multiple row groups with multiple columns. We create
   // different dictionary wrappings for different columns and load the
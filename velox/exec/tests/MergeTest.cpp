@@ -181,3 +181,61 @@ TEST_F(MergeTest, offByOne) {
       {{core::QueryConfig::kPreferredOutputBatchSize, "6"}});
   assertQueryOrdered(params, "VALUES (0), (1), (2), (3), (4), (5), (10)", {0});
 }
+
+/// Verifies merging sources whose rows come in runs that are copied out as
+/// ranges, across source and output batch boundaries.
+TEST_F(MergeTest, runs) {
+  constexpr int32_t kNumSources = 3;
+  constexpr int32_t kRunSize = 50;
+  constexpr int32_t kBatchSize = 230;
+  std::vector<std::vector<RowVectorPtr>> sourceVectors(kNumSources);
+  std::vector<RowVectorPtr> allVectors;
+  for (auto i = 0; i < kNumSources; ++i) {
+    // Source 'i' has every 'kNumSources'th run of 'kRunSize' consecutive
+    // values. The last value of a run is also the first of the next run in
+    // the next source.
+    std::vector<int64_t> values;
+    for (auto run = i; run < 60; run += kNumSources) {
+      for (auto j = 0; j <= kRunSize; ++j) {
+        values.push_back(run * kRunSize + j);
+      }
+    }
+    for (auto first = 0; first < values.size(); first += kBatchSize) {
+      const auto size =
+          std::min<vector_size_t>(kBatchSize, values.size() - first);
+      auto vector = makeRowVector({
+          makeFlatVector<int64_t>(
+              size, [&](auto row) { return values[first + row]; }),
+          makeFlatVector<StringView>(
+              size,
+              [&](auto row) {
+                return StringView(
+                    std::string(20, 'a' + values[first + row] % 26));
+              }),
+      });
+      sourceVectors[i].push_back(vector);
+      allVectors.push_back(vector);
+    }
+  }
+  createDuckDbTable(allVectors);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  std::vector<core::PlanNodePtr> sources;
+  for (const auto& vectors : sourceVectors) {
+    sources.push_back(
+        PlanBuilder(planNodeIdGenerator).values(vectors).planNode());
+  }
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .localMerge({"c0"}, std::move(sources))
+                  .planNode();
+
+  for (const auto* outputBatchSize : {"1", "7", "100", "10000"}) {
+    SCOPED_TRACE(outputBatchSize);
+    CursorParameters params;
+    params.planNode = plan;
+    params.queryCtx = core::QueryCtx::createForTest();
+    params.queryCtx->setConfigOverridesUnsafe(
+        {{core::QueryConfig::kPreferredOutputBatchSize, outputBatchSize}});
+    assertQueryOrdered(params, "SELECT * FROM tmp ORDER BY c0", {0});
+  }
+}
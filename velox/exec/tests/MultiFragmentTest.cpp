@@ -18,9 +18,13 @@
 #include "velox/dwio/common/DataSink.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/Exchange.h"
+#include "velox/exec/HashPartitionFunction.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/SortShuffleExchangeSource.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
@@ -235,6 +239,64 @@ TEST_F(MultiFragmentTest, distributedTableScan) {
   }
 }
 
+TEST_F(MultiFragmentTest, wideExchange) {
+  // A small buffer makes the credits of the sources smaller than a page, so
+  // that each request returns a single page.
+  configSettings_[core::QueryConfig::kMaxPartitionedOutputBufferSize] = "4096";
+  setupSources(20, 1000);
+  std::vector<std::shared_ptr<Task>> tasks;
+  std::vector<std::string> leafTaskIds;
+  core::PlanNodePtr leafPlan;
+  for (auto i = 0; i < filePaths_.size(); ++i) {
+    leafPlan = PlanBuilder()
+                   .tableScan(rowType_)
+                   .project({"c0", "c1"})
+                   .partitionedOutput({}, 1)
+                   .planNode();
+    leafTaskIds.push_back(makeTaskId("leaf", i));
+    auto leafTask = makeTask(leafTaskIds.back(), leafPlan, 0);
+    tasks.push_back(leafTask);
+    Task::start(leafTask, 1);
+    addHiveSplits(leafTask, {filePaths_[i]});
+  }
+
+  core::PlanNodeId exchangeId;
+  auto rootPlan = PlanBuilder()
+                      .exchange(leafPlan->outputType())
+                      .capturePlanNodeId(exchangeId)
+                      .partitionedOutput({}, 1)
+                      .planNode();
+  auto rootTaskId = makeTaskId("root", 0);
+  auto rootTask = makeTask(rootTaskId, rootPlan, 0);
+  tasks.push_back(rootTask);
+  Task::start(rootTask, 1);
+  addRemoteSplits(rootTask, leafTaskIds);
+
+  auto op = PlanBuilder().exchange(rootPlan->outputType()).planNode();
+  assertQuery(op, {rootTaskId}, "SELECT c0, c1 FROM tmp");
+
+  for (auto& task : tasks) {
+    ASSERT_TRUE(waitForTaskCompletion(task.get())) << task->taskId();
+  }
+
+  // The source stats have a value per source and add up to the page stats.
+  auto stats = toPlanStats(rootTask->taskStats()).at(exchangeId).customStats;
+  const auto& pageBytes = stats.at("pageBytes");
+  EXPECT_EQ(filePaths_.size(), stats.at("sourceBytes").count);
+  EXPECT_EQ(pageBytes.sum, stats.at("sourceBytes").sum);
+  EXPECT_EQ(pageBytes.count, stats.at("sourcePages").sum);
+  EXPECT_EQ(pageBytes.count, stats.at("pageQueuedWallNanos").count);
+  EXPECT_EQ(filePaths_.size(), stats.at("sourceResponseWaitNanos").count);
+  int64_t numBucketed = 0;
+  for (const auto& [name, metric] : stats) {
+    if (name.find("pageSize") == 0) {
+      numBucketed += metric.sum;
+    }
+  }
+  EXPECT_EQ(pageBytes.count, numBucketed);
+  EXPECT_LT(0, stats.at("deserializeCpuNanos").count);
+}
+
 TEST_F(MultiFragmentTest, mergeExchange) {
   setupSources(20, 1000);
 
@@ -426,6 +488,122 @@ TEST_F(MultiFragmentTest, broadcast) {
   leafTask->updateBroadcastOutputBuffers(finalAggTaskIds.size(), true);
 }
 
+TEST_F(MultiFragmentTest, arbitrary) {
+  std::vector<RowVectorPtr> data;
+  for (auto i = 0; i < 10; ++i) {
+    data.push_back(makeRowVector({makeFlatVector<int32_t>(
+        1'000, [i](auto row) { return i * 1'000 + row; })}));
+  }
+  createDuckDbTable(data);
+
+  // Make leaf task: Values -> Repartitioning (arbitrary)
+  std::vector<std::shared_ptr<Task>> tasks;
+  auto leafTaskId = makeTaskId("leaf", 0);
+  auto leafPlan =
+      PlanBuilder().values(data).partitionedOutputArbitrary().planNode();
+  auto leafTask = makeTask(leafTaskId, leafPlan, 0);
+  tasks.emplace_back(leafTask);
+  Task::start(leafTask, 1);
+
+  // Each consumer gets some of the pages and all consumers together get
+  // each row once.
+  core::PlanNodePtr consumerPlan;
+  std::vector<std::string> consumerTaskIds;
+  for (int i = 0; i < 3; i++) {
+    consumerPlan = PlanBuilder()
+                       .exchange(leafPlan->outputType())
+                       .partitionedOutput({}, 1)
+                       .planNode();
+
+    consumerTaskIds.push_back(makeTaskId("consumer", i));
+    auto task = makeTask(consumerTaskIds.back(), consumerPlan, i);
+    tasks.emplace_back(task);
+    Task::start(task, 1);
+    leafTask->updateBroadcastOutputBuffers(i + 1, false);
+    addRemoteSplits(task, {leafTaskId});
+  }
+  leafTask->updateBroadcastOutputBuffers(consumerTaskIds.size(), true);
+
+  auto op = PlanBuilder().exchange(consumerPlan->outputType()).planNode();
+  assertQuery(op, consumerTaskIds, "SELECT * FROM tmp");
+
+  for (auto& task : tasks) {
+    ASSERT_TRUE(waitForTaskCompletion(task.get())) << task->taskId();
+  }
+}
+
+TEST_F(MultiFragmentTest, sortShuffle) {
+  SortShuffleExchangeSource::registerFactory();
+  constexpr int32_t kNumPartitions = 17;
+  auto rowType = ROW({"c0", "c1"}, {INTEGER(), INTEGER()});
+  HashPartitionFunction partitionFunction(kNumPartitions, rowType, {0});
+  std::vector<uint32_t> partitions;
+  std::vector<RowVectorPtr> data;
+  for (auto i = 0; i < 10; ++i) {
+    auto keys = makeFlatVector<int32_t>(
+        1'000, [i](auto row) { return i * 1'000 + row; });
+    // 'c1' is the partition of the row computed here.
+    partitionFunction.partition(*makeRowVector({keys, keys}), partitions);
+    data.push_back(makeRowVector(
+        {keys,
+         makeFlatVector<int32_t>(
+             1'000, [&](auto row) { return partitions[row]; })}));
+  }
+  createDuckDbTable(data);
+
+  for (bool spill : {false, true}) {
+    SCOPED_TRACE(fmt::format("spill: {}", spill));
+    auto directory = exec::test::TempDirectoryPath::create();
+    auto spillDirectory = exec::test::TempDirectoryPath::create();
+    if (spill) {
+      configSettings_[core::QueryConfig::kSpillEnabled] = "true";
+      configSettings_[core::QueryConfig::kSortShuffleSpillEnabled] = "true";
+      configSettings_[core::QueryConfig::kSpillPath] = spillDirectory->path;
+      configSettings_[core::QueryConfig::kTestingSpillPct] = "100";
+    }
+    const auto path = directory->path + "/shuffle";
+
+    core::PlanNodeId writeNodeId;
+    auto writePlan = PlanBuilder()
+                         .values(data)
+                         .sortShuffleWrite({"c0"}, kNumPartitions, path)
+                         .capturePlanNodeId(writeNodeId)
+                         .planNode();
+    auto writeTask = makeTask(makeTaskId("write", 0), writePlan, 0);
+    Task::start(writeTask, 1);
+    ASSERT_TRUE(waitForTaskCompletion(writeTask.get()));
+    EXPECT_EQ(
+        spill,
+        toPlanStats(writeTask->taskStats()).at(writeNodeId).spilledRows > 0);
+
+    // Each reader reads its partition and adds its number to the rows.
+    std::vector<std::shared_ptr<Task>> tasks;
+    std::vector<std::string> readerTaskIds;
+    core::PlanNodePtr readerPlan;
+    for (int i = 0; i < kNumPartitions; ++i) {
+      readerPlan =
+          PlanBuilder()
+              .exchange(rowType)
+              .project({"c0", "c1", fmt::format("cast({} as integer)", i)})
+              .partitionedOutput({}, 1)
+              .planNode();
+      readerTaskIds.push_back(makeTaskId("reader", i));
+      auto task = makeTask(readerTaskIds.back(), readerPlan, i);
+      tasks.push_back(task);
+      Task::start(task, 1);
+      addRemoteSplits(
+          task, {std::string(SortShuffleExchangeSource::kPrefix) + path});
+    }
+
+    auto op = PlanBuilder().exchange(readerPlan->outputType()).planNode();
+    assertQuery(op, readerTaskIds, "SELECT c0, c1, c1 FROM tmp");
+
+    for (auto& task : tasks) {
+      ASSERT_TRUE(waitForTaskCompletion(task.get())) << task->taskId();
+    }
+  }
+}
+
 TEST_F(MultiFragmentTest, replicateNullsAndAny) {
   auto data = makeRowVector({makeFlatVector<int32_t>(
       1'000, [](auto row) { return row; }, nullEvery(7))});
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/core/QueryConfig.h"
 #include "velox/exec/PlanNodeStats.h"
@@ -40,6 +41,7 @@ Spiller::Stats spilledStats(const exec::Task& task) {
       spilledStats.spilledBytes += op.spilledBytes;
       spilledStats.spilledRows += op.spilledRows;
       spilledStats.spilledPartitions += op.spilledPartitions;
+      spilledStats.spilledFiles += op.spilledFiles;
     }
   }
   return spilledStats;
@@ -448,6 +450,163 @@ TEST_F(OrderByTest, spill) {
   EXPECT_EQ(1, stats[0].operatorStats[1].spilledPartitions);
 }
 
+TEST_F(OrderByTest, parallelSort) {
+  const int kNumBatches = 3;
+  const int kNumRows = 10'000;
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < kNumBatches; ++i) {
+    batches.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             kNumRows,
+             [&](auto row) { return (i * kNumRows + row) * 7919 % 10007; },
+             nullEvery(17)),
+         makeFlatVector<StringView>(kNumRows, [](auto row) {
+           return StringView(std::to_string(row % 1000));
+         }),
+         makeFlatVector<int32_t>(kNumRows, [](auto /*row*/) { return 1; })}));
+  }
+  createDuckDbTable(batches);
+
+  // Four drivers sort the rows of all drivers in ranges. The LocalMerge
+  // concatenates the ranges. The last case has a single key value, so that
+  // all rows are in one range.
+  struct {
+    std::vector<std::string> keys;
+    std::vector<uint32_t> sortingKeys;
+  } testSettings[] = {
+      {{"c0 ASC NULLS LAST"}, {0}},
+      {{"c0 DESC NULLS FIRST"}, {0}},
+      {{"c1 DESC NULLS LAST", "c0 ASC NULLS FIRST"}, {1, 0}},
+      {{"c2 ASC NULLS LAST"}, {2}}};
+  for (const auto& [keys, sortingKeys] : testSettings) {
+    const auto orderBy = folly::join(", ", keys);
+    SCOPED_TRACE(orderBy);
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    core::PlanNodeId orderById;
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .localMerge(
+                        keys,
+                        {PlanBuilder(planNodeIdGenerator)
+                             .values(batches, true)
+                             .orderBy(keys, true)
+                             .capturePlanNodeId(orderById)
+                             .planNode()})
+                    .planNode();
+    auto queryCtx = core::QueryCtx::createForTest();
+    queryCtx->setConfigOverridesUnsafe({
+        {core::QueryConfig::kOrderByParallelSortEnabled, "true"},
+    });
+    CursorParameters params;
+    params.planNode = plan;
+    params.queryCtx = queryCtx;
+    params.maxDrivers = 4;
+    auto task = assertQueryOrdered(
+        params,
+        fmt::format(
+            "SELECT * FROM (SELECT * FROM tmp UNION ALL SELECT * FROM tmp "
+            "UNION ALL SELECT * FROM tmp UNION ALL SELECT * FROM tmp) "
+            "ORDER BY {}",
+            orderBy),
+        sortingKeys);
+    EXPECT_EQ(
+        4 * kNumBatches * kNumRows,
+        toPlanStats(task->taskStats()).at(orderById).outputRows);
+  }
+}
+
+TEST_F(OrderByTest, spillArbitration) {
+  const int kNumBatches = 3;
+  const int kNumRows = 100'000;
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < kNumBatches; ++i) {
+    batches.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(kNumRows, [](auto row) { return row * 3; }),
+         makeFlatVector<StringView>(kNumRows, [](auto row) {
+           return StringView(std::to_string(row * 3));
+         })}));
+  }
+  createDuckDbTable(batches);
+
+  // Two drivers sort concurrently under one memory cap. The driver that fails
+  // to grow its reservation has its Task spill the OrderBy with the most
+  // memory, which may belong to the other driver.
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId orderById;
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .localMerge(
+                      {"c0 ASC NULLS LAST"},
+                      {PlanBuilder(planNodeIdGenerator)
+                           .values(batches, true)
+                           .orderBy({"c0 ASC NULLS LAST"}, true)
+                           .capturePlanNodeId(orderById)
+                           .planNode()})
+                  .planNode();
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  auto queryCtx = core::QueryCtx::createForTest();
+  constexpr int64_t kMaxBytes = 20LL << 20; // 20 MB
+  queryCtx->pool()->setMemoryUsageTracker(
+      memory::MemoryUsageTracker::create(kMaxBytes, 0, kMaxBytes));
+  queryCtx->setConfigOverridesUnsafe({
+      {core::QueryConfig::kSpillPath, spillDirectory->path},
+      {core::QueryConfig::kSpillEnabled, "true"},
+      {core::QueryConfig::kOrderBySpillEnabled, "true"},
+      {core::QueryConfig::kSpillArbitrationEnabled, "true"},
+      {core::QueryConfig::kSpillableReservationGrowthPct, "1000"},
+  });
+  CursorParameters params;
+  params.planNode = plan;
+  params.queryCtx = queryCtx;
+  params.maxDrivers = 2;
+  auto task = assertQueryOrdered(
+      params,
+      "SELECT * FROM (SELECT * FROM tmp UNION ALL SELECT * FROM tmp) "
+      "ORDER BY c0 ASC NULLS LAST",
+      {0});
+  const auto& customStats =
+      toPlanStats(task->taskStats()).at(orderById).customStats;
+  ASSERT_EQ(1, customStats.count("taskReclaimedBytes"));
+  EXPECT_LT(0, customStats.at("taskReclaimedBytes").sum);
+}
+
+TEST_F(OrderByTest, spillDiskBudget) {
+  auto rowType = ROW({"c0", "c1"}, {INTEGER(), VARCHAR()});
+  VectorFuzzer fuzzer({}, pool());
+  std::vector<RowVectorPtr> batches;
+  for (int32_t i = 0; i < 5; ++i) {
+    batches.push_back(fuzzer.fuzzRow(rowType));
+  }
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .orderBy({"c0 ASC NULLS LAST"}, false)
+                  .planNode();
+  auto results = AssertQueryBuilder(plan).copyResults(pool_.get());
+
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  auto makeBuilder = [&](const std::string& maxSpillBytes) {
+    AssertQueryBuilder builder(plan);
+    builder.config(QueryConfig::kSpillPath, spillDirectory->path)
+        .config(QueryConfig::kSpillEnabled, "true")
+        .config(QueryConfig::kOrderBySpillEnabled, "true")
+        // Spills on each batch.
+        .config(QueryConfig::kOrderBySpillMemoryThreshold, "1")
+        .config(QueryConfig::kMaxSpillBytes, maxSpillBytes);
+    return builder;
+  };
+
+  // Within the budget.
+  auto task = makeBuilder("1000000000").assertResults(results);
+  const auto& orderByStats =
+      task->taskStats().pipelineStats[0].operatorStats[1];
+  EXPECT_LT(0, orderByStats.spilledFiles);
+  EXPECT_LE(orderByStats.spilledBytes, orderByStats.spillPeakDiskBytes);
+
+  // The OrderBy holds all the spill files of the query, so nothing would
+  // release space if it waited.
+  VELOX_ASSERT_THROW(
+      makeBuilder("1").copyResults(pool_.get()),
+      "Exceeded the spill disk budget of the query");
+}
+
 TEST_F(OrderByTest, spillWithMemoryLimit) {
   constexpr int32_t kNumRows = 2000;
   constexpr int64_t kMaxBytes = 1LL << 30; // 1GB
@@ -46,7 +46,9 @@ class PartitionedOutputBufferManagerTest : public testing::Test {
       const std::string& taskId,
       const RowTypePtr& rowType,
       int numDestinations,
-      int numDrivers) {
+      int numDrivers,
+      core::PartitionedOutputNode::Kind kind =
+          core::PartitionedOutputNode::Kind::kPartitioned) {
     bufferManager_->removeTask(taskId);
 
     auto planFragment = exec::test::PlanBuilder()
@@ -56,7 +58,7 @@ class PartitionedOutputBufferManagerTest : public testing::Test {
     auto task = std::make_shared<Task>(
         taskId, std::move(planFragment), 0, core::QueryCtx::createForTest());
 
-    bufferManager_->initializeTask(task, false, numDestinations, numDrivers);
+    bufferManager_->initializeTask(task, kind, numDestinations, numDrivers);
     return task;
   }
 
@@ -294,6 +296,42 @@ TEST_F(PartitionedOutputBufferManagerTest, basic) {
   EXPECT_TRUE(task->isFinished());
 }
 
+TEST_F(PartitionedOutputBufferManagerTest, arbitrary) {
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), VARCHAR()});
+  vector_size_t size = 100;
+
+  std::string taskId = "t0";
+  auto task = initializeTask(
+      taskId, rowType, 1, 1, core::PartitionedOutputNode::Kind::kArbitrary);
+
+  // Any destination takes the next page, so a fast destination gets more
+  // pages than a slow one. A destination is added by its first fetch.
+  for (int i = 0; i < 3; ++i) {
+    enqueue(taskId, 0, rowType, size);
+  }
+  fetchOneAndAck(taskId, 0, 0);
+  fetchOneAndAck(taskId, 0, 1);
+  fetchOne(taskId, 1, 0);
+
+  // A page goes to a waiting destination right away.
+  bool receivedData0;
+  registerForData(taskId, 0, 2, 1, receivedData0);
+  enqueue(taskId, 0, rowType, size);
+  EXPECT_TRUE(receivedData0);
+
+  // The end markers come after the last page is taken.
+  enqueue(taskId, 0, rowType, size);
+  task->updateBroadcastOutputBuffers(2, true);
+  noMoreData(taskId);
+  fetchOne(taskId, 1, 1);
+  EXPECT_FALSE(bufferManager_->isFinished(taskId));
+
+  fetchEndMarker(taskId, 0, 3);
+  EXPECT_TRUE(task->isRunning());
+  fetchEndMarker(taskId, 1, 2);
+  EXPECT_TRUE(task->isFinished());
+}
+
 TEST_F(PartitionedOutputBufferManagerTest, maxBytes) {
   std::vector<std::string> names = {"c0", "c1"};
   std::vector<TypePtr> types = {BIGINT(), VARCHAR()};
@@ -371,6 +409,35 @@ TEST_F(PartitionedOutputBufferManagerTest, errorInQueue) {
   EXPECT_THROW(auto page = queue->dequeue(&atEnd, &future), std::runtime_error);
 }
 
+TEST_F(PartitionedOutputBufferManagerTest, dequeuePages) {
+  auto rowType = ROW({"a"}, {BIGINT()});
+  auto queue = std::make_shared<ExchangeQueue>(1 << 20);
+  std::lock_guard<std::mutex> l(queue->mutex());
+  uint64_t pageSize = 0;
+  for (auto i = 0; i < 5; ++i) {
+    auto page = makeSerializedPage(rowType, 10);
+    pageSize = page->size();
+    queue->enqueue(std::move(page));
+  }
+
+  // The first page is returned with the following pages that fit.
+  bool atEnd = false;
+  ContinueFuture future;
+  auto pages = queue->dequeue(3 * pageSize + 1, &atEnd, &future);
+  EXPECT_EQ(3, pages.size());
+  EXPECT_EQ(2 * pageSize, queue->totalBytes());
+  pages = queue->dequeue(0, &atEnd, &future);
+  EXPECT_EQ(1, pages.size());
+  pages = queue->dequeue(10 * pageSize, &atEnd, &future);
+  EXPECT_EQ(1, pages.size());
+  EXPECT_EQ(0, queue->totalBytes());
+
+  pages = queue->dequeue(10 * pageSize, &atEnd, &future);
+  EXPECT_TRUE(pages.empty());
+  EXPECT_FALSE(atEnd);
+  EXPECT_TRUE(future.valid());
+}
+
 TEST_F(PartitionedOutputBufferManagerTest, serializedPage) {
   const uint64_t kBufferSize = 128;
   // IOBuf managed memory case
@@ -553,4 +553,14 @@ TEST_F(PlanNodeToStringTest, window) {
       "w0 := window1(ROW[\"c\"]) RANGE between CURRENT ROW and b FOLLOWING] "
       "-> a:VARCHAR, b:BIGINT, c:BIGINT, w0:BIGINT\n",
       plan->toString(true, false));
+
+  plan = PlanBuilder()
+             .tableScan(ROW({"a", "b", "c"}, {VARCHAR(), BIGINT(), BIGINT()}))
+             .streamingWindow({"window1(c) over (partition by a order by b)"})
+             .planNode();
+  ASSERT_EQ(
+      "-- Window[partition by [a] order by [b ASC NULLS LAST] inputs sorted "
+      "w0 := window1(ROW[\"c\"]) RANGE between UNBOUNDED PRECEDING and "
+      "CURRENT ROW] -> a:VARCHAR, b:BIGINT, c:BIGINT, w0:BIGINT\n",
+      plan->toString(true, false));
 }
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+#include <gtest/gtest.h>
+#include "velox/exec/tests/utils/RowContainerTestBase.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+class PrefixSortTest : public exec::test::RowContainerTestBase {
+ protected:
+  // Stores 'data' in a container with all its columns as keys, sorts the rows
+  // with PrefixSort on 'keys' and checks the order with
+  // RowContainer::compare().
+  void testSort(
+      const RowVectorPtr& data,
+      const std::vector<PrefixSort::Key>& keys) {
+    std::vector<TypePtr> types;
+    for (auto i = 0; i < data->childrenSize(); ++i) {
+      types.push_back(data->childAt(i)->type());
+    }
+    auto container = makeRowContainer(types, {}, false);
+    std::vector<char*> rows(data->size());
+    for (auto i = 0; i < data->size(); ++i) {
+      rows[i] = container->newRow();
+    }
+    SelectivityVector allRows(data->size());
+    for (auto column = 0; column < types.size(); ++column) {
+      DecodedVector decoded(*data->childAt(column), allRows);
+      for (auto i = 0; i < data->size(); ++i) {
+        container->store(decoded, i, rows[i], column);
+      }
+    }
+
+    PrefixSort::sort(
+        *container, keys, folly::Range<char**>(rows.data(), rows.size()));
+
+    for (auto i = 1; i < rows.size(); ++i) {
+      for (const auto& [column, flags] : keys) {
+        const auto result =
+            container->compare(rows[i - 1], rows[i], column, flags);
+        ASSERT_LE(result, 0) << "row " << i << ", column " << column;
+        if (result < 0) {
+          break;
+        }
+      }
+    }
+  }
+
+  RowVectorPtr fuzz(const RowTypePtr& rowType, vector_size_t size) {
+    VectorFuzzer::Options options;
+    options.vectorSize = size;
+    options.nullRatio = 0.1;
+    // Short strings make many ties on the prefix.
+    options.stringLength = 20;
+    options.stringVariableLength = true;
+    VectorFuzzer fuzzer(options, pool_.get());
+    return fuzzer.fuzzRow(rowType);
+  }
+};
+
+TEST_F(PrefixSortTest, numPrefixKeys) {
+  auto numPrefixKeys = [&](const std::vector<TypePtr>& types) {
+    auto container = makeRowContainer(types, {}, false);
+    return PrefixSort::testingNumPrefixKeys(
+        *container, PrefixSort::leadingKeys(types.size(), {}));
+  };
+  EXPECT_EQ(3, numPrefixKeys({INTEGER(), SMALLINT(), BOOLEAN()}));
+  // The second BIGINT is encoded in part.
+  EXPECT_EQ(2, numPrefixKeys({BIGINT(), BIGINT(), BIGINT()}));
+  // A string ends the prefix.
+  EXPECT_EQ(1, numPrefixKeys({VARCHAR(), BIGINT()}));
+  EXPECT_EQ(2, numPrefixKeys({DATE(), VARCHAR()}));
+  EXPECT_EQ(1, numPrefixKeys({DOUBLE(), ARRAY(BIGINT())}));
+  EXPECT_EQ(0, numPrefixKeys({ARRAY(BIGINT()), BIGINT()}));
+}
+
+TEST_F(PrefixSortTest, sort) {
+  const std::vector<CompareFlags> allFlags = {
+      {true, true, false},
+      {false, true, false},
+      {true, false, false},
+      {false, false, false},
+  };
+  const std::vector<RowTypePtr> rowTypes = {
+      ROW({"c0"}, {BIGINT()}),
+      ROW({"c0"}, {TINYINT()}),
+      ROW({"c0", "c1"}, {VARCHAR(), BIGINT()}),
+      ROW({"c0", "c1", "c2"}, {BIGINT(), DOUBLE(), VARCHAR()}),
+      ROW({"c0", "c1", "c2"}, {REAL(), BOOLEAN(), SMALLINT()}),
+      ROW({"c0", "c1"}, {DATE(), INTEGER()}),
+      ROW({"c0", "c1"}, {ARRAY(INTEGER()), INTEGER()}),
+  };
+  for (const auto& rowType : rowTypes) {
+    auto data = fuzz(rowType, 1'000);
+    for (const auto& flags : allFlags) {
+      SCOPED_TRACE(fmt::format(
+          "{}, nullsFirst: {}, ascending: {}",
+          rowType->toString(),
+          flags.nullsFirst,
+          flags.ascending));
+      std::vector<PrefixSort::Key> keys;
+      for (auto i = 0; i < rowType->size(); ++i) {
+        // Alternates the order between the keys.
+        keys.emplace_back(
+            i,
+            i % 2 == 0 ? flags
+                       : CompareFlags{!flags.nullsFirst, !flags.ascending});
+      }
+      testSort(data, keys);
+    }
+  }
+}
+
+TEST_F(PrefixSortTest, floatingPoint) {
+  facebook::velox::test::VectorMaker vectorMaker(pool_.get());
+  // NaN is larger than any other value and -0.0 equals 0.0.
+  auto data = vectorMaker.rowVector({
+      vectorMaker.flatVectorNullable<double>(
+          {std::nan(""),
+           0.0,
+           -0.0,
+           std::nullopt,
+           -std::numeric_limits<double>::infinity(),
+           std::numeric_limits<double>::infinity(),
+           -1.5,
+           1.5,
+           std::numeric_limits<double>::lowest(),
+           std::numeric_limits<double>::max()}),
+      vectorMaker.flatVector<int32_t>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10}),
+  });
+  testSort(data, {{0, {true, true, false}}, {1, {true, false, false}}});
+  testSort(data, {{0, {false, false, false}}, {1, {true, true, false}}});
+}
@@ -14,9 +14,11 @@
  * limitations under the License.
  */
 #include "velox/exec/Spill.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <memory>
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/serializers/PrestoSerializer.h"
@@ -335,6 +337,297 @@ TEST_F(SpillTest, spillTimestamp) {
   ASSERT_EQ(nullptr, merge->next());
 }
 
+TEST_F(SpillTest, mergeFanInAndReadAhead) {
+  const std::vector<CompareFlags> emptyCompareFlags;
+  constexpr int32_t kNumRuns = 10;
+  constexpr int32_t kRowsPerRun = 1'000;
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  struct {
+    int32_t maxMergeFanIn;
+    bool readAhead;
+
+    std::string debugString() const {
+      return fmt::format(
+          "maxMergeFanIn: {}, readAhead: {}", maxMergeFanIn, readAhead);
+    }
+  } testSettings[] = {{0, false}, {0, true}, {3, false}, {3, true}, {2, true}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    SpillState state(
+        tempDirectory->path + "/test",
+        1,
+        1,
+        emptyCompareFlags,
+        kGB,
+        *pool(),
+        *mappedMemory_);
+    state.setPartitionSpilled(0);
+    // Each run is a file with every 'kNumRuns'th value.
+    for (auto run = 0; run < kNumRuns; ++run) {
+      state.appendToPartition(
+          0,
+          makeRowVector({makeFlatVector<int64_t>(
+              kRowsPerRun, [&](auto row) { return row * kNumRuns + run; })}));
+      state.finishWrite(0);
+    }
+    ASSERT_EQ(kNumRuns, state.spilledFiles());
+
+    // A small read buffer makes many reads ahead per file.
+    SpillReadOptions readOptions{
+        1'000,
+        testData.readAhead ? executor.get() : nullptr,
+        testData.maxMergeFanIn};
+    auto merge = state.startMerge(0, nullptr, readOptions);
+    for (auto i = 0; i < kNumRuns * kRowsPerRun; ++i) {
+      auto* stream = merge->next();
+      ASSERT_NE(nullptr, stream);
+      ASSERT_EQ(
+          i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+      stream->pop();
+    }
+    ASSERT_EQ(nullptr, merge->next());
+  }
+}
+
+TEST_F(SpillTest, spillCompression) {
+  const std::vector<CompareFlags> emptyCompareFlags;
+  // Many repeated values that compress well.
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(10'000, [](auto row) { return row / 100; }),
+      makeFlatVector<StringView>(
+          10'000, [](auto row) { return StringView("spilled string"); }),
+  });
+  for (auto compressionKind :
+       {folly::io::CodecType::NO_COMPRESSION,
+        folly::io::CodecType::LZ4,
+        folly::io::CodecType::ZSTD}) {
+    SCOPED_TRACE(fmt::format("codec: {}", static_cast<int>(compressionKind)));
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    SpillState state(
+        tempDirectory->path + "/test",
+        1,
+        1,
+        emptyCompareFlags,
+        kGB,
+        *pool(),
+        *mappedMemory_,
+        compressionKind);
+    state.setPartitionSpilled(0);
+    for (auto i = 0; i < 3; ++i) {
+      state.appendToPartition(0, data);
+    }
+    state.finishWrite(0);
+    if (compressionKind == folly::io::CodecType::NO_COMPRESSION) {
+      EXPECT_EQ(state.spilledBytes(), state.spilledUncompressedBytes());
+    } else {
+      EXPECT_LT(state.spilledBytes() * 2, state.spilledUncompressedBytes());
+    }
+
+    auto files = state.files(0);
+    ASSERT_EQ(1, files.size());
+    files[0]->startRead();
+    RowVectorPtr result;
+    for (auto i = 0; i < 3; ++i) {
+      ASSERT_TRUE(files[0]->nextBatch(result));
+      assertEqualVectors(data, result);
+    }
+    ASSERT_FALSE(files[0]->nextBatch(result));
+  }
+
+  EXPECT_EQ(folly::io::CodecType::LZ4, spillCompressionKindFromString("lz4"));
+  EXPECT_EQ(
+      folly::io::CodecType::NO_COMPRESSION,
+      spillCompressionKindFromString("none"));
+  VELOX_ASSERT_THROW(
+      spillCompressionKindFromString("brotli"),
+      "Unknown spill compression codec: brotli");
+}
+
+TEST_F(SpillTest, asyncWrite) {
+  const std::vector<CompareFlags> emptyCompareFlags;
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(2);
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 10; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [i](auto row) { return i * 1'000 + row; }),
+    }));
+  }
+  for (auto compressionKind :
+       {folly::io::CodecType::NO_COMPRESSION, folly::io::CodecType::LZ4}) {
+    for (auto targetFileSize : {kGB, int64_t(1)}) {
+      SCOPED_TRACE(fmt::format(
+          "codec: {}, targetFileSize: {}",
+          static_cast<int>(compressionKind),
+          targetFileSize));
+      auto tempDirectory = exec::test::TempDirectoryPath::create();
+      SpillState state(
+          tempDirectory->path + "/test",
+          2,
+          1,
+          emptyCompareFlags,
+          targetFileSize,
+          *pool(),
+          *mappedMemory_,
+          compressionKind,
+          executor.get());
+      for (auto partition = 0; partition < 2; ++partition) {
+        state.setPartitionSpilled(partition);
+        for (const auto& batch : batches) {
+          state.appendToPartition(partition, batch);
+        }
+        state.finishWrite(partition);
+      }
+      EXPECT_LT(0, state.spilledBytes());
+
+      for (auto partition = 0; partition < 2; ++partition) {
+        auto files = state.files(partition);
+        EXPECT_EQ(targetFileSize == 1 ? batches.size() : 1, files.size());
+        auto batch = batches.begin();
+        RowVectorPtr result;
+        for (auto& file : files) {
+          file->startRead();
+          while (file->nextBatch(result)) {
+            ASSERT_TRUE(batch != batches.end());
+            assertEqualVectors(*batch++, result);
+          }
+        }
+        EXPECT_TRUE(batch == batches.end());
+      }
+    }
+  }
+}
+
+TEST_F(SpillTest, localSpillTier) {
+  const std::vector<CompareFlags> emptyCompareFlags;
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 10; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [i](auto row) { return i * 1'000 + row; }),
+    }));
+  }
+  auto remoteDirectory = exec::test::TempDirectoryPath::create();
+  auto localDirectory = exec::test::TempDirectoryPath::create();
+  const uint64_t targetFileSize = kGB;
+  const auto localBytes = SpillFile::localSpillBytes();
+  {
+    // Room for the target size of two files in the local directory. The
+    // writes are buffered in chunks smaller than a batch.
+    SpillState state(
+        remoteDirectory->path + "/test",
+        3,
+        1,
+        emptyCompareFlags,
+        targetFileSize,
+        *pool(),
+        *mappedMemory_,
+        folly::io::CodecType::NO_COMPRESSION,
+        nullptr,
+        SpillWriteOptions{1'000, localDirectory->path, 2 * targetFileSize});
+    // All partitions are written at once so that the third one finds the
+    // local directory full.
+    for (auto partition = 0; partition < 3; ++partition) {
+      state.setPartitionSpilled(partition);
+    }
+    for (const auto& batch : batches) {
+      for (auto partition = 0; partition < 3; ++partition) {
+        state.appendToPartition(partition, batch);
+      }
+    }
+    EXPECT_EQ(localBytes + 2 * targetFileSize, SpillFile::localSpillBytes());
+    for (auto partition = 0; partition < 3; ++partition) {
+      state.finishWrite(partition);
+    }
+    // The reservations shrink to the file sizes.
+    EXPECT_LT(localBytes, SpillFile::localSpillBytes());
+    EXPECT_GT(localBytes + targetFileSize, SpillFile::localSpillBytes());
+
+    const auto paths = state.testingSpilledFilePaths();
+    ASSERT_EQ(3, paths.size());
+    for (auto i = 0; i < 3; ++i) {
+      EXPECT_EQ(
+          0,
+          paths[i].find(
+              i < 2 ? localDirectory->path : remoteDirectory->path + "/"))
+          << paths[i];
+    }
+
+    for (auto partition = 0; partition < 3; ++partition) {
+      auto files = state.files(partition);
+      ASSERT_EQ(1, files.size());
+      files[0]->startRead();
+      RowVectorPtr result;
+      for (const auto& batch : batches) {
+        ASSERT_TRUE(files[0]->nextBatch(result));
+        assertEqualVectors(batch, result);
+      }
+      ASSERT_FALSE(files[0]->nextBatch(result));
+    }
+  }
+  EXPECT_EQ(localBytes, SpillFile::localSpillBytes());
+}
+
+TEST_F(SpillTest, spillDiskTracker) {
+  const std::vector<CompareFlags> emptyCompareFlags;
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 10; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [i](auto row) { return i * 1'000 + row; }),
+    }));
+  }
+  auto tracker = std::make_shared<core::SpillDiskTracker>();
+  int32_t holder;
+  int32_t otherHolder;
+  auto directory = exec::test::TempDirectoryPath::create();
+  {
+    SpillState state(
+        directory->path + "/test",
+        1,
+        1,
+        emptyCompareFlags,
+        kGB,
+        *pool(),
+        *mappedMemory_,
+        folly::io::CodecType::NO_COMPRESSION,
+        nullptr,
+        SpillWriteOptions{1'000, "", 0, tracker, &holder});
+    state.setPartitionSpilled(0);
+    for (const auto& batch : batches) {
+      state.appendToPartition(0, batch);
+    }
+    state.finishWrite(0);
+    const auto spilledBytes = state.spilledBytes();
+    EXPECT_EQ(spilledBytes, tracker->bytes());
+    EXPECT_EQ(spilledBytes, tracker->peakBytes());
+
+    // The only holder of space would wait for itself.
+    ContinueFuture future;
+    EXPECT_FALSE(tracker->waitIfExceeded(&holder, spilledBytes, &future));
+    VELOX_ASSERT_THROW(
+        tracker->waitIfExceeded(&holder, spilledBytes - 1, &future),
+        "Exceeded the spill disk budget of the query");
+    // Another holder waits until the files are released.
+    EXPECT_TRUE(tracker->waitIfExceeded(&otherHolder, 1, &future));
+    EXPECT_FALSE(future.isReady());
+
+    auto files = state.files(0);
+    ASSERT_EQ(1, files.size());
+    files[0]->startRead();
+    RowVectorPtr result;
+    for (const auto& batch : batches) {
+      ASSERT_TRUE(files[0]->nextBatch(result));
+      assertEqualVectors(batch, result);
+    }
+    files.clear();
+    EXPECT_TRUE(future.isReady());
+    EXPECT_EQ(0, tracker->bytes());
+    EXPECT_EQ(spilledBytes, tracker->peakBytes());
+  }
+}
+
 TEST_F(SpillTest, spillStateWithSmallTargetFileSize) {
   // Set the target file size to a small value to open a new file on each batch
   // write.
@@ -91,7 +91,7 @@ class SpillerTest : public exec::test::RowContainerTestBase {
       : param_(param),
         type_(param.type),
         executorPoolSize_(param.poolSize),
-        hashBits_(0, type_ == Spiller::Type::kOrderBy ? 0 : 2),
+        hashBits_(0, isSinglePartitionType() ? 0 : 2),
         numPartitions_(hashBits_.numPartitions()) {}
 
   void SetUp() override {
@@ -124,6 +124,11 @@ class SpillerTest : public exec::test::RowContainerTestBase {
   }
 
  protected:
+  // Returns true for the spiller types that spill into a single partition.
+  bool isSinglePartitionType() const {
+    return type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kWindow;
+  }
+
   void testSortedSpill(
       int32_t spillPct,
       int numDuplicates,
@@ -332,9 +337,9 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           targetFileSize,
           *pool_,
           executor());
-    } else if (type_ == Spiller::Type::kOrderBy) {
-      // We spill 'data' in one partition in type of kOrderBy, otherwise in 4
-      // partitions.
+    } else if (isSinglePartitionType()) {
+      // We spill 'data' in one partition in type of kOrderBy and kWindow,
+      // otherwise in 4 partitions.
       spiller_ = std::make_unique<Spiller>(
           type_,
           rowContainer_.get(),
@@ -360,7 +365,7 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           *pool_,
           executor());
     }
-    if (type_ == Spiller::Type::kOrderBy) {
+    if (isSinglePartitionType()) {
       ASSERT_EQ(spiller_->state().maxPartitions(), 1);
     } else {
       ASSERT_EQ(spiller_->state().maxPartitions(), numPartitions_);
@@ -755,7 +760,8 @@ class NoHashJoinNoOrderBy : public SpillerTest,
         .typesToExclude =
             {Spiller::Type::kHashJoinProbe,
              Spiller::Type::kHashJoinBuild,
-             Spiller::Type::kOrderBy}}
+             Spiller::Type::kOrderBy,
+             Spiller::Type::kWindow}}
         .getTestParams();
   }
 };
@@ -938,7 +944,7 @@ TEST_P(NoHashJoinNoOrderBy, spillWithNonSpillingPartitions) {
 }
 
 TEST_P(AllTypes, nonSortedSpillFunctions) {
-  if (type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kAggregate) {
+  if (isSinglePartitionType() || type_ == Spiller::Type::kAggregate) {
     setupSpillData(rowType_, numKeys_, 1'000, 1, nullptr, {});
     sortSpillData();
     setupSpiller(100'000, false);
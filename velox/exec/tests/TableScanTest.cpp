@@ -21,6 +21,7 @@
 #include "velox/dwio/common/tests/utils/DataFiles.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -28,6 +29,8 @@
 #include "velox/type/Type.h"
 #include "velox/type/tests/SubfieldFiltersBuilder.h"
 
+DECLARE_int32(hive_scan_result_cache_mb);
+
 using namespace facebook::velox;
 using namespace facebook::velox::connector::hive;
 using namespace facebook::velox::exec;
@@ -257,6 +260,42 @@ TEST_F(TableScanTest, partitionKeyAlias) {
   assertQuery(op, split, "SELECT c0, '2021-12-02' FROM tmp");
 }
 
+TEST_F(TableScanTest, partitionKeyRemainingFilter) {
+  auto vectors = makeVectors(1, 1'000, ROW({"c0"}, {BIGINT()}));
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  ColumnHandleMap assignments = {
+      {"c0", regularColumn("c0", BIGINT())},
+      {"ds", partitionKey("ds", VARCHAR())}};
+  auto rowType = ROW({"c0", "ds"}, {BIGINT(), VARCHAR()});
+
+  // The split of the partition that is filtered out points to a missing
+  // file to check that the file is not opened.
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splits = {
+      HiveConnectorSplitBuilder(filePath->path)
+          .partitionKey("ds", "2021-12-02")
+          .build(),
+      HiveConnectorSplitBuilder("/path/that/does/not/exist")
+          .partitionKey("ds", "2021-12-01")
+          .build()};
+
+  for (const auto& filter :
+       {"ds = '2021-12-02'", "ds = '2021-12-02' AND c0 % 2 = 0"}) {
+    auto tableHandle =
+        makeTableHandle(SubfieldFilters{}, parseExpr(filter, rowType));
+    auto op =
+        PlanBuilder().tableScan(rowType, tableHandle, assignments).planNode();
+    auto expected = std::string("SELECT c0, '2021-12-02' FROM tmp");
+    if (std::string_view(filter).find("c0") != std::string_view::npos) {
+      expected += " WHERE c0 % 2 = 0";
+    }
+    auto task = assertQuery(op, splits, expected);
+    EXPECT_EQ(1, getSkippedSplitsStat(task));
+  }
+}
+
 TEST_F(TableScanTest, columnPruning) {
   auto vectors = makeVectors(10, 1'000);
   auto filePath = TempFilePath::create();
@@ -495,6 +534,34 @@ TEST_F(TableScanTest, multipleSplits) {
   assertQuery(tableScanNode(), filePaths, "SELECT * FROM tmp");
 }
 
+TEST_F(TableScanTest, splitPreload) {
+  auto filePaths = makeFilePaths(10);
+  auto vectors = makeVectors(10, 1'000);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  auto plan = tableScanNode();
+  for (auto maxPreload : {0, 1, 3}) {
+    SCOPED_TRACE(fmt::format("maxPreload: {}", maxPreload));
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .config(
+                        core::QueryConfig::kMaxSplitPreloadPerDriver,
+                        std::to_string(maxPreload))
+                    .splits(makeHiveConnectorSplits(filePaths))
+                    .assertResults("SELECT * FROM tmp");
+    const auto& stats =
+        toPlanStats(task->taskStats()).at(plan->id()).customStats;
+    if (maxPreload == 0) {
+      EXPECT_EQ(0, stats.count("preloadedSplits"));
+    } else {
+      // The splits after the first are preloaded.
+      EXPECT_LT(0, stats.at("preloadedSplits").sum);
+    }
+  }
+}
+
 TEST_F(TableScanTest, waitForSplit) {
   auto filePaths = makeFilePaths(10);
   auto vectors = makeVectors(10, 1'000);
@@ -1543,6 +1610,88 @@ TEST_F(TableScanTest, stringNotEqualFilter) {
       "SELECT * FROM tmp WHERE c1 != ''");
 }
 
+TEST_F(TableScanTest, extendedSubfieldFilters) {
+  auto rowType = ROW({"c0", "c1"}, {INTEGER(), VARCHAR()});
+
+  const vector_size_t size = 1'000;
+
+  std::vector<StringView> strings = {"abc", "abcd", "abd", "ab", "b"};
+  auto rowVector = makeRowVector(
+      {makeFlatVector<int32_t>(
+           size, [](auto row) { return row % 31; }, nullEvery(7)),
+       makeFlatVector<StringView>(size, [&strings](auto row) {
+         return strings[row % strings.size()];
+       })});
+
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, rowVector);
+  createDuckDbTable({rowVector});
+
+  auto assertFilter = [&](const std::string& filter) {
+    assertQuery(
+        PlanBuilder().tableScan(rowType, {filter}, {}).planNode(),
+        {filePath},
+        "SELECT * FROM tmp WHERE " + filter);
+  };
+
+  // Overlapping and adjacent ranges are merged.
+  assertFilter("c0 < 5 or c0 between 3 and 10 or c0 = 11 or c0 > 20");
+  assertFilter("c0 is null or c0 = 7");
+  assertFilter("c0 is not null or c0 = 7");
+  assertFilter("cast(c0 as bigint) in (1, 2, 3)");
+  assertFilter("cast(c0 as bigint) >= 25");
+  assertFilter("c1 like 'abc%'");
+  assertFilter("c1 like 'ab'");
+  assertFilter("c0 is distinct from 5");
+  assertFilter("not (c0 is distinct from 5)");
+}
+
+TEST_F(TableScanTest, scanResultCache) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_hive_scan_result_cache_mb = 16;
+  // Replaces the connector with one that has a result cache.
+  connector::unregisterConnector(kHiveConnectorId);
+  connector::registerConnector(
+      connector::getConnectorFactory(
+          connector::hive::HiveConnectorFactory::kHiveConnectorName)
+          ->newConnector(kHiveConnectorId, nullptr, executor_.get()));
+
+  auto rowType = ROW({"c0", "c1", "c2"}, {BIGINT(), INTEGER(), VARCHAR()});
+  auto filePaths = makeFilePaths(3);
+  auto vectors = makeVectors(3, 1'000, rowType);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  auto getCacheHits = [](const std::shared_ptr<Task>& task) {
+    return getTableScanRuntimeStats(task)["numScanResultCacheHits"].sum;
+  };
+
+  auto plan = PlanBuilder()
+                  .tableScan(rowType, {"c0 > 0"}, "c1 % 3 = 1")
+                  .project({"c2", "c0"})
+                  .planNode();
+  const std::string sql = "SELECT c2, c0 FROM tmp WHERE c0 > 0 AND c1 % 3 = 1";
+  auto task = assertQuery(plan, filePaths, sql);
+  EXPECT_EQ(0, getCacheHits(task));
+  task = assertQuery(plan, filePaths, sql);
+  EXPECT_EQ(3, getCacheHits(task));
+
+  // A different filter does not hit the results of the first.
+  task = assertQuery(
+      PlanBuilder().tableScan(rowType, {"c0 > 0"}, {}).planNode(),
+      filePaths,
+      "SELECT * FROM tmp WHERE c0 > 0");
+  EXPECT_EQ(0, getCacheHits(task));
+
+  // Results under a non-deterministic filter are not cached.
+  plan = PlanBuilder().tableScan(rowType, {}, "rand() < 2.0").planNode();
+  assertQuery(plan, filePaths, "SELECT * FROM tmp");
+  task = assertQuery(plan, filePaths, "SELECT * FROM tmp");
+  EXPECT_EQ(0, getCacheHits(task));
+}
+
 TEST_F(TableScanTest, remainingFilter) {
   auto rowType = ROW(
       {"c0", "c1", "c2", "c3"}, {INTEGER(), INTEGER(), DOUBLE(), BOOLEAN()});
@@ -1852,6 +2001,69 @@ TEST_F(TableScanTest, lazyVectorAccessTwiceWithDifferentRows) {
       "SELECT c0, c1 from tmp where ([c0 + c1, if(c1 >= 0, c1, 0)])[1] > 0");
 }
 
+TEST_F(TableScanTest, adaptiveLazyLoad) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 30; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+         makeFlatVector<int64_t>(1'000, [](auto row) { return row * 2; })}));
+  }
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  auto rowType = asRowType(vectors[0]->type());
+  auto lazyStat = [](const std::shared_ptr<Task>& task,
+                     const std::string& name) {
+    return getTableScanRuntimeStats(task).at(name).sum;
+  };
+
+  // All the rows of both columns are loaded. The columns become eager after
+  // the first batches.
+  auto plan = PlanBuilder().tableScan(rowType).project({"c0 + c1"}).planNode();
+  auto task = assertQuery(plan, {filePath}, "SELECT c0 + c1 FROM tmp");
+  EXPECT_EQ(
+      lazyStat(task, "numLazyBatches"), lazyStat(task, "numLoadedLazyBatches"));
+  auto numEagerBatches = lazyStat(task, "numEagerBatches");
+  EXPECT_GT(numEagerBatches, 0);
+
+  // 'c1' is loaded for 1% of its rows and stays lazy.
+  plan = PlanBuilder()
+             .tableScan(rowType)
+             .filter("c0 % 100 = 0")
+             .project({"c1"})
+             .planNode();
+  task = assertQuery(plan, {filePath}, "SELECT c1 FROM tmp WHERE c0 % 100 = 0");
+  EXPECT_GT(lazyStat(task, "numEagerBatches"), 0);
+  EXPECT_LT(lazyStat(task, "numEagerBatches"), numEagerBatches);
+}
+
+TEST_F(TableScanTest, adaptiveFilterOrder) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 30; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+         makeFlatVector<int64_t>(1'000, [](auto row) { return row % 100; })}));
+  }
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  // The range on 'c0' is first without history but drops almost nothing, so
+  // the IN list on 'c1' goes first once the time to drop a row is known.
+  auto plan = PlanBuilder()
+                  .tableScan(
+                      asRowType(vectors[0]->type()),
+                      {"c0 > 0", "c1 in (3, 7, 20)"})
+                  .planNode();
+  auto task = assertQuery(
+      plan, {filePath}, "SELECT * FROM tmp WHERE c0 > 0 AND c1 in (3, 7, 20)");
+  auto stats = getTableScanRuntimeStats(task);
+  EXPECT_LT(0, stats.at("numFilterReorders").sum);
+  EXPECT_EQ(0, stats.at("filterOrder.c1").sum);
+  EXPECT_EQ(1, stats.at("filterOrder.c0").sum);
+}
+
 TEST_F(TableScanTest, structInArrayOrMap) {
   vector_size_t size = 1'000;
 
@@ -2135,3 +2347,63 @@ TEST_F(TableScanTest, errorInLoadLazy) {
     EXPECT_TRUE(ex.context().find(filePath->path, 0) != std::string::npos);
   }
 }
+
+TEST_F(TableScanTest, limitPushdown) {
+  auto filePaths = makeFilePaths(10);
+  auto vectors = makeVectors(10, 1'000);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  // A final Limit over the scan runs in one Driver, which reads only the
+  // rows the Limit needs from the first split.
+  core::PlanNodeId scanNodeId;
+  auto plan = PlanBuilder()
+                  .tableScan(rowType_)
+                  .capturePlanNodeId(scanNodeId)
+                  .limit(5, 10, false)
+                  .planNode();
+  auto task =
+      assertQuery(plan, filePaths, "SELECT * FROM tmp OFFSET 5 LIMIT 10");
+  auto scanStats = toPlanStats(task->taskStats()).at(scanNodeId);
+  EXPECT_EQ(1, scanStats.numSplits);
+  EXPECT_EQ(15, scanStats.outputRows);
+
+  // The partial Limits of several Drivers share the budget of the scan. The
+  // Drivers stop taking splits once it is used up.
+  CursorParameters params;
+  params.planNode = PlanBuilder()
+                        .tableScan(rowType_)
+                        .capturePlanNodeId(scanNodeId)
+                        .limit(0, 10, true)
+                        .localPartition({})
+                        .limit(0, 10, false)
+                        .planNode();
+  params.maxDrivers = 4;
+  auto [cursor, results] = readCursor(params, [&](Task* task) {
+    for (const auto& filePath : filePaths) {
+      task->addSplit(scanNodeId, makeHiveSplit(filePath->path));
+    }
+    task->noMoreSplits(scanNodeId);
+  });
+  int32_t numRows = 0;
+  for (const auto& result : results) {
+    numRows += result->size();
+  }
+  EXPECT_EQ(10, numRows);
+  ASSERT_TRUE(waitForTaskCompletion(cursor->task().get()));
+  scanStats = toPlanStats(cursor->task()->taskStats()).at(scanNodeId);
+  EXPECT_LE(scanStats.numSplits, 4);
+  EXPECT_LE(scanStats.outputRows, 40);
+
+  // A partial Limit with an offset is not pushed down, since each Driver
+  // skips the offset of its own.
+  plan = PlanBuilder()
+             .tableScan(rowType_)
+             .capturePlanNodeId(scanNodeId)
+             .limit(5, 10, true)
+             .planNode();
+  task = assertQuery(plan, filePaths, "SELECT * FROM tmp OFFSET 5 LIMIT 10");
+  EXPECT_LT(15, toPlanStats(task->taskStats()).at(scanNodeId).outputRows);
+}
@@ -14,9 +14,14 @@
  * limitations under the License.
  */
 #include "velox/common/base/Fs.h"
+#include "velox/connectors/hive/HivePartitionFunction.h"
 #include "velox/dwio/common/DataSink.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+#include <numeric>
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
@@ -236,3 +241,93 @@ TEST_F(TableWriteTest, writeEmptyFile) {
   execute(plan, queryCtx);
   ASSERT_TRUE(fs::exists(outputFile->path));
 }
+
+// Writes the rows to bucket files sorted on c1 with and without spilling and
+// checks that each file has the rows of its bucket in sort order.
+TEST_F(TableWriteTest, bucketedSortedWrite) {
+  constexpr int32_t kNumBuckets = 4;
+  auto vectors = makeVectors(rowType_, 10, 1000);
+  createDuckDbTable(vectors);
+
+  auto bucketFunctionFactory = [](int numBuckets) {
+    std::vector<int> bucketToPartition(numBuckets);
+    std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+    return std::make_unique<HivePartitionFunction>(
+        numBuckets,
+        std::move(bucketToPartition),
+        std::vector<column_index_t>{0});
+  };
+
+  for (const bool spill : {false, true}) {
+    SCOPED_TRACE(fmt::format("spill {}", spill));
+    auto outputDirectory = TempDirectoryPath::create();
+    const auto outputPath = outputDirectory->path + "/bucketed";
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .tableWrite(
+                        rowType_->names(),
+                        std::make_shared<core::InsertTableHandle>(
+                            kHiveConnectorId,
+                            std::make_shared<HiveInsertTableHandle>(
+                                outputPath)),
+                        kNumBuckets,
+                        bucketFunctionFactory,
+                        {"c1"},
+                        "rows")
+                    .project({"rows"})
+                    .planNode();
+
+    auto spillDirectory = TempDirectoryPath::create();
+    auto queryCtx = core::QueryCtx::createForTest();
+    if (spill) {
+      queryCtx->setConfigOverridesUnsafe({
+          {core::QueryConfig::kTestingSpillPct, "100"},
+          {core::QueryConfig::kSpillEnabled, "true"},
+          {core::QueryConfig::kTableWriterSpillEnabled, "true"},
+          {core::QueryConfig::kSpillPath, spillDirectory->path},
+      });
+    }
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .queryCtx(queryCtx)
+                    .assertResults("SELECT count(*) FROM tmp");
+    int64_t spilledBytes = 0;
+    for (const auto& pipeline : task->taskStats().pipelineStats) {
+      for (const auto& op : pipeline.operatorStats) {
+        spilledBytes += op.spilledBytes;
+      }
+    }
+    EXPECT_EQ(spill, spilledBytes > 0);
+
+    std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+    auto bucketFunction = bucketFunctionFactory(kNumBuckets);
+    std::vector<uint32_t> buckets;
+    for (auto bucket = 0; bucket < kNumBuckets; ++bucket) {
+      const auto bucketPath = fmt::format("{}_{:05d}", outputPath, bucket);
+      if (!fs::exists(bucketPath)) {
+        continue;
+      }
+      auto rows =
+          AssertQueryBuilder(PlanBuilder().tableScan(rowType_).planNode())
+              .split(makeHiveConnectorSplit(bucketPath))
+              .copyResults(pool_.get());
+      bucketFunction->partition(*rows, buckets);
+      const auto& c1 = rows->childAt(1);
+      for (auto i = 0; i < rows->size(); ++i) {
+        ASSERT_EQ(bucket, buckets[i]);
+        if (i > 0) {
+          ASSERT_LE(
+              c1->compare(c1.get(), i - 1, i, CompareFlags{false, true})
+                  .value(),
+              0);
+        }
+      }
+      splits.push_back(makeHiveConnectorSplit(bucketPath));
+    }
+    EXPECT_LT(1, splits.size());
+
+    AssertQueryBuilder(
+        PlanBuilder().tableScan(rowType_).planNode(), duckDbQueryRunner_)
+        .splits(splits)
+        .assertResults("SELECT * FROM tmp");
+  }
+}
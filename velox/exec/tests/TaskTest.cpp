@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/Task.h"
+#include <folly/json.h>
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/connectors/hive/HiveConnector.h"
@@ -427,6 +428,63 @@ TEST_F(TaskTest, testTerminateDeadlock) {
   VELOX_ASSERT_THROW(cursor->moveNext(), "Aborted for external error");
 }
 
+TEST_F(TaskTest, numaAwareTasks) {
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(1'000, [](auto row) { return row; })});
+  CursorParameters params;
+  params.planNode =
+      PlanBuilder().values({data}, true).filter("c0 % 2 = 0").planNode();
+  params.maxDrivers = 2;
+  params.queryCtx = core::QueryCtx::createForTest();
+  params.queryCtx->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kNumaAwareTasks, "true"}});
+  auto [cursor, results] = readCursor(params, [](Task*) {});
+  int64_t numRows = 0;
+  for (const auto& result : results) {
+    numRows += result->size();
+  }
+  // Each of the 2 Drivers produces the even rows.
+  EXPECT_EQ(1'000, numRows);
+
+  // A single node machine does not place Tasks.
+  if (process::numNumaNodes() == 1) {
+    EXPECT_EQ(process::kNoNumaNode, cursor->task()->numaNode());
+  } else {
+    EXPECT_LT(cursor->task()->numaNode(), process::numNumaNodes());
+  }
+}
+
+TEST_F(TaskTest, driverTrace) {
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(1'000, [](auto row) { return row; })});
+  CursorParameters params;
+  params.planNode =
+      PlanBuilder().values({data}, true).filter("c0 % 2 = 0").planNode();
+  params.maxDrivers = 2;
+  params.queryCtx = core::QueryCtx::createForTest();
+  params.queryCtx->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kDriverTraceEnabled, "true"}});
+  auto [cursor, results] = readCursor(params, [](Task*) {});
+
+  auto trace = folly::parseJson(cursor->task()->driverTrace());
+  std::unordered_set<int64_t> onThreadDrivers;
+  for (const auto& event : trace["traceEvents"]) {
+    if (event["name"] == "OnThread") {
+      EXPECT_EQ(0, event["pid"].asInt());
+      EXPECT_GE(event["dur"].asInt(), 0);
+      EXPECT_TRUE(event["args"].count("stopReason"));
+      onThreadDrivers.insert(event["tid"].asInt());
+    }
+  }
+  EXPECT_EQ(2, onThreadDrivers.size());
+
+  // A Task without the config does not trace.
+  params.queryCtx = core::QueryCtx::createForTest();
+  auto [otherCursor, otherResults] = readCursor(params, [](Task*) {});
+  EXPECT_EQ(0, otherCursor->task()->driverTraceId());
+  VELOX_ASSERT_THROW(otherCursor->task()->driverTrace(), "are not traced");
+}
+
 TEST_F(TaskTest, singleThreadedExecution) {
   auto data = makeRowVector({
       makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
@@ -13,8 +13,10 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec::test;
@@ -245,3 +247,43 @@ TEST_F(TopNTest, empty) {
 
   testSingleKey(vectors, "c0", "c0 < 0");
 }
+
+TEST_F(TopNTest, spill) {
+  vector_size_t batchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    auto c0 = makeFlatVector<StringView>(batchSize, [&](vector_size_t row) {
+      return StringView(std::to_string(batchSize * i + row));
+    });
+    auto c1 = makeFlatVector<int64_t>(batchSize, [&](vector_size_t row) {
+      return (batchSize * i + row) * 7919 % 10'007;
+    });
+    vectors.push_back(makeRowVector({c0, c1}));
+  }
+  createDuckDbTable(vectors);
+
+  // Limits below and above the number of rows.
+  for (int32_t limit : {10, 2'500, 20'000}) {
+    SCOPED_TRACE(fmt::format("limit: {}", limit));
+    auto spillDirectory = TempDirectoryPath::create();
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .topN({"c1 DESC"}, limit, false)
+                    .planNode();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(core::QueryConfig::kTestingSpillPct, "100")
+            .config(core::QueryConfig::kSpillEnabled, "true")
+            .config(core::QueryConfig::kTopNSpillEnabled, "true")
+            .config(core::QueryConfig::kSpillPath, spillDirectory->path)
+            .assertResults(
+                fmt::format(
+                    "SELECT * FROM tmp ORDER BY c1 DESC LIMIT {}", limit),
+                {{1}});
+
+    const auto stats = task->taskStats().pipelineStats[0].operatorStats[1];
+    ASSERT_EQ(stats.operatorType, "TopN");
+    EXPECT_LT(0, stats.spilledRows);
+    EXPECT_EQ(1, stats.spilledPartitions);
+  }
+}
@@ -15,6 +15,8 @@
  */
 #include "velox/exec/tests/utils/MergeTestBase.h"
 
+#include <cmath>
+
 using namespace facebook::velox;
 using namespace facebook::velox::exec::test;
 
@@ -241,3 +243,71 @@ TEST_F(TreeOfLosersTest, randomWithDuplicates) {
     }
   }
 }
+
+TEST_F(TreeOfLosersTest, runs) {
+  for (auto clusterSize : {1, 3, 100, 10000}) {
+    SCOPED_TRACE(fmt::format("clusterSize: {}", clusterSize));
+    testRuns(makeTestData(0, 3, clusterSize), true);
+    testRuns(makeTestData(1000, 1, clusterSize), true);
+    testRuns(makeTestData(100000, 2, clusterSize), true);
+    testRuns(makeTestData(100000, 37, clusterSize), true);
+
+    // The clusters do not change the result of merging one value at a time.
+    auto testData = makeTestData(100000, 17, clusterSize);
+    test<TreeOfLosers<TestingStream>>(testData, true);
+  }
+}
+
+TEST_F(TreeOfLosersTest, runnerUp) {
+  std::vector<std::unique_ptr<TestingStream>> streams;
+  streams.push_back(
+      std::make_unique<TestingStream>(std::vector<uint32_t>{9, 3, 2}));
+  streams.push_back(
+      std::make_unique<TestingStream>(std::vector<uint32_t>{7, 5}));
+  streams.push_back(
+      std::make_unique<TestingStream>(std::vector<uint32_t>{8, 4, 1}));
+  TreeOfLosers<TestingStream> merge(std::move(streams));
+
+  // Pairs of the next value and the first value of the runner-up.
+  const std::vector<std::pair<uint32_t, std::optional<uint32_t>>> expected = {
+      {1, 2},
+      {2, 4},
+      {3, 4},
+      {4, 5},
+      {5, 8},
+      {7, 8},
+      {8, 9},
+      {9, std::nullopt}};
+  for (const auto& [value, runnerUpValue] : expected) {
+    auto* stream = merge.next();
+    ASSERT_TRUE(stream != nullptr);
+    EXPECT_EQ(value, stream->current()->value());
+    auto* runnerUp = merge.runnerUp();
+    if (runnerUpValue.has_value()) {
+      ASSERT_TRUE(runnerUp != nullptr) << value;
+      EXPECT_EQ(runnerUpValue.value(), runnerUp->current()->value());
+    } else {
+      EXPECT_TRUE(runnerUp == nullptr) << value;
+    }
+    stream->pop();
+  }
+  EXPECT_TRUE(merge.next() == nullptr);
+}
+
+TEST_F(TreeOfLosersTest, gallopingRunSize) {
+  for (int32_t size : {1, 2, 3, 7, 8, 9, 100, 1025}) {
+    for (int32_t runSize = 1; runSize <= size; ++runSize) {
+      int32_t numCalls = 0;
+      EXPECT_EQ(
+          runSize,
+          gallopingRunSize<int32_t>(
+              size,
+              [&](int32_t index) {
+                ++numCalls;
+                return index < runSize;
+              }))
+          << size << " " << runSize;
+      EXPECT_LE(numCalls, 2 * std::log2(runSize) + 2) << runSize;
+    }
+  }
+}
@@ -13,10 +13,13 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
 using namespace facebook::velox;
+using namespace facebook::velox::exec;
 using namespace facebook::velox::exec::test;
 
 class UnnestTest : public OperatorTestBase {};
@@ -403,3 +406,139 @@ TEST_F(UnnestTest, allEmptyOrNullMaps) {
            .planNode();
   assertQueryReturnsEmptyResult(op);
 }
+
+TEST_F(UnnestTest, outputBatchBytes) {
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+      makeArrayVector<int32_t>(
+          100,
+          [](auto /* row */) { return 10; },
+          [](auto row, auto index) { return row * 10 + index; }),
+  });
+  createDuckDbTable({vector});
+
+  core::PlanNodeId unnestId;
+  auto plan = PlanBuilder()
+                  .values({vector})
+                  .unnest({"c0"}, {"c1"})
+                  .capturePlanNodeId(unnestId)
+                  .planNode();
+  auto sql = "SELECT c0, UNNEST(c1) FROM tmp";
+
+  auto numOutputVectors = [&](const std::string& batchBytes,
+                              const std::string& maxBatchRows) {
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .config(core::QueryConfig::kPreferredOutputBatchBytes,
+                            batchBytes)
+                    .config(core::QueryConfig::kMaxOutputBatchRows,
+                            maxBatchRows)
+                    .assertResults(sql);
+    return toPlanStats(task->taskStats()).at(unnestId).outputVectors;
+  };
+
+  // Without a byte target all 1'000 rows fit in one batch.
+  EXPECT_EQ(1, numOutputVectors("0", "10000"));
+  // Batches are capped at 100 rows, i.e. 10 input rows.
+  EXPECT_EQ(10, numOutputVectors("1000000", "100"));
+  // A row with more elements than fit in a batch is split over batches.
+  EXPECT_EQ(1'000, numOutputVectors("1", "10000"));
+  EXPECT_EQ(334, numOutputVectors("1000000", "3"));
+}
+
+TEST_F(UnnestTest, splitLargeRows) {
+  constexpr vector_size_t kSize = 40;
+  auto size1 = [](auto row) { return (row % 4) * 50; };
+  auto size2 = [](auto row) { return (row % 3) * 60; };
+  auto value1 = [](auto row, auto index) { return row * 1'000 + index; };
+  auto value2 = [](auto row, auto index) { return row * 2'000 + index; };
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(kSize, [](auto row) { return row; }),
+      makeArrayVector<int32_t>(kSize, size1, value1, nullEvery(9)),
+      makeArrayVector<int64_t>(kSize, size2, value2, nullEvery(7)),
+  });
+
+  // The shorter of the arrays of a row is padded with nulls.
+  std::vector<int64_t> expectedReplicated;
+  std::vector<std::optional<int32_t>> expected1;
+  std::vector<std::optional<int64_t>> expected2;
+  std::vector<int64_t> expectedOrdinality;
+  for (auto row = 0; row < kSize; ++row) {
+    const auto numElements1 = row % 9 == 0 ? 0 : size1(row);
+    const auto numElements2 = row % 7 == 0 ? 0 : size2(row);
+    for (auto i = 0; i < std::max(numElements1, numElements2); ++i) {
+      expectedReplicated.push_back(row);
+      expected1.push_back(
+          i < numElements1 ? std::optional(value1(row, i)) : std::nullopt);
+      expected2.push_back(
+          i < numElements2 ? std::optional<int64_t>(value2(row, i))
+                           : std::nullopt);
+      expectedOrdinality.push_back(i + 1);
+    }
+  }
+  auto expected = makeRowVector({
+      makeFlatVector(expectedReplicated),
+      makeNullableFlatVector(expected1),
+      makeNullableFlatVector(expected2),
+      makeFlatVector(expectedOrdinality),
+  });
+
+  core::PlanNodeId unnestId;
+  auto plan = PlanBuilder()
+                  .values({vector})
+                  .unnest({"c0"}, {"c1", "c2"}, "ordinal")
+                  .capturePlanNodeId(unnestId)
+                  .planNode();
+  for (auto batchSize : {1, 7, 64, 149, 151, 100'000}) {
+    SCOPED_TRACE(fmt::format("batchSize: {}", batchSize));
+    auto task = AssertQueryBuilder(plan)
+                    .config(core::QueryConfig::kPreferredOutputBatchBytes, "0")
+                    .config(
+                        core::QueryConfig::kPreferredOutputBatchSize,
+                        std::to_string(batchSize))
+                    .assertResults(expected);
+    // All batches but the last are full.
+    const uint64_t numBatches =
+        bits::roundUp(expected->size(), batchSize) / batchSize;
+    EXPECT_EQ(
+        numBatches, toPlanStats(task->taskStats()).at(unnestId).outputVectors);
+  }
+}
+
+TEST_F(UnnestTest, sliceElements) {
+  // Each batch has consecutive elements of the arrays without null padding,
+  // so that the element column is a slice of the elements of the input.
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(10, [](auto row) { return row; }),
+      makeArrayVector<int32_t>(
+          10,
+          [](auto row) { return row * 3; },
+          [](auto row, auto index) { return row * 100 + index; }),
+  });
+  std::vector<int64_t> expectedReplicated;
+  std::vector<int32_t> expectedElements;
+  for (auto row = 0; row < 10; ++row) {
+    for (auto i = 0; i < row * 3; ++i) {
+      expectedReplicated.push_back(row);
+      expectedElements.push_back(row * 100 + i);
+    }
+  }
+  auto expected = makeRowVector({
+      makeFlatVector(expectedReplicated),
+      makeFlatVector(expectedElements),
+  });
+
+  CursorParameters params;
+  params.planNode =
+      PlanBuilder().values({vector}).unnest({"c0"}, {"c1"}).planNode();
+  params.queryCtx = core::QueryCtx::createForTest();
+  params.queryCtx->setConfigOverridesUnsafe({
+      {core::QueryConfig::kPreferredOutputBatchBytes, "0"},
+      {core::QueryConfig::kPreferredOutputBatchSize, "20"},
+  });
+  auto [cursor, results] = readCursor(params, [](auto /*task*/) {});
+  ASSERT_EQ(7, results.size());
+  for (const auto& result : results) {
+    EXPECT_EQ(VectorEncoding::Simple::FLAT, result->childAt(1)->encoding());
+  }
+  assertEqualResults({expected}, results);
+}
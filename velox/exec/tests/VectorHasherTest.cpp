@@ -303,6 +303,69 @@ TEST_F(VectorHasherTest, dictionary) {
   }
 }
 
+// Tests that the hashes and ids of the elements of a string dictionary stay
+// right across batches over the same dictionary and mode changes.
+TEST_F(VectorHasherTest, stringDictionary) {
+  auto base = vectorMaker_->flatVector<StringView>(
+      10, [](auto row) { return StringView(fmt::format("s{}", row)); });
+  auto makeBatch = [&](int32_t step) {
+    BufferPtr indices =
+        AlignedBuffer::allocate<vector_size_t>(100, pool_.get());
+    auto rawIndices = indices->asMutable<vector_size_t>();
+    for (int32_t i = 0; i < 100; i++) {
+      rawIndices[i] = (i * step) % 10;
+    }
+    return BaseVector::wrapInDictionary(
+        BufferPtr(nullptr), indices, 100, base);
+  };
+  auto flatHasher = exec::VectorHasher::create(VARCHAR(), 0);
+  auto hasher = exec::VectorHasher::create(VARCHAR(), 0);
+  SelectivityVector baseRows(10);
+  raw_vector<uint64_t> expected(10);
+  raw_vector<uint64_t> result(100);
+
+  auto expectSame = [&](int32_t step) {
+    for (auto i = 0; i < 100; ++i) {
+      ASSERT_EQ(expected[(i * step) % 10], result[i]) << "at " << i;
+    }
+  };
+  for (auto step : {1, 3, 7}) {
+    auto batch = makeBatch(step);
+    flatHasher->decode(*base, baseRows);
+    flatHasher->hash(baseRows, false, expected);
+    hasher->decode(*batch, allRows_);
+    hasher->hash(allRows_, false, result);
+    expectSame(step);
+  }
+
+  // Collects the distinct values, then maps them to ids.
+  flatHasher->decode(*base, baseRows);
+  EXPECT_FALSE(flatHasher->computeValueIds(baseRows, expected));
+  auto batch = makeBatch(1);
+  hasher->decode(*batch, allRows_);
+  EXPECT_FALSE(hasher->computeValueIds(allRows_, result));
+  flatHasher->enableValueIds(1, 0);
+  hasher->enableValueIds(1, 0);
+  flatHasher->decode(*base, baseRows);
+  ASSERT_TRUE(flatHasher->computeValueIds(baseRows, expected));
+  for (auto step : {1, 3}) {
+    batch = makeBatch(step);
+    hasher->decode(*batch, allRows_);
+    ASSERT_TRUE(hasher->computeValueIds(allRows_, result));
+    expectSame(step);
+  }
+
+  // The ids by range are different from the ids by distinct value.
+  flatHasher->enableValueRange(1, 0);
+  hasher->enableValueRange(1, 0);
+  flatHasher->decode(*base, baseRows);
+  ASSERT_TRUE(flatHasher->computeValueIds(baseRows, expected));
+  batch = makeBatch(7);
+  hasher->decode(*batch, allRows_);
+  ASSERT_TRUE(hasher->computeValueIds(allRows_, result));
+  expectSame(7);
+}
+
 // Tests how strings are mapped to uint64_t (if they fit) and to
 // consecutive ids of distinct values for the general case.
 TEST_F(VectorHasherTest, stringIds) {
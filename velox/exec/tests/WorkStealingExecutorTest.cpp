@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/WorkStealingExecutor.h"
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class WorkStealingExecutorTest : public OperatorTestBase {};
+
+TEST_F(WorkStealingExecutorTest, runAll) {
+  constexpr int32_t kNumFuncs = 1'000;
+  std::atomic<int32_t> numRun{0};
+  {
+    WorkStealingExecutor executor(4);
+    for (auto i = 0; i < kNumFuncs; ++i) {
+      // Each function adds another one from its worker.
+      executor.add([&]() {
+        ++numRun;
+        executor.add([&]() { ++numRun; });
+      });
+    }
+  }
+  // The destructor runs the queued functions.
+  EXPECT_EQ(2 * kNumFuncs, numRun);
+}
+
+TEST_F(WorkStealingExecutorTest, currentWorker) {
+  WorkStealingExecutor executor(3);
+  WorkStealingExecutor otherExecutor(1);
+  EXPECT_EQ(-1, executor.currentWorker());
+  for (auto worker = 0; worker < executor.numThreads(); ++worker) {
+    folly::Baton<> done;
+    int32_t currentWorker = -2;
+    int32_t otherWorker = -2;
+    executor.addWithAffinity(
+        [&]() {
+          currentWorker = executor.currentWorker();
+          otherWorker = otherExecutor.currentWorker();
+          done.post();
+        },
+        worker);
+    done.wait();
+    // An idle executor runs the function on the worker it was queued on.
+    EXPECT_EQ(worker, currentWorker);
+    EXPECT_EQ(-1, otherWorker);
+  }
+}
+
+TEST_F(WorkStealingExecutorTest, steal) {
+  constexpr int32_t kNumFuncs = 100;
+  WorkStealingExecutor executor(4);
+  folly::Baton<> blocked;
+  folly::Baton<> release;
+  executor.addWithAffinity(
+      [&]() {
+        blocked.post();
+        release.wait();
+      },
+      0);
+  blocked.wait();
+
+  // Worker 0 is busy, so the other workers run its queue.
+  std::atomic<int32_t> numRun{0};
+  folly::Baton<> done;
+  for (auto i = 0; i < kNumFuncs; ++i) {
+    executor.addWithAffinity(
+        [&]() {
+          EXPECT_NE(0, executor.currentWorker());
+          if (++numRun == kNumFuncs) {
+            done.post();
+          }
+        },
+        0);
+  }
+  done.wait();
+  EXPECT_EQ(kNumFuncs, executor.numStolen());
+  release.post();
+}
+
+TEST_F(WorkStealingExecutorTest, drivers) {
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 10; ++i) {
+    batches.push_back(makeRowVector({makeFlatVector<int64_t>(
+        1'000, [i](auto row) { return i * 1'000 + row; })}));
+  }
+  createDuckDbTable(batches);
+
+  constexpr int32_t kNumDrivers = 4;
+  auto plan = PlanBuilder()
+                  .values(batches, true)
+                  .filter("c0 % 3 = 0")
+                  .project({"c0 + 1"})
+                  .planNode();
+  std::string sql = "SELECT c0 + 1 FROM tmp WHERE c0 % 3 = 0";
+  for (auto i = 1; i < kNumDrivers; ++i) {
+    sql += " UNION ALL SELECT c0 + 1 FROM tmp WHERE c0 % 3 = 0";
+  }
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      std::make_shared<WorkStealingExecutor>(kNumDrivers));
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .queryCtx(queryCtx)
+      .maxDrivers(kNumDrivers)
+      .assertResults(sql);
+}
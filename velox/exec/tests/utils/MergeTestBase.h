@@ -79,6 +79,26 @@ class TestingStream final : public MergeStream {
     currentValid_ = false;
   }
 
+  // Removes the first 'count' values.
+  void pop(int32_t count) {
+    numbers_.resize(numbers_.size() - count);
+    currentValid_ = false;
+  }
+
+  // Returns the number of leading values, at most 'maxValues', that are not
+  // greater than the first value of 'other', or all values if 'other' is
+  // nullptr.
+  int32_t runSize(const TestingStream* other, int32_t maxValues) const {
+    const int32_t size = std::min<size_t>(maxValues, numbers_.size());
+    if (other == nullptr) {
+      return size;
+    }
+    const auto otherValue = other->current()->value();
+    return gallopingRunSize<int32_t>(size, [&](int32_t offset) {
+      return numbers_[numbers_.size() - 1 - offset] <= otherValue;
+    });
+  }
+
   bool operator<(const MergeStream& other) const final {
     return current_.value() <
         static_cast<const TestingStream&>(other).current_.value();
@@ -115,12 +135,25 @@ class MergeTestBase {
     rng_.seed(seed);
   }
 
-  // Makes 'numRuns' sorted streams totalling 'numValues' entries.
-  TestData makeTestData(int32_t numValues, int32_t numRuns) {
+  // Makes 'numRuns' sorted streams totalling 'numValues' entries. If
+  // 'clusterSize' is more than 1, the values come in clusters of
+  // 'clusterSize' consecutive values that mostly go to the same stream.
+  TestData
+  makeTestData(int32_t numValues, int32_t numRuns, int32_t clusterSize = 1) {
     TestData data;
     data.data.reserve(numValues);
+    uint32_t cluster = 0;
     for (auto i = 0; i < numValues; ++i) {
-      data.data.push_back(folly::Random::rand32(rng_));
+      if (clusterSize <= 1) {
+        data.data.push_back(folly::Random::rand32(rng_));
+        continue;
+      }
+      // Each cluster is a range of values with a random start.
+      if (i % clusterSize == 0) {
+        cluster = folly::Random::rand32(rng_);
+      }
+      data.data.push_back(static_cast<uint32_t>(
+          (cluster / clusterSize) * clusterSize + i % clusterSize));
     }
     std::vector<std::vector<uint32_t>> runs;
     int32_t offset = 0;
@@ -146,6 +179,39 @@ class MergeTestBase {
     return data;
   }
 
+  // Reads the data in 'testData.runs' using TreeOfLosers, taking the values
+  // of the winning stream up to the first value of the runner-up at a time.
+  // Checks the results like test().
+  static void testRuns(const TestData& testData, bool check) {
+    constexpr int32_t kMaxRun = 1024;
+    std::vector<std::unique_ptr<TestingStream>> sources;
+    for (auto& source : testData.sources) {
+      sources.push_back(std::make_unique<TestingStream>(*source));
+    }
+    TreeOfLosers<TestingStream> merge(std::move(sources));
+    size_t numValues = 0;
+    TestingStream* last = nullptr;
+    TestingStream* stream;
+    while ((stream = merge.next())) {
+      const auto numRun =
+          stream == last ? stream->runSize(merge.runnerUp(), kMaxRun) : 1;
+      last = stream;
+      if (check) {
+        for (auto i = 0; i < numRun; ++i) {
+          ASSERT_LT(numValues, testData.data.size());
+          ASSERT_EQ(stream->current()->value(), testData.data[numValues]);
+          stream->pop();
+        }
+      } else {
+        stream->pop(numRun);
+      }
+      numValues += numRun;
+    }
+    if (check) {
+      ASSERT_EQ(numValues, testData.data.size());
+    }
+  }
+
   // Reads the data in 'testData.runs' using the merging class MergeType. Checks
   // that the results match the globally sorted data in 'testData' if check is
   // true.
@@ -138,7 +138,8 @@ PlanBuilder& PlanBuilder::tableScan(
 PlanBuilder& PlanBuilder::tableScan(
     tpch::Table table,
     std::vector<std::string>&& columnNames,
-    double scaleFactor) {
+    double scaleFactor,
+    const std::string& filter) {
   std::unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
       assignmentsMap;
   std::vector<TypePtr> outputTypes;
@@ -152,11 +153,16 @@ PlanBuilder& PlanBuilder::tableScan(
         std::make_shared<connector::tpch::TpchColumnHandle>(columnName));
     outputTypes.emplace_back(resolveTpchColumn(table, columnName));
   }
+  core::TypedExprPtr filterExpr;
+  if (!filter.empty()) {
+    filterExpr =
+        parseExpr(filter, tpch::getTableSchema(table), options_, pool_);
+  }
   auto rowType = ROW(std::move(columnNames), std::move(outputTypes));
   return tableScan(
       rowType,
       std::make_shared<connector::tpch::TpchTableHandle>(
-          kTpchConnectorId, table, scaleFactor),
+          kTpchConnectorId, table, scaleFactor, std::move(filterExpr)),
       assignmentsMap);
 }
 
@@ -169,6 +175,15 @@ PlanBuilder& PlanBuilder::values(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::arrowStream(
+    const RowTypePtr& outputType,
+    std::shared_ptr<ArrowArrayStream> arrowStream) {
+  VELOX_CHECK_NULL(planNode_, "arrowStream() must be the first call");
+  planNode_ = std::make_shared<core::ArrowStreamNode>(
+      nextPlanNodeId(), outputType, std::move(arrowStream));
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::exchange(const RowTypePtr& outputType) {
   VELOX_CHECK_NULL(planNode_, "exchange() must be the first call");
   planNode_ =
@@ -290,6 +305,32 @@ PlanBuilder& PlanBuilder::tableWrite(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::tableWrite(
+    const std::vector<std::string>& columnNames,
+    const std::shared_ptr<core::InsertTableHandle>& insertHandle,
+    int32_t numBuckets,
+    core::PartitionFunctionFactory bucketFunctionFactory,
+    const std::vector<std::string>& sortingKeys,
+    const std::string& rowCountColumnName) {
+  const auto& inputType = planNode_->outputType();
+  auto [keys, sortOrders] = parseOrderByClauses(sortingKeys, inputType, pool_);
+  auto outputType =
+      ROW({rowCountColumnName, "fragments", "commitcontext"},
+          {BIGINT(), VARBINARY(), VARBINARY()});
+  planNode_ = std::make_shared<core::TableWriteNode>(
+      nextPlanNodeId(),
+      inputType,
+      columnNames,
+      insertHandle,
+      outputType,
+      planNode_,
+      numBuckets,
+      std::move(bucketFunctionFactory),
+      keys,
+      sortOrders);
+  return *this;
+}
+
 namespace {
 
 std::string throwAggregateFunctionDoesntExist(const std::string& name) {
@@ -810,7 +851,7 @@ PlanBuilder& PlanBuilder::partitionedOutput(
       nextPlanNodeId(),
       exprs(keys),
       numPartitions,
-      false,
+      core::PartitionedOutputNode::Kind::kPartitioned,
       replicateNullsAndAny,
       std::move(partitionFunctionFactory),
       outputType,
@@ -828,6 +869,30 @@ PlanBuilder& PlanBuilder::partitionedOutputBroadcast(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::partitionedOutputArbitrary(
+    const std::vector<std::string>& outputLayout) {
+  auto outputType = outputLayout.empty()
+      ? planNode_->outputType()
+      : extract(planNode_->outputType(), outputLayout);
+  planNode_ = core::PartitionedOutputNode::arbitrary(
+      nextPlanNodeId(), outputType, planNode_);
+  return *this;
+}
+
+PlanBuilder& PlanBuilder::sortShuffleWrite(
+    const std::vector<std::string>& keys,
+    int numPartitions,
+    const std::string& path) {
+  planNode_ = std::make_shared<core::SortShuffleWriteNode>(
+      nextPlanNodeId(),
+      exprs(keys),
+      numPartitions,
+      createPartitionFunctionFactory(planNode_->outputType(), keys),
+      path,
+      planNode_);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::localPartition(
     const std::vector<std::string>& keys,
     const std::vector<core::PlanNodePtr>& sources) {
@@ -1192,6 +1257,17 @@ bool equalSortOrderList(
 
 PlanBuilder& PlanBuilder::window(
     const std::vector<std::string>& windowFunctions) {
+  return window(windowFunctions, false);
+}
+
+PlanBuilder& PlanBuilder::streamingWindow(
+    const std::vector<std::string>& windowFunctions) {
+  return window(windowFunctions, true);
+}
+
+PlanBuilder& PlanBuilder::window(
+    const std::vector<std::string>& windowFunctions,
+    bool inputsSorted) {
   VELOX_CHECK_GT(
       windowFunctions.size(),
       0,
@@ -1270,6 +1346,7 @@ PlanBuilder& PlanBuilder::window(
       sortingOrders,
       windowNames,
       windowNodeFunctions,
+      inputsSorted,
       planNode_);
   return *this;
 }
@@ -151,10 +151,14 @@ class PlanBuilder {
   /// and scale factor.
   /// @param columnNames The columns to be returned from that table.
   /// @param scaleFactor The TPC-H scale factor.
+  /// @param filter Optional SQL filter over the columns of the table, which
+  /// the connector applies to the generated rows. The columns need not be in
+  /// 'columnNames'.
   PlanBuilder& tableScan(
       tpch::Table table,
       std::vector<std::string>&& columnNames,
-      double scaleFactor = 1);
+      double scaleFactor = 1,
+      const std::string& filter = "");
 
   /// Add a ValuesNode using specified data.
   ///
@@ -166,6 +170,14 @@ class PlanBuilder {
       const std::vector<RowVectorPtr>& values,
       bool parallelizable = false);
 
+  /// Add an ArrowStreamNode that reads 'arrowStream'.
+  ///
+  /// @param outputType The type of the batches of the stream.
+  /// @param arrowStream The stream to read. Its deleter releases the stream.
+  PlanBuilder& arrowStream(
+      const RowTypePtr& outputType,
+      std::shared_ptr<ArrowArrayStream> arrowStream);
+
   /// Add an ExchangeNode.
   ///
   /// Use capturePlanNodeId method to capture the node ID needed for adding
@@ -248,6 +260,27 @@ class PlanBuilder {
       const std::shared_ptr<core::InsertTableHandle>& insertHandle,
       const std::string& rowCountColumnName = "rowCount");
 
+  /// Add a TableWriteNode writing 'numBuckets' files sorted on 'sortingKeys'
+  /// assuming that input columns names match column names in the target
+  /// table.
+  ///
+  /// @param columnNames A subset of input columns to write.
+  /// @param insertHandle Connector-specific table handle.
+  /// @param numBuckets Number of bucket files. 0 if not bucketed.
+  /// @param bucketFunctionFactory Makes the function that assigns the rows to
+  /// buckets. The key channels of the function refer to 'columnNames'.
+  /// @param sortingKeys Columns to sort the rows of each file on, with
+  /// optional sort order, e.g. {"a", "b DESC NULLS FIRST"}.
+  /// @param rowCountColumnName The name of the output column containing the
+  /// number of rows written.
+  PlanBuilder& tableWrite(
+      const std::vector<std::string>& columnNames,
+      const std::shared_ptr<core::InsertTableHandle>& insertHandle,
+      int32_t numBuckets,
+      core::PartitionFunctionFactory bucketFunctionFactory,
+      const std::vector<std::string>& sortingKeys,
+      const std::string& rowCountColumnName = "rowCount");
+
   /// Add an AggregationNode representing partial aggregation with the
   /// specified grouping keys, aggregates and optional masks.
   ///
@@ -533,6 +566,28 @@ class PlanBuilder {
   PlanBuilder& partitionedOutputBroadcast(
       const std::vector<std::string>& outputLayout = {});
 
+  /// Add a PartitionedOutputNode that gives each page of the input data to
+  /// any one destination, the first that asks for data.
+  ///
+  /// @param outputLayout Optional output layout in case it is different then
+  /// the input. See partitionedOutputBroadcast().
+  PlanBuilder& partitionedOutputArbitrary(
+      const std::vector<std::string>& outputLayout = {});
+
+  /// Add a SortShuffleWriteNode that writes the input to files at 'path'
+  /// sorted by partition instead of to output buffers.
+  ///
+  /// @param keys Partitioning keys. May be empty, in which case all input
+  /// will be placed in a single partition.
+  /// @param numPartitions Number of partitions. Keys must not be empty if
+  /// greater than 1.
+  /// @param path The data and index files are '<path>.data' and
+  /// '<path>.index'.
+  PlanBuilder& sortShuffleWrite(
+      const std::vector<std::string>& keys,
+      int numPartitions,
+      const std::string& path);
+
   /// Add a LocalPartitionNode to hash-partition the input on the specified
   /// keys using exec::HashPartitionFunction. Number of partitions is determined
   /// at runtime based on parallelism of the downstream pipeline.
@@ -654,6 +709,11 @@ class PlanBuilder {
   ///  rows between a + 10 preceding and 10 following)"
   PlanBuilder& window(const std::vector<std::string>& windowFunctions);
 
+  /// Adds a WindowNode like window() for input in which the rows of each
+  /// partition arrive together, ordered by the ORDER BY keys. The partitions
+  /// are processed as they arrive, without buffering the whole input.
+  PlanBuilder& streamingWindow(const std::vector<std::string>& windowFunctions);
+
   /// Stores the latest plan node ID into the specified variable. Useful for
   /// capturing IDs of the leaf plan nodes (table scans, exchanges, etc.) to use
   /// when adding splits at runtime.
@@ -731,6 +791,10 @@ class PlanBuilder {
       core::AggregationNode::Step step,
       const core::AggregationNode* partialAggNode);
 
+  PlanBuilder& window(
+      const std::vector<std::string>& windowFunctions,
+      bool inputsSorted);
+
   struct ExpressionsAndNames {
     std::vector<std::shared_ptr<const core::CallTypedExpr>> expressions;
     std::vector<std::string> names;
@@ -121,8 +121,12 @@ TpchPlan TpchQueryBuilder::getQueryPlan(int queryId) const {
   switch (queryId) {
     case 1:
       return getQ1Plan();
+    case 2:
+      return getQ2Plan();
     case 3:
       return getQ3Plan();
+    case 4:
+      return getQ4Plan();
     case 5:
       return getQ5Plan();
     case 6:
@@ -135,6 +139,8 @@ TpchPlan TpchQueryBuilder::getQueryPlan(int queryId) const {
       return getQ9Plan();
     case 10:
       return getQ10Plan();
+    case 11:
+      return getQ11Plan();
     case 12:
       return getQ12Plan();
     case 13:
@@ -145,10 +151,16 @@ TpchPlan TpchQueryBuilder::getQueryPlan(int queryId) const {
       return getQ15Plan();
     case 16:
       return getQ16Plan();
+    case 17:
+      return getQ17Plan();
     case 18:
       return getQ18Plan();
     case 19:
       return getQ19Plan();
+    case 20:
+      return getQ20Plan();
+    case 21:
+      return getQ21Plan();
     case 22:
       return getQ22Plan();
     default:
@@ -209,6 +221,203 @@ TpchPlan TpchQueryBuilder::getQ1Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ2Plan() const {
+  std::vector<std::string> partColumns = {
+      "p_partkey", "p_mfgr", "p_size", "p_type"};
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey",
+      "s_name",
+      "s_address",
+      "s_nationkey",
+      "s_phone",
+      "s_acctbal",
+      "s_comment"};
+  std::vector<std::string> supplierColumnsSubQuery = {
+      "s_suppkey", "s_nationkey"};
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_supplycost"};
+  std::vector<std::string> nationColumns = {
+      "n_nationkey", "n_name", "n_regionkey"};
+  std::vector<std::string> nationColumnsSubQuery = {
+      "n_nationkey", "n_regionkey"};
+  std::vector<std::string> regionColumns = {"r_regionkey", "r_name"};
+
+  const auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto supplierSelectedRowTypeSubQuery =
+      getRowType(kSupplier, supplierColumnsSubQuery);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  const auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto nationSelectedRowTypeSubQuery =
+      getRowType(kNation, nationColumnsSubQuery);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  const auto regionSelectedRowType = getRowType(kRegion, regionColumns);
+  const auto& regionFileColumns = getFileColumnNames(kRegion);
+
+  const std::string regionNameFilter = "r_name = 'EUROPE'";
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId supplierScanNodeIdSubQuery;
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId partsuppScanNodeIdSubQuery;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId nationScanNodeIdSubQuery;
+  core::PlanNodeId regionScanNodeId;
+  core::PlanNodeId regionScanNodeIdSubQuery;
+
+  // The correlated subquery is decorrelated into the minimum supply cost in
+  // Europe for each part.
+  auto europeanNationsSubQuery =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kNation, nationSelectedRowTypeSubQuery, nationFileColumns)
+          .capturePlanNodeId(nationScanNodeIdSubQuery)
+          .hashJoin(
+              {"n_regionkey"},
+              {"r_regionkey"},
+              PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kRegion,
+                      regionSelectedRowType,
+                      regionFileColumns,
+                      {regionNameFilter})
+                  .capturePlanNodeId(regionScanNodeIdSubQuery)
+                  .planNode(),
+              "",
+              {"n_nationkey"})
+          .planNode();
+
+  auto europeanSuppliersSubQuery =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kSupplier, supplierSelectedRowTypeSubQuery, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeIdSubQuery)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              europeanNationsSubQuery,
+              "",
+              {"s_suppkey"})
+          .planNode();
+
+  auto minSupplyCost =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeIdSubQuery)
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              europeanSuppliersSubQuery,
+              "",
+              {"ps_partkey", "ps_supplycost"})
+          .partialAggregation(
+              {"ps_partkey"}, {"min(ps_supplycost) AS min_supplycost"})
+          .localPartition({"ps_partkey"})
+          .finalAggregation()
+          .project({"ps_partkey AS min_partkey", "min_supplycost"})
+          .planNode();
+
+  auto europeanNations =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+          .capturePlanNodeId(nationScanNodeId)
+          .hashJoin(
+              {"n_regionkey"},
+              {"r_regionkey"},
+              PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kRegion,
+                      regionSelectedRowType,
+                      regionFileColumns,
+                      {regionNameFilter})
+                  .capturePlanNodeId(regionScanNodeId)
+                  .planNode(),
+              "",
+              {"n_nationkey", "n_name"})
+          .planNode();
+
+  auto europeanSuppliers =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              europeanNations,
+              "",
+              {"s_suppkey",
+               "s_name",
+               "s_address",
+               "s_phone",
+               "s_acctbal",
+               "s_comment",
+               "n_name"})
+          .planNode();
+
+  auto part = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {"p_size = 15"},
+                      "p_type like '%BRASS'")
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"ps_partkey", "ps_suppkey", "ps_supplycost", "p_mfgr"})
+          .hashJoin(
+              {"ps_partkey", "ps_supplycost"},
+              {"min_partkey", "min_supplycost"},
+              minSupplyCost,
+              "",
+              {"ps_partkey", "ps_suppkey", "p_mfgr"})
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              europeanSuppliers,
+              "",
+              {"s_acctbal",
+               "s_name",
+               "n_name",
+               "ps_partkey",
+               "p_mfgr",
+               "s_address",
+               "s_phone",
+               "s_comment"})
+          .localPartition({})
+          .orderBy({"s_acctbal DESC", "n_name", "s_name", "ps_partkey"}, false)
+          .limit(0, 100, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[supplierScanNodeIdSubQuery] = getTableFilePaths(kSupplier);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partsuppScanNodeIdSubQuery] = getTableFilePaths(kPartsupp);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[nationScanNodeIdSubQuery] = getTableFilePaths(kNation);
+  context.dataFiles[regionScanNodeId] = getTableFilePaths(kRegion);
+  context.dataFiles[regionScanNodeIdSubQuery] = getTableFilePaths(kRegion);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ3Plan() const {
   std::vector<std::string> lineitemColumns = {
       "l_shipdate", "l_orderkey", "l_extendedprice", "l_discount"};
@@ -297,6 +506,64 @@ TpchPlan TpchQueryBuilder::getQ3Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ4Plan() const {
+  std::vector<std::string> ordersColumns = {
+      "o_orderkey", "o_orderdate", "o_orderpriority"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey", "l_commitdate", "l_receiptdate"};
+
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+
+  const std::string orderDateFilter = formatDateFilter(
+      "o_orderdate", ordersSelectedRowType, "'1993-07-01'", "'1993-09-30'");
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+
+  auto lineitem = PlanBuilder(planNodeIdGenerator)
+                      .tableScan(
+                          kLineitem,
+                          lineitemSelectedRowType,
+                          lineitemFileColumns,
+                          {},
+                          "l_commitdate < l_receiptdate")
+                      .capturePlanNodeId(lineitemScanNodeId)
+                      .planNode();
+
+  // The EXISTS subquery is a semi join of orders with their late items.
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kOrders,
+                      ordersSelectedRowType,
+                      ordersFileColumns,
+                      {orderDateFilter})
+                  .capturePlanNodeId(ordersScanNodeId)
+                  .hashJoin(
+                      {"o_orderkey"},
+                      {"l_orderkey"},
+                      lineitem,
+                      "",
+                      {"o_orderpriority"},
+                      core::JoinType::kLeftSemi)
+                  .partialAggregation(
+                      {"o_orderpriority"}, {"count(0) AS order_count"})
+                  .localPartition({})
+                  .finalAggregation()
+                  .orderBy({"o_orderpriority"}, false)
+                  .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ5Plan() const {
   std::vector<std::string> customerColumns = {"c_custkey", "c_nationkey"};
   std::vector<std::string> ordersColumns = {
@@ -1030,6 +1297,103 @@ TpchPlan TpchQueryBuilder::getQ10Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ11Plan() const {
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_availqty", "ps_supplycost"};
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+
+  const auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+
+  const std::string nationNameFilter = "n_name = 'GERMANY'";
+  const std::string partValue =
+      "ps_supplycost * cast(ps_availqty as double) AS part_value";
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId partsuppScanNodeIdSubQuery;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId supplierScanNodeIdSubQuery;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId nationScanNodeIdSubQuery;
+
+  auto germanSuppliers = [&](core::PlanNodeId& supplierScanId,
+                             core::PlanNodeId& nationScanId) {
+    return PlanBuilder(planNodeIdGenerator)
+        .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+        .capturePlanNodeId(supplierScanId)
+        .hashJoin(
+            {"s_nationkey"},
+            {"n_nationkey"},
+            PlanBuilder(planNodeIdGenerator)
+                .tableScan(
+                    kNation,
+                    nationSelectedRowType,
+                    nationFileColumns,
+                    {nationNameFilter})
+                .capturePlanNodeId(nationScanId)
+                .planNode(),
+            "",
+            {"s_suppkey"})
+        .planNode();
+  };
+
+  auto threshold =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeIdSubQuery)
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              germanSuppliers(
+                  supplierScanNodeIdSubQuery, nationScanNodeIdSubQuery),
+              "",
+              {"ps_supplycost", "ps_availqty"})
+          .project({partValue})
+          .partialAggregation({}, {"sum(part_value) AS total_value"})
+          .localPartition({})
+          .finalAggregation()
+          .project({"total_value * 0.0001 AS threshold"})
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              germanSuppliers(supplierScanNodeId, nationScanNodeId),
+              "",
+              {"ps_partkey", "ps_supplycost", "ps_availqty"})
+          .project({"ps_partkey", partValue})
+          .partialAggregation({"ps_partkey"}, {"sum(part_value) AS value"})
+          .localPartition({"ps_partkey"})
+          .finalAggregation()
+          .crossJoin(threshold, {"ps_partkey", "value", "threshold"})
+          .filter("value > threshold")
+          .localPartition({})
+          .orderBy({"value DESC"}, false)
+          .project({"ps_partkey", "value"})
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partsuppScanNodeIdSubQuery] = getTableFilePaths(kPartsupp);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[supplierScanNodeIdSubQuery] = getTableFilePaths(kSupplier);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[nationScanNodeIdSubQuery] = getTableFilePaths(kNation);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ12Plan() const {
   std::vector<std::string> ordersColumns = {"o_orderkey", "o_orderpriority"};
   std::vector<std::string> lineitemColumns = {
@@ -1381,6 +1745,88 @@ TpchPlan TpchQueryBuilder::getQ16Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ17Plan() const {
+  std::vector<std::string> lineitemColumns = {
+      "l_partkey", "l_quantity", "l_extendedprice"};
+  std::vector<std::string> partColumns = {
+      "p_partkey", "p_brand", "p_container"};
+
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  const auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+
+  const std::vector<std::string> partFilters = {
+      "p_brand = 'Brand#23'", "p_container = 'MED BOX'"};
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId lineitemScanNodeIdSubQuery;
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId partScanNodeIdSubQuery;
+
+  // The correlated subquery is decorrelated into the average quantity of
+  // each of the selected parts.
+  auto quantityThreshold =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kLineitem, lineitemSelectedRowType, lineitemFileColumns)
+          .capturePlanNodeId(lineitemScanNodeIdSubQuery)
+          .hashJoin(
+              {"l_partkey"},
+              {"p_partkey"},
+              PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kPart, partSelectedRowType, partFileColumns, partFilters)
+                  .capturePlanNodeId(partScanNodeIdSubQuery)
+                  .planNode(),
+              "",
+              {"l_partkey", "l_quantity"},
+              core::JoinType::kLeftSemi)
+          .partialAggregation(
+              {"l_partkey"}, {"avg(l_quantity) AS avg_quantity"})
+          .localPartition({"l_partkey"})
+          .finalAggregation()
+          .project(
+              {"l_partkey AS avg_partkey",
+               "0.2 * avg_quantity AS quantity_threshold"})
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kLineitem, lineitemSelectedRowType, lineitemFileColumns)
+          .capturePlanNodeId(lineitemScanNodeId)
+          .hashJoin(
+              {"l_partkey"},
+              {"p_partkey"},
+              PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kPart, partSelectedRowType, partFileColumns, partFilters)
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode(),
+              "",
+              {"l_partkey", "l_quantity", "l_extendedprice"})
+          .hashJoin(
+              {"l_partkey"},
+              {"avg_partkey"},
+              quantityThreshold,
+              "l_quantity < quantity_threshold",
+              {"l_extendedprice"})
+          .partialAggregation({}, {"sum(l_extendedprice) AS total_price"})
+          .localPartition({})
+          .finalAggregation()
+          .project({"total_price / 7.0 AS avg_yearly"})
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[lineitemScanNodeIdSubQuery] = getTableFilePaths(kLineitem);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[partScanNodeIdSubQuery] = getTableFilePaths(kPart);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ18Plan() const {
   std::vector<std::string> lineitemColumns = {"l_orderkey", "l_quantity"};
   std::vector<std::string> ordersColumns = {
@@ -1531,6 +1977,265 @@ TpchPlan TpchQueryBuilder::getQ19Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ20Plan() const {
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey", "s_name", "s_address", "s_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_availqty"};
+  std::vector<std::string> partColumns = {"p_partkey", "p_name"};
+  std::vector<std::string> lineitemColumns = {
+      "l_partkey", "l_suppkey", "l_quantity", "l_shipdate"};
+
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  const auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  const auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+
+  const std::string shipDateFilter = formatDateFilter(
+      "l_shipdate", lineitemSelectedRowType, "'1994-01-01'", "'1994-12-31'");
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+
+  // The correlated subquery is decorrelated into the quantity shipped in
+  // 1994 for each part and supplier.
+  auto shippedQuantity =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {shipDateFilter})
+          .capturePlanNodeId(lineitemScanNodeId)
+          .partialAggregation(
+              {"l_partkey", "l_suppkey"}, {"sum(l_quantity) AS quantity"})
+          .localPartition({"l_partkey", "l_suppkey"})
+          .finalAggregation()
+          .project(
+              {"l_partkey",
+               "l_suppkey",
+               "0.5 * quantity AS quantity_threshold"})
+          .planNode();
+
+  auto forestParts = PlanBuilder(planNodeIdGenerator)
+                         .tableScan(
+                             kPart,
+                             partSelectedRowType,
+                             partFileColumns,
+                             {},
+                             "p_name like 'forest%'")
+                         .capturePlanNodeId(partScanNodeId)
+                         .planNode();
+
+  auto excessSuppliers =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              forestParts,
+              "",
+              {"ps_partkey", "ps_suppkey", "ps_availqty"},
+              core::JoinType::kLeftSemi)
+          .hashJoin(
+              {"ps_partkey", "ps_suppkey"},
+              {"l_partkey", "l_suppkey"},
+              shippedQuantity,
+              "cast(ps_availqty as double) > quantity_threshold",
+              {"ps_suppkey"})
+          .planNode();
+
+  auto canadianNation = PlanBuilder(planNodeIdGenerator)
+                            .tableScan(
+                                kNation,
+                                nationSelectedRowType,
+                                nationFileColumns,
+                                {"n_name = 'CANADA'"})
+                            .capturePlanNodeId(nationScanNodeId)
+                            .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              canadianNation,
+              "",
+              {"s_suppkey", "s_name", "s_address"})
+          .hashJoin(
+              {"s_suppkey"},
+              {"ps_suppkey"},
+              excessSuppliers,
+              "",
+              {"s_name", "s_address"},
+              core::JoinType::kLeftSemi)
+          .localPartition({})
+          .orderBy({"s_name"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ21Plan() const {
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey", "s_name", "s_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+  std::vector<std::string> ordersColumns = {"o_orderkey", "o_orderstatus"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey", "l_suppkey", "l_commitdate", "l_receiptdate"};
+  std::vector<std::string> lineitemColumnsNoDates = {
+      "l_orderkey", "l_suppkey"};
+
+  const auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto lineitemSelectedRowTypeNoDates =
+      getRowType(kLineitem, lineitemColumnsNoDates);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+
+  const std::string lateFilter = "l_receiptdate > l_commitdate";
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId lineitemScanNodeIdExists;
+  core::PlanNodeId lineitemScanNodeIdNotExists;
+
+  auto saudiSuppliers =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kNation,
+                      nationSelectedRowType,
+                      nationFileColumns,
+                      {"n_name = 'SAUDI ARABIA'"})
+                  .capturePlanNodeId(nationScanNodeId)
+                  .planNode(),
+              "",
+              {"s_suppkey", "s_name"})
+          .planNode();
+
+  auto failedOrders = PlanBuilder(planNodeIdGenerator)
+                          .tableScan(
+                              kOrders,
+                              ordersSelectedRowType,
+                              ordersFileColumns,
+                              {"o_orderstatus = 'F'"})
+                          .capturePlanNodeId(ordersScanNodeId)
+                          .planNode();
+
+  // The items of the EXISTS subquery: any item of the order.
+  auto otherItems =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem, lineitemSelectedRowTypeNoDates, lineitemFileColumns)
+          .capturePlanNodeId(lineitemScanNodeIdExists)
+          .project({"l_orderkey AS l2_orderkey", "l_suppkey AS l2_suppkey"})
+          .planNode();
+
+  // The items of the NOT EXISTS subquery: the late items of the order.
+  auto otherLateItems =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {},
+              lateFilter)
+          .capturePlanNodeId(lineitemScanNodeIdNotExists)
+          .project({"l_orderkey AS l3_orderkey", "l_suppkey AS l3_suppkey"})
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {},
+              lateFilter)
+          .capturePlanNodeId(lineitemScanNodeId)
+          .hashJoin(
+              {"l_suppkey"},
+              {"s_suppkey"},
+              saudiSuppliers,
+              "",
+              {"l_orderkey", "l_suppkey", "s_name"})
+          .hashJoin(
+              {"l_orderkey"},
+              {"o_orderkey"},
+              failedOrders,
+              "",
+              {"l_orderkey", "l_suppkey", "s_name"})
+          .hashJoin(
+              {"l_orderkey"},
+              {"l2_orderkey"},
+              otherItems,
+              "l2_suppkey <> l_suppkey",
+              {"l_orderkey", "l_suppkey", "s_name"},
+              core::JoinType::kLeftSemi)
+          // The order keys are not null, so the null-aware anti join gives
+          // the result of NOT EXISTS.
+          .hashJoin(
+              {"l_orderkey"},
+              {"l3_orderkey"},
+              otherLateItems,
+              "l3_suppkey <> l_suppkey",
+              {"s_name"},
+              core::JoinType::kNullAwareAnti)
+          .partialAggregation({"s_name"}, {"count(0) AS numwait"})
+          .localPartition({})
+          .finalAggregation()
+          .orderBy({"numwait DESC", "s_name"}, false)
+          .limit(0, 100, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[lineitemScanNodeIdExists] = getTableFilePaths(kLineitem);
+  context.dataFiles[lineitemScanNodeIdNotExists] =
+      getTableFilePaths(kLineitem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ22Plan() const {
   std::vector<std::string> ordersColumns = {"o_custkey"};
   std::vector<std::string> customerColumns = {"c_acctbal", "c_phone"};
@@ -15,6 +15,9 @@
  */
 #pragma once
 
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include "velox/experimental/codegen/compiler_utils/Compiler.h"
 #include "velox/experimental/codegen/compiler_utils/CompilerOptions.h"
 #include "velox/experimental/codegen/library_loader/NativeLibraryLoader.h"
@@ -45,7 +48,49 @@ class CodeManager {
     return loader_;
   }
 
+  /// Compiles 'cppContent' and links it into a dynamic library. The libraries
+  /// are cached for the life of the process, keyed by the generated source
+  /// and the compiler settings, so that a plan with the same compiled
+  /// expressions reuses the library built for the first one instead of
+  /// running the compiler again.
+  std::filesystem::path compileAndLink(const std::string& cppContent) {
+    auto& options = compiler_.compilerOptions();
+    const auto key = fmt::format(
+        "{}\n{}\n{}",
+        options.compilerPath.string(),
+        options.optimizationLevel,
+        cppContent);
+    {
+      std::lock_guard<std::mutex> l(cacheMutex());
+      auto it = libraryCache().find(key);
+      if (it != libraryCache().end()) {
+        return it->second;
+      }
+    }
+    auto object = compiler_.compileString({}, cppContent);
+    auto library = compiler_.link({}, {object});
+    std::lock_guard<std::mutex> l(cacheMutex());
+    return libraryCache().emplace(key, library).first->second;
+  }
+
+  /// Returns the number of dynamic libraries cached by compileAndLink().
+  static size_t numCachedLibraries() {
+    std::lock_guard<std::mutex> l(cacheMutex());
+    return libraryCache().size();
+  }
+
  private:
+  static std::mutex& cacheMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::unordered_map<std::string, std::filesystem::path>&
+  libraryCache() {
+    static std::unordered_map<std::string, std::filesystem::path> cache;
+    return cache;
+  }
+
   Compiler compiler_;
   NativeLibraryLoader loader_;
   DefaultScopedTimer::EventSequence eventSequence_;
@@ -50,6 +50,7 @@ void CoalesceExpr::evalSpecialForm(
 
   exec::LocalDecodedVector decodedVector(context);
   for (int i = 0; i < inputs_.size(); i++) {
+    loadExclusiveFields(i, *activeRows, context);
     inputs_[i]->eval(*activeRows, context, result);
 
     if (!result->mayHaveNulls()) {
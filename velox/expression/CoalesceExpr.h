@@ -36,5 +36,13 @@ class CoalesceExpr : public SpecialForm {
   bool propagatesNulls() const override {
     return false;
   }
+
+  bool isConditional() const override {
+    return true;
+  }
+
+  bool loadsExclusiveFields() const override {
+    return true;
+  }
 };
 } // namespace facebook::velox::exec
@@ -171,6 +171,15 @@ void ConjunctExpr::evalSpecialForm(
 }
 
 void ConjunctExpr::maybeReorderInputs() {
+  // Evaluations between halvings of the selectivity statistics, so that the
+  // order follows changes in the data instead of the whole history.
+  constexpr int32_t kDecayInterval = 32;
+  if (++numEvalsSinceDecay_ == kDecayInterval) {
+    numEvalsSinceDecay_ = 0;
+    for (auto& selectivity : selectivity_) {
+      selectivity.decay();
+    }
+  }
   bool reorder = false;
   for (auto i = 1; i < inputs_.size(); ++i) {
     if (selectivity_[inputOrder_[i - 1]].timeToDropValue() >
@@ -243,6 +252,35 @@ void ConjunctExpr::updateResult(
       }
       return;
     default: {
+      if (!nulls) {
+        // Without nulls the rows decided by this input are found 64 at a
+        // time: false decides AND and true decides OR.
+        uint64_t* activeBits = activeRows->asMutableRange().bits();
+        auto resultValues = result->mutableRawValues<uint64_t>();
+        auto resultNulls =
+            result->mayHaveNulls() ? result->mutableRawNulls() : nullptr;
+        bits::forEachWord(
+            activeRows->begin(),
+            activeRows->end(),
+            [&](int32_t index, uint64_t mask) {
+              const uint64_t decided = activeBits[index] & mask &
+                  (isAnd_ ? ~values[index] : values[index]);
+              if (!decided) {
+                return;
+              }
+              if (isAnd_) {
+                resultValues[index] &= ~decided;
+              } else {
+                resultValues[index] |= decided;
+              }
+              if (resultNulls) {
+                resultNulls[index] |= decided;
+              }
+              activeBits[index] &= ~decided;
+            });
+        activeRows->updateBounds();
+        return;
+      }
       bits::forEachSetBit(
           activeRows->asRange().bits(),
           activeRows->begin(),
@@ -76,6 +76,8 @@ class ConjunctExpr : public SpecialForm {
   BufferPtr tempNulls_;
   bool reorderEnabledChecked_ = false;
   bool reorderEnabled_;
+  // Number of evaluations since 'selectivity_' was last decayed.
+  int32_t numEvalsSinceDecay_{0};
   std::vector<SelectivityInfo> selectivity_;
   std::vector<int32_t> inputOrder_;
 };
@@ -49,6 +49,10 @@ EvalCtx::EvalCtx(core::ExecCtx* execCtx)
   VELOX_CHECK_NOT_NULL(execCtx);
 }
 
+EvalCtx::~EvalCtx() {
+  releaseErrors(errors_);
+}
+
 VectorPtr EvalCtx::applyWrapToPeeledResult(
     const TypePtr& outputType,
     VectorPtr peeledResult,
@@ -122,6 +126,18 @@ void EvalCtx::saveAndReset(
 void EvalCtx::ensureErrorsVectorSize(ErrorVectorPtr& vector, vector_size_t size)
     const {
   auto oldSize = vector ? vector->size() : 0;
+  if (!vector) {
+    vector = std::static_pointer_cast<ErrorVector>(execCtx_->getErrorVector());
+    if (vector) {
+      // Drops the errors of the evaluation that released 'vector'.
+      auto* rawValues = vector->mutableRawValues();
+      for (auto i = 0; i < vector->size(); ++i) {
+        rawValues[i].reset();
+      }
+      vector->resize(size, false);
+      oldSize = 0;
+    }
+  }
   if (!vector) {
     vector = std::make_shared<ErrorVector>(
         pool(),
@@ -144,6 +160,14 @@ void EvalCtx::ensureErrorsVectorSize(ErrorVectorPtr& vector, vector_size_t size)
   }
 }
 
+void EvalCtx::releaseErrors(ErrorVectorPtr& errors) const {
+  // The values are reset in place on reuse, so they must not be shared.
+  if (errors && errors->values()->unique()) {
+    execCtx_->releaseErrorVector(std::move(errors));
+  }
+  errors = nullptr;
+}
+
 void EvalCtx::addError(
     vector_size_t index,
     const std::exception_ptr& exceptionPtr,
@@ -178,6 +202,7 @@ void EvalCtx::restore(ScopedContextSaver& saver) {
       }
     });
   }
+  releaseErrors(errors_);
   errors_ = std::move(saver.errors);
   wrap_ = std::move(saver.wrap);
   wrapNulls_ = std::move(saver.wrapNulls);
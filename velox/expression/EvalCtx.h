@@ -41,6 +41,9 @@ class EvalCtx {
   /// For testing only.
   explicit EvalCtx(core::ExecCtx* FOLLY_NONNULL execCtx);
 
+  /// Returns the error vector to the ExecCtx for the next evaluation.
+  ~EvalCtx();
+
   const RowVector* FOLLY_NONNULL row() const {
     return row_;
   }
@@ -92,6 +95,11 @@ class EvalCtx {
   /// vector_size_t and return void.
   template <typename Callable>
   void applyToSelectedNoThrow(const SelectivityVector& rows, Callable func) {
+    // A sparse selection is materialized as an index array. The indices are
+    // kept on 'rows' for the other functions evaluated on the same rows.
+    if (rows.isSparse()) {
+      rows.selectedIndices();
+    }
     rows.template applyToSelected([&](auto row) INLINE_LAMBDA {
       try {
         func(row);
@@ -239,6 +247,9 @@ class EvalCtx {
   /// new elements to null.
   void ensureErrorsVectorSize(ErrorVectorPtr& vector, vector_size_t size) const;
 
+  // Returns 'errors' to the ExecCtx for reuse by ensureErrorsVectorSize().
+  void releaseErrors(ErrorVectorPtr& errors) const;
+
  private:
   core::ExecCtx* const FOLLY_NONNULL execCtx_;
   ExprSet* FOLLY_NULLABLE const exprSet_;
@@ -94,7 +94,8 @@ void mergeFields(
   }
 }
 
-// Returns true if input expression or any sub-expression is an IF, AND or OR.
+// Returns true if input expression or any sub-expression is an IF, AND, OR or
+// COALESCE.
 bool hasConditionals(Expr* expr) {
   if (expr->isConditional()) {
     return true;
@@ -474,7 +475,9 @@ void Expr::evalFlatNoNulls(
     }
   }
 
-  applyFunction(rows, context, result);
+  if (!applyFunctionWithValueMemo(rows, context, result)) {
+    applyFunction(rows, context, result);
+  }
 
   // Move constant values back to constantInputs_.
   for (int32_t i = 0; i < inputs_.size(); ++i) {
@@ -853,6 +856,7 @@ void Expr::evalEncodings(
             finalRowsHolder);
         auto* newRows = peelEncodingsResult.newRows;
         if (newRows) {
+          ++stats_.numPeeledVectors;
           VectorPtr peeledResult;
           // peelEncodings() can potentially produce an empty selectivity vector
           // if all selected values we are waiting for are nulls. So, here we
@@ -964,6 +968,7 @@ void Expr::evalWithNulls(
     if (mayHaveNulls && !distinctFields_.empty()) {
       LocalSelectivityVector nonNullHolder(context);
       if (removeSureNulls(rows, context, nonNullHolder)) {
+        ++stats_.numDefaultNullVectors;
         ScopedVarSetter noMoreNulls(context.mutableNullsPruned(), true);
         if (nonNullHolder.get()->hasSelections()) {
           evalAll(*nonNullHolder.get(), context, result);
@@ -1235,8 +1240,9 @@ void Expr::evalAll(
     }
   }
 
-  if (!tryPeelArgs ||
-      !applyFunctionWithPeeling(rows, *remainingRows, context, result)) {
+  if ((!tryPeelArgs ||
+       !applyFunctionWithPeeling(rows, *remainingRows, context, result)) &&
+      !applyFunctionWithValueMemo(*remainingRows, context, result)) {
     applyFunction(*remainingRows, context, result);
   }
 
@@ -1400,6 +1406,137 @@ bool Expr::applyFunctionWithPeeling(
   return true;
 }
 
+bool Expr::applyFunctionWithValueMemo(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  // Nulls are removed before the function is applied only for functions
+  // with default null behavior.
+  if (maxValueMemoEntries_ <= 0 || valueMemoDisabled_ || !deterministic_ ||
+      !vectorFunction_->isDefaultNullBehavior() ||
+      context.wrapEncoding() == VectorEncoding::Simple::CONSTANT) {
+    return false;
+  }
+  int32_t argIndex = -1;
+  for (auto i = 0; i < inputValues_.size(); ++i) {
+    const auto& input = inputValues_[i];
+    if (input->isConstantEncoding()) {
+      continue;
+    }
+    if (argIndex >= 0 || !input->isFlatEncoding() ||
+        !(input->type()->kind() == TypeKind::VARCHAR ||
+          input->type()->kind() == TypeKind::VARBINARY)) {
+      return false;
+    }
+    argIndex = i;
+  }
+  if (argIndex < 0) {
+    return false;
+  }
+
+  auto* pool = context.pool();
+  if (!valueMemo_) {
+    valueMemo_ = std::make_unique<ValueMemo>();
+    valueMemo_->values = std::static_pointer_cast<FlatVector<StringView>>(
+        BaseVector::create(
+            inputValues_[argIndex]->type(), maxValueMemoEntries_, pool));
+    context.exprSet()->addToMemo(this);
+  }
+  auto& memo = *valueMemo_;
+  auto* argValues =
+      inputValues_[argIndex]->asUnchecked<FlatVector<StringView>>();
+
+  // Maps each row to the position of its argument value in the memo.
+  auto indices = allocateIndices(rows.end(), pool);
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  const bool full = !rows.testSelected([&](vector_size_t row) {
+    const auto value = argValues->valueAt(row);
+    auto it = memo.indices.find(value);
+    if (it != memo.indices.end()) {
+      rawIndices[row] = it->second;
+      return true;
+    }
+    if (memo.size == maxValueMemoEntries_) {
+      return false;
+    }
+    const auto index = memo.size++;
+    memo.values->set(index, value);
+    memo.indices.emplace(memo.values->valueAt(index), index);
+    rawIndices[row] = index;
+    return true;
+  });
+  if (full) {
+    // Too many distinct values for the memo to pay off.
+    valueMemoDisabled_ = true;
+    valueMemo_.reset();
+    return false;
+  }
+
+  LocalSelectivityVector toEvaluateHolder(context, memo.size);
+  auto* toEvaluate = toEvaluateHolder.get();
+  toEvaluate->clearAll();
+  rows.applyToSelected([&](vector_size_t row) {
+    const auto index = rawIndices[row];
+    if (index >= memo.valid.size() || !memo.valid.isValid(index)) {
+      toEvaluate->setValid(index, true);
+    }
+  });
+  toEvaluate->updateBounds();
+
+  // Evaluates the new values as if 'rows' were a dictionary over the memo so
+  // that errors are reported for the rows.
+  ScopedContextSaver saver;
+  context.saveAndReset(saver, rows);
+  context.setDictionaryWrap(indices, nullptr);
+  if (toEvaluate->hasSelections()) {
+    auto rowInputs = std::move(inputValues_);
+    inputValues_.resize(rowInputs.size());
+    for (auto i = 0; i < rowInputs.size(); ++i) {
+      inputValues_[i] = i == argIndex
+          ? memo.values
+          : BaseVector::wrapInConstant(memo.size, 0, rowInputs[i]);
+    }
+    VectorPtr newResults;
+    applyFunction(*toEvaluate, context, newResults);
+    inputValues_ = std::move(rowInputs);
+    deselectErrors(context, *toEvaluate);
+
+    if (!memo.results) {
+      memo.results = BaseVector::create(type(), memo.size, pool);
+    } else {
+      // Keeps the valid results if 'results' is shared with a previous
+      // batch.
+      LocalSelectivityVector notValid(context, memo.size);
+      notValid.get()->setAll();
+      notValid.get()->deselect(memo.valid);
+      context.ensureWritable(*notValid.get(), type(), memo.results);
+      if (memo.results->size() < memo.size) {
+        memo.results->resize(memo.size);
+      }
+    }
+    memo.results->copy(newResults.get(), *toEvaluate, nullptr);
+    memo.valid.select(*toEvaluate);
+  }
+  auto wrappedResult =
+      context.applyWrapToPeeledResult(type(), memo.results, rows);
+  context.moveOrCopyResult(wrappedResult, rows, result);
+  return true;
+}
+
+void Expr::loadExclusiveFields(
+    int32_t index,
+    const SelectivityVector& rows,
+    EvalCtx& context) {
+  if (exclusiveFields_.empty() || exclusiveFields_[index].empty()) {
+    return;
+  }
+  // Loads for 'rows' instead of the final selection.
+  ScopedVarSetter finalSelection(context.mutableIsFinalSelection(), true);
+  for (auto* field : exclusiveFields_[index]) {
+    context.ensureFieldLoaded(field->index(context), rows);
+  }
+}
+
 void Expr::applyFunction(
     const SelectivityVector& rows,
     EvalCtx& context,
@@ -1511,6 +1648,107 @@ void Expr::appendInputsSql(std::stringstream& stream) const {
   }
 }
 
+namespace {
+// Returns 'expr' if it is a reference to an input column, nullptr otherwise.
+FieldReference* asInputField(Expr* expr) {
+  auto* field = dynamic_cast<FieldReference*>(expr);
+  return field && field->inputs().empty() ? field : nullptr;
+}
+
+// Counts the parents of each distinct sub-expression of 'expr' and the
+// references to each input column of 'expr', by column name.
+void countReferences(
+    Expr* expr,
+    std::unordered_map<Expr*, int32_t>& numParents,
+    std::unordered_map<std::string, int32_t>& numFieldReferences) {
+  if (auto* field = asInputField(expr)) {
+    ++numFieldReferences[field->field()];
+    return;
+  }
+  if (numParents[expr]++ > 0) {
+    return;
+  }
+  if (expr->inputs().empty()) {
+    // A lambda references its captures without having inputs.
+    for (auto* field : expr->distinctFields()) {
+      ++numFieldReferences[field->field()];
+    }
+  }
+  for (const auto& input : expr->inputs()) {
+    countReferences(input.get(), numParents, numFieldReferences);
+  }
+}
+
+// Adds the input columns of 'expr' to 'fields' and counts their references
+// in 'numFieldReferences'. Returns false if a sub-expression has more than
+// one parent, i.e. may also be evaluated on rows other than those of 'expr'.
+bool collectFields(
+    Expr* expr,
+    const std::unordered_map<Expr*, int32_t>& numParents,
+    std::unordered_map<std::string, int32_t>& numFieldReferences,
+    std::vector<FieldReference*>& fields) {
+  if (auto* field = asInputField(expr)) {
+    if (numFieldReferences[field->field()]++ == 0) {
+      fields.push_back(field);
+    }
+    return true;
+  }
+  if (numParents.at(expr) > 1) {
+    return false;
+  }
+  if (expr->inputs().empty()) {
+    for (auto* field : expr->distinctFields()) {
+      if (numFieldReferences[field->field()]++ == 0) {
+        fields.push_back(field);
+      }
+    }
+  }
+  for (const auto& input : expr->inputs()) {
+    if (!collectFields(input.get(), numParents, numFieldReferences, fields)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Sets the exclusive fields of the expressions in 'expr' that load them. An
+// expression evaluated more than once per batch, e.g. a common
+// sub-expression, could evaluate its inputs on rows not loaded before, so
+// it and its sub-expressions load for their final selection as usual.
+void setExclusiveFields(
+    Expr* expr,
+    const std::unordered_map<Expr*, int32_t>& numParents,
+    const std::unordered_map<std::string, int32_t>& numFieldReferences,
+    std::unordered_set<Expr*>& visited) {
+  if (asInputField(expr) || numParents.at(expr) > 1 ||
+      !visited.insert(expr).second) {
+    return;
+  }
+  const auto& inputs = expr->inputs();
+  if (expr->loadsExclusiveFields()) {
+    std::vector<std::vector<FieldReference*>> exclusiveFields(inputs.size());
+    for (auto i = 0; i < inputs.size(); ++i) {
+      std::unordered_map<std::string, int32_t> numInputReferences;
+      std::vector<FieldReference*> fields;
+      if (!collectFields(
+              inputs[i].get(), numParents, numInputReferences, fields)) {
+        continue;
+      }
+      for (auto* field : fields) {
+        if (numInputReferences[field->field()] ==
+            numFieldReferences.at(field->field())) {
+          exclusiveFields[i].push_back(field);
+        }
+      }
+    }
+    expr->setExclusiveFields(std::move(exclusiveFields));
+  }
+  for (const auto& input : inputs) {
+    setExclusiveFields(input.get(), numParents, numFieldReferences, visited);
+  }
+}
+} // namespace
+
 ExprSet::ExprSet(
     const std::vector<core::TypedExprPtr>& sources,
     core::ExecCtx* execCtx,
@@ -1522,6 +1760,16 @@ ExprSet::ExprSet(
     mergeFields(
         distinctFields_, multiplyReferencedFields_, expr->distinctFields());
   }
+
+  std::unordered_map<Expr*, int32_t> numParents;
+  std::unordered_map<std::string, int32_t> numFieldReferences;
+  for (auto& expr : exprs_) {
+    countReferences(expr.get(), numParents, numFieldReferences);
+  }
+  std::unordered_set<Expr*> visited;
+  for (auto& expr : exprs_) {
+    setExclusiveFields(expr.get(), numParents, numFieldReferences, visited);
+  }
 }
 
 namespace {
@@ -1555,23 +1803,30 @@ std::string makeUuid() {
 ExprSet::~ExprSet() {
   exprSetListeners().withRLock([&](auto& listeners) {
     if (!listeners.empty()) {
-      std::unordered_map<std::string, exec::ExprStats> stats;
-      std::unordered_set<const exec::Expr*> uniqueExprs;
       std::vector<std::string> sqls;
       for (const auto& expr : exprs()) {
         sqls.emplace_back(expr->toSql());
-        addStats(*expr, stats, uniqueExprs);
       }
 
       auto uuid = makeUuid();
+      auto exprStats = stats();
       for (const auto& listener : listeners) {
         listener->onCompletion(
-            uuid, {stats, sqls, execCtx()->queryCtx()->queryId()});
+            uuid, {exprStats, sqls, execCtx()->queryCtx()->queryId()});
       }
     }
   });
 }
 
+std::unordered_map<std::string, exec::ExprStats> ExprSet::stats() const {
+  std::unordered_map<std::string, exec::ExprStats> stats;
+  std::unordered_set<const exec::Expr*> uniqueExprs;
+  for (const auto& expr : exprs()) {
+    addStats(*expr, stats, uniqueExprs);
+  }
+  return stats;
+}
+
 std::string ExprSet::toString(bool compact) const {
   std::unordered_map<const exec::Expr*, uint32_t> uniqueExprs;
   std::stringstream out;
@@ -56,18 +56,31 @@ struct ExprStats {
   /// size.
   uint64_t numProcessedVectors{0};
 
+  /// Number of vectors for which the expression was evaluated on the peeled
+  /// base vectors of dictionary or constant encoded inputs.
+  uint64_t numPeeledVectors{0};
+
+  /// Number of vectors for which the rows with null inputs were set to null
+  /// without evaluating the expression, which has default null behavior.
+  uint64_t numDefaultNullVectors{0};
+
   void add(const ExprStats& other) {
     timing.add(other.timing);
     numProcessedRows += other.numProcessedRows;
     numProcessedVectors += other.numProcessedVectors;
+    numPeeledVectors += other.numPeeledVectors;
+    numDefaultNullVectors += other.numDefaultNullVectors;
   }
 
   std::string toString() const {
     return fmt::format(
-        "timing: {}, numProcessedRows: {}, numProcessedVectors: {}",
+        "timing: {}, numProcessedRows: {}, numProcessedVectors: {}, "
+        "numPeeledVectors: {}, numDefaultNullVectors: {}",
         timing.toString(),
         numProcessedRows,
-        numProcessedVectors);
+        numProcessedVectors,
+        numPeeledVectors,
+        numDefaultNullVectors);
   }
 };
 
@@ -168,6 +181,14 @@ class Expr {
     baseDictionary_ = nullptr;
     dictionaryCache_ = nullptr;
     cachedDictionaryIndices_ = nullptr;
+    valueMemo_.reset();
+  }
+
+  // Enables remembering the results of the function of 'this' for up to
+  // 'maxEntries' distinct values of a string argument across batches. See
+  // applyFunctionWithValueMemo().
+  void setMaxValueMemoEntries(int32_t maxEntries) {
+    maxValueMemoEntries_ = maxEntries;
   }
 
   const TypePtr& type() const {
@@ -190,6 +211,20 @@ class Expr {
     return false;
   }
 
+  /// True if the expression evaluates each input on a subset of its rows,
+  /// e.g. CASE or COALESCE, and can load the lazy columns that only one input
+  /// references for just the rows of that input. See loadExclusiveFields().
+  virtual bool loadsExclusiveFields() const {
+    return false;
+  }
+
+  /// Sets the input columns that only inputs()[i] references among all the
+  /// expressions of the ExprSet, for each input i. Set by ExprSet.
+  void setExclusiveFields(
+      std::vector<std::vector<FieldReference*>> exclusiveFields) {
+    exclusiveFields_ = std::move(exclusiveFields);
+  }
+
   bool isDeterministic() const {
     return deterministic_;
   }
@@ -314,6 +349,17 @@ class Expr {
       EvalCtx& context,
       VectorPtr& result);
 
+  // Applies the function of 'this' to 'rows' if the only non-constant
+  // argument in 'inputValues_' is a flat string vector. The results are
+  // remembered by argument value across batches so that the function is
+  // called once per distinct value. Returns false if the memo does not
+  // apply or has exceeded 'maxValueMemoEntries_', in which case it is not
+  // tried again.
+  bool applyFunctionWithValueMemo(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result);
+
   // Calls the function of 'this' on arguments in
   // 'inputValues_'. Handles cases of VectorFunction and SimpleFunction.
   void applyFunction(
@@ -361,6 +407,15 @@ class Expr {
   /// reused.
   void releaseInputValues(EvalCtx& evalCtx);
 
+  /// Loads the lazy columns that only 'inputs_[index]' references for 'rows',
+  /// on which the input is about to be evaluated. Otherwise, the input would
+  /// load them for all the rows of the final selection, e.g. a rarely taken
+  /// branch of a CASE would decode its columns for the whole batch.
+  void loadExclusiveFields(
+      int32_t index,
+      const SelectivityVector& rows,
+      EvalCtx& context);
+
   /// Returns an instance of CpuWallTimer if cpu usage tracking is enabled. Null
   /// otherwise.
   std::unique_ptr<CpuWallTimer> cpuWallTimer() {
@@ -398,11 +453,15 @@ class Expr {
   // True if this and all children are deterministic.
   bool deterministic_ = true;
 
-  // True if this or a sub-expression is an IF, AND or OR.
+  // True if this or a sub-expression is an IF, AND, OR or COALESCE.
   bool hasConditionals_ = false;
 
   bool isMultiplyReferenced_ = false;
 
+  // The input columns that only 'inputs_[i]' references, for each i. Empty
+  // unless loadsExclusiveFields().
+  std::vector<std::vector<FieldReference*>> exclusiveFields_;
+
   std::vector<VectorPtr> inputValues_;
 
   // If multiply referenced or literal, these are the values.
@@ -420,6 +479,24 @@ class Expr {
   // The indices that are valid in 'dictionaryCache_'.
   std::unique_ptr<SelectivityVector> cachedDictionaryIndices_;
 
+  // Results of the function of 'this' by the value of its single string
+  // argument.
+  struct ValueMemo {
+    // Maps an argument value to its position in 'values' and 'results'.
+    folly::F14FastMap<StringView, vector_size_t> indices;
+    // The distinct argument values. The first 'size' are set.
+    std::shared_ptr<FlatVector<StringView>> values;
+    vector_size_t size{0};
+    VectorPtr results;
+    // The positions of 'results' that are set. A value for which the
+    // function failed is retried the next time it is seen.
+    SelectivityVector valid;
+  };
+
+  int32_t maxValueMemoEntries_{0};
+  bool valueMemoDisabled_{false};
+  std::unique_ptr<ValueMemo> valueMemo_;
+
   // Count of executions where this is wrapped in a dictionary so that
   // results could be cached.
   int32_t numCachableInput_{0};
@@ -518,6 +595,10 @@ class ExprSet {
   /// Otherwise, prints a tree of expressions one node per line.
   std::string toString(bool compact = true) const;
 
+  /// Returns the runtime stats of the expressions aggregated by expression
+  /// name, e.g. a function name. A common sub-expression is counted once.
+  std::unordered_map<std::string, ExprStats> stats() const;
+
  protected:
   void clearSharedSubexprs();
 
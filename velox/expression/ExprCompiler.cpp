@@ -15,6 +15,7 @@
  */
 
 #include "velox/expression/ExprCompiler.h"
+#include <folly/json.h>
 #include "velox/expression/CastExpr.h"
 #include "velox/expression/CoalesceExpr.h"
 #include "velox/expression/ConjunctExpr.h"
@@ -40,6 +41,8 @@ const char* const kTry = "try";
 const char* const kSwitch = "switch";
 const char* const kIf = "if";
 const char* const kRowConstructor = "row_constructor";
+const char* const kJsonExtractScalar = "json_extract_scalar";
+const char* const kJsonExtractScalars = "$internal$json_extract_scalars";
 
 struct ITypedExprHasher {
   size_t operator()(const ITypedExpr* expr) const {
@@ -84,6 +87,12 @@ struct Scope {
   std::vector<const ITypedExpr*> captureFieldAccesses;
   // Deduplicatable ITypedExprs. Only applies within the one scope.
   ExprDedupMap visited;
+  // Replacements for calls that are computed by a fused call shared with
+  // other calls. Only set for a top level Scope. See fuseJsonExtractions().
+  folly::F14FastMap<const ITypedExpr*, TypedExprPtr> fusedCalls;
+  // The values of the subexpressions that compiled to constants, for making
+  // an ExprTemplateCache entry. Only set for a top level Scope.
+  folly::F14FastMap<const ITypedExpr*, VectorPtr>* foldedConstants{nullptr};
 
   Scope(std::vector<std::string>&& _locals, Scope* _parent, ExprSet* _exprSet)
       : locals(_locals), parent(_parent), exprSet(_exprSet) {}
@@ -197,6 +206,8 @@ std::vector<TypePtr> getTypes(const std::vector<ExprPtr>& exprs) {
   return types;
 }
 
+std::vector<VectorPtr> getConstantInputs(const std::vector<ExprPtr>& exprs);
+
 ExprPtr getRowConstructorExpr(
     const TypePtr& type,
     std::vector<ExprPtr>&& compiledChildren,
@@ -215,6 +226,30 @@ ExprPtr getRowConstructorExpr(
       trackCpuUsage);
 }
 
+ExprPtr getJsonExtractScalarsExpr(
+    const TypePtr& type,
+    std::vector<ExprPtr>&& compiledChildren,
+    bool trackCpuUsage) {
+  // Not resolved by signature since the arity of the result depends on the
+  // number of paths.
+  auto constantInputs = getConstantInputs(compiledChildren);
+  std::vector<VectorFunctionArg> inputArgs;
+  for (auto i = 0; i < compiledChildren.size(); ++i) {
+    inputArgs.push_back({compiledChildren[i]->type(), constantInputs[i]});
+  }
+  auto func = vectorFunctionFactories().withRLock([&](auto& functionMap) {
+    auto functionIterator = functionMap.find(kJsonExtractScalars);
+    VELOX_CHECK(functionIterator != functionMap.end());
+    return functionIterator->second.factory(kJsonExtractScalars, inputArgs);
+  });
+  return std::make_shared<Expr>(
+      type,
+      std::move(compiledChildren),
+      std::move(func),
+      kJsonExtractScalars,
+      trackCpuUsage);
+}
+
 ExprPtr getSpecialForm(
     const std::string& name,
     const TypePtr& type,
@@ -266,6 +301,143 @@ ExprPtr getSpecialForm(
     return getRowConstructorExpr(
         type, std::move(compiledChildren), trackCpuUsage);
   }
+  if (name == kJsonExtractScalars) {
+    return getJsonExtractScalarsExpr(
+        type, std::move(compiledChildren), trackCpuUsage);
+  }
+  return nullptr;
+}
+
+// Returns the value of 'expr' if it is a non-null boolean constant.
+std::optional<bool> constantBool(const ExprPtr& expr) {
+  auto constant = dynamic_cast<const ConstantExpr*>(expr.get());
+  if (!constant || !constant->type()->isBoolean() ||
+      constant->value()->isNullAt(0)) {
+    return std::nullopt;
+  }
+  return constant->value()->as<ConstantVector<bool>>()->valueAt(0);
+}
+
+bool isNullConstant(const ExprPtr& expr) {
+  auto constant = dynamic_cast<const ConstantExpr*>(expr.get());
+  return constant && constant->value()->isNullAt(0);
+}
+
+ExprPtr makeConstant(variant value, memory::MemoryPool* pool) {
+  return std::make_shared<ConstantExpr>(
+      BaseVector::createConstant(std::move(value), 1, pool));
+}
+
+ExprPtr makeNullConstant(const TypePtr& type, memory::MemoryPool* pool) {
+  return std::make_shared<ConstantExpr>(
+      BaseVector::createNullConstant(type, 1, pool));
+}
+
+// Removes the constant inputs of an AND or OR that do not affect the result.
+// Returns the result if it does not depend on the non-constant inputs or if
+// a single input remains. Errors in the other inputs do not surface for rows
+// where a conjunct decides the result, so a constant false in an AND makes
+// the AND false.
+ExprPtr simplifyConjunct(
+    bool isAnd,
+    std::vector<ExprPtr>& inputs,
+    memory::MemoryPool* pool) {
+  std::vector<ExprPtr> remaining;
+  for (auto& input : inputs) {
+    auto value = constantBool(input);
+    if (!value.has_value()) {
+      remaining.push_back(input);
+    } else if (value.value() != isAnd) {
+      return makeConstant(!isAnd, pool);
+    }
+  }
+  if (remaining.empty()) {
+    return makeConstant(isAnd, pool);
+  }
+  if (remaining.size() == 1) {
+    return remaining[0];
+  }
+  inputs = std::move(remaining);
+  return nullptr;
+}
+
+// Removes the null constants of a coalesce and the inputs after the first
+// non-null constant, which are never evaluated.
+ExprPtr simplifyCoalesce(
+    const TypePtr& type,
+    std::vector<ExprPtr>& inputs,
+    memory::MemoryPool* pool) {
+  std::vector<ExprPtr> remaining;
+  for (auto& input : inputs) {
+    if (isNullConstant(input)) {
+      continue;
+    }
+    remaining.push_back(input);
+    if (dynamic_cast<const ConstantExpr*>(input.get())) {
+      break;
+    }
+  }
+  if (remaining.empty()) {
+    return makeNullConstant(type, pool);
+  }
+  if (remaining.size() == 1) {
+    return remaining[0];
+  }
+  inputs = std::move(remaining);
+  return nullptr;
+}
+
+// Removes the branches of an IF or SWITCH with a constant false or null
+// condition. A constant true condition makes its result the else and drops
+// the branches after it.
+ExprPtr simplifySwitch(
+    const TypePtr& type,
+    std::vector<ExprPtr>& inputs,
+    memory::MemoryPool* pool) {
+  const auto numBranches = inputs.size() / 2;
+  ExprPtr elseExpr = inputs.size() % 2 ? inputs.back() : nullptr;
+  std::vector<ExprPtr> remaining;
+  for (auto i = 0; i < numBranches; ++i) {
+    auto& condition = inputs[2 * i];
+    auto value = constantBool(condition);
+    if (isNullConstant(condition) || value == false) {
+      continue;
+    }
+    if (value == true) {
+      elseExpr = inputs[2 * i + 1];
+      break;
+    }
+    remaining.push_back(condition);
+    remaining.push_back(inputs[2 * i + 1]);
+  }
+  if (remaining.empty()) {
+    return elseExpr ? elseExpr : makeNullConstant(type, pool);
+  }
+  if (elseExpr) {
+    remaining.push_back(elseExpr);
+  }
+  inputs = std::move(remaining);
+  return nullptr;
+}
+
+// Applies algebraic simplifications to the special form 'name' over
+// 'inputs', after the constant inputs have been folded. Returns the
+// expression that replaces the special form if there is one. Otherwise
+// returns nullptr and may leave fewer 'inputs'.
+ExprPtr simplifySpecialForm(
+    const std::string& name,
+    const TypePtr& type,
+    std::vector<ExprPtr>& inputs,
+    memory::MemoryPool* pool) {
+  if (name == kAnd || name == kOr) {
+    return simplifyConjunct(name == kAnd, inputs, pool);
+  }
+  if (name == kCoalesce) {
+    return simplifyCoalesce(type, inputs, pool);
+  }
+  if (name == kIf || name == kSwitch) {
+    return simplifySwitch(type, inputs, pool);
+  }
   return nullptr;
 }
 
@@ -370,6 +542,21 @@ ExprPtr tryFoldIfConstant(const ExprPtr& expr, Scope* scope) {
   return expr;
 }
 
+// Records the value of 'compiled' for rewriting 'expr' into a literal if
+// 'compiled' is a constant that 'expr' was folded or simplified to.
+void recordFolded(
+    Scope* scope,
+    const ITypedExpr* expr,
+    const ExprPtr& compiled) {
+  if (!scope->foldedConstants ||
+      dynamic_cast<const core::ConstantTypedExpr*>(expr)) {
+    return;
+  }
+  if (auto constant = dynamic_cast<ConstantExpr*>(compiled.get())) {
+    (*scope->foldedConstants)[expr] = constant->value();
+  }
+}
+
 /// Returns a vector aligned with exprs vector where elements that correspond to
 /// constant expressions are set to constant values of these expressions.
 /// Elements that correspond to non-constant expressions are set to null.
@@ -393,12 +580,24 @@ ExprPtr compileExpression(
     memory::MemoryPool* pool,
     const std::unordered_set<std::string>& flatteningCandidates,
     bool enableConstantFolding) {
+  auto fused = scope->fusedCalls.find(expr.get());
+  if (fused != scope->fusedCalls.end()) {
+    return compileExpression(
+        fused->second,
+        scope,
+        config,
+        pool,
+        flatteningCandidates,
+        enableConstantFolding);
+  }
+
   ExprPtr alreadyCompiled = getAlreadyCompiled(expr.get(), &scope->visited);
   if (alreadyCompiled) {
     if (!alreadyCompiled->isMultiplyReferenced()) {
       scope->exprSet->addToReset(alreadyCompiled);
     }
     alreadyCompiled->setMultiplyReferenced();
+    recordFolded(scope, expr.get(), alreadyCompiled);
     return alreadyCompiled;
   }
 
@@ -421,6 +620,17 @@ ExprPtr compileExpression(
         trackCpuUsage,
         cast->nullOnFailure());
   } else if (auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get())) {
+    ExprPtr simplified;
+    if (enableConstantFolding) {
+      simplified = simplifySpecialForm(
+          call->name(), resultType, compiledInputs, pool);
+    }
+    if (simplified) {
+      // The result was compiled, e.g. as an input of the special form.
+      scope->visited[expr.get()] = simplified;
+      recordFolded(scope, expr.get(), simplified);
+      return simplified;
+    }
     if (auto specialForm = getSpecialForm(
             call->name(),
             resultType,
@@ -436,6 +646,7 @@ ExprPtr compileExpression(
           func,
           call->name(),
           trackCpuUsage);
+      result->setMaxValueMemoEntries(config.exprValueMemoMaxEntries());
     } else if (
         auto simpleFunctionEntry =
             SimpleFunctions().resolveFunction(call->name(), inputTypes)) {
@@ -456,6 +667,7 @@ ExprPtr compileExpression(
           std::move(func),
           call->name(),
           trackCpuUsage);
+      result->setMaxValueMemoEntries(config.exprValueMemoMaxEntries());
     } else {
       VELOX_FAIL(
           "Scalar function not registered: {} ({})",
@@ -507,6 +719,9 @@ ExprPtr compileExpression(
   auto folded =
       enableConstantFolding ? tryFoldIfConstant(result, scope) : result;
   scope->visited[expr.get()] = folded;
+  if (folded != result) {
+    recordFolded(scope, expr.get(), folded);
+  }
   return folded;
 }
 
@@ -546,6 +761,207 @@ std::unordered_set<std::string> collectFlatteningCandidates(
     return flatteningCandidates;
   });
 }
+
+// Returns the path of a json_extract_scalar call with a constant path.
+std::optional<std::string> constantJsonPath(const core::CallTypedExpr& call) {
+  if (call.name() != kJsonExtractScalar || call.inputs().size() != 2) {
+    return std::nullopt;
+  }
+  auto constant =
+      dynamic_cast<const core::ConstantTypedExpr*>(call.inputs()[1].get());
+  if (!constant || constant->type()->kind() != TypeKind::VARCHAR) {
+    return std::nullopt;
+  }
+  if (constant->hasValueVector()) {
+    const auto& vector = constant->valueVector();
+    if (vector->isNullAt(0)) {
+      return std::nullopt;
+    }
+    return vector->as<SimpleVector<StringView>>()->valueAt(0).str();
+  }
+  if (constant->value().isNull()) {
+    return std::nullopt;
+  }
+  return constant->value().value<std::string>();
+}
+
+// The json_extract_scalar calls with a constant path on one json argument.
+struct JsonExtractions {
+  // The distinct paths in order of appearance.
+  std::vector<std::string> paths;
+  // The calls and the index of their path in 'paths'.
+  std::vector<std::pair<const core::CallTypedExpr*, int32_t>> calls;
+};
+
+using JsonExtractionsMap = folly::F14FastMap<
+    const ITypedExpr*,
+    JsonExtractions,
+    ITypedExprHasher,
+    ITypedExprComparer>;
+
+void collectJsonExtractions(
+    const TypedExprPtr& expr,
+    JsonExtractionsMap& extractions) {
+  if (dynamic_cast<const core::LambdaTypedExpr*>(expr.get())) {
+    // The body is compiled in a different Scope.
+    return;
+  }
+  if (auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get())) {
+    if (auto path = constantJsonPath(*call)) {
+      auto& json = extractions[call->inputs()[0].get()];
+      auto it = std::find(json.paths.begin(), json.paths.end(), path.value());
+      json.calls.emplace_back(call, it - json.paths.begin());
+      if (it == json.paths.end()) {
+        json.paths.push_back(std::move(path.value()));
+      }
+      return;
+    }
+  }
+  for (const auto& input : expr->inputs()) {
+    collectJsonExtractions(input, extractions);
+  }
+}
+
+// Plans computing json_extract_scalar calls with different constant paths on
+// the same json in one scan of each document. The calls are replaced by field
+// accesses of one $internal$json_extract_scalars(json, path1, path2, ...)
+// call, which is then a common subexpression of the calls.
+void fuseJsonExtractions(
+    const std::vector<TypedExprPtr>& exprs,
+    Scope& scope) {
+  const bool registered =
+      vectorFunctionFactories().withRLock([](auto& functionMap) {
+        return functionMap.count(kJsonExtractScalars) > 0;
+      });
+  if (!registered) {
+    return;
+  }
+  JsonExtractionsMap extractions;
+  for (const auto& expr : exprs) {
+    collectJsonExtractions(expr, extractions);
+  }
+  for (auto& [json, extraction] : extractions) {
+    if (extraction.paths.size() < 2) {
+      continue;
+    }
+    const auto& jsonArg = extraction.calls[0].first->inputs()[0];
+    std::vector<TypedExprPtr> inputs{jsonArg};
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    for (auto i = 0; i < extraction.paths.size(); ++i) {
+      inputs.push_back(std::make_shared<core::ConstantTypedExpr>(
+          VARCHAR(), variant(extraction.paths[i])));
+      names.push_back(fmt::format("p{}", i));
+      types.push_back(VARCHAR());
+    }
+    auto fusedCall = std::make_shared<core::CallTypedExpr>(
+        ROW(std::move(names), std::move(types)),
+        std::move(inputs),
+        kJsonExtractScalars);
+    for (const auto& [call, index] : extraction.calls) {
+      scope.fusedCalls[call] = std::make_shared<core::FieldAccessTypedExpr>(
+          VARCHAR(), fusedCall, fmt::format("p{}", index));
+    }
+  }
+}
+
+// Appends to 'out' a string that is equal for two trees only if they are
+// equal, including the types of all the nodes. Returns false if 'expr' has a
+// node that has no exact string form, e.g. a constant given as a vector.
+bool appendFingerprint(const ITypedExpr& expr, std::string& out) {
+  auto appendName = [&](const char* kind, const std::string& name) {
+    out += fmt::format("{}{}:{}", kind, name.size(), name);
+  };
+  out += expr.type()->toString();
+  if (auto call = dynamic_cast<const core::CallTypedExpr*>(&expr)) {
+    appendName("call", call->name());
+  } else if (auto cast = dynamic_cast<const core::CastTypedExpr*>(&expr)) {
+    out += cast->nullOnFailure() ? "try_cast" : "cast";
+  } else if (
+      auto access = dynamic_cast<const core::FieldAccessTypedExpr*>(&expr)) {
+    appendName("field", access->name());
+  } else if (
+      auto constant = dynamic_cast<const core::ConstantTypedExpr*>(&expr)) {
+    if (constant->hasValueVector()) {
+      return false;
+    }
+    appendName("constant", folly::toJson(constant->value().serialize()));
+  } else if (
+      auto lambda = dynamic_cast<const core::LambdaTypedExpr*>(&expr)) {
+    out += "lambda" + lambda->signature()->toString();
+    if (!appendFingerprint(*lambda->body(), out)) {
+      return false;
+    }
+  } else if (
+      !dynamic_cast<const core::ConcatTypedExpr*>(&expr) &&
+      !dynamic_cast<const core::InputTypedExpr*>(&expr)) {
+    return false;
+  }
+  out += "(";
+  for (const auto& input : expr.inputs()) {
+    if (!appendFingerprint(*input, out)) {
+      return false;
+    }
+    out += ",";
+  }
+  out += ")";
+  return true;
+}
+
+std::optional<std::string> fingerprint(
+    const std::vector<TypedExprPtr>& sources) {
+  std::string out;
+  for (const auto& source : sources) {
+    if (!appendFingerprint(*source, out)) {
+      return std::nullopt;
+    }
+    out += ";";
+  }
+  return out;
+}
+
+// Returns 'expr' with the subtrees in 'foldedConstants' replaced by literals
+// of their values, which are copied into 'pool'.
+TypedExprPtr replaceFolded(
+    const TypedExprPtr& expr,
+    const folly::F14FastMap<const ITypedExpr*, VectorPtr>& foldedConstants,
+    memory::MemoryPool* pool) {
+  auto it = foldedConstants.find(expr.get());
+  if (it != foldedConstants.end()) {
+    const auto& value = it->second;
+    auto copy = BaseVector::create(value->type(), 1, pool);
+    copy->copy(value.get(), 0, 0, 1);
+    return std::make_shared<core::ConstantTypedExpr>(
+        BaseVector::wrapInConstant(1, 0, copy));
+  }
+  std::vector<TypedExprPtr> inputs;
+  bool changed = false;
+  for (const auto& input : expr->inputs()) {
+    inputs.push_back(replaceFolded(input, foldedConstants, pool));
+    changed |= inputs.back() != input;
+  }
+  if (!changed) {
+    return expr;
+  }
+  if (auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get())) {
+    return std::make_shared<core::CallTypedExpr>(
+        call->type(), std::move(inputs), call->name());
+  }
+  if (auto cast = dynamic_cast<const core::CastTypedExpr*>(expr.get())) {
+    return std::make_shared<core::CastTypedExpr>(
+        cast->type(), inputs, cast->nullOnFailure());
+  }
+  if (auto access =
+          dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get())) {
+    return std::make_shared<core::FieldAccessTypedExpr>(
+        access->type(), std::move(inputs[0]), access->name());
+  }
+  if (dynamic_cast<const core::ConcatTypedExpr*>(expr.get())) {
+    return std::make_shared<core::ConcatTypedExpr>(
+        expr->type()->asRow().names(), inputs);
+  }
+  return expr;
+}
 } // namespace
 
 std::vector<std::shared_ptr<Expr>> compileExpressions(
@@ -553,23 +969,55 @@ std::vector<std::shared_ptr<Expr>> compileExpressions(
     core::ExecCtx* execCtx,
     ExprSet* exprSet,
     bool enableConstantFolding) {
+  auto* queryCtx = execCtx->queryCtx();
+  const auto& config = queryCtx->config();
+
+  // The trees are compiled as recorded in the first compilation in the query
+  // if there was one. This only skips evaluating the folded subtrees, the
+  // Exprs are made anew.
+  std::optional<std::string> key;
+  core::ExprTemplateCache::Template folded;
+  if (enableConstantFolding && config.exprTemplateCacheEnabled()) {
+    key = fingerprint(sources);
+    if (key.has_value()) {
+      folded = queryCtx->exprTemplateCache().find(key.value());
+    }
+  }
+  const auto& toCompile = folded ? *folded : sources;
+
   Scope scope({}, nullptr, exprSet);
+  folly::F14FastMap<const ITypedExpr*, VectorPtr> foldedConstants;
+  if (key.has_value() && !folded) {
+    scope.foldedConstants = &foldedConstants;
+  }
   std::vector<std::shared_ptr<Expr>> exprs;
-  exprs.reserve(sources.size());
+  exprs.reserve(toCompile.size());
 
   // Precompute a set of function calls that support flattening. This allows to
   // lock function registry once vs. locking for each function call.
-  auto flatteningCandidates = collectFlatteningCandidates(sources);
+  auto flatteningCandidates = collectFlatteningCandidates(toCompile);
+  fuseJsonExtractions(toCompile, scope);
 
-  for (auto& source : sources) {
+  for (auto& source : toCompile) {
     exprs.push_back(compileExpression(
         source,
         &scope,
-        execCtx->queryCtx()->config(),
+        config,
         execCtx->pool(),
         flatteningCandidates,
         enableConstantFolding));
   }
+
+  if (!foldedConstants.empty()) {
+    auto& cache = queryCtx->exprTemplateCache();
+    auto* pool = cache.pool();
+    auto rewritten = std::make_shared<std::vector<TypedExprPtr>>();
+    rewritten->reserve(sources.size());
+    for (const auto& source : sources) {
+      rewritten->push_back(replaceFolded(source, foldedConstants, pool));
+    }
+    cache.insert(key.value(), std::move(rewritten));
+  }
   return exprs;
 }
 
@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <limits>
+
 #include <velox/core/QueryCtx.h>
 #include <velox/expression/Expr.h>
 #include <velox/expression/ExprToSubfieldFilter.h>
@@ -47,11 +50,41 @@ T singleValue(const VectorPtr& vector) {
   return simpleVector->valueAt(0);
 }
 
+int32_t integerWidth(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return 1;
+    case TypeKind::SMALLINT:
+      return 2;
+    case TypeKind::INTEGER:
+      return 4;
+    case TypeKind::BIGINT:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+// Returns true if casting 'from' to 'to' keeps every value distinct and in
+// order, so that a filter on the cast value can be applied to the input.
+bool isLosslessCast(const TypePtr& from, const TypePtr& to) {
+  const auto fromWidth = integerWidth(from->kind());
+  return fromWidth > 0 && fromWidth <= integerWidth(to->kind());
+}
+
+// Returns the field that is input 'index' of 'expr', looking through
+// lossless casts. The integer filters apply to all integer widths.
 const core::FieldAccessTypedExpr* asField(
     const core::ITypedExpr* expr,
     int index) {
-  return dynamic_cast<const core::FieldAccessTypedExpr*>(
-      expr->inputs()[index].get());
+  const auto* input = expr->inputs()[index].get();
+  while (auto cast = dynamic_cast<const core::CastTypedExpr*>(input)) {
+    if (!isLosslessCast(cast->inputs()[0]->type(), cast->type())) {
+      return nullptr;
+    }
+    input = cast->inputs()[0].get();
+  }
+  return dynamic_cast<const core::FieldAccessTypedExpr*>(input);
 }
 
 const core::CallTypedExpr* asCall(const core::ITypedExpr* expr) {
@@ -72,37 +105,101 @@ std::unique_ptr<T> asUniquePtr(std::unique_ptr<U> ptr) {
   return std::unique_ptr<T>(static_cast<T*>(ptr.release()));
 }
 
-std::unique_ptr<common::Filter> makeOrFilter(
-    std::unique_ptr<common::Filter> a,
-    std::unique_ptr<common::Filter> b) {
-  if (asBigintRange(a) && asBigintRange(b)) {
-    return bigintOr(
-        asUniquePtr<common::BigintRange>(std::move(a)),
-        asUniquePtr<common::BigintRange>(std::move(b)));
+// Appends the ranges of 'filter' to 'ranges'. Returns false if 'filter' is
+// not a BigintRange or BigintMultiRange.
+bool appendBigintRanges(
+    const common::Filter& filter,
+    std::vector<std::unique_ptr<common::BigintRange>>& ranges) {
+  if (auto range = dynamic_cast<const common::BigintRange*>(&filter)) {
+    ranges.emplace_back(asUniquePtr<common::BigintRange>(range->clone()));
+    return true;
   }
+  if (auto multiRange =
+          dynamic_cast<const common::BigintMultiRange*>(&filter)) {
+    for (const auto& range : multiRange->ranges()) {
+      ranges.emplace_back(asUniquePtr<common::BigintRange>(range->clone()));
+    }
+    return true;
+  }
+  return false;
+}
 
-  if (asBigintRange(a) && asBigintMultiRange(b)) {
-    const auto& ranges = asBigintMultiRange(b)->ranges();
-    std::vector<std::unique_ptr<common::BigintRange>> newRanges;
-    newRanges.emplace_back(asUniquePtr<common::BigintRange>(std::move(a)));
-    for (const auto& range : ranges) {
-      newRanges.emplace_back(asUniquePtr<common::BigintRange>(range->clone()));
+// Sorts 'ranges' and merges the ones that overlap or are adjacent, which a
+// BigintMultiRange does not allow.
+std::unique_ptr<common::Filter> combineBigintRanges(
+    std::vector<std::unique_ptr<common::BigintRange>> ranges,
+    bool nullAllowed) {
+  std::sort(ranges.begin(), ranges.end(), [](const auto& a, const auto& b) {
+    return a->lower() < b->lower();
+  });
+  std::vector<std::unique_ptr<common::BigintRange>> merged;
+  for (auto& range : ranges) {
+    if (!merged.empty()) {
+      const auto upper = merged.back()->upper();
+      if (upper == std::numeric_limits<int64_t>::max() ||
+          range->lower() <= upper + 1) {
+        merged.back() = std::make_unique<common::BigintRange>(
+            merged.back()->lower(), std::max(upper, range->upper()), false);
+        continue;
+      }
     }
+    merged.emplace_back(std::move(range));
+  }
+  if (merged.size() == 1) {
+    return std::make_unique<common::BigintRange>(
+        merged[0]->lower(), merged[0]->upper(), nullAllowed);
+  }
+  return std::make_unique<common::BigintMultiRange>(
+      std::move(merged), nullAllowed);
+}
 
-    std::sort(
-        newRanges.begin(), newRanges.end(), [](const auto& a, const auto& b) {
-          return a->lower() < b->lower();
-        });
+// Appends the filters of 'filter' to 'filters', flattening a MultiRange.
+void appendFilters(
+    std::unique_ptr<common::Filter> filter,
+    std::vector<std::unique_ptr<common::Filter>>& filters,
+    bool& nanAllowed) {
+  if (auto multiRange = dynamic_cast<common::MultiRange*>(filter.get())) {
+    nanAllowed |= multiRange->nanAllowed();
+    for (const auto& child : multiRange->filters()) {
+      filters.emplace_back(child->clone());
+    }
+    return;
+  }
+  filters.emplace_back(std::move(filter));
+}
+
+std::unique_ptr<common::Filter> makeOrFilter(
+    std::unique_ptr<common::Filter> a,
+    std::unique_ptr<common::Filter> b) {
+  const bool nullAllowed = a->testNull() || b->testNull();
 
-    return std::make_unique<common::BigintMultiRange>(
-        std::move(newRanges), false);
+  // 'x IS NULL OR <filter>' passes the values that <filter> passes and
+  // nulls. 'x IS NOT NULL OR <filter>' passes all values.
+  if (a->kind() == common::FilterKind::kIsNull) {
+    return b->clone(true);
+  }
+  if (b->kind() == common::FilterKind::kIsNull) {
+    return a->clone(true);
+  }
+  if (a->kind() == common::FilterKind::kIsNotNull ||
+      b->kind() == common::FilterKind::kIsNotNull) {
+    if (nullAllowed) {
+      return std::make_unique<common::AlwaysTrue>();
+    }
+    return isNotNull();
   }
 
-  if (asBigintMultiRange(a) && asBigintRange(b)) {
-    return makeOrFilter(std::move(b), std::move(a));
+  std::vector<std::unique_ptr<common::BigintRange>> ranges;
+  if (appendBigintRanges(*a, ranges) && appendBigintRanges(*b, ranges)) {
+    return combineBigintRanges(std::move(ranges), nullAllowed);
   }
 
-  return orFilter(std::move(a), std::move(b));
+  std::vector<std::unique_ptr<common::Filter>> filters;
+  bool nanAllowed = false;
+  appendFilters(std::move(a), filters, nanAllowed);
+  appendFilters(std::move(b), filters, nanAllowed);
+  return std::make_unique<common::MultiRange>(
+      std::move(filters), nullAllowed, nanAllowed);
 }
 
 std::unique_ptr<common::Filter> makeLessThanOrEqualFilter(
@@ -332,6 +429,38 @@ std::unique_ptr<common::Filter> makeInFilter(const core::TypedExprPtr& expr) {
   }
 }
 
+// Returns a filter for 'field LIKE pattern' if 'pattern' is a prefix
+// followed by '%' wildcards or has no wildcards.
+std::unique_ptr<common::Filter> makeLikeFilter(
+    const core::TypedExprPtr& patternExpr) {
+  auto queryCtx = core::QueryCtx::createForTest();
+  const auto pattern =
+      singleValue<StringView>(toConstant(patternExpr, queryCtx)).str();
+  const auto wildcard = pattern.find_first_of("%_");
+  if (wildcard == std::string::npos) {
+    return equal(pattern);
+  }
+  if (pattern.find_first_not_of('%', wildcard) != std::string::npos) {
+    VELOX_NYI("Unsupported pattern for 'like' filter: {}", pattern);
+  }
+  const auto prefix = pattern.substr(0, wildcard);
+  if (prefix.empty()) {
+    return isNotNull();
+  }
+  // The strings with 'prefix' are below 'prefix' with its last byte that is
+  // not 0xFF incremented and the rest truncated.
+  auto upper = prefix;
+  while (!upper.empty() && static_cast<uint8_t>(upper.back()) == 0xFF) {
+    upper.pop_back();
+  }
+  if (upper.empty()) {
+    return greaterThanOrEqual(prefix);
+  }
+  upper.back() = static_cast<char>(static_cast<uint8_t>(upper.back()) + 1);
+  return std::make_unique<common::BytesRange>(
+      prefix, false, false, upper, false, true, false);
+}
+
 std::unique_ptr<common::Filter> makeBetweenFilter(
     const core::TypedExprPtr& lowerExpr,
     const core::TypedExprPtr& upperExpr) {
@@ -412,6 +541,19 @@ std::pair<common::Subfield, std::unique_ptr<common::Filter>> toSubfieldFilter(
       if (auto field = asField(call, 0)) {
         return {Subfield(field->name()), makeInFilter(call->inputs()[1])};
       }
+    } else if (call->name() == "like") {
+      if (call->inputs().size() == 2) {
+        if (auto field = asField(call, 0)) {
+          return {Subfield(field->name()), makeLikeFilter(call->inputs()[1])};
+        }
+      }
+    } else if (call->name() == "distinct_from") {
+      // Passes the values other than the constant and nulls.
+      if (auto field = asField(call, 0)) {
+        return {
+            Subfield(field->name()),
+            makeNotEqualFilter(call->inputs()[1])->clone(true)};
+      }
     } else if (call->name() == "is_null") {
       if (auto field = asField(call, 0)) {
         return {Subfield(field->name()), isNull()};
@@ -422,6 +564,12 @@ std::pair<common::Subfield, std::unique_ptr<common::Filter>> toSubfieldFilter(
           if (auto field = asField(nestedCall, 0)) {
             return {Subfield(field->name()), isNotNull()};
           }
+        } else if (nestedCall->name() == "distinct_from") {
+          if (auto field = asField(nestedCall, 0)) {
+            return {
+                Subfield(field->name()),
+                makeEqualFilter(nestedCall->inputs()[1])};
+          }
         }
       }
     }
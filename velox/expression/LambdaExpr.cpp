@@ -39,6 +39,15 @@ class ExprCallable : public Callable {
     return capture_->childrenSize() > signature_->size();
   }
 
+  bool hasNonConstantCapture() const override {
+    for (auto i = signature_->size(); i < capture_->childrenSize(); ++i) {
+      if (!capture_->childAt(i)->isConstantEncoding()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   void apply(
       const SelectivityVector& rows,
       const SelectivityVector& finalSelection,
@@ -52,6 +61,10 @@ class ExprCallable : public Callable {
       if (wrapCapture) {
         values = BaseVector::wrapInDictionary(
             BufferPtr(nullptr), wrapCapture, rows.end(), values);
+      } else if (
+          values->isConstantEncoding() && values->size() != rows.end()) {
+        // Constant captures are not wrapped if no capture needs wrapping.
+        values = BaseVector::wrapInConstant(rows.end(), 0, values);
       }
       allVectors.push_back(values);
     }
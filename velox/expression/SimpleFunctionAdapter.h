@@ -328,6 +328,24 @@ class SimpleFunctionAdapter : public VectorFunction {
       }
     }
 
+    // Computes all rows with a single call if the function provides
+    // callBatch() and all arguments are flat and null-free. Needs no null
+    // handling since a function with default null behavior that can't
+    // produce nulls returns non-null values for non-null inputs.
+    if constexpr (
+        FUNC::udf_has_callBatch && fastPathIteration &&
+        FUNC::is_default_null_behavior && !FUNC::can_produce_null_output &&
+        allArgsFlatConstantFastPathEligible()) {
+      if (rows.isAllSelected() && allArgsFlatNoNulls(args)) {
+        applyBatch(
+            applyContext, args, std::make_index_sequence<FUNC::num_args>());
+        if (isResultReused) {
+          result = std::move(*reusableResult);
+        }
+        return;
+      }
+    }
+
     std::vector<std::optional<LocalDecodedVector>> decoded;
     if (allPrimitiveArgsFlatConstant(args)) {
       if constexpr (
@@ -435,6 +453,27 @@ class SimpleFunctionAdapter : public VectorFunction {
     return hasStringArgs && allAscii;
   }
 
+  static bool allArgsFlatNoNulls(const std::vector<VectorPtr>& args) {
+    for (const auto& arg : args) {
+      if (!arg->isFlatEncoding() || arg->mayHaveNulls()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template <size_t... Is>
+  void applyBatch(
+      ApplyContext& applyContext,
+      const std::vector<VectorPtr>& args,
+      std::index_sequence<Is...>) const {
+    (*fn_).callBatch(
+        applyContext.result->mutableRawValues(),
+        applyContext.rows->end(),
+        args[Is]->template asUnchecked<FlatVector<exec_arg_at<Is>>>()
+            ->rawValues()...);
+  }
+
   // This is called only when we know that all args are flat or constant and are
   // eligible for the optimization and the optimization is enabled.
   template <int32_t POSITION, typename... TReader>
@@ -98,6 +98,7 @@ void SwitchExpr::evalSpecialForm(
       break;
     }
     // evaluate the case condition
+    loadExclusiveFields(2 * i, *remainingRows.get(), context);
     inputs_[2 * i]->eval(*remainingRows.get(), context, condition);
 
     const auto booleanMix = getFlatBool(
@@ -112,6 +113,7 @@ void SwitchExpr::evalSpecialForm(
     context.releaseVector(condition);
     switch (booleanMix) {
       case BooleanMix::kAllTrue:
+        loadExclusiveFields(2 * i + 1, *remainingRows.get(), context);
         inputs_[2 * i + 1]->eval(*remainingRows.get(), context, result);
         return;
       case BooleanMix::kAllNull:
@@ -127,6 +129,7 @@ void SwitchExpr::evalSpecialForm(
         thenRows.get()->updateBounds();
 
         if (thenRows.get()->hasSelections()) {
+          loadExclusiveFields(2 * i + 1, *thenRows.get(), context);
           inputs_[2 * i + 1]->eval(*thenRows.get(), context, result);
           remainingRows.get()->deselect(*thenRows.get());
         }
@@ -137,6 +140,7 @@ void SwitchExpr::evalSpecialForm(
   // Evaluate the "else" clause.
   if (remainingRows.get()->hasSelections()) {
     if (hasElseClause_) {
+      loadExclusiveFields(inputs_.size() - 1, *remainingRows.get(), context);
       inputs_.back()->eval(*remainingRows.get(), context, result);
     } else {
       context.ensureWritable(*remainingRows.get(), type(), result);
@@ -53,6 +53,10 @@ class SwitchExpr : public SpecialForm {
     return true;
   }
 
+  bool loadsExclusiveFields() const override {
+    return true;
+  }
+
  private:
   const size_t numCases_;
   const bool hasElseClause_;
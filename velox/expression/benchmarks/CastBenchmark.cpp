@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+
+// Benchmarks casting VARCHAR to BIGINT, DOUBLE, DATE and TIMESTAMP for inputs
+// in the common formats, which take the fast parsing paths, and in other
+// formats, which take the general conversions.
+
+using namespace facebook::velox;
+
+namespace {
+class CastBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  size_t run(
+      const std::string& type,
+      std::function<std::string(vector_size_t)> makeString) {
+    folly::BenchmarkSuspender suspender;
+    constexpr vector_size_t kSize = 10'000;
+    std::vector<std::string> strings;
+    strings.reserve(kSize);
+    for (auto i = 0; i < kSize; ++i) {
+      strings.push_back(makeString(i));
+    }
+    auto rowVector = vectorMaker_.rowVector({vectorMaker_.flatVector(strings)});
+    auto exprSet = compileExpression(
+        fmt::format("cast(c0 as {})", type), rowVector->type());
+    suspender.dismiss();
+
+    size_t count = 0;
+    for (auto i = 0; i < 100; ++i) {
+      count += evaluate(exprSet, rowVector)->size();
+    }
+    return count;
+  }
+};
+
+std::string dateString(vector_size_t row) {
+  return fmt::format(
+      "20{:02}-{:02}-{:02}", row % 100, row % 12 + 1, row % 28 + 1);
+}
+
+BENCHMARK_MULTI(castBigint) {
+  CastBenchmark benchmark;
+  return benchmark.run("bigint", [](auto row) {
+    return std::to_string(row * 1'000'003LL);
+  });
+}
+
+BENCHMARK_RELATIVE_MULTI(castBigintLeadingSpaces) {
+  CastBenchmark benchmark;
+  return benchmark.run("bigint", [](auto row) {
+    return " " + std::to_string(row * 1'000'003LL);
+  });
+}
+
+BENCHMARK_MULTI(castDouble) {
+  CastBenchmark benchmark;
+  return benchmark.run(
+      "double", [](auto row) { return fmt::format("{}.{}", row, row % 1000); });
+}
+
+BENCHMARK_RELATIVE_MULTI(castDoubleExponent) {
+  CastBenchmark benchmark;
+  return benchmark.run(
+      "double", [](auto row) { return fmt::format("{}e-3", row); });
+}
+
+BENCHMARK_MULTI(castDate) {
+  CastBenchmark benchmark;
+  return benchmark.run("date", dateString);
+}
+
+BENCHMARK_RELATIVE_MULTI(castDateSingleDigits) {
+  CastBenchmark benchmark;
+  return benchmark.run("date", [](auto row) {
+    return fmt::format("20{:02}-{}-{}", row % 100, row % 9 + 1, row % 9 + 1);
+  });
+}
+
+BENCHMARK_MULTI(castTimestamp) {
+  CastBenchmark benchmark;
+  return benchmark.run("timestamp", [](auto row) {
+    return fmt::format(
+        "{} {:02}:{:02}:{:02}", dateString(row), row % 24, row % 60, row % 60);
+  });
+}
+
+BENCHMARK_RELATIVE_MULTI(castTimestampMillis) {
+  CastBenchmark benchmark;
+  return benchmark.run("timestamp", [](auto row) {
+    return fmt::format(
+        "{} {:02}:{:02}:{:02}.123",
+        dateString(row),
+        row % 24,
+        row % 60,
+        row % 60);
+  });
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -202,6 +202,56 @@ TEST_F(CastExprTest, basics) {
   testCast<bool, std::string>("string", {true, false}, {"true", "false"});
 }
 
+TEST_F(CastExprTest, stringToNumber) {
+  // Integers with up to 18 digits are parsed 8 digits at a time. Longer ones
+  // and other formats use the general conversion.
+  testCast<std::string, int64_t>(
+      "bigint",
+      {"0",
+       "-0",
+       "007",
+       "12345678",
+       "-123456789012345678",
+       "1234567890123456789",
+       "-9223372036854775808",
+       "9223372036854775807"},
+      {0,
+       0,
+       7,
+       12345678,
+       -123456789012345678,
+       1234567890123456789,
+       std::numeric_limits<int64_t>::min(),
+       std::numeric_limits<int64_t>::max()});
+  testCast<std::string, int64_t>(
+      "bigint", {"9223372036854775808"}, {std::nullopt}, true);
+  testCast<std::string, int16_t>(
+      "smallint", {"-32768", "32767"}, {-32768, 32767});
+  testCast<std::string, int16_t>("smallint", {"32768"}, {std::nullopt}, true);
+  testCast<std::string, int32_t>("integer", {"12a"}, {std::nullopt}, true);
+
+  // Decimals with up to 15 digits are parsed with a single division.
+  testCast<std::string, double>(
+      "double",
+      {"0.1",
+       "-0.0",
+       "3",
+       "123456789.123456",
+       "1.7976931348623157e308",
+       "0.12345678901234567",
+       ".5",
+       "1e3"},
+      {0.1,
+       -0.0,
+       3.0,
+       123456789.123456,
+       1.7976931348623157e308,
+       0.12345678901234567,
+       0.5,
+       1000.0});
+  testCast<std::string, double>("double", {"1.5x"}, {std::nullopt}, true);
+}
+
 TEST_F(CastExprTest, timestamp) {
   testCast<std::string, Timestamp>(
       "timestamp",
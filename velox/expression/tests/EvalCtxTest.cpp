@@ -119,3 +119,31 @@ TEST_F(EvalCtxTest, ensureErrorsVectorSize) {
   ASSERT_GE(context.errors()->size(), 20);
   ASSERT_EQ(BaseVector::countNulls(context.errors()->nulls(), 20), 19);
 }
+
+TEST_F(EvalCtxTest, reuseErrorsVector) {
+  const EvalCtx::ErrorVector* errors;
+  {
+    EvalCtx context(&execCtx_);
+    *context.mutableThrowOnError() = false;
+    context.setError(5, std::make_exception_ptr(std::exception()));
+    errors = context.errors();
+  }
+
+  // The next evaluation gets the errors vector without the old errors.
+  EvalCtx context(&execCtx_);
+  context.ensureErrorsVectorSize(*context.errorsPtr(), 3);
+  ASSERT_EQ(errors, context.errors());
+  ASSERT_EQ(3, context.errors()->size());
+  ASSERT_EQ(BaseVector::countNulls(context.errors()->nulls(), 3), 3);
+
+  // A vector that is referenced elsewhere is not reused.
+  EvalCtx::ErrorVectorPtr copy;
+  {
+    EvalCtx scoped(&execCtx_);
+    scoped.ensureErrorsVectorSize(*scoped.errorsPtr(), 3);
+    copy = *scoped.errorsPtr();
+  }
+  EvalCtx other(&execCtx_);
+  other.ensureErrorsVectorSize(*other.errorsPtr(), 3);
+  ASSERT_NE(copy.get(), other.errors());
+}
@@ -101,6 +101,54 @@ TEST_F(ExprCompilerTest, constantFolding) {
       "plus(plus(a, 1:BIGINT), 5:BIGINT)", compile(expression)->toString());
 }
 
+TEST_F(ExprCompilerTest, templateCache) {
+  queryCtx_->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kExprTemplateCacheEnabled, "true"}});
+  const auto& cache = queryCtx_->exprTemplateCache();
+  auto rowType = ROW({"a"}, {BIGINT()});
+  auto field = makeField(rowType);
+
+  // Equal trees share the folded template, the first compilation folds.
+  auto makeExpression = [&](int64_t value) {
+    return call("plus", {field("a"), call("plus", {bigint(1), bigint(value)})});
+  };
+  ASSERT_EQ("plus(a, 6:BIGINT)", compile(makeExpression(5))->toString());
+  ASSERT_EQ(1, cache.stats().numMisses);
+  ASSERT_EQ(1, cache.stats().numEntries);
+  ASSERT_EQ("plus(a, 6:BIGINT)", compile(makeExpression(5))->toString());
+  ASSERT_EQ(1, cache.stats().numHits);
+
+  ASSERT_EQ("plus(a, 7:BIGINT)", compile(makeExpression(6))->toString());
+  ASSERT_EQ(2, cache.stats().numMisses);
+  ASSERT_EQ(2, cache.stats().numEntries);
+
+  // The same text over a different type is a different template.
+  auto doubleType = ROW({"a"}, {DOUBLE()});
+  auto doubleField = makeField(doubleType);
+  auto expression = call(
+      "plus",
+      {doubleField("a"),
+       call("plus",
+            {std::make_shared<core::ConstantTypedExpr>(1.0),
+             std::make_shared<core::ConstantTypedExpr>(5.0)})});
+  ASSERT_EQ("plus(a, 6:DOUBLE)", compile(expression)->toString());
+  ASSERT_EQ(3, cache.stats().numMisses);
+
+  // Trees with nothing to fold are not cached.
+  compile(call("plus", {field("a"), field("a")}));
+  ASSERT_EQ(3, cache.stats().numEntries);
+
+  auto data = makeRowVector({makeFlatVector<int64_t>({1, 2, 3})});
+  auto exprSet = compile(makeExpression(5));
+  ASSERT_EQ(2, cache.stats().numHits);
+  SelectivityVector rows(data->size());
+  EvalCtx context(execCtx_.get(), exprSet.get(), data.get());
+  std::vector<VectorPtr> result(1);
+  exprSet->eval(rows, context, result);
+  velox::test::assertEqualVectors(
+      makeFlatVector<int64_t>({7, 8, 9}), result[0]);
+}
+
 TEST_F(ExprCompilerTest, andFlattening) {
   auto rowType =
       ROW({"a", "b", "c", "d"}, {BOOLEAN(), BOOLEAN(), BOOLEAN(), BOOLEAN()});
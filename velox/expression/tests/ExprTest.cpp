@@ -299,6 +299,60 @@ TEST_F(ExprTest, reorder) {
   }
 }
 
+TEST_F(ExprTest, reorderAdapts) {
+  constexpr int32_t kBatchSize = 1'000;
+  auto exprSet = compileExpression(
+      "c0 < 10 and c1 < 10", ROW({"c0", "c1"}, {BIGINT(), BIGINT()}));
+  auto condition =
+      std::dynamic_pointer_cast<exec::ConjunctExpr>(exprSet->expr(0));
+  ASSERT_TRUE(condition != nullptr);
+
+  // 'dropping' is the column for which the filter drops 90% of the rows. The
+  // other filter drops no rows.
+  auto evaluateBatches = [&](int32_t dropping) {
+    std::vector<VectorPtr> columns(2);
+    columns[dropping] = makeFlatVector<int64_t>(
+        kBatchSize, [](auto row) { return row % 100; });
+    columns[1 - dropping] =
+        makeFlatVector<int64_t>(kBatchSize, [](auto /*row*/) { return 0; });
+    auto data = makeRowVector(columns);
+    for (auto i = 0; i < 200; ++i) {
+      evaluate(exprSet.get(), data);
+    }
+  };
+
+  // The filter that drops the rows runs first and sees all the rows.
+  for (auto dropping : {1, 0, 1}) {
+    evaluateBatches(dropping);
+    const auto& first = condition->selectivityAt(0);
+    EXPECT_LT(first.numOut() * 2, first.numIn());
+  }
+}
+
+TEST_F(ExprTest, flatBooleanConjuncts) {
+  constexpr int32_t kSize = 1'000;
+  auto data = makeRowVector({
+      makeFlatVector<bool>(kSize, [](auto row) { return row % 3 != 0; }),
+      makeFlatVector<bool>(kSize, [](auto row) { return row % 5 == 0; }),
+      makeFlatVector<bool>(
+          kSize, [](auto row) { return row % 2 == 0; }, nullEvery(7)),
+  });
+
+  auto result = evaluate("c0 and c1 and c2", data);
+  auto expected = makeFlatVector<bool>(
+      kSize,
+      [](auto row) { return row % 3 != 0 && row % 5 == 0 && row % 2 == 0; },
+      [](auto row) { return row % 7 == 0 && row % 3 != 0 && row % 5 == 0; });
+  assertEqualVectors(expected, result);
+
+  result = evaluate("c0 or c1 or c2", data);
+  expected = makeFlatVector<bool>(
+      kSize,
+      [](auto row) { return row % 3 != 0 || row % 5 == 0 || row % 2 == 0; },
+      [](auto row) { return row % 7 == 0 && row % 3 == 0 && row % 5 != 0; });
+  assertEqualVectors(expected, result);
+}
+
 TEST_F(ExprTest, constant) {
   auto exprSet = compileExpression("1 + 2 + 3 + 4", ROW({}));
   auto constExpr = dynamic_cast<exec::ConstantExpr*>(exprSet->expr(0).get());
@@ -416,6 +470,102 @@ TEST_F(ExprTest, constantFolding) {
   }
 }
 
+TEST_F(ExprTest, simplifySpecialForms) {
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), BOOLEAN()});
+  auto compile = [&](const std::string& text) {
+    exec::ExprSet exprSet({parseExpression(text, rowType)}, execCtx_.get());
+    return exprSet.exprs().front();
+  };
+  auto isConstant = [](const exec::ExprPtr& expr) {
+    return dynamic_cast<exec::ConstantExpr*>(expr.get()) != nullptr;
+  };
+
+  // Identities of AND and OR are dropped and a constant that decides the
+  // result replaces the conjunct.
+  EXPECT_EQ("c1", compile("c1 AND (1 < 2)")->toString());
+  EXPECT_EQ("c1", compile("(1 > 2) OR c1")->toString());
+  auto expr = compile("c1 AND (1 > 2) AND c0 > 0");
+  ASSERT_TRUE(isConstant(expr));
+  EXPECT_FALSE(std::dynamic_pointer_cast<exec::ConstantExpr>(expr)
+                   ->value()
+                   ->as<ConstantVector<bool>>()
+                   ->valueAt(0));
+  EXPECT_EQ("and", compile("c1 AND c0 > 0 AND (1 < 2)")->name());
+  EXPECT_EQ(2, compile("c1 AND c0 > 0 AND (1 < 2)")->inputs().size());
+
+  // A non-null constant ends a coalesce.
+  expr = compile("coalesce(1 + 2, c0)");
+  ASSERT_TRUE(isConstant(expr));
+  EXPECT_EQ(2, compile("coalesce(c0, 1 + 2, c0 + 1)")->inputs().size());
+
+  // Branches with constant conditions are resolved at compile time.
+  EXPECT_EQ("c0", compile("if (1 < 2, c0, c0 + 1)")->toString());
+  EXPECT_EQ(
+      "plus", compile("case when 1 > 2 then c0 else c0 + 1 end")->name());
+  EXPECT_EQ(
+      3, compile("case when c1 then c0 when 1 < 2 then 1 else 2 end")
+             ->inputs()
+             .size());
+
+  // The results are the same with and without the simplifications.
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>({1, -2, 3}),
+       makeNullableFlatVector<bool>({true, false, std::nullopt})});
+  for (const auto& text :
+       {"c1 AND (1 < 2)",
+        "c1 AND (1 > 2) AND c0 > 0",
+        "coalesce(c0, 1 + 2, c0 + 1)",
+        "case when c1 then c0 when 1 < 2 then 1 else 2 end"}) {
+    auto typedExpr = parseExpression(text, rowType);
+    exec::ExprSet simplified({typedExpr}, execCtx_.get(), true);
+    exec::ExprSet unsimplified({typedExpr}, execCtx_.get(), false);
+    SelectivityVector rows(data->size());
+    std::vector<VectorPtr> expected(1);
+    std::vector<VectorPtr> actual(1);
+    exec::EvalCtx context(execCtx_.get(), &unsimplified, data.get());
+    unsimplified.eval(rows, context, expected);
+    exec::EvalCtx simplifiedContext(execCtx_.get(), &simplified, data.get());
+    simplified.eval(rows, simplifiedContext, actual);
+    assertEqualVectors(expected[0], actual[0]);
+  }
+}
+
+TEST_F(ExprTest, valueMemo) {
+  queryCtx_->setConfigOverridesUnsafe({
+      {core::QueryConfig::kExprValueMemoMaxEntries, "3"},
+  });
+  auto exprSet = compileExpression("upper(c0)", ROW({"c0"}, {VARCHAR()}));
+  const auto& stats = exprSet->exprs()[0]->stats();
+
+  auto evaluate = [&](const std::vector<std::string>& values) {
+    auto data = makeRowVector({makeFlatVector<std::string>(values)});
+    SelectivityVector rows(data->size());
+    std::vector<VectorPtr> result(1);
+    exec::EvalCtx context(execCtx_.get(), exprSet.get(), data.get());
+    exprSet->eval(rows, context, result);
+    std::vector<std::string> expected;
+    for (auto value : values) {
+      std::transform(value.begin(), value.end(), value.begin(), ::toupper);
+      expected.push_back(value);
+    }
+    assertEqualVectors(makeFlatVector<std::string>(expected), result[0]);
+  };
+
+  // upper() is called once per distinct value.
+  evaluate({"apple", "banana", "apple", "banana"});
+  EXPECT_EQ(2, stats.numProcessedRows);
+  evaluate({"banana", "apple"});
+  EXPECT_EQ(2, stats.numProcessedRows);
+  evaluate({"cherry", "apple", "cherry"});
+  EXPECT_EQ(3, stats.numProcessedRows);
+
+  // The memo is full and upper() is called for all rows from now on.
+  evaluate({"apple", "durian", "apple"});
+  EXPECT_EQ(6, stats.numProcessedRows);
+  evaluate({"apple", "banana"});
+  EXPECT_EQ(8, stats.numProcessedRows);
+}
+
 TEST_F(ExprTest, constantArray) {
   auto a = makeArrayVector<int32_t>(
       10, [](auto /*row*/) { return 5; }, [](auto row) { return row * 3; });
@@ -1159,15 +1309,15 @@ TEST_F(ExprTest, lazyVectorAccessTwiceInDifferentExpressions) {
 TEST_F(ExprTest, selectiveLazyLoadingIf) {
   const vector_size_t size = 1'000;
 
-  // Evaluate IF expression. Columns under IF must be loaded for "all" rows
-  // because the engine currently doesn't know whether a column is used in a
-  // single branch (then or else) or in both.
+  // Evaluate IF expression. A column used only in one branch is loaded for
+  // the rows of the branch. A column used in both branches is loaded for
+  // "all" rows.
   auto valueAt = [](auto row) { return row; };
 
   auto a = makeLazyFlatVector<int64_t>(
       size, valueAt, nullptr, size, [](auto row) { return row; });
   auto b = makeLazyFlatVector<int64_t>(
-      size, valueAt, nullptr, size, [](auto row) { return row; });
+      size, valueAt, nullptr, size / 2, [](auto row) { return row * 2; });
   auto c = makeLazyFlatVector<int64_t>(
       size, valueAt, nullptr, size, [](auto row) { return row; });
 
@@ -1176,6 +1326,41 @@ TEST_F(ExprTest, selectiveLazyLoadingIf) {
   auto expected = makeFlatVector<int64_t>(
       size, [](auto row) { return row % 2 == 0 ? row + row : row / 3; });
   assertEqualVectors(expected, result);
+
+  // A column also used outside of the branch is loaded for "all" rows.
+  a = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, size, [](auto row) { return row; });
+  b = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, size, [](auto row) { return row; });
+  result = evaluate(
+      "if (c0 % 2 = 0, c1 * 2, 0) + c1", makeRowVector({a, b}));
+  expected = makeFlatVector<int64_t>(
+      size, [](auto row) { return row % 2 == 0 ? row * 3 : row; });
+  assertEqualVectors(expected, result);
+}
+
+TEST_F(ExprTest, selectiveLazyLoadingCoalesce) {
+  const vector_size_t size = 1'000;
+
+  // The second argument of COALESCE is loaded only for the rows where the
+  // first is null.
+  auto a = makeLazyFlatVector<int64_t>(
+      size,
+      [](auto row) { return row; },
+      [](auto row) { return row % 10 == 0; },
+      size,
+      [](auto row) { return row; });
+  auto b = makeLazyFlatVector<int64_t>(
+      size,
+      [](auto row) { return -row; },
+      nullptr,
+      size / 10,
+      [](auto row) { return row * 10; });
+
+  auto result = evaluate("coalesce(c0, c1)", makeRowVector({a, b}));
+  auto expected = makeFlatVector<int64_t>(
+      size, [](auto row) { return row % 10 == 0 ? -row : row; });
+  assertEqualVectors(expected, result);
 }
 
 namespace {
@@ -2651,6 +2836,40 @@ TEST_F(ExprTest, flatNoNullsFastPath) {
       << exprSet->toString();
 }
 
+TEST_F(ExprTest, structurallyEqualSubexpressions) {
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), BIGINT()});
+  // The two 'c0 + c1' are separate trees of ITypedExprs. They compile to one
+  // Expr that is evaluated once for both expressions.
+  auto exprSet = compileMultiple({"c0 + c1 > 10", "(c0 + c1) * 2"}, rowType);
+  auto& exprs = exprSet->exprs();
+  ASSERT_EQ(2, exprs.size());
+  EXPECT_EQ(exprs[0]->inputs()[0].get(), exprs[1]->inputs()[0].get());
+  EXPECT_TRUE(exprs[0]->inputs()[0]->isMultiplyReferenced());
+
+  // Row constructors of the same inputs with different field names are
+  // different expressions.
+  auto c0 = std::make_shared<core::FieldAccessTypedExpr>(BIGINT(), "c0");
+  std::vector<core::TypedExprPtr> inputs{c0};
+  exec::ExprSet concats(
+      {std::make_shared<core::ConcatTypedExpr>(
+           std::vector<std::string>{"a"}, inputs),
+       std::make_shared<core::ConcatTypedExpr>(
+           std::vector<std::string>{"b"}, inputs),
+       std::make_shared<core::ConcatTypedExpr>(
+           std::vector<std::string>{"a"}, inputs)},
+      execCtx_.get());
+  EXPECT_NE(concats.exprs()[0].get(), concats.exprs()[1].get());
+  EXPECT_EQ(concats.exprs()[0].get(), concats.exprs()[2].get());
+
+  auto data = makeRowVector({makeFlatVector<int64_t>({1, 2, 3})});
+  SelectivityVector rows(data->size());
+  std::vector<VectorPtr> result(3);
+  exec::EvalCtx context(execCtx_.get(), &concats, data.get());
+  concats.eval(rows, context, result);
+  EXPECT_EQ(*ROW({"a"}, {BIGINT()}), *result[0]->type());
+  EXPECT_EQ(*ROW({"b"}, {BIGINT()}), *result[1]->type());
+}
+
 TEST_F(ExprTest, commonSubExpressionWithEncodedInput) {
   // This test case does a sanity check of the code path that re-uses
   // precomputed results for common sub-expressions.
@@ -1036,4 +1036,80 @@ TEST_F(SimpleFunctionTest, variadicReuseNoArgsDifferentType) {
   ASSERT_NE(resultPtr.get(), capturedArg1);
 }
 
+int32_t numBatchPlusCalls{0};
+
+template <typename T>
+struct BatchPlusFunction {
+  FOLLY_ALWAYS_INLINE void
+  call(int64_t& result, const int64_t& a, const int64_t& b) {
+    result = a + b;
+  }
+
+  FOLLY_ALWAYS_INLINE void
+  callBatch(int64_t* result, int32_t size, const int64_t* a, const int64_t* b) {
+    ++numBatchPlusCalls;
+    for (auto i = 0; i < size; ++i) {
+      result[i] = a[i] + b[i];
+    }
+  }
+};
+
+TEST_F(SimpleFunctionTest, callBatch) {
+  registerFunction<BatchPlusFunction, int64_t, int64_t, int64_t>(
+      {"batch_plus"});
+  numBatchPlusCalls = 0;
+
+  vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row * 2; }),
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row; }, nullEvery(7)),
+  });
+
+  // Flat inputs without nulls on all rows take a single batch call.
+  auto result = evaluate<SimpleVector<int64_t>>("batch_plus(c0, c1)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(size, [](auto row) { return row * 3; }),
+      result);
+  EXPECT_EQ(1, numBatchPlusCalls);
+
+  // Inputs with nulls go through call().
+  result = evaluate<SimpleVector<int64_t>>("batch_plus(c0, c2)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row * 2; }, nullEvery(7)),
+      result);
+  EXPECT_EQ(1, numBatchPlusCalls);
+
+  // So do subsets of rows.
+  SelectivityVector rows(size);
+  rows.setValidRange(0, size / 2, false);
+  rows.updateBounds();
+  VectorPtr subsetResult;
+  auto subset = evaluate<SimpleVector<int64_t>>(
+      "batch_plus(c0, c1)", data, rows, subsetResult);
+  for (auto i = size / 2; i < size; ++i) {
+    EXPECT_EQ(i * 3, subset->valueAt(i));
+  }
+  EXPECT_EQ(1, numBatchPlusCalls);
+
+  // Comparisons write bit-packed results in batch.
+  std::vector<std::string> left;
+  std::vector<std::string> right;
+  for (auto i = 0; i < size; ++i) {
+    left.push_back(std::to_string(i));
+    right.push_back(std::to_string(size - i));
+  }
+  auto strings = makeRowVector({
+      makeFlatVector<std::string>(left),
+      makeFlatVector<std::string>(right),
+  });
+  auto lessThan = evaluate<SimpleVector<bool>>("c0 < c1", strings);
+  assertEqualVectors(
+      makeFlatVector<bool>(
+          size, [&](auto row) { return left[row] < right[row]; }),
+      lessThan);
+}
+
 } // namespace
@@ -48,6 +48,13 @@ DEFINE_bool(
     true,
     "Record time and volume for large allocation/free");
 
+DEFINE_int64(
+    velox_allocation_sample_bytes,
+    0,
+    "If not 0, records the call site of about one allocation per this many "
+    "bytes allocated from each MemoryPool and ScopedMappedMemory, see "
+    "memory::AllocationSampler");
+
 // Used in common/base/VeloxException.cpp
 DEFINE_bool(
     velox_exception_user_stacktrace_enabled,
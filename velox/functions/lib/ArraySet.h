@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/container/F14Set.h>
+#include <vector>
+
+namespace facebook::velox::functions {
+
+/// A set of distinct non-null values of an array with a flag that tells
+/// whether the array had nulls. Used by the array functions that compare the
+/// elements of an array, e.g. array_distinct() or array_intersect().
+///
+/// Most arrays are small and for up to kMaxLinearSize values a linear scan of
+/// a vector is faster than hashing. Past that size the values move to an
+/// F14FastSet. clear() keeps the memory of both, so that the same set can be
+/// reused for all the rows of a batch without allocating per row.
+template <typename T>
+class ArraySet {
+ public:
+  static constexpr size_t kMaxLinearSize = 10;
+
+  /// Adds 'value'. Returns false if 'value' was already in the set.
+  bool insert(const T& value) {
+    if (!hashed_) {
+      for (const auto& existing : values_) {
+        if (existing == value) {
+          return false;
+        }
+      }
+      values_.push_back(value);
+      if (values_.size() > kMaxLinearSize) {
+        set_.insert(values_.begin(), values_.end());
+        hashed_ = true;
+      }
+      return true;
+    }
+    return set_.insert(value).second;
+  }
+
+  bool contains(const T& value) const {
+    if (!hashed_) {
+      for (const auto& existing : values_) {
+        if (existing == value) {
+          return true;
+        }
+      }
+      return false;
+    }
+    return set_.count(value) > 0;
+  }
+
+  /// Empties the set and resets 'hasNull' while retaining the memory.
+  void clear() {
+    values_.clear();
+    if (hashed_) {
+      set_.clear();
+      hashed_ = false;
+    }
+    hasNull = false;
+  }
+
+  bool empty() const {
+    return values_.empty();
+  }
+
+  bool hasNull{false};
+
+ private:
+  // The values in insertion order. Only appended to while '!hashed_'.
+  std::vector<T> values_;
+  folly::F14FastSet<T> set_;
+  // True if 'set_' holds the values.
+  bool hashed_{false};
+};
+
+} // namespace facebook::velox::functions
@@ -15,7 +15,10 @@
  */
 #include "velox/functions/lib/Re2Functions.h"
 
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
 #include <re2/re2.h>
+#include <cstring>
 #include <optional>
 #include <string>
 
@@ -67,6 +70,74 @@ void checkForBadPattern(const RE2& re) {
   }
 }
 
+// Max number of compiled regexes kept by compileRegex(). When full, an
+// arbitrary regex is dropped to make room for a new one.
+constexpr size_t kMaxCachedRegexes = 1'000;
+
+// Returns a key for the options that affect the compiled regex.
+uint32_t optionsKey(const RE2::Options& options) {
+  return static_cast<uint32_t>(options.encoding()) |
+      options.posix_syntax() << 2 | options.longest_match() << 3 |
+      options.log_errors() << 4 | options.literal() << 5 |
+      options.never_nl() << 6 | options.dot_nl() << 7 |
+      options.never_capture() << 8 | options.case_sensitive() << 9 |
+      options.perl_classes() << 10 | options.word_boundary() << 11 |
+      options.one_line() << 12;
+}
+
+// Returns the regex for 'pattern' and 'options' from a process-wide cache,
+// compiling it if not cached. Compiling may take longer than matching many
+// strings, e.g. for a non-constant pattern or a constant pattern in many
+// drivers. The result may not be ok(), see checkForBadPattern().
+std::shared_ptr<const RE2> compileRegex(
+    std::string_view pattern,
+    const RE2::Options& options = RE2::Quiet) {
+  using Key = std::pair<std::string, uint32_t>;
+  static folly::Synchronized<
+      folly::F14FastMap<Key, std::shared_ptr<const RE2>>>
+      cache;
+  Key key{std::string(pattern), optionsKey(options)};
+  {
+    auto regexes = cache.rlock();
+    auto it = regexes->find(key);
+    if (it != regexes->end()) {
+      return it->second;
+    }
+  }
+  auto re = std::make_shared<const RE2>(
+      re2::StringPiece(pattern.data(), pattern.size()), options);
+  auto regexes = cache.wlock();
+  if (regexes->size() >= kMaxCachedRegexes) {
+    regexes->erase(regexes->begin());
+  }
+  return regexes->try_emplace(std::move(key), std::move(re)).first->second;
+}
+
+// Returns the compiled regexes for the patterns of the rows of a batch.
+// Remembers the last pattern, so that consecutive rows with the same pattern
+// look up the process-wide cache once.
+class RowRegexes {
+ public:
+  const RE2& get(StringView pattern) {
+    if (!re_ || pattern != pattern_) {
+      re_ = compileRegex(std::string_view(pattern));
+      pattern_ = pattern;
+    }
+    return *re_;
+  }
+
+ private:
+  StringView pattern_;
+  std::shared_ptr<const RE2> re_;
+};
+
+// Returns true if 'str' may match a regex that requires 'literal'.
+bool mayContain(StringView str, const std::string& literal) {
+  return literal.empty() ||
+      memmem(str.data(), str.size(), literal.data(), literal.size()) !=
+      nullptr;
+}
+
 FlatVector<bool>& ensureWritableBool(
     const SelectivityVector& rows,
     EvalCtx& context,
@@ -185,7 +256,8 @@ template <bool (*Fn)(StringView, const RE2&)>
 class Re2MatchConstantPattern final : public VectorFunction {
  public:
   explicit Re2MatchConstantPattern(StringView pattern)
-      : re_(toStringPiece(pattern), RE2::Quiet) {}
+      : re_(compileRegex(std::string_view(pattern))),
+        requiredLiteral_(re2RequiredLiteral(std::string_view(pattern))) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -196,14 +268,18 @@ class Re2MatchConstantPattern final : public VectorFunction {
     VELOX_CHECK_EQ(args.size(), 2);
     FlatVector<bool>& result = ensureWritableBool(rows, context, resultRef);
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
-    checkForBadPattern(re_);
+    checkForBadPattern(*re_);
     rows.applyToSelected([&](vector_size_t i) {
-      result.set(i, Fn(toSearch->valueAt<StringView>(i), re_));
+      const auto str = toSearch->valueAt<StringView>(i);
+      result.set(i, mayContain(str, requiredLiteral_) && Fn(str, *re_));
     });
   }
 
  private:
-  RE2 re_;
+  std::shared_ptr<const RE2> re_;
+  // A string that all matches contain. Rows without it are rejected without
+  // running the regex. Empty if not known.
+  const std::string requiredLiteral_;
 };
 
 template <bool (*Fn)(StringView, const RE2&)>
@@ -225,8 +301,9 @@ class Re2Match final : public VectorFunction {
     FlatVector<bool>& result = ensureWritableBool(rows, context, resultRef);
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
     exec::LocalDecodedVector pattern(context, *args[1], rows);
+    RowRegexes regexes;
     rows.applyToSelected([&](vector_size_t row) {
-      RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
+      const auto& re = regexes.get(pattern->valueAt<StringView>(row));
       checkForBadPattern(re);
       result.set(row, Fn(toSearch->valueAt<StringView>(row), re));
     });
@@ -245,7 +322,8 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
   explicit Re2SearchAndExtractConstantPattern(
       StringView pattern,
       bool emptyNoMatch)
-      : re_(toStringPiece(pattern), RE2::Quiet), emptyNoMatch_(emptyNoMatch) {}
+      : re_(compileRegex(std::string_view(pattern))),
+        emptyNoMatch_(emptyNoMatch) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -259,7 +337,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
         ensureWritableStringView(rows, context, resultRef);
 
     // apply() will not be invoked if the selection is empty.
-    checkForBadPattern(re_);
+    checkForBadPattern(*re_);
 
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
     bool mustRefSourceStrings = false;
@@ -269,7 +347,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
       groups.resize(1);
       rows.applyToSelected([&](vector_size_t i) {
         mustRefSourceStrings |=
-            re2Extract(result, i, re_, toSearch, groups, 0, emptyNoMatch_);
+            re2Extract(result, i, *re_, toSearch, groups, 0, emptyNoMatch_);
       });
       if (mustRefSourceStrings) {
         result.acquireSharedStringBuffers(toSearch->base());
@@ -278,11 +356,11 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
     }
 
     if (const auto groupId = getIfConstant<T>(*args[2])) {
-      checkForBadGroupId(*groupId, re_);
+      checkForBadGroupId(*groupId, *re_);
       groups.resize(*groupId + 1);
       rows.applyToSelected([&](vector_size_t i) {
         mustRefSourceStrings |= re2Extract(
-            result, i, re_, toSearch, groups, *groupId, emptyNoMatch_);
+            result, i, *re_, toSearch, groups, *groupId, emptyNoMatch_);
       });
       if (mustRefSourceStrings) {
         result.acquireSharedStringBuffers(toSearch->base());
@@ -298,13 +376,13 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
       maxGroupId = std::max(groupIds->valueAt<T>(i), maxGroupId);
       minGroupId = std::min(groupIds->valueAt<T>(i), minGroupId);
     });
-    checkForBadGroupId(maxGroupId, re_);
-    checkForBadGroupId(minGroupId, re_);
+    checkForBadGroupId(maxGroupId, *re_);
+    checkForBadGroupId(minGroupId, *re_);
     groups.resize(maxGroupId + 1);
     rows.applyToSelected([&](vector_size_t i) {
       T group = groupIds->valueAt<T>(i);
       mustRefSourceStrings |=
-          re2Extract(result, i, re_, toSearch, groups, group, emptyNoMatch_);
+          re2Extract(result, i, *re_, toSearch, groups, group, emptyNoMatch_);
     });
     if (mustRefSourceStrings) {
       result.acquireSharedStringBuffers(toSearch->base());
@@ -312,7 +390,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
   }
 
  private:
-  RE2 re_;
+  std::shared_ptr<const RE2> re_;
   const bool emptyNoMatch_;
 }; // namespace
 
@@ -337,18 +415,19 @@ class Re2SearchAndExtract final : public VectorFunction {
       return;
     }
 
-    // The general case. Further optimizations are possible to avoid regex
-    // recompilation, but a constant pattern is by far the most common case.
+    // The general case. The regexes come from the process-wide cache, so
+    // repeated patterns are not recompiled.
     FlatVector<StringView>& result =
         ensureWritableStringView(rows, context, resultRef);
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
     exec::LocalDecodedVector pattern(context, *args[1], rows);
     bool mustRefSourceStrings = false;
     FOLLY_DECLARE_REUSED(groups, std::vector<re2::StringPiece>);
+    RowRegexes regexes;
     if (args.size() == 2) {
       groups.resize(1);
       rows.applyToSelected([&](vector_size_t i) {
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(i)), RE2::Quiet);
+        const auto& re = regexes.get(pattern->valueAt<StringView>(i));
         checkForBadPattern(re);
         mustRefSourceStrings |=
             re2Extract(result, i, re, toSearch, groups, 0, emptyNoMatch_);
@@ -357,7 +436,7 @@ class Re2SearchAndExtract final : public VectorFunction {
       exec::LocalDecodedVector groupIds(context, *args[2], rows);
       rows.applyToSelected([&](vector_size_t i) {
         const auto groupId = groupIds->valueAt<T>(i);
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(i)), RE2::Quiet);
+        const auto& re = regexes.get(pattern->valueAt<StringView>(i));
         checkForBadPattern(re);
         checkForBadGroupId(groupId, re);
         groups.resize(groupId + 1);
@@ -465,12 +544,12 @@ class OptimizedLikeWithMemcmp final : public VectorFunction {
 
 class LikeWithRe2 final : public VectorFunction {
  public:
-  LikeWithRe2(StringView pattern, std::optional<char> escapeChar) {
+  LikeWithRe2(StringView pattern, std::optional<char> escapeChar)
+      : requiredLiteral_(likeRequiredLiteral(pattern, escapeChar)) {
     RE2::Options opt{RE2::Quiet};
     opt.set_dot_nl(true);
-    re_.emplace(
-        toStringPiece(likePatternToRe2(pattern, escapeChar, validPattern_)),
-        opt);
+    re_ = compileRegex(
+        likePatternToRe2(pattern, escapeChar, validPattern_), opt);
   }
 
   void apply(
@@ -497,13 +576,18 @@ class LikeWithRe2 final : public VectorFunction {
     if (toSearch->isIdentityMapping()) {
       auto rawStrings = toSearch->data<StringView>();
       rows.applyToSelected([&](vector_size_t i) {
-        result.set(i, re2FullMatch(rawStrings[i], *re_));
+        result.set(
+            i,
+            mayContain(rawStrings[i], requiredLiteral_) &&
+                re2FullMatch(rawStrings[i], *re_));
       });
       return;
     }
 
     if (toSearch->isConstantMapping()) {
-      bool match = re2FullMatch(toSearch->valueAt<StringView>(0), *re_);
+      const auto str = toSearch->valueAt<StringView>(0);
+      bool match =
+          mayContain(str, requiredLiteral_) && re2FullMatch(str, *re_);
       rows.applyToSelected([&](vector_size_t i) { result.set(i, match); });
       return;
     }
@@ -515,8 +599,10 @@ class LikeWithRe2 final : public VectorFunction {
   }
 
  private:
-  std::optional<RE2> re_;
+  std::shared_ptr<const RE2> re_;
   bool validPattern_;
+  // A string that all matches contain. Empty if the pattern has no literal.
+  const std::string requiredLiteral_;
 };
 
 void re2ExtractAll(
@@ -550,7 +636,7 @@ template <typename T>
 class Re2ExtractAllConstantPattern final : public VectorFunction {
  public:
   explicit Re2ExtractAllConstantPattern(StringView pattern)
-      : re_(toStringPiece(pattern), RE2::Quiet) {}
+      : re_(compileRegex(std::string_view(pattern))) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -559,7 +645,7 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
       EvalCtx& context,
       VectorPtr& resultRef) const final {
     VELOX_CHECK(args.size() == 2 || args.size() == 3);
-    checkForBadPattern(re_);
+    checkForBadPattern(*re_);
 
     ArrayBuilder<Varchar> builder(
         rows.size(), rows.countSelected() * 3, context.pool());
@@ -571,15 +657,15 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
       //
       groups.resize(1);
       context.applyToSelectedNoThrow(rows, [&](vector_size_t row) {
-        re2ExtractAll(builder, re_, inputStrs, row, groups, 0);
+        re2ExtractAll(builder, *re_, inputStrs, row, groups, 0);
       });
     } else if (const auto _groupId = getIfConstant<T>(*args[2])) {
       // Case 2: Constant groupId
       //
-      checkForBadGroupId(*_groupId, re_);
+      checkForBadGroupId(*_groupId, *re_);
       groups.resize(*_groupId + 1);
       context.applyToSelectedNoThrow(rows, [&](vector_size_t row) {
-        re2ExtractAll(builder, re_, inputStrs, row, groups, *_groupId);
+        re2ExtractAll(builder, *re_, inputStrs, row, groups, *_groupId);
       });
     } else {
       // Case 3: Variable groupId, so resize the groups vector to accommodate
@@ -591,26 +677,26 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
         maxGroupId = std::max(groupIds->valueAt<T>(row), maxGroupId);
         minGroupId = std::min(groupIds->valueAt<T>(row), minGroupId);
       });
-      checkForBadGroupId(maxGroupId, re_);
-      checkForBadGroupId(minGroupId, re_);
+      checkForBadGroupId(maxGroupId, *re_);
+      checkForBadGroupId(minGroupId, *re_);
       groups.resize(maxGroupId + 1);
       context.applyToSelectedNoThrow(rows, [&](vector_size_t row) {
         const T groupId = groupIds->valueAt<T>(row);
-        checkForBadGroupId(groupId, re_);
-        re2ExtractAll(builder, re_, inputStrs, row, groups, groupId);
+        checkForBadGroupId(groupId, *re_);
+        re2ExtractAll(builder, *re_, inputStrs, row, groups, groupId);
       });
     }
 
-    if (const auto fv = inputStrs->base()->asFlatVector<StringView>()) {
-      builder.setStringBuffers(fv->stringBuffers());
-    }
+    // The matches point into the input strings. Reference the buffers of
+    // the input whether it is flat or constant.
+    builder.setStringBuffers(inputStrs->base());
     std::shared_ptr<ArrayVector> arrayVector =
         std::move(builder).finish(context.pool());
     context.moveOrCopyResult(arrayVector, rows, resultRef);
   }
 
  private:
-  RE2 re_;
+  std::shared_ptr<const RE2> re_;
 };
 
 template <typename T>
@@ -636,13 +722,14 @@ class Re2ExtractAll final : public VectorFunction {
     exec::LocalDecodedVector inputStrs(context, *args[0], rows);
     exec::LocalDecodedVector pattern(context, *args[1], rows);
     FOLLY_DECLARE_REUSED(groups, std::vector<re2::StringPiece>);
+    RowRegexes regexes;
 
     if (args.size() == 2) {
       // Case 1: No groupId -- use 0 as the default groupId
       //
       groups.resize(1);
       context.applyToSelectedNoThrow(rows, [&](vector_size_t row) {
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
+        const auto& re = regexes.get(pattern->valueAt<StringView>(row));
         checkForBadPattern(re);
         re2ExtractAll(builder, re, inputStrs, row, groups, 0);
       });
@@ -652,7 +739,7 @@ class Re2ExtractAll final : public VectorFunction {
       exec::LocalDecodedVector groupIds(context, *args[2], rows);
       context.applyToSelectedNoThrow(rows, [&](vector_size_t row) {
         const T groupId = groupIds->valueAt<T>(row);
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
+        const auto& re = regexes.get(pattern->valueAt<StringView>(row));
         checkForBadPattern(re);
         checkForBadGroupId(groupId, re);
         groups.resize(groupId + 1);
@@ -660,9 +747,9 @@ class Re2ExtractAll final : public VectorFunction {
       });
     }
 
-    if (const auto fv = inputStrs->base()->asFlatVector<StringView>()) {
-      builder.setStringBuffers(fv->stringBuffers());
-    }
+    // The matches point into the input strings. Reference the buffers of
+    // the input whether it is flat or constant.
+    builder.setStringBuffers(inputStrs->base());
     std::shared_ptr<ArrayVector> arrayVector =
         std::move(builder).finish(context.pool());
     context.moveOrCopyResult(arrayVector, rows, resultRef);
@@ -694,6 +781,130 @@ std::shared_ptr<VectorFunction> makeRe2MatchImpl(
 
 } // namespace
 
+std::string re2RequiredLiteral(std::string_view pattern) {
+  // Alternations may make any literal optional. Flags like (?i) may make
+  // literals match other strings.
+  if (pattern.find('|') != std::string_view::npos ||
+      pattern.find("(?") != std::string_view::npos) {
+    return "";
+  }
+  std::string best;
+  std::string run;
+  auto endRun = [&]() {
+    if (run.size() > best.size()) {
+      best = run;
+    }
+    run.clear();
+  };
+  // Removes the last UTF-8 character of 'run', which a quantifier makes
+  // optional.
+  auto dropLastChar = [&]() {
+    while (!run.empty() && (run.back() & 0xC0) == 0x80) {
+      run.pop_back();
+    }
+    if (!run.empty()) {
+      run.pop_back();
+    }
+  };
+  int32_t depth = 0;
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    const char c = pattern[i];
+    switch (c) {
+      case '\\': {
+        endRun();
+        if (i + 1 == pattern.size()) {
+          return best;
+        }
+        const char next = pattern[i + 1];
+        // \Q...\E, \x{..}, \p{..} and octal escapes span more characters.
+        if (next == 'Q' || next == 'x' || next == 'p' || next == 'P' ||
+            (next >= '0' && next <= '9')) {
+          return best;
+        }
+        ++i;
+        break;
+      }
+      case '[': {
+        endRun();
+        // Skips the character class. A ']' right after '[' or '[^' is a
+        // member of the class.
+        ++i;
+        if (i < pattern.size() && pattern[i] == '^') {
+          ++i;
+        }
+        if (i < pattern.size() && pattern[i] == ']') {
+          ++i;
+        }
+        while (i < pattern.size() && pattern[i] != ']') {
+          if (pattern[i] == '\\') {
+            ++i;
+          }
+          ++i;
+        }
+        if (i >= pattern.size()) {
+          return best;
+        }
+        break;
+      }
+      case '(':
+        endRun();
+        ++depth;
+        break;
+      case ')':
+        --depth;
+        break;
+      case '*':
+      case '?':
+        dropLastChar();
+        endRun();
+        break;
+      case '{': {
+        dropLastChar();
+        endRun();
+        const auto close = pattern.find('}', i);
+        if (close == std::string_view::npos) {
+          return best;
+        }
+        i = close;
+        break;
+      }
+      case '+':
+      case '.':
+      case '^':
+      case '$':
+        endRun();
+        break;
+      default:
+        if (depth == 0) {
+          run.push_back(c);
+        }
+    }
+  }
+  endRun();
+  return best;
+}
+
+std::string likeRequiredLiteral(
+    StringView pattern,
+    std::optional<char> escapeChar) {
+  std::string best;
+  std::string run;
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    const char c = pattern.data()[i];
+    if (escapeChar && c == *escapeChar && i + 1 < pattern.size()) {
+      run.push_back(pattern.data()[++i]);
+    } else if (c == '%' || c == '_') {
+      if (run.size() > best.size()) {
+        best = run;
+      }
+      run.clear();
+    } else {
+      run.push_back(c);
+    }
+  }
+  return run.size() > best.size() ? run : best;
+}
+
 std::shared_ptr<VectorFunction> makeRe2Match(
     const std::string& name,
     const std::vector<VectorFunctionArg>& inputArgs) {
@@ -16,6 +16,9 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include <re2/re2.h>
@@ -101,6 +104,18 @@ std::vector<std::shared_ptr<exec::FunctionSignature>> re2ExtractSignatures();
 /// {kGenericPattern, 0} for generic patterns).
 std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern);
 
+/// Returns the longest string that every match of the RE2 'pattern' contains,
+/// e.g. 'error' for 'error [0-9]+'. Matching functions skip the regex for
+/// strings without it. Returns an empty string if the pattern has no such
+/// literal or is too complex to tell, e.g. has alternations.
+std::string re2RequiredLiteral(std::string_view pattern);
+
+/// Returns the longest string that every match of the LIKE 'pattern' contains,
+/// e.g. 'foo' for '%foo_bar%'. Returns an empty string if none.
+std::string likeRequiredLiteral(
+    StringView pattern,
+    std::optional<char> escapeChar);
+
 std::shared_ptr<exec::VectorFunction> makeLike(
     const std::string& name,
     const std::vector<exec::VectorFunctionArg>& inputArgs);
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace facebook::velox::functions {
+
+/// Sorts the values of arrays of scalars in place, e.g. for array_sort().
+///
+/// Ranges of up to kMaxInsertionSortSize values are insertion sorted, which
+/// beats std::sort for the small arrays that are most common. Integers in
+/// ranges of at least kMinRadixSortSize values are LSD radix sorted,
+/// skipping the digits that all values share. The radix sort needs a
+/// scratch buffer the size of the range, which a sorter keeps across calls
+/// so that one sorter can sort all the arrays of a batch.
+template <typename T>
+class ValueSorter {
+ public:
+  static constexpr size_t kMaxInsertionSortSize = 16;
+  static constexpr size_t kMinRadixSortSize = 256;
+
+  /// Sorts [begin, end) in ascending or descending order of '<'. T must be
+  /// arithmetic.
+  void sort(T* begin, T* end, bool ascending) {
+    static_assert(std::is_arithmetic_v<T>);
+    if constexpr (kRadixSortable) {
+      if (end - begin >= static_cast<ptrdiff_t>(kMinRadixSortSize)) {
+        radixSort(begin, end);
+        if (!ascending) {
+          std::reverse(begin, end);
+        }
+        return;
+      }
+    }
+    if (ascending) {
+      sortBy(begin, end, std::less<T>());
+    } else {
+      sortBy(begin, end, std::greater<T>());
+    }
+  }
+
+  /// Sorts [begin, end) by 'less'. Used for the types and orders that can't
+  /// be radix sorted, e.g. floating point with NaN treated as the largest
+  /// value.
+  template <typename Less>
+  static void sortBy(T* begin, T* end, Less less) {
+    if (end - begin <= static_cast<ptrdiff_t>(kMaxInsertionSortSize)) {
+      insertionSort(begin, end, less);
+    } else {
+      std::sort(begin, end, less);
+    }
+  }
+
+ private:
+  static constexpr bool kRadixSortable = std::is_integral_v<T> &&
+      !std::is_same_v<T, bool> && sizeof(T) <= sizeof(uint64_t);
+
+  template <typename Less>
+  static void insertionSort(T* begin, T* end, Less less) {
+    if (end - begin < 2) {
+      return;
+    }
+    for (auto* it = begin + 1; it < end; ++it) {
+      T value = *it;
+      auto* hole = it;
+      for (; hole > begin && less(value, *(hole - 1)); --hole) {
+        *hole = *(hole - 1);
+      }
+      *hole = value;
+    }
+  }
+
+  // Returns 'value' as an unsigned integer with the same order.
+  static auto radixKey(T value) {
+    using Key = std::make_unsigned_t<T>;
+    auto key = static_cast<Key>(value);
+    if constexpr (std::is_signed_v<T>) {
+      key ^= Key(1) << (sizeof(T) * 8 - 1);
+    }
+    return key;
+  }
+
+  static uint32_t digitAt(T value, int32_t digit) {
+    return (radixKey(value) >> (digit * 8)) & 0xFF;
+  }
+
+  void radixSort(T* begin, T* end) {
+    const uint32_t size = end - begin;
+    scratch_.resize(size);
+    // The histograms of all digits are made in one pass over the values.
+    constexpr int32_t kNumDigits = sizeof(T);
+    uint32_t counts[kNumDigits][256] = {};
+    for (auto* it = begin; it < end; ++it) {
+      for (auto digit = 0; digit < kNumDigits; ++digit) {
+        ++counts[digit][digitAt(*it, digit)];
+      }
+    }
+    T* from = begin;
+    T* to = scratch_.data();
+    for (auto digit = 0; digit < kNumDigits; ++digit) {
+      auto& digitCounts = counts[digit];
+      // A digit that is the same in all values doesn't change the order.
+      if (digitCounts[digitAt(*from, digit)] == size) {
+        continue;
+      }
+      uint32_t offset = 0;
+      for (auto& count : digitCounts) {
+        const auto numValues = count;
+        count = offset;
+        offset += numValues;
+      }
+      for (auto* it = from; it < from + size; ++it) {
+        to[digitCounts[digitAt(*it, digit)]++] = *it;
+      }
+      std::swap(from, to);
+    }
+    if (from != begin) {
+      std::copy(from, from + size, begin);
+    }
+  }
+
+  std::vector<T> scratch_;
+};
+
+} // namespace facebook::velox::functions
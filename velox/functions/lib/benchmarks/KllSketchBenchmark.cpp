@@ -119,6 +119,30 @@ void mergeKllSketch(int iters, int maxSize, int count) {
   }
 }
 
+// Merges the sketches into the first one one at a time, as an aggregation
+// that merges each intermediate result on arrival would.
+void mergeKllSketchOneByOne(int iters, int maxSize, int count) {
+  std::vector<KllSketch<double>> sketches;
+  BENCHMARK_SUSPEND {
+    std::vector<double> values;
+    for (int i = 0; i < count; ++i) {
+      populateValues(maxSize, values);
+      KllSketch<double> kll;
+      for (auto v : values) {
+        kll.insert(v);
+      }
+      sketches.push_back(std::move(kll));
+      values.clear();
+    }
+  }
+  assert(sketches.size() >= 2); // get rid of the lint warning
+  for (int i = 0; i < iters; ++i) {
+    for (int j = 1; j < count; ++j) {
+      sketches[0].merge(sketches[j]);
+    }
+  }
+}
+
 #define DEFINE_WITH_TYPE(name, type)  \
   int name##_##type(int, int iters) { \
     return name<type>(iters);         \
@@ -154,6 +178,11 @@ BENCHMARK_NAMED_PARAM(mergeTDigest, 1e6x40, 1e6, 40);
 BENCHMARK_RELATIVE_NAMED_PARAM(mergeKllSketch, 1e6x40, 1e6, 40);
 BENCHMARK_NAMED_PARAM(mergeTDigest, 1e6x80, 1e6, 80);
 BENCHMARK_RELATIVE_NAMED_PARAM(mergeKllSketch, 1e6x80, 1e6, 80);
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(mergeKllSketchOneByOne, 1e4x100, 1e4, 100);
+BENCHMARK_RELATIVE_NAMED_PARAM(mergeKllSketch, 1e4x100, 1e4, 100);
+BENCHMARK_NAMED_PARAM(mergeKllSketchOneByOne, 1e4x1000, 1e4, 1000);
+BENCHMARK_RELATIVE_NAMED_PARAM(mergeKllSketch, 1e4x1000, 1e4, 1000);
 
 // ============================================================================
 // [...]chmarks/ApproxPercentileBenchmark.cpp     relative  time/iter   iters/s
@@ -56,6 +56,59 @@ BENCHMARK_NAMED_PARAM_MULTI(regexSearch, bs1k, 1 << 10, "re2_search");
 BENCHMARK_NAMED_PARAM_MULTI(regexSearch, bs10k, 10 << 10, "re2_search");
 BENCHMARK_NAMED_PARAM_MULTI(regexSearch, bs100k, 100 << 10, "re2_search");
 
+// A pattern with a literal that almost no row contains. The rows without it
+// are rejected without running the regex.
+int regexSearchLiteral(int n, int blockSize) {
+  folly::BenchmarkSuspender kSuspender;
+  FunctionBenchmarkBase benchmarkBase;
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = blockSize;
+  auto vector = VectorFuzzer(opts, benchmarkBase.pool()).fuzzFlat(VARCHAR());
+  const auto data = benchmarkBase.maker().rowVector({vector});
+
+  exec::ExprSet expr = benchmarkBase.compileExpression(
+      "re2_search(c0, 'error: [0-9]+')", data->type());
+  kSuspender.dismiss();
+  for (int i = 0; i != n; ++i) {
+    benchmarkBase.evaluate(expr, data);
+  }
+  return n * blockSize;
+}
+
+BENCHMARK_NAMED_PARAM_MULTI(regexSearchLiteral, bs1k, 1 << 10);
+BENCHMARK_NAMED_PARAM_MULTI(regexSearchLiteral, bs10k, 10 << 10);
+BENCHMARK_NAMED_PARAM_MULTI(regexSearchLiteral, bs100k, 100 << 10);
+
+// A non-constant pattern with a few distinct values. The compiled regexes
+// come from the cache instead of being compiled for each row.
+int regexMatchColumnPattern(int n, int blockSize) {
+  folly::BenchmarkSuspender kSuspender;
+  FunctionBenchmarkBase benchmarkBase;
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = blockSize;
+  auto vector = VectorFuzzer(opts, benchmarkBase.pool()).fuzzFlat(VARCHAR());
+  std::vector<std::string> patterns = {"[^9]{3,5}", "a.*b", "[0-9]+x"};
+  const auto data = benchmarkBase.maker().rowVector({
+      vector,
+      benchmarkBase.maker().flatVector<StringView>(
+          blockSize,
+          [&](auto row) { return StringView(patterns[row / 64 % 3]); }),
+  });
+
+  exec::ExprSet expr =
+      benchmarkBase.compileExpression("re2_match(c0, c1)", data->type());
+  kSuspender.dismiss();
+  for (int i = 0; i != n; ++i) {
+    benchmarkBase.evaluate(expr, data);
+  }
+  return n * blockSize;
+}
+
+BENCHMARK_NAMED_PARAM_MULTI(regexMatchColumnPattern, bs1k, 1 << 10);
+BENCHMARK_NAMED_PARAM_MULTI(regexMatchColumnPattern, bs10k, 10 << 10);
+
 int regexExtract(int n, int blockSize) {
   folly::BenchmarkSuspender kSuspender;
   FunctionBenchmarkBase benchmarkBase;
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 #include <string>
 #include <string_view>
@@ -47,12 +48,21 @@ namespace stringCore {
 static bool isAscii(const char* str, size_t length);
 
 FOLLY_ALWAYS_INLINE bool isAscii(const char* str, size_t length) {
-  for (auto i = 0; i < length; i++) {
-    if (str[i] & 0x80) {
-      return false;
-    }
+  // Ors the input 8 bytes at a time without branches so that the loop can be
+  // vectorized. A high bit set in any byte means the input is not ascii.
+  constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+  uint64_t bits = 0;
+  size_t i = 0;
+  VECTORIZE_LOOP_IF_POSSIBLE for (; i + sizeof(uint64_t) <= length;
+                                  i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, str + i, sizeof(uint64_t));
+    bits |= word;
+  }
+  for (; i < length; ++i) {
+    bits |= static_cast<uint8_t>(str[i]);
   }
-  return true;
+  return (bits & kHighBits) == 0;
 }
 
 /// Perform reverse for ascii string input
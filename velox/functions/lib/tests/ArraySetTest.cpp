@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/functions/lib/ArraySet.h"
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include "velox/type/StringView.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::functions;
+
+namespace {
+
+// Inserts 0..numValues-1 twice and checks that only the first insert of a
+// value succeeds, also after clear() for the reuse on the next row.
+template <typename T, typename MakeValue>
+void testInsertAndClear(int32_t numValues, MakeValue makeValue) {
+  ArraySet<T> set;
+  for (auto round = 0; round < 2; ++round) {
+    EXPECT_TRUE(set.empty());
+    EXPECT_FALSE(set.hasNull);
+    for (auto i = 0; i < numValues; ++i) {
+      EXPECT_FALSE(set.contains(makeValue(i)));
+      EXPECT_TRUE(set.insert(makeValue(i)));
+    }
+    for (auto i = 0; i < numValues; ++i) {
+      EXPECT_TRUE(set.contains(makeValue(i)));
+      EXPECT_FALSE(set.insert(makeValue(i)));
+    }
+    EXPECT_FALSE(set.contains(makeValue(numValues)));
+    set.hasNull = true;
+    set.clear();
+  }
+}
+} // namespace
+
+TEST(ArraySetTest, linear) {
+  testInsertAndClear<int64_t>(
+      ArraySet<int64_t>::kMaxLinearSize, [](auto i) { return i; });
+}
+
+TEST(ArraySetTest, hashed) {
+  // Goes past the linear size to switch to the hash set.
+  testInsertAndClear<int64_t>(100, [](auto i) { return i * 7; });
+}
+
+TEST(ArraySetTest, strings) {
+  std::vector<std::string> strings;
+  for (auto i = 0; i <= 50; ++i) {
+    strings.push_back(fmt::format("string value number {}", i));
+  }
+  testInsertAndClear<StringView>(
+      50, [&](auto i) { return StringView(strings[i]); });
+}
@@ -440,6 +440,49 @@ TEST_F(Re2FunctionsTest, likeDeterminePatternKind) {
   testPattern("foo%bar", PatternKind::kGeneric, 0);
 }
 
+TEST_F(Re2FunctionsTest, requiredLiteral) {
+  EXPECT_EQ(re2RequiredLiteral("error [0-9]+"), "error ");
+  EXPECT_EQ(re2RequiredLiteral("^GET /index\\.html$"), "GET /index");
+  EXPECT_EQ(re2RequiredLiteral("colou?r"), "colo");
+  EXPECT_EQ(re2RequiredLiteral("ab+c"), "ab");
+  EXPECT_EQ(re2RequiredLiteral("x(abc)*yz{2}www"), "www");
+  EXPECT_EQ(re2RequiredLiteral("[abc]de[^]f]ghi"), "ghi");
+  EXPECT_EQ(re2RequiredLiteral("caf\u00e9*s"), "caf");
+  EXPECT_EQ(re2RequiredLiteral("foo|bar"), "");
+  EXPECT_EQ(re2RequiredLiteral("(?i)hello"), "");
+  EXPECT_EQ(re2RequiredLiteral(".*"), "");
+  EXPECT_EQ(re2RequiredLiteral("ab\\123cdef"), "ab");
+
+  EXPECT_EQ(likeRequiredLiteral("%foo_barbaz%", std::nullopt), "barbaz");
+  EXPECT_EQ(likeRequiredLiteral("%10#%%", '#'), "10%");
+  EXPECT_EQ(likeRequiredLiteral("%_%", std::nullopt), "");
+}
+
+TEST_F(Re2FunctionsTest, requiredLiteralPrefilter) {
+  auto input = makeRowVector({makeFlatVector<std::string>(
+      {"an error 42", "no problem", "error", "error 7 here", "warning 1"})});
+
+  auto result = evaluate("re2_search(c0, 'error [0-9]+')", input);
+  assertEqualVectors(
+      makeFlatVector<bool>({true, false, false, true, false}), result);
+
+  result = evaluate("re2_match(c0, '.*error [0-9]+')", input);
+  assertEqualVectors(
+      makeFlatVector<bool>({true, false, false, false, false}), result);
+
+  result = evaluate("like(c0, '%error _%')", input);
+  assertEqualVectors(
+      makeFlatVector<bool>({true, false, false, true, false}), result);
+
+  // Non-constant patterns, repeated across rows.
+  input = makeRowVector({
+      makeFlatVector<std::string>({"abc", "abd", "xyz", "xyy"}),
+      makeFlatVector<std::string>({"ab.", "ab.", "xy[z]", "xy[z]"}),
+  });
+  result = evaluate("re2_match(c0, c1)", input);
+  assertEqualVectors(makeFlatVector<bool>({true, true, true, false}), result);
+}
+
 TEST_F(Re2FunctionsTest, likePatternWildcard) {
   auto like = [&](std::string str, std::string pattern) {
     auto likeResult = evaluateOnce<bool>(
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/functions/lib/ValueSorter.h"
+
+#include <folly/Random.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::functions;
+
+namespace {
+
+// Sorts arrays of random values of sizes on both sides of the insertion and
+// radix sort thresholds and compares with std::sort. 'range' limits the
+// values to make ties and shared radix digits.
+template <typename T>
+void testSort(uint64_t range) {
+  folly::Random::DefaultGenerator rng(1);
+  ValueSorter<T> sorter;
+  for (auto size : {0, 1, 2, 15, 16, 17, 255, 256, 1'000, 10'000}) {
+    std::vector<T> values(size);
+    for (auto& value : values) {
+      value = static_cast<T>(folly::Random::rand64(range, rng));
+    }
+    for (auto ascending : {true, false}) {
+      auto expected = values;
+      auto actual = values;
+      if (ascending) {
+        std::sort(expected.begin(), expected.end());
+      } else {
+        std::sort(expected.begin(), expected.end(), std::greater<T>());
+      }
+      sorter.sort(actual.data(), actual.data() + size, ascending);
+      EXPECT_EQ(expected, actual) << size << " " << ascending;
+    }
+  }
+}
+} // namespace
+
+TEST(ValueSorterTest, integers) {
+  testSort<int8_t>(256);
+  testSort<int16_t>(1 << 16);
+  testSort<int32_t>(1'000);
+  testSort<int32_t>(std::numeric_limits<uint32_t>::max());
+  testSort<int64_t>(std::numeric_limits<uint64_t>::max());
+  testSort<uint64_t>(std::numeric_limits<uint64_t>::max());
+}
+
+TEST(ValueSorterTest, floatingPoint) {
+  testSort<double>(1'000'000);
+  testSort<float>(1'000);
+}
+
+TEST(ValueSorterTest, sortBy) {
+  std::vector<std::string> values;
+  for (auto i = 0; i < 100; ++i) {
+    values.push_back(std::to_string((i * 37) % 100));
+  }
+  auto expected = values;
+  std::sort(expected.begin(), expected.end());
+  ValueSorter<std::string>::sortBy(
+      values.data(), values.data() + values.size(), std::less<std::string>());
+  EXPECT_EQ(expected, values);
+}
@@ -47,6 +47,14 @@ struct PlusFunction {
   call(TInput& result, const TInput& a, const TInput& b) {
     result = plus(a, b);
   }
+
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  callBatch(TInput* result, int32_t size, const TInput* a, const TInput* b) {
+    for (auto i = 0; i < size; ++i) {
+      result[i] = plus(a[i], b[i]);
+    }
+  }
 };
 
 template <typename T>
@@ -56,6 +64,14 @@ struct MinusFunction {
   call(TInput& result, const TInput& a, const TInput& b) {
     result = minus(a, b);
   }
+
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  callBatch(TInput* result, int32_t size, const TInput* a, const TInput* b) {
+    for (auto i = 0; i < size; ++i) {
+      result[i] = minus(a[i], b[i]);
+    }
+  }
 };
 
 template <typename T>
@@ -65,6 +81,14 @@ struct MultiplyFunction {
   call(TInput& result, const TInput& a, const TInput& b) {
     result = multiply(a, b);
   }
+
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  callBatch(TInput* result, int32_t size, const TInput* a, const TInput* b) {
+    for (auto i = 0; i < size; ++i) {
+      result[i] = multiply(a[i], b[i]);
+    }
+  }
 };
 
 template <typename T>
@@ -81,6 +105,20 @@ struct DivideFunction {
   {
     result = a / b;
   }
+
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  callBatch(TInput* result, int32_t size, const TInput* a, const TInput* b)
+#if defined(__has_feature)
+#if __has_feature(__address_sanitizer__)
+      __attribute__((__no_sanitize__("float-divide-by-zero")))
+#endif
+#endif
+  {
+    for (auto i = 0; i < size; ++i) {
+      result[i] = a[i] / b[i];
+    }
+  }
 };
 
 template <typename T>
@@ -14,11 +14,10 @@
  * limitations under the License.
  */
 
-#include <folly/container/F14Set.h>
-
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/VectorFunction.h"
+#include "velox/functions/lib/ArraySet.h"
 #include "velox/functions/lib/LambdaFunctionUtil.h"
 
 namespace facebook::velox::functions {
@@ -99,25 +98,25 @@ class ArrayDistinctFunction : public exec::VectorFunction {
     auto* rawSizes = newLengths->asMutable<vector_size_t>();
     auto* rawOffsets = newOffsets->asMutable<vector_size_t>();
 
-    // Process the rows: store unique values in the hash table.
-    folly::F14FastSet<T> uniqueSet;
+    // Process the rows: store unique values in a set that is reused across
+    // rows.
+    ArraySet<T> uniqueSet;
 
     rows.applyToSelected([&](vector_size_t row) {
       auto size = arrayVector->sizeAt(row);
       auto offset = arrayVector->offsetAt(row);
 
       rawOffsets[row] = indicesCursor;
-      bool hasNulls = false;
       for (vector_size_t i = offset; i < offset + size; ++i) {
         if (elements->isNullAt(i)) {
-          if (!hasNulls) {
-            hasNulls = true;
+          if (!uniqueSet.hasNull) {
+            uniqueSet.hasNull = true;
             rawNewIndices[indicesCursor++] = i;
           }
         } else {
           auto value = elements->valueAt<T>(i);
 
-          if (uniqueSet.insert(value).second) {
+          if (uniqueSet.insert(value)) {
             rawNewIndices[indicesCursor++] = i;
           }
         }
@@ -14,26 +14,11 @@
  * limitations under the License.
  */
 #include "velox/expression/VectorFunction.h"
+#include "velox/functions/lib/ArraySet.h"
 #include "velox/functions/lib/LambdaFunctionUtil.h"
 
 namespace facebook::velox::functions {
 namespace {
-template <typename T>
-
-struct SetWithNull {
-  SetWithNull(vector_size_t initialSetSize = kInitialSetSize) {
-    set.reserve(initialSetSize);
-  }
-
-  void reset() {
-    set.clear();
-    hasNull = false;
-  }
-
-  std::unordered_set<T> set;
-  bool hasNull{false};
-  static constexpr vector_size_t kInitialSetSize{128};
-};
 // Generates a set based on the elements of an ArrayVector. Note that we take
 // rightSet as a parameter (instead of returning a new one) to reuse the
 // allocated memory.
@@ -42,10 +27,10 @@ void generateSet(
     const ArrayVector* arrayVector,
     const TVector* arrayElements,
     vector_size_t idx,
-    SetWithNull<T>& rightSet) {
+    ArraySet<T>& rightSet) {
   auto size = arrayVector->sizeAt(idx);
   auto offset = arrayVector->offsetAt(idx);
-  rightSet.reset();
+  rightSet.clear();
 
   for (vector_size_t i = offset; i < (offset + size); ++i) {
     if (arrayElements->isNullAt(i)) {
@@ -54,9 +39,9 @@ void generateSet(
       // Function can be called with either FlatVector or DecodedVector, but
       // their APIs are slightly different.
       if constexpr (std::is_same_v<TVector, DecodedVector>) {
-        rightSet.set.insert(arrayElements->template valueAt<T>(i));
+        rightSet.insert(arrayElements->template valueAt<T>(i));
       } else {
-        rightSet.set.insert(arrayElements->valueAt(i));
+        rightSet.insert(arrayElements->valueAt(i));
       }
     }
   }
@@ -115,7 +100,7 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
   ArrayIntersectExceptFunction() = default;
 
   explicit ArrayIntersectExceptFunction(
-      SetWithNull<T> constantSet,
+      ArraySet<T> constantSet,
       bool isLeftConstant)
       : constantSet_(std::move(constantSet)), isLeftConstant_(isLeftConstant) {}
 
@@ -170,13 +155,13 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
     // apply it differently based on whether the right-hand side set is constant
     // or not.
     auto processRow = [&](vector_size_t row,
-                          const SetWithNull<T>& rightSet,
-                          SetWithNull<T>& outputSet) {
+                          const ArraySet<T>& rightSet,
+                          ArraySet<T>& outputSet) {
       auto idx = decodedLeftArray->index(row);
       auto size = baseLeftArray->sizeAt(idx);
       auto offset = baseLeftArray->offsetAt(idx);
 
-      outputSet.reset();
+      outputSet.clear();
       *rawNewOffsets = indicesCursor;
 
       // Scans the array elements on the left-hand side.
@@ -204,13 +189,12 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
           // (check outputSet).
           bool addValue = false;
           if constexpr (isIntersect) {
-            addValue = rightSet.set.count(val) > 0;
+            addValue = rightSet.contains(val);
           } else {
-            addValue = rightSet.set.count(val) == 0;
+            addValue = !rightSet.contains(val);
           }
           if (addValue) {
-            auto it = outputSet.set.insert(val);
-            if (it.second) {
+            if (outputSet.insert(val)) {
               rawNewIndices[indicesCursor++] = i;
             }
           }
@@ -221,7 +205,7 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
       ++rawNewOffsets;
     };
 
-    SetWithNull<T> outputSet;
+    ArraySet<T> outputSet;
 
     // Optimized case when the right-hand side array is constant.
     if (constantSet_.has_value()) {
@@ -237,11 +221,17 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
       exec::LocalDecodedVector rightElementsHolder(context);
       auto decodedRightElements =
           decodeArrayElements(rightHolder, rightElementsHolder, rows);
-      SetWithNull<T> rightSet;
+      ArraySet<T> rightSet;
       auto rightArrayVector = rightHolder.get()->base()->as<ArrayVector>();
+      // The set is only rebuilt when the right-hand side array changes, so a
+      // right-hand side that is constant in this batch is hashed once.
+      vector_size_t setIdx = -1;
       rows.applyToSelected([&](vector_size_t row) {
         auto idx = rightHolder.get()->index(row);
-        generateSet<T>(rightArrayVector, decodedRightElements, idx, rightSet);
+        if (idx != setIdx) {
+          generateSet<T>(rightArrayVector, decodedRightElements, idx, rightSet);
+          setIdx = idx;
+        }
         processRow(row, rightSet, outputSet);
       });
     }
@@ -263,7 +253,7 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
   // If one of the arrays is constant, this member will store a pointer to the
   // set generated from its elements, which is calculated only once, before
   // instantiating this object.
-  std::optional<SetWithNull<T>> constantSet_;
+  std::optional<ArraySet<T>> constantSet_;
 
   // If there's a `constantSet`, whether it refers to left or right-hand side.
   const bool isLeftConstant_{false};
@@ -274,7 +264,7 @@ class ArraysOverlapFunction : public exec::VectorFunction {
  public:
   ArraysOverlapFunction() = default;
 
-  ArraysOverlapFunction(SetWithNull<T> constantSet, bool isLeftConstant)
+  ArraysOverlapFunction(ArraySet<T> constantSet, bool isLeftConstant)
       : constantSet_(std::move(constantSet)), isLeftConstant_(isLeftConstant) {}
 
   void apply(
@@ -296,7 +286,7 @@ class ArraysOverlapFunction : public exec::VectorFunction {
     auto baseLeftArray = decodedLeftArray->base()->as<ArrayVector>();
     context.ensureWritable(rows, BOOLEAN(), result);
     auto resultBoolVector = result->template asFlatVector<bool>();
-    auto processRow = [&](auto row, const SetWithNull<T>& rightSet) {
+    auto processRow = [&](auto row, const ArraySet<T>& rightSet) {
       auto idx = decodedLeftArray->index(row);
       auto offset = baseLeftArray->offsetAt(idx);
       auto size = baseLeftArray->sizeAt(idx);
@@ -308,7 +298,7 @@ class ArraysOverlapFunction : public exec::VectorFunction {
           hasNull = true;
           continue;
         }
-        if (rightSet.set.count(decodedLeftElements->valueAt<T>(i)) > 0) {
+        if (rightSet.contains(decodedLeftElements->valueAt<T>(i))) {
           // Found an overlapping element. Add to result set.
           resultBoolVector->set(row, true);
           return;
@@ -334,11 +324,17 @@ class ArraysOverlapFunction : public exec::VectorFunction {
       exec::LocalDecodedVector rightElementsDecoder(context);
       auto decodedRightElements =
           decodeArrayElements(rightDecoder, rightElementsDecoder, rows);
-      SetWithNull<T> rightSet;
+      ArraySet<T> rightSet;
       auto baseRightArray = rightDecoder.get()->base()->as<ArrayVector>();
+      // The set is only rebuilt when the right-hand side array changes, so a
+      // right-hand side that is constant in this batch is hashed once.
+      vector_size_t setIdx = -1;
       rows.applyToSelected([&](vector_size_t row) {
         auto idx = rightDecoder.get()->index(row);
-        generateSet<T>(baseRightArray, decodedRightElements, idx, rightSet);
+        if (idx != setIdx) {
+          generateSet<T>(baseRightArray, decodedRightElements, idx, rightSet);
+          setIdx = idx;
+        }
         processRow(row, rightSet);
       });
     }
@@ -348,7 +344,7 @@ class ArraysOverlapFunction : public exec::VectorFunction {
   // If one of the arrays is constant, this member will store a pointer to the
   // set generated from its elements, which is calculated only once, before
   // instantiating this object.
-  std::optional<SetWithNull<T>> constantSet_;
+  std::optional<ArraySet<T>> constantSet_;
 
   // If there's a `constantSet`, whether it refers to left or right-hand side.
   const bool isLeftConstant_{false};
@@ -383,7 +379,7 @@ void validateMatchingArrayTypes(
 }
 
 template <typename T>
-SetWithNull<T> validateConstantVectorAndGenerateSet(
+ArraySet<T> validateConstantVectorAndGenerateSet(
     const BaseVector* baseVector) {
   auto constantVector = baseVector->as<ConstantVector<velox::ComplexType>>();
   auto constantArray = constantVector->as<ConstantVector<velox::ComplexType>>();
@@ -395,7 +391,7 @@ SetWithNull<T> validateConstantVectorAndGenerateSet(
   VELOX_CHECK_NOT_NULL(
       elementsAsFlatVector, "constant value must be encoded as flat");
   auto idx = constantArray->index();
-  SetWithNull<T> constantSet;
+  ArraySet<T> constantSet;
   generateSet<T>(arrayVecPtr, elementsAsFlatVector, idx, constantSet);
   return constantSet;
 }
@@ -420,7 +416,7 @@ std::shared_ptr<exec::VectorFunction> createTypedArraysIntersectExcept(
     }
   }
   BaseVector* constantVector = isLeftConstant ? left : right;
-  SetWithNull<T> constantSet =
+  ArraySet<T> constantSet =
       validateConstantVectorAndGenerateSet<T>(constantVector);
   return std::make_shared<ArrayIntersectExceptFunction<isIntersect, T>>(
       std::move(constantSet), isLeftConstant);
@@ -20,6 +20,7 @@
 #include "velox/expression/Expr.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/functions/lib/LambdaFunctionUtil.h"
+#include "velox/functions/lib/ValueSorter.h"
 
 namespace facebook::velox::functions {
 namespace {
@@ -100,6 +101,7 @@ void applyScalarType(
       decodedElements->base(), inputElementRows, /*toSourceRow=*/nullptr);
 
   auto flatResults = resultElements->asFlatVector<T>();
+  ValueSorter<T> sorter;
 
   auto processRow = [&](vector_size_t row) {
     const auto size = inputArray->sizeAt(row);
@@ -127,7 +129,17 @@ void applyScalarType(
       bits::fillBits(rawBits, endZeroRow, endRow, bits::kNotNull);
     } else {
       T* resultRawValues = flatResults->mutableRawValues();
-      std::sort(resultRawValues + startRow, resultRawValues + endRow);
+      if constexpr (std::is_arithmetic_v<T>) {
+        sorter.sort(
+            resultRawValues + startRow,
+            resultRawValues + endRow,
+            /*ascending=*/true);
+      } else {
+        sorter.sortBy(
+            resultRawValues + startRow,
+            resultRawValues + endRow,
+            std::less<T>());
+      }
     }
   };
   rows.applyToSelected(processRow);
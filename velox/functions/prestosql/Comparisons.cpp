@@ -38,60 +38,79 @@ struct SimdComparator {
     return d_type::load_unaligned(rawData + offset);
   }
 
+  // Returns the comparison results for the 64 rows starting at 'offset' as
+  // one word, one batch compare and movemask per 'd_type::size' rows.
   template <typename T, bool isLeftConstant, bool isRightConstant>
-  void applySimdComparison(
-      const vector_size_t begin,
-      const vector_size_t end,
+  inline uint64_t compareWord(
       const T* rawLhs,
       const T* rawRhs,
-      uint8_t* rawResult) {
+      vector_size_t offset) {
     using d_type = xsimd::batch<T>;
     constexpr auto numScalarElements = d_type::size;
-    const auto vectorEnd = (end - begin) - (end - begin) % numScalarElements;
-
-    if constexpr (numScalarElements == 2 || numScalarElements == 4) {
-      for (auto i = begin; i < vectorEnd; i += 8) {
-        rawResult[i / 8] = 0;
-        for (auto j = 0; j < 8 && j < vectorEnd; j += numScalarElements) {
-          auto left = loadSimdData<T, isLeftConstant>(rawLhs, i + j);
-          auto right = loadSimdData<T, isRightConstant>(rawRhs, i + j);
-
-          uint8_t res = simd::toBitMask(ComparisonOp()(left, right));
-          rawResult[i / 8] |= res << j;
-        }
-      }
-    } else {
-      for (auto i = begin; i < vectorEnd; i += numScalarElements) {
-        auto left = loadSimdData<T, isLeftConstant>(rawLhs, i);
-        auto right = loadSimdData<T, isRightConstant>(rawRhs, i);
-
-        auto res = simd::toBitMask(ComparisonOp()(left, right));
-        if constexpr (numScalarElements == 8) {
-          rawResult[i / 8] = res;
-        } else if constexpr (numScalarElements == 16) {
-          uint16_t* addr = reinterpret_cast<uint16_t*>(rawResult + i / 8);
-          *addr = res;
-        } else if constexpr (numScalarElements == 32) {
-          uint32_t* addr = reinterpret_cast<uint32_t*>(rawResult + i / 8);
-          *addr = res;
-        } else {
-          VELOX_FAIL("Unsupported number of scalar elements");
-        }
-      }
+    static_assert(64 % numScalarElements == 0);
+    // Unsigned so that the mask of the top lanes is not sign extended.
+    using MaskType = std::conditional_t<
+        numScalarElements <= 8,
+        uint8_t,
+        std::conditional_t<
+            numScalarElements == 16,
+            uint16_t,
+            std::conditional_t<numScalarElements == 32, uint32_t, uint64_t>>>;
+    uint64_t word = 0;
+    for (auto j = 0; j < 64; j += numScalarElements) {
+      auto left = loadSimdData<T, isLeftConstant>(rawLhs, offset + j);
+      auto right = loadSimdData<T, isRightConstant>(rawRhs, offset + j);
+      const MaskType mask = simd::toBitMask(ComparisonOp()(left, right));
+      word |= static_cast<uint64_t>(mask) << j;
     }
+    return word;
+  }
+
+  template <typename T, bool isLeftConstant, bool isRightConstant>
+  inline bool compareRow(const T* rawLhs, const T* rawRhs, vector_size_t row) {
+    return ComparisonOp()(
+        rawLhs[isLeftConstant ? 0 : row], rawRhs[isRightConstant ? 0 : row]);
+  }
 
-    // Evaluate remaining values.
-    for (auto i = vectorEnd; i < end; i++) {
-      if constexpr (isRightConstant && isLeftConstant) {
-        bits::setBit(rawResult, i, ComparisonOp()(rawLhs[0], rawRhs[0]));
-      } else if constexpr (isRightConstant) {
-        bits::setBit(rawResult, i, ComparisonOp()(rawLhs[i], rawRhs[0]));
-      } else if constexpr (isLeftConstant) {
-        bits::setBit(rawResult, i, ComparisonOp()(rawLhs[0], rawRhs[i]));
+  // Writes the result bits of 'rows' 64 at a time. A word of results is
+  // computed for every 64 rows that the vectors cover, whether or not all
+  // of them are selected, and merged into 'rawResult' under the mask of
+  // 'rows' so that the values of the rows that are not selected are kept.
+  // Only the last partial word is compared row by row.
+  template <typename T, bool isLeftConstant, bool isRightConstant>
+  void applySimdComparison(
+      const SelectivityVector& rows,
+      const T* rawLhs,
+      const T* rawRhs,
+      uint64_t* rawResult) {
+    const auto begin = rows.begin();
+    const auto end = rows.end();
+    const uint64_t* rowBits = rows.asRange().bits();
+    if constexpr (isLeftConstant && isRightConstant) {
+      if (ComparisonOp()(rawLhs[0], rawRhs[0])) {
+        bits::orBits(rawResult, rowBits, begin, end);
       } else {
-        bits::setBit(rawResult, i, ComparisonOp()(rawLhs[i], rawRhs[i]));
+        bits::andWithNegatedBits(rawResult, rowBits, begin, end);
       }
+      return;
+    }
+    const bool allSelected = rows.isAllSelected();
+    // The first word may start before 'begin', reading values of rows below
+    // 'begin', which are inside the vectors.
+    vector_size_t offset = begin & ~63;
+    for (; offset + 64 <= end; offset += 64) {
+      const auto word = compareWord<T, isLeftConstant, isRightConstant>(
+          rawLhs, rawRhs, offset);
+      const auto index = offset / 64;
+      const uint64_t mask = allSelected ? ~0ULL : rowBits[index];
+      rawResult[index] = (rawResult[index] & ~mask) | (word & mask);
     }
+    bits::forEachSetBit(rowBits, std::max(offset, begin), end, [&](auto row) {
+      bits::setBit(
+          rawResult,
+          row,
+          compareRow<T, isLeftConstant, isRightConstant>(rawLhs, rawRhs, row));
+    });
   }
 
   template <
@@ -110,11 +129,10 @@ struct SimdComparator {
     using T = typename TypeTraits<kind>::NativeType;
 
     auto resultVector = result->asUnchecked<FlatVector<bool>>();
-    auto rawResult = resultVector->mutableRawValues<uint8_t>();
+    auto rawResult = resultVector->mutableRawValues<uint64_t>();
 
     auto isSimdizable = (lhs.isConstantEncoding() || lhs.isFlatEncoding()) &&
-        (rhs.isConstantEncoding() || rhs.isFlatEncoding()) &&
-        rows.isAllSelected();
+        (rhs.isConstantEncoding() || rhs.isFlatEncoding());
 
     if (!isSimdizable) {
       exec::LocalDecodedVector lhsDecoded(context, lhs, rows);
@@ -132,23 +150,19 @@ struct SimdComparator {
     if (lhs.isConstantEncoding() && rhs.isConstantEncoding()) {
       auto l = lhs.asUnchecked<ConstantVector<T>>()->valueAt(0);
       auto r = rhs.asUnchecked<ConstantVector<T>>()->valueAt(0);
-      applySimdComparison<T, true, true>(
-          rows.begin(), rows.end(), &l, &r, rawResult);
+      applySimdComparison<T, true, true>(rows, &l, &r, rawResult);
     } else if (lhs.isConstantEncoding()) {
       auto l = lhs.asUnchecked<ConstantVector<T>>()->valueAt(0);
       auto rawRhs = rhs.asUnchecked<FlatVector<T>>()->rawValues();
-      applySimdComparison<T, true, false>(
-          rows.begin(), rows.end(), &l, rawRhs, rawResult);
+      applySimdComparison<T, true, false>(rows, &l, rawRhs, rawResult);
     } else if (rhs.isConstantEncoding()) {
       auto rawLhs = lhs.asUnchecked<FlatVector<T>>()->rawValues();
       auto r = rhs.asUnchecked<ConstantVector<T>>()->valueAt(0);
-      applySimdComparison<T, false, true>(
-          rows.begin(), rows.end(), rawLhs, &r, rawResult);
+      applySimdComparison<T, false, true>(rows, rawLhs, &r, rawResult);
     } else {
       auto rawLhs = lhs.asUnchecked<FlatVector<T>>()->rawValues();
       auto rawRhs = rhs.asUnchecked<FlatVector<T>>()->rawValues();
-      applySimdComparison<T, false, false>(
-          rows.begin(), rows.end(), rawLhs, rawRhs, rawResult);
+      applySimdComparison<T, false, false>(rows, rawLhs, rawRhs, rawResult);
     }
 
     resultVector->clearNulls(rows);
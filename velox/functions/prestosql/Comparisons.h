@@ -15,19 +15,59 @@
  */
 #pragma once
 
+#include <algorithm>
+
+#include "velox/common/base/BitUtil.h"
 #include "velox/common/base/CompareFlags.h"
 #include "velox/functions/Macros.h"
 
 namespace facebook::velox::functions {
-#define VELOX_GEN_BINARY_EXPR(Name, Expr, TResult)                \
-  template <typename T>                                           \
-  struct Name {                                                   \
-    VELOX_DEFINE_FUNCTION_TYPES(T);                               \
-    template <typename TInput>                                    \
-    FOLLY_ALWAYS_INLINE void                                      \
-    call(TResult& result, const TInput& lhs, const TInput& rhs) { \
-      result = (Expr);                                            \
-    }                                                             \
+
+// Sets the bits of 'result' to 'compare' of the first 'size' values of 'lhs'
+// and 'rhs'. Fills a word at a time and keeps the bits of the last word past
+// 'size'.
+template <typename TInput, typename TCompare>
+FOLLY_ALWAYS_INLINE void compareBatch(
+    uint64_t* result,
+    int32_t size,
+    const TInput* lhs,
+    const TInput* rhs,
+    TCompare compare) {
+  for (auto begin = 0; begin < size; begin += 64) {
+    const auto end = std::min(begin + 64, size);
+    uint64_t word = 0;
+    for (auto i = begin; i < end; ++i) {
+      word |= static_cast<uint64_t>(compare(lhs[i], rhs[i])) << (i - begin);
+    }
+    if (end - begin < 64) {
+      const auto mask = bits::lowMask(end - begin);
+      word |= result[begin / 64] & ~mask;
+    }
+    result[begin / 64] = word;
+  }
+}
+
+#define VELOX_GEN_BINARY_EXPR(Name, Expr, TResult)                         \
+  template <typename T>                                                    \
+  struct Name {                                                            \
+    VELOX_DEFINE_FUNCTION_TYPES(T);                                        \
+    template <typename TInput>                                             \
+    FOLLY_ALWAYS_INLINE void                                               \
+    call(TResult& result, const TInput& lhs, const TInput& rhs) {          \
+      result = (Expr);                                                     \
+    }                                                                      \
+                                                                           \
+    template <typename TInput>                                             \
+    FOLLY_ALWAYS_INLINE void callBatch(                                    \
+        uint64_t* result,                                                  \
+        int32_t size,                                                      \
+        const TInput* lhs,                                                 \
+        const TInput* rhs) {                                               \
+      compareBatch(                                                        \
+          result, size, lhs, rhs, [](const auto& lhs, const auto& rhs) {   \
+            return (Expr);                                                 \
+          });                                                              \
+    }                                                                      \
   };
 
 VELOX_GEN_BINARY_EXPR(NeqFunction, lhs != rhs, bool);
@@ -70,6 +110,17 @@ struct EqFunction {
     out = (lhs == rhs);
   }
 
+  template <typename TInput>
+  void callBatch(
+      uint64_t* result,
+      int32_t size,
+      const TInput* lhs,
+      const TInput* rhs) {
+    compareBatch(result, size, lhs, rhs, [](const auto& lhs, const auto& rhs) {
+      return lhs == rhs;
+    });
+  }
+
   // For arbitrary nested complex types. Can return null.
   bool call(
       bool& out,
@@ -23,6 +23,7 @@
 #include "velox/functions/prestosql/DateTimeImpl.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
 #include "velox/type/Type.h"
+#include "velox/type/tz/TimeZoneConverter.h"
 #include "velox/type/tz/TimeZoneMap.h"
 
 namespace facebook::velox::functions {
@@ -77,6 +78,25 @@ FOLLY_ALWAYS_INLINE const date::time_zone* getTimeZoneFromConfig(
   return nullptr;
 }
 
+// Returns a converter for the session time zone if timestamps are adjusted to
+// it. The converter caches the offset of the last conversion.
+FOLLY_ALWAYS_INLINE std::optional<util::TimeZoneConverter>
+getTimeZoneConverterFromConfig(const core::QueryConfig& config) {
+  if (auto* timeZone = getTimeZoneFromConfig(config)) {
+    return util::TimeZoneConverter(timeZone);
+  }
+  return std::nullopt;
+}
+
+FOLLY_ALWAYS_INLINE int64_t getSeconds(
+    Timestamp timestamp,
+    std::optional<util::TimeZoneConverter>& timeZone) {
+  if (timeZone.has_value()) {
+    return timeZone->toLocal(timestamp.getSeconds());
+  }
+  return timestamp.getSeconds();
+}
+
 FOLLY_ALWAYS_INLINE int64_t
 getSeconds(Timestamp timestamp, const date::time_zone* timeZone) {
   if (timeZone != nullptr) {
@@ -95,6 +115,16 @@ std::tm getDateTime(Timestamp timestamp, const date::time_zone* timeZone) {
   return dateTime;
 }
 
+FOLLY_ALWAYS_INLINE
+std::tm getDateTime(
+    Timestamp timestamp,
+    std::optional<util::TimeZoneConverter>& timeZone) {
+  int64_t seconds = getSeconds(timestamp, timeZone);
+  std::tm dateTime;
+  gmtime_r((const time_t*)&seconds, &dateTime);
+  return dateTime;
+}
+
 FOLLY_ALWAYS_INLINE
 std::tm getDateTime(Date date) {
   int64_t seconds = date.days() * kSecondsInDay;
@@ -106,12 +136,12 @@ std::tm getDateTime(Date date) {
 template <typename T>
 struct InitSessionTimezone {
   VELOX_DEFINE_FUNCTION_TYPES(T);
-  const date::time_zone* timeZone_{nullptr};
+  std::optional<util::TimeZoneConverter> timeZone_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
       const arg_type<Timestamp>* /*timestamp*/) {
-    timeZone_ = getTimeZoneFromConfig(config);
+    timeZone_ = getTimeZoneConverterFromConfig(config);
   }
 };
 
@@ -547,14 +577,14 @@ template <typename T>
 struct DateTruncFunction : public TimestampWithTimezoneSupport<T> {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
-  const date::time_zone* timeZone_ = nullptr;
+  std::optional<util::TimeZoneConverter> timeZone_;
   std::optional<DateTimeUnit> unit_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
       const arg_type<Varchar>* unitString,
       const arg_type<Timestamp>* /*timestamp*/) {
-    timeZone_ = getTimeZoneFromConfig(config);
+    timeZone_ = getTimeZoneConverterFromConfig(config);
 
     if (unitString != nullptr) {
       unit_ = getTimestampUnit(*unitString);
@@ -627,8 +657,8 @@ struct DateTruncFunction : public TimestampWithTimezoneSupport<T> {
     adjustDateTime(dateTime, unit);
 
     result = Timestamp(timegm(&dateTime), 0);
-    if (timeZone_ != nullptr) {
-      result.toGMT(*timeZone_);
+    if (timeZone_.has_value()) {
+      result = Timestamp(timeZone_->toGMT(result.getSeconds()), 0);
     }
   }
 
@@ -687,7 +717,7 @@ template <typename T>
 struct DateAddFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
-  const date::time_zone* sessionTimeZone_ = nullptr;
+  std::optional<util::TimeZoneConverter> sessionTimeZone_;
   std::optional<DateTimeUnit> unit_ = std::nullopt;
 
   FOLLY_ALWAYS_INLINE void initialize(
@@ -695,7 +725,7 @@ struct DateAddFunction {
       const arg_type<Varchar>* unitString,
       const int64_t* /*value*/,
       const arg_type<Timestamp>* /*timestamp*/) {
-    sessionTimeZone_ = getTimeZoneFromConfig(config);
+    sessionTimeZone_ = getTimeZoneConverterFromConfig(config);
     if (unitString != nullptr) {
       unit_ = fromDateTimeUnitString(*unitString, false /*throwIfInvalid*/);
     }
@@ -724,11 +754,12 @@ struct DateAddFunction {
       VELOX_UNSUPPORTED("integer overflow");
     }
 
-    if (LIKELY(sessionTimeZone_ != nullptr)) {
+    if (LIKELY(sessionTimeZone_.has_value())) {
       // sessionTimeZone not null means that the config
       // adjust_timestamp_to_timezone is on.
-      Timestamp zonedTimestamp = timestamp;
-      zonedTimestamp.toTimezone(*sessionTimeZone_);
+      const Timestamp zonedTimestamp(
+          sessionTimeZone_->toLocal(timestamp.getSeconds()),
+          timestamp.getNanos());
 
       Timestamp resultTimestamp =
           addToTimestamp(zonedTimestamp, unit, (int32_t)value);
@@ -739,8 +770,9 @@ struct DateAddFunction {
         result = Timestamp(
             resultTimestamp.getSeconds() + offset, resultTimestamp.getNanos());
       } else {
-        resultTimestamp.toGMT(*sessionTimeZone_);
-        result = resultTimestamp;
+        result = Timestamp(
+            sessionTimeZone_->toGMT(resultTimestamp.getSeconds()),
+            resultTimestamp.getNanos());
       }
     } else {
       result = addToTimestamp(timestamp, unit, (int32_t)value);
@@ -771,7 +803,7 @@ template <typename T>
 struct DateDiffFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
-  const date::time_zone* sessionTimeZone_ = nullptr;
+  std::optional<util::TimeZoneConverter> sessionTimeZone_;
   std::optional<DateTimeUnit> unit_ = std::nullopt;
 
   FOLLY_ALWAYS_INLINE void initialize(
@@ -783,7 +815,7 @@ struct DateDiffFunction {
       unit_ = fromDateTimeUnitString(*unitString, false /*throwIfInvalid*/);
     }
 
-    sessionTimeZone_ = getTimeZoneFromConfig(config);
+    sessionTimeZone_ = getTimeZoneConverterFromConfig(config);
   }
 
   FOLLY_ALWAYS_INLINE void initialize(
@@ -805,11 +837,12 @@ struct DateDiffFunction {
         ? unit_.value()
         : fromDateTimeUnitString(unitString, true /*throwIfInvalid*/).value();
 
-    if (LIKELY(sessionTimeZone_ != nullptr)) {
+    if (LIKELY(sessionTimeZone_.has_value())) {
       // sessionTimeZone not null means that the config
       // adjust_timestamp_to_timezone is on.
-      Timestamp fromZonedTimestamp = timestamp1;
-      fromZonedTimestamp.toTimezone(*sessionTimeZone_);
+      const Timestamp fromZonedTimestamp(
+          sessionTimeZone_->toLocal(timestamp1.getSeconds()),
+          timestamp1.getNanos());
 
       Timestamp toZonedTimestamp = timestamp2;
       if (isTimeUnit(unit)) {
@@ -819,7 +852,9 @@ struct DateDiffFunction {
             toZonedTimestamp.getSeconds() - offset,
             toZonedTimestamp.getNanos());
       } else {
-        toZonedTimestamp.toTimezone(*sessionTimeZone_);
+        toZonedTimestamp = Timestamp(
+            sessionTimeZone_->toLocal(toZonedTimestamp.getSeconds()),
+            toZonedTimestamp.getNanos());
       }
       result = diffTimestamp(unit, fromZonedTimestamp, toZonedTimestamp);
     } else {
@@ -20,15 +20,30 @@
 namespace facebook::velox::functions {
 namespace {
 
+// Returns 'value' scaled up by 'multiplier' in the native type of R without
+// checking for overflow. Only used when the precisions of the arguments
+// guarantee that the result fits in R.
+template <typename R, typename T>
+inline auto uncheckedRescale(const T& value, const int128_t& multiplier) {
+  using TNative = decltype(std::declval<R>().unscaledValue());
+  return static_cast<TNative>(value.unscaledValue()) *
+      static_cast<TNative>(multiplier);
+}
+
+/// 'checkOverflow' is false if the precisions of the arguments guarantee that
+/// neither the rescaling nor the operation can overflow, in which case the
+/// per-row overflow checks are compiled out.
 template <
     typename R /* Result Type */,
     typename A /* Argument1 */,
     typename B /* Argument2 */,
-    typename Operation /* Arithmetic operation */>
+    typename Operation /* Arithmetic operation */,
+    bool checkOverflow>
 class DecimalBaseFunction : public exec::VectorFunction {
  public:
   DecimalBaseFunction(uint8_t aRescale, uint8_t bRescale)
-      : aRescale_(aRescale), bRescale_(bRescale) {}
+      : aMultiplier_(DecimalUtil::kPowersOfTen[aRescale]),
+        bMultiplier_(DecimalUtil::kPowersOfTen[bRescale]) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -37,14 +52,21 @@ class DecimalBaseFunction : public exec::VectorFunction {
       exec::EvalCtx& context,
       VectorPtr& result) const override {
     auto rawResults = prepareResults(rows, resultType, context, result);
+    // Copied to locals so that the compiler can keep them in registers.
+    const auto aMultiplier = aMultiplier_;
+    const auto bMultiplier = bMultiplier_;
     if (args[0]->isConstantEncoding() && args[1]->isFlatEncoding()) {
       // Fast path for (const, flat).
       auto constant = args[0]->asUnchecked<SimpleVector<A>>()->valueAt(0);
       auto flatValues = args[1]->asUnchecked<FlatVector<B>>();
       auto rawValues = flatValues->mutableRawValues();
       context.applyToSelectedNoThrow(rows, [&](auto row) {
-        Operation::template apply<R, A, B>(
-            rawResults[row], constant, rawValues[row], aRescale_, bRescale_);
+        Operation::template apply<R, A, B, checkOverflow>(
+            rawResults[row],
+            constant,
+            rawValues[row],
+            aMultiplier,
+            bMultiplier);
       });
     } else if (args[0]->isFlatEncoding() && args[1]->isConstantEncoding()) {
       // Fast path for (flat, const).
@@ -52,8 +74,12 @@ class DecimalBaseFunction : public exec::VectorFunction {
       auto constant = args[1]->asUnchecked<SimpleVector<B>>()->valueAt(0);
       auto rawValues = flatValues->mutableRawValues();
       context.applyToSelectedNoThrow(rows, [&](auto row) {
-        Operation::template apply<R, A, B>(
-            rawResults[row], rawValues[row], constant, aRescale_, bRescale_);
+        Operation::template apply<R, A, B, checkOverflow>(
+            rawResults[row],
+            rawValues[row],
+            constant,
+            aMultiplier,
+            bMultiplier);
       });
     } else if (args[0]->isFlatEncoding() && args[1]->isFlatEncoding()) {
       // Fast path for (flat, flat).
@@ -62,8 +88,8 @@ class DecimalBaseFunction : public exec::VectorFunction {
       auto flatB = args[1]->asUnchecked<FlatVector<B>>();
       auto rawB = flatB->mutableRawValues();
       context.applyToSelectedNoThrow(rows, [&](auto row) {
-        Operation::template apply<R, A, B>(
-            rawResults[row], rawA[row], rawB[row], aRescale_, bRescale_);
+        Operation::template apply<R, A, B, checkOverflow>(
+            rawResults[row], rawA[row], rawB[row], aMultiplier, bMultiplier);
       });
     } else {
       // Fast path if one or more arguments are encoded.
@@ -71,12 +97,12 @@ class DecimalBaseFunction : public exec::VectorFunction {
       auto a = decodedArgs.at(0);
       auto b = decodedArgs.at(1);
       context.applyToSelectedNoThrow(rows, [&](auto row) {
-        Operation::template apply<R, A, B>(
+        Operation::template apply<R, A, B, checkOverflow>(
             rawResults[row],
             a->valueAt<A>(row),
             b->valueAt<B>(row),
-            aRescale_,
-            bRescale_);
+            aMultiplier,
+            bMultiplier);
       });
     }
   }
@@ -92,31 +118,35 @@ class DecimalBaseFunction : public exec::VectorFunction {
     return result->asUnchecked<FlatVector<R>>()->mutableRawValues();
   }
 
-  const uint8_t aRescale_;
-  const uint8_t bRescale_;
+  // 10 to the power of the rescale factors of the arguments.
+  const int128_t aMultiplier_;
+  const int128_t bMultiplier_;
 };
 
 class Addition {
  public:
-  template <typename R, typename A, typename B>
-  inline static void
-  apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t bRescale)
+  template <typename R, typename A, typename B, bool checkOverflow>
+  inline static void apply(
+      R& r,
+      const A& a,
+      const B& b,
+      const int128_t& aMultiplier,
+      const int128_t& bMultiplier)
 #if defined(__has_feature)
 #if __has_feature(__address_sanitizer__)
       __attribute__((__no_sanitize__("signed-integer-overflow")))
 #endif
 #endif
   {
+    if constexpr (!checkOverflow) {
+      r = R(uncheckedRescale<R>(a, aMultiplier) +
+            uncheckedRescale<R>(b, bMultiplier));
+      return;
+    }
     int128_t aRescaled;
     int128_t bRescaled;
-    if (__builtin_mul_overflow(
-            a.unscaledValue(),
-            DecimalUtil::kPowersOfTen[aRescale],
-            &aRescaled) ||
-        __builtin_mul_overflow(
-            b.unscaledValue(),
-            DecimalUtil::kPowersOfTen[bRescale],
-            &bRescaled)) {
+    if (__builtin_mul_overflow(a.unscaledValue(), aMultiplier, &aRescaled) ||
+        __builtin_mul_overflow(b.unscaledValue(), bMultiplier, &bRescaled)) {
       VELOX_ARITHMETIC_ERROR(
           "Decimal overflow: {} + {}", a.unscaledValue(), b.unscaledValue());
     }
@@ -140,29 +170,43 @@ class Addition {
                 std::max(aScale, bScale) + 1),
         std::max(aScale, bScale)};
   }
+
+  // The rescaled arguments have at most max(aPrecision + aRescale,
+  // bPrecision + bRescale) digits and their sum one more.
+  inline static bool mayOverflow(
+      uint8_t aPrecision,
+      uint8_t aRescale,
+      uint8_t bPrecision,
+      uint8_t bRescale) {
+    return std::max(aPrecision + aRescale, bPrecision + bRescale) + 1 >
+        DecimalType<TypeKind::LONG_DECIMAL>::kMaxPrecision;
+  }
 };
 
 class Subtraction {
  public:
-  template <typename R, typename A, typename B>
-  inline static void
-  apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t bRescale)
+  template <typename R, typename A, typename B, bool checkOverflow>
+  inline static void apply(
+      R& r,
+      const A& a,
+      const B& b,
+      const int128_t& aMultiplier,
+      const int128_t& bMultiplier)
 #if defined(__has_feature)
 #if __has_feature(__address_sanitizer__)
       __attribute__((__no_sanitize__("signed-integer-overflow")))
 #endif
 #endif
   {
+    if constexpr (!checkOverflow) {
+      r = R(uncheckedRescale<R>(a, aMultiplier) -
+            uncheckedRescale<R>(b, bMultiplier));
+      return;
+    }
     int128_t aRescaled;
     int128_t bRescaled;
-    if (__builtin_mul_overflow(
-            a.unscaledValue(),
-            DecimalUtil::kPowersOfTen[aRescale],
-            &aRescaled) ||
-        __builtin_mul_overflow(
-            b.unscaledValue(),
-            DecimalUtil::kPowersOfTen[bRescale],
-            &bRescaled)) {
+    if (__builtin_mul_overflow(a.unscaledValue(), aMultiplier, &aRescaled) ||
+        __builtin_mul_overflow(b.unscaledValue(), bMultiplier, &bRescaled)) {
       VELOX_ARITHMETIC_ERROR(
           "Decimal overflow: {} - {}", a.unscaledValue(), b.unscaledValue());
     }
@@ -182,16 +226,31 @@ class Subtraction {
     return Addition::computeResultPrecisionScale(
         aPrecision, aScale, bPrecision, bScale);
   }
+
+  inline static bool mayOverflow(
+      uint8_t aPrecision,
+      uint8_t aRescale,
+      uint8_t bPrecision,
+      uint8_t bRescale) {
+    return Addition::mayOverflow(aPrecision, aRescale, bPrecision, bRescale);
+  }
 };
 
 class Multiply {
  public:
-  template <typename R, typename A, typename B>
-  inline static void
-  apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t bRescale) {
-    r = checkedMultiply<R>(
-        checkedMultiply<R>(R(a), R(b)),
-        R(DecimalUtil::kPowersOfTen[aRescale + bRescale]));
+  // The rescale factors of multiply are always 0, hence the multipliers are 1.
+  template <typename R, typename A, typename B, bool checkOverflow>
+  inline static void apply(
+      R& r,
+      const A& a,
+      const B& b,
+      const int128_t& /*aMultiplier*/,
+      const int128_t& /*bMultiplier*/) {
+    if constexpr (!checkOverflow) {
+      r = R(uncheckedRescale<R>(a, 1) * uncheckedRescale<R>(b, 1));
+    } else {
+      r = checkedMultiply<R>(R(a), R(b));
+    }
   }
 
   inline static uint8_t
@@ -206,13 +265,26 @@ class Multiply {
       const uint8_t bScale) {
     return {std::min(38, aPrecision + bPrecision), aScale + bScale};
   }
+
+  inline static bool mayOverflow(
+      uint8_t aPrecision,
+      uint8_t /*aRescale*/,
+      uint8_t bPrecision,
+      uint8_t /*bRescale*/) {
+    return aPrecision + bPrecision >
+        DecimalType<TypeKind::LONG_DECIMAL>::kMaxPrecision;
+  }
 };
 
 class Divide {
  public:
-  template <typename R, typename A, typename B>
-  inline static void
-  apply(R& r, const A& a, const B& b, uint8_t aRescale, uint8_t /*bRescale*/) {
+  template <typename R, typename A, typename B, bool checkOverflow>
+  inline static void apply(
+      R& r,
+      const A& a,
+      const B& b,
+      const int128_t& aMultiplier,
+      const int128_t& /*bMultiplier*/) {
     VELOX_CHECK_NE(b.unscaledValue(), 0, "Division by zero");
     int resultSign = 1;
     R unsignedDividendRescaled(a);
@@ -225,8 +297,13 @@ class Divide {
       resultSign *= -1;
       unsignedDivisor *= -1;
     }
-    unsignedDividendRescaled = checkedMultiply<R>(
-        unsignedDividendRescaled, R(DecimalUtil::kPowersOfTen[aRescale]));
+    if constexpr (!checkOverflow) {
+      unsignedDividendRescaled =
+          R(uncheckedRescale<R>(unsignedDividendRescaled, aMultiplier));
+    } else {
+      unsignedDividendRescaled =
+          checkedMultiply<R>(unsignedDividendRescaled, R(aMultiplier));
+    }
     R quotient = unsignedDividendRescaled / unsignedDivisor;
     R remainder = unsignedDividendRescaled % unsignedDivisor;
     if (remainder * 2 >= unsignedDivisor) {
@@ -249,6 +326,17 @@ class Divide {
         std::min(38, aPrecision + bScale + std::max(0, bScale - aScale)),
         std::max(aScale, bScale)};
   }
+
+  // Only the rescaling of the dividend can overflow. The quotient is not
+  // larger than the rescaled dividend.
+  inline static bool mayOverflow(
+      uint8_t aPrecision,
+      uint8_t aRescale,
+      uint8_t /*bPrecision*/,
+      uint8_t /*bRescale*/) {
+    return aPrecision + aRescale >
+        DecimalType<TypeKind::LONG_DECIMAL>::kMaxPrecision;
+  }
 };
 
 std::vector<std::shared_ptr<exec::FunctionSignature>>
@@ -301,6 +389,17 @@ std::vector<std::shared_ptr<exec::FunctionSignature>> decimalDivideSignature() {
               .build()};
 }
 
+template <typename R, typename A, typename B, typename Operation>
+std::shared_ptr<exec::VectorFunction>
+makeDecimalFunction(bool mayOverflow, uint8_t aRescale, uint8_t bRescale) {
+  if (mayOverflow) {
+    return std::make_shared<DecimalBaseFunction<R, A, B, Operation, true>>(
+        aRescale, bRescale);
+  }
+  return std::make_shared<DecimalBaseFunction<R, A, B, Operation, false>>(
+      aRescale, bRescale);
+}
+
 template <typename Operation>
 std::shared_ptr<exec::VectorFunction> createDecimalFunction(
     const std::string& name,
@@ -313,46 +412,50 @@ std::shared_ptr<exec::VectorFunction> createDecimalFunction(
       aPrecision, aScale, bPrecision, bScale);
   uint8_t aRescale = Operation::computeRescaleFactor(aScale, bScale, rScale);
   uint8_t bRescale = Operation::computeRescaleFactor(bScale, aScale, rScale);
+  // The result precision before clamping to 38 is at most 18 for a short
+  // decimal result, so comparing it with the long decimal precision suffices.
+  const bool mayOverflow =
+      Operation::mayOverflow(aPrecision, aRescale, bPrecision, bRescale);
   if (aType->kind() == TypeKind::SHORT_DECIMAL) {
     if (bType->kind() == TypeKind::SHORT_DECIMAL) {
       if (rPrecision > DecimalType<TypeKind::SHORT_DECIMAL>::kMaxPrecision) {
         // Arguments are short decimals and result is a long decimal.
-        return std::make_shared<DecimalBaseFunction<
+        return makeDecimalFunction<
             UnscaledLongDecimal /*result*/,
             UnscaledShortDecimal,
             UnscaledShortDecimal,
-            Operation>>(aRescale, bRescale);
+            Operation>(mayOverflow, aRescale, bRescale);
       } else {
         // Arguments are short decimals and result is a short decimal.
-        return std::make_shared<DecimalBaseFunction<
+        return makeDecimalFunction<
             UnscaledShortDecimal /*result*/,
             UnscaledShortDecimal,
             UnscaledShortDecimal,
-            Operation>>(aRescale, bRescale);
+            Operation>(mayOverflow, aRescale, bRescale);
       }
     } else {
       // LHS is short decimal and rhs is a long decimal, result is long decimal.
-      return std::make_shared<DecimalBaseFunction<
+      return makeDecimalFunction<
           UnscaledLongDecimal /*result*/,
           UnscaledShortDecimal,
           UnscaledLongDecimal,
-          Operation>>(aRescale, bRescale);
+          Operation>(mayOverflow, aRescale, bRescale);
     }
   } else {
     if (bType->kind() == TypeKind::SHORT_DECIMAL) {
       // LHS is long decimal and rhs is short decimal, result is a long decimal.
-      return std::make_shared<DecimalBaseFunction<
+      return makeDecimalFunction<
           UnscaledLongDecimal /*result*/,
           UnscaledLongDecimal,
           UnscaledShortDecimal,
-          Operation>>(aRescale, bRescale);
+          Operation>(mayOverflow, aRescale, bRescale);
     } else {
       // Arguments and result are all long decimals.
-      return std::make_shared<DecimalBaseFunction<
+      return makeDecimalFunction<
           UnscaledLongDecimal /*result*/,
           UnscaledLongDecimal,
           UnscaledLongDecimal,
-          Operation>>(aRescale, bRescale);
+          Operation>(mayOverflow, aRescale, bRescale);
     }
   }
   VELOX_UNSUPPORTED();
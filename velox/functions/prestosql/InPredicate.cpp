@@ -13,12 +13,27 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <folly/container/F14Set.h>
+
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/type/Filter.h"
 
 namespace facebook::velox::functions {
 namespace {
 
+// IN lists of at most this many values are tested by comparing with all
+// values at once instead of probing a hash table.
+constexpr int32_t kMaxSmallInList = 16;
+
+// Returns the size and up to the first 4 bytes of a string in one word. Equal
+// strings have equal keys, so comparing keys is a cheap pre-check.
+inline int64_t sizeAndPrefix(const char* data, uint32_t size) {
+  uint32_t prefix = 0;
+  memcpy(&prefix, data, std::min<uint32_t>(size, sizeof(prefix)));
+  return size | (static_cast<int64_t>(prefix) << 32);
+}
+
 template <typename T, typename U = T>
 std::optional<std::pair<std::vector<T>, bool>> toValues(
     const std::vector<exec::VectorFunctionArg>& inputArgs) {
@@ -98,7 +113,37 @@ std::unique_ptr<common::Filter> createBytesValuesFilter(
 class InPredicate : public exec::VectorFunction {
  public:
   explicit InPredicate(std::unique_ptr<common::Filter> filter)
-      : filter_{std::move(filter)} {}
+      : filter_{std::move(filter)} {
+    // Picks a strategy based on the type and the size of the IN list:
+    // - Integers that the filter would look up in a hash table are compared
+    //   with all values at once if there are few.
+    // - Few strings are compared by size and prefix with all values at once
+    //   before comparing the strings.
+    // - More strings are looked up in a set of StringViews, which does not
+    //   need to copy the value to probe, unlike the filter.
+    // Other lists, e.g. single values or dense integers, use the filter.
+    if (auto* hashTable =
+            dynamic_cast<common::BigintValuesUsingHashTable*>(filter_.get())) {
+      if (hashTable->values().size() <= kMaxSmallInList) {
+        setSmallValues(hashTable->values());
+      }
+    } else if (
+        auto* bytesValues = dynamic_cast<common::BytesValues*>(filter_.get())) {
+      strings_.assign(
+          bytesValues->values().begin(), bytesValues->values().end());
+      if (strings_.size() <= kMaxSmallInList) {
+        std::vector<int64_t> keys;
+        for (const auto& value : strings_) {
+          keys.push_back(sizeAndPrefix(value.data(), value.size()));
+        }
+        setSmallValues(keys);
+      } else {
+        for (const auto& value : strings_) {
+          stringSet_.insert(StringView(value));
+        }
+      }
+    }
+  }
 
   static std::shared_ptr<InPredicate> create(
       const std::string& /*name*/,
@@ -148,31 +193,20 @@ class InPredicate : public exec::VectorFunction {
     const auto& input = args[0];
     switch (input->typeKind()) {
       case TypeKind::BIGINT:
-        applyTyped<int64_t>(rows, input, context, result, [&](int64_t value) {
-          return filter_->testInt64(value);
-        });
+        applyInteger<int64_t>(rows, input, context, result);
         break;
       case TypeKind::INTEGER:
-        applyTyped<int32_t>(rows, input, context, result, [&](int32_t value) {
-          return filter_->testInt64(value);
-        });
+        applyInteger<int32_t>(rows, input, context, result);
         break;
       case TypeKind::SMALLINT:
-        applyTyped<int16_t>(rows, input, context, result, [&](int16_t value) {
-          return filter_->testInt64(value);
-        });
+        applyInteger<int16_t>(rows, input, context, result);
         break;
       case TypeKind::TINYINT:
-        applyTyped<int8_t>(rows, input, context, result, [&](int8_t value) {
-          return filter_->testInt64(value);
-        });
+        applyInteger<int8_t>(rows, input, context, result);
         break;
       case TypeKind::VARCHAR:
       case TypeKind::VARBINARY:
-        applyTyped<StringView>(
-            rows, input, context, result, [&](StringView value) {
-              return filter_->testBytes(value.data(), value.size());
-            });
+        applyString(rows, input, context, result);
         break;
       default:
         VELOX_UNSUPPORTED(
@@ -208,6 +242,77 @@ class InPredicate : public exec::VectorFunction {
     return BaseVector::createConstant(value, size, context.pool());
   }
 
+  // Pads 'values' to a multiple of the SIMD width with copies of the first
+  // value, which does not change the result of testSmallValues().
+  void setSmallValues(const std::vector<int64_t>& values) {
+    constexpr auto kBatchSize = xsimd::batch<int64_t>::size;
+    smallValues_ = values;
+    while (smallValues_.size() % kBatchSize != 0) {
+      smallValues_.push_back(values[0]);
+    }
+  }
+
+  // Returns true if 'value' is in 'smallValues_'. Compares with all values
+  // at once, a batch of values per instruction.
+  bool testSmallValues(int64_t value) const {
+    constexpr auto kBatchSize = xsimd::batch<int64_t>::size;
+    const auto broadcast = xsimd::broadcast<int64_t>(value);
+    xsimd::batch_bool<int64_t> found(false);
+    for (auto i = 0; i < smallValues_.size(); i += kBatchSize) {
+      found =
+          found | (broadcast == xsimd::load_unaligned(&smallValues_[i]));
+    }
+    return xsimd::any(found);
+  }
+
+  template <typename T>
+  void applyInteger(
+      const SelectivityVector& rows,
+      const VectorPtr& input,
+      exec::EvalCtx& context,
+      VectorPtr& result) const {
+    if (!smallValues_.empty()) {
+      applyTyped<T>(rows, input, context, result, [&](T value) {
+        return testSmallValues(value);
+      });
+    } else {
+      applyTyped<T>(rows, input, context, result, [&](T value) {
+        return filter_->testInt64(value);
+      });
+    }
+  }
+
+  void applyString(
+      const SelectivityVector& rows,
+      const VectorPtr& input,
+      exec::EvalCtx& context,
+      VectorPtr& result) const {
+    if (!smallValues_.empty()) {
+      applyTyped<StringView>(
+          rows, input, context, result, [&](StringView value) {
+            if (!testSmallValues(sizeAndPrefix(value.data(), value.size()))) {
+              return false;
+            }
+            for (const auto& string : strings_) {
+              if (value == StringView(string)) {
+                return true;
+              }
+            }
+            return false;
+          });
+    } else if (!stringSet_.empty()) {
+      applyTyped<StringView>(
+          rows, input, context, result, [&](StringView value) {
+            return stringSet_.contains(value);
+          });
+    } else {
+      applyTyped<StringView>(
+          rows, input, context, result, [&](StringView value) {
+            return filter_->testBytes(value.data(), value.size());
+          });
+    }
+  }
+
   template <typename T, typename F>
   void applyTyped(
       const SelectivityVector& rows,
@@ -269,6 +374,16 @@ class InPredicate : public exec::VectorFunction {
   }
 
   const std::unique_ptr<common::Filter> filter_;
+
+  // The integers or the sizes and prefixes of the strings of a small IN
+  // list, padded for testSmallValues().
+  std::vector<int64_t> smallValues_;
+
+  // The values of a string IN list.
+  std::vector<std::string> strings_;
+
+  // Views on 'strings_' of a large string IN list.
+  folly::F14FastSet<StringView> stringSet_;
 };
 } // namespace
 
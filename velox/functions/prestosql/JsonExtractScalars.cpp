@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <optional>
+
+#include "velox/expression/DecodedArgs.h"
+#include "velox/expression/EvalCtx.h"
+#include "velox/expression/StringWriter.h"
+#include "velox/expression/VectorFunction.h"
+#include "velox/functions/prestosql/json/JsonExtractor.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::functions {
+namespace {
+
+/// $internal$json_extract_scalars(json, path1, path2, ...) ->
+///     row(varchar, varchar, ...)
+/// Returns json_extract_scalar(json, pathN) as field N - 1 of a row, scanning
+/// each json document once for all the paths. The paths are constant. The
+/// expression compiler substitutes this for json_extract_scalar calls with
+/// the same json argument.
+class JsonExtractScalarsFunction : public exec::VectorFunction {
+ public:
+  explicit JsonExtractScalarsFunction(std::vector<std::string> paths)
+      : paths_(std::move(paths)) {
+    for (const auto& path : paths_) {
+      auto extractor = JsonExtractor::tryCreate(path);
+      if (!extractor) {
+        // Reported for each row like json_extract_scalar does.
+        invalidPath_ = path;
+        extractors_.clear();
+        return;
+      }
+      extractorPtrs_.push_back(extractor.get());
+      extractors_.push_back(std::move(extractor));
+    }
+  }
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      exec::EvalCtx& context,
+      VectorPtr& result) const override {
+    if (invalidPath_.has_value()) {
+      context.applyToSelectedNoThrow(rows, [&](auto /*row*/) {
+        VELOX_USER_FAIL("Invalid JSON path: {}", invalidPath_.value());
+      });
+      return;
+    }
+
+    exec::DecodedArgs decodedArgs(rows, args, context);
+    auto* json = decodedArgs.at(0);
+
+    std::vector<VectorPtr> fields;
+    std::vector<FlatVector<StringView>*> flatFields;
+    for (auto i = 0; i < paths_.size(); ++i) {
+      fields.push_back(
+          BaseVector::create(VARCHAR(), rows.end(), context.pool()));
+      flatFields.push_back(fields.back()->asFlatVector<StringView>());
+    }
+
+    std::vector<folly::Optional<std::string>> values;
+    context.applyToSelectedNoThrow(rows, [&](auto row) {
+      const auto document = json->valueAt<StringView>(row);
+      JsonExtractor::extractScalars(
+          folly::StringPiece(document.data(), document.size()),
+          extractorPtrs_,
+          values);
+      for (auto i = 0; i < values.size(); ++i) {
+        if (values[i].hasValue()) {
+          exec::StringWriter<> writer(flatFields[i], row);
+          writer.copy_from(values[i].value());
+          writer.finalize();
+        } else {
+          flatFields[i]->setNull(row, true);
+        }
+      }
+    });
+
+    auto rowVector = std::make_shared<RowVector>(
+        context.pool(),
+        outputType,
+        BufferPtr(nullptr),
+        rows.end(),
+        std::move(fields));
+    context.moveOrCopyResult(rowVector, rows, result);
+  }
+
+ private:
+  const std::vector<std::string> paths_;
+  std::vector<std::unique_ptr<JsonExtractor>> extractors_;
+  std::vector<const JsonExtractor*> extractorPtrs_;
+  std::optional<std::string> invalidPath_;
+};
+
+std::shared_ptr<exec::VectorFunction> createJsonExtractScalars(
+    const std::string& /*name*/,
+    const std::vector<exec::VectorFunctionArg>& inputArgs) {
+  VELOX_CHECK_GE(inputArgs.size(), 2);
+  std::vector<std::string> paths;
+  for (auto i = 1; i < inputArgs.size(); ++i) {
+    const auto& constant = inputArgs[i].constantValue;
+    VELOX_CHECK_NOT_NULL(
+        constant, "$internal$json_extract_scalars requires constant paths");
+    VELOX_CHECK(!constant->isNullAt(0));
+    paths.push_back(
+        constant->as<ConstantVector<StringView>>()->valueAt(0).str());
+  }
+  return std::make_shared<JsonExtractScalarsFunction>(std::move(paths));
+}
+
+} // namespace
+
+VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
+    udf_json_extract_scalars,
+    std::vector<std::shared_ptr<exec::FunctionSignature>>{},
+    createJsonExtractScalars);
+
+} // namespace facebook::velox::functions
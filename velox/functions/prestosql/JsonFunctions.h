@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/core/QueryConfig.h"
 #include "velox/functions/Macros.h"
 #include "velox/functions/UDFOutputString.h"
 #include "velox/functions/prestosql/json/JsonExtractor.h"
@@ -39,14 +40,26 @@ template <typename T>
 struct JsonExtractScalarFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Tokenizes a constant path once. An invalid constant path is left for
+  // call() to report for each row.
+  FOLLY_ALWAYS_INLINE void initialize(
+      const core::QueryConfig& /*config*/,
+      const arg_type<Varchar>* /*json*/,
+      const arg_type<Varchar>* jsonPath) {
+    if (jsonPath != nullptr) {
+      extractor_ = JsonExtractor::tryCreate(*jsonPath);
+    }
+  }
+
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& json,
       const arg_type<Varchar>& jsonPath) {
     const folly::StringPiece& jsonStringPiece = json;
     const folly::StringPiece& jsonPathStringPiece = jsonPath;
-    auto extractResult =
-        jsonExtractScalar(jsonStringPiece, jsonPathStringPiece);
+    auto extractResult = extractor_
+        ? extractor_->extractScalar(jsonStringPiece)
+        : jsonExtractScalar(jsonStringPiece, jsonPathStringPiece);
     if (extractResult.hasValue()) {
       UDFOutputString::assign(result, *extractResult);
       return true;
@@ -55,6 +68,9 @@ struct JsonExtractScalarFunction {
       return false;
     }
   }
+
+ private:
+  std::unique_ptr<JsonExtractor> extractor_;
 };
 
 template <typename T>
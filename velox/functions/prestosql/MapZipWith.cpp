@@ -165,7 +165,7 @@ class MapZipWithFunction : public exec::VectorFunction {
       elementRows.updateBounds();
 
       BufferPtr wrapCapture;
-      if (entry.callable->hasCapture()) {
+      if (entry.callable->hasNonConstantCapture()) {
         wrapCapture = makeWrapCapture(
             *entry.rows, index, mergeResults.rawNewSizes, context.pool());
       }
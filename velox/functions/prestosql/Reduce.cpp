@@ -22,8 +22,11 @@ namespace {
 /// Populates indices of the n-th elements of the arrays.
 /// Selects 'row' in 'arrayRows' if corresponding array has an n-th element.
 /// Sets elementIndices[row] to the index of the n-th element in the 'elements'
-/// vector.
+/// vector. The indices of the other rows are left as they are.
 /// Returns true if at least one array has n-th element.
+///
+/// 'rows' are the arrays that had an (n-1)-th element, so that each step only
+/// visits the arrays that are still being processed.
 bool toNthElementRows(
     const ArrayVectorPtr& arrayVector,
     const SelectivityVector& rows,
@@ -37,7 +40,6 @@ bool toNthElementRows(
   auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
 
   arrayRows.clearAll();
-  memset(rawElementIndices, 0, elementIndices->size());
 
   rows.applyToSelected([&](auto row) {
     if (!rawNulls || !bits::isBitNull(rawNulls, row)) {
@@ -113,6 +115,7 @@ class ReduceFunction : public exec::VectorFunction {
     // some arrays will run out of elements.
     while (auto entry = inputFuncIt.next()) {
       VectorPtr state = initialState;
+      SelectivityVector remainingRows = *entry.rows;
 
       vector_size_t n = 0;
       while (true) {
@@ -127,7 +130,7 @@ class ReduceFunction : public exec::VectorFunction {
         // Set elementIndices[row] to the index of the n-th element in the
         // array's elements vector.
         if (!toNthElementRows(
-                flatArray, *entry.rows, n, arrayRows, elementIndices)) {
+                flatArray, remainingRows, n, arrayRows, elementIndices)) {
           break; // Ran out of elements in all arrays.
         }
 
@@ -149,6 +152,7 @@ class ReduceFunction : public exec::VectorFunction {
             lambdaArgs,
             &partialResult);
         state = partialResult;
+        remainingRows = arrayRows;
         n++;
       }
     }
@@ -135,20 +135,17 @@ class SplitFunction : public exec::VectorFunction {
         }
       }
 
-      // Ensure that our result elements vector uses the same string buffer as
-      // the input vector of strings.
-      builder.setStringBuffers(
-          strings->base()->as<FlatVector<StringView>>()->stringBuffers());
     } else {
       // The rest of the cases are handled through this general path and no
       // direct access.
       applyDecoded<I>(rows, context, strings, delims, limits, builder);
-
-      // Ensure that our result elements vector uses the same string buffer as
-      // the input vector of strings.
-      builder.setStringBuffers(strings->base());
     }
 
+    // The elements are slices of the input strings. Ensure that our result
+    // elements vector uses the same string buffers as the input vector of
+    // strings instead of copying them.
+    builder.setStringBuffers(strings->base());
+
     std::shared_ptr<ArrayVector> arrayVector =
         std::move(builder).finish(context.pool());
     context.moveOrCopyResult(arrayVector, rows, result);
@@ -75,6 +75,95 @@ class UpperLowerTemplateFunction : public exec::VectorFunction {
     });
   }
 
+  static void applyAscii(char* output, const char* input, size_t length) {
+    if constexpr (isLower) {
+      lowerAscii(output, input, length);
+    } else {
+      upperAscii(output, input, length);
+    }
+  }
+
+  // Converts each string buffer of the flat ascii 'input' in one pass and
+  // points the results at the same offsets in the converted buffers, instead
+  // of writing the strings one by one. Returns false without writing
+  // 'results' if a string is not inlined and not in a string buffer of
+  // 'input' or if the buffers are more than twice the size of the strings to
+  // convert.
+  static bool applyAsciiToBuffers(
+      const SelectivityVector& rows,
+      const FlatVector<StringView>& input,
+      memory::MemoryPool* pool,
+      FlatVector<StringView>* results) {
+    const auto& buffers = input.stringBuffers();
+    if (buffers.empty()) {
+      return false;
+    }
+    // Returns the index of the buffer that contains 'value' or -1. Checks
+    // the buffer of the previous string first since consecutive strings are
+    // usually in the same buffer.
+    size_t lastBuffer = 0;
+    auto findBuffer = [&](const StringView& value) -> int32_t {
+      for (size_t i = 0; i < buffers.size(); ++i) {
+        const auto index = (lastBuffer + i) % buffers.size();
+        const auto* begin = buffers[index]->as<char>();
+        if (value.data() >= begin &&
+            value.data() + value.size() <= begin + buffers[index]->size()) {
+          lastBuffer = index;
+          return index;
+        }
+      }
+      return -1;
+    };
+
+    const auto* rawValues = input.rawValues();
+    size_t stringBytes = 0;
+    const bool allInBuffers = rows.testSelected([&](auto row) {
+      const auto& value = rawValues[row];
+      if (input.isNullAt(row) || value.isInline()) {
+        return true;
+      }
+      stringBytes += value.size();
+      return findBuffer(value) >= 0;
+    });
+    size_t bufferBytes = 0;
+    for (const auto& buffer : buffers) {
+      bufferBytes += buffer->size();
+    }
+    if (!allInBuffers || bufferBytes > 2 * stringBytes) {
+      return false;
+    }
+
+    std::vector<BufferPtr> converted;
+    converted.reserve(buffers.size());
+    for (const auto& buffer : buffers) {
+      converted.push_back(AlignedBuffer::allocate<char>(buffer->size(), pool));
+      applyAscii(
+          converted.back()->asMutable<char>(),
+          buffer->as<char>(),
+          buffer->size());
+    }
+    rows.applyToSelected([&](auto row) {
+      if (input.isNullAt(row)) {
+        return;
+      }
+      const auto& value = rawValues[row];
+      if (value.isInline()) {
+        char inlined[StringView::kInlineSize];
+        applyAscii(inlined, value.data(), value.size());
+        results->setNoCopy(row, StringView(inlined, value.size()));
+        return;
+      }
+      const auto index = findBuffer(value);
+      const auto offset = value.data() - buffers[index]->as<char>();
+      results->setNoCopy(
+          row, StringView(converted[index]->as<char>() + offset, value.size()));
+    });
+    for (auto& buffer : converted) {
+      results->addStringBuffer(buffer);
+    }
+    return true;
+  }
+
  public:
   bool isDefaultNullBehavior() const override {
     return true;
@@ -114,6 +203,15 @@ class UpperLowerTemplateFunction : public exec::VectorFunction {
     prepareFlatResultsVector(result, rows, context, emptyVectorPtr);
     auto* resultFlatVector = result->as<FlatVector<StringView>>();
 
+    if (tryInplace &&
+        applyAsciiToBuffers(
+            rows,
+            *inputStringsVector->asUnchecked<FlatVector<StringView>>(),
+            context.pool(),
+            resultFlatVector)) {
+      return;
+    }
+
     StringEncodingTemplateWrapper<ApplyInternal>::apply(
         ascii, rows, decodedInput, resultFlatVector);
   }
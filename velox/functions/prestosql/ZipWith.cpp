@@ -113,7 +113,7 @@ class ZipWithFunction : public exec::VectorFunction {
       }
 
       BufferPtr wrapCapture;
-      if (entry.callable->hasCapture()) {
+      if (entry.callable->hasNonConstantCapture()) {
         wrapCapture = allocateIndices(numResultElements, context.pool());
         auto rawWrapCaptures = wrapCapture->asMutable<vector_size_t>();
 
@@ -53,6 +53,18 @@ struct HllAccumulator {
     }
   }
 
+  void append(const uint64_t* hashes, int32_t numHashes) {
+    if (isSparse_) {
+      if (sparseHll_.insertHashes(hashes, numHashes)) {
+        toDense();
+      }
+    } else {
+      for (auto i = 0; i < numHashes; ++i) {
+        denseHll_.insertHash(hashes[i]);
+      }
+    }
+  }
+
   int64_t cardinality() const {
     return isSparse_ ? sparseHll_.cardinality() : denseHll_.cardinality();
   }
@@ -256,19 +268,29 @@ class ApproxDistinctAggregate : public exec::Aggregate {
     } else {
       decodeArguments(rows, args);
 
-      rows.applyToSelected([&](auto row) {
-        if (decodedValue_.isNullAt(row)) {
-          return;
-        }
-
-        auto accumulator = value<HllAccumulator>(group);
-        if (clearNull(group)) {
-          accumulator->setIndexBitLength(indexBitLength_);
+      // Hashes the batch first and adds the hashes to the HLL together.
+      hashes_.clear();
+      if (decodedValue_.isConstantMapping()) {
+        // Adding the hash of the same value again does not change the HLL.
+        if (rows.hasSelections() && !decodedValue_.isNullAt(rows.begin())) {
+          hashes_.push_back(hashOne(decodedValue_.valueAt<T>(rows.begin())));
         }
+      } else {
+        rows.applyToSelected([&](auto row) {
+          if (!decodedValue_.isNullAt(row)) {
+            hashes_.push_back(hashOne(decodedValue_.valueAt<T>(row)));
+          }
+        });
+      }
+      if (hashes_.empty()) {
+        return;
+      }
 
-        auto hash = hashOne(decodedValue_.valueAt<T>(row));
-        accumulator->append(hash);
-      });
+      auto accumulator = value<HllAccumulator>(group);
+      if (clearNull(group)) {
+        accumulator->setIndexBitLength(indexBitLength_);
+      }
+      accumulator->append(hashes_.data(), hashes_.size());
     }
   }
 
@@ -382,6 +404,9 @@ class ApproxDistinctAggregate : public exec::Aggregate {
   DecodedVector decodedValue_;
   DecodedVector decodedMaxStandardError_;
   DecodedVector decodedHll_;
+
+  // The hashes of the non-null input values of a batch for a single group.
+  std::vector<uint64_t> hashes_;
 };
 
 template <TypeKind kind>
@@ -71,7 +71,7 @@ struct KllSketchAccumulator {
     sketch_.mergeViews(folly::Range(&view, 1));
   }
 
-  void append(const std::vector<typename KllSketch<T>::View>& views) {
+  void append(folly::Range<const typename KllSketch<T>::View*> views) {
     sketch_.mergeViews(views);
   }
 
@@ -566,8 +566,12 @@ class ApproxPercentileAggregate : public exec::Aggregate {
         levels->elements()->asFlatVector<int32_t>()->rawValues<uint32_t>();
     KllSketchAccumulator<T>* accumulator = nullptr;
     std::vector<typename KllSketch<T>::View> views;
-    if constexpr (kSingleGroup) {
-      views.reserve(rows.end());
+    // The sketches of each row with its group. Merging all the sketches of a
+    // group at once compacts each level once instead of once per sketch.
+    std::vector<std::pair<char*, typename KllSketch<T>::View>> groupViews;
+    views.reserve(rows.end());
+    if constexpr (!kSingleGroup) {
+      groupViews.reserve(rows.end());
     }
     rows.applyToSelected([&](auto row) {
       if (decoded.isNullAt(row)) {
@@ -612,8 +616,7 @@ class ApproxPercentileAggregate : public exec::Aggregate {
       if constexpr (kSingleGroup) {
         views.push_back(v);
       } else {
-        auto tracker = trackRowSize(group[row]);
-        accumulator->append(v);
+        groupViews.emplace_back(group[row], v);
       }
     });
     if constexpr (kSingleGroup) {
@@ -621,6 +624,25 @@ class ApproxPercentileAggregate : public exec::Aggregate {
         auto tracker = trackRowSize(group);
         accumulator->append(views);
       }
+    } else {
+      std::sort(
+          groupViews.begin(),
+          groupViews.end(),
+          [](const auto& left, const auto& right) {
+            return left.first < right.first;
+          });
+      for (auto begin = 0; begin < groupViews.size();) {
+        auto* rowGroup = groupViews[begin].first;
+        views.clear();
+        auto end = begin;
+        for (; end < groupViews.size() && groupViews[end].first == rowGroup;
+             ++end) {
+          views.push_back(groupViews[end].second);
+        }
+        auto tracker = trackRowSize(rowGroup);
+        value<KllSketchAccumulator<T>>(rowGroup)->append(views);
+        begin = end;
+      }
     }
   }
 
@@ -16,6 +16,7 @@
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/expression/FunctionSignature.h"
 #include "velox/functions/prestosql/aggregates/AggregateNames.h"
+#include "velox/functions/prestosql/aggregates/FixedWidthValueList.h"
 #include "velox/functions/prestosql/aggregates/ValueList.h"
 #include "velox/vector/ComplexVector.h"
 
@@ -175,6 +176,185 @@ class ArrayAggAggregate : public exec::Aggregate {
   DecodedVector decodedIntermediate_;
 };
 
+// array_agg for fixed-width element types. Keeps the elements of each group
+// in a FixedWidthValueList and copies these to the result in bulk.
+template <typename T>
+class FixedWidthArrayAggAggregate : public exec::Aggregate {
+ public:
+  explicit FixedWidthArrayAggAggregate(TypePtr resultType)
+      : Aggregate(resultType) {}
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return sizeof(FixedWidthValueList<T>);
+  }
+
+  bool isFixedSize() const override {
+    return false;
+  }
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override {
+    for (auto index : indices) {
+      new (groups[index] + offset_) FixedWidthValueList<T>();
+    }
+  }
+
+  void finalize(char** /*groups*/, int32_t /*numGroups*/) override {}
+
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    auto vector = (*result)->as<ArrayVector>();
+    VELOX_CHECK(vector);
+    vector->resize(numGroups);
+
+    auto elements = vector->elements();
+    elements->resize(countElements(groups, numGroups));
+    auto* flatElements = elements->asFlatVector<T>();
+    VELOX_CHECK_NOT_NULL(flatElements);
+
+    uint64_t* rawNulls = getRawNulls(vector);
+    vector_size_t offset = 0;
+    for (int32_t i = 0; i < numGroups; ++i) {
+      clearNull(rawNulls, i);
+
+      const auto& values = *value<FixedWidthValueList<T>>(groups[i]);
+      values.copyTo(*flatElements, offset);
+      vector->setOffsetAndSize(i, offset, values.size());
+      offset += values.size();
+    }
+  }
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    extractValues(groups, numGroups, result);
+  }
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodedElements_.decode(*args[0], rows);
+    rows.applyToSelected([&](vector_size_t row) {
+      auto group = groups[row];
+      auto tracker = trackRowSize(group);
+      appendValue(*value<FixedWidthValueList<T>>(group), row);
+    });
+  }
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodedIntermediate_.decode(*args[0], rows);
+    auto arrayVector = decodedIntermediate_.base()->as<ArrayVector>();
+    prepareElements(*arrayVector);
+    rows.applyToSelected([&](vector_size_t row) {
+      auto group = groups[row];
+      auto decodedRow = decodedIntermediate_.index(row);
+      auto tracker = trackRowSize(group);
+      appendElements(
+          *value<FixedWidthValueList<T>>(group),
+          arrayVector->offsetAt(decodedRow),
+          arrayVector->sizeAt(decodedRow));
+    });
+  }
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /* mayPushdown */) override {
+    auto& values = *value<FixedWidthValueList<T>>(group);
+
+    decodedElements_.decode(*args[0], rows);
+    auto tracker = trackRowSize(group);
+    rows.applyToSelected(
+        [&](vector_size_t row) { appendValue(values, row); });
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /* mayPushdown */) override {
+    decodedIntermediate_.decode(*args[0], rows);
+    auto arrayVector = decodedIntermediate_.base()->as<ArrayVector>();
+    prepareElements(*arrayVector);
+
+    auto& values = *value<FixedWidthValueList<T>>(group);
+    auto tracker = trackRowSize(group);
+    rows.applyToSelected([&](vector_size_t row) {
+      auto decodedRow = decodedIntermediate_.index(row);
+      appendElements(
+          values,
+          arrayVector->offsetAt(decodedRow),
+          arrayVector->sizeAt(decodedRow));
+    });
+  }
+
+  void destroy(folly::Range<char**> groups) override {
+    for (auto group : groups) {
+      value<FixedWidthValueList<T>>(group)->free(allocator_);
+    }
+  }
+
+ private:
+  vector_size_t countElements(char** groups, int32_t numGroups) const {
+    vector_size_t size = 0;
+    for (int32_t i = 0; i < numGroups; ++i) {
+      size += value<FixedWidthValueList<T>>(groups[i])->size();
+    }
+    return size;
+  }
+
+  void appendValue(FixedWidthValueList<T>& values, vector_size_t row) {
+    if (decodedElements_.isNullAt(row)) {
+      values.appendNull(allocator_);
+    } else {
+      values.append(decodedElements_.valueAt<T>(row), allocator_);
+    }
+  }
+
+  // Sets up reading the elements of 'arrayVector' for appendElements(). Flat
+  // elements are appended in bulk.
+  void prepareElements(const ArrayVector& arrayVector) {
+    const auto& elements = arrayVector.elements();
+    flatIntermediateElements_ = elements->asFlatVector<T>();
+    if (flatIntermediateElements_ == nullptr) {
+      SelectivityVector allElements(elements->size());
+      decodedElements_.decode(*elements, allElements);
+    }
+  }
+
+  void appendElements(
+      FixedWidthValueList<T>& values,
+      vector_size_t offset,
+      vector_size_t size) {
+    if (flatIntermediateElements_) {
+      values.appendRange(
+          flatIntermediateElements_->rawValues(),
+          flatIntermediateElements_->rawNulls(),
+          offset,
+          size,
+          allocator_);
+      return;
+    }
+    for (auto i = 0; i < size; ++i) {
+      appendValue(values, offset + i);
+    }
+  }
+
+  // Reusable instance of DecodedVector for decoding input vectors.
+  DecodedVector decodedElements_;
+  DecodedVector decodedIntermediate_;
+
+  // The elements of the intermediate input if flat.
+  const FlatVector<T>* flatIntermediateElements_{nullptr};
+};
+
 bool registerArrayAggregate(const std::string& name) {
   std::vector<std::shared_ptr<exec::AggregateFunctionSignature>> signatures{
       exec::AggregateFunctionSignatureBuilder()
@@ -193,7 +373,34 @@ bool registerArrayAggregate(const std::string& name) {
           const TypePtr& resultType) -> std::unique_ptr<exec::Aggregate> {
         VELOX_CHECK_EQ(
             argTypes.size(), 1, "{} takes at most one argument", name);
-        return std::make_unique<ArrayAggAggregate>(resultType);
+        switch (argTypes[0]->kind()) {
+          case TypeKind::TINYINT:
+            return std::make_unique<FixedWidthArrayAggAggregate<int8_t>>(
+                resultType);
+          case TypeKind::SMALLINT:
+            return std::make_unique<FixedWidthArrayAggAggregate<int16_t>>(
+                resultType);
+          case TypeKind::INTEGER:
+            return std::make_unique<FixedWidthArrayAggAggregate<int32_t>>(
+                resultType);
+          case TypeKind::BIGINT:
+            return std::make_unique<FixedWidthArrayAggAggregate<int64_t>>(
+                resultType);
+          case TypeKind::REAL:
+            return std::make_unique<FixedWidthArrayAggAggregate<float>>(
+                resultType);
+          case TypeKind::DOUBLE:
+            return std::make_unique<FixedWidthArrayAggAggregate<double>>(
+                resultType);
+          case TypeKind::TIMESTAMP:
+            return std::make_unique<FixedWidthArrayAggAggregate<Timestamp>>(
+                resultType);
+          case TypeKind::DATE:
+            return std::make_unique<FixedWidthArrayAggAggregate<Date>>(
+                resultType);
+          default:
+            return std::make_unique<ArrayAggAggregate>(resultType);
+        }
       });
   return true;
 }
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/FunctionSignature.h"
 #include "velox/functions/prestosql/aggregates/AggregateNames.h"
 #include "velox/functions/prestosql/aggregates/SumAggregate.h"
@@ -102,6 +103,11 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       if (!decoded.isNullAt(0)) {
         addToGroup(group, rows.size());
       }
+    } else if (
+        decoded.mayHaveNulls() && decoded.isIdentityMapping() &&
+        rows.isAllSelected()) {
+      // Non-null rows have their null bit set.
+      addToGroup(group, bits::countBits(decoded.nulls(), 0, rows.size()));
     } else if (decoded.mayHaveNulls()) {
       int64_t nonNullCount = 0;
       rows.applyToSelected([&](vector_size_t i) {
@@ -120,6 +126,11 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*mayPushdown*/) override {
+    if (auto counts = flatNoNullsValues<int64_t>(rows, args[0])) {
+      addToGroup(group, simd::reduceSum<int64_t>(counts, rows.size()));
+      return;
+    }
+
     decodedIntermediate_.decode(*args[0], rows);
 
     int64_t count = 0;
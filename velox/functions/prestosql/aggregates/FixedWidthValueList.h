@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/base/Nulls.h"
+#include "velox/common/memory/HashStringAllocator.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::aggregate {
+
+// Represents a list of fixed-width values, including nulls, for array_agg and
+// related aggregates. Unlike ValueList, the values are not serialized. They
+// are appended to a chain of contiguous chunks, each holding the values
+// followed by their null flags. The chunks double in capacity from
+// kMinChunkSize to kMaxChunkSize values, so that small lists take a single
+// small allocation. The values are copied out with one memcpy per chunk.
+template <typename T>
+class FixedWidthValueList {
+ public:
+  static constexpr int32_t kMinChunkSize = 4;
+  static constexpr int32_t kMaxChunkSize = 1024;
+
+  void append(T value, HashStringAllocator* allocator) {
+    ensureSpace(allocator);
+    values(last_)[last_->size++] = value;
+    ++size_;
+  }
+
+  void appendNull(HashStringAllocator* allocator) {
+    ensureSpace(allocator);
+    bits::setBit(nulls(last_), last_->size++);
+    ++size_;
+    hasNulls_ = true;
+  }
+
+  // Appends 'size' values starting at 'offset' of 'rawValues'. 'rawNulls' is
+  // in the format of BaseVector::rawNulls() and may be nullptr.
+  void appendRange(
+      const T* rawValues,
+      const uint64_t* rawNulls,
+      vector_size_t offset,
+      vector_size_t size,
+      HashStringAllocator* allocator) {
+    while (size > 0) {
+      ensureSpace(allocator);
+      const auto numValues = std::min(size, last_->capacity - last_->size);
+      memcpy(
+          values(last_) + last_->size,
+          rawValues + offset,
+          numValues * sizeof(T));
+      if (rawNulls) {
+        for (auto i = 0; i < numValues; ++i) {
+          if (bits::isBitNull(rawNulls, offset + i)) {
+            bits::setBit(nulls(last_), last_->size + i);
+            hasNulls_ = true;
+          }
+        }
+      }
+      last_->size += numValues;
+      size_ += numValues;
+      offset += numValues;
+      size -= numValues;
+    }
+  }
+
+  int32_t size() const {
+    return size_;
+  }
+
+  // Copies the values to 'result' starting at 'offset'. 'result' must have
+  // space for size() values from 'offset'.
+  void copyTo(FlatVector<T>& result, vector_size_t offset) const {
+    if (size_ == 0) {
+      return;
+    }
+    if (result.mayHaveNulls()) {
+      result.clearNulls(offset, offset + size_);
+    }
+    auto* rawValues = result.mutableRawValues();
+    for (auto* chunk = first_; chunk != nullptr; chunk = chunk->next) {
+      memcpy(rawValues + offset, values(chunk), chunk->size * sizeof(T));
+      if (hasNulls_) {
+        bits::forEachSetBit(
+            nulls(chunk), 0, chunk->size, [&](vector_size_t row) {
+              result.setNull(offset + row, true);
+            });
+      }
+      offset += chunk->size;
+    }
+  }
+
+  void free(HashStringAllocator* allocator) {
+    while (first_ != nullptr) {
+      auto* next = first_->next;
+      allocator->free(HashStringAllocator::headerOf(first_));
+      first_ = next;
+    }
+    last_ = nullptr;
+    size_ = 0;
+    hasNulls_ = false;
+  }
+
+ private:
+  // Header of a chunk. Followed by 'capacity' values and then by
+  // bits::nwords(capacity) words of null flags, with a set bit for a null.
+  struct Chunk {
+    Chunk* next;
+    int32_t capacity;
+    int32_t size;
+  };
+
+  static T* values(Chunk* chunk) {
+    return reinterpret_cast<T*>(chunk + 1);
+  }
+
+  static const T* values(const Chunk* chunk) {
+    return reinterpret_cast<const T*>(chunk + 1);
+  }
+
+  static uint64_t* nulls(Chunk* chunk) {
+    return reinterpret_cast<uint64_t*>(values(chunk) + chunk->capacity);
+  }
+
+  static const uint64_t* nulls(const Chunk* chunk) {
+    return reinterpret_cast<const uint64_t*>(
+        values(chunk) + chunk->capacity);
+  }
+
+  // Adds a chunk if the last one is full.
+  void ensureSpace(HashStringAllocator* allocator) {
+    if (last_ != nullptr && last_->size < last_->capacity) {
+      return;
+    }
+    const int32_t capacity = last_ == nullptr
+        ? kMinChunkSize
+        : std::min(last_->capacity * 2, kMaxChunkSize);
+    const auto nullBytes = bits::nwords(capacity) * sizeof(uint64_t);
+    auto* chunk = reinterpret_cast<Chunk*>(
+        allocator
+            ->allocate(sizeof(Chunk) + capacity * sizeof(T) + nullBytes)
+            ->begin());
+    chunk->next = nullptr;
+    chunk->capacity = capacity;
+    chunk->size = 0;
+    memset(nulls(chunk), 0, nullBytes);
+    if (last_ == nullptr) {
+      first_ = chunk;
+    } else {
+      last_->next = chunk;
+    }
+    last_ = chunk;
+  }
+
+  Chunk* first_{nullptr};
+  Chunk* last_{nullptr};
+
+  // Number of values added, including nulls.
+  int32_t size_{0};
+
+  bool hasNulls_{false};
+};
+
+} // namespace facebook::velox::aggregate
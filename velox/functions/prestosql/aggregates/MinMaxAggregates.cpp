@@ -15,6 +15,7 @@
  */
 
 #include <limits>
+#include "velox/common/base/SimdUtil.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/AggregationHook.h"
 #include "velox/expression/FunctionSignature.h"
@@ -143,6 +144,14 @@ class MaxAggregate : public MinMaxAggregate<T> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
+    if constexpr (std::is_integral_v<T>) {
+      if (auto values = BaseAggregate::flatNoNullsValues(rows, args[0])) {
+        exec::Aggregate::clearNull(group);
+        auto& result = *exec::Aggregate::value<T>(group);
+        result = simd::reduceMax(values, rows.size(), result);
+        return;
+      }
+    }
     BaseAggregate::updateOneGroup(
         group,
         rows,
@@ -216,6 +225,14 @@ class MinAggregate : public MinMaxAggregate<T> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
+    if constexpr (std::is_integral_v<T>) {
+      if (auto values = BaseAggregate::flatNoNullsValues(rows, args[0])) {
+        exec::Aggregate::clearNull(group);
+        auto& result = *exec::Aggregate::value<T>(group);
+        result = simd::reduceMin(values, rows.size(), result);
+        return;
+      }
+    }
     BaseAggregate::updateOneGroup(
         group,
         rows,
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <numeric>
+
 #include "velox/exec/Aggregate.h"
 #include "velox/expression/FunctionSignature.h"
 #include "velox/functions/prestosql/aggregates/AggregateNames.h"
@@ -618,6 +620,391 @@ class MinByAggregate : public MinMaxByAggregate<T, U> {
   }
 };
 
+/// Accumulator of max_by(x, y, n) and min_by(x, y, n). Keeps the 'n' values of
+/// X with the highest, respectively lowest, values of Y in a binary heap whose
+/// top is the entry to evict first.
+template <typename T, typename U>
+struct MinMaxByNAccumulator {
+  using ValueAccumulatorType =
+      typename AccumulatorTypeTraits<T>::AccumulatorType;
+
+  struct Entry {
+    U comparison;
+    bool isNull;
+    ValueAccumulatorType value;
+  };
+
+  explicit MinMaxByNAccumulator(HashStringAllocator* allocator)
+      : heap{StlAllocator<Entry>(allocator)} {}
+
+  int64_t n{0};
+  std::vector<Entry, StlAllocator<Entry>> heap;
+};
+
+/// Implements max_by(x, y, n) and min_by(x, y, n) with numeric or date Y. These
+/// return an array of the values of X associated with the 'n' largest,
+/// respectively smallest, values of Y, ordered on Y. Each group keeps a bounded
+/// heap of at most 'n' entries, so that a top-K per group, i.e. a window with
+/// row_number() <= K, takes O(log K) per input row and no sort of the input.
+/// The intermediate result is a row(n, array(X), array(Y)) with the entries of
+/// the heap. T is the type of X and U is the type of Y.
+template <typename T, typename U, bool isMaxBy>
+class MinMaxByNAggregate : public exec::Aggregate {
+ public:
+  using Accumulator = MinMaxByNAccumulator<T, U>;
+  using Entry = typename Accumulator::Entry;
+
+  /// Upper limit for 'n', as in Presto.
+  static constexpr int64_t kMaxN = 10'000;
+
+  explicit MinMaxByNAggregate(TypePtr resultType)
+      : exec::Aggregate(resultType) {}
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return sizeof(Accumulator);
+  }
+
+  bool isFixedSize() const override {
+    return false;
+  }
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override {
+    exec::Aggregate::setAllNulls(groups, indices);
+    for (const vector_size_t i : indices) {
+      new (groups[i] + offset_) Accumulator(allocator_);
+    }
+  }
+
+  void finalize(char** /* unused */, int32_t /* unused */) override {}
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodeRawInput(rows, args);
+    rows.applyToSelected([&](vector_size_t i) {
+      if (!decodedComparison_.isNullAt(i)) {
+        addRawValue(groups[i], i);
+      }
+    });
+  }
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodeRawInput(rows, args);
+    rows.applyToSelected([&](vector_size_t i) {
+      if (!decodedComparison_.isNullAt(i)) {
+        addRawValue(group, i);
+      }
+    });
+  }
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodeIntermediate(rows, args);
+    rows.applyToSelected([&](vector_size_t i) {
+      if (!decodedIntermediate_.isNullAt(i)) {
+        addIntermediateValues(groups[i], decodedIntermediate_.index(i));
+      }
+    });
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodeIntermediate(rows, args);
+    rows.applyToSelected([&](vector_size_t i) {
+      if (!decodedIntermediate_.isNullAt(i)) {
+        addIntermediateValues(group, decodedIntermediate_.index(i));
+      }
+    });
+  }
+
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    auto arrayVector = (*result)->as<ArrayVector>();
+    VELOX_CHECK(arrayVector);
+    arrayVector->resize(numGroups);
+    auto elements = arrayVector->elements();
+    elements->resize(countEntries(groups, numGroups));
+
+    uint64_t* rawNulls = getRawNulls(arrayVector);
+    auto* rawOffsets = arrayVector->offsets()->asMutable<vector_size_t>();
+    auto* rawSizes = arrayVector->sizes()->asMutable<vector_size_t>();
+    T* rawValues = mutableRawValues<T>(elements);
+
+    std::vector<int32_t> order;
+    vector_size_t offset = 0;
+    for (auto i = 0; i < numGroups; ++i) {
+      char* group = groups[i];
+      const auto& heap = accumulator(group)->heap;
+      rawOffsets[i] = offset;
+      rawSizes[i] = heap.size();
+      if (isNull(group)) {
+        arrayVector->setNull(i, true);
+        continue;
+      }
+      clearNull(rawNulls, i);
+
+      // The heap is not modified so that the accumulator stays valid.
+      order.resize(heap.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), [&](int32_t left, int32_t right) {
+        return before(heap[left].comparison, heap[right].comparison);
+      });
+      for (auto index : order) {
+        extractValue(heap[index], elements, offset++, rawValues);
+      }
+    }
+  }
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    auto rowVector = (*result)->as<RowVector>();
+    VELOX_CHECK(rowVector);
+    rowVector->resize(numGroups);
+    auto nVector = rowVector->childAt(0)->asFlatVector<int64_t>();
+    auto valueArray = rowVector->childAt(1)->as<ArrayVector>();
+    auto comparisonArray = rowVector->childAt(2)->as<ArrayVector>();
+    nVector->resize(numGroups);
+    valueArray->resize(numGroups);
+    comparisonArray->resize(numGroups);
+
+    const auto numEntries = countEntries(groups, numGroups);
+    auto valueElements = valueArray->elements();
+    auto comparisonElements = comparisonArray->elements();
+    valueElements->resize(numEntries);
+    comparisonElements->resize(numEntries);
+
+    uint64_t* rawNulls = getRawNulls(rowVector);
+    auto* rawN = nVector->mutableRawValues();
+    auto* rawValueOffsets = valueArray->offsets()->asMutable<vector_size_t>();
+    auto* rawValueSizes = valueArray->sizes()->asMutable<vector_size_t>();
+    auto* rawComparisonOffsets =
+        comparisonArray->offsets()->asMutable<vector_size_t>();
+    auto* rawComparisonSizes =
+        comparisonArray->sizes()->asMutable<vector_size_t>();
+    T* rawValues = mutableRawValues<T>(valueElements);
+    U* rawComparisons = mutableRawValues<U>(comparisonElements);
+
+    vector_size_t offset = 0;
+    for (auto i = 0; i < numGroups; ++i) {
+      char* group = groups[i];
+      const auto* accumulator = this->accumulator(group);
+      rawValueOffsets[i] = offset;
+      rawComparisonOffsets[i] = offset;
+      rawValueSizes[i] = accumulator->heap.size();
+      rawComparisonSizes[i] = accumulator->heap.size();
+      rawN[i] = accumulator->n;
+      if (isNull(group)) {
+        rowVector->setNull(i, true);
+        continue;
+      }
+      clearNull(rawNulls, i);
+      for (const auto& entry : accumulator->heap) {
+        rawComparisons[offset] = entry.comparison;
+        extractValue(entry, valueElements, offset++, rawValues);
+      }
+    }
+  }
+
+  void destroy(folly::Range<char**> groups) override {
+    for (auto group : groups) {
+      auto* accumulator = this->accumulator(group);
+      if constexpr (!isNumericOrDate<T>()) {
+        for (auto& entry : accumulator->heap) {
+          entry.value.destroy(allocator_);
+        }
+      }
+      accumulator->~Accumulator();
+    }
+  }
+
+ private:
+  // Returns true if an entry with comparison value 'left' ranks ahead of one
+  // with 'right' in the result.
+  static bool before(U left, U right) {
+    if constexpr (isMaxBy) {
+      return left > right;
+    } else {
+      return left < right;
+    }
+  }
+
+  static bool heapCompare(const Entry& left, const Entry& right) {
+    return before(left.comparison, right.comparison);
+  }
+
+  template <typename V>
+  static V* mutableRawValues(const VectorPtr& vector) {
+    if constexpr (isNumericOrDate<V>()) {
+      auto flatVector = vector->asFlatVector<V>();
+      VELOX_CHECK(flatVector);
+      return flatVector->mutableRawValues();
+    } else {
+      return nullptr;
+    }
+  }
+
+  Accumulator* accumulator(char* group) {
+    return reinterpret_cast<Accumulator*>(group + offset_);
+  }
+
+  int64_t countEntries(char** groups, int32_t numGroups) {
+    int64_t numEntries = 0;
+    for (auto i = 0; i < numGroups; ++i) {
+      numEntries += accumulator(groups[i])->heap.size();
+    }
+    return numEntries;
+  }
+
+  void extractValue(
+      const Entry& entry,
+      const VectorPtr& elements,
+      vector_size_t index,
+      T* rawValues) {
+    if (entry.isNull) {
+      elements->setNull(index, true);
+    } else {
+      elements->setNull(index, false);
+      extract<T, const typename Accumulator::ValueAccumulatorType>(
+          &entry.value, elements, index, rawValues);
+    }
+  }
+
+  void decodeRawInput(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) {
+    decodedValue_.decode(*args[0], rows);
+    decodedComparison_.decode(*args[1], rows);
+    decodedN_.decode(*args[2], rows);
+  }
+
+  void decodeIntermediate(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) {
+    decodedIntermediate_.decode(*args[0], rows);
+    auto baseRowVector =
+        dynamic_cast<const RowVector*>(decodedIntermediate_.base());
+    VELOX_CHECK(baseRowVector);
+    decodedN_.decode(*baseRowVector->childAt(0));
+    valueArray_ = baseRowVector->childAt(1)->as<ArrayVector>();
+    comparisonArray_ = baseRowVector->childAt(2)->as<ArrayVector>();
+    VELOX_CHECK(valueArray_ && comparisonArray_);
+    decodedValue_.decode(*valueArray_->elements());
+    decodedComparison_.decode(*comparisonArray_->elements());
+  }
+
+  // Sets the 'n' of the accumulator of 'group' on first use and checks that it
+  // is the same for all rows after that.
+  void setN(char* group, int64_t n) {
+    auto* accumulator = this->accumulator(group);
+    if (accumulator->n == 0) {
+      VELOX_USER_CHECK_GT(
+          n, 0, "third argument of max_by/min_by must be positive");
+      VELOX_USER_CHECK_LE(
+          n,
+          kMaxN,
+          "third argument of max_by/min_by must be less than or equal to {}",
+          kMaxN);
+      accumulator->n = n;
+    } else {
+      VELOX_USER_CHECK_EQ(
+          n,
+          accumulator->n,
+          "third argument of max_by/min_by must be a constant for all rows in a group");
+    }
+  }
+
+  void addRawValue(char* group, vector_size_t row) {
+    VELOX_USER_CHECK(
+        !decodedN_.isNullAt(row),
+        "third argument of max_by/min_by must not be null");
+    setN(group, decodedN_.valueAt<int64_t>(row));
+    clearNull(group);
+    addEntry(
+        group,
+        decodedComparison_.valueAt<U>(row),
+        decodedValue_.isNullAt(row),
+        row);
+  }
+
+  void addIntermediateValues(char* group, vector_size_t index) {
+    const auto offset = valueArray_->offsetAt(index);
+    const auto size = valueArray_->sizeAt(index);
+    VELOX_CHECK_EQ(size, comparisonArray_->sizeAt(index));
+    if (size == 0) {
+      return;
+    }
+    setN(group, decodedN_.valueAt<int64_t>(index));
+    clearNull(group);
+    const auto comparisonOffset = comparisonArray_->offsetAt(index);
+    for (auto i = 0; i < size; ++i) {
+      addEntry(
+          group,
+          decodedComparison_.valueAt<U>(comparisonOffset + i),
+          decodedValue_.isNullAt(offset + i),
+          offset + i);
+    }
+  }
+
+  // Adds the value at 'index' of 'decodedValue_' with 'comparison' to the heap
+  // of 'group' if the heap has less than 'n' entries or if it ranks ahead of
+  // the top of the heap. The top is evicted in the latter case.
+  void addEntry(
+      char* group,
+      U comparison,
+      bool isValueNull,
+      vector_size_t index) {
+    auto* accumulator = this->accumulator(group);
+    auto& heap = accumulator->heap;
+    const bool isFull = heap.size() >= static_cast<size_t>(accumulator->n);
+    if (isFull && !before(comparison, heap.front().comparison)) {
+      return;
+    }
+    auto tracker = trackRowSize(group);
+    if (isFull) {
+      std::pop_heap(heap.begin(), heap.end(), heapCompare);
+      auto& evicted = heap.back();
+      if constexpr (!isNumericOrDate<T>()) {
+        evicted.value.destroy(allocator_);
+      }
+      heap.pop_back();
+    }
+    heap.push_back(Entry{comparison, isValueNull, {}});
+    if (!isValueNull) {
+      store<T, typename Accumulator::ValueAccumulatorType>(
+          &heap.back().value, decodedValue_, index, allocator_);
+    }
+    std::push_heap(heap.begin(), heap.end(), heapCompare);
+  }
+
+  DecodedVector decodedValue_;
+  DecodedVector decodedComparison_;
+  DecodedVector decodedN_;
+  DecodedVector decodedIntermediate_;
+  const ArrayVector* valueArray_{nullptr};
+  const ArrayVector* comparisonArray_{nullptr};
+};
+
+template <typename T, typename U>
+using MaxByNAggregate = MinMaxByNAggregate<T, U, true>;
+
+template <typename T, typename U>
+using MinByNAggregate = MinMaxByNAggregate<T, U, false>;
+
+
 template <template <typename U, typename V> class Aggregate, typename W>
 std::unique_ptr<exec::Aggregate> create(
     TypePtr resultType,
@@ -646,7 +1033,69 @@ std::unique_ptr<exec::Aggregate> create(
   }
 }
 
+template <template <typename U, typename V> class Aggregate, typename W>
+std::unique_ptr<exec::Aggregate> createN(
+    TypePtr resultType,
+    TypePtr compareType,
+    const std::string& errorMessage) {
+  switch (compareType->kind()) {
+    case TypeKind::TINYINT:
+      return std::make_unique<Aggregate<W, int8_t>>(resultType);
+    case TypeKind::SMALLINT:
+      return std::make_unique<Aggregate<W, int16_t>>(resultType);
+    case TypeKind::INTEGER:
+      return std::make_unique<Aggregate<W, int32_t>>(resultType);
+    case TypeKind::BIGINT:
+      return std::make_unique<Aggregate<W, int64_t>>(resultType);
+    case TypeKind::REAL:
+      return std::make_unique<Aggregate<W, float>>(resultType);
+    case TypeKind::DOUBLE:
+      return std::make_unique<Aggregate<W, double>>(resultType);
+    case TypeKind::DATE:
+      return std::make_unique<Aggregate<W, Date>>(resultType);
+    default:
+      VELOX_FAIL("{}", errorMessage);
+      return nullptr;
+  }
+}
+
 template <template <typename U, typename V> class Aggregate>
+std::unique_ptr<exec::Aggregate> createN(
+    TypePtr resultType,
+    TypePtr valueType,
+    TypePtr compareType,
+    const std::string& errorMessage) {
+  switch (valueType->kind()) {
+    case TypeKind::TINYINT:
+      return createN<Aggregate, int8_t>(resultType, compareType, errorMessage);
+    case TypeKind::SMALLINT:
+      return createN<Aggregate, int16_t>(
+          resultType, compareType, errorMessage);
+    case TypeKind::INTEGER:
+      return createN<Aggregate, int32_t>(
+          resultType, compareType, errorMessage);
+    case TypeKind::BIGINT:
+      return createN<Aggregate, int64_t>(
+          resultType, compareType, errorMessage);
+    case TypeKind::REAL:
+      return createN<Aggregate, float>(resultType, compareType, errorMessage);
+    case TypeKind::DOUBLE:
+      return createN<Aggregate, double>(resultType, compareType, errorMessage);
+    case TypeKind::VARCHAR:
+      return createN<Aggregate, StringView>(
+          resultType, compareType, errorMessage);
+    case TypeKind::DATE:
+      return createN<Aggregate, Date>(resultType, compareType, errorMessage);
+    default:
+      VELOX_FAIL("{}", errorMessage);
+  }
+}
+
+template <
+    template <typename U, typename V>
+    class Aggregate,
+    template <typename U, typename V>
+    class NAggregate>
 bool registerMinMaxByAggregate(const std::string& name) {
   std::vector<std::shared_ptr<exec::AggregateFunctionSignature>> signatures;
   for (const auto& valueType :
@@ -675,6 +1124,25 @@ bool registerMinMaxByAggregate(const std::string& name) {
                                .argumentType(compareType)
                                .build());
     }
+    // max_by(x, y, n) and min_by(x, y, n).
+    for (const auto& compareType :
+         {"tinyint",
+          "smallint",
+          "integer",
+          "bigint",
+          "real",
+          "double",
+          "date"}) {
+      signatures.push_back(
+          exec::AggregateFunctionSignatureBuilder()
+              .returnType(fmt::format("array({})", valueType))
+              .intermediateType(fmt::format(
+                  "row(bigint,array({}),array({}))", valueType, compareType))
+              .argumentType(valueType)
+              .argumentType(compareType)
+              .argumentType("bigint")
+              .build());
+    }
   }
 
   exec::registerAggregateFunction(
@@ -685,6 +1153,27 @@ bool registerMinMaxByAggregate(const std::string& name) {
           const std::vector<TypePtr>& argTypes,
           const TypePtr& resultType) -> std::unique_ptr<exec::Aggregate> {
         auto isRawInput = exec::isRawInput(step);
+        const bool isN = isRawInput
+            ? argTypes.size() == 3
+            : (argTypes.size() == 1 && argTypes[0]->size() == 3);
+        if (isN) {
+          const auto valueType = isRawInput
+              ? argTypes[0]
+              : argTypes[0]->childAt(1)->childAt(0);
+          const auto compareType = isRawInput
+              ? argTypes[1]
+              : argTypes[0]->childAt(2)->childAt(0);
+          return createN<NAggregate>(
+              resultType,
+              valueType,
+              compareType,
+              fmt::format(
+                  "Unknown input types for {} ({}) aggregation: {}, {}, BIGINT",
+                  name,
+                  mapAggregationStepToName(step),
+                  valueType->kindName(),
+                  compareType->kindName()));
+        }
         if (isRawInput) {
           VELOX_CHECK_EQ(
               argTypes.size(),
@@ -749,8 +1238,8 @@ bool registerMinMaxByAggregate(const std::string& name) {
 } // namespace
 
 void registerMinMaxByAggregates() {
-  registerMinMaxByAggregate<MaxByAggregate>(kMaxBy);
-  registerMinMaxByAggregate<MinByAggregate>(kMinBy);
+  registerMinMaxByAggregate<MaxByAggregate, MaxByNAggregate>(kMaxBy);
+  registerMinMaxByAggregate<MinByAggregate, MinByNAggregate>(kMinBy);
 }
 
 } // namespace facebook::velox::aggregate::prestosql
@@ -66,6 +66,26 @@ class SimpleNumericAggregate : public exec::Aggregate {
     }
   }
 
+  // Returns the values of 'arg' if 'arg' is a flat vector of T without nulls
+  // and all of its rows are selected, e.g. for a global aggregation over a
+  // scan. Such input can be reduced with SIMD instead of row by row. Returns
+  // nullptr otherwise.
+  template <typename T = TInput>
+  static const T* flatNoNullsValues(
+      const SelectivityVector& rows,
+      const VectorPtr& arg) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+      if (rows.size() == 0 || !rows.isAllSelected() ||
+          arg->encoding() != VectorEncoding::Simple::FLAT ||
+          arg->mayHaveNulls()) {
+        return nullptr;
+      }
+      return arg->asUnchecked<FlatVector<T>>()->rawValues();
+    } else {
+      return nullptr;
+    }
+  }
+
   // TData is either TAccumulator or TResult, which in most cases are the same,
   // but for sum(real) can differ.
   template <
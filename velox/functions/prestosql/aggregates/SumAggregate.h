@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/FunctionSignature.h"
 #include "velox/functions/prestosql/CheckedArithmeticImpl.h"
 #include "velox/functions/prestosql/aggregates/SimpleNumericAggregate.h"
@@ -51,7 +52,7 @@ class SumAggregate
       override {
     BaseAggregate::template doExtractValues<ResultType>(
         groups, numGroups, result, [&](char* group) {
-          return *BaseAggregate::Aggregate::template value<ResultType>(group);
+          return checkedSum<ResultType>(group);
         });
   }
 
@@ -59,7 +60,7 @@ class SumAggregate
       override {
     BaseAggregate::template doExtractValues<TAccumulator>(
         groups, numGroups, result, [&](char* group) {
-          return *BaseAggregate::Aggregate::template value<TAccumulator>(group);
+          return checkedSum<TAccumulator>(group);
         });
   }
 
@@ -84,6 +85,9 @@ class SumAggregate
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
+    if (addSingleGroupSimd<TAccumulator>(group, rows, args[0])) {
+      return;
+    }
     BaseAggregate::template updateOneGroup<TAccumulator>(
         group,
         rows,
@@ -99,6 +103,9 @@ class SumAggregate
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
+    if (addSingleGroupSimd<ResultType>(group, rows, args[0])) {
+      return;
+    }
     BaseAggregate::template updateOneGroup<ResultType>(
         group,
         rows,
@@ -136,14 +143,54 @@ class SumAggregate
   }
 
  private:
+  // Adds the values of 'arg' to 'group' with SIMD if 'arg' is flat without
+  // nulls and all 'rows' are selected. Returns false if the rows must be added
+  // one by one instead, e.g. because the sum of a SIMD lane overflowed, in
+  // which case the serial loop decides whether the sum overflows.
+  template <typename TData>
+  bool addSingleGroupSimd(
+      char* group,
+      const SelectivityVector& rows,
+      const VectorPtr& arg) {
+    if constexpr (std::is_arithmetic_v<TData>) {
+      auto values = BaseAggregate::flatNoNullsValues(rows, arg);
+      if (!values) {
+        return false;
+      }
+      bool overflow = false;
+      auto sum = simd::reduceSum<TData>(values, rows.size(), &overflow);
+      if (overflow) {
+        return false;
+      }
+      exec::Aggregate::clearNull(group);
+      updateSingleValue<TData>(*exec::Aggregate::value<TData>(group), sum);
+      return true;
+    } else {
+      return false;
+    }
+  }
+
   /// Update functions that check for overflows for integer types.
   /// For floating points, an overflow results in +/- infinity which is a
   /// valid output.
+  /// Decimal sums are accumulated as int128_t and only checked for int128_t
+  /// overflow per row. Whether the sum fits in DECIMAL(38) is checked once
+  /// when the sum is extracted.
   template <typename TData>
   static void updateSingleValue(TData& result, TData value) {
     if constexpr (
         std::is_same_v<TData, double> || std::is_same_v<TData, float>) {
       result += value;
+    } else if constexpr (std::is_same_v<TData, UnscaledLongDecimal>) {
+      int128_t sum;
+      if (UNLIKELY(__builtin_add_overflow(
+              result.unscaledValue(), value.unscaledValue(), &sum))) {
+        VELOX_ARITHMETIC_ERROR(
+            "Decimal overflow: {} + {}",
+            result.unscaledValue(),
+            value.unscaledValue());
+      }
+      result.setUnscaledValue(sum);
     } else {
       result = functions::checkedPlus<TData>(result, value);
     }
@@ -154,11 +201,38 @@ class SumAggregate
     if constexpr (
         std::is_same_v<TData, double> || std::is_same_v<TData, float>) {
       result += n * value;
+    } else if constexpr (std::is_same_v<TData, UnscaledLongDecimal>) {
+      int128_t product;
+      int128_t sum;
+      if (UNLIKELY(
+              __builtin_mul_overflow(
+                  value.unscaledValue(), static_cast<int128_t>(n), &product) ||
+              __builtin_add_overflow(result.unscaledValue(), product, &sum))) {
+        VELOX_ARITHMETIC_ERROR(
+            "Decimal overflow: {} + {} * {}",
+            result.unscaledValue(),
+            value.unscaledValue(),
+            n);
+      }
+      result.setUnscaledValue(sum);
     } else {
       result = functions::checkedPlus<TData>(
           result, functions::checkedMultiply<TData>(TData(n), value));
     }
   }
+
+  // Returns the sum in 'group' after checking that a decimal sum fits in
+  // DECIMAL(38).
+  template <typename TData>
+  static TData checkedSum(char* group) {
+    const auto sum = *exec::Aggregate::value<TData>(group);
+    if constexpr (std::is_same_v<TData, UnscaledLongDecimal>) {
+      if (UNLIKELY(!UnscaledLongDecimal::valueInRange(sum.unscaledValue()))) {
+        VELOX_ARITHMETIC_ERROR("Decimal overflow: {}", sum.unscaledValue());
+      }
+    }
+    return sum;
+  }
 };
 
 /// Override 'initializeNewGroups' for float values. Make sure to use 'double'
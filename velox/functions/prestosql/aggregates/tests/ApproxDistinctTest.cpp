@@ -192,6 +192,16 @@ TEST_F(ApproxDistinctTest, globalAggVeryLowCardinalityIntegers) {
   testGlobalAgg(values, 1);
 }
 
+TEST_F(ApproxDistinctTest, globalAggEncodedIntegers) {
+  vector_size_t size = 1'000;
+  testGlobalAgg(makeConstant<int32_t>(27, size), 1);
+
+  auto indices = makeIndices(size, [](auto row) { return (row * 7) % 100; });
+  auto values = wrapInDictionary(
+      indices, makeFlatVector<int32_t>(100, [](auto row) { return row % 17; }));
+  testGlobalAgg(values, 17);
+}
+
 TEST_F(ApproxDistinctTest, globalAggIntegersWithError) {
   vector_size_t size = 1'000;
   auto values = makeFlatVector<int32_t>(size, [](auto row) { return row; });
@@ -60,6 +60,29 @@ TEST_F(ArrayAggTest, groupBy) {
       "SELECT c0, array_agg(a) FROM tmp GROUP BY c0");
 }
 
+TEST_F(ArrayAggTest, groupByFixedWidth) {
+  // Many small groups and a few that span several chunks of their
+  // accumulators.
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 3; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            10'000, [](auto row) { return row % 10 == 0 ? row % 3 : row; }),
+        makeFlatVector<int64_t>(
+            10'000, [i](auto row) { return row + i; }, nullEvery(11)),
+        makeFlatVector<double>(
+            10'000, [](auto row) { return row * 0.1; }, nullEvery(7)),
+    }));
+  }
+
+  createDuckDbTable(batches);
+  testAggregations(
+      batches,
+      {"c0"},
+      {"array_agg(c1)", "array_agg(c2)"},
+      "SELECT c0, array_agg(c1), array_agg(c2) FROM tmp GROUP BY c0");
+}
+
 TEST_F(ArrayAggTest, global) {
   vector_size_t size = 10;
 
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/functions/prestosql/aggregates/AggregateNames.h"
 #include "velox/functions/prestosql/aggregates/tests/AggregationTestBase.h"
@@ -546,6 +547,88 @@ VELOX_INSTANTIATE_TEST_SUITE_P(
     MinMaxByGlobalByAggregationTest,
     testing::ValuesIn(getTestParams()));
 
+class MinMaxByNAggregationTest : public AggregationTestBase {};
+
+TEST_F(MinMaxByNAggregationTest, groupBy) {
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>({1, 2, 1, 2, 1, 2, 1, 1, 3}),
+      makeNullableFlatVector<int64_t>(
+          {10, 20, std::nullopt, 40, 50, 60, 70, 80, 90}),
+      makeNullableFlatVector<double>(
+          {1.0, 2.0, 3.0, 4.0, std::nullopt, 6.0, 7.0, 0.5, std::nullopt}),
+      makeFlatVector<StringView>(
+          {"a", "b", "c", "d", "e", "f", "g", "h", "i"}),
+  });
+
+  // Rows with a null comparison value are ignored. Group 3 has none left.
+  auto expected = makeRowVector({
+      makeFlatVector<int32_t>({1, 2, 3}),
+      makeNullableArrayVector<int64_t>(
+          {{{70, std::nullopt, 10}}, {{60, 40, 20}}, std::nullopt}),
+      makeNullableArrayVector<int64_t>(
+          {{{80, 10, std::nullopt}}, {{20, 40, 60}}, std::nullopt}),
+  });
+  testAggregations(
+      {data},
+      {"c0"},
+      {"max_by(c1, c2, 3)", "min_by(c1, c2, 3)"},
+      {expected});
+
+  expected = makeRowVector({
+      makeFlatVector<int32_t>({1, 2, 3}),
+      makeNullableArrayVector<StringView>(
+          {{{"g", "c"}}, {{"f", "d"}}, std::nullopt}),
+      makeNullableArrayVector<StringView>({{{"h"}}, {{"b"}}, std::nullopt}),
+  });
+  testAggregations(
+      {data},
+      {"c0"},
+      {"max_by(c3, c2, 2)", "min_by(c3, c2, 1)"},
+      {expected});
+}
+
+TEST_F(MinMaxByNAggregationTest, global) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+      makeFlatVector<int32_t>(
+          1'000, [](auto row) { return (row * 7) % 1'000; }),
+  });
+
+  // c1 is a permutation of 0..999. max_by returns the rows with the 5 largest
+  // c1, i.e. 999 down to 995.
+  std::vector<int64_t> maxRows;
+  std::vector<int64_t> minRows;
+  for (auto value = 999; value >= 995; --value) {
+    maxRows.push_back((value * 143) % 1'000);
+  }
+  for (auto value = 0; value < 5; ++value) {
+    minRows.push_back((value * 143) % 1'000);
+  }
+  auto expected = makeRowVector({
+      makeArrayVector<int64_t>({maxRows}),
+      makeArrayVector<int64_t>({minRows}),
+  });
+  testAggregations(
+      {data}, {}, {"max_by(c0, c1, 5)", "min_by(c0, c1, 5)"}, {expected});
+}
+
+TEST_F(MinMaxByNAggregationTest, invalidN) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>({1, 2, 3}),
+      makeFlatVector<int64_t>({1, 2, 3}),
+  });
+  for (const auto& n : {"0", "-1", "10001"}) {
+    auto plan =
+        PlanBuilder()
+            .values({data})
+            .singleAggregation({}, {fmt::format("max_by(c0, c1, {})", n)})
+            .planNode();
+    VELOX_ASSERT_THROW(
+        AssertQueryBuilder(plan).copyResults(pool()),
+        "third argument of max_by/min_by must be");
+  }
+}
+
 class MinMaxByGroupByAggregationTest
     : public MinMaxByAggregationTestBase,
       public testing::WithParamInterface<TestParam> {
@@ -968,5 +1051,87 @@ VELOX_INSTANTIATE_TEST_SUITE_P(
     MinMaxByGroupByAggregationTest,
     testing::ValuesIn(getTestParams()));
 
+class MinMaxByNAggregationTest : public AggregationTestBase {};
+
+TEST_F(MinMaxByNAggregationTest, groupBy) {
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>({1, 2, 1, 2, 1, 2, 1, 1, 3}),
+      makeNullableFlatVector<int64_t>(
+          {10, 20, std::nullopt, 40, 50, 60, 70, 80, 90}),
+      makeNullableFlatVector<double>(
+          {1.0, 2.0, 3.0, 4.0, std::nullopt, 6.0, 7.0, 0.5, std::nullopt}),
+      makeFlatVector<StringView>(
+          {"a", "b", "c", "d", "e", "f", "g", "h", "i"}),
+  });
+
+  // Rows with a null comparison value are ignored. Group 3 has none left.
+  auto expected = makeRowVector({
+      makeFlatVector<int32_t>({1, 2, 3}),
+      makeNullableArrayVector<int64_t>(
+          {{{70, std::nullopt, 10}}, {{60, 40, 20}}, std::nullopt}),
+      makeNullableArrayVector<int64_t>(
+          {{{80, 10, std::nullopt}}, {{20, 40, 60}}, std::nullopt}),
+  });
+  testAggregations(
+      {data},
+      {"c0"},
+      {"max_by(c1, c2, 3)", "min_by(c1, c2, 3)"},
+      {expected});
+
+  expected = makeRowVector({
+      makeFlatVector<int32_t>({1, 2, 3}),
+      makeNullableArrayVector<StringView>(
+          {{{"g", "c"}}, {{"f", "d"}}, std::nullopt}),
+      makeNullableArrayVector<StringView>({{{"h"}}, {{"b"}}, std::nullopt}),
+  });
+  testAggregations(
+      {data},
+      {"c0"},
+      {"max_by(c3, c2, 2)", "min_by(c3, c2, 1)"},
+      {expected});
+}
+
+TEST_F(MinMaxByNAggregationTest, global) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+      makeFlatVector<int32_t>(
+          1'000, [](auto row) { return (row * 7) % 1'000; }),
+  });
+
+  // c1 is a permutation of 0..999. max_by returns the rows with the 5 largest
+  // c1, i.e. 999 down to 995.
+  std::vector<int64_t> maxRows;
+  std::vector<int64_t> minRows;
+  for (auto value = 999; value >= 995; --value) {
+    maxRows.push_back((value * 143) % 1'000);
+  }
+  for (auto value = 0; value < 5; ++value) {
+    minRows.push_back((value * 143) % 1'000);
+  }
+  auto expected = makeRowVector({
+      makeArrayVector<int64_t>({maxRows}),
+      makeArrayVector<int64_t>({minRows}),
+  });
+  testAggregations(
+      {data}, {}, {"max_by(c0, c1, 5)", "min_by(c0, c1, 5)"}, {expected});
+}
+
+TEST_F(MinMaxByNAggregationTest, invalidN) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>({1, 2, 3}),
+      makeFlatVector<int64_t>({1, 2, 3}),
+  });
+  for (const auto& n : {"0", "-1", "10001"}) {
+    auto plan =
+        PlanBuilder()
+            .values({data})
+            .singleAggregation({}, {fmt::format("max_by(c0, c1, {})", n)})
+            .planNode();
+    VELOX_ASSERT_THROW(
+        AssertQueryBuilder(plan).copyResults(pool()),
+        "third argument of max_by/min_by must be");
+  }
+}
+
 } // namespace
 } // namespace facebook::velox::aggregate::test
@@ -263,6 +263,24 @@ TEST_F(SumTest, sumDecimal) {
       {input}, {}, {"sum(c0)", "sum(c1)"}, "SELECT sum(c0), sum(c1) FROM tmp");
 }
 
+TEST_F(SumTest, decimalRangeCheckedOnExtract) {
+  const auto kMax = UnscaledLongDecimal::max().unscaledValue();
+  auto sumOf = [&](const std::vector<int128_t>& values) {
+    return readSingleValue(
+        PlanBuilder()
+            .values({makeRowVector(
+                {makeLongDecimalFlatVector(values, DECIMAL(38, 0))})})
+            .singleAggregation({}, {"sum(c0)"})
+            .planNode());
+  };
+
+  // The running sum exceeds DECIMAL(38) but the final sum does not.
+  EXPECT_EQ(
+      UnscaledLongDecimal(kMax),
+      sumOf({kMax, kMax, -kMax}).value<TypeKind::LONG_DECIMAL>().value());
+  VELOX_ASSERT_THROW(sumOf({kMax, 1}), "Decimal overflow");
+}
+
 TEST_F(SumTest, sumWithMask) {
   auto rowType =
       ROW({"c0", "c1", "c2", "c3", "c4"},
@@ -386,6 +404,48 @@ TEST_F(SumTest, emptyValues) {
   testAggregations({vector}, {"c0"}, {"sum(c1)"}, "");
 }
 
+/// Test global sum, min, max and count over flat input without nulls, which is
+/// reduced with SIMD.
+TEST_F(SumTest, flatNoNulls) {
+  vector_size_t size = 1'003;
+  auto data = {makeRowVector({
+      makeFlatVector<int8_t>(size, [](auto row) { return row % 113 - 50; }),
+      makeFlatVector<int16_t>(size, [](auto row) { return row * 7 - 3'000; }),
+      makeFlatVector<int32_t>(size, [](auto row) { return row * 1'001; }),
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return (row % 17) * 1'000'000'007L; }),
+      makeFlatVector<double>(size, [](auto row) { return row * 0.5; }),
+  })};
+  createDuckDbTable(data);
+
+  testAggregations(
+      data,
+      {},
+      {"sum(c0)",
+       "sum(c1)",
+       "sum(c2)",
+       "sum(c3)",
+       "sum(c4)",
+       "min(c1)",
+       "max(c2)",
+       "min(c3)",
+       "max(c3)",
+       "count(c0)"},
+      "SELECT sum(c0), sum(c1), sum(c2), sum(c3), sum(c4), min(c1), max(c2), "
+      "min(c3), max(c3), count(c0) FROM tmp");
+
+  // The lanes overflow. The rows are then added one by one to check whether
+  // the sum overflows.
+  auto overflowData = makeRowVector({makeFlatVector<int64_t>(
+      size, [](auto /*row*/) { return std::numeric_limits<int64_t>::max(); })});
+  VELOX_ASSERT_THROW(
+      readSingleValue(PlanBuilder()
+                          .values({overflowData})
+                          .singleAggregation({}, {"sum(c0)"})
+                          .planNode()),
+      "overflow");
+}
+
 /// Test aggregating over lots of null values.
 TEST_F(SumTest, nulls) {
   vector_size_t size = 10'000;
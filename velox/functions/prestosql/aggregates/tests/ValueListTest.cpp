@@ -15,6 +15,7 @@
  */
 #include "velox/functions/prestosql/aggregates/ValueList.h"
 #include <gtest/gtest.h>
+#include "velox/functions/prestosql/aggregates/FixedWidthValueList.h"
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
 #include "velox/vector/tests/utils/VectorMaker.h"
 
@@ -47,6 +48,39 @@ class ValueListTest : public functions::test::FunctionBaseTest {
     assertEqualVectors(data, result);
   }
 
+  void testFixedWidthRoundTrip(const VectorPtr& data) {
+    auto size = data->size();
+    auto flatData = data->asFlatVector<int64_t>();
+
+    // Half the values one by one, the rest in ranges of varying size.
+    aggregate::FixedWidthValueList<int64_t> values;
+    auto half = size / 2;
+    for (auto i = 0; i < half; i++) {
+      if (flatData->isNullAt(i)) {
+        values.appendNull(allocator());
+      } else {
+        values.append(flatData->valueAt(i), allocator());
+      }
+    }
+    for (auto i = half, rangeSize = 1; i < size; i += rangeSize++) {
+      values.appendRange(
+          flatData->rawValues(),
+          flatData->rawNulls(),
+          i,
+          std::min<vector_size_t>(rangeSize, size - i),
+          allocator());
+    }
+    ASSERT_EQ(size, values.size());
+
+    // Copies to an offset of a vector with nulls to reuse.
+    auto result = makeFlatVector<int64_t>(
+        size + 3, [](auto row) { return row; }, [](auto) { return true; });
+    values.copyTo(*result, 3);
+    assertEqualVectors(data, result->slice(3, size));
+
+    values.free(allocator());
+  }
+
   HashStringAllocator* allocator() {
     return allocator_.get();
   }
@@ -101,3 +135,16 @@ TEST_F(ValueListTest, arrays) {
     }
   }
 }
+
+TEST_F(ValueListTest, fixedWidth) {
+  for (auto size : {1, 10, 1'000, 10'000}) {
+    testFixedWidthRoundTrip(
+        makeFlatVector<int64_t>(size, [](auto row) { return row; }));
+    for (auto nullEvery : {2, 7, 97}) {
+      testFixedWidthRoundTrip(makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return row; },
+          test::VectorMaker::nullEvery(nullEvery)));
+    }
+  }
+}
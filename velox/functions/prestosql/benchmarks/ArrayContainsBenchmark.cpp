@@ -124,6 +124,45 @@ class ArrayContainsBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, rowVector);
   }
 
+  // Runs array function 'functionName' over arrays of 'arraySize' integers.
+  // If 'constantRight' the second argument is a constant array, otherwise it
+  // is another column of arrays. Used for array_distinct() and the functions
+  // that use a set of the elements of an array.
+  void runArraySet(
+      const std::string& functionName,
+      vector_size_t arraySize,
+      bool constantRight,
+      bool unary = false) {
+    folly::BenchmarkSuspender suspender;
+    vector_size_t size = 1'000;
+    auto left = vectorMaker_.arrayVector<int32_t>(
+        size,
+        [&](auto /*row*/) { return arraySize; },
+        [&](auto row) { return row % (arraySize * 2); });
+    VectorPtr right;
+    if (constantRight) {
+      auto array = vectorMaker_.arrayVector<int32_t>(
+          1,
+          [&](auto /*row*/) { return arraySize; },
+          [](auto row) { return row * 2; });
+      right = BaseVector::wrapInConstant(size, 0, array);
+    } else {
+      right = vectorMaker_.arrayVector<int32_t>(
+          size,
+          [&](auto /*row*/) { return arraySize; },
+          [](auto row) { return row % 7; });
+    }
+
+    auto rowVector = vectorMaker_.rowVector({left, right});
+    auto exprSet = compileExpression(
+        unary ? fmt::format("{}(c0)", functionName)
+              : fmt::format("{}(c0, c1)", functionName),
+        rowVector->type());
+    suspender.dismiss();
+
+    doRun(exprSet, rowVector);
+  }
+
   void doRun(ExprSet& exprSet, const RowVectorPtr& rowVector) {
     int cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -143,6 +182,58 @@ BENCHMARK_RELATIVE(vectorFunctionInteger) {
   benchmark.runInteger("contains");
 }
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(arrayDistinctSmall) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runArraySet("array_distinct", 5, false, true);
+}
+
+BENCHMARK(arrayDistinctLarge) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runArraySet("array_distinct", 100, false, true);
+}
+
+BENCHMARK(arrayDuplicatesSmall) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runArraySet("array_duplicates", 5, false, true);
+}
+
+BENCHMARK(arrayDuplicatesLarge) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runArraySet("array_duplicates", 100, false, true);
+}
+
+BENCHMARK(arrayIntersectSmall) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runArraySet("array_intersect", 5, false);
+}
+
+BENCHMARK(arrayIntersectLarge) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runArraySet("array_intersect", 100, false);
+}
+
+BENCHMARK(arrayIntersectConstantLarge) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runArraySet("array_intersect", 100, true);
+}
+
+BENCHMARK(arrayExceptSmall) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runArraySet("array_except", 5, false);
+}
+
+BENCHMARK(arrayExceptLarge) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runArraySet("array_except", 100, false);
+}
+
+BENCHMARK(arrayExceptConstantLarge) {
+  ArrayContainsBenchmark benchmark;
+  benchmark.runArraySet("array_except", 100, true);
+}
+
 } // namespace
 
 int main(int /*argc*/, char** /*argv*/) {
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include "velox/functions/lib/ValueSorter.h"
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::functions;
+
+namespace {
+
+class ArraySortBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  ArraySortBenchmark() : FunctionBenchmarkBase() {
+    functions::prestosql::registerArrayFunctions();
+  }
+
+  template <typename T>
+  void run(vector_size_t arraySize) {
+    folly::BenchmarkSuspender suspender;
+    vector_size_t size = 100'000 / arraySize;
+    folly::Random::DefaultGenerator rng(1);
+    auto arrayVector = vectorMaker_.arrayVector<T>(
+        size,
+        [&](auto /*row*/) { return arraySize; },
+        [&](auto /*row*/) { return folly::Random::rand64(rng); });
+
+    auto rowVector = vectorMaker_.rowVector({arrayVector});
+    auto exprSet = compileExpression("array_sort(c0)", rowVector->type());
+    suspender.dismiss();
+
+    int cnt = 0;
+    for (auto i = 0; i < 100; i++) {
+      cnt += evaluate(exprSet, rowVector)->size();
+    }
+    folly::doNotOptimizeAway(cnt);
+  }
+};
+
+// Sorts 100K random values as arrays of 'arraySize' with std::sort or with
+// ValueSorter.
+template <typename T>
+void sortKernel(vector_size_t arraySize, bool useValueSorter) {
+  folly::BenchmarkSuspender suspender;
+  constexpr int32_t kNumValues = 100'000;
+  folly::Random::DefaultGenerator rng(1);
+  std::vector<T> input(kNumValues);
+  for (auto& value : input) {
+    value = folly::Random::rand64(rng);
+  }
+  ValueSorter<T> sorter;
+  std::vector<T> values;
+  suspender.dismiss();
+
+  for (auto i = 0; i < 10; ++i) {
+    suspender.rehire();
+    values = input;
+    suspender.dismiss();
+    for (auto offset = 0; offset + arraySize <= kNumValues;
+         offset += arraySize) {
+      auto* begin = values.data() + offset;
+      if (useValueSorter) {
+        sorter.sort(begin, begin + arraySize, true);
+      } else {
+        std::sort(begin, begin + arraySize);
+      }
+    }
+  }
+  folly::doNotOptimizeAway(values);
+}
+
+BENCHMARK(stdSortBigint8) {
+  sortKernel<int64_t>(8, false);
+}
+
+BENCHMARK_RELATIVE(valueSorterBigint8) {
+  sortKernel<int64_t>(8, true);
+}
+
+BENCHMARK(stdSortBigint1000) {
+  sortKernel<int64_t>(1'000, false);
+}
+
+BENCHMARK_RELATIVE(valueSorterBigint1000) {
+  sortKernel<int64_t>(1'000, true);
+}
+
+BENCHMARK(stdSortInteger10000) {
+  sortKernel<int32_t>(10'000, false);
+}
+
+BENCHMARK_RELATIVE(valueSorterInteger10000) {
+  sortKernel<int32_t>(10'000, true);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(arraySortBigint8) {
+  ArraySortBenchmark benchmark;
+  benchmark.run<int64_t>(8);
+}
+
+BENCHMARK(arraySortBigint1000) {
+  ArraySortBenchmark benchmark;
+  benchmark.run<int64_t>(1'000);
+}
+
+BENCHMARK(arraySortDouble8) {
+  ArraySortBenchmark benchmark;
+  benchmark.run<double>(8);
+}
+
+BENCHMARK(arraySortDouble1000) {
+  ArraySortBenchmark benchmark;
+  benchmark.run<double>(1'000);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -124,6 +124,26 @@ class DateTimeBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, data);
   }
 
+  // Runs 'expression' over timestamps a minute apart, as in an event log,
+  // with timestamps adjusted to the session time zone 'timeZone'.
+  void runSessionTimeZone(
+      const std::string& expression,
+      const std::string& timeZone) {
+    folly::BenchmarkSuspender suspender;
+    queryCtx_->setConfigOverridesUnsafe({
+        {core::QueryConfig::kSessionTimezone, timeZone},
+        {core::QueryConfig::kAdjustTimestampToTimezone, "true"},
+    });
+    auto timestamps = vectorMaker_.flatVector<Timestamp>(10'000, [](auto row) {
+      return Timestamp(1'600'000'000 + row * 60, 0);
+    });
+    auto data = vectorMaker_.rowVector({timestamps});
+    auto exprSet = compileExpression(expression, data->type());
+    suspender.dismiss();
+
+    doRun(exprSet, data);
+  }
+
   void doRun(exec::ExprSet& exprSet, const RowVectorPtr& rowVector) {
     int cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -188,6 +208,26 @@ BENCHMARK_RELATIVE(hour_vector) {
   benchmark.run("hour_vector");
 }
 
+BENCHMARK(hourSessionTimeZone) {
+  DateTimeBenchmark benchmark;
+  benchmark.runSessionTimeZone("hour(c0)", "America/Los_Angeles");
+}
+
+BENCHMARK_RELATIVE(hour_vectorSessionTimeZone) {
+  DateTimeBenchmark benchmark;
+  benchmark.runSessionTimeZone("hour_vector(c0)", "America/Los_Angeles");
+}
+
+BENCHMARK(daySessionTimeZone) {
+  DateTimeBenchmark benchmark;
+  benchmark.runSessionTimeZone("day(c0)", "Asia/Kolkata");
+}
+
+BENCHMARK(truncDaySessionTimeZone) {
+  DateTimeBenchmark benchmark;
+  benchmark.runSessionTimeZone("date_trunc('day', c0)", "America/Los_Angeles");
+}
+
 BENCHMARK(minute) {
   DateTimeBenchmark benchmark;
   benchmark.run("minute");
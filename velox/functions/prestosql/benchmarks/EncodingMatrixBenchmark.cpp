@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <iostream>
+
+#include "velox/common/time/Timer.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/expression/SignatureBinder.h"
+#include "velox/functions/FunctionRegistry.h"
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+// Runs the signatures of a registered scalar or aggregate function over
+// inputs of different encodings made with VectorFuzzer and reports the
+// throughput of each encoding next to that of flat inputs. Regressions that
+// only show for, e.g., dictionaries over constants or lazy vectors are
+// flagged with SLOW. Exits with 1 if any encoding is flagged.
+//
+// velox_functions_prestosql_benchmarks_encoding_matrix --function=array_max
+
+DEFINE_string(function, "", "Scalar or aggregate function to benchmark.");
+
+DEFINE_int32(vector_size, 10'000, "Number of rows per input vector.");
+
+DEFINE_int32(iterations, 20, "Number of times each input is evaluated.");
+
+DEFINE_int32(
+    num_batches,
+    10,
+    "Number of input vectors per aggregation query.");
+
+DEFINE_double(null_ratio, 0.1, "Chance of a null in the fuzzed inputs.");
+
+DEFINE_double(
+    slowdown_threshold,
+    3.0,
+    "Flags an encoding if flat inputs of the same signature have this many "
+    "times its throughput.");
+
+DEFINE_int32(seed, 123456, "Seed of the VectorFuzzer.");
+
+using namespace facebook::velox;
+
+namespace {
+
+enum class Encoding {
+  kFlat,
+  kConstant,
+  kDictionary,
+  kDictionaryOverConstant,
+  kNestedDictionary,
+  kLazy,
+  kDictionaryOverArrayElements,
+};
+
+constexpr Encoding kEncodings[] = {
+    Encoding::kFlat,
+    Encoding::kConstant,
+    Encoding::kDictionary,
+    Encoding::kDictionaryOverConstant,
+    Encoding::kNestedDictionary,
+    Encoding::kLazy,
+    Encoding::kDictionaryOverArrayElements,
+};
+
+const char* encodingName(Encoding encoding) {
+  switch (encoding) {
+    case Encoding::kFlat:
+      return "flat";
+    case Encoding::kConstant:
+      return "constant";
+    case Encoding::kDictionary:
+      return "dictionary";
+    case Encoding::kDictionaryOverConstant:
+      return "dictionary_over_constant";
+    case Encoding::kNestedDictionary:
+      return "nested_dictionary";
+    case Encoding::kLazy:
+      return "lazy";
+    case Encoding::kDictionaryOverArrayElements:
+      return "dictionary_over_array_elements";
+  }
+  VELOX_UNREACHABLE();
+}
+
+class EncodingMatrixBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  EncodingMatrixBenchmark() : fuzzer_(makeOptions(), pool(), FLAGS_seed) {
+    functions::prestosql::registerAllScalarFunctions();
+    aggregate::prestosql::registerAllAggregateFunctions();
+  }
+
+  // Runs all signatures of 'name'. Returns the number of flagged encodings.
+  int32_t run(const std::string& name) {
+    int32_t numSlow = 0;
+    bool found = false;
+    auto scalarSignatures = getFunctionSignatures();
+    auto it = scalarSignatures.find(name);
+    if (it != scalarSignatures.end()) {
+      found = true;
+      for (const auto* signature : it->second) {
+        numSlow += runSignature(name, *signature, false);
+      }
+    }
+    if (auto signatures = exec::getAggregateFunctionSignatures(name)) {
+      found = true;
+      for (const auto& signature : signatures.value()) {
+        numSlow += runSignature(name, *signature, true);
+      }
+    }
+    VELOX_USER_CHECK(found, "Function not found: {}", name);
+    return numSlow;
+  }
+
+ private:
+  static VectorFuzzer::Options makeOptions() {
+    VectorFuzzer::Options options;
+    options.vectorSize = FLAGS_vector_size;
+    options.nullRatio = FLAGS_null_ratio;
+    return options;
+  }
+
+  // Returns the argument types of 'signature' with all type variables bound
+  // to BIGINT or std::nullopt if some argument can't be resolved, e.g. for
+  // decimal precisions or 'any'.
+  static std::optional<std::vector<TypePtr>> resolveArgumentTypes(
+      const exec::FunctionSignature& signature) {
+    std::unordered_map<std::string, TypePtr> bindings;
+    for (const auto& variable : signature.typeVariableConstraints()) {
+      if (variable.isTypeParameter()) {
+        bindings[variable.name()] = BIGINT();
+      }
+    }
+    std::vector<TypePtr> types;
+    for (const auto& argument : signature.argumentTypes()) {
+      auto type = exec::SignatureBinder::tryResolveType(argument, bindings);
+      if (!type) {
+        return std::nullopt;
+      }
+      types.push_back(std::move(type));
+    }
+    return types;
+  }
+
+  int32_t runSignature(
+      const std::string& name,
+      const exec::FunctionSignature& signature,
+      bool isAggregate) {
+    auto types = resolveArgumentTypes(signature);
+    if (!types.has_value()) {
+      std::cout << "Skipping " << name << signature.toString()
+                << ": unresolved argument types" << std::endl;
+      return 0;
+    }
+    std::cout << name << signature.toString() << std::endl;
+
+    double flatRowsPerSec = 0;
+    int32_t numSlow = 0;
+    for (auto encoding : kEncodings) {
+      auto makeInput = makeInputFactory(encoding, types.value());
+      if (!makeInput) {
+        continue;
+      }
+      double rowsPerSec;
+      try {
+        rowsPerSec = isAggregate
+            ? runAggregate(name, makeInput)
+            : runScalar(name, signature, types.value(), makeInput);
+      } catch (const std::exception& e) {
+        std::cout << "  " << encodingName(encoding) << " failed: " << e.what()
+                  << std::endl;
+        continue;
+      }
+      if (encoding == Encoding::kFlat) {
+        flatRowsPerSec = rowsPerSec;
+      }
+      const auto slowdown =
+          flatRowsPerSec > 0 ? flatRowsPerSec / rowsPerSec : 0;
+      const bool slow = slowdown > FLAGS_slowdown_threshold;
+      numSlow += slow;
+      std::cout << fmt::format(
+                       "  {:<32} {:>14.0f} rows/s {:>6.2f}x {}",
+                       encodingName(encoding),
+                       rowsPerSec,
+                       slowdown,
+                       slow ? "SLOW" : "")
+                << std::endl;
+    }
+    return numSlow;
+  }
+
+  // Returns the input for an argument of 'type' in 'encoding' or nullptr if
+  // 'encoding' does not apply to 'type'.
+  VectorPtr makeArgument(Encoding encoding, const TypePtr& type) {
+    const vector_size_t size = FLAGS_vector_size;
+    switch (encoding) {
+      case Encoding::kFlat:
+      case Encoding::kLazy:
+        return fuzzer_.fuzzFlat(type, size);
+      case Encoding::kConstant:
+        return BaseVector::wrapInConstant(size, 0, fuzzer_.fuzzFlat(type, 1));
+      case Encoding::kDictionary:
+        return fuzzer_.fuzzDictionary(fuzzer_.fuzzFlat(type, size), size);
+      case Encoding::kDictionaryOverConstant:
+        return fuzzer_.fuzzDictionary(
+            BaseVector::wrapInConstant(size, 0, fuzzer_.fuzzFlat(type, 1)),
+            size);
+      case Encoding::kNestedDictionary:
+        return fuzzer_.fuzzDictionary(
+            fuzzer_.fuzzDictionary(fuzzer_.fuzzFlat(type, size), size), size);
+      case Encoding::kDictionaryOverArrayElements: {
+        if (type->kind() != TypeKind::ARRAY) {
+          return nullptr;
+        }
+        const vector_size_t numElements =
+            size * makeOptions().containerLength;
+        auto elements = fuzzer_.fuzzFlat(type->childAt(0), numElements);
+        return fuzzer_.fuzzArray(
+            fuzzer_.fuzzDictionary(elements, numElements), size);
+      }
+    }
+    VELOX_UNREACHABLE();
+  }
+
+  // Returns a function that makes the input batches in 'encoding' or nullptr
+  // if 'encoding' applies to none of 'types'. The inputs are fuzzed once.
+  // Only lazy inputs are wrapped anew for each call since a LazyVector is
+  // loaded only once.
+  std::function<RowVectorPtr()> makeInputFactory(
+      Encoding encoding,
+      const std::vector<TypePtr>& types) {
+    std::vector<VectorPtr> arguments;
+    bool applies = false;
+    for (const auto& type : types) {
+      auto argument = makeArgument(encoding, type);
+      if (argument) {
+        applies = true;
+      } else {
+        argument = fuzzer_.fuzzFlat(type, FLAGS_vector_size);
+      }
+      arguments.push_back(std::move(argument));
+    }
+    if (!applies) {
+      return nullptr;
+    }
+    if (encoding != Encoding::kLazy) {
+      auto input = maker().rowVector(arguments);
+      return [input]() { return input; };
+    }
+    return [this, arguments]() {
+      std::vector<VectorPtr> lazyArguments;
+      for (const auto& argument : arguments) {
+        lazyArguments.push_back(std::make_shared<LazyVector>(
+            pool(),
+            argument->type(),
+            argument->size(),
+            std::make_unique<facebook::velox::test::SimpleVectorLoader>(
+                [argument](RowSet /*rows*/) { return argument; })));
+      }
+      return maker().rowVector(lazyArguments);
+    };
+  }
+
+  double runScalar(
+      const std::string& name,
+      const exec::FunctionSignature& signature,
+      const std::vector<TypePtr>& types,
+      const std::function<RowVectorPtr()>& makeInput) {
+    auto returnType =
+        exec::SignatureBinder(signature, types).tryResolveReturnType();
+    VELOX_CHECK_NOT_NULL(returnType, "Cannot resolve the return type");
+    std::vector<core::TypedExprPtr> inputs;
+    for (auto i = 0; i < types.size(); ++i) {
+      inputs.push_back(std::make_shared<core::FieldAccessTypedExpr>(
+          types[i], fmt::format("c{}", i)));
+    }
+    exec::ExprSet exprSet(
+        {std::make_shared<core::CallTypedExpr>(
+            returnType, std::move(inputs), name)},
+        &execCtx_);
+
+    uint64_t micros = 0;
+    for (auto i = 0; i < FLAGS_iterations; ++i) {
+      auto input = makeInput();
+      MicrosecondTimer timer(&micros);
+      evaluate(exprSet, input);
+    }
+    return rowsPerSec(FLAGS_vector_size, micros);
+  }
+
+  double runAggregate(
+      const std::string& name,
+      const std::function<RowVectorPtr()>& makeInput) {
+    uint64_t micros = 0;
+    for (auto i = 0; i < FLAGS_iterations; ++i) {
+      std::vector<RowVectorPtr> batches;
+      for (auto j = 0; j < FLAGS_num_batches; ++j) {
+        batches.push_back(makeInput());
+      }
+      const auto& names = asRowType(batches[0]->type())->names();
+      const auto call =
+          fmt::format("{}({})", name, folly::join(", ", names));
+      auto plan = exec::test::PlanBuilder()
+                      .values(batches)
+                      .singleAggregation({}, {call})
+                      .planNode();
+      MicrosecondTimer timer(&micros);
+      exec::test::AssertQueryBuilder(plan).copyResults(pool());
+    }
+    return rowsPerSec(
+        static_cast<int64_t>(FLAGS_vector_size) * FLAGS_num_batches, micros);
+  }
+
+  static double rowsPerSec(int64_t rowsPerIteration, uint64_t micros) {
+    return rowsPerIteration * FLAGS_iterations * 1'000'000.0 /
+        std::max<uint64_t>(micros, 1);
+  }
+
+  VectorFuzzer fuzzer_;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  VELOX_USER_CHECK(!FLAGS_function.empty(), "--function is required");
+  EncodingMatrixBenchmark benchmark;
+  return benchmark.run(FLAGS_function) > 0 ? 1 : 0;
+}
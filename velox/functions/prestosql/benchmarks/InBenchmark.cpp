@@ -56,14 +56,41 @@ class InBenchmark : public functions::test::FunctionBenchmarkBase {
         {VectorFuzzer(opts, pool()).fuzzFlat(INTEGER())});
   }
 
-  void run(size_t numValues) {
+  // Runs IN over a list of 'numValues' multiples of 'step'. A large 'step'
+  // makes the values too sparse for a bitmap.
+  void run(size_t numValues, int32_t step = 2) {
     folly::BenchmarkSuspender suspender;
     auto data = makeData();
 
     std::ostringstream inList;
     inList << "0";
     for (auto i = 1; i < numValues; ++i) {
-      inList << ", " << i * 2;
+      inList << ", " << i * step;
+    }
+
+    auto sql = fmt::format("c0 IN ({})", inList.str());
+    auto exprSet = compileExpression(sql, data->type());
+    suspender.dismiss();
+
+    doRun(exprSet, data);
+  }
+
+  void runVarchar(size_t numValues) {
+    folly::BenchmarkSuspender suspender;
+    // Half of the rows match. Long strings share their prefixes.
+    auto makeString = [](int32_t i) {
+      return fmt::format("string-value-{}", i);
+    };
+    std::vector<std::string> strings;
+    for (auto i = 0; i < 1'000; ++i) {
+      strings.push_back(makeString(i % (numValues * 2)));
+    }
+    auto data = vectorMaker_.rowVector({vectorMaker_.flatVector<StringView>(
+        strings.size(), [&](auto row) { return StringView(strings[row]); })});
+
+    std::ostringstream inList;
+    for (auto i = 0; i < numValues; ++i) {
+      inList << (i > 0 ? ", '" : "'") << makeString(i * 2) << "'";
     }
 
     auto sql = fmt::format("c0 IN ({})", inList.str());
@@ -126,6 +153,26 @@ BENCHMARK_RELATIVE(in1K) {
   benchmark.run(1'000);
 }
 
+BENCHMARK(inSparse) {
+  InBenchmark benchmark;
+  benchmark.run(10, 1'000);
+}
+
+BENCHMARK(inSparse1K) {
+  InBenchmark benchmark;
+  benchmark.run(1'000, 1'000);
+}
+
+BENCHMARK(inVarchar) {
+  InBenchmark benchmark;
+  benchmark.runVarchar(10);
+}
+
+BENCHMARK(inVarchar1K) {
+  InBenchmark benchmark;
+  benchmark.runVarchar(1'000);
+}
+
 } // namespace
 
 int main(int /*argc*/, char** /*argv*/) {
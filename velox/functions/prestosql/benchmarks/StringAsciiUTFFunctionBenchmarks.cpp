@@ -32,7 +32,9 @@ class StringAsciiUTFFunctionBenchmark
     functions::prestosql::registerStringFunctions();
   }
 
-  void runUpperLower(const std::string& fnName, bool utf) {
+  // The input stays referenced by the row vector, so the ascii upper and lower
+  // can't write in place and convert the string buffers of the input instead.
+  void runUnary(const std::string& fnName, bool utf) {
     folly::BenchmarkSuspender suspender;
 
     VectorFuzzer::Options opts;
@@ -125,22 +127,52 @@ class StringAsciiUTFFunctionBenchmark
 
 BENCHMARK(utfLower) {
   StringAsciiUTFFunctionBenchmark benchmark;
-  benchmark.runUpperLower("lower", true);
+  benchmark.runUnary("lower", true);
 }
 
 BENCHMARK_RELATIVE(asciiLower) {
   StringAsciiUTFFunctionBenchmark benchmark;
-  benchmark.runUpperLower("lower", false);
+  benchmark.runUnary("lower", false);
 }
 
 BENCHMARK(utfUpper) {
   StringAsciiUTFFunctionBenchmark benchmark;
-  benchmark.runUpperLower("upper", true);
+  benchmark.runUnary("upper", true);
 }
 
 BENCHMARK_RELATIVE(asciiUpper) {
   StringAsciiUTFFunctionBenchmark benchmark;
-  benchmark.runUpperLower("upper", false);
+  benchmark.runUnary("upper", false);
+}
+
+BENCHMARK(utfTrim) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("trim", true);
+}
+
+BENCHMARK_RELATIVE(asciiTrim) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("trim", false);
+}
+
+BENCHMARK(utfLength) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("length", true);
+}
+
+BENCHMARK_RELATIVE(asciiLength) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("length", false);
+}
+
+BENCHMARK(utfReverse) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("reverse", true);
+}
+
+BENCHMARK_RELATIVE(asciiReverse) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runUnary("reverse", false);
 }
 
 BENCHMARK(utfSubStr) {
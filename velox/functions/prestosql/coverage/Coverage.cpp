@@ -256,7 +256,8 @@ void printCoverageMap(
 /// Returns alphabetically sorted list of scalar functions available in Velox.
 std::vector<std::string> getSortedScalarNames() {
   // Do not print "internal" functions.
-  static const std::unordered_set<std::string> kBlockList = {"row_constructor"};
+  static const std::unordered_set<std::string> kBlockList = {
+      "row_constructor", "$internal$json_extract_scalars"};
 
   auto functions = getFunctionSignatures();
 
@@ -17,10 +17,11 @@
 #include "velox/functions/prestosql/json/JsonExtractor.h"
 
 #include <cctype>
+#include <cstring>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
-#include "boost/algorithm/string/trim.hpp"
 #include "folly/String.h"
 #include "folly/json.h"
 #include "velox/common/base/Exceptions.h"
@@ -32,72 +33,434 @@ namespace {
 
 using JsonVector = std::vector<const folly::dynamic*>;
 
-class JsonExtractor {
+// Cache of extractors across invocations in the same thread for the same
+// json path.
+const JsonExtractor& getInstance(folly::StringPiece path) {
+  // Max extractor number in extractor cache
+  static constexpr uint32_t kMaxCacheNum{32};
+  thread_local std::
+      unordered_map<std::string, std::shared_ptr<JsonExtractor>>
+          extractorCache;
+
+  // Pre-process
+  auto trimedPath = folly::trimWhitespace(path).str();
+  auto it = extractorCache.find(trimedPath);
+  if (it != extractorCache.end()) {
+    return *it->second;
+  }
+  if (extractorCache.size() == kMaxCacheNum) {
+    // TODO: Blindly evict the first one, use better policy
+    extractorCache.erase(extractorCache.begin());
+  }
+  auto op = std::make_shared<JsonExtractor>(trimedPath);
+  extractorCache[trimedPath] = op;
+  return *op;
+}
+
+// The nesting depth at which folly::parseJson fails by default.
+constexpr int32_t kMaxDepth = 100;
+
+// Scans json text without materializing it. Each scan function consumes the
+// item starting at 'pos' and returns false if the text is not valid json, in
+// which case 'pos' is undefined.
+class JsonScanner {
  public:
-  // Use this method to get an instance of JsonExtractor given a json path.
-  static JsonExtractor& getInstance(folly::StringPiece path) {
-    // Pre-process
-    auto trimedPath = folly::trimWhitespace(path).str();
-
-    std::shared_ptr<JsonExtractor> op;
-    if (kExtractorCache.count(trimedPath)) {
-      op = kExtractorCache.at(trimedPath);
-    } else {
-      if (kExtractorCache.size() == kMaxCacheNum) {
-        // TODO: Blindly evict the first one, use better policy
-        kExtractorCache.erase(kExtractorCache.begin());
-      }
-      op = std::make_shared<JsonExtractor>(trimedPath);
-      kExtractorCache[trimedPath] = op;
+  explicit JsonScanner(folly::StringPiece json) : end_(json.end()) {}
+
+  const char* end() const {
+    return end_;
+  }
+
+  void skipWhitespace(const char*& pos) const {
+    while (pos < end_ &&
+           (*pos == ' ' || *pos == '\n' || *pos == '\t' || *pos == '\r')) {
+      ++pos;
+    }
+  }
+
+  // Consumes 'expected' and the whitespace after it.
+  bool consume(const char*& pos, char expected) const {
+    if (pos == end_ || *pos != expected) {
+      return false;
     }
-    return *op;
+    ++pos;
+    skipWhitespace(pos);
+    return true;
   }
 
-  folly::Optional<folly::dynamic> extract(const folly::dynamic& json);
+  // Consumes a string. Sets 'hasEscapes' if the string has a backslash.
+  bool skipString(const char*& pos, bool& hasEscapes) const {
+    ++pos;
+    hasEscapes = false;
+    while (pos < end_) {
+      const auto c = static_cast<unsigned char>(*pos);
+      if (c == '"') {
+        ++pos;
+        return true;
+      }
+      if (c < 0x20) {
+        return false;
+      }
+      if (c == '\\') {
+        hasEscapes = true;
+        if (++pos == end_) {
+          return false;
+        }
+        if (*pos == 'u') {
+          if (end_ - pos < 5) {
+            return false;
+          }
+          for (auto i = 1; i < 5; ++i) {
+            if (!std::isxdigit(static_cast<unsigned char>(pos[i]))) {
+              return false;
+            }
+          }
+          pos += 4;
+        } else if (!std::strchr("\"\\/bfnrt", *pos) || *pos == '\0') {
+          return false;
+        }
+      }
+      ++pos;
+    }
+    return false;
+  }
 
-  // Shouldn't instantiate directly - use getInstance().
-  explicit JsonExtractor(const std::string& path) {
-    if (!tokenize(path)) {
-      VELOX_USER_FAIL("Invalid JSON path: {}", path);
+  // Consumes one value of any type and the whitespace after it.
+  bool skipValue(const char*& pos, int32_t depth = 0) const {
+    if (pos == end_) {
+      return false;
     }
+    switch (*pos) {
+      case '{':
+        if (++depth > kMaxDepth) {
+          return false;
+        }
+        ++pos;
+        skipWhitespace(pos);
+        if (pos < end_ && *pos == '}') {
+          break;
+        }
+        for (;;) {
+          bool hasEscapes;
+          if (pos == end_ || *pos != '"' || !skipString(pos, hasEscapes)) {
+            return false;
+          }
+          skipWhitespace(pos);
+          if (!consume(pos, ':') || !skipValue(pos, depth)) {
+            return false;
+          }
+          if (pos < end_ && *pos == '}') {
+            break;
+          }
+          if (!consume(pos, ',')) {
+            return false;
+          }
+        }
+        break;
+      case '[':
+        if (++depth > kMaxDepth) {
+          return false;
+        }
+        ++pos;
+        skipWhitespace(pos);
+        if (pos < end_ && *pos == ']') {
+          break;
+        }
+        for (;;) {
+          if (!skipValue(pos, depth)) {
+            return false;
+          }
+          if (pos < end_ && *pos == ']') {
+            break;
+          }
+          if (!consume(pos, ',')) {
+            return false;
+          }
+        }
+        break;
+      case '"': {
+        bool hasEscapes;
+        if (!skipString(pos, hasEscapes)) {
+          return false;
+        }
+        skipWhitespace(pos);
+        return true;
+      }
+      case 't':
+        return skipLiteral(pos, "true");
+      case 'f':
+        return skipLiteral(pos, "false");
+      case 'n':
+        return skipLiteral(pos, "null");
+      default:
+        return skipNumber(pos);
+    }
+    // Consumes the closing bracket.
+    ++pos;
+    skipWhitespace(pos);
+    return true;
   }
 
  private:
-  bool tokenize(const std::string& path) {
-    if (path.empty()) {
+  bool skipLiteral(const char*& pos, std::string_view literal) const {
+    if (std::string_view(pos, end_ - pos).substr(0, literal.size()) !=
+        literal) {
       return false;
     }
-    if (!kTokenizer.reset(path)) {
-      return false;
+    pos += literal.size();
+    skipWhitespace(pos);
+    return true;
+  }
+
+  bool skipDigits(const char*& pos) const {
+    const auto* start = pos;
+    while (pos < end_ && *pos >= '0' && *pos <= '9') {
+      ++pos;
     }
+    return pos > start;
+  }
 
-    while (kTokenizer.hasNext()) {
-      if (auto token = kTokenizer.getNext()) {
-        tokens_.push_back(token.value());
-      } else {
-        tokens_.clear();
+  bool skipNumber(const char*& pos) const {
+    if (*pos == '-') {
+      ++pos;
+    }
+    if (!skipDigits(pos)) {
+      return false;
+    }
+    if (pos < end_ && *pos == '.') {
+      ++pos;
+      if (!skipDigits(pos)) {
+        return false;
+      }
+    }
+    if (pos < end_ && (*pos == 'e' || *pos == 'E')) {
+      ++pos;
+      if (pos < end_ && (*pos == '+' || *pos == '-')) {
+        ++pos;
+      }
+      if (!skipDigits(pos)) {
         return false;
       }
     }
+    skipWhitespace(pos);
     return true;
   }
 
-  // Cache tokenize operations in JsonExtractor across invocations in the same
-  // thread for the same JsonPath.
-  thread_local static std::
-      unordered_map<std::string, std::shared_ptr<JsonExtractor>>
-          kExtractorCache;
-  thread_local static JsonPathTokenizer kTokenizer;
+  const char* const end_;
+};
 
-  // Max extractor number in extractor cache
-  static const uint32_t kMaxCacheNum{32};
+// Returns the value between 'begin' and 'end' without the whitespace after
+// it.
+folly::StringPiece trimValue(const char* begin, const char* end) {
+  while (end > begin && std::isspace(static_cast<unsigned char>(end[-1]))) {
+    --end;
+  }
+  return folly::StringPiece(begin, end);
+}
+
+// A path being matched and the number of its tokens matched by the values
+// enclosing the value being scanned.
+struct Cursor {
+  int32_t path;
+  int32_t depth;
+};
+
+// Scans the json text once for the values at several paths.
+class PathScanner {
+ public:
+  PathScanner(
+      folly::StringPiece json,
+      const std::vector<const JsonExtractor*>& extractors)
+      : json_(json),
+        scanner_(json),
+        extractors_(extractors),
+        values_(extractors.size()) {}
+
+  // Returns false if the document is not valid json.
+  bool scan() {
+    std::vector<Cursor> cursors;
+    cursors.reserve(extractors_.size());
+    for (auto i = 0; i < extractors_.size(); ++i) {
+      cursors.push_back({i, 0});
+    }
+    const auto* pos = json_.begin();
+    scanner_.skipWhitespace(pos);
+    try {
+      return scanValue(cursors, pos) && pos == json_.end();
+    } catch (const folly::json::parse_error&) {
+      // Decoding a key with escapes failed.
+      return false;
+    }
+  }
+
+  // The values matching the path of each extractor, in document order.
+  const std::vector<std::vector<folly::StringPiece>>& values() const {
+    return values_;
+  }
+
+ private:
+  const JsonExtractor::Token& tokenAt(const Cursor& cursor) const {
+    return extractors_[cursor.path]->tokens()[cursor.depth];
+  }
+
+  bool isComplete(const Cursor& cursor) const {
+    return cursor.depth == extractors_[cursor.path]->tokens().size();
+  }
+
+  // Consumes the value at 'pos' and records the values in it at the paths
+  // of 'cursors'. Returns false if the value is not valid json. A key of an
+  // object may appear more than once, in which case the last one is taken,
+  // like folly::parseJson does.
+  bool scanValue(const std::vector<Cursor>& cursors, const char*& pos) {
+    const auto* valueStart = pos;
+    const auto* end = scanner_.end();
+    std::vector<Cursor> active;
+    for (const auto& cursor : cursors) {
+      if (!isComplete(cursor)) {
+        active.push_back(cursor);
+      }
+    }
+    if (active.empty() || pos == end || (*pos != '{' && *pos != '[')) {
+      if (!scanner_.skipValue(pos)) {
+        return false;
+      }
+    } else if (!scanContainer(active, pos)) {
+      return false;
+    }
+    if (active.size() < cursors.size()) {
+      const auto value = trimValue(valueStart, pos);
+      for (const auto& cursor : cursors) {
+        if (isComplete(cursor)) {
+          values_[cursor.path].push_back(value);
+        }
+      }
+    }
+    return true;
+  }
+
+  bool scanContainer(const std::vector<Cursor>& cursors, const char*& pos) {
+    const auto* end = scanner_.end();
+    const bool isObject = *pos == '{';
+    const char close = isObject ? '}' : ']';
+    ++pos;
+    scanner_.skipWhitespace(pos);
+    if (pos < end && *pos == close) {
+      ++pos;
+      scanner_.skipWhitespace(pos);
+      return true;
+    }
+    // The number of values of the path of each cursor before the first
+    // member of this object that matches the cursor.
+    std::vector<int32_t> firstMatch;
+    if (isObject) {
+      firstMatch.resize(cursors.size(), -1);
+    }
+    std::vector<Cursor> matches;
+    for (int32_t i = 0;; ++i) {
+      matches.clear();
+      if (isObject) {
+        const auto* keyStart = pos;
+        bool hasEscapes;
+        if (pos == end || *pos != '"' ||
+            !scanner_.skipString(pos, hasEscapes)) {
+          return false;
+        }
+        const folly::StringPiece rawKey(keyStart + 1, pos - 1);
+        std::string unescaped;
+        if (hasEscapes) {
+          unescaped =
+              folly::parseJson(folly::StringPiece(keyStart, pos)).getString();
+        }
+        const folly::StringPiece key = hasEscapes ? unescaped : rawKey;
+        for (auto j = 0; j < cursors.size(); ++j) {
+          if (key == tokenAt(cursors[j]).key) {
+            auto& values = values_[cursors[j].path];
+            if (firstMatch[j] < 0) {
+              firstMatch[j] = values.size();
+            } else {
+              values.resize(firstMatch[j]);
+            }
+            matches.push_back({cursors[j].path, cursors[j].depth + 1});
+          }
+        }
+        scanner_.skipWhitespace(pos);
+        if (!scanner_.consume(pos, ':')) {
+          return false;
+        }
+      } else {
+        for (const auto& cursor : cursors) {
+          const auto& token = tokenAt(cursor);
+          if (token.wildcard || i == token.index) {
+            matches.push_back({cursor.path, cursor.depth + 1});
+          }
+        }
+      }
+      if (matches.empty() ? !scanner_.skipValue(pos)
+                          : !scanValue(matches, pos)) {
+        return false;
+      }
+      if (pos < end && *pos == close) {
+        ++pos;
+        scanner_.skipWhitespace(pos);
+        return true;
+      }
+      if (!scanner_.consume(pos, ',')) {
+        return false;
+      }
+    }
+  }
 
-  std::vector<std::string> tokens_;
+  const folly::StringPiece json_;
+  const JsonScanner scanner_;
+  const std::vector<const JsonExtractor*>& extractors_;
+  std::vector<std::vector<folly::StringPiece>> values_;
 };
 
-thread_local std::unordered_map<std::string, std::shared_ptr<JsonExtractor>>
-    JsonExtractor::kExtractorCache;
-thread_local JsonPathTokenizer JsonExtractor::kTokenizer;
+// Returns the value in 'values', an array of them if more than one, or
+// folly::none if 'values' is empty.
+folly::Optional<folly::dynamic> toDynamic(
+    const std::vector<folly::StringPiece>& values) {
+  auto len = values.size();
+  if (0 == len) {
+    return folly::none;
+  } else if (1 == len) {
+    return folly::parseJson(values.front());
+  } else {
+    folly::dynamic array = folly::dynamic::array;
+    for (const auto& value : values) {
+      array.push_back(folly::parseJson(value));
+    }
+    return array;
+  }
+}
+
+bool isScalarType(const folly::Optional<folly::dynamic>& json) {
+  return json.has_value() && !json->isObject() && !json->isArray() &&
+      !json->isNull();
+}
+
+folly::Optional<std::string> toScalar(
+    const std::vector<folly::StringPiece>& values) {
+  // More than one value is an array.
+  if (values.size() != 1) {
+    return folly::none;
+  }
+  folly::Optional<folly::dynamic> res;
+  try {
+    res = toDynamic(values);
+  } catch (const folly::json::parse_error&) {
+  } catch (const folly::ConversionError&) {
+  }
+  // Not a scalar value
+  if (isScalarType(res)) {
+    if (res->isBool()) {
+      return res->asBool() ? std::string{"true"} : std::string{"false"};
+    } else {
+      return res->asString();
+    }
+  }
+  return folly::none;
+}
 
 void extractObject(
     const folly::dynamic* jsonObj,
@@ -111,26 +474,74 @@ void extractObject(
 
 void extractArray(
     const folly::dynamic* jsonArray,
-    const std::string& key,
+    const JsonExtractor::Token& token,
     JsonVector& ret) {
   auto arrayLen = jsonArray->size();
-  if (key == "*") {
+  if (token.wildcard) {
     for (size_t i = 0; i < arrayLen; ++i) {
       ret.push_back(jsonArray->get_ptr(i));
     }
-  } else {
-    auto rv = folly::tryTo<int32_t>(key);
-    if (rv.hasValue()) {
-      auto idx = rv.value();
-      if (idx >= 0 && idx < arrayLen) {
-        ret.push_back(jsonArray->get_ptr(idx));
-      }
+  } else if (token.index >= 0 && token.index < arrayLen) {
+    ret.push_back(jsonArray->get_ptr(token.index));
+  }
+}
+
+} // namespace
+
+JsonExtractor::JsonExtractor(folly::StringPiece path) {
+  if (!tokenize(path)) {
+    VELOX_USER_FAIL("Invalid JSON path: {}", path.str());
+  }
+}
+
+// static
+std::unique_ptr<JsonExtractor> JsonExtractor::tryCreate(
+    folly::StringPiece path) {
+  std::unique_ptr<JsonExtractor> extractor(new JsonExtractor());
+  if (!extractor->tokenize(path)) {
+    return nullptr;
+  }
+  return extractor;
+}
+
+bool JsonExtractor::tokenize(folly::StringPiece path) {
+  path = folly::trimWhitespace(path);
+  if (path.empty()) {
+    return false;
+  }
+  JsonPathTokenizer tokenizer;
+  if (!tokenizer.reset(path)) {
+    return false;
+  }
+
+  while (tokenizer.hasNext()) {
+    if (auto token = tokenizer.getNext()) {
+      auto index = folly::tryTo<int32_t>(token.value());
+      const bool wildcard = token.value() == "*";
+      tokens_.push_back(
+          {std::move(token.value()),
+           wildcard,
+           index.hasValue() ? index.value() : -1});
+    } else {
+      tokens_.clear();
+      return false;
     }
   }
+  return true;
+}
+
+folly::Optional<folly::dynamic> JsonExtractor::extract(
+    folly::StringPiece json) const {
+  std::vector<const JsonExtractor*> extractors{this};
+  PathScanner scanner(json, extractors);
+  if (!scanner.scan()) {
+    return folly::none;
+  }
+  return toDynamic(scanner.values()[0]);
 }
 
 folly::Optional<folly::dynamic> JsonExtractor::extract(
-    const folly::dynamic& json) {
+    const folly::dynamic& json) const {
   JsonVector input;
   // Temporary extraction result holder, swap with input after
   // each iteration.
@@ -140,7 +551,7 @@ folly::Optional<folly::dynamic> JsonExtractor::extract(
   for (auto& token : tokens_) {
     for (auto& jsonObj : input) {
       if (jsonObj->isObject()) {
-        extractObject(jsonObj, token, result);
+        extractObject(jsonObj, token.key, result);
       } else if (jsonObj->isArray()) {
         extractArray(jsonObj, token, result);
       }
@@ -166,12 +577,31 @@ folly::Optional<folly::dynamic> JsonExtractor::extract(
   }
 }
 
-bool isScalarType(const folly::Optional<folly::dynamic>& json) {
-  return json.has_value() && !json->isObject() && !json->isArray() &&
-      !json->isNull();
+folly::Optional<std::string> JsonExtractor::extractScalar(
+    folly::StringPiece json) const {
+  std::vector<const JsonExtractor*> extractors{this};
+  PathScanner scanner(json, extractors);
+  if (!scanner.scan()) {
+    return folly::none;
+  }
+  return toScalar(scanner.values()[0]);
 }
 
-} // namespace
+// static
+void JsonExtractor::extractScalars(
+    folly::StringPiece json,
+    const std::vector<const JsonExtractor*>& extractors,
+    std::vector<folly::Optional<std::string>>& results) {
+  results.clear();
+  results.resize(extractors.size());
+  PathScanner scanner(json, extractors);
+  if (!scanner.scan()) {
+    return;
+  }
+  for (auto i = 0; i < extractors.size(); ++i) {
+    results[i] = toScalar(scanner.values()[i]);
+  }
+}
 
 folly::Optional<folly::dynamic> jsonExtract(
     folly::StringPiece json,
@@ -181,8 +611,7 @@ folly::Optional<folly::dynamic> jsonExtract(
     // and we want to let this exception bubble up to the client. We only catch
     // json parsing failures (in which cases we return folly::none instead of
     // throw).
-    auto& extractor = JsonExtractor::getInstance(path);
-    return extractor.extract(folly::parseJson(json));
+    return getInstance(path).extract(json);
   } catch (const folly::json::parse_error&) {
   } catch (const folly::ConversionError&) {
     // Folly might throw a conversion error while parsing the input json. In
@@ -201,7 +630,7 @@ folly::Optional<folly::dynamic> jsonExtract(
     const folly::dynamic& json,
     folly::StringPiece path) {
   try {
-    return JsonExtractor::getInstance(path).extract(json);
+    return getInstance(path).extract(json);
   } catch (const folly::json::parse_error&) {
   }
   return folly::none;
@@ -210,16 +639,7 @@ folly::Optional<folly::dynamic> jsonExtract(
 folly::Optional<std::string> jsonExtractScalar(
     folly::StringPiece json,
     folly::StringPiece path) {
-  auto res = jsonExtract(json, path);
-  // Not a scalar value
-  if (isScalarType(res)) {
-    if (res->isBool()) {
-      return res->asBool() ? std::string{"true"} : std::string{"false"};
-    } else {
-      return res->asString();
-    }
-  }
-  return folly::none;
+  return getInstance(path).extractScalar(json);
 }
 
 folly::Optional<std::string> jsonExtractScalar(
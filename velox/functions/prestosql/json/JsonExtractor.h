@@ -16,13 +16,66 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "folly/Range.h"
 #include "folly/dynamic.h"
 
 namespace facebook::velox::functions {
 
+/// Extracts the values at a json path from json documents. The path is
+/// tokenized once. Extracting from a json string scans the document without
+/// building a folly::dynamic for it. Only the values at the path are parsed.
+class JsonExtractor {
+ public:
+  /// Throws VeloxUserError if 'path' is not a valid json path.
+  explicit JsonExtractor(folly::StringPiece path);
+
+  /// Returns an extractor for 'path' or nullptr if 'path' is not a valid json
+  /// path.
+  static std::unique_ptr<JsonExtractor> tryCreate(folly::StringPiece path);
+
+  /// Returns the value at the path in 'json', or an array of the values if the
+  /// path has a wildcard and matches more than one. Returns folly::none if
+  /// nothing matches or if 'json' is not valid json.
+  folly::Optional<folly::dynamic> extract(folly::StringPiece json) const;
+
+  folly::Optional<folly::dynamic> extract(const folly::dynamic& json) const;
+
+  /// Like extract() but returns the value as a string. Returns folly::none if
+  /// the value is not a boolean, number or string.
+  folly::Optional<std::string> extractScalar(folly::StringPiece json) const;
+
+  /// Extracts the scalar at the path of each of 'extractors' from 'json' in
+  /// one scan of it. Sets 'results' to one element per extractor, the value
+  /// extractScalar() would return.
+  static void extractScalars(
+      folly::StringPiece json,
+      const std::vector<const JsonExtractor*>& extractors,
+      std::vector<folly::Optional<std::string>>& results);
+
+  struct Token {
+    std::string key;
+    // True if 'key' is "*".
+    bool wildcard;
+    // 'key' as an array subscript, -1 if not a non-negative integer.
+    int32_t index;
+  };
+
+  const std::vector<Token>& tokens() const {
+    return tokens_;
+  }
+
+ private:
+  JsonExtractor() = default;
+
+  bool tokenize(folly::StringPiece path);
+
+  std::vector<Token> tokens_;
+};
+
 /**
  * Extract a json object from path
  * @param json: A json object
@@ -21,6 +21,7 @@
 #include "velox/common/base/VeloxException.h"
 
 using facebook::velox::VeloxUserError;
+using facebook::velox::functions::JsonExtractor;
 using facebook::velox::functions::jsonExtract;
 using facebook::velox::functions::jsonExtractScalar;
 using folly::json::parse_error;
@@ -501,3 +502,46 @@ TEST(JsonExtractorTest, jsonMultipleExtractsTest) {
   ASSERT_TRUE(extract2.hasValue());
   EXPECT_EQ(jsonExtract(json, "$.store.fruit").value(), extract2.value());
 }
+
+TEST(JsonExtractorTest, invalidJsonTest) {
+  // The scan of the document finds errors also outside of the path.
+  EXPECT_JSON_VALUE_NULL(""s, "$.a"s);
+  EXPECT_JSON_VALUE_NULL("{\"a\": 1"s, "$.a"s);
+  EXPECT_JSON_VALUE_NULL("{\"a\": 1, \"b\": [1, 2}"s, "$.a"s);
+  EXPECT_JSON_VALUE_NULL("{\"a\": 1, \"b\": tru}"s, "$.a"s);
+  EXPECT_JSON_VALUE_NULL("{\"a\": 1, \"b\": \"x\\q\"}"s, "$.a"s);
+  EXPECT_JSON_VALUE_NULL("{\"a\": 1, \"b\": 1.}"s, "$.a"s);
+  EXPECT_JSON_VALUE_NULL("{\"a\": 1,}"s, "$.a"s);
+  EXPECT_JSON_VALUE_NULL("{\"a\": 1} x"s, "$.a"s);
+  EXPECT_JSON_VALUE_NULL("[1 2]"s, "$[0]"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1, \"b\": -}"s, "$.a"s);
+  EXPECT_JSON_VALUE_NULL(
+      std::string(200, '[') + std::string(200, ']'), "$[0]"s);
+
+  EXPECT_JSON_VALUE_EQ(
+      " {\"a\" : 1e-2 ,\"b\":[true,false,null]} "s, "$.a"s, "0.01"s);
+  EXPECT_JSON_VALUE_EQ(
+      "{\"a\": {\"b\\u0041\": [1, {}]}}"s, "$.a.bA[1]"s, "{}"s);
+}
+
+TEST(JsonExtractorTest, duplicateKeyTest) {
+  // The last value of a key is taken, like folly::parseJson does.
+  EXPECT_JSON_VALUE_EQ("{\"a\": 1, \"b\": 2, \"a\": 3}"s, "$.a"s, "3"s);
+  EXPECT_JSON_VALUE_EQ(
+      "[{\"a\": 1, \"a\": 2}, {\"a\": 3}]"s, "$[*].a"s, "[2,3]"s);
+}
+
+TEST(JsonExtractorTest, constantPath) {
+  auto extractor = JsonExtractor::tryCreate(" $.a[1] "s);
+  ASSERT_NE(extractor, nullptr);
+  EXPECT_EQ("2", extractor->extractScalar("{\"a\": [1, 2]}"s).value());
+  EXPECT_EQ("x", extractor->extractScalar("{\"a\": [1, \"x\"]}"s).value());
+  EXPECT_FALSE(extractor->extractScalar("{\"a\": [1, {}]}"s).hasValue());
+  EXPECT_FALSE(extractor->extractScalar("{\"a\": [1, 2]"s).hasValue());
+  EXPECT_EQ(
+      folly::parseJson("[3, 4]"),
+      extractor->extract(folly::parseJson("{\"a\": [1, [3, 4]]}")).value());
+
+  EXPECT_EQ(JsonExtractor::tryCreate("$.a..b"s), nullptr);
+  EXPECT_THROW(JsonExtractor("$.a..b"s), VeloxUserError);
+}
@@ -32,6 +32,8 @@ void registerJsonFunctions() {
       {"json_array_contains"});
   registerFunction<JsonArrayContainsFunction, bool, Varchar, Varchar>(
       {"json_array_contains"});
+  VELOX_REGISTER_VECTOR_FUNCTION(
+      udf_json_extract_scalars, "$internal$json_extract_scalars");
 }
 
 } // namespace facebook::velox::functions
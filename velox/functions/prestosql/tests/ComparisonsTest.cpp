@@ -551,6 +551,40 @@ class SimdComparisonsTest : public functions::test::FunctionBaseTest {
     }
   }
 
+  // Evaluates over a selection that is not all rows and does not start on a
+  // word boundary. The rows that are not selected must keep their values.
+  void testPartialSelection(bool constantRhs) {
+    constexpr vector_size_t kSize = 1'000;
+    auto lhs = makeFlatVector<T>(kSize, [](auto row) { return row % 7; });
+    auto rhs = constantRhs
+        ? makeConstant<T>(3, kSize)
+        : makeFlatVector<T>(kSize, [](auto row) { return row % 5; });
+    auto rowVector = makeRowVector({lhs, rhs});
+
+    SelectivityVector rows(kSize, false);
+    for (auto row = 5; row < kSize - 3; ++row) {
+      if (row % 4 != 1) {
+        rows.setValid(row, true);
+      }
+    }
+    rows.updateBounds();
+
+    auto initial = [](auto row) { return row % 3 == 0; };
+    VectorPtr result = makeFlatVector<bool>(kSize, initial);
+    evaluate<SimpleVector<bool>>(
+        fmt::format("{}(c0, c1)", sqlFn), rowVector, rows, result);
+
+    auto simpleRhs = rhs->template as<SimpleVector<T>>();
+    auto simpleResult = result->template as<SimpleVector<bool>>();
+    for (auto row = 0; row < kSize; ++row) {
+      const bool expected = rows.isValid(row)
+          ? ComparisonOp()(lhs->valueAt(row), simpleRhs->valueAt(row))
+          : initial(row);
+      ASSERT_FALSE(simpleResult->isNullAt(row)) << "at " << row;
+      ASSERT_EQ(expected, simpleResult->valueAt(row)) << "at " << row;
+    }
+  }
+
   void testDictionary() {
     // Identity mapping, however this will result in non-simd path.
     auto makeDictionary = [&](const std::vector<T>& data) {
@@ -592,6 +626,11 @@ TYPED_TEST(SimdComparisonsTest, flat) {
   this->testFlat();
 }
 
+TYPED_TEST(SimdComparisonsTest, partialSelection) {
+  this->testPartialSelection(false);
+  this->testPartialSelection(true);
+}
+
 TYPED_TEST(SimdComparisonsTest, dictionary) {
   this->testDictionary();
 }
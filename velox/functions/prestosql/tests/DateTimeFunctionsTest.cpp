@@ -558,6 +558,25 @@ TEST_F(DateTimeFunctionsTest, hour) {
   EXPECT_EQ(8, hour(Timestamp(998423705, 321000000)));
 }
 
+TEST_F(DateTimeFunctionsTest, hourAcrossDaylightSavingTime) {
+  setQueryTimeZone("America/Los_Angeles");
+  // Half hours from 2021-03-14 00:00 PST, crossing the switch to PDT at 02:00,
+  // and from 2021-11-07 00:00 PDT, crossing the switch back at 02:00. The
+  // rows of a batch reuse the offset of the previous row until a switch.
+  std::vector<Timestamp> timestamps;
+  for (int64_t start : {1615708800, 1636268400}) {
+    for (auto i = 0; i < 12; ++i) {
+      timestamps.emplace_back(start + i * 1800, 0);
+    }
+  }
+  auto result = evaluate<SimpleVector<int64_t>>(
+      "hour(c0)", makeRowVector({makeFlatVector(timestamps)}));
+  assertEqualVectors(
+      makeFlatVector<int64_t>({0, 0, 1, 1, 3, 3, 4, 4, 5, 5, 6, 6,
+                               0, 0, 1, 1, 1, 1, 2, 2, 3, 3, 4, 4}),
+      result);
+}
+
 TEST_F(DateTimeFunctionsTest, hourTimestampWithTimezone) {
   EXPECT_EQ(
       20,
@@ -16,6 +16,7 @@
 
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
+#include "velox/type/DecimalUtil.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::test;
@@ -350,3 +351,36 @@ TEST_F(DecimalArithmeticTest, decimalDivTest) {
               {UnscaledLongDecimal::max().unscaledValue()}, DECIMAL(38, 0))}),
       "Decimal overflow: 99999999999999999999999999999999999999 * 100");
 }
+
+TEST_F(DecimalArithmeticTest, noOverflowPrecisions) {
+  // The precisions of these arguments guarantee that the results fit, so the
+  // overflow checks are skipped. Uses the largest values of the precisions.
+  const auto max37 = DecimalUtil::kPowersOfTen[37] - 1;
+  const auto max19 = DecimalUtil::kPowersOfTen[19] - 1;
+  auto long37 = makeLongDecimalFlatVector({max37, -max37}, DECIMAL(37, 0));
+  testDecimalExpr<TypeKind::LONG_DECIMAL>(
+      makeLongDecimalFlatVector({2 * max37, -2 * max37}, DECIMAL(38, 0)),
+      "c0 + c1",
+      {long37, long37});
+  testDecimalExpr<TypeKind::LONG_DECIMAL>(
+      makeLongDecimalFlatVector({2 * max37, -2 * max37}, DECIMAL(38, 0)),
+      "c0 - c1",
+      {long37,
+       makeLongDecimalFlatVector({-max37, max37}, DECIMAL(37, 0))});
+
+  auto long19 = makeLongDecimalFlatVector({max19, -max19}, DECIMAL(19, 0));
+  testDecimalExpr<TypeKind::LONG_DECIMAL>(
+      makeLongDecimalFlatVector({max19 * max19, max19 * max19}, DECIMAL(38, 0)),
+      "c0 * c1",
+      {long19, makeLongDecimalFlatVector({max19, -max19}, DECIMAL(19, 0))});
+
+  // Dividing DECIMAL(10, 0) by DECIMAL(10, 5) rescales the dividend by 10
+  // digits.
+  const int64_t max10 = 9'999'999'999;
+  testDecimalExpr<TypeKind::LONG_DECIMAL>(
+      makeLongDecimalFlatVector(
+          {max10 * 100'000, -max10 * 100'000}, DECIMAL(20, 5)),
+      "c0 / c1",
+      {makeShortDecimalFlatVector({max10, max10}, DECIMAL(10, 0)),
+       makeShortDecimalFlatVector({100'000, -100'000}, DECIMAL(10, 5))});
+}
@@ -271,6 +271,65 @@ TEST_F(InPredicateTest, varchar) {
   assertEqualVectors(expected, result);
 }
 
+TEST_F(InPredicateTest, bigintListSizes) {
+  const vector_size_t size = 1'000;
+  auto rowVector = makeRowVector({makeFlatVector<int64_t>(
+      size, [](auto row) { return (row % 50) * 1'000; }, nullEvery(7))});
+
+  // Sparse values are looked up in a hash table unless there are few.
+  for (auto numValues : {3, 16, 17, 40}) {
+    std::ostringstream inList;
+    inList << "-1";
+    for (auto i = 1; i < numValues; ++i) {
+      inList << ", " << i * 2'000;
+    }
+    auto result = evaluate<SimpleVector<bool>>(
+        fmt::format("c0 IN ({})", inList.str()), rowVector);
+    auto expected = makeFlatVector<bool>(
+        size,
+        [&](auto row) {
+          const auto n = row % 50;
+          return n % 2 == 0 && n > 0 && n / 2 < numValues;
+        },
+        nullEvery(7));
+    assertEqualVectors(expected, result);
+  }
+}
+
+TEST_F(InPredicateTest, varcharListSizes) {
+  const vector_size_t size = 1'000;
+  // Values with the same prefixes and sizes, some inlined in StringView.
+  auto makeString = [](int32_t i) {
+    return i % 3 == 0 ? fmt::format("{}", i)
+                      : fmt::format("abcd-long-string-{:04}", i);
+  };
+  std::vector<std::string> strings;
+  for (auto row = 0; row < size; ++row) {
+    strings.push_back(makeString(row % 100));
+  }
+  auto rowVector = makeRowVector({makeFlatVector<StringView>(
+      size,
+      [&](auto row) { return StringView(strings[row]); },
+      nullEvery(7))});
+
+  for (auto numValues : {2, 16, 17, 60}) {
+    std::ostringstream inList;
+    for (auto i = 0; i < numValues; ++i) {
+      inList << (i > 0 ? ", '" : "'") << makeString(i * 2) << "'";
+    }
+    auto result = evaluate<SimpleVector<bool>>(
+        fmt::format("c0 IN ({})", inList.str()), rowVector);
+    auto expected = makeFlatVector<bool>(
+        size,
+        [&](auto row) {
+          const auto n = row % 100;
+          return n % 2 == 0 && n / 2 < numValues;
+        },
+        nullEvery(7));
+    assertEqualVectors(expected, result);
+  }
+}
+
 TEST_F(InPredicateTest, varcharConstant) {
   const vector_size_t size = 1'000;
   auto rowVector = makeRowVector(
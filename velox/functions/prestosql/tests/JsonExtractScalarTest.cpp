@@ -184,6 +184,50 @@ TEST_F(JsonExtractScalarTest, wildcardSelect) {
       std::nullopt);
 }
 
+TEST_F(JsonExtractScalarTest, fusedPaths) {
+  auto data = makeRowVector({makeNullableFlatVector<StringView>(
+      {R"({"a": 1, "b": {"c": "x"}, "d": [1, 2]})",
+       R"({"a": "y", "b": {"c": [1]}})",
+       std::nullopt,
+       R"({"a": 2, "b": )",
+       R"({"a": true, "b": {"c": null}, "d": [3]})"})});
+
+  // Calls on the same json with different paths are computed together and
+  // give the same results as separate calls.
+  std::vector<std::string> expressions = {
+      "json_extract_scalar(c0, '$.a')",
+      "json_extract_scalar(c0, '$.b.c')",
+      "concat(json_extract_scalar(c0, '$.a'), '-')",
+      "if(c0 like '%true%', json_extract_scalar(c0, '$.d[0]'), 'none')"};
+  auto exprSet = compileExpressions(expressions, asRowType(data->type()));
+  ASSERT_NE(
+      exprSet->toString().find("$internal$json_extract_scalars"),
+      std::string::npos);
+
+  exec::EvalCtx context(&execCtx_, exprSet.get(), data.get());
+  SelectivityVector rows(data->size());
+  std::vector<VectorPtr> results(expressions.size());
+  exprSet->eval(rows, context, results);
+
+  for (auto i = 0; i < expressions.size(); ++i) {
+    SCOPED_TRACE(expressions[i]);
+    ::facebook::velox::test::assertEqualVectors(
+        evaluate<SimpleVector<StringView>>(expressions[i], data), results[i]);
+  }
+  ::facebook::velox::test::assertEqualVectors(
+      makeNullableFlatVector<StringView>(
+          {"1", "y", std::nullopt, std::nullopt, "true"}),
+      results[0]);
+  ::facebook::velox::test::assertEqualVectors(
+      makeNullableFlatVector<StringView>(
+          {"x", std::nullopt, std::nullopt, std::nullopt, std::nullopt}),
+      results[1]);
+  ::facebook::velox::test::assertEqualVectors(
+      makeNullableFlatVector<StringView>(
+          {"none", "none", "none", "none", "3"}),
+      results[3]);
+}
+
 } // namespace
 
 } // namespace facebook::velox::functions::prestosql
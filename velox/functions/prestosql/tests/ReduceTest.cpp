@@ -152,3 +152,28 @@ TEST_F(ReduceTest, elementIndicesOverwrite) {
       evaluate("reduce(array[c0, c1], 100, (s, x) -> s + x, s -> s)", data);
   assertEqualVectors(makeFlatVector<int64_t>({104, 106}), result);
 }
+
+TEST_F(ReduceTest, differentSizesWithCapture) {
+  vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeArrayVector<int64_t>(size, modN(13), modN(7), nullEvery(11)),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 3; }),
+  });
+
+  // Each step only processes the arrays that still have elements.
+  auto result = evaluate<SimpleVector<int64_t>>(
+      "reduce(c0, 0, (s, x) -> s + x * c1, s -> s)", data);
+  auto* arrays = data->childAt(0)->as<ArrayVector>();
+  auto* elements = arrays->elements()->as<SimpleVector<int64_t>>();
+  auto expectedResult = makeFlatVector<int64_t>(
+      size,
+      [&](auto row) {
+        int64_t sum = 0;
+        for (auto i = 0; i < arrays->sizeAt(row); ++i) {
+          sum += elements->valueAt(arrays->offsetAt(row) + i) * (row % 3);
+        }
+        return sum;
+      },
+      nullEvery(11));
+  assertEqualVectors(expectedResult, result);
+}
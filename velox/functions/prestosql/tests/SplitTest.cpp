@@ -302,3 +302,17 @@ TEST_F(SplitTest, splitError) {
   // Limit should be positive.
   EXPECT_THROW(RUN("split(C0, C1, C2)", 0), std::invalid_argument);
 }
+
+/// The elements of the result are slices of the input strings, not copies.
+TEST_F(SplitTest, elementsReferenceInput) {
+  auto input = makeFlatVector<std::string>(
+      {"a long first element,and a long second element",
+       "a long string without delimiters"});
+  auto result =
+      evaluate<ArrayVector>("split(c0, ',')", makeRowVector({input}));
+  auto elements = result->elements()->asFlatVector<StringView>();
+  ASSERT_EQ(3, elements->size());
+  EXPECT_EQ(input->stringBuffers(), elements->stringBuffers());
+  EXPECT_EQ(input->valueAt(0).data(), elements->valueAt(0).data());
+  EXPECT_EQ(input->valueAt(1).data(), elements->valueAt(2).data());
+}
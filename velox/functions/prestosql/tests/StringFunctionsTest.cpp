@@ -713,6 +713,40 @@ TEST_F(StringFunctionsTest, upper) {
 }
 
 // Test lower vector function
+// The input is referenced by the test, so upper and lower can't convert it
+// in place and convert its string buffers as a whole instead.
+TEST_F(StringFunctionsTest, upperLowerAsciiBuffers) {
+  auto input = makeNullableFlatVector<std::string>(
+      {"a Long Mixed Case String 1",
+       "short",
+       std::nullopt,
+       "another Long Mixed Case String 2"});
+  auto expectedUpper = makeNullableFlatVector<std::string>(
+      {"A LONG MIXED CASE STRING 1",
+       "SHORT",
+       std::nullopt,
+       "ANOTHER LONG MIXED CASE STRING 2"});
+  auto expectedLower = makeNullableFlatVector<std::string>(
+      {"a long mixed case string 1",
+       "short",
+       std::nullopt,
+       "another long mixed case string 2"});
+  auto inputCopy = makeNullableFlatVector<std::string>(
+      {"a Long Mixed Case String 1",
+       "short",
+       std::nullopt,
+       "another Long Mixed Case String 2"});
+
+  auto upper =
+      evaluate<FlatVector<StringView>>("upper(c0)", makeRowVector({input}));
+  assertEqualVectors(expectedUpper, upper);
+  EXPECT_EQ(input->stringBuffers().size(), upper->stringBuffers().size());
+  auto lower =
+      evaluate<FlatVector<StringView>>("lower(c0)", makeRowVector({input}));
+  assertEqualVectors(expectedLower, lower);
+  assertEqualVectors(inputCopy, input);
+}
+
 TEST_F(StringFunctionsTest, lower) {
   auto lowerStd = [](const std::string& input) {
     std::string output;
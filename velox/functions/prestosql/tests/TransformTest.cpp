@@ -135,3 +135,34 @@ TEST_F(TransformTest, dictionaryWithDuplicates) {
 
   assertEqualVectors(expectedResult, result);
 }
+
+TEST_F(TransformTest, constantCapture) {
+  vector_size_t size = 1'000;
+  auto input = makeRowVector({
+      makeArrayVector<int64_t>(
+          size,
+          modN(5),
+          [](vector_size_t /*row*/, vector_size_t idx) { return idx; },
+          nullEvery(11)),
+      makeConstant<int64_t>(10, size),
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+  });
+
+  // Constant captures are passed to the lambda without wrapping them.
+  auto result = evaluate<ArrayVector>("transform(c0, x -> x + c1)", input);
+  auto expectedResult = makeArrayVector<int64_t>(
+      size,
+      modN(5),
+      [](vector_size_t /*row*/, vector_size_t idx) { return idx + 10; },
+      nullEvery(11));
+  assertEqualVectors(expectedResult, result);
+
+  // Constant and non-constant captures together.
+  result = evaluate<ArrayVector>("transform(c0, x -> x + c1 + c2)", input);
+  expectedResult = makeArrayVector<int64_t>(
+      size,
+      modN(5),
+      [](vector_size_t row, vector_size_t idx) { return idx + 10 + row; },
+      nullEvery(11));
+  assertEqualVectors(expectedResult, result);
+}
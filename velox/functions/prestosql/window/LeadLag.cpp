@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/exec/WindowFunction.h"
+#include "velox/expression/FunctionSignature.h"
+#include "velox/functions/prestosql/window/NullSkipIndex.h"
+#include "velox/vector/ConstantVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::window {
+
+namespace {
+
+// lag(x, offset, default) returns the value of 'x' 'offset' rows before the
+// current row of the partition and lead() the value 'offset' rows after
+// it. 'offset' is 1 by default. If there is no such row, the result is
+// 'default' or null. The values are read straight from the rows of the
+// partition.
+template <bool isLag>
+class LeadLagFunction : public exec::WindowFunction {
+ public:
+  LeadLagFunction(
+      const std::vector<exec::WindowFunctionArg>& args,
+      const TypePtr& resultType,
+      bool ignoreNulls,
+      velox::memory::MemoryPool* pool)
+      : WindowFunction(resultType, pool), ignoreNulls_(ignoreNulls) {
+    VELOX_USER_CHECK(
+        args[0].index.has_value(),
+        "The value of {} must be a column",
+        functionName());
+    valueIndex_ = args[0].index.value();
+
+    if (args.size() > 1) {
+      if (args[1].constantValue) {
+        if (args[1].constantValue->isNullAt(0)) {
+          isNullOffset_ = true;
+        } else {
+          constantOffset_ = checkOffset(
+              args[1].constantValue->as<ConstantVector<int64_t>>()->valueAt(
+                  0));
+        }
+      } else {
+        offsetIndex_ = args[1].index;
+      }
+    }
+
+    if (args.size() > 2) {
+      defaultValue_ = args[2].constantValue;
+      defaultIndex_ = args[2].index;
+    }
+  }
+
+  void resetPartition(const exec::WindowPartition* partition) override {
+    partition_ = partition;
+    partitionOffset_ = 0;
+    if (ignoreNulls_) {
+      nullSkipIndex_.reset(*partition, valueIndex_);
+    }
+  }
+
+  void apply(
+      const BufferPtr& peerGroupStarts,
+      const BufferPtr& /*peerGroupEnds*/,
+      const BufferPtr& /*frameStarts*/,
+      const BufferPtr& /*frameEnds*/,
+      vector_size_t resultOffset,
+      const VectorPtr& result) override {
+    const vector_size_t numRows =
+        peerGroupStarts->size() / sizeof(vector_size_t);
+    rowNumbers_.resize(numRows);
+    defaultRows_.clear();
+
+    if (isNullOffset_) {
+      std::fill(rowNumbers_.begin(), rowNumbers_.end(), kNullRow);
+    } else if (offsetIndex_.has_value()) {
+      auto offsets = BaseVector::create(BIGINT(), numRows, pool_);
+      partition_->extractColumn(
+          offsetIndex_.value(), partitionOffset_, numRows, 0, offsets);
+      SelectivityVector rows(numRows);
+      DecodedVector decodedOffsets(*offsets, rows);
+      for (auto i = 0; i < numRows; ++i) {
+        if (decodedOffsets.isNullAt(i)) {
+          rowNumbers_[i] = kNullRow;
+        } else {
+          setRowNumber(i, checkOffset(decodedOffsets.valueAt<int64_t>(i)));
+        }
+      }
+    } else {
+      for (auto i = 0; i < numRows; ++i) {
+        setRowNumber(i, constantOffset_);
+      }
+    }
+
+    partition_->extractColumn(valueIndex_, rowNumbers_, resultOffset, result);
+    setDefaults(numRows, resultOffset, result);
+    partitionOffset_ += numRows;
+  }
+
+ private:
+  static constexpr vector_size_t kNullRow = -1;
+
+  static const char* functionName() {
+    return isLag ? "lag" : "lead";
+  }
+
+  static int64_t checkOffset(int64_t offset) {
+    VELOX_USER_CHECK_GE(offset, 0, "Offset must be at least 0");
+    return offset;
+  }
+
+  // Sets the row number of the value for the i'th row of the batch for
+  // 'offset'. Records the row if it needs the default value.
+  void setRowNumber(vector_size_t i, int64_t offset) {
+    const auto row = partitionOffset_ + i;
+    const auto numRows = partition_->numRows();
+    vector_size_t valueRow;
+    if (offset == 0) {
+      valueRow = row;
+    } else if (ignoreNulls_) {
+      valueRow = isLag
+          ? nullSkipIndex_.nthNonNullRow(
+                nullSkipIndex_.numNonNullsBefore(row) - offset)
+          : nullSkipIndex_.nthNonNullRow(
+                nullSkipIndex_.numNonNullsBefore(row + 1) + offset - 1);
+    } else if (isLag) {
+      valueRow = row - offset >= 0 ? row - offset : kNullRow;
+    } else {
+      valueRow = offset < numRows - row ? row + offset : kNullRow;
+    }
+    rowNumbers_[i] = valueRow;
+    if (valueRow == kNullRow) {
+      defaultRows_.push_back(i);
+    }
+  }
+
+  // Copies the default value into the rows of 'result' for the rows of the
+  // batch in 'defaultRows_'.
+  void setDefaults(
+      vector_size_t numRows,
+      vector_size_t resultOffset,
+      const VectorPtr& result) {
+    if (defaultRows_.empty()) {
+      return;
+    }
+    if (defaultValue_) {
+      if (defaultValue_->isNullAt(0)) {
+        return;
+      }
+      for (auto i : defaultRows_) {
+        result->copy(defaultValue_.get(), resultOffset + i, 0, 1);
+      }
+    } else if (defaultIndex_.has_value()) {
+      auto defaults = BaseVector::create(resultType_, numRows, pool_);
+      partition_->extractColumn(
+          defaultIndex_.value(), partitionOffset_, numRows, 0, defaults);
+      for (auto i : defaultRows_) {
+        result->copy(defaults.get(), resultOffset + i, i, 1);
+      }
+    }
+  }
+
+  const bool ignoreNulls_;
+  column_index_t valueIndex_;
+
+  // The offset is null, constant or read from the column at 'offsetIndex_'.
+  bool isNullOffset_{false};
+  int64_t constantOffset_{1};
+  std::optional<column_index_t> offsetIndex_;
+
+  // The default value is constant or read from the column at
+  // 'defaultIndex_'. Null if neither is set.
+  VectorPtr defaultValue_;
+  std::optional<column_index_t> defaultIndex_;
+
+  const exec::WindowPartition* partition_{nullptr};
+  // Position in the partition of the first row of the next apply().
+  vector_size_t partitionOffset_{0};
+  NullSkipIndex nullSkipIndex_;
+
+  // The rows of the partition to read the values of a batch from.
+  std::vector<vector_size_t> rowNumbers_;
+  // The rows of a batch that have no value row and take the default.
+  std::vector<vector_size_t> defaultRows_;
+};
+
+template <bool isLag>
+void registerLeadLagInternal(const std::string& name) {
+  // T -> T, (T, bigint) -> T and (T, bigint, T) -> T.
+  std::vector<exec::FunctionSignaturePtr> signatures{
+      exec::FunctionSignatureBuilder()
+          .typeVariable("T")
+          .returnType("T")
+          .argumentType("T")
+          .build(),
+      exec::FunctionSignatureBuilder()
+          .typeVariable("T")
+          .returnType("T")
+          .argumentType("T")
+          .argumentType("bigint")
+          .build(),
+      exec::FunctionSignatureBuilder()
+          .typeVariable("T")
+          .returnType("T")
+          .argumentType("T")
+          .argumentType("bigint")
+          .argumentType("T")
+          .build(),
+  };
+
+  exec::registerWindowFunction(
+      name,
+      std::move(signatures),
+      [name](
+          const std::vector<exec::WindowFunctionArg>& args,
+          const TypePtr& resultType,
+          bool ignoreNulls,
+          velox::memory::MemoryPool* pool)
+          -> std::unique_ptr<exec::WindowFunction> {
+        return std::make_unique<LeadLagFunction<isLag>>(
+            args, resultType, ignoreNulls, pool);
+      });
+}
+
+} // namespace
+
+void registerLag(const std::string& name) {
+  registerLeadLagInternal<true>(name);
+}
+
+void registerLead(const std::string& name) {
+  registerLeadLagInternal<false>(name);
+}
+
+} // namespace facebook::velox::window
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/exec/WindowFunction.h"
+#include "velox/expression/FunctionSignature.h"
+#include "velox/functions/prestosql/window/NullSkipIndex.h"
+#include "velox/vector/ConstantVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::window {
+
+namespace {
+
+enum class ValueType { kFirst, kLast, kNth };
+
+// first_value(x), last_value(x) and nth_value(x, offset) return the value of
+// 'x' at the first, last or 'offset'th row of the frame of the current row,
+// or null if the frame has no such row. The values are read straight from
+// the rows of the partition.
+template <ValueType TValue>
+class NthValueFunction : public exec::WindowFunction {
+ public:
+  NthValueFunction(
+      const std::vector<exec::WindowFunctionArg>& args,
+      const TypePtr& resultType,
+      bool ignoreNulls,
+      velox::memory::MemoryPool* pool)
+      : WindowFunction(resultType, pool), ignoreNulls_(ignoreNulls) {
+    VELOX_USER_CHECK(
+        args[0].index.has_value(), "Window function value must be a column");
+    valueIndex_ = args[0].index.value();
+
+    if constexpr (TValue == ValueType::kNth) {
+      if (args[1].constantValue) {
+        if (args[1].constantValue->isNullAt(0)) {
+          isNullOffset_ = true;
+        } else {
+          constantOffset_ = checkOffset(
+              args[1].constantValue->as<ConstantVector<int64_t>>()->valueAt(
+                  0));
+        }
+      } else {
+        offsetIndex_ = args[1].index;
+      }
+    }
+  }
+
+  void resetPartition(const exec::WindowPartition* partition) override {
+    partition_ = partition;
+    partitionOffset_ = 0;
+    if (ignoreNulls_) {
+      nullSkipIndex_.reset(*partition, valueIndex_);
+    }
+  }
+
+  void apply(
+      const BufferPtr& /*peerGroupStarts*/,
+      const BufferPtr& /*peerGroupEnds*/,
+      const BufferPtr& frameStarts,
+      const BufferPtr& frameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) override {
+    const vector_size_t numRows = frameStarts->size() / sizeof(vector_size_t);
+    const auto* rawFrameStarts = frameStarts->as<vector_size_t>();
+    const auto* rawFrameEnds = frameEnds->as<vector_size_t>();
+    rowNumbers_.resize(numRows);
+
+    if (isNullOffset_) {
+      std::fill(rowNumbers_.begin(), rowNumbers_.end(), kNullRow);
+    } else if (offsetIndex_.has_value()) {
+      auto offsets = BaseVector::create(BIGINT(), numRows, pool_);
+      partition_->extractColumn(
+          offsetIndex_.value(), partitionOffset_, numRows, 0, offsets);
+      SelectivityVector rows(numRows);
+      DecodedVector decodedOffsets(*offsets, rows);
+      for (auto i = 0; i < numRows; ++i) {
+        rowNumbers_[i] = decodedOffsets.isNullAt(i)
+            ? kNullRow
+            : valueRow(
+                  rawFrameStarts[i],
+                  rawFrameEnds[i],
+                  checkOffset(decodedOffsets.valueAt<int64_t>(i)));
+      }
+    } else {
+      for (auto i = 0; i < numRows; ++i) {
+        rowNumbers_[i] =
+            valueRow(rawFrameStarts[i], rawFrameEnds[i], constantOffset_);
+      }
+    }
+
+    partition_->extractColumn(valueIndex_, rowNumbers_, resultOffset, result);
+    partitionOffset_ += numRows;
+  }
+
+ private:
+  static constexpr vector_size_t kNullRow = -1;
+
+  static int64_t checkOffset(int64_t offset) {
+    VELOX_USER_CHECK_GE(offset, 1, "Offset must be at least 1");
+    return offset;
+  }
+
+  // Returns the row of the value for the frame from 'frameStart' to
+  // 'frameEnd' or kNullRow if there is none. 'offset' is 1 based and only
+  // applies to nth_value.
+  vector_size_t
+  valueRow(vector_size_t frameStart, vector_size_t frameEnd, int64_t offset)
+      const {
+    if (frameStart > frameEnd) {
+      return kNullRow;
+    }
+    if (ignoreNulls_) {
+      if constexpr (TValue == ValueType::kLast) {
+        const auto row = nullSkipIndex_.nthNonNullRow(
+            nullSkipIndex_.numNonNullsBefore(frameEnd + 1) - 1);
+        return row >= frameStart ? row : kNullRow;
+      }
+      const auto row = nullSkipIndex_.nthNonNullRow(
+          nullSkipIndex_.numNonNullsBefore(frameStart) + offset - 1);
+      return row <= frameEnd ? row : kNullRow;
+    }
+    if constexpr (TValue == ValueType::kLast) {
+      return frameEnd;
+    }
+    return offset - 1 <= frameEnd - frameStart ? frameStart + offset - 1
+                                               : kNullRow;
+  }
+
+  const bool ignoreNulls_;
+  column_index_t valueIndex_;
+
+  // The offset of nth_value is null, constant or read from the column at
+  // 'offsetIndex_'. first_value is nth_value with offset 1.
+  bool isNullOffset_{false};
+  int64_t constantOffset_{1};
+  std::optional<column_index_t> offsetIndex_;
+
+  const exec::WindowPartition* partition_{nullptr};
+  // Position in the partition of the first row of the next apply().
+  vector_size_t partitionOffset_{0};
+  NullSkipIndex nullSkipIndex_;
+
+  // The rows of the partition to read the values of a batch from.
+  std::vector<vector_size_t> rowNumbers_;
+};
+
+template <ValueType TValue>
+void registerNthValueInternal(const std::string& name) {
+  auto builder = exec::FunctionSignatureBuilder()
+                     .typeVariable("T")
+                     .returnType("T")
+                     .argumentType("T");
+  if (TValue == ValueType::kNth) {
+    builder.argumentType("bigint");
+  }
+  std::vector<exec::FunctionSignaturePtr> signatures{builder.build()};
+
+  exec::registerWindowFunction(
+      name,
+      std::move(signatures),
+      [name](
+          const std::vector<exec::WindowFunctionArg>& args,
+          const TypePtr& resultType,
+          bool ignoreNulls,
+          velox::memory::MemoryPool* pool)
+          -> std::unique_ptr<exec::WindowFunction> {
+        return std::make_unique<NthValueFunction<TValue>>(
+            args, resultType, ignoreNulls, pool);
+      });
+}
+
+} // namespace
+
+// first_value(T) -> T.
+void registerFirstValue(const std::string& name) {
+  registerNthValueInternal<ValueType::kFirst>(name);
+}
+
+// last_value(T) -> T.
+void registerLastValue(const std::string& name) {
+  registerNthValueInternal<ValueType::kLast>(name);
+}
+
+// nth_value(T, bigint) -> T.
+void registerNthValue(const std::string& name) {
+  registerNthValueInternal<ValueType::kNth>(name);
+}
+
+} // namespace facebook::velox::window
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/exec/WindowPartition.h"
+
+namespace facebook::velox::window {
+
+/// Positions of the rows of a partition in which a column is not null. Used
+/// by the value functions to skip nulls in O(1) per row for IGNORE NULLS.
+class NullSkipIndex {
+ public:
+  /// Indexes the rows of 'partition' for the column at 'columnIndex'.
+  void reset(
+      const exec::WindowPartition& partition,
+      column_index_t columnIndex) {
+    const auto numRows = partition.numRows();
+    nulls_.assign(bits::nwords(numRows), 0);
+    partition.extractNulls(columnIndex, 0, numRows, nulls_.data());
+    nonNullRows_.clear();
+    numNonNullsBefore_.resize(numRows + 1);
+    for (auto i = 0; i < numRows; ++i) {
+      numNonNullsBefore_[i] = nonNullRows_.size();
+      if (!bits::isBitSet(nulls_.data(), i)) {
+        nonNullRows_.push_back(i);
+      }
+    }
+    numNonNullsBefore_[numRows] = nonNullRows_.size();
+  }
+
+  /// Returns the number of rows with a non-null value before 'row'. 'row'
+  /// may be one past the last row.
+  vector_size_t numNonNullsBefore(vector_size_t row) const {
+    return numNonNullsBefore_[row];
+  }
+
+  /// Returns the row of the 'n'th non-null value, counting from 0, or -1 if
+  /// there is no such row.
+  vector_size_t nthNonNullRow(int64_t n) const {
+    if (n < 0 || n >= nonNullRows_.size()) {
+      return -1;
+    }
+    return nonNullRows_[n];
+  }
+
+ private:
+  std::vector<uint64_t> nulls_;
+  std::vector<vector_size_t> nonNullRows_;
+  std::vector<vector_size_t> numNonNullsBefore_;
+};
+
+} // namespace facebook::velox::window
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include "velox/functions/prestosql/window/WindowFunctionsRegistration.h"
+#include "velox/exec/Aggregate.h"
+#include "velox/exec/AggregateWindow.h"
 
 namespace facebook::velox::window {
 
@@ -22,6 +24,11 @@ extern void registerRank(const std::string& name);
 extern void registerDenseRank(const std::string& name);
 extern void registerPercentRank(const std::string& name);
 extern void registerCumeDist(const std::string& name);
+extern void registerLag(const std::string& name);
+extern void registerLead(const std::string& name);
+extern void registerFirstValue(const std::string& name);
+extern void registerLastValue(const std::string& name);
+extern void registerNthValue(const std::string& name);
 
 void registerWindowFunctions() {
   window::registerRowNumber("row_number");
@@ -29,6 +36,15 @@ void registerWindowFunctions() {
   window::registerDenseRank("dense_rank");
   window::registerPercentRank("percent_rank");
   window::registerCumeDist("cume_dist");
+  window::registerLag("lag");
+  window::registerLead("lead");
+  window::registerFirstValue("first_value");
+  window::registerLastValue("last_value");
+  window::registerNthValue("nth_value");
+
+  for (const auto& [name, _] : exec::aggregateFunctions()) {
+    exec::registerAggregateWindowFunction(name);
+  }
 }
 
 } // namespace facebook::velox::window
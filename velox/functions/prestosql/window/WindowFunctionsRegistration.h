@@ -17,6 +17,8 @@
 
 namespace facebook::velox::window {
 
+/// Registers the window functions. The aggregate functions registered before
+/// this call are also registered as window functions.
 void registerWindowFunctions();
 
 } // namespace facebook::velox::window
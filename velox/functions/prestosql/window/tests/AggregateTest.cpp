@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/functions/prestosql/window/tests/WindowTestBase.h"
+
+using namespace facebook::velox::exec::test;
+
+namespace facebook::velox::window::test {
+
+namespace {
+
+class AggregateTest : public WindowTestBase {
+ protected:
+  void SetUp() override {
+    aggregate::prestosql::registerAllAggregateFunctions();
+    WindowTestBase::SetUp();
+  }
+
+  // Rows with 'c0' as partition key and unique 'c1' as sort key so that
+  // ROWS frames are deterministic. 'c2' has nulls.
+  RowVectorPtr makeInput(vector_size_t size, int32_t numPartitions) {
+    return makeRowVector({
+        makeFlatVector<int32_t>(
+            size, [&](auto row) { return row % numPartitions; }),
+        makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+        makeFlatVector<int64_t>(
+            size, [](auto row) { return row % 11 - 5; }, nullEvery(7)),
+    });
+  }
+
+  void testAggregates(
+      const std::vector<RowVectorPtr>& input,
+      const std::vector<std::string>& overClauses) {
+    createDuckDbTable(input);
+    for (const auto& function :
+         {"sum(c2)", "min(c2)", "max(c2)", "count(c2)", "avg(c2)"}) {
+      testWindowFunction(input, function, overClauses);
+    }
+  }
+};
+
+TEST_F(AggregateTest, defaultFrame) {
+  auto input = makeRowVector({
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row % 10; }),
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row % 7; }),
+      makeFlatVector<int64_t>(
+          1'000, [](auto row) { return row % 13; }, nullEvery(5)),
+  });
+  // Rows with the same 'c1' are peers and share their frame.
+  testAggregates(
+      {input},
+      {"partition by c0 order by c1",
+       "partition by c0 order by c1 desc",
+       "order by c0, c1",
+       "partition by c0"});
+}
+
+TEST_F(AggregateTest, rowsFrames) {
+  testAggregates(
+      {makeInput(1'000, 7)},
+      {"partition by c0 order by c1 rows between 3 preceding and current row",
+       "partition by c0 order by c1 rows between current row and 2 following",
+       "partition by c0 order by c1 rows between 5 preceding and 2 following",
+       "partition by c0 order by c1 rows between 3 preceding and 1 preceding",
+       "partition by c0 order by c1 rows between 1 following and 4 following",
+       "partition by c0 order by c1 "
+       "rows between unbounded preceding and current row",
+       "partition by c0 order by c1 "
+       "rows between current row and unbounded following",
+       "partition by c0 order by c1 "
+       "rows between 2 preceding and unbounded following",
+       "order by c1 rows between 10 preceding and 10 following"});
+}
+
+TEST_F(AggregateTest, rangeFrames) {
+  auto input = makeRowVector({
+      makeFlatVector<int32_t>(500, [](auto row) { return row % 3; }),
+      makeFlatVector<int32_t>(500, [](auto row) { return row % 17; }),
+      makeFlatVector<int64_t>(
+          500, [](auto row) { return row % 9; }, nullEvery(4)),
+  });
+  testAggregates(
+      {input},
+      {"partition by c0 order by c1 "
+       "range between unbounded preceding and unbounded following",
+       "partition by c0 order by c1 "
+       "range between current row and unbounded following",
+       "partition by c0 order by c1 "
+       "range between current row and current row"});
+}
+
+TEST_F(AggregateTest, singleRowPartitions) {
+  testAggregates(
+      {makeInput(100, 100)},
+      {"partition by c0 order by c1 rows between 1 preceding and 1 following",
+       "partition by c0 order by c1"});
+}
+
+TEST_F(AggregateTest, multipleBatches) {
+  // A partition of 3 batches is output over several calls to apply().
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 3; ++i) {
+    input.push_back(makeRowVector({
+        makeFlatVector<int32_t>(1'000, [](auto /*row*/) { return 1; }),
+        makeFlatVector<int32_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }),
+        makeFlatVector<int64_t>(
+            1'000, [](auto row) { return row % 23; }, nullEvery(3)),
+    }));
+  }
+  testAggregates(
+      input,
+      {"order by c1 rows between 100 preceding and 50 following",
+       "order by c1"});
+}
+
+TEST_F(AggregateTest, arrayAgg) {
+  // The nodes of the tree are combined in the order of the rows.
+  auto input = makeInput(200, 3);
+  createDuckDbTable({input});
+  auto plan =
+      PlanBuilder()
+          .values({input})
+          .window({"array_agg(c1) over (partition by c0 order by c1 "
+                   "rows between 4 preceding and 3 following)"})
+          .planNode();
+  assertQuery(
+      plan,
+      "SELECT c0, c1, c2, array_agg(c1) over (partition by c0 order by c1 "
+      "rows between 4 preceding and 3 following) FROM tmp");
+}
+
+TEST_F(AggregateTest, invalidFrame) {
+  auto input = makeInput(10, 2);
+  auto plan = PlanBuilder()
+                  .values({input})
+                  .window({"sum(c2) over (partition by c0 order by c1 "
+                           "range between 1 preceding and current row)"})
+                  .planNode();
+  VELOX_ASSERT_THROW(
+      assertQuery(plan, "SELECT 1"),
+      "Window doesn't support RANGE frames with offset bounds");
+}
+
+} // namespace
+} // namespace facebook::velox::window::test
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/window/tests/WindowTestBase.h"
+
+using namespace facebook::velox::exec::test;
+
+namespace facebook::velox::window::test {
+
+namespace {
+
+class LeadLagTest : public WindowTestBase {
+ protected:
+  // 'c0' is the partition key, 'c1' a unique sort key, 'c2' has nulls and
+  // 'c3' holds offsets.
+  RowVectorPtr makeInput(vector_size_t size) {
+    return makeRowVector({
+        makeFlatVector<int32_t>(size, [](auto row) { return row % 6; }),
+        makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+        makeFlatVector<int64_t>(
+            size, [](auto row) { return row * 3; }, nullEvery(4)),
+        makeFlatVector<int64_t>(
+            size, [](auto row) { return row % 5; }, nullEvery(9)),
+    });
+  }
+
+  void testFunctions(
+      const std::vector<RowVectorPtr>& input,
+      const std::vector<std::string>& functions) {
+    createDuckDbTable(input);
+    for (const auto& function : functions) {
+      testWindowFunction(
+          input,
+          function,
+          {"partition by c0 order by c1",
+           "partition by c0 order by c1 desc",
+           "order by c1"});
+    }
+  }
+};
+
+TEST_F(LeadLagTest, basic) {
+  testFunctions(
+      {makeInput(1'000)},
+      {"lag(c2)",
+       "lead(c2)",
+       "lag(c2, 3)",
+       "lead(c2, 3)",
+       "lag(c2, 0)",
+       "lead(c2, 1000)",
+       "lag(c2, 2, 100)",
+       "lead(c2, 2, c3)"});
+}
+
+TEST_F(LeadLagTest, columnOffset) {
+  testFunctions(
+      {makeInput(1'000)},
+      {"lag(c2, c3)", "lead(c2, c3)", "lag(c2, c3, c3)", "lead(c2, c3, 7)"});
+}
+
+TEST_F(LeadLagTest, ignoreNulls) {
+  testFunctions(
+      {makeInput(1'000)},
+      {"lag(c2, 1 ignore nulls)",
+       "lead(c2, 1 ignore nulls)",
+       "lag(c2, 3 ignore nulls)",
+       "lead(c2, c3, 5 ignore nulls)"});
+}
+
+TEST_F(LeadLagTest, strings) {
+  auto input = makeRowVector({
+      makeFlatVector<int32_t>(500, [](auto row) { return row % 4; }),
+      makeFlatVector<int32_t>(500, [](auto row) { return row; }),
+      makeFlatVector<std::string>(
+          500,
+          [](auto row) { return fmt::format("a long string value {}", row); },
+          nullEvery(3)),
+  });
+  testFunctions({input}, {"lag(c2, 2)", "lead(c2, 1, 'none')"});
+}
+
+TEST_F(LeadLagTest, negativeOffset) {
+  auto input = makeRowVector({
+      makeFlatVector<int32_t>({1, 2, 3}),
+      makeFlatVector<int64_t>({1, -1, 1}),
+  });
+  auto plan = PlanBuilder()
+                  .values({input})
+                  .window({"lag(c0, c1) over (order by c0)"})
+                  .planNode();
+  VELOX_ASSERT_THROW(
+      assertQuery(plan, "SELECT 1"), "Offset must be at least 0");
+}
+
+} // namespace
+} // namespace facebook::velox::window::test
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/window/tests/WindowTestBase.h"
+
+using namespace facebook::velox::exec::test;
+
+namespace facebook::velox::window::test {
+
+namespace {
+
+class NthValueTest : public WindowTestBase {
+ protected:
+  // 'c0' is the partition key, 'c1' a unique sort key, 'c2' has nulls and
+  // 'c3' holds offsets.
+  RowVectorPtr makeInput(vector_size_t size) {
+    return makeRowVector({
+        makeFlatVector<int32_t>(size, [](auto row) { return row % 5; }),
+        makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+        makeFlatVector<int64_t>(
+            size, [](auto row) { return row * 7; }, nullEvery(3)),
+        makeFlatVector<int64_t>(
+            size, [](auto row) { return row % 4 + 1; }, nullEvery(11)),
+    });
+  }
+
+  void testFunctions(
+      const std::vector<RowVectorPtr>& input,
+      const std::vector<std::string>& functions) {
+    createDuckDbTable(input);
+    for (const auto& function : functions) {
+      testWindowFunction(
+          input,
+          function,
+          {"partition by c0 order by c1",
+           "partition by c0 order by c1 desc",
+           "partition by c0 order by c1 "
+           "rows between 2 preceding and 3 following",
+           "partition by c0 order by c1 "
+           "rows between 3 preceding and 1 preceding",
+           "partition by c0 order by c1 "
+           "rows between current row and unbounded following",
+           "order by c1 rows between 1 following and 4 following"});
+    }
+  }
+};
+
+TEST_F(NthValueTest, basic) {
+  testFunctions(
+      {makeInput(1'000)},
+      {"first_value(c2)",
+       "last_value(c2)",
+       "nth_value(c2, 1)",
+       "nth_value(c2, 3)",
+       "nth_value(c2, c3)"});
+}
+
+TEST_F(NthValueTest, ignoreNulls) {
+  testFunctions(
+      {makeInput(1'000)},
+      {"first_value(c2 ignore nulls)",
+       "last_value(c2 ignore nulls)",
+       "nth_value(c2, 2 ignore nulls)"});
+}
+
+TEST_F(NthValueTest, peers) {
+  // Rows with the same 'c1' are peers, so the default frame of a row ends at
+  // its last peer. Peers have the same 'c2' for deterministic results.
+  auto input = makeRowVector({
+      makeFlatVector<int32_t>(500, [](auto row) { return row % 3; }),
+      makeFlatVector<int32_t>(500, [](auto row) { return row % 11; }),
+      makeFlatVector<int64_t>(500, [](auto row) { return row % 11 * 10; }),
+  });
+  createDuckDbTable({input});
+  testWindowFunction(
+      {input},
+      "last_value(c2)",
+      {"partition by c0 order by c1",
+       "partition by c0 order by c1 "
+       "range between current row and unbounded following"});
+}
+
+TEST_F(NthValueTest, invalidOffset) {
+  auto input = makeInput(10);
+  auto plan = PlanBuilder()
+                  .values({input})
+                  .window({"nth_value(c2, 0) over (order by c1)"})
+                  .planNode();
+  VELOX_ASSERT_THROW(
+      assertQuery(plan, "SELECT 1"), "Offset must be at least 1");
+}
+
+} // namespace
+} // namespace facebook::velox::window::test
@@ -13,6 +13,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/functions/prestosql/window/tests/WindowTestBase.h"
 
 using namespace facebook::velox::exec::test;
@@ -74,5 +77,42 @@ TEST_F(RowNumberTest, randomInput) {
   testWindowFunction(vectors, "row_number()", overClauses);
 }
 
+TEST_F(RowNumberTest, spill) {
+  vector_size_t size = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            size, [&](auto row) { return (i * size + row) % 17; }),
+        makeFlatVector<int32_t>(
+            size, [&](auto row) { return i * size + row; }, nullEvery(11)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  for (const auto& overClause :
+       {"partition by c0 order by c1",
+        "order by c1 desc, c0",
+        "partition by c0, c1"}) {
+    SCOPED_TRACE(overClause);
+    auto functionSql = fmt::format("row_number() over ({})", overClause);
+    auto spillDirectory = TempDirectoryPath::create();
+    auto plan = PlanBuilder().values(vectors).window({functionSql}).planNode();
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .config(core::QueryConfig::kTestingSpillPct, "100")
+                    .config(core::QueryConfig::kSpillEnabled, "true")
+                    .config(core::QueryConfig::kWindowSpillEnabled, "true")
+                    .config(core::QueryConfig::kSpillPath, spillDirectory->path)
+                    .assertResults(
+                        fmt::format("SELECT c0, c1, {} FROM tmp", functionSql));
+
+    const auto stats = task->taskStats().pipelineStats[0].operatorStats[1];
+    ASSERT_EQ(stats.operatorType, "Window");
+    EXPECT_LT(0, stats.spilledBytes);
+    EXPECT_LT(0, stats.spilledRows);
+    EXPECT_EQ(1, stats.spilledPartitions);
+  }
+}
+
 }; // namespace
 }; // namespace facebook::velox::window::test
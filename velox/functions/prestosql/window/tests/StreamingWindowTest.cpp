@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/window/tests/WindowTestBase.h"
+
+using namespace facebook::velox::exec::test;
+
+namespace facebook::velox::window::test {
+
+namespace {
+
+class StreamingWindowTest : public WindowTestBase {
+ protected:
+  // Returns 'numBatches' batches sorted on 'c0' and then the unique 'c1'.
+  // The partitions on 'c0' have 'partitionSize' rows and span batches.
+  std::vector<RowVectorPtr> makeSortedInput(
+      int32_t numBatches,
+      vector_size_t batchSize,
+      vector_size_t partitionSize) {
+    std::vector<RowVectorPtr> input;
+    for (auto i = 0; i < numBatches; ++i) {
+      input.push_back(makeRowVector({
+          makeFlatVector<int32_t>(
+              batchSize,
+              [&](auto row) { return (i * batchSize + row) / partitionSize; }),
+          makeFlatVector<int32_t>(
+              batchSize, [&](auto row) { return i * batchSize + row; }),
+          makeFlatVector<int64_t>(
+              batchSize,
+              [&](auto row) { return i * batchSize + row; },
+              nullEvery(5)),
+      }));
+    }
+    return input;
+  }
+
+  void testStreaming(
+      const std::vector<RowVectorPtr>& input,
+      const std::vector<std::string>& functions) {
+    createDuckDbTable(input);
+    for (const auto& function : functions) {
+      auto sql = fmt::format("{} over (partition by c0 order by c1)", function);
+      SCOPED_TRACE(sql);
+      auto plan = PlanBuilder()
+                      .values(input)
+                      .orderBy({"c0", "c1"}, false)
+                      .streamingWindow({sql})
+                      .planNode();
+      assertQuery(plan, fmt::format("SELECT c0, c1, c2, {} FROM tmp", sql));
+    }
+  }
+};
+
+TEST_F(StreamingWindowTest, partitionsSpanBatches) {
+  testStreaming(
+      makeSortedInput(10, 100, 37),
+      {"row_number()", "rank()", "lag(c2)", "first_value(c2)"});
+}
+
+TEST_F(StreamingWindowTest, manySmallPartitions) {
+  testStreaming(
+      makeSortedInput(5, 1'000, 3), {"row_number()", "dense_rank()"});
+}
+
+TEST_F(StreamingWindowTest, singlePartition) {
+  testStreaming(makeSortedInput(3, 500, 10'000), {"row_number()", "rank()"});
+}
+
+TEST_F(StreamingWindowTest, descendingPartitionKeys) {
+  // The partition keys need not be sorted ascending, only grouped.
+  auto input = makeSortedInput(4, 250, 23);
+  createDuckDbTable(input);
+  auto sql = "row_number() over (partition by c0 order by c1 desc)";
+  auto plan = PlanBuilder()
+                  .values(input)
+                  .orderBy({"c0 DESC", "c1 DESC"}, false)
+                  .streamingWindow({sql})
+                  .planNode();
+  assertQuery(plan, fmt::format("SELECT c0, c1, c2, {} FROM tmp", sql));
+}
+
+} // namespace
+} // namespace facebook::velox::window::test
@@ -21,6 +21,7 @@
 #include "velox/expression/Expr.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/functions/lib/LambdaFunctionUtil.h"
+#include "velox/functions/lib/ValueSorter.h"
 #include "velox/functions/sparksql/Comparisons.h"
 #include "velox/type/Type.h"
 #include "velox/vector/BaseVector.h"
@@ -103,6 +104,7 @@ void applyTyped(
 
   auto flatResults = (*resultElements)->asFlatVector<T>();
   T* resultRawValues = flatResults->mutableRawValues();
+  ValueSorter<T> sorter;
 
   auto processRow = [&](vector_size_t row) {
     auto size = inputArray->sizeAt(row);
@@ -142,14 +144,15 @@ void applyTyped(
       auto mid = ascending ? rowEnd - numSetBits : rowBegin + numSetBits;
       bits::fillBits(rawBits, rowBegin, mid, smallerValue);
       bits::fillBits(rawBits, mid, rowEnd, !smallerValue);
+    } else if constexpr (std::is_integral_v<T>) {
+      sorter.sort(
+          resultRawValues + rowBegin, resultRawValues + rowEnd, ascending);
+    } else if (ascending) {
+      sorter.sortBy(
+          resultRawValues + rowBegin, resultRawValues + rowEnd, Less<T>());
     } else {
-      if (ascending) {
-        std::sort(
-            resultRawValues + rowBegin, resultRawValues + rowEnd, Less<T>());
-      } else {
-        std::sort(
-            resultRawValues + rowBegin, resultRawValues + rowEnd, Greater<T>());
-      }
+      sorter.sortBy(
+          resultRawValues + rowBegin, resultRawValues + rowEnd, Greater<T>());
     }
   };
 
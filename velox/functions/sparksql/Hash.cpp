@@ -20,6 +20,7 @@
 #include <folly/CPortability.h>
 
 #include "velox/common/base/BitUtil.h"
+#include "velox/vector/DecodedVector.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::functions::sparksql {
@@ -35,14 +36,14 @@ namespace {
 // Signed integer types have been remapped to unsigned types (as in the
 // original) to avoid undefined signed integer overflow and sign extension.
 
-uint32_t mixK1(uint32_t k1) {
+FOLLY_ALWAYS_INLINE uint32_t mixK1(uint32_t k1) {
   k1 *= 0xcc9e2d51;
   k1 = bits::rotateLeft(k1, 15);
   k1 *= 0x1b873593;
   return k1;
 }
 
-uint32_t mixH1(uint32_t h1, uint32_t k1) {
+FOLLY_ALWAYS_INLINE uint32_t mixH1(uint32_t h1, uint32_t k1) {
   h1 ^= k1;
   h1 = bits::rotateLeft(h1, 13);
   h1 = h1 * 5 + 0xe6546b64;
@@ -50,7 +51,7 @@ uint32_t mixH1(uint32_t h1, uint32_t k1) {
 }
 
 // Finalization mix - force all bits of a hash block to avalanche
-uint32_t fmix(uint32_t h1, uint32_t length) {
+FOLLY_ALWAYS_INLINE uint32_t fmix(uint32_t h1, uint32_t length) {
   h1 ^= length;
   h1 ^= h1 >> 16;
   h1 *= 0x85ebca6b;
@@ -60,13 +61,13 @@ uint32_t fmix(uint32_t h1, uint32_t length) {
   return h1;
 }
 
-uint32_t hashInt32(int32_t input, uint32_t seed) {
+FOLLY_ALWAYS_INLINE uint32_t hashInt32(int32_t input, uint32_t seed) {
   uint32_t k1 = mixK1(input);
   uint32_t h1 = mixH1(seed, k1);
   return fmix(h1, 4);
 }
 
-uint32_t hashInt64(uint64_t input, uint32_t seed) {
+FOLLY_ALWAYS_INLINE uint32_t hashInt64(uint64_t input, uint32_t seed) {
   uint32_t low = input;
   uint32_t high = input >> 32;
 
@@ -96,16 +97,40 @@ uint32_t hashBytes(const StringView& input, uint32_t seed) {
 
 // Floating point numbers are hashed as if they are integers, with
 // -0f defined to have the same output as +0f.
-uint32_t hashFloat(float input, uint32_t seed) {
+FOLLY_ALWAYS_INLINE uint32_t hashFloat(float input, uint32_t seed) {
   return hashInt32(
       input == -0.f ? 0 : *reinterpret_cast<uint32_t*>(&input), seed);
 }
 
-uint32_t hashDouble(double input, uint32_t seed) {
+FOLLY_ALWAYS_INLINE uint32_t hashDouble(double input, uint32_t seed) {
   return hashInt64(
       input == -0. ? 0 : *reinterpret_cast<uint64_t*>(&input), seed);
 }
 
+// Updates the running hashes of 'rows' with the hashes of 'values'. Values
+// of a flat vector for a contiguous range of rows are hashed in a loop over
+// the raw values, which the compiler can unroll and vectorize.
+template <typename T, typename HashFn>
+void hashColumn(
+    const DecodedVector& values,
+    const SelectivityVector& rows,
+    HashFn hashFn,
+    int32_t* hashes) {
+  // Flat booleans are bits and can't be read as an array of T.
+  if constexpr (!std::is_same_v<T, bool>) {
+    if (values.isIdentityMapping() && rows.isAllSelected()) {
+      const auto* rawValues = values.data<T>();
+      for (auto row = rows.begin(); row < rows.end(); ++row) {
+        hashes[row] = hashFn(rawValues[row], hashes[row]);
+      }
+      return;
+    }
+  }
+  rows.applyToSelected([&](vector_size_t row) {
+    hashes[row] = hashFn(values.valueAt<T>(row), hashes[row]);
+  });
+}
+
 class HashFunction final : public exec::VectorFunction {
   bool isDefaultNullBehavior() const final {
     return false;
@@ -123,6 +148,7 @@ class HashFunction final : public exec::VectorFunction {
 
     FlatVector<int32_t>& result = *resultRef->as<FlatVector<int32_t>>();
     rows.applyToSelected([&](int row) { result.set(row, kSeed); });
+    auto* rawResult = result.mutableRawValues();
 
     exec::LocalSelectivityVector selectedMinusNulls(context);
 
@@ -136,12 +162,15 @@ class HashFunction final : public exec::VectorFunction {
         selected = selectedMinusNulls.get();
       }
       switch (arg->type()->kind()) {
-#define CASE(typeEnum, hashFn, inputType)                                      \
-  case TypeKind::typeEnum:                                                     \
-    selected->applyToSelected([&](int row) {                                   \
-      result.set(                                                              \
-          row, hashFn(decoded->valueAt<inputType>(row), result.valueAt(row))); \
-    });                                                                        \
+#define CASE(typeEnum, hashFn, inputType)    \
+  case TypeKind::typeEnum:                   \
+    hashColumn<inputType>(                   \
+        *decoded,                            \
+        *selected,                           \
+        [](inputType value, uint32_t seed) { \
+          return hashFn(value, seed);        \
+        },                                   \
+        rawResult);                          \
     break;
         // Derived from InterpretedHashFunction.hash:
         // https://github.com/apache/spark/blob/382b66e/sql/catalyst/src/main/scala/org/apache/spark/sql/catalyst/expressions/hash.scala#L532
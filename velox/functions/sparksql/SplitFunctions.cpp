@@ -59,8 +59,8 @@ class SplitCharacter final : public exec::VectorFunction {
       } while (delim != end);
     });
     // Reference the input StringBuffers since we did not deep copy above.
-    builder.setStringBuffers(
-        args[0]->asFlatVector<StringView>()->stringBuffers());
+    // 'args[0]' is not necessarily flat, so take the buffers of its base.
+    builder.setStringBuffers(input->base());
     std::shared_ptr<ArrayVector> arrayVector =
         std::move(builder).finish(context.pool());
     context.moveOrCopyResult(arrayVector, rows, result);
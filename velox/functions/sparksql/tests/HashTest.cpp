@@ -89,6 +89,49 @@ TEST_F(HashTest, StringInt32) {
   EXPECT_EQ(hash("", 0), 1143746540);
 }
 
+TEST_F(HashTest, flatAndDictionary) {
+  // Flat columns without nulls take the loop over raw values. The same
+  // values in dictionaries, and a column with nulls, go row by row.
+  constexpr vector_size_t kSize = 1'000;
+  auto ints = makeFlatVector<int32_t>(kSize, [](auto row) { return row * 7; });
+  auto doubles =
+      makeFlatVector<double>(kSize, [](auto row) { return row * 1.5; });
+  auto strings = makeFlatVector<std::string>(
+      kSize, [](auto row) { return std::string(row % 20, 'x'); });
+  auto flatResult = evaluate<SimpleVector<int32_t>>(
+      "hash(c0, c1, c2)", makeRowVector({ints, doubles, strings}));
+
+  auto indices = makeIndicesInReverse(kSize);
+  auto dictionaryResult = evaluate<SimpleVector<int32_t>>(
+      "hash(c0, c1, c2)",
+      makeRowVector(
+          {wrapInDictionary(indices, kSize, ints),
+           wrapInDictionary(indices, kSize, doubles),
+           wrapInDictionary(indices, kSize, strings)}));
+
+  auto nullableInts = makeFlatVector<int32_t>(
+      kSize, [](auto row) { return row * 7; }, nullEvery(3));
+  auto nullsResult = evaluate<SimpleVector<int32_t>>(
+      "hash(c0, c1, c2)", makeRowVector({nullableInts, doubles, strings}));
+  auto doublesAndStringsResult = evaluate<SimpleVector<int32_t>>(
+      "hash(c0, c1)", makeRowVector({doubles, strings}));
+
+  for (auto row = 0; row < kSize; ++row) {
+    ASSERT_EQ(
+        flatResult->valueAt(row),
+        dictionaryResult->valueAt(kSize - 1 - row))
+        << row;
+    if (row % 3 == 0) {
+      // A null doesn't change the running hash.
+      ASSERT_EQ(
+          doublesAndStringsResult->valueAt(row), nullsResult->valueAt(row))
+          << row;
+    } else {
+      ASSERT_EQ(flatResult->valueAt(row), nullsResult->valueAt(row)) << row;
+    }
+  }
+}
+
 TEST_F(HashTest, Double) {
   using limits = std::numeric_limits<double>;
 
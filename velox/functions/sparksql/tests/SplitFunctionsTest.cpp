@@ -105,5 +105,17 @@ TEST_F(SplitTest, LongStrings) {
       {{{"abcdefghijklkmnopqrstuvwxyz"}}});
 }
 
+TEST_F(SplitTest, dictionaryInput) {
+  auto strings = makeFlatVector<std::string>(
+      {"a long first element:a long second element", "another:long string"});
+  auto input = wrapInDictionary(makeIndices({1, 0, 1}), 3, strings);
+  auto result = evaluate<ArrayVector>("split(c0, ':')", makeRowVector({input}));
+  auto expected = makeArrayVector<StringView>(
+      {{"another", "long string"},
+       {"a long first element", "a long second element"},
+       {"another", "long string"}});
+  assertEqualVectors(expected, result);
+}
+
 } // namespace
 } // namespace facebook::velox::functions::sparksql::test
@@ -15,6 +15,8 @@
  */
 
 #include "velox/row/UnsafeRow24Deserializer.h"
+#include "velox/common/base/AsyncSource.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/functions/lib/DynamicFlatVector.h"
 
 #include <vector>
@@ -115,7 +117,95 @@ VectorPtr DeserializeFixedWidth(
       /*stringBuffers=*/std::vector<BufferPtr>{});
 }
 
-// Strings are the simplest variable-length type.
+// The positions of the rows of a batch as byte offsets from the first
+// non-null row. Computed in one scan over the rows so that the fixed-width
+// fields are then gathered column by column with SIMD. Null rows get the
+// offset of the first non-null row.
+struct RowOffsets {
+  explicit RowOffsets(const std::vector<const char*>& rows) {
+    auto first = std::find_if(
+        rows.begin(), rows.end(), [](auto row) { return row != nullptr; });
+    if (first == rows.end()) {
+      return;
+    }
+    base = *first;
+    offsets.resize(rows.size());
+    for (auto i = 0; i < rows.size(); ++i) {
+      const int64_t offset = rows[i] ? rows[i] - base : 0;
+      if (offset != static_cast<int32_t>(offset)) {
+        // The rows are too far apart for 32 bit gather indices.
+        offsets.clear();
+        return;
+      }
+      offsets[i] = offset;
+    }
+  }
+
+  const char* base{nullptr};
+  // Empty if all rows are null or the rows are not within 2GB of 'base'.
+  std::vector<int32_t> offsets;
+};
+
+// Deserializes a fixed-width field of a struct from the value slots at
+// 'offset' in 'rows'. The slot of a null field is zero but present, so the
+// values of 4 and 8 byte types are gathered for all the rows regardless of
+// nulls, a SIMD batch at a time.
+template <TypeKind kind>
+VectorPtr DeserializeFixedWidthField(
+    memory::MemoryPool* pool,
+    const std::vector<const char*>& rows,
+    const RowOffsets& rowOffsets,
+    int32_t field,
+    std::size_t offset) {
+  using T = typename TypeTraits<kind>::NativeType;
+  if constexpr (
+      kind == TypeKind::INTEGER || kind == TypeKind::BIGINT ||
+      kind == TypeKind::REAL || kind == TypeKind::DOUBLE) {
+    if (!rowOffsets.offsets.empty()) {
+      const vector_size_t size = rows.size();
+      NullBuffer nulls(size, pool);
+      bool hasNull = false;
+      for (auto i = 0; i < size; ++i) {
+        if (!rows[i] || bits::isBitSet(rows[i], field)) {
+          hasNull = true;
+          nulls.setNull(i);
+        }
+      }
+      BufferPtr values = AlignedBuffer::allocate<T>(size, pool);
+      T* data = values->template asMutable<T>();
+      const auto* fieldBase =
+          reinterpret_cast<const T*>(rowOffsets.base + offset);
+      const int32_t* offsets = rowOffsets.offsets.data();
+      constexpr int32_t kBatchSize = xsimd::batch<T>::size;
+      vector_size_t i = 0;
+      for (; i + kBatchSize <= size; i += kBatchSize) {
+        simd::gather<T, int32_t, 1>(fieldBase, offsets + i)
+            .store_unaligned(data + i);
+      }
+      for (; i < size; ++i) {
+        data[i] = *reinterpret_cast<const T*>(
+            reinterpret_cast<const char*>(fieldBase) + offsets[i]);
+      }
+      return std::make_shared<FlatVector<T>>(
+          pool,
+          ScalarType<kind>::create(),
+          hasNull ? std::move(nulls.buf_) : nullptr,
+          size,
+          std::move(values),
+          /*stringBuffers=*/std::vector<BufferPtr>{});
+    }
+  }
+  auto row = rows.begin();
+  return DeserializeFixedWidth<kind>(pool, rows.size(), [&] {
+    const char* data = *row++;
+    return data && !bits::isBitSet(data, field) ? data + offset : nullptr;
+  });
+}
+
+// Strings are the simplest variable-length type. A first pass over the
+// offset and size words sizes a single buffer for the strings that are not
+// inlined in StringView, so that the second pass copies each string without
+// checking for space.
 FlatVectorPtr<StringView> DeserializeString(
     const TypePtr& type,
     memory::MemoryPool* pool,
@@ -124,13 +214,33 @@ FlatVectorPtr<StringView> DeserializeString(
   const vector_size_t size = valuePointers.size();
   auto result = std::dynamic_pointer_cast<FlatVector<StringView>>(
       BaseVector::create(type, size, pool));
+  uint64_t totalBytes = 0;
+  for (int i = 0; i < size; ++i) {
+    if (valuePointers[i]) {
+      const auto stringSize = static_cast<uint32_t>(
+          *reinterpret_cast<const uint64_t*>(valuePointers[i]));
+      if (!StringView::isInline(stringSize)) {
+        totalBytes += stringSize;
+      }
+    }
+  }
+  char* rawBuffer = nullptr;
+  if (totalBytes > 0) {
+    auto buffer = AlignedBuffer::allocate<char>(totalBytes, pool);
+    rawBuffer = buffer->asMutable<char>();
+    result->addStringBuffer(buffer);
+  }
   for (int i = 0; i < size; ++i) {
     if (valuePointers[i]) {
       auto [data, size] = decodeVarOffset(basePointers[i], valuePointers[i]);
-      // This copies the data into the FlatVector's buffers if needed.
-      // It might be possible to avoid this copy, but it would significantly
-      // complicate lifetime management.
-      result->set(i, StringView(data, size));
+      // The data is copied since the vector may outlive the rows.
+      if (StringView::isInline(size)) {
+        result->setNoCopy(i, StringView(data, size));
+      } else {
+        memcpy(rawBuffer, data, size);
+        result->setNoCopy(i, StringView(rawBuffer, size));
+        rawBuffer += size;
+      }
     } else {
       result->setNull(i, true);
     }
@@ -142,46 +252,88 @@ FlatVectorPtr<StringView> DeserializeString(
 //   int64_t nulls[]
 //   int64_t elements[]
 // Note that elements are padded out to 8 bytes each, even for e.g. bools.
+VectorPtr DeserializeField(
+    const TypePtr& fieldType,
+    memory::MemoryPool* pool,
+    const std::vector<const char*>& rows,
+    const RowOffsets& rowOffsets,
+    int32_t field,
+    std::size_t offset) {
+  switch (fieldType->kind()) {
+#define FIXED_WIDTH(kind)                              \
+  case TypeKind::kind:                                 \
+    return DeserializeFixedWidthField<TypeKind::kind>( \
+        pool, rows, rowOffsets, field, offset)
+    FIXED_WIDTH(BOOLEAN);
+    FIXED_WIDTH(TINYINT);
+    FIXED_WIDTH(SMALLINT);
+    FIXED_WIDTH(INTEGER);
+    FIXED_WIDTH(BIGINT);
+    FIXED_WIDTH(REAL);
+    FIXED_WIDTH(DOUBLE);
+    FIXED_WIDTH(TIMESTAMP);
+    FIXED_WIDTH(DATE);
+#undef FIXED_WIDTH
+    default: {
+      std::vector<const char*> fieldPointers(rows.size());
+      for (int i = 0; i < rows.size(); ++i) {
+        const char* data = rows[i];
+        fieldPointers[i] =
+            data && !bits::isBitSet(data, field) ? data + offset : nullptr;
+      }
+      return DeserializeVariableLength(fieldType, pool, rows, fieldPointers);
+    }
+  }
+}
+
+// Deserializes the fields of 'rows' column by column. If 'executor' is
+// given, the fields are deserialized in parallel on it.
 RowVectorPtr DeserializeRow(
     const std::shared_ptr<const RowType>& type,
     memory::MemoryPool* pool,
-    const std::vector<const char*>& rows) {
+    const std::vector<const char*>& rows,
+    folly::Executor* executor = nullptr) {
   const std::vector<TypePtr>& fieldTypes = type->children();
   auto nulls = makeNullBuffer(pool, rows);
-  std::vector<VectorPtr> fields;
-  std::size_t offset = nullSizeBytes(fieldTypes.size());
-  for (int field = 0; field < fieldTypes.size(); ++field) {
-    auto row = rows.begin();
-    auto fieldPointerCallback = [&row, field, offset] {
-      const char* data = *row++;
-      return data && !bits::isBitSet(data, field) ? data + offset : nullptr;
-    };
-    switch (fieldTypes[field]->kind()) {
-#define FIXED_WIDTH(kind)                                   \
-  case TypeKind::kind:                                      \
-    fields.push_back(DeserializeFixedWidth<TypeKind::kind>( \
-        pool, rows.size(), fieldPointerCallback));          \
-    break
-      FIXED_WIDTH(BOOLEAN);
-      FIXED_WIDTH(TINYINT);
-      FIXED_WIDTH(SMALLINT);
-      FIXED_WIDTH(INTEGER);
-      FIXED_WIDTH(BIGINT);
-      FIXED_WIDTH(REAL);
-      FIXED_WIDTH(DOUBLE);
-      FIXED_WIDTH(TIMESTAMP);
-      FIXED_WIDTH(DATE);
-#undef FIXED_WIDTH
-      default: {
-        std::vector<const char*> fieldPointers(rows.size());
-        for (int i = 0; i < rows.size(); ++i) {
-          fieldPointers[i] = fieldPointerCallback();
-        }
-        fields.push_back(DeserializeVariableLength(
-            fieldTypes[field], pool, rows, fieldPointers));
+  const RowOffsets rowOffsets(rows);
+  std::vector<VectorPtr> fields(fieldTypes.size());
+  const std::size_t firstOffset = nullSizeBytes(fieldTypes.size());
+  auto fieldOffset = [&](int32_t field) {
+    return firstOffset + field * sizeof(uint64_t);
+  };
+  if (!executor || fieldTypes.size() < 2) {
+    for (int field = 0; field < fieldTypes.size(); ++field) {
+      fields[field] = DeserializeField(
+          fieldTypes[field], pool, rows, rowOffsets, field, fieldOffset(field));
+    }
+  } else {
+    std::vector<std::shared_ptr<AsyncSource<VectorPtr>>> sources;
+    sources.reserve(fieldTypes.size());
+    for (int field = 0; field < fieldTypes.size(); ++field) {
+      sources.push_back(std::make_shared<AsyncSource<VectorPtr>>([&, field]() {
+        return std::make_unique<VectorPtr>(DeserializeField(
+            fieldTypes[field],
+            pool,
+            rows,
+            rowOffsets,
+            field,
+            fieldOffset(field)));
+      }));
+      executor->add([source = sources.back()]() { source->prepare(); });
+    }
+    // All the fields are waited for also in case of error since the
+    // sources reference 'rows' and 'rowOffsets'.
+    std::exception_ptr error;
+    for (int field = 0; field < fieldTypes.size(); ++field) {
+      try {
+        fields[field] = std::move(*sources[field]->move());
+      } catch (const std::exception&) {
+        error = std::current_exception();
       }
     }
-    offset += sizeof(uint64_t);
+    if (error) {
+      std::rethrow_exception(error);
+    }
   }
   return std::make_shared<RowVector>(
       pool, type, nulls, rows.size(), std::move(fields));
@@ -387,21 +539,35 @@ VectorPtr DeserializeVariableLength(
 } // namespace
 
 std::unique_ptr<UnsafeRow24Deserializer> UnsafeRow24Deserializer::Create(
-    RowTypePtr rowType) {
+    RowTypePtr rowType,
+    folly::Executor* executor,
+    vector_size_t minParallelRows) {
   // The current implementation is stateless, so no object is really needed.
   struct Wrapper final : public UnsafeRow24Deserializer {
-    explicit Wrapper(RowTypePtr rowType) : type_(std::move(rowType)) {}
+    Wrapper(
+        RowTypePtr rowType,
+        folly::Executor* executor,
+        vector_size_t minParallelRows)
+        : type_(std::move(rowType)),
+          executor_(executor),
+          minParallelRows_(minParallelRows) {}
 
     RowVectorPtr DeserializeRows(
         memory::MemoryPool* pool,
         const std::vector<const char*>& rows) final {
-      return DeserializeRow(type_, pool, rows);
+      return DeserializeRow(
+          type_,
+          pool,
+          rows,
+          rows.size() >= minParallelRows_ ? executor_ : nullptr);
     }
 
     RowTypePtr type_;
+    folly::Executor* const executor_;
+    const vector_size_t minParallelRows_;
   };
 
-  return std::make_unique<Wrapper>(rowType);
+  return std::make_unique<Wrapper>(rowType, executor, minParallelRows);
 }
 
 } // namespace facebook::velox::row
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <folly/Executor.h>
 #include <memory>
 #include <string_view>
 
@@ -29,7 +30,12 @@ class UnsafeRow24Deserializer {
  public:
   virtual ~UnsafeRow24Deserializer() = default;
 
-  static std::unique_ptr<UnsafeRow24Deserializer> Create(RowTypePtr rowType);
+  // If 'executor' is given, the top level columns of batches of at least
+  // 'minParallelRows' rows are deserialized in parallel on it.
+  static std::unique_ptr<UnsafeRow24Deserializer> Create(
+      RowTypePtr rowType,
+      folly::Executor* executor = nullptr,
+      vector_size_t minParallelRows = 10'000);
 
   // We are allowed to mutate `rows`.
   virtual RowVectorPtr DeserializeRows(
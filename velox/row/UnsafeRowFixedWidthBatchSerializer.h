@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/Nulls.h"
+#include "velox/row/UnsafeRow.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/SelectivityVector.h"
+
+namespace facebook::velox::row {
+
+/// Serializes and deserializes UnsafeRows of a row type whose fields are all
+/// fixed width a column at a time instead of a row and a field at a time.
+/// All such rows have the same size: the null bitset followed by one 8 byte
+/// slot per field. The rows are the same as the rows written by
+/// UnsafeRowDynamicSerializer, except that the unused bytes of the slots
+/// are zeros.
+struct UnsafeRowFixedWidthBatchSerializer {
+  /// True if all the fields of 'rowType' have a fixed width type that
+  /// UnsafeRowDynamicSerializer supports.
+  static bool supports(const RowType& rowType) {
+    for (const auto& type : rowType.children()) {
+      switch (type->kind()) {
+        case TypeKind::BOOLEAN:
+        case TypeKind::TINYINT:
+        case TypeKind::SMALLINT:
+        case TypeKind::INTEGER:
+        case TypeKind::BIGINT:
+        case TypeKind::REAL:
+        case TypeKind::DOUBLE:
+        case TypeKind::TIMESTAMP:
+        case TypeKind::DATE:
+          break;
+        default:
+          return false;
+      }
+    }
+    return true;
+  }
+
+  /// Returns the size of each row of 'rowType'. 'rowType' must be
+  /// supported.
+  static size_t rowSize(const RowType& rowType) {
+    return UnsafeRow::getNullLength(rowType.size()) +
+        rowType.size() * UnsafeRow::kFieldWidthBytes;
+  }
+
+  /// Writes the rows in 'ranges' of 'data' to consecutive rows that start
+  /// 'rowStride' bytes apart at 'buffer'. The type of 'data' must be
+  /// supported and 'data' must not have nulls at the top level.
+  static void serialize(
+      const RowVector& data,
+      const folly::Range<const IndexRange*>& ranges,
+      char* buffer,
+      size_t rowStride) {
+    VELOX_DCHECK(!data.mayHaveNulls());
+    const auto& rowType = data.type()->asRow();
+    const auto nullLength = UnsafeRow::getNullLength(rowType.size());
+
+    // The null bits are set column by column, so all start as not null.
+    auto* row = buffer;
+    for (const auto& range : ranges) {
+      for (auto i = 0; i < range.size; ++i) {
+        std::memset(row, 0, nullLength);
+        row += rowStride;
+      }
+    }
+
+    SelectivityVector allRows(data.size());
+    DecodedVector decoded;
+    for (auto field = 0; field < rowType.size(); ++field) {
+      decoded.decode(*data.childAt(field), allRows);
+      const auto slotOffset = nullLength + field * UnsafeRow::kFieldWidthBytes;
+      switch (rowType.childAt(field)->kind()) {
+#define FIXED_WIDTH(kind)                                       \
+  case TypeKind::kind:                                          \
+    serializeColumn<TypeKind::kind>(                            \
+        decoded, ranges, field, slotOffset, buffer, rowStride); \
+    break;
+        FIXED_WIDTH(BOOLEAN);
+        FIXED_WIDTH(TINYINT);
+        FIXED_WIDTH(SMALLINT);
+        FIXED_WIDTH(INTEGER);
+        FIXED_WIDTH(BIGINT);
+        FIXED_WIDTH(REAL);
+        FIXED_WIDTH(DOUBLE);
+        FIXED_WIDTH(TIMESTAMP);
+        FIXED_WIDTH(DATE);
+#undef FIXED_WIDTH
+        default:
+          VELOX_UNSUPPORTED(
+              "Unsupported type: {}", rowType.childAt(field)->toString());
+      }
+    }
+  }
+
+  /// Reads 'rows' of 'rowType' into a RowVector. Returns nullptr if a row is
+  /// null or does not have the size of a row of 'rowType', e.g. because the
+  /// rows were written by a different writer.
+  static RowVectorPtr deserialize(
+      const std::vector<std::optional<std::string_view>>& rows,
+      const RowTypePtr& rowType,
+      memory::MemoryPool* pool) {
+    const auto size = rowSize(*rowType);
+    for (const auto& row : rows) {
+      if (!row.has_value() || row->size() != size) {
+        return nullptr;
+      }
+    }
+
+    const auto nullLength = UnsafeRow::getNullLength(rowType->size());
+    std::vector<VectorPtr> columns(rowType->size());
+    for (auto field = 0; field < rowType->size(); ++field) {
+      const auto& type = rowType->childAt(field);
+      const auto offset = nullLength + field * UnsafeRow::kFieldWidthBytes;
+      switch (type->kind()) {
+#define FIXED_WIDTH(kind)                                     \
+  case TypeKind::kind:                                        \
+    columns[field] = deserializeColumn<TypeKind::kind>(       \
+        rows, type, field, offset, pool);                     \
+    break;
+        FIXED_WIDTH(BOOLEAN);
+        FIXED_WIDTH(TINYINT);
+        FIXED_WIDTH(SMALLINT);
+        FIXED_WIDTH(INTEGER);
+        FIXED_WIDTH(BIGINT);
+        FIXED_WIDTH(REAL);
+        FIXED_WIDTH(DOUBLE);
+        FIXED_WIDTH(TIMESTAMP);
+        FIXED_WIDTH(DATE);
+#undef FIXED_WIDTH
+        default:
+          VELOX_UNSUPPORTED("Unsupported type: {}", type->toString());
+      }
+    }
+    return std::make_shared<RowVector>(
+        pool, rowType, nullptr, rows.size(), std::move(columns));
+  }
+
+ private:
+  // Writes the values of the column of 'field' to the slots at 'slotOffset'
+  // of the rows that start at 'buffer' and sets the null bits of the nulls.
+  template <TypeKind Kind>
+  static void serializeColumn(
+      const DecodedVector& decoded,
+      const folly::Range<const IndexRange*>& ranges,
+      int32_t field,
+      size_t slotOffset,
+      char* buffer,
+      size_t rowStride) {
+    using Traits = ScalarTraits<Kind>;
+    static_assert(
+        sizeof(typename Traits::SerializedType) <=
+        UnsafeRow::kFieldWidthBytes);
+
+    const auto nullWord = field / 64;
+    const auto nullBit = 1UL << (field % 64);
+    const bool mayHaveNulls = decoded.mayHaveNulls();
+    auto* row = buffer;
+    for (const auto& range : ranges) {
+      const auto end = range.begin + range.size;
+      for (auto i = range.begin; i < end; ++i, row += rowStride) {
+        if (mayHaveNulls && decoded.isNullAt(i)) {
+          reinterpret_cast<uint64_t*>(row)[nullWord] |= nullBit;
+          *reinterpret_cast<uint64_t*>(row + slotOffset) = 0;
+        } else {
+          writeSlot(Traits::get(decoded, i), row + slotOffset);
+        }
+      }
+    }
+  }
+
+  template <typename T>
+  FOLLY_ALWAYS_INLINE static void writeSlot(T value, char* slot) {
+    uint64_t word = 0;
+    std::memcpy(&word, &value, sizeof(T));
+    *reinterpret_cast<uint64_t*>(slot) = word;
+  }
+
+  template <TypeKind Kind>
+  static VectorPtr deserializeColumn(
+      const std::vector<std::optional<std::string_view>>& rows,
+      const TypePtr& type,
+      int32_t field,
+      size_t offset,
+      memory::MemoryPool* pool) {
+    using Traits = ScalarTraits<Kind>;
+    using SerializedType = typename Traits::SerializedType;
+
+    auto vector = BaseVector::create(type, rows.size(), pool);
+    auto* flatVector = vector->asFlatVector<typename Traits::InMemoryType>();
+    const auto nullWord = field / 64;
+    const auto nullBit = 1UL << (field % 64);
+    uint64_t* rawNulls = nullptr;
+    vector_size_t nullCount = 0;
+    for (auto i = 0; i < rows.size(); ++i) {
+      const auto* row = rows[i]->data();
+      if (reinterpret_cast<const uint64_t*>(row)[nullWord] & nullBit) {
+        if (!rawNulls) {
+          rawNulls = vector->mutableRawNulls();
+        }
+        bits::setNull(rawNulls, i);
+        ++nullCount;
+        continue;
+      }
+      SerializedType value;
+      std::memcpy(&value, row + offset, sizeof(SerializedType));
+      Traits::set(flatVector, i, value);
+    }
+    vector->setNullCount(nullCount);
+    return vector;
+  }
+};
+
+} // namespace facebook::velox::row
@@ -21,6 +21,7 @@
 #include "velox/row/UnsafeRowBatchDeserializer.h"
 #include "velox/row/UnsafeRowDeserializer.h"
 #include "velox/row/UnsafeRowDynamicSerializer.h"
+#include "velox/row/UnsafeRowFixedWidthBatchSerializer.h"
 #include "velox/type/Type.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
 #include "velox/vector/tests/utils/VectorMaker.h"
@@ -72,10 +73,30 @@ class UnsaferowBatchDeserializer : public Deserializer {
       memory::getDefaultScopedMemoryPool();
 };
 
+class UnsaferowFixedWidthBatchDeserializer : public Deserializer {
+ public:
+  UnsaferowFixedWidthBatchDeserializer() {}
+
+  void deserialize(
+      const std::vector<std::optional<std::string_view>>& data,
+      const TypePtr& type) override {
+    UnsafeRowFixedWidthBatchSerializer::deserialize(
+        data, asRowType(type), pool_.get());
+  }
+
+ private:
+  std::unique_ptr<memory::ScopedMemoryPool> pool_ =
+      memory::getDefaultScopedMemoryPool();
+};
+
 class BenchmarkHelper {
  public:
   std::tuple<std::vector<std::optional<std::string_view>>, TypePtr>
-  randomUnsaferows(int nFields, int nRows, bool stringOnly) {
+  randomUnsaferows(
+      int nFields,
+      int nRows,
+      bool stringOnly,
+      bool fixedWidthOnly = false) {
     RowTypePtr rowType;
     std::vector<std::string> names;
     std::vector<TypePtr> types;
@@ -85,6 +106,9 @@ class BenchmarkHelper {
       names.push_back("");
       if (stringOnly) {
         types.push_back(VARCHAR());
+      } else if (fixedWidthOnly) {
+        auto idx = folly::Random::rand32() % fixedWidthTypes_.size();
+        types.push_back(fixedWidthTypes_[idx]);
       } else {
         auto idx = folly::Random::rand32() % allTypes_.size();
         types.push_back(allTypes_[idx]);
@@ -133,6 +157,16 @@ class BenchmarkHelper {
       MAP(VARCHAR(), ARRAY(INTEGER())),
       ROW({INTEGER()})};
 
+  std::vector<TypePtr> fixedWidthTypes_{
+      BOOLEAN(),
+      TINYINT(),
+      SMALLINT(),
+      INTEGER(),
+      BIGINT(),
+      REAL(),
+      DOUBLE(),
+      TIMESTAMP()};
+
   std::unique_ptr<memory::ScopedMemoryPool> pool_ =
       memory::getDefaultScopedMemoryPool();
 };
@@ -155,6 +189,24 @@ int deserialize(
   return nIters * nFields * nRows;
 }
 
+int deserializeFixedWidth(
+    int nIters,
+    int nFields,
+    int nRows,
+    std::unique_ptr<Deserializer> deserializer) {
+  folly::BenchmarkSuspender suspender;
+  BenchmarkHelper helper;
+  auto [data, rowType] = helper.randomUnsaferows(
+      nFields, nRows, /*stringOnly=*/false, /*fixedWidthOnly=*/true);
+  suspender.dismiss();
+
+  for (int i = 0; i < nIters; i++) {
+    deserializer->deserialize(data, rowType);
+  }
+
+  return nIters * nFields * nRows;
+}
+
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
     row_10_100k_string_only,
@@ -215,6 +267,44 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     false,
     std::make_unique<UnsaferowBatchDeserializer>());
 
+BENCHMARK_NAMED_PARAM_MULTI(
+    deserializeFixedWidth,
+    row_10_100k_fixed_width,
+    10,
+    100000,
+    std::make_unique<UnsaferowDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserializeFixedWidth,
+    batch_10_100k_fixed_width,
+    10,
+    100000,
+    std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserializeFixedWidth,
+    column_10_100k_fixed_width,
+    10,
+    100000,
+    std::make_unique<UnsaferowFixedWidthBatchDeserializer>());
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    deserializeFixedWidth,
+    row_100_100k_fixed_width,
+    100,
+    100000,
+    std::make_unique<UnsaferowDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserializeFixedWidth,
+    batch_100_100k_fixed_width,
+    100,
+    100000,
+    std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserializeFixedWidth,
+    column_100_100k_fixed_width,
+    100,
+    100000,
+    std::make_unique<UnsaferowFixedWidthBatchDeserializer>());
+
 } // namespace
 } // namespace facebook::spark::benchmarks
 
@@ -17,8 +17,10 @@
 #include <gtest/gtest.h>
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/init/Init.h>
 
+#include "velox/row/UnsafeRow24Deserializer.h"
 #include "velox/row/UnsafeRowBatchDeserializer.h"
 #include "velox/row/UnsafeRowDynamicSerializer.h"
 #include "velox/type/Type.h"
@@ -104,5 +106,62 @@ TEST_F(UnsafeRowFuzzTests, simpleTypeRoundTripTest) {
   }
 }
 
+// Serializes a batch of rows back to back into one buffer and deserializes
+// them column by column with UnsafeRow24Deserializer, on one thread and in
+// parallel.
+TEST_F(UnsafeRowFuzzTests, batchRoundTripTest) {
+  auto rowType = ROW(
+      {BOOLEAN(),
+       TINYINT(),
+       INTEGER(),
+       BIGINT(),
+       REAL(),
+       DOUBLE(),
+       VARCHAR(),
+       ROW({VARCHAR(), INTEGER()}),
+       ARRAY(BIGINT())});
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = 1'000;
+  opts.nullRatio = 0.1;
+  opts.containerHasNulls = false;
+  opts.stringVariableLength = true;
+  opts.stringLength = 20;
+  opts.containerLength = 10;
+
+  auto seed = folly::Random::rand32();
+  LOG(INFO) << "seed: " << seed;
+  SCOPED_TRACE(fmt::format("seed: {}", seed));
+  VectorFuzzer fuzzer(opts, pool_.get(), seed);
+  auto inputVector = fuzzer.fuzzRow(rowType);
+  UnsafeRowDynamicSerializer::preloadVector(inputVector);
+
+  std::vector<size_t> offsets;
+  size_t totalSize = 0;
+  for (auto i = 0; i < inputVector->size(); ++i) {
+    offsets.push_back(totalSize);
+    totalSize += bits::roundUp(
+        UnsafeRowDynamicSerializer::getSizeRow(rowType, inputVector.get(), i),
+        8);
+  }
+  auto rowBuffer = AlignedBuffer::allocate<char>(totalSize, pool_.get(), 0);
+  std::vector<const char*> rows;
+  for (auto i = 0; i < inputVector->size(); ++i) {
+    char* row = rowBuffer->asMutable<char>() + offsets[i];
+    UnsafeRowDynamicSerializer::serialize(rowType, inputVector, row, i);
+    rows.push_back(row);
+  }
+
+  auto outputVector =
+      UnsafeRow24Deserializer::Create(rowType)->DeserializeRows(
+          pool_.get(), rows);
+  assertEqualVectors(inputVector, outputVector);
+
+  folly::CPUThreadPoolExecutor executor(4);
+  outputVector = UnsafeRow24Deserializer::Create(rowType, &executor, 100)
+                     ->DeserializeRows(pool_.get(), rows);
+  assertEqualVectors(inputVector, outputVector);
+}
+
 } // namespace
 } // namespace facebook::velox::row
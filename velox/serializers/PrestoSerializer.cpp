@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 #include "velox/serializers/PrestoSerializer.h"
+#include <folly/Random.h>
 #include "velox/common/base/Crc.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
 #include "velox/type/Date.h"
@@ -30,6 +32,7 @@ constexpr int8_t kCompressedBitMask = 1;
 constexpr int8_t kEncryptedBitMask = 2;
 constexpr int8_t kCheckSumBitMask = 4;
 constexpr folly::StringPiece kRLE{"RLE"};
+constexpr folly::StringPiece kDictionary{"DICTIONARY"};
 
 int64_t computeChecksum(
     PrestoOutputStreamListener* listener,
@@ -47,11 +50,12 @@ int64_t computeChecksum(
     ByteStream* source,
     int codecMarker,
     int numRows,
-    int uncompressedSize) {
+    int uncompressedSize,
+    int sizeInBytes) {
   auto offset = source->tellp();
   bits::Crc32 crc32;
 
-  auto remainingBytes = uncompressedSize;
+  auto remainingBytes = sizeInBytes;
   while (remainingBytes > 0) {
     auto data = source->nextView(remainingBytes);
     crc32.process_bytes(data.data(), data.size());
@@ -129,17 +133,20 @@ std::string typeToEncodingName(const TypePtr& type) {
   }
 }
 
+// Reads the values of the 'size' rows from 'offset' into 'values'.
 template <typename T>
 void readValues(
     ByteStream* source,
+    vector_size_t offset,
     vector_size_t size,
     BufferPtr nulls,
     vector_size_t nullCount,
     BufferPtr values) {
+  const vector_size_t end = offset + size;
   if (nullCount) {
     auto rawValues = values->asMutable<T>();
-    int32_t toClear = 0;
-    bits::forEachSetBit(nulls->as<uint64_t>(), 0, size, [&](int32_t row) {
+    int32_t toClear = offset;
+    bits::forEachSetBit(nulls->as<uint64_t>(), offset, end, [&](int32_t row) {
       // Set the values between the last non-null and this to type default.
       for (; toClear < row; ++toClear) {
         rawValues[toClear] = T();
@@ -148,21 +155,23 @@ void readValues(
       toClear = row + 1;
     });
   } else {
-    source->readBytes(values->asMutable<uint8_t>(), size * sizeof(T));
+    source->readBytes(values->asMutable<T>() + offset, size * sizeof(T));
   }
 }
 
 template <>
 void readValues<bool>(
     ByteStream* source,
+    vector_size_t offset,
     vector_size_t size,
     BufferPtr nulls,
     vector_size_t nullCount,
     BufferPtr values) {
+  const vector_size_t end = offset + size;
   auto rawValues = values->asMutable<uint64_t>();
   if (nullCount) {
-    int32_t toClear = 0;
-    bits::forEachSetBit(nulls->as<uint64_t>(), 0, size, [&](int32_t row) {
+    int32_t toClear = offset;
+    bits::forEachSetBit(nulls->as<uint64_t>(), offset, end, [&](int32_t row) {
       // Set the values between the last non-null and this to type default.
       for (; toClear < row; ++toClear) {
         bits::clearBit(rawValues, toClear);
@@ -171,7 +180,7 @@ void readValues<bool>(
       toClear = row + 1;
     });
   } else {
-    for (int32_t row = 0; row < size; ++row) {
+    for (int32_t row = offset; row < end; ++row) {
       bits::setBit(rawValues, row, (source->read<int8_t>() != 0));
     }
   }
@@ -185,14 +194,16 @@ Timestamp readTimestamp(ByteStream* source) {
 template <>
 void readValues<Timestamp>(
     ByteStream* source,
+    vector_size_t offset,
     vector_size_t size,
     BufferPtr nulls,
     vector_size_t nullCount,
     BufferPtr values) {
+  const vector_size_t end = offset + size;
   auto rawValues = values->asMutable<Timestamp>();
   if (nullCount) {
-    int32_t toClear = 0;
-    bits::forEachSetBit(nulls->as<uint64_t>(), 0, size, [&](int32_t row) {
+    int32_t toClear = offset;
+    bits::forEachSetBit(nulls->as<uint64_t>(), offset, end, [&](int32_t row) {
       // Set the values between the last non-null and this to type default.
       for (; toClear < row; ++toClear) {
         rawValues[toClear] = Timestamp();
@@ -201,7 +212,7 @@ void readValues<Timestamp>(
       toClear = row + 1;
     });
   } else {
-    for (int32_t row = 0; row < size; ++row) {
+    for (int32_t row = offset; row < end; ++row) {
       rawValues[row] = readTimestamp(source);
     }
   }
@@ -214,14 +225,16 @@ Timestamp readLosslessTimestamp(ByteStream* source) {
 
 void readLosslessTimestampValues(
     ByteStream* source,
+    vector_size_t offset,
     vector_size_t size,
     BufferPtr nulls,
     vector_size_t nullCount,
     BufferPtr values) {
+  const vector_size_t end = offset + size;
   auto rawValues = values->asMutable<Timestamp>();
   if (nullCount > 0) {
-    int32_t toClear = 0;
-    bits::forEachSetBit(nulls->as<uint64_t>(), 0, size, [&](int32_t row) {
+    int32_t toClear = offset;
+    bits::forEachSetBit(nulls->as<uint64_t>(), offset, end, [&](int32_t row) {
       // Set the values between the last non-null and this to type default.
       for (; toClear < row; ++toClear) {
         rawValues[toClear] = Timestamp();
@@ -230,7 +243,7 @@ void readLosslessTimestampValues(
       toClear = row + 1;
     });
   } else {
-    for (int32_t row = 0; row < size; ++row) {
+    for (int32_t row = offset; row < end; ++row) {
       rawValues[row] = readLosslessTimestamp(source);
     }
   }
@@ -244,14 +257,16 @@ Date readDate(ByteStream* source) {
 template <>
 void readValues<Date>(
     ByteStream* source,
+    vector_size_t offset,
     vector_size_t size,
     BufferPtr nulls,
     vector_size_t nullCount,
     BufferPtr values) {
+  const vector_size_t end = offset + size;
   auto rawValues = values->asMutable<Date>();
   if (nullCount) {
-    int32_t toClear = 0;
-    bits::forEachSetBit(nulls->as<uint64_t>(), 0, size, [&](int32_t row) {
+    int32_t toClear = offset;
+    bits::forEachSetBit(nulls->as<uint64_t>(), offset, end, [&](int32_t row) {
       // Set the values between the last non-null and this to type default.
       for (; toClear < row; ++toClear) {
         rawValues[toClear] = Date();
@@ -260,7 +275,7 @@ void readValues<Date>(
       toClear = row + 1;
     });
   } else {
-    for (int32_t row = 0; row < size; ++row) {
+    for (int32_t row = offset; row < end; ++row) {
       rawValues[row] = readDate(source);
     }
   }
@@ -273,14 +288,16 @@ IntervalDayTime readIntervalDayTime(ByteStream* source) {
 template <>
 void readValues<IntervalDayTime>(
     ByteStream* source,
+    vector_size_t offset,
     vector_size_t size,
     BufferPtr nulls,
     vector_size_t nullCount,
     BufferPtr values) {
+  const vector_size_t end = offset + size;
   auto rawValues = values->asMutable<IntervalDayTime>();
   if (nullCount) {
-    int32_t toClear = 0;
-    bits::forEachSetBit(nulls->as<uint64_t>(), 0, size, [&](int32_t row) {
+    int32_t toClear = offset;
+    bits::forEachSetBit(nulls->as<uint64_t>(), offset, end, [&](int32_t row) {
       // Set the values between the last non-null and this to type default.
       for (; toClear < row; ++toClear) {
         rawValues[toClear] = IntervalDayTime();
@@ -289,7 +306,7 @@ void readValues<IntervalDayTime>(
       toClear = row + 1;
     });
   } else {
-    for (int32_t row = 0; row < size; ++row) {
+    for (int32_t row = offset; row < end; ++row) {
       rawValues[row] = readIntervalDayTime(source);
     }
   }
@@ -313,14 +330,16 @@ UnscaledLongDecimal readUnscaledLongDecimal(ByteStream* source) {
 template <>
 void readValues<UnscaledLongDecimal>(
     ByteStream* source,
+    vector_size_t offset,
     vector_size_t size,
     BufferPtr nulls,
     vector_size_t nullCount,
     BufferPtr values) {
+  const vector_size_t end = offset + size;
   auto rawValues = values->asMutable<UnscaledLongDecimal>();
   if (nullCount) {
-    int32_t toClear = 0;
-    bits::forEachSetBit(nulls->as<uint64_t>(), 0, size, [&](int32_t row) {
+    int32_t toClear = offset;
+    bits::forEachSetBit(nulls->as<uint64_t>(), offset, end, [&](int32_t row) {
       // Set the values between the last non-null and this to type default.
       for (; toClear < row; ++toClear) {
         rawValues[toClear] = UnscaledLongDecimal();
@@ -329,58 +348,159 @@ void readValues<UnscaledLongDecimal>(
       toClear = row + 1;
     });
   } else {
-    for (int32_t row = 0; row < size; ++row) {
+    for (int32_t row = offset; row < end; ++row) {
       rawValues[row] = readUnscaledLongDecimal(source);
     }
   }
 }
 
-vector_size_t
-readNulls(ByteStream* source, vector_size_t size, BaseVector* result) {
+// Reads the nulls of 'size' rows into the rows from 'resultOffset' of
+// 'result'. Returns the number of nulls that are read.
+vector_size_t readNulls(
+    ByteStream* source,
+    vector_size_t size,
+    BaseVector* result,
+    vector_size_t resultOffset = 0) {
   if (source->readByte() == 0) {
-    result->clearNulls(0, size);
-    result->setNullCount(0);
+    if (resultOffset == 0) {
+      result->clearNulls(0, size);
+      result->setNullCount(0);
+    }
+    // Otherwise resizing 'result' cleared the nulls of the new rows.
     return 0;
   }
 
-  BufferPtr nulls = result->mutableNulls(size);
+  BufferPtr nulls = result->mutableNulls(resultOffset + size);
   auto rawNulls = nulls->asMutable<uint8_t>();
   auto numBytes = BaseVector::byteSize<bool>(size);
-
-  source->readBytes(rawNulls, numBytes);
-  bits::reverseBits(rawNulls, numBytes);
-  bits::negate(reinterpret_cast<char*>(rawNulls), numBytes * 8);
-  vector_size_t nullCount = nulls ? BaseVector::countNulls(nulls, 0, size) : 0;
-  result->setNullCount(nullCount);
+  if (resultOffset == 0) {
+    source->readBytes(rawNulls, numBytes);
+    bits::reverseBits(rawNulls, numBytes);
+    bits::negate(reinterpret_cast<char*>(rawNulls), numBytes * 8);
+    vector_size_t nullCount = BaseVector::countNulls(nulls, 0, size);
+    result->setNullCount(nullCount);
+    return nullCount;
+  }
+
+  // The nulls of the page are not aligned on a byte of 'result'.
+  std::vector<uint64_t> pageNulls(bits::nwords(size));
+  auto rawPageNulls = reinterpret_cast<uint8_t*>(pageNulls.data());
+  source->readBytes(rawPageNulls, numBytes);
+  bits::reverseBits(rawPageNulls, numBytes);
+  bits::negate(reinterpret_cast<char*>(rawPageNulls), numBytes * 8);
+  bits::copyBits(
+      pageNulls.data(),
+      0,
+      nulls->asMutable<uint64_t>(),
+      resultOffset,
+      size);
+  vector_size_t nullCount = bits::countNulls(pageNulls.data(), 0, size);
+  auto previousNullCount = result->getNullCount();
+  if (previousNullCount.has_value()) {
+    result->setNullCount(previousNullCount.value() + nullCount);
+  }
   return nullCount;
 }
 
+// Keeps the memory of a page alive for the values that are read in place.
+struct PageReleaser {
+  void addRef() const {}
+
+  void release() const {}
+
+  const std::shared_ptr<void> owner;
+};
+
+// True if the values of a flat vector of T have the same layout in a page.
+template <typename T>
+constexpr bool isInPlaceReadable() {
+  return std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> ||
+      std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+      std::is_same_v<T, float> || std::is_same_v<T, double>;
+}
+
+// Returns a BufferView over the 'size' values at the position of 'source'
+// and skips them if 'source' has an owner for its memory and the values are
+// contiguous and aligned. Returns nullptr and does not skip otherwise. The
+// page then stays allocated, and tracked against its pool, for as long as
+// the values are referenced.
+template <typename T>
+BufferPtr readValuesInPlace(ByteStream* source, vector_size_t size) {
+  if (!source->inputOwner()) {
+    return nullptr;
+  }
+  // The padding makes SIMD reads past the last value safe like for an
+  // AlignedBuffer.
+  auto data =
+      source->nextContiguous(size * sizeof(T), alignof(T), simd::kPadding);
+  if (data == nullptr) {
+    return nullptr;
+  }
+  return BufferView<PageReleaser>::create(
+      data, size * sizeof(T), PageReleaser{source->inputOwner()});
+}
+
+// True if the rows of a flat column can be read into 'column' after its
+// rows. 'column' must then be a uniquely referenced flat vector whose buffers
+// can be written.
+bool canReadAfter(const VectorPtr& column) {
+  return column && column.unique() &&
+      column->encoding() == VectorEncoding::Simple::FLAT &&
+      (!column->values() || column->values()->isMutable()) &&
+      (!column->nulls() || column->nulls()->isMutable());
+}
+
 template <typename T>
 void read(
     ByteStream* source,
     std::shared_ptr<const Type> type,
     velox::memory::MemoryPool* pool,
     VectorPtr* result,
+    vector_size_t resultOffset,
     bool useLosslessTimestamp) {
   int32_t size = source->read<int32_t>();
-  if (*result && result->unique()) {
+  // A vector whose values are read in place is not reused, since the memory
+  // belongs to another page. readColumns() checks that the vector of rows
+  // that are read after its rows can be written.
+  if (resultOffset > 0) {
+    VELOX_DCHECK(canReadAfter(*result));
+    (*result)->resize(resultOffset + size);
+  } else if (
+      *result && result->unique() &&
+      (!(*result)->values() || (*result)->values()->isMutable())) {
     (*result)->resize(size);
   } else {
     *result = BaseVector::create(type, size, pool);
   }
 
   auto flatResult = (*result)->asFlatVector<T>();
-  auto nullCount = readNulls(source, size, flatResult);
+  auto nullCount = readNulls(source, size, flatResult, resultOffset);
+
+  if constexpr (isInPlaceReadable<T>()) {
+    if (nullCount == 0 && resultOffset == 0) {
+      if (auto values = readValuesInPlace<T>(source, size)) {
+        *result = std::make_shared<FlatVector<T>>(
+            pool,
+            type,
+            BufferPtr(nullptr),
+            size,
+            std::move(values),
+            std::vector<BufferPtr>{});
+        return;
+      }
+    }
+  }
 
-  BufferPtr values = flatResult->mutableValues(size);
+  BufferPtr values = flatResult->mutableValues(resultOffset + size);
   if constexpr (std::is_same_v<T, Timestamp>) {
     if (useLosslessTimestamp) {
       readLosslessTimestampValues(
-          source, size, flatResult->nulls(), nullCount, values);
+          source, resultOffset, size, flatResult->nulls(), nullCount, values);
       return;
     }
   }
-  readValues<T>(source, size, flatResult->nulls(), nullCount, values);
+  readValues<T>(
+      source, resultOffset, size, flatResult->nulls(), nullCount, values);
 }
 
 BufferPtr findOrAllocateStringBuffer(
@@ -408,28 +528,39 @@ void read<StringView>(
     std::shared_ptr<const Type> type,
     velox::memory::MemoryPool* pool,
     VectorPtr* result,
+    vector_size_t resultOffset,
     bool useLosslessTimestamp) {
   int32_t size = source->read<int32_t>();
 
-  if (*result && result->unique()) {
+  if (resultOffset > 0) {
+    VELOX_DCHECK(canReadAfter(*result));
+    (*result)->resize(resultOffset + size);
+  } else if (*result && result->unique()) {
     (*result)->resize(size);
   } else {
     *result = BaseVector::create(type, size, pool);
   }
 
   auto flatResult = (*result)->as<FlatVector<StringView>>();
-  BufferPtr values = flatResult->mutableValues(size);
-  auto rawValues = values->asMutable<StringView>();
+  BufferPtr values = flatResult->mutableValues(resultOffset + size);
+  auto rawValues = values->asMutable<StringView>() + resultOffset;
   for (int32_t i = 0; i < size; ++i) {
     // Set the first int32_t of each StringView to be the offset.
     *reinterpret_cast<int32_t*>(&rawValues[i]) = source->read<int32_t>();
   }
-  readNulls(source, size, flatResult);
+  readNulls(source, size, flatResult, resultOffset);
 
   int32_t dataSize = source->read<int32_t>();
-  const auto& stringBuffers = flatResult->stringBuffers();
-  BufferPtr strings = findOrAllocateStringBuffer(dataSize, stringBuffers, pool);
-  flatResult->setStringBuffers({strings});
+  BufferPtr strings;
+  if (resultOffset > 0) {
+    // The rows before 'resultOffset' keep referencing their buffers.
+    strings = AlignedBuffer::allocate<char>(dataSize, pool);
+    flatResult->addStringBuffer(strings);
+  } else {
+    strings = findOrAllocateStringBuffer(
+        dataSize, flatResult->stringBuffers(), pool);
+    flatResult->setStringBuffers({strings});
+  }
   auto rawStrings = strings->asMutable<uint8_t>();
 
   source->readBytes(rawStrings, dataSize);
@@ -443,12 +574,16 @@ void read<StringView>(
   }
 }
 
+// Reads a column of each of 'types' into 'result'. If 'resultOffset' is
+// not 0, the rows are read after the first 'resultOffset' rows of the
+// vectors of 'result', which are kept.
 void readColumns(
     ByteStream* source,
     velox::memory::MemoryPool* pool,
     const std::vector<TypePtr>& types,
     std::vector<VectorPtr>* result,
-    bool useLosslessTimestamp);
+    bool useLosslessTimestamp,
+    vector_size_t resultOffset = 0);
 
 void readConstantVector(
     ByteStream* source,
@@ -464,12 +599,34 @@ void readConstantVector(
   *result = BaseVector::wrapInConstant(size, 0, children[0]);
 }
 
+void readDictionaryVector(
+    ByteStream* source,
+    const TypePtr& type,
+    velox::memory::MemoryPool* pool,
+    VectorPtr* result,
+    bool useLosslessTimestamp) {
+  auto size = source->read<int32_t>();
+  std::vector<TypePtr> childTypes = {type};
+  std::vector<VectorPtr> children(1);
+  readColumns(source, pool, childTypes, &children, useLosslessTimestamp);
+  auto indices = AlignedBuffer::allocate<vector_size_t>(size, pool);
+  source->readBytes(
+      indices->asMutable<uint8_t>(), size * sizeof(vector_size_t));
+  // Skip the dictionary id, which identifies the dictionaries Presto can
+  // process once for all the blocks that use them.
+  source->skip(3 * sizeof(int64_t));
+  *result = BaseVector::wrapInDictionary(
+      BufferPtr(nullptr), std::move(indices), size, children[0]);
+}
+
 void readArrayVector(
     ByteStream* source,
     std::shared_ptr<const Type> type,
     velox::memory::MemoryPool* pool,
     VectorPtr* result,
+    vector_size_t resultOffset,
     bool useLosslessTimestamp) {
+  VELOX_DCHECK_EQ(0, resultOffset);
   ArrayVector* arrayVector =
       (*result && result->unique()) ? (*result)->as<ArrayVector>() : nullptr;
   std::vector<TypePtr> childTypes = {type->childAt(0)};
@@ -524,7 +681,9 @@ void readMapVector(
     std::shared_ptr<const Type> type,
     velox::memory::MemoryPool* pool,
     VectorPtr* result,
+    vector_size_t resultOffset,
     bool useLosslessTimestamp) {
+  VELOX_DCHECK_EQ(0, resultOffset);
   MapVector* mapVector =
       (*result && result->unique()) ? (*result)->as<MapVector>() : nullptr;
   std::vector<TypePtr> childTypes = {type->childAt(0), type->childAt(1)};
@@ -582,7 +741,7 @@ void readTimestampWithTimeZone(
     velox::memory::MemoryPool* pool,
     VectorPtr* result) {
   VectorPtr timestamps;
-  read<int64_t>(source, BIGINT(), pool, &timestamps, false);
+  read<int64_t>(source, BIGINT(), pool, &timestamps, 0, false);
 
   auto rawTimestamps = timestamps->asFlatVector<int64_t>()->mutableRawValues();
 
@@ -612,7 +771,9 @@ void readRowVector(
     std::shared_ptr<const Type> type,
     velox::memory::MemoryPool* pool,
     VectorPtr* result,
+    vector_size_t resultOffset,
     bool useLosslessTimestamp) {
+  VELOX_DCHECK_EQ(0, resultOffset);
   if (isTimestampWithTimeZoneType(type)) {
     readTimestampWithTimeZone(source, pool, result);
     return;
@@ -715,11 +876,39 @@ void checkTypeEncoding(std::string encoding, TypePtr type) {
       encoding);
 }
 
-void readColumns(
+// Copies the rows of 'rows' after the first 'offset' rows of '*column'.
+void appendRows(
+    const VectorPtr& rows,
+    vector_size_t offset,
+    velox::memory::MemoryPool* pool,
+    VectorPtr* column) {
+  const auto size = offset + rows->size();
+  auto encoding = (*column)->encoding();
+  if (column->unique() &&
+      (encoding == VectorEncoding::Simple::ARRAY ||
+       encoding == VectorEncoding::Simple::MAP ||
+       encoding == VectorEncoding::Simple::ROW || canReadAfter(*column))) {
+    (*column)->resize(size);
+    (*column)->copy(rows.get(), offset, 0, rows->size());
+    return;
+  }
+  // A constant or dictionary column, or one that references another page,
+  // is flattened.
+  auto flat = BaseVector::create(rows->type(), size, pool);
+  flat->copy(column->get(), 0, 0, offset);
+  flat->copy(rows.get(), offset, 0, rows->size());
+  *column = std::move(flat);
+}
+
+// Reads a column of 'type' whose encoding name 'encoding' has been read from
+// 'source'. See readColumns() for 'resultOffset'.
+void readColumn(
     ByteStream* source,
     velox::memory::MemoryPool* pool,
-    const std::vector<TypePtr>& types,
-    std::vector<VectorPtr>* result,
+    const TypePtr& type,
+    const std::string& encoding,
+    VectorPtr* result,
+    vector_size_t resultOffset,
     bool useLosslessTimestamp) {
   static std::unordered_map<
       TypeKind,
@@ -728,6 +917,7 @@ void readColumns(
           std::shared_ptr<const Type> type,
           velox::memory::MemoryPool * pool,
           VectorPtr * result,
+          vector_size_t resultOffset,
           bool useLosslessTimestamp)>>
       readers = {
           {TypeKind::BOOLEAN, &read<bool>},
@@ -749,20 +939,82 @@ void readColumns(
           {TypeKind::ROW, &readRowVector},
           {TypeKind::UNKNOWN, &read<UnknownValue>}};
 
+  if (encoding == kRLE) {
+    readConstantVector(source, type, pool, result, useLosslessTimestamp);
+  } else if (encoding == kDictionary) {
+    readDictionaryVector(source, type, pool, result, useLosslessTimestamp);
+  } else {
+    // A vector read from an RLE or DICTIONARY column of a previous page
+    // is not reused for a flat column.
+    auto& column = *result;
+    if (column &&
+        (column->encoding() == VectorEncoding::Simple::CONSTANT ||
+         column->encoding() == VectorEncoding::Simple::DICTIONARY)) {
+      column = nullptr;
+    }
+    checkTypeEncoding(encoding, type);
+    auto it = readers.find(type->kind());
+    VELOX_CHECK(
+        it != readers.end(),
+        "Column reader for type {} is missing",
+        type->kindName());
+
+    it->second(source, type, pool, result, resultOffset, useLosslessTimestamp);
+  }
+}
+
+// Copies the rows of 'rows' after the first 'offset' rows of '*column'.
+void appendRows(
+    const VectorPtr& rows,
+    vector_size_t offset,
+    velox::memory::MemoryPool* pool,
+    VectorPtr* column) {
+  const auto size = offset + rows->size();
+  auto encoding = (*column)->encoding();
+  if (column->unique() &&
+      (encoding == VectorEncoding::Simple::ARRAY ||
+       encoding == VectorEncoding::Simple::MAP ||
+       encoding == VectorEncoding::Simple::ROW || canReadAfter(*column))) {
+    (*column)->resize(size);
+    (*column)->copy(rows.get(), offset, 0, rows->size());
+    return;
+  }
+  // A constant or dictionary column, or one that references another page,
+  // is flattened.
+  auto flat = BaseVector::create(rows->type(), size, pool);
+  flat->copy(column->get(), 0, 0, offset);
+  flat->copy(rows.get(), offset, 0, rows->size());
+  *column = std::move(flat);
+}
+
+void readColumns(
+    ByteStream* source,
+    velox::memory::MemoryPool* pool,
+    const std::vector<TypePtr>& types,
+    std::vector<VectorPtr>* result,
+    bool useLosslessTimestamp,
+    vector_size_t resultOffset) {
   for (int32_t i = 0; i < types.size(); ++i) {
     auto encoding = readLengthPrefixedString(source);
-    if (encoding == kRLE) {
-      readConstantVector(
-          source, types[i], pool, &(*result)[i], useLosslessTimestamp);
+    auto& column = (*result)[i];
+    if (resultOffset > 0 &&
+        (encoding == kRLE || encoding == kDictionary ||
+         !canReadAfter(column))) {
+      // The rows that can't be read after the rows of 'column' are read
+      // apart and copied.
+      VectorPtr rows;
+      readColumn(
+          source, pool, types[i], encoding, &rows, 0, useLosslessTimestamp);
+      appendRows(rows, resultOffset, pool, &column);
     } else {
-      checkTypeEncoding(encoding, types[i]);
-      auto it = readers.find(types[i]->kind());
-      VELOX_CHECK(
-          it != readers.end(),
-          "Column reader for type {} is missing",
-          types[i]->kindName());
-
-      it->second(source, types[i], pool, &(*result)[i], useLosslessTimestamp);
+      readColumn(
+          source,
+          pool,
+          types[i],
+          encoding,
+          &column,
+          resultOffset,
+          useLosslessTimestamp);
     }
   }
 }
@@ -787,6 +1039,7 @@ class VectorStream {
       int32_t initialNumRows,
       bool useLosslessTimestamp)
       : type_(type),
+        streamArena_(streamArena),
         useLosslessTimestamp_(useLosslessTimestamp),
         nulls_(streamArena, true, true),
         lengths_(streamArena),
@@ -877,8 +1130,31 @@ class VectorStream {
     return children_[index].get();
   }
 
+  // Appends the rows of 'ranges' of a top level column. A dictionary or
+  // constant column stays encoded for as long as all the appended vectors
+  // have the same dictionary or constant value and is otherwise flattened.
+  void appendColumn(
+      const VectorPtr& vector,
+      const folly::Range<const IndexRange*>& ranges);
+
   // Writes out the accumulated contents. Does not change the state.
   void flush(OutputStream* out) {
+    switch (encoding_) {
+      case Encoding::kDictionary:
+        // A dictionary that is not referenced by enough rows is larger
+        // than the flat values.
+        if (ids_.size() >= kMinRowsPerDictionaryEntry * encodedBase_->size()) {
+          flushDictionary(out);
+        } else {
+          flushFlattened(out);
+        }
+        return;
+      case Encoding::kConstant:
+        flushRle(out);
+        return;
+      default:
+        break;
+    }
     out->write(reinterpret_cast<char*>(header_.buffer), header_.size);
     switch (type_->kind()) {
       case TypeKind::ROW:
@@ -957,7 +1233,39 @@ class VectorStream {
   }
 
  private:
+  // The encoding of a top level column.
+  enum class Encoding {
+    // Nothing appended yet.
+    kNone,
+    kFlat,
+    // The rows are 'ids_' into 'encodedBase_'.
+    kDictionary,
+    // The rows are 'numConstantRows_' copies of 'encodedBase_'.
+    kConstant
+  };
+
+  // The minimum average number of rows per dictionary entry for writing a
+  // DICTIONARY column.
+  static constexpr int32_t kMinRowsPerDictionaryEntry = 2;
+
+  // Returns the encoding to keep for a top level column that starts with
+  // 'vector'. Only a dictionary that adds no nulls can be kept, since the
+  // nulls of a Presto dictionary block are those of its dictionary.
+  static Encoding initialEncoding(const BaseVector& vector);
+
+  // Serializes the rows appended to a dictionary or constant column into
+  // the flat streams of 'this'.
+  void flattenEncoded();
+
+  void flushDictionary(OutputStream* out);
+
+  void flushRle(OutputStream* out);
+
+  // Writes a dictionary column as a flat one.
+  void flushFlattened(OutputStream* out);
+
   const TypePtr type_;
+  StreamArena* const streamArena_;
   /// Indicates whether to serialize timestamps with nanosecond precision.
   /// If false, they are serialized with millisecond precision which is
   /// compatible with presto.
@@ -971,6 +1279,13 @@ class VectorStream {
   ByteStream lengths_;
   ByteStream values_;
   std::vector<std::unique_ptr<VectorStream>> children_;
+
+  Encoding encoding_{Encoding::kNone};
+  // The dictionary of a kDictionary column or the constant vector of a
+  // kConstant column.
+  VectorPtr encodedBase_;
+  std::vector<vector_size_t> ids_;
+  int32_t numConstantRows_{0};
 };
 
 template <>
@@ -1360,6 +1675,120 @@ void serializeColumn(
   }
 }
 
+// static
+VectorStream::Encoding VectorStream::initialEncoding(
+    const BaseVector& vector) {
+  switch (vector.encoding()) {
+    case VectorEncoding::Simple::CONSTANT:
+      return Encoding::kConstant;
+    case VectorEncoding::Simple::DICTIONARY:
+      return vector.rawNulls() ? Encoding::kFlat : Encoding::kDictionary;
+    default:
+      return Encoding::kFlat;
+  }
+}
+
+void VectorStream::appendColumn(
+    const VectorPtr& vector,
+    const folly::Range<const IndexRange*>& ranges) {
+  if (encoding_ == Encoding::kNone) {
+    encoding_ = initialEncoding(*vector);
+    if (encoding_ == Encoding::kDictionary) {
+      encodedBase_ = BaseVector::loadedVectorShared(vector->valueVector());
+    } else if (encoding_ == Encoding::kConstant) {
+      encodedBase_ = vector;
+    }
+  }
+  switch (encoding_) {
+    case Encoding::kDictionary:
+      if (vector->encoding() == VectorEncoding::Simple::DICTIONARY &&
+          !vector->rawNulls() &&
+          BaseVector::loadedVectorShared(vector->valueVector()) ==
+              encodedBase_) {
+        auto indices = vector->wrapInfo()->as<vector_size_t>();
+        for (const auto& range : ranges) {
+          ids_.insert(
+              ids_.end(),
+              indices + range.begin,
+              indices + range.begin + range.size);
+        }
+        return;
+      }
+      flattenEncoded();
+      break;
+    case Encoding::kConstant:
+      if (vector->isConstantEncoding() &&
+          encodedBase_->equalValueAt(vector.get(), 0, 0)) {
+        numConstantRows_ += rangesTotalSize(ranges);
+        return;
+      }
+      flattenEncoded();
+      break;
+    default:
+      break;
+  }
+  serializeColumn(vector.get(), ranges, this);
+}
+
+void VectorStream::flattenEncoded() {
+  if (encoding_ == Encoding::kDictionary) {
+    std::vector<IndexRange> ranges;
+    ranges.reserve(ids_.size());
+    for (auto id : ids_) {
+      ranges.push_back(IndexRange{id, 1});
+    }
+    serializeColumn(encodedBase_.get(), ranges, this);
+    ids_.clear();
+  } else if (encoding_ == Encoding::kConstant && numConstantRows_ > 0) {
+    auto constant =
+        BaseVector::wrapInConstant(numConstantRows_, 0, encodedBase_);
+    IndexRange range{0, numConstantRows_};
+    serializeColumn(constant.get(), folly::Range(&range, 1), this);
+    numConstantRows_ = 0;
+  }
+  encodedBase_ = nullptr;
+  encoding_ = Encoding::kFlat;
+}
+
+void VectorStream::flushDictionary(OutputStream* out) {
+  writeInt32(out, kDictionary.size());
+  out->write(kDictionary.data(), kDictionary.size());
+  writeInt32(out, ids_.size());
+  const vector_size_t dictionarySize = encodedBase_->size();
+  VectorStream dictionary(
+      type_, streamArena_, dictionarySize, useLosslessTimestamp_);
+  IndexRange range{0, dictionarySize};
+  serializeColumn(encodedBase_.get(), folly::Range(&range, 1), &dictionary);
+  dictionary.flush(out);
+  out->write(
+      reinterpret_cast<const char*>(ids_.data()),
+      ids_.size() * sizeof(vector_size_t));
+  // A random dictionary id, so that Presto does not take dictionaries of
+  // different pages for the same one.
+  writeInt64(out, folly::Random::rand64());
+  writeInt64(out, folly::Random::rand64());
+  writeInt64(out, 0);
+}
+
+void VectorStream::flushRle(OutputStream* out) {
+  writeInt32(out, kRLE.size());
+  out->write(kRLE.data(), kRLE.size());
+  writeInt32(out, numConstantRows_);
+  VectorStream value(type_, streamArena_, 1, useLosslessTimestamp_);
+  IndexRange range{0, 1};
+  serializeColumn(encodedBase_.get(), folly::Range(&range, 1), &value);
+  value.flush(out);
+}
+
+void VectorStream::flushFlattened(OutputStream* out) {
+  VectorStream flat(type_, streamArena_, ids_.size(), useLosslessTimestamp_);
+  flat.encodedBase_ = encodedBase_;
+  flat.ids_ = ids_;
+  flat.encoding_ = Encoding::kDictionary;
+  flat.flattenEncoded();
+  flat.flush(out);
+}
+
 void expandRepeatedRanges(
     const BaseVector* vector,
     const vector_size_t* rawOffsets,
@@ -1627,7 +2056,15 @@ class PrestoVectorSerializer : public VectorSerializer {
       std::shared_ptr<const RowType> rowType,
       int32_t numRows,
       StreamArena* streamArena,
-      bool useLosslessTimestamp) {
+      bool useLosslessTimestamp,
+      folly::io::CodecType compressionKind,
+      float minCompressionRatio)
+      : streamArena_(streamArena),
+        codec_(
+            compressionKind == folly::io::CodecType::NO_COMPRESSION
+                ? nullptr
+                : folly::io::getCodec(compressionKind)),
+        minCompressionRatio_(minCompressionRatio) {
     auto types = rowType->children();
     auto numTypes = types.size();
     streams_.resize(numTypes);
@@ -1644,7 +2081,7 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (newRows > 0) {
       numRows_ += newRows;
       for (int32_t i = 0; i < vector->childrenSize(); ++i) {
-        serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
+        streams_[i]->appendColumn(vector->childAt(i), ranges);
       }
     }
   }
@@ -1659,14 +2096,26 @@ class PrestoVectorSerializer : public VectorSerializer {
       VELOX_CHECK(child->isConstantEncoding());
     }
 
+    // The RLE marker is written for the page, so the columns are written
+    // with their single value.
     std::vector<IndexRange> ranges{{0, 1}};
-    append(vector, folly::Range(ranges.data(), ranges.size()));
+    ++numRows_;
+    for (int32_t i = 0; i < vector->childrenSize(); ++i) {
+      serializeColumn(
+          vector->childAt(i).get(),
+          folly::Range(ranges.data(), ranges.size()),
+          streams_[i].get());
+    }
 
     flushInternal(vector->size(), true /*rle*/, out);
   }
 
   // Writes the contents to 'stream' in wire format
   void flushInternal(int32_t numRows, bool rle, OutputStream* out) {
+    if (codec_ != nullptr) {
+      flushCompressed(numRows, rle, out);
+      return;
+    }
     auto listener = dynamic_cast<PrestoOutputStreamListener*>(out->listener());
     // Reset CRC computation
     if (listener) {
@@ -1697,6 +2146,31 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (listener) {
       listener->resume();
     }
+    flushColumns(numRows, rle, out);
+
+    // Pause CRC computation
+    if (listener) {
+      listener->pause();
+    }
+
+    // Fill in uncompressedSizeInBytes & sizeInBytes
+    int32_t size = (int32_t)out->tellp() - offset;
+    int32_t uncompressedSize = size - kHeaderSize;
+    int64_t crc = 0;
+    if (listener) {
+      crc = computeChecksum(listener, codec, numRows, uncompressedSize);
+    }
+
+    out->seekp(offset + kSizeInBytesOffset);
+    writeInt32(out, uncompressedSize);
+    writeInt32(out, uncompressedSize);
+    writeInt64(out, crc);
+    out->seekp(offset + size);
+  }
+
+ private:
+  // Writes the number of columns and the columns.
+  void flushColumns(int32_t numRows, bool rle, OutputStream* out) {
     writeInt32(out, streams_.size());
 
     if (rle) {
@@ -1710,31 +2184,61 @@ class PrestoVectorSerializer : public VectorSerializer {
     for (auto& stream : streams_) {
       stream->flush(out);
     }
+  }
 
-    // Pause CRC computation
+  // Writes the page with the columns compressed by 'codec_'. Like Presto,
+  // writes the columns uncompressed and without the compressed bit if they
+  // do not compress to at most 'minCompressionRatio_' of their size.
+  void flushCompressed(int32_t numRows, bool rle, OutputStream* out) {
+    IOBufOutputStream columns(*streamArena_->mappedMemory());
+    flushColumns(numRows, rle, &columns);
+    auto uncompressed = columns.getIOBuf();
+    const int32_t uncompressedSize = uncompressed->computeChainDataLength();
+    auto compressed = codec_->compress(uncompressed.get());
+    const bool useCompressed = compressed->computeChainDataLength() <=
+        uncompressedSize * minCompressionRatio_;
+    const auto& page = useCompressed ? compressed : uncompressed;
+    const int32_t sizeInBytes = page->computeChainDataLength();
+
+    auto listener = dynamic_cast<PrestoOutputStreamListener*>(out->listener());
+    char codec = 0;
+    int64_t crc = 0;
     if (listener) {
+      // The checksum is computed here and not by 'listener'.
+      listener->reset();
       listener->pause();
+      codec = getCodecMarker();
+    }
+    if (useCompressed) {
+      codec |= kCompressedBitMask;
     }
-
-    // Fill in uncompressedSizeInBytes & sizeInBytes
-    int32_t size = (int32_t)out->tellp() - offset;
-    int32_t uncompressedSize = size - kHeaderSize;
-    int64_t crc = 0;
     if (listener) {
-      crc = computeChecksum(listener, codec, numRows, uncompressedSize);
+      bits::Crc32 crc32;
+      for (auto range : *page) {
+        crc32.process_bytes(range.data(), range.size());
+      }
+      crc32.process_bytes(&codec, 1);
+      crc32.process_bytes(&numRows, 4);
+      crc32.process_bytes(&uncompressedSize, 4);
+      crc = crc32.checksum();
     }
 
-    out->seekp(offset + kSizeInBytesOffset);
-    writeInt32(out, uncompressedSize);
+    writeInt32(out, numRows);
+    out->write(&codec, 1);
     writeInt32(out, uncompressedSize);
+    writeInt32(out, sizeInBytes);
     writeInt64(out, crc);
-    out->seekp(offset + size);
+    for (auto range : *page) {
+      out->write(reinterpret_cast<const char*>(range.data()), range.size());
+    }
   }
 
- private:
   static const int32_t kSizeInBytesOffset{4 + 1};
   static const int32_t kHeaderSize{kSizeInBytesOffset + 4 + 4 + 8};
 
+  StreamArena* const streamArena_;
+  const std::unique_ptr<folly::io::Codec> codec_;
+  const float minCompressionRatio_;
   int32_t numRows_{0};
   std::vector<std::unique_ptr<VectorStream>> streams_;
 };
@@ -1752,11 +2256,17 @@ std::unique_ptr<VectorSerializer> PrestoVectorSerde::createSerializer(
     int32_t numRows,
     StreamArena* streamArena,
     const Options* options) {
-  bool useLosslessTimestamp = options != nullptr
-      ? static_cast<const PrestoOptions*>(options)->useLosslessTimestamp
-      : false;
+  const PrestoOptions defaultOptions(false);
+  const auto& prestoOptions = options != nullptr
+      ? *static_cast<const PrestoOptions*>(options)
+      : defaultOptions;
   return std::make_unique<PrestoVectorSerializer>(
-      type, numRows, streamArena, useLosslessTimestamp);
+      type,
+      numRows,
+      streamArena,
+      prestoOptions.useLosslessTimestamp,
+      prestoOptions.compressionKind,
+      prestoOptions.minCompressionRatio);
 }
 
 void PrestoVectorSerde::serializeConstants(
@@ -1776,11 +2286,31 @@ void PrestoVectorSerde::deserialize(
     std::shared_ptr<const RowType> type,
     std::shared_ptr<RowVector>* result,
     const Options* options) {
+  deserialize(source, pool, type, result, 0, options);
+}
+
+void PrestoVectorSerde::deserialize(
+    ByteStream* source,
+    velox::memory::MemoryPool* pool,
+    std::shared_ptr<const RowType> type,
+    std::shared_ptr<RowVector>* result,
+    vector_size_t resultOffset,
+    const Options* options) {
   bool useLosslessTimestamp = options != nullptr
       ? static_cast<const PrestoOptions*>(options)->useLosslessTimestamp
       : false;
+  auto compressionKind = options != nullptr
+      ? static_cast<const PrestoOptions*>(options)->compressionKind
+      : folly::io::CodecType::NO_COMPRESSION;
   auto numRows = source->read<int32_t>();
-  if (!(*result) || !result->unique() || (*result)->type() != type) {
+  if (resultOffset > 0) {
+    VELOX_CHECK(
+        *result && result->unique() && (*result)->type() == type,
+        "Rows of a page can only be appended to a uniquely referenced "
+        "vector of the page type");
+    VELOX_CHECK_EQ(resultOffset, (*result)->size());
+    (*result)->resize(resultOffset + numRows);
+  } else if (!(*result) || !result->unique() || (*result)->type() != type) {
     *result = std::dynamic_pointer_cast<RowVector>(
         BaseVector::create(type, numRows, pool));
   } else {
@@ -1789,25 +2319,51 @@ void PrestoVectorSerde::deserialize(
 
   auto pageCodecMarker = source->read<int8_t>();
   auto uncompressedSize = source->read<int32_t>();
-  // skip size in bytes
-  source->skip(4);
+  auto sizeInBytes = source->read<int32_t>();
   auto checksum = source->read<int64_t>();
 
   int64_t actualCheckSum = 0;
   if (isChecksumBitSet(pageCodecMarker)) {
-    actualCheckSum =
-        computeChecksum(source, pageCodecMarker, numRows, uncompressedSize);
+    actualCheckSum = computeChecksum(
+        source, pageCodecMarker, numRows, uncompressedSize, sizeInBytes);
   }
 
   VELOX_CHECK_EQ(
       checksum, actualCheckSum, "Received corrupted serialized page.");
 
-  // skip number of columns
-  source->skip(4);
-
   auto children = &(*result)->children();
   auto childTypes = type->as<TypeKind::ROW>().children();
-  readColumns(source, pool, childTypes, children, useLosslessTimestamp);
+  if (!isCompressedBitSet(pageCodecMarker)) {
+    // skip number of columns
+    source->skip(4);
+    readColumns(
+        source, pool, childTypes, children, useLosslessTimestamp, resultOffset);
+    return;
+  }
+
+  VELOX_CHECK(
+      compressionKind != folly::io::CodecType::NO_COMPRESSION,
+      "Received a compressed page but no compression codec is set");
+  auto compressed = folly::IOBuf::create(sizeInBytes);
+  source->readBytes(compressed->writableData(), sizeInBytes);
+  compressed->append(sizeInBytes);
+  auto uncompressed = folly::io::getCodec(compressionKind)
+                          ->uncompress(compressed.get(), uncompressedSize);
+  uncompressed->coalesce();
+  ByteStream uncompressedSource;
+  uncompressedSource.setRange(
+      {uncompressed->writableData(),
+       static_cast<int32_t>(uncompressed->length()),
+       0});
+  // skip number of columns
+  uncompressedSource.skip(4);
+  readColumns(
+      &uncompressedSource,
+      pool,
+      childTypes,
+      children,
+      useLosslessTimestamp,
+      resultOffset);
 }
 
 // static
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #pragma once
+#include <folly/compression/Compression.h>
 #include "velox/common/base/Crc.h"
 #include "velox/vector/VectorStream.h"
 
@@ -22,13 +23,24 @@ class PrestoVectorSerde : public VectorSerde {
  public:
   // Input options that the serializer recognizes.
   struct PrestoOptions : VectorSerde::Options {
-    explicit PrestoOptions(bool useLosslessTimestamp)
-        : useLosslessTimestamp(useLosslessTimestamp) {}
+    explicit PrestoOptions(
+        bool useLosslessTimestamp,
+        folly::io::CodecType compressionKind =
+            folly::io::CodecType::NO_COMPRESSION)
+        : useLosslessTimestamp(useLosslessTimestamp),
+          compressionKind(compressionKind) {}
     // Currently presto only supports millisecond precision and the serializer
     // converts velox native timestamp to that resulting in loss of precision.
     // This option allows it to serialize with nanosecond precision and is
     // currently used for spilling. Is false by default.
     bool useLosslessTimestamp{false};
+
+    // Codec for compressing pages. The codec is not in the page, so the
+    // reader must use the same codec. Presto reads LZ4 and ZSTD. A page
+    // that does not compress to at most 'minCompressionRatio' of its size
+    // is written uncompressed.
+    folly::io::CodecType compressionKind{folly::io::CodecType::NO_COMPRESSION};
+    float minCompressionRatio{0.8};
   };
 
   void estimateSerializedSize(
@@ -56,6 +68,17 @@ class PrestoVectorSerde : public VectorSerde {
       std::shared_ptr<RowVector>* result,
       const Options* options) override;
 
+  /// Reads the flat columns of fixed-width and string types of the page
+  /// directly after the rows of '*result'. The other columns are read apart
+  /// and copied.
+  void deserialize(
+      ByteStream* source,
+      velox::memory::MemoryPool* pool,
+      std::shared_ptr<const RowType> type,
+      std::shared_ptr<RowVector>* result,
+      vector_size_t resultOffset,
+      const Options* options) override;
+
   static void registerVectorSerde();
 };
 
@@ -16,6 +16,7 @@
 #include "velox/serializers/UnsafeRowSerializer.h"
 #include "velox/row/UnsafeRowDeserializer.h"
 #include "velox/row/UnsafeRowDynamicSerializer.h"
+#include "velox/row/UnsafeRowFixedWidthBatchSerializer.h"
 
 namespace facebook::velox::serializer::spark {
 
@@ -35,6 +36,14 @@ class UnsafeRowVectorSerializer : public VectorSerializer {
   void append(
       RowVectorPtr vector,
       const folly::Range<const IndexRange*>& ranges) override {
+    using velox::row::UnsafeRowFixedWidthBatchSerializer;
+    const auto& rowType = vector->type()->asRow();
+    if (!vector->mayHaveNulls() &&
+        UnsafeRowFixedWidthBatchSerializer::supports(rowType)) {
+      appendFixedWidth(*vector, ranges);
+      return;
+    }
+
     size_t totalSize = 0;
     for (auto& range : ranges) {
       for (auto i = range.begin; i < range.begin + range.size; ++i) {
@@ -75,6 +84,33 @@ class UnsafeRowVectorSerializer : public VectorSerializer {
     }
   }
 
+  // Writes all the rows a column at a time. All rows have the same size.
+  void appendFixedWidth(
+      const RowVector& vector,
+      const folly::Range<const IndexRange*>& ranges) {
+    using velox::row::UnsafeRowFixedWidthBatchSerializer;
+    const auto rowSize =
+        UnsafeRowFixedWidthBatchSerializer::rowSize(vector.type()->asRow());
+    const auto rowStride = rowSize + sizeof(size_t);
+    size_t numRows = 0;
+    for (auto& range : ranges) {
+      numRows += range.size;
+    }
+    if (numRows == 0) {
+      return;
+    }
+
+    const auto totalSize = numRows * rowStride;
+    auto* buffer = (char*)mappedMemory_->allocateBytes(totalSize);
+    buffers_.push_back(
+        ByteRange{(uint8_t*)buffer, (int32_t)totalSize, (int32_t)totalSize});
+    for (auto i = 0; i < numRows; ++i) {
+      *(size_t*)(buffer + i * rowStride) = rowSize;
+    }
+    UnsafeRowFixedWidthBatchSerializer::serialize(
+        vector, ranges, buffer + sizeof(size_t), rowStride);
+  }
+
   void flush(OutputStream* stream) override {
     for (auto& buffer : buffers_) {
       stream->write((char*)buffer.buffer, buffer.position);
@@ -117,6 +153,16 @@ void UnsafeRowVectorSerde::deserialize(
     return;
   }
 
+  // Rows of fixed width fields are read a column at a time unless some row
+  // is not laid out as expected.
+  if (velox::row::UnsafeRowFixedWidthBatchSerializer::supports(*type)) {
+    *result = velox::row::UnsafeRowFixedWidthBatchSerializer::deserialize(
+        serializedRows, type, pool);
+    if (*result) {
+      return;
+    }
+  }
+
   *result = std::dynamic_pointer_cast<RowVector>(
       velox::row::UnsafeRowDynamicVectorDeserializer::deserializeComplex(
           serializedRows, type, pool));
@@ -35,6 +35,8 @@ class UnsafeRowVectorSerde : public VectorSerde {
       StreamArena* streamArena,
       const Options* options) override;
 
+  using VectorSerde::deserialize;
+
   // This method is used when reading data from the exchange.
   void deserialize(
       ByteStream* source,
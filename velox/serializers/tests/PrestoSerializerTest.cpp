@@ -176,6 +176,77 @@ TEST_F(PrestoSerializerTest, dictionaryWithExtraNulls) {
   testRoundTrip(dictionary);
 }
 
+TEST_F(PrestoSerializerTest, keepDictionaryAndConstant) {
+  constexpr vector_size_t kSize = 1'000;
+  auto makeDictionary = [&](const VectorPtr& base) {
+    auto indices = AlignedBuffer::allocate<vector_size_t>(kSize, pool_.get());
+    auto rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < kSize; ++i) {
+      rawIndices[i] = (i * 7) % base->size();
+    }
+    return BaseVector::wrapInDictionary(nullptr, indices, kSize, base);
+  };
+  auto base = vectorMaker_->flatVector<std::string>(
+      10, [](auto row) { return fmt::format("dimension value {}", row); });
+  auto dictionary = makeDictionary(base);
+  auto constant =
+      BaseVector::createConstant(variant(int64_t(11)), kSize, pool_.get());
+  auto rowVector = vectorMaker_->rowVector({dictionary, constant});
+  auto rowType = asRowType(rowVector->type());
+
+  auto roundTrip = [&](const std::vector<RowVectorPtr>& batches) {
+    auto arena =
+        std::make_unique<StreamArena>(memory::MappedMemory::getInstance());
+    auto serializer = serde_->createSerializer(rowType, kSize, arena.get());
+    for (const auto& batch : batches) {
+      IndexRange range{0, batch->size()};
+      serializer->append(batch, folly::Range(&range, 1));
+    }
+    std::ostringstream out;
+    facebook::velox::serializer::presto::PrestoOutputStreamListener listener;
+    OStreamOutputStream output(&out, &listener);
+    serializer->flush(&output);
+    return deserialize(rowType, out.str(), nullptr);
+  };
+
+  // A dictionary and a constant stay encoded over several appends.
+  auto result = roundTrip({rowVector, rowVector});
+  ASSERT_EQ(2 * kSize, result->size());
+  for (auto i = 0; i < 2; ++i) {
+    assertEqualVectors(
+        rowVector,
+        std::dynamic_pointer_cast<RowVector>(result->slice(i * kSize, kSize)));
+  }
+  EXPECT_EQ(
+      VectorEncoding::Simple::DICTIONARY, result->childAt(0)->encoding());
+  EXPECT_EQ(10, result->childAt(0)->valueVector()->size());
+  EXPECT_TRUE(result->childAt(1)->isConstantEncoding());
+
+  // Another dictionary or constant value flattens the column.
+  auto other = vectorMaker_->rowVector(
+      {makeDictionary(vectorMaker_->flatVector<std::string>(
+           5, [](auto row) { return fmt::format("other value {}", row); })),
+       BaseVector::createConstant(variant(int64_t(12)), kSize, pool_.get())});
+  result = roundTrip({rowVector, other});
+  assertEqualVectors(
+      rowVector,
+      std::dynamic_pointer_cast<RowVector>(result->slice(0, kSize)));
+  assertEqualVectors(
+      other,
+      std::dynamic_pointer_cast<RowVector>(result->slice(kSize, kSize)));
+  EXPECT_TRUE(result->childAt(0)->isFlatEncoding());
+  EXPECT_TRUE(result->childAt(1)->isFlatEncoding());
+
+  // A dictionary with more entries than half its rows is flattened.
+  auto large = vectorMaker_->rowVector(
+      {makeDictionary(vectorMaker_->flatVector<std::string>(
+           kSize, [](auto row) { return fmt::format("value {}", row); })),
+       constant});
+  result = roundTrip({large});
+  assertEqualVectors(large, result);
+  EXPECT_TRUE(result->childAt(0)->isFlatEncoding());
+}
+
 TEST_F(PrestoSerializerTest, emptyPage) {
   auto rowVector = vectorMaker_->rowVector(ROW({"a"}, {BIGINT()}), 0);
 
@@ -292,6 +363,74 @@ TEST_F(PrestoSerializerTest, multiPage) {
   ASSERT_TRUE(byteStream->atEnd());
 }
 
+TEST_F(PrestoSerializerTest, resultOffset) {
+  auto makePage = [&](vector_size_t size, int32_t base) {
+    return vectorMaker_->rowVector({
+        vectorMaker_->flatVector<int64_t>(
+            size,
+            [base](vector_size_t row) { return base + row; },
+            [](vector_size_t row) { return row % 5 == 0; }),
+        vectorMaker_->flatVector<bool>(
+            size,
+            [](vector_size_t row) { return row % 3 == 0; },
+            [](vector_size_t row) { return row % 7 == 0; }),
+        vectorMaker_->flatVector<std::string>(
+            size,
+            [base](vector_size_t row) {
+              return fmt::format("string value {}", base + row);
+            }),
+        vectorMaker_->arrayVector<int32_t>(
+            size,
+            [](vector_size_t row) { return row % 4; },
+            [base](vector_size_t idx) { return base + idx; })});
+  };
+  // The pages do not end on a byte of the nulls.
+  std::vector<RowVectorPtr> pages = {
+      makePage(13, 0), makePage(507, 100), makePage(3, 1'000)};
+  pages.push_back(vectorMaker_->rowVector(
+      {BaseVector::createConstant(variant(int64_t(7)), 11, pool_.get()),
+       BaseVector::createConstant(variant(true), 11, pool_.get()),
+       BaseVector::createConstant(variant("constant"), 11, pool_.get()),
+       BaseVector::wrapInConstant(
+           11, 0, vectorMaker_->arrayVector<int32_t>({{1, 2, 3}}))}));
+  pages.push_back(makePage(100, 2'000));
+  auto rowType = asRowType(pages[0]->type());
+
+  std::ostringstream out;
+  for (const auto& page : pages) {
+    if (page->childAt(0)->isConstantEncoding()) {
+      serializeRle(page, &out, nullptr);
+    } else {
+      serialize(page, &out, nullptr);
+    }
+  }
+  auto byteStream = toByteStream(out.str());
+
+  // All the pages are read into one vector.
+  RowVectorPtr result;
+  for (const auto& page : pages) {
+    auto numRows = result ? result->size() : 0;
+    serde_->deserialize(
+        byteStream.get(), pool_.get(), rowType, &result, numRows, nullptr);
+    ASSERT_EQ(numRows + page->size(), result->size());
+  }
+  ASSERT_TRUE(byteStream->atEnd());
+
+  vector_size_t offset = 0;
+  for (const auto& page : pages) {
+    assertEqualVectors(
+        page,
+        std::dynamic_pointer_cast<RowVector>(
+            result->slice(offset, page->size())));
+    offset += page->size();
+  }
+  for (auto& column : result->children()) {
+    EXPECT_EQ(offset, column->size());
+  }
+  // The rows of the constant page are copied into the flat columns.
+  EXPECT_TRUE(result->childAt(0)->isFlatEncoding());
+}
+
 TEST_F(PrestoSerializerTest, timestampWithNanosecondPrecision) {
   // Verify that nanosecond precision is preserved when the right options are
   // passed to the serde.
@@ -341,6 +480,96 @@ TEST_F(PrestoSerializerTest, unscaledLongDecimal) {
   testRoundTrip(vector);
 }
 
+TEST_F(PrestoSerializerTest, compression) {
+  // The codec marker follows the number of rows.
+  constexpr int32_t kCodecMarkerOffset = 4;
+  constexpr char kCompressedBit = 1;
+  auto rowVector = makeTestVector(10'000);
+  auto rowType = asRowType(rowVector->type());
+  std::ostringstream uncompressedOut;
+  serialize(rowVector, &uncompressedOut, nullptr);
+
+  for (auto kind : {folly::io::CodecType::LZ4, folly::io::CodecType::ZSTD}) {
+    SCOPED_TRACE(folly::to<std::string>(static_cast<int>(kind)));
+    serializer::presto::PrestoVectorSerde::PrestoOptions options(false, kind);
+    std::ostringstream out;
+    serialize(rowVector, &out, &options);
+    auto page = out.str();
+    EXPECT_TRUE(page[kCodecMarkerOffset] & kCompressedBit);
+    EXPECT_LT(page.size(), uncompressedOut.str().size());
+    assertEqualVectors(rowVector, deserialize(rowType, page, &options));
+
+    // A compressed page can't be read without the codec.
+    VELOX_ASSERT_THROW(
+        deserialize(rowType, page, nullptr),
+        "Received a compressed page but no compression codec is set");
+  }
+
+  // Random values don't compress and are sent as is.
+  folly::Random::DefaultGenerator rng(1);
+  auto randomVector =
+      vectorMaker_->rowVector({vectorMaker_->flatVector<int64_t>(
+          10'000, [&](auto /*row*/) { return folly::Random::rand64(rng); })});
+  serializer::presto::PrestoVectorSerde::PrestoOptions options(
+      false, folly::io::CodecType::LZ4);
+  std::ostringstream out;
+  serialize(randomVector, &out, &options);
+  auto page = out.str();
+  EXPECT_FALSE(page[kCodecMarkerOffset] & kCompressedBit);
+  assertEqualVectors(
+      randomVector,
+      deserialize(asRowType(randomVector->type()), page, &options));
+}
+
+TEST_F(PrestoSerializerTest, inPlaceValues) {
+  auto rowVector = vectorMaker_->rowVector(
+      {vectorMaker_->flatVector<int64_t>(1'000, [](auto row) { return row; }),
+       vectorMaker_->flatVector<int64_t>(
+           1'000,
+           [](auto row) { return row; },
+           [](auto row) { return row % 7 == 0; })});
+  auto rowType = asRowType(rowVector->type());
+  std::ostringstream out;
+  serialize(rowVector, &out, nullptr);
+  auto page = out.str();
+
+  // The values are used in place only if aligned, so the page is read at
+  // each offset of a word.
+  int32_t numInPlace = 0;
+  for (auto offset = 0; offset < sizeof(int64_t); ++offset) {
+    SCOPED_TRACE(fmt::format("offset {}", offset));
+    auto buffer = std::make_shared<std::string>(offset, ' ');
+    *buffer += page;
+    ByteStream input;
+    input.resetInput({ByteRange{
+        reinterpret_cast<uint8_t*>(buffer->data()) + offset,
+        static_cast<int32_t>(page.size()),
+        0}});
+    input.setInputOwner(buffer);
+    RowVectorPtr result;
+    serde_->deserialize(&input, pool_.get(), rowType, &result, nullptr);
+    assertEqualVectors(rowVector, result);
+
+    auto& values = result->childAt(0)->values();
+    if (values->isView()) {
+      ++numInPlace;
+      EXPECT_GE(values->as<char>(), buffer->data());
+      EXPECT_LT(values->as<char>(), buffer->data() + buffer->size());
+    }
+    // A column with nulls is copied.
+    EXPECT_FALSE(result->childAt(1)->values()->isView());
+
+    // The vector keeps the page alive.
+    buffer.reset();
+    assertEqualVectors(rowVector, result);
+  }
+  EXPECT_EQ(1, numInPlace);
+
+  // Without an owner the values are copied.
+  auto result = deserialize(rowType, page, nullptr);
+  EXPECT_FALSE(result->childAt(0)->values()->isView());
+}
+
 TEST_F(PrestoSerializerTest, rle) {
   // Test RLE vectors with non-null value.
   testRleRoundTrip(BaseVector::createConstant(true, 12, pool_.get()));
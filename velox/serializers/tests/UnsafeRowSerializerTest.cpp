@@ -15,6 +15,7 @@
  */
 #include "velox/serializers/UnsafeRowSerializer.h"
 #include <gtest/gtest.h>
+#include "velox/row/UnsafeRowDeserializer.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
 
@@ -114,3 +115,46 @@ TEST_F(UnsafeRowSerializerTest, types) {
   auto data = fuzzer.fuzzRow(rowType);
   testRoundTrip(data);
 }
+
+TEST_F(UnsafeRowSerializerTest, fixedWidth) {
+  auto rowType = ROW(
+      {BOOLEAN(),
+       TINYINT(),
+       SMALLINT(),
+       INTEGER(),
+       BIGINT(),
+       REAL(),
+       DOUBLE(),
+       TIMESTAMP(),
+       DATE()});
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = 100;
+  opts.nullRatio = 0.1;
+  opts.useMicrosecondPrecisionTimestamp = true;
+
+  auto seed = folly::Random::rand32();
+
+  LOG(ERROR) << "Seed: " << seed;
+  SCOPED_TRACE(fmt::format("seed: {}", seed));
+  VectorFuzzer fuzzer(opts, pool_.get(), seed);
+
+  auto data = fuzzer.fuzzRow(rowType);
+  testRoundTrip(data);
+
+  // The rows written a column at a time read the same row by row.
+  std::ostringstream out;
+  serialize(data, &out);
+  auto input = out.str();
+  auto byteStream = toByteStream(input);
+  std::vector<std::optional<std::string_view>> rows;
+  while (!byteStream->atEnd()) {
+    auto rowSize = byteStream->read<size_t>();
+    rows.push_back(byteStream->nextView(rowSize));
+  }
+  ASSERT_EQ(data->size(), rows.size());
+  test::assertEqualVectors(
+      data,
+      row::UnsafeRowDynamicVectorDeserializer::deserializeComplex(
+          rows, rowType, pool_.get()));
+}
@@ -19,6 +19,16 @@
 
 namespace facebook::velox::substrait {
 
+SubstraitVeloxExprConverter::SubstraitVeloxExprConverter(
+    memory::MemoryPool* pool,
+    const std::unordered_map<uint64_t, std::string>& functionMap)
+    : pool_(pool) {
+  veloxFunctionMap_.reserve(functionMap.size());
+  for (const auto& [id, functionSpec] : functionMap) {
+    veloxFunctionMap_[id] = substraitParser_.findVeloxFunction(functionMap, id);
+  }
+}
+
 std::shared_ptr<const core::FieldAccessTypedExpr>
 SubstraitVeloxExprConverter::toVeloxExpr(
     const ::substrait::Expression::FieldReference& substraitField,
@@ -57,8 +67,12 @@ SubstraitVeloxExprConverter::toVeloxExpr(
   for (const auto& sArg : substraitFunc.arguments()) {
     params.emplace_back(toVeloxExpr(sArg.value(), inputType));
   }
-  const auto& veloxFunction = substraitParser_.findVeloxFunction(
-      functionMap_, substraitFunc.function_reference());
+  auto it = veloxFunctionMap_.find(substraitFunc.function_reference());
+  VELOX_CHECK(
+      it != veloxFunctionMap_.end(),
+      "Could not find function id {} in function map.",
+      substraitFunc.function_reference());
+  const auto& veloxFunction = it->second;
   std::string typeName =
       substraitParser_.parseType(substraitFunc.output_type())->type;
   return std::make_shared<const core::CallTypedExpr>(
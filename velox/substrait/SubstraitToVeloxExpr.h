@@ -30,8 +30,7 @@ class SubstraitVeloxExprConverter {
   /// storing the relations between the function id and the function name.
   explicit SubstraitVeloxExprConverter(
       memory::MemoryPool* pool,
-      const std::unordered_map<uint64_t, std::string>& functionMap)
-      : pool_(pool), functionMap_(functionMap) {}
+      const std::unordered_map<uint64_t, std::string>& functionMap);
 
   /// Convert Substrait Field into Velox Field Expression.
   std::shared_ptr<const core::FieldAccessTypedExpr> toVeloxExpr(
@@ -70,9 +69,10 @@ class SubstraitVeloxExprConverter {
   /// recognizable representations.
   SubstraitParser substraitParser_;
 
-  /// The map storing the relations between the function id and the function
-  /// name.
-  std::unordered_map<uint64_t, std::string> functionMap_;
+  /// The map storing the relations between the function id and the Velox
+  /// function name. Resolved once from the function specifications of the
+  /// plan instead of for each call.
+  std::unordered_map<uint64_t, std::string> veloxFunctionMap_;
 };
 
 } // namespace facebook::velox::substrait
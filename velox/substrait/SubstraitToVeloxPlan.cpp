@@ -233,6 +233,37 @@ core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
       childNode);
 }
 
+void SubstraitVeloxPlanConverter::parseSplitInfo(
+    const ::substrait::ReadRel& readRel,
+    SplitInfo& splitInfo) {
+  // Parse local files
+  if (readRel.has_local_files()) {
+    using SubstraitFileFormatCase =
+        ::substrait::ReadRel_LocalFiles_FileOrFiles::FileFormatCase;
+    const auto& fileList = readRel.local_files().items();
+    splitInfo.paths.reserve(fileList.size());
+    splitInfo.starts.reserve(fileList.size());
+    splitInfo.lengths.reserve(fileList.size());
+    for (const auto& file : fileList) {
+      // Expect all files to share the same index.
+      splitInfo.partitionIndex = file.partition_index();
+      splitInfo.paths.emplace_back(file.uri_file());
+      splitInfo.starts.emplace_back(file.start());
+      splitInfo.lengths.emplace_back(file.length());
+      switch (file.file_format_case()) {
+        case SubstraitFileFormatCase::kOrc:
+          splitInfo.format = dwio::common::FileFormat::DWRF;
+          break;
+        case SubstraitFileFormatCase::kParquet:
+          splitInfo.format = dwio::common::FileFormat::PARQUET;
+          break;
+        default:
+          splitInfo.format = dwio::common::FileFormat::UNKNOWN;
+      }
+    }
+  }
+}
+
 core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
     const ::substrait::ReadRel& readRel,
     std::shared_ptr<SplitInfo>& splitInfo) {
@@ -252,32 +283,7 @@ core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
     }
   }
 
-  // Parse local files
-  if (readRel.has_local_files()) {
-    using SubstraitFileFormatCase =
-        ::substrait::ReadRel_LocalFiles_FileOrFiles::FileFormatCase;
-    const auto& fileList = readRel.local_files().items();
-    splitInfo->paths.reserve(fileList.size());
-    splitInfo->starts.reserve(fileList.size());
-    splitInfo->lengths.reserve(fileList.size());
-    for (const auto& file : fileList) {
-      // Expect all files to share the same index.
-      splitInfo->partitionIndex = file.partition_index();
-      splitInfo->paths.emplace_back(file.uri_file());
-      splitInfo->starts.emplace_back(file.start());
-      splitInfo->lengths.emplace_back(file.length());
-      switch (file.file_format_case()) {
-        case SubstraitFileFormatCase::kOrc:
-          splitInfo->format = dwio::common::FileFormat::DWRF;
-          break;
-        case SubstraitFileFormatCase::kParquet:
-          splitInfo->format = dwio::common::FileFormat::PARQUET;
-          break;
-        default:
-          splitInfo->format = dwio::common::FileFormat::UNKNOWN;
-      }
-    }
-  }
+  parseSplitInfo(readRel, *splitInfo);
 
   // Do not hard-code connector ID and allow for connectors other than Hive.
   static const std::string kHiveConnectorId = "test-hive";
@@ -404,6 +410,7 @@ core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
 
     auto planNode = toVeloxPlan(rel.read(), splitInfo);
     splitInfoMap_[planNode->id()] = splitInfo;
+    readNodeIds_.push_back(planNode->id());
     return planNode;
   }
   VELOX_NYI("Substrait conversion not supported for Rel.");
@@ -428,21 +435,140 @@ core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
   // Construct the function map based on the Substrait representation.
   constructFunctionMap(substraitPlan);
 
+  // In fact, only one RelRoot or Rel is expected here.
+  VELOX_CHECK_EQ(substraitPlan.relations_size(), 1);
+  const auto& rel = substraitPlan.relations(0);
+  VELOX_CHECK(
+      rel.has_root() || rel.has_rel(), "RelRoot or Rel is expected in Plan.");
+
+  std::optional<std::string> cacheKey;
+  if (planCache_) {
+    cacheKey = makePlanCacheKey(substraitPlan);
+    if (cacheKey.has_value()) {
+      if (auto entry = planCache_->find(cacheKey.value())) {
+        addSplitInfos(substraitPlan, entry->readNodeIds);
+        return entry->plan;
+      }
+    }
+  }
+
   // Construct the expression converter.
   exprConverter_ =
       std::make_shared<SubstraitVeloxExprConverter>(pool_, functionMap_);
 
-  // In fact, only one RelRoot or Rel is expected here.
-  VELOX_CHECK_EQ(substraitPlan.relations_size(), 1);
-  const auto& rel = substraitPlan.relations(0);
-  if (rel.has_root()) {
-    return toVeloxPlan(rel.root());
+  readNodeIds_.clear();
+  auto planNode =
+      rel.has_root() ? toVeloxPlan(rel.root()) : toVeloxPlan(rel.rel());
+  if (cacheKey.has_value()) {
+    planCache_->insert(
+        std::move(cacheKey.value()), {planNode, std::move(readNodeIds_)});
+    readNodeIds_.clear();
+  }
+  return planNode;
+}
+
+namespace {
+
+// Returns the input of 'rel' or nullptr if 'rel' has none. The Rels with an
+// input have exactly one, so the ReadRels of a plan are the leaf of the chain
+// of inputs.
+const ::substrait::Rel* inputRel(const ::substrait::Rel& rel) {
+  if (rel.has_aggregate() && rel.aggregate().has_input()) {
+    return &rel.aggregate().input();
+  }
+  if (rel.has_project() && rel.project().has_input()) {
+    return &rel.project().input();
   }
-  if (rel.has_rel()) {
-    return toVeloxPlan(rel.rel());
+  if (rel.has_filter() && rel.filter().has_input()) {
+    return &rel.filter().input();
   }
+  return nullptr;
+}
+
+::substrait::Rel* mutableInputRel(::substrait::Rel& rel) {
+  return const_cast<::substrait::Rel*>(inputRel(rel));
+}
+
+} // namespace
+
+// static
+std::optional<std::string> SubstraitVeloxPlanConverter::makePlanCacheKey(
+    const ::substrait::Plan& substraitPlan) {
+  // The files to read differ between the tasks of a stage. The plan nodes do
+  // not depend on them, so they are left out of the key.
+  ::substrait::Plan plan = substraitPlan;
+  auto* planRel = plan.mutable_relations(0);
+  auto* rel = planRel->has_root() ? planRel->mutable_root()->mutable_input()
+                                  : planRel->mutable_rel();
+  for (; rel != nullptr; rel = mutableInputRel(*rel)) {
+    if (rel->has_read()) {
+      if (rel->read().has_virtual_table()) {
+        return std::nullopt;
+      }
+      rel->mutable_read()->clear_local_files();
+    }
+  }
+  return plan.SerializeAsString();
+}
+
+void SubstraitVeloxPlanConverter::addSplitInfos(
+    const ::substrait::Plan& substraitPlan,
+    const std::vector<core::PlanNodeId>& readNodeIds) {
+  const auto& planRel = substraitPlan.relations(0);
+  const auto* rel =
+      planRel.has_root() ? &planRel.root().input() : &planRel.rel();
+  auto readNodeId = readNodeIds.begin();
+  for (; rel != nullptr; rel = inputRel(*rel)) {
+    if (!rel->has_read()) {
+      continue;
+    }
+    VELOX_CHECK(readNodeId != readNodeIds.end());
+    auto splitInfo = std::make_shared<SplitInfo>();
+    parseSplitInfo(rel->read(), *splitInfo);
+    splitInfoMap_[*readNodeId++] = std::move(splitInfo);
+  }
+  VELOX_CHECK(readNodeId == readNodeIds.end());
+}
+
+std::optional<SubstraitPlanCache::Entry> SubstraitPlanCache::find(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    ++numMisses_;
+    return std::nullopt;
+  }
+  ++numHits_;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->second;
+}
+
+void SubstraitPlanCache::insert(std::string key, Entry entry) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (maxEntries_ == 0 || index_.count(key) > 0) {
+    return;
+  }
+  entries_.emplace_front(std::move(key), std::move(entry));
+  index_[entries_.front().first] = entries_.begin();
+  if (entries_.size() > maxEntries_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+}
+
+size_t SubstraitPlanCache::size() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return entries_.size();
+}
+
+uint64_t SubstraitPlanCache::numHits() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return numHits_;
+}
 
-  VELOX_FAIL("RelRoot or Rel is expected in Plan.");
+uint64_t SubstraitPlanCache::numMisses() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return numMisses_;
 }
 
 std::string SubstraitVeloxPlanConverter::nextPlanNodeId() {
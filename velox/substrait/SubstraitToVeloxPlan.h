@@ -16,17 +16,70 @@
 
 #pragma once
 
+#include <list>
+#include <mutex>
+
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/core/PlanNode.h"
 #include "velox/substrait/SubstraitToVeloxExpr.h"
 
 namespace facebook::velox::substrait {
 
+/// Caches the Velox plans converted from Substrait plans, so that the tasks
+/// of a stage, which get the same plan with different files to read, convert
+/// it once. The key is the serialized Substrait plan without the files of its
+/// ReadRels. The least recently used plan is evicted past 'maxEntries'.
+/// Thread safe.
+class SubstraitPlanCache {
+ public:
+  struct Entry {
+    core::PlanNodePtr plan;
+
+    /// The ids of the plan nodes made from the ReadRels of the plan in the
+    /// order the ReadRels are converted.
+    std::vector<core::PlanNodeId> readNodeIds;
+  };
+
+  explicit SubstraitPlanCache(size_t maxEntries) : maxEntries_(maxEntries) {}
+
+  /// Returns the entry for 'key' or std::nullopt if not cached.
+  std::optional<Entry> find(const std::string& key);
+
+  void insert(std::string key, Entry entry);
+
+  size_t size() const;
+
+  uint64_t numHits() const;
+
+  uint64_t numMisses() const;
+
+ private:
+  const size_t maxEntries_;
+
+  mutable std::mutex mutex_;
+
+  /// The most recently used first.
+  std::list<std::pair<std::string, Entry>> entries_;
+
+  /// The keys point to the keys in 'entries_'.
+  std::unordered_map<
+      std::string_view,
+      std::list<std::pair<std::string, Entry>>::iterator>
+      index_;
+
+  uint64_t numHits_{0};
+  uint64_t numMisses_{0};
+};
+
 /// This class is used to convert the Substrait plan into Velox plan.
 class SubstraitVeloxPlanConverter {
  public:
-  explicit SubstraitVeloxPlanConverter(memory::MemoryPool* pool)
-      : pool_(pool) {}
+  /// planCache: If not null, toVeloxPlan(const ::substrait::Plan&) reuses the
+  /// plans converted before by converters sharing 'planCache'.
+  explicit SubstraitVeloxPlanConverter(
+      memory::MemoryPool* pool,
+      std::shared_ptr<SubstraitPlanCache> planCache = nullptr)
+      : pool_(pool), planCache_(std::move(planCache)) {}
   struct SplitInfo {
     /// The Partition index.
     u_int32_t partitionIndex;
@@ -105,6 +158,24 @@ class SubstraitVeloxPlanConverter {
   /// starting from zero.
   std::string nextPlanNodeId();
 
+  /// Fills 'splitInfo' with the files of 'readRel'.
+  void parseSplitInfo(
+      const ::substrait::ReadRel& readRel,
+      SplitInfo& splitInfo);
+
+  /// Returns the key of 'substraitPlan' in 'planCache_' or std::nullopt if
+  /// the plan can't be cached. Plans with virtual tables are not cached since
+  /// their vectors are allocated from 'pool_'.
+  static std::optional<std::string> makePlanCacheKey(
+      const ::substrait::Plan& substraitPlan);
+
+  /// Adds the split infos of a plan found in 'planCache_' to 'splitInfoMap_'.
+  /// The files come from the ReadRels of 'substraitPlan' and the ids from
+  /// 'readNodeIds' of the cached entry.
+  void addSplitInfos(
+      const ::substrait::Plan& substraitPlan,
+      const std::vector<core::PlanNodeId>& readNodeIds);
+
   /// Used to convert Substrait Filter into Velox SubfieldFilters which will
   /// be used in TableScan.
   connector::hive::SubfieldFilters toVeloxFilter(
@@ -140,8 +211,14 @@ class SubstraitVeloxPlanConverter {
   std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>>
       splitInfoMap_;
 
+  /// The ids of the plan nodes made from ReadRels in conversion order.
+  std::vector<core::PlanNodeId> readNodeIds_;
+
   /// Memory pool.
   memory::MemoryPool* pool_;
+
+  /// Plans converted before. May be null.
+  const std::shared_ptr<SubstraitPlanCache> planCache_;
 };
 
 } // namespace facebook::velox::substrait
@@ -287,3 +287,64 @@ TEST_F(Substrait2VeloxPlanConversionTest, q6) {
       .splits(makeSplits(planConverter, planNode))
       .assertResults(expectedResult);
 }
+
+TEST_F(Substrait2VeloxPlanConversionTest, planCache) {
+  auto readPlan = [](const std::string& name) {
+    ::substrait::Plan substraitPlan;
+    JsonToProtoConverter::readFromFile(
+        getDataFilePath("velox/substrait/tests", "data/" + name),
+        substraitPlan);
+    return substraitPlan;
+  };
+  auto planCache =
+      std::make_shared<facebook::velox::substrait::SubstraitPlanCache>(10);
+  auto q6 = readPlan("q6_first_stage.json");
+
+  facebook::velox::substrait::SubstraitVeloxPlanConverter firstConverter(
+      pool_.get(), planCache);
+  auto planNode = firstConverter.toVeloxPlan(q6);
+  EXPECT_EQ(1, planCache->size());
+  EXPECT_EQ(0, planCache->numHits());
+
+  // Another task of the same stage reads another file.
+  auto* rel = q6.mutable_relations(0)->mutable_root()->mutable_input();
+  while (!rel->has_read()) {
+    if (rel->has_aggregate()) {
+      rel = rel->mutable_aggregate()->mutable_input();
+    } else if (rel->has_project()) {
+      rel = rel->mutable_project()->mutable_input();
+    } else {
+      rel = rel->mutable_filter()->mutable_input();
+    }
+  }
+  auto* file = rel->mutable_read()->mutable_local_files()->mutable_items(0);
+  file->set_uri_file("/other_lineitem.orc");
+  file->set_length(100);
+
+  facebook::velox::substrait::SubstraitVeloxPlanConverter secondConverter(
+      pool_.get(), planCache);
+  EXPECT_EQ(planNode, secondConverter.toVeloxPlan(q6));
+  EXPECT_EQ(1, planCache->numHits());
+  const auto& splitInfos = secondConverter.splitInfos();
+  ASSERT_EQ(1, splitInfos.size());
+  const auto& splitInfo =
+      splitInfos.at(*planNode->leafPlanNodeIds().begin());
+  EXPECT_EQ(
+      std::vector<std::string>{"/other_lineitem.orc"}, splitInfo->paths);
+  EXPECT_EQ(std::vector<u_int64_t>{100}, splitInfo->lengths);
+  EXPECT_EQ(dwio::common::FileFormat::DWRF, splitInfo->format);
+
+  // A plan reading another column is converted and cached.
+  rel->mutable_read()->mutable_base_schema()->set_names(0, "l_orderkey_new");
+  facebook::velox::substrait::SubstraitVeloxPlanConverter thirdConverter(
+      pool_.get(), planCache);
+  EXPECT_NE(planNode, thirdConverter.toVeloxPlan(q6));
+  EXPECT_EQ(2, planCache->numMisses());
+  EXPECT_EQ(2, planCache->size());
+
+  // Plans with virtual tables are not cached.
+  facebook::velox::substrait::SubstraitVeloxPlanConverter fourthConverter(
+      pool_.get(), planCache);
+  fourthConverter.toVeloxPlan(readPlan("substrait_virtualTable.json"));
+  EXPECT_EQ(2, planCache->size());
+}
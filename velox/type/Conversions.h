@@ -17,7 +17,10 @@
 #pragma once
 
 #include <folly/Conv.h>
+#include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <limits>
 #include <string>
 #include <type_traits>
 #include "velox/common/base/Exceptions.h"
@@ -26,6 +29,120 @@
 
 namespace facebook::velox::util {
 
+namespace detail {
+
+// Returns true if all 8 bytes of 'chars' are ASCII digits.
+inline bool isEightDigits(uint64_t chars) {
+  return ((chars & 0xF0F0F0F0F0F0F0F0) |
+          (((chars + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+      0x3333333333333333;
+}
+
+// Returns the value of the 8 ASCII digits in 'chars', loaded little-endian so
+// that the first digit is in the lowest byte. Combines pairs of digits, then
+// pairs of 2 digit numbers and so on with 3 multiplications in total.
+inline uint32_t parseEightDigits(uint64_t chars) {
+  constexpr uint64_t kMask = 0x000000FF000000FF;
+  constexpr uint64_t kMul1 = 100 + (1000000ULL << 32);
+  constexpr uint64_t kMul2 = 1 + (10000ULL << 32);
+  chars -= 0x3030303030303030;
+  chars = (chars * 10) + (chars >> 8);
+  chars = (((chars & kMask) * kMul1) + (((chars >> 16) & kMask) * kMul2)) >> 32;
+  return static_cast<uint32_t>(chars);
+}
+
+// Parses up to 'maxDigits' ASCII digits from 'data' to 'value'. Reads 8 digits
+// at a time. Returns the number of digits parsed, which is less than 'size'
+// if a non-digit is found.
+inline size_t
+parseDigits(const char* data, size_t size, size_t maxDigits, uint64_t& value) {
+  size_t pos = 0;
+  const auto end = std::min(size, maxDigits);
+  while (end - pos >= 8) {
+    uint64_t chars;
+    memcpy(&chars, data + pos, sizeof(chars));
+    if (!isEightDigits(chars)) {
+      break;
+    }
+    value = value * 100'000'000 + parseEightDigits(chars);
+    pos += 8;
+  }
+  for (; pos < end; ++pos) {
+    const uint8_t digit = data[pos] - '0';
+    if (digit > 9) {
+      break;
+    }
+    value = value * 10 + digit;
+  }
+  return pos;
+}
+
+// Fast path for casting the common integer format [-]digits of at most 18
+// digits, which fit in int64_t without overflow checks. Returns false for
+// any other input, which is then left to the general conversion. This keeps
+// the exact semantics and error messages of the general conversion.
+inline bool tryParseInt64(const char* data, size_t size, int64_t& result) {
+  constexpr size_t kMaxDigits = 18;
+  const bool negative = size > 0 && data[0] == '-';
+  const size_t start = negative ? 1 : 0;
+  const auto numDigits = size - start;
+  if (numDigits == 0 || numDigits > kMaxDigits) {
+    return false;
+  }
+  uint64_t value = 0;
+  if (parseDigits(data + start, numDigits, kMaxDigits, value) != numDigits) {
+    return false;
+  }
+  result = static_cast<int64_t>(value);
+  if (negative) {
+    result = -result;
+  }
+  return true;
+}
+
+// Fast path for casting the common decimal format [-]digits[.digits] of at
+// most 15 digits in total. The digits then fit exactly in the mantissa of a
+// double and the result of a single division by an exact power of 10 is
+// correctly rounded, same as the general conversion. Returns false for any
+// other input, which is then left to the general conversion.
+inline bool tryParseDouble(const char* data, size_t size, double& result) {
+  constexpr size_t kMaxDigits = 15;
+  static constexpr double kPowersOf10[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+      1e13, 1e14, 1e15};
+  const bool negative = size > 0 && data[0] == '-';
+  size_t pos = negative ? 1 : 0;
+  if (pos == size || size - pos > kMaxDigits + 1) {
+    return false;
+  }
+  uint64_t value = 0;
+  const auto numIntegerDigits =
+      parseDigits(data + pos, size - pos, kMaxDigits, value);
+  if (numIntegerDigits == 0) {
+    return false;
+  }
+  pos += numIntegerDigits;
+  size_t numFractionDigits = 0;
+  if (pos < size) {
+    if (data[pos] != '.') {
+      return false;
+    }
+    ++pos;
+    numFractionDigits = parseDigits(
+        data + pos, size - pos, kMaxDigits - numIntegerDigits, value);
+    if (numFractionDigits == 0 || pos + numFractionDigits != size) {
+      return false;
+    }
+  }
+  result = static_cast<double>(value) / kPowersOf10[numFractionDigits];
+  if (negative) {
+    result = -result;
+  }
+  return true;
+}
+
+} // namespace detail
+
 template <TypeKind KIND, typename = void, bool TRUNCATE = false>
 struct Converter {
   template <typename T>
@@ -152,6 +269,14 @@ struct Converter<
       if constexpr (TRUNCATE) {
         return convertStringToInt(folly::StringPiece(v), nullOutput);
       } else {
+        if constexpr (!std::is_same_v<T, bool>) {
+          int64_t value;
+          if (detail::tryParseInt64(v.data(), v.size(), value) &&
+              value >= std::numeric_limits<T>::min() &&
+              value <= std::numeric_limits<T>::max()) {
+            return value;
+          }
+        }
         return folly::to<T>(folly::StringPiece(v));
       }
     } catch (const std::exception& e) {
@@ -305,6 +430,12 @@ struct Converter<
   }
 
   static T cast(const StringView& v, bool& nullOutput) {
+    if constexpr (std::is_same_v<T, double>) {
+      double value;
+      if (detail::tryParseDouble(v.data(), v.size(), value)) {
+        return value;
+      }
+    }
     return cast<folly::StringPiece>(folly::StringPiece(v), nullOutput);
   }
 
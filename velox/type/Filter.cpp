@@ -86,6 +86,9 @@ std::string Filter::toString() const {
     case FilterKind::kMultiRange:
       strKind = "MultiRange";
       break;
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      strKind = "BigintValuesUsingBloomFilter";
+      break;
   };
 
   return fmt::format(
@@ -106,10 +109,10 @@ BigintValuesUsingBitmask::BigintValuesUsingBitmask(
   VELOX_CHECK(min < max, "min must be less than max");
   VELOX_CHECK(values.size() > 1, "values must contain at least 2 entries");
 
-  bitmask_.resize(max - min + 1);
+  bitmask_.resize(bits::nwords(max - min + 1) + 1);
 
   for (int64_t value : values) {
-    bitmask_[value - min] = true;
+    bits::setBit(bitmask_.data(), value - min);
   }
 }
 
@@ -117,13 +120,49 @@ bool BigintValuesUsingBitmask::testInt64(int64_t value) const {
   if (value < min_ || value > max_) {
     return false;
   }
-  return bitmask_[value - min_];
+  return isSet(value - min_);
+}
+
+xsimd::batch_bool<int64_t> BigintValuesUsingBitmask::testValues(
+    xsimd::batch<int64_t> x) const {
+  constexpr int32_t kSize = xsimd::batch<int64_t>::size;
+  static_assert(kSize <= 8);
+  // The bits are gathered with 32 bit offsets.
+  if (UNLIKELY(max_ - min_ >= std::numeric_limits<int32_t>::max())) {
+    return Filter::testValues(x);
+  }
+  const uint8_t inRange = simd::toBitMask(
+      (x >= xsimd::broadcast<int64_t>(min_)) &
+      (x <= xsimd::broadcast<int64_t>(max_)));
+  if (!inRange) {
+    return xsimd::batch_bool<int64_t>(false);
+  }
+  constexpr int kAlign = xsimd::default_arch::alignment();
+  alignas(kAlign) int64_t offsets[kSize];
+  (x - xsimd::broadcast<int64_t>(min_)).store_aligned(offsets);
+  // The lanes out of range read bit 0 and are masked off.
+  alignas(kAlign) int32_t indices[xsimd::batch<int32_t>::size] = {};
+  for (auto i = 0; i < kSize; ++i) {
+    if (inRange & (1 << i)) {
+      indices[i] = offsets[i];
+    }
+  }
+  return simd::fromBitMask<int64_t>(
+      simd::gather8Bits(bitmask_.data(), indices, kSize) & inRange);
+}
+
+xsimd::batch_bool<int32_t> BigintValuesUsingBitmask::testValues(
+    xsimd::batch<int32_t> x) const {
+  auto first = simd::toBitMask(testValues(simd::getHalf<int64_t, 0>(x)));
+  auto second = simd::toBitMask(testValues(simd::getHalf<int64_t, 1>(x)));
+  return simd::fromBitMask<int32_t>(
+      first | (second << xsimd::batch<int64_t>::size));
 }
 
 std::vector<int64_t> BigintValuesUsingBitmask::values() const {
   std::vector<int64_t> values;
-  for (int i = 0; i < bitmask_.size(); i++) {
-    if (bitmask_[i]) {
+  for (int64_t i = 0; i <= max_ - min_; i++) {
+    if (isSet(i)) {
       values.push_back(min_ + i);
     }
   }
@@ -1091,6 +1130,8 @@ std::vector<std::unique_ptr<BigintRange>> negatedValuesToRanges(
 
 std::unique_ptr<Filter> BigintRange::mergeWith(const Filter* other) const {
   switch (other->kind()) {
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
     case FilterKind::kIsNull:
@@ -1159,6 +1200,8 @@ std::unique_ptr<Filter> BigintRange::mergeWith(const Filter* other) const {
 std::unique_ptr<Filter> NegatedBigintRange::mergeWith(
     const Filter* other) const {
   switch (other->kind()) {
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
     case FilterKind::kIsNull:
@@ -1252,6 +1295,8 @@ std::unique_ptr<Filter> NegatedBigintRange::mergeWith(
 std::unique_ptr<Filter> BigintValuesUsingHashTable::mergeWith(
     const Filter* other) const {
   switch (other->kind()) {
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
     case FilterKind::kIsNull:
@@ -1343,6 +1388,8 @@ std::unique_ptr<Filter> BigintValuesUsingHashTable::mergeWith(
 std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
     const Filter* other) const {
   switch (other->kind()) {
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
     case FilterKind::kIsNull:
@@ -1381,7 +1428,7 @@ std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
         auto min = std::max(min_, range->lower());
         auto max = std::min(max_, range->upper());
         for (auto i = min; i <= max; ++i) {
-          if (bitmask_[i - min_] && range->testInt64(i)) {
+          if (isSet(i - min_) && range->testInt64(i)) {
             valuesToKeep.push_back(i);
           }
         }
@@ -1408,13 +1455,118 @@ std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
 
   std::vector<int64_t> valuesToKeep;
   for (auto i = min; i <= max; ++i) {
-    if (bitmask_[i - min_] && other->testInt64(i)) {
+    if (isSet(i - min_) && other->testInt64(i)) {
       valuesToKeep.push_back(i);
     }
   }
   return createBigintValues(valuesToKeep, bothNullAllowed);
 }
 
+xsimd::batch_bool<int64_t> BigintValuesUsingBloomFilter::testValues(
+    xsimd::batch<int64_t> x) const {
+  auto inRange = (x >= xsimd::broadcast<int64_t>(min_)) &
+      (x <= xsimd::broadcast<int64_t>(max_));
+  static_assert(decltype(inRange)::size <= 16);
+  uint16_t candidates = simd::toBitMask(inRange);
+  if (!candidates) {
+    return xsimd::batch_bool<int64_t>(false);
+  }
+  constexpr int kAlign = xsimd::default_arch::alignment();
+  constexpr int kArraySize = xsimd::batch<int64_t>::size;
+  alignas(kAlign) int64_t valuesArray[kArraySize];
+  x.store_aligned(valuesArray);
+  uint16_t resultBits = 0;
+  // The range check above usually rejects most of the lanes. Probe the Bloom
+  // filter only for the lanes that remain.
+  while (candidates) {
+    auto lane = bits::getAndClearLastSetBit(candidates);
+    if (bloomFilter_->mayContain(valuesArray[lane])) {
+      resultBits |= 1 << lane;
+    }
+  }
+  return simd::fromBitMask<int64_t>(resultBits);
+}
+
+xsimd::batch_bool<int32_t> BigintValuesUsingBloomFilter::testValues(
+    xsimd::batch<int32_t> x) const {
+  auto first = simd::toBitMask(testValues(simd::getHalf<int64_t, 0>(x)));
+  auto second = simd::toBitMask(testValues(simd::getHalf<int64_t, 1>(x)));
+  return simd::fromBitMask<int32_t>(
+      first | (second << xsimd::batch<int64_t>::size));
+}
+
+bool BigintValuesUsingBloomFilter::testInt64Range(
+    int64_t min,
+    int64_t max,
+    bool hasNull) const {
+  if (hasNull && nullAllowed_) {
+    return true;
+  }
+
+  if (min == max) {
+    return testInt64(min);
+  }
+
+  return !(min > max_ || max < min_);
+}
+
+std::unique_ptr<Filter> BigintValuesUsingBloomFilter::mergeWith(
+    const Filter* other) const {
+  bool bothNullAllowed = nullAllowed_ && other->testNull();
+  switch (other->kind()) {
+    case FilterKind::kAlwaysTrue:
+    case FilterKind::kAlwaysFalse:
+    case FilterKind::kIsNull:
+      return other->mergeWith(this);
+    case FilterKind::kIsNotNull:
+      return std::make_unique<BigintValuesUsingBloomFilter>(*this, false);
+    case FilterKind::kBigintRange: {
+      auto otherRange = static_cast<const BigintRange*>(other);
+      auto min = std::max(min_, otherRange->lower());
+      auto max = std::min(max_, otherRange->upper());
+      if (min > max) {
+        return nullOrFalse(bothNullAllowed);
+      }
+      return std::make_unique<BigintValuesUsingBloomFilter>(
+          min, max, bloomFilter_, bothNullAllowed);
+    }
+    case FilterKind::kBigintValuesUsingBloomFilter: {
+      // Two Bloom filters of different sizes cannot be intersected. Keep the
+      // bits of 'this' and narrow the range.
+      auto otherBloom = static_cast<const BigintValuesUsingBloomFilter*>(other);
+      auto min = std::max(min_, otherBloom->min_);
+      auto max = std::min(max_, otherBloom->max_);
+      if (min > max) {
+        return nullOrFalse(bothNullAllowed);
+      }
+      return std::make_unique<BigintValuesUsingBloomFilter>(
+          min, max, bloomFilter_, bothNullAllowed);
+    }
+    case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintValuesUsingBitmask: {
+      // An exact IN-list gets narrower after dropping the values that cannot
+      // be in the Bloom filter.
+      std::vector<int64_t> values;
+      if (other->kind() == FilterKind::kBigintValuesUsingHashTable) {
+        values = static_cast<const BigintValuesUsingHashTable*>(other)->values();
+      } else {
+        values = static_cast<const BigintValuesUsingBitmask*>(other)->values();
+      }
+      std::vector<int64_t> valuesToKeep;
+      for (auto value : values) {
+        if (testInt64(value)) {
+          valuesToKeep.push_back(value);
+        }
+      }
+      return createBigintValues(valuesToKeep, bothNullAllowed);
+    }
+    default:
+      // The other filter is exact while 'this' is not. Dropping 'this' is
+      // always correct.
+      return other->clone(bothNullAllowed);
+  }
+}
+
 std::unique_ptr<Filter> NegatedBigintValuesUsingHashTable::mergeWith(
     const Filter* other) const {
   // Rules of NegatedBigintValuesUsingHashTable with IsNull/IsNotNull
@@ -1426,6 +1578,8 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingHashTable::mergeWith(
   // 4. Negated...(nullAllowed=false) AND IS NOT NULL
   // =>Negated...(nullAllowed=false)
   switch (other->kind()) {
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
     case FilterKind::kIsNull:
@@ -1465,6 +1619,8 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingBitmask::mergeWith(
   // 4. Negated...(nullAllowed=false) AND IS NOT NULL
   // =>Negated...(nullAllowed=false)
   switch (other->kind()) {
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
     case FilterKind::kIsNull:
@@ -1500,6 +1656,8 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingBitmask::mergeWith(
 
 std::unique_ptr<Filter> BigintMultiRange::mergeWith(const Filter* other) const {
   switch (other->kind()) {
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
     case FilterKind::kIsNull:
@@ -25,6 +25,7 @@
 #include <folly/Range.h>
 #include <folly/container/F14Set.h>
 
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/type/StringView.h"
@@ -52,6 +53,7 @@ enum class FilterKind {
   kNegatedBytesValues,
   kBigintMultiRange,
   kMultiRange,
+  kBigintValuesUsingBloomFilter,
 };
 
 /**
@@ -823,6 +825,14 @@ class BigintValuesUsingBitmask final : public Filter {
 
   bool testInt64(int64_t value) const final;
 
+  xsimd::batch_bool<int64_t> testValues(xsimd::batch<int64_t>) const final;
+
+  xsimd::batch_bool<int32_t> testValues(xsimd::batch<int32_t>) const final;
+
+  xsimd::batch_bool<int16_t> testValues(xsimd::batch<int16_t> x) const final {
+    return Filter::testValues(x);
+  }
+
   bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final;
 
   std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
@@ -831,7 +841,13 @@ class BigintValuesUsingBitmask final : public Filter {
   std::unique_ptr<Filter>
   mergeWith(int64_t min, int64_t max, const Filter* other) const;
 
-  std::vector<bool> bitmask_;
+  bool isSet(int64_t offset) const {
+    return bits::isBitSet(bitmask_.data(), offset);
+  }
+
+  // Bit 'value - min_' is set for each passing value. Has a word of padding
+  // at the end since the SIMD path loads bits 32 at a time.
+  std::vector<uint64_t> bitmask_;
   const int64_t min_;
   const int64_t max_;
 };
@@ -962,6 +978,84 @@ class NegatedBigintValuesUsingBitmask final : public Filter {
   std::unique_ptr<BigintValuesUsingBitmask> nonNegated_;
 };
 
+/// Approximate IN-list filter for integral data types backed by a Bloom
+/// filter. Used for dynamic filters from hash join build sides that have too
+/// many distinct keys for an exact IN-list. May pass values that are not in
+/// the set, but never rejects a value that is. Hence, this must only be used
+/// where false positives are removed downstream, e.g. by the join itself.
+class BigintValuesUsingBloomFilter final : public Filter {
+ public:
+  /// @param min Minimum value in the set.
+  /// @param max Maximum value in the set.
+  /// @param bloomFilter Bloom filter populated with all the values in the set.
+  /// Shared between all the copies of this filter.
+  /// @param nullAllowed Null values are passing the filter if true.
+  BigintValuesUsingBloomFilter(
+      int64_t min,
+      int64_t max,
+      std::shared_ptr<const BloomFilter<>> bloomFilter,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, FilterKind::kBigintValuesUsingBloomFilter),
+        min_(min),
+        max_(max),
+        bloomFilter_(std::move(bloomFilter)) {
+    VELOX_CHECK_LE(min_, max_);
+    VELOX_CHECK_NOT_NULL(bloomFilter_);
+  }
+
+  BigintValuesUsingBloomFilter(
+      const BigintValuesUsingBloomFilter& other,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, other.kind()),
+        min_(other.min_),
+        max_(other.max_),
+        bloomFilter_(other.bloomFilter_) {}
+
+  std::unique_ptr<Filter> clone(
+      std::optional<bool> nullAllowed = std::nullopt) const final {
+    return std::make_unique<BigintValuesUsingBloomFilter>(
+        *this, nullAllowed.value_or(nullAllowed_));
+  }
+
+  bool testInt64(int64_t value) const final {
+    return value >= min_ && value <= max_ && bloomFilter_->mayContain(value);
+  }
+
+  xsimd::batch_bool<int64_t> testValues(xsimd::batch<int64_t> x) const final;
+  xsimd::batch_bool<int32_t> testValues(xsimd::batch<int32_t> x) const final;
+  xsimd::batch_bool<int16_t> testValues(xsimd::batch<int16_t> x) const final {
+    return Filter::testValues(x);
+  }
+
+  bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final;
+
+  /// Merges with 'other' producing a filter that is at least as selective as
+  /// 'other'. If the two cannot be combined, returns a copy of 'other' since
+  /// 'this' is only an approximation.
+  std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
+
+  int64_t min() const {
+    return min_;
+  }
+
+  int64_t max() const {
+    return max_;
+  }
+
+  std::string toString() const final {
+    return fmt::format(
+        "BigintValuesUsingBloomFilter: [{}, {}] {}",
+        min_,
+        max_,
+        nullAllowed_ ? "with nulls" : "no nulls");
+  }
+
+ private:
+  const int64_t min_;
+  const int64_t max_;
+  const std::shared_ptr<const BloomFilter<>> bloomFilter_;
+};
+
 /// Base class for range filters on floating point and string data types.
 class AbstractRange : public Filter {
  public:
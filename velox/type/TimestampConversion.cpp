@@ -128,6 +128,52 @@ bool parseDoubleDigit(
   return false;
 }
 
+// Parses exactly 'count' digits at 'buf'.
+inline bool parseFixedDigits(const char* buf, int count, int32_t& result) {
+  result = 0;
+  for (auto i = 0; i < count; ++i) {
+    if (!characterIsDigit(buf[i])) {
+      return false;
+    }
+    result = result * 10 + (buf[i] - '0');
+  }
+  return true;
+}
+
+// Parses the fixed format YYYY-MM-DD at the start of 'buf', which must have
+// at least 10 characters. This is a fast path for the most common format.
+// Other formats are left to tryParseDateString().
+inline bool tryParseFixedDateString(const char* buf, int64_t& daysSinceEpoch) {
+  int32_t year;
+  int32_t month;
+  int32_t day;
+  if (buf[4] != '-' || buf[7] != '-' || !parseFixedDigits(buf, 4, year) ||
+      !parseFixedDigits(buf + 5, 2, month) ||
+      !parseFixedDigits(buf + 8, 2, day)) {
+    return false;
+  }
+  daysSinceEpoch = daysSinceEpochFromDate(year, month, day);
+  return true;
+}
+
+// Parses the fixed format HH:MM:SS, which must have 8 characters. Other
+// formats are left to tryParseTimeString().
+inline bool tryParseFixedTimeString(
+    const char* buf,
+    int64_t& microsSinceMidnight) {
+  int32_t hour;
+  int32_t minute;
+  int32_t second;
+  if (buf[2] != ':' || buf[5] != ':' || !parseFixedDigits(buf, 2, hour) ||
+      !parseFixedDigits(buf + 3, 2, minute) ||
+      !parseFixedDigits(buf + 6, 2, second) || hour >= 24 || minute >= 60 ||
+      second > 60) {
+    return false;
+  }
+  microsSinceMidnight = fromTime(hour, minute, second, 0);
+  return true;
+}
+
 bool isValidWeekDate(int32_t weekYear, int32_t weekOfYear, int32_t dayOfWeek) {
   if (dayOfWeek < 1 || dayOfWeek > 7) {
     return false;
@@ -497,6 +543,10 @@ int64_t fromDateString(const char* str, size_t len) {
   int64_t daysSinceEpoch;
   size_t pos = 0;
 
+  if (len == 10 && tryParseFixedDateString(str, daysSinceEpoch)) {
+    return daysSinceEpoch;
+  }
+
   if (!tryParseDateString(str, len, pos, daysSinceEpoch, true)) {
     VELOX_USER_FAIL(
         "Unable to parse date value: \"{}\", expected format is (YYYY-MM-DD)",
@@ -579,6 +629,17 @@ Timestamp fromTimestampString(const char* str, size_t len) {
   int64_t daysSinceEpoch;
   int64_t microsSinceMidnight;
 
+  // Fast path for YYYY-MM-DD and YYYY-MM-DD HH:MM:SS.
+  if ((len == 10 || (len == 19 && (str[10] == ' ' || str[10] == 'T'))) &&
+      tryParseFixedDateString(str, daysSinceEpoch)) {
+    if (len == 10) {
+      return fromDatetime(daysSinceEpoch, 0);
+    }
+    if (tryParseFixedTimeString(str + 11, microsSinceMidnight)) {
+      return fromDatetime(daysSinceEpoch, microsSinceMidnight);
+    }
+  }
+
   if (!tryParseDateString(str, len, pos, daysSinceEpoch, false)) {
     parserError(str, len);
   }
@@ -384,6 +384,71 @@ TEST(FilterTest, bigintValuesUsingHashTableSimd) {
   applySimdTestToVector(numbers32, *filter, verify);
 }
 
+TEST(FilterTest, bigintValuesUsingBloomFilter) {
+  std::vector<int64_t> numbers;
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(1'000);
+  for (auto i = 0; i < 1'000; ++i) {
+    numbers.push_back(i * 1'209);
+    bloomFilter->insert(numbers.back());
+  }
+  auto filter = std::make_unique<BigintValuesUsingBloomFilter>(
+      0, 999 * 1'209, bloomFilter, false);
+
+  // No false negatives.
+  for (auto n : numbers) {
+    EXPECT_TRUE(filter->testInt64(n));
+  }
+  EXPECT_FALSE(filter->testNull());
+  EXPECT_FALSE(filter->testInt64(-1));
+  EXPECT_FALSE(filter->testInt64(999 * 1'209 + 1));
+  EXPECT_FALSE(filter->testInt64(INT64_MAX));
+
+  // False positives are rare.
+  int32_t numPassed = 0;
+  for (auto i = 0; i < 999; ++i) {
+    numPassed += filter->testInt64(i * 1'209 + 1);
+  }
+  EXPECT_LT(numPassed, 100);
+
+  EXPECT_TRUE(filter->testInt64Range(0, 10, false));
+  EXPECT_FALSE(filter->testInt64Range(-10, -5, false));
+  EXPECT_FALSE(filter->testInt64Range(2'000'000, 3'000'000, false));
+  EXPECT_TRUE(filter->clone(true)->testNull());
+
+  int64_t outOfRange[] = {-100, -20000, 0x10000000, 0x20000000};
+  auto verify = [&](int64_t x) { return filter->testInt64(x); };
+  checkSimd(filter.get(), outOfRange, verify);
+  applySimdTestToVector(numbers, *filter, verify);
+
+  std::vector<int32_t> numbers32;
+  for (auto n : numbers) {
+    numbers32.push_back(n);
+  }
+  applySimdTestToVector(numbers32, *filter, verify);
+
+  // Merging with an exact filter is at least as selective as the exact filter.
+  auto merged = filter->mergeWith(
+      createBigintValues({1'209, 2'418, 1'210, 5'000'000}, true).get());
+  EXPECT_TRUE(merged->testInt64(1'209));
+  EXPECT_TRUE(merged->testInt64(2'418));
+  EXPECT_FALSE(merged->testInt64(5'000'000));
+  EXPECT_FALSE(merged->testInt64(3'627));
+  EXPECT_FALSE(merged->testNull());
+
+  merged = BigintRange(1'000, 10'000, false).mergeWith(filter.get());
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintValuesUsingBloomFilter);
+  EXPECT_TRUE(merged->testInt64(1'209));
+  EXPECT_FALSE(merged->testInt64(0));
+  EXPECT_FALSE(merged->testInt64(12'090));
+
+  merged = BigintRange(-10, -1, false).mergeWith(filter.get());
+  EXPECT_EQ(merged->kind(), FilterKind::kAlwaysFalse);
+
+  merged = NegatedBigintRange(0, 0, false).mergeWith(filter.get());
+  EXPECT_EQ(merged->kind(), FilterKind::kNegatedBigintRange);
+}
+
 TEST(FilterTest, negatedBigintValuesUsingHashTableSimd) {
   std::vector<int64_t> numbers;
   // make a worst case filter where every item falls on the same slot.
@@ -440,6 +505,17 @@ TEST(FilterTest, bigintValuesUsingBitmask) {
   EXPECT_FALSE(filter->testInt64Range(11, 11, false));
   EXPECT_FALSE(filter->testInt64Range(-10, -5, false));
   EXPECT_FALSE(filter->testInt64Range(1234, 2000, false));
+
+  auto testInt64 = [&](int64_t x) { return filter->testInt64(x); };
+  int64_t n4[] = {1, 2, 1000, INT64_MIN};
+  checkSimd(filter.get(), n4, testInt64);
+  int64_t outOfRange[] = {0, 1001, -1000, INT64_MAX};
+  checkSimd(filter.get(), outOfRange, testInt64);
+  int32_t n8[] = {10, 11, 100, 999, 1000, -1, 0, 1};
+  checkSimd(filter.get(), n8, testInt64);
+  int16_t n16[] = {
+      10, 11, 100, 999, 1000, -1, 0, 1, 2, 1, 1000, -1000, 1, 1, 0, 1111};
+  checkSimd(filter.get(), n16, testInt64);
 }
 
 TEST(FilterTest, negatedBigintValuesUsingBitmask) {
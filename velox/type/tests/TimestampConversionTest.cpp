@@ -107,6 +107,11 @@ TEST(DateTimeUtilTest, fromDateStrInvalid) {
   // Too large of a year.
   EXPECT_THROW(fromDateString("1000000"), VeloxUserError);
   EXPECT_THROW(fromDateString("-1000000"), VeloxUserError);
+
+  // Invalid dates in the common YYYY-MM-DD format.
+  EXPECT_THROW(fromDateString("2000-13-01"), VeloxUserError);
+  EXPECT_THROW(fromDateString("2001-02-29"), VeloxUserError);
+  EXPECT_THROW(fromDateString("2000-01-0a"), VeloxUserError);
 }
 
 TEST(DateTimeUtilTest, fromTimeString) {
@@ -178,6 +183,11 @@ TEST(DateTimeUtilTest, fromTimestampStrInvalid) {
   EXPECT_THROW(fromTimestampString(""), VeloxUserError);
   EXPECT_THROW(fromTimestampString("00:00:00"), VeloxUserError);
 
+  // Invalid times in the common YYYY-MM-DD HH:MM:SS format.
+  EXPECT_THROW(fromTimestampString("1970-01-01 24:00:00"), VeloxUserError);
+  EXPECT_THROW(fromTimestampString("1970-01-01 00:60:00"), VeloxUserError);
+  EXPECT_THROW(fromTimestampString("1970-01-01 00:00:0a"), VeloxUserError);
+
   // Broken UTC offsets.
   EXPECT_THROW(fromTimestampString("1970-01-01 00:00:00-asd"), VeloxUserError);
   EXPECT_THROW(
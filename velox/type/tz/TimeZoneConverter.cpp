@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/type/tz/TimeZoneConverter.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/external/date/tz.h"
+
+namespace facebook::velox::util {
+namespace {
+// Local times at or below this make time_zone::to_sys() SIGABRT. Same bound
+// as Timestamp::toGMT().
+constexpr int64_t kMinLocalSeconds = -1096193779200l + 86400l;
+} // namespace
+
+TimeZoneConverter::TimeZoneConverter(const date::time_zone* zone)
+    : zone_(zone) {
+  VELOX_CHECK_NOT_NULL(zone_);
+}
+
+int64_t TimeZoneConverter::toLocalSlow(int64_t seconds) {
+  lookUp(seconds);
+  return seconds + offset_;
+}
+
+int64_t TimeZoneConverter::toGMTSlow(int64_t seconds) {
+  if (seconds <= kMinLocalSeconds) {
+    VELOX_UNSUPPORTED(
+        "Timestamp out of bound for time zone adjustment {} seconds", seconds);
+  }
+  const date::local_seconds localTime{std::chrono::seconds(seconds)};
+  const auto gmt = zone_->to_sys(localTime, date::choose::latest)
+                       .time_since_epoch()
+                       .count();
+  lookUp(gmt);
+  return gmt;
+}
+
+void TimeZoneConverter::lookUp(int64_t seconds) {
+  const auto info =
+      zone_->get_info(date::sys_seconds(std::chrono::seconds(seconds)));
+  offset_ = info.offset.count();
+  // The range is clamped so that the local times of the fast path of
+  // toGMT() stay above kMinLocalSeconds.
+  begin_ = std::max<int64_t>(
+      info.begin.time_since_epoch().count(),
+      kMinLocalSeconds + 2 * kMaxOffsetChange);
+  end_ = info.end.time_since_epoch().count();
+  gmtEnd_ = end_ - kMaxOffsetChange;
+}
+
+} // namespace facebook::velox::util
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace date {
+class time_zone;
+}
+
+namespace facebook::velox::util {
+
+/// Converts seconds since epoch between GMT and the local time of a time
+/// zone. Looking up the offset of a time zone is a binary search over its
+/// transitions, so the converter remembers the range between the two
+/// transitions around the last lookup together with its offset. Times in
+/// the same range convert with a compare and an add. For zones without
+/// daylight saving time the range spans years, and for the others it is
+/// about half a year, enough for most batches of an event log. A converter
+/// is not thread safe and is meant to be part of the state of a function
+/// instance.
+class TimeZoneConverter {
+ public:
+  explicit TimeZoneConverter(const date::time_zone* zone);
+
+  const date::time_zone* zone() const {
+    return zone_;
+  }
+
+  /// Returns the local time in 'zone' at the moment 'seconds' in GMT.
+  int64_t toLocal(int64_t seconds) {
+    if (seconds >= begin_ && seconds < end_) {
+      return seconds + offset_;
+    }
+    return toLocalSlow(seconds);
+  }
+
+  /// Returns the GMT time of the local time 'seconds' in 'zone'. An
+  /// ambiguous local time resolves to the later moment. Throws if 'seconds'
+  /// is too far in the past for the time zone library.
+  int64_t toGMT(int64_t seconds) {
+    const auto gmt = seconds - offset_;
+    if (gmt >= begin_ && gmt < gmtEnd_) {
+      return gmt;
+    }
+    return toGMTSlow(seconds);
+  }
+
+ private:
+  // A change of offset at a transition is less than this, so local times
+  // that are further than this from the end of a range belong to the range
+  // only.
+  static constexpr int64_t kMaxOffsetChange = 86'400;
+
+  int64_t toLocalSlow(int64_t seconds);
+
+  int64_t toGMTSlow(int64_t seconds);
+
+  // Remembers the range of GMT 'seconds' and its offset.
+  void lookUp(int64_t seconds);
+
+  const date::time_zone* zone_;
+
+  // The GMT range [begin_, end_) with 'offset_' from the last lookup. Empty
+  // until the first lookup.
+  int64_t begin_{0};
+  int64_t end_{0};
+  int64_t offset_{0};
+  // The end of the GMT times that local times convert to with 'offset_'.
+  int64_t gmtEnd_{0};
+};
+
+} // namespace facebook::velox::util
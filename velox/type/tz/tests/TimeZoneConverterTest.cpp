@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/external/date/tz.h"
+#include "velox/type/tz/TimeZoneConverter.h"
+
+namespace facebook::velox::util {
+namespace {
+
+int64_t expectedLocal(const date::time_zone* zone, int64_t seconds) {
+  return zone->to_local(date::sys_seconds(std::chrono::seconds(seconds)))
+      .time_since_epoch()
+      .count();
+}
+
+int64_t expectedGMT(const date::time_zone* zone, int64_t seconds) {
+  return zone
+      ->to_sys(
+          date::local_seconds(std::chrono::seconds(seconds)),
+          date::choose::latest)
+      .time_since_epoch()
+      .count();
+}
+
+// Converts every 'step' seconds over two years starting at 2021-01-01, which
+// crosses the daylight saving time transitions of the zones below, including
+// the ambiguous and nonexistent local times around them.
+void testZone(const std::string& name, int64_t step) {
+  SCOPED_TRACE(name);
+  const auto* zone = date::locate_zone(name);
+  TimeZoneConverter converter(zone);
+  constexpr int64_t kStart = 1'609'459'200;
+  constexpr int64_t kEnd = kStart + 2 * 365 * 86'400;
+  for (auto seconds = kStart; seconds < kEnd; seconds += step) {
+    ASSERT_EQ(expectedLocal(zone, seconds), converter.toLocal(seconds))
+        << seconds;
+    ASSERT_EQ(expectedGMT(zone, seconds), converter.toGMT(seconds))
+        << seconds;
+  }
+  // Going back and forth between distant times misses the cached range.
+  for (auto seconds : {kEnd, kStart, kEnd + 86'400 * 180, int64_t(0)}) {
+    EXPECT_EQ(expectedLocal(zone, seconds), converter.toLocal(seconds));
+    EXPECT_EQ(expectedGMT(zone, seconds), converter.toGMT(seconds));
+  }
+}
+
+TEST(TimeZoneConverterTest, daylightSavingTime) {
+  testZone("America/Los_Angeles", 600);
+  testZone("Europe/Berlin", 900);
+  testZone("Australia/Sydney", 900);
+}
+
+TEST(TimeZoneConverterTest, fixedOffset) {
+  testZone("Asia/Kolkata", 3'600);
+  testZone("UTC", 3'600);
+}
+
+TEST(TimeZoneConverterTest, outOfRange) {
+  TimeZoneConverter converter(date::locate_zone("America/Los_Angeles"));
+  EXPECT_THROW(converter.toGMT(-1096193779200l), VeloxUserError);
+}
+
+} // namespace
+} // namespace facebook::velox::util
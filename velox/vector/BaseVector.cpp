@@ -139,6 +139,51 @@ VectorPtr BaseVector::wrapInDictionary(
       addDictionary, kind, nulls, indices, size, std::move(vector));
 }
 
+// static
+bool BaseVector::shouldCopyInsteadOfWrap(
+    vector_size_t size,
+    const BaseVector& vector) {
+  int32_t nesting = 0;
+  const BaseVector* base = &vector;
+  while (base->encoding() == VectorEncoding::Simple::DICTIONARY) {
+    ++nesting;
+    base = base->valueVector().get();
+  }
+  if (base->encoding() == VectorEncoding::Simple::LAZY) {
+    // The lazy vector may be loaded only for some rows.
+    return false;
+  }
+  if (nesting >= kMaxDictionaryNesting) {
+    return true;
+  }
+  if (base->encoding() == VectorEncoding::Simple::CONSTANT) {
+    // Wrapping a constant makes a constant.
+    return false;
+  }
+  // The copy is cheap and frees the dropped rows if at most half of the rows
+  // are kept and these are narrow.
+  const auto& type = vector.type();
+  return type->isFixedWidth() &&
+      type->cppSizeInBytes() <= kMaxCopyInsteadOfWrapRowBytes &&
+      size <= vector.size() / 2;
+}
+
+// static
+VectorPtr BaseVector::wrapInDictionaryOrCopy(
+    BufferPtr nulls,
+    BufferPtr indices,
+    vector_size_t size,
+    VectorPtr vector) {
+  if (nulls || !shouldCopyInsteadOfWrap(size, *vector)) {
+    return wrapInDictionary(
+        std::move(nulls), std::move(indices), size, std::move(vector));
+  }
+  auto result = BaseVector::create(vector->type(), size, vector->pool());
+  SelectivityVector rows(size);
+  result->copy(vector.get(), rows, indices->as<vector_size_t>());
+  return result;
+}
+
 template <TypeKind kind>
 static VectorPtr
 addSequence(BufferPtr lengths, vector_size_t size, VectorPtr vector) {
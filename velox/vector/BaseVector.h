@@ -57,6 +57,14 @@ class BaseVector {
  public:
   static constexpr uint64_t kNullHash = 1;
 
+  /// Dictionaries over vectors with this many levels of dictionaries are
+  /// flattened by wrapInDictionaryOrCopy().
+  static constexpr int32_t kMaxDictionaryNesting = 2;
+
+  /// Maximum bytes per row of the vectors flattened by
+  /// wrapInDictionaryOrCopy() after a selective filter.
+  static constexpr int32_t kMaxCopyInsteadOfWrapRowBytes = 16;
+
   BaseVector(
       velox::memory::MemoryPool* pool,
       TypePtr type,
@@ -451,6 +459,26 @@ class BaseVector {
       vector_size_t size,
       std::shared_ptr<BaseVector> vector);
 
+  /// Returns true if the 'size' rows of a dictionary over 'vector' are
+  /// better copied into a flat vector than wrapped. Copying pays off for
+  /// narrow fixed-width rows when most rows of 'vector' are dropped, e.g.
+  /// after a selective filter, since the copy is cheap and frees the dropped
+  /// rows. It also pays off when 'vector' is already nested
+  /// kMaxDictionaryNesting dictionaries deep, since each level is an extra
+  /// indirection on every access downstream. Dictionaries over lazy
+  /// vectors are never copied.
+  static bool shouldCopyInsteadOfWrap(
+      vector_size_t size,
+      const BaseVector& vector);
+
+  /// Same as wrapInDictionary() but copies the rows at 'indices' into a new
+  /// flat vector if shouldCopyInsteadOfWrap() and there are no 'nulls'.
+  static std::shared_ptr<BaseVector> wrapInDictionaryOrCopy(
+      BufferPtr nulls,
+      BufferPtr indices,
+      vector_size_t size,
+      std::shared_ptr<BaseVector> vector);
+
   static std::shared_ptr<BaseVector> wrapInSequence(
       BufferPtr lengths,
       vector_size_t size,
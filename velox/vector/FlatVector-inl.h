@@ -160,7 +160,26 @@ void FlatVector<T>::copyValuesAndNulls(
     auto flat = source->asUnchecked<FlatVector<T>>();
     auto* sourceValues =
         source->typeKind() != TypeKind::UNKNOWN ? flat->rawValues() : nullptr;
-    if (toSourceRow) {
+    if (toSourceRow && isContiguous(rows)) {
+      // Gathers a whole batch, e.g. the output of a merge. The loop over the
+      // values has no per-row branches and the nulls are gathered a byte at
+      // a time.
+      const auto begin = rows.begin();
+      const auto end = rows.end();
+      if (sourceValues) {
+        for (auto row = begin; row < end; ++row) {
+          rawValues_[row] = sourceValues[toSourceRow[row]];
+        }
+      }
+      if (rawNulls) {
+        if (sourceNulls) {
+          simd::gatherBits(
+              sourceNulls, toSourceRow + begin, end - begin, rawNulls, begin);
+        } else {
+          bits::fillBits(rawNulls, begin, end, bits::kNotNull);
+        }
+      }
+    } else if (toSourceRow) {
       rows.applyToSelected([&](auto row) {
         auto sourceRow = toSourceRow[row];
         if (sourceValues) {
@@ -217,14 +236,17 @@ void FlatVector<T>::copyValuesAndNulls(
 template <typename T>
 void FlatVector<T>::copyValuesAndNulls(
     const BaseVector* source,
-    vector_size_t targetIndex,
-    vector_size_t sourceIndex,
-    vector_size_t count) {
+    const folly::Range<const CopyRange*>& ranges) {
+  if (ranges.empty()) {
+    return;
+  }
   source = source->loadedVector();
   VELOX_CHECK(
       BaseVector::compatibleKind(BaseVector::typeKind(), source->typeKind()));
-  VELOX_CHECK_GE(source->size(), sourceIndex + count);
-  VELOX_CHECK_GE(BaseVector::length_, targetIndex + count);
+  for (auto& range : ranges) {
+    VELOX_CHECK_GE(source->size(), range.sourceIndex + range.count);
+    VELOX_CHECK_GE(BaseVector::length_, range.targetIndex + range.count);
+  }
   const uint64_t* sourceNulls = source->rawNulls();
   uint64_t* rawNulls = const_cast<uint64_t*>(BaseVector::rawNulls_);
   if (source->mayHaveNulls()) {
@@ -244,51 +266,79 @@ void FlatVector<T>::copyValuesAndNulls(
       VELOX_CHECK_EQ(
           BaseVector::countNulls(flat->nulls(), 0, flat->size()), flat->size());
     } else if (source->typeKind() != TypeKind::UNKNOWN) {
-      if (Buffer::is_pod_like_v<T>) {
-        memcpy(
-            &rawValues_[targetIndex],
-            &flat->rawValues()[sourceIndex],
-            count * sizeof(T));
-      } else {
-        const T* srcValues = flat->rawValues();
-        std::copy(
-            srcValues + sourceIndex,
-            srcValues + sourceIndex + count,
-            rawValues_ + targetIndex);
+      const T* srcValues = flat->rawValues();
+      for (auto& range : ranges) {
+        if (Buffer::is_pod_like_v<T>) {
+          memcpy(
+              &rawValues_[range.targetIndex],
+              &srcValues[range.sourceIndex],
+              range.count * sizeof(T));
+        } else {
+          std::copy(
+              srcValues + range.sourceIndex,
+              srcValues + range.sourceIndex + range.count,
+              rawValues_ + range.targetIndex);
+        }
       }
     }
     if (rawNulls) {
-      if (sourceNulls) {
-        bits::copyBits(sourceNulls, sourceIndex, rawNulls, targetIndex, count);
-      } else {
-        bits::fillBits(
-            rawNulls, targetIndex, targetIndex + count, bits::kNotNull);
+      for (auto& range : ranges) {
+        if (sourceNulls) {
+          bits::copyBits(
+              sourceNulls,
+              range.sourceIndex,
+              rawNulls,
+              range.targetIndex,
+              range.count);
+        } else {
+          bits::fillBits(
+              rawNulls,
+              range.targetIndex,
+              range.targetIndex + range.count,
+              bits::kNotNull);
+        }
       }
     }
   } else if (source->isConstantEncoding()) {
     if (source->isNullAt(0)) {
-      bits::fillBits(rawNulls, targetIndex, targetIndex + count, bits::kNull);
+      for (auto& range : ranges) {
+        bits::fillBits(
+            rawNulls,
+            range.targetIndex,
+            range.targetIndex + range.count,
+            bits::kNull);
+      }
       return;
     }
     auto constant = source->asUnchecked<ConstantVector<T>>();
     T value = constant->valueAt(0);
-    for (auto row = targetIndex; row < targetIndex + count; ++row) {
-      rawValues_[row] = value;
-    }
-    if (rawNulls) {
-      bits::fillBits(
-          rawNulls, targetIndex, targetIndex + count, bits::kNotNull);
+    for (auto& range : ranges) {
+      std::fill(
+          rawValues_ + range.targetIndex,
+          rawValues_ + range.targetIndex + range.count,
+          value);
+      if (rawNulls) {
+        bits::fillBits(
+            rawNulls,
+            range.targetIndex,
+            range.targetIndex + range.count,
+            bits::kNotNull);
+      }
     }
   } else {
     auto sourceVector = source->asUnchecked<SimpleVector<T>>();
-    for (int32_t i = 0; i < count; ++i) {
-      if (!source->isNullAt(sourceIndex + i)) {
-        rawValues_[targetIndex + i] = sourceVector->valueAt(sourceIndex + i);
-        if (rawNulls) {
-          bits::clearNull(rawNulls, targetIndex + i);
+    for (auto& range : ranges) {
+      for (int32_t i = 0; i < range.count; ++i) {
+        const auto sourceRow = range.sourceIndex + i;
+        const auto row = range.targetIndex + i;
+        if (!source->isNullAt(sourceRow)) {
+          rawValues_[row] = sourceVector->valueAt(sourceRow);
+          if (rawNulls) {
+            bits::clearNull(rawNulls, row);
+          }
+        } else {
+          bits::setNull(rawNulls, row);
         }
-      } else {
-        bits::setNull(rawNulls, targetIndex + i);
       }
     }
   }
@@ -70,7 +70,21 @@ void FlatVector<bool>::copyValuesAndNulls(
       rows.applyToSelected(
           [&](auto row) { bits::setNull(rawNulls, row, true); });
     } else {
-      if (toSourceRow) {
+      if (toSourceRow && isContiguous(rows)) {
+        // Gathers the values and nulls of a whole batch a byte at a time.
+        const auto begin = rows.begin();
+        const auto end = rows.end();
+        simd::gatherBits(
+            sourceValues, toSourceRow + begin, end - begin, rawValues, begin);
+        if (rawNulls) {
+          if (sourceNulls) {
+            simd::gatherBits(
+                sourceNulls, toSourceRow + begin, end - begin, rawNulls, begin);
+          } else {
+            bits::fillBits(rawNulls, begin, end, bits::kNotNull);
+          }
+        }
+      } else if (toSourceRow) {
         rows.applyToSelected([&](auto row) {
           int32_t sourceRow = toSourceRow[row];
           if (sourceValues) {
@@ -132,14 +146,17 @@ void FlatVector<bool>::copyValuesAndNulls(
 template <>
 void FlatVector<bool>::copyValuesAndNulls(
     const BaseVector* source,
-    vector_size_t targetIndex,
-    vector_size_t sourceIndex,
-    vector_size_t count) {
+    const folly::Range<const CopyRange*>& ranges) {
+  if (ranges.empty()) {
+    return;
+  }
   source = source->loadedVector();
   VELOX_CHECK(
       BaseVector::compatibleKind(BaseVector::typeKind(), source->typeKind()));
-  VELOX_CHECK(source->size() >= sourceIndex + count);
-  VELOX_CHECK(BaseVector::length_ >= targetIndex + count);
+  for (auto& range : ranges) {
+    VELOX_CHECK(source->size() >= range.sourceIndex + range.count);
+    VELOX_CHECK(BaseVector::length_ >= range.targetIndex + range.count);
+  }
 
   const uint64_t* sourceNulls = source->rawNulls();
   auto rawValues = reinterpret_cast<uint64_t*>(rawValues_);
@@ -151,45 +168,75 @@ void FlatVector<bool>::copyValuesAndNulls(
     if (source->typeKind() != TypeKind::UNKNOWN) {
       auto* sourceValues =
           source->asUnchecked<FlatVector<bool>>()->rawValues<uint64_t>();
-      bits::copyBits(sourceValues, sourceIndex, rawValues, targetIndex, count);
+      for (auto& range : ranges) {
+        bits::copyBits(
+            sourceValues,
+            range.sourceIndex,
+            rawValues,
+            range.targetIndex,
+            range.count);
+      }
     }
     if (rawNulls) {
-      if (sourceNulls) {
-        bits::copyBits(sourceNulls, sourceIndex, rawNulls, targetIndex, count);
-      } else {
-        bits::fillBits(
-            rawNulls, targetIndex, targetIndex + count, bits::kNotNull);
+      for (auto& range : ranges) {
+        if (sourceNulls) {
+          bits::copyBits(
+              sourceNulls,
+              range.sourceIndex,
+              rawNulls,
+              range.targetIndex,
+              range.count);
+        } else {
+          bits::fillBits(
+              rawNulls,
+              range.targetIndex,
+              range.targetIndex + range.count,
+              bits::kNotNull);
+        }
       }
     }
   } else if (source->isConstantEncoding()) {
     auto constant = source->asUnchecked<ConstantVector<bool>>();
     if (constant->isNullAt(0)) {
-      bits::fillBits(rawNulls, targetIndex, targetIndex + count, bits::kNull);
+      for (auto& range : ranges) {
+        bits::fillBits(
+            rawNulls,
+            range.targetIndex,
+            range.targetIndex + range.count,
+            bits::kNull);
+      }
       return;
     }
     bool value = constant->valueAt(0);
-    bits::fillBits(rawValues, targetIndex, targetIndex + count, value);
-    if (rawNulls) {
+    for (auto& range : ranges) {
       bits::fillBits(
-          rawNulls, targetIndex, targetIndex + count, bits::kNotNull);
+          rawValues, range.targetIndex, range.targetIndex + range.count, value);
+      if (rawNulls) {
+        bits::fillBits(
+            rawNulls,
+            range.targetIndex,
+            range.targetIndex + range.count,
+            bits::kNotNull);
+      }
     }
   } else {
     auto sourceVector = source->typeKind() != TypeKind::UNKNOWN
         ? source->asUnchecked<SimpleVector<bool>>()
         : nullptr;
-    for (int32_t i = 0; i < count; ++i) {
-      if (!source->isNullAt(sourceIndex + i)) {
-        if (sourceVector) {
-          bits::setBit(
-              rawValues,
-              targetIndex + i,
-              sourceVector->valueAt(sourceIndex + i));
-        }
-        if (rawNulls) {
-          bits::clearNull(rawNulls, targetIndex + i);
+    for (auto& range : ranges) {
+      for (int32_t i = 0; i < range.count; ++i) {
+        const auto sourceRow = range.sourceIndex + i;
+        const auto row = range.targetIndex + i;
+        if (!source->isNullAt(sourceRow)) {
+          if (sourceVector) {
+            bits::setBit(rawValues, row, sourceVector->valueAt(sourceRow));
+          }
+          if (rawNulls) {
+            bits::clearNull(rawNulls, row);
+          }
+        } else {
+          bits::setNull(rawNulls, row);
         }
-      } else {
-        bits::setNull(rawNulls, targetIndex + i);
       }
     }
   }
@@ -211,6 +258,16 @@ Buffer* FlatVector<StringView>::getBufferWithSpace(vector_size_t size) {
   int32_t newSize = std::max(kInitialStringSize, size);
   BufferPtr newBuffer = AlignedBuffer::allocate<char>(newSize, pool());
   newBuffer->setSize(0);
+  if (size > kInitialStringSize && buffer && buffer->unique() &&
+      buffer->size() < buffer->capacity()) {
+    // A string larger than a regular buffer gets a buffer of its own. The
+    // last buffer stays last so that the following strings fill its free
+    // space instead of leaving it unused.
+    if (stringBufferSet_.insert(newBuffer.get()).second) {
+      stringBuffers_.insert(stringBuffers_.end() - 1, newBuffer);
+    }
+    return newBuffer.get();
+  }
   addStringBuffer(newBuffer);
   return newBuffer.get();
 }
@@ -317,6 +374,45 @@ void FlatVector<StringView>::acquireSharedStringBuffers(
   }
 }
 
+template <>
+int64_t FlatVector<StringView>::unreferencedStringBytes(
+    const BaseVector* source) const {
+  auto leaf = source->wrappedVector();
+  if (leaf->encoding() != VectorEncoding::Simple::FLAT) {
+    return 0;
+  }
+  auto* flat = leaf->asUnchecked<FlatVector<StringView>>();
+  int64_t bytes = 0;
+  for (auto& buffer : flat->stringBuffers_) {
+    if (stringBufferSet_.count(buffer.get()) == 0) {
+      bytes += buffer->size();
+    }
+  }
+  return bytes;
+}
+
+template <>
+int64_t FlatVector<StringView>::outOfLineStringBytes(vector_size_t row) const {
+  if (isNullAt(row) || rawValues_[row].isInline()) {
+    return 0;
+  }
+  return rawValues_[row].size();
+}
+
+template <>
+void FlatVector<StringView>::copyStringToBuffer(
+    vector_size_t row,
+    Buffer* buffer) {
+  const auto size = outOfLineStringBytes(row);
+  if (size == 0) {
+    return;
+  }
+  char* ptr = buffer->asMutable<char>() + buffer->size();
+  memcpy(ptr, rawValues_[row].data(), size);
+  buffer->setSize(buffer->size() + size);
+  rawValues_[row] = StringView(ptr, size);
+}
+
 template <>
 void FlatVector<StringView>::copy(
     const BaseVector* source,
@@ -344,9 +440,22 @@ void FlatVector<StringView>::copy(
   auto leaf = source->wrappedVector()->asUnchecked<SimpleVector<StringView>>();
 
   if (pool_ == leaf->pool()) {
-    // We copy referencing the storage of 'source'.
+    // We copy referencing the storage of 'source', unless the copied strings
+    // are a small part of it, e.g. the rows that passed a filter. The
+    // strings are then copied so as not to hold on to mostly dead buffers.
     copyValuesAndNulls(source, rows, toSourceRow);
-    acquireSharedStringBuffers(source);
+    int64_t copiedBytes = 0;
+    rows.applyToSelected(
+        [&](auto row) { copiedBytes += outOfLineStringBytes(row); });
+    if (copiedBytes > 0 &&
+        copiedBytes * kStringCopyRatio <
+            unreferencedStringBytes(source)) {
+      auto* buffer =
+          getBufferWithSpace(static_cast<vector_size_t>(copiedBytes));
+      rows.applyToSelected([&](auto row) { copyStringToBuffer(row, buffer); });
+    } else {
+      acquireSharedStringBuffers(source);
+    }
   } else {
     rows.applyToSelected([&](vector_size_t row) {
       auto sourceRow = toSourceRow ? toSourceRow[row] : row;
@@ -390,11 +499,32 @@ void FlatVector<StringView>::copyRanges(
     const folly::Range<const CopyRange*>& ranges) {
   auto leaf = source->wrappedVector()->asUnchecked<SimpleVector<StringView>>();
   if (pool_ == leaf->pool()) {
-    // We copy referencing the storage of 'source'.
-    for (auto& r : ranges) {
-      copyValuesAndNulls(source, r.targetIndex, r.sourceIndex, r.count);
+    // We copy referencing the storage of 'source' unless the copied strings
+    // are a small part of it, as in copy() above.
+    copyValuesAndNulls(source, ranges);
+    int64_t copiedBytes = 0;
+    for (auto& range : ranges) {
+      for (auto row = range.targetIndex;
+           row < range.targetIndex + range.count;
+           ++row) {
+        copiedBytes += outOfLineStringBytes(row);
+      }
+    }
+    if (copiedBytes > 0 &&
+        copiedBytes * kStringCopyRatio <
+            unreferencedStringBytes(source)) {
+      auto* buffer =
+          getBufferWithSpace(static_cast<vector_size_t>(copiedBytes));
+      for (auto& range : ranges) {
+        for (auto row = range.targetIndex;
+             row < range.targetIndex + range.count;
+             ++row) {
+          copyStringToBuffer(row, buffer);
+        }
+      }
+    } else {
+      acquireSharedStringBuffers(source);
     }
-    acquireSharedStringBuffers(source);
   } else {
     for (auto& r : ranges) {
       for (auto i = 0; i < r.count; ++i) {
@@ -51,6 +51,12 @@ class FlatVector final : public SimpleVector<T> {
   /// BaseVector::prepareForReuse): 1MB.
   static constexpr vector_size_t kMaxStringSizeForReuse =
       (1 << 20) - sizeof(AlignedBuffer);
+  /// A copy of strings from a vector in the same pool references the string
+  /// buffers of the source, unless these have more than kStringCopyRatio
+  /// times the copied bytes. The strings are then copied so that a few rows,
+  /// e.g. the rows that passed a filter, do not hold on to mostly dead
+  /// buffers.
+  static constexpr int64_t kStringCopyRatio = 2;
 
   FlatVector(
       velox::memory::MemoryPool* pool,
@@ -254,15 +260,14 @@ class FlatVector final : public SimpleVector<T> {
       vector_size_t targetIndex,
       vector_size_t sourceIndex,
       vector_size_t count) override {
-    copyValuesAndNulls(source, targetIndex, sourceIndex, count);
+    const CopyRange range{sourceIndex, targetIndex, count};
+    copyValuesAndNulls(source, folly::Range(&range, 1));
   }
 
   void copyRanges(
       const BaseVector* source,
       const folly::Range<const BaseVector::CopyRange*>& ranges) override {
-    for (auto& range : ranges) {
-      copy(source, range.targetIndex, range.sourceIndex, range.count);
-    }
+    copyValuesAndNulls(source, ranges);
   }
 
   void resize(vector_size_t size, bool setNotNull = true) override;
@@ -443,11 +448,30 @@ class FlatVector final : public SimpleVector<T> {
       const SelectivityVector& rows,
       const vector_size_t* toSourceRow);
 
+  // Copies the values and nulls of all 'ranges' with one check of the
+  // encoding of 'source'.
   void copyValuesAndNulls(
       const BaseVector* source,
-      vector_size_t targetIndex,
-      vector_size_t sourceIndex,
-      vector_size_t count);
+      const folly::Range<const CopyRange*>& ranges);
+
+  // Returns the number of bytes in the string buffers of 'source' that this
+  // vector does not reference yet.
+  int64_t unreferencedStringBytes(const BaseVector* source) const;
+
+  // Returns the number of bytes of the non-null, non-inlined strings at
+  // 'row'.
+  int64_t outOfLineStringBytes(vector_size_t row) const;
+
+  // Copies the string at 'row' into 'buffer' if it is not null and not
+  // inlined. 'buffer' must have space for it.
+  void copyStringToBuffer(vector_size_t row, Buffer* buffer);
+
+  // Returns true if all rows between the first and last selected row are
+  // selected. A copy from 'toSourceRow' into such 'rows' is a gather.
+  static bool isContiguous(const SelectivityVector& rows) {
+    return rows.isAllSelected() ||
+        bits::isAllSet(rows.asRange().bits(), rows.begin(), rows.end());
+  }
 
   // Contiguous values.
   // If strings, these are velox::StringViews into memory held by
@@ -516,13 +540,23 @@ void FlatVector<bool>::copyValuesAndNulls(
 template <>
 void FlatVector<bool>::copyValuesAndNulls(
     const BaseVector* source,
-    vector_size_t targetIndex,
-    vector_size_t sourceIndex,
-    vector_size_t count);
+    const folly::Range<const CopyRange*>& ranges);
 
 template <>
 Buffer* FlatVector<StringView>::getBufferWithSpace(vector_size_t size);
 
+template <>
+int64_t FlatVector<StringView>::unreferencedStringBytes(
+    const BaseVector* source) const;
+
+template <>
+int64_t FlatVector<StringView>::outOfLineStringBytes(vector_size_t row) const;
+
+template <>
+void FlatVector<StringView>::copyStringToBuffer(
+    vector_size_t row,
+    Buffer* buffer);
+
 template <>
 void FlatVector<StringView>::prepareForReuse();
 
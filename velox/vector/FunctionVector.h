@@ -30,6 +30,13 @@ class Callable {
 
   virtual bool hasCapture() const = 0;
 
+  // Returns true if some captures are not constant. Constant captures are
+  // the same for all rows and need no 'wrapCapture' to be aligned with the
+  // arguments.
+  virtual bool hasNonConstantCapture() const {
+    return hasCapture();
+  }
+
   // Applies 'this' to 'args' for 'rows' and returns the result in
   // '*result'.  'wrapCapture' translates row numbers in 'rows' to the
   // corresponding numbers for captured variables, i.e. is an indices
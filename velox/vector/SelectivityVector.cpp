@@ -15,6 +15,8 @@
  */
 #include "velox/vector/SelectivityVector.h"
 
+#include "velox/common/base/SimdUtil.h"
+
 namespace facebook::velox {
 
 // static
@@ -27,6 +29,19 @@ SelectivityVector SelectivityVector::empty(vector_size_t size) {
   return SelectivityVector{size, false};
 }
 
+const std::vector<vector_size_t>& SelectivityVector::selectedIndices() const {
+  if (!indicesValid_) {
+    // indicesOfSetBits() stores whole batches and may write past the last
+    // index.
+    indices_.resize(countSelected() + xsimd::batch<int32_t>::size);
+    const auto numSelected =
+        simd::indicesOfSetBits(bits_.data(), begin_, end_, indices_.data());
+    indices_.resize(numSelected);
+    indicesValid_ = true;
+  }
+  return indices_;
+}
+
 std::string SelectivityVector::toString(
     vector_size_t maxSelectedRowsToPrint) const {
   const auto selectedCnt = countSelected();
@@ -88,6 +88,7 @@ class SelectivityVector {
     begin_ = 0;
     end_ = value ? size_ : 0;
     allSelected_ = value;
+    indicesValid_ = false;
   }
 
   /**
@@ -99,6 +100,7 @@ class SelectivityVector {
     VELOX_DCHECK_LT(idx, bits_.size() * sizeof(bits_[0]) * 8);
     bits::setBit(bits_.data(), idx, valid);
     allSelected_.reset();
+    indicesValid_ = false;
   }
 
   /**
@@ -110,6 +112,7 @@ class SelectivityVector {
     VELOX_DCHECK_LE(end, bits_.size() * sizeof(bits_[0]) * 8);
     bits::fillBits(bits_.data(), begin, end, valid);
     allSelected_.reset();
+    indicesValid_ = false;
   }
 
   /**
@@ -127,6 +130,7 @@ class SelectivityVector {
    * updateBounds() need to be called explicitly if data is modified.
    */
   MutableRange<bool> asMutableRange() {
+    indicesValid_ = false;
     return MutableRange<bool>(bits_.data(), begin_, end_);
   }
 
@@ -136,6 +140,7 @@ class SelectivityVector {
     begin_ = begin;
     end_ = end;
     allSelected_.reset();
+    indicesValid_ = false;
   }
 
   vector_size_t begin() const {
@@ -161,6 +166,7 @@ class SelectivityVector {
     begin_ = 0;
     end_ = 0;
     allSelected_ = false;
+    indicesValid_ = false;
   }
 
   /**
@@ -171,6 +177,7 @@ class SelectivityVector {
     begin_ = 0;
     end_ = size_;
     allSelected_ = true;
+    indicesValid_ = false;
   }
 
   void setFromBits(const uint64_t* bits, int32_t size) {
@@ -279,6 +286,7 @@ class SelectivityVector {
    * index (noting that the range in between may contain not selected indices).
    */
   void updateBounds() {
+    indicesValid_ = false;
     begin_ = bits::findFirstBit(bits_.data(), 0, size_);
     if (begin_ == -1) {
       begin_ = 0;
@@ -330,8 +338,25 @@ class SelectivityVector {
     return !(*this == other);
   }
 
+  /// Returns the selected rows in ascending order. The rows are extracted
+  /// from the bits with SIMD on first use and kept until the selection
+  /// changes, so that the functions of an expression that loop over the same
+  /// sparse selection do not each scan the bits.
+  const std::vector<vector_size_t>& selectedIndices() const;
+
+  /// Returns true if at most 1 / kSparseRatio of the rows in [begin(), end())
+  /// are selected. A loop over selectedIndices() is then cheaper than
+  /// scanning the bits, which mostly finds rows that are not selected.
+  bool isSparse() const {
+    if (indicesValid_) {
+      return indices_.size() * kSparseRatio <= size_t(end_ - begin_);
+    }
+    return !isAllSelected() && countSelected() * kSparseRatio <= end_ - begin_;
+  }
+
   /// Invokes a function on each selected row. The function must take a single
-  /// "row" argument of type vector_size_t and return void.
+  /// "row" argument of type vector_size_t and return void. Loops over
+  /// selectedIndices() if these have been computed.
   template <typename Callable>
   void applyToSelected(Callable func) const;
 
@@ -367,6 +392,8 @@ class SelectivityVector {
   }
 
  private:
+  static constexpr int32_t kSparseRatio = 8;
+
   // the vector of bits for what is selected vs not (1 is selected)
   std::vector<uint64_t> bits_;
   // The number of leading bits used in 'bits_'.
@@ -376,6 +403,9 @@ class SelectivityVector {
   // one past the last selected value, if there are any selected
   vector_size_t end_ = 0;
   mutable std::optional<bool> allSelected_;
+  // The selected rows if 'indicesValid_'. Set by selectedIndices().
+  mutable std::vector<vector_size_t> indices_;
+  mutable bool indicesValid_ = false;
 
   friend class SelectivityIterator;
 };
@@ -428,6 +458,10 @@ inline void SelectivityVector::applyToSelected(Callable func) const {
     for (vector_size_t row = begin_; row < end_; ++row) {
       func(row);
     }
+  } else if (indicesValid_) {
+    for (auto row : indices_) {
+      func(row);
+    }
   } else {
     bits::forEachSetBit(bits_.data(), begin_, end_, func);
   }
@@ -55,6 +55,32 @@ size_t VectorPool::release(std::vector<VectorPtr>& vectors) {
   return numReleased;
 }
 
+VectorPtr VectorPool::getReusable(const TypePtr& type, vector_size_t size) {
+  VectorPtr* freeSlot = nullptr;
+  for (auto& vector : reusable_) {
+    if (vector == nullptr) {
+      freeSlot = &vector;
+      continue;
+    }
+    if (!vector.unique()) {
+      continue;
+    }
+    if (vector->type()->equivalent(*type)) {
+      VectorPtr result = std::move(vector);
+      BaseVector::prepareForReuse(result, size);
+      vector = result;
+      return result;
+    }
+    // A vector of another type that nobody uses is dropped.
+    freeSlot = &vector;
+  }
+  auto result = BaseVector::create(type, size, pool_);
+  if (freeSlot != nullptr) {
+    *freeSlot = result;
+  }
+  return result;
+}
+
 bool VectorPool::TypePool::maybePushBack(VectorPtr& vector) {
   // Check that this is a Flat Vector with an initialized, unique, and mutable
   // values Buffer and an uninitialized or unique and mutable nulls Buffer.
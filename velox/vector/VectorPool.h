@@ -37,6 +37,16 @@ class VectorPool {
 
   size_t release(std::vector<VectorPtr>& vectors);
 
+  /// Gets a vector of 'type' and 'size' for a result that is handed to
+  /// consumers that may keep references to it, e.g. the output of an
+  /// operator. Keeps a reference to the vectors it returns and reuses one of
+  /// 'type' once all other references to it are dropped, so that its memory
+  /// comes back without the consumer releasing it. Any vector of 'type',
+  /// including complex types, can be reused. The children of a reused
+  /// RowVector that are still referenced elsewhere are replaced and the
+  /// others have size 0.
+  VectorPtr getReusable(const TypePtr& type, vector_size_t size);
+
  private:
   static constexpr int32_t kNumCachedVectorTypes =
       static_cast<int32_t>(TypeKind::ARRAY);
@@ -44,6 +54,8 @@ class VectorPool {
   /// the batch the less the win from recycling.
   static constexpr vector_size_t kMaxRecycleSize = 64 * 1024;
   static constexpr int32_t kNumPerType = 10;
+  /// Max number of vectors returned by getReusable() that are kept for reuse.
+  static constexpr int32_t kNumReusable = 4;
 
   struct TypePool {
     int32_t size{0};
@@ -61,6 +73,9 @@ class VectorPool {
 
   /// Caches of pre-allocated vectors indexed by typeKind.
   std::array<TypePool, kNumCachedVectorTypes> vectors_;
+
+  /// Vectors returned by getReusable(). Reusable when singly referenced.
+  std::array<VectorPtr, kNumReusable> reusable_;
 };
 
 /// A simple vector ptr wrapper with an associated vector pool. It releases
@@ -14,14 +14,37 @@
  * limitations under the License.
  */
 #include "velox/vector/VectorSaver.h"
+#include <fcntl.h>
+#include <folly/ScopeGuard.h>
+#include <folly/String.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <fstream>
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/FlatVector.h"
+#include "velox/vector/LazyVector.h"
 
 namespace facebook::velox {
 
 namespace {
 
+// Alignment of the buffers written for memory mapping. Covers the widest
+// SIMD loads from the values of a vector.
+constexpr int32_t kBufferAlignment = 64;
+
+class MappedFile;
+
+void saveVectorImpl(
+    const BaseVector& vector,
+    std::ostream& out,
+    bool alignBuffers);
+
+VectorPtr restoreVectorImpl(
+    std::istream& in,
+    memory::MemoryPool* pool,
+    MappedFile* mappedFile);
+
 enum class Encoding : int8_t {
   kFlat = 0,
   kConstant = 1,
@@ -97,32 +120,163 @@ Encoding readEncoding(std::istream& in) {
   }
 }
 
-void writeBuffer(const BufferPtr& buffer, std::ostream& out) {
+// Pads 'out' with zeros up to the next multiple of kBufferAlignment.
+void writeAlignment(std::ostream& out) {
+  const auto position = static_cast<int64_t>(out.tellp());
+  VELOX_CHECK_GE(position, 0, "Aligned buffers need a seekable stream");
+  static const char kZeros[kBufferAlignment] = {};
+  out.write(kZeros, bits::roundUp(position, kBufferAlignment) - position);
+}
+
+// If 'alignBuffers', the data starts at a multiple of kBufferAlignment from
+// the start of 'out', so that a mapping of the file can be wrapped in a
+// buffer without copying.
+void writeBuffer(
+    const BufferPtr& buffer,
+    std::ostream& out,
+    bool alignBuffers) {
   write<int32_t>(buffer->size(), out);
+  if (alignBuffers) {
+    writeAlignment(out);
+  }
   out.write(buffer->as<char>(), buffer->size());
 }
 
-void writeOptionalBuffer(const BufferPtr& buffer, std::ostream& out) {
+void writeOptionalBuffer(
+    const BufferPtr& buffer,
+    std::ostream& out,
+    bool alignBuffers) {
   if (buffer) {
     write<bool>(true, out);
-    writeBuffer(buffer, out);
+    writeBuffer(buffer, out, alignBuffers);
   } else {
     write<bool>(false, out);
   }
 }
 
-BufferPtr readBuffer(std::istream& in, memory::MemoryPool* pool) {
+// A file mapped into memory with MAP_PRIVATE. The pages are writable so
+// that StringViews can be pointed at the mapped string buffers in place,
+// which copies only the pages of the StringViews. Buffers over the mapping
+// keep it alive through MappedFileReleaser.
+class MappedFile : public std::enable_shared_from_this<MappedFile> {
+ public:
+  static std::shared_ptr<MappedFile> map(const char* filePath) {
+    auto fd = ::open(filePath, O_RDONLY);
+    VELOX_CHECK_GE(
+        fd, 0, "Cannot open {}: {}", filePath, folly::errnoStr(errno));
+    SCOPE_EXIT {
+      ::close(fd);
+    };
+    struct stat stats;
+    VELOX_CHECK_EQ(::fstat(fd, &stats), 0, "Cannot stat {}", filePath);
+    const size_t size = stats.st_size;
+    VELOX_CHECK_GT(size, 0, "Empty vector file {}", filePath);
+    auto data =
+        ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    VELOX_CHECK(
+        data != MAP_FAILED,
+        "Cannot map {}: {}",
+        filePath,
+        folly::errnoStr(errno));
+    return std::shared_ptr<MappedFile>(
+        new MappedFile(static_cast<char*>(data), size));
+  }
+
+  ~MappedFile() {
+    ::munmap(data_, size_);
+  }
+
+  char* data() const {
+    return data_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  MappedFile(char* data, size_t size) : data_(data), size_(size) {}
+
+  char* const data_;
+  const size_t size_;
+};
+
+class MappedFileReleaser {
+ public:
+  explicit MappedFileReleaser(std::shared_ptr<MappedFile> file)
+      : file_(std::move(file)) {}
+
+  void addRef() const {}
+
+  void release() const {}
+
+ private:
+  const std::shared_ptr<MappedFile> file_;
+};
+
+// Reads a range of a MappedFile through std::istream.
+class MappedStreamBuf : public std::streambuf {
+ public:
+  MappedStreamBuf(char* data, size_t size) {
+    setg(data, data, data + size);
+  }
+
+ protected:
+  pos_type seekoff(
+      off_type offset,
+      std::ios_base::seekdir dir,
+      std::ios_base::openmode /*mode*/) override {
+    char* position = dir == std::ios_base::beg ? eback() : gptr();
+    if (dir == std::ios_base::end) {
+      position = egptr();
+    }
+    position += offset;
+    if (position < eback() || position > egptr()) {
+      return pos_type(off_type(-1));
+    }
+    setg(eback(), position, egptr());
+    return pos_type(position - eback());
+  }
+
+  pos_type seekpos(pos_type position, std::ios_base::openmode mode) override {
+    return seekoff(off_type(position), std::ios_base::beg, mode);
+  }
+};
+
+// Reads a buffer written by writeBuffer(). If 'mappedFile' is not null,
+// 'in' reads the mapping from its start, the buffer was written with
+// 'alignBuffers' and the returned buffer is a view of the mapped memory.
+BufferPtr readBuffer(
+    std::istream& in,
+    memory::MemoryPool* pool,
+    MappedFile* mappedFile) {
   auto numBytes = read<int32_t>(in);
+  if (mappedFile) {
+    const int64_t position = bits::roundUp(
+        static_cast<int64_t>(in.tellg()), kBufferAlignment);
+    VELOX_CHECK_LE(
+        position + numBytes,
+        static_cast<int64_t>(mappedFile->size()),
+        "Truncated vector file");
+    in.seekg(position + numBytes);
+    return BufferView<MappedFileReleaser>::create(
+        reinterpret_cast<const uint8_t*>(mappedFile->data() + position),
+        numBytes,
+        MappedFileReleaser(mappedFile->shared_from_this()));
+  }
   auto buffer = AlignedBuffer::allocate<char>(numBytes, pool);
   auto rawBuffer = buffer->asMutable<char>();
   in.read(rawBuffer, numBytes);
   return buffer;
 }
 
-BufferPtr readOptionalBuffer(std::istream& in, memory::MemoryPool* pool) {
+BufferPtr readOptionalBuffer(
+    std::istream& in,
+    memory::MemoryPool* pool,
+    MappedFile* mappedFile) {
   bool hasBuffer = read<bool>(in);
   if (hasBuffer) {
-    return readBuffer(in, pool);
+    return readBuffer(in, pool, mappedFile);
   }
 
   return nullptr;
@@ -184,8 +338,12 @@ void writeStringViews(
     vector_size_t size,
     const BufferPtr& strings,
     const std::vector<BufferPtr>& stringBuffers,
-    std::ostream& out) {
+    std::ostream& out,
+    bool alignBuffers) {
   write<int32_t>(strings->size(), out);
+  if (alignBuffers) {
+    writeAlignment(out);
+  }
 
   auto rawBytes = strings->as<char>();
   auto rawValues = strings->as<StringView>();
@@ -213,7 +371,9 @@ void restoreVectorStringViews(
     const BufferPtr& strings,
     const std::vector<BufferPtr>& stringBuffers) {
   auto rawBytes = strings->as<char>();
-  auto rawValues = strings->asMutable<StringView>();
+  // 'strings' is either allocated by readBuffer() or a view of a writable
+  // private mapping.
+  auto rawValues = const_cast<StringView*>(strings->as<StringView>());
   for (auto i = 0; i < size; ++i) {
     auto value = rawValues[i];
     if (!value.isInline()) {
@@ -230,9 +390,12 @@ bool isVarcharOrVarbinary(const BaseVector& vector) {
       vector.typeKind() == TypeKind::VARBINARY;
 }
 
-void writeFlatVector(const BaseVector& vector, std::ostream& out) {
+void writeFlatVector(
+    const BaseVector& vector,
+    std::ostream& out,
+    bool alignBuffers) {
   // Nulls buffer.
-  writeOptionalBuffer(vector.nulls(), out);
+  writeOptionalBuffer(vector.nulls(), out, alignBuffers);
 
   // Values buffer.
   if (isVarcharOrVarbinary(vector)) {
@@ -242,12 +405,13 @@ void writeFlatVector(const BaseVector& vector, std::ostream& out) {
 
       const auto& stringBuffers =
           vector.asFlatVector<StringView>()->stringBuffers();
-      writeStringViews(vector.size(), values, stringBuffers, out);
+      writeStringViews(
+          vector.size(), values, stringBuffers, out, alignBuffers);
     } else {
       write<bool>(false, out);
     }
   } else {
-    writeOptionalBuffer(vector.values(), out);
+    writeOptionalBuffer(vector.values(), out, alignBuffers);
   }
 
   // String buffers.
@@ -257,7 +421,7 @@ void writeFlatVector(const BaseVector& vector, std::ostream& out) {
     write<int32_t>(stringBuffers.size(), out);
 
     for (const auto& buffer : stringBuffers) {
-      writeBuffer(buffer, out);
+      writeBuffer(buffer, out, alignBuffers);
     }
   }
 }
@@ -266,19 +430,20 @@ VectorPtr readFlatVector(
     const TypePtr& type,
     vector_size_t size,
     std::istream& in,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    MappedFile* mappedFile) {
   // Nulls buffer.
-  BufferPtr nulls = readOptionalBuffer(in, pool);
+  BufferPtr nulls = readOptionalBuffer(in, pool, mappedFile);
 
   // Values buffer.
-  BufferPtr values = readOptionalBuffer(in, pool);
+  BufferPtr values = readOptionalBuffer(in, pool, mappedFile);
 
   // String buffers.
   std::vector<BufferPtr> stringBuffers;
   if (type->isVarchar() || type->isVarbinary()) {
     int32_t numStringBuffers = read<int32_t>(in);
     for (auto i = 0; i < numStringBuffers; ++i) {
-      stringBuffers.push_back(readBuffer(in, pool));
+      stringBuffers.push_back(readBuffer(in, pool, mappedFile));
     }
 
     // Update the pointers in the StringViews.
@@ -306,7 +471,10 @@ void writeScalarConstant(const BaseVector& vector, std::ostream& out) {
   }
 }
 
-void writeConstantVector(const BaseVector& vector, std::ostream& out) {
+void writeConstantVector(
+    const BaseVector& vector,
+    std::ostream& out,
+    bool alignBuffers) {
   bool isNull = vector.isNullAt(0);
   write<bool>(isNull, out);
 
@@ -318,7 +486,7 @@ void writeConstantVector(const BaseVector& vector, std::ostream& out) {
   write<bool>(baseVector == nullptr, out);
 
   if (baseVector) {
-    saveVector(*baseVector, out);
+    saveVectorImpl(*baseVector, out, alignBuffers);
     write<int32_t>(vector.as<ConstantVector<ComplexType>>()->index(), out);
   } else {
     VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
@@ -355,7 +523,8 @@ VectorPtr readConstantVector(
     const TypePtr& type,
     vector_size_t size,
     std::istream& in,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    MappedFile* mappedFile) {
   // Is-null flag.
   auto isNull = read<bool>(in);
 
@@ -369,43 +538,50 @@ VectorPtr readConstantVector(
         readConstant, type->kind(), type, size, pool, in);
   }
 
-  auto baseVector = restoreVector(in, pool);
+  auto baseVector = restoreVectorImpl(in, pool, mappedFile);
   auto baseIndex = read<int32_t>(in);
 
   return BaseVector::wrapInConstant(size, baseIndex, baseVector);
 }
 
-void writeDictionaryVector(const BaseVector& vector, std::ostream& out) {
+void writeDictionaryVector(
+    const BaseVector& vector,
+    std::ostream& out,
+    bool alignBuffers) {
   // Nulls buffer.
-  writeOptionalBuffer(vector.nulls(), out);
+  writeOptionalBuffer(vector.nulls(), out, alignBuffers);
 
   // Indices buffer.
-  writeBuffer(vector.wrapInfo(), out);
+  writeBuffer(vector.wrapInfo(), out, alignBuffers);
 
   // Base vector.
-  saveVector(*vector.valueVector(), out);
+  saveVectorImpl(*vector.valueVector(), out, alignBuffers);
 }
 
 VectorPtr readDictionaryVector(
     const TypePtr& /*type*/,
     vector_size_t size,
     std::istream& in,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    MappedFile* mappedFile) {
   // Nulls buffer.
-  BufferPtr nulls = readOptionalBuffer(in, pool);
+  BufferPtr nulls = readOptionalBuffer(in, pool, mappedFile);
 
   // Indices buffer.
-  BufferPtr indices = readBuffer(in, pool);
+  BufferPtr indices = readBuffer(in, pool, mappedFile);
 
   // Base vector.
-  auto baseVector = restoreVector(in, pool);
+  auto baseVector = restoreVectorImpl(in, pool, mappedFile);
 
   return BaseVector::wrapInDictionary(nulls, indices, size, baseVector);
 }
 
-void writeRowVector(const BaseVector& vector, std::ostream& out) {
+void writeRowVector(
+    const BaseVector& vector,
+    std::ostream& out,
+    bool alignBuffers) {
   // Nulls buffer.
-  writeOptionalBuffer(vector.nulls(), out);
+  writeOptionalBuffer(vector.nulls(), out, alignBuffers);
 
   auto rowVector = vector.as<RowVector>();
 
@@ -418,7 +594,7 @@ void writeRowVector(const BaseVector& vector, std::ostream& out) {
 
     write<bool>(child != nullptr, out);
     if (child) {
-      saveVector(*child, out);
+      saveVectorImpl(*child, out, alignBuffers);
     }
   }
 }
@@ -427,9 +603,10 @@ VectorPtr readRowVector(
     const TypePtr& type,
     vector_size_t size,
     std::istream& in,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    MappedFile* mappedFile) {
   // Nulls buffer.
-  BufferPtr nulls = readOptionalBuffer(in, pool);
+  BufferPtr nulls = readOptionalBuffer(in, pool, mappedFile);
 
   // Child vectors.
   auto numChildren = read<int32_t>(in);
@@ -438,7 +615,7 @@ VectorPtr readRowVector(
   for (auto i = 0; i < numChildren; ++i) {
     bool present = read<bool>(in);
     if (present) {
-      children.push_back(restoreVector(in, pool));
+      children.push_back(restoreVectorImpl(in, pool, mappedFile));
     } else {
       children.push_back(nullptr);
     }
@@ -447,63 +624,71 @@ VectorPtr readRowVector(
   return std::make_shared<RowVector>(pool, type, nulls, size, children);
 }
 
-void writeArrayVector(const BaseVector& vector, std::ostream& out) {
+void writeArrayVector(
+    const BaseVector& vector,
+    std::ostream& out,
+    bool alignBuffers) {
   // Nulls buffer.
-  writeOptionalBuffer(vector.nulls(), out);
+  writeOptionalBuffer(vector.nulls(), out, alignBuffers);
 
   // Offsets and sizes.
   auto arrayVector = vector.as<ArrayVector>();
-  writeBuffer(arrayVector->offsets(), out);
-  writeBuffer(arrayVector->sizes(), out);
+  writeBuffer(arrayVector->offsets(), out, alignBuffers);
+  writeBuffer(arrayVector->sizes(), out, alignBuffers);
 
   // Elements vector.
-  saveVector(*arrayVector->elements(), out);
+  saveVectorImpl(*arrayVector->elements(), out, alignBuffers);
 }
 
 VectorPtr readArrayVector(
     const TypePtr& type,
     vector_size_t size,
     std::istream& in,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    MappedFile* mappedFile) {
   // Nulls buffer.
-  BufferPtr nulls = readOptionalBuffer(in, pool);
+  BufferPtr nulls = readOptionalBuffer(in, pool, mappedFile);
 
-  BufferPtr offsets = readBuffer(in, pool);
-  BufferPtr sizes = readBuffer(in, pool);
+  BufferPtr offsets = readBuffer(in, pool, mappedFile);
+  BufferPtr sizes = readBuffer(in, pool, mappedFile);
 
-  auto elements = restoreVector(in, pool);
+  auto elements = restoreVectorImpl(in, pool, mappedFile);
 
   return std::make_shared<ArrayVector>(
       pool, type, nulls, size, offsets, sizes, elements);
 }
 
-void writeMapVector(const BaseVector& vector, std::ostream& out) {
+void writeMapVector(
+    const BaseVector& vector,
+    std::ostream& out,
+    bool alignBuffers) {
   // Nulls buffer.
-  writeOptionalBuffer(vector.nulls(), out);
+  writeOptionalBuffer(vector.nulls(), out, alignBuffers);
 
   // Offsets and sizes.
   auto mapVector = vector.as<MapVector>();
-  writeBuffer(mapVector->offsets(), out);
-  writeBuffer(mapVector->sizes(), out);
+  writeBuffer(mapVector->offsets(), out, alignBuffers);
+  writeBuffer(mapVector->sizes(), out, alignBuffers);
 
   // Keys and values vectors.
-  saveVector(*mapVector->mapKeys(), out);
-  saveVector(*mapVector->mapValues(), out);
+  saveVectorImpl(*mapVector->mapKeys(), out, alignBuffers);
+  saveVectorImpl(*mapVector->mapValues(), out, alignBuffers);
 }
 
 VectorPtr readMapVector(
     const TypePtr& type,
     vector_size_t size,
     std::istream& in,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    MappedFile* mappedFile) {
   // Nulls buffer.
-  BufferPtr nulls = readOptionalBuffer(in, pool);
+  BufferPtr nulls = readOptionalBuffer(in, pool, mappedFile);
 
-  BufferPtr offsets = readBuffer(in, pool);
-  BufferPtr sizes = readBuffer(in, pool);
+  BufferPtr offsets = readBuffer(in, pool, mappedFile);
+  BufferPtr sizes = readBuffer(in, pool, mappedFile);
 
-  auto keys = restoreVector(in, pool);
-  auto values = restoreVector(in, pool);
+  auto keys = restoreVectorImpl(in, pool, mappedFile);
+  auto values = restoreVectorImpl(in, pool, mappedFile);
 
   return std::make_shared<MapVector>(
       pool, type, nulls, size, offsets, sizes, keys, values);
@@ -588,7 +773,11 @@ TypePtr restoreType(std::istream& in) {
   return createScalarType(typeKind);
 }
 
-void saveVector(const BaseVector& vector, std::ostream& out) {
+namespace {
+void saveVectorImpl(
+    const BaseVector& vector,
+    std::ostream& out,
+    bool alignBuffers) {
   // Encoding.
   writeEncoding(vector.encoding(), out);
 
@@ -600,28 +789,33 @@ void saveVector(const BaseVector& vector, std::ostream& out) {
 
   switch (vector.encoding()) {
     case VectorEncoding::Simple::FLAT:
-      writeFlatVector(vector, out);
+      writeFlatVector(vector, out, alignBuffers);
       return;
     case VectorEncoding::Simple::CONSTANT:
-      writeConstantVector(vector, out);
+      writeConstantVector(vector, out, alignBuffers);
       return;
     case VectorEncoding::Simple::DICTIONARY:
-      writeDictionaryVector(vector, out);
+      writeDictionaryVector(vector, out, alignBuffers);
       return;
     case VectorEncoding::Simple::ROW:
-      writeRowVector(vector, out);
+      writeRowVector(vector, out, alignBuffers);
       return;
     case VectorEncoding::Simple::ARRAY:
-      writeArrayVector(vector, out);
+      writeArrayVector(vector, out, alignBuffers);
       return;
     case VectorEncoding::Simple::MAP:
-      writeMapVector(vector, out);
+      writeMapVector(vector, out, alignBuffers);
       return;
     default:
       VELOX_UNSUPPORTED(
           "Unsupported encoding: {}", mapSimpleToName(vector.encoding()));
   }
 }
+} // namespace
+
+void saveVector(const BaseVector& vector, std::ostream& out) {
+  saveVectorImpl(vector, out, false);
+}
 
 void saveVectorToFile(
     const BaseVector* FOLLY_NONNULL vector,
@@ -639,7 +833,11 @@ void saveStringToFile(
   outputFile.close();
 }
 
-VectorPtr restoreVector(std::istream& in, memory::MemoryPool* pool) {
+namespace {
+VectorPtr restoreVectorImpl(
+    std::istream& in,
+    memory::MemoryPool* pool,
+    MappedFile* mappedFile) {
   // Encoding.
   auto encoding = readEncoding(in);
 
@@ -652,22 +850,112 @@ VectorPtr restoreVector(std::istream& in, memory::MemoryPool* pool) {
   switch (encoding) {
     case Encoding::kFlat:
       if (type->isRow()) {
-        return readRowVector(type, size, in, pool);
+        return readRowVector(type, size, in, pool, mappedFile);
       } else if (type->isArray()) {
-        return readArrayVector(type, size, in, pool);
+        return readArrayVector(type, size, in, pool, mappedFile);
       } else if (type->isMap()) {
-        return readMapVector(type, size, in, pool);
+        return readMapVector(type, size, in, pool, mappedFile);
       }
-      return readFlatVector(type, size, in, pool);
+      return readFlatVector(type, size, in, pool, mappedFile);
     case Encoding::kConstant:
-      return readConstantVector(type, size, in, pool);
+      return readConstantVector(type, size, in, pool, mappedFile);
     case Encoding::kDictionary:
-      return readDictionaryVector(type, size, in, pool);
+      return readDictionaryVector(type, size, in, pool, mappedFile);
     default:
       VELOX_UNREACHABLE();
   }
 }
 
+// Restores the vector that a file written by saveVectorToMappedFile() has at
+// 'offset' on first access.
+class MappedVectorLoader : public VectorLoader {
+ public:
+  MappedVectorLoader(
+      std::shared_ptr<MappedFile> file,
+      int64_t offset,
+      memory::MemoryPool* pool)
+      : file_(std::move(file)), offset_(offset), pool_(pool) {}
+
+  void loadInternal(RowSet /*rows*/, ValueHook* hook, VectorPtr* result)
+      override {
+    VELOX_CHECK_NULL(hook, "MappedVectorLoader doesn't support ValueHook");
+    MappedStreamBuf streamBuf(file_->data(), file_->size());
+    std::istream in(&streamBuf);
+    in.seekg(offset_);
+    *result = restoreVectorImpl(in, pool_, file_.get());
+  }
+
+ private:
+  const std::shared_ptr<MappedFile> file_;
+  const int64_t offset_;
+  memory::MemoryPool* const pool_;
+};
+
+// Identifies a file written by saveVectorToMappedFile().
+constexpr int64_t kMappedFileMagic = 0x31564d4d584c4556; // "VELXMMV1"
+} // namespace
+
+VectorPtr restoreVector(std::istream& in, memory::MemoryPool* pool) {
+  return restoreVectorImpl(in, pool, nullptr);
+}
+
+void saveVectorToMappedFile(
+    const RowVector& vector,
+    const char* FOLLY_NONNULL filePath) {
+  std::ofstream out(filePath, std::ofstream::binary);
+  write<int64_t>(kMappedFileMagic, out);
+  saveType(vector.type(), out);
+  write<int32_t>(vector.size(), out);
+  writeOptionalBuffer(vector.nulls(), out, true);
+  std::vector<int64_t> childOffsets;
+  for (const auto& child : vector.children()) {
+    VELOX_CHECK_NOT_NULL(child);
+    childOffsets.push_back(out.tellp());
+    saveVectorImpl(*child->loadedVector(), out, true);
+  }
+  // The offsets of the children and the position of their table close the
+  // file, so that a reader can find any child without parsing the others.
+  const int64_t tableOffset = out.tellp();
+  for (auto offset : childOffsets) {
+    write<int64_t>(offset, out);
+  }
+  write<int64_t>(tableOffset, out);
+  out.close();
+  VELOX_CHECK(!out.fail(), "Failed to write {}", filePath);
+}
+
+RowVectorPtr restoreVectorFromMappedFile(
+    const char* FOLLY_NONNULL filePath,
+    memory::MemoryPool* pool) {
+  auto file = MappedFile::map(filePath);
+  MappedStreamBuf streamBuf(file->data(), file->size());
+  std::istream in(&streamBuf);
+  VELOX_CHECK_EQ(
+      read<int64_t>(in), kMappedFileMagic, "Not a vector file: {}", filePath);
+  auto type = restoreType(in);
+  VELOX_CHECK(type->isRow());
+  const auto size = read<int32_t>(in);
+  auto nulls = readOptionalBuffer(in, pool, file.get());
+
+  const auto numChildren = type->size();
+  in.seekg(file->size() - sizeof(int64_t));
+  const auto tableOffset = read<int64_t>(in);
+  in.seekg(tableOffset);
+  std::vector<VectorPtr> children;
+  children.reserve(numChildren);
+  for (auto i = 0; i < numChildren; ++i) {
+    const auto offset = read<int64_t>(in);
+    children.push_back(std::make_shared<LazyVector>(
+        pool,
+        type->childAt(i),
+        size,
+        std::make_unique<MappedVectorLoader>(file, offset, pool)));
+  }
+  VELOX_CHECK(!in.fail(), "Truncated vector file: {}", filePath);
+  return std::make_shared<RowVector>(
+      pool, type, std::move(nulls), size, std::move(children));
+}
+
 std::optional<std::string> generateFilePath(
     const char* basePath,
     const char* prefix) {
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/vector/BaseVector.h"
+#include "velox/vector/ComplexVector.h"
 
 namespace facebook::velox {
 
@@ -50,6 +51,24 @@ void saveStringToFile(
 /// Deserializes a vector serialized by 'save' from the provided input stream.
 VectorPtr restoreVector(std::istream& in, memory::MemoryPool* pool);
 
+/// Writes 'vector' to a new file in 'filePath' in a format that
+/// restoreVectorFromMappedFile() maps into memory instead of reading. The
+/// buffers are aligned in the file and each top level column can be found
+/// without reading the others. Exceptions will be thrown if any error occurs
+/// while writing.
+void saveVectorToMappedFile(
+    const RowVector& vector,
+    const char* FOLLY_NONNULL filePath);
+
+/// Maps a file written by saveVectorToMappedFile() into memory. The top level
+/// columns are LazyVectors that are restored on first access. The nulls,
+/// values, offsets and string buffers of the restored vectors are views of
+/// the mapped memory rather than copies, and keep the mapping alive. Only the
+/// pages holding the StringViews of non-inlined strings are copied on write.
+RowVectorPtr restoreVectorFromMappedFile(
+    const char* FOLLY_NONNULL filePath,
+    memory::MemoryPool* pool);
+
 /// Generates a file path in specified directory. Returns std::nullopt on
 /// failure.
 std::optional<std::string> generateFilePath(
@@ -25,6 +25,24 @@ std::unique_ptr<VectorSerde>& getVectorSerde() {
 }
 } // namespace
 
+void VectorSerde::deserialize(
+    ByteStream* source,
+    velox::memory::MemoryPool* pool,
+    RowTypePtr type,
+    RowVectorPtr* result,
+    vector_size_t resultOffset,
+    const Options* options) {
+  if (resultOffset == 0) {
+    deserialize(source, pool, type, result, options);
+    return;
+  }
+  VELOX_CHECK(*result && result->unique());
+  VELOX_CHECK_EQ(resultOffset, (*result)->size());
+  RowVectorPtr page;
+  deserialize(source, pool, type, &page, options);
+  (*result)->append(page.get());
+}
+
 bool registerVectorSerde(std::unique_ptr<VectorSerde> serde) {
   VELOX_CHECK(!getVectorSerde().get(), "Vector serde is already registered");
   getVectorSerde() = std::move(serde);
@@ -74,4 +92,17 @@ void VectorStreamGroup::read(
   getVectorSerde()->deserialize(source, pool, type, result, options);
 }
 
+// static
+void VectorStreamGroup::read(
+    ByteStream* source,
+    velox::memory::MemoryPool* pool,
+    RowTypePtr type,
+    RowVectorPtr* result,
+    vector_size_t resultOffset,
+    const VectorSerde::Options* options) {
+  VELOX_CHECK(getVectorSerde().get(), "Vector serde is not registered");
+  getVectorSerde()->deserialize(
+      source, pool, type, result, resultOffset, options);
+}
+
 } // namespace facebook::velox
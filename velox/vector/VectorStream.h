@@ -69,6 +69,19 @@ class VectorSerde {
       RowTypePtr type,
       RowVectorPtr* result,
       const Options* options = nullptr) = 0;
+
+  /// Deserializes a page like deserialize() and appends its rows after the
+  /// first 'resultOffset' rows of '*result', e.g. to coalesce small pages
+  /// into one vector. '*result' must be uniquely referenced and have
+  /// 'resultOffset' rows of 'type'. The default deserializes the page apart
+  /// and copies its rows.
+  virtual void deserialize(
+      ByteStream* source,
+      velox::memory::MemoryPool* pool,
+      RowTypePtr type,
+      RowVectorPtr* result,
+      vector_size_t resultOffset,
+      const Options* options);
 };
 
 bool registerVectorSerde(std::unique_ptr<VectorSerde> serde);
@@ -105,6 +118,16 @@ class VectorStreamGroup : public StreamArena {
       RowVectorPtr* result,
       const VectorSerde::Options* options = nullptr);
 
+  /// Reads the rows of a page after the first 'resultOffset' rows of
+  /// '*result'. See VectorSerde::deserialize().
+  static void read(
+      ByteStream* source,
+      velox::memory::MemoryPool* pool,
+      RowTypePtr type,
+      RowVectorPtr* result,
+      vector_size_t resultOffset,
+      const VectorSerde::Options* options = nullptr);
+
  private:
   std::unique_ptr<VectorSerializer> serializer_;
 };
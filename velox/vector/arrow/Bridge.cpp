@@ -16,6 +16,8 @@
 
 #include "velox/vector/arrow/Bridge.h"
 
+#include <cerrno>
+
 #include "velox/buffer/Buffer.h"
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/CheckedArithmetic.h"
@@ -28,22 +30,25 @@ namespace facebook::velox {
 
 namespace {
 
-// The supported conversions use one buffer for nulls (0), one for values (1),
-// and one for offsets (2).
+// Most conversions use one buffer for nulls (0), one for values (1), and one
+// for offsets (2). String views have a variable number of data buffers.
 static constexpr size_t kMaxBuffers{3};
 
 // Structure that will hold the buffers needed by ArrowArray. This is opaquely
 // carried by ArrowArray.private_data
 class VeloxToArrowBridgeHolder {
  public:
-  VeloxToArrowBridgeHolder() {
-    for (size_t i = 0; i < kMaxBuffers; ++i) {
-      buffers_[i] = nullptr;
-    }
-  }
+  VeloxToArrowBridgeHolder()
+      : buffers_(kMaxBuffers, nullptr), bufferPtrs_(kMaxBuffers) {}
 
-  // Acquires a buffer at index `idx`.
+  // Acquires a buffer at index `idx`. Indices past kMaxBuffers grow the
+  // buffer list, so the pointer returned by getArrowBuffers() is only stable
+  // once all buffers are set.
   void setBuffer(size_t idx, const BufferPtr& buffer) {
+    if (idx >= buffers_.size()) {
+      buffers_.resize(idx + 1, nullptr);
+      bufferPtrs_.resize(idx + 1);
+    }
     bufferPtrs_[idx] = buffer;
     if (buffer) {
       buffers_[idx] = buffer->as<void>();
@@ -56,7 +61,7 @@ class VeloxToArrowBridgeHolder {
   }
 
   const void** getArrowBuffers() {
-    return buffers_;
+    return buffers_.data();
   }
 
   // Allocates space for `numChildren` ArrowArray pointers.
@@ -87,11 +92,11 @@ class VeloxToArrowBridgeHolder {
 
  private:
   // Holds the pointers to the arrow buffers.
-  const void* buffers_[kMaxBuffers];
+  std::vector<const void*> buffers_;
 
   // Holds ownership over the Buffers being referenced by the buffers vector
   // above.
-  BufferPtr bufferPtrs_[kMaxBuffers];
+  std::vector<BufferPtr> bufferPtrs_;
 
   // Auxiliary buffers to hold ownership over ArrowArray children structures.
   std::vector<std::unique_ptr<ArrowArray>> childrenPtrs_;
@@ -209,6 +214,7 @@ static void bridgeSchemaRelease(ArrowSchema* arrowSchema) {
 // Returns the Arrow C data interface format type for a given Velox type.
 const char* exportArrowFormatStr(
     const TypePtr& type,
+    const ArrowOptions& options,
     std::string& formatBuffer) {
   switch (type->kind()) {
     // Scalar types.
@@ -233,12 +239,12 @@ const char* exportArrowFormatStr(
       formatBuffer = fmt::format("d:{},{}", precision, scale);
       return formatBuffer.c_str();
     }
-    // We always map VARCHAR and VARBINARY to the "small" version (lower case
-    // format string), which uses 32 bit offsets.
+    // We map VARCHAR and VARBINARY to the "small" version (lower case format
+    // string), which uses 32 bit offsets, unless string views are requested.
     case TypeKind::VARCHAR:
-      return "u"; // utf-8 string
+      return options.exportToStringView ? "vu" : "u"; // utf-8 string (view)
     case TypeKind::VARBINARY:
-      return "z"; // binary
+      return options.exportToStringView ? "vz" : "z"; // binary (view)
 
     case TypeKind::TIMESTAMP:
       // TODO: need to figure out how we'll map this since in Velox we currently
@@ -412,12 +418,103 @@ void exportStrings(
   VELOX_DCHECK_EQ(bufSize, *rawOffsets);
 }
 
+// Exports strings in the Arrow binary view layout: one 16 byte view per row,
+// the data buffers and an int64 buffer with the size of each data buffer. The
+// views are laid out like StringView, except that a string that is not
+// inlined is referred to by a data buffer index and an offset instead of a
+// pointer. The string buffers of 'vec' are exported as data buffers without
+// copying. Strings that are not in them, e.g. ones pointing to literals, are
+// copied to an extra data buffer after these.
+void exportStringViews(
+    const FlatVector<StringView>& vec,
+    const Selection& rows,
+    ArrowArray& out,
+    memory::MemoryPool* pool,
+    VeloxToArrowBridgeHolder& holder) {
+  static_assert(sizeof(StringView) == 16);
+  const auto& stringBuffers = vec.stringBuffers();
+  const int32_t numStringBuffers = stringBuffers.size();
+  // Consecutive strings are usually in the same buffer, so the search starts
+  // from the buffer of the previous string.
+  int32_t lastIndex = 0;
+  auto findBuffer = [&](const StringView& sv) -> int32_t {
+    for (int32_t n = 0; n < numStringBuffers; ++n) {
+      const auto index = (lastIndex + n) % numStringBuffers;
+      const auto* start = stringBuffers[index]->as<char>();
+      if (sv.data() >= start &&
+          sv.data() + sv.size() <= start + stringBuffers[index]->size()) {
+        lastIndex = index;
+        return index;
+      }
+    }
+    return -1;
+  };
+
+  auto views = AlignedBuffer::allocate<char>(
+      checkedMultiply<size_t>(out.length, sizeof(StringView)), pool);
+  auto* rawViews = views->asMutable<char>();
+  std::vector<StringView> copied;
+  size_t copiedSize = 0;
+  vector_size_t j = 0;
+  rows.apply([&](vector_size_t i) {
+    char* view = rawViews + (j++) * sizeof(StringView);
+    if (vec.isNullAt(i)) {
+      memset(view, 0, sizeof(StringView));
+      return;
+    }
+    const auto& sv = vec.valueAtFast(i);
+    if (sv.isInline()) {
+      memcpy(view, &sv, sizeof(StringView));
+      return;
+    }
+    int32_t index = findBuffer(sv);
+    size_t offset;
+    if (index >= 0) {
+      offset = sv.data() - stringBuffers[index]->as<char>();
+    } else {
+      index = numStringBuffers;
+      offset = copiedSize;
+      copiedSize += sv.size();
+      copied.push_back(sv);
+    }
+    VELOX_CHECK_LE(offset, std::numeric_limits<int32_t>::max());
+    const int32_t size = sv.size();
+    const int32_t offset32 = offset;
+    memcpy(view, &size, sizeof(int32_t));
+    memcpy(view + 4, sv.data(), 4);
+    memcpy(view + 8, &index, sizeof(int32_t));
+    memcpy(view + 12, &offset32, sizeof(int32_t));
+  });
+  holder.setBuffer(1, views);
+
+  const int32_t numDataBuffers = numStringBuffers + (copied.empty() ? 0 : 1);
+  auto dataSizes = AlignedBuffer::allocate<int64_t>(numDataBuffers, pool);
+  auto* rawDataSizes = dataSizes->asMutable<int64_t>();
+  for (int32_t i = 0; i < numStringBuffers; ++i) {
+    holder.setBuffer(2 + i, stringBuffers[i]);
+    rawDataSizes[i] = stringBuffers[i]->size();
+  }
+  if (!copied.empty()) {
+    auto extra = AlignedBuffer::allocate<char>(copiedSize, pool);
+    auto* rawExtra = extra->asMutable<char>();
+    for (const auto& sv : copied) {
+      memcpy(rawExtra, sv.data(), sv.size());
+      rawExtra += sv.size();
+    }
+    holder.setBuffer(2 + numStringBuffers, extra);
+    rawDataSizes[numStringBuffers] = copiedSize;
+  }
+  holder.setBuffer(2 + numDataBuffers, dataSizes);
+  out.n_buffers = 3 + numDataBuffers;
+}
+
 void exportFlat(
     const BaseVector& vec,
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   out.n_children = 0;
   out.children = nullptr;
   switch (vec.typeKind()) {
@@ -434,8 +531,21 @@ void exportFlat(
       break;
     case TypeKind::VARCHAR:
     case TypeKind::VARBINARY:
-      exportStrings(
-          *vec.asUnchecked<FlatVector<StringView>>(), rows, out, pool, holder);
+      if (options.exportToStringView) {
+        exportStringViews(
+            *vec.asUnchecked<FlatVector<StringView>>(),
+            rows,
+            out,
+            pool,
+            holder);
+      } else {
+        exportStrings(
+            *vec.asUnchecked<FlatVector<StringView>>(),
+            rows,
+            out,
+            pool,
+            holder);
+      }
       break;
     default:
       VELOX_NYI(
@@ -448,14 +558,16 @@ void exportBase(
     const BaseVector&,
     const Selection&,
     ArrowArray&,
-    memory::MemoryPool*);
+    memory::MemoryPool*,
+    const ArrowOptions&);
 
 void exportRows(
     const RowVector& vec,
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   out.n_buffers = 1;
   holder.resizeChildren(vec.childrenSize());
   out.n_children = vec.childrenSize();
@@ -466,7 +578,8 @@ void exportRows(
           *vec.childAt(i)->loadedVector(),
           rows,
           *holder.allocateChild(i),
-          pool);
+          pool,
+          options);
     } catch (const VeloxException&) {
       for (column_index_t j = 0; j < i; ++j) {
         // When exception is thrown, i th child is guaranteed unset.
@@ -527,7 +640,8 @@ void exportArrays(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   Selection childRows(vec.elements()->size());
   exportOffsets(vec, rows, out, pool, holder, childRows);
   holder.resizeChildren(1);
@@ -535,7 +649,8 @@ void exportArrays(
       *vec.elements()->loadedVector(),
       childRows,
       *holder.allocateChild(0),
-      pool);
+      pool,
+      options);
   out.n_children = 1;
   out.children = holder.getChildrenArrays();
 }
@@ -545,7 +660,8 @@ void exportMaps(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   RowVector child(
       pool,
       ROW({"key", "value"}, {vec.mapKeys()->type(), vec.mapValues()->type()}),
@@ -555,7 +671,7 @@ void exportMaps(
   Selection childRows(child.size());
   exportOffsets(vec, rows, out, pool, holder, childRows);
   holder.resizeChildren(1);
-  exportBase(child, childRows, *holder.allocateChild(0), pool);
+  exportBase(child, childRows, *holder.allocateChild(0), pool, options);
   out.n_children = 1;
   out.children = holder.getChildrenArrays();
 }
@@ -565,7 +681,8 @@ void exportDictionary(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   out.n_buffers = 2;
   out.n_children = 0;
   if (rows.changed()) {
@@ -577,39 +694,102 @@ void exportDictionary(
   }
   auto& values = *vec.valueVector()->loadedVector();
   out.dictionary = holder.allocateDictionary();
-  exportBase(values, Selection(values.size()), *out.dictionary, pool);
+  exportBase(
+      values, Selection(values.size()), *out.dictionary, pool, options);
+}
+
+// Exports a constant vector as a run-end encoded array with a single run. The
+// children are the int32 run ends, i.e. the length, and the one row of values.
+// Complex values are exported from the base of the constant without copying.
+void exportConstant(
+    const BaseVector& vec,
+    const Selection& rows,
+    ArrowArray& out,
+    memory::MemoryPool* pool,
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
+  out.n_buffers = 0;
+  out.null_count = 0;
+  holder.resizeChildren(2);
+  out.n_children = 2;
+  out.children = holder.getChildrenArrays();
+
+  // An empty array has no runs.
+  const vector_size_t numRuns = out.length > 0 ? 1 : 0;
+  FlatVector<int32_t> runEnds(
+      pool,
+      INTEGER(),
+      nullptr,
+      numRuns,
+      AlignedBuffer::allocate<int32_t>(
+          numRuns, pool, static_cast<int32_t>(out.length)),
+      {});
+  exportBase(
+      runEnds, Selection(numRuns), *holder.allocateChild(0), pool, options);
+
+  try {
+    if (vec.valueVector()) {
+      const auto& values = *vec.valueVector()->loadedVector();
+      Selection valueRows(values.size());
+      valueRows.clearAll();
+      valueRows.addRange(vec.wrappedIndex(0), numRuns);
+      exportBase(values, valueRows, *holder.allocateChild(1), pool, options);
+    } else {
+      auto values = BaseVector::create(vec.type(), numRuns, pool);
+      if (numRuns > 0) {
+        values->copy(&vec, 0, 0, numRuns);
+      }
+      exportBase(
+          *values, Selection(numRuns), *holder.allocateChild(1), pool, options);
+    }
+  } catch (const VeloxException&) {
+    out.children[0]->release(out.children[0]);
+    throw;
+  }
 }
 
 void exportBase(
     const BaseVector& vec,
     const Selection& rows,
     ArrowArray& out,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const ArrowOptions& options) {
   auto holder = std::make_unique<VeloxToArrowBridgeHolder>();
-  out.buffers = holder->getArrowBuffers();
   out.length = rows.count();
   out.offset = 0;
   out.dictionary = nullptr;
-  exportNulls(vec, rows, out, pool, *holder);
+  // Run-end encoded arrays have no validity buffer, the nulls are in the
+  // values.
+  if (vec.encoding() != VectorEncoding::Simple::CONSTANT) {
+    exportNulls(vec, rows, out, pool, *holder);
+  }
   switch (vec.encoding()) {
     case VectorEncoding::Simple::FLAT:
-      exportFlat(vec, rows, out, pool, *holder);
+      exportFlat(vec, rows, out, pool, *holder, options);
       break;
     case VectorEncoding::Simple::ROW:
-      exportRows(*vec.asUnchecked<RowVector>(), rows, out, pool, *holder);
+      exportRows(
+          *vec.asUnchecked<RowVector>(), rows, out, pool, *holder, options);
       break;
     case VectorEncoding::Simple::ARRAY:
-      exportArrays(*vec.asUnchecked<ArrayVector>(), rows, out, pool, *holder);
+      exportArrays(
+          *vec.asUnchecked<ArrayVector>(), rows, out, pool, *holder, options);
       break;
     case VectorEncoding::Simple::MAP:
-      exportMaps(*vec.asUnchecked<MapVector>(), rows, out, pool, *holder);
+      exportMaps(
+          *vec.asUnchecked<MapVector>(), rows, out, pool, *holder, options);
       break;
     case VectorEncoding::Simple::DICTIONARY:
-      exportDictionary(vec, rows, out, pool, *holder);
+      exportDictionary(vec, rows, out, pool, *holder, options);
+      break;
+    case VectorEncoding::Simple::CONSTANT:
+      exportConstant(vec, rows, out, pool, *holder, options);
       break;
     default:
       VELOX_NYI("{} cannot be exported to Arrow yet.", vec.encoding());
   }
+  // Set after the buffers since string views may add buffers.
+  out.buffers = holder->getArrowBuffers();
   out.private_data = holder.release();
   out.release = bridgeRelease;
 }
@@ -619,11 +799,15 @@ void exportBase(
 void exportToArrow(
     const VectorPtr& vector,
     ArrowArray& arrowArray,
-    memory::MemoryPool* pool) {
-  exportBase(*vector, Selection(vector->size()), arrowArray, pool);
+    memory::MemoryPool* pool,
+    const ArrowOptions& options) {
+  exportBase(*vector, Selection(vector->size()), arrowArray, pool, options);
 }
 
-void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
+void exportToArrow(
+    const VectorPtr& vec,
+    ArrowSchema& arrowSchema,
+    const ArrowOptions& options) {
   auto& type = vec->type();
 
   arrowSchema.name = nullptr;
@@ -643,10 +827,43 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
     arrowSchema.format = "i";
     bridgeHolder->dictionary = std::make_unique<ArrowSchema>();
     arrowSchema.dictionary = bridgeHolder->dictionary.get();
-    exportToArrow(vec->valueVector(), *arrowSchema.dictionary);
+    exportToArrow(vec->valueVector(), *arrowSchema.dictionary, options);
+
+  } else if (vec->encoding() == VectorEncoding::Simple::CONSTANT) {
+    // Run-end encoded with int32 run ends. Scalar constants export their
+    // value as a flat vector.
+    arrowSchema.format = "+r";
+    arrowSchema.dictionary = nullptr;
+    bridgeHolder->childrenRaw.resize(2);
+    bridgeHolder->childrenOwned.resize(2);
+    arrowSchema.children = bridgeHolder->childrenRaw.data();
+    arrowSchema.n_children = 2;
+
+    auto& runEnds = bridgeHolder->childrenOwned[0];
+    runEnds = std::make_unique<ArrowSchema>();
+    exportToArrow(BaseVector::create(INTEGER(), 0, vec->pool()), *runEnds);
+    runEnds->name = "run_ends";
+    runEnds->flags = 0;
+    arrowSchema.children[0] = runEnds.get();
+
+    auto& values = bridgeHolder->childrenOwned[1];
+    values = std::make_unique<ArrowSchema>();
+    try {
+      exportToArrow(
+          vec->valueVector() ? vec->valueVector()
+                             : BaseVector::create(type, 0, vec->pool()),
+          *values,
+          options);
+    } catch (const VeloxException&) {
+      runEnds->release(runEnds.get());
+      throw;
+    }
+    values->name = "values";
+    arrowSchema.children[1] = values.get();
 
   } else {
-    arrowSchema.format = exportArrowFormatStr(type, bridgeHolder->formatBuffer);
+    arrowSchema.format =
+        exportArrowFormatStr(type, options, bridgeHolder->formatBuffer);
     arrowSchema.dictionary = nullptr;
 
     if (type->kind() == TypeKind::MAP) {
@@ -661,14 +878,14 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
           0,
           std::vector<VectorPtr>{maps.mapKeys(), maps.mapValues()},
           maps.getNullCount());
-      exportToArrow(rows, *child);
+      exportToArrow(rows, *child, options);
       child->name = "entries";
       setUniqueChild(std::move(child), *bridgeHolder, arrowSchema);
 
     } else if (type->kind() == TypeKind::ARRAY) {
       auto child = std::make_unique<ArrowSchema>();
       auto& arrays = *vec->asUnchecked<ArrayVector>();
-      exportToArrow(arrays.elements(), *child);
+      exportToArrow(arrays.elements(), *child, options);
       // Name is required, and "item" is the default name used in arrow itself.
       child->name = "item";
       setUniqueChild(std::move(child), *bridgeHolder, arrowSchema);
@@ -701,7 +918,7 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
         try {
           auto& currentSchema = bridgeHolder->childrenOwned[i];
           currentSchema = std::make_unique<ArrowSchema>();
-          exportToArrow(rows.childAt(i), *currentSchema);
+          exportToArrow(rows.childAt(i), *currentSchema, options);
           currentSchema->name = bridgeHolder->rowType->nameOf(i).data();
           arrowSchema.children[i] = currentSchema.get();
         } catch (const VeloxException& e) {
@@ -726,6 +943,138 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
   arrowSchema.private_data = bridgeHolder.release();
 }
 
+namespace {
+
+// Structure that holds the producer of an ArrowArrayStream. This is opaquely
+// carried by ArrowArrayStream.private_data
+struct VeloxToArrowStreamHolder {
+  RowTypePtr type;
+  std::function<RowVectorPtr()> next;
+  memory::MemoryPool* pool;
+  ArrowOptions options;
+  std::string lastError;
+};
+
+// Returns 'vector' with dictionary and constant encoded children flattened,
+// since the schema of a stream is that of its type. Only these children are
+// copied.
+VectorPtr flattenEncodings(const VectorPtr& vector) {
+  auto loaded = BaseVector::loadedVectorShared(vector);
+  auto* pool = loaded->pool();
+  switch (loaded->encoding()) {
+    case VectorEncoding::Simple::FLAT:
+      return loaded;
+    case VectorEncoding::Simple::ROW: {
+      auto* row = loaded->asUnchecked<RowVector>();
+      std::vector<VectorPtr> children;
+      children.reserve(row->childrenSize());
+      for (const auto& child : row->children()) {
+        children.push_back(child ? flattenEncodings(child) : child);
+      }
+      return std::make_shared<RowVector>(
+          pool,
+          row->type(),
+          row->nulls(),
+          row->size(),
+          std::move(children),
+          row->getNullCount());
+    }
+    case VectorEncoding::Simple::ARRAY: {
+      auto* array = loaded->asUnchecked<ArrayVector>();
+      return std::make_shared<ArrayVector>(
+          pool,
+          array->type(),
+          array->nulls(),
+          array->size(),
+          array->offsets(),
+          array->sizes(),
+          flattenEncodings(array->elements()),
+          array->getNullCount());
+    }
+    case VectorEncoding::Simple::MAP: {
+      auto* map = loaded->asUnchecked<MapVector>();
+      return std::make_shared<MapVector>(
+          pool,
+          map->type(),
+          map->nulls(),
+          map->size(),
+          map->offsets(),
+          map->sizes(),
+          flattenEncodings(map->mapKeys()),
+          flattenEncodings(map->mapValues()),
+          map->getNullCount());
+    }
+    default: {
+      auto flat = BaseVector::create(loaded->type(), loaded->size(), pool);
+      flat->copy(loaded.get(), 0, 0, loaded->size());
+      return flat;
+    }
+  }
+}
+
+VeloxToArrowStreamHolder& streamHolder(ArrowArrayStream* stream) {
+  return *static_cast<VeloxToArrowStreamHolder*>(stream->private_data);
+}
+
+int streamGetSchema(ArrowArrayStream* stream, ArrowSchema* out) {
+  auto& holder = streamHolder(stream);
+  try {
+    exportToArrow(
+        BaseVector::create(holder.type, 0, holder.pool), *out, holder.options);
+  } catch (const std::exception& e) {
+    holder.lastError = e.what();
+    return EIO;
+  }
+  return 0;
+}
+
+int streamGetNext(ArrowArrayStream* stream, ArrowArray* out) {
+  auto& holder = streamHolder(stream);
+  try {
+    VectorPtr batch = holder.next();
+    if (!batch) {
+      // A released array marks the end of the stream.
+      out->release = nullptr;
+      return 0;
+    }
+    exportToArrow(flattenEncodings(batch), *out, holder.pool, holder.options);
+  } catch (const std::exception& e) {
+    holder.lastError = e.what();
+    return EIO;
+  }
+  return 0;
+}
+
+const char* streamGetLastError(ArrowArrayStream* stream) {
+  const auto& lastError = streamHolder(stream).lastError;
+  return lastError.empty() ? nullptr : lastError.c_str();
+}
+
+void streamRelease(ArrowArrayStream* stream) {
+  if (!stream || !stream->release) {
+    return;
+  }
+  delete &streamHolder(stream);
+  stream->release = nullptr;
+  stream->private_data = nullptr;
+}
+
+} // namespace
+
+void exportToArrowStream(
+    const RowTypePtr& type,
+    std::function<RowVectorPtr()> next,
+    ArrowArrayStream& arrowStream,
+    memory::MemoryPool* pool,
+    const ArrowOptions& options) {
+  arrowStream.get_schema = streamGetSchema;
+  arrowStream.get_next = streamGetNext;
+  arrowStream.get_last_error = streamGetLastError;
+  arrowStream.release = streamRelease;
+  arrowStream.private_data = new VeloxToArrowStreamHolder{
+      type, std::move(next), pool, options, std::string()};
+}
+
 TypePtr importFromArrow(const ArrowSchema& arrowSchema) {
   const char* format = arrowSchema.format;
   VELOX_CHECK_NOT_NULL(format);
@@ -756,6 +1105,16 @@ TypePtr importFromArrow(const ArrowSchema& arrowSchema) {
     case 'Z':
       return VARBINARY();
 
+    // String and binary views.
+    case 'v':
+      if (format[1] == 'u') {
+        return VARCHAR();
+      }
+      if (format[1] == 'z') {
+        return VARBINARY();
+      }
+      break;
+
     case 't': // temporal types.
       // Mapping it to ttn for now.
       if (format[1] == 't' && format[2] == 'n') {
@@ -823,6 +1182,12 @@ TypePtr importFromArrow(const ArrowSchema& arrowSchema) {
           return ROW(std::move(childNames), std::move(childTypes));
         }
 
+        // Run-end encoded, which has the type of its values.
+        case 'r':
+          VELOX_CHECK_EQ(arrowSchema.n_children, 2);
+          VELOX_CHECK_NOT_NULL(arrowSchema.children[1]);
+          return importFromArrow(*arrowSchema.children[1]);
+
         default:
           break;
       }
@@ -932,7 +1297,7 @@ VectorPtr createStringFlatVector(
   std::vector<BufferPtr> stringViewBuffers;
   if (shouldAcquireStringBuffer) {
     stringViewBuffers.emplace_back(
-        wrapInBufferView(values, offsets[length + 1]));
+        wrapInBufferView(values, offsets[length]));
   }
 
   return std::make_shared<FlatVector<StringView>>(
@@ -947,6 +1312,73 @@ VectorPtr createStringFlatVector(
       optionalNullCount(nullCount));
 }
 
+// Imports the Arrow binary view layout. The views of inlined strings are the
+// same as StringViews. The others point into the data buffers, which are
+// referenced by the vector without copying.
+VectorPtr createStringViewFlatVector(
+    memory::MemoryPool* pool,
+    const TypePtr& type,
+    BufferPtr nulls,
+    const ArrowArray& arrowArray,
+    WrapInBufferViewFunc wrapInBufferView) {
+  VELOX_USER_CHECK_GE(
+      arrowArray.n_buffers,
+      3,
+      "Expecting at least three buffers as input for string views.");
+  const auto length = arrowArray.length;
+  const auto numDataBuffers = arrowArray.n_buffers - 3;
+  const auto* views = static_cast<const char*>(arrowArray.buffers[1]);
+  const auto* dataBuffers =
+      reinterpret_cast<const char* const*>(arrowArray.buffers + 2);
+  const auto* dataSizes =
+      static_cast<const int64_t*>(arrowArray.buffers[arrowArray.n_buffers - 1]);
+  const auto* rawNulls = nulls ? nulls->as<uint64_t>() : nullptr;
+
+  BufferPtr stringViews = AlignedBuffer::allocate<StringView>(length, pool);
+  auto rawStringViews = stringViews->asMutable<StringView>();
+  bool shouldAcquireStringBuffers = false;
+  for (int64_t i = 0; i < length; ++i) {
+    if (rawNulls && bits::isBitNull(rawNulls, i)) {
+      rawStringViews[i] = StringView();
+      continue;
+    }
+    const char* view = views + i * sizeof(StringView);
+    int32_t size;
+    memcpy(&size, view, sizeof(int32_t));
+    if (size <= static_cast<int32_t>(StringView::kInlineSize)) {
+      rawStringViews[i] = StringView(view + 4, size);
+      continue;
+    }
+    int32_t index;
+    int32_t offset;
+    memcpy(&index, view + 8, sizeof(int32_t));
+    memcpy(&offset, view + 12, sizeof(int32_t));
+    VELOX_USER_CHECK_LT(index, numDataBuffers, "Invalid string view buffer.");
+    rawStringViews[i] = StringView(dataBuffers[index] + offset, size);
+    shouldAcquireStringBuffers = true;
+  }
+
+  std::vector<BufferPtr> stringViewBuffers;
+  if (shouldAcquireStringBuffers) {
+    stringViewBuffers.reserve(numDataBuffers);
+    for (int64_t i = 0; i < numDataBuffers; ++i) {
+      stringViewBuffers.emplace_back(
+          wrapInBufferView(dataBuffers[i], dataSizes[i]));
+    }
+  }
+
+  return std::make_shared<FlatVector<StringView>>(
+      pool,
+      type,
+      nulls,
+      length,
+      stringViews,
+      std::move(stringViewBuffers),
+      SimpleVectorStats<StringView>{},
+      std::nullopt,
+      optionalNullCount(arrowArray.null_count));
+}
+
 VectorPtr importFromArrowImpl(
     ArrowSchema& arrowSchema,
     ArrowArray& arrowArray,
@@ -1079,6 +1511,44 @@ VectorPtr createDictionaryVector(
       std::move(wrapped));
 }
 
+// Imports a run-end encoded array as a constant vector if it has a single run
+// and as a dictionary vector over the values otherwise.
+VectorPtr createRunEndEncodedVector(
+    memory::MemoryPool* pool,
+    ArrowSchema& arrowSchema,
+    ArrowArray& arrowArray,
+    bool isViewer) {
+  VELOX_CHECK_EQ(arrowArray.n_children, 2);
+  VELOX_USER_CHECK_EQ(
+      strcmp(arrowSchema.children[0]->format, "i"),
+      0,
+      "Only int32 run ends are supported for arrow conversion");
+  auto runEnds = importFromArrowImpl(
+      *arrowSchema.children[0], *arrowArray.children[0], pool, isViewer);
+  auto values = importFromArrowImpl(
+      *arrowSchema.children[1], *arrowArray.children[1], pool, isViewer);
+  const auto length = arrowArray.length;
+  const auto numRuns = runEnds->size();
+  const auto* rawRunEnds = runEnds->asFlatVector<int32_t>()->rawValues();
+  if (numRuns == 1 && rawRunEnds[0] >= length) {
+    return BaseVector::wrapInConstant(length, 0, std::move(values));
+  }
+
+  auto indices = allocateIndices(length, pool);
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  vector_size_t row = 0;
+  for (vector_size_t run = 0; run < numRuns && row < length; ++run) {
+    VELOX_USER_CHECK_GE(rawRunEnds[run], row, "Run ends must be ascending.");
+    const auto end = std::min<int64_t>(rawRunEnds[run], length);
+    for (; row < end; ++row) {
+      rawIndices[row] = run;
+    }
+  }
+  VELOX_USER_CHECK_EQ(row, length, "Run ends must cover the array length.");
+  return BaseVector::wrapInDictionary(
+      nullptr, std::move(indices), length, std::move(values));
+}
+
 VectorPtr importFromArrowImpl(
     ArrowSchema& arrowSchema,
     ArrowArray& arrowArray,
@@ -1097,6 +1567,11 @@ VectorPtr importFromArrowImpl(
   // First parse and generate a Velox type.
   auto type = importFromArrow(arrowSchema);
 
+  // Run-end encoded arrays have no buffers, the nulls are in the values.
+  if (strcmp(arrowSchema.format, "+r") == 0) {
+    return createRunEndEncodedVector(pool, arrowSchema, arrowArray, isViewer);
+  }
+
   // Wrap the nulls buffer into a Velox BufferView (zero-copy). Null buffer size
   // needs to be at least one bit per element.
   BufferPtr nulls = nullptr;
@@ -1120,6 +1595,10 @@ VectorPtr importFromArrowImpl(
   }
 
   // String data types (VARCHAR and VARBINARY).
+  if (arrowSchema.format[0] == 'v') {
+    return createStringViewFlatVector(
+        pool, type, nulls, arrowArray, wrapInBufferView);
+  }
   if (type->isVarchar() || type->isVarbinary()) {
     VELOX_USER_CHECK_EQ(
         arrowArray.n_buffers,
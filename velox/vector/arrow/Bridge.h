@@ -16,17 +16,29 @@
 
 #pragma once
 
+#include <functional>
+
 #include "velox/common/memory/Memory.h"
 #include "velox/vector/BaseVector.h"
+#include "velox/vector/ComplexVector.h"
 
 /// These 2 definitions should be included by user from either
 ///   1. <arrow/c/abi.h> or
 ///   2. "velox/vector/arrow/Abi.h"
 struct ArrowArray;
 struct ArrowSchema;
+struct ArrowArrayStream;
 
 namespace facebook::velox {
 
+/// Options for exporting Velox vectors to Arrow.
+struct ArrowOptions {
+  /// Exports VARCHAR and VARBINARY in the Arrow string view layout ("vu" and
+  /// "vz"), which references the string buffers of flat vectors instead of
+  /// copying the strings into an offsets and data layout.
+  bool exportToStringView{false};
+};
+
 /// Export a generic Velox Vector to an ArrowArray, as defined by Arrow's C data
 /// interface:
 ///
@@ -42,7 +54,9 @@ namespace facebook::velox {
 ///
 /// The function takes a memory pool where allocations will be made (in cases
 /// where the conversion is not zero-copy, e.g. for strings) and throws in case
-/// the conversion is not implemented yet.
+/// the conversion is not implemented yet. Dictionary vectors are exported as
+/// Arrow dictionaries and constant vectors as run-end encoded arrays with a
+/// single run.
 ///
 /// Example usage:
 ///
@@ -58,7 +72,8 @@ void exportToArrow(
     const VectorPtr& vector,
     ArrowArray& arrowArray,
     memory::MemoryPool* pool =
-        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+        &velox::memory::getProcessDefaultMemoryManager().getRoot(),
+    const ArrowOptions& options = ArrowOptions{});
 
 /// Export the type of a Velox vector to an ArrowSchema.
 ///
@@ -79,7 +94,33 @@ void exportToArrow(
 ///
 /// NOTE: Since Arrow couples type and encoding, we need both Velox type and
 /// actual data (containing encoding) to create an ArrowSchema.
-void exportToArrow(const VectorPtr&, ArrowSchema&);
+/// The same 'options' must be used as for exporting the array.
+void exportToArrow(
+    const VectorPtr&,
+    ArrowSchema&,
+    const ArrowOptions& options = ArrowOptions{});
+
+/// Export the RowVectors returned by 'next' as an ArrowArrayStream of struct
+/// arrays of 'type'. 'next' returns nullptr at the end of the stream. It is
+/// called from get_next(), so the producer only runs as fast as the consumer
+/// reads, e.g. for streaming the results of a Task:
+///
+///   ArrowArrayStream stream;
+///   exportToArrowStream(
+///       plan->outputType(), [task]() { return task->next(); }, stream);
+///
+/// The batches are exported as by exportToArrow() with 'options', except that
+/// dictionary and constant encodings are flattened since all the batches of a
+/// stream have the schema of 'type'. An exception thrown by 'next' makes
+/// get_next() fail with EIO and get_last_error() return its message. The
+/// consumer calls release() on the stream when done.
+void exportToArrowStream(
+    const RowTypePtr& type,
+    std::function<RowVectorPtr()> next,
+    ArrowArrayStream& arrowStream,
+    memory::MemoryPool* pool =
+        &velox::memory::getProcessDefaultMemoryManager().getRoot(),
+    const ArrowOptions& options = ArrowOptions{});
 
 /// Import an ArrowSchema into a Velox Type object.
 ///
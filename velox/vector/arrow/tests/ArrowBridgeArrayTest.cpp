@@ -653,10 +653,92 @@ TEST_F(ArrowBridgeArrayExportTest, unsupported) {
   // Dates.
   vector = vectorMaker_.flatVectorNullable<Date>({});
   EXPECT_THROW(exportToArrow(vector, arrowArray, pool_.get()), VeloxException);
+}
 
-  // Constant encoding.
-  vector = BaseVector::createConstant(variant(10), 10, pool_.get());
-  EXPECT_THROW(exportToArrow(vector, arrowArray, pool_.get()), VeloxException);
+TEST_F(ArrowBridgeArrayExportTest, constant) {
+  auto vec = BaseVector::createConstant(variant(int64_t(10)), 5, pool_.get());
+  ArrowSchema arrowSchema;
+  exportToArrow(vec, arrowSchema);
+  EXPECT_STREQ(arrowSchema.format, "+r");
+  ASSERT_EQ(arrowSchema.n_children, 2);
+  EXPECT_STREQ(arrowSchema.children[0]->format, "i");
+  EXPECT_STREQ(arrowSchema.children[0]->name, "run_ends");
+  EXPECT_STREQ(arrowSchema.children[1]->format, "l");
+  EXPECT_STREQ(arrowSchema.children[1]->name, "values");
+  arrowSchema.release(&arrowSchema);
+
+  ArrowArray arrowArray;
+  exportToArrow(vec, arrowArray, pool_.get());
+  EXPECT_EQ(arrowArray.length, 5);
+  EXPECT_EQ(arrowArray.null_count, 0);
+  EXPECT_EQ(arrowArray.n_buffers, 0);
+  ASSERT_EQ(arrowArray.n_children, 2);
+  const auto& runEnds = *arrowArray.children[0];
+  ASSERT_EQ(runEnds.length, 1);
+  EXPECT_EQ(static_cast<const int32_t*>(runEnds.buffers[1])[0], 5);
+  const auto& values = *arrowArray.children[1];
+  ASSERT_EQ(values.length, 1);
+  EXPECT_EQ(values.null_count, 0);
+  EXPECT_EQ(static_cast<const int64_t*>(values.buffers[1])[0], 10);
+  arrowArray.release(&arrowArray);
+
+  // Complex constants export one row of their base.
+  auto base = vectorMaker_.arrayVector<int64_t>({{1, 2}, {3, 4, 5}});
+  exportToArrow(
+      BaseVector::wrapInConstant(3, 1, base), arrowArray, pool_.get());
+  ASSERT_EQ(arrowArray.n_children, 2);
+  const auto& list = *arrowArray.children[1];
+  ASSERT_EQ(list.length, 1);
+  auto* offsets = static_cast<const int32_t*>(list.buffers[1]);
+  EXPECT_EQ(offsets[0], 0);
+  EXPECT_EQ(offsets[1], 3);
+  ASSERT_EQ(list.children[0]->length, 3);
+  EXPECT_EQ(static_cast<const int64_t*>(list.children[0]->buffers[1])[0], 3);
+  arrowArray.release(&arrowArray);
+}
+
+TEST_F(ArrowBridgeArrayExportTest, stringView) {
+  static const char* kLiteral = "a literal longer than twelve bytes";
+  auto vec = vectorMaker_.flatVectorNullable<std::string>(
+      {"inline", std::nullopt, "a string longer than twelve bytes", ""});
+  vec->setNoCopy(3, StringView(kLiteral));
+  ArrowOptions options;
+  options.exportToStringView = true;
+
+  ArrowSchema arrowSchema;
+  exportToArrow(vec, arrowSchema, options);
+  EXPECT_STREQ(arrowSchema.format, "vu");
+  arrowSchema.release(&arrowSchema);
+
+  ArrowArray arrowArray;
+  exportToArrow(vec, arrowArray, pool_.get(), options);
+  EXPECT_EQ(arrowArray.length, 4);
+  EXPECT_EQ(arrowArray.null_count, 1);
+  // Nulls, views, the string buffer of 'vec', one buffer for the literal and
+  // the buffer sizes.
+  const int32_t numStringBuffers = vec->stringBuffers().size();
+  ASSERT_EQ(arrowArray.n_buffers, 4 + numStringBuffers);
+  auto* views = static_cast<const int32_t*>(arrowArray.buffers[1]);
+  auto* dataSizes = static_cast<const int64_t*>(
+      arrowArray.buffers[arrowArray.n_buffers - 1]);
+
+  EXPECT_EQ(views[0], 6);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(views + 1), 6), "inline");
+
+  // Not inlined strings are referenced by buffer index and offset.
+  auto viewAt = [&](int32_t row) {
+    auto* view = views + 4 * row;
+    auto* data = static_cast<const char*>(arrowArray.buffers[2 + view[2]]);
+    EXPECT_LE(view[3] + view[0], dataSizes[view[2]]);
+    return std::string(data + view[3], view[0]);
+  };
+  EXPECT_EQ(viewAt(2), "a string longer than twelve bytes");
+  EXPECT_EQ(
+      arrowArray.buffers[2 + views[4 * 2 + 2]],
+      vec->stringBuffers()[views[4 * 2 + 2]]->as<void>());
+  EXPECT_EQ(views[4 * 3 + 2], numStringBuffers);
+  EXPECT_EQ(viewAt(3), kLiteral);
+  arrowArray.release(&arrowArray);
 }
 
 class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
@@ -1067,6 +1149,84 @@ class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
     });
   }
 
+  // Exports 'vec' with 'options' and imports it back.
+  void testVeloxRoundTrip(
+      const VectorPtr& vec,
+      const ArrowOptions& options,
+      VectorEncoding::Simple expectedEncoding) {
+    ArrowSchema schema;
+    ArrowArray data;
+    exportToArrow(vec, schema, options);
+    exportToArrow(vec, data, pool_.get(), options);
+    auto imported = importFromArrow(schema, data, pool_.get());
+    EXPECT_EQ(imported->encoding(), expectedEncoding);
+    ASSERT_EQ(*imported->type(), *vec->type());
+    ASSERT_EQ(imported->size(), vec->size());
+    for (vector_size_t i = 0; i < vec->size(); ++i) {
+      EXPECT_TRUE(vec->equalValueAt(imported.get(), i, i)) << "at " << i;
+    }
+    if (isViewer()) {
+      imported.reset();
+      schema.release(&schema);
+      data.release(&data);
+    } else {
+      EXPECT_FALSE(schema.release);
+      EXPECT_FALSE(data.release);
+    }
+  }
+
+  void testImportStringView() {
+    ArrowOptions options;
+    options.exportToStringView = true;
+    auto vec = vectorMaker_.flatVectorNullable<std::string>(
+        {"inline", std::nullopt, "a string longer than twelve bytes", ""});
+    testVeloxRoundTrip(vec, options, VectorEncoding::Simple::FLAT);
+    auto binary = vectorMaker_.flatVector<std::string>(
+        {"a binary longer than twelve bytes", "b"}, VARBINARY());
+    testVeloxRoundTrip(binary, options, VectorEncoding::Simple::FLAT);
+  }
+
+  void testImportConstant() {
+    testVeloxRoundTrip(
+        BaseVector::createConstant(variant(int64_t(10)), 5, pool_.get()),
+        {},
+        VectorEncoding::Simple::CONSTANT);
+    testVeloxRoundTrip(
+        BaseVector::createNullConstant(BIGINT(), 5, pool_.get()),
+        {},
+        VectorEncoding::Simple::CONSTANT);
+    testVeloxRoundTrip(
+        BaseVector::wrapInConstant(
+            3, 1, vectorMaker_.arrayVector<int64_t>({{1, 2}, {3, 4, 5}})),
+        {},
+        VectorEncoding::Simple::CONSTANT);
+
+    // Several runs import as a dictionary.
+    const int32_t runEnds[] = {2, 5};
+    const int64_t values[] = {7, 8};
+    const void* runEndsBuffers[] = {nullptr, runEnds};
+    const void* valuesBuffers[] = {nullptr, values};
+    ArrowSchema runEndsSchema = makeArrowSchema("i");
+    ArrowSchema valuesSchema = makeArrowSchema("l");
+    ArrowSchema* childSchemas[] = {&runEndsSchema, &valuesSchema};
+    ArrowSchema schema = makeArrowSchema("+r");
+    schema.n_children = 2;
+    schema.children = childSchemas;
+    ArrowArray runEndsArray = makeArrowArray(runEndsBuffers, 2, 2, 0);
+    ArrowArray valuesArray = makeArrowArray(valuesBuffers, 2, 2, 0);
+    ArrowArray* childArrays[] = {&runEndsArray, &valuesArray};
+    ArrowArray data = makeArrowArray(nullptr, 0, 5, 0);
+    data.n_children = 2;
+    data.children = childArrays;
+    auto vec = importFromArrow(schema, data, pool_.get());
+    EXPECT_EQ(vec->encoding(), VectorEncoding::Simple::DICTIONARY);
+    auto expected = vectorMaker_.flatVector<int64_t>({7, 7, 8, 8, 8});
+    ASSERT_EQ(vec->size(), expected->size());
+    for (vector_size_t i = 0; i < vec->size(); ++i) {
+      EXPECT_TRUE(expected->equalValueAt(vec.get(), i, i)) << "at " << i;
+    }
+  }
+
   void testImportFailures() {
     ArrowSchema arrowSchema;
     ArrowArray arrowArray;
@@ -1171,6 +1331,14 @@ TEST_F(ArrowBridgeArrayImportAsViewerTest, dictionary) {
   testImportDictionary();
 }
 
+TEST_F(ArrowBridgeArrayImportAsViewerTest, stringView) {
+  testImportStringView();
+}
+
+TEST_F(ArrowBridgeArrayImportAsViewerTest, constant) {
+  testImportConstant();
+}
+
 TEST_F(ArrowBridgeArrayImportAsViewerTest, failures) {
   testImportFailures();
 }
@@ -1218,6 +1386,14 @@ TEST_F(ArrowBridgeArrayImportAsOwnerTest, dictionary) {
   testImportDictionary();
 }
 
+TEST_F(ArrowBridgeArrayImportAsOwnerTest, stringView) {
+  testImportStringView();
+}
+
+TEST_F(ArrowBridgeArrayImportAsOwnerTest, constant) {
+  testImportConstant();
+}
+
 TEST_F(ArrowBridgeArrayImportAsOwnerTest, failures) {
   testImportFailures();
 }
@@ -234,6 +234,8 @@ TEST_F(ArrowBridgeSchemaImportTest, scalar) {
   EXPECT_EQ(*VARCHAR(), *testSchemaImport("U"));
   EXPECT_EQ(*VARBINARY(), *testSchemaImport("z"));
   EXPECT_EQ(*VARBINARY(), *testSchemaImport("Z"));
+  EXPECT_EQ(*VARCHAR(), *testSchemaImport("vu"));
+  EXPECT_EQ(*VARBINARY(), *testSchemaImport("vz"));
 
   // Temporal.
   EXPECT_EQ(*TIMESTAMP(), *testSchemaImport("ttn"));
@@ -274,6 +276,10 @@ TEST_F(ArrowBridgeSchemaImportTest, complexTypes) {
   EXPECT_EQ(
       *ROW({"col1", "col2"}, {SMALLINT(), REAL()}),
       *testSchemaImportComplex("+s", {"s", "f"}, {"col1", "col2"}));
+
+  // Run-end encoded has the type of its values.
+  EXPECT_EQ(*BIGINT(), *testSchemaImportComplex("+r", {"i", "l"}));
+  EXPECT_EQ(*VARCHAR(), *testSchemaImportComplex("+r", {"i", "vu"}));
 }
 
 TEST_F(ArrowBridgeSchemaImportTest, unsupported) {
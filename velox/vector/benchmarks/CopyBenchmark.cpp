@@ -66,6 +66,157 @@ size_t runBenchmark(
   return runBenchmark(data, selected, type, pool, data->size());
 }
 
+// Copies all rows of 'data' in the order of 'toSourceRow', like the output
+// of a merge or a hash probe.
+size_t runGatherBenchmark(
+    const VectorPtr& data,
+    memory::MemoryPool* pool,
+    const std::vector<vector_size_t>& toSourceRow) {
+  folly::BenchmarkSuspender suspender;
+  const vector_size_t size = data->size();
+  SelectivityVector selected(size);
+  VectorPtr result;
+  BaseVector::ensureWritable(selected, data->type(), pool, result);
+  suspender.dismiss();
+
+  size_t numIters = 100;
+  for (auto i = 0; i < numIters; i++) {
+    BaseVector::prepareForReuse(result, size);
+    result->copy(data.get(), selected, toSourceRow.data());
+  }
+
+  return size * numIters;
+}
+
+std::vector<vector_size_t> shuffledRows(vector_size_t size) {
+  std::vector<vector_size_t> rows(size);
+  for (auto i = 0; i < size; ++i) {
+    // 37 and 'size' are coprime so this shuffles the rows.
+    rows[i] = (i * 37) % size;
+  }
+  return rows;
+}
+
+// Copies all rows of 'data' in ranges of 'rangeSize' rows with one
+// copyRanges() call per iteration.
+size_t runRangesBenchmark(
+    const VectorPtr& data,
+    memory::MemoryPool* pool,
+    vector_size_t rangeSize) {
+  folly::BenchmarkSuspender suspender;
+  const vector_size_t size = data->size();
+  SelectivityVector selected(size);
+  VectorPtr result;
+  BaseVector::ensureWritable(selected, data->type(), pool, result);
+  std::vector<BaseVector::CopyRange> ranges;
+  for (vector_size_t i = 0; i < size; i += rangeSize) {
+    // Reverses the order of the ranges so they can't be merged.
+    const auto target = size - i - std::min(rangeSize, size - i);
+    ranges.push_back({i, target, std::min(rangeSize, size - i)});
+  }
+  suspender.dismiss();
+
+  size_t numIters = 100;
+  for (auto i = 0; i < numIters; i++) {
+    BaseVector::prepareForReuse(result, size);
+    result->copyRanges(data.get(), ranges);
+  }
+
+  return size * numIters;
+}
+
+BENCHMARK_MULTI(gatherBigint) {
+  folly::BenchmarkSuspender suspender;
+  std::unique_ptr<memory::MemoryPool> pool{
+      memory::getDefaultScopedMemoryPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+
+  const vector_size_t size = 10'000;
+  auto data =
+      vectorMaker.flatVector<int64_t>(size, [](auto row) { return row; });
+  suspender.dismiss();
+
+  return runGatherBenchmark(data, pool.get(), shuffledRows(size));
+}
+
+BENCHMARK_MULTI(gatherBigintWithNulls) {
+  folly::BenchmarkSuspender suspender;
+  std::unique_ptr<memory::MemoryPool> pool{
+      memory::getDefaultScopedMemoryPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+
+  const vector_size_t size = 10'000;
+  auto data = vectorMaker.flatVector<int64_t>(
+      size, [](auto row) { return row; }, test::VectorMaker::nullEvery(7));
+  suspender.dismiss();
+
+  return runGatherBenchmark(data, pool.get(), shuffledRows(size));
+}
+
+BENCHMARK_MULTI(gatherBoolWithNulls) {
+  folly::BenchmarkSuspender suspender;
+  std::unique_ptr<memory::MemoryPool> pool{
+      memory::getDefaultScopedMemoryPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+
+  const vector_size_t size = 10'000;
+  auto data = vectorMaker.flatVector<bool>(
+      size,
+      [](auto row) { return row % 3 == 0; },
+      test::VectorMaker::nullEvery(7));
+  suspender.dismiss();
+
+  return runGatherBenchmark(data, pool.get(), shuffledRows(size));
+}
+
+BENCHMARK_MULTI(gatherVarcharWithNulls) {
+  folly::BenchmarkSuspender suspender;
+  std::unique_ptr<memory::MemoryPool> pool{
+      memory::getDefaultScopedMemoryPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+
+  const vector_size_t size = 10'000;
+  char string[51];
+  std::fill(std::begin(string), std::prev(std::end(string)), 'x');
+  *std::prev(std::end(string)) = '\0';
+  auto data = vectorMaker.flatVector<StringView>(
+      size, [&](auto) { return string; }, test::VectorMaker::nullEvery(7));
+  suspender.dismiss();
+
+  return runGatherBenchmark(data, pool.get(), shuffledRows(size));
+}
+
+BENCHMARK_MULTI(copyRangesBigintWithNulls) {
+  folly::BenchmarkSuspender suspender;
+  std::unique_ptr<memory::MemoryPool> pool{
+      memory::getDefaultScopedMemoryPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+
+  const vector_size_t size = 10'000;
+  auto data = vectorMaker.flatVector<int64_t>(
+      size, [](auto row) { return row; }, test::VectorMaker::nullEvery(7));
+  suspender.dismiss();
+
+  return runRangesBenchmark(data, pool.get(), 4);
+}
+
+BENCHMARK_MULTI(copyRangesVarchar) {
+  folly::BenchmarkSuspender suspender;
+  std::unique_ptr<memory::MemoryPool> pool{
+      memory::getDefaultScopedMemoryPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+
+  const vector_size_t size = 10'000;
+  char string[51];
+  std::fill(std::begin(string), std::prev(std::end(string)), 'x');
+  *std::prev(std::end(string)) = '\0';
+  auto data = vectorMaker.flatVector<StringView>(
+      size, [&](auto) { return string; });
+  suspender.dismiss();
+
+  return runRangesBenchmark(data, pool.get(), 4);
+}
+
 BENCHMARK_MULTI(copyArray) {
   folly::BenchmarkSuspender suspender;
   std::unique_ptr<memory::MemoryPool> pool{
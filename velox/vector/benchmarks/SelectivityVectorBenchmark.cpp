@@ -300,6 +300,68 @@ BENCHMARK_PARAM(BM_operatorEquals, 1000000);
 BENCHMARK_PARAM(BM_operatorEquals, 10000000);
 BENCHMARK_DRAW_LINE();
 
+// applyToSelected Tests
+
+// Selects one row in 'stride' and sums the selected rows 10 times, like 10
+// functions evaluated on the same rows. If 'useIndices', the rows are
+// materialized before the first loop.
+void applyToSelectedTest(
+    uint32_t iterations,
+    size_t numEntries,
+    int32_t stride,
+    bool useIndices) {
+  folly::BenchmarkSuspender suspender;
+  SelectivityVector vector(numEntries, false);
+  for (size_t i = 0; i < numEntries; i += stride) {
+    vector.setValid(i, true);
+  }
+  vector.updateBounds();
+  suspender.dismiss();
+
+  for (uint32_t i = 0; i < iterations; ++i) {
+    // Drops the indices of the previous iteration.
+    vector.updateBounds();
+    if (useIndices) {
+      vector.selectedIndices();
+    }
+    int64_t sum = 0;
+    for (auto j = 0; j < 10; ++j) {
+      vector.applyToSelected([&](auto row) { sum += row; });
+    }
+    folly::doNotOptimizeAway(sum);
+  }
+
+  suspender.rehire();
+}
+
+void BM_applyToSelectedSparseBits(uint32_t iterations, size_t numEntries) {
+  applyToSelectedTest(iterations, numEntries, 17, false);
+}
+
+void BM_applyToSelectedSparseIndices(uint32_t iterations, size_t numEntries) {
+  applyToSelectedTest(iterations, numEntries, 17, true);
+}
+
+void BM_applyToSelectedDenseBits(uint32_t iterations, size_t numEntries) {
+  applyToSelectedTest(iterations, numEntries, 2, false);
+}
+
+void BM_applyToSelectedDenseIndices(uint32_t iterations, size_t numEntries) {
+  applyToSelectedTest(iterations, numEntries, 2, true);
+}
+
+BENCHMARK_PARAM(BM_applyToSelectedSparseBits, 1000);
+BENCHMARK_PARAM(BM_applyToSelectedSparseBits, 1000000);
+BENCHMARK_PARAM(BM_applyToSelectedSparseIndices, 1000);
+BENCHMARK_PARAM(BM_applyToSelectedSparseIndices, 1000000);
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_PARAM(BM_applyToSelectedDenseBits, 1000);
+BENCHMARK_PARAM(BM_applyToSelectedDenseBits, 1000000);
+BENCHMARK_PARAM(BM_applyToSelectedDenseIndices, 1000);
+BENCHMARK_PARAM(BM_applyToSelectedDenseIndices, 1000000);
+BENCHMARK_DRAW_LINE();
+
 } // namespace test
 } // namespace velox
 } // namespace facebook
@@ -549,6 +549,41 @@ TEST(SelectivityVectorTest, toString) {
       "147 out of 1024 rows selected between 0 and 1023: 0, 7, 14, 21, 28, 35, 42, 49, 56, 63, 70, 77, 84, 91, 98, 105, 112, 119, 126, 133, 140, 147, 154, 161, 168, 175, 182, 189, 196, 203, 210, 217, 224, 231, 238, 245, 252, 259, 266, 273, 280, 287, 294, 301, 308, 315, 322, 329, 336, 343, 350, 357, 364, 371, 378, 385, 392, 399, 406, 413, 420, 427, 434, 441, 448, 455, 462, 469, 476, 483, 490, 497, 504, 511, 518, 525, 532, 539, 546, 553, 560, 567, 574, 581, 588, 595, 602, 609, 616, 623, 630, 637, 644, 651, 658, 665, 672, 679, 686, 693, 700, 707, 714, 721, 728, 735, 742, 749, 756, 763, 770, 777, 784, 791, 798, 805, 812, 819, 826, 833, 840, 847, 854, 861, 868, 875, 882, 889, 896, 903, 910, 917, 924, 931, 938, 945, 952, 959, 966, 973, 980, 987, 994, 1001, 1008, 1015, 1022");
 }
 
+TEST(SelectivityVectorTest, selectedIndices) {
+  SelectivityVector rows(1'000, false);
+  for (auto i = 3; i < rows.size(); i += 11) {
+    rows.setValid(i, true);
+  }
+  rows.updateBounds();
+  ASSERT_TRUE(rows.isSparse());
+
+  std::vector<vector_size_t> expected;
+  bits::forEachSetBit(
+      rows.asRange().bits(), rows.begin(), rows.end(), [&](auto row) {
+        expected.push_back(row);
+      });
+  ASSERT_EQ(expected, rows.selectedIndices());
+
+  // applyToSelected() loops over the indices.
+  std::vector<vector_size_t> visited;
+  rows.applyToSelected([&](auto row) { visited.push_back(row); });
+  ASSERT_EQ(expected, visited);
+
+  // Changing the selection drops the indices.
+  rows.setValid(3, false);
+  rows.updateBounds();
+  expected.erase(expected.begin());
+  ASSERT_EQ(expected, rows.selectedIndices());
+
+  rows.setValidRange(0, 500, true);
+  rows.updateBounds();
+  ASSERT_FALSE(rows.isSparse());
+  ASSERT_EQ(500 + 45, rows.selectedIndices().size());
+
+  rows.clearAll();
+  ASSERT_TRUE(rows.selectedIndices().empty());
+}
+
 } // namespace test
 } // namespace velox
 } // namespace facebook
@@ -129,4 +129,34 @@ TEST_F(VectorPoolTest, ScopedVectorPtr) {
     ASSERT_NE(rawPtr, vectorPtr.get());
   }
 }
+
+TEST_F(VectorPoolTest, reusable) {
+  VectorPool vectorPool(pool());
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), VARCHAR()});
+
+  // A vector is reused once the consumer drops it.
+  auto vector = vectorPool.getReusable(rowType, 1'000);
+  auto* rawVector = vector.get();
+  auto other = vectorPool.getReusable(rowType, 1'000);
+  ASSERT_NE(rawVector, other.get());
+  vector.reset();
+  vector = vectorPool.getReusable(rowType, 100);
+  ASSERT_EQ(rawVector, vector.get());
+  ASSERT_EQ(100, vector->size());
+
+  // A child that is still referenced is replaced.
+  auto child = vector->as<RowVector>()->childAt(0);
+  auto* rawChild = vector->as<RowVector>()->childAt(1).get();
+  vector.reset();
+  vector = vectorPool.getReusable(rowType, 100);
+  ASSERT_EQ(rawVector, vector.get());
+  ASSERT_NE(child.get(), vector->as<RowVector>()->childAt(0).get());
+  ASSERT_EQ(rawChild, vector->as<RowVector>()->childAt(1).get());
+
+  // Vectors of another type are not reused.
+  vector.reset();
+  auto bigint = vectorPool.getReusable(BIGINT(), 100);
+  ASSERT_NE(rawVector, bigint.get());
+  ASSERT_EQ(TypeKind::BIGINT, bigint->typeKind());
+}
 } // namespace facebook::velox::test
@@ -464,6 +464,57 @@ struct VectorSaverInfo {
 };
 } // namespace
 
+TEST_F(VectorSaverTest, mappedFile) {
+  auto opts = fuzzerOptions();
+  opts.nullRatio = 0.1;
+  SCOPED_TRACE(fmt::format("seed: {}", seed_));
+  VectorFuzzer fuzzer(opts, pool(), seed_);
+  auto rowType =
+      ROW({"a", "b", "c", "d", "e"},
+          {BIGINT(),
+           VARCHAR(),
+           ARRAY(INTEGER()),
+           MAP(VARCHAR(), DOUBLE()),
+           ROW({"e1", "e2"}, {BOOLEAN(), VARCHAR()})});
+  auto children = fuzzer.fuzzFlat(rowType)->as<RowVector>()->children();
+  // A dictionary and a constant column.
+  children.push_back(fuzzer.fuzzDictionary(children[0]));
+  children.push_back(BaseVector::wrapInConstant(data->size(), 7, children[1]));
+  auto data = makeRowVector(children);
+
+  auto path = exec::test::TempFilePath::create();
+  saveVectorToMappedFile(*data, path->path.c_str());
+  auto copy = restoreVectorFromMappedFile(path->path.c_str(), pool());
+
+  // Each column is restored on first access.
+  for (auto i = 0; i < copy->childrenSize(); ++i) {
+    ASSERT_TRUE(isLazyNotLoaded(*copy->childAt(i)));
+  }
+  copy->childAt(1)->loadedVector();
+  ASSERT_TRUE(isLazyNotLoaded(*copy->childAt(0)));
+  ASSERT_FALSE(isLazyNotLoaded(*copy->childAt(1)));
+
+  // The values are not copied.
+  auto strings = copy->childAt(1)->loadedVector()->asFlatVector<StringView>();
+  ASSERT_TRUE(strings->values()->isView());
+  for (const auto& buffer : strings->stringBuffers()) {
+    ASSERT_TRUE(buffer->isView());
+  }
+
+  for (auto& child : children) {
+    child = BaseVector::loadedVectorShared(child);
+  }
+  for (auto i = 0; i < copy->childrenSize(); ++i) {
+    assertEqualEncodings(
+        children[i], BaseVector::loadedVectorShared(copy->childAt(i)));
+  }
+
+  // The buffers keep the mapping alive after the top level vector is gone.
+  auto firstColumn = BaseVector::loadedVectorShared(copy->childAt(0));
+  copy.reset();
+  assertEqualVectors(children[0], firstColumn);
+}
+
 /// A demonstration of using VectorSaver to save 'current' vector being
 /// processed to disk in case of an exception.
 TEST_F(VectorSaverTest, exceptionContext) {
@@ -1260,6 +1260,50 @@ TEST_F(VectorTest, wrapConstantInDictionary) {
   }
 }
 
+TEST_F(VectorTest, wrapInDictionaryOrCopy) {
+  auto ints = makeFlatVector<int64_t>(
+      100, [](auto row) { return row; }, nullEvery(7));
+  std::vector<std::string> stringData(100);
+  for (auto i = 0; i < 100; ++i) {
+    stringData[i] = fmt::format("string {}", i);
+  }
+  VectorPtr strings = makeFlatVector(stringData);
+  auto fewRows = makeIndices(10, [](auto row) { return row * 3; });
+  auto manyRows = makeIndices(80, [](auto row) { return row; });
+
+  auto expectCopy = [&](const VectorPtr& vector,
+                        const BufferPtr& indices,
+                        bool copy) {
+    const auto size = indices->size() / sizeof(vector_size_t);
+    auto result =
+        BaseVector::wrapInDictionaryOrCopy(nullptr, indices, size, vector);
+    ASSERT_EQ(copy, result->isFlatEncoding());
+    ASSERT_EQ(!copy, result->encoding() == VectorEncoding::Simple::DICTIONARY);
+    auto* rawIndices = indices->as<vector_size_t>();
+    for (auto i = 0; i < size; ++i) {
+      ASSERT_TRUE(result->equalValueAt(vector.get(), i, rawIndices[i]));
+    }
+  };
+
+  // Narrow rows are copied if most rows are dropped.
+  expectCopy(ints, fewRows, true);
+  expectCopy(ints, manyRows, false);
+  // Strings are wrapped.
+  expectCopy(strings, fewRows, false);
+
+  // Dictionaries nested too deep are copied.
+  VectorPtr nested = strings;
+  for (auto i = 0; i < BaseVector::kMaxDictionaryNesting; ++i) {
+    nested = BaseVector::wrapInDictionary(nullptr, manyRows, 80, nested);
+  }
+  expectCopy(nested, manyRows, true);
+
+  // Extra nulls are always wrapped.
+  auto nulls = makeNulls(10, [](auto row) { return row % 2 == 0; });
+  auto result = BaseVector::wrapInDictionaryOrCopy(nulls, fewRows, 10, ints);
+  ASSERT_EQ(VectorEncoding::Simple::DICTIONARY, result->encoding());
+}
+
 TEST_F(VectorTest, setFlatVectorStringView) {
   auto vector = BaseVector::create(VARCHAR(), 1, pool_.get());
   auto flat = vector->asFlatVector<StringView>();
@@ -1290,6 +1334,52 @@ TEST_F(VectorTest, setFlatVectorStringView) {
   EXPECT_EQ(newString.size(), flatCopy->stringBuffers()[1]->size());
 }
 
+TEST_F(VectorTest, copyFewStrings) {
+  const vector_size_t size = 1'000;
+  std::vector<std::string> data(size);
+  for (auto i = 0; i < size; ++i) {
+    data[i] = fmt::format("a string that is not inlined {}", i);
+  }
+  auto source = makeFlatVector<StringView>(
+      size, [&](auto row) { return StringView(data[row]); }, nullEvery(9));
+  auto* sourceBuffer = source->stringBuffers()[0].get();
+
+  // A few rows are copied into buffers of the target.
+  auto target = BaseVector::create(VARCHAR(), size, pool_.get());
+  auto* flatTarget = target->asFlatVector<StringView>();
+  SelectivityVector rows(20);
+  target->copy(source.get(), rows, nullptr);
+  for (auto& buffer : flatTarget->stringBuffers()) {
+    ASSERT_NE(sourceBuffer, buffer.get());
+  }
+
+  // All rows reference the buffers of the source.
+  SelectivityVector allRows(size);
+  target->copy(source.get(), allRows, nullptr);
+  const auto& targetBuffers = flatTarget->stringBuffers();
+  ASSERT_TRUE(std::any_of(
+      targetBuffers.begin(), targetBuffers.end(), [&](const auto& buffer) {
+        return buffer.get() == sourceBuffer;
+      }));
+  for (auto i = 0; i < size; ++i) {
+    ASSERT_TRUE(target->equalValueAt(source.get(), i, i)) << "at " << i;
+  }
+
+  // The same for a few ranges.
+  auto other = BaseVector::create(VARCHAR(), size, pool_.get());
+  std::vector<BaseVector::CopyRange> ranges = {{0, 0, 5}, {500, 5, 5}};
+  other->copyRanges(source.get(), ranges);
+  for (auto& buffer : other->asFlatVector<StringView>()->stringBuffers()) {
+    ASSERT_NE(sourceBuffer, buffer.get());
+  }
+  for (auto& range : ranges) {
+    for (auto i = 0; i < range.count; ++i) {
+      ASSERT_TRUE(other->equalValueAt(
+          source.get(), range.targetIndex + i, range.sourceIndex + i));
+    }
+  }
+}
+
 TEST_F(VectorTest, resizeAtConstruction) {
   using T = int64_t;
   const size_t realSize = 10;
@@ -1350,6 +1440,72 @@ TEST_F(VectorTest, copyNoRows) {
   }
 }
 
+TEST_F(VectorTest, copyGather) {
+  const vector_size_t size = 1'000;
+  auto ints = makeFlatVector<int64_t>(
+      size, [](auto row) { return row; }, nullEvery(7));
+  auto bools = makeFlatVector<bool>(
+      size, [](auto row) { return row % 3 == 0; }, nullEvery(5));
+  std::vector<std::string> stringData(size);
+  for (auto i = 0; i < size; ++i) {
+    stringData[i] = fmt::format("string value {}", i);
+  }
+  auto strings = makeFlatVector<StringView>(
+      size,
+      [&](auto row) { return StringView(stringData[row]); },
+      nullEvery(11));
+  std::vector<vector_size_t> toSourceRow(size);
+  for (auto i = 0; i < size; ++i) {
+    toSourceRow[i] = (i * 37) % size;
+  }
+
+  // Contiguous rows starting at an unaligned offset take the gather path, the
+  // rows with a gap do not.
+  SelectivityVector contiguous(size - 13);
+  contiguous.setValidRange(0, 5, false);
+  contiguous.updateBounds();
+  SelectivityVector withGap(size);
+  withGap.setValid(500, false);
+  withGap.updateBounds();
+  for (auto* rows : {&contiguous, &withGap}) {
+    for (auto& source : std::vector<VectorPtr>{ints, bools, strings}) {
+      auto target = BaseVector::create(source->type(), size, pool_.get());
+      target->copy(source.get(), *rows, toSourceRow.data());
+      rows->applyToSelected([&](auto row) {
+        ASSERT_TRUE(target->equalValueAt(source.get(), row, toSourceRow[row]))
+            << "at " << row;
+      });
+    }
+  }
+}
+
+TEST_F(VectorTest, copyRanges) {
+  auto source = makeFlatVector<int32_t>(
+      100, [](auto row) { return row; }, nullEvery(3));
+  auto constant = BaseVector::wrapInConstant(100, 1, source);
+  auto nullConstant = BaseVector::wrapInConstant(100, 0, source);
+  std::vector<BaseVector::CopyRange> ranges = {
+      {0, 10, 5}, {50, 1, 9}, {97, 90, 3}};
+  for (auto& vector : std::vector<VectorPtr>{source, constant, nullConstant}) {
+    auto target = makeFlatVector<int32_t>(100, [](auto row) { return -row; });
+    target->copyRanges(vector.get(), ranges);
+    std::vector<bool> copied(100);
+    for (auto& range : ranges) {
+      for (auto i = 0; i < range.count; ++i) {
+        ASSERT_TRUE(target->equalValueAt(
+            vector.get(), range.targetIndex + i, range.sourceIndex + i));
+        copied[range.targetIndex + i] = true;
+      }
+    }
+    for (auto i = 0; i < 100; ++i) {
+      if (!copied[i]) {
+        ASSERT_FALSE(target->isNullAt(i));
+        ASSERT_EQ(-i, target->valueAt(i));
+      }
+    }
+  }
+}
+
 TEST_F(VectorTest, copyAscii) {
   auto maker = std::make_unique<test::VectorMaker>(pool_.get());
   std::vector<std::string> stringData = {"a", "b", "c"};